@@ -18,6 +18,7 @@ void AssetManager::PushFront(std::unique_ptr<AssetResolver> resolver) {
     return;
   }
 
+  IndexResolver(resolver.get(), true);
   resolvers_.push_front(std::move(resolver));
 }
 
@@ -26,9 +27,70 @@ void AssetManager::PushBack(std::unique_ptr<AssetResolver> resolver) {
     return;
   }
 
+  IndexResolver(resolver.get(), false);
   resolvers_.push_back(std::move(resolver));
 }
 
+void AssetManager::IndexResolver(const AssetResolver* resolver, bool front) {
+  TRACE_EVENT0("flutter", "AssetManager::IndexResolver");
+  std::vector<std::string> names;
+  if (!resolver->GetAssetNames(&names)) {
+    return;
+  }
+  indexed_resolvers_.insert(resolver);
+  for (auto& name : names) {
+    if (front) {
+      index_[std::move(name)] = resolver;
+    } else {
+      index_.emplace(std::move(name), resolver);
+    }
+  }
+}
+
+std::unique_ptr<fml::Mapping> AssetManager::Resolve(
+    const std::string& asset_name,
+    Getter getter) const {
+  auto found = index_.find(asset_name);
+  const AssetResolver* indexed =
+      found != index_.end() ? found->second : nullptr;
+
+  // Only the resolvers that couldn't be indexed need to be probed, up to the
+  // one the index points at.
+  for (const auto& resolver : resolvers_) {
+    if (resolver.get() == indexed) {
+      break;
+    }
+    if (indexed_resolvers_.count(resolver.get()) > 0) {
+      continue;
+    }
+    auto mapping = (resolver.get()->*getter)(asset_name);
+    if (mapping != nullptr) {
+      return mapping;
+    }
+  }
+  if (indexed != nullptr) {
+    auto mapping = (indexed->*getter)(asset_name);
+    if (mapping != nullptr) {
+      return mapping;
+    }
+  }
+
+  // The name may be spelled differently than when the asset was indexed, or
+  // the file may have been added since. Probe the indexed resolvers as well
+  // before giving up.
+  for (const auto& resolver : resolvers_) {
+    if (resolver.get() == indexed ||
+        indexed_resolvers_.count(resolver.get()) == 0) {
+      continue;
+    }
+    auto mapping = (resolver.get()->*getter)(asset_name);
+    if (mapping != nullptr) {
+      return mapping;
+    }
+  }
+  return nullptr;
+}
+
 // |AssetResolver|
 std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
     const std::string& asset_name) const {
@@ -37,16 +99,67 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   }
   TRACE_EVENT1("flutter", "AssetManager::GetAsMapping", "name",
                asset_name.c_str());
-  for (const auto& resolver : resolvers_) {
-    auto mapping = resolver->GetAsMapping(asset_name);
-    if (mapping != nullptr) {
-      return mapping;
-    }
+  auto mapping = Resolve(asset_name, &AssetResolver::GetAsMapping);
+  if (mapping != nullptr) {
+    RecordAccess(asset_name);
+    return mapping;
   }
   FML_DLOG(WARNING) << "Could not find asset: " << asset_name;
   return nullptr;
 }
 
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> AssetManager::GetAsDemandPagedMapping(
+    const std::string& asset_name) const {
+  if (asset_name.size() == 0) {
+    return nullptr;
+  }
+  TRACE_EVENT1("flutter", "AssetManager::GetAsDemandPagedMapping", "name",
+               asset_name.c_str());
+  auto mapping = Resolve(asset_name, &AssetResolver::GetAsDemandPagedMapping);
+  if (mapping != nullptr) {
+    RecordAccess(asset_name);
+    return mapping;
+  }
+  FML_DLOG(WARNING) << "Could not find asset: " << asset_name;
+  return nullptr;
+}
+
+// |AssetResolver|
+bool AssetManager::GetAssetNames(std::vector<std::string>* names) const {
+  if (indexed_resolvers_.size() != resolvers_.size()) {
+    return false;
+  }
+  names->reserve(names->size() + index_.size());
+  for (const auto& entry : index_) {
+    names->push_back(entry.first);
+  }
+  return true;
+}
+
+void AssetManager::StartRecordingAccesses() {
+  std::scoped_lock lock(recording_mutex_);
+  recording_accesses_ = true;
+  recorded_accesses_.clear();
+  recorded_names_.clear();
+}
+
+std::vector<std::string> AssetManager::StopRecordingAccesses() {
+  std::scoped_lock lock(recording_mutex_);
+  recording_accesses_ = false;
+  recorded_names_.clear();
+  std::vector<std::string> accesses;
+  accesses.swap(recorded_accesses_);
+  return accesses;
+}
+
+void AssetManager::RecordAccess(const std::string& asset_name) const {
+  std::scoped_lock lock(recording_mutex_);
+  if (recording_accesses_ && recorded_names_.insert(asset_name).second) {
+    recorded_accesses_.push_back(asset_name);
+  }
+}
+
 // |AssetResolver|
 bool AssetManager::IsValid() const {
   return resolvers_.size() > 0;
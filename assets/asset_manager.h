@@ -7,7 +7,10 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
@@ -32,8 +35,47 @@ class AssetManager final : public AssetResolver {
   std::unique_ptr<fml::Mapping> GetAsMapping(
       const std::string& asset_name) const override;
 
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsDemandPagedMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  bool GetAssetNames(std::vector<std::string>* names) const override;
+
+  // Starts recording the names of the assets that are found, in the order
+  // they are first looked up. Can be called on any thread.
+  void StartRecordingAccesses();
+
+  // Stops recording and returns the names recorded since
+  // |StartRecordingAccesses|. Can be called on any thread.
+  std::vector<std::string> StopRecordingAccesses();
+
  private:
+  using Getter = std::unique_ptr<fml::Mapping> (AssetResolver::*)(
+      const std::string&) const;
+
   std::deque<std::unique_ptr<AssetResolver>> resolvers_;
+  // The resolvers that enumerated their assets into |index_|.
+  std::unordered_set<const AssetResolver*> indexed_resolvers_;
+  // The first indexed resolver of each asset, so that looking an asset up
+  // doesn't need to probe the file system of every resolver ahead of it.
+  std::unordered_map<std::string, const AssetResolver*> index_;
+
+  // Adds the assets of |resolver| to the index, taking precedence over the
+  // resolvers already indexed if |front| is set.
+  void IndexResolver(const AssetResolver* resolver, bool front);
+
+  // Guards the recording of accesses, as assets are looked up on several
+  // threads.
+  mutable std::mutex recording_mutex_;
+  bool recording_accesses_ = false;
+  mutable std::vector<std::string> recorded_accesses_;
+  mutable std::unordered_set<std::string> recorded_names_;
+
+  std::unique_ptr<fml::Mapping> Resolve(const std::string& asset_name,
+                                        Getter getter) const;
+
+  void RecordAccess(const std::string& asset_name) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(AssetManager);
 };
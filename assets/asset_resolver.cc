@@ -0,0 +1,25 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_resolver.h"
+
+#include <utility>
+
+namespace flutter {
+
+void AssetResolver::GetAsMappingAsync(const std::string& asset_name,
+                                      fml::RefPtr<fml::TaskRunner> worker,
+                                      fml::RefPtr<fml::TaskRunner> completion,
+                                      MappingCallback callback) const {
+  worker->PostTask([resolver = this, asset_name, completion,
+                    callback = std::move(callback)]() mutable {
+    auto mapping = resolver->GetAsMapping(asset_name);
+    completion->PostTask([callback = std::move(callback),
+                          mapping = std::move(mapping)]() mutable {
+      callback(std::move(mapping));
+    });
+  });
+}
+
+}  // namespace flutter
@@ -5,16 +5,21 @@
 #ifndef FLUTTER_ASSETS_ASSET_RESOLVER_H_
 #define FLUTTER_ASSETS_ASSET_RESOLVER_H_
 
+#include <functional>
 #include <string>
 #include <vector>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
 
 namespace flutter {
 
 class AssetResolver {
  public:
+  using MappingCallback = std::function<void(std::unique_ptr<fml::Mapping>)>;
+
   AssetResolver() = default;
 
   virtual ~AssetResolver() = default;
@@ -24,6 +29,32 @@ class AssetResolver {
   [[nodiscard]] virtual std::unique_ptr<fml::Mapping> GetAsMapping(
       const std::string& asset_name) const = 0;
 
+  // Like |GetAsMapping|, but for large assets of which only parts are read,
+  // like fonts. Resolvers that map assets from files return them without
+  // reading them ahead, so that their pages are only read in once accessed and
+  // are shared with other processes mapping the same file.
+  [[nodiscard]] virtual std::unique_ptr<fml::Mapping> GetAsDemandPagedMapping(
+      const std::string& asset_name) const {
+    return GetAsMapping(asset_name);
+  }
+
+  // Like |GetAsMapping|, but doesn't block the calling thread on the file
+  // system. The asset is read on |worker| and |callback| is called on
+  // |completion| with the mapping, or with null if the asset isn't found. The
+  // resolver has to be kept alive until |callback| is called, for example by
+  // capturing it in the callback.
+  virtual void GetAsMappingAsync(const std::string& asset_name,
+                                 fml::RefPtr<fml::TaskRunner> worker,
+                                 fml::RefPtr<fml::TaskRunner> completion,
+                                 MappingCallback callback) const;
+
+  // Appends the names of all the assets of this resolver to |names|. Returns
+  // false if the resolver can't enumerate its assets, in which case an
+  // |AssetManager| has to ask it for every asset it looks up.
+  virtual bool GetAssetNames(std::vector<std::string>* names) const {
+    return false;
+  }
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(AssetResolver);
 };
@@ -4,6 +4,7 @@
 
 #include "flutter/assets/directory_asset_bundle.h"
 
+#include <iterator>
 #include <utility>
 
 #include "flutter/fml/eintr_wrapper.h"
@@ -12,6 +13,11 @@
 
 namespace flutter {
 
+// Assets up to this size are cached. Larger ones are mostly decoded once and
+// would crowd the small ones out.
+static constexpr size_t kMaxCachedAssetSize = 64 * 1024;
+static constexpr size_t kMaxCachedAssets = 32;
+
 DirectoryAssetBundle::DirectoryAssetBundle(fml::UniqueFD descriptor)
     : descriptor_(std::move(descriptor)) {
   if (!fml::IsDirectory(descriptor_)) {
@@ -30,6 +36,124 @@ bool DirectoryAssetBundle::IsValid() const {
 // |AssetResolver|
 std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsMapping(
     const std::string& asset_name) const {
+  auto cached = GetCachedMapping(asset_name);
+  if (cached) {
+    return cached;
+  }
+
+  auto mapping = OpenMapping(asset_name);
+  if (!mapping) {
+    return nullptr;
+  }
+
+  // Assets are asked for right before they are decoded or parsed as a whole,
+  // read them ahead instead of faulting on every page.
+  mapping->Prefetch();
+
+  return CacheMapping(asset_name, std::move(mapping));
+}
+
+// |AssetResolver|
+void DirectoryAssetBundle::GetAsMappingAsync(
+    const std::string& asset_name,
+    fml::RefPtr<fml::TaskRunner> worker,
+    fml::RefPtr<fml::TaskRunner> completion,
+    MappingCallback callback) const {
+  // Cached assets are already mapped, skip the trip to the worker.
+  auto cached = GetCachedMapping(asset_name);
+  if (cached) {
+    completion->PostTask([callback = std::move(callback),
+                          mapping = std::move(cached)]() mutable {
+      callback(std::move(mapping));
+    });
+    return;
+  }
+  AssetResolver::GetAsMappingAsync(asset_name, std::move(worker),
+                                   std::move(completion), std::move(callback));
+}
+
+// Wraps a cached mapping so that it stays alive while it is used, even if it
+// is evicted from the cache.
+static std::unique_ptr<fml::Mapping> WrapCachedMapping(
+    std::shared_ptr<fml::FileMapping> mapping) {
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, size, [mapping = std::move(mapping)](auto, auto) {});
+}
+
+std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetCachedMapping(
+    const std::string& asset_name) const {
+  std::scoped_lock lock(cache_mutex_);
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    if (it->first == asset_name) {
+      cache_.splice(cache_.begin(), cache_, it);
+      return WrapCachedMapping(it->second);
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<fml::Mapping> DirectoryAssetBundle::CacheMapping(
+    const std::string& asset_name,
+    std::unique_ptr<fml::FileMapping> mapping) const {
+  if (mapping->GetSize() > kMaxCachedAssetSize) {
+    return mapping;
+  }
+  std::shared_ptr<fml::FileMapping> shared = std::move(mapping);
+  std::scoped_lock lock(cache_mutex_);
+  // Another thread may have cached the asset since it was looked up.
+  cache_.remove_if(
+      [&asset_name](const auto& entry) { return entry.first == asset_name; });
+  cache_.emplace_front(asset_name, shared);
+  if (cache_.size() > kMaxCachedAssets) {
+    cache_.pop_back();
+  }
+  return WrapCachedMapping(std::move(shared));
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsDemandPagedMapping(
+    const std::string& asset_name) const {
+  return OpenMapping(asset_name);
+}
+
+// Appends the paths of the files below |directory|, prefixed with |prefix|.
+static bool CollectFileNames(const fml::UniqueFD& directory,
+                             const std::string& prefix,
+                             std::vector<std::string>* names) {
+  return fml::VisitFiles(directory, [&prefix, names](
+                                        const fml::UniqueFD& parent,
+                                        const std::string& filename) {
+    const std::string name = prefix + filename;
+    if (!fml::IsDirectory(parent, filename.c_str())) {
+      names->push_back(name);
+      return true;
+    }
+    auto subdirectory = fml::OpenDirectoryReadOnly(parent, filename.c_str());
+    return subdirectory.is_valid() &&
+           CollectFileNames(subdirectory, name + "/", names);
+  });
+}
+
+// |AssetResolver|
+bool DirectoryAssetBundle::GetAssetNames(
+    std::vector<std::string>* names) const {
+  if (!is_valid_) {
+    return false;
+  }
+  std::vector<std::string> collected;
+  if (!CollectFileNames(descriptor_, "", &collected)) {
+    FML_DLOG(WARNING) << "Could not list the assets of the bundle.";
+    return false;
+  }
+  names->insert(names->end(), std::make_move_iterator(collected.begin()),
+                std::make_move_iterator(collected.end()));
+  return true;
+}
+
+std::unique_ptr<fml::FileMapping> DirectoryAssetBundle::OpenMapping(
+    const std::string& asset_name) const {
   if (!is_valid_) {
     FML_DLOG(WARNING) << "Asset bundle was not valid.";
     return nullptr;
@@ -5,6 +5,12 @@
 #ifndef FLUTTER_ASSETS_DIRECTORY_ASSET_BUNDLE_H_
 #define FLUTTER_ASSETS_DIRECTORY_ASSET_BUNDLE_H_
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
@@ -22,6 +28,13 @@ class DirectoryAssetBundle : public AssetResolver {
   const fml::UniqueFD descriptor_;
   bool is_valid_ = false;
 
+  // The mappings of the small assets looked up last, most recent first, so
+  // that assets that are asked for over and over, like the images of lists,
+  // don't go to the file system every time.
+  mutable std::mutex cache_mutex_;
+  mutable std::list<std::pair<std::string, std::shared_ptr<fml::FileMapping>>>
+      cache_;
+
   // |AssetResolver|
   bool IsValid() const override;
 
@@ -29,6 +42,31 @@ class DirectoryAssetBundle : public AssetResolver {
   std::unique_ptr<fml::Mapping> GetAsMapping(
       const std::string& asset_name) const override;
 
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsDemandPagedMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  void GetAsMappingAsync(const std::string& asset_name,
+                         fml::RefPtr<fml::TaskRunner> worker,
+                         fml::RefPtr<fml::TaskRunner> completion,
+                         MappingCallback callback) const override;
+
+  // |AssetResolver|
+  bool GetAssetNames(std::vector<std::string>* names) const override;
+
+  std::unique_ptr<fml::FileMapping> OpenMapping(
+      const std::string& asset_name) const;
+
+  // Returns a mapping of the cached asset, or null if it isn't cached.
+  std::unique_ptr<fml::Mapping> GetCachedMapping(
+      const std::string& asset_name) const;
+
+  // Caches |mapping| if the asset is small, and returns a mapping of it.
+  std::unique_ptr<fml::Mapping> CacheMapping(
+      const std::string& asset_name,
+      std::unique_ptr<fml::FileMapping> mapping) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(DirectoryAssetBundle);
 };
 
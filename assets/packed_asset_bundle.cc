@@ -0,0 +1,280 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+static constexpr char kMagic[8] = {'F', 'L', 'T', 'P', 'A', 'C', 'K', '1'};
+
+namespace {
+
+// Reads the little endian integers of the index, failing instead of reading
+// past its end.
+class IndexReader {
+ public:
+  IndexReader(const uint8_t* data, size_t size)
+      : cursor_(data), end_(data + size) {}
+
+  template <class T>
+  bool Read(T* value) {
+    if (static_cast<size_t>(end_ - cursor_) < sizeof(T)) {
+      return false;
+    }
+    // All the platforms the engine runs on are little endian.
+    std::memcpy(value, cursor_, sizeof(T));
+    cursor_ += sizeof(T);
+    return true;
+  }
+
+  bool Read(std::string* value, size_t length) {
+    if (static_cast<size_t>(end_ - cursor_) < length) {
+      return false;
+    }
+    value->assign(reinterpret_cast<const char*>(cursor_), length);
+    cursor_ += length;
+    return true;
+  }
+
+ private:
+  const uint8_t* cursor_;
+  const uint8_t* const end_;
+};
+
+}  // namespace
+
+PackedAssetBundle::PackedAssetBundle(const fml::UniqueFD& file)
+    : mapping_(std::make_shared<fml::FileMapping>(file)) {
+  if (!mapping_->IsValid()) {
+    return;
+  }
+  if (!ReadIndex()) {
+    FML_LOG(ERROR) << "The packed asset bundle is malformed.";
+    entries_.clear();
+    return;
+  }
+  // Assets are looked up by name and are all over the file, so don't read
+  // ahead of the pages that are accessed. Assets that are asked for as a whole
+  // are prefetched when they are.
+  mapping_->SetAccessHint(fml::FileMapping::AccessHint::kRandom);
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::ReadIndex() {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::ReadIndex");
+  const size_t file_size = mapping_->GetSize();
+  IndexReader reader(mapping_->GetMapping(), file_size);
+
+  std::string magic;
+  uint32_t entry_count = 0;
+  if (!reader.Read(&magic, sizeof(kMagic)) ||
+      std::memcmp(magic.data(), kMagic, sizeof(kMagic)) != 0 ||
+      !reader.Read(&entry_count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    uint32_t name_length = 0;
+    std::string name;
+    uint32_t method = 0;
+    Entry entry;
+    if (!reader.Read(&name_length) || !reader.Read(&name, name_length) ||
+        !reader.Read(&method) || !reader.Read(&entry.block_size) ||
+        !reader.Read(&entry.offset) || !reader.Read(&entry.size) ||
+        !reader.Read(&entry.stored_size)) {
+      return false;
+    }
+    if (entry.offset > file_size ||
+        entry.stored_size > file_size - entry.offset) {
+      return false;
+    }
+    switch (static_cast<Method>(method)) {
+      case Method::kStored:
+        if (entry.stored_size != entry.size) {
+          return false;
+        }
+        break;
+      case Method::kLZ4Blocks:
+        if (entry.block_size == 0) {
+          return false;
+        }
+        break;
+      default:
+        FML_LOG(ERROR) << "Asset '" << name
+                       << "' uses an unknown compression method " << method
+                       << ".";
+        return false;
+    }
+    entry.method = static_cast<Method>(method);
+    entries_[std::move(name)] = entry;
+  }
+  return true;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  auto found = entries_.find(asset_name);
+  if (found == entries_.end()) {
+    return nullptr;
+  }
+  const Entry& entry = found->second;
+
+  if (entry.method != Method::kStored) {
+    return Decompress(asset_name, entry);
+  }
+
+  // The slice keeps the mapping of the whole file alive for as long as it is
+  // used, so assets may outlive the bundle.
+  mapping_->Prefetch(entry.offset, entry.size);
+  return std::make_unique<fml::NonOwnedMapping>(
+      mapping_->GetMapping() + entry.offset, entry.size,
+      [mapping = mapping_](auto, auto) {});
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::Decompress(
+    const std::string& asset_name,
+    const Entry& entry) const {
+  TRACE_EVENT1("flutter", "PackedAssetBundle::Decompress", "asset",
+               asset_name.c_str());
+  const uint8_t* data = mapping_->GetMapping() + entry.offset;
+  mapping_->Prefetch(entry.offset, entry.stored_size);
+
+  const uint64_t block_count =
+      (entry.size + entry.block_size - 1) / entry.block_size;
+  const uint64_t table_size = block_count * sizeof(uint32_t);
+  if (table_size > entry.stored_size) {
+    FML_LOG(ERROR) << "The block table of asset '" << asset_name
+                   << "' is truncated.";
+    return nullptr;
+  }
+
+  std::vector<uint8_t> decompressed(entry.size);
+  uint64_t block_offset = table_size;
+  for (uint64_t block = 0; block < block_count; block++) {
+    uint32_t compressed_size = 0;
+    std::memcpy(&compressed_size, data + block * sizeof(uint32_t),
+                sizeof(uint32_t));
+    const uint64_t decompressed_offset = block * entry.block_size;
+    const uint64_t decompressed_size =
+        std::min<uint64_t>(entry.block_size, entry.size - decompressed_offset);
+    if (compressed_size > entry.stored_size - block_offset ||
+        !DecompressLZ4Block(data + block_offset, compressed_size,
+                            decompressed.data() + decompressed_offset,
+                            decompressed_size)) {
+      FML_LOG(ERROR) << "Block " << block << " of asset '" << asset_name
+                     << "' is corrupt.";
+      return nullptr;
+    }
+    block_offset += compressed_size;
+  }
+
+  return std::make_unique<fml::DataMapping>(std::move(decompressed));
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::GetAssetNames(std::vector<std::string>* names) const {
+  if (!is_valid_) {
+    return false;
+  }
+  for (const auto& entry : entries_) {
+    names->push_back(entry.first);
+  }
+  return true;
+}
+
+bool PackedAssetBundle::DecompressLZ4Block(const uint8_t* source,
+                                           size_t source_size,
+                                           uint8_t* destination,
+                                           size_t destination_size) {
+  const uint8_t* in = source;
+  const uint8_t* const in_end = source + source_size;
+  uint8_t* out = destination;
+  uint8_t* const out_end = destination + destination_size;
+
+  // Lengths of 15 and up continue in the bytes that follow, each of them
+  // adding up to 255.
+  auto read_length = [&in, in_end](size_t* length) {
+    if (*length != 15) {
+      return true;
+    }
+    uint8_t byte = 255;
+    while (byte == 255) {
+      if (in == in_end) {
+        return false;
+      }
+      byte = *in++;
+      *length += byte;
+    }
+    return true;
+  };
+
+  while (in < in_end) {
+    const uint8_t token = *in++;
+
+    size_t literal_length = token >> 4;
+    if (!read_length(&literal_length) ||
+        literal_length > static_cast<size_t>(in_end - in) ||
+        literal_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+
+    // The last sequence of a block only has literals.
+    if (in == in_end) {
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    const size_t match_offset = in[0] | (in[1] << 8);
+    in += 2;
+    if (match_offset == 0 ||
+        match_offset > static_cast<size_t>(out - destination)) {
+      return false;
+    }
+
+    size_t match_length = token & 0xF;
+    if (!read_length(&match_length)) {
+      return false;
+    }
+    match_length += 4;
+    if (match_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    // Matches may overlap the bytes they produce, so copy them byte by byte.
+    const uint8_t* match = out - match_offset;
+    for (size_t i = 0; i < match_length; i++) {
+      out[i] = match[i];
+    }
+    out += match_length;
+  }
+
+  return out == out_end;
+}
+
+}  // namespace flutter
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+// Serves the assets of a bundle packed into a single file, so that a bundle is
+// read with one open and one mapping instead of a file per asset.
+//
+// All integers of the file are little endian. The file starts with a header:
+//
+//   char     magic[8]      "FLTPACK1"
+//   uint32_t entry_count
+//
+// followed by |entry_count| index entries:
+//
+//   uint32_t name_length
+//   char     name[name_length]
+//   uint32_t method        |Method|
+//   uint32_t block_size    Uncompressed size of every block but the last.
+//   uint64_t offset        From the start of the file.
+//   uint64_t size          Uncompressed size of the asset.
+//   uint64_t stored_size   Size of the data at |offset|.
+//
+// The data of stored entries is the asset itself and is handed out as a slice
+// of the mapping of the file, without copies. The data of compressed entries
+// is a table of the uint32_t compressed sizes of its blocks followed by the
+// blocks. Blocks are compressed independently, so the blocks of an asset can
+// be found and decompressed without decompressing the ones before.
+// Decompression happens when the asset is asked for, on the thread that asks
+// for it.
+class PackedAssetBundle : public AssetResolver {
+ public:
+  enum class Method : uint32_t {
+    // Not compressed. Packers should store small assets and assets that don't
+    // compress well, like images, this way.
+    kStored = 0,
+    // Blocks in the LZ4 block format, without frame headers.
+    kLZ4Blocks = 1,
+  };
+
+  explicit PackedAssetBundle(const fml::UniqueFD& file);
+
+  ~PackedAssetBundle() override;
+
+  // Decompresses a single block in the LZ4 block format into |destination|,
+  // which has to be exactly the size of the uncompressed block. Returns false
+  // if the block is malformed or doesn't decompress to that size.
+  static bool DecompressLZ4Block(const uint8_t* source,
+                                 size_t source_size,
+                                 uint8_t* destination,
+                                 size_t destination_size);
+
+ private:
+  struct Entry {
+    Method method = Method::kStored;
+    uint32_t block_size = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint64_t stored_size = 0;
+  };
+
+  std::shared_ptr<fml::FileMapping> mapping_;
+  std::unordered_map<std::string, Entry> entries_;
+  bool is_valid_ = false;
+
+  bool ReadIndex();
+
+  std::unique_ptr<fml::Mapping> Decompress(const std::string& asset_name,
+                                           const Entry& entry) const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  bool GetAssetNames(std::vector<std::string>* names) const override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -4,6 +4,9 @@
 
 #include "benchmarking.h"
 
+#include <string>
+
+#include "flutter/benchmarking/engine_benchmark_reporter.h"
 #include "flutter/fml/backtrace.h"
 #include "flutter/fml/icu_util.h"
 
@@ -11,9 +14,11 @@ namespace benchmarking {
 
 int Main(int argc, char** argv) {
   fml::InstallCrashHandler();
+  const std::string output_path =
+      EngineBenchmarkReporter::TakeOutputPath(&argc, argv);
   benchmark::Initialize(&argc, argv);
   fml::icu::InitializeICU("icudtl.dat");
-  ::benchmark::RunSpecifiedBenchmarks();
+  EngineBenchmarkReporter::RunSpecifiedBenchmarks(argv[0], output_path);
   return 0;
 }
 
@@ -0,0 +1,253 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/engine_benchmark_reporter.h"
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/benchmarking/memory_usage.h"
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/logging.h"
+#include "flutter/shell/version/version.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#if !defined(OS_WIN)
+#include <sys/utsname.h>
+#endif
+
+namespace benchmarking {
+
+// The suffixes of the aggregates the benchmark library adds to repeated and
+// complexity benchmarks.
+static constexpr const char* kAggregateSuffixes[] = {
+    "_mean", "_median", "_stddev", "_BigO", "_RMS",
+};
+
+static bool IsAggregate(const std::string& name) {
+  for (const char* suffix : kAggregateSuffixes) {
+    const std::string_view suffix_view(suffix);
+    if (name.size() > suffix_view.size() &&
+        name.compare(name.size() - suffix_view.size(), suffix_view.size(),
+                     suffix_view) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static double ToNanoseconds(double time, ::benchmark::TimeUnit unit) {
+  return time * 1e9 / ::benchmark::GetTimeUnitMultiplier(unit);
+}
+
+static std::string GetOperatingSystem() {
+#if defined(OS_WIN)
+  return "Windows";
+#else
+  struct utsname name = {};
+  if (uname(&name) != 0) {
+    return "unknown";
+  }
+  return std::string(name.sysname) + " " + name.release;
+#endif
+}
+
+static std::string GetArchitecture() {
+#if defined(OS_WIN)
+  return "unknown";
+#else
+  struct utsname name = {};
+  if (uname(&name) != 0) {
+    return "unknown";
+  }
+  return name.machine;
+#endif
+}
+
+static std::string GetCompiler() {
+#if defined(__clang__)
+  return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+  return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+static std::string GetTimestamp() {
+  const std::time_t now = std::time(nullptr);
+  char timestamp[32] = {};
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ",
+                std::gmtime(&now));
+  return timestamp;
+}
+
+static constexpr char kOutputFlag[] = "--engine_benchmark_out=";
+
+std::string EngineBenchmarkReporter::TakeOutputPath(int* argc, char** argv) {
+  std::string output_path;
+  int kept = 0;
+  for (int i = 0; i < *argc; i++) {
+    if (std::strncmp(argv[i], kOutputFlag, sizeof(kOutputFlag) - 1) == 0) {
+      output_path = argv[i] + sizeof(kOutputFlag) - 1;
+      continue;
+    }
+    argv[kept++] = argv[i];
+  }
+  *argc = kept;
+  return output_path;
+}
+
+void EngineBenchmarkReporter::RunSpecifiedBenchmarks(
+    const std::string& executable,
+    const std::string& output_path) {
+  if (output_path.empty()) {
+    ::benchmark::RunSpecifiedBenchmarks();
+    return;
+  }
+  EngineBenchmarkReporter reporter(
+      executable.substr(executable.find_last_of("/\\") + 1), output_path);
+  ::benchmark::RunSpecifiedBenchmarks(&reporter);
+}
+
+EngineBenchmarkReporter::EngineBenchmarkReporter(std::string suite,
+                                                 std::string output_path)
+    : suite_(std::move(suite)), output_path_(std::move(output_path)) {}
+
+EngineBenchmarkReporter::~EngineBenchmarkReporter() = default;
+
+// |benchmark::BenchmarkReporter|
+bool EngineBenchmarkReporter::ReportContext(const Context& context) {
+  const bool result = ConsoleReporter::ReportContext(context);
+  allocation_count_ = GetAllocationCount();
+  return result;
+}
+
+// |benchmark::BenchmarkReporter|
+void EngineBenchmarkReporter::ReportRuns(const std::vector<Run>& runs) {
+  const uint64_t allocation_count = GetAllocationCount();
+  const size_t peak_rss_bytes = GetPeakResidentBytes();
+  ConsoleReporter::ReportRuns(runs);
+
+  for (const auto& run : runs) {
+    if (run.error_occurred || IsAggregate(run.benchmark_name)) {
+      continue;
+    }
+    if (results_.empty() || results_.back().name != run.benchmark_name) {
+      Result result;
+      result.name = run.benchmark_name;
+      result.allocations = allocation_count - allocation_count_;
+      result.peak_rss_bytes = peak_rss_bytes;
+      results_.push_back(std::move(result));
+    }
+    Result& result = results_.back();
+    result.iterations.push_back(static_cast<int64_t>(run.iterations));
+    result.real_time_ns.push_back(
+        ToNanoseconds(run.GetAdjustedRealTime(), run.time_unit));
+    result.cpu_time_ns.push_back(
+        ToNanoseconds(run.GetAdjustedCPUTime(), run.time_unit));
+    for (const auto& counter : run.counters) {
+      result.counters[counter.first].push_back(counter.second.value);
+    }
+  }
+
+  // Leaves the allocations of the reporter out of the next benchmark.
+  allocation_count_ = GetAllocationCount();
+}
+
+// |benchmark::BenchmarkReporter|
+void EngineBenchmarkReporter::Finalize() {
+  ConsoleReporter::Finalize();
+  std::ofstream output(output_path_, std::ios::out | std::ios::trunc);
+  output << DescribeResults();
+  if (!output.good()) {
+    FML_LOG(ERROR) << "Could not write the benchmark results to "
+                   << output_path_ << ".";
+  }
+}
+
+std::string EngineBenchmarkReporter::DescribeResults() const {
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+  auto write_numbers = [&writer](const auto& numbers) {
+    writer.StartArray();
+    for (const auto number : numbers) {
+      if constexpr (std::is_floating_point_v<decltype(number)>) {
+        writer.Double(number);
+      } else {
+        writer.Int64(number);
+      }
+    }
+    writer.EndArray();
+  };
+
+  writer.StartObject();
+  writer.Key("schema_version");
+  writer.Int(kSchemaVersion);
+  writer.Key("suite");
+  writer.String(suite_.c_str());
+
+  writer.Key("environment");
+  writer.StartObject();
+  writer.Key("engine_version");
+  writer.String(flutter::GetFlutterEngineVersion());
+  writer.Key("os");
+  writer.String(GetOperatingSystem().c_str());
+  writer.Key("arch");
+  writer.String(GetArchitecture().c_str());
+  writer.Key("cpu_count");
+  writer.Uint(std::thread::hardware_concurrency());
+  writer.Key("compiler");
+  writer.String(GetCompiler().c_str());
+  writer.Key("build");
+#if defined(NDEBUG)
+  writer.String("release");
+#else
+  writer.String("debug");
+#endif
+  writer.Key("timestamp");
+  writer.String(GetTimestamp().c_str());
+  writer.EndObject();
+
+  writer.Key("benchmarks");
+  writer.StartArray();
+  for (const auto& result : results_) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(result.name.c_str());
+    writer.Key("iterations");
+    write_numbers(result.iterations);
+    writer.Key("real_time_ns");
+    write_numbers(result.real_time_ns);
+    writer.Key("cpu_time_ns");
+    write_numbers(result.cpu_time_ns);
+    writer.Key("counters");
+    writer.StartObject();
+    for (const auto& counter : result.counters) {
+      writer.Key(counter.first.c_str());
+      write_numbers(counter.second);
+    }
+    writer.EndObject();
+    writer.Key("allocations");
+    writer.Uint64(result.allocations);
+    writer.Key("peak_rss_bytes");
+    writer.Uint64(result.peak_rss_bytes);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  return buffer.GetString();
+}
+
+}  // namespace benchmarking
@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_BENCHMARKING_ENGINE_BENCHMARK_REPORTER_H_
+#define FLUTTER_BENCHMARKING_ENGINE_BENCHMARK_REPORTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "flutter/fml/macros.h"
+
+namespace benchmarking {
+
+// Prints the results of the benchmarks of an executable to the console and
+// writes them to a file as JSON, in a schema that is the same for all engine
+// benchmarks, so that results can be merged and compared against baselines
+// by //flutter/benchmarking/run_benchmarks.py:
+//
+//   {
+//     "schema_version": 1,
+//     "suite": "fml_benchmarks",
+//     "environment": {
+//       "engine_version": "...",
+//       "os": "Linux 5.4.0",
+//       "arch": "x86_64",
+//       "cpu_count": 8,
+//       "compiler": "...",
+//       "build": "release",
+//       "timestamp": "2020-07-01T12:00:00Z"
+//     },
+//     "benchmarks": [{
+//       "name": "BM_Example/64",
+//       "iterations": [1000, 1000, 1000],
+//       "real_time_ns": [101.5, 99.8, 100.2],
+//       "cpu_time_ns": [101.2, 99.6, 100.0],
+//       "counters": {"ItemsPerFrame": [10, 10, 10]},
+//       "allocations": 3000,
+//       "peak_rss_bytes": 12345678
+//     }]
+//   }
+//
+// There is a sample per repetition, see --benchmark_repetitions. The
+// aggregates that the benchmark library reports for repetitions are left out
+// as they can be computed from the samples.
+//
+// |allocations| counts the allocations made with operator new while the
+// benchmark ran, see |GetAllocationCount|. The benchmark library calibrates
+// the number of iterations by running the benchmark with growing iteration
+// counts first, so the count is only the exact count for the reported
+// iterations with --benchmark_min_time=0 or for benchmarks with a fixed
+// iteration count. |peak_rss_bytes| is the high-water mark of the resident
+// memory of the process once the benchmark ran, so it only grows from one
+// benchmark to the next.
+class EngineBenchmarkReporter : public ::benchmark::ConsoleReporter {
+ public:
+  static constexpr int kSchemaVersion = 1;
+
+  // Removes --engine_benchmark_out=<path> from the arguments, which the
+  // benchmark library would reject, and returns its path. Must be called
+  // before |benchmark::Initialize|.
+  static std::string TakeOutputPath(int* argc, char** argv);
+
+  // Runs the benchmarks that the arguments passed to |benchmark::Initialize|
+  // selected. The results are written to |output_path| unless it is empty.
+  // The suite is named after the |executable| path.
+  static void RunSpecifiedBenchmarks(const std::string& executable,
+                                     const std::string& output_path);
+
+  EngineBenchmarkReporter(std::string suite, std::string output_path);
+
+  ~EngineBenchmarkReporter() override;
+
+  // |benchmark::BenchmarkReporter|
+  bool ReportContext(const Context& context) override;
+
+  // |benchmark::BenchmarkReporter|
+  void ReportRuns(const std::vector<Run>& runs) override;
+
+  // |benchmark::BenchmarkReporter|
+  void Finalize() override;
+
+ private:
+  struct Result {
+    std::string name;
+    std::vector<int64_t> iterations;
+    std::vector<double> real_time_ns;
+    std::vector<double> cpu_time_ns;
+    std::map<std::string, std::vector<double>> counters;
+    uint64_t allocations = 0;
+    size_t peak_rss_bytes = 0;
+  };
+
+  const std::string suite_;
+  const std::string output_path_;
+  std::vector<Result> results_;
+  uint64_t allocation_count_ = 0;
+
+  std::string DescribeResults() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EngineBenchmarkReporter);
+};
+
+}  // namespace benchmarking
+
+#endif  // FLUTTER_BENCHMARKING_ENGINE_BENCHMARK_REPORTER_H_
@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/memory_usage.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "flutter/fml/build_config.h"
+
+#if !defined(OS_WIN)
+#include <sys/resource.h>
+#endif
+
+namespace benchmarking {
+
+static std::atomic<uint64_t> allocation_count(0);
+
+uint64_t GetAllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+size_t GetPeakResidentBytes() {
+#if defined(OS_WIN)
+  return 0;
+#else
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(OS_MACOSX)
+  // In bytes on macOS, in kilobytes everywhere else.
+  return usage.ru_maxrss;
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static void* CountedAllocate(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  // Zero byte allocations have to return a unique pointer.
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+// The engine is built without exceptions, so failing to allocate aborts, as
+// the operator new of the standard library does then.
+static void* CountedAllocateOrAbort(size_t size) {
+  void* pointer = CountedAllocate(size);
+  if (pointer == nullptr) {
+    std::abort();
+  }
+  return pointer;
+}
+
+}  // namespace benchmarking
+
+// The replacements are linked into every benchmark executable, so that the
+// allocations of the benchmarks can be counted without changing them.
+void* operator new(size_t size) {
+  return benchmarking::CountedAllocateOrAbort(size);
+}
+
+void* operator new[](size_t size) {
+  return benchmarking::CountedAllocateOrAbort(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return benchmarking::CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return benchmarking::CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,24 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_BENCHMARKING_MEMORY_USAGE_H_
+#define FLUTTER_BENCHMARKING_MEMORY_USAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace benchmarking {
+
+// The number of allocations made with the global operator new by the
+// benchmark executable so far. Allocations made with malloc directly, as C
+// libraries and Skia do, are not counted.
+uint64_t GetAllocationCount();
+
+// The high-water mark of the resident memory of the process in bytes, or zero
+// where it isn't known.
+size_t GetPeakResidentBytes();
+
+}  // namespace benchmarking
+
+#endif  // FLUTTER_BENCHMARKING_MEMORY_USAGE_H_
@@ -0,0 +1,243 @@
+#!/usr/bin/env python
+# Copyright 2013 The Flutter Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""
+Runs all the engine benchmarks of a build, merges their results into a single
+JSON file and compares them against a baseline.
+
+The benchmarks are built by //flutter/benchmarking:benchmarks. Each benchmark
+executable writes its results with --engine_benchmark_out, see
+engine_benchmark_reporter.h for the schema. The benchmarks run twice: once
+with repetitions for the times, and once with a single iteration per
+benchmark for the memory usage, so that the allocation counts don't depend on
+the iteration counts the benchmark library picks.
+
+The merged results have the schema:
+
+  {
+    "schema_version": 1,
+    "environment": {...},
+    "benchmarks": [{
+      "suite": "fml_benchmarks",
+      "name": "BM_Example/64",
+      "real_time_ns": [...],
+      "cpu_time_ns": [...],
+      "counters": {...},
+      "allocations_per_iteration": 12.0,
+      "peak_rss_bytes": 12345678
+    }]
+  }
+
+|allocations_per_iteration| includes the allocations of the setup of the
+benchmark outside of its loop.
+
+Times regress when their mean grew by more than --time-threshold and Welch's
+t statistic of the samples exceeds --t-threshold, so that noise doesn't fail
+the comparison. Allocations are deterministic and regress when they grew by
+more than --allocation-threshold.
+
+Example:
+
+  ./flutter/benchmarking/run_benchmarks.py --variant host_release \\
+      --output results.json --baseline baseline.json
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+SCHEMA_VERSION = 1
+
+buildroot_dir = os.path.abspath(os.path.join(os.path.realpath(__file__), '..', '..', '..'))
+out_dir = os.path.join(buildroot_dir, 'out')
+
+
+def GetBenchmarkExecutables():
+  executables = [
+      'shell_benchmarks',
+      'fml_benchmarks',
+      'flow_benchmarks',
+      'ui_benchmarks',
+  ]
+  if sys.platform.startswith('linux'):
+    executables += [
+        'txt_benchmarks',
+        'client_wrapper_benchmarks',
+        'common_cpp_benchmarks',
+        'flutter_linux_benchmarks',
+    ]
+  return executables
+
+
+def RunSuite(build_dir, executable, filter, extra_args):
+  executable_path = os.path.join(build_dir, executable)
+  if not os.path.exists(executable_path):
+    print('Skipping %s, it was not built.' % executable)
+    return None
+
+  handle, output_path = tempfile.mkstemp(suffix='.json')
+  os.close(handle)
+  try:
+    command = [
+        executable_path,
+        '--engine_benchmark_out=%s' % output_path,
+    ] + extra_args
+    if filter:
+      command.append('--benchmark_filter=%s' % filter)
+    print('Running "%s"' % ' '.join(command))
+    subprocess.check_call(command, cwd=build_dir)
+    with open(output_path) as output:
+      results = json.load(output)
+  finally:
+    os.remove(output_path)
+
+  if results.get('schema_version') != SCHEMA_VERSION:
+    raise Exception('%s wrote results of schema version %s, expected %s.' %
+                    (executable, results.get('schema_version'), SCHEMA_VERSION))
+  return results
+
+
+def RunBenchmarks(build_dir, filter, repetitions):
+  environment = None
+  benchmarks = []
+  for executable in GetBenchmarkExecutables():
+    timed = RunSuite(build_dir, executable, filter,
+                     ['--benchmark_repetitions=%d' % repetitions])
+    if timed is None:
+      continue
+    # A single iteration per benchmark, unless it asks for a fixed count.
+    measured = RunSuite(build_dir, executable, filter,
+                        ['--benchmark_min_time=0', '--benchmark_repetitions=1'])
+    memory = dict((benchmark['name'], benchmark)
+                  for benchmark in measured['benchmarks'])
+
+    environment = environment or timed['environment']
+    for benchmark in timed['benchmarks']:
+      result = {
+          'suite': timed['suite'],
+          'name': benchmark['name'],
+          'real_time_ns': benchmark['real_time_ns'],
+          'cpu_time_ns': benchmark['cpu_time_ns'],
+          'counters': benchmark['counters'],
+      }
+      if benchmark['name'] in memory:
+        usage = memory[benchmark['name']]
+        result['allocations_per_iteration'] = (
+            float(usage['allocations']) / max(1, sum(usage['iterations'])))
+        result['peak_rss_bytes'] = usage['peak_rss_bytes']
+      benchmarks.append(result)
+
+  return {
+      'schema_version': SCHEMA_VERSION,
+      'environment': environment or {},
+      'benchmarks': benchmarks,
+  }
+
+
+def MeanAndVariance(samples):
+  mean = sum(samples) / len(samples)
+  if len(samples) < 2:
+    return mean, 0.0
+  variance = sum((sample - mean) ** 2 for sample in samples) / (len(samples) - 1)
+  return mean, variance
+
+
+def WelchT(baseline, current):
+  baseline_mean, baseline_variance = MeanAndVariance(baseline)
+  current_mean, current_variance = MeanAndVariance(current)
+  error = math.sqrt(baseline_variance / len(baseline) +
+                    current_variance / len(current))
+  if error == 0:
+    return float('inf') if current_mean > baseline_mean else 0.0
+  return (current_mean - baseline_mean) / error
+
+
+def Compare(baseline, current, args):
+  baseline_benchmarks = dict(((benchmark['suite'], benchmark['name']), benchmark)
+                             for benchmark in baseline['benchmarks'])
+  regressions = []
+  for benchmark in current['benchmarks']:
+    key = (benchmark['suite'], benchmark['name'])
+    if key not in baseline_benchmarks:
+      print('%s/%s has no baseline.' % key)
+      continue
+    reference = baseline_benchmarks[key]
+
+    baseline_mean, _ = MeanAndVariance(reference['real_time_ns'])
+    current_mean, _ = MeanAndVariance(benchmark['real_time_ns'])
+    change = (current_mean - baseline_mean) / baseline_mean if baseline_mean else 0
+    t = WelchT(reference['real_time_ns'], benchmark['real_time_ns'])
+    if change > args.time_threshold and t > args.t_threshold:
+      regressions.append('%s/%s: time %.1fns -> %.1fns (%+.1f%%, t=%.1f)' %
+                         (key + (baseline_mean, current_mean, change * 100, t)))
+
+    if ('allocations_per_iteration' in reference and
+        'allocations_per_iteration' in benchmark):
+      baseline_allocations = reference['allocations_per_iteration']
+      current_allocations = benchmark['allocations_per_iteration']
+      if current_allocations > baseline_allocations * (1 + args.allocation_threshold):
+        regressions.append('%s/%s: allocations per iteration %.1f -> %.1f' %
+                           (key + (baseline_allocations, current_allocations)))
+
+  return regressions
+
+
+def main():
+  parser = argparse.ArgumentParser()
+  parser.add_argument('--variant', dest='variant', action='store',
+                      default='host_debug_unopt', help='The engine build variant to run.')
+  parser.add_argument('--build-dir', dest='build_dir', action='store',
+                      help='The build directory, instead of the one of --variant.')
+  parser.add_argument('--filter', dest='filter', action='store',
+                      help='Only run the benchmarks matching this regular expression.')
+  parser.add_argument('--repetitions', dest='repetitions', type=int, default=5,
+                      help='The number of time samples of each benchmark.')
+  parser.add_argument('--output', dest='output', action='store',
+                      help='The file to write the merged results to.')
+  parser.add_argument('--baseline', dest='baseline', action='store',
+                      help='The merged results to compare against.')
+  parser.add_argument('--time-threshold', dest='time_threshold', type=float, default=0.05,
+                      help='The relative growth of the mean time that is a regression.')
+  parser.add_argument('--t-threshold', dest='t_threshold', type=float, default=3.0,
+                      help='The Welch t statistic above which a growth is not noise.')
+  parser.add_argument('--allocation-threshold', dest='allocation_threshold', type=float,
+                      default=0.0, help='The relative growth of allocations that is a regression.')
+  args = parser.parse_args()
+
+  build_dir = args.build_dir or os.path.join(out_dir, args.variant)
+  results = RunBenchmarks(build_dir, args.filter, args.repetitions)
+
+  if args.output:
+    with open(args.output, 'w') as output:
+      json.dump(results, output, indent=2, sort_keys=True)
+
+  if not args.baseline:
+    return 0
+
+  with open(args.baseline) as baseline_file:
+    baseline = json.load(baseline_file)
+  if baseline.get('schema_version') != SCHEMA_VERSION:
+    print('The baseline has schema version %s, expected %s.' %
+          (baseline.get('schema_version'), SCHEMA_VERSION))
+    return 1
+
+  regressions = Compare(baseline, results, args)
+  if regressions:
+    print('Regressions against %s:' % args.baseline)
+    for regression in regressions:
+      print('  ' + regression)
+    return 1
+  print('No regressions against %s.' % args.baseline)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -41,15 +41,107 @@ std::string Settings::ToString() const {
   stream << "dump_skp_on_shader_compilation: " << dump_skp_on_shader_compilation
          << std::endl;
   stream << "cache_sksl: " << cache_sksl << std::endl;
+  stream << "pack_persistent_cache: " << pack_persistent_cache << std::endl;
+  stream << "persistent_cache_max_bytes: " << persistent_cache_max_bytes
+         << std::endl;
+  stream << "sksl_precompilation_budget_us: " << sksl_precompilation_budget_us
+         << std::endl;
+  stream << "record_shader_warm_up: " << record_shader_warm_up << std::endl;
+  stream << "shader_warm_up: " << shader_warm_up << std::endl;
+  stream << "glyph_warm_up:" << std::endl;
+  for (const auto& spec : glyph_warm_up) {
+    stream << "    " << spec << std::endl;
+  }
+  stream << "asset_access_manifest_path: " << asset_access_manifest_path
+         << std::endl;
+  stream << "record_asset_access_manifest: " << record_asset_access_manifest
+         << std::endl;
   stream << "endless_trace_buffer: " << endless_trace_buffer << std::endl;
   stream << "enable_dart_profiling: " << enable_dart_profiling << std::endl;
   stream << "disable_dart_asserts: " << disable_dart_asserts << std::endl;
   stream << "enable_observatory: " << enable_observatory << std::endl;
   stream << "observatory_host: " << observatory_host << std::endl;
   stream << "observatory_port: " << observatory_port << std::endl;
+  stream << "defer_observatory_startup: " << defer_observatory_startup
+         << std::endl;
   stream << "use_test_fonts: " << use_test_fonts << std::endl;
   stream << "enable_software_rendering: " << enable_software_rendering
          << std::endl;
+  stream << "raster_cache_max_bytes: " << raster_cache_max_bytes << std::endl;
+  stream << "raster_cache_max_unused_frames: "
+         << raster_cache_max_unused_frames << std::endl;
+  stream << "deferred_raster_cache_population: "
+         << deferred_raster_cache_population << std::endl;
+  stream << "raster_cache_atlas_max_entry_size: "
+         << raster_cache_atlas_max_entry_size << std::endl;
+  stream << "raster_cache_scale_tolerance: " << raster_cache_scale_tolerance
+         << std::endl;
+  stream << "raster_cache_cost_model: " << raster_cache_cost_model
+         << std::endl;
+  stream << "raster_cache_shadows: " << raster_cache_shadows << std::endl;
+  stream << "backdrop_filter_max_downsample: "
+         << backdrop_filter_max_downsample << std::endl;
+  stream << "reuse_filtered_backdrops: " << reuse_filtered_backdrops
+         << std::endl;
+  stream << "retain_raster_cache_on_teardown: "
+         << retain_raster_cache_on_teardown << std::endl;
+  stream << "layer_tree_pipeline_depth: " << layer_tree_pipeline_depth
+         << std::endl;
+  stream << "low_latency_pipeline: " << low_latency_pipeline << std::endl;
+  stream << "vulkan_present_mode: " << vulkan_present_mode << std::endl;
+  stream << "vulkan_max_frames_in_flight: " << vulkan_max_frames_in_flight
+         << std::endl;
+  stream << "predictive_frame_scheduling: " << predictive_frame_scheduling
+         << std::endl;
+  stream << "frame_aware_idle_notifications: "
+         << frame_aware_idle_notifications << std::endl;
+  stream << "skip_unchanged_frames: " << skip_unchanged_frames << std::endl;
+  stream << "adaptive_frame_rate: " << adaptive_frame_rate << std::endl;
+  stream << "profile_layer_costs: " << profile_layer_costs << std::endl;
+  stream << "performance_overlay_mode: " << performance_overlay_mode
+         << std::endl;
+  stream << "profile_sync: " << profile_sync << std::endl;
+  stream << "raster_thread_merger_max_lease_term: "
+         << raster_thread_merger_max_lease_term << std::endl;
+  stream << "adaptive_resource_cache: " << adaptive_resource_cache
+         << std::endl;
+  stream << "device_memory_mb: " << device_memory_mb << std::endl;
+  stream << "decoded_image_cache_max_bytes: " << decoded_image_cache_max_bytes
+         << std::endl;
+  stream << "enable_platform_image_decoders: "
+         << enable_platform_image_decoders << std::endl;
+  stream << "animated_image_look_ahead_frames: "
+         << animated_image_look_ahead_frames << std::endl;
+  stream << "animated_image_frame_cache_max_bytes: "
+         << animated_image_frame_cache_max_bytes << std::endl;
+  stream << "enable_canvas_command_buffer: " << enable_canvas_command_buffer
+         << std::endl;
+  stream << "enable_display_list: " << enable_display_list << std::endl;
+  stream << "path_cache_max_entries: " << path_cache_max_entries << std::endl;
+  stream << "paragraph_cache_max_bytes: " << paragraph_cache_max_bytes
+         << std::endl;
+  stream << "enable_skparagraph: " << enable_skparagraph << std::endl;
+  stream << "retain_unchanged_layers: " << retain_unchanged_layers
+         << std::endl;
+  stream << "snapshot_surface_pool_size: " << snapshot_surface_pool_size
+         << std::endl;
+  stream << "unref_queue_drain_budget_us: " << unref_queue_drain_budget_us
+         << std::endl;
+  stream << "io_upload_worker_count: " << io_upload_worker_count << std::endl;
+  stream << "layout_cache_max_bytes: " << layout_cache_max_bytes << std::endl;
+  stream << "parallel_preroll: " << parallel_preroll << std::endl;
+  stream << "parallel_paint: " << parallel_paint << std::endl;
+  stream << "timer_tolerance_ms: " << timer_tolerance_ms << std::endl;
+  stream << "message_batch_max_count: " << message_batch_max_count
+         << std::endl;
+  stream << "message_batch_budget_us: " << message_batch_budget_us
+         << std::endl;
+  stream << "jank_capture_path: " << jank_capture_path << std::endl;
+  stream << "jank_capture_budget_ms: " << jank_capture_budget_ms << std::endl;
+  stream << "jank_capture_slow_frame_count: " << jank_capture_slow_frame_count
+         << std::endl;
+  stream << "jank_capture_interval_s: " << jank_capture_interval_s
+         << std::endl;
   stream << "log_tag: " << log_tag << std::endl;
   stream << "icu_initialization_required: " << icu_initialization_required
          << std::endl;
@@ -32,8 +32,63 @@ class FrameTiming {
     return data_[phase] = value;
   }
 
+  // The time of the vsync that started the frame. The build starts once the UI
+  // thread handled the vsync, or later if the start was delayed, see
+  // |Settings::predictive_frame_scheduling|.
+  fml::TimePoint GetVsyncStart() const { return vsync_start_; }
+  void SetVsyncStart(fml::TimePoint value) { vsync_start_ = value; }
+
+  // The parts of the raster phase spent prerolling and painting the layer
+  // tree, and submitting the painted frame to the surface. Submitting flushes
+  // the GPU work of the frame and presents it.
+  fml::TimeDelta GetPrerollDuration() const { return preroll_duration_; }
+  void SetPrerollDuration(fml::TimeDelta duration) {
+    preroll_duration_ = duration;
+  }
+  fml::TimeDelta GetPaintDuration() const { return paint_duration_; }
+  void SetPaintDuration(fml::TimeDelta duration) { paint_duration_ = duration; }
+  fml::TimeDelta GetSubmitDuration() const { return submit_duration_; }
+  void SetSubmitDuration(fml::TimeDelta duration) {
+    submit_duration_ = duration;
+  }
+
+  // How many raster cache entries were drawn from, and how many could not be
+  // because they were not cached yet.
+  size_t GetRasterCacheHitCount() const { return raster_cache_hit_count_; }
+  size_t GetRasterCacheMissCount() const { return raster_cache_miss_count_; }
+  void SetRasterCacheCounts(size_t hits, size_t misses) {
+    raster_cache_hit_count_ = hits;
+    raster_cache_miss_count_ = misses;
+  }
+
+  // The time the GPU spent executing the work of the most recent frame whose
+  // GPU timing became available while this frame was rasterized. GPU work
+  // completes asynchronously, so this usually belongs to a frame one to three
+  // frames earlier. Zero when the surface cannot measure GPU time, or no new
+  // measurement became available.
+  fml::TimeDelta GetGpuRasterDuration() const { return gpu_raster_duration_; }
+  void SetGpuRasterDuration(fml::TimeDelta duration) {
+    gpu_raster_duration_ = duration;
+  }
+
+  // The number of newer frames that replaced a queued frame before this one
+  // was rasterized, see |Settings::low_latency_pipeline|. The build times are
+  // those of this frame.
+  size_t GetSupersededFrameCount() const { return superseded_frame_count_; }
+  void SetSupersededFrameCount(size_t count) {
+    superseded_frame_count_ = count;
+  }
+
  private:
   fml::TimePoint data_[kCount];
+  fml::TimePoint vsync_start_;
+  fml::TimeDelta preroll_duration_;
+  fml::TimeDelta paint_duration_;
+  fml::TimeDelta submit_duration_;
+  size_t raster_cache_hit_count_ = 0;
+  size_t raster_cache_miss_count_ = 0;
+  fml::TimeDelta gpu_raster_duration_;
+  size_t superseded_frame_count_ = 0;
 };
 
 using TaskObserverAdd =
@@ -93,10 +148,42 @@ struct Settings {
   bool start_paused = false;
   bool trace_skia = false;
   std::string trace_allowlist;
+  // Comma separated trace categories to trace events in. Empty traces all of
+  // them.
+  std::string trace_categories;
   bool trace_startup = false;
   bool trace_systrace = false;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
+  // Whether the persistent cache appends new shaders to a single packed file
+  // of its directory, instead of writing a file for each.
+  bool pack_persistent_cache = false;
+  // The bytes that the shaders of each packed persistent cache file may take,
+  // above which the least recently used ones are evicted. Zero doesn't limit
+  // them.
+  size_t persistent_cache_max_bytes = 0;
+  // The microseconds that precompiling the SkSLs found at startup may keep
+  // the raster thread busy at a time, before it yields to frames and
+  // continues later. Zero precompiles them all before the first frame.
+  size_t sksl_precompilation_budget_us = 0;
+  // Whether the raster thread records a draw op for each new pipeline key of
+  // the frames into the persistent cache, for |shader_warm_up| to replay in
+  // later runs.
+  bool record_shader_warm_up = false;
+  // Whether the draw ops recorded by |record_shader_warm_up| are replayed on
+  // the resource context at startup, so that their shaders are compiled
+  // before the first frame.
+  bool shader_warm_up = false;
+  // The glyphs rasterized on the resource context at idle time after launch,
+  // so that the first frames showing them don't rasterize them. Each spec is
+  // of the form "<font family>:<size>[,<size>...][:<characters>]", see
+  // |GlyphWarmUp::ParseSpec|.
+  std::vector<std::string> glyph_warm_up;
+  // The path of the manifest of the assets looked up before the first frame.
+  // The assets it lists are prefetched at launch, unless
+  // |record_asset_access_manifest| is set, in which case the run writes it.
+  std::string asset_access_manifest_path;
+  bool record_asset_access_manifest = false;
   bool endless_trace_buffer = false;
   bool enable_dart_profiling = false;
   bool disable_dart_asserts = false;
@@ -132,6 +219,13 @@ struct Settings {
   // after failing to bind to a specified port.
   bool enable_service_port_fallback = false;
 
+  // Whether the Dart VM service starts after the first frame of the first
+  // shell rather than along with the VM, so that it doesn't add to the cold
+  // start. The observatory URI is published once it is ready, as usual.
+  // Ignored when |start_paused| is set, as the debugger is needed before the
+  // first frame then.
+  bool defer_observatory_startup = false;
+
   // Font settings
   bool use_test_fonts = false;
 
@@ -173,6 +267,189 @@ struct Settings {
   UnhandledExceptionCallback unhandled_exception_callback;
   bool enable_software_rendering = false;
   bool skia_deterministic_rendering_on_cpu = false;
+  // The maximum number of bytes that the images held by the raster cache may
+  // occupy, or 0 for unlimited. When the budget is exceeded, the least recently
+  // used entries are evicted at the end of the frame.
+  size_t raster_cache_max_bytes = 0;
+  // The number of consecutive frames a raster cache entry may go unused before
+  // it is evicted. Entries not used in the last frame are still evicted early
+  // on a low memory warning.
+  size_t raster_cache_max_unused_frames = 0;
+  // Whether pictures that become worth raster caching are drawn directly and
+  // rasterized into the cache in the idle time after the frame is submitted,
+  // instead of synchronously during Preroll.
+  bool deferred_raster_cache_population = false;
+  // Raster cache entries whose device width and height are both at most this
+  // many pixels are packed into shared atlas textures. Zero disables the atlas.
+  int raster_cache_atlas_max_entry_size = 0;
+  // While the matrix a raster cache entry is drawn with is scaled by at most a
+  // factor of 1 + this tolerance, the cached image is stretched instead of
+  // being rasterized again until the scale settles. Zero disables the reuse.
+  double raster_cache_scale_tolerance = 0;
+  // Whether the raster cache admits pictures when the time caching them saves
+  // is expected to pay for rasterizing them, as estimated from their ops and
+  // calibrated by measurement, instead of after a fixed number of frames.
+  bool raster_cache_cost_model = false;
+  // Whether the shadows of physical shape layers are raster cached, so that
+  // identical shadows are only blurred once instead of in every frame.
+  bool raster_cache_shadows = false;
+  // The largest factor the backdrops of large blurs of backdrop filter layers
+  // may be downsampled by before being blurred. A value of one keeps them at
+  // full resolution.
+  int backdrop_filter_max_downsample = 1;
+  // Whether the filtered backdrops of backdrop filter layers are reused in the
+  // next frame when the content below them did not change.
+  bool reuse_filtered_backdrops = false;
+  // Whether the raster cache is kept when the surface is torn down, e.g. when
+  // the app goes to the background, so that it can be reused if the next
+  // surface renders with the same, still valid, GrContext.
+  bool retain_raster_cache_on_teardown = false;
+  // The number of layer trees that may be in flight between the UI and the
+  // raster thread, from 1 to 3. Zero picks the default for the platform.
+  int layer_tree_pipeline_depth = 0;
+  // Whether a layer tree produced while the previous one is still waiting for
+  // the raster thread replaces it, so that a raster thread that falls behind
+  // skips stale frames instead of rendering them late.
+  bool low_latency_pipeline = false;
+  // The present mode of Vulkan swapchains, one of "fifo", "fifo-relaxed" and
+  // "mailbox". Empty, or a mode the surface doesn't support, presents in FIFO
+  // mode.
+  std::string vulkan_present_mode;
+  // The number of frames that may be rendering or waiting to be presented in a
+  // Vulkan swapchain before the raster thread waits for the oldest one. Zero
+  // allows one frame per swapchain image.
+  size_t vulkan_max_frames_in_flight = 0;
+  // Whether the UI work of a frame is delayed after vsync for as long as the
+  // frame is still predicted to complete in time, as predicted from the build
+  // and raster durations of recent frames.
+  bool predictive_frame_scheduling = false;
+  // Whether the deadlines of the idle notifications sent to the root isolate
+  // end when the next frame's build is predicted to start, as predicted from
+  // the windows between recent frames, so that garbage collections don't run
+  // into frames of an animation.
+  bool frame_aware_idle_notifications = false;
+  // Whether frames whose layer tree paints the same content as the previous
+  // frame are dropped instead of being rasterized again.
+  bool skip_unchanged_frames = false;
+  // Whether the display is asked for a lower refresh rate while frames are
+  // built less often than it refreshes.
+  bool adaptive_frame_rate = false;
+  // Whether the preroll and paint time of each layer is measured, for the
+  // "LayerCosts" timeline events and the _flutter.getLayerCosts service
+  // protocol extension.
+  bool profile_layer_costs = false;
+  // How the performance overlay shows the statistics of the frames: empty
+  // for the full graphs, "lightweight" for graphs drawn as a single image
+  // each, or "export" to draw nothing and only report the frame times as
+  // trace counters.
+  std::string performance_overlay_mode;
+  // Whether the waits for the locks of the message loops and the latency and
+  // duration of their tasks are recorded into histograms, for the trace
+  // counters and the _flutter.getSyncProfile service protocol extension. See
+  // |fml::SyncProfiler|.
+  bool profile_sync = false;
+  // The longest lease term, in frames, that the raster and platform threads
+  // stay merged for when platform views keep appearing and disappearing. Each
+  // merge shortly after an unmerge doubles the lease term up to this. Zero
+  // keeps the lease terms of the external view embedder.
+  size_t raster_thread_merger_max_lease_term = 0;
+  // Whether the budget of Skia's resource cache grows past the one picked for
+  // the viewport when resources keep getting evicted and uploaded again, and
+  // shrinks under memory pressure. It is not adapted once the app set a budget
+  // of its own.
+  bool adaptive_resource_cache = false;
+  // The physical memory of the device in megabytes, or zero if it is not
+  // known. Used to size caches to the memory class of the device.
+  size_t device_memory_mb = 0;
+  // Whether the rasterizer may preroll independent layer subtrees concurrently
+  // on the worker threads of the VM's concurrent message loop.
+  bool parallel_preroll = false;
+  // Whether the rasterizer may record ranges of sibling layers of large scenes
+  // into deferred display lists on the worker threads of the VM's concurrent
+  // message loop, and replay them in order on the raster thread.
+  bool parallel_paint = false;
+  // How late, in milliseconds, delayed tasks on the UI and IO threads may run
+  // so that timers due close to each other share a wake up of the thread.
+  // Frame critical tasks always run on time. Zero runs every task on time.
+  int timer_tolerance_ms = 0;
+  // The most pending messages of the root isolate handled in one task on the
+  // UI thread, and the time in microseconds after which the rest are left to
+  // a later task so that frame work can run in between. One handles each
+  // message in its own task.
+  size_t message_batch_max_count = 1;
+  int64_t message_batch_budget_us = 2000;
+  // Records trace events into per thread ring buffers of this many events
+  // instead of sending them to the Dart timeline, also in release mode. Zero
+  // uses the Dart timeline.
+  size_t trace_ring_buffer_size = 0;
+  // The directory the rasterizer writes captures of jank to, see
+  // |JankWatchdog|. Empty captures nothing.
+  std::string jank_capture_path;
+  // The time in milliseconds a frame may take to build or to rasterize before
+  // it counts as slow. Zero uses the frame budget of the display.
+  int64_t jank_capture_budget_ms = 0;
+  // A capture is made when more than this many of the last 60 frames were
+  // slow.
+  size_t jank_capture_slow_frame_count = 2;
+  // The minimum time in seconds between two captures.
+  int64_t jank_capture_interval_s = 300;
+  // The maximum number of bytes of decoded images, and of the encoded data
+  // they were decoded from, that the image decoder keeps so that decoding the
+  // same data to the same size again reuses them. Zero keeps none, though
+  // concurrent decodes of the same image are still shared.
+  size_t decoded_image_cache_max_bytes = 0;
+  // Whether compressed images are decoded with the platform's image decoders,
+  // such as hardware JPEG and HEIF decoders, where the platform view provides
+  // them. Skia's codecs decode the images the platform decoders don't accept.
+  bool enable_platform_image_decoders = false;
+  // The number of frames of animated images decoded ahead of the frame last
+  // requested, on the worker threads. Zero decodes each frame when requested.
+  int animated_image_look_ahead_frames = 0;
+  // The maximum number of bytes of decoded frames that an animated image keeps
+  // so that later loops of short animations don't decode them again. Zero
+  // keeps none.
+  size_t animated_image_frame_cache_max_bytes = 0;
+  // Whether Canvas records its most frequent commands into a buffer on the
+  // Dart side and replays them in one native call, instead of making a native
+  // call for each command.
+  bool enable_canvas_command_buffer = false;
+  // Whether PictureRecorder records into an engine display list, which the
+  // raster thread can cull, fold opacity into and hash without playing it
+  // back, instead of into an SkPicture.
+  bool enable_display_list = false;
+  // The maximum number of paths that each isolate interns by their contents,
+  // so that paths rebuilt with the same contents every frame keep hitting
+  // Skia's caches of path masks and tessellations. Zero interns none.
+  size_t path_cache_max_entries = 0;
+  // The bytes of the paragraphs that each isolate keeps by the contents they
+  // were built with, so that paragraphs rebuilt with the same text and style
+  // reuse the lines and text blobs of the first one built. Zero keeps none.
+  size_t paragraph_cache_max_bytes = 0;
+  // Whether paragraphs are laid out by Skia's SkParagraph instead of libtxt.
+  // Only builds with flutter_enable_skshaper include SkParagraph; others lay
+  // out paragraphs with libtxt either way.
+  bool enable_skparagraph = false;
+  // Whether SceneBuilder keeps the layer passed as oldLayer to a push method in
+  // place of the layer it builds when both paint the same, so that unchanged
+  // layers keep their identity, and with it their raster cache entries, across
+  // frames.
+  bool retain_unchanged_layers = false;
+  // The number of offscreen surfaces the rasterizer keeps between the
+  // snapshots made by Picture.toImage and Scene.toImage, so that snapshots of
+  // the same size don't allocate a render target each. Zero keeps none.
+  size_t snapshot_surface_pool_size = 0;
+  // The microseconds of unrefs that each drain of the IO thread's queue of
+  // released GPU objects may take before it yields to other IO work, such as
+  // texture uploads, and continues later. Zero drains the queue at once.
+  size_t unref_queue_drain_budget_us = 0;
+  // The number of threads that upload decoded images to the GPU besides the
+  // IO thread, each with a resource context of its own. Only used where the
+  // platform can create several resource contexts.
+  size_t io_upload_worker_count = 0;
+  // The maximum number of bytes that the process-wide cache of shaped words
+  // may hold, or 0 for the default of 2 MiB. The cache is shared by all
+  // shells, so the last shell to set it wins.
+  size_t layout_cache_max_bytes = 0;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
 
@@ -187,6 +464,8 @@ struct Settings {
   // Assets settings
   fml::UniqueFD::element_type assets_dir =
       fml::UniqueFD::traits_type::InvalidValue();
+  // The flutter_assets directory, or a file the bundle was packed into. See
+  // |PackedAssetBundle|.
   std::string assets_path;
 
   // Callback to handle the timings of a rasterized frame. This is called as
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/backdrop_filter_cache.h"
+
+#include <utility>
+
+namespace flutter {
+
+BackdropFilterCache::BackdropFilterCache()
+    : memory_charge_(fml::MemoryCounter::Get("BackdropFilterCache")) {}
+
+BackdropFilterCache::~BackdropFilterCache() = default;
+
+void BackdropFilterCache::SetReuseEnabled(bool reuse_enabled) {
+  reuse_enabled_ = reuse_enabled;
+  if (!reuse_enabled_) {
+    Clear();
+  }
+}
+
+void BackdropFilterCache::BeginFrame(
+    SkCanvas* frame_canvas,
+    std::unordered_map<uint64_t, uint64_t> fingerprints) {
+  frame_canvas_ = frame_canvas;
+  previous_fingerprints_.clear();
+  for (const auto& item : fingerprints_) {
+    previous_fingerprints_.insert(item.second);
+  }
+  fingerprints_ = std::move(fingerprints);
+}
+
+std::optional<uint64_t> BackdropFilterCache::GetFingerprint(
+    uint64_t layer_id) const {
+  auto it = fingerprints_.find(layer_id);
+  if (it == fingerprints_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+const BackdropFilterCache::FilteredBackdrop* BackdropFilterCache::Get(
+    uint64_t fingerprint) {
+  auto it = entries_.find(fingerprint);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  it->second.used_this_frame = true;
+  return &it->second.backdrop;
+}
+
+void BackdropFilterCache::Put(uint64_t fingerprint,
+                              FilteredBackdrop backdrop) {
+  if (!reuse_enabled_ || !backdrop.image) {
+    return;
+  }
+  Entry& entry = entries_[fingerprint];
+  entry.backdrop = std::move(backdrop);
+  entry.used_this_frame = true;
+  UpdateMemoryCharge();
+}
+
+void BackdropFilterCache::EndFrame() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.used_this_frame) {
+      it->second.used_this_frame = false;
+      ++it;
+    } else {
+      it = entries_.erase(it);
+    }
+  }
+  frame_canvas_ = nullptr;
+  UpdateMemoryCharge();
+}
+
+void BackdropFilterCache::Clear() {
+  entries_.clear();
+  fingerprints_.clear();
+  previous_fingerprints_.clear();
+  UpdateMemoryCharge();
+}
+
+void BackdropFilterCache::UpdateMemoryCharge() {
+  int64_t bytes = 0;
+  for (const auto& item : entries_) {
+    const SkImage& image = *item.second.backdrop.image;
+    bytes += image.dimensions().area() * image.imageInfo().bytesPerPixel();
+  }
+  memory_charge_.Update(bytes);
+}
+
+}  // namespace flutter
@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_BACKDROP_FILTER_CACHE_H_
+#define FLUTTER_FLOW_BACKDROP_FILTER_CACHE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+// Holds the backdrops filtered by the backdrop filter layers of the last
+// frame, so that a layer whose backdrop did not change since, as told by the
+// fingerprints of the damage tracking (see DiffContext), draws the image it
+// filtered then instead of filtering its backdrop again. Also holds the
+// options of the backdrop filter layers for the frames of a compositor.
+//
+// A backdrop can only be filtered into an image while its layer paints
+// straight into the surface of the frame, as it is read back from the
+// surface.
+class BackdropFilterCache {
+ public:
+  // A backdrop filtered into an image covering |device_bounds|, which may
+  // have a lower resolution than the device.
+  struct FilteredBackdrop {
+    sk_sp<SkImage> image;
+    SkRect device_bounds = SkRect::MakeEmpty();
+  };
+
+  BackdropFilterCache();
+
+  ~BackdropFilterCache();
+
+  // Sets the largest factor the backdrops of large blurs may be downsampled
+  // by before being filtered, trading sharpness for speed. Blurs are only
+  // downsampled as long as their sigma stays at least two pixels. A value of
+  // one or less disables downsampling.
+  void SetMaxDownsample(int max_downsample) {
+    max_downsample_ = std::max(max_downsample, 1);
+  }
+
+  int GetMaxDownsample() const { return max_downsample_; }
+
+  // Sets whether filtered backdrops are reused across frames. Disabling it
+  // drops the cached backdrops.
+  void SetReuseEnabled(bool reuse_enabled);
+
+  bool GetReuseEnabled() const { return reuse_enabled_; }
+
+  // Starts a frame painted into |frame_canvas|, or into several canvases or
+  // offscreen if it is null. |fingerprints| are those of the backdrops of the
+  // frame by layer ID, see |DiffContext::TakeBackdropFingerprints|.
+  void BeginFrame(SkCanvas* frame_canvas,
+                  std::unordered_map<uint64_t, uint64_t> fingerprints);
+
+  // The canvas of the surface of the current frame, or null if backdrops
+  // cannot be read back from it.
+  SkCanvas* frame_canvas() const { return frame_canvas_; }
+
+  // The fingerprint of the backdrop of the layer with |layer_id| in the
+  // current frame, or std::nullopt if it is unknown.
+  std::optional<uint64_t> GetFingerprint(uint64_t layer_id) const;
+
+  // Whether a backdrop with |fingerprint| was also part of the previous frame,
+  // which makes it likely to be part of the next one as well.
+  bool WasInPreviousFrame(uint64_t fingerprint) const {
+    return previous_fingerprints_.count(fingerprint) > 0;
+  }
+
+  // Returns the backdrop filtered with |fingerprint|, or null if there is none.
+  const FilteredBackdrop* Get(uint64_t fingerprint);
+
+  void Put(uint64_t fingerprint, FilteredBackdrop backdrop);
+
+  // Drops the backdrops that the frame did not draw.
+  void EndFrame();
+
+  void Clear();
+
+  size_t GetCachedEntriesCount() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    FilteredBackdrop backdrop;
+    bool used_this_frame = false;
+  };
+
+  int max_downsample_ = 1;
+  bool reuse_enabled_ = false;
+  SkCanvas* frame_canvas_ = nullptr;
+  std::unordered_map<uint64_t, uint64_t> fingerprints_;
+  std::unordered_set<uint64_t> previous_fingerprints_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  // The bytes of the cached images, charged to the "BackdropFilterCache"
+  // counter.
+  fml::MemoryCharge memory_charge_;
+
+  void UpdateMemoryCharge();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BackdropFilterCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_BACKDROP_FILTER_CACHE_H_
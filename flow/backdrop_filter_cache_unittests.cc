@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/backdrop_filter_cache.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+BackdropFilterCache::FilteredBackdrop MakeBackdrop() {
+  return {SkSurface::MakeRasterN32Premul(10, 10)->makeImageSnapshot(),
+          SkRect::MakeWH(20, 20)};
+}
+
+}  // namespace
+
+TEST(BackdropFilterCache, ReusesBackdropsDrawnInThePreviousFrame) {
+  BackdropFilterCache cache;
+  cache.SetReuseEnabled(true);
+
+  cache.BeginFrame(nullptr, {{1, 100}});
+  EXPECT_EQ(cache.GetFingerprint(1), 100u);
+  EXPECT_FALSE(cache.GetFingerprint(2).has_value());
+  EXPECT_EQ(cache.Get(100), nullptr);
+  cache.Put(100, MakeBackdrop());
+  cache.EndFrame();
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 1u);
+
+  cache.BeginFrame(nullptr, {{1, 100}});
+  const BackdropFilterCache::FilteredBackdrop* backdrop = cache.Get(100);
+  ASSERT_NE(backdrop, nullptr);
+  EXPECT_EQ(backdrop->device_bounds, SkRect::MakeWH(20, 20));
+  cache.EndFrame();
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 1u);
+
+  // Backdrops that are not drawn in a frame are dropped.
+  cache.BeginFrame(nullptr, {{1, 200}});
+  EXPECT_EQ(cache.Get(200), nullptr);
+  cache.EndFrame();
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 0u);
+}
+
+TEST(BackdropFilterCache, RemembersFingerprintsOfThePreviousFrame) {
+  BackdropFilterCache cache;
+  cache.BeginFrame(nullptr, {{1, 100}});
+  EXPECT_FALSE(cache.WasInPreviousFrame(100));
+  cache.EndFrame();
+
+  cache.BeginFrame(nullptr, {{1, 200}});
+  EXPECT_TRUE(cache.WasInPreviousFrame(100));
+  EXPECT_FALSE(cache.WasInPreviousFrame(200));
+  cache.EndFrame();
+}
+
+TEST(BackdropFilterCache, DoesNotKeepBackdropsUnlessReuseIsEnabled) {
+  BackdropFilterCache cache;
+  cache.BeginFrame(nullptr, {{1, 100}});
+  cache.Put(100, MakeBackdrop());
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 0u);
+  cache.EndFrame();
+
+  cache.SetReuseEnabled(true);
+  cache.BeginFrame(nullptr, {{1, 100}});
+  cache.Put(100, MakeBackdrop());
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 1u);
+  cache.SetReuseEnabled(false);
+  EXPECT_EQ(cache.GetCachedEntriesCount(), 0u);
+}
+
+TEST(BackdropFilterCache, ClampsMaxDownsample) {
+  BackdropFilterCache cache;
+  EXPECT_EQ(cache.GetMaxDownsample(), 1);
+  cache.SetMaxDownsample(4);
+  EXPECT_EQ(cache.GetMaxDownsample(), 4);
+  cache.SetMaxDownsample(0);
+  EXPECT_EQ(cache.GetMaxDownsample(), 1);
+}
+
+}  // namespace testing
+}  // namespace flutter
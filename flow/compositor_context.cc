@@ -5,25 +5,49 @@
 #include "flutter/flow/compositor_context.h"
 
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkRegion.h"
 
 namespace flutter {
 
 CompositorContext::CompositorContext(fml::Milliseconds frame_budget)
-    : raster_time_(frame_budget), ui_time_(frame_budget) {}
+    : texture_registry_(std::make_shared<TextureRegistry>()),
+      raster_time_(frame_budget),
+      ui_time_(frame_budget),
+      gpu_time_(frame_budget) {}
 
 CompositorContext::~CompositorContext() = default;
 
+void CompositorContext::AddGpuFrameTime(fml::TimeDelta gpu_time) {
+  gpu_time_.SetLapTime(gpu_time);
+  has_gpu_time_ = true;
+  FML_TRACE_COUNTER("flutter", "GPURasterTime",
+                    reinterpret_cast<int64_t>(this),            //
+                    "Milliseconds", gpu_time.ToMillisecondsF()  //
+  );
+}
+
+void CompositorContext::SetLayerCostProfilingEnabled(bool enabled) {
+  if (!enabled) {
+    layer_cost_profiler_.reset();
+  } else if (!layer_cost_profiler_) {
+    layer_cost_profiler_ = std::make_unique<LayerCostProfiler>();
+  }
+}
+
 void CompositorContext::BeginFrame(ScopedFrame& frame,
                                    bool enable_instrumentation) {
   if (enable_instrumentation) {
     frame_count_.Increment();
     raster_time_.Start();
   }
+  texture_registry_->BeginFrame();
 }
 
 void CompositorContext::EndFrame(ScopedFrame& frame,
                                  bool enable_instrumentation) {
+  texture_registry_->EndFrame();
   raster_cache_.SweepAfterFrame();
   if (enable_instrumentation) {
     raster_time_.Stop();
@@ -71,6 +95,10 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
     bool ignore_raster_cache) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
+  const fml::TimePoint preroll_start = fml::TimePoint::Now();
+  preroll_duration_ = fml::TimeDelta::Zero();
+  paint_duration_ = fml::TimeDelta::Zero();
+  paint_concurrently_ = false;
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
@@ -82,9 +110,20 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (post_preroll_result == PostPrerollResult::kResubmitFrame) {
     return RasterStatus::kResubmit;
   }
+  damage_ = ComputeDamage(layer_tree, needs_save_layer);
+  const fml::TimePoint paint_start = fml::TimePoint::Now();
+  preroll_duration_ = paint_start - preroll_start;
+  if (damage_.has_value() && damage_->isEmpty()) {
+    // Nothing changed since the buffer was last rendered to.
+    return RasterStatus::kSuccess;
+  }
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
+    if (damage_.has_value()) {
+      canvas()->save();
+      canvas()->clipRegion(SkRegion(damage_.value()));
+    }
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
       SkRect bounds = SkRect::Make(layer_tree.frame_size());
@@ -94,21 +133,79 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     }
     canvas()->clear(SK_ColorTRANSPARENT);
   }
+  // Recordings are replayed into the whole surface, without the clip of the
+  // damage or the save layer on the canvas. Profiled layers are timed on one
+  // thread.
+  paint_concurrently_ = context_.concurrent_paint_task_runner() && canvas() &&
+                        canvas()->getSurface() && gr_context_ &&
+                        !view_embedder_ && !root_needs_readback &&
+                        !damage_.has_value() && !context_.layer_cost_profiler();
   layer_tree.Paint(*this, ignore_raster_cache);
+  context_.backdrop_filter_cache_.EndFrame();
   if (canvas() && needs_save_layer) {
     canvas()->restore();
   }
+  if (canvas() && damage_.has_value()) {
+    canvas()->restore();
+  }
+  paint_duration_ = fml::TimePoint::Now() - paint_start;
   return RasterStatus::kSuccess;
 }
 
-void CompositorContext::OnGrContextCreated() {
-  texture_registry_.OnGrContextCreated();
-  raster_cache_.Clear();
+std::optional<SkIRect> CompositorContext::ScopedFrame::ComputeDamage(
+    LayerTree& layer_tree,
+    bool needs_save_layer) {
+  DamageHistory& history = context_.damage_history_;
+  BackdropFilterCache& backdrop_cache = context_.backdrop_filter_cache_;
+  // Partial repaint and reading back backdrops from the surface need a single
+  // canvas to paint into. Partial repaint also needs the previous contents of
+  // the surface.
+  const bool single_canvas = canvas() && !view_embedder_ &&
+                             !needs_save_layer && layer_tree.root_layer();
+  const bool partial_repaint = single_canvas && surface_buffer_age_ > 0;
+  if (!partial_repaint) {
+    history.Reset();
+  }
+  // The fingerprints of the layers tell which backdrops are unchanged.
+  if (!partial_repaint &&
+      !(single_canvas && backdrop_cache.GetReuseEnabled())) {
+    backdrop_cache.BeginFrame(single_canvas ? canvas() : nullptr, {});
+    return std::nullopt;
+  }
+
+  TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::ComputeDamage");
+  DiffContext diff_context(root_surface_transformation_,
+                           context_.texture_registry_.get());
+  if (layer_tree.root_layer()->needs_painting()) {
+    layer_tree.root_layer()->Diff(&diff_context);
+  }
+  backdrop_cache.BeginFrame(
+      canvas(), backdrop_cache.GetReuseEnabled()
+                    ? diff_context.TakeBackdropFingerprints()
+                    : std::unordered_map<uint64_t, uint64_t>());
+  if (!partial_repaint) {
+    return std::nullopt;
+  }
+  return history.AddFrame(layer_tree.frame_size(), diff_context,
+                          surface_buffer_age_);
 }
 
-void CompositorContext::OnGrContextDestroyed() {
-  texture_registry_.OnGrContextDestroyed();
-  raster_cache_.Clear();
+void CompositorContext::OnGrContextCreated(bool retain_raster_cache) {
+  texture_registry_->OnGrContextCreated();
+  if (!retain_raster_cache) {
+    raster_cache_.Clear();
+  }
+  backdrop_filter_cache_.Clear();
+  damage_history_.Reset();
+}
+
+void CompositorContext::OnGrContextDestroyed(bool retain_raster_cache) {
+  texture_registry_->OnGrContextDestroyed();
+  if (!retain_raster_cache) {
+    raster_cache_.Clear();
+  }
+  backdrop_filter_cache_.Clear();
+  damage_history_.Reset();
 }
 
 }  // namespace flutter
@@ -8,10 +8,14 @@
 #include <memory>
 #include <string>
 
+#include "flutter/flow/backdrop_filter_cache.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layer_cost_profiler.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -64,6 +68,28 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
+    // The buffer age of the surface being rendered to, see
+    // |SurfaceFrame::buffer_age|. When known, |Raster| only repaints the
+    // region that changed since the buffer was last rendered to.
+    void set_surface_buffer_age(int buffer_age) {
+      surface_buffer_age_ = buffer_age;
+    }
+
+    // The region repainted by the last call to |Raster|, or std::nullopt if
+    // the whole frame was repainted.
+    const std::optional<SkIRect>& damage() const { return damage_; }
+
+    // The time the last call to |Raster| spent prerolling the layer tree,
+    // including computing the damage, and painting it.
+    fml::TimeDelta preroll_duration() const { return preroll_duration_; }
+    fml::TimeDelta paint_duration() const { return paint_duration_; }
+
+    // Whether the last call to |Raster| let the layer tree paint ranges of
+    // layers concurrently, see |SetConcurrentPaintTaskRunner|. Only frames
+    // that repaint the whole surface of a GPU canvas without platform views or
+    // reading back from the surface are painted concurrently.
+    bool paint_concurrently() const { return paint_concurrently_; }
+
     virtual RasterStatus Raster(LayerTree& layer_tree,
                                 bool ignore_raster_cache);
 
@@ -76,6 +102,16 @@ class CompositorContext {
     const bool instrumentation_enabled_;
     const bool surface_supports_readback_;
     fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
+    int surface_buffer_age_ = 0;
+    std::optional<SkIRect> damage_;
+    fml::TimeDelta preroll_duration_;
+    fml::TimeDelta paint_duration_;
+    bool paint_concurrently_ = false;
+
+    // Computes the region of the frame to repaint, or std::nullopt to repaint
+    // all of it, and starts the frame of the backdrop filter cache.
+    std::optional<SkIRect> ComputeDamage(LayerTree& layer_tree,
+                                         bool needs_save_layer);
 
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
@@ -93,13 +129,53 @@ class CompositorContext {
       bool surface_supports_readback,
       fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger);
 
-  void OnGrContextCreated();
+  // Called when rendering starts with a new GrContext. The raster cache is
+  // cleared unless |retain_raster_cache| is set, which the caller may only do
+  // when the context is the one the cache was populated with and it is still
+  // valid.
+  void OnGrContextCreated(bool retain_raster_cache = false);
 
-  void OnGrContextDestroyed();
+  // Called when the GrContext rendering was done with goes away. With
+  // |retain_raster_cache|, the raster cache keeps its entries in case the next
+  // surface renders with the same context.
+  void OnGrContextDestroyed(bool retain_raster_cache = false);
 
   RasterCache& raster_cache() { return raster_cache_; }
 
-  TextureRegistry& texture_registry() { return texture_registry_; }
+  BackdropFilterCache& backdrop_filter_cache() {
+    return backdrop_filter_cache_;
+  }
+
+  TextureRegistry& texture_registry() { return *texture_registry_; }
+
+  // The registry may be updated from other threads, which keep it alive while
+  // they do.
+  const std::shared_ptr<TextureRegistry>& shared_texture_registry() const {
+    return texture_registry_;
+  }
+
+  // Sets the task runner that layer trees may use to preroll independent
+  // subtrees concurrently, or nullptr to always preroll on the raster thread.
+  void SetConcurrentTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+    concurrent_task_runner_ = std::move(task_runner);
+  }
+
+  fml::ConcurrentTaskRunner* concurrent_task_runner() const {
+    return concurrent_task_runner_.get();
+  }
+
+  // Sets the task runner that layer trees may use to record ranges of layers
+  // into deferred display lists concurrently, or nullptr to always paint on
+  // the raster thread. See |ConcurrentPaintRecorder|.
+  void SetConcurrentPaintTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+    concurrent_paint_task_runner_ = std::move(task_runner);
+  }
+
+  fml::ConcurrentTaskRunner* concurrent_paint_task_runner() const {
+    return concurrent_paint_task_runner_.get();
+  }
 
   const Counter& frame_count() const { return frame_count_; }
 
@@ -107,12 +183,49 @@ class CompositorContext {
 
   Stopwatch& ui_time() { return ui_time_; }
 
+  // Records the GPU time of a frame as reported by the surface.
+  void AddGpuFrameTime(fml::TimeDelta gpu_time);
+
+  // The GPU frame times recorded so far, or nullptr if the surface has not
+  // reported any.
+  const Stopwatch* gpu_time() const {
+    return has_gpu_time_ ? &gpu_time_ : nullptr;
+  }
+
+  // Sets how the performance overlay layers of the frames show the statistics
+  // of the frames.
+  void SetPerformanceOverlayMode(PerformanceOverlayMode mode) {
+    performance_overlay_mode_ = mode;
+  }
+
+  PerformanceOverlayMode performance_overlay_mode() const {
+    return performance_overlay_mode_;
+  }
+
+  // Whether the preroll and paint time of each layer of the frames rastered
+  // from now on is measured. Must be called on the raster thread.
+  void SetLayerCostProfilingEnabled(bool enabled);
+
+  // The profiler of the layer costs, or nullptr if profiling is disabled.
+  LayerCostProfiler* layer_cost_profiler() const {
+    return layer_cost_profiler_.get();
+  }
+
  private:
   RasterCache raster_cache_;
-  TextureRegistry texture_registry_;
+  std::shared_ptr<TextureRegistry> texture_registry_;
+  DamageHistory damage_history_;
+  BackdropFilterCache backdrop_filter_cache_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_paint_task_runner_;
   Counter frame_count_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
+  Stopwatch gpu_time_;
+  bool has_gpu_time_ = false;
+  PerformanceOverlayMode performance_overlay_mode_ =
+      PerformanceOverlayMode::kGraphs;
+  std::unique_ptr<LayerCostProfiler> layer_cost_profiler_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
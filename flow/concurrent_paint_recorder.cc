@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/concurrent_paint_recorder.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkDeferredDisplayList.h"
+#include "third_party/skia/include/core/SkDeferredDisplayListRecorder.h"
+
+namespace flutter {
+
+ConcurrentPaintRecorder::ConcurrentPaintRecorder(
+    SkSurface* surface,
+    fml::ConcurrentTaskRunner* task_runner)
+    : surface_(surface), task_runner_(task_runner) {
+  // Only GPU surfaces can be characterized.
+  can_record_ = surface_ != nullptr && task_runner_ != nullptr &&
+                surface_->characterize(&characterization_);
+}
+
+ConcurrentPaintRecorder::~ConcurrentPaintRecorder() = default;
+
+bool ConcurrentPaintRecorder::PaintLayers(
+    Layer::PaintContext& context,
+    const std::vector<const Layer*>& layers) {
+  if (!can_record_ || layers.size() < 2) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "ConcurrentPaintRecorder::PaintLayers");
+
+  // The recordings start from the state of the canvas, in device space.
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  const SkMatrix matrix = canvas->getTotalMatrix();
+  const SkIRect clip = canvas->getDeviceClipBounds();
+
+  const size_t task_count = std::min<size_t>(
+      layers.size(), std::max(1u, std::thread::hardware_concurrency()));
+  const size_t range_size = (layers.size() + task_count - 1) / task_count;
+
+  struct Task {
+    size_t begin;
+    size_t end;
+    std::unique_ptr<SkDeferredDisplayList> display_list;
+  };
+  std::vector<Task> tasks;
+  for (size_t start = 0; start < layers.size(); start += range_size) {
+    tasks.push_back({start, std::min(start + range_size, layers.size())});
+  }
+
+  // Each range paints with its own copy of the context, made here since this
+  // thread keeps using |context| while the ranges are recorded. Backdrops are
+  // read from the surface when the recordings are replayed, so they can't use
+  // the filtered backdrops of the frame, which are read from the canvas.
+  Layer::PaintContext task_context_template = context;
+  task_context_template.gr_context = nullptr;
+  task_context_template.backdrop_filter_cache = nullptr;
+  task_context_template.concurrent_paint_recorder = nullptr;
+
+  auto record_range = [this, &task_context_template, &layers, &matrix,
+                       &clip](Task& task) {
+    TRACE_EVENT0("flutter", "ConcurrentPaintRecorder::RecordRange");
+    SkDeferredDisplayListRecorder recorder(characterization_);
+    SkCanvas* recording_canvas = recorder.getCanvas();
+    if (!recording_canvas) {
+      return;
+    }
+    recording_canvas->clipRect(SkRect::Make(clip));
+    recording_canvas->setMatrix(matrix);
+
+    Layer::PaintContext task_context = task_context_template;
+    task_context.internal_nodes_canvas = recording_canvas;
+    task_context.leaf_nodes_canvas = recording_canvas;
+    for (size_t i = task.begin; i < task.end; i++) {
+      layers[i]->Paint(task_context);
+    }
+    task.display_list = recorder.detach();
+  };
+
+  fml::CountDownLatch latch(tasks.size() - 1);
+  for (size_t i = 1; i < tasks.size(); i++) {
+    task_runner_->PostTaskWithAffinity(
+        [&record_range, &latch, task = &tasks[i]]() {
+          record_range(*task);
+          latch.CountDown();
+        },
+        i);
+  }
+
+  // The first range is painted into the canvas directly while the others are
+  // recorded, which also makes sure it is drawn before the recordings.
+  ConcurrentPaintRecorder* recorder = context.concurrent_paint_recorder;
+  context.concurrent_paint_recorder = nullptr;
+  for (size_t i = tasks[0].begin; i < tasks[0].end; i++) {
+    layers[i]->Paint(context);
+  }
+  latch.Wait();
+
+  for (size_t i = 1; i < tasks.size(); i++) {
+    if (tasks[i].display_list && surface_->draw(tasks[i].display_list.get())) {
+      continue;
+    }
+    // The range could not be recorded or replayed, so paint it directly.
+    FML_LOG(ERROR) << "Could not replay a deferred display list.";
+    for (size_t j = tasks[i].begin; j < tasks[i].end; j++) {
+      layers[j]->Paint(context);
+    }
+  }
+  context.concurrent_paint_recorder = recorder;
+  return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,54 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_CONCURRENT_PAINT_RECORDER_H_
+#define FLUTTER_FLOW_CONCURRENT_PAINT_RECORDER_H_
+
+#include <vector>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkSurfaceCharacterization.h"
+
+namespace flutter {
+
+/// Paints ranges of sibling layers concurrently into a GPU surface.
+///
+/// The calling thread paints the first range into the canvas of the surface
+/// while the concurrent workers record the other ranges into
+/// SkDeferredDisplayLists, which are then replayed into the surface in order.
+/// Replaying bypasses the canvas, so the layers must only be painted with
+/// transforms and the clip of the whole surface applied to it, see
+/// |ContainerLayer::PaintChildren|.
+///
+/// The layers must not paint external textures, whose frames can only be
+/// acquired on the raster thread, and the paint context must not profile the
+/// layers.
+class ConcurrentPaintRecorder {
+ public:
+  ConcurrentPaintRecorder(SkSurface* surface,
+                          fml::ConcurrentTaskRunner* task_runner);
+
+  ~ConcurrentPaintRecorder();
+
+  // Paints |layers| in order with |context|, whose leaf nodes canvas must be
+  // the canvas of the surface. Returns false without painting anything if the
+  // surface can't be recorded for, in which case the caller must paint them.
+  bool PaintLayers(Layer::PaintContext& context,
+                   const std::vector<const Layer*>& layers);
+
+ private:
+  SkSurface* surface_;
+  fml::ConcurrentTaskRunner* task_runner_;
+  SkSurfaceCharacterization characterization_;
+  bool can_record_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentPaintRecorder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_CONCURRENT_PAINT_RECORDER_H_
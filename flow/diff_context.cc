@@ -0,0 +1,216 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <tuple>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+static uint64_t FingerprintMatrix(const SkMatrix& matrix) {
+  std::size_t seed = fml::HashCombine();
+  for (int i = 0; i < 9; i++) {
+    fml::HashCombineSeed(seed, matrix[i]);
+  }
+  return seed;
+}
+
+static bool RegionLessThan(const PaintRegion& a, const PaintRegion& b) {
+  if (a.fingerprint != b.fingerprint) {
+    return a.fingerprint < b.fingerprint;
+  }
+  return std::tie(a.device_bounds.fLeft, a.device_bounds.fTop,
+                  a.device_bounds.fRight, a.device_bounds.fBottom) <
+         std::tie(b.device_bounds.fLeft, b.device_bounds.fTop,
+                  b.device_bounds.fRight, b.device_bounds.fBottom);
+}
+
+DiffContext::DiffContext(const SkMatrix& root_transformation,
+                         const TextureRegistry* texture_registry)
+    : matrix_(root_transformation),
+      texture_registry_(texture_registry),
+      fingerprint_(FingerprintMatrix(root_transformation)) {}
+
+DiffContext::~DiffContext() = default;
+
+DiffContext::AutoSubtree::AutoSubtree(DiffContext* context,
+                                      const SkMatrix& matrix,
+                                      uint64_t fingerprint)
+    : context_(context),
+      previous_matrix_(context->matrix_),
+      previous_fingerprint_(context->fingerprint_),
+      previous_child_index_(context->child_index_) {
+  context_->matrix_.preConcat(matrix);
+  context_->fingerprint_ =
+      fml::HashCombine(context_->fingerprint_, context_->child_index_,
+                       fingerprint, FingerprintMatrix(matrix));
+  context_->child_index_ = 0;
+}
+
+DiffContext::AutoSubtree::~AutoSubtree() {
+  context_->matrix_ = previous_matrix_;
+  context_->fingerprint_ = previous_fingerprint_;
+  context_->child_index_ = previous_child_index_ + 1;
+}
+
+void DiffContext::AddPaintRegion(const SkRect& bounds, uint64_t fingerprint) {
+  if (bounds.isEmpty()) {
+    child_index_++;
+    return;
+  }
+  SkRect device_bounds;
+  matrix_.mapRect(&device_bounds, bounds);
+  regions_.push_back(
+      {device_bounds, fml::HashCombine(fingerprint_, child_index_, fingerprint)});
+  child_index_++;
+}
+
+void DiffContext::AddVolatilePaintRegion(const SkRect& bounds) {
+  // The region itself makes sure the area is damaged once the layer goes away.
+  // While it is present, it is damaged unconditionally.
+  SkRect device_bounds;
+  matrix_.mapRect(&device_bounds, bounds);
+  volatile_damage_.join(device_bounds);
+  AddPaintRegion(bounds, 0);
+}
+
+void DiffContext::AddBackdropPaintRegion(uint64_t layer_id,
+                                         const SkRect& bounds,
+                                         const SkRect& device_input_bounds,
+                                         uint64_t fingerprint) {
+  if (volatile_damage_.intersects(device_input_bounds)) {
+    AddVolatilePaintRegion(bounds);
+    return;
+  }
+  std::size_t backdrop = fml::HashCombine(fingerprint);
+  for (const auto& region : regions_) {
+    if (region.device_bounds.intersects(device_input_bounds)) {
+      fml::HashCombineSeed(backdrop, region.fingerprint,
+                           FingerprintRect(region.device_bounds));
+    }
+  }
+  const size_t region_count = regions_.size();
+  AddPaintRegion(bounds, backdrop);
+  if (regions_.size() > region_count) {
+    const PaintRegion& region = regions_.back();
+    backdrop_fingerprints_[layer_id] = fml::HashCombine(
+        region.fingerprint, FingerprintRect(region.device_bounds));
+  }
+}
+
+uint64_t DiffContext::FingerprintRect(const SkRect& rect) {
+  return fml::HashCombine(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
+}
+
+uint64_t DiffContext::FingerprintRRect(const SkRRect& rrect) {
+  char buffer[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(buffer);
+  return std::hash<std::string_view>{}(
+      std::string_view(buffer, SkRRect::kSizeInMemory));
+}
+
+uint64_t DiffContext::FingerprintPath(const SkPath& path) {
+  // Paths are recreated for every frame so their generation IDs never match.
+  // Compare their contents instead.
+  std::vector<char> buffer(path.writeToMemory(nullptr));
+  path.writeToMemory(buffer.data());
+  return std::hash<std::string_view>{}(
+      std::string_view(buffer.data(), buffer.size()));
+}
+
+std::optional<uint64_t> DiffContext::FingerprintImageFilter(
+    const SkImageFilter& filter) {
+  // Filters are recreated for every frame too. Compare their serialized form.
+  sk_sp<SkData> data = filter.serialize();
+  if (!data) {
+    return std::nullopt;
+  }
+  return std::hash<std::string_view>{}(std::string_view(
+      static_cast<const char*>(data->data()), data->size()));
+}
+
+SkIRect DiffContext::ComputeDamage(const std::vector<PaintRegion>& previous,
+                                   const std::vector<PaintRegion>& current) {
+  std::vector<PaintRegion> sorted_previous(previous);
+  std::vector<PaintRegion> sorted_current(current);
+  std::sort(sorted_previous.begin(), sorted_previous.end(), RegionLessThan);
+  std::sort(sorted_current.begin(), sorted_current.end(), RegionLessThan);
+
+  std::vector<PaintRegion> changed;
+  std::set_symmetric_difference(sorted_previous.begin(), sorted_previous.end(),
+                                sorted_current.begin(), sorted_current.end(),
+                                std::back_inserter(changed), RegionLessThan);
+
+  SkRect damage = SkRect::MakeEmpty();
+  for (const auto& region : changed) {
+    damage.join(region.device_bounds);
+  }
+  // Anti-aliased edges may touch the pixels just outside of the bounds.
+  return damage.isEmpty() ? SkIRect::MakeEmpty()
+                          : damage.makeOutset(1, 1).roundOut();
+}
+
+DamageHistory::DamageHistory() = default;
+
+DamageHistory::~DamageHistory() = default;
+
+std::optional<SkIRect> DamageHistory::AddFrame(const SkISize& frame_size,
+                                               DiffContext& diff_context,
+                                               int buffer_age) {
+  const SkIRect frame_rect = SkIRect::MakeSize(frame_size);
+  std::vector<PaintRegion> regions = diff_context.TakeRegions();
+
+  SkIRect damage = frame_rect;
+  if (last_regions_.has_value() && frame_size == frame_size_ &&
+      !diff_context.has_full_damage()) {
+    damage = DiffContext::ComputeDamage(last_regions_.value(), regions);
+    if (!diff_context.volatile_damage().isEmpty()) {
+      damage.join(diff_context.volatile_damage().makeOutset(1, 1).roundOut());
+    }
+    if (!damage.intersect(frame_rect)) {
+      damage.setEmpty();
+    }
+  }
+
+  if (diff_context.has_full_damage()) {
+    last_regions_.reset();
+  } else {
+    last_regions_ = std::move(regions);
+  }
+  frame_size_ = frame_size;
+
+  damage_.push_front(damage);
+  while (damage_.size() > static_cast<size_t>(kMaxBufferAge)) {
+    damage_.pop_back();
+  }
+
+  // A buffer of age N was last rendered to N frames ago. It is missing the
+  // damage of the N - 1 frames since then in addition to this one.
+  if (buffer_age <= 0 || static_cast<size_t>(buffer_age) > damage_.size()) {
+    return std::nullopt;
+  }
+  SkIRect buffer_damage = SkIRect::MakeEmpty();
+  for (int i = 0; i < buffer_age; i++) {
+    buffer_damage.join(damage_[i]);
+  }
+  if (buffer_damage == frame_rect) {
+    return std::nullopt;
+  }
+  return buffer_damage;
+}
+
+void DamageHistory::Reset() {
+  frame_size_ = SkISize::MakeEmpty();
+  last_regions_.reset();
+  damage_.clear();
+}
+
+}  // namespace flutter
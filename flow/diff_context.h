@@ -0,0 +1,175 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DIFF_CONTEXT_H_
+#define FLUTTER_FLOW_DIFF_CONTEXT_H_
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+class TextureRegistry;
+
+// A region of the frame painted by a single layer along with a fingerprint of
+// everything that determines what the layer paints there (the layer contents,
+// the state applied by its ancestors and its position in the paint order).
+// Two frames painting the same set of regions with the same fingerprints
+// produce the same pixels.
+struct PaintRegion {
+  SkRect device_bounds;
+  uint64_t fingerprint;
+
+  bool operator==(const PaintRegion& other) const {
+    return fingerprint == other.fingerprint &&
+           device_bounds == other.device_bounds;
+  }
+};
+
+// Collects the paint regions of a prerolled layer tree. See |Layer::Diff|.
+class DiffContext {
+ public:
+  // |texture_registry| holds the external textures of the frame, if known,
+  // which lets texture layers tell whether their textures have new frames.
+  explicit DiffContext(const SkMatrix& root_transformation,
+                       const TextureRegistry* texture_registry = nullptr);
+
+  ~DiffContext();
+
+  // Applies the state of a layer with children for the lifetime of this
+  // object. |fingerprint| must describe everything the layer itself does to
+  // the output of its children other than transforming them by |matrix|.
+  class AutoSubtree {
+   public:
+    AutoSubtree(DiffContext* context,
+                const SkMatrix& matrix,
+                uint64_t fingerprint);
+
+    ~AutoSubtree();
+
+   private:
+    DiffContext* context_;
+    SkMatrix previous_matrix_;
+    uint64_t previous_fingerprint_;
+    uint64_t previous_child_index_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(AutoSubtree);
+  };
+
+  // Records that the layer with paint bounds |bounds| (in the coordinate space
+  // of the current subtree) paints content described by |fingerprint|.
+  void AddPaintRegion(const SkRect& bounds, uint64_t fingerprint);
+
+  // Records that the layer paints content that may differ in every frame, such
+  // as external textures.
+  void AddVolatilePaintRegion(const SkRect& bounds);
+
+  // Records that the layer with ID |layer_id| and paint bounds |bounds| paints
+  // the content painted before it within |device_input_bounds| through a
+  // filter described by |fingerprint|. The fingerprint of its region covers
+  // the regions painted before it that intersect its input, so the region
+  // changes whenever its backdrop does. Unless the backdrop is volatile, the
+  // fingerprint is also recorded as that of the filtered backdrop of the
+  // layer, see |TakeBackdropFingerprints|.
+  void AddBackdropPaintRegion(uint64_t layer_id,
+                              const SkRect& bounds,
+                              const SkRect& device_input_bounds,
+                              uint64_t fingerprint);
+
+  // Records that the frame cannot be partially repainted, for example because
+  // it contains platform views or reads back from the surface.
+  void MarkFullDamage() { full_damage_ = true; }
+
+  bool has_full_damage() const { return full_damage_; }
+
+  // The union of the device bounds of all volatile paint regions.
+  const SkRect& volatile_damage() const { return volatile_damage_; }
+
+  // The transformation from the current subtree to device coordinates.
+  const SkMatrix& matrix() const { return matrix_; }
+
+  const TextureRegistry* texture_registry() const { return texture_registry_; }
+
+  const std::vector<PaintRegion>& regions() const { return regions_; }
+
+  std::vector<PaintRegion> TakeRegions() { return std::move(regions_); }
+
+  // The fingerprints of the filtered backdrops of the frame by layer ID. Two
+  // backdrops with the same fingerprint produce the same pixels.
+  std::unordered_map<uint64_t, uint64_t> TakeBackdropFingerprints() {
+    return std::move(backdrop_fingerprints_);
+  }
+
+  static uint64_t FingerprintRect(const SkRect& rect);
+
+  static uint64_t FingerprintRRect(const SkRRect& rrect);
+
+  static uint64_t FingerprintPath(const SkPath& path);
+
+  // Returns std::nullopt if the filter cannot be serialized.
+  static std::optional<uint64_t> FingerprintImageFilter(
+      const SkImageFilter& filter);
+
+  // Computes the device region that differs between two frames described by
+  // their paint regions, rounded out to whole pixels.
+  static SkIRect ComputeDamage(const std::vector<PaintRegion>& previous,
+                               const std::vector<PaintRegion>& current);
+
+ private:
+  SkMatrix matrix_;
+  const TextureRegistry* texture_registry_;
+  uint64_t fingerprint_;
+  uint64_t child_index_ = 0;
+  SkRect volatile_damage_ = SkRect::MakeEmpty();
+  bool full_damage_ = false;
+  std::vector<PaintRegion> regions_;
+  std::unordered_map<uint64_t, uint64_t> backdrop_fingerprints_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DiffContext);
+};
+
+// Keeps the paint regions of the last frame and the damage of the last few
+// frames so that the region to repaint can be computed for a surface whose
+// buffer was last rendered to some number of frames ago.
+class DamageHistory {
+ public:
+  // The largest buffer age for which the damage can be reconstructed.
+  static constexpr int kMaxBufferAge = 4;
+
+  DamageHistory();
+
+  ~DamageHistory();
+
+  // Records a new frame and returns the region that must be repainted on a
+  // buffer of age |buffer_age| (as reported by EGL_EXT_buffer_age and similar
+  // extensions), or std::nullopt if the whole frame must be repainted.
+  std::optional<SkIRect> AddFrame(const SkISize& frame_size,
+                                  DiffContext& diff_context,
+                                  int buffer_age);
+
+  // Forgets all previous frames. The next frame is fully repainted.
+  void Reset();
+
+ private:
+  SkISize frame_size_ = SkISize::MakeEmpty();
+  std::optional<std::vector<PaintRegion>> last_regions_;
+  // Damage of the most recent frames, newest first.
+  std::deque<SkIRect> damage_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DamageHistory);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DIFF_CONTEXT_H_
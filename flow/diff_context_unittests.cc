@@ -0,0 +1,179 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/layer_test.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+using DiffContextTest = LayerTest;
+
+namespace {
+
+std::vector<PaintRegion> CollectRegions(Layer* root) {
+  DiffContext context(SkMatrix::I());
+  root->Diff(&context);
+  return context.TakeRegions();
+}
+
+}  // namespace
+
+TEST_F(DiffContextTest, RetainedLayersProduceNoDamage) {
+  auto child = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(10, 10, 20, 20)));
+
+  auto first = std::make_shared<ContainerLayer>();
+  first->Add(child);
+  first->Preroll(preroll_context(), SkMatrix::I());
+
+  auto second = std::make_shared<ContainerLayer>();
+  second->Add(child);
+  second->Preroll(preroll_context(), SkMatrix::I());
+
+  EXPECT_TRUE(DiffContext::ComputeDamage(CollectRegions(first.get()),
+                                         CollectRegions(second.get()))
+                  .isEmpty());
+}
+
+TEST_F(DiffContextTest, RebuiltLayersAreDamaged) {
+  const SkPath path = SkPath().addRect(SkRect::MakeLTRB(10, 10, 20, 20));
+
+  auto first = std::make_shared<ContainerLayer>();
+  first->Add(std::make_shared<MockLayer>(path));
+  first->Preroll(preroll_context(), SkMatrix::I());
+
+  auto second = std::make_shared<ContainerLayer>();
+  second->Add(std::make_shared<MockLayer>(path));
+  second->Preroll(preroll_context(), SkMatrix::I());
+
+  EXPECT_EQ(DiffContext::ComputeDamage(CollectRegions(first.get()),
+                                       CollectRegions(second.get())),
+            SkIRect::MakeLTRB(9, 9, 21, 21));
+}
+
+TEST_F(DiffContextTest, TransformChangesDamageOldAndNewBounds) {
+  auto child = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(0, 0, 10, 10)));
+
+  auto first = std::make_shared<TransformLayer>(SkMatrix::Translate(10, 0));
+  first->Add(child);
+  first->Preroll(preroll_context(), SkMatrix::I());
+
+  auto second = std::make_shared<TransformLayer>(SkMatrix::Translate(30, 0));
+  second->Add(child);
+  second->Preroll(preroll_context(), SkMatrix::I());
+
+  EXPECT_EQ(DiffContext::ComputeDamage(CollectRegions(first.get()),
+                                       CollectRegions(second.get())),
+            SkIRect::MakeLTRB(9, -1, 41, 11));
+}
+
+TEST_F(DiffContextTest, OpacityChangesDamageChildren) {
+  auto child = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(0, 0, 10, 10)));
+
+  auto first = std::make_shared<OpacityLayer>(128, SkPoint::Make(0, 0));
+  first->Add(child);
+  first->Preroll(preroll_context(), SkMatrix::I());
+
+  auto same = std::make_shared<OpacityLayer>(128, SkPoint::Make(0, 0));
+  same->Add(child);
+  same->Preroll(preroll_context(), SkMatrix::I());
+
+  auto other = std::make_shared<OpacityLayer>(64, SkPoint::Make(0, 0));
+  other->Add(child);
+  other->Preroll(preroll_context(), SkMatrix::I());
+
+  EXPECT_TRUE(DiffContext::ComputeDamage(CollectRegions(first.get()),
+                                         CollectRegions(same.get()))
+                  .isEmpty());
+  EXPECT_FALSE(DiffContext::ComputeDamage(CollectRegions(first.get()),
+                                          CollectRegions(other.get()))
+                   .isEmpty());
+}
+
+TEST(DamageHistoryTest, AccumulatesDamageForOlderBuffers) {
+  const SkISize frame_size = SkISize::Make(100, 100);
+  DamageHistory history;
+
+  auto add_frame = [&](const SkRect& bounds, uint64_t fingerprint,
+                       int buffer_age) {
+    DiffContext context(SkMatrix::I());
+    context.AddPaintRegion(bounds, fingerprint);
+    return history.AddFrame(frame_size, context, buffer_age);
+  };
+
+  // Nothing to compare to for the first frame.
+  EXPECT_FALSE(add_frame(SkRect::MakeLTRB(0, 0, 10, 10), 1, 1).has_value());
+
+  auto damage = add_frame(SkRect::MakeLTRB(0, 0, 10, 10), 1, 1);
+  ASSERT_TRUE(damage.has_value());
+  EXPECT_TRUE(damage->isEmpty());
+
+  damage = add_frame(SkRect::MakeLTRB(50, 50, 60, 60), 2, 1);
+  ASSERT_TRUE(damage.has_value());
+  EXPECT_EQ(damage.value(), SkIRect::MakeLTRB(0, 0, 61, 61));
+
+  // An unchanged frame on a buffer rendered two frames ago still needs the
+  // damage of the previous frame.
+  damage = add_frame(SkRect::MakeLTRB(50, 50, 60, 60), 2, 2);
+  ASSERT_TRUE(damage.has_value());
+  EXPECT_FALSE(damage->isEmpty());
+
+  // Unknown buffer contents.
+  EXPECT_FALSE(add_frame(SkRect::MakeLTRB(50, 50, 60, 60), 2, 0).has_value());
+
+  // Resizing repaints everything.
+  DiffContext context(SkMatrix::I());
+  context.AddPaintRegion(SkRect::MakeLTRB(50, 50, 60, 60), 2);
+  EXPECT_FALSE(
+      history.AddFrame(SkISize::Make(200, 200), context, 1).has_value());
+}
+
+TEST(DamageHistoryTest, FullDamageRepaintsEverything) {
+  DamageHistory history;
+  for (int i = 0; i < 3; i++) {
+    DiffContext context(SkMatrix::I());
+    context.MarkFullDamage();
+    EXPECT_FALSE(
+        history.AddFrame(SkISize::Make(100, 100), context, 1).has_value());
+  }
+}
+
+TEST_F(DiffContextTest, BackdropFingerprintsTrackRegionsBelowInput) {
+  auto backdrop_fingerprint = [](const SkRect& below_bounds,
+                                 uint64_t below_fingerprint) {
+    DiffContext context(SkMatrix::I());
+    context.AddPaintRegion(SkRect::MakeLTRB(0, 0, 10, 10), 1);
+    context.AddPaintRegion(below_bounds, below_fingerprint);
+    context.AddBackdropPaintRegion(42, SkRect::MakeLTRB(0, 0, 50, 50),
+                                   SkRect::MakeLTRB(0, 0, 60, 60), 3);
+    auto fingerprints = context.TakeBackdropFingerprints();
+    EXPECT_EQ(fingerprints.size(), 1u);
+    return fingerprints[42];
+  };
+
+  const uint64_t fingerprint =
+      backdrop_fingerprint(SkRect::MakeLTRB(20, 20, 30, 30), 2);
+  EXPECT_EQ(backdrop_fingerprint(SkRect::MakeLTRB(20, 20, 30, 30), 2),
+            fingerprint);
+  // Content changing under the input of the filter changes the backdrop.
+  EXPECT_NE(backdrop_fingerprint(SkRect::MakeLTRB(20, 20, 30, 30), 4),
+            fingerprint);
+  EXPECT_NE(backdrop_fingerprint(SkRect::MakeLTRB(25, 25, 35, 35), 2),
+            fingerprint);
+  // Content outside of it doesn't.
+  EXPECT_EQ(backdrop_fingerprint(SkRect::MakeLTRB(80, 80, 90, 90), 2),
+            backdrop_fingerprint(SkRect::MakeLTRB(70, 70, 80, 80), 4));
+}
+
+}  // namespace testing
+}  // namespace flutter
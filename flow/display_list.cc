@@ -0,0 +1,871 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list.h"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "flutter/fml/hash.h"
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkM44.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRRect.h"
+
+namespace flutter {
+
+enum class DisplayListOpType : uint32_t {
+  kSave,
+  kSaveLayer,
+  kRestore,
+  kTranslate,
+  kScale,
+  kConcat,
+  kConcat44,
+  kSetMatrix,
+  kClipRect,
+  kClipRRect,
+  kClipPath,
+  kClipRegion,
+
+  // The draws, which each have bounds.
+  kDrawPaint,
+  kFirstDraw = kDrawPaint,
+  kDrawPoints,
+  kDrawRect,
+  kDrawOval,
+  kDrawArc,
+  kDrawRRect,
+  kDrawDRRect,
+  kDrawPath,
+  kDrawTextBlob,
+  kDrawVertices,
+  kDrawImage,
+  kDrawImageRect,
+  kDrawPicture,
+};
+
+namespace {
+
+using OpType = DisplayListOpType;
+
+// The index of the objects ops are made without, like the paint of an image
+// draw or the backdrop of a save layer.
+constexpr uint32_t kNoIndex = UINT32_MAX;
+
+// The bounds of the nested pictures, which should not cull anything.
+constexpr SkRect kNestedPictureBounds =
+    SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
+
+// The arguments of the ops. They are copied in and out of the op buffer, so
+// they must be made of 32-bit fields only, which leaves no padding for the
+// content hash to read.
+struct OpHeader {
+  OpType type;
+  // The size of the arguments following the header.
+  uint32_t size;
+};
+
+struct SaveLayerOp {
+  SkRect bounds;
+  uint32_t has_bounds;
+  uint32_t paint;
+  uint32_t backdrop;
+  uint32_t flags;
+};
+
+struct PointOp {
+  SkScalar x;
+  SkScalar y;
+};
+
+struct MatrixOp {
+  SkMatrix matrix;
+};
+
+struct Matrix44Op {
+  SkM44 matrix;
+};
+
+struct ClipRectOp {
+  SkRect rect;
+  uint32_t op;
+  uint32_t anti_alias;
+};
+
+struct ClipRRectOp {
+  SkRRect rrect;
+  uint32_t op;
+  uint32_t anti_alias;
+};
+
+struct ClipPathOp {
+  uint32_t path;
+  uint32_t op;
+  uint32_t anti_alias;
+};
+
+struct ClipRegionOp {
+  uint32_t region;
+  uint32_t op;
+};
+
+struct PaintOp {
+  uint32_t paint;
+};
+
+struct PointsOp {
+  uint32_t mode;
+  uint32_t first_point;
+  uint32_t count;
+  uint32_t paint;
+};
+
+struct RectOp {
+  SkRect rect;
+  uint32_t paint;
+};
+
+struct ArcOp {
+  SkRect oval;
+  SkScalar start_angle;
+  SkScalar sweep_angle;
+  uint32_t use_center;
+  uint32_t paint;
+};
+
+struct RRectOp {
+  SkRRect rrect;
+  uint32_t paint;
+};
+
+struct DRRectOp {
+  SkRRect outer;
+  SkRRect inner;
+  uint32_t paint;
+};
+
+struct PathOp {
+  uint32_t path;
+  uint32_t paint;
+};
+
+struct TextBlobOp {
+  uint32_t blob;
+  SkScalar x;
+  SkScalar y;
+  uint32_t paint;
+};
+
+struct VerticesOp {
+  uint32_t vertices;
+  uint32_t mode;
+  uint32_t paint;
+};
+
+struct ImageOp {
+  uint32_t image;
+  SkScalar left;
+  SkScalar top;
+  uint32_t paint;
+};
+
+struct ImageRectOp {
+  uint32_t image;
+  uint32_t has_src;
+  SkRect src;
+  SkRect dst;
+  uint32_t paint;
+  uint32_t constraint;
+};
+
+struct PictureOp {
+  uint32_t picture;
+};
+
+template <typename Op>
+Op ReadOp(const uint8_t* args) {
+  Op op;
+  memcpy(&op, args, sizeof(op));
+  return op;
+}
+
+// The fields of a paint that are hashed, for paints without any objects.
+struct PaintKey {
+  SkColor4f color;
+  SkScalar stroke_width;
+  SkScalar stroke_miter;
+  uint32_t blend_mode;
+  uint32_t style;
+  uint32_t cap;
+  uint32_t join;
+  uint32_t anti_alias;
+  uint32_t dither;
+  uint32_t filter_quality;
+};
+
+bool HasObjects(const SkPaint& paint) {
+  return paint.getShader() || paint.getColorFilter() ||
+         paint.getMaskFilter() || paint.getImageFilter() ||
+         paint.getPathEffect();
+}
+
+std::optional<uint64_t> HashPath(const SkPath& path, uint64_t seed) {
+  if (path.getSegmentMasks() & SkPath::kConic_SegmentMask) {
+    // The weights of the conics aren't public.
+    return std::nullopt;
+  }
+  std::vector<SkPoint> points(path.countPoints());
+  path.getPoints(points.data(), points.size());
+  std::vector<uint8_t> verbs(path.countVerbs());
+  path.getVerbs(verbs.data(), verbs.size());
+  uint64_t hash = fml::HashMix(seed, static_cast<uint64_t>(path.getFillType()));
+  hash = fml::HashBytes(points.data(), points.size() * sizeof(SkPoint), hash);
+  return fml::HashBytes(verbs.data(), verbs.size(), hash);
+}
+
+std::atomic<uint64_t> next_unique_id{uint64_t{1} << 32};
+
+}  // namespace
+
+DisplayList::DisplayList() : unique_id_(next_unique_id++) {}
+
+DisplayList::~DisplayList() = default;
+
+size_t DisplayList::bytes_used() const {
+  size_t bytes = sizeof(DisplayList) + ops_.capacity() +
+                 draw_bounds_.capacity() * sizeof(SkRect) +
+                 paints_.capacity() * sizeof(SkPaint) +
+                 points_.capacity() * sizeof(SkPoint) +
+                 regions_.capacity() * sizeof(SkRegion) +
+                 (images_.capacity() + text_blobs_.capacity() +
+                  vertices_.capacity() + backdrops_.capacity() +
+                  pictures_.capacity()) *
+                     sizeof(void*);
+  for (const SkPath& path : paths_) {
+    bytes += path.approximateBytesUsed();
+  }
+  for (const sk_sp<SkVertices>& vertices : vertices_) {
+    bytes += vertices->approximateSize();
+  }
+  for (const sk_sp<SkPicture>& picture : pictures_) {
+    bytes += picture->approximateBytesUsed();
+  }
+  return bytes;
+}
+
+void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
+  SkAutoCanvasRestore restore(canvas, true);
+  if (opacity >= SK_Scalar1 || can_apply_opacity_) {
+    Render(canvas, opacity);
+    return;
+  }
+  canvas->saveLayerAlpha(&bounds_, SkScalarRoundToInt(opacity * 255));
+  Render(canvas, SK_Scalar1);
+}
+
+sk_sp<SkPicture> DisplayList::ToSkPicture() const {
+  SkPictureRecorder recorder;
+  Render(recorder.beginRecording(cull_rect_), SK_Scalar1);
+  return recorder.finishRecordingAsPicture();
+}
+
+void DisplayList::Render(SkCanvas* canvas, SkScalar opacity) const {
+  const SkMatrix initial_matrix = canvas->getTotalMatrix();
+  const SkRect clip_bounds = canvas->getLocalClipBounds();
+  SkPaint storage;
+  auto paint = [&](uint32_t index) -> const SkPaint* {
+    if (opacity >= SK_Scalar1) {
+      return index == kNoIndex ? nullptr : &paints_[index];
+    }
+    storage = index == kNoIndex ? SkPaint() : paints_[index];
+    storage.setAlphaf(storage.getAlphaf() * opacity);
+    return &storage;
+  };
+
+  size_t draw = 0;
+  size_t offset = 0;
+  while (offset < ops_.size()) {
+    const OpHeader header = ReadOp<OpHeader>(ops_.data() + offset);
+    const uint8_t* args = ops_.data() + offset + sizeof(OpHeader);
+    offset += sizeof(OpHeader) + header.size;
+    if (header.type >= OpType::kFirstDraw &&
+        !clip_bounds.intersects(draw_bounds_[draw++])) {
+      continue;
+    }
+
+    switch (header.type) {
+      case OpType::kSave:
+        canvas->save();
+        break;
+      case OpType::kSaveLayer: {
+        const auto op = ReadOp<SaveLayerOp>(args);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(
+            op.has_bounds ? &op.bounds : nullptr, paint(op.paint),
+            op.backdrop == kNoIndex ? nullptr : backdrops_[op.backdrop].get(),
+            op.flags));
+        break;
+      }
+      case OpType::kRestore:
+        canvas->restore();
+        break;
+      case OpType::kTranslate: {
+        const auto op = ReadOp<PointOp>(args);
+        canvas->translate(op.x, op.y);
+        break;
+      }
+      case OpType::kScale: {
+        const auto op = ReadOp<PointOp>(args);
+        canvas->scale(op.x, op.y);
+        break;
+      }
+      case OpType::kConcat:
+        canvas->concat(ReadOp<MatrixOp>(args).matrix);
+        break;
+      case OpType::kConcat44:
+        canvas->concat(ReadOp<Matrix44Op>(args).matrix);
+        break;
+      case OpType::kSetMatrix:
+        // The matrix is relative to the matrix the ops are drawn with.
+        canvas->setMatrix(
+            SkMatrix::Concat(initial_matrix, ReadOp<MatrixOp>(args).matrix));
+        break;
+      case OpType::kClipRect: {
+        const auto op = ReadOp<ClipRectOp>(args);
+        canvas->clipRect(op.rect, static_cast<SkClipOp>(op.op),
+                         op.anti_alias != 0);
+        break;
+      }
+      case OpType::kClipRRect: {
+        const auto op = ReadOp<ClipRRectOp>(args);
+        canvas->clipRRect(op.rrect, static_cast<SkClipOp>(op.op),
+                          op.anti_alias != 0);
+        break;
+      }
+      case OpType::kClipPath: {
+        const auto op = ReadOp<ClipPathOp>(args);
+        canvas->clipPath(paths_[op.path], static_cast<SkClipOp>(op.op),
+                         op.anti_alias != 0);
+        break;
+      }
+      case OpType::kClipRegion: {
+        const auto op = ReadOp<ClipRegionOp>(args);
+        canvas->clipRegion(regions_[op.region], static_cast<SkClipOp>(op.op));
+        break;
+      }
+      case OpType::kDrawPaint:
+        canvas->drawPaint(*paint(ReadOp<PaintOp>(args).paint));
+        break;
+      case OpType::kDrawPoints: {
+        const auto op = ReadOp<PointsOp>(args);
+        canvas->drawPoints(static_cast<SkCanvas::PointMode>(op.mode), op.count,
+                           &points_[op.first_point], *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawRect: {
+        const auto op = ReadOp<RectOp>(args);
+        canvas->drawRect(op.rect, *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawOval: {
+        const auto op = ReadOp<RectOp>(args);
+        canvas->drawOval(op.rect, *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawArc: {
+        const auto op = ReadOp<ArcOp>(args);
+        canvas->drawArc(op.oval, op.start_angle, op.sweep_angle,
+                        op.use_center != 0, *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawRRect: {
+        const auto op = ReadOp<RRectOp>(args);
+        canvas->drawRRect(op.rrect, *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawDRRect: {
+        const auto op = ReadOp<DRRectOp>(args);
+        canvas->drawDRRect(op.outer, op.inner, *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawPath: {
+        const auto op = ReadOp<PathOp>(args);
+        canvas->drawPath(paths_[op.path], *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawTextBlob: {
+        const auto op = ReadOp<TextBlobOp>(args);
+        canvas->drawTextBlob(text_blobs_[op.blob], op.x, op.y,
+                             *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawVertices: {
+        const auto op = ReadOp<VerticesOp>(args);
+        canvas->drawVertices(vertices_[op.vertices].get(),
+                             static_cast<SkBlendMode>(op.mode),
+                             *paint(op.paint));
+        break;
+      }
+      case OpType::kDrawImage: {
+        const auto op = ReadOp<ImageOp>(args);
+        canvas->drawImage(images_[op.image].get(), op.left, op.top,
+                          paint(op.paint));
+        break;
+      }
+      case OpType::kDrawImageRect: {
+        const auto op = ReadOp<ImageRectOp>(args);
+        const SkImage* image = images_[op.image].get();
+        const SkRect src = op.has_src ? op.src : SkRect::Make(image->bounds());
+        canvas->drawImageRect(
+            image, src, op.dst, paint(op.paint),
+            static_cast<SkCanvas::SrcRectConstraint>(op.constraint));
+        break;
+      }
+      case OpType::kDrawPicture:
+        canvas->drawPicture(pictures_[ReadOp<PictureOp>(args).picture]);
+        break;
+    }
+  }
+}
+
+void DisplayList::Finish() {
+  for (const SkRect& bounds : draw_bounds_) {
+    bounds_.join(bounds);
+  }
+  can_apply_opacity_ = ComputeCanApplyOpacity();
+  content_hash_ = ComputeContentHash();
+}
+
+bool DisplayList::ComputeCanApplyOpacity() const {
+  if (draw_bounds_.empty() ||
+      draw_bounds_.size() > static_cast<size_t>(kMaxOpacityFoldingDraws)) {
+    return false;
+  }
+  // Layers, vertices and nested pictures blend what they draw with each
+  // other.
+  for (size_t offset = 0; offset < ops_.size();) {
+    const OpHeader header = ReadOp<OpHeader>(ops_.data() + offset);
+    if (header.type == OpType::kSaveLayer ||
+        header.type == OpType::kDrawVertices ||
+        header.type == OpType::kDrawPicture) {
+      return false;
+    }
+    offset += sizeof(OpHeader) + header.size;
+  }
+  for (const SkPaint& paint : paints_) {
+    if (paint.getBlendMode() != SkBlendMode::kSrcOver ||
+        paint.getColorFilter() || paint.getImageFilter()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < draw_bounds_.size(); i++) {
+    for (size_t j = i + 1; j < draw_bounds_.size(); j++) {
+      if (SkRect::Intersects(draw_bounds_[i], draw_bounds_[j])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::optional<uint64_t> DisplayList::ComputeContentHash() const {
+  if (!regions_.empty() || !backdrops_.empty()) {
+    return std::nullopt;
+  }
+  uint64_t hash = fml::HashBytes(ops_.data(), ops_.size());
+  for (const SkPaint& paint : paints_) {
+    if (HasObjects(paint)) {
+      return std::nullopt;
+    }
+    const PaintKey key = {
+        paint.getColor4f(),
+        paint.getStrokeWidth(),
+        paint.getStrokeMiter(),
+        static_cast<uint32_t>(paint.getBlendMode()),
+        static_cast<uint32_t>(paint.getStyle()),
+        static_cast<uint32_t>(paint.getStrokeCap()),
+        static_cast<uint32_t>(paint.getStrokeJoin()),
+        paint.isAntiAlias(),
+        paint.isDither(),
+        static_cast<uint32_t>(paint.getFilterQuality()),
+    };
+    hash = fml::HashBytes(&key, sizeof(key), hash);
+  }
+  hash = fml::HashBytes(points_.data(), points_.size() * sizeof(SkPoint), hash);
+  for (const SkPath& path : paths_) {
+    auto path_hash = HashPath(path, hash);
+    if (!path_hash) {
+      return std::nullopt;
+    }
+    hash = *path_hash;
+  }
+  // The objects below are immutable, and their unique IDs are never reused.
+  for (const sk_sp<SkImage>& image : images_) {
+    hash = fml::HashMix(hash, image->uniqueID());
+  }
+  for (const sk_sp<SkTextBlob>& blob : text_blobs_) {
+    hash = fml::HashMix(hash, blob->uniqueID());
+  }
+  for (const sk_sp<SkVertices>& vertices : vertices_) {
+    hash = fml::HashMix(hash, vertices->uniqueID());
+  }
+  for (const sk_sp<SkPicture>& picture : pictures_) {
+    hash = fml::HashMix(hash, picture->uniqueID());
+  }
+  return hash;
+}
+
+DisplayListRecorder::DisplayListRecorder(const SkRect& cull_rect)
+    : PictureCostCanvas(cull_rect.roundOut(), &recorded_cost_),
+      display_list_(new DisplayList()) {
+  display_list_->cull_rect_ = cull_rect;
+}
+
+DisplayListRecorder::~DisplayListRecorder() = default;
+
+sk_sp<DisplayList> DisplayListRecorder::Finish() {
+  FML_DCHECK(display_list_);
+  display_list_->cost_ = recorded_cost_;
+  display_list_->Finish();
+  return std::move(display_list_);
+}
+
+template <typename Op>
+void DisplayListRecorder::Push(DisplayListOpType type, const Op& op) {
+  static_assert(std::is_trivially_copyable_v<Op>);
+  static_assert(sizeof(Op) % sizeof(uint32_t) == 0);
+  const OpHeader header = {type, sizeof(Op)};
+  std::vector<uint8_t>& ops = display_list_->ops_;
+  const size_t offset = ops.size();
+  ops.resize(offset + sizeof(OpHeader) + sizeof(Op));
+  memcpy(ops.data() + offset, &header, sizeof(OpHeader));
+  memcpy(ops.data() + offset + sizeof(OpHeader), &op, sizeof(Op));
+  display_list_->op_count_++;
+}
+
+void DisplayListRecorder::Push(DisplayListOpType type) {
+  const OpHeader header = {type, 0};
+  std::vector<uint8_t>& ops = display_list_->ops_;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&header);
+  ops.insert(ops.end(), bytes, bytes + sizeof(OpHeader));
+  display_list_->op_count_++;
+}
+
+template <typename Op>
+void DisplayListRecorder::PushDraw(DisplayListOpType type, const Op& op) {
+  Push(type, op);
+  display_list_->draw_bounds_.push_back(pending_bounds_);
+  pending_bounds_.setEmpty();
+}
+
+template <typename Draw>
+void DisplayListRecorder::PushNestedDraw(Draw draw) {
+  SkPictureRecorder recorder;
+  draw(recorder.beginRecording(kNestedPictureBounds));
+  std::vector<sk_sp<SkPicture>>& pictures = display_list_->pictures_;
+  pictures.push_back(recorder.finishRecordingAsPicture());
+  PushDraw(OpType::kDrawPicture,
+           PictureOp{static_cast<uint32_t>(pictures.size() - 1)});
+}
+
+uint32_t DisplayListRecorder::AddPaint(const SkPaint* paint) {
+  if (!paint) {
+    return kNoIndex;
+  }
+  std::vector<SkPaint>& paints = display_list_->paints_;
+  if (paints.empty() || !(paints.back() == *paint)) {
+    paints.push_back(*paint);
+  }
+  return static_cast<uint32_t>(paints.size() - 1);
+}
+
+uint32_t DisplayListRecorder::AddPath(const SkPath& path) {
+  display_list_->paths_.push_back(path);
+  return static_cast<uint32_t>(display_list_->paths_.size() - 1);
+}
+
+void DisplayListRecorder::DidRecordDraw(const SkRect& device_bounds) {
+  pending_bounds_.join(device_bounds);
+}
+
+void DisplayListRecorder::willSave() {
+  Push(OpType::kSave);
+}
+
+SkCanvas::SaveLayerStrategy DisplayListRecorder::getSaveLayerStrategy(
+    const SaveLayerRec& rec) {
+  uint32_t backdrop = kNoIndex;
+  if (rec.fBackdrop) {
+    display_list_->backdrops_.push_back(sk_ref_sp(rec.fBackdrop));
+    backdrop = static_cast<uint32_t>(display_list_->backdrops_.size() - 1);
+  }
+  Push(OpType::kSaveLayer,
+       SaveLayerOp{rec.fBounds ? *rec.fBounds : SkRect::MakeEmpty(),
+                   rec.fBounds != nullptr, AddPaint(rec.fPaint), backdrop,
+                   rec.fSaveLayerFlags});
+  return PictureCostCanvas::getSaveLayerStrategy(rec);
+}
+
+void DisplayListRecorder::willRestore() {
+  Push(OpType::kRestore);
+}
+
+void DisplayListRecorder::didConcat44(const SkM44& matrix) {
+  Push(OpType::kConcat44, Matrix44Op{matrix});
+}
+
+void DisplayListRecorder::didConcat(const SkMatrix& matrix) {
+  // Computes the lazily computed type of the matrix, so that equal matrices
+  // have the same bytes.
+  matrix.getType();
+  Push(OpType::kConcat, MatrixOp{matrix});
+}
+
+void DisplayListRecorder::didSetMatrix(const SkMatrix& matrix) {
+  matrix.getType();
+  Push(OpType::kSetMatrix, MatrixOp{matrix});
+}
+
+void DisplayListRecorder::didScale(SkScalar x, SkScalar y) {
+  Push(OpType::kScale, PointOp{x, y});
+}
+
+void DisplayListRecorder::didTranslate(SkScalar x, SkScalar y) {
+  Push(OpType::kTranslate, PointOp{x, y});
+}
+
+void DisplayListRecorder::onClipRect(const SkRect& rect,
+                                     SkClipOp op,
+                                     ClipEdgeStyle style) {
+  Push(OpType::kClipRect, ClipRectOp{rect, static_cast<uint32_t>(op),
+                                     style == kSoft_ClipEdgeStyle});
+  PictureCostCanvas::onClipRect(rect, op, style);
+}
+
+void DisplayListRecorder::onClipRRect(const SkRRect& rrect,
+                                      SkClipOp op,
+                                      ClipEdgeStyle style) {
+  Push(OpType::kClipRRect, ClipRRectOp{rrect, static_cast<uint32_t>(op),
+                                       style == kSoft_ClipEdgeStyle});
+  PictureCostCanvas::onClipRRect(rrect, op, style);
+}
+
+void DisplayListRecorder::onClipPath(const SkPath& path,
+                                     SkClipOp op,
+                                     ClipEdgeStyle style) {
+  Push(OpType::kClipPath, ClipPathOp{AddPath(path), static_cast<uint32_t>(op),
+                                     style == kSoft_ClipEdgeStyle});
+  PictureCostCanvas::onClipPath(path, op, style);
+}
+
+void DisplayListRecorder::onClipRegion(const SkRegion& region, SkClipOp op) {
+  display_list_->regions_.push_back(region);
+  Push(OpType::kClipRegion,
+       ClipRegionOp{static_cast<uint32_t>(display_list_->regions_.size() - 1),
+                    static_cast<uint32_t>(op)});
+  PictureCostCanvas::onClipRegion(region, op);
+}
+
+void DisplayListRecorder::onDrawPaint(const SkPaint& paint) {
+  PictureCostCanvas::onDrawPaint(paint);
+  PushDraw(OpType::kDrawPaint, PaintOp{AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawPoints(PointMode mode,
+                                       size_t count,
+                                       const SkPoint points[],
+                                       const SkPaint& paint) {
+  PictureCostCanvas::onDrawPoints(mode, count, points, paint);
+  std::vector<SkPoint>& table = display_list_->points_;
+  const auto first_point = static_cast<uint32_t>(table.size());
+  table.insert(table.end(), points, points + count);
+  PushDraw(OpType::kDrawPoints,
+           PointsOp{static_cast<uint32_t>(mode), first_point,
+                    static_cast<uint32_t>(count), AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawRect(const SkRect& rect,
+                                     const SkPaint& paint) {
+  PictureCostCanvas::onDrawRect(rect, paint);
+  PushDraw(OpType::kDrawRect, RectOp{rect, AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawRegion(const SkRegion& region,
+                                       const SkPaint& paint) {
+  PictureCostCanvas::onDrawRegion(region, paint);
+  PushNestedDraw([&](SkCanvas* canvas) { canvas->drawRegion(region, paint); });
+}
+
+void DisplayListRecorder::onDrawOval(const SkRect& rect,
+                                     const SkPaint& paint) {
+  PictureCostCanvas::onDrawOval(rect, paint);
+  PushDraw(OpType::kDrawOval, RectOp{rect, AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawArc(const SkRect& rect,
+                                    SkScalar start_angle,
+                                    SkScalar sweep_angle,
+                                    bool use_center,
+                                    const SkPaint& paint) {
+  PictureCostCanvas::onDrawArc(rect, start_angle, sweep_angle, use_center,
+                               paint);
+  PushDraw(OpType::kDrawArc, ArcOp{rect, start_angle, sweep_angle, use_center,
+                                   AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawRRect(const SkRRect& rrect,
+                                      const SkPaint& paint) {
+  PictureCostCanvas::onDrawRRect(rrect, paint);
+  PushDraw(OpType::kDrawRRect, RRectOp{rrect, AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawDRRect(const SkRRect& outer,
+                                       const SkRRect& inner,
+                                       const SkPaint& paint) {
+  PictureCostCanvas::onDrawDRRect(outer, inner, paint);
+  PushDraw(OpType::kDrawDRRect, DRRectOp{outer, inner, AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawPath(const SkPath& path,
+                                     const SkPaint& paint) {
+  PictureCostCanvas::onDrawPath(path, paint);
+  PushDraw(OpType::kDrawPath, PathOp{AddPath(path), AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawTextBlob(const SkTextBlob* blob,
+                                         SkScalar x,
+                                         SkScalar y,
+                                         const SkPaint& paint) {
+  PictureCostCanvas::onDrawTextBlob(blob, x, y, paint);
+  std::vector<sk_sp<SkTextBlob>>& blobs = display_list_->text_blobs_;
+  blobs.push_back(sk_ref_sp(const_cast<SkTextBlob*>(blob)));
+  PushDraw(OpType::kDrawTextBlob,
+           TextBlobOp{static_cast<uint32_t>(blobs.size() - 1), x, y,
+                      AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawPatch(const SkPoint cubics[12],
+                                      const SkColor colors[4],
+                                      const SkPoint tex_coords[4],
+                                      SkBlendMode mode,
+                                      const SkPaint& paint) {
+  PictureCostCanvas::onDrawPatch(cubics, colors, tex_coords, mode, paint);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->drawPatch(cubics, colors, tex_coords, mode, paint);
+  });
+}
+
+void DisplayListRecorder::onDrawVerticesObject(const SkVertices* vertices,
+                                               SkBlendMode mode,
+                                               const SkPaint& paint) {
+  PictureCostCanvas::onDrawVerticesObject(vertices, mode, paint);
+  std::vector<sk_sp<SkVertices>>& table = display_list_->vertices_;
+  table.push_back(sk_ref_sp(const_cast<SkVertices*>(vertices)));
+  PushDraw(OpType::kDrawVertices,
+           VerticesOp{static_cast<uint32_t>(table.size() - 1),
+                      static_cast<uint32_t>(mode), AddPaint(&paint)});
+}
+
+void DisplayListRecorder::onDrawImage(const SkImage* image,
+                                      SkScalar left,
+                                      SkScalar top,
+                                      const SkPaint* paint) {
+  PictureCostCanvas::onDrawImage(image, left, top, paint);
+  std::vector<sk_sp<SkImage>>& images = display_list_->images_;
+  images.push_back(sk_ref_sp(const_cast<SkImage*>(image)));
+  PushDraw(OpType::kDrawImage,
+           ImageOp{static_cast<uint32_t>(images.size() - 1), left, top,
+                   AddPaint(paint)});
+}
+
+void DisplayListRecorder::onDrawImageRect(const SkImage* image,
+                                          const SkRect* src,
+                                          const SkRect& dst,
+                                          const SkPaint* paint,
+                                          SrcRectConstraint constraint) {
+  PictureCostCanvas::onDrawImageRect(image, src, dst, paint, constraint);
+  std::vector<sk_sp<SkImage>>& images = display_list_->images_;
+  images.push_back(sk_ref_sp(const_cast<SkImage*>(image)));
+  PushDraw(OpType::kDrawImageRect,
+           ImageRectOp{static_cast<uint32_t>(images.size() - 1),
+                       src != nullptr, src ? *src : SkRect::MakeEmpty(), dst,
+                       AddPaint(paint), static_cast<uint32_t>(constraint)});
+}
+
+void DisplayListRecorder::onDrawImageLattice(const SkImage* image,
+                                             const Lattice& lattice,
+                                             const SkRect& dst,
+                                             const SkPaint* paint) {
+  PictureCostCanvas::onDrawImageLattice(image, lattice, dst, paint);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->drawImageLattice(image, lattice, dst, paint);
+  });
+}
+
+void DisplayListRecorder::onDrawImageNine(const SkImage* image,
+                                          const SkIRect& center,
+                                          const SkRect& dst,
+                                          const SkPaint* paint) {
+  PictureCostCanvas::onDrawImageNine(image, center, dst, paint);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->drawImageNine(image, center, dst, paint);
+  });
+}
+
+void DisplayListRecorder::onDrawAtlas(const SkImage* atlas,
+                                      const SkRSXform xforms[],
+                                      const SkRect tex[],
+                                      const SkColor colors[],
+                                      int count,
+                                      SkBlendMode mode,
+                                      const SkRect* cull_rect,
+                                      const SkPaint* paint) {
+  PictureCostCanvas::onDrawAtlas(atlas, xforms, tex, colors, count, mode,
+                                 cull_rect, paint);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->drawAtlas(atlas, xforms, tex, colors, count, mode, cull_rect,
+                      paint);
+  });
+}
+
+void DisplayListRecorder::onDrawShadowRec(const SkPath& path,
+                                          const SkDrawShadowRec& rec) {
+  PictureCostCanvas::onDrawShadowRec(path, rec);
+  // The shadow extends past the path by an amount that depends on the light,
+  // so it is only bounded by the clip.
+  pending_bounds_ = SkRect::Make(getDeviceClipBounds());
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->private_draw_shadow_rec(path, rec);
+  });
+}
+
+void DisplayListRecorder::onDrawEdgeAAQuad(const SkRect& rect,
+                                           const SkPoint clip[4],
+                                           QuadAAFlags aa_flags,
+                                           const SkColor4f& color,
+                                           SkBlendMode mode) {
+  PictureCostCanvas::onDrawEdgeAAQuad(rect, clip, aa_flags, color, mode);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->experimental_DrawEdgeAAQuad(rect, clip, aa_flags, color, mode);
+  });
+}
+
+void DisplayListRecorder::onDrawEdgeAAImageSet(
+    const ImageSetEntry set[],
+    int count,
+    const SkPoint dst_clips[],
+    const SkMatrix pre_view_matrices[],
+    const SkPaint* paint,
+    SrcRectConstraint constraint) {
+  PictureCostCanvas::onDrawEdgeAAImageSet(set, count, dst_clips,
+                                          pre_view_matrices, paint, constraint);
+  PushNestedDraw([&](SkCanvas* canvas) {
+    canvas->experimental_DrawEdgeAAImageSet(set, count, dst_clips,
+                                            pre_view_matrices, paint,
+                                            constraint);
+  });
+}
+
+}  // namespace flutter
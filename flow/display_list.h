@@ -0,0 +1,320 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DISPLAY_LIST_H_
+#define FLUTTER_FLOW_DISPLAY_LIST_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "flutter/flow/picture_cost.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+// The kinds of ops of a DisplayList, which are private to it.
+enum class DisplayListOpType : uint32_t;
+
+// A recording of draw calls owned by the engine, which a PictureLayer draws
+// instead of an SkPicture.
+//
+// The ops are packed one after the other into a single buffer, each as a
+// header followed by its arguments, and the objects they refer to are kept in
+// side tables, so that replaying them is a linear walk over memory. Unlike an
+// SkPicture, a display list can be inspected without playing it back: it keeps
+// the bounds of each draw, the PictureCost of its ops, whether an opacity can
+// be applied to its paints instead of a layer, and a hash of its contents.
+//
+// Display lists are immutable once recorded, and can be drawn from any thread.
+class DisplayList : public SkRefCnt {
+ public:
+  // The most draws the paints of a display list can fold an opacity into.
+  static constexpr int kMaxOpacityFoldingDraws = 16;
+
+  ~DisplayList() override;
+
+  // Unique among the display lists of the process, and never equal to the
+  // unique ID of an SkPicture, so that both can share the keys of a cache.
+  uint64_t unique_id() const { return unique_id_; }
+
+  // The bounds the display list was recorded for, in its coordinates.
+  const SkRect& cull_rect() const { return cull_rect_; }
+
+  // The union of the bounds of the draws.
+  const SkRect& bounds() const { return bounds_; }
+
+  // The number of ops, including those that only save and restore the canvas
+  // state or change the matrix and clip.
+  int op_count() const { return op_count_; }
+
+  // The bounds of each draw in the order they are made, in the coordinates of
+  // the display list and clipped to the clip they are drawn with.
+  const std::vector<SkRect>& draw_bounds() const { return draw_bounds_; }
+
+  // The cost of the draws, measured while recording them.
+  const PictureCost& cost() const { return cost_; }
+
+  // Whether drawing with an opacity can modulate the alpha of each paint
+  // instead of drawing into a translucent layer, which is only the same when
+  // the draws do not overlap or blend with each other.
+  bool can_apply_opacity() const { return can_apply_opacity_; }
+
+  // A hash of the ops and of the objects they draw, equal for display lists
+  // that draw the same. Not available when the display list refers to an
+  // object without a stable identity, like a shader.
+  std::optional<uint64_t> content_hash() const { return content_hash_; }
+
+  // The bytes taken by the ops and the side tables, not counting the images.
+  size_t bytes_used() const;
+
+  // Draws the ops into |canvas| as if into a layer with |opacity|. Draws
+  // outside of the clip of |canvas| are skipped.
+  void RenderTo(SkCanvas* canvas, SkScalar opacity = SK_Scalar1) const;
+
+  // Records the ops into an SkPicture, for the APIs that need one.
+  sk_sp<SkPicture> ToSkPicture() const;
+
+ private:
+  friend class DisplayListRecorder;
+
+  DisplayList();
+
+  // Draws the ops, multiplying the alpha of their paints by |opacity|.
+  void Render(SkCanvas* canvas, SkScalar opacity) const;
+
+  // Computes the summaries of the ops once they are all recorded.
+  void Finish();
+
+  bool ComputeCanApplyOpacity() const;
+  std::optional<uint64_t> ComputeContentHash() const;
+
+  const uint64_t unique_id_;
+  SkRect cull_rect_ = SkRect::MakeEmpty();
+  SkRect bounds_ = SkRect::MakeEmpty();
+  int op_count_ = 0;
+  PictureCost cost_;
+  bool can_apply_opacity_ = false;
+  std::optional<uint64_t> content_hash_;
+
+  std::vector<uint8_t> ops_;
+  std::vector<SkRect> draw_bounds_;
+  std::vector<SkPaint> paints_;
+  std::vector<SkPoint> points_;
+  std::vector<SkPath> paths_;
+  std::vector<SkRegion> regions_;
+  std::vector<sk_sp<SkImage>> images_;
+  std::vector<sk_sp<SkTextBlob>> text_blobs_;
+  std::vector<sk_sp<SkVertices>> vertices_;
+  std::vector<sk_sp<SkImageFilter>> backdrops_;
+  std::vector<sk_sp<SkPicture>> pictures_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayList);
+};
+
+// A canvas that records what is drawn into it into a DisplayList.
+//
+// The common draws are recorded as ops of their own. The rare ones, like
+// patches and lattices, are recorded into a nested SkPicture, and the ops of
+// the pictures drawn into the recorder are recorded like any other.
+class DisplayListRecorder final : public PictureCostCanvas {
+ public:
+  explicit DisplayListRecorder(const SkRect& cull_rect);
+
+  ~DisplayListRecorder() override;
+
+  // Returns the recorded display list. Nothing can be drawn afterwards.
+  sk_sp<DisplayList> Finish();
+
+ private:
+  sk_sp<DisplayList> display_list_;
+  PictureCost recorded_cost_;
+  // The device bounds of the draw being recorded.
+  SkRect pending_bounds_ = SkRect::MakeEmpty();
+
+  template <typename Op>
+  void Push(DisplayListOpType type, const Op& op);
+  void Push(DisplayListOpType type);
+
+  // Records the args of a draw whose cost the PictureCostCanvas has recorded.
+  template <typename Op>
+  void PushDraw(DisplayListOpType type, const Op& op);
+
+  // Records a draw made into a nested picture by |draw|.
+  template <typename Draw>
+  void PushNestedDraw(Draw draw);
+
+  // Returns the index of |paint| in the paint table, which is shared with the
+  // previous draw when it has the same paint.
+  uint32_t AddPaint(const SkPaint* paint);
+  uint32_t AddPath(const SkPath& path);
+
+  // |PictureCostCanvas|
+  void DidRecordDraw(const SkRect& device_bounds) override;
+
+  // |SkCanvas|
+  void willSave() override;
+
+  // |SkCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override;
+
+  // |SkCanvas|
+  void willRestore() override;
+
+  // |SkCanvas|
+  void didConcat44(const SkM44& matrix) override;
+
+  // |SkCanvas|
+  void didConcat(const SkMatrix& matrix) override;
+
+  // |SkCanvas|
+  void didSetMatrix(const SkMatrix& matrix) override;
+
+  // |SkCanvas|
+  void didScale(SkScalar x, SkScalar y) override;
+
+  // |SkCanvas|
+  void didTranslate(SkScalar x, SkScalar y) override;
+
+  // |SkCanvas|
+  void onClipRect(const SkRect& rect,
+                  SkClipOp op,
+                  ClipEdgeStyle style) override;
+
+  // |SkCanvas|
+  void onClipRRect(const SkRRect& rrect,
+                   SkClipOp op,
+                   ClipEdgeStyle style) override;
+
+  // |SkCanvas|
+  void onClipPath(const SkPath& path,
+                  SkClipOp op,
+                  ClipEdgeStyle style) override;
+
+  // |SkCanvas|
+  void onClipRegion(const SkRegion& region, SkClipOp op) override;
+
+  // |SkCanvas|
+  void onDrawPaint(const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPoints(PointMode mode,
+                    size_t count,
+                    const SkPoint points[],
+                    const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRegion(const SkRegion& region, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawOval(const SkRect& rect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawArc(const SkRect& rect,
+                 SkScalar start_angle,
+                 SkScalar sweep_angle,
+                 bool use_center,
+                 const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawDRRect(const SkRRect& outer,
+                    const SkRRect& inner,
+                    const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPath(const SkPath& path, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint tex_coords[4],
+                   SkBlendMode mode,
+                   const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawVerticesObject(const SkVertices* vertices,
+                            SkBlendMode mode,
+                            const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawImage(const SkImage* image,
+                   SkScalar left,
+                   SkScalar top,
+                   const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawImageRect(const SkImage* image,
+                       const SkRect* src,
+                       const SkRect& dst,
+                       const SkPaint* paint,
+                       SrcRectConstraint constraint) override;
+
+  // |SkCanvas|
+  void onDrawImageLattice(const SkImage* image,
+                          const Lattice& lattice,
+                          const SkRect& dst,
+                          const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawImageNine(const SkImage* image,
+                       const SkIRect& center,
+                       const SkRect& dst,
+                       const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawAtlas(const SkImage* atlas,
+                   const SkRSXform xforms[],
+                   const SkRect tex[],
+                   const SkColor colors[],
+                   int count,
+                   SkBlendMode mode,
+                   const SkRect* cull_rect,
+                   const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override;
+
+  // |SkCanvas|
+  void onDrawEdgeAAQuad(const SkRect& rect,
+                        const SkPoint clip[4],
+                        QuadAAFlags aa_flags,
+                        const SkColor4f& color,
+                        SkBlendMode mode) override;
+
+  // |SkCanvas|
+  void onDrawEdgeAAImageSet(const ImageSetEntry set[],
+                            int count,
+                            const SkPoint dst_clips[],
+                            const SkMatrix pre_view_matrices[],
+                            const SkPaint* paint,
+                            SrcRectConstraint constraint) override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListRecorder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DISPLAY_LIST_H_
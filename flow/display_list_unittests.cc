@@ -0,0 +1,231 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/display_list.h"
+
+#include <cstdlib>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+
+namespace flutter {
+namespace testing {
+
+using DrawFunction = std::function<void(SkCanvas*)>;
+
+static const SkRect kCullRect = SkRect::MakeWH(100, 100);
+
+static sk_sp<DisplayList> Record(const DrawFunction& draw) {
+  DisplayListRecorder recorder(kCullRect);
+  draw(&recorder);
+  return recorder.Finish();
+}
+
+static void DrawScene(SkCanvas* canvas) {
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), paint);
+  canvas->save();
+  canvas->translate(40, 40);
+  canvas->clipRect(SkRect::MakeWH(30, 30));
+  paint.setColor(SK_ColorBLUE);
+  paint.setAntiAlias(true);
+  canvas->drawCircle(10, 10, 25, paint);
+  canvas->restore();
+  SkPath path;
+  path.moveTo(0, 90);
+  path.lineTo(50, 60);
+  path.lineTo(90, 95);
+  paint.setStyle(SkPaint::kStroke_Style);
+  paint.setStrokeWidth(3);
+  canvas->drawPath(path, paint);
+}
+
+// Draws |draw| into a raster surface and returns its pixels.
+static sk_sp<SkImage> Rasterize(const DrawFunction& draw) {
+  auto surface = SkSurface::MakeRasterN32Premul(100, 100);
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  draw(surface->getCanvas());
+  return surface->makeImageSnapshot();
+}
+
+// Expects the channels of the pixels to differ by at most |tolerance|, which
+// allows for the rounding of different ways of blending.
+static void ExpectSamePixels(const sk_sp<SkImage>& actual,
+                             const sk_sp<SkImage>& expected,
+                             int tolerance = 0) {
+  SkPixmap actual_pixels;
+  SkPixmap expected_pixels;
+  ASSERT_TRUE(actual->peekPixels(&actual_pixels));
+  ASSERT_TRUE(expected->peekPixels(&expected_pixels));
+  for (int y = 0; y < actual->height(); y++) {
+    for (int x = 0; x < actual->width(); x++) {
+      const SkColor actual_color = actual_pixels.getColor(x, y);
+      const SkColor expected_color = expected_pixels.getColor(x, y);
+      for (int shift = 0; shift < 32; shift += 8) {
+        const int actual_channel = (actual_color >> shift) & 0xFF;
+        const int expected_channel = (expected_color >> shift) & 0xFF;
+        const int difference = actual_channel - expected_channel;
+        ASSERT_LE(std::abs(difference), tolerance) << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(DisplayList, RecordsBoundsAndCostOfEachDraw) {
+  auto display_list = Record(DrawScene);
+
+  EXPECT_GE(display_list->unique_id(), uint64_t{1} << 32);
+  EXPECT_EQ(display_list->cull_rect(), kCullRect);
+  // The save, translate, clip and restore are ops without bounds.
+  EXPECT_EQ(display_list->op_count(), 7);
+  ASSERT_EQ(display_list->draw_bounds().size(), 3u);
+  EXPECT_EQ(display_list->draw_bounds()[0], SkRect::MakeXYWH(10, 10, 20, 20));
+  // The circle is clipped.
+  EXPECT_EQ(display_list->draw_bounds()[1], SkRect::MakeXYWH(40, 40, 30, 30));
+  EXPECT_TRUE(display_list->bounds().contains(SkRect::MakeLTRB(0, 10, 90, 95)));
+
+  PictureCost expected = PictureCost::Analyze(*display_list->ToSkPicture());
+  EXPECT_EQ(display_list->cost().op_count(), 3);
+  EXPECT_EQ(display_list->cost().path_count(), expected.path_count());
+  EXPECT_DOUBLE_EQ(display_list->cost().covered_area(),
+                   expected.covered_area());
+  EXPECT_GT(display_list->bytes_used(), 0u);
+}
+
+TEST(DisplayList, RendersLikeAPicture) {
+  SkPictureRecorder recorder;
+  DrawScene(recorder.beginRecording(kCullRect));
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+  auto display_list = Record(DrawScene);
+
+  auto expected = Rasterize([&](SkCanvas* canvas) {
+    canvas->translate(5, 5);
+    canvas->drawPicture(picture);
+  });
+  ExpectSamePixels(Rasterize([&](SkCanvas* canvas) {
+                     canvas->translate(5, 5);
+                     display_list->RenderTo(canvas);
+                   }),
+                   expected);
+  ExpectSamePixels(Rasterize([&](SkCanvas* canvas) {
+                     canvas->translate(5, 5);
+                     canvas->drawPicture(display_list->ToSkPicture());
+                   }),
+                   expected);
+}
+
+TEST(DisplayList, SetMatrixIsRelativeToTheCanvasMatrix) {
+  auto draw = [](SkCanvas* canvas) {
+    canvas->setMatrix(SkMatrix::Translate(20, 20));
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+  };
+  auto display_list = Record(draw);
+
+  auto image = Rasterize([&](SkCanvas* canvas) {
+    canvas->translate(30, 30);
+    display_list->RenderTo(canvas);
+  });
+  auto expected = Rasterize([](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeXYWH(50, 50, 10, 10), SkPaint());
+  });
+  ExpectSamePixels(image, expected);
+}
+
+TEST(DisplayList, SkipsDrawsOutsideOfTheClip) {
+  auto display_list = Record(DrawScene);
+
+  DisplayListRecorder recorder(kCullRect);
+  recorder.clipRect(SkRect::MakeWH(35, 35));
+  display_list->RenderTo(&recorder);
+  auto clipped = recorder.Finish();
+
+  // Only the rect is drawn.
+  ASSERT_EQ(clipped->draw_bounds().size(), 1u);
+  EXPECT_EQ(clipped->draw_bounds()[0], SkRect::MakeXYWH(10, 10, 20, 20));
+}
+
+TEST(DisplayList, FoldsOpacityIntoNonOverlappingDraws) {
+  auto draw = [](SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(0, 0, 40, 40), paint);
+    paint.setColor(0x80FF0000);
+    canvas->drawOval(SkRect::MakeXYWH(50, 50, 40, 40), paint);
+  };
+  auto display_list = Record(draw);
+  ASSERT_TRUE(display_list->can_apply_opacity());
+
+  auto expected = Rasterize([&](SkCanvas* canvas) {
+    canvas->saveLayerAlpha(nullptr, 128);
+    draw(canvas);
+    canvas->restore();
+  });
+  auto image = Rasterize(
+      [&](SkCanvas* canvas) { display_list->RenderTo(canvas, 128 / 255.0f); });
+  ExpectSamePixels(image, expected, 2);
+}
+
+TEST(DisplayList, CannotFoldOpacityIntoOverlappingOrBlendingDraws) {
+  auto overlapping = Record([](SkCanvas* canvas) {
+    canvas->drawRect(SkRect::MakeWH(40, 40), SkPaint());
+    canvas->drawRect(SkRect::MakeXYWH(20, 20, 40, 40), SkPaint());
+  });
+  EXPECT_FALSE(overlapping->can_apply_opacity());
+
+  auto layer = Record([](SkCanvas* canvas) {
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawRect(SkRect::MakeWH(40, 40), SkPaint());
+    canvas->restore();
+  });
+  EXPECT_FALSE(layer->can_apply_opacity());
+
+  auto blending = Record([](SkCanvas* canvas) {
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    canvas->drawRect(SkRect::MakeWH(40, 40), paint);
+  });
+  EXPECT_FALSE(blending->can_apply_opacity());
+
+  // Drawing them with an opacity still draws them into a layer.
+  auto expected = Rasterize([](SkCanvas* canvas) {
+    canvas->saveLayerAlpha(nullptr, 128);
+    canvas->drawRect(SkRect::MakeWH(40, 40), SkPaint());
+    canvas->drawRect(SkRect::MakeXYWH(20, 20, 40, 40), SkPaint());
+    canvas->restore();
+  });
+  auto image = Rasterize(
+      [&](SkCanvas* canvas) { overlapping->RenderTo(canvas, 128 / 255.0f); });
+  ExpectSamePixels(image, expected);
+}
+
+TEST(DisplayList, ContentHashMatchesTheDraws) {
+  auto first = Record(DrawScene);
+  auto second = Record(DrawScene);
+  ASSERT_TRUE(first->content_hash().has_value());
+  EXPECT_NE(first->unique_id(), second->unique_id());
+  EXPECT_EQ(first->content_hash(), second->content_hash());
+
+  auto different = Record([](SkCanvas* canvas) {
+    DrawScene(canvas);
+    canvas->drawRect(SkRect::MakeWH(1, 1), SkPaint());
+  });
+  EXPECT_NE(first->content_hash(), different->content_hash());
+
+  auto shaded = Record([](SkCanvas* canvas) {
+    const SkPoint points[] = {{0, 0}, {100, 100}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(points, colors, nullptr, 2,
+                                                 SkTileMode::kClamp));
+    canvas->drawPaint(paint);
+  });
+  EXPECT_FALSE(shaded->content_hash().has_value());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,9 @@
 
 #include "flutter/flow/embedded_views.h"
 
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+
 namespace flutter {
 
 bool ExternalViewEmbedder::SubmitFrame(GrContext* context,
@@ -11,53 +14,154 @@ bool ExternalViewEmbedder::SubmitFrame(GrContext* context,
   return frame->Submit();
 };
 
+namespace {
+
+void HashScalars(size_t& seed, const SkScalar* values, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    fml::HashCombineSeed(seed, values[i]);
+  }
+}
+
+}  // namespace
+
+size_t Mutator::ComputeHash() const {
+  size_t seed = fml::HashCombine(static_cast<int>(type_));
+  switch (type_) {
+    case clip_rect:
+      HashScalars(seed, rect_.asScalars(), 4);
+      break;
+    case clip_rrect:
+      HashScalars(seed, rrect_.rect().asScalars(), 4);
+      for (int corner = 0; corner < 4; corner++) {
+        const SkVector radii =
+            rrect_.radii(static_cast<SkRRect::Corner>(corner));
+        fml::HashCombineSeed(seed, radii.fX, radii.fY);
+      }
+      break;
+    case clip_path: {
+      // Hashing the points and verbs would cost as much as comparing them.
+      // These properties are cheap to get and equal for equal paths.
+      HashScalars(seed, path_.getBounds().asScalars(), 4);
+      fml::HashCombineSeed(seed, path_.countPoints(), path_.countVerbs(),
+                           static_cast<int>(path_.getFillType()));
+      break;
+    }
+    case transform: {
+      SkScalar values[9];
+      matrix_.get9(values);
+      HashScalars(seed, values, 9);
+      break;
+    }
+    case opacity:
+      fml::HashCombineSeed(seed, alpha_);
+      break;
+  }
+  return seed;
+}
+
+MutatorsStack::MutatorsStack(const MutatorsStack& other) {
+  *this = other;
+}
+
+MutatorsStack& MutatorsStack::operator=(const MutatorsStack& other) {
+  if (this == &other) {
+    return *this;
+  }
+  Clear();
+  Reserve(other.size_);
+  for (size_t i = 0; i < other.size_; i++) {
+    new (data_ + i) Mutator(other.data_[i]);
+  }
+  size_ = other.size_;
+  hash_ = other.hash_;
+  return *this;
+}
+
+MutatorsStack::~MutatorsStack() {
+  Clear();
+}
+
 void MutatorsStack::PushClipRect(const SkRect& rect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rect);
-  vector_.push_back(element);
+  Push(rect);
 };
 
 void MutatorsStack::PushClipRRect(const SkRRect& rrect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rrect);
-  vector_.push_back(element);
+  Push(rrect);
 };
 
 void MutatorsStack::PushClipPath(const SkPath& path) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(path);
-  vector_.push_back(element);
+  Push(path);
 };
 
 void MutatorsStack::PushTransform(const SkMatrix& matrix) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(matrix);
-  vector_.push_back(element);
+  Push(matrix);
 };
 
 void MutatorsStack::PushOpacity(const int& alpha) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(alpha);
-  vector_.push_back(element);
+  Push(alpha);
 };
 
 void MutatorsStack::Pop() {
-  vector_.pop_back();
+  FML_DCHECK(size_ > 0);
+  size_--;
+  hash_ -= HashAt(data_[size_], size_);
+  data_[size_].~Mutator();
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator
-MutatorsStack::Top() const {
-  return vector_.rend();
+MutatorsStack::const_reverse_iterator MutatorsStack::Top() const {
+  return const_reverse_iterator(Begin());
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator
-MutatorsStack::Bottom() const {
-  return vector_.rbegin();
+MutatorsStack::const_reverse_iterator MutatorsStack::Bottom() const {
+  return const_reverse_iterator(End());
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_iterator
-MutatorsStack::Begin() const {
-  return vector_.begin();
+MutatorsStack::const_iterator MutatorsStack::Begin() const {
+  return data_;
 };
 
-const std::vector<std::shared_ptr<Mutator>>::const_iterator MutatorsStack::End()
-    const {
-  return vector_.end();
+MutatorsStack::const_iterator MutatorsStack::End() const {
+  return data_ + size_;
 };
 
+template <typename T>
+void MutatorsStack::Push(const T& value) {
+  if (size_ == capacity_) {
+    Reserve(capacity_ * 2);
+  }
+  Mutator* mutator = new (data_ + size_) Mutator(value);
+  hash_ += HashAt(*mutator, size_);
+  size_++;
+}
+
+void MutatorsStack::Reserve(size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  std::unique_ptr<Storage[]> storage(new Storage[capacity]);
+  Mutator* data = reinterpret_cast<Mutator*>(storage.get());
+  for (size_t i = 0; i < size_; i++) {
+    new (data + i) Mutator(data_[i]);
+    data_[i].~Mutator();
+  }
+  heap_storage_ = std::move(storage);
+  data_ = data;
+  capacity_ = capacity;
+}
+
+void MutatorsStack::Clear() {
+  for (size_t i = 0; i < size_; i++) {
+    data_[i].~Mutator();
+  }
+  size_ = 0;
+  hash_ = 0;
+}
+
+size_t MutatorsStack::HashAt(const Mutator& mutator, size_t index) {
+  // The contributions are summed so that popping a mutator can subtract its
+  // contribution again. Mixing in the index keeps the hash sensitive to the
+  // order of the mutators.
+  return fml::HashCombine(mutator.Hash(), index);
+}
+
 }  // namespace flutter
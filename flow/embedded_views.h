@@ -5,6 +5,10 @@
 #ifndef FLUTTER_FLOW_EMBEDDED_VIEWS_H_
 #define FLUTTER_FLOW_EMBEDDED_VIEWS_H_
 
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "flutter/flow/surface_frame.h"
@@ -29,10 +33,13 @@ enum MutatorType { clip_rect, clip_rrect, clip_path, transform, opacity };
 // Each `type` is paired with an object that supports the mutation. For example,
 // if the `type` is clip_rect, `rect()` is used the represent the rect to be
 // clipped. One mutation object must only contain one type of mutation.
+//
+// Mutators are values. Clip paths are stored inline; copying an SkPath only
+// shares its immutable, ref counted path data, so pushing a clip path mutator
+// doesn't copy the path or allocate memory.
 class Mutator {
  public:
-  Mutator(const Mutator& other) {
-    type_ = other.type_;
+  Mutator(const Mutator& other) : type_(other.type_), hash_(other.hash_) {
     switch (other.type_) {
       case clip_rect:
         rect_ = other.rect_;
@@ -41,7 +48,7 @@ class Mutator {
         rrect_ = other.rrect_;
         break;
       case clip_path:
-        path_ = new SkPath(*other.path_);
+        new (&path_) SkPath(other.path_);
         break;
       case transform:
         matrix_ = other.matrix_;
@@ -54,24 +61,45 @@ class Mutator {
     }
   }
 
-  explicit Mutator(const SkRect& rect) : type_(clip_rect), rect_(rect) {}
-  explicit Mutator(const SkRRect& rrect) : type_(clip_rrect), rrect_(rrect) {}
-  explicit Mutator(const SkPath& path)
-      : type_(clip_path), path_(new SkPath(path)) {}
+  explicit Mutator(const SkRect& rect) : type_(clip_rect), rect_(rect) {
+    hash_ = ComputeHash();
+  }
+  explicit Mutator(const SkRRect& rrect) : type_(clip_rrect), rrect_(rrect) {
+    hash_ = ComputeHash();
+  }
+  explicit Mutator(const SkPath& path) : type_(clip_path), path_(path) {
+    hash_ = ComputeHash();
+  }
   explicit Mutator(const SkMatrix& matrix)
-      : type_(transform), matrix_(matrix) {}
-  explicit Mutator(const int& alpha) : type_(opacity), alpha_(alpha) {}
+      : type_(transform), matrix_(matrix) {
+    hash_ = ComputeHash();
+  }
+  explicit Mutator(const int& alpha) : type_(opacity), alpha_(alpha) {
+    hash_ = ComputeHash();
+  }
+
+  Mutator& operator=(const Mutator& other) {
+    if (this != &other) {
+      this->~Mutator();
+      new (this) Mutator(other);
+    }
+    return *this;
+  }
 
   const MutatorType& GetType() const { return type_; }
   const SkRect& GetRect() const { return rect_; }
   const SkRRect& GetRRect() const { return rrect_; }
-  const SkPath& GetPath() const { return *path_; }
+  const SkPath& GetPath() const { return path_; }
   const SkMatrix& GetMatrix() const { return matrix_; }
   const int& GetAlpha() const { return alpha_; }
   float GetAlphaFloat() const { return (alpha_ / 255.0); }
 
+  // A hash of the type and value of the mutator that is computed when the
+  // mutator is created. Equal mutators have equal hashes.
+  size_t Hash() const { return hash_; }
+
   bool operator==(const Mutator& other) const {
-    if (type_ != other.type_) {
+    if (type_ != other.type_ || hash_ != other.hash_) {
       return false;
     }
     switch (type_) {
@@ -80,7 +108,7 @@ class Mutator {
       case clip_rrect:
         return rrect_ == other.rrect_;
       case clip_path:
-        return *path_ == *other.path_;
+        return path_ == other.path_;
       case transform:
         return matrix_ == other.matrix_;
       case opacity:
@@ -92,27 +120,29 @@ class Mutator {
 
   bool operator!=(const Mutator& other) const { return !operator==(other); }
 
-  bool IsClipType() {
+  bool IsClipType() const {
     return type_ == clip_rect || type_ == clip_rrect || type_ == clip_path;
   }
 
   ~Mutator() {
     if (type_ == clip_path) {
-      delete path_;
+      path_.~SkPath();
     }
   };
 
  private:
   MutatorType type_;
+  size_t hash_;
 
   union {
     SkRect rect_;
     SkRRect rrect_;
     SkMatrix matrix_;
-    SkPath* path_;
+    SkPath path_;
     int alpha_;
   };
 
+  size_t ComputeHash() const;
 };  // Mutator
 
 // A stack of mutators that can be applied to an embedded platform view.
@@ -124,10 +154,26 @@ class Mutator {
 // For example consider the following stack: [T1, T2, T3], where T1 is the top
 // of the stack and T3 is the bottom of the stack. Applying this mutators stack
 // to a platform view P1 will result in T1(T2(T2(P1))).
+//
+// The mutators are stored by value, in place for stacks of up to
+// |kInlineCapacity| mutators. Layer trees rarely nest deeper than that above
+// a platform view, so pushing, popping and copying the stack for each platform
+// view of a frame doesn't allocate memory.
 class MutatorsStack {
  public:
+  using const_iterator = const Mutator*;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_t kInlineCapacity = 8;
+
   MutatorsStack() = default;
 
+  MutatorsStack(const MutatorsStack& other);
+
+  MutatorsStack& operator=(const MutatorsStack& other);
+
+  ~MutatorsStack();
+
   void PushClipRect(const SkRect& rect);
   void PushClipRRect(const SkRRect& rrect);
   void PushClipPath(const SkPath& path);
@@ -140,29 +186,35 @@ class MutatorsStack {
 
   // Returns a reverse iterator pointing to the top of the stack, which is the
   // mutator that is furtherest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator Top()
-      const;
+  const_reverse_iterator Top() const;
   // Returns a reverse iterator pointing to the bottom of the stack, which is
   // the mutator that is closeset from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator Bottom()
-      const;
+  const_reverse_iterator Bottom() const;
 
   // Returns an iterator pointing to the begining of the mutator vector, which
   // is the mutator that is furtherest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_iterator Begin() const;
+  const_iterator Begin() const;
 
   // Returns an iterator pointing to the end of the mutator vector, which is the
   // mutator that is closest from the leaf node.
-  const std::vector<std::shared_ptr<Mutator>>::const_iterator End() const;
+  const_iterator End() const;
+
+  bool is_empty() const { return size_ == 0; }
+
+  size_t size() const { return size_; }
 
-  bool is_empty() const { return vector_.empty(); }
+  // A hash of all the mutators in the stack and their order, updated as
+  // mutators are pushed and popped. Equal stacks have equal hashes, so
+  // embedders can skip updating a platform view whose stack hash didn't change
+  // since the last frame, and only compare the stacks to rule out a collision.
+  size_t Hash() const { return hash_; }
 
   bool operator==(const MutatorsStack& other) const {
-    if (vector_.size() != other.vector_.size()) {
+    if (size_ != other.size_ || hash_ != other.hash_) {
       return false;
     }
-    for (size_t i = 0; i < vector_.size(); i++) {
-      if (*vector_[i] != *other.vector_[i]) {
+    for (size_t i = 0; i < size_; i++) {
+      if (data_[i] != other.data_[i]) {
         return false;
       }
     }
@@ -170,11 +222,11 @@ class MutatorsStack {
   }
 
   bool operator==(const std::vector<Mutator>& other) const {
-    if (vector_.size() != other.size()) {
+    if (size_ != other.size()) {
       return false;
     }
-    for (size_t i = 0; i < vector_.size(); i++) {
-      if (*vector_[i] != other[i]) {
+    for (size_t i = 0; i < size_; i++) {
+      if (data_[i] != other[i]) {
         return false;
       }
     }
@@ -190,7 +242,24 @@ class MutatorsStack {
   }
 
  private:
-  std::vector<std::shared_ptr<Mutator>> vector_;
+  using Storage = std::aligned_storage_t<sizeof(Mutator), alignof(Mutator)>;
+
+  Storage inline_storage_[kInlineCapacity];
+  std::unique_ptr<Storage[]> heap_storage_;
+  Mutator* data_ = reinterpret_cast<Mutator*>(inline_storage_);
+  size_t size_ = 0;
+  size_t capacity_ = kInlineCapacity;
+  size_t hash_ = 0;
+
+  template <typename T>
+  void Push(const T& value);
+
+  void Reserve(size_t capacity);
+
+  void Clear();
+
+  // The contribution of |mutator| at |index| to the hash of the stack.
+  static size_t HashAt(const Mutator& mutator, size_t index);
 };  // MutatorsStack
 
 class EmbeddedViewParams {
@@ -4,12 +4,59 @@
 
 #include "flutter/flow/gl_context_switch.h"
 
+#include "flutter/fml/thread_local.h"
+
 namespace flutter {
 
+namespace {
+
+struct TrackerState {
+  const void* current = nullptr;
+  GLContextTracker::Stats stats;
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<TrackerState> tls_tracker_state;
+
+TrackerState& GetTrackerState() {
+  if (!tls_tracker_state.get()) {
+    tls_tracker_state.reset(new TrackerState());
+  }
+  return *tls_tracker_state.get();
+}
+
+}  // namespace
+
+const void* GLContextTracker::GetCurrent() {
+  return GetTrackerState().current;
+}
+
+void GLContextTracker::DidSwitch(const void* context) {
+  auto& state = GetTrackerState();
+  state.current = context;
+  state.stats.switches++;
+}
+
+void GLContextTracker::DidAvoidSwitch() {
+  auto& state = GetTrackerState();
+  state.stats.switches++;
+  state.stats.avoided_switches++;
+}
+
+GLContextTracker::Stats GLContextTracker::TakeStats() {
+  auto& state = GetTrackerState();
+  Stats stats = state.stats;
+  state.stats = {};
+  return stats;
+}
+
 SwitchableGLContext::SwitchableGLContext() = default;
 
 SwitchableGLContext::~SwitchableGLContext() = default;
 
+bool SwitchableGLContext::IsCurrent() {
+  return false;
+}
+
 GLContextResult::GLContextResult() = default;
 
 GLContextResult::~GLContextResult() = default;
@@ -28,11 +75,23 @@ GLContextDefaultResult::~GLContextDefaultResult() = default;
 GLContextSwitch::GLContextSwitch(std::unique_ptr<SwitchableGLContext> context)
     : context_(std::move(context)) {
   FML_CHECK(context_ != nullptr);
+  if (context_->IsCurrent()) {
+    was_current_ = true;
+    result_ = true;
+    GLContextTracker::DidAvoidSwitch();
+    return;
+  }
   result_ = context_->SetCurrent();
+  GLContextTracker::DidSwitch(nullptr);
 };
 
 GLContextSwitch::~GLContextSwitch() {
+  if (was_current_) {
+    GLContextTracker::DidAvoidSwitch();
+    return;
+  }
   context_->RemoveCurrent();
+  GLContextTracker::DidSwitch(nullptr);
 };
 
 }  // namespace flutter
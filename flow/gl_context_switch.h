@@ -34,6 +34,11 @@ class SwitchableGLContext {
   // object from current context;
   virtual bool RemoveCurrent() = 0;
 
+  // Override this to tell whether the context wrapped by this
+  // |SwitchableGLContext| object is already the current context, in which
+  // case |GLContextSwitch| neither sets nor removes it.
+  virtual bool IsCurrent();
+
   FML_DISALLOW_COPY_AND_ASSIGN(SwitchableGLContext);
 };
 
@@ -47,6 +52,52 @@ class SwitchableGLContext {
 // on platforms that requires context switching. A |GLContextDefaultResult| is
 // also a subclass of |GLContextResult|, which can be returned on platforms
 // that doesn't require context switching.
+//------------------------------------------------------------------------------
+/// Tracks the GL context the engine made current on each thread, so that the
+/// calls that would not change it can be skipped, and counts the switches that
+/// were made and avoided on each thread.
+///
+/// The tracker only knows about the switches it is told about. It may only be
+/// relied on to skip switches on threads where nothing else changes the
+/// current context.
+///
+class GLContextTracker {
+ public:
+  struct Stats {
+    /// The number of calls made to make a context current or to clear it.
+    size_t switches = 0;
+    /// The number of those calls that were skipped.
+    size_t avoided_switches = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @return     The context last made current on the calling thread, or null
+  ///             if it was cleared or is unknown.
+  ///
+  static const void* GetCurrent();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records that `context` was made current on the calling
+  ///             thread, or that the current context was cleared if it is
+  ///             null, and counts the switch.
+  ///
+  static void DidSwitch(const void* context);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Counts a switch that was skipped on the calling thread.
+  ///
+  static void DidAvoidSwitch();
+
+  //----------------------------------------------------------------------------
+  /// @return     The switches counted on the calling thread since the last
+  ///             call.
+  ///
+  static Stats TakeStats();
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(GLContextTracker);
+};
+
 class GLContextResult {
  public:
   GLContextResult();
@@ -105,6 +156,8 @@ class GLContextSwitch final : public GLContextResult {
 
  private:
   std::unique_ptr<SwitchableGLContext> context_;
+  // Whether the context was already current, so there is nothing to undo.
+  bool was_current_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GLContextSwitch);
 };
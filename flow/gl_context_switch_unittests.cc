@@ -23,5 +23,43 @@ TEST(GLContextSwitchTest, SwitchKeepsContextCurrentWhileInScope) {
   ASSERT_EQ(TestSwitchableGLContext::GetCurrentContext(), -1);
 }
 
+TEST(GLContextSwitchTest, SwitchToCurrentContextIsSkipped) {
+  GLContextTracker::TakeStats();
+  TestSwitchableGLContext::SetCurrentContext(1);
+  {
+    auto context_switch =
+        GLContextSwitch(std::make_unique<TestSwitchableGLContext>(1));
+    ASSERT_TRUE(context_switch.GetResult());
+    ASSERT_EQ(TestSwitchableGLContext::GetCurrentContext(), 1);
+  }
+  // The context wasn't removed, as it was current before the switch.
+  ASSERT_EQ(TestSwitchableGLContext::GetCurrentContext(), 1);
+
+  auto stats = GLContextTracker::TakeStats();
+  ASSERT_EQ(stats.switches, 2u);
+  ASSERT_EQ(stats.avoided_switches, 2u);
+}
+
+TEST(GLContextSwitchTest, TrackerCountsSwitchesPerThread) {
+  GLContextTracker::TakeStats();
+  int context = 0;
+  GLContextTracker::DidSwitch(&context);
+  ASSERT_EQ(GLContextTracker::GetCurrent(), &context);
+  GLContextTracker::DidAvoidSwitch();
+  GLContextTracker::DidSwitch(nullptr);
+  ASSERT_EQ(GLContextTracker::GetCurrent(), nullptr);
+
+  std::async(std::launch::async, [] {
+    GLContextTracker::DidSwitch(nullptr);
+  }).wait();
+
+  auto stats = GLContextTracker::TakeStats();
+  ASSERT_EQ(stats.switches, 3u);
+  ASSERT_EQ(stats.avoided_switches, 1u);
+
+  stats = GLContextTracker::TakeStats();
+  ASSERT_EQ(stats.switches, 0u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/glyph_warm_up.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace flutter {
+
+const char GlyphWarmUp::kDefaultCharacters[] =
+    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+    "abcdefghijklmnopqrstuvwxyz{|}~";
+
+std::optional<GlyphWarmUp::Spec> GlyphWarmUp::ParseSpec(
+    std::string_view spec) {
+  const size_t family_end = spec.find(':');
+  if (family_end == 0 || family_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+  const size_t sizes_end = spec.find(':', family_end + 1);
+
+  Spec result;
+  result.font_family = std::string(spec.substr(0, family_end));
+  std::string_view sizes =
+      spec.substr(family_end + 1, sizes_end == std::string_view::npos
+                                      ? std::string_view::npos
+                                      : sizes_end - family_end - 1);
+  if (sizes_end != std::string_view::npos) {
+    result.characters = std::string(spec.substr(sizes_end + 1));
+  }
+
+  while (true) {
+    const size_t size_end = sizes.find(',');
+    const std::string size(sizes.substr(0, size_end));
+    char* parsed_end = nullptr;
+    const float font_size = std::strtof(size.c_str(), &parsed_end);
+    if (size.empty() || parsed_end != size.c_str() + size.size() ||
+        !(font_size > 0)) {
+      return std::nullopt;
+    }
+    result.font_sizes.push_back(font_size);
+    if (size_end == std::string_view::npos) {
+      break;
+    }
+    sizes.remove_prefix(size_end + 1);
+  }
+  return result;
+}
+
+size_t GlyphWarmUp::Rasterize(GrContext* context,
+                              sk_sp<SkTypeface> typeface,
+                              float font_size,
+                              std::string_view characters) {
+  TRACE_EVENT0("flutter", "GlyphWarmUp::Rasterize");
+  if (characters.empty()) {
+    characters = kDefaultCharacters;
+  }
+  const SkFont font(std::move(typeface), font_size);
+  const int glyph_count = font.countText(
+      characters.data(), characters.size(), SkTextEncoding::kUTF8);
+  if (glyph_count <= 0) {
+    return 0;
+  }
+  std::vector<SkGlyphID> glyphs(glyph_count);
+  font.textToGlyphs(characters.data(), characters.size(),
+                    SkTextEncoding::kUTF8, glyphs.data(), glyph_count);
+  std::vector<SkScalar> widths(glyph_count);
+  font.getWidths(glyphs.data(), glyph_count, widths.data());
+
+  const SkImageInfo info =
+      SkImageInfo::MakeN32Premul(kSurfaceSize, kSurfaceSize);
+  sk_sp<SkSurface> surface =
+      context ? SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info)
+              : SkSurface::MakeRaster(info);
+  if (!surface) {
+    FML_LOG(ERROR) << "Could not create the glyph warm-up surface.";
+    return 0;
+  }
+  SkCanvas* canvas = surface->getCanvas();
+
+  // Glyphs are laid out in rows within the surface, as glyphs outside of its
+  // bounds would be culled instead of rasterized. A surface that is full is
+  // flushed and drawn over.
+  SkFontMetrics metrics;
+  const SkScalar line_height = font.getMetrics(&metrics);
+  const SkScalar ascent = -metrics.fAscent;
+  SkTextBlobBuilder builder;
+  SkPoint origin = SkPoint::Make(0, ascent);
+  int row_start = 0;
+  auto draw_row = [&](int row_end) {
+    if (row_end == row_start) {
+      return;
+    }
+    const auto& run =
+        builder.allocRunPosH(font, row_end - row_start, origin.y());
+    SkScalar x = 0;
+    for (int i = row_start; i < row_end; i++) {
+      run.glyphs[i - row_start] = glyphs[i];
+      run.pos[i - row_start] = x;
+      x += widths[i];
+    }
+    row_start = row_end;
+  };
+  auto flush = [&]() {
+    if (sk_sp<SkTextBlob> blob = builder.make()) {
+      canvas->clear(SK_ColorTRANSPARENT);
+      canvas->drawTextBlob(blob, 0, 0, SkPaint());
+      canvas->flush();
+    }
+  };
+
+  for (int i = 0; i < glyph_count; i++) {
+    if (origin.x() > 0 && origin.x() + widths[i] > kSurfaceSize) {
+      draw_row(i);
+      origin.set(0, origin.y() + line_height);
+      if (origin.y() - ascent + line_height > kSurfaceSize) {
+        flush();
+        origin.set(0, ascent);
+      }
+    }
+    origin.offset(widths[i], 0);
+  }
+  draw_row(glyph_count);
+  flush();
+  return glyph_count;
+}
+
+}  // namespace flutter
@@ -0,0 +1,63 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_GLYPH_WARM_UP_H_
+#define FLUTTER_FLOW_GLYPH_WARM_UP_H_
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+// Rasterizes the glyphs of fonts that the first frames are known to show
+// ahead of time, e.g. on the resource context at startup, so that the raster
+// thread doesn't rasterize them while it draws those frames.
+//
+// Glyph masks go into Skia's glyph cache, which is shared by the whole
+// process, so warming them up on the resource context saves the raster thread
+// the rasterization, leaving it only the upload of the masks into the atlas of
+// its own context.
+class GlyphWarmUp {
+ public:
+  // The glyphs of a font family to rasterize, at each of |font_sizes|.
+  struct Spec {
+    std::string font_family;
+    std::vector<float> font_sizes;
+    // UTF-8. Empty rasterizes |kDefaultCharacters|.
+    std::string characters;
+  };
+
+  // The printable characters of ASCII.
+  static const char kDefaultCharacters[];
+
+  // The size of the surface the glyphs are drawn into.
+  static constexpr int kSurfaceSize = 256;
+
+  // Parses a spec of the form "<font family>:<size>[,<size>...][:<chars>]",
+  // in which the characters run to the end of the spec. Returns std::nullopt
+  // if the spec is malformed.
+  static std::optional<Spec> ParseSpec(std::string_view spec);
+
+  // Draws the glyphs of |characters| (UTF-8), or of |kDefaultCharacters| if
+  // empty, with |typeface| at |font_size| into an offscreen surface of
+  // |context|, or into a raster surface if |context| is null, and flushes it.
+  // Returns the number of glyphs drawn.
+  static size_t Rasterize(GrContext* context,
+                          sk_sp<SkTypeface> typeface,
+                          float font_size,
+                          std::string_view characters);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(GlyphWarmUp);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_GLYPH_WARM_UP_H_
@@ -0,0 +1,51 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/glyph_warm_up.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(GlyphWarmUp, ParsesSpecs) {
+  std::optional<GlyphWarmUp::Spec> spec =
+      GlyphWarmUp::ParseSpec("Roboto:14,16.5");
+  ASSERT_TRUE(spec.has_value());
+  EXPECT_EQ(spec->font_family, "Roboto");
+  EXPECT_EQ(spec->font_sizes, std::vector<float>({14, 16.5}));
+  EXPECT_TRUE(spec->characters.empty());
+
+  // The characters run to the end of the spec.
+  spec = GlyphWarmUp::ParseSpec("Noto Sans:12:0123456789:,");
+  ASSERT_TRUE(spec.has_value());
+  EXPECT_EQ(spec->font_family, "Noto Sans");
+  EXPECT_EQ(spec->font_sizes, std::vector<float>({12}));
+  EXPECT_EQ(spec->characters, "0123456789:,");
+}
+
+TEST(GlyphWarmUp, RejectsMalformedSpecs) {
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("Roboto").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec(":14").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("Roboto:").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("Roboto:14,").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("Roboto:14px").has_value());
+  EXPECT_FALSE(GlyphWarmUp::ParseSpec("Roboto:-14").has_value());
+}
+
+TEST(GlyphWarmUp, RasterizesEveryGlyph) {
+  EXPECT_EQ(GlyphWarmUp::Rasterize(nullptr, SkTypeface::MakeDefault(), 14,
+                                   "abc"),
+            3u);
+  EXPECT_EQ(GlyphWarmUp::Rasterize(nullptr, SkTypeface::MakeDefault(), 14, ""),
+            sizeof(GlyphWarmUp::kDefaultCharacters) - 1);
+  // Glyphs that don't fit in the surface at once are drawn in several passes.
+  EXPECT_EQ(GlyphWarmUp::Rasterize(nullptr, SkTypeface::MakeDefault(), 96,
+                                   GlyphWarmUp::kDefaultCharacters),
+            sizeof(GlyphWarmUp::kDefaultCharacters) - 1);
+}
+
+}  // namespace testing
+}  // namespace flutter
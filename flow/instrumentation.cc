@@ -5,8 +5,10 @@
 #include "flutter/flow/instrumentation.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPath.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -14,6 +16,7 @@ namespace flutter {
 
 static const size_t kMaxSamples = 120;
 static const size_t kMaxFrameMarkers = 8;
+static const int kSamplesImageHeight = 64;
 
 Stopwatch::Stopwatch(fml::Milliseconds frame_budget)
     : start_(fml::TimePoint::Now()), current_sample_(0) {
@@ -226,6 +229,56 @@ void Stopwatch::Visualize(SkCanvas& canvas, const SkRect& rect) const {
   visualize_cache_surface_->draw(&canvas, rect.x(), rect.y(), &paint);
 }
 
+void Stopwatch::VisualizeSamples(SkCanvas& canvas, const SkRect& rect) const {
+  if (samples_bitmap_.isNull()) {
+    samples_bitmap_.allocN32Pixels(kMaxSamples, kSamplesImageHeight);
+  }
+
+  // Scale the graph to show frame times up to those that are 3 times the frame
+  // time.
+  const double one_frame_ms = frame_budget_.count();
+  const double max_interval = one_frame_ms * 3.0;
+  const double max_unit_interval = UnitFrameInterval(max_interval);
+
+  // The background, and the timing bars blended over it.
+  samples_bitmap_.eraseColor(0x99FFFFFF);
+  for (int i = 0; i < static_cast<int>(kMaxSamples); i++) {
+    const int sample_y = std::round(
+        kSamplesImageHeight *
+        (1.0 - UnitHeight(laps_[i].ToMillisecondsF(), max_unit_interval)));
+    samples_bitmap_.erase(
+        0xDD3B3BFF, SkIRect::MakeLTRB(i, sample_y, i + 1, kSamplesImageHeight));
+  }
+
+  // The horizontal frame markers.
+  const size_t frame_marker_count =
+      static_cast<size_t>(max_interval / one_frame_ms);
+  for (size_t frame_index = 0; frame_index < frame_marker_count;
+       frame_index++) {
+    const int frame_y = std::min<int>(
+        std::round(kSamplesImageHeight *
+                   (1.0 - UnitFrameInterval((frame_index + 1) * one_frame_ms) /
+                              max_unit_interval)),
+        kSamplesImageHeight - 1);
+    samples_bitmap_.erase(0xCC000000, SkIRect::MakeLTRB(0, frame_y, kMaxSamples,
+                                                        frame_y + 1));
+  }
+
+  // The vertical marker for the current frame.
+  const SkColor marker_color =
+      UnitFrameInterval(LastLap().ToMillisecondsF()) > 1.0 ? SK_ColorRED
+                                                           : SK_ColorGREEN;
+  const int marker_x = static_cast<int>(current_sample_);
+  samples_bitmap_.erase(
+      marker_color,
+      SkIRect::MakeLTRB(marker_x, 0, marker_x + 1, kSamplesImageHeight));
+
+  // The image is uploaded as a whole and stretched over the graph without
+  // filtering, so that the graph is a single textured quad.
+  canvas.drawImageRect(SkImage::MakeFromBitmap(samples_bitmap_), rect,
+                       nullptr);
+}
+
 CounterValues::CounterValues() : current_sample_(kMaxSamples - 1) {
   values_.resize(kMaxSamples, 0);
 }
@@ -10,10 +10,23 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flutter {
 
+// How the performance overlay shows the statistics of the frames.
+enum class PerformanceOverlayMode {
+  // Draws the graphs with |Stopwatch::Visualize|.
+  kGraphs,
+  // Draws the graphs with |Stopwatch::VisualizeSamples|, which costs about as
+  // much as drawing a single image.
+  kLightweight,
+  // Draws nothing and only reports the frame times as trace counters, so that
+  // enabling the overlay does not change the frame times it reports.
+  kExportOnly,
+};
+
 class Stopwatch {
  public:
   Stopwatch(fml::Milliseconds frame_budget = fml::kDefaultFrameBudget);
@@ -32,6 +45,10 @@ class Stopwatch {
 
   void Visualize(SkCanvas& canvas, const SkRect& rect) const;
 
+  // Draws the same graph as |Visualize| from a small image holding a column
+  // per sample, which is scaled to |rect|.
+  void VisualizeSamples(SkCanvas& canvas, const SkRect& rect) const;
+
   void Start();
 
   void Stop();
@@ -53,6 +70,7 @@ class Stopwatch {
   mutable bool cache_dirty_;
   mutable sk_sp<SkSurface> visualize_cache_surface_;
   mutable size_t prev_drawn_sample_index_;
+  mutable SkBitmap samples_bitmap_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Stopwatch);
 };
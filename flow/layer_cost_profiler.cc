@@ -0,0 +1,136 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_cost_profiler.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <sstream>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/flow/raster_cache.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// Paint scopes of layers that weren't prerolled aren't recorded.
+static constexpr size_t kUnknownLayer = std::numeric_limits<size_t>::max();
+
+LayerCostProfiler::LayerCostProfiler() = default;
+
+LayerCostProfiler::~LayerCostProfiler() = default;
+
+void LayerCostProfiler::BeginFrame() {
+  costs_.clear();
+  indices_.clear();
+  scopes_.clear();
+}
+
+void LayerCostProfiler::BeginPreroll(const Layer* layer) {
+  LayerCost cost;
+  cost.layer_id = layer->unique_id();
+  cost.type_name = layer->GetTypeName();
+  cost.depth = scopes_.size();
+  indices_.emplace(layer, costs_.size());
+  scopes_.push_back({costs_.size(), fml::TimePoint::Now(),
+                     fml::TimeDelta::Zero(), 0, 0});
+  costs_.push_back(cost);
+}
+
+void LayerCostProfiler::EndPreroll() {
+  FML_DCHECK(!scopes_.empty());
+  const Scope scope = scopes_.back();
+  scopes_.pop_back();
+  const fml::TimeDelta time = fml::TimePoint::Now() - scope.start;
+  LayerCost& cost = costs_[scope.index];
+  cost.preroll_time = time;
+  cost.self_preroll_time = time - scope.children_time;
+  if (!scopes_.empty()) {
+    scopes_.back().children_time = scopes_.back().children_time + time;
+  }
+}
+
+void LayerCostProfiler::BeginPaint(const Layer* layer,
+                                   const RasterCache* raster_cache) {
+  auto found = indices_.find(layer);
+  scopes_.push_back(
+      {found != indices_.end() ? found->second : kUnknownLayer,
+       fml::TimePoint::Now(), fml::TimeDelta::Zero(),
+       raster_cache ? raster_cache->GetFrameHitCount() : 0,
+       raster_cache ? raster_cache->GetFrameMissCount() : 0});
+}
+
+void LayerCostProfiler::EndPaint(const RasterCache* raster_cache) {
+  FML_DCHECK(!scopes_.empty());
+  const Scope scope = scopes_.back();
+  scopes_.pop_back();
+  const fml::TimeDelta time = fml::TimePoint::Now() - scope.start;
+  const size_t hits =
+      raster_cache ? raster_cache->GetFrameHitCount() - scope.start_hits : 0;
+  const size_t misses =
+      raster_cache ? raster_cache->GetFrameMissCount() - scope.start_misses
+                   : 0;
+  if (scope.index != kUnknownLayer) {
+    LayerCost& cost = costs_[scope.index];
+    cost.painted = true;
+    cost.paint_time = cost.paint_time + time;
+    cost.self_paint_time =
+        cost.self_paint_time + time - scope.children_time;
+    cost.raster_cache_hits += hits - scope.children_hits;
+    cost.raster_cache_misses += misses - scope.children_misses;
+  }
+  if (!scopes_.empty()) {
+    Scope& parent = scopes_.back();
+    parent.children_time = parent.children_time + time;
+    parent.children_hits += hits;
+    parent.children_misses += misses;
+  }
+}
+
+void LayerCostProfiler::EndFrame() {
+  FML_DCHECK(scopes_.empty());
+
+  std::vector<size_t> by_cost(costs_.size());
+  std::iota(by_cost.begin(), by_cost.end(), 0);
+  auto self_time = [this](size_t index) {
+    return costs_[index].self_preroll_time + costs_[index].self_paint_time;
+  };
+  const size_t ranked = std::min<size_t>(3, by_cost.size());
+  std::partial_sort(by_cost.begin(), by_cost.begin() + ranked, by_cost.end(),
+                    [&self_time](size_t a, size_t b) {
+                      return self_time(a) > self_time(b);
+                    });
+  FML_TRACE_EVENT("flutter", "LayerCosts", "layerCount", costs_.size(),
+                  "costliest1", DescribeCostliest(by_cost, 0), "costliest2",
+                  DescribeCostliest(by_cost, 1), "costliest3",
+                  DescribeCostliest(by_cost, 2));
+
+  std::scoped_lock lock(last_frame_mutex_);
+  last_frame_costs_ = costs_;
+}
+
+std::string LayerCostProfiler::DescribeCostliest(
+    const std::vector<size_t>& by_cost,
+    size_t rank) const {
+  if (rank >= by_cost.size()) {
+    return "";
+  }
+  const LayerCost& cost = costs_[by_cost[rank]];
+  std::stringstream stream;
+  stream << cost.type_name << " #" << cost.layer_id << " depth=" << cost.depth
+         << " preroll=" << cost.self_preroll_time.ToMicroseconds() << "us"
+         << " paint=" << cost.self_paint_time.ToMicroseconds() << "us"
+         << " cacheHits=" << cost.raster_cache_hits
+         << " cacheMisses=" << cost.raster_cache_misses;
+  return stream.str();
+}
+
+std::vector<LayerCostProfiler::LayerCost> LayerCostProfiler::GetLastFrameCosts()
+    const {
+  std::scoped_lock lock(last_frame_mutex_);
+  return last_frame_costs_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_COST_PROFILER_H_
+#define FLUTTER_FLOW_LAYER_COST_PROFILER_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+class Layer;
+class RasterCache;
+
+/// Measures how long each layer of a frame takes to preroll and paint, so that
+/// a slow frame can be attributed to the layers that made it slow instead of
+/// only to the frame as a whole.
+///
+/// Profiling reads the clock twice per layer and phase and is only done when
+/// enabled, see |CompositorContext::SetLayerCostProfilingEnabled|. Frames are
+/// profiled on the raster thread, the costs of the last profiled frame can be
+/// read on any thread.
+///
+/// The times are CPU times of the raster thread. The GPU executes the recorded
+/// commands of a frame as a whole when the frame is flushed, so GPU time can't
+/// be attributed to layers.
+class LayerCostProfiler {
+ public:
+  struct LayerCost {
+    uint64_t layer_id = 0;
+    const char* type_name = "";
+    // The depth of the layer in the tree, 0 for the root. The costs are in the
+    // order the layers were prerolled, so the children of a layer follow it.
+    size_t depth = 0;
+    // Including the children of the layer.
+    fml::TimeDelta preroll_time;
+    fml::TimeDelta paint_time;
+    // Excluding the children of the layer.
+    fml::TimeDelta self_preroll_time;
+    fml::TimeDelta self_paint_time;
+    // Layers are not painted when they are empty, outside of the damage of the
+    // frame or hidden behind other layers.
+    bool painted = false;
+    // The raster cache lookups of the layer while painting itself, excluding
+    // its children. A hit means the layer, or the picture or child it caches,
+    // was drawn from the cache.
+    size_t raster_cache_hits = 0;
+    size_t raster_cache_misses = 0;
+  };
+
+  LayerCostProfiler();
+
+  ~LayerCostProfiler();
+
+  void BeginFrame();
+
+  void BeginPreroll(const Layer* layer);
+
+  void EndPreroll();
+
+  // |raster_cache| may be null if the frame is painted without one.
+  void BeginPaint(const Layer* layer, const RasterCache* raster_cache);
+
+  void EndPaint(const RasterCache* raster_cache);
+
+  // Makes the costs of the frame the ones returned by |GetLastFrameCosts| and
+  // adds the three costliest layers as arguments of a "LayerCosts" timeline
+  // event.
+  void EndFrame();
+
+  std::vector<LayerCost> GetLastFrameCosts() const;
+
+ private:
+  struct Scope {
+    size_t index;
+    fml::TimePoint start;
+    fml::TimeDelta children_time;
+    size_t start_hits;
+    size_t start_misses;
+    size_t children_hits = 0;
+    size_t children_misses = 0;
+  };
+
+  // Only touched on the raster thread.
+  std::vector<LayerCost> costs_;
+  std::unordered_map<const Layer*, size_t> indices_;
+  std::vector<Scope> scopes_;
+
+  mutable std::mutex last_frame_mutex_;
+  std::vector<LayerCost> last_frame_costs_;
+
+  // Describes the |rank|th costliest layer of |by_cost|, or returns an empty
+  // string if there are fewer layers.
+  std::string DescribeCostliest(const std::vector<size_t>& by_cost,
+                                size_t rank) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerCostProfiler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYER_COST_PROFILER_H_
@@ -4,26 +4,183 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include <algorithm>
+
+#include "third_party/skia/include/core/SkSurface.h"
+
 namespace flutter {
 
+// Blurs are downsampled by at most their extent divided by this many pixels,
+// which keeps their sigma at least two pixels in the downsampled backdrop. The
+// extent of a blur is three times its sigma.
+static constexpr int kMinDownsampledExtent = 6;
+
+// Reads the backdrop of the device bounds |output| back from |surface| and
+// filters it by |filter|, drawn with |matrix| over |bounds|, at a resolution
+// reduced by |downsample|.
+static BackdropFilterCache::FilteredBackdrop FilterBackdrop(
+    SkSurface* surface,
+    const SkImageFilter* filter,
+    const SkRect& bounds,
+    const SkMatrix& matrix,
+    const SkIRect& output,
+    int downsample) {
+  TRACE_EVENT0("flutter", "BackdropFilterLayer::FilterBackdrop");
+  SkIRect input = filter->filterBounds(output, matrix,
+                                       SkImageFilter::kReverse_MapDirection);
+  if (!input.intersect(SkIRect::MakeWH(surface->width(), surface->height()))) {
+    return {};
+  }
+  sk_sp<SkImage> backdrop = surface->makeImageSnapshot(input);
+  if (!backdrop) {
+    return {};
+  }
+
+  const int width = (input.width() + downsample - 1) / downsample;
+  const int height = (input.height() + downsample - 1) / downsample;
+  sk_sp<SkSurface> offscreen =
+      surface->makeSurface(surface->imageInfo().makeWH(width, height));
+  if (!offscreen) {
+    return {};
+  }
+  SkCanvas* canvas = offscreen->getCanvas();
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->scale(1.0f / downsample, 1.0f / downsample);
+  canvas->translate(-input.left(), -input.top());
+  SkPaint paint;
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas->drawImage(backdrop, input.left(), input.top(), &paint);
+  // Filter the backdrop with a saveLayer like on screen, which maps the
+  // parameters of the filter through the matrix, now including the
+  // downsampling.
+  canvas->concat(matrix);
+  canvas->saveLayer(SkCanvas::SaveLayerRec{&bounds, nullptr, filter, 0});
+  canvas->restore();
+
+  return {offscreen->makeImageSnapshot(),
+          SkRect::MakeXYWH(input.left(), input.top(), width * downsample,
+                           height * downsample)};
+}
+
 BackdropFilterLayer::BackdropFilterLayer(sk_sp<SkImageFilter> filter)
     : filter_(std::move(filter)) {}
 
 void BackdropFilterLayer::Preroll(PrerollContext* context,
                                   const SkMatrix& matrix) {
+  paints_into_frame_surface_ = context->save_layer_depth == 0;
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context, true, bool(filter_));
   ContainerLayer::Preroll(context, matrix);
 }
 
 void BackdropFilterLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (PaintFilteredBackdrop(context)) {
+    // The children are painted right over the filtered backdrop.
+    PaintChildren(context);
+    return;
+  }
+
   Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
       context,
       SkCanvas::SaveLayerRec{&paint_bounds(), nullptr, filter_.get(), 0});
   PaintChildren(context);
 }
 
+bool BackdropFilterLayer::PaintFilteredBackdrop(PaintContext& context) const {
+  BackdropFilterCache* cache = context.backdrop_filter_cache;
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  if (!filter_ || !cache || !paints_into_frame_surface_ ||
+      canvas != cache->frame_canvas() || !canvas->getSurface()) {
+    return false;
+  }
+  const SkMatrix matrix = canvas->getTotalMatrix();
+  if (!matrix.rectStaysRect()) {
+    return false;
+  }
+  SkIRect output = RasterCache::GetDeviceBounds(paint_bounds(), matrix);
+  if (!output.intersect(SkIRect::MakeSize(canvas->getBaseLayerSize()))) {
+    return false;
+  }
+
+  const std::optional<uint64_t> fingerprint =
+      cache->GetFingerprint(unique_id());
+  const BackdropFilterCache::FilteredBackdrop* backdrop =
+      fingerprint ? cache->Get(*fingerprint) : nullptr;
+  BackdropFilterCache::FilteredBackdrop filtered;
+  if (!backdrop) {
+    const int downsample =
+        GetDownsampleFactor(matrix, cache->GetMaxDownsample());
+    // Filtering offscreen costs an extra copy of the backdrop, which only
+    // pays off when it is downsampled or likely reused in the next frames.
+    const bool reuse = fingerprint && cache->WasInPreviousFrame(*fingerprint);
+    if (downsample == 1 && !reuse) {
+      return false;
+    }
+    filtered = FilterBackdrop(canvas->getSurface(), filter_.get(),
+                              paint_bounds(), matrix, output, downsample);
+    if (!filtered.image) {
+      return false;
+    }
+    if (fingerprint) {
+      cache->Put(*fingerprint, filtered);
+    }
+    backdrop = &filtered;
+  }
+
+  SkAutoCanvasRestore auto_restore(canvas, true);
+  canvas->resetMatrix();
+  canvas->clipRect(SkRect::Make(output));
+  SkPaint paint;
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas->drawImageRect(backdrop->image, backdrop->device_bounds, &paint);
+  return true;
+}
+
+int BackdropFilterLayer::GetDownsampleFactor(const SkMatrix& matrix,
+                                             int max_downsample) const {
+  if (max_downsample <= 1) {
+    return 1;
+  }
+  // The extent of the filter around a single pixel.
+  const SkIRect extent =
+      filter_->filterBounds(SkIRect::MakeWH(1, 1), matrix,
+                            SkImageFilter::kForward_MapDirection);
+  const int min_extent = std::min({-extent.left(), -extent.top(),
+                                   extent.right() - 1, extent.bottom() - 1});
+  return std::clamp(min_extent / kMinDownsampledExtent, 1, max_downsample);
+}
+
+void BackdropFilterLayer::Diff(DiffContext* context) const {
+  // The filtered backdrop depends on everything painted below this layer, and
+  // filtering it in a partially repainted buffer would filter the output of an
+  // earlier frame again.
+  context->MarkFullDamage();
+  if (filter_) {
+    // Fingerprinting the backdrop lets the backdrop filter cache tell whether
+    // it changed since the previous frame.
+    std::optional<uint64_t> fingerprint =
+        DiffContext::FingerprintImageFilter(*filter_);
+    const SkIRect output =
+        RasterCache::GetDeviceBounds(paint_bounds(), context->matrix());
+    if (fingerprint) {
+      context->AddBackdropPaintRegion(
+          unique_id(), paint_bounds(),
+          SkRect::Make(filter_->filterBounds(
+              output, context->matrix(), SkImageFilter::kReverse_MapDirection)),
+          *fingerprint);
+    } else {
+      context->AddVolatilePaintRegion(paint_bounds());
+    }
+  }
+  DiffChildren(context, SkMatrix::I(), 0);
+}
+
+std::optional<uint64_t> BackdropFilterLayer::ComputeContentHash() const {
+  // Image filters cannot be compared cheaply.
+  return HashChildren(unique_id());
+}
+
 }  // namespace flutter
@@ -11,6 +11,13 @@
 
 namespace flutter {
 
+// Paints its children over the content painted before it, filtered by
+// |filter|. The filtered backdrop is normally produced by a saveLayer, which
+// filters it at full resolution in every frame. When the layer paints straight
+// into the surface of the frame, the BackdropFilterCache of the frame may
+// instead have it read the backdrop back and filter it at a lower resolution
+// for large blurs, or reuse the backdrop it filtered in an earlier frame when
+// the content below it did not change.
 class BackdropFilterLayer : public ContainerLayer {
  public:
   BackdropFilterLayer(sk_sp<SkImageFilter> filter);
@@ -19,8 +26,27 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "BackdropFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
+  // Whether no ancestor paints this layer into a saveLayer, so that its
+  // backdrop can be read back from the surface of the frame.
+  bool paints_into_frame_surface_ = false;
+
+  // Draws the filtered backdrop without a saveLayer, if the backdrop filter
+  // cache of |context| allows and it is worth it. Returns false if the
+  // backdrop is left to a saveLayer.
+  bool PaintFilteredBackdrop(PaintContext& context) const;
+
+  // The factor the backdrop is downsampled by before it is filtered with
+  // |matrix|, which is at most |max_downsample|.
+  int GetDownsampleFactor(const SkMatrix& matrix, int max_downsample) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(BackdropFilterLayer);
 };
@@ -18,7 +18,7 @@ ChildSceneLayer::ChildSceneLayer(zx_koid_t layer_id,
       hit_testable_(hit_testable) {}
 
 void ChildSceneLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ChildSceneLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ChildSceneLayer::Preroll");
   set_needs_system_composite(true);
 
   CheckForChildLayerBelow(context);
@@ -33,7 +33,7 @@ void ChildSceneLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 }
 
 void ChildSceneLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ChildSceneLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ChildSceneLayer::Paint");
   FML_DCHECK(needs_painting());
   FML_DCHECK(needs_system_composite());
 
@@ -47,7 +47,7 @@ void ChildSceneLayer::Paint(PaintContext& context) const {
 }
 
 void ChildSceneLayer::UpdateScene(SceneUpdateContext& context) {
-  TRACE_EVENT0("flutter", "ChildSceneLayer::UpdateScene");
+  TRACE_EVENT0("flutter.detail", "ChildSceneLayer::UpdateScene");
   FML_DCHECK(needs_system_composite());
 
   Layer::UpdateScene(context);
@@ -60,4 +60,9 @@ void ChildSceneLayer::UpdateScene(SceneUpdateContext& context) {
                            hit_testable_);
 }
 
+std::optional<uint64_t> ChildSceneLayer::ComputeContentHash() const {
+  // The child scene is composited by Scenic and may change at any time.
+  return std::nullopt;
+}
+
 }  // namespace flutter
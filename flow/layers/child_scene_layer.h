@@ -27,8 +27,13 @@ class ChildSceneLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ChildSceneLayer"; }
+
   void UpdateScene(SceneUpdateContext& context) override;
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   zx_koid_t layer_id_ = ZX_KOID_INVALID;
   SkPoint offset_;
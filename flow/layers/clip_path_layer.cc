@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_path_layer.h"
 
+#include "flutter/fml/hash_combine.h"
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 #include "lib/ui/scenic/cpp/commands.h"
@@ -18,13 +20,16 @@ ClipPathLayer::ClipPathLayer(const SkPath& clip_path, Clip clip_behavior)
 }
 
 void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ClipPathLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ClipPathLayer::Preroll");
 
   SkRect previous_cull_rect = context->cull_rect;
   SkRect clip_path_bounds = clip_path_.getBounds();
   children_inside_clip_ = context->cull_rect.intersect(clip_path_bounds);
+  children_need_clip_ = true;
+  rect_clip_.reset();
+  paints_with_save_layer_ = UsesSaveLayer();
   if (children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children inside clip rect");
+    TRACE_EVENT_INSTANT0("flutter.detail", "children inside clip rect");
 
     Layer::AutoPrerollSaveLayerState save =
         Layer::AutoPrerollSaveLayerState::Create(context, UsesSaveLayer());
@@ -32,18 +37,38 @@ void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     SkRect child_paint_bounds = SkRect::MakeEmpty();
     PrerollChildren(context, matrix, &child_paint_bounds);
 
+    // Children painting within the path need no clip, and children clipped
+    // by a rectangular part of it only need a rect clip.
+    if (!clip_path_.isInverseFillType()) {
+      children_need_clip_ =
+          !clip_path_.conservativelyContainsRect(child_paint_bounds);
+      if (children_need_clip_) {
+        rect_clip_ = GetRectClip(child_paint_bounds);
+      } else {
+        TRACE_EVENT_INSTANT0("flutter.detail", "children inside clip, eliding");
+      }
+    }
+    paints_with_save_layer_ =
+        UsesSaveLayer() &&
+        (children_need_clip_ || context->surface_needs_readback);
+
     if (child_paint_bounds.intersect(clip_path_bounds)) {
       set_paint_bounds(child_paint_bounds);
     }
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
+
+  // An inherited opacity can also be applied by the saveLayer used for
+  // anti-aliasing.
+  context->subtree_can_inherit_opacity =
+      paints_with_save_layer_ || children_can_inherit_opacity();
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
-  TRACE_EVENT0("flutter", "ClipPathLayer::UpdateScene");
+  TRACE_EVENT0("flutter.detail", "ClipPathLayer::UpdateScene");
   FML_DCHECK(needs_system_composite());
 
   // TODO(liyuqian): respect clip_behavior_
@@ -54,25 +79,64 @@ void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
 #endif
 
 void ClipPathLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ClipPathLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ClipPathLayer::Paint");
   FML_DCHECK(needs_painting());
 
   if (!children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
+    TRACE_EVENT_INSTANT0("flutter.detail",
+                         "children not inside clip rect, skipping");
     return;
   }
 
-  SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
-  context.internal_nodes_canvas->clipPath(clip_path_,
-                                          clip_behavior_ != Clip::hardEdge);
-
-  if (UsesSaveLayer()) {
-    context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+  SkAutoCanvasRestore save(context.internal_nodes_canvas, children_need_clip_);
+  if (rect_clip_) {
+    context.internal_nodes_canvas->clipRect(*rect_clip_,
+                                            clip_behavior_ != Clip::hardEdge);
+  } else if (children_need_clip_) {
+    context.internal_nodes_canvas->clipPath(clip_path_,
+                                            clip_behavior_ != Clip::hardEdge);
   }
-  PaintChildren(context);
-  if (UsesSaveLayer()) {
+
+  if (paints_with_save_layer_) {
+    SkPaint paint;
+    paint.setAlphaf(context.inherited_opacity);
+    context.internal_nodes_canvas->saveLayer(
+        paint_bounds(),
+        context.inherited_opacity < SK_Scalar1 ? &paint : nullptr);
+    AutoInheritedOpacity inherited_opacity(context, SK_Scalar1);
+    PaintChildren(context);
     context.internal_nodes_canvas->restore();
+  } else {
+    PaintChildren(context);
   }
 }
 
+std::optional<SkRect> ClipPathLayer::GetRectClip(
+    const SkRect& child_paint_bounds) const {
+  SkRect rect;
+  if (clip_path_.isRect(&rect)) {
+    return rect;
+  }
+  SkRRect rrect;
+  if (clip_path_.isRRect(&rrect)) {
+    return ContainerLayer::GetRectClip(rrect, child_paint_bounds);
+  }
+  if (clip_path_.isOval(&rect)) {
+    return ContainerLayer::GetRectClip(SkRRect::MakeOval(rect),
+                                       child_paint_bounds);
+  }
+  return std::nullopt;
+}
+
+void ClipPathLayer::Diff(DiffContext* context) const {
+  DiffChildren(context, SkMatrix::I(),
+               fml::HashCombine(DiffContext::FingerprintPath(clip_path_),
+                                static_cast<int>(clip_behavior_)));
+}
+
+std::optional<uint64_t> ClipPathLayer::ComputeContentHash() const {
+  return HashChildren(fml::HashCombine(DiffContext::FingerprintPath(clip_path_),
+                                      static_cast<int>(clip_behavior_)));
+}
+
 }  // namespace flutter
@@ -137,6 +137,24 @@ TEST_F(ClipPathLayerTest, FullyContainedChild) {
   EXPECT_EQ(mock_layer->parent_matrix(), initial_matrix);
   EXPECT_EQ(mock_layer->parent_mutators(), std::vector({Mutator(layer_path)}));
 
+  // The clip is elided.
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+}
+
+TEST_F(ClipPathLayerTest, ChildAwayFromCornersIsClippedByRect) {
+  const SkRect child_bounds = SkRect::MakeXYWH(-5.0, 20.0, 30.0, 10.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.0, 0.0, 20.0, 50.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPath layer_path = SkPath().addRoundRect(layer_bounds, 5.0, 5.0);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipPathLayer>(layer_path, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
   layer->Paint(paint_context());
   EXPECT_EQ(
       mock_canvas().draw_calls(),
@@ -144,7 +162,33 @@ TEST_F(ClipPathLayerTest, FullyContainedChild) {
           {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
            MockCanvas::DrawCall{
                1, MockCanvas::ClipRectData{layer_bounds, SkClipOp::kIntersect,
-                                           MockCanvas::kHard_ClipEdgeStyle}},
+                                           MockCanvas::kSoft_ClipEdgeStyle}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::DrawPathData{child_path, child_paint}},
+           MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+}
+
+TEST_F(ClipPathLayerTest, ChildNearCornersKeepsPathClip) {
+  const SkRect child_bounds = SkRect::MakeXYWH(-5.0, -5.0, 30.0, 10.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.0, 0.0, 20.0, 50.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkRRect layer_rrect = SkRRect::MakeRectXY(layer_bounds, 5.0, 5.0);
+  const SkPath layer_path = SkPath().addRRect(layer_rrect);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipPathLayer>(layer_path, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector(
+          {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+           // Canvases clip by rounded rect paths as rounded rects.
+           MockCanvas::DrawCall{
+               1, MockCanvas::ClipRRectData{layer_rrect, SkClipOp::kIntersect,
+                                            MockCanvas::kSoft_ClipEdgeStyle}},
            MockCanvas::DrawCall{
                1, MockCanvas::DrawPathData{child_path, child_paint}},
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
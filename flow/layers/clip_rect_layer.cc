@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_rect_layer.h"
 
+#include "flutter/fml/hash_combine.h"
+
 namespace flutter {
 
 ClipRectLayer::ClipRectLayer(const SkRect& clip_rect, Clip clip_behavior)
@@ -12,12 +14,12 @@ ClipRectLayer::ClipRectLayer(const SkRect& clip_rect, Clip clip_behavior)
 }
 
 void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ClipRectLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ClipRectLayer::Preroll");
 
   SkRect previous_cull_rect = context->cull_rect;
   children_inside_clip_ = context->cull_rect.intersect(clip_rect_);
   if (children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children inside clip rect");
+    TRACE_EVENT_INSTANT0("flutter.detail", "children inside clip rect");
 
     Layer::AutoPrerollSaveLayerState save =
         Layer::AutoPrerollSaveLayerState::Create(context, UsesSaveLayer());
@@ -31,12 +33,22 @@ void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
+
+  // An inherited opacity can also be applied by the saveLayer used for
+  // anti-aliasing.
+  context->subtree_can_inherit_opacity =
+      UsesSaveLayer() || children_can_inherit_opacity();
+
+  SkRect opaque_bounds = children_opaque_bounds();
+  if (children_inside_clip_ && opaque_bounds.intersect(clip_rect_)) {
+    context->subtree_opaque_bounds = opaque_bounds;
+  }
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void ClipRectLayer::UpdateScene(SceneUpdateContext& context) {
-  TRACE_EVENT0("flutter", "ClipRectLayer::UpdateScene");
+  TRACE_EVENT0("flutter.detail", "ClipRectLayer::UpdateScene");
   FML_DCHECK(needs_system_composite());
 
   // TODO(liyuqian): respect clip_behavior_
@@ -47,11 +59,12 @@ void ClipRectLayer::UpdateScene(SceneUpdateContext& context) {
 #endif
 
 void ClipRectLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ClipRectLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ClipRectLayer::Paint");
   FML_DCHECK(needs_painting());
 
   if (!children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
+    TRACE_EVENT_INSTANT0("flutter.detail",
+                         "children not inside clip rect, skipping");
     return;
   }
 
@@ -60,12 +73,27 @@ void ClipRectLayer::Paint(PaintContext& context) const {
                                           clip_behavior_ != Clip::hardEdge);
 
   if (UsesSaveLayer()) {
-    context.internal_nodes_canvas->saveLayer(clip_rect_, nullptr);
-  }
-  PaintChildren(context);
-  if (UsesSaveLayer()) {
+    SkPaint paint;
+    paint.setAlphaf(context.inherited_opacity);
+    context.internal_nodes_canvas->saveLayer(
+        clip_rect_, context.inherited_opacity < SK_Scalar1 ? &paint : nullptr);
+    AutoInheritedOpacity inherited_opacity(context, SK_Scalar1);
+    PaintChildren(context);
     context.internal_nodes_canvas->restore();
+  } else {
+    PaintChildren(context);
   }
 }
 
+void ClipRectLayer::Diff(DiffContext* context) const {
+  DiffChildren(context, SkMatrix::I(),
+               fml::HashCombine(DiffContext::FingerprintRect(clip_rect_),
+                                static_cast<int>(clip_behavior_)));
+}
+
+std::optional<uint64_t> ClipRectLayer::ComputeContentHash() const {
+  return HashChildren(fml::HashCombine(DiffContext::FingerprintRect(clip_rect_),
+                                      static_cast<int>(clip_behavior_)));
+}
+
 }  // namespace flutter
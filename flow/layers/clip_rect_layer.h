@@ -16,6 +16,10 @@ class ClipRectLayer : public ContainerLayer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ClipRectLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -24,6 +28,9 @@ class ClipRectLayer : public ContainerLayer {
   void UpdateScene(SceneUpdateContext& context) override;
 #endif
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   SkRect clip_rect_;
   Clip clip_behavior_;
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_rrect_layer.h"
 
+#include "flutter/fml/hash_combine.h"
+
 namespace flutter {
 
 ClipRRectLayer::ClipRRectLayer(const SkRRect& clip_rrect, Clip clip_behavior)
@@ -12,13 +14,16 @@ ClipRRectLayer::ClipRRectLayer(const SkRRect& clip_rrect, Clip clip_behavior)
 }
 
 void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ClipRRectLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ClipRRectLayer::Preroll");
 
   SkRect previous_cull_rect = context->cull_rect;
   SkRect clip_rrect_bounds = clip_rrect_.getBounds();
   children_inside_clip_ = context->cull_rect.intersect(clip_rrect_bounds);
+  children_need_clip_ = true;
+  rect_clip_.reset();
+  paints_with_save_layer_ = UsesSaveLayer();
   if (children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children inside clip rect");
+    TRACE_EVENT_INSTANT0("flutter.detail", "children inside clip rect");
 
     Layer::AutoPrerollSaveLayerState save =
         Layer::AutoPrerollSaveLayerState::Create(context, UsesSaveLayer());
@@ -26,18 +31,41 @@ void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     SkRect child_paint_bounds = SkRect::MakeEmpty();
     PrerollChildren(context, matrix, &child_paint_bounds);
 
+    // Children painting within the rounded rect need no clip, and children
+    // painting away from its corners only need its rect.
+    children_need_clip_ = !clip_rrect_.contains(child_paint_bounds);
+    if (children_need_clip_) {
+      rect_clip_ = GetRectClip(clip_rrect_, child_paint_bounds);
+    } else {
+      TRACE_EVENT_INSTANT0("flutter.detail", "children inside clip, eliding");
+    }
+    paints_with_save_layer_ =
+        UsesSaveLayer() &&
+        (children_need_clip_ || context->surface_needs_readback);
+
     if (child_paint_bounds.intersect(clip_rrect_bounds)) {
       set_paint_bounds(child_paint_bounds);
     }
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
+
+  // An inherited opacity can also be applied by the saveLayer used for
+  // anti-aliasing.
+  context->subtree_can_inherit_opacity =
+      paints_with_save_layer_ || children_can_inherit_opacity();
+
+  SkRect opaque_bounds = children_opaque_bounds();
+  if (children_inside_clip_ &&
+      opaque_bounds.intersect(GetInnerRect(clip_rrect_))) {
+    context->subtree_opaque_bounds = opaque_bounds;
+  }
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void ClipRRectLayer::UpdateScene(SceneUpdateContext& context) {
-  TRACE_EVENT0("flutter", "ClipRRectLayer::UpdateScene");
+  TRACE_EVENT0("flutter.detail", "ClipRRectLayer::UpdateScene");
   FML_DCHECK(needs_system_composite());
 
   // TODO(liyuqian): respect clip_behavior_
@@ -48,25 +76,48 @@ void ClipRRectLayer::UpdateScene(SceneUpdateContext& context) {
 #endif
 
 void ClipRRectLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ClipRRectLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ClipRRectLayer::Paint");
   FML_DCHECK(needs_painting());
 
   if (!children_inside_clip_) {
-    TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
+    TRACE_EVENT_INSTANT0("flutter.detail",
+                         "children not inside clip rect, skipping");
     return;
   }
 
-  SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
-  context.internal_nodes_canvas->clipRRect(clip_rrect_,
-                                           clip_behavior_ != Clip::hardEdge);
-
-  if (UsesSaveLayer()) {
-    context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+  SkAutoCanvasRestore save(context.internal_nodes_canvas, children_need_clip_);
+  if (rect_clip_) {
+    context.internal_nodes_canvas->clipRect(*rect_clip_,
+                                            clip_behavior_ != Clip::hardEdge);
+  } else if (children_need_clip_) {
+    context.internal_nodes_canvas->clipRRect(clip_rrect_,
+                                             clip_behavior_ != Clip::hardEdge);
   }
-  PaintChildren(context);
-  if (UsesSaveLayer()) {
+
+  if (paints_with_save_layer_) {
+    SkPaint paint;
+    paint.setAlphaf(context.inherited_opacity);
+    context.internal_nodes_canvas->saveLayer(
+        paint_bounds(),
+        context.inherited_opacity < SK_Scalar1 ? &paint : nullptr);
+    AutoInheritedOpacity inherited_opacity(context, SK_Scalar1);
+    PaintChildren(context);
     context.internal_nodes_canvas->restore();
+  } else {
+    PaintChildren(context);
   }
 }
 
+void ClipRRectLayer::Diff(DiffContext* context) const {
+  DiffChildren(context, SkMatrix::I(),
+               fml::HashCombine(DiffContext::FingerprintRRect(clip_rrect_),
+                                static_cast<int>(clip_behavior_)));
+}
+
+std::optional<uint64_t> ClipRRectLayer::ComputeContentHash() const {
+  return HashChildren(
+      fml::HashCombine(DiffContext::FingerprintRRect(clip_rrect_),
+                       static_cast<int>(clip_behavior_)));
+}
+
 }  // namespace flutter
@@ -17,6 +17,10 @@ class ClipRRectLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ClipRRectLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -25,10 +29,21 @@ class ClipRRectLayer : public ContainerLayer {
   void UpdateScene(SceneUpdateContext& context) override;
 #endif
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   SkRRect clip_rrect_;
   Clip clip_behavior_;
   bool children_inside_clip_ = false;
+  // Whether the children paint outside of the inner region of the clip, as
+  // found by Preroll.
+  bool children_need_clip_ = true;
+  // A rect that clips the children like the clip does, if any.
+  std::optional<SkRect> rect_clip_;
+  // Whether Paint uses a saveLayer, which is elided along with the clip unless
+  // the children read back from it.
+  bool paints_with_save_layer_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipRRectLayer);
 };
@@ -140,6 +140,24 @@ TEST_F(ClipRRectLayerTest, FullyContainedChild) {
   EXPECT_EQ(mock_layer->parent_matrix(), initial_matrix);
   EXPECT_EQ(mock_layer->parent_mutators(), std::vector({Mutator(layer_rrect)}));
 
+  // The clip is elided.
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+}
+
+TEST_F(ClipRRectLayerTest, ChildAwayFromCornersIsClippedByRect) {
+  const SkRect child_bounds = SkRect::MakeXYWH(-5.0, 20.0, 30.0, 10.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.0, 0.0, 20.0, 50.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkRRect layer_rrect = SkRRect::MakeRectXY(layer_bounds, 5.0, 5.0);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipRRectLayer>(layer_rrect, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
   layer->Paint(paint_context());
   EXPECT_EQ(
       mock_canvas().draw_calls(),
@@ -147,12 +165,31 @@ TEST_F(ClipRRectLayerTest, FullyContainedChild) {
           {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
            MockCanvas::DrawCall{
                1, MockCanvas::ClipRectData{layer_bounds, SkClipOp::kIntersect,
-                                           MockCanvas::kHard_ClipEdgeStyle}},
+                                           MockCanvas::kSoft_ClipEdgeStyle}},
            MockCanvas::DrawCall{
                1, MockCanvas::DrawPathData{child_path, child_paint}},
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
+TEST_F(ClipRRectLayerTest, SaveLayerIsElidedForContainedChild) {
+  const SkRect child_bounds = SkRect::MakeXYWH(5.0, 5.0, 10.0, 10.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.0, 0.0, 20.0, 20.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkRRect layer_rrect = SkRRect::MakeRectXY(layer_bounds, 5.0, 5.0);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipRRectLayer>(layer_rrect,
+                                                Clip::antiAliasWithSaveLayer);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(), child_bounds);
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+}
+
 TEST_F(ClipRRectLayerTest, PartiallyContainedChild) {
   const SkMatrix initial_matrix = SkMatrix::Translate(0.5f, 1.0f);
   const SkRect cull_bounds = SkRect::MakeXYWH(0.0, 0.0, 4.0, 5.5);
@@ -7,25 +7,57 @@
 namespace flutter {
 
 ColorFilterLayer::ColorFilterLayer(sk_sp<SkColorFilter> filter)
-    : filter_(std::move(filter)) {}
+    : filter_(std::move(filter)), render_count_(1) {}
 
 void ColorFilterLayer::Preroll(PrerollContext* context,
                                const SkMatrix& matrix) {
+  TRACE_EVENT0("flutter.detail", "ColorFilterLayer::Preroll");
+
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
   ContainerLayer::Preroll(context, matrix);
+
+  if (render_count_ >= kMinimumRendersBeforeCachingFilterLayer) {
+    TryToPrepareRasterCache(context, this, matrix);
+  } else {
+    render_count_++;
+    // Color filters don't depend on the transform, so the cached children
+    // can be filtered as they are drawn.
+    TryToPrepareRasterCache(context, GetCacheableChild(), matrix);
+  }
 }
 
 void ColorFilterLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ColorFilterLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ColorFilterLayer::Paint");
   FML_DCHECK(needs_painting());
 
   SkPaint paint;
   paint.setColorFilter(filter_);
 
+  if (context.raster_cache) {
+    if (context.raster_cache->Draw(this, *context.leaf_nodes_canvas)) {
+      return;
+    }
+    if (context.raster_cache->Draw(GetCacheableChild(),
+                                   *context.leaf_nodes_canvas, &paint)) {
+      return;
+    }
+  }
+
   Layer::AutoSaveLayer save =
       Layer::AutoSaveLayer::Create(context, paint_bounds(), &paint);
   PaintChildren(context);
 }
 
+void ColorFilterLayer::Diff(DiffContext* context) const {
+  // Color filters cannot be compared cheaply. Treat the layer as changed
+  // whenever it is rebuilt.
+  Layer::Diff(context);
+}
+
+std::optional<uint64_t> ColorFilterLayer::ComputeContentHash() const {
+  // Color filters cannot be compared cheaply.
+  return HashChildren(unique_id());
+}
+
 }  // namespace flutter
@@ -11,7 +11,7 @@
 
 namespace flutter {
 
-class ColorFilterLayer : public ContainerLayer {
+class ColorFilterLayer : public MergedContainerLayer {
  public:
   ColorFilterLayer(sk_sp<SkColorFilter> filter);
 
@@ -19,8 +19,22 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ColorFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
+  // Like the ImageFilterLayer, the ColorFilterLayer caches its children
+  // while it is new, such as while its filter animates, and applies the
+  // filter when drawing them from the cache. Once the same layer has been
+  // rendered this many times, it caches its filtered output instead.
+  static constexpr int kMinimumRendersBeforeCachingFilterLayer = 3;
+
   sk_sp<SkColorFilter> filter_;
+  int render_count_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ColorFilterLayer);
 };
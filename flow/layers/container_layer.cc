@@ -4,6 +4,14 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#include "flutter/flow/concurrent_paint_recorder.h"
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
 namespace flutter {
 
 ContainerLayer::ContainerLayer() {}
@@ -13,17 +21,208 @@ void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
 }
 
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ContainerLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ContainerLayer::Preroll");
 
   SkRect child_paint_bounds = SkRect::MakeEmpty();
   PrerollChildren(context, matrix, &child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+
+  // A plain container paints nothing of its own.
+  context->subtree_can_inherit_opacity = children_can_inherit_opacity();
+  context->subtree_opaque_bounds = children_opaque_bounds();
 }
 
 void ContainerLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting());
 
-  PaintChildren(context);
+  PaintChildren(context, true /* allow_concurrent_paint */);
+}
+
+namespace {
+
+// The results of prerolling a range of sibling layers, merged into the parent
+// once all ranges are done.
+struct ChildrenPrerollResult {
+  SkRect paint_bounds = SkRect::MakeEmpty();
+  bool has_platform_view = false;
+  bool needs_system_composite = false;
+  bool can_inherit_opacity = true;
+};
+
+// What a child reported during its Preroll that decides whether its earlier
+// siblings are hidden behind it.
+struct ChildOcclusionInfo {
+  SkRect opaque_bounds = SkRect::MakeEmpty();
+  bool reads_surface = false;
+  bool has_platform_view = false;
+};
+
+using LayerIterator = std::vector<std::shared_ptr<Layer>>::const_iterator;
+
+void PrerollLayers(PrerollContext* context,
+                   const SkMatrix& child_matrix,
+                   LayerIterator begin,
+                   LayerIterator end,
+                   ChildOcclusionInfo* occlusion_info,
+                   ChildrenPrerollResult* result) {
+  for (auto it = begin; it != end; ++it) {
+    Layer* layer = it->get();
+    // Reset context->has_platform_view to false so that layers aren't treated
+    // as if they have a platform view based on one being previously found in a
+    // sibling tree.
+    context->has_platform_view = false;
+    context->subtree_can_inherit_opacity = false;
+    context->subtree_opaque_bounds.setEmpty();
+    const bool surface_needed_readback = context->surface_needs_readback;
+    context->surface_needs_readback = false;
+
+    if (context->layer_cost_profiler) {
+      context->layer_cost_profiler->BeginPreroll(layer);
+      layer->Preroll(context, child_matrix);
+      context->layer_cost_profiler->EndPreroll();
+    } else {
+      layer->Preroll(context, child_matrix);
+    }
+
+    occlusion_info->opaque_bounds = context->subtree_opaque_bounds;
+    occlusion_info->reads_surface = context->surface_needs_readback;
+    occlusion_info->has_platform_view = context->has_platform_view;
+    occlusion_info++;
+    context->surface_needs_readback =
+        surface_needed_readback || context->surface_needs_readback;
+
+    if (layer->needs_system_composite()) {
+      result->needs_system_composite = true;
+    }
+    // Overlapping children would blend with each other if the opacity was
+    // applied to them separately. Comparing against the bounds of all of the
+    // previous children is conservative but keeps this linear.
+    if (!context->subtree_can_inherit_opacity ||
+        SkRect::Intersects(result->paint_bounds, layer->paint_bounds())) {
+      result->can_inherit_opacity = false;
+    }
+    result->paint_bounds.join(layer->paint_bounds());
+
+    result->has_platform_view =
+        result->has_platform_view || context->has_platform_view;
+  }
+}
+
+// Returns which of |layers| are completely hidden behind the opaque bounds of
+// later siblings. The comparison is made in whole device pixels so that
+// partially covered edge pixels never hide anything. A child that reads back
+// from the surface depends on everything painted before it, so it hides the
+// content below it from nothing above it.
+std::vector<bool> ComputeOccludedChildren(
+    const SkMatrix& child_matrix,
+    const std::vector<std::shared_ptr<Layer>>& layers,
+    const std::vector<ChildOcclusionInfo>& occlusion_info) {
+  std::vector<bool> occluded;
+  if (!child_matrix.rectStaysRect()) {
+    // Mapped rects would only be bounds of the mapped opaque areas.
+    return occluded;
+  }
+
+  SkIRect occluder = SkIRect::MakeEmpty();
+  for (size_t i = layers.size(); i-- > 0;) {
+    const Layer* layer = layers[i].get();
+    const ChildOcclusionInfo& info = occlusion_info[i];
+    // The bounds are padded by a pixel because raster cache entries may be
+    // rendered with the translation snapped to a slightly different grid.
+    if (!occluder.isEmpty() && layer->needs_painting() &&
+        !info.has_platform_view && !layer->needs_system_composite() &&
+        occluder.contains(
+            RasterCache::GetDeviceBounds(layer->paint_bounds(), child_matrix)
+                .makeOutset(1, 1))) {
+      if (occluded.empty()) {
+        occluded.resize(layers.size(), false);
+      }
+      occluded[i] = true;
+      continue;
+    }
+
+    if (info.reads_surface) {
+      occluder.setEmpty();
+    }
+    if (!info.opaque_bounds.isEmpty()) {
+      SkIRect opaque;
+      child_matrix.mapRect(info.opaque_bounds).roundIn(&opaque);
+      // Only a single rect is tracked, so keep the larger one.
+      if (opaque.contains(occluder) ||
+          (!occluder.contains(opaque) &&
+           int64_t{opaque.width()} * opaque.height() >
+               int64_t{occluder.width()} * occluder.height())) {
+        occluder = opaque;
+      }
+    }
+  }
+  return occluded;
+}
+
+// The largest opaque rect of the children that are painted before the first
+// one that reads back from the surface, which would also read what is below
+// this container.
+SkRect ComputeOpaqueBounds(const ChildOcclusionInfo* occlusion_info,
+                           size_t count) {
+  SkRect opaque_bounds = SkRect::MakeEmpty();
+  for (size_t i = 0; i < count; i++) {
+    const ChildOcclusionInfo& info = occlusion_info[i];
+    if (info.reads_surface) {
+      break;
+    }
+    if (info.opaque_bounds.width() * info.opaque_bounds.height() >
+        opaque_bounds.width() * opaque_bounds.height()) {
+      opaque_bounds = info.opaque_bounds;
+    }
+  }
+  return opaque_bounds;
+}
+
+}  // namespace
+
+SkRect ContainerLayer::GetInnerRect(const SkRRect& rrect) {
+  SkScalar inset_x = 0;
+  SkScalar inset_y = 0;
+  for (int corner = 0; corner < 4; corner++) {
+    SkVector radii = rrect.radii(static_cast<SkRRect::Corner>(corner));
+    inset_x = std::max(inset_x, radii.fX);
+    inset_y = std::max(inset_y, radii.fY);
+  }
+  SkRect inner = rrect.rect().makeInset(inset_x, inset_y);
+  return inner.isEmpty() ? SkRect::MakeEmpty() : inner;
+}
+
+std::optional<SkRect> ContainerLayer::GetRectClip(const SkRRect& rrect,
+                                                  const SkRect& bounds) {
+  const SkRect& rect = rrect.rect();
+  for (int i = 0; i < 4; i++) {
+    const SkRRect::Corner corner = static_cast<SkRRect::Corner>(i);
+    const SkVector radii = rrect.radii(corner);
+    if (radii.isZero()) {
+      continue;
+    }
+    const bool left = corner == SkRRect::kUpperLeft_Corner ||
+                      corner == SkRRect::kLowerLeft_Corner;
+    const bool top = corner == SkRRect::kUpperLeft_Corner ||
+                     corner == SkRRect::kUpperRight_Corner;
+    const SkRect corner_bounds = SkRect::MakeXYWH(
+        left ? rect.fLeft : rect.fRight - radii.fX,
+        top ? rect.fTop : rect.fBottom - radii.fY, radii.fX, radii.fY);
+    if (corner_bounds.intersects(bounds)) {
+      return std::nullopt;
+    }
+  }
+  return rect;
+}
+
+bool ContainerLayer::ShouldPrerollChildrenConcurrently(
+    PrerollContext* context) const {
+  // Platform views are prerolled through the view embedder, which must only be
+  // called from the raster thread. Profiled layers are timed on one thread.
+  return context->concurrent_task_runner != nullptr &&
+         context->view_embedder == nullptr &&
+         context->layer_cost_profiler == nullptr &&
+         layers_.size() >= kMinChildrenForConcurrentPreroll;
 }
 
 void ContainerLayer::PrerollChildren(PrerollContext* context,
@@ -37,25 +236,134 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   // Platform views have no children, so context->has_platform_view should
   // always be false.
   FML_DCHECK(!context->has_platform_view);
-  bool child_has_platform_view = false;
-  for (auto& layer : layers_) {
-    // Reset context->has_platform_view to false so that layers aren't treated
-    // as if they have a platform view based on one being previously found in a
-    // sibling tree.
-    context->has_platform_view = false;
 
-    layer->Preroll(context, child_matrix);
+  // A single child, the most common case, doesn't need an allocation.
+  ChildOcclusionInfo single_child_info;
+  std::vector<ChildOcclusionInfo> occlusion_info;
+  ChildOcclusionInfo* occlusion_data = &single_child_info;
+  if (layers_.size() > 1) {
+    occlusion_info.resize(layers_.size());
+    occlusion_data = occlusion_info.data();
+  }
 
-    if (layer->needs_system_composite()) {
-      set_needs_system_composite(true);
+  ChildrenPrerollResult result;
+  if (ShouldPrerollChildrenConcurrently(context)) {
+    TRACE_EVENT0("flutter.detail",
+                 "ContainerLayer::PrerollChildrenConcurrently");
+
+    // The children are split into contiguous ranges, one per task. Each range
+    // is prerolled with its own copy of the context and mutators stack so that
+    // siblings in different ranges never observe each other's state. The
+    // copies don't carry the task runner, so nested containers preroll
+    // serially on the worker they were scheduled on and no worker ever waits
+    // for tasks queued behind it.
+    const size_t task_count =
+        std::min<size_t>(layers_.size(),
+                         std::max(1u, std::thread::hardware_concurrency()));
+    const size_t range_size = (layers_.size() + task_count - 1) / task_count;
+
+    struct Task {
+      LayerIterator begin;
+      LayerIterator end;
+      ChildOcclusionInfo* occlusion_info;
+      MutatorsStack mutators_stack;
+      bool surface_needs_readback = false;
+      bool has_texture_layer = false;
+      ChildrenPrerollResult result;
+    };
+    std::vector<Task> tasks;
+    for (size_t start = 0; start < layers_.size(); start += range_size) {
+      size_t stop = std::min(start + range_size, layers_.size());
+      tasks.push_back({layers_.begin() + start, layers_.begin() + stop,
+                       occlusion_data + start,
+                       context->mutators_stack});
     }
-    child_paint_bounds->join(layer->paint_bounds());
 
-    child_has_platform_view =
-        child_has_platform_view || context->has_platform_view;
+    auto preroll_range = [context, &child_matrix](Task& task) {
+      PrerollContext task_context = {
+          context->raster_cache,
+          context->gr_context,
+          context->view_embedder,
+          task.mutators_stack,
+          context->dst_color_space,
+          context->cull_rect,
+          context->surface_needs_readback,
+          context->raster_time,
+          context->ui_time,
+          context->texture_registry,
+          context->checkerboard_offscreen_layers,
+          context->frame_physical_depth,
+          context->frame_device_pixel_ratio};
+      task_context.total_elevation = context->total_elevation;
+      task_context.is_opaque = context->is_opaque;
+      PrerollLayers(&task_context, child_matrix, task.begin, task.end,
+                    task.occlusion_info, &task.result);
+      task.surface_needs_readback = task_context.surface_needs_readback;
+      task.has_texture_layer = task_context.has_texture_layer;
+    };
+
+    // While the tasks run, the raster cache only records which entries are
+    // needed and rasterizes them on this thread afterwards.
+    if (context->raster_cache) {
+      context->raster_cache->BeginConcurrentPreroll();
+    }
+    fml::CountDownLatch latch(tasks.size() - 1);
+    for (size_t i = 1; i < tasks.size(); i++) {
+      // The same range of children is likely prerolled on the same worker as
+      // in the last frame, which may still have their data cached.
+      context->concurrent_task_runner->PostTaskWithAffinity(
+          [&preroll_range, &latch, task = &tasks[i]]() {
+            preroll_range(*task);
+            latch.CountDown();
+          },
+          i);
+    }
+    preroll_range(tasks[0]);
+    latch.Wait();
+    if (context->raster_cache) {
+      context->raster_cache->EndConcurrentPreroll(context);
+    }
+
+    for (const Task& task : tasks) {
+      if (!task.result.can_inherit_opacity ||
+          SkRect::Intersects(result.paint_bounds, task.result.paint_bounds)) {
+        result.can_inherit_opacity = false;
+      }
+      result.paint_bounds.join(task.result.paint_bounds);
+      result.has_platform_view =
+          result.has_platform_view || task.result.has_platform_view;
+      result.needs_system_composite =
+          result.needs_system_composite || task.result.needs_system_composite;
+      context->surface_needs_readback =
+          context->surface_needs_readback || task.surface_needs_readback;
+      context->has_texture_layer =
+          context->has_texture_layer || task.has_texture_layer;
+    }
+  } else {
+    PrerollLayers(context, child_matrix, layers_.begin(), layers_.end(),
+                  occlusion_data, &result);
   }
 
-  context->has_platform_view = child_has_platform_view;
+  if (result.needs_system_composite) {
+    set_needs_system_composite(true);
+  }
+  child_paint_bounds->join(result.paint_bounds);
+  context->has_platform_view = result.has_platform_view;
+  // Layers opt into opacity inheritance explicitly, see
+  // children_can_inherit_opacity.
+  children_can_inherit_opacity_ = result.can_inherit_opacity;
+  context->subtree_can_inherit_opacity = false;
+  // Layers opt into reporting opaque bounds explicitly as well, see
+  // children_opaque_bounds.
+  if (occlusion_info.empty()) {
+    occluded_children_.clear();
+  } else {
+    occluded_children_ =
+        ComputeOccludedChildren(child_matrix, layers_, occlusion_info);
+  }
+  children_opaque_bounds_ =
+      ComputeOpaqueBounds(occlusion_data, layers_.size());
+  context->subtree_opaque_bounds.setEmpty();
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   if (child_layer_exists_below_) {
@@ -66,16 +374,79 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
 #endif
 }
 
-void ContainerLayer::PaintChildren(PaintContext& context) const {
+void ContainerLayer::PaintChildren(PaintContext& context,
+                                   bool allow_concurrent_paint) const {
   FML_DCHECK(needs_painting());
 
+  ConcurrentPaintRecorder* recorder = context.concurrent_paint_recorder;
+  if (!allow_concurrent_paint) {
+    context.concurrent_paint_recorder = nullptr;
+  } else if (recorder && layers_.size() >= kMinChildrenForConcurrentPaint) {
+    std::vector<const Layer*> layers;
+    layers.reserve(layers_.size());
+    for (size_t i = 0; i < layers_.size(); i++) {
+      if (layers_[i]->needs_painting() &&
+          (occluded_children_.empty() || !occluded_children_[i])) {
+        layers.push_back(layers_[i].get());
+      }
+    }
+    if (layers.size() >= kMinChildrenForConcurrentPaint &&
+        recorder->PaintLayers(context, layers)) {
+      return;
+    }
+  }
+
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
+  for (size_t i = 0; i < layers_.size(); i++) {
+    const auto& layer = layers_[i];
+    if (layer->needs_painting() &&
+        (occluded_children_.empty() || !occluded_children_[i])) {
+      if (context.layer_cost_profiler) {
+        context.layer_cost_profiler->BeginPaint(layer.get(),
+                                                context.raster_cache);
+        layer->Paint(context);
+        context.layer_cost_profiler->EndPaint(context.raster_cache);
+      } else {
+        layer->Paint(context);
+      }
+    }
+  }
+  context.concurrent_paint_recorder = recorder;
+}
+
+void ContainerLayer::Diff(DiffContext* context) const {
+  // A plain container does not affect the output of its children.
+  DiffChildren(context, SkMatrix::I(), 0);
+}
+
+void ContainerLayer::DiffChildren(DiffContext* context,
+                                  const SkMatrix& child_matrix,
+                                  uint64_t fingerprint) const {
+  DiffContext::AutoSubtree subtree(context, child_matrix, fingerprint);
   for (auto& layer : layers_) {
     if (layer->needs_painting()) {
-      layer->Paint(context);
+      layer->Diff(context);
+    }
+  }
+}
+
+std::optional<uint64_t> ContainerLayer::HashChildren(
+    uint64_t fingerprint) const {
+  size_t hash = fml::HashCombine(fingerprint, layers_.size());
+  for (auto& layer : layers_) {
+    std::optional<uint64_t> child_hash = layer->GetContentHash();
+    if (!child_hash) {
+      return std::nullopt;
     }
+    fml::HashCombineSeed(hash, *child_hash);
   }
+  return hash;
+}
+
+std::optional<uint64_t> ContainerLayer::ComputeContentHash() const {
+  // A plain container does not affect the output of its children.
+  return HashChildren(0);
 }
 
 void ContainerLayer::TryToPrepareRasterCache(PrerollContext* context,
@@ -125,7 +496,7 @@ void ContainerLayer::UpdateSceneChildren(SceneUpdateContext& context) {
     // frame so we won't call PhysicalShapeLayer::Paint.
     LayerRasterCacheKey key(unique_id(), context.Matrix());
     if (context.HasRetainedNode(key)) {
-      TRACE_EVENT_INSTANT0("flutter", "retained layer cache hit");
+      TRACE_EVENT_INSTANT0("flutter.detail", "retained layer cache hit");
       scenic::EntityNode* retained_node = context.GetRetainedNode(key);
       FML_DCHECK(context.top_entity());
       FML_DCHECK(retained_node->session() == context.session());
@@ -137,7 +508,7 @@ void ContainerLayer::UpdateSceneChildren(SceneUpdateContext& context) {
       return;
     }
 
-    TRACE_EVENT_INSTANT0("flutter", "cache miss, creating");
+    TRACE_EVENT_INSTANT0("flutter.detail", "cache miss, creating");
     // If we can't find an existing retained surface, create one.
     SceneUpdateContext::Frame frame(
         context, SkRRect::MakeRect(paint_bounds()), SK_ColorTRANSPARENT,
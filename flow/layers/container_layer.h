@@ -12,12 +12,23 @@ namespace flutter {
 
 class ContainerLayer : public Layer {
  public:
+  // The minimum number of children a container needs for them to be prerolled
+  // concurrently when the PrerollContext provides a concurrent task runner.
+  // Fanning out fewer children costs more than it saves.
+  static constexpr size_t kMinChildrenForConcurrentPreroll = 4;
+
+  // The minimum number of children to paint for them to be painted
+  // concurrently when the PaintContext provides a ConcurrentPaintRecorder.
+  static constexpr size_t kMinChildrenForConcurrentPaint = 4;
+
   ContainerLayer();
 
   virtual void Add(std::shared_ptr<Layer> layer);
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
+  const char* GetTypeName() const override { return "ContainerLayer"; }
+  void Diff(DiffContext* context) const override;
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void CheckForChildLayerBelow(PrerollContext* context) override;
   void UpdateScene(SceneUpdateContext& context) override;
@@ -29,7 +40,55 @@ class ContainerLayer : public Layer {
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
-  void PaintChildren(PaintContext& context) const;
+
+  // Paints the children that are not occluded.
+  //
+  // Only layers that apply nothing but transforms to the canvas pass
+  // |allow_concurrent_paint|. The children may then be painted through the
+  // ConcurrentPaintRecorder of |context|, if any, or pass it on to their own
+  // children. Otherwise the recorder is hidden from the subtree, since its
+  // recordings are replayed into the surface without the clips and save
+  // layers of the canvas.
+  void PaintChildren(PaintContext& context,
+                     bool allow_concurrent_paint = false) const;
+
+  // Whether all children reported that they can inherit opacity during the
+  // last PrerollChildren and their paint bounds don't overlap, so that an
+  // opacity can be applied to each child separately.
+  bool children_can_inherit_opacity() const {
+    return children_can_inherit_opacity_;
+  }
+
+  // The largest of the opaque rects reported by the children during the last
+  // PrerollChildren, see PrerollContext::subtree_opaque_bounds.
+  const SkRect& children_opaque_bounds() const {
+    return children_opaque_bounds_;
+  }
+
+  // A rect inside |rrect|, used as the opaque bounds of rounded shapes.
+  static SkRect GetInnerRect(const SkRRect& rrect);
+
+  // The rect that clips content within |bounds| like |rrect| does, or
+  // std::nullopt if the rounded corners of |rrect| reach into |bounds|.
+  static std::optional<SkRect> GetRectClip(const SkRRect& rrect,
+                                           const SkRect& bounds);
+
+  // Describes the children to |context|. |child_matrix| and |fingerprint|
+  // describe what this layer does to the output of its children, see
+  // |DiffContext::AutoSubtree|.
+  void DiffChildren(DiffContext* context,
+                    const SkMatrix& child_matrix,
+                    uint64_t fingerprint) const;
+
+  // Hashes the content of the children for |ComputeContentHash|.
+  // |fingerprint| describes what this layer does to the output of its
+  // children, like the fingerprint passed to |DiffChildren|.
+  //
+  // Subclasses must override |ComputeContentHash| to hash what they add to
+  // the children, or their unique id if that can't be hashed cheaply.
+  std::optional<uint64_t> HashChildren(uint64_t fingerprint) const;
+
+  std::optional<uint64_t> ComputeContentHash() const override;
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateSceneChildren(SceneUpdateContext& context);
@@ -51,6 +110,13 @@ class ContainerLayer : public Layer {
 
  private:
   std::vector<std::shared_ptr<Layer>> layers_;
+  bool children_can_inherit_opacity_ = false;
+  SkRect children_opaque_bounds_ = SkRect::MakeEmpty();
+  // Which children are fully hidden behind opaque later siblings and are
+  // skipped by PaintChildren. Empty if none are.
+  std::vector<bool> occluded_children_;
+
+  bool ShouldPrerollChildrenConcurrently(PrerollContext* context) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
@@ -4,8 +4,10 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include "flutter/flow/concurrent_paint_recorder.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 
@@ -268,5 +270,174 @@ TEST_F(ContainerLayerTest, MergedMultipleChildren) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST_F(ContainerLayerTest, ConcurrentPrerollMergesChildResults) {
+  const size_t child_count =
+      ContainerLayer::kMinChildrenForConcurrentPreroll * 2;
+  SkMatrix initial_transform = SkMatrix::Translate(-0.5f, -0.5f);
+
+  auto layer = std::make_shared<ContainerLayer>();
+  std::vector<std::shared_ptr<MockLayer>> mock_layers;
+  SkRect expected_total_bounds = SkRect::MakeEmpty();
+  for (size_t i = 0; i < child_count; i++) {
+    SkPath child_path;
+    child_path.addRect(SkRect::MakeXYWH(i * 10.0f, 5.0f, 8.0f, 8.0f));
+    expected_total_bounds.join(child_path.getBounds());
+    auto mock_layer = std::make_shared<MockLayer>(
+        child_path, SkPaint(), false /* fake_has_platform_view */,
+        false /* fake_needs_system_composite */,
+        i == child_count - 1 /* fake_reads_surface */);
+    mock_layers.push_back(mock_layer);
+    layer->Add(mock_layer);
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  preroll_context()->concurrent_task_runner = task_runner.get();
+  layer->Preroll(preroll_context(), initial_transform);
+  preroll_context()->concurrent_task_runner = nullptr;
+
+  EXPECT_EQ(layer->paint_bounds(), expected_total_bounds);
+  EXPECT_TRUE(layer->needs_painting());
+  EXPECT_FALSE(preroll_context()->has_platform_view);
+  EXPECT_TRUE(preroll_context()->surface_needs_readback);
+  for (auto& mock_layer : mock_layers) {
+    EXPECT_TRUE(mock_layer->needs_painting());
+    EXPECT_EQ(mock_layer->parent_matrix(), initial_transform);
+    EXPECT_EQ(mock_layer->parent_cull_rect(), kGiantRect);
+  }
+}
+
+TEST_F(ContainerLayerTest, ConcurrentPaintFallsBackWithoutGpuSurface) {
+  const size_t child_count = ContainerLayer::kMinChildrenForConcurrentPaint * 2;
+  SkPaint child_paint(SkColors::kGreen);
+
+  auto layer = std::make_shared<ContainerLayer>();
+  std::vector<MockCanvas::DrawCall> expected_draw_calls;
+  for (size_t i = 0; i < child_count; i++) {
+    SkPath child_path;
+    child_path.addRect(SkRect::MakeXYWH(i * 10.0f, 5.0f, 8.0f, 8.0f));
+    layer->Add(std::make_shared<MockLayer>(child_path, child_paint));
+    expected_draw_calls.push_back(MockCanvas::DrawCall{
+        0, MockCanvas::DrawPathData{child_path, child_paint}});
+  }
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  // Raster surfaces can't be recorded for, so the children are painted in
+  // order on this thread.
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(16, 16);
+  ConcurrentPaintRecorder recorder(surface.get(), task_runner.get());
+  paint_context().concurrent_paint_recorder = &recorder;
+  layer->Paint(paint_context());
+  EXPECT_EQ(paint_context().concurrent_paint_recorder, &recorder);
+  paint_context().concurrent_paint_recorder = nullptr;
+
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+TEST_F(ContainerLayerTest, ChildrenBehindOpaqueSiblingsAreNotPainted) {
+  SkPath hidden_path;
+  hidden_path.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+  SkPath visible_path;
+  visible_path.addRect(15.0f, 15.0f, 40.0f, 40.0f);
+  SkPath opaque_path;
+  opaque_path.addRect(0.0f, 0.0f, 30.0f, 30.0f);
+  SkPaint paint(SkColors::kGreen);
+
+  auto hidden_layer = std::make_shared<MockLayer>(hidden_path, paint);
+  auto visible_layer = std::make_shared<MockLayer>(visible_path, paint);
+  auto opaque_layer = std::make_shared<MockLayer>(opaque_path, paint);
+  opaque_layer->set_fake_opaque_bounds(opaque_path.getBounds());
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(hidden_layer);
+  layer->Add(visible_layer);
+  layer->Add(opaque_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_EQ(preroll_context()->subtree_opaque_bounds, opaque_path.getBounds());
+
+  layer->Paint(paint_context());
+  auto visible_draw =
+      MockCanvas::DrawCall{0, MockCanvas::DrawPathData{visible_path, paint}};
+  auto opaque_draw =
+      MockCanvas::DrawCall{0, MockCanvas::DrawPathData{opaque_path, paint}};
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({visible_draw, opaque_draw}));
+}
+
+TEST_F(ContainerLayerTest, ReadbackExposesChildrenBehindOpaqueSiblings) {
+  SkPath hidden_path;
+  hidden_path.addRect(10.0f, 10.0f, 20.0f, 20.0f);
+  SkPath reading_path;
+  reading_path.addRect(15.0f, 15.0f, 40.0f, 40.0f);
+  SkPath opaque_path;
+  opaque_path.addRect(0.0f, 0.0f, 30.0f, 30.0f);
+  SkPaint paint(SkColors::kGreen);
+
+  auto hidden_layer = std::make_shared<MockLayer>(hidden_path, paint);
+  auto reading_layer = std::make_shared<MockLayer>(
+      reading_path, paint, false /* fake_has_platform_view */,
+      false /* fake_needs_system_composite */, true /* fake_reads_surface */);
+  auto opaque_layer = std::make_shared<MockLayer>(opaque_path, paint);
+  opaque_layer->set_fake_opaque_bounds(opaque_path.getBounds());
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(hidden_layer);
+  layer->Add(reading_layer);
+  layer->Add(opaque_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_TRUE(preroll_context()->subtree_opaque_bounds.isEmpty());
+
+  layer->Paint(paint_context());
+  auto hidden_draw =
+      MockCanvas::DrawCall{0, MockCanvas::DrawPathData{hidden_path, paint}};
+  auto reading_draw =
+      MockCanvas::DrawCall{0, MockCanvas::DrawPathData{reading_path, paint}};
+  auto opaque_draw =
+      MockCanvas::DrawCall{0, MockCanvas::DrawPathData{opaque_path, paint}};
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({hidden_draw, reading_draw, opaque_draw}));
+}
+
+TEST_F(ContainerLayerTest, ProfilesTheCostOfEachChild) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  LayerCostProfiler profiler;
+  preroll_context()->layer_cost_profiler = &profiler;
+  paint_context().layer_cost_profiler = &profiler;
+  profiler.BeginFrame();
+  profiler.BeginPreroll(layer.get());
+  layer->Preroll(preroll_context(), SkMatrix());
+  profiler.EndPreroll();
+  profiler.BeginPaint(layer.get(), nullptr);
+  layer->Paint(paint_context());
+  profiler.EndPaint(nullptr);
+  profiler.EndFrame();
+
+  auto costs = profiler.GetLastFrameCosts();
+  ASSERT_EQ(costs.size(), 3u);
+  EXPECT_EQ(costs[0].layer_id, layer->unique_id());
+  EXPECT_STREQ(costs[0].type_name, "ContainerLayer");
+  EXPECT_EQ(costs[0].depth, 0u);
+  EXPECT_EQ(costs[1].layer_id, mock_layer1->unique_id());
+  EXPECT_EQ(costs[1].depth, 1u);
+  EXPECT_EQ(costs[2].layer_id, mock_layer2->unique_id());
+  EXPECT_EQ(costs[2].depth, 1u);
+  for (const auto& cost : costs) {
+    EXPECT_TRUE(cost.painted);
+    EXPECT_LE(cost.self_preroll_time, cost.preroll_time);
+    EXPECT_LE(cost.self_paint_time, cost.paint_time);
+  }
+  EXPECT_GE(costs[0].paint_time,
+            costs[1].paint_time + costs[2].paint_time);
+}
+
 }  // namespace testing
 }  // namespace flutter
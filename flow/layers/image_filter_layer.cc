@@ -13,7 +13,7 @@ ImageFilterLayer::ImageFilterLayer(sk_sp<SkImageFilter> filter)
 
 void ImageFilterLayer::Preroll(PrerollContext* context,
                                const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "ImageFilterLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "ImageFilterLayer::Preroll");
 
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
@@ -62,7 +62,7 @@ void ImageFilterLayer::Preroll(PrerollContext* context,
 }
 
 void ImageFilterLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ImageFilterLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ImageFilterLayer::Paint");
   FML_DCHECK(needs_painting());
 
   if (context.raster_cache) {
@@ -92,4 +92,15 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ImageFilterLayer::Diff(DiffContext* context) const {
+  // Image filters cannot be compared cheaply and may move content arbitrarily.
+  // Treat the layer as changed whenever it is rebuilt.
+  Layer::Diff(context);
+}
+
+std::optional<uint64_t> ImageFilterLayer::ComputeContentHash() const {
+  // Image filters cannot be compared cheaply.
+  return HashChildren(unique_id());
+}
+
 }  // namespace flutter
@@ -19,6 +19,13 @@ class ImageFilterLayer : public MergedContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ImageFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   // The ImageFilterLayer might cache the filtered output of this layer
   // if the layer remains stable (if it is not animating for instance).
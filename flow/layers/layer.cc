@@ -27,6 +27,22 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+void Layer::Diff(DiffContext* context) const {
+  context->AddPaintRegion(paint_bounds(), unique_id());
+}
+
+std::optional<uint64_t> Layer::GetContentHash() const {
+  if (!content_hash_computed_) {
+    content_hash_ = ComputeContentHash();
+    content_hash_computed_ = true;
+  }
+  return content_hash_;
+}
+
+std::optional<uint64_t> Layer::ComputeContentHash() const {
+  return unique_id();
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
@@ -37,6 +53,7 @@ Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
   if (save_layer_is_active_) {
     prev_surface_needs_readback_ = preroll_context_->surface_needs_readback;
     preroll_context_->surface_needs_readback = false;
+    preroll_context_->save_layer_depth++;
   }
 }
 
@@ -52,6 +69,7 @@ Layer::AutoPrerollSaveLayerState::~AutoPrerollSaveLayerState() {
   if (save_layer_is_active_) {
     preroll_context_->surface_needs_readback =
         (prev_surface_needs_readback_ || layer_itself_performs_readback_);
+    preroll_context_->save_layer_depth--;
   }
 }
 
@@ -80,7 +98,7 @@ void Layer::UpdateScene(SceneUpdateContext& context) {
     // frame so we won't call PhysicalShapeLayer::Paint.
     LayerRasterCacheKey key(unique_id(), context.Matrix());
     if (context.HasRetainedNode(key)) {
-      TRACE_EVENT_INSTANT0("flutter", "retained layer cache hit");
+      TRACE_EVENT_INSTANT0("flutter.detail", "retained layer cache hit");
       scenic::EntityNode* retained_node = context.GetRetainedNode(key);
       FML_DCHECK(context.top_entity());
       FML_DCHECK(retained_node->session() == context.session());
@@ -92,7 +110,7 @@ void Layer::UpdateScene(SceneUpdateContext& context) {
       return;
     }
 
-    TRACE_EVENT_INSTANT0("flutter", "cache miss, creating");
+    TRACE_EVENT_INSTANT0("flutter.detail", "cache miss, creating");
     // If we can't find an existing retained surface, create one.
     SceneUpdateContext::Frame frame(
         context, SkRRect::MakeRect(paint_bounds()), SK_ColorTRANSPARENT,
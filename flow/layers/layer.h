@@ -6,14 +6,19 @@
 #define FLUTTER_FLOW_LAYERS_LAYER_H_
 
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "flutter/flow/backdrop_filter_cache.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layer_cost_profiler.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/compiler_specific.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -37,6 +42,8 @@
 
 namespace flutter {
 
+class ConcurrentPaintRecorder;
+
 static constexpr SkRect kGiantRect = SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 
 // This should be an exact copy of the Clip enum in painting.dart.
@@ -66,11 +73,43 @@ struct PrerollContext {
   float total_elevation = 0.0f;
   bool has_platform_view = false;
   bool is_opaque = true;
+
+  // Set by a layer during its Preroll if it can apply an opacity passed down
+  // in PaintContext::inherited_opacity itself, allowing an ancestor
+  // OpacityLayer to skip its saveLayer. Reset to false by the parent before
+  // each child is prerolled.
+  bool subtree_can_inherit_opacity = false;
+
+  // Set by a layer during its Preroll to a rect, in the same coordinates as its
+  // paint bounds, that it is known to cover with fully opaque content. Earlier
+  // siblings hidden behind it are not painted. Reset to empty by the parent
+  // before each child is prerolled.
+  SkRect subtree_opaque_bounds = SkRect::MakeEmpty();
+
+  // The number of ancestors of the layer being prerolled that paint it into a
+  // saveLayer. Maintained by Layer::AutoPrerollSaveLayerState.
+  int save_layer_depth = 0;
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   // True if, during the traversal so far, we have seen a child_scene_layer.
   // Informs whether a layer needs to be system composited.
   bool child_scene_layer_exists_below = false;
 #endif
+
+  // When set, containers with enough children may preroll sibling subtrees
+  // concurrently on this task runner. See ContainerLayer::PrerollChildren.
+  fml::ConcurrentTaskRunner* concurrent_task_runner = nullptr;
+
+  // Set by texture layers during their Preroll. External textures can only be
+  // painted on the raster thread.
+  bool has_texture_layer = false;
+
+  // When set, the preroll time of each layer is measured. Children are then
+  // always prerolled serially.
+  LayerCostProfiler* layer_cost_profiler = nullptr;
+
+  // How performance overlay layers show the statistics of the frames.
+  PerformanceOverlayMode performance_overlay_mode =
+      PerformanceOverlayMode::kGraphs;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -132,6 +171,47 @@ class Layer {
     // These allow us to make use of the scene metrics during Paint.
     float frame_physical_depth;
     float frame_device_pixel_ratio;
+
+    // The opacity that ancestors folded into this subtree instead of painting
+    // it into a saveLayer. Only layers that reported
+    // PrerollContext::subtree_can_inherit_opacity are painted with a value
+    // other than 1.
+    SkScalar inherited_opacity = SK_Scalar1;
+
+    // The GPU frame times, if the surface can measure them.
+    const Stopwatch* gpu_time = nullptr;
+
+    // When set, the paint time of each layer is measured.
+    LayerCostProfiler* layer_cost_profiler = nullptr;
+
+    // The filtered backdrops and backdrop filter options of the frame, if it
+    // is painted by a compositor.
+    BackdropFilterCache* backdrop_filter_cache = nullptr;
+
+    // When set, containers may paint ranges of their children concurrently.
+    // See ContainerLayer::PaintChildren.
+    ConcurrentPaintRecorder* concurrent_paint_recorder = nullptr;
+  };
+
+  // Sets the inherited opacity of the PaintContext for the children painted in
+  // its scope and restores the previous value upon destruction.
+  class AutoInheritedOpacity {
+   public:
+    AutoInheritedOpacity(PaintContext& paint_context, SkScalar opacity)
+        : paint_context_(paint_context),
+          previous_opacity_(paint_context.inherited_opacity) {
+      paint_context_.inherited_opacity = opacity;
+    }
+
+    ~AutoInheritedOpacity() {
+      paint_context_.inherited_opacity = previous_opacity_;
+    }
+
+   private:
+    PaintContext& paint_context_;
+    const SkScalar previous_opacity_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(AutoInheritedOpacity);
   };
 
   // Calls SkCanvas::saveLayer and restores the layer upon destruction. Also
@@ -162,6 +242,22 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Describes what this layer paints to |context| so that the region that
+  // changed since the previous frame can be computed. Called after Preroll.
+  //
+  // The default implementation reports the paint bounds of the layer as
+  // content that only stays the same while the layer itself is retained across
+  // frames. Layers that can describe their content more precisely, or whose
+  // content may change without the layer being rebuilt, override this.
+  virtual void Diff(DiffContext* context) const;
+
+  // A hash of everything that determines what this layer and its children
+  // paint, or std::nullopt if they paint content that can change while the
+  // layers stay the same, like the frames of an external texture. Layers don't
+  // change once they are built, so the hash is computed once and must only be
+  // requested on the UI thread after the layer was fully built.
+  std::optional<uint64_t> GetContentHash() const;
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   // Updates the system composited scene.
   virtual void UpdateScene(SceneUpdateContext& context);
@@ -183,6 +279,9 @@ class Layer {
 
   bool needs_painting() const { return !paint_bounds_.isEmpty(); }
 
+  // The name of the class of the layer, for profiles and dumps.
+  virtual const char* GetTypeName() const { return "Layer"; }
+
   uint64_t unique_id() const { return unique_id_; }
 
  protected:
@@ -190,10 +289,20 @@ class Layer {
   bool child_layer_exists_below_ = false;
 #endif
 
+  // Computes the hash returned by |GetContentHash|.
+  //
+  // The default implementation hashes the unique id of the layer, which only
+  // matches between frames that retain the same layer. Layers that are
+  // commonly rebuilt with the same content every frame hash that content
+  // instead.
+  virtual std::optional<uint64_t> ComputeContentHash() const;
+
  private:
   SkRect paint_bounds_;
   uint64_t unique_id_;
   bool needs_system_composite_;
+  mutable std::optional<uint64_t> content_hash_;
+  mutable bool content_hash_computed_ = false;
 
   static uint64_t NextUniqueID();
 
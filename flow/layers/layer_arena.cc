@@ -0,0 +1,17 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+namespace flutter {
+
+std::shared_ptr<LayerArena> LayerArena::Create(size_t block_size) {
+  return std::shared_ptr<LayerArena>(new LayerArena(block_size));
+}
+
+LayerArena::LayerArena(size_t block_size) : arena_(block_size) {}
+
+LayerArena::~LayerArena() = default;
+
+}  // namespace flutter
@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/arena.h"
+
+namespace flutter {
+
+// A bump allocator for the layers of a single frame, over an |fml::Arena|.
+//
+// Layers made with |Make| are still owned through regular std::shared_ptrs so
+// they can be mixed freely with heap allocated layers in a tree. Their object
+// and control block are carved out of large blocks owned by the arena, and
+// destroying them releases no memory. Every layer made by the arena keeps it
+// alive, so all of its blocks are released in one go once the last of them is
+// destroyed. That is usually when the LayerTree of the frame is destroyed, but
+// a layer that is kept by a retained parent layer keeps the arena of the frame
+// it was built in alive, so retained layers should be allocated on the heap.
+//
+// Allocation is not thread safe. An arena is meant to be filled by the
+// SceneBuilder of a frame on the UI thread and then handed to the rasterizer
+// with its LayerTree.
+class LayerArena : public std::enable_shared_from_this<LayerArena> {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  static std::shared_ptr<LayerArena> Create(
+      size_t block_size = kDefaultBlockSize);
+
+  ~LayerArena();
+
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(std::shared_ptr<LayerArena> arena)
+        : arena_(std::move(arena)) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+      // The memory is released with the arena.
+    }
+
+    const std::shared_ptr<LayerArena>& arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return arena_ != other.arena();
+    }
+
+   private:
+    std::shared_ptr<LayerArena> arena_;
+  };
+
+  // Constructs a T with |args| in the arena.
+  template <typename T, typename... Args>
+  std::shared_ptr<T> Make(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(shared_from_this()),
+                                   std::forward<Args>(args)...);
+  }
+
+  // Returns |size| bytes aligned to |alignment|, which must be a power of
+  // two.
+  void* Allocate(size_t size, size_t alignment) {
+    return arena_.Allocate(size, alignment);
+  }
+
+  // The number of bytes handed out by |Allocate| so far.
+  size_t GetAllocatedBytes() const { return arena_.GetAllocatedBytes(); }
+
+  // The number of bytes reserved from the heap so far.
+  size_t GetReservedBytes() const { return arena_.GetReservedBytes(); }
+
+ private:
+  // Never reset, the memory is released with the last layer.
+  fml::Arena arena_;
+
+  explicit LayerArena(size_t block_size);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
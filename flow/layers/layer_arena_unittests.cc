@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <cstdint>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(LayerArenaTest, AllocationsAreAligned) {
+  auto arena = LayerArena::Create();
+
+  arena->Allocate(1, 1);
+  void* pointer = arena->Allocate(sizeof(double), alignof(double));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignof(double), 0u);
+  arena->Allocate(3, 1);
+  pointer =
+      arena->Allocate(sizeof(std::max_align_t), alignof(std::max_align_t));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignof(std::max_align_t),
+            0u);
+}
+
+TEST(LayerArenaTest, ReservesBlocksLazily) {
+  auto arena = LayerArena::Create(1024);
+  EXPECT_EQ(arena->GetReservedBytes(), 0u);
+
+  arena->Allocate(64, 8);
+  EXPECT_EQ(arena->GetAllocatedBytes(), 64u);
+  EXPECT_EQ(arena->GetReservedBytes(), 1024u);
+
+  // Fits in the current block.
+  arena->Allocate(64, 8);
+  EXPECT_EQ(arena->GetReservedBytes(), 1024u);
+
+  // Too large for a regular block, gets a block of its own.
+  arena->Allocate(2048, 8);
+  EXPECT_EQ(arena->GetAllocatedBytes(), 2176u);
+  EXPECT_GE(arena->GetReservedBytes(), 3072u);
+
+  // The current block is still used after the large allocation.
+  size_t reserved = arena->GetReservedBytes();
+  arena->Allocate(64, 8);
+  EXPECT_EQ(arena->GetReservedBytes(), reserved);
+}
+
+TEST(LayerArenaTest, LayersKeepTheArenaAlive) {
+  auto arena = LayerArena::Create();
+  std::weak_ptr<LayerArena> weak_arena = arena;
+
+  auto root = arena->Make<ContainerLayer>();
+  SkPath path;
+  path.addRect(SkRect::MakeWH(10.0f, 10.0f));
+  std::shared_ptr<Layer> leaf = arena->Make<MockLayer>(path);
+  root->Add(leaf);
+  EXPECT_GT(arena->GetAllocatedBytes(), 0u);
+
+  // A heap allocated layer retaining an arena layer keeps the arena alive after
+  // the tree it was built for is gone.
+  auto retained = std::make_shared<ContainerLayer>();
+  retained->Add(leaf);
+
+  arena.reset();
+  root.reset();
+  leaf.reset();
+  EXPECT_FALSE(weak_arena.expired());
+  EXPECT_EQ(retained->layers().size(), 1u);
+
+  retained.reset();
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+}  // namespace testing
+}  // namespace flutter
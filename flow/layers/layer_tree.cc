@@ -4,7 +4,9 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include "flutter/flow/concurrent_paint_recorder.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/skia/include/utils/SkNWayCanvas.h"
@@ -21,13 +23,30 @@ LayerTree::LayerTree(const SkISize& frame_size,
       checkerboard_raster_cache_images_(false),
       checkerboard_offscreen_layers_(false) {}
 
-void LayerTree::RecordBuildTime(fml::TimePoint build_start,
+void LayerTree::RecordBuildTime(fml::TimePoint vsync_start,
+                                fml::TimePoint build_start,
                                 fml::TimePoint target_time) {
+  vsync_start_ = vsync_start;
   build_start_ = build_start;
   target_time_ = target_time;
   build_finish_ = fml::TimePoint::Now();
 }
 
+std::optional<uint64_t> LayerTree::GetContentHash() const {
+  if (!root_layer_) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> root_hash = root_layer_->GetContentHash();
+  if (!root_hash) {
+    return std::nullopt;
+  }
+  return fml::HashCombine(*root_hash, frame_size_.width(), frame_size_.height(),
+                          frame_physical_depth_, frame_device_pixel_ratio_,
+                          rasterizer_tracing_threshold_,
+                          checkerboard_raster_cache_images_,
+                          checkerboard_offscreen_layers_);
+}
+
 bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
                         bool ignore_raster_cache) {
   TRACE_EVENT0("flutter", "LayerTree::Preroll");
@@ -56,8 +75,27 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       checkerboard_offscreen_layers_,
       frame_physical_depth_,
       frame_device_pixel_ratio_};
+#if !defined(LEGACY_FUCHSIA_EMBEDDER)
+  // The scene update of the legacy Fuchsia embedder depends on the order in
+  // which child scene layers are visited, so it always prerolls serially.
+  context.concurrent_task_runner = frame.context().concurrent_task_runner();
+#endif
+  context.performance_overlay_mode =
+      frame.context().performance_overlay_mode();
+
+  LayerCostProfiler* profiler = frame.context().layer_cost_profiler();
+  if (profiler) {
+    context.layer_cost_profiler = profiler;
+    profiler->BeginFrame();
+    profiler->BeginPreroll(root_layer_.get());
+  }
 
   root_layer_->Preroll(&context, frame.root_surface_transformation());
+
+  if (profiler) {
+    profiler->EndPreroll();
+  }
+  has_texture_layer_ = context.has_texture_layer;
   return context.surface_needs_readback;
 }
 
@@ -127,9 +165,30 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       checkerboard_offscreen_layers_,
       frame_physical_depth_,
       frame_device_pixel_ratio_};
+  context.gpu_time = frame.context().gpu_time();
+  context.backdrop_filter_cache = &frame.context().backdrop_filter_cache();
+
+  std::optional<ConcurrentPaintRecorder> concurrent_paint_recorder;
+  if (frame.paint_concurrently() && !has_texture_layer_) {
+    concurrent_paint_recorder.emplace(
+        frame.canvas()->getSurface(),
+        frame.context().concurrent_paint_task_runner());
+    context.concurrent_paint_recorder = &concurrent_paint_recorder.value();
+  }
+
+  LayerCostProfiler* profiler = frame.context().layer_cost_profiler();
+  if (profiler) {
+    context.layer_cost_profiler = profiler;
+    profiler->BeginPaint(root_layer_.get(), context.raster_cache);
+  }
 
   if (root_layer_->needs_painting())
     root_layer_->Paint(context);
+
+  if (profiler) {
+    profiler->EndPaint(context.raster_cache);
+    profiler->EndFrame();
+  }
 }
 
 sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
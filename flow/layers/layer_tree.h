@@ -8,9 +8,11 @@
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -50,11 +52,31 @@ class LayerTree {
     root_layer_ = std::move(root_layer);
   }
 
+  // The arena the non-retained layers of this tree were allocated from, if
+  // any. It is released once the tree and any layers retained from it are
+  // destroyed.
+  const std::shared_ptr<LayerArena>& arena() const { return arena_; }
+
+  void set_arena(std::shared_ptr<LayerArena> arena) {
+    arena_ = std::move(arena);
+  }
+
+  // A hash of everything that determines the frame painted by this tree, or
+  // std::nullopt if the tree paints content that can change while it stays the
+  // same, see |Layer::GetContentHash|. Trees with equal hashes paint the same
+  // frame. Must only be called on the UI thread, before the tree is handed to
+  // the rasterizer.
+  std::optional<uint64_t> GetContentHash() const;
+
   const SkISize& frame_size() const { return frame_size_; }
+  void set_frame_size(const SkISize& frame_size) { frame_size_ = frame_size; }
   float frame_physical_depth() const { return frame_physical_depth_; }
   float frame_device_pixel_ratio() const { return frame_device_pixel_ratio_; }
 
-  void RecordBuildTime(fml::TimePoint build_start, fml::TimePoint target_time);
+  void RecordBuildTime(fml::TimePoint vsync_start,
+                       fml::TimePoint build_start,
+                       fml::TimePoint target_time);
+  fml::TimePoint vsync_start() const { return vsync_start_; }
   fml::TimePoint build_start() const { return build_start_; }
   fml::TimePoint build_finish() const { return build_finish_; }
   fml::TimeDelta build_time() const { return build_finish_ - build_start_; }
@@ -83,6 +105,8 @@ class LayerTree {
 
  private:
   std::shared_ptr<Layer> root_layer_;
+  std::shared_ptr<LayerArena> arena_;
+  fml::TimePoint vsync_start_;
   fml::TimePoint build_start_;
   fml::TimePoint build_finish_;
   fml::TimePoint target_time_;
@@ -92,6 +116,9 @@ class LayerTree {
   uint32_t rasterizer_tracing_threshold_;
   bool checkerboard_raster_cache_images_;
   bool checkerboard_offscreen_layers_;
+  // Whether the last Preroll found a texture layer, which keeps the tree from
+  // being painted concurrently.
+  bool has_texture_layer_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(LayerTree);
 };
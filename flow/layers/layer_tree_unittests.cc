@@ -6,6 +6,8 @@
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/canvas_test.h"
@@ -203,5 +205,45 @@ TEST_F(LayerTreeTest, NeedsSystemComposite) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST(LayerTreeContentHashTest, RebuiltTreesWithTheSameContentMatch) {
+  auto retained = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeWH(10.0f, 10.0f)));
+  auto build_tree = [&retained](const SkMatrix& transform) {
+    auto tree =
+        std::make_unique<LayerTree>(SkISize::Make(64, 64), 100.0f, 1.0f);
+    auto root = std::make_shared<ContainerLayer>();
+    auto transform_layer = std::make_shared<TransformLayer>(transform);
+    transform_layer->Add(retained);
+    root->Add(transform_layer);
+    tree->set_root_layer(root);
+    return tree;
+  };
+
+  auto tree = build_tree(SkMatrix::Scale(2.0f, 2.0f));
+  auto same_tree = build_tree(SkMatrix::Scale(2.0f, 2.0f));
+  auto moved_tree = build_tree(SkMatrix::Translate(1.0f, 0.0f));
+  ASSERT_TRUE(tree->GetContentHash().has_value());
+  EXPECT_EQ(tree->GetContentHash(), same_tree->GetContentHash());
+  EXPECT_NE(tree->GetContentHash(), moved_tree->GetContentHash());
+
+  // Layers that are not retained are told apart by their unique ids.
+  auto other_tree = build_tree(SkMatrix::Scale(2.0f, 2.0f));
+  retained = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeWH(10.0f, 10.0f)));
+  auto rebuilt_tree = build_tree(SkMatrix::Scale(2.0f, 2.0f));
+  EXPECT_EQ(tree->GetContentHash(), other_tree->GetContentHash());
+  EXPECT_NE(tree->GetContentHash(), rebuilt_tree->GetContentHash());
+}
+
+TEST(LayerTreeContentHashTest, TexturesHaveNoContentHash) {
+  LayerTree tree(SkISize::Make(64, 64), 100.0f, 1.0f);
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(std::make_shared<TextureLayer>(
+      SkPoint::Make(0.0f, 0.0f), SkSize::Make(8.0f, 8.0f), 0, false,
+      kNone_SkFilterQuality));
+  tree.set_root_layer(root);
+  EXPECT_FALSE(tree.GetContentHash().has_value());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPaint.h"
 
@@ -13,7 +14,7 @@ OpacityLayer::OpacityLayer(SkAlpha alpha, const SkPoint& offset)
     : alpha_(alpha), offset_(offset) {}
 
 void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "OpacityLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "OpacityLayer::Preroll");
 
   ContainerLayer* container = GetChildContainer();
   FML_DCHECK(!container->layers().empty());  // OpacityLayer can't be a leaf.
@@ -39,22 +40,39 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   {
     set_paint_bounds(paint_bounds().makeOffset(offset_.fX, offset_.fY));
+    // When the alpha can be folded into the children, there is no offscreen
+    // pass for the raster cache to save.
+    if (!children_can_inherit_opacity()) {
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
-    child_matrix = RasterCache::GetIntegralTransCTM(child_matrix);
+      child_matrix = RasterCache::GetIntegralTransCTM(child_matrix);
 #endif
-    TryToPrepareRasterCache(context, GetCacheableChild(), child_matrix);
+      TryToPrepareRasterCache(context, GetCacheableChild(), child_matrix);
+    }
   }
 
   // Restore cull_rect
   context->cull_rect = context->cull_rect.makeOffset(offset_.fX, offset_.fY);
+
+  // An inherited opacity is either passed on to the children or applied by
+  // the saveLayer together with the alpha of this layer.
+  context->subtree_can_inherit_opacity = true;
+  if (alpha_ == SK_AlphaOPAQUE) {
+    context->subtree_opaque_bounds =
+        children_opaque_bounds().makeOffset(offset_.fX, offset_.fY);
+  }
 }
 
 void OpacityLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "OpacityLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "OpacityLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  const SkScalar opacity = context.inherited_opacity * alpha_ / 255.0f;
   SkPaint paint;
-  paint.setAlpha(alpha_);
+  if (context.inherited_opacity < SK_Scalar1) {
+    paint.setAlphaf(opacity);
+  } else {
+    paint.setAlpha(alpha_);
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->translate(offset_.fX, offset_.fY);
@@ -64,6 +82,12 @@ void OpacityLayer::Paint(PaintContext& context) const {
       context.leaf_nodes_canvas->getTotalMatrix()));
 #endif
 
+  if (children_can_inherit_opacity()) {
+    AutoInheritedOpacity inherited_opacity(context, opacity);
+    PaintChildren(context);
+    return;
+  }
+
   if (context.raster_cache &&
       context.raster_cache->Draw(GetCacheableChild(),
                                  *context.leaf_nodes_canvas, &paint)) {
@@ -85,9 +109,18 @@ void OpacityLayer::Paint(PaintContext& context) const {
 
   Layer::AutoSaveLayer save_layer =
       Layer::AutoSaveLayer::Create(context, saveLayerBounds, &paint);
+  AutoInheritedOpacity inherited_opacity(context, SK_Scalar1);
   PaintChildren(context);
 }
 
+void OpacityLayer::Diff(DiffContext* context) const {
+  DiffChildren(context, SkMatrix::Translate(offset_.fX, offset_.fY), alpha_);
+}
+
+std::optional<uint64_t> OpacityLayer::ComputeContentHash() const {
+  return HashChildren(fml::HashCombine(alpha_, offset_.fX, offset_.fY));
+}
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void OpacityLayer::UpdateScene(SceneUpdateContext& context) {
@@ -31,10 +31,17 @@ class OpacityLayer : public MergedContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "OpacityLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   SkAlpha alpha_;
   SkPoint offset_;
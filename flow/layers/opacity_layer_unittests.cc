@@ -406,5 +406,65 @@ TEST_F(OpacityLayerTest, CullRectIsTransformed) {
   EXPECT_EQ(mockLayer->parent_cull_rect().fTop, -20);
 }
 
+static size_t CountSaveLayers(const MockCanvas& canvas) {
+  size_t count = 0;
+  for (const auto& call : canvas.draw_calls()) {
+    if (std::holds_alternative<MockCanvas::SaveLayerData>(call.data)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+TEST_F(OpacityLayerTest, OpacityIsFoldedIntoNonOverlappingChildren) {
+  const SkPath child_path1 = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPath child_path2 =
+      SkPath().addRect(SkRect::MakeXYWH(10.0f, 0.0f, 5.0f, 5.0f));
+  const SkPaint child_paint = SkPaint(SkColors::kGreen);
+  const SkAlpha alpha_half = 255 / 2;
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1, child_paint);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2, child_paint);
+  mock_layer1->set_fake_can_inherit_opacity(true);
+  mock_layer2->set_fake_can_inherit_opacity(true);
+  auto layer =
+      std::make_shared<OpacityLayer>(alpha_half, SkPoint::Make(0.0f, 0.0f));
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  EXPECT_TRUE(preroll_context()->subtree_can_inherit_opacity);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(CountSaveLayers(mock_canvas()), 0u);
+  SkPaint expected_paint = child_paint;
+  expected_paint.setAlphaf(alpha_half / 255.0f);
+  size_t draws = 0;
+  for (const auto& call : mock_canvas().draw_calls()) {
+    if (auto* draw = std::get_if<MockCanvas::DrawPathData>(&call.data)) {
+      EXPECT_EQ(draw->paint, expected_paint);
+      draws++;
+    }
+  }
+  EXPECT_EQ(draws, 2u);
+}
+
+TEST_F(OpacityLayerTest, OverlappingChildrenUseSaveLayer) {
+  const SkPath child_path1 = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPath child_path2 =
+      SkPath().addRect(SkRect::MakeXYWH(2.0f, 2.0f, 5.0f, 5.0f));
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2);
+  mock_layer1->set_fake_can_inherit_opacity(true);
+  mock_layer2->set_fake_can_inherit_opacity(true);
+  auto layer =
+      std::make_shared<OpacityLayer>(255 / 2, SkPoint::Make(0.0f, 0.0f));
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context(), SkMatrix::I());
+  layer->Paint(paint_context());
+  EXPECT_EQ(CountSaveLayers(mock_canvas()), 1u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -21,6 +21,7 @@ void VisualizeStopWatch(SkCanvas& canvas,
                         SkScalar height,
                         bool show_graph,
                         bool show_labels,
+                        bool lightweight,
                         const std::string& label_prefix,
                         const std::string& font_path) {
   const int label_x = 8;    // distance from x
@@ -28,7 +29,11 @@ void VisualizeStopWatch(SkCanvas& canvas,
 
   if (show_graph) {
     SkRect visualization_rect = SkRect::MakeXYWH(x, y, width, height);
-    stopwatch.Visualize(canvas, visualization_rect);
+    if (lightweight) {
+      stopwatch.VisualizeSamples(canvas, visualization_rect);
+    } else {
+      stopwatch.Visualize(canvas, visualization_rect);
+    }
   }
 
   if (show_labels) {
@@ -73,28 +78,74 @@ PerformanceOverlayLayer::PerformanceOverlayLayer(uint64_t options,
   }
 }
 
+void PerformanceOverlayLayer::Preroll(PrerollContext* context,
+                                      const SkMatrix& matrix) {
+  mode_ = context->performance_overlay_mode;
+  if (!options_ || mode_ != PerformanceOverlayMode::kExportOnly)
+    return;
+
+  // Nothing is painted, so the layer neither adds to the bounds of its
+  // ancestors nor damages the frame.
+  set_paint_bounds(SkRect::MakeEmpty());
+  const double raster_ms = context->raster_time.LastLap().ToMillisecondsF();
+  const double ui_ms = context->ui_time.LastLap().ToMillisecondsF();
+  FML_TRACE_COUNTER("flutter", "PerformanceOverlay", 0,  //
+                    "RasterMilliseconds", raster_ms,     //
+                    "UIMilliseconds", ui_ms              //
+  );
+}
+
 void PerformanceOverlayLayer::Paint(PaintContext& context) const {
   const int padding = 8;
 
-  if (!options_)
+  if (!options_ || mode_ == PerformanceOverlayMode::kExportOnly)
     return;
 
-  TRACE_EVENT0("flutter", "PerformanceOverlayLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "PerformanceOverlayLayer::Paint");
   SkScalar x = paint_bounds().x() + padding;
   SkScalar y = paint_bounds().y() + padding;
   SkScalar width = paint_bounds().width() - (padding * 2);
   SkScalar height = paint_bounds().height() / 2;
+  const bool lightweight = mode_ == PerformanceOverlayMode::kLightweight;
   SkAutoCanvasRestore save(context.leaf_nodes_canvas, true);
 
-  VisualizeStopWatch(
-      *context.leaf_nodes_canvas, context.raster_time, x, y, width,
-      height - padding, options_ & kVisualizeRasterizerStatistics,
-      options_ & kDisplayRasterizerStatistics, "Raster", font_path_);
+  VisualizeStopWatch(*context.leaf_nodes_canvas, context.raster_time, x, y,
+                     width, height - padding,
+                     options_ & kVisualizeRasterizerStatistics,
+                     options_ & kDisplayRasterizerStatistics, lightweight,
+                     "Raster", font_path_);
+
+  // The GPU time is listed above the raster time when the surface measures it,
+  // to tell frames bound by the GPU apart from frames bound by the raster
+  // thread.
+  if (context.gpu_time && (options_ & kDisplayRasterizerStatistics)) {
+    const int label_x = 8;
+    const int label_y = -28;
+    auto text = MakeStatisticsText(*context.gpu_time, "GPU", font_path_);
+    SkPaint paint;
+    paint.setColor(SK_ColorGRAY);
+    context.leaf_nodes_canvas->drawTextBlob(
+        text, x + label_x, y + height - padding + label_y, paint);
+  }
 
   VisualizeStopWatch(*context.leaf_nodes_canvas, context.ui_time, x, y + height,
                      width, height - padding,
                      options_ & kVisualizeEngineStatistics,
-                     options_ & kDisplayEngineStatistics, "UI", font_path_);
+                     options_ & kDisplayEngineStatistics, lightweight, "UI",
+                     font_path_);
+}
+
+void PerformanceOverlayLayer::Diff(DiffContext* context) const {
+  if (paint_bounds().isEmpty()) {
+    return;
+  }
+  // The statistics change in every frame.
+  context->AddVolatilePaintRegion(paint_bounds());
+}
+
+std::optional<uint64_t> PerformanceOverlayLayer::ComputeContentHash() const {
+  // The statistics change in every frame.
+  return std::nullopt;
 }
 
 }  // namespace flutter
@@ -29,11 +29,21 @@ class PerformanceOverlayLayer : public Layer {
   explicit PerformanceOverlayLayer(uint64_t options,
                                    const char* font_path = nullptr);
 
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "PerformanceOverlayLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   int options_;
   std::string font_path_;
+  PerformanceOverlayMode mode_ = PerformanceOverlayMode::kGraphs;
 
   FML_DISALLOW_COPY_AND_ASSIGN(PerformanceOverlayLayer);
 };
@@ -12,6 +12,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkSerialProcs.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -176,6 +177,62 @@ TEST_F(PerformanceOverlayLayerTest, SimpleRasterizerStatistics) {
                                             text_position}}}));
 }
 
+TEST_F(PerformanceOverlayLayerTest, ExportOnlyModePaintsNothing) {
+  const SkRect layer_bounds = SkRect::MakeLTRB(0.0f, 0.0f, 64.0f, 64.0f);
+  const uint64_t overlay_opts =
+      kDisplayRasterizerStatistics | kVisualizeRasterizerStatistics;
+  auto layer = std::make_shared<PerformanceOverlayLayer>(overlay_opts);
+  layer->set_paint_bounds(layer_bounds);
+
+  preroll_context()->performance_overlay_mode =
+      PerformanceOverlayMode::kExportOnly;
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(), SkRect::MakeEmpty());
+  EXPECT_FALSE(layer->needs_painting());
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(), std::vector<MockCanvas::DrawCall>());
+}
+
+TEST_F(PerformanceOverlayLayerTest, LightweightModeDrawsSamples) {
+  const SkRect layer_bounds = SkRect::MakeLTRB(0.0f, 0.0f, 256.0f, 256.0f);
+  const uint64_t overlay_opts = kVisualizeRasterizerStatistics;
+  auto layer = std::make_shared<PerformanceOverlayLayer>(overlay_opts);
+  layer->set_paint_bounds(layer_bounds);
+
+  preroll_context()->performance_overlay_mode =
+      PerformanceOverlayMode::kLightweight;
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(), layer_bounds);
+
+  // Three frame budgets fill the graph. The marker of the current sample is
+  // red as the last frame was over budget.
+  Stopwatch stopwatch(fml::Milliseconds(16));
+  stopwatch.SetLapTime(fml::TimeDelta::FromMilliseconds(48));
+  stopwatch.SetLapTime(fml::TimeDelta::FromMilliseconds(0));
+
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(256, 256);
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  TextureRegistry unused_texture_registry;
+  Layer::PaintContext context = {
+      nullptr,   surface->getCanvas(),    nullptr, nullptr, stopwatch,
+      stopwatch, unused_texture_registry, nullptr, false};
+  layer->Paint(context);
+
+  // The graph spans from 8 to 248 horizontally, two pixels per sample, and
+  // from 8 to 120 vertically.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(256, 256);
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(SkColorGetA(bitmap.getColor(11, 20)), 0xDDu);
+  EXPECT_EQ(SkColorGetB(bitmap.getColor(11, 20)), 0xFFu);
+  EXPECT_EQ(bitmap.getColor(13, 20), SK_ColorRED);
+  EXPECT_EQ(SkColorGetA(bitmap.getColor(15, 20)), 0x99u);
+  // Nothing is drawn outside of the graph.
+  EXPECT_EQ(bitmap.getColor(4, 20), SK_ColorTRANSPARENT);
+  EXPECT_EQ(bitmap.getColor(11, 200), SK_ColorTRANSPARENT);
+}
+
 TEST(PerformanceOverlayLayerDefault, Gold) {
   TestPerformanceOverlayLayerGold(60);
 }
@@ -4,7 +4,10 @@
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 
+#include <cmath>
+
 #include "flutter/flow/paint_utils.h"
+#include "flutter/fml/hash_combine.h"
 #include "third_party/skia/include/utils/SkShadowUtils.h"
 
 namespace flutter {
@@ -24,6 +27,7 @@ PhysicalShapeLayer::PhysicalShapeLayer(SkColor color,
       isRect_(false),
       clip_behavior_(clip_behavior) {
   SkRect rect;
+  bool is_rrect = true;
   if (path.isRect(&rect)) {
     isRect_ = true;
     frameRRect_ = SkRRect::MakeRect(rect);
@@ -34,6 +38,7 @@ PhysicalShapeLayer::PhysicalShapeLayer(SkColor color,
     // as well.
     frameRRect_ = SkRRect::MakeOval(rect);
   } else {
+    is_rrect = false;
     // Scenic currently doesn't provide an easy way to create shapes from
     // arbitrary paths.
     // For shapes that cannot be represented as a rounded rectangle we
@@ -42,11 +47,17 @@ PhysicalShapeLayer::PhysicalShapeLayer(SkColor color,
     // an SkPath.
     frameRRect_ = SkRRect::MakeRect(path.getBounds());
   }
+
+  // The shape is filled with |color_| before the children are painted.
+  if (is_rrect && !path.isInverseFillType() &&
+      SkColorGetA(color_) == SK_AlphaOPAQUE) {
+    opaque_bounds_ = GetInnerRect(frameRRect_);
+  }
 }
 
 void PhysicalShapeLayer::Preroll(PrerollContext* context,
                                  const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "PhysicalShapeLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "PhysicalShapeLayer::Preroll");
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context, UsesSaveLayer());
 
@@ -66,16 +77,41 @@ void PhysicalShapeLayer::Preroll(PrerollContext* context,
     // children to it so we don't need to join the child paint bounds.
     set_paint_bounds(ComputeShadowBounds(path_.getBounds(), elevation_,
                                          context->frame_device_pixel_ratio));
+
+    const float dpr = context->frame_device_pixel_ratio;
+    if (auto shadow_id =
+            GetShadowCacheId(context->raster_cache, matrix, dpr)) {
+      context->raster_cache->PrepareShadow(
+          context->gr_context, *shadow_id, paint_bounds(), matrix,
+          context->dst_color_space, [this, matrix, dpr](SkCanvas* canvas) {
+            // The cache draws into an image whose device origin is offset
+            // from that of the screen.
+            const SkVector light_offset =
+                canvas->getTotalMatrix().mapXY(0, 0) - matrix.mapXY(0, 0);
+            DrawShadow(canvas, path_, shadow_color_, elevation_,
+                       SkColorGetA(color_) != 0xff, dpr, light_offset);
+          });
+    }
   }
+
+  context->subtree_opaque_bounds = opaque_bounds_;
 }
 
 void PhysicalShapeLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "PhysicalShapeLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "PhysicalShapeLayer::Paint");
   FML_DCHECK(needs_painting());
 
   if (elevation_ != 0) {
-    DrawShadow(context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
-               SkColorGetA(color_) != 0xff, context.frame_device_pixel_ratio);
+    auto shadow_id =
+        GetShadowCacheId(context.raster_cache,
+                         context.leaf_nodes_canvas->getTotalMatrix(),
+                         context.frame_device_pixel_ratio);
+    if (!shadow_id || !context.raster_cache->DrawShadow(
+                          *shadow_id, *context.leaf_nodes_canvas)) {
+      DrawShadow(context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
+                 SkColorGetA(color_) != 0xff,
+                 context.frame_device_pixel_ratio);
+    }
   }
 
   // Call drawPath without clip if possible for better performance.
@@ -115,6 +151,41 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   context.internal_nodes_canvas->restoreToCount(saveCount);
 }
 
+void PhysicalShapeLayer::Diff(DiffContext* context) const {
+  // The shadow extends beyond the children and depends on the elevation. Treat
+  // the layer as changed whenever it is rebuilt.
+  Layer::Diff(context);
+}
+
+std::optional<uint64_t> PhysicalShapeLayer::ComputeContentHash() const {
+  return HashChildren(unique_id());
+}
+
+std::optional<uint64_t> PhysicalShapeLayer::GetShadowCacheId(
+    const RasterCache* raster_cache,
+    const SkMatrix& ctm,
+    float dpr) const {
+  if (!raster_cache || !raster_cache->GetCacheShadows() ||
+      ctm.hasPerspective() || elevation_ >= kLightHeight) {
+    return std::nullopt;
+  }
+  // SkShadowUtils takes the light position in device coordinates, so the spot
+  // shadow moves away from the shape by the offset of the shape from the
+  // light, scaled by elevation / (light height - elevation). The offset only
+  // depends on the translation of |ctm|, which cache keys ignore, so the ID
+  // includes the resulting shift of the shadow in half pixels: a cached
+  // shadow is reused while it is off by at most a quarter of a pixel.
+  const SkRect& bounds = path_.getBounds();
+  const SkPoint light =
+      SkPoint::Make((bounds.left() + bounds.right()) / 2, bounds.top() - 600);
+  const SkVector offset = ctm.mapXY(light.x(), light.y()) - light;
+  const SkScalar shift_scale = 2 * elevation_ / (kLightHeight - elevation_);
+  return fml::HashCombine(path_.getGenerationID(), elevation_, dpr,
+                          shadow_color_, SkColorGetA(color_) != 0xff,
+                          std::lround(offset.x() * shift_scale),
+                          std::lround(offset.y() * shift_scale));
+}
+
 SkRect PhysicalShapeLayer::ComputeShadowBounds(const SkRect& bounds,
                                                float elevation,
                                                float pixel_ratio) {
@@ -164,7 +235,8 @@ void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
                                     SkColor color,
                                     float elevation,
                                     bool transparentOccluder,
-                                    SkScalar dpr) {
+                                    SkScalar dpr,
+                                    const SkVector& light_offset) {
   const SkScalar kAmbientAlpha = 0.039f;
   const SkScalar kSpotAlpha = 0.25f;
 
@@ -172,8 +244,8 @@ void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
                             ? SkShadowFlags::kTransparentOccluder_ShadowFlag
                             : SkShadowFlags::kNone_ShadowFlag;
   const SkRect& bounds = path.getBounds();
-  SkScalar shadow_x = (bounds.left() + bounds.right()) / 2;
-  SkScalar shadow_y = bounds.top() - 600.0f;
+  SkScalar shadow_x = (bounds.left() + bounds.right()) / 2 + light_offset.x();
+  SkScalar shadow_y = bounds.top() - 600.0f + light_offset.y();
   SkColor inAmbient = SkColorSetA(color, kAmbientAlpha * SkColorGetA(color));
   SkColor inSpot = SkColorSetA(color, kSpotAlpha * SkColorGetA(color));
   SkColor ambientColor, spotColor;
@@ -20,24 +20,41 @@ class PhysicalShapeLayer : public ContainerLayer {
   static SkRect ComputeShadowBounds(const SkRect& bounds,
                                     float elevation,
                                     float pixel_ratio);
+  // Draws the shadow of |path|. The light is placed above |path| in device
+  // coordinates, moved by |light_offset| to draw the shadow into an offscreen
+  // canvas whose device origin differs from that of the screen.
   static void DrawShadow(SkCanvas* canvas,
                          const SkPath& path,
                          SkColor color,
                          float elevation,
                          bool transparentOccluder,
-                         SkScalar dpr);
+                         SkScalar dpr,
+                         const SkVector& light_offset = SkVector::Make(0, 0));
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "PhysicalShapeLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
 
   float total_elevation() const { return total_elevation_; }
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
+  // Returns the ID of the shadow of this layer drawn with |ctm| in the shadow
+  // cache of |raster_cache|, or nullopt if the shadow is not to be cached.
+  std::optional<uint64_t> GetShadowCacheId(const RasterCache* raster_cache,
+                                           const SkMatrix& ctm,
+                                           float dpr) const;
+
   SkColor color_;
   SkColor shadow_color_;
   float elevation_ = 0.0f;
@@ -45,6 +62,7 @@ class PhysicalShapeLayer : public ContainerLayer {
   SkPath path_;
   bool isRect_;
   SkRRect frameRRect_;
+  SkRect opaque_bounds_ = SkRect::MakeEmpty();
   Clip clip_behavior_;
 };
 
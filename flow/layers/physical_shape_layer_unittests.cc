@@ -4,6 +4,9 @@
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 
+#include <algorithm>
+#include <variant>
+
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
@@ -149,6 +152,46 @@ TEST_F(PhysicalShapeLayerTest, ElevationSimple) {
 #endif
 }
 
+#if !defined(LEGACY_FUCHSIA_EMBEDDER)
+TEST_F(PhysicalShapeLayerTest, ShadowIsRasterCachedWhenEnabled) {
+  constexpr float initial_elevation = 20.0f;
+  SkPath layer_path;
+  layer_path.addRect(0, 0, 8, 8).close();
+  auto layer = std::make_shared<PhysicalShapeLayer>(
+      SK_ColorGREEN, SK_ColorBLACK, initial_elevation, layer_path, Clip::none);
+
+  use_mock_raster_cache();
+  raster_cache()->SetCacheShadows(true);
+  auto count_shadows = [this]() {
+    return std::count_if(mock_canvas().draw_calls().begin(),
+                         mock_canvas().draw_calls().end(),
+                         [](const MockCanvas::DrawCall& call) {
+                           return std::holds_alternative<
+                               MockCanvas::DrawShadowData>(call.data);
+                         });
+  };
+
+  // The shadow is drawn directly until it reaches the access threshold.
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix());
+    layer->Paint(paint_context());
+    raster_cache()->SweepAfterFrame();
+  }
+  EXPECT_EQ(count_shadows(), 3);
+  EXPECT_EQ(raster_cache()->GetShadowCachedEntriesCount(), (size_t)1);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+  EXPECT_EQ(count_shadows(), 3);
+
+  // Moving the layer far enough to move the shadow relative to it needs
+  // another entry.
+  layer->Preroll(preroll_context(), SkMatrix::Translate(0, 200));
+  layer->Paint(paint_context());
+  EXPECT_EQ(raster_cache()->GetShadowCachedEntriesCount(), (size_t)2);
+}
+#endif
+
 TEST_F(PhysicalShapeLayerTest, ElevationComplex) {
   // The layer tree should look like this:
   // layers[0] +1.0f = 1.0f
@@ -4,10 +4,34 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
+#include "third_party/skia/include/utils/SkPaintFilterCanvas.h"
 
 namespace flutter {
 
+namespace {
+
+// Modulates the alpha of every paint drawn through it by a fixed opacity.
+// This is only equivalent to drawing into a translucent layer when the draws
+// don't overlap, which is trivially true for a single one.
+class OpacityFilterCanvas : public SkPaintFilterCanvas {
+ public:
+  OpacityFilterCanvas(SkCanvas* canvas, SkScalar opacity)
+      : SkPaintFilterCanvas(canvas), opacity_(opacity) {}
+
+ protected:
+  bool onFilter(SkPaint& paint) const override {
+    paint.setAlphaf(paint.getAlphaf() * opacity_);
+    return true;
+  }
+
+ private:
+  const SkScalar opacity_;
+};
+
+}  // namespace
+
 PictureLayer::PictureLayer(const SkPoint& offset,
                            SkiaGPUObject<SkPicture> picture,
                            bool is_complex,
@@ -17,34 +41,72 @@ PictureLayer::PictureLayer(const SkPoint& offset,
       is_complex_(is_complex),
       will_change_(will_change) {}
 
+PictureLayer::PictureLayer(const SkPoint& offset,
+                           SkiaGPUObject<DisplayList> display_list,
+                           bool is_complex,
+                           bool will_change)
+    : offset_(offset),
+      display_list_(std::move(display_list)),
+      is_complex_(is_complex),
+      will_change_(will_change) {}
+
+SkRect PictureLayer::GetCullRect() const {
+  return display_list() ? display_list()->cull_rect() : picture()->cullRect();
+}
+
+uint64_t PictureLayer::GetContentID() const {
+  if (auto* display_list = this->display_list()) {
+    // Display lists that draw the same have the same content hash, which lets
+    // the diff skip a picture that the framework recorded again.
+    return display_list->content_hash().value_or(display_list->unique_id());
+  }
+  return picture()->uniqueID();
+}
+
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "PictureLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "PictureLayer::Preroll");
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   CheckForChildLayerBelow(context);
 #endif
 
   SkPicture* sk_picture = picture();
+  DisplayList* display_list = this->display_list();
 
+  bool will_be_cached = false;
   if (auto* cache = context->raster_cache) {
-    TRACE_EVENT0("flutter", "PictureLayer::RasterCache (Preroll)");
+    TRACE_EVENT0("flutter.detail", "PictureLayer::RasterCache (Preroll)");
 
     SkMatrix ctm = matrix;
     ctm.postTranslate(offset_.x(), offset_.y());
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     ctm = RasterCache::GetIntegralTransCTM(ctm);
 #endif
-    cache->Prepare(context->gr_context, sk_picture, ctm,
-                   context->dst_color_space, is_complex_, will_change_);
+    if (display_list) {
+      will_be_cached =
+          cache->Prepare(context->gr_context, display_list, ctm,
+                         context->dst_color_space, is_complex_, will_change_);
+    } else {
+      will_be_cached =
+          cache->Prepare(context->gr_context, sk_picture, ctm,
+                         context->dst_color_space, is_complex_, will_change_);
+    }
   }
 
-  SkRect bounds = sk_picture->cullRect().makeOffset(offset_.x(), offset_.y());
+  SkRect bounds = GetCullRect().makeOffset(offset_.x(), offset_.y());
   set_paint_bounds(bounds);
+
+  // An inherited opacity can be applied when blitting the cached image, or to
+  // the paints of a picture that consists of a single draw or of a display
+  // list whose draws do not overlap.
+  context->subtree_can_inherit_opacity =
+      will_be_cached || (display_list ? display_list->can_apply_opacity()
+                                      : sk_picture->approximateOpCount() == 1);
 }
 
 void PictureLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "PictureLayer::Paint");
-  FML_DCHECK(picture_.get());
+  TRACE_EVENT0("flutter.detail", "PictureLayer::Paint");
+  FML_DCHECK(picture_.get() || display_list_.get());
   FML_DCHECK(needs_painting());
 
   SkAutoCanvasRestore save(context.leaf_nodes_canvas, true);
@@ -54,12 +116,61 @@ void PictureLayer::Paint(PaintContext& context) const {
       context.leaf_nodes_canvas->getTotalMatrix()));
 #endif
 
+  if (auto* display_list = this->display_list()) {
+    SkPaint paint;
+    paint.setAlphaf(context.inherited_opacity);
+    if (context.raster_cache &&
+        context.raster_cache->Draw(
+            *display_list, *context.leaf_nodes_canvas,
+            context.inherited_opacity < SK_Scalar1 ? &paint : nullptr)) {
+      TRACE_EVENT_INSTANT0("flutter.detail", "raster cache hit");
+      return;
+    }
+    // The display list applies the opacity to its paints when it can, and
+    // draws into a layer otherwise.
+    display_list->RenderTo(context.leaf_nodes_canvas,
+                           context.inherited_opacity);
+    return;
+  }
+
+  if (context.inherited_opacity < SK_Scalar1) {
+    SkPaint paint;
+    paint.setAlphaf(context.inherited_opacity);
+    if (context.raster_cache &&
+        context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas,
+                                   &paint)) {
+      TRACE_EVENT_INSTANT0("flutter.detail", "raster cache hit");
+      return;
+    }
+    if (picture()->approximateOpCount() == 1) {
+      OpacityFilterCanvas opacity_canvas(context.leaf_nodes_canvas,
+                                         context.inherited_opacity);
+      picture()->playback(&opacity_canvas);
+      return;
+    }
+    // The cache entry promised during Preroll could not be created.
+    context.leaf_nodes_canvas->saveLayer(&picture()->cullRect(), &paint);
+    picture()->playback(context.leaf_nodes_canvas);
+    context.leaf_nodes_canvas->restore();
+    return;
+  }
+
   if (context.raster_cache &&
       context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas)) {
-    TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
+    TRACE_EVENT_INSTANT0("flutter.detail", "raster cache hit");
     return;
   }
   picture()->playback(context.leaf_nodes_canvas);
 }
 
+void PictureLayer::Diff(DiffContext* context) const {
+  context->AddPaintRegion(
+      paint_bounds(), fml::HashCombine(GetContentID(), offset_.fX, offset_.fY));
+}
+
+std::optional<uint64_t> PictureLayer::ComputeContentHash() const {
+  return fml::HashCombine(GetContentID(), offset_.fX, offset_.fY, is_complex_,
+                          will_change_);
+}
+
 }  // namespace flutter
@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "flutter/flow/display_list.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/skia_gpu_object.h"
@@ -20,17 +21,35 @@ class PictureLayer : public Layer {
                bool is_complex,
                bool will_change);
 
+  PictureLayer(const SkPoint& offset,
+               SkiaGPUObject<DisplayList> display_list,
+               bool is_complex,
+               bool will_change);
+
+  // Only one of the picture and the display list is set.
   SkPicture* picture() const { return picture_.get().get(); }
+  DisplayList* display_list() const { return display_list_.get().get(); }
 
   void Preroll(PrerollContext* frame, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "PictureLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
+  SkRect GetCullRect() const;
+  uint64_t GetContentID() const;
+
   SkPoint offset_;
   // Even though pictures themselves are not GPU resources, they may reference
   // images that have a reference to a GPU resource.
   SkiaGPUObject<SkPicture> picture_;
+  SkiaGPUObject<DisplayList> display_list_;
   bool is_complex_ = false;
   bool will_change_ = false;
 
@@ -98,5 +98,34 @@ TEST_F(PictureLayerTest, SimplePicture) {
   EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
 }
 
+TEST_F(PictureLayerTest, SimpleDisplayList) {
+  const SkPoint layer_offset = SkPoint::Make(1.5f, -0.5f);
+  const SkRect display_list_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  DisplayListRecorder recorder(display_list_bounds);
+  recorder.drawRect(display_list_bounds, SkPaint());
+  auto display_list = recorder.Finish();
+  auto layer = std::make_shared<PictureLayer>(
+      layer_offset, SkiaGPUObject(display_list, unref_queue()), false, false);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(),
+            display_list_bounds.makeOffset(layer_offset.fX, layer_offset.fY));
+  EXPECT_EQ(layer->display_list(), display_list.get());
+  EXPECT_EQ(layer->picture(), nullptr);
+  EXPECT_TRUE(layer->needs_painting());
+  // A single draw can take an inherited opacity.
+  EXPECT_TRUE(preroll_context()->subtree_can_inherit_opacity);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls().back(),
+            (MockCanvas::DrawCall{0, MockCanvas::RestoreData{0}}));
+  bool drew_rect = false;
+  for (const auto& call : mock_canvas().draw_calls()) {
+    drew_rect = drew_rect ||
+                std::holds_alternative<MockCanvas::DrawRectData>(call.data);
+  }
+  EXPECT_TRUE(drew_rect);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -46,6 +46,17 @@ void PlatformViewLayer::Paint(PaintContext& context) const {
   context.leaf_nodes_canvas = canvas;
 }
 
+void PlatformViewLayer::Diff(DiffContext* context) const {
+  // Platform views are composited by the embedder, which needs the whole
+  // frame.
+  context->MarkFullDamage();
+}
+
+std::optional<uint64_t> PlatformViewLayer::ComputeContentHash() const {
+  // Platform views are composited by the embedder and may change at any time.
+  return std::nullopt;
+}
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 void PlatformViewLayer::UpdateScene(SceneUpdateContext& context) {
   context.UpdateScene(view_id_, offset_, size_);
@@ -17,11 +17,18 @@ class PlatformViewLayer : public Layer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
+
+  const char* GetTypeName() const override { return "PlatformViewLayer"; }
+
+  void Diff(DiffContext* context) const override;
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   // Updates the system composited scene.
   void UpdateScene(SceneUpdateContext& context) override;
 #endif
 
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
   SkPoint offset_;
   SkSize size_;
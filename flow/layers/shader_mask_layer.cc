@@ -9,9 +9,14 @@ namespace flutter {
 ShaderMaskLayer::ShaderMaskLayer(sk_sp<SkShader> shader,
                                  const SkRect& mask_rect,
                                  SkBlendMode blend_mode)
-    : shader_(shader), mask_rect_(mask_rect), blend_mode_(blend_mode) {}
+    : shader_(shader),
+      mask_rect_(mask_rect),
+      blend_mode_(blend_mode),
+      render_count_(1) {}
 
 void ShaderMaskLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  TRACE_EVENT0("flutter.detail", "ShaderMaskLayer::Preroll");
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   CheckForChildLayerBelow(context);
 #endif
@@ -19,15 +24,33 @@ void ShaderMaskLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
   ContainerLayer::Preroll(context, matrix);
+
+  if (render_count_ >= kMinimumRendersBeforeCachingFilterLayer) {
+    TryToPrepareRasterCache(context, this, matrix);
+  } else {
+    render_count_++;
+    TryToPrepareRasterCache(context, GetCacheableChild(), matrix);
+  }
 }
 
 void ShaderMaskLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "ShaderMaskLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "ShaderMaskLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (context.raster_cache &&
+      context.raster_cache->Draw(this, *context.leaf_nodes_canvas)) {
+    return;
+  }
+
   Layer::AutoSaveLayer save =
       Layer::AutoSaveLayer::Create(context, paint_bounds(), nullptr);
-  PaintChildren(context);
+  // The mask still needs a layer, but the children may be drawn from the
+  // cache.
+  if (!context.raster_cache ||
+      !context.raster_cache->Draw(GetCacheableChild(),
+                                  *context.leaf_nodes_canvas)) {
+    PaintChildren(context);
+  }
 
   SkPaint paint;
   paint.setBlendMode(blend_mode_);
@@ -37,4 +60,15 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::Diff(DiffContext* context) const {
+  // Shaders cannot be compared cheaply. Treat the layer as changed whenever it
+  // is rebuilt.
+  Layer::Diff(context);
+}
+
+std::optional<uint64_t> ShaderMaskLayer::ComputeContentHash() const {
+  // Shaders cannot be compared cheaply.
+  return HashChildren(unique_id());
+}
+
 }  // namespace flutter
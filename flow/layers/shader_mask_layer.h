@@ -11,7 +11,7 @@
 
 namespace flutter {
 
-class ShaderMaskLayer : public ContainerLayer {
+class ShaderMaskLayer : public MergedContainerLayer {
  public:
   ShaderMaskLayer(sk_sp<SkShader> shader,
                   const SkRect& mask_rect,
@@ -21,10 +21,24 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ShaderMaskLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
+ protected:
+  std::optional<uint64_t> ComputeContentHash() const override;
+
  private:
+  // Like the ImageFilterLayer, the ShaderMaskLayer caches its children while
+  // it is new, such as while its shader animates, and masks them as they are
+  // drawn from the cache. Once the same layer has been rendered this many
+  // times, it caches its masked output instead.
+  static constexpr int kMinimumRendersBeforeCachingFilterLayer = 3;
+
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
   SkBlendMode blend_mode_;
+  int render_count_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ShaderMaskLayer);
 };
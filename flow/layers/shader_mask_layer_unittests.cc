@@ -275,5 +275,54 @@ TEST_F(ShaderMaskLayerTest, Readback) {
   EXPECT_FALSE(preroll_context()->surface_needs_readback);
 }
 
+TEST_F(ShaderMaskLayerTest, ChildIsCached) {
+  auto layer_filter =
+      SkPerlinNoiseShader::MakeImprovedNoise(1.0f, 1.0f, 1, 1.0f);
+  auto layer = std::make_shared<ShaderMaskLayer>(
+      layer_filter, SkRect::MakeWH(5.0f, 5.0f), SkBlendMode::kSrc);
+  const SkMatrix initial_transform = SkMatrix::Translate(50.0, 25.5);
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  layer->Add(mock_layer);
+
+  SkCanvas cache_canvas;
+  cache_canvas.setMatrix(initial_transform);
+
+  use_mock_raster_cache();
+
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)0);
+  EXPECT_FALSE(raster_cache()->Draw(mock_layer.get(), cache_canvas));
+
+  layer->Preroll(preroll_context(), initial_transform);
+
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)1);
+  EXPECT_TRUE(raster_cache()->Draw(mock_layer.get(), cache_canvas));
+  EXPECT_FALSE(raster_cache()->Draw(layer.get(), cache_canvas));
+}
+
+TEST_F(ShaderMaskLayerTest, LayerIsCachedOnceStable) {
+  auto layer_filter =
+      SkPerlinNoiseShader::MakeImprovedNoise(1.0f, 1.0f, 1, 1.0f);
+  auto layer = std::make_shared<ShaderMaskLayer>(
+      layer_filter, SkRect::MakeWH(5.0f, 5.0f), SkBlendMode::kSrc);
+  const SkMatrix initial_transform = SkMatrix::Translate(50.0, 25.5);
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  layer->Add(mock_layer);
+
+  SkCanvas cache_canvas;
+  cache_canvas.setMatrix(initial_transform);
+
+  use_mock_raster_cache();
+
+  layer->Preroll(preroll_context(), initial_transform);
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_FALSE(raster_cache()->Draw(layer.get(), cache_canvas));
+
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_EQ(raster_cache()->GetLayerCachedEntriesCount(), (size_t)2);
+  EXPECT_TRUE(raster_cache()->Draw(layer.get(), cache_canvas));
+}
+
 }  // namespace testing
 }  // namespace flutter
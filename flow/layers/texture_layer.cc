@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/texture_layer.h"
 
 #include "flutter/flow/texture.h"
+#include "flutter/fml/hash_combine.h"
 
 namespace flutter {
 
@@ -20,7 +21,7 @@ TextureLayer::TextureLayer(const SkPoint& offset,
       filter_quality_(filter_quality) {}
 
 void TextureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "TextureLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "TextureLayer::Preroll");
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   CheckForChildLayerBelow(context);
@@ -28,19 +29,43 @@ void TextureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
                                     size_.height()));
+  context->has_texture_layer = true;
 }
 
 void TextureLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "TextureLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "TextureLayer::Paint");
 
   std::shared_ptr<Texture> texture =
       context.texture_registry.GetTexture(texture_id_);
   if (!texture) {
-    TRACE_EVENT_INSTANT0("flutter", "null texture");
+    TRACE_EVENT_INSTANT0("flutter.detail", "null texture");
     return;
   }
   texture->Paint(*context.leaf_nodes_canvas, paint_bounds(), freeze_,
                  context.gr_context, filter_quality_);
 }
 
+void TextureLayer::Diff(DiffContext* context) const {
+  std::shared_ptr<Texture> texture =
+      context->texture_registry()
+          ? context->texture_registry()->GetTexture(texture_id_)
+          : nullptr;
+  if (!texture) {
+    // External textures may receive new frames at any time.
+    context->AddVolatilePaintRegion(paint_bounds());
+    return;
+  }
+  // The texture only paints something new after a new frame was marked
+  // available.
+  context->AddPaintRegion(
+      paint_bounds(),
+      fml::HashCombine(texture->frame_generation(), freeze_,
+                       static_cast<int>(filter_quality_)));
+}
+
+std::optional<uint64_t> TextureLayer::ComputeContentHash() const {
+  // External textures may receive new frames at any time.
+  return std::nullopt;
+}
+
 }  // namespace flutter
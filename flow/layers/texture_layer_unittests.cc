@@ -79,5 +79,31 @@ TEST_F(TextureLayerTest, PaintingWithLowFilterQuality) {
   EXPECT_EQ(mock_canvas().draw_calls(), std::vector<MockCanvas::DrawCall>());
 }
 
+TEST_F(TextureLayerTest, DamagedOnlyByNewFrames) {
+  const SkPoint layer_offset = SkPoint::Make(0.0f, 0.0f);
+  const SkSize layer_size = SkSize::Make(8.0f, 8.0f);
+  const int64_t texture_id = 0;
+  auto mock_texture = std::make_shared<MockTexture>(texture_id);
+  auto layer = std::make_shared<TextureLayer>(
+      layer_offset, layer_size, texture_id, false, kLow_SkFilterQuality);
+  TextureRegistry& registry = preroll_context()->texture_registry;
+  registry.RegisterTexture(mock_texture);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  auto diff = [&]() {
+    DiffContext context(SkMatrix::I(), &registry);
+    layer->Diff(&context);
+    EXPECT_TRUE(context.volatile_damage().isEmpty());
+    return context.TakeRegions();
+  };
+
+  auto regions = diff();
+  EXPECT_TRUE(DiffContext::ComputeDamage(regions, diff()).isEmpty());
+
+  registry.MarkNewFrameAvailable(texture_id);
+  EXPECT_EQ(DiffContext::ComputeDamage(regions, diff()),
+            SkIRect::MakeLTRB(-1, -1, 9, 9));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/transform_layer.h"
 
+#include "flutter/fml/hash_combine.h"
+
 namespace flutter {
 
 TransformLayer::TransformLayer(const SkMatrix& transform)
@@ -25,7 +27,7 @@ TransformLayer::TransformLayer(const SkMatrix& transform)
 }
 
 void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  TRACE_EVENT0("flutter", "TransformLayer::Preroll");
+  TRACE_EVENT0("flutter.detail", "TransformLayer::Preroll");
 
   SkMatrix child_matrix;
   child_matrix.setConcat(matrix, transform_);
@@ -48,12 +50,18 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   context->cull_rect = previous_cull_rect;
   context->mutators_stack.Pop();
+
+  context->subtree_can_inherit_opacity = children_can_inherit_opacity();
+  if (transform_.rectStaysRect()) {
+    context->subtree_opaque_bounds =
+        transform_.mapRect(children_opaque_bounds());
+  }
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void TransformLayer::UpdateScene(SceneUpdateContext& context) {
-  TRACE_EVENT0("flutter", "TransformLayer::UpdateScene");
+  TRACE_EVENT0("flutter.detail", "TransformLayer::UpdateScene");
   FML_DCHECK(needs_system_composite());
 
   if (!transform_.isIdentity()) {
@@ -67,13 +75,25 @@ void TransformLayer::UpdateScene(SceneUpdateContext& context) {
 #endif
 
 void TransformLayer::Paint(PaintContext& context) const {
-  TRACE_EVENT0("flutter", "TransformLayer::Paint");
+  TRACE_EVENT0("flutter.detail", "TransformLayer::Paint");
   FML_DCHECK(needs_painting());
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->concat(transform_);
 
-  PaintChildren(context);
+  PaintChildren(context, true /* allow_concurrent_paint */);
+}
+
+void TransformLayer::Diff(DiffContext* context) const {
+  DiffChildren(context, transform_, 0);
+}
+
+std::optional<uint64_t> TransformLayer::ComputeContentHash() const {
+  size_t fingerprint = fml::HashCombine();
+  for (int i = 0; i < 9; i++) {
+    fml::HashCombineSeed(fingerprint, transform_[i]);
+  }
+  return HashChildren(fingerprint);
 }
 
 }  // namespace flutter
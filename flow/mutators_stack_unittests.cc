@@ -37,11 +37,11 @@ TEST(MutatorsStack, CopyAndUpdateTheCopy) {
   ASSERT_TRUE(copy.is_empty());
   ASSERT_TRUE(!stack.is_empty());
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rrect);
-  ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+  ASSERT_TRUE(iter->GetType() == MutatorType::clip_rrect);
+  ASSERT_TRUE(iter->GetRRect() == rrect);
   ++iter;
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rect);
-  ASSERT_TRUE(iter->get()->GetRect() == rect);
+  ASSERT_TRUE(iter->GetType() == MutatorType::clip_rect);
+  ASSERT_TRUE(iter->GetRect() == rect);
 }
 
 TEST(MutatorsStack, PushClipRect) {
@@ -49,8 +49,8 @@ TEST(MutatorsStack, PushClipRect) {
   auto rect = SkRect::MakeEmpty();
   stack.PushClipRect(rect);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rect);
-  ASSERT_TRUE(iter->get()->GetRect() == rect);
+  ASSERT_TRUE(iter->GetType() == MutatorType::clip_rect);
+  ASSERT_TRUE(iter->GetRect() == rect);
 }
 
 TEST(MutatorsStack, PushClipRRect) {
@@ -58,8 +58,8 @@ TEST(MutatorsStack, PushClipRRect) {
   auto rrect = SkRRect::MakeEmpty();
   stack.PushClipRRect(rrect);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rrect);
-  ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+  ASSERT_TRUE(iter->GetType() == MutatorType::clip_rrect);
+  ASSERT_TRUE(iter->GetRRect() == rrect);
 }
 
 TEST(MutatorsStack, PushClipPath) {
@@ -67,8 +67,8 @@ TEST(MutatorsStack, PushClipPath) {
   SkPath path;
   stack.PushClipPath(path);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == flutter::MutatorType::clip_path);
-  ASSERT_TRUE(iter->get()->GetPath() == path);
+  ASSERT_TRUE(iter->GetType() == flutter::MutatorType::clip_path);
+  ASSERT_TRUE(iter->GetPath() == path);
 }
 
 TEST(MutatorsStack, PushTransform) {
@@ -77,8 +77,8 @@ TEST(MutatorsStack, PushTransform) {
   matrix.setIdentity();
   stack.PushTransform(matrix);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::transform);
-  ASSERT_TRUE(iter->get()->GetMatrix() == matrix);
+  ASSERT_TRUE(iter->GetType() == MutatorType::transform);
+  ASSERT_TRUE(iter->GetMatrix() == matrix);
 }
 
 TEST(MutatorsStack, PushOpacity) {
@@ -86,8 +86,8 @@ TEST(MutatorsStack, PushOpacity) {
   int alpha = 240;
   stack.PushOpacity(alpha);
   auto iter = stack.Bottom();
-  ASSERT_TRUE(iter->get()->GetType() == MutatorType::opacity);
-  ASSERT_TRUE(iter->get()->GetAlpha() == 240);
+  ASSERT_TRUE(iter->GetType() == MutatorType::opacity);
+  ASSERT_TRUE(iter->GetAlpha() == 240);
 }
 
 TEST(MutatorsStack, Pop) {
@@ -114,16 +114,16 @@ TEST(MutatorsStack, Traversal) {
   while (iter != stack.Top()) {
     switch (index) {
       case 0:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rrect);
-        ASSERT_TRUE(iter->get()->GetRRect() == rrect);
+        ASSERT_TRUE(iter->GetType() == MutatorType::clip_rrect);
+        ASSERT_TRUE(iter->GetRRect() == rrect);
         break;
       case 1:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::clip_rect);
-        ASSERT_TRUE(iter->get()->GetRect() == rect);
+        ASSERT_TRUE(iter->GetType() == MutatorType::clip_rect);
+        ASSERT_TRUE(iter->GetRect() == rect);
         break;
       case 2:
-        ASSERT_TRUE(iter->get()->GetType() == MutatorType::transform);
-        ASSERT_TRUE(iter->get()->GetMatrix() == matrix);
+        ASSERT_TRUE(iter->GetType() == MutatorType::transform);
+        ASSERT_TRUE(iter->GetMatrix() == matrix);
         break;
       default:
         break;
@@ -161,6 +161,81 @@ TEST(MutatorsStack, Equality) {
   ASSERT_TRUE(stack == stackOther);
 }
 
+TEST(MutatorsStack, GrowsPastInlineCapacity) {
+  MutatorsStack stack;
+  SkPath path;
+  path.addCircle(5.0f, 5.0f, 5.0f);
+  const size_t count = MutatorsStack::kInlineCapacity * 2 + 1;
+  for (size_t i = 0; i < count; i++) {
+    if (i % 2 == 0) {
+      stack.PushClipPath(path);
+    } else {
+      const SkScalar size = static_cast<SkScalar>(i);
+      stack.PushClipRect(SkRect::MakeWH(size, size));
+    }
+  }
+  ASSERT_EQ(stack.size(), count);
+
+  MutatorsStack copy = stack;
+  ASSERT_TRUE(copy == stack);
+
+  size_t index = 0;
+  for (auto iter = stack.Begin(); iter != stack.End(); ++iter, ++index) {
+    if (index % 2 == 0) {
+      ASSERT_EQ(iter->GetType(), MutatorType::clip_path);
+      ASSERT_TRUE(iter->GetPath() == path);
+    } else {
+      ASSERT_EQ(iter->GetType(), MutatorType::clip_rect);
+      const SkScalar size = static_cast<SkScalar>(index);
+      ASSERT_TRUE(iter->GetRect() == SkRect::MakeWH(size, size));
+    }
+  }
+  ASSERT_EQ(index, count);
+}
+
+TEST(MutatorsStack, HashMatchesForEqualStacks) {
+  MutatorsStack stack;
+  stack.PushTransform(SkMatrix::Scale(2, 2));
+  stack.PushClipRect(SkRect::MakeWH(10, 10));
+  SkPath path;
+  path.addCircle(5.0f, 5.0f, 5.0f);
+  stack.PushClipPath(path);
+  stack.PushOpacity(240);
+
+  MutatorsStack stackOther;
+  stackOther.PushTransform(SkMatrix::Scale(2, 2));
+  stackOther.PushClipRect(SkRect::MakeWH(10, 10));
+  SkPath pathOther;
+  pathOther.addCircle(5.0f, 5.0f, 5.0f);
+  stackOther.PushClipPath(pathOther);
+  stackOther.PushOpacity(240);
+
+  ASSERT_EQ(stack.Hash(), stackOther.Hash());
+  ASSERT_EQ(stack.Hash(), MutatorsStack(stack).Hash());
+}
+
+TEST(MutatorsStack, HashChangesWithTheMutators) {
+  MutatorsStack stack;
+  stack.PushClipRect(SkRect::MakeWH(10, 10));
+  stack.PushTransform(SkMatrix::Scale(2, 2));
+  const size_t hash = stack.Hash();
+
+  stack.PushOpacity(240);
+  ASSERT_NE(stack.Hash(), hash);
+  stack.Pop();
+  ASSERT_EQ(stack.Hash(), hash);
+
+  MutatorsStack reordered;
+  reordered.PushTransform(SkMatrix::Scale(2, 2));
+  reordered.PushClipRect(SkRect::MakeWH(10, 10));
+  ASSERT_NE(reordered.Hash(), hash);
+
+  MutatorsStack changed;
+  changed.PushClipRect(SkRect::MakeWH(10, 10));
+  changed.PushTransform(SkMatrix::Scale(3, 3));
+  ASSERT_NE(changed.Hash(), hash);
+}
+
 TEST(Mutator, Initialization) {
   SkRect rect = SkRect::MakeEmpty();
   Mutator mutator = Mutator(rect);
@@ -0,0 +1,333 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/picture_cost.h"
+
+#include <algorithm>
+
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+namespace {
+
+using OpKind = PictureCostCanvas::OpKind;
+
+// The fixed cost of an op by kind.
+double GetOpCost(OpKind kind) {
+  switch (kind) {
+    case OpKind::kSimple:
+      return 0.5;
+    case OpKind::kPath:
+      // Paths are tessellated or rendered into a coverage mask.
+      return 5.0;
+    case OpKind::kText:
+      return 2.0;
+    case OpKind::kImage:
+      return 2.0;
+  }
+  return 0.5;
+}
+
+// The cost per covered pixel of an op by kind.
+double GetFillCostPerPixel(OpKind kind) {
+  static constexpr double kFillCostPerPixel = 1e-4;
+  switch (kind) {
+    case OpKind::kSimple:
+    case OpKind::kText:
+      return kFillCostPerPixel;
+    case OpKind::kPath:
+      return 2 * kFillCostPerPixel;
+    case OpKind::kImage:
+      return 1.5 * kFillCostPerPixel;
+  }
+  return kFillCostPerPixel;
+}
+
+// Filters and blurs read many pixels for each one they write, and usually
+// need an offscreen pass.
+constexpr double kFilterOpCost = 20.0;
+constexpr double kFilterFillFactor = 10.0;
+
+// The cost of allocating, clearing and compositing a save layer.
+constexpr double kSaveLayerOpCost = 10.0;
+
+bool HasFilter(const SkPaint* paint) {
+  return paint && (paint->getMaskFilter() || paint->getImageFilter());
+}
+
+SkRect PointsBounds(const SkPoint points[], size_t count) {
+  SkRect bounds;
+  bounds.setBounds(points, static_cast<int>(count));
+  return bounds;
+}
+
+}  // namespace
+
+PictureCostCanvas::PictureCostCanvas(const SkIRect& bounds, PictureCost* cost)
+    : SkNoDrawCanvas(bounds), cost_(cost) {}
+
+PictureCostCanvas::~PictureCostCanvas() = default;
+
+void PictureCostCanvas::Record(OpKind kind,
+                               const SkRect& bounds,
+                               const SkPaint* paint) {
+  if (paint && !paint->canComputeFastBounds()) {
+    // The paint may draw outside of the bounds, e.g. with an image filter
+    // that moves pixels, up to the whole clip.
+    RecordClip(kind, paint);
+    return;
+  }
+  SkRect draw_bounds = bounds;
+  SkRect storage;
+  if (paint) {
+    draw_bounds = paint->computeFastBounds(bounds, &storage);
+  }
+  SkRect device_bounds = getTotalMatrix().mapRect(draw_bounds);
+  RecordDevice(kind, device_bounds, HasFilter(paint));
+}
+
+void PictureCostCanvas::RecordDevice(OpKind kind,
+                                     const SkRect& device_bounds,
+                                     bool filtered) {
+  SkRect covered = SkRect::Make(getDeviceClipBounds());
+  if (!covered.intersect(device_bounds)) {
+    covered.setEmpty();
+  }
+  const double area = covered.width() * covered.height();
+
+  cost_->op_count_++;
+  cost_->covered_area_ += area;
+  double op_cost = GetOpCost(kind);
+  double fill_cost = GetFillCostPerPixel(kind) * area;
+  if (filtered) {
+    cost_->filter_count_++;
+    op_cost += kFilterOpCost;
+    fill_cost *= kFilterFillFactor;
+  }
+  cost_->op_cost_ += op_cost;
+  cost_->fill_cost_ += fill_cost;
+
+  switch (kind) {
+    case OpKind::kPath:
+      cost_->path_count_++;
+      break;
+    case OpKind::kText:
+      cost_->text_count_++;
+      break;
+    case OpKind::kImage:
+      cost_->image_count_++;
+      break;
+    case OpKind::kSimple:
+      break;
+  }
+
+  DidRecordDraw(covered);
+}
+
+void PictureCostCanvas::RecordClip(OpKind kind, const SkPaint* paint) {
+  RecordDevice(kind, SkRect::Make(getDeviceClipBounds()), HasFilter(paint));
+}
+
+SkCanvas::SaveLayerStrategy PictureCostCanvas::getSaveLayerStrategy(
+    const SaveLayerRec& rec) {
+  const bool filtered = rec.fBackdrop || HasFilter(rec.fPaint);
+  SkRect device_bounds = SkRect::Make(getDeviceClipBounds());
+  if (rec.fBounds && !rec.fBackdrop) {
+    device_bounds = getTotalMatrix().mapRect(*rec.fBounds);
+  }
+  SkRect covered = SkRect::Make(getDeviceClipBounds());
+  if (!covered.intersect(device_bounds)) {
+    covered.setEmpty();
+  }
+  const double area = covered.width() * covered.height();
+
+  cost_->save_layer_count_++;
+  cost_->op_cost_ += kSaveLayerOpCost;
+  cost_->fill_cost_ += GetFillCostPerPixel(OpKind::kImage) * area;
+  if (filtered) {
+    cost_->filter_count_++;
+    cost_->op_cost_ += kFilterOpCost;
+    cost_->fill_cost_ +=
+        GetFillCostPerPixel(OpKind::kImage) * kFilterFillFactor * area;
+  }
+  return SkNoDrawCanvas::getSaveLayerStrategy(rec);
+}
+
+void PictureCostCanvas::onDrawPaint(const SkPaint& paint) {
+  RecordClip(OpKind::kSimple, &paint);
+}
+
+void PictureCostCanvas::onDrawBehind(const SkPaint& paint) {
+  RecordClip(OpKind::kSimple, &paint);
+}
+
+void PictureCostCanvas::onDrawPoints(PointMode mode,
+                                     size_t count,
+                                     const SkPoint points[],
+                                     const SkPaint& paint) {
+  if (count == 0) {
+    return;
+  }
+  Record(mode == kPoints_PointMode ? OpKind::kSimple : OpKind::kPath,
+         PointsBounds(points, count), &paint);
+}
+
+void PictureCostCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
+  Record(OpKind::kSimple, rect, &paint);
+}
+
+void PictureCostCanvas::onDrawRegion(const SkRegion& region,
+                                     const SkPaint& paint) {
+  Record(OpKind::kSimple, SkRect::Make(region.getBounds()), &paint);
+}
+
+void PictureCostCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
+  Record(OpKind::kSimple, rect, &paint);
+}
+
+void PictureCostCanvas::onDrawArc(const SkRect& rect,
+                                  SkScalar start_angle,
+                                  SkScalar sweep_angle,
+                                  bool use_center,
+                                  const SkPaint& paint) {
+  Record(OpKind::kPath, rect, &paint);
+}
+
+void PictureCostCanvas::onDrawRRect(const SkRRect& rrect,
+                                    const SkPaint& paint) {
+  Record(OpKind::kSimple, rrect.getBounds(), &paint);
+}
+
+void PictureCostCanvas::onDrawDRRect(const SkRRect& outer,
+                                     const SkRRect& inner,
+                                     const SkPaint& paint) {
+  Record(OpKind::kPath, outer.getBounds(), &paint);
+}
+
+void PictureCostCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
+  if (path.isInverseFillType()) {
+    RecordClip(OpKind::kPath, &paint);
+    return;
+  }
+  Record(OpKind::kPath, path.getBounds(), &paint);
+}
+
+void PictureCostCanvas::onDrawTextBlob(const SkTextBlob* blob,
+                                       SkScalar x,
+                                       SkScalar y,
+                                       const SkPaint& paint) {
+  Record(OpKind::kText, blob->bounds().makeOffset(x, y), &paint);
+}
+
+void PictureCostCanvas::onDrawPatch(const SkPoint cubics[12],
+                                    const SkColor colors[4],
+                                    const SkPoint tex_coords[4],
+                                    SkBlendMode mode,
+                                    const SkPaint& paint) {
+  Record(OpKind::kPath, PointsBounds(cubics, 12), &paint);
+}
+
+void PictureCostCanvas::onDrawVerticesObject(const SkVertices* vertices,
+                                             SkBlendMode mode,
+                                             const SkPaint& paint) {
+  Record(OpKind::kPath, vertices->bounds(), &paint);
+}
+
+void PictureCostCanvas::onDrawImage(const SkImage* image,
+                                    SkScalar left,
+                                    SkScalar top,
+                                    const SkPaint* paint) {
+  Record(OpKind::kImage,
+         SkRect::MakeXYWH(left, top, image->width(), image->height()),
+         paint);
+}
+
+void PictureCostCanvas::onDrawImageRect(const SkImage* image,
+                                        const SkRect* src,
+                                        const SkRect& dst,
+                                        const SkPaint* paint,
+                                        SrcRectConstraint constraint) {
+  Record(OpKind::kImage, dst, paint);
+}
+
+void PictureCostCanvas::onDrawImageLattice(const SkImage* image,
+                                           const Lattice& lattice,
+                                           const SkRect& dst,
+                                           const SkPaint* paint) {
+  Record(OpKind::kImage, dst, paint);
+}
+
+void PictureCostCanvas::onDrawImageNine(const SkImage* image,
+                                        const SkIRect& center,
+                                        const SkRect& dst,
+                                        const SkPaint* paint) {
+  Record(OpKind::kImage, dst, paint);
+}
+
+void PictureCostCanvas::onDrawAtlas(const SkImage* atlas,
+                                    const SkRSXform xforms[],
+                                    const SkRect tex[],
+                                    const SkColor colors[],
+                                    int count,
+                                    SkBlendMode mode,
+                                    const SkRect* cull_rect,
+                                    const SkPaint* paint) {
+  if (cull_rect) {
+    Record(OpKind::kImage, *cull_rect, paint);
+  } else {
+    RecordClip(OpKind::kImage, paint);
+  }
+}
+
+void PictureCostCanvas::onDrawShadowRec(const SkPath& path,
+                                        const SkDrawShadowRec& rec) {
+  // Shadows are blurred. The blur extends past the path, but its bounds
+  // depend on the light, so the path bounds are used as an estimate.
+  RecordDevice(OpKind::kPath, getTotalMatrix().mapRect(path.getBounds()),
+               true);
+}
+
+void PictureCostCanvas::onDrawEdgeAAQuad(const SkRect& rect,
+                                         const SkPoint clip[4],
+                                         QuadAAFlags aa_flags,
+                                         const SkColor4f& color,
+                                         SkBlendMode mode) {
+  Record(OpKind::kSimple, rect, nullptr);
+}
+
+void PictureCostCanvas::onDrawEdgeAAImageSet(const ImageSetEntry set[],
+                                             int count,
+                                             const SkPoint dst_clips[],
+                                             const SkMatrix pre_view_matrices[],
+                                             const SkPaint* paint,
+                                             SrcRectConstraint constraint) {
+  for (int i = 0; i < count; i++) {
+    Record(OpKind::kImage, set[i].fDstRect, paint);
+  }
+}
+
+PictureCost PictureCost::Analyze(const SkPicture& picture) {
+  PictureCost cost;
+  const SkRect cull_rect = picture.cullRect();
+  if (cull_rect.isEmpty() || !cull_rect.isFinite()) {
+    return cost;
+  }
+  PictureCostCanvas canvas(cull_rect.roundOut(), &cost);
+  picture.playback(&canvas);
+  return cost;
+}
+
+double PictureCost::EstimateImageDraw(double pixels) {
+  return GetOpCost(OpKind::kImage) +
+         GetFillCostPerPixel(OpKind::kImage) * pixels;
+}
+
+}  // namespace flutter
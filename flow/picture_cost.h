@@ -0,0 +1,205 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_PICTURE_COST_H_
+#define FLUTTER_FLOW_PICTURE_COST_H_
+
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flutter {
+
+// A rough model of the cost of drawing an SkPicture directly, built by
+// playing its ops back into a canvas that only inspects them.
+//
+// Costs are in nominal microseconds. Each op has a fixed cost that depends on
+// its kind, and a fill cost proportional to the pixels it covers that is much
+// higher for ops that blur or filter. The constants are only meant to rank
+// pictures against each other and against drawing a cached image of them; the
+// RasterCache calibrates them against the time rasterizing actually takes.
+class PictureCost {
+ public:
+  static PictureCost Analyze(const SkPicture& picture);
+
+  // The estimated cost of drawing an image covering |pixels| device pixels.
+  static double EstimateImageDraw(double pixels);
+
+  // The estimated cost of drawing the picture with a matrix that scales areas
+  // by |area_scale|.
+  double Estimate(double area_scale) const {
+    return op_cost_ + fill_cost_ * area_scale;
+  }
+
+  int op_count() const { return op_count_; }
+  int path_count() const { return path_count_; }
+  int text_count() const { return text_count_; }
+  int image_count() const { return image_count_; }
+  int save_layer_count() const { return save_layer_count_; }
+
+  // The number of ops with a mask or image filter, shadows and save layers
+  // with a backdrop filter.
+  int filter_count() const { return filter_count_; }
+
+  // The area in picture coordinates covered by the ops, clipped to their clips
+  // and counting overlapping ops repeatedly.
+  double covered_area() const { return covered_area_; }
+
+ private:
+  friend class PictureCostCanvas;
+
+  int op_count_ = 0;
+  int path_count_ = 0;
+  int text_count_ = 0;
+  int image_count_ = 0;
+  int save_layer_count_ = 0;
+  int filter_count_ = 0;
+  double covered_area_ = 0;
+  double op_cost_ = 0;
+  double fill_cost_ = 0;
+};
+
+// A canvas that adds the cost of the ops drawn into it to a PictureCost,
+// without drawing them. Its device coordinates are those of |bounds|.
+class PictureCostCanvas : public SkNoDrawCanvas {
+ public:
+  PictureCostCanvas(const SkIRect& bounds, PictureCost* cost);
+
+  ~PictureCostCanvas() override;
+
+  enum class OpKind { kSimple, kPath, kText, kImage };
+
+ protected:
+  // Called with the device bounds of each draw, clipped to the clip, after its
+  // cost is recorded. Some draws are recorded as several ops.
+  virtual void DidRecordDraw(const SkRect& device_bounds) {}
+
+  // |SkCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override;
+
+  // |SkCanvas|
+  void onDrawPaint(const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawBehind(const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPoints(PointMode mode,
+                    size_t count,
+                    const SkPoint points[],
+                    const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRegion(const SkRegion& region, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawOval(const SkRect& rect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawArc(const SkRect& rect,
+                 SkScalar start_angle,
+                 SkScalar sweep_angle,
+                 bool use_center,
+                 const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawDRRect(const SkRRect& outer,
+                    const SkRRect& inner,
+                    const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPath(const SkPath& path, const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint tex_coords[4],
+                   SkBlendMode mode,
+                   const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawVerticesObject(const SkVertices* vertices,
+                            SkBlendMode mode,
+                            const SkPaint& paint) override;
+
+  // |SkCanvas|
+  void onDrawImage(const SkImage* image,
+                   SkScalar left,
+                   SkScalar top,
+                   const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawImageRect(const SkImage* image,
+                       const SkRect* src,
+                       const SkRect& dst,
+                       const SkPaint* paint,
+                       SrcRectConstraint constraint) override;
+
+  // |SkCanvas|
+  void onDrawImageLattice(const SkImage* image,
+                          const Lattice& lattice,
+                          const SkRect& dst,
+                          const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawImageNine(const SkImage* image,
+                       const SkIRect& center,
+                       const SkRect& dst,
+                       const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawAtlas(const SkImage* atlas,
+                   const SkRSXform xforms[],
+                   const SkRect tex[],
+                   const SkColor colors[],
+                   int count,
+                   SkBlendMode mode,
+                   const SkRect* cull_rect,
+                   const SkPaint* paint) override;
+
+  // |SkCanvas|
+  void onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) override;
+
+  // |SkCanvas|
+  void onDrawEdgeAAQuad(const SkRect& rect,
+                        const SkPoint clip[4],
+                        QuadAAFlags aa_flags,
+                        const SkColor4f& color,
+                        SkBlendMode mode) override;
+
+  // |SkCanvas|
+  void onDrawEdgeAAImageSet(const ImageSetEntry set[],
+                            int count,
+                            const SkPoint dst_clips[],
+                            const SkMatrix pre_view_matrices[],
+                            const SkPaint* paint,
+                            SrcRectConstraint constraint) override;
+
+ private:
+  PictureCost* cost_;
+
+  // Records an op that draws |bounds| in local coordinates with |paint|.
+  void Record(OpKind kind, const SkRect& bounds, const SkPaint* paint);
+
+  // Records an op that draws |device_bounds| in device coordinates.
+  void RecordDevice(OpKind kind, const SkRect& device_bounds, bool filtered);
+
+  // Records an op that covers the whole clip.
+  void RecordClip(OpKind kind, const SkPaint* paint);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_PICTURE_COST_H_
@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/picture_cost.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(PictureCost, CountsOpsByKind) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  SkPath path;
+  path.moveTo(0, 0);
+  path.cubicTo(10, 40, 60, 80, 90, 10);
+  canvas->drawPath(path, paint);
+  sk_sp<SkImage> image =
+      SkSurface::MakeRasterN32Premul(10, 10)->makeImageSnapshot();
+  canvas->drawImage(image, 50, 50);
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  PictureCost cost = PictureCost::Analyze(*picture);
+  EXPECT_EQ(cost.op_count(), 3);
+  EXPECT_EQ(cost.path_count(), 1);
+  EXPECT_EQ(cost.text_count(), 0);
+  EXPECT_EQ(cost.image_count(), 1);
+  EXPECT_EQ(cost.filter_count(), 0);
+  EXPECT_GT(cost.Estimate(1), 0);
+}
+
+TEST(PictureCost, CoveredAreaIsClipped) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  canvas->drawRect(SkRect::MakeWH(20, 10), paint);
+  canvas->save();
+  canvas->clipRect(SkRect::MakeWH(10, 10));
+  canvas->drawRect(SkRect::MakeWH(50, 50), paint);
+  canvas->restore();
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  PictureCost cost = PictureCost::Analyze(*picture);
+  EXPECT_EQ(cost.op_count(), 2);
+  EXPECT_DOUBLE_EQ(cost.covered_area(), 300);
+}
+
+TEST(PictureCost, FiltersAreExpensive) {
+  auto make_picture = [](bool blur) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkPaint paint;
+    if (blur) {
+      paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 5));
+    }
+    canvas->drawRect(SkRect::MakeWH(50, 50), paint);
+    return recorder.finishRecordingAsPicture();
+  };
+
+  PictureCost plain = PictureCost::Analyze(*make_picture(false));
+  PictureCost blurred = PictureCost::Analyze(*make_picture(true));
+  EXPECT_EQ(plain.filter_count(), 0);
+  EXPECT_EQ(blurred.filter_count(), 1);
+  EXPECT_GT(blurred.Estimate(1), plain.Estimate(1));
+}
+
+TEST(PictureCost, EstimateGrowsWithTheAreaScale) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+  canvas->drawRect(SkRect::MakeWH(100, 100), SkPaint());
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  PictureCost cost = PictureCost::Analyze(*picture);
+  EXPECT_GT(cost.Estimate(4), cost.Estimate(1));
+  EXPECT_GT(PictureCost::EstimateImageDraw(400), 0);
+  EXPECT_GT(PictureCost::EstimateImageDraw(400),
+            PictureCost::EstimateImageDraw(100));
+}
+
+}  // namespace testing
+}  // namespace flutter
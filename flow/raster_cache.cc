@@ -4,6 +4,7 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
@@ -18,12 +19,23 @@
 
 namespace flutter {
 
+// The cost model's estimate in microseconds of allocating and clearing a
+// byte of a cache image, and the number of bytes per pixel of the images.
+static constexpr double kPopulateCostPerByte = 2.5e-5;
+static constexpr double kBytesPerPixel = 4;
+
+// Bounds and rate of the calibration of the cost model, see
+// RasterCache::LearnRasterizeCost.
+static constexpr double kMinCostScale = 0.05;
+static constexpr double kMaxCostScale = 20.0;
+static constexpr double kCostScaleLearningRate = 0.1;
+
 RasterCacheResult::RasterCacheResult(sk_sp<SkImage> image,
                                      const SkRect& logical_rect)
     : image_(std::move(image)), logical_rect_(logical_rect) {}
 
 void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
-  TRACE_EVENT0("flutter", "RasterCacheResult::draw");
+  TRACE_EVENT0("flutter.detail", "RasterCacheResult::draw");
   SkAutoCanvasRestore auto_restore(&canvas, true);
   SkIRect bounds =
       RasterCache::GetDeviceBounds(logical_rect_, canvas.getTotalMatrix());
@@ -34,19 +46,45 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   canvas.drawImage(image_, bounds.fLeft, bounds.fTop, paint);
 }
 
+void RasterCacheResult::drawScaled(SkCanvas& canvas,
+                                   const SkVector& scale,
+                                   const SkPaint* paint) const {
+  TRACE_EVENT0("flutter.detail", "RasterCacheResult::drawScaled");
+  SkAutoCanvasRestore auto_restore(&canvas, true);
+  SkIRect bounds =
+      RasterCache::GetDeviceBounds(logical_rect_, canvas.getTotalMatrix());
+  SkPaint filtered_paint = paint ? *paint : SkPaint();
+  filtered_paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas.resetMatrix();
+  canvas.drawImageRect(
+      image_,
+      SkRect::MakeXYWH(bounds.fLeft, bounds.fTop,
+                       image_->width() * scale.fX, image_->height() * scale.fY),
+      &filtered_paint);
+}
+
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t max_bytes)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
-      checkerboard_images_(false) {}
+      max_bytes_(max_bytes),
+      checkerboard_images_(false),
+      memory_charge_(fml::MemoryCounter::Get("RasterCache")) {}
 
-static bool CanRasterizePicture(SkPicture* picture) {
-  if (picture == nullptr) {
-    return false;
-  }
+uint64_t RasterCache::PictureSource::unique_id() const {
+  return picture ? picture->uniqueID() : display_list->unique_id();
+}
 
-  const SkRect cull_rect = picture->cullRect();
+SkRect RasterCache::PictureSource::cull_rect() const {
+  return picture ? picture->cullRect() : display_list->cull_rect();
+}
 
+int RasterCache::PictureSource::op_count() const {
+  return picture ? picture->approximateOpCount() : display_list->op_count();
+}
+
+static bool CanRasterizePicture(const SkRect& cull_rect) {
   if (cull_rect.isEmpty()) {
     // No point in ever rasterizing an empty picture.
     return false;
@@ -60,7 +98,8 @@ static bool CanRasterizePicture(SkPicture* picture) {
   return true;
 }
 
-static bool IsPictureWorthRasterizing(SkPicture* picture,
+static bool IsPictureWorthRasterizing(const SkRect& cull_rect,
+                                      int op_count,
                                       bool will_change,
                                       bool is_complex) {
   if (will_change) {
@@ -69,7 +108,7 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
     return false;
   }
 
-  if (!CanRasterizePicture(picture)) {
+  if (!CanRasterizePicture(cull_rect)) {
     // No point in deciding whether the picture is worth rasterizing if it
     // cannot be rasterized at all.
     return false;
@@ -83,7 +122,7 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
 
   // TODO(abarth): We should find a better heuristic here that lets us avoid
   // wasting memory on trivial layers that are easy to re-rasterize every frame.
-  return picture->approximateOpCount() > 5;
+  return op_count > 5;
 }
 
 /// @note Procedure doesn't copy all closures.
@@ -93,6 +132,7 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
     SkColorSpace* dst_color_space,
     bool checkerboard,
     const SkRect& logical_rect,
+    RasterCacheAtlas* atlas,
     const std::function<void(SkCanvas*)>& draw_function) {
   TRACE_EVENT0("flutter", "RasterCachePopulate");
   SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
@@ -100,6 +140,23 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
   const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
       cache_rect.width(), cache_rect.height(), sk_ref_sp(dst_color_space));
 
+  auto draw_cache = [&](SkCanvas* canvas) {
+    canvas->translate(-cache_rect.left(), -cache_rect.top());
+    canvas->concat(ctm);
+    draw_function(canvas);
+
+    if (checkerboard) {
+      DrawCheckerboard(canvas, logical_rect);
+    }
+  };
+
+  if (atlas && atlas->CanPack(image_info.dimensions())) {
+    if (auto result =
+            atlas->Rasterize(context, image_info, logical_rect, draw_cache)) {
+      return result;
+    }
+  }
+
   sk_sp<SkSurface> surface =
       context
           ? SkSurface::MakeRenderTarget(context, SkBudgeted::kYes, image_info)
@@ -111,13 +168,7 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
 
   SkCanvas* canvas = surface->getCanvas();
   canvas->clear(SK_ColorTRANSPARENT);
-  canvas->translate(-cache_rect.left(), -cache_rect.top());
-  canvas->concat(ctm);
-  draw_function(canvas);
-
-  if (checkerboard) {
-    DrawCheckerboard(canvas, logical_rect);
-  }
+  draw_cache(canvas);
 
   return std::make_unique<RasterCacheResult>(surface->makeImageSnapshot(),
                                              logical_rect);
@@ -130,19 +181,143 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
     SkColorSpace* dst_color_space,
     bool checkerboard) const {
   return Rasterize(context, ctm, dst_color_space, checkerboard,
-                   picture->cullRect(),
+                   picture->cullRect(), atlas_.get(),
                    [=](SkCanvas* canvas) { canvas->drawPicture(picture); });
 }
 
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeDisplayList(
+    DisplayList* display_list,
+    GrContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) const {
+  return Rasterize(context, ctm, dst_color_space, checkerboard,
+                   display_list->cull_rect(), atlas_.get(),
+                   [=](SkCanvas* canvas) { display_list->RenderTo(canvas); });
+}
+
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeShadow(
+    GrContext* context,
+    const SkRect& bounds,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const std::function<void(SkCanvas*)>& draw_shadow) const {
+  return Rasterize(context, ctm, dst_color_space, checkerboard, bounds,
+                   atlas_.get(), draw_shadow);
+}
+
 void RasterCache::Prepare(PrerollContext* context,
                           Layer* layer,
                           const SkMatrix& ctm) {
   LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
+  std::unique_lock<std::mutex> lock(prepare_mutex_);
   Entry& entry = layer_cache_[cache_key];
   entry.access_count++;
-  entry.used_this_frame = true;
+  Touch(entry);
   if (!entry.image) {
-    entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+    SkVector scale;
+    auto* scaled = FindScaledEntry(layer_cache_, cache_key, &scale);
+    if (scaled && entry.access_count < access_threshold_) {
+      // Keep drawing the image made at a nearby scale until this scale has
+      // been used for long enough to be worth rasterizing.
+      Touch(scaled->second);
+      return;
+    }
+    if (concurrent_preroll_) {
+      queued_layers_.push_back({cache_key, layer, ctm});
+      return;
+    }
+    lock.unlock();
+    PopulateLayerEntry(entry, context, layer, ctm);
+  }
+}
+
+bool RasterCache::PrepareShadow(GrContext* context,
+                                uint64_t shadow_id,
+                                const SkRect& bounds,
+                                const SkMatrix& ctm,
+                                SkColorSpace* dst_color_space,
+                                std::function<void(SkCanvas*)> draw_shadow) {
+  if (!cache_shadows_ || access_threshold_ == 0 ||
+      !CanRasterizePicture(bounds) || !MatrixDecomposition(ctm).IsValid()) {
+    return false;
+  }
+
+  ShadowRasterCacheKey cache_key(shadow_id, ctm);
+  std::unique_lock<std::mutex> lock(prepare_mutex_);
+  // Creates an entry, if not present prior. Accesses are counted when the
+  // shadow is drawn.
+  Entry& entry = shadow_cache_[cache_key];
+  if (entry.image) {
+    return true;
+  }
+  if (entry.access_count < access_threshold_ ||
+      picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+  picture_cached_this_frame_++;
+  if (concurrent_preroll_) {
+    queued_shadows_.push_back({cache_key, bounds, ctm,
+                               sk_ref_sp(dst_color_space),
+                               std::move(draw_shadow)});
+    return true;
+  }
+  lock.unlock();
+  PopulateShadowEntry(entry, context, bounds, ctm, dst_color_space,
+                      draw_shadow);
+  return entry.image != nullptr;
+}
+
+void RasterCache::BeginConcurrentPreroll() {
+  std::scoped_lock lock(prepare_mutex_);
+  FML_DCHECK(!concurrent_preroll_);
+  concurrent_preroll_ = true;
+}
+
+void RasterCache::EndConcurrentPreroll(PrerollContext* context) {
+  std::vector<PendingPicture> pictures;
+  std::vector<QueuedLayer> layers;
+  std::vector<QueuedShadow> shadows;
+  {
+    std::scoped_lock lock(prepare_mutex_);
+    FML_DCHECK(concurrent_preroll_);
+    concurrent_preroll_ = false;
+    pictures.swap(queued_pictures_);
+    layers.swap(queued_layers_);
+    shadows.swap(queued_shadows_);
+  }
+
+  if (pictures.empty() && layers.empty() && shadows.empty()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCache::EndConcurrentPreroll");
+  // Pictures go first so that layers painting them can use their images.
+  for (const PendingPicture& queued : pictures) {
+    auto it = picture_cache_.find(queued.key);
+    if (it == picture_cache_.end() || it->second.image) {
+      continue;
+    }
+    it->second.pending = false;
+    PopulatePictureEntry(it->second, queued.source(), context->gr_context,
+                         queued.matrix, queued.dst_color_space.get());
+  }
+  for (const QueuedLayer& queued : layers) {
+    auto it = layer_cache_.find(queued.key);
+    if (it == layer_cache_.end() || it->second.image) {
+      continue;
+    }
+    PopulateLayerEntry(it->second, context, queued.layer, queued.matrix);
+  }
+  for (const QueuedShadow& queued : shadows) {
+    auto it = shadow_cache_.find(queued.key);
+    if (it == shadow_cache_.end() || it->second.image) {
+      continue;
+    }
+    PopulateShadowEntry(it->second, context->gr_context, queued.bounds,
+                        queued.matrix, queued.dst_color_space.get(),
+                        queued.draw_shadow);
   }
 }
 
@@ -153,7 +328,7 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizeLayer(
     bool checkerboard) const {
   return Rasterize(
       context->gr_context, ctm, context->dst_color_space, checkerboard,
-      layer->paint_bounds(), [layer, context](SkCanvas* canvas) {
+      layer->paint_bounds(), atlas_.get(), [layer, context](SkCanvas* canvas) {
         SkISize canvas_size = canvas->getBaseLayerSize();
         SkNWayCanvas internal_nodes_canvas(canvas_size.width(),
                                            canvas_size.height());
@@ -182,14 +357,40 @@ bool RasterCache::Prepare(GrContext* context,
                           SkColorSpace* dst_color_space,
                           bool is_complex,
                           bool will_change) {
+  return PreparePicture(context, PictureSource(picture), transformation_matrix,
+                        dst_color_space, is_complex, will_change);
+}
+
+bool RasterCache::Prepare(GrContext* context,
+                          DisplayList* display_list,
+                          const SkMatrix& transformation_matrix,
+                          SkColorSpace* dst_color_space,
+                          bool is_complex,
+                          bool will_change) {
+  return PreparePicture(context, PictureSource(display_list),
+                        transformation_matrix, dst_color_space, is_complex,
+                        will_change);
+}
+
+bool RasterCache::PreparePicture(GrContext* context,
+                                 PictureSource source,
+                                 const SkMatrix& transformation_matrix,
+                                 SkColorSpace* dst_color_space,
+                                 bool is_complex,
+                                 bool will_change) {
   // Disabling caching when access_threshold is zero is historic behavior.
-  if (access_threshold_ == 0) {
+  if (access_threshold_ == 0 || source.is_null()) {
     return false;
   }
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
-    return false;
-  }
-  if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
+  const SkRect cull_rect = source.cull_rect();
+  const bool use_cost_model = use_cost_model_ && !is_complex;
+  if (use_cost_model) {
+    // The cost model decides whether the picture is worth rasterizing.
+    if (will_change || !CanRasterizePicture(cull_rect)) {
+      return false;
+    }
+  } else if (!IsPictureWorthRasterizing(cull_rect, source.op_count(),
+                                        will_change, is_complex)) {
     // We only deal with pictures that are worthy of rasterization.
     return false;
   }
@@ -203,77 +404,377 @@ bool RasterCache::Prepare(GrContext* context,
     return false;
   }
 
-  PictureRasterCacheKey cache_key(picture->uniqueID(), transformation_matrix);
+  PictureRasterCacheKey cache_key(source.unique_id(), transformation_matrix);
+
+  std::unique_lock<std::mutex> lock(prepare_mutex_);
+  if (scale_tolerance_ > 0) {
+    auto it = picture_cache_.find(cache_key);
+    SkVector scale;
+    if (it == picture_cache_.end() || !it->second.image) {
+      auto* scaled = FindScaledEntry(picture_cache_, cache_key, &scale);
+      const size_t access_count =
+          it == picture_cache_.end() ? 0 : it->second.access_count;
+      // Keep drawing the image made at a nearby scale until this scale has
+      // been used for long enough to be worth rasterizing.
+      if (scaled && access_count < access_threshold_) {
+        Touch(scaled->second);
+        // Creates the entry, which counts the accesses at this scale. This
+        // moves |scaled|.
+        picture_cache_[cache_key];
+        return true;
+      }
+    }
+  }
+
+  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
 
-  // Creates an entry, if not present prior.
-  Entry& entry = picture_cache_[cache_key];
-  if (entry.access_count < access_threshold_) {
+  // Creates an entry, if not present prior. Other threads may insert entries
+  // while a concurrent preroll has the lock released, which moves the entry.
+  Entry* entry = &picture_cache_[cache_key];
+  if (use_cost_model && !entry->image) {
+    const SkIRect device_bounds =
+        GetDeviceBounds(cull_rect, transformation_matrix);
+    if (entry->estimated_cost < 0) {
+      // The ops of a picture are only analyzed once per entry, but that takes
+      // a while for large pictures. Display lists measure them while they are
+      // recorded.
+      lock.unlock();
+      const double area_scale =
+          static_cast<double>(device_bounds.width()) * device_bounds.height() /
+          (static_cast<double>(cull_rect.width()) * cull_rect.height());
+      const double cost =
+          source.display_list
+              ? source.display_list->cost().Estimate(area_scale)
+              : PictureCost::Analyze(*source.picture).Estimate(area_scale);
+      lock.lock();
+      entry = &picture_cache_[cache_key];
+      entry->estimated_cost = cost;
+    }
+    if (!IsWorthCaching(*entry, device_bounds)) {
+      return false;
+    }
+  } else if (!use_cost_model && entry->access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
-  if (!entry.image) {
-    entry.image = RasterizePicture(picture, context, transformation_matrix,
-                                   dst_color_space, checkerboard_images_);
+  if (!entry->image) {
+    if (defer_population_ || concurrent_preroll_) {
+      if (!entry->pending) {
+        entry->pending = true;
+        PendingPicture pending = {cache_key, sk_ref_sp(source.picture),
+                                  sk_ref_sp(source.display_list),
+                                  transformation_matrix,
+                                  sk_ref_sp(dst_color_space)};
+        if (defer_population_) {
+          pending_pictures_.push_back(std::move(pending));
+        } else {
+          queued_pictures_.push_back(std::move(pending));
+          picture_cached_this_frame_++;
+        }
+      }
+      // Pictures queued by a concurrent preroll are rasterized before the
+      // frame is painted.
+      return !defer_population_;
+    }
     picture_cached_this_frame_++;
+    lock.unlock();
+    PopulatePictureEntry(*entry, source, context, transformation_matrix,
+                         dst_color_space);
   }
   return true;
 }
 
-bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
-  PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
-  auto it = picture_cache_.find(cache_key);
-  if (it == picture_cache_.end()) {
-    return false;
+size_t RasterCache::RasterizePendingEntries(GrContext* context,
+                                            fml::TimePoint deadline) {
+  if (pending_pictures_.empty()) {
+    return 0;
   }
 
-  Entry& entry = it->second;
-  entry.access_count++;
-  entry.used_this_frame = true;
-
-  if (entry.image) {
-    entry.image->draw(canvas);
-    return true;
+  TRACE_EVENT0("flutter", "RasterCache::RasterizePendingEntries");
+  size_t populated = 0;
+  size_t processed = 0;
+  for (; processed < pending_pictures_.size(); processed++) {
+    if (fml::TimePoint::Now() >= deadline) {
+      break;
+    }
+    PendingPicture& pending = pending_pictures_[processed];
+    auto it = picture_cache_.find(pending.key);
+    if (it == picture_cache_.end() || it->second.image) {
+      // The entry has been swept or populated since it was queued.
+      continue;
+    }
+    Entry& entry = it->second;
+    entry.pending = false;
+    PopulatePictureEntry(entry, pending.source(), context, pending.matrix,
+                         pending.dst_color_space.get());
+    populated++;
   }
+  pending_pictures_.erase(pending_pictures_.begin(),
+                          pending_pictures_.begin() + processed);
+  return populated;
+}
+
+bool RasterCache::Draw(const SkPicture& picture,
+                       SkCanvas& canvas,
+                       const SkPaint* paint) const {
+  PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
+  return DrawEntry(picture_cache_, cache_key, canvas, paint);
+}
 
-  return false;
+bool RasterCache::Draw(const DisplayList& display_list,
+                       SkCanvas& canvas,
+                       const SkPaint* paint) const {
+  PictureRasterCacheKey cache_key(display_list.unique_id(),
+                                  canvas.getTotalMatrix());
+  return DrawEntry(picture_cache_, cache_key, canvas, paint);
 }
 
 bool RasterCache::Draw(const Layer* layer,
                        SkCanvas& canvas,
                        SkPaint* paint) const {
   LayerRasterCacheKey cache_key(layer->unique_id(), canvas.getTotalMatrix());
-  auto it = layer_cache_.find(cache_key);
-  if (it == layer_cache_.end()) {
-    return false;
-  }
+  return DrawEntry(layer_cache_, cache_key, canvas, paint);
+}
 
-  Entry& entry = it->second;
-  entry.access_count++;
-  entry.used_this_frame = true;
+bool RasterCache::DrawShadow(uint64_t shadow_id, SkCanvas& canvas) const {
+  ShadowRasterCacheKey cache_key(shadow_id, canvas.getTotalMatrix());
+  return DrawEntry(shadow_cache_, cache_key, canvas, nullptr);
+}
 
-  if (entry.image) {
-    entry.image->draw(canvas, paint);
-    return true;
+bool RasterCache::GetScaleWithinTolerance(const SkMatrix& from,
+                                          const SkMatrix& to,
+                                          SkVector* scale) const {
+  if (!from.isScaleTranslate() || !to.isScaleTranslate() ||
+      from.getScaleX() <= 0 || from.getScaleY() <= 0 ||
+      to.getScaleX() <= 0 || to.getScaleY() <= 0) {
+    return false;
   }
-
-  return false;
+  SkVector result = SkVector::Make(to.getScaleX() / from.getScaleX(),
+                                   to.getScaleY() / from.getScaleY());
+  const SkScalar max_scale = 1 + scale_tolerance_;
+  auto within_tolerance = [max_scale](SkScalar value) {
+    return value <= max_scale && value * max_scale >= 1;
+  };
+  if (!within_tolerance(result.fX) || !within_tolerance(result.fY)) {
+    return false;
+  }
+  *scale = result;
+  return true;
 }
 
 void RasterCache::SweepAfterFrame() {
-  SweepOneCacheAfterFrame(picture_cache_);
-  SweepOneCacheAfterFrame(layer_cache_);
+  SweepOneCacheAfterFrame(picture_cache_, max_unused_frames_);
+  SweepOneCacheAfterFrame(layer_cache_, max_unused_frames_);
+  SweepOneCacheAfterFrame(shadow_cache_, max_unused_frames_);
+  EvictToMaxBytes();
+  // Forget about queued pictures whose entries did not survive the sweep.
+  pending_pictures_.erase(
+      std::remove_if(pending_pictures_.begin(), pending_pictures_.end(),
+                     [this](const PendingPicture& pending) {
+                       return picture_cache_.find(pending.key) ==
+                              picture_cache_.end();
+                     }),
+      pending_pictures_.end());
   picture_cached_this_frame_ = 0;
+  UpdateMemoryCharge();
   TraceStatsToTimeline();
+  stats_ = {};
+}
+
+void RasterCache::PurgeUnusedEntries() {
+  // Entries are marked as unused when a frame ends, so anything used in the
+  // last completed frame has no unused frames recorded yet.
+  auto purge = [](auto& cache) {
+    for (auto it = cache.begin(); it != cache.end();) {
+      if (it->second.unused_frames > 0) {
+        it = cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  };
+  purge(picture_cache_);
+  purge(layer_cache_);
+  purge(shadow_cache_);
+  UpdateMemoryCharge();
+}
+
+void RasterCache::EvictToMaxBytes() {
+  if (max_bytes_ == 0) {
+    return;
+  }
+
+  if (use_cost_model_) {
+    EvictByValueToMaxBytes();
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, int64_t>> ages;
+  CollectEntryAges(picture_cache_, ages);
+  CollectEntryAges(layer_cache_, ages);
+  CollectEntryAges(shadow_cache_, ages);
+
+  size_t total_bytes = 0;
+  for (const auto& age : ages) {
+    total_bytes += age.second;
+  }
+  if (total_bytes <= max_bytes_) {
+    return;
+  }
+
+  // Walk the entries from the least to the most recently used one to find the
+  // newest access stamp that must be evicted to fit in the budget. Stamps are
+  // unique so a single cutoff identifies the exact set of entries to evict.
+  std::sort(ages.begin(), ages.end());
+  uint64_t cutoff = 0;
+  for (const auto& age : ages) {
+    if (total_bytes <= max_bytes_) {
+      break;
+    }
+    total_bytes -= age.second;
+    cutoff = age.first;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCache::EvictToMaxBytes");
+  stats_.evictions += EvictOneCacheUpTo(picture_cache_, cutoff);
+  stats_.evictions += EvictOneCacheUpTo(layer_cache_, cutoff);
+  stats_.evictions += EvictOneCacheUpTo(shadow_cache_, cutoff);
+}
+
+void RasterCache::EvictByValueToMaxBytes() {
+  std::vector<std::tuple<double, uint64_t, int64_t>> values;
+  CollectEntryValues(picture_cache_, values);
+  CollectEntryValues(layer_cache_, values);
+  CollectEntryValues(shadow_cache_, values);
+
+  size_t total_bytes = 0;
+  for (const auto& value : values) {
+    total_bytes += std::get<2>(value);
+  }
+  if (total_bytes <= max_bytes_) {
+    return;
+  }
+
+  // Evict the entries saving the least time per byte first. Among entries of
+  // equal value, the least recently used ones go first.
+  std::sort(values.begin(), values.end());
+  std::vector<uint64_t> evicted_accesses;
+  for (const auto& value : values) {
+    if (total_bytes <= max_bytes_) {
+      break;
+    }
+    total_bytes -= std::get<2>(value);
+    evicted_accesses.push_back(std::get<1>(value));
+  }
+  std::sort(evicted_accesses.begin(), evicted_accesses.end());
+
+  TRACE_EVENT0("flutter", "RasterCache::EvictByValueToMaxBytes");
+  stats_.evictions += EvictOneCache(picture_cache_, evicted_accesses);
+  stats_.evictions += EvictOneCache(layer_cache_, evicted_accesses);
+  stats_.evictions += EvictOneCache(shadow_cache_, evicted_accesses);
+}
+
+bool RasterCache::IsWorthCaching(const Entry& entry,
+                                 const SkIRect& device_bounds) const {
+  const double pixels =
+      static_cast<double>(device_bounds.width()) * device_bounds.height();
+  const double draw_cost = GetDrawCost(entry);
+  const double savings = draw_cost - GetImageDrawCost(pixels);
+  if (savings <= 0) {
+    // Drawing the image would not be cheaper than drawing the picture.
+    return false;
+  }
+  // Rasterizing costs about as much as drawing the picture once, plus
+  // allocating and clearing the image.
+  const double populate_cost =
+      draw_cost + pixels * kBytesPerPixel * kPopulateCostPerByte * cost_scale_;
+  // The accesses so far are the best predictor of the accesses to come.
+  return entry.access_count * savings >= populate_cost;
+}
+
+void RasterCache::PopulatePictureEntry(Entry& entry,
+                                       PictureSource source,
+                                       GrContext* context,
+                                       const SkMatrix& matrix,
+                                       SkColorSpace* dst_color_space) {
+  const fml::TimePoint start = fml::TimePoint::Now();
+  if (source.display_list) {
+    entry.image = RasterizeDisplayList(source.display_list, context, matrix,
+                                       dst_color_space, checkerboard_images_);
+  } else {
+    entry.image = RasterizePicture(source.picture, context, matrix,
+                                   dst_color_space, checkerboard_images_);
+  }
+  LearnRasterizeCost(entry, fml::TimePoint::Now() - start);
+}
+
+void RasterCache::PopulateLayerEntry(Entry& entry,
+                                     PrerollContext* context,
+                                     Layer* layer,
+                                     const SkMatrix& matrix) {
+  const fml::TimePoint start = fml::TimePoint::Now();
+  entry.image = RasterizeLayer(context, layer, matrix, checkerboard_images_);
+  LearnRasterizeCost(entry, fml::TimePoint::Now() - start);
+}
+
+void RasterCache::PopulateShadowEntry(
+    Entry& entry,
+    GrContext* context,
+    const SkRect& bounds,
+    const SkMatrix& matrix,
+    SkColorSpace* dst_color_space,
+    const std::function<void(SkCanvas*)>& draw_shadow) {
+  const fml::TimePoint start = fml::TimePoint::Now();
+  entry.image = RasterizeShadow(context, bounds, matrix, dst_color_space,
+                                checkerboard_images_, draw_shadow);
+  LearnRasterizeCost(entry, fml::TimePoint::Now() - start);
+}
+
+void RasterCache::LearnRasterizeCost(Entry& entry, fml::TimeDelta duration) {
+  if (!use_cost_model_ || !entry.image) {
+    return;
+  }
+  const double measured = duration.ToMicrosecondsF();
+  if (measured <= 0) {
+    return;
+  }
+  if (entry.estimated_cost > 0) {
+    // An exponential moving average of the ratio between the measured and the
+    // estimated cost, clamped so that a single outlier, e.g. a frame that was
+    // descheduled, cannot throw the model off.
+    const double ratio = std::clamp(measured / entry.estimated_cost,
+                                    kMinCostScale, kMaxCostScale);
+    cost_scale_ += kCostScaleLearningRate * (ratio - cost_scale_);
+  }
+  entry.measured_cost = measured;
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
   layer_cache_.clear();
+  shadow_cache_.clear();
+  pending_pictures_.clear();
+  if (atlas_) {
+    atlas_->Clear();
+  }
+  UpdateMemoryCharge();
+}
+
+void RasterCache::SetAtlasMaxEntrySize(int max_entry_size) {
+  if (max_entry_size <= 0) {
+    atlas_.reset();
+    return;
+  }
+  atlas_ = std::make_unique<RasterCacheAtlas>(
+      RasterCacheAtlas::kDefaultPageSize,
+      std::min(max_entry_size, RasterCacheAtlas::kDefaultPageSize));
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
-  return layer_cache_.size() + picture_cache_.size();
+  return layer_cache_.size() + picture_cache_.size() + shadow_cache_.size();
 }
 
 size_t RasterCache::GetLayerCachedEntriesCount() const {
@@ -284,6 +785,34 @@ size_t RasterCache::GetPictureCachedEntriesCount() const {
   return picture_cache_.size();
 }
 
+size_t RasterCache::GetShadowCachedEntriesCount() const {
+  return shadow_cache_.size();
+}
+
+size_t RasterCache::GetCachedBytes() const {
+  size_t bytes = 0;
+  for (const auto& item : layer_cache_) {
+    if (item.second.image) {
+      bytes += item.second.image->image_bytes();
+    }
+  }
+  for (const auto& item : picture_cache_) {
+    if (item.second.image) {
+      bytes += item.second.image->image_bytes();
+    }
+  }
+  for (const auto& item : shadow_cache_) {
+    if (item.second.image) {
+      bytes += item.second.image->image_bytes();
+    }
+  }
+  return bytes;
+}
+
+void RasterCache::UpdateMemoryCharge() {
+  memory_charge_.Update(static_cast<int64_t>(GetCachedBytes()));
+}
+
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   if (checkerboard_images_ == checkerboard) {
     return;
@@ -303,6 +832,8 @@ void RasterCache::TraceStatsToTimeline() const {
   size_t layer_cache_bytes = 0;
   size_t picture_cache_count = 0;
   size_t picture_cache_bytes = 0;
+  size_t shadow_cache_count = 0;
+  size_t shadow_cache_bytes = 0;
 
   for (const auto& item : layer_cache_) {
     layer_cache_count++;
@@ -318,12 +849,28 @@ void RasterCache::TraceStatsToTimeline() const {
     }
   }
 
+  for (const auto& item : shadow_cache_) {
+    shadow_cache_count++;
+    if (item.second.image) {
+      shadow_cache_bytes += item.second.image->image_bytes();
+    }
+  }
+
   FML_TRACE_COUNTER("flutter", "RasterCache",
-                    reinterpret_cast<int64_t>(this),             //
-                    "LayerCount", layer_cache_count,             //
-                    "LayerMBytes", layer_cache_bytes * 1e-6,     //
-                    "PictureCount", picture_cache_count,         //
-                    "PictureMBytes", picture_cache_bytes * 1e-6  //
+                    reinterpret_cast<int64_t>(this),              //
+                    "LayerCount", layer_cache_count,              //
+                    "LayerMBytes", layer_cache_bytes * 1e-6,      //
+                    "PictureCount", picture_cache_count,          //
+                    "PictureMBytes", picture_cache_bytes * 1e-6,  //
+                    "ShadowCount", shadow_cache_count,            //
+                    "ShadowMBytes", shadow_cache_bytes * 1e-6     //
+  );
+
+  FML_TRACE_COUNTER("flutter", "RasterCacheStats",
+                    reinterpret_cast<int64_t>(this),  //
+                    "Hits", stats_.hits,              //
+                    "Misses", stats_.misses,          //
+                    "Evictions", stats_.evictions     //
   );
 
 #endif  // !FLUTTER_RELEASE
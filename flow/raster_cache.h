@@ -5,13 +5,26 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <memory>
-#include <unordered_map>
-
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "flutter/flow/display_list.h"
+#include "flutter/flow/picture_cost.h"
+#include "flutter/flow/raster_cache_atlas.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkSize.h"
 
 namespace flutter {
@@ -24,6 +37,13 @@ class RasterCacheResult {
 
   virtual void draw(SkCanvas& canvas, const SkPaint* paint = nullptr) const;
 
+  // Draws the image stretched by |scale| relative to the size it was
+  // rasterized at, for reusing it while the matrix it is drawn with is being
+  // scaled. The image is filtered, so the result is slightly blurry.
+  virtual void drawScaled(SkCanvas& canvas,
+                          const SkVector& scale,
+                          const SkPaint* paint = nullptr) const;
+
   virtual SkISize image_dimensions() const {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
@@ -49,9 +69,14 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default maximum number of bytes that may be held by the images of the
+  // picture, layer and shadow caches combined. Zero means no limit.
+  static constexpr size_t kDefaultMaxBytes = 0;
+
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t max_bytes = kDefaultMaxBytes);
 
   virtual ~RasterCache() = default;
 
@@ -77,6 +102,28 @@ class RasterCache {
       SkColorSpace* dst_color_space,
       bool checkerboard) const;
 
+  /**
+   * @brief Rasterize a display list and produce a RasterCacheResult
+   * to be stored in the cache.
+   *
+   * @param display_list the DisplayList to be cached.
+   * @param context the GrContext used for rendering.
+   * @param ctm the transformation matrix used for rendering.
+   * @param dst_color_space the destination color space that the cached
+   *        rendering will be drawn into
+   * @param checkerboard a flag indicating whether or not a checkerboard
+   *        pattern should be rendered into the cached image for debug
+   *        analysis
+   * @return a RasterCacheResult that can draw the rendered display list
+   *         into the destination using a simple image blit
+   */
+  virtual std::unique_ptr<RasterCacheResult> RasterizeDisplayList(
+      DisplayList* display_list,
+      GrContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const;
+
   /**
    * @brief Rasterize an engine Layer and produce a RasterCacheResult
    * to be stored in the cache.
@@ -97,6 +144,31 @@ class RasterCache {
       const SkMatrix& ctm,
       bool checkerboard) const;
 
+  /**
+   * @brief Rasterize a shadow and produce a RasterCacheResult
+   * to be stored in the cache.
+   *
+   * @param context the GrContext used for rendering.
+   * @param bounds the bounds of the shadow.
+   * @param ctm the transformation matrix used for rendering.
+   * @param dst_color_space the destination color space that the cached
+   *        rendering will be drawn into
+   * @param checkerboard a flag indicating whether or not a checkerboard
+   *        pattern should be rendered into the cached image for debug
+   *        analysis
+   * @param draw_shadow the function drawing the shadow into the canvas of
+   *        the cached image.
+   * @return a RasterCacheResult that can draw the rendered shadow into
+   *         the destination using a simple image blit
+   */
+  virtual std::unique_ptr<RasterCacheResult> RasterizeShadow(
+      GrContext* context,
+      const SkRect& bounds,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard,
+      const std::function<void(SkCanvas*)>& draw_shadow) const;
+
   static SkIRect GetDeviceBounds(const SkRect& rect, const SkMatrix& ctm) {
     SkRect device_rect;
     ctm.mapRect(&device_rect, rect);
@@ -134,6 +206,10 @@ class RasterCache {
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
   //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 5. Population is deferred (see SetDeferPopulation) and the picture has
+  //    been queued for rasterization after the frame instead.
+  // 6. With the cost model (see SetUseCostModel), the picture has not been
+  //    accessed often enough yet for the cache to pay for itself.
   bool Prepare(GrContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -141,12 +217,53 @@ class RasterCache {
                bool is_complex,
                bool will_change);
 
+  // Like the above for a display list, whose cost the cost model reads from
+  // the display list instead of analyzing its ops.
+  bool Prepare(GrContext* context,
+               DisplayList* display_list,
+               const SkMatrix& transformation_matrix,
+               SkColorSpace* dst_color_space,
+               bool is_complex,
+               bool will_change);
+
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
+  // Rasterizes the shadow drawn by |draw_shadow| within |bounds| with |ctm|
+  // once the shadow identified by |shadow_id| was drawn with that matrix in
+  // the access threshold number of frames. Shadows count against the limit of
+  // pictures cached per frame and the byte budget like pictures do, and are
+  // never deferred. Returns true if the shadow is cached. Does nothing unless
+  // shadow caching is enabled, see SetCacheShadows.
+  bool PrepareShadow(GrContext* context,
+                     uint64_t shadow_id,
+                     const SkRect& bounds,
+                     const SkMatrix& ctm,
+                     SkColorSpace* dst_color_space,
+                     std::function<void(SkCanvas*)> draw_shadow);
+
+  // Brackets a preroll during which the |Prepare| methods may be called from
+  // several threads at once. In between, they only record the accesses and
+  // queue the images to create, which |EndConcurrentPreroll| then rasterizes
+  // on the calling thread with the resources of |context|. Both calls must be
+  // made from the raster thread.
+  void BeginConcurrentPreroll();
+
+  void EndConcurrentPreroll(PrerollContext* context);
+
   // Find the raster cache for the picture and draw it to the canvas.
   //
+  // Addional paint can be given to change how the raster cache is drawn (e.g.,
+  // draw the raster cache with some opacity).
+  //
   // Return true if it's found and drawn.
-  bool Draw(const SkPicture& picture, SkCanvas& canvas) const;
+  bool Draw(const SkPicture& picture,
+            SkCanvas& canvas,
+            const SkPaint* paint = nullptr) const;
+
+  // Find the raster cache for the display list and draw it to the canvas.
+  bool Draw(const DisplayList& display_list,
+            SkCanvas& canvas,
+            const SkPaint* paint = nullptr) const;
 
   // Find the raster cache for the layer and draw it to the canvas.
   //
@@ -158,51 +275,460 @@ class RasterCache {
             SkCanvas& canvas,
             SkPaint* paint = nullptr) const;
 
+  // Find the raster cache for the shadow and draw it to the canvas.
+  //
+  // Return true if the shadow raster cache is found and drawn.
+  bool DrawShadow(uint64_t shadow_id, SkCanvas& canvas) const;
+
+  // Removes the entries that have not been used for more than the allowed
+  // number of consecutive frames and, if the cache is over its byte budget,
+  // evicts the least recently used images until it fits again.
   void SweepAfterFrame();
 
+  // Removes all entries that were not used in the most recently completed
+  // frame, regardless of the number of unused frames they may otherwise be
+  // retained for. Used to respond to memory pressure.
+  void PurgeUnusedEntries();
+
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  // Sets the maximum number of bytes the images in the picture, layer and
+  // shadow caches may hold combined. A value of zero disables the limit. The
+  // new budget is enforced at the end of the next frame.
+  void SetMaxBytes(size_t max_bytes) { max_bytes_ = max_bytes; }
+
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  // Sets the number of consecutive frames an entry may go unused before it is
+  // swept. With the default of zero, entries are swept as soon as a frame does
+  // not use them. Retaining entries longer avoids re-rasterizing content that
+  // is briefly hidden, e.g. during route transitions or while scrolling.
+  void SetMaxUnusedFrames(size_t max_unused_frames) {
+    max_unused_frames_ = max_unused_frames;
+  }
+
+  size_t GetMaxUnusedFrames() const { return max_unused_frames_; }
+
+  // When enabled, pictures that become worth caching are not rasterized during
+  // Preroll. They are drawn directly in the current frame and queued instead,
+  // to be rasterized by |RasterizePendingEntries| once the frame has been
+  // submitted. Subsequent frames use the cached image once it is ready. Layers
+  // are always cached synchronously as they cannot outlive their layer tree.
+  void SetDeferPopulation(bool defer_population) {
+    defer_population_ = defer_population;
+    if (!defer_population_) {
+      pending_pictures_.clear();
+    }
+  }
+
+  bool GetDeferPopulation() const { return defer_population_; }
+
+  // Rasterizes the pictures queued while population is deferred, until the
+  // queue is empty or |deadline| is reached. Returns the number of cache
+  // entries populated.
+  size_t RasterizePendingEntries(GrContext* context, fml::TimePoint deadline);
+
+  size_t GetPendingEntriesCount() const { return pending_pictures_.size(); }
+
+  // Packs entries whose device width and height are both at most
+  // |max_entry_size| into shared atlas textures instead of giving each of them
+  // a texture of its own. A value of zero or less disables the atlas.
+  void SetAtlasMaxEntrySize(int max_entry_size);
+
+  const RasterCacheAtlas* GetAtlas() const { return atlas_.get(); }
+
+  // Lets an entry rasterized with a matrix that only differs in scale by at
+  // most a factor of 1 + |tolerance| along each axis stand in for a missing
+  // entry, drawn stretched to the new scale. A new entry at the exact scale is
+  // only rasterized once that scale has been kept for the access threshold
+  // number of frames, so pinch-zooms and scale animations reuse the images
+  // they started with until they settle. A value of zero or less disables the
+  // reuse. Only positive scales without rotation or skew are matched.
+  void SetScaleTolerance(SkScalar tolerance) { scale_tolerance_ = tolerance; }
+
+  SkScalar GetScaleTolerance() const { return scale_tolerance_; }
+
+  // When enabled, pictures are admitted by a cost model instead of the access
+  // threshold: the ops of each picture are analyzed with PictureCost, and it
+  // is cached once it was accessed often enough for the time saved by drawing
+  // the cached image instead of the picture to pay for rasterizing it and for
+  // the memory it takes. Pictures flagged as complex still use the threshold.
+  // The estimates are calibrated against the time rasterizing entries actually
+  // takes, and when over the byte budget, the entries saving the least time per
+  // byte are evicted first instead of the least recently used ones.
+  void SetUseCostModel(bool use_cost_model) {
+    use_cost_model_ = use_cost_model;
+  }
+
+  bool GetUseCostModel() const { return use_cost_model_; }
+
+  // When enabled, the shadows of physical shape layers are cached as images,
+  // keyed by everything they are drawn with, so that identical shadows, e.g.
+  // those of the cards of a list, are only blurred once instead of every
+  // frame. Disabling it drops the cached shadows.
+  void SetCacheShadows(bool cache_shadows) {
+    cache_shadows_ = cache_shadows;
+    if (!cache_shadows_) {
+      shadow_cache_.clear();
+    }
+  }
+
+  bool GetCacheShadows() const { return cache_shadows_; }
+
+  // The factor the cost model currently scales the estimates of PictureCost by
+  // to match the measured rasterization times.
+  double GetCostScale() const { return cost_scale_; }
+
   size_t GetCachedEntriesCount() const;
 
   size_t GetLayerCachedEntriesCount() const;
 
   size_t GetPictureCachedEntriesCount() const;
 
+  size_t GetShadowCachedEntriesCount() const;
+
+  // The number of bytes currently held by the images of all caches.
+  size_t GetCachedBytes() const;
+
+  // The number of times the current frame drew a cached image so far, and the
+  // number of times it looked for one that was not cached.
+  size_t GetFrameHitCount() const { return stats_.hits; }
+  size_t GetFrameMissCount() const { return stats_.misses; }
+
  private:
   struct Entry {
     bool used_this_frame = false;
+    // The number of consecutive completed frames this entry was not used in.
+    size_t unused_frames = 0;
     size_t access_count = 0;
+    // A monotonically increasing stamp of the last access to this entry. Used
+    // to pick the least recently used entries when over the byte budget.
+    uint64_t last_access = 0;
+    // Whether this entry is waiting in the deferred population queue.
+    bool pending = false;
+    // Used by the cost model. The estimated cost of drawing the picture of
+    // this entry directly, in the uncalibrated units of PictureCost, or a
+    // negative value if it has not been analyzed.
+    double estimated_cost = -1;
+    // The time rasterizing the image of this entry took in microseconds, or
+    // zero if it was not measured.
+    double measured_cost = 0;
     std::unique_ptr<RasterCacheResult> image;
   };
 
-  template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
-    std::vector<typename Cache::iterator> dead;
+  // What a picture cache entry is rasterized from: either a picture or a
+  // display list.
+  struct PictureSource {
+    explicit PictureSource(SkPicture* picture) : picture(picture) {}
+    explicit PictureSource(DisplayList* display_list)
+        : display_list(display_list) {}
+
+    SkPicture* picture = nullptr;
+    DisplayList* display_list = nullptr;
+
+    bool is_null() const { return !picture && !display_list; }
+    uint64_t unique_id() const;
+    SkRect cull_rect() const;
+    int op_count() const;
+  };
+
+  struct PendingPicture {
+    PictureRasterCacheKey key;
+    // One of the two is set.
+    sk_sp<SkPicture> picture;
+    sk_sp<DisplayList> display_list;
+    SkMatrix matrix;
+    sk_sp<SkColorSpace> dst_color_space;
+
+    PictureSource source() const {
+      return picture ? PictureSource(picture.get())
+                     : PictureSource(display_list.get());
+    }
+  };
 
-    for (auto it = cache.begin(); it != cache.end(); ++it) {
+  // Per frame counters reported to the timeline.
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  template <class Cache>
+  static void SweepOneCacheAfterFrame(Cache& cache, size_t max_unused_frames) {
+    for (auto it = cache.begin(); it != cache.end();) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
-        dead.push_back(it);
+      if (entry.used_this_frame) {
+        entry.unused_frames = 0;
+      } else if (++entry.unused_frames > max_unused_frames) {
+        it = cache.erase(it);
+        continue;
       }
       entry.used_this_frame = false;
+      ++it;
+    }
+  }
+
+  // Collects the value in microseconds saved per byte by drawing each image
+  // instead of its content, the last access and the size of the entries with
+  // an image, for the cost model.
+  template <class Cache>
+  void CollectEntryValues(
+      const Cache& cache,
+      std::vector<std::tuple<double, uint64_t, int64_t>>& values) const {
+    for (const auto& item : cache) {
+      const Entry& entry = item.second;
+      if (!entry.image) {
+        continue;
+      }
+      const int64_t bytes = entry.image->image_bytes();
+      const double savings =
+          GetDrawCost(entry) -
+          GetImageDrawCost(entry.image->image_dimensions().area());
+      // Entries that went unused are less likely to save anything soon.
+      const double value = std::max(savings, 0.0) /
+                           std::max<int64_t>(bytes, 1) /
+                           (1 + entry.unused_frames);
+      values.emplace_back(value, entry.last_access, bytes);
+    }
+  }
+
+  // Erases all entries with an image whose last access is in the sorted
+  // |last_accesses|. Returns the number of erased entries.
+  template <class Cache>
+  static size_t EvictOneCache(Cache& cache,
+                              const std::vector<uint64_t>& last_accesses) {
+    size_t evicted = 0;
+    for (auto it = cache.begin(); it != cache.end();) {
+      if (it->second.image &&
+          std::binary_search(last_accesses.begin(), last_accesses.end(),
+                             it->second.last_access)) {
+        it = cache.erase(it);
+        evicted++;
+      } else {
+        ++it;
+      }
+    }
+    return evicted;
+  }
+
+  template <class Cache>
+  static void CollectEntryAges(
+      const Cache& cache,
+      std::vector<std::pair<uint64_t, int64_t>>& ages) {
+    for (const auto& item : cache) {
+      if (item.second.image) {
+        ages.emplace_back(item.second.last_access,
+                          item.second.image->image_bytes());
+      }
+    }
+  }
+
+  // Erases all entries with an image that were last accessed at or before
+  // |last_access|. Returns the number of erased entries.
+  template <class Cache>
+  static size_t EvictOneCacheUpTo(Cache& cache, uint64_t last_access) {
+    size_t evicted = 0;
+    for (auto it = cache.begin(); it != cache.end();) {
+      if (it->second.image && it->second.last_access <= last_access) {
+        it = cache.erase(it);
+        evicted++;
+      } else {
+        ++it;
+      }
+    }
+    return evicted;
+  }
+
+  // Finds the entry with an image for the same ID as |key| whose matrix is the
+  // closest to that of |key| within the scale tolerance, and sets |scale| to
+  // the scale from the matrix of the entry to that of |key|. Returns nullptr
+  // if there is none. The entry moves when an entry is inserted into |cache|.
+  template <class Cache>
+  typename Cache::value_type* FindScaledEntry(
+      Cache& cache,
+      const typename Cache::key_type& key,
+      SkVector* scale) const {
+    if (scale_tolerance_ <= 0) {
+      return nullptr;
+    }
+    // Keys only hash their ID, so all the entries for it hash alike.
+    typename Cache::value_type* closest = nullptr;
+    SkScalar closest_error = 0;
+    cache.ForEachWithHashOf(key, [&](typename Cache::value_type& item) {
+      SkVector entry_scale;
+      if (item.first.id() != key.id() || !item.second.image ||
+          !GetScaleWithinTolerance(item.first.matrix(), key.matrix(),
+                                   &entry_scale)) {
+        return;
+      }
+      SkScalar error = std::max(std::abs(entry_scale.fX - 1),
+                                std::abs(entry_scale.fY - 1));
+      if (!closest || error < closest_error) {
+        closest = &item;
+        closest_error = error;
+        *scale = entry_scale;
+      }
+    });
+    return closest;
+  }
+
+  // Finds the entry for |key|, or one that can stand in for it at a different
+  // scale, and draws it. Returns true if an image was drawn. May be called
+  // from several threads at once while a frame is painted concurrently.
+  template <class Cache>
+  bool DrawEntry(Cache& cache,
+                 const typename Cache::key_type& key,
+                 SkCanvas& canvas,
+                 const SkPaint* paint) const {
+    const RasterCacheResult* image = nullptr;
+    SkVector scale = SkVector::Make(1, 1);
+    bool scaled = false;
+    {
+      std::scoped_lock lock(prepare_mutex_);
+      auto it = cache.find(key);
+      if (it != cache.end()) {
+        Entry& entry = it->second;
+        entry.access_count++;
+        Touch(entry);
+        image = entry.image.get();
+      }
+      if (!image) {
+        if (auto* scaled_entry = FindScaledEntry(cache, key, &scale)) {
+          Touch(scaled_entry->second);
+          image = scaled_entry->second.image.get();
+          scaled = true;
+        }
+      }
+      if (image) {
+        stats_.hits++;
+      } else {
+        stats_.misses++;
+      }
     }
 
-    for (auto it : dead) {
-      cache.erase(it);
+    // The images are only removed at the end of the frame.
+    if (!image) {
+      return false;
     }
+    if (scaled) {
+      image->drawScaled(canvas, scale, paint);
+    } else {
+      image->draw(canvas, paint);
+    }
+    return true;
+  }
+
+  // Returns whether |to| only differs from |from| by a positive scale within
+  // the scale tolerance, and if so sets |scale| to that scale.
+  bool GetScaleWithinTolerance(const SkMatrix& from,
+                               const SkMatrix& to,
+                               SkVector* scale) const;
+
+  struct QueuedLayer {
+    LayerRasterCacheKey key;
+    Layer* layer;
+    SkMatrix matrix;
+  };
+
+  struct QueuedShadow {
+    ShadowRasterCacheKey key;
+    SkRect bounds;
+    SkMatrix matrix;
+    sk_sp<SkColorSpace> dst_color_space;
+    std::function<void(SkCanvas*)> draw_shadow;
+  };
+
+  void Touch(Entry& entry) const {
+    entry.used_this_frame = true;
+    entry.last_access = ++access_clock_;
   }
 
+  void EvictToMaxBytes();
+
+  void EvictByValueToMaxBytes();
+
+  // The cost model's estimate in microseconds of drawing the content of
+  // |entry| directly.
+  double GetDrawCost(const Entry& entry) const {
+    return entry.measured_cost > 0
+               ? entry.measured_cost
+               : std::max(entry.estimated_cost, 0.0) * cost_scale_;
+  }
+
+  // The cost model's estimate in microseconds of drawing a cached image of
+  // |pixels| device pixels.
+  double GetImageDrawCost(double pixels) const {
+    return PictureCost::EstimateImageDraw(pixels) * cost_scale_;
+  }
+
+  // Whether the cost model expects caching the picture of |entry| to pay off.
+  bool IsWorthCaching(const Entry& entry, const SkIRect& device_bounds) const;
+
+  // Rasterizes the picture or layer into |entry|, measuring the time it takes
+  // for the cost model.
+  bool PreparePicture(GrContext* context,
+                      PictureSource source,
+                      const SkMatrix& transformation_matrix,
+                      SkColorSpace* dst_color_space,
+                      bool is_complex,
+                      bool will_change);
+
+  void PopulatePictureEntry(Entry& entry,
+                            PictureSource source,
+                            GrContext* context,
+                            const SkMatrix& matrix,
+                            SkColorSpace* dst_color_space);
+
+  void PopulateLayerEntry(Entry& entry,
+                          PrerollContext* context,
+                          Layer* layer,
+                          const SkMatrix& matrix);
+
+  void PopulateShadowEntry(Entry& entry,
+                           GrContext* context,
+                           const SkRect& bounds,
+                           const SkMatrix& matrix,
+                           SkColorSpace* dst_color_space,
+                           const std::function<void(SkCanvas*)>& draw_shadow);
+
+  // Records that rasterizing |entry| took |duration| and calibrates the
+  // estimates of the cost model with it.
+  void LearnRasterizeCost(Entry& entry, fml::TimeDelta duration);
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
+  size_t max_bytes_;
+  size_t max_unused_frames_ = 0;
+  SkScalar scale_tolerance_ = 0;
+  bool use_cost_model_ = false;
+  double cost_scale_ = 1.0;
+  bool defer_population_ = false;
+  bool cache_shadows_ = false;
+  std::unique_ptr<RasterCacheAtlas> atlas_;
+  std::vector<PendingPicture> pending_pictures_;
+  // Guards the state touched by the Prepare methods during a concurrent
+  // preroll, see BeginConcurrentPreroll, and by the Draw methods.
+  mutable std::mutex prepare_mutex_;
+  bool concurrent_preroll_ = false;
+  std::vector<PendingPicture> queued_pictures_;
+  std::vector<QueuedLayer> queued_layers_;
+  std::vector<QueuedShadow> queued_shadows_;
   size_t picture_cached_this_frame_ = 0;
+  mutable uint64_t access_clock_ = 0;
+  mutable Stats stats_;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  mutable ShadowRasterCacheKey::Map<Entry> shadow_cache_;
   bool checkerboard_images_;
+  // The bytes of the cached images, charged to the "RasterCache" counter.
+  fml::MemoryCharge memory_charge_;
 
   void TraceStatsToTimeline() const;
 
+  void UpdateMemoryCharge();
+
   FML_DISALLOW_COPY_AND_ASSIGN(RasterCache);
 };
 
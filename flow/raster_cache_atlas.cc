@@ -0,0 +1,244 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_atlas.h"
+
+#include <optional>
+
+#include "flutter/flow/raster_cache.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+// Transparent pixels left between entries so that filtering at the edge of one
+// entry never samples its neighbour.
+static constexpr int kEntryPadding = 1;
+
+// A single atlas texture. Entries are packed into horizontal shelves whose
+// height is that of the first entry placed on them.
+class RasterCacheAtlas::Page {
+ public:
+  Page(GrContext* context, sk_sp<SkSurface> surface)
+      : context_(context), surface_(std::move(surface)) {}
+
+  bool IsCompatible(GrContext* context, const SkImageInfo& image_info) const {
+    return context_ == context &&
+           SkColorSpace::Equals(surface_->imageInfo().colorSpace(),
+                                image_info.colorSpace());
+  }
+
+  std::optional<SkIRect> Allocate(const SkISize& size) {
+    const int width = size.width() + kEntryPadding;
+    const int height = size.height() + kEntryPadding;
+    const int page_width = surface_->width();
+    const int page_height = surface_->height();
+
+    for (auto& shelf : shelves_) {
+      if (height <= shelf.height && shelf.x + width <= page_width) {
+        auto slot = SkIRect::MakeXYWH(shelf.x, shelf.y, size.width(),
+                                      size.height());
+        shelf.x += width;
+        live_entries_++;
+        return slot;
+      }
+    }
+
+    if (next_shelf_y_ + height > page_height || width > page_width) {
+      return std::nullopt;
+    }
+
+    shelves_.push_back({next_shelf_y_, height, width});
+    auto slot =
+        SkIRect::MakeXYWH(0, next_shelf_y_, size.width(), size.height());
+    next_shelf_y_ += height;
+    live_entries_++;
+    return slot;
+  }
+
+  void Release() {
+    FML_DCHECK(live_entries_ > 0);
+    if (--live_entries_ == 0) {
+      // The page is empty. Start packing from scratch. The stale pixels are
+      // cleared slot by slot as new entries are drawn.
+      shelves_.clear();
+      next_shelf_y_ = 0;
+    }
+  }
+
+  SkCanvas* BeginDraw() {
+    // Drop the cached snapshot first so that drawing does not force a copy of
+    // the whole page.
+    snapshot_ = nullptr;
+    return surface_->getCanvas();
+  }
+
+  const sk_sp<SkImage>& GetImage() {
+    if (!snapshot_) {
+      snapshot_ = surface_->makeImageSnapshot();
+    }
+    return snapshot_;
+  }
+
+ private:
+  struct Shelf {
+    int y;
+    int height;
+    int x;
+  };
+
+  GrContext* context_;
+  sk_sp<SkSurface> surface_;
+  sk_sp<SkImage> snapshot_;
+  std::vector<Shelf> shelves_;
+  int next_shelf_y_ = 0;
+  size_t live_entries_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Page);
+};
+
+namespace {
+
+class AtlasRasterCacheResult : public RasterCacheResult {
+ public:
+  AtlasRasterCacheResult(std::shared_ptr<RasterCacheAtlas::Page> page,
+                         const SkIRect& slot,
+                         const SkRect& logical_rect,
+                         int bytes_per_pixel)
+      : RasterCacheResult(nullptr, logical_rect),
+        page_(std::move(page)),
+        slot_(slot),
+        logical_rect_(logical_rect),
+        bytes_per_pixel_(bytes_per_pixel) {}
+
+  ~AtlasRasterCacheResult() override { page_->Release(); }
+
+  // |RasterCacheResult|
+  void draw(SkCanvas& canvas, const SkPaint* paint) const override {
+    TRACE_EVENT0("flutter", "AtlasRasterCacheResult::draw");
+    SkAutoCanvasRestore auto_restore(&canvas, true);
+    SkIRect bounds =
+        RasterCache::GetDeviceBounds(logical_rect_, canvas.getTotalMatrix());
+    FML_DCHECK(std::abs(bounds.size().width() - slot_.width()) <= 1 &&
+               std::abs(bounds.size().height() - slot_.height()) <= 1);
+    canvas.resetMatrix();
+    canvas.drawImageRect(
+        page_->GetImage(), slot_,
+        SkRect::MakeXYWH(bounds.fLeft, bounds.fTop, slot_.width(),
+                         slot_.height()),
+        paint, SkCanvas::kStrict_SrcRectConstraint);
+  }
+
+  // |RasterCacheResult|
+  void drawScaled(SkCanvas& canvas,
+                  const SkVector& scale,
+                  const SkPaint* paint) const override {
+    TRACE_EVENT0("flutter", "AtlasRasterCacheResult::drawScaled");
+    SkAutoCanvasRestore auto_restore(&canvas, true);
+    SkIRect bounds =
+        RasterCache::GetDeviceBounds(logical_rect_, canvas.getTotalMatrix());
+    SkPaint filtered_paint = paint ? *paint : SkPaint();
+    filtered_paint.setFilterQuality(kLow_SkFilterQuality);
+    canvas.resetMatrix();
+    canvas.drawImageRect(
+        page_->GetImage(), slot_,
+        SkRect::MakeXYWH(bounds.fLeft, bounds.fTop, slot_.width() * scale.fX,
+                         slot_.height() * scale.fY),
+        &filtered_paint, SkCanvas::kStrict_SrcRectConstraint);
+  }
+
+  // |RasterCacheResult|
+  SkISize image_dimensions() const override { return slot_.size(); }
+
+  // |RasterCacheResult|
+  int64_t image_bytes() const override {
+    return slot_.size().area() * bytes_per_pixel_;
+  }
+
+ private:
+  std::shared_ptr<RasterCacheAtlas::Page> page_;
+  const SkIRect slot_;
+  const SkRect logical_rect_;
+  const int bytes_per_pixel_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AtlasRasterCacheResult);
+};
+
+}  // namespace
+
+RasterCacheAtlas::RasterCacheAtlas(int page_size, int max_entry_size)
+    : page_size_(page_size), max_entry_size_(max_entry_size) {}
+
+RasterCacheAtlas::~RasterCacheAtlas() = default;
+
+bool RasterCacheAtlas::CanPack(const SkISize& size) const {
+  return !size.isEmpty() && size.width() <= max_entry_size_ &&
+         size.height() <= max_entry_size_;
+}
+
+std::unique_ptr<RasterCacheResult> RasterCacheAtlas::Rasterize(
+    GrContext* context,
+    const SkImageInfo& image_info,
+    const SkRect& logical_rect,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  if (!CanPack(image_info.dimensions())) {
+    return nullptr;
+  }
+
+  std::shared_ptr<Page> page;
+  std::optional<SkIRect> slot;
+  for (const auto& candidate : pages_) {
+    if (!candidate->IsCompatible(context, image_info)) {
+      continue;
+    }
+    slot = candidate->Allocate(image_info.dimensions());
+    if (slot) {
+      page = candidate;
+      break;
+    }
+  }
+
+  if (!page) {
+    TRACE_EVENT0("flutter", "RasterCacheAtlas::AddPage");
+    const SkImageInfo page_info =
+        image_info.makeWH(page_size_, page_size_);
+    sk_sp<SkSurface> surface =
+        context
+            ? SkSurface::MakeRenderTarget(context, SkBudgeted::kYes, page_info)
+            : SkSurface::MakeRaster(page_info);
+    if (!surface) {
+      return nullptr;
+    }
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    page = std::make_shared<Page>(context, std::move(surface));
+    slot = page->Allocate(image_info.dimensions());
+    if (!slot) {
+      return nullptr;
+    }
+    pages_.push_back(page);
+  }
+
+  SkCanvas* canvas = page->BeginDraw();
+  {
+    SkAutoCanvasRestore auto_restore(canvas, true);
+    canvas->clipRect(SkRect::Make(*slot));
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->translate(slot->left(), slot->top());
+    draw_function(canvas);
+  }
+
+  return std::make_unique<AtlasRasterCacheResult>(
+      std::move(page), *slot, logical_rect, image_info.bytesPerPixel());
+}
+
+void RasterCacheAtlas::Clear() {
+  pages_.clear();
+}
+
+}  // namespace flutter
@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
+#define FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+class GrContext;
+class SkCanvas;
+
+namespace flutter {
+
+class RasterCacheResult;
+
+// Packs small raster cache entries into shared atlas textures ("pages").
+//
+// Every entry handed out by the atlas keeps its page alive. A page whose
+// entries have all been released is recycled for new entries, and the page
+// texture itself is released once neither the atlas nor any entry refers to
+// it. Entries on the same page are drawn from the same texture, which lets
+// Skia batch consecutive cache draws and avoids one texture allocation per
+// small cached picture or layer.
+class RasterCacheAtlas {
+ public:
+  // The default width and height of an atlas page.
+  static constexpr int kDefaultPageSize = 1024;
+
+  // The default largest width or height of an entry packed into the atlas.
+  static constexpr int kDefaultMaxEntrySize = 128;
+
+  explicit RasterCacheAtlas(int page_size = kDefaultPageSize,
+                            int max_entry_size = kDefaultMaxEntrySize);
+
+  ~RasterCacheAtlas();
+
+  // Whether an entry of the given device size is small enough to be packed.
+  bool CanPack(const SkISize& size) const;
+
+  // Allocates a slot of |image_info|'s dimensions and invokes |draw_function|
+  // with a canvas whose origin maps to the top left of the slot and that is
+  // clipped to it. Returns nullptr if the entry cannot be packed, in which
+  // case the caller should fall back to a dedicated surface.
+  std::unique_ptr<RasterCacheResult> Rasterize(
+      GrContext* context,
+      const SkImageInfo& image_info,
+      const SkRect& logical_rect,
+      const std::function<void(SkCanvas*)>& draw_function);
+
+  // Drops the atlas references to all pages. Pages still referenced by live
+  // entries stay valid until those entries are collected.
+  void Clear();
+
+  size_t GetPageCount() const { return pages_.size(); }
+
+  class Page;
+
+ private:
+  const int page_size_;
+  const int max_entry_size_;
+  std::vector<std::shared_ptr<Page>> pages_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterCacheAtlas);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_ATLAS_H_
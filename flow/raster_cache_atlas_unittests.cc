@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_atlas.h"
+
+#include "flutter/flow/raster_cache.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkPaint.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::unique_ptr<RasterCacheResult> RasterizeRect(RasterCacheAtlas& atlas,
+                                                 int width,
+                                                 int height) {
+  const SkImageInfo info = SkImageInfo::MakeN32Premul(
+      width, height, SkColorSpace::MakeSRGB());
+  return atlas.Rasterize(nullptr, info, SkRect::MakeWH(width, height),
+                         [width, height](SkCanvas* canvas) {
+                           SkPaint paint;
+                           paint.setColor(SK_ColorRED);
+                           canvas->drawRect(SkRect::MakeWH(width, height),
+                                            paint);
+                         });
+}
+
+}  // namespace
+
+TEST(RasterCacheAtlas, RejectsLargeEntries) {
+  RasterCacheAtlas atlas(256, 64);
+  ASSERT_TRUE(atlas.CanPack(SkISize::Make(64, 64)));
+  ASSERT_FALSE(atlas.CanPack(SkISize::Make(65, 10)));
+  ASSERT_FALSE(atlas.CanPack(SkISize::Make(0, 0)));
+  ASSERT_EQ(RasterizeRect(atlas, 65, 10), nullptr);
+  ASSERT_EQ(atlas.GetPageCount(), 0u);
+}
+
+TEST(RasterCacheAtlas, SmallEntriesShareAPage) {
+  RasterCacheAtlas atlas(256, 64);
+  std::vector<std::unique_ptr<RasterCacheResult>> results;
+  for (int i = 0; i < 8; i++) {
+    auto result = RasterizeRect(atlas, 32, 32);
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(result->image_dimensions(), SkISize::Make(32, 32));
+    ASSERT_EQ(result->image_bytes(), 32 * 32 * 4);
+    results.push_back(std::move(result));
+  }
+  ASSERT_EQ(atlas.GetPageCount(), 1u);
+}
+
+TEST(RasterCacheAtlas, FullPagesSpillIntoNewPages) {
+  RasterCacheAtlas atlas(64, 64);
+  auto first = RasterizeRect(atlas, 40, 40);
+  auto second = RasterizeRect(atlas, 40, 40);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(atlas.GetPageCount(), 2u);
+}
+
+TEST(RasterCacheAtlas, EmptyPagesAreRecycled) {
+  RasterCacheAtlas atlas(64, 64);
+  auto first = RasterizeRect(atlas, 40, 40);
+  ASSERT_NE(first, nullptr);
+  first.reset();
+  auto second = RasterizeRect(atlas, 40, 40);
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(atlas.GetPageCount(), 1u);
+}
+
+TEST(RasterCacheAtlas, EntriesCanBeDrawn) {
+  RasterCacheAtlas atlas(256, 64);
+  auto result = RasterizeRect(atlas, 20, 10);
+  ASSERT_NE(result, nullptr);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(40, 40);
+  SkCanvas canvas(bitmap);
+  canvas.clear(SK_ColorTRANSPARENT);
+  canvas.translate(5, 5);
+  result->draw(canvas);
+
+  ASSERT_EQ(bitmap.getColor(10, 10), SK_ColorRED);
+  ASSERT_EQ(bitmap.getColor(30, 30), SK_ColorTRANSPARENT);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -5,8 +5,9 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 #define FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 
-#include <unordered_map>
 #include "flutter/flow/matrix_decomposition.h"
+#include "flutter/fml/flat_hash_map.h"
+#include "flutter/fml/hash.h"
 #include "flutter/fml/logging.h"
 
 namespace flutter {
@@ -22,9 +23,11 @@ class RasterCacheKey {
   ID id() const { return id_; }
   const SkMatrix& matrix() const { return matrix_; }
 
+  // Only hashes the ID, so that the entries for the same ID at different
+  // scales can be found with |FlatHashMap::ForEachWithHashOf|.
   struct Hash {
-    uint32_t operator()(RasterCacheKey const& key) const {
-      return std::hash<ID>()(key.id_);
+    size_t operator()(RasterCacheKey const& key) const {
+      return fml::Hash<ID>()(key.id_);
     }
   };
 
@@ -36,7 +39,7 @@ class RasterCacheKey {
   };
 
   template <class Value>
-  using Map = std::unordered_map<RasterCacheKey, Value, Hash, Equal>;
+  using Map = fml::FlatHashMap<RasterCacheKey, Value, Hash, Equal>;
 
  private:
   ID id_;
@@ -48,14 +51,19 @@ class RasterCacheKey {
   SkMatrix matrix_;
 };
 
-// The ID is the uint32_t picture uniqueID
-using PictureRasterCacheKey = RasterCacheKey<uint32_t>;
+// The ID is the uint32_t picture uniqueID, or the uint64_t display list
+// unique_id, which never collide.
+using PictureRasterCacheKey = RasterCacheKey<uint64_t>;
 
 class Layer;
 
 // The ID is the uint64_t layer unique_id
 using LayerRasterCacheKey = RasterCacheKey<uint64_t>;
 
+// The ID of a shadow cache entry hashes the parameters the shadow is drawn
+// with, see PhysicalShapeLayer.
+using ShadowRasterCacheKey = RasterCacheKey<uint64_t>;
+
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_RASTER_CACHE_KEY_H_
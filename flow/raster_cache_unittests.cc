@@ -6,6 +6,7 @@
 
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -24,6 +25,25 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+sk_sp<SkPicture> GetExpensivePicture() {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 5));
+  for (int i = 0; i < 20; i++) {
+    recorder.getRecordingCanvas()->drawRect(
+        SkRect::MakeXYWH(10 + i, 10, 80, 80), paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+sk_sp<DisplayList> GetExpensiveDisplayList() {
+  DisplayListRecorder recorder(SkRect::MakeWH(150, 100));
+  GetExpensivePicture()->playback(&recorder);
+  return recorder.Finish();
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -132,6 +152,377 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
 }
 
+TEST(RasterCache, EntriesSurviveUpToMaxUnusedFrames) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetMaxUnusedFrames(2);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // Two frames without an access.
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // A third unused frame evicts the entry.
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, PurgeUnusedEntriesIgnoresMaxUnusedFrames) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetMaxUnusedFrames(10);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // Used in the last frame, so it is kept.
+  cache.PurgeUnusedEntries();
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+
+  cache.SweepAfterFrame();
+  cache.PurgeUnusedEntries();
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+}
+
+TEST(RasterCache, MaxBytesEvictsLeastRecentlyUsedEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  // Draw the second picture first so that it is the least recently used one.
+  ASSERT_TRUE(cache.Draw(*picture2, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture1, dummy_canvas));
+
+  // Only leave room for one of the two images.
+  ASSERT_GT(cache.GetCachedBytes(), 0u);
+  cache.SetMaxBytes(cache.GetCachedBytes() / 2);
+  cache.SweepAfterFrame();
+
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  ASSERT_LE(cache.GetCachedBytes(), cache.GetMaxBytes());
+  ASSERT_TRUE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+}
+
+TEST(RasterCache, ShadowsAreOnlyCachedWhenEnabled) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(100, 100);
+  auto draw_shadow = [](SkCanvas* canvas) { canvas->drawColor(SK_ColorBLACK); };
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.PrepareShadow(NULL, 1, bounds, matrix, srgb.get(), draw_shadow));
+  ASSERT_FALSE(cache.DrawShadow(1, dummy_canvas));
+  ASSERT_EQ(cache.GetShadowCachedEntriesCount(), 0u);
+
+  cache.SetCacheShadows(true);
+  ASSERT_FALSE(
+      cache.PrepareShadow(NULL, 1, bounds, matrix, srgb.get(), draw_shadow));
+  ASSERT_FALSE(cache.DrawShadow(1, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.PrepareShadow(NULL, 1, bounds, matrix, srgb.get(), draw_shadow));
+  ASSERT_TRUE(cache.DrawShadow(1, dummy_canvas));
+  ASSERT_FALSE(cache.DrawShadow(2, dummy_canvas));
+  ASSERT_EQ(cache.GetShadowCachedEntriesCount(), 1u);
+  ASSERT_GT(cache.GetCachedBytes(), 0u);
+
+  cache.SetCacheShadows(false);
+  ASSERT_EQ(cache.GetShadowCachedEntriesCount(), 0u);
+  ASSERT_FALSE(cache.DrawShadow(1, dummy_canvas));
+}
+
+TEST(RasterCache, MaxBytesEvictsShadowsWithPictures) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetCacheShadows(true);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect bounds = SkRect::MakeWH(150, 100);
+  auto draw_shadow = [](SkCanvas* canvas) { canvas->drawColor(SK_ColorBLACK); };
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_FALSE(
+      cache.PrepareShadow(NULL, 1, bounds, matrix, srgb.get(), draw_shadow));
+  ASSERT_FALSE(cache.DrawShadow(1, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(
+      cache.PrepareShadow(NULL, 1, bounds, matrix, srgb.get(), draw_shadow));
+  // Draw the shadow first so that it is the least recently used entry.
+  ASSERT_TRUE(cache.DrawShadow(1, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  // Only leave room for one of the two images.
+  cache.SetMaxBytes(cache.GetCachedBytes() / 2);
+  cache.SweepAfterFrame();
+
+  ASSERT_EQ(cache.GetShadowCachedEntriesCount(), 0u);
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, DeferredPopulationRasterizesAfterTheFrame) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetDeferPopulation(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // The picture is worth caching now but only queued.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 1u);
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  // No idle time left.
+  ASSERT_EQ(cache.RasterizePendingEntries(nullptr, fml::TimePoint::Now()), 0u);
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 1u);
+
+  ASSERT_EQ(cache.RasterizePendingEntries(nullptr, fml::TimePoint::Max()), 1u);
+  ASSERT_EQ(cache.GetPendingEntriesCount(), 0u);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, ScaledEntryIsReusedUntilTheScaleSettles) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetScaleTolerance(0.1f);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkMatrix scaled_matrix = SkMatrix::Scale(1.05f, 1.05f);
+  SkMatrix zoomed_matrix = SkMatrix::Scale(1.5f, 1.5f);
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas canvas(100, 100, nullptr);
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+
+  // A nearby scale draws the existing image instead of rasterizing again.
+  canvas.setMatrix(scaled_matrix);
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), scaled_matrix, srgb.get(),
+                            true, false));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 2u);
+
+  // Once the scale has been kept for the access threshold, it gets an image of
+  // its own and the old one is swept.
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), scaled_matrix, srgb.get(),
+                            true, false));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+
+  // Scales beyond the tolerance are not reused.
+  canvas.setMatrix(zoomed_matrix);
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), zoomed_matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+}
+
+TEST(RasterCache, CostModelSkipsPicturesThatAreCheapToDraw) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUseCostModel(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // A single rect is cheaper to draw than an image of it, however often it is
+  // drawn.
+  for (int i = 0; i < 10; i++) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+    cache.SweepAfterFrame();
+  }
+}
+
+TEST(RasterCache, CostModelCachesPicturesThatAreExpensiveToDraw) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUseCostModel(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetExpensivePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  size_t frames = 0;
+  while (!cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false,
+                        false)) {
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+    cache.SweepAfterFrame();
+    ASSERT_LT(++frames, 10u);
+  }
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_GE(cache.GetCostScale(), 0.05);
+  ASSERT_LE(cache.GetCostScale(), 20.0);
+}
+
+TEST(RasterCache, CostModelEvictsTheEntriesSavingTheLeastFirst) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUseCostModel(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto cheap_picture = GetSamplePicture();
+  auto expensive_picture = GetExpensivePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // Complex pictures bypass the cost model's admission, but their rasterize
+  // times are still measured.
+  for (int i = 0; i < 2; i++) {
+    cache.Prepare(NULL, cheap_picture.get(), matrix, srgb.get(), true, false);
+    cache.Prepare(NULL, expensive_picture.get(), matrix, srgb.get(), true,
+                  false);
+    cache.Draw(*expensive_picture, dummy_canvas);
+    cache.Draw(*cheap_picture, dummy_canvas);
+    cache.SweepAfterFrame();
+  }
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 2u);
+
+  // The cheap picture is the most recently used one but saves the least.
+  cache.SetMaxBytes(cache.GetCachedBytes() / 2);
+  cache.SweepAfterFrame();
+
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  ASSERT_TRUE(cache.Draw(*expensive_picture, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*cheap_picture, dummy_canvas));
+}
+
+TEST(RasterCache, CostModelCachesDisplayListsWithTheirRecordedCost) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUseCostModel(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetExpensiveDisplayList();
+  auto picture = GetExpensivePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  size_t frames = 0;
+  while (!cache.Prepare(NULL, display_list.get(), matrix, srgb.get(), false,
+                        false)) {
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+    cache.SweepAfterFrame();
+    ASSERT_LT(++frames, 10u);
+  }
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+
+  // The entries of pictures and display lists never share a key.
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false);
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 2u);
+}
+
 // Construct a cache result whose device target rectangle rounds out to be one
 // pixel wider than the cached image.  Verify that it can be drawn without
 // triggering any assertions.
@@ -4,7 +4,7 @@
 
 #include "rtree.h"
 
-#include <list>
+#include <algorithm>
 
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkBBHFactory.h"
@@ -18,9 +18,11 @@ void RTree::insert(const SkRect boundsArray[],
                    int N) {
   FML_DCHECK(0 == all_ops_count_);
   bbh_->insert(boundsArray, metadata, N);
-  for (int i = 0; i < N; i++) {
-    if (metadata != nullptr && metadata[i].isDraw) {
-      draw_op_[i] = boundsArray[i];
+  op_bounds_.assign(boundsArray, boundsArray + N);
+  is_draw_op_.assign(N, false);
+  if (metadata != nullptr) {
+    for (int i = 0; i < N; i++) {
+      is_draw_op_[i] = metadata[i].isDraw;
     }
   }
   all_ops_count_ = N;
@@ -34,51 +36,92 @@ void RTree::search(const SkRect& query, std::vector<int>* results) const {
   bbh_->search(query, results);
 }
 
-std::list<SkRect> RTree::searchNonOverlappingDrawnRects(
+namespace {
+
+// Joins the intersecting rects in |rects| until none of them intersect.
+//
+// Each pass sweeps over the rects sorted by their left edge and only compares
+// a rect with the merged rects that are still open at its left edge, so a pass
+// costs O(n log n + n * k) for k overlapping columns rather than O(n^2).
+// Joining grows rects, which can make a merged rect intersect one that was
+// already closed, so passes repeat until one of them joins nothing.
+void JoinIntersectingRects(std::vector<SkRect>* rects) {
+  std::vector<SkRect> open;
+  bool joined = true;
+  while (joined && rects->size() > 1) {
+    joined = false;
+    std::sort(rects->begin(), rects->end(),
+              [](const SkRect& a, const SkRect& b) {
+                return a.fLeft < b.fLeft;
+              });
+    // Closed rects are written back to the front of |rects|. There are never
+    // more of them than rects read so far.
+    size_t closed = 0;
+    open.clear();
+    for (size_t i = 0; i < rects->size(); i++) {
+      SkRect rect = (*rects)[i];
+      // Rects that end before this one starts can't intersect any of the
+      // remaining rects in this pass.
+      for (size_t j = 0; j < open.size();) {
+        if (open[j].fRight <= rect.fLeft) {
+          (*rects)[closed++] = open[j];
+          open[j] = open.back();
+          open.pop_back();
+        } else {
+          j++;
+        }
+      }
+      bool grew = true;
+      while (grew) {
+        grew = false;
+        for (size_t j = 0; j < open.size();) {
+          if (SkRect::Intersects(open[j], rect)) {
+            rect.join(open[j]);
+            open[j] = open.back();
+            open.pop_back();
+            grew = true;
+            joined = true;
+          } else {
+            j++;
+          }
+        }
+      }
+      open.push_back(rect);
+    }
+    std::copy(open.begin(), open.end(), rects->begin() + closed);
+    rects->resize(closed + open.size());
+  }
+  std::sort(rects->begin(), rects->end(),
+            [](const SkRect& a, const SkRect& b) {
+              return a.fLeft < b.fLeft ||
+                     (a.fLeft == b.fLeft && a.fTop < b.fTop);
+            });
+}
+
+}  // namespace
+
+std::vector<SkRect> RTree::searchNonOverlappingDrawnRects(
     const SkRect& query) const {
+  std::vector<SkRect> results;
+  searchNonOverlappingDrawnRects(query, &results);
+  return results;
+}
+
+void RTree::searchNonOverlappingDrawnRects(
+    const SkRect& query,
+    std::vector<SkRect>* results) const {
   // Get the indexes for the operations that intersect with the query rect.
   std::vector<int> intermediary_results;
   search(query, &intermediary_results);
 
-  std::list<SkRect> final_results;
+  results->clear();
   for (int index : intermediary_results) {
-    auto draw_op = draw_op_.find(index);
     // Ignore records that don't draw anything.
-    if (draw_op == draw_op_.end()) {
-      continue;
-    }
-    auto current_record_rect = draw_op->second;
-    auto replaced_existing_rect = false;
-    // // If the current record rect intersects with any of the rects in the
-    // // result list, then join them, and update the rect in final_results.
-    std::list<SkRect>::iterator curr_rect_itr = final_results.begin();
-    std::list<SkRect>::iterator first_intersecting_rect_itr;
-    while (!replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, current_record_rect)) {
-        replaced_existing_rect = true;
-        first_intersecting_rect_itr = curr_rect_itr;
-        curr_rect_itr->join(current_record_rect);
-      }
-      curr_rect_itr++;
-    }
-    // It's possible that the result contains duplicated rects at this point.
-    // For example, consider a result list that contains rects A, B. If a
-    // new rect C is a superset of A and B, then A and B are the same set after
-    // the merge. As a result, find such cases and remove them from the result
-    // list.
-    while (replaced_existing_rect && curr_rect_itr != final_results.end()) {
-      if (SkRect::Intersects(*curr_rect_itr, *first_intersecting_rect_itr)) {
-        first_intersecting_rect_itr->join(*curr_rect_itr);
-        curr_rect_itr = final_results.erase(curr_rect_itr);
-      } else {
-        curr_rect_itr++;
-      }
-    }
-    if (!replaced_existing_rect) {
-      final_results.push_back(current_record_rect);
+    if (is_draw_op_[index]) {
+      results->push_back(op_bounds_[index]);
     }
   }
-  return final_results;
+  JoinIntersectingRects(results);
 }
 
 size_t RTree::bytesUsed() const {
@@ -5,8 +5,7 @@
 #ifndef FLUTTER_FLOW_RTREE_H_
 #define FLUTTER_FLOW_RTREE_H_
 
-#include <list>
-#include <map>
+#include <vector>
 
 #include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkTypes.h"
@@ -34,16 +33,23 @@ class RTree : public SkBBoxHierarchy {
   //
   // When two rects intersect with each other, they are joined into a single
   // rect which also intersects with the query rect. In other words, the bounds
-  // of each rect in the result list are mutually exclusive.
-  std::list<SkRect> searchNonOverlappingDrawnRects(const SkRect& query) const;
+  // of each rect in the result list are mutually exclusive. The results are
+  // sorted by their left edge, then by their top edge.
+  std::vector<SkRect> searchNonOverlappingDrawnRects(const SkRect& query) const;
+
+  // Same as above, but replaces the contents of |results| so that callers
+  // querying every frame can reuse its storage.
+  void searchNonOverlappingDrawnRects(const SkRect& query,
+                                      std::vector<SkRect>* results) const;
 
   // Insertion count (not overall node count, which may be greater).
   int getCount() const { return all_ops_count_; }
 
  private:
-  // A map containing the draw operation rects keyed off the operation index
-  // in the insert call.
-  std::map<int, SkRect> draw_op_;
+  // The bounds of the operations in the insert call, indexed by operation.
+  std::vector<SkRect> op_bounds_;
+  // Whether the operation at the same index in |op_bounds_| draws anything.
+  std::vector<bool> is_draw_op_;
   sk_sp<SkBBoxHierarchy> bbh_;
   int all_ops_count_;
 };
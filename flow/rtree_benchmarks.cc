@@ -0,0 +1,51 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/rtree.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace flutter {
+
+// Records |count| small, mostly disjoint rects laid out on a grid, with every
+// fourth rect overlapping its neighbour so that there is merging to do, like
+// the overlays drawn on top of a platform view.
+static sk_sp<RTree> RecordRects(int count) {
+  RTreeFactory rtree_factory;
+  SkPictureRecorder recorder;
+  SkCanvas* canvas =
+      recorder.beginRecording(SkRect::MakeIWH(4000, 16000), &rtree_factory);
+
+  SkPaint paint;
+  const int columns = 64;
+  for (int i = 0; i < count; i++) {
+    SkScalar left = (i % columns) * 60.0f;
+    SkScalar top = (i / columns) * 60.0f;
+    SkScalar width = i % 4 == 0 ? 70.0f : 40.0f;
+    canvas->drawRect(SkRect::MakeXYWH(left, top, width, 40.0f), paint);
+  }
+  recorder.finishRecordingAsPicture();
+  return rtree_factory.getInstance();
+}
+
+static void BM_RTreeSearchNonOverlappingDrawnRects(benchmark::State& state) {
+  sk_sp<RTree> rtree = RecordRects(state.range(0));
+  const SkRect query = SkRect::MakeIWH(4000, 16000);
+  std::vector<SkRect> results;
+  while (state.KeepRunning()) {
+    rtree->searchNonOverlappingDrawnRects(query, &results);
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_RTreeSearchNonOverlappingDrawnRects)
+    ->RangeMultiplier(4)
+    ->Range(16, 16 << 10)
+    ->Complexity();
+
+}  // namespace flutter
@@ -231,5 +231,72 @@ TEST(RTree, searchNonOverlappingDrawnRects_JoinRectsWhenIntersectedCase3) {
   ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(50, 50, 620, 300));
 }
 
+TEST(RTree, searchNonOverlappingDrawnRects_JoinRectsWhenJoinedRectGrows) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  // Given the A, B and C rects, where only B and C intersect, the union of B
+  // and C intersects with A, so the result list contains a single rect.
+  //
+  // +-----+
+  // |  A  |  +--+
+  // |     |  |  |
+  // +-----+  |C |
+  //    +-----|  |--+
+  //    |  B  |  |  |
+  //    +-----|  |--+
+  //          +--+
+
+  // A
+  recording_canvas->drawRect(SkRect::MakeLTRB(0, 0, 100, 100), rect_paint);
+  // B
+  recording_canvas->drawRect(SkRect::MakeLTRB(50, 200, 200, 300), rect_paint);
+  // C
+  recording_canvas->drawRect(SkRect::MakeLTRB(120, 50, 150, 250), rect_paint);
+
+  recorder->finishRecordingAsPicture();
+
+  auto hits = rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1000));
+  ASSERT_EQ(1UL, hits.size());
+  ASSERT_EQ(*hits.begin(), SkRect::MakeLTRB(0, 0, 200, 300));
+}
+
+TEST(RTree, searchNonOverlappingDrawnRects_ReusesResults) {
+  auto rtree_factory = RTreeFactory();
+  auto recorder = std::make_unique<SkPictureRecorder>();
+  auto recording_canvas =
+      recorder->beginRecording(SkRect::MakeIWH(1000, 1000), &rtree_factory);
+
+  auto rect_paint = SkPaint();
+  rect_paint.setColor(SkColors::kCyan);
+  rect_paint.setStyle(SkPaint::Style::kFill_Style);
+
+  recording_canvas->drawRect(SkRect::MakeLTRB(300, 100, 400, 200), rect_paint);
+  recording_canvas->drawRect(SkRect::MakeLTRB(100, 100, 200, 200), rect_paint);
+
+  recorder->finishRecordingAsPicture();
+
+  // The results replace what the vector contained before and are sorted by
+  // their left edge.
+  std::vector<SkRect> hits = {SkRect::MakeLTRB(0, 0, 10, 10)};
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(0, 0, 1000, 1000), &hits);
+  ASSERT_EQ(2UL, hits.size());
+  ASSERT_EQ(hits[0], SkRect::MakeLTRB(100, 100, 200, 200));
+  ASSERT_EQ(hits[1], SkRect::MakeLTRB(300, 100, 400, 200));
+
+  rtree_factory.getInstance()->searchNonOverlappingDrawnRects(
+      SkRect::MakeLTRB(250, 0, 1000, 1000), &hits);
+  ASSERT_EQ(1UL, hits.size());
+  ASSERT_EQ(hits[0], SkRect::MakeLTRB(300, 100, 400, 200));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,604 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/shader_warm_up.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRSXform.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "third_party/skia/include/core/SkShader.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// The size of the images recorded in place of those of the frames.
+constexpr int kPlaceholderSize = 4;
+
+enum class Op : uint32_t {
+  kPaint,
+  kPoints,
+  kRect,
+  kRegion,
+  kOval,
+  kArc,
+  kRRect,
+  kDRRect,
+  kPath,
+  kTextBlob,
+  kPatch,
+  kVertices,
+  kImage,
+  kImageRect,
+  kImageLattice,
+  kAtlas,
+  kShadow,
+  kEdgeAAQuad,
+  kImageSet,
+  kSaveLayer,
+};
+
+enum class ShaderKind : uint32_t {
+  kNone,
+  kImage,
+  kLinearGradient,
+  kRadialGradient,
+  kSweepGradient,
+  kConicalGradient,
+  kOther,
+};
+
+ShaderKind GetShaderKind(const SkShader* shader) {
+  if (!shader) {
+    return ShaderKind::kNone;
+  }
+  if (shader->isAImage()) {
+    return ShaderKind::kImage;
+  }
+  switch (shader->asAGradient(nullptr)) {
+    case SkShader::kLinear_GradientType:
+      return ShaderKind::kLinearGradient;
+    case SkShader::kRadial_GradientType:
+      return ShaderKind::kRadialGradient;
+    case SkShader::kSweep_GradientType:
+      return ShaderKind::kSweepGradient;
+    case SkShader::kConical_GradientType:
+      return ShaderKind::kConicalGradient;
+    default:
+      return ShaderKind::kOther;
+  }
+}
+
+// Images are told apart by whether they are alpha only or opaque, which
+// changes how their texels are read and blended.
+size_t GetImageClass(const SkImage& image) {
+  if (image.isAlphaOnly()) {
+    return 0;
+  }
+  return image.isOpaque() ? 1 : 2;
+}
+
+// Packs the traits of a draw into a pipeline key, a few bits each.
+class KeyBuilder {
+ public:
+  KeyBuilder& Add(uint32_t value, int bits) {
+    key_ = (key_ << bits) | (value & ((uint64_t{1} << bits) - 1));
+    return *this;
+  }
+
+  KeyBuilder& Add(bool value) { return Add(value ? 1u : 0u, 1); }
+
+  uint64_t key() const { return key_; }
+
+ private:
+  uint64_t key_ = 0;
+};
+
+// |geometry| is a class of the geometry of the op, of up to 3 bits, whose
+// meaning depends on |op|.
+uint64_t MakeKey(Op op,
+                 uint32_t geometry,
+                 const SkPaint* paint,
+                 const SkMatrix& matrix) {
+  const SkPaint default_paint;
+  const SkPaint& traits = paint ? *paint : default_paint;
+  const bool stroked = traits.getStyle() != SkPaint::kFill_Style;
+  return KeyBuilder()
+      .Add(static_cast<uint32_t>(op), 5)
+      .Add(geometry, 3)
+      .Add(traits.getStyle(), 2)
+      .Add(stroked && traits.getStrokeWidth() == 0)
+      .Add(static_cast<uint32_t>(traits.getBlendMode()), 5)
+      .Add(static_cast<uint32_t>(GetShaderKind(traits.getShader())), 3)
+      .Add(traits.getFilterQuality(), 2)
+      .Add(traits.getColorFilter() != nullptr)
+      .Add(traits.getMaskFilter() != nullptr)
+      .Add(traits.getImageFilter() != nullptr)
+      .Add(traits.getPathEffect() != nullptr)
+      .Add(traits.isAntiAlias())
+      .Add(traits.isDither())
+      .Add(matrix.hasPerspective())
+      .Add(matrix.rectStaysRect())
+      .key();
+}
+
+uint32_t GetPathClass(const SkPath& path) {
+  if (path.isInverseFillType()) {
+    return 2;
+  }
+  return path.isConvex() ? 0 : 1;
+}
+
+SkRect PointsBounds(const SkPoint points[], size_t count) {
+  SkRect bounds;
+  bounds.setBounds(points, static_cast<int>(count));
+  return bounds;
+}
+
+}  // namespace
+
+// A canvas that records the ops of new pipeline keys into a
+// ShaderWarmUpRecorder, without drawing them.
+class ShaderWarmUpCanvas final : public SkNoDrawCanvas {
+ public:
+  ShaderWarmUpCanvas(int width, int height, ShaderWarmUpRecorder* recorder)
+      : SkNoDrawCanvas(width, height), recorder_(recorder) {}
+
+  ~ShaderWarmUpCanvas() override = default;
+
+ protected:
+  // |SkCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    Record(MakeKey(Op::kSaveLayer, rec.fBackdrop != nullptr, rec.fPaint,
+                   getTotalMatrix()),
+           nullptr, rec.fPaint, [&](SkCanvas* canvas, const SkPaint* paint) {
+             // Layers are bounded by the clip, which is at the origin.
+             canvas->resetMatrix();
+             canvas->saveLayer(SaveLayerRec(nullptr, paint, rec.fBackdrop,
+                                            rec.fSaveLayerFlags));
+             canvas->drawRect(SkRect::MakeWH(ShaderWarmUpRecorder::kReplaySize,
+                                             ShaderWarmUpRecorder::kReplaySize),
+                              SkPaint());
+             canvas->restore();
+           });
+    return SkNoDrawCanvas::getSaveLayerStrategy(rec);
+  }
+
+  // |SkCanvas|
+  void onDrawPaint(const SkPaint& paint) override {
+    RecordPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawBehind(const SkPaint& paint) override {
+    // Drawing behind is not public API, and draws like a paint.
+    RecordPaint(paint);
+  }
+
+  // |SkCanvas|
+  void onDrawPoints(PointMode mode,
+                    size_t count,
+                    const SkPoint points[],
+                    const SkPaint& paint) override {
+    if (count == 0) {
+      return;
+    }
+    const SkRect bounds = PointsBounds(points, count);
+    Record(MakeKey(Op::kPoints, mode, &paint, getTotalMatrix()), &bounds,
+           &paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawPoints(mode, count, points, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+    Record(MakeKey(Op::kRect, 0, &paint, getTotalMatrix()), &rect, &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawRect(rect, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawRegion(const SkRegion& region, const SkPaint& paint) override {
+    const SkRect bounds = SkRect::Make(region.getBounds());
+    Record(MakeKey(Op::kRegion, region.isRect(), &paint, getTotalMatrix()),
+           &bounds, &paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawRegion(region, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawOval(const SkRect& rect, const SkPaint& paint) override {
+    Record(MakeKey(Op::kOval, 0, &paint, getTotalMatrix()), &rect, &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawOval(rect, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawArc(const SkRect& rect,
+                 SkScalar start_angle,
+                 SkScalar sweep_angle,
+                 bool use_center,
+                 const SkPaint& paint) override {
+    Record(MakeKey(Op::kArc, use_center, &paint, getTotalMatrix()), &rect,
+           &paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawArc(rect, start_angle, sweep_angle, use_center,
+                             *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+    Record(MakeKey(Op::kRRect, rrect.getType(), &paint, getTotalMatrix()),
+           &rrect.getBounds(), &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawRRect(rrect, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawDRRect(const SkRRect& outer,
+                    const SkRRect& inner,
+                    const SkPaint& paint) override {
+    Record(MakeKey(Op::kDRRect, 0, &paint, getTotalMatrix()),
+           &outer.getBounds(), &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawDRRect(outer, inner, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+    const uint32_t path_class = GetPathClass(path);
+    Record(MakeKey(Op::kPath, path_class, &paint, getTotalMatrix()),
+           path.isInverseFillType() ? nullptr : &path.getBounds(), &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawPath(path, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override {
+    const SkRect bounds = blob->bounds().makeOffset(x, y);
+    Record(MakeKey(Op::kTextBlob, 0, &paint, getTotalMatrix()), &bounds,
+           &paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawTextBlob(blob, x, y, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint tex_coords[4],
+                   SkBlendMode mode,
+                   const SkPaint& paint) override {
+    const SkRect bounds = PointsBounds(cubics, 12);
+    Record(MakeKey(Op::kPatch, (colors != nullptr) | (tex_coords != nullptr) << 1,
+                   &paint, getTotalMatrix()),
+           &bounds, &paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawPatch(cubics, colors, tex_coords, mode, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawVerticesObject(const SkVertices* vertices,
+                            SkBlendMode mode,
+                            const SkPaint& paint) override {
+    Record(MakeKey(Op::kVertices, 0, &paint, getTotalMatrix()),
+           &vertices->bounds(), &paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawVertices(vertices, mode, *replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawImage(const SkImage* image,
+                   SkScalar left,
+                   SkScalar top,
+                   const SkPaint* paint) override {
+    const SkRect dst =
+        SkRect::MakeXYWH(left, top, image->width(), image->height());
+    RecordImage(Op::kImage, *image, dst, paint,
+                SkCanvas::kFast_SrcRectConstraint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageRect(const SkImage* image,
+                       const SkRect* src,
+                       const SkRect& dst,
+                       const SkPaint* paint,
+                       SrcRectConstraint constraint) override {
+    RecordImage(Op::kImageRect, *image, dst, paint, constraint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageLattice(const SkImage* image,
+                          const Lattice& lattice,
+                          const SkRect& dst,
+                          const SkPaint* paint) override {
+    RecordImage(Op::kImageLattice, *image, dst, paint,
+                SkCanvas::kFast_SrcRectConstraint);
+  }
+
+  // |SkCanvas|
+  void onDrawImageNine(const SkImage* image,
+                       const SkIRect& center,
+                       const SkRect& dst,
+                       const SkPaint* paint) override {
+    // Nine patches are drawn as lattices.
+    RecordImage(Op::kImageLattice, *image, dst, paint,
+                SkCanvas::kFast_SrcRectConstraint);
+  }
+
+  // |SkCanvas|
+  void onDrawAtlas(const SkImage* atlas,
+                   const SkRSXform xforms[],
+                   const SkRect tex[],
+                   const SkColor colors[],
+                   int count,
+                   SkBlendMode mode,
+                   const SkRect* cull_rect,
+                   const SkPaint* paint) override {
+    if (count <= 0) {
+      return;
+    }
+    const uint32_t geometry =
+        static_cast<uint32_t>(GetImageClass(*atlas)) | (colors != nullptr) << 2;
+    // Only the first sprite is recorded, as they are all drawn alike.
+    Record(MakeKey(Op::kAtlas, geometry, paint, getTotalMatrix()), cull_rect,
+           paint, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             sk_sp<SkImage> placeholder = recorder_->GetPlaceholder(*atlas);
+             const SkRect placeholder_tex = SkRect::Make(placeholder->bounds());
+             canvas->drawAtlas(placeholder.get(), xforms, &placeholder_tex,
+                               colors, 1, mode, nullptr, replay_paint);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawShadowRec(const SkPath& path,
+                       const SkDrawShadowRec& rec) override {
+    Record(MakeKey(Op::kShadow, path.isConvex(), nullptr, getTotalMatrix()),
+           &path.getBounds(), nullptr,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->private_draw_shadow_rec(path, rec);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawEdgeAAQuad(const SkRect& rect,
+                        const SkPoint clip[4],
+                        QuadAAFlags aa_flags,
+                        const SkColor4f& color,
+                        SkBlendMode mode) override {
+    SkPaint traits;
+    traits.setBlendMode(mode);
+    traits.setAntiAlias(aa_flags != kNone_QuadAAFlags);
+    Record(MakeKey(Op::kEdgeAAQuad, clip != nullptr, &traits, getTotalMatrix()),
+           &rect, nullptr, [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->experimental_DrawEdgeAAQuad(rect, clip, aa_flags, color,
+                                                 mode);
+           });
+  }
+
+  // |SkCanvas|
+  void onDrawEdgeAAImageSet(const ImageSetEntry set[],
+                            int count,
+                            const SkPoint dst_clips[],
+                            const SkMatrix pre_view_matrices[],
+                            const SkPaint* paint,
+                            SrcRectConstraint constraint) override {
+    if (count <= 0 || !set[0].fImage) {
+      return;
+    }
+    // The entries are drawn alike, so the first one stands for all of them.
+    RecordImage(Op::kImageSet, *set[0].fImage, set[0].fDstRect, paint,
+                constraint);
+  }
+
+ private:
+  using Draw = std::function<void(SkCanvas*, const SkPaint*)>;
+
+  ShaderWarmUpRecorder* recorder_;
+
+  // Records |draw| if |key| is new. |bounds| are those of the op in local
+  // coordinates, or null if the op covers the clip. |draw| is called with
+  // |paint| with its images replaced with placeholders.
+  void Record(uint64_t key,
+              const SkRect* bounds,
+              const SkPaint* paint,
+              const Draw& draw) {
+    const SkMatrix& matrix = getTotalMatrix();
+    SkRect device_bounds;
+    if (bounds) {
+      device_bounds = matrix.mapRect(*bounds);
+    }
+    recorder_->Record(key, matrix, bounds ? &device_bounds : nullptr,
+                      [&](SkCanvas* canvas) {
+                        if (!paint) {
+                          draw(canvas, nullptr);
+                          return;
+                        }
+                        const SkPaint replay_paint =
+                            recorder_->ReplaceImages(*paint);
+                        draw(canvas, &replay_paint);
+                      });
+  }
+
+  void RecordPaint(const SkPaint& paint) {
+    Record(MakeKey(Op::kPaint, 0, &paint, getTotalMatrix()), nullptr, &paint,
+           [](SkCanvas* canvas, const SkPaint* replay_paint) {
+             canvas->drawPaint(*replay_paint);
+           });
+  }
+
+  void RecordImage(Op op,
+                   const SkImage& image,
+                   const SkRect& dst,
+                   const SkPaint* paint,
+                   SrcRectConstraint constraint) {
+    const uint32_t geometry = static_cast<uint32_t>(GetImageClass(image)) |
+                              (constraint == kStrict_SrcRectConstraint) << 2;
+    Record(MakeKey(op, geometry, paint, getTotalMatrix()), &dst, paint,
+           [&](SkCanvas* canvas, const SkPaint* replay_paint) {
+             sk_sp<SkImage> placeholder = recorder_->GetPlaceholder(image);
+             canvas->drawImageRect(placeholder,
+                                   SkRect::Make(placeholder->bounds()), dst,
+                                   replay_paint, constraint);
+           });
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderWarmUpCanvas);
+};
+
+namespace {
+
+// Draws into a canvas and records the draws into a ShaderWarmUpCanvas. Skia
+// objects are created for the canvas drawn into.
+class ShaderWarmUpTee final : public SkNWayCanvas {
+ public:
+  ShaderWarmUpTee(SkCanvas* canvas, ShaderWarmUpRecorder* recorder)
+      : SkNWayCanvas(canvas->getBaseLayerSize().width(),
+                     canvas->getBaseLayerSize().height()),
+        canvas_(canvas),
+        recording_canvas_(canvas->getBaseLayerSize().width(),
+                          canvas->getBaseLayerSize().height(),
+                          recorder) {
+    addCanvas(canvas_);
+    addCanvas(&recording_canvas_);
+  }
+
+  ~ShaderWarmUpTee() override = default;
+
+  // |SkCanvas|
+  GrContext* getGrContext() override { return canvas_->getGrContext(); }
+
+ protected:
+  // |SkCanvas|
+  SkImageInfo onImageInfo() const override { return canvas_->imageInfo(); }
+
+ private:
+  SkCanvas* canvas_;
+  ShaderWarmUpCanvas recording_canvas_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderWarmUpTee);
+};
+
+}  // namespace
+
+ShaderWarmUpRecorder::ShaderWarmUpRecorder() = default;
+
+ShaderWarmUpRecorder::~ShaderWarmUpRecorder() = default;
+
+std::unique_ptr<SkCanvas> ShaderWarmUpRecorder::Tee(SkCanvas* canvas) {
+  return std::make_unique<ShaderWarmUpTee>(canvas, this);
+}
+
+void ShaderWarmUpRecorder::Record(uint64_t key,
+                                  const SkMatrix& matrix,
+                                  const SkRect* device_bounds,
+                                  const Draw& draw) {
+  if (ops_.size() >= kMaxOpCount || !keys_.insert(key).second) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "ShaderWarmUpRecorder::Record");
+  SkMatrix replay_matrix = matrix;
+  if (device_bounds && device_bounds->isFinite()) {
+    replay_matrix.postTranslate(-device_bounds->left(), -device_bounds->top());
+  }
+  const SkRect replay_bounds = SkRect::MakeWH(kReplaySize, kReplaySize);
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(replay_bounds);
+  canvas->clipRect(replay_bounds);
+  canvas->setMatrix(replay_matrix);
+  draw(canvas);
+  ops_.push_back(recorder.finishRecordingAsPicture());
+  has_new_ops_ = true;
+}
+
+sk_sp<SkImage> ShaderWarmUpRecorder::GetPlaceholder(const SkImage& image) {
+  const size_t image_class = GetImageClass(image);
+  sk_sp<SkImage>& placeholder = placeholders_[image_class];
+  if (!placeholder) {
+    const SkImageInfo info =
+        image_class == 0
+            ? SkImageInfo::MakeA8(kPlaceholderSize, kPlaceholderSize)
+            : SkImageInfo::MakeN32(kPlaceholderSize, kPlaceholderSize,
+                                   image_class == 1 ? kOpaque_SkAlphaType
+                                                    : kPremul_SkAlphaType);
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    bitmap.eraseColor(image_class == 1 ? SK_ColorBLACK : SK_ColorTRANSPARENT);
+    bitmap.setImmutable();
+    placeholder = SkImage::MakeFromBitmap(bitmap);
+  }
+  return placeholder;
+}
+
+SkPaint ShaderWarmUpRecorder::ReplaceImages(const SkPaint& paint) {
+  SkMatrix local_matrix;
+  SkTileMode tile_modes[2];
+  const SkImage* image =
+      paint.getShader()
+          ? paint.getShader()->isAImage(&local_matrix, tile_modes)
+          : nullptr;
+  if (!image) {
+    return paint;
+  }
+  SkPaint result = paint;
+  result.setShader(GetPlaceholder(*image)->makeShader(
+      tile_modes[0], tile_modes[1], &local_matrix));
+  return result;
+}
+
+sk_sp<SkData> ShaderWarmUpRecorder::Serialize() {
+  TRACE_EVENT0("flutter", "ShaderWarmUpRecorder::Serialize");
+  SkPictureRecorder recorder;
+  SkCanvas* canvas =
+      recorder.beginRecording(SkRect::MakeWH(kReplaySize, kReplaySize));
+  for (const auto& op : ops_) {
+    canvas->drawPicture(op);
+  }
+  has_new_ops_ = false;
+  return recorder.finishRecordingAsPicture()->serialize();
+}
+
+sk_sp<SkPicture> ShaderWarmUp::Deserialize(const SkData& data) {
+  return SkPicture::MakeFromData(data.data(), data.size());
+}
+
+bool ShaderWarmUp::Replay(GrContext* context, const SkData& data) {
+  TRACE_EVENT0("flutter", "ShaderWarmUp::Replay");
+  sk_sp<SkPicture> picture = Deserialize(data);
+  if (!picture) {
+    FML_LOG(ERROR) << "Could not read the shader warm-up ops.";
+    return false;
+  }
+  sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(
+      context, SkBudgeted::kNo,
+      SkImageInfo::MakeN32Premul(ShaderWarmUpRecorder::kReplaySize,
+                                 ShaderWarmUpRecorder::kReplaySize));
+  if (!surface) {
+    FML_LOG(ERROR) << "Could not create the shader warm-up surface.";
+    return false;
+  }
+  surface->getCanvas()->drawPicture(picture);
+  surface->getCanvas()->flush();
+  return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_SHADER_WARM_UP_H_
+#define FLUTTER_FLOW_SHADER_WARM_UP_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+// Records a representative draw op for each pipeline key of the frames drawn
+// during a training run, so that replaying them at startup compiles the
+// shaders of those frames ahead of time, on any backend.
+//
+// The pipeline key of an op combines the traits that select the shaders Skia
+// draws it with: the kind of op and the class of its geometry, the style,
+// blend mode, shader and filters of its paint, antialiasing and the kind of
+// transform. Only the first op of each key is recorded. Ops are recorded with
+// their transform, translated to draw at the origin and clipped to
+// |kReplaySize|, so that replaying them costs little more than compiling
+// their shaders. Images are replaced with small placeholders of the same
+// kind, which keeps the recorder from holding on to the textures of the
+// frames.
+//
+// Clips are not recorded, as a canvas doesn't expose their geometry, so the
+// shaders of complex clips are left to the first frames.
+class ShaderWarmUpRecorder {
+ public:
+  // The size of the surface the ops are replayed into.
+  static constexpr int kReplaySize = 64;
+
+  // The number of pipeline keys recorded, after which new keys are ignored.
+  static constexpr size_t kMaxOpCount = 256;
+
+  ShaderWarmUpRecorder();
+
+  ~ShaderWarmUpRecorder();
+
+  // Returns a canvas that draws into |canvas| and records the ops of new
+  // pipeline keys. It must not outlive the recorder nor |canvas|.
+  std::unique_ptr<SkCanvas> Tee(SkCanvas* canvas);
+
+  size_t op_count() const { return ops_.size(); }
+
+  // Whether ops were recorded since the last |Serialize|.
+  bool has_new_ops() const { return has_new_ops_; }
+
+  // Serializes the recorded ops into an SKP for |ShaderWarmUp::Replay|.
+  sk_sp<SkData> Serialize();
+
+ private:
+  friend class ShaderWarmUpCanvas;
+
+  using Draw = std::function<void(SkCanvas*)>;
+
+  std::unordered_set<uint64_t> keys_;
+  std::vector<sk_sp<SkPicture>> ops_;
+  bool has_new_ops_ = false;
+  // Placeholders for alpha only, opaque and translucent images.
+  std::array<sk_sp<SkImage>, 3> placeholders_;
+
+  // Records |draw| with |matrix| if |key| is new. |device_bounds| are those
+  // of the op under |matrix|, or null if the op covers the clip.
+  void Record(uint64_t key,
+              const SkMatrix& matrix,
+              const SkRect* device_bounds,
+              const Draw& draw);
+
+  // Returns an image of the same kind as |image| to record in its place.
+  sk_sp<SkImage> GetPlaceholder(const SkImage& image);
+
+  // Returns |paint| with the image of its shader, if any, replaced with a
+  // placeholder.
+  SkPaint ReplaceImages(const SkPaint& paint);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderWarmUpRecorder);
+};
+
+class ShaderWarmUp {
+ public:
+  // Reads the ops serialized by |ShaderWarmUpRecorder::Serialize|.
+  static sk_sp<SkPicture> Deserialize(const SkData& data);
+
+  // Replays the serialized ops into an offscreen surface of |context| and
+  // flushes them, which compiles their shaders. Returns false if |data| could
+  // not be read or the surface could not be created.
+  static bool Replay(GrContext* context, const SkData& data);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(ShaderWarmUp);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_SHADER_WARM_UP_H_
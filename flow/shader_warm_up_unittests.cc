@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/shader_warm_up.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(ShaderWarmUpRecorder, RecordsAnOpPerPipelineKey) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  ShaderWarmUpRecorder recorder;
+  std::unique_ptr<SkCanvas> canvas = recorder.Tee(surface->getCanvas());
+
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  // Colors don't select shaders.
+  paint.setColor(SK_ColorBLUE);
+  canvas->drawRect(SkRect::MakeXYWH(20, 20, 10, 10), paint);
+  EXPECT_EQ(recorder.op_count(), 1u);
+
+  paint.setAntiAlias(true);
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  EXPECT_EQ(recorder.op_count(), 2u);
+
+  SkPath concave;
+  concave.moveTo(0, 0);
+  concave.lineTo(10, 0);
+  concave.lineTo(5, 5);
+  concave.lineTo(10, 10);
+  concave.lineTo(0, 10);
+  SkPath scaled;
+  concave.transform(SkMatrix::Scale(2, 2), &scaled);
+  canvas->drawPath(concave, paint);
+  canvas->drawPath(scaled, paint);
+  EXPECT_EQ(recorder.op_count(), 3u);
+
+  canvas->save();
+  canvas->rotate(45);
+  canvas->drawPath(concave, paint);
+  canvas->restore();
+  EXPECT_EQ(recorder.op_count(), 4u);
+
+  // The ops are still drawn into the canvas.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(100, 100);
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(25, 25), SK_ColorBLUE);
+}
+
+TEST(ShaderWarmUpRecorder, DoesNotHoldOnToImages) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  ShaderWarmUpRecorder recorder;
+  std::unique_ptr<SkCanvas> canvas = recorder.Tee(surface->getCanvas());
+
+  sk_sp<SkImage> image =
+      SkSurface::MakeRasterN32Premul(50, 50)->makeImageSnapshot();
+  canvas->drawImage(image, 0, 0);
+  SkPaint paint;
+  paint.setShader(image->makeShader());
+  canvas->drawRect(SkRect::MakeWH(50, 50), paint);
+  paint.setShader(nullptr);
+  EXPECT_EQ(recorder.op_count(), 2u);
+  EXPECT_TRUE(image->unique());
+}
+
+TEST(ShaderWarmUpRecorder, StopsRecordingAtMaxOpCount) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  ShaderWarmUpRecorder recorder;
+  std::unique_ptr<SkCanvas> canvas = recorder.Tee(surface->getCanvas());
+
+  SkPaint paint;
+  for (int mode = 0; mode <= static_cast<int>(SkBlendMode::kLastMode);
+       mode++) {
+    paint.setBlendMode(static_cast<SkBlendMode>(mode));
+    for (int style = 0; style < SkPaint::kStyleCount; style++) {
+      paint.setStyle(static_cast<SkPaint::Style>(style));
+      for (int flags = 0; flags < 4; flags++) {
+        paint.setAntiAlias(flags & 1);
+        paint.setDither(flags & 2);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+      }
+    }
+  }
+  EXPECT_EQ(recorder.op_count(), ShaderWarmUpRecorder::kMaxOpCount);
+}
+
+TEST(ShaderWarmUp, ReplaysSerializedOps) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(100, 100);
+  ShaderWarmUpRecorder recorder;
+  std::unique_ptr<SkCanvas> canvas = recorder.Tee(surface->getCanvas());
+
+  SkPaint paint;
+  canvas->translate(500, 500);
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  canvas->drawOval(SkRect::MakeWH(10, 10), paint);
+  canvas->drawImage(SkSurface::MakeRasterN32Premul(10, 10)->makeImageSnapshot(),
+                    0, 0);
+  EXPECT_TRUE(recorder.has_new_ops());
+
+  sk_sp<SkData> data = recorder.Serialize();
+  ASSERT_NE(data, nullptr);
+  EXPECT_FALSE(recorder.has_new_ops());
+
+  sk_sp<SkPicture> picture = ShaderWarmUp::Deserialize(*data);
+  ASSERT_NE(picture, nullptr);
+  EXPECT_EQ(picture->approximateOpCount(), 3);
+
+  // The ops are moved to the origin to be replayed.
+  sk_sp<SkSurface> replay_surface = SkSurface::MakeRasterN32Premul(
+      ShaderWarmUpRecorder::kReplaySize, ShaderWarmUpRecorder::kReplaySize);
+  replay_surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  replay_surface->getCanvas()->drawPicture(picture);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(ShaderWarmUpRecorder::kReplaySize,
+                        ShaderWarmUpRecorder::kReplaySize);
+  ASSERT_TRUE(replay_surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(5, 5), SK_ColorBLACK);
+}
+
+}  // namespace testing
+}  // namespace flutter
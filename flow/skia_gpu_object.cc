@@ -4,6 +4,9 @@
 
 #include "flutter/flow/skia_gpu_object.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/trace_event.h"
 
@@ -15,6 +18,8 @@ SkiaUnrefQueue::SkiaUnrefQueue(fml::RefPtr<fml::TaskRunner> task_runner,
     : task_runner_(std::move(task_runner)),
       drain_delay_(delay),
       drain_pending_(false),
+      prompt_drain_pending_(false),
+      drain_budget_(fml::TimeDelta::Zero()),
       context_(context) {}
 
 SkiaUnrefQueue::~SkiaUnrefQueue() {
@@ -26,18 +31,37 @@ void SkiaUnrefQueue::Unref(SkRefCnt* object) {
   objects_.push_back(object);
   if (!drain_pending_) {
     drain_pending_ = true;
-    task_runner_->PostDelayedTask(
-        [strong = fml::Ref(this)]() { strong->Drain(); }, drain_delay_);
+    PostDrainSlice(fml::TimePoint::Now() + drain_delay_);
+  }
+}
+
+void SkiaUnrefQueue::UnrefPromptly(SkRefCnt* object) {
+  std::scoped_lock lock(mutex_);
+  objects_.push_back(object);
+  if (!prompt_drain_pending_) {
+    // A delayed drain that is already posted finds nothing left to drain.
+    drain_pending_ = true;
+    prompt_drain_pending_ = true;
+    PostDrainSlice(fml::TimePoint::Now());
   }
 }
 
+void SkiaUnrefQueue::PostDrainSlice(fml::TimePoint target_time) {
+  // Draining is housekeeping, keep it out of the way of other work.
+  task_runner_->PostTaskForTimeWithPriority(
+      [strong = fml::Ref(this)]() { strong->DrainSlice(); }, target_time,
+      fml::TaskPriority::kIdle);
+}
+
 void SkiaUnrefQueue::Drain() {
   TRACE_EVENT0("flutter", "SkiaUnrefQueue::Drain");
+  const fml::TimePoint start = fml::TimePoint::Now();
   std::deque<SkRefCnt*> skia_objects;
   {
     std::scoped_lock lock(mutex_);
     objects_.swap(skia_objects);
     drain_pending_ = false;
+    prompt_drain_pending_ = false;
   }
 
   for (SkRefCnt* skia_object : skia_objects) {
@@ -47,6 +71,77 @@ void SkiaUnrefQueue::Drain() {
   if (context_ && skia_objects.size() > 0) {
     context_->performDeferredCleanup(std::chrono::milliseconds(0));
   }
+
+  TraceCounters(0, fml::TimePoint::Now() - start);
+}
+
+void SkiaUnrefQueue::SetDrainBudget(fml::TimeDelta budget) {
+  std::scoped_lock lock(mutex_);
+  drain_budget_ = budget;
+}
+
+void SkiaUnrefQueue::DrainSlice() {
+  fml::TimeDelta budget;
+  {
+    std::scoped_lock lock(mutex_);
+    budget = drain_budget_;
+  }
+  if (budget <= fml::TimeDelta::Zero()) {
+    Drain();
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "SkiaUnrefQueue::DrainSlice");
+  // The clock is only read between batches of this many unrefs.
+  constexpr size_t kBatchSize = 16;
+  const fml::TimePoint start = fml::TimePoint::Now();
+  const fml::TimePoint deadline = start + budget;
+  size_t drained_count = 0;
+  size_t depth = 0;
+  do {
+    std::vector<SkRefCnt*> batch;
+    {
+      std::scoped_lock lock(mutex_);
+      const size_t count = std::min(kBatchSize, objects_.size());
+      batch.assign(objects_.begin(), objects_.begin() + count);
+      objects_.erase(objects_.begin(), objects_.begin() + count);
+      depth = objects_.size();
+      if (depth == 0) {
+        drain_pending_ = false;
+        prompt_drain_pending_ = false;
+      }
+    }
+    for (SkRefCnt* skia_object : batch) {
+      skia_object->unref();
+    }
+    drained_count += batch.size();
+  } while (depth > 0 && fml::TimePoint::Now() < deadline);
+
+  if (context_ && drained_count > 0) {
+    context_->performDeferredCleanup(std::chrono::milliseconds(0));
+  }
+
+  // The drain is still pending, so the next slice is only posted here.
+  if (depth > 0) {
+    PostDrainSlice(fml::TimePoint::Now());
+  }
+
+  TraceCounters(depth, fml::TimePoint::Now() - start);
+}
+
+void SkiaUnrefQueue::TraceCounters(size_t depth, fml::TimeDelta drain_time) {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SkiaUnrefQueue",
+                    reinterpret_cast<int64_t>(this),                //
+                    "Depth", depth,                                 //
+                    "DrainTimeMicros", drain_time.ToMicroseconds()  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+void SkiaUnrefQueue::UpdateResourceContext(fml::WeakPtr<GrContext> context) {
+  FML_DCHECK(task_runner_->RunsTasksOnCurrentThread());
+  context_ = std::move(context);
 }
 
 }  // namespace flutter
@@ -22,6 +22,12 @@ class SkiaUnrefQueue : public fml::RefCountedThreadSafe<SkiaUnrefQueue> {
  public:
   void Unref(SkRefCnt* object);
 
+  // Like |Unref|, but drains the queue in the next task of its task runner
+  // instead of after the drain delay. For objects that the app explicitly
+  // disposed of, such as large images, whose memory should not wait for the
+  // next drain.
+  void UnrefPromptly(SkRefCnt* object);
+
   // Usually, the drain is called automatically. However, during IO manager
   // shutdown (when the platform side reference to the OpenGL context is about
   // to go away), we may need to pre-emptively drain the unref queue. It is the
@@ -29,12 +35,27 @@ class SkiaUnrefQueue : public fml::RefCountedThreadSafe<SkiaUnrefQueue> {
   // after this call.
   void Drain();
 
+  // Limits each automatic drain to about |budget| of unrefs. The objects left
+  // over are drained in further slices posted behind the other work of the
+  // task runner, such as texture uploads, so that releasing many objects at
+  // once doesn't stall it. A zero budget, the default, drains all the objects
+  // at once.
+  void SetDrainBudget(fml::TimeDelta budget);
+
+  // Replaces the context that is signaled to perform deferred cleanup after a
+  // drain. This is used when the resource context becomes available after the
+  // queue was created. Must be called on the task runner of the queue.
+  void UpdateResourceContext(fml::WeakPtr<GrContext> context);
+
  private:
   const fml::RefPtr<fml::TaskRunner> task_runner_;
   const fml::TimeDelta drain_delay_;
   std::mutex mutex_;
   std::deque<SkRefCnt*> objects_;
   bool drain_pending_;
+  // Whether a drain that doesn't wait for the drain delay is posted.
+  bool prompt_drain_pending_;
+  fml::TimeDelta drain_budget_;
   fml::WeakPtr<GrContext> context_;
 
   // The `GrContext* context` is only used for signaling Skia to
@@ -46,6 +67,14 @@ class SkiaUnrefQueue : public fml::RefCountedThreadSafe<SkiaUnrefQueue> {
 
   ~SkiaUnrefQueue();
 
+  // Unrefs the queued objects for up to the drain budget and posts another
+  // slice for the ones left over.
+  void DrainSlice();
+
+  void PostDrainSlice(fml::TimePoint target_time);
+
+  void TraceCounters(size_t depth, fml::TimeDelta drain_time);
+
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(SkiaUnrefQueue);
   FML_FRIEND_MAKE_REF_COUNTED(SkiaUnrefQueue);
   FML_DISALLOW_COPY_AND_ASSIGN(SkiaUnrefQueue);
@@ -71,6 +100,9 @@ class SkiaGPUObject {
 
   sk_sp<SkiaObjectType> get() const { return object_; }
 
+  // The queue that the object is unreferenced on, if any.
+  fml::RefPtr<SkiaUnrefQueue> queue() const { return queue_; }
+
   void reset() {
     if (object_ && queue_) {
       queue_->Unref(object_.release());
@@ -79,6 +111,16 @@ class SkiaGPUObject {
     FML_DCHECK(object_ == nullptr);
   }
 
+  // Like |reset|, but the object is unreferenced promptly, see
+  // |SkiaUnrefQueue::UnrefPromptly|.
+  void reset_promptly() {
+    if (object_ && queue_) {
+      queue_->UnrefPromptly(object_.release());
+    }
+    queue_ = nullptr;
+    FML_DCHECK(object_ == nullptr);
+  }
+
  private:
   sk_sp<SkiaObjectType> object_;
   fml::RefPtr<SkiaUnrefQueue> queue_;
@@ -11,7 +11,10 @@
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 
+#include <atomic>
+#include <functional>
 #include <future>
+#include <thread>
 
 namespace flutter {
 namespace testing {
@@ -127,5 +130,69 @@ TEST_F(SkiaGpuObjectTest, ObjectResetTwice) {
   ASSERT_EQ(dtor_task_queue_id, unref_task_runner()->GetTaskQueueId());
 }
 
+TEST_F(SkiaGpuObjectTest, ObjectResetPromptly) {
+  std::shared_ptr<fml::AutoResetWaitableEvent> latch =
+      std::make_shared<fml::AutoResetWaitableEvent>();
+  fml::TaskQueueId dtor_task_queue_id(0);
+  SkiaGPUObject<TestSkObject> sk_object(
+      sk_make_sp<TestSkObject>(latch, &dtor_task_queue_id),
+      delayed_unref_queue());
+  // The object doesn't wait for the drain delay of the queue.
+  sk_object.reset_promptly();
+  ASSERT_EQ(sk_object.get(), nullptr);
+  ASSERT_FALSE(latch->WaitWithTimeout(fml::TimeDelta::FromSeconds(2)));
+  ASSERT_EQ(dtor_task_queue_id, unref_task_runner()->GetTaskQueueId());
+}
+
+class CountingSkObject : public SkRefCnt {
+ public:
+  CountingSkObject(std::atomic<size_t>* destroyed_count,
+                   std::function<void()> on_destroyed)
+      : destroyed_count_(destroyed_count),
+        on_destroyed_(std::move(on_destroyed)) {}
+
+  ~CountingSkObject() {
+    (*destroyed_count_)++;
+    on_destroyed_();
+  }
+
+ private:
+  std::atomic<size_t>* destroyed_count_;
+  std::function<void()> on_destroyed_;
+};
+
+TEST_F(SkiaGpuObjectTest, BudgetedDrainLetsOtherTasksRunBetweenSlices) {
+  constexpr size_t kObjectCount = 64;
+  std::atomic<size_t> destroyed_count(0);
+  size_t destroyed_count_between_slices = 0;
+  fml::AutoResetWaitableEvent between_slices_latch;
+  fml::AutoResetWaitableEvent drained_latch;
+  unref_queue()->SetDrainBudget(fml::TimeDelta::FromMicroseconds(1));
+
+  // Posts a task from within the first slice, which must run before the slices
+  // that are posted after it, and outlasts the budget of the slice.
+  SkRefCnt* first_object = new CountingSkObject(&destroyed_count, [&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    unref_task_runner()->PostTask([&]() {
+      destroyed_count_between_slices = destroyed_count;
+      between_slices_latch.Signal();
+    });
+  });
+  unref_queue()->Unref(first_object);
+  for (size_t i = 1; i < kObjectCount; i++) {
+    unref_queue()->Unref(new CountingSkObject(&destroyed_count, [&]() {
+      if (destroyed_count == kObjectCount) {
+        drained_latch.Signal();
+      }
+    }));
+  }
+
+  between_slices_latch.Wait();
+  drained_latch.Wait();
+  EXPECT_EQ(destroyed_count, kObjectCount);
+  EXPECT_GT(destroyed_count_between_slices, 0u);
+  EXPECT_LT(destroyed_count_between_slices, kObjectCount);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -18,4 +18,12 @@ std::unique_ptr<GLContextResult> Surface::MakeRenderContextCurrent() {
   return std::make_unique<GLContextDefaultResult>(true);
 }
 
+std::optional<fml::TimeDelta> Surface::TakeGpuFrameTime() {
+  return std::nullopt;
+}
+
+bool Surface::DeferredLastFrame() const {
+  return false;
+}
+
 }  // namespace flutter
@@ -6,11 +6,13 @@
 #define FLUTTER_FLOW_SURFACE_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/gl_context_switch.h"
 #include "flutter/flow/surface_frame.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
 
 namespace flutter {
 
@@ -33,6 +35,18 @@ class Surface {
 
   virtual std::unique_ptr<GLContextResult> MakeRenderContextCurrent();
 
+  // Returns the time the GPU spent on the most recent frame whose GPU timing
+  // has become available since the last call. GPU work completes
+  // asynchronously, so this usually lags a few frames behind. Returns
+  // std::nullopt if there is no new measurement, or the surface cannot measure
+  // GPU time.
+  virtual std::optional<fml::TimeDelta> TakeGpuFrameTime();
+
+  // Returns whether the last call to |AcquireFrame| returned no frame only
+  // because the surface had no buffer ready in time, in which case the layer
+  // tree of the frame is drawn again later rather than dropped.
+  virtual bool DeferredLastFrame() const;
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Surface);
 };
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -42,12 +43,29 @@ class SurfaceFrame {
 
   bool supports_readback() { return supports_readback_; }
 
+  // The number of frames ago the buffer backing this frame was last rendered
+  // to, as reported by EGL_EXT_buffer_age and similar mechanisms. A value of 0
+  // means the contents of the buffer are undefined. Set by surfaces that can
+  // tell.
+  int buffer_age() const { return buffer_age_; }
+
+  void set_buffer_age(int buffer_age) { buffer_age_ = buffer_age; }
+
+  // The region of the frame that was repainted, or std::nullopt if the whole
+  // frame was. Surfaces that can restrict presentation to a region may use
+  // this when the frame is submitted.
+  const std::optional<SkIRect>& damage() const { return damage_; }
+
+  void set_damage(std::optional<SkIRect> damage) { damage_ = damage; }
+
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
   bool supports_readback_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
+  int buffer_age_ = 0;
+  std::optional<SkIRect> damage_;
 
   bool PerformSubmit();
 
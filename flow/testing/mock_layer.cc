@@ -31,11 +31,19 @@ void MockLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   if (fake_reads_surface_) {
     context->surface_needs_readback = true;
   }
+  context->subtree_can_inherit_opacity = fake_can_inherit_opacity_;
+  context->subtree_opaque_bounds = fake_opaque_bounds_;
 }
 
 void MockLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting());
 
+  if (context.inherited_opacity < SK_Scalar1) {
+    SkPaint paint = fake_paint_;
+    paint.setAlphaf(paint.getAlphaf() * context.inherited_opacity);
+    context.leaf_nodes_canvas->drawPath(fake_paint_path_, paint);
+    return;
+  }
   context.leaf_nodes_canvas->drawPath(fake_paint_path_, fake_paint_);
 }
 
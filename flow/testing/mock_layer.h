@@ -31,6 +31,18 @@ class MockLayer : public Layer {
   float parent_elevation() { return parent_elevation_; }
   bool parent_has_platform_view() { return parent_has_platform_view_; }
 
+  // Makes the layer report that it can inherit opacity during Preroll. An
+  // inherited opacity is then applied to the paint of the path.
+  void set_fake_can_inherit_opacity(bool value) {
+    fake_can_inherit_opacity_ = value;
+  }
+
+  // Makes the layer report |bounds| as covered with opaque content during
+  // Preroll.
+  void set_fake_opaque_bounds(const SkRect& bounds) {
+    fake_opaque_bounds_ = bounds;
+  }
+
  private:
   MutatorsStack parent_mutators_;
   SkMatrix parent_matrix_;
@@ -42,6 +54,8 @@ class MockLayer : public Layer {
   bool fake_has_platform_view_ = false;
   bool fake_needs_system_composite_ = false;
   bool fake_reads_surface_ = false;
+  bool fake_can_inherit_opacity_ = false;
+  SkRect fake_opaque_bounds_ = SkRect::MakeEmpty();
 
   FML_DISALLOW_COPY_AND_ASSIGN(MockLayer);
 };
@@ -25,6 +25,18 @@ std::unique_ptr<RasterCacheResult> MockRasterCache::RasterizePicture(
   return std::make_unique<MockRasterCacheResult>(cache_rect);
 }
 
+std::unique_ptr<RasterCacheResult> MockRasterCache::RasterizeDisplayList(
+    DisplayList* display_list,
+    GrContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) const {
+  SkRect logical_rect = display_list->cull_rect();
+  SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
+
+  return std::make_unique<MockRasterCacheResult>(cache_rect);
+}
+
 std::unique_ptr<RasterCacheResult> MockRasterCache::RasterizeLayer(
     PrerollContext* context,
     Layer* layer,
@@ -36,5 +48,17 @@ std::unique_ptr<RasterCacheResult> MockRasterCache::RasterizeLayer(
   return std::make_unique<MockRasterCacheResult>(cache_rect);
 }
 
+std::unique_ptr<RasterCacheResult> MockRasterCache::RasterizeShadow(
+    GrContext* context,
+    const SkRect& bounds,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const std::function<void(SkCanvas*)>& draw_shadow) const {
+  SkIRect cache_rect = RasterCache::GetDeviceBounds(bounds, ctm);
+
+  return std::make_unique<MockRasterCacheResult>(cache_rect);
+}
+
 }  // namespace testing
 }  // namespace flutter
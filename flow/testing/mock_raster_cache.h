@@ -25,6 +25,10 @@ class MockRasterCacheResult : public RasterCacheResult {
 
   void draw(SkCanvas& canvas, const SkPaint* paint = nullptr) const override{};
 
+  void drawScaled(SkCanvas& canvas,
+                  const SkVector& scale,
+                  const SkPaint* paint = nullptr) const override{};
+
   SkISize image_dimensions() const override { return device_rect_.size(); };
 
   int64_t image_bytes() const override {
@@ -51,11 +55,26 @@ class MockRasterCache : public RasterCache {
       SkColorSpace* dst_color_space,
       bool checkerboard) const override;
 
+  std::unique_ptr<RasterCacheResult> RasterizeDisplayList(
+      DisplayList* display_list,
+      GrContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const override;
+
   std::unique_ptr<RasterCacheResult> RasterizeLayer(
       PrerollContext* context,
       Layer* layer,
       const SkMatrix& ctm,
       bool checkerboard) const override;
+
+  std::unique_ptr<RasterCacheResult> RasterizeShadow(
+      GrContext* context,
+      const SkRect& bounds,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard,
+      const std::function<void(SkCanvas*)>& draw_shadow) const override;
 };
 
 }  // namespace testing
@@ -10,39 +10,91 @@ Texture::Texture(int64_t id) : id_(id) {}
 
 Texture::~Texture() = default;
 
-TextureRegistry::TextureRegistry() = default;
+TextureRegistry::TextureRegistry()
+    : textures_(std::make_shared<const TextureMap>()) {}
+
+TextureRegistry::~TextureRegistry() = default;
 
 void TextureRegistry::RegisterTexture(std::shared_ptr<Texture> texture) {
   if (!texture) {
     return;
   }
-  mapping_[texture->Id()] = texture;
+  std::scoped_lock lock(mutex_);
+  auto textures = std::make_shared<TextureMap>(*textures_);
+  texture->frame_generation_ = ++last_frame_generation_;
+  (*textures)[texture->Id()] = std::move(texture);
+  textures_ = std::move(textures);
 }
 
 void TextureRegistry::UnregisterTexture(int64_t id) {
-  auto found = mapping_.find(id);
-  if (found == mapping_.end()) {
-    return;
+  std::shared_ptr<Texture> texture;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = textures_->find(id);
+    if (found == textures_->end()) {
+      return;
+    }
+    texture = found->second;
+    auto textures = std::make_shared<TextureMap>(*textures_);
+    textures->erase(id);
+    textures_ = std::move(textures);
   }
-  found->second->OnTextureUnregistered();
-  mapping_.erase(found);
+  texture->OnTextureUnregistered();
+}
+
+std::shared_ptr<const TextureRegistry::TextureMap>
+TextureRegistry::GetTextures() const {
+  std::scoped_lock lock(mutex_);
+  return textures_;
 }
 
 void TextureRegistry::OnGrContextCreated() {
-  for (auto& it : mapping_) {
+  for (auto& it : *GetTextures()) {
     it.second->OnGrContextCreated();
   }
 }
 
 void TextureRegistry::OnGrContextDestroyed() {
-  for (auto& it : mapping_) {
+  for (auto& it : *GetTextures()) {
     it.second->OnGrContextDestroyed();
   }
 }
 
-std::shared_ptr<Texture> TextureRegistry::GetTexture(int64_t id) {
-  auto it = mapping_.find(id);
-  return it != mapping_.end() ? it->second : nullptr;
+static std::shared_ptr<Texture> FindTexture(
+    const std::map<int64_t, std::shared_ptr<Texture>>& textures,
+    int64_t id) {
+  auto it = textures.find(id);
+  return it != textures.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Texture> TextureRegistry::GetTexture(int64_t id) const {
+  if (frame_textures_) {
+    return FindTexture(*frame_textures_, id);
+  }
+  return FindTexture(*GetTextures(), id);
+}
+
+void TextureRegistry::BeginFrame() {
+  frame_textures_ = GetTextures();
+}
+
+void TextureRegistry::EndFrame() {
+  frame_textures_ = nullptr;
+}
+
+void TextureRegistry::MarkNewFrameAvailable(int64_t id) {
+  std::shared_ptr<Texture> texture;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = textures_->find(id);
+    if (it == textures_->end()) {
+      return;
+    }
+    texture = it->second;
+    texture->frame_generation_ = ++last_frame_generation_;
+  }
+  has_new_frames_ = true;
+  texture->MarkNewFrameAvailable();
 }
 
 }  // namespace flutter
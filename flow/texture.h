@@ -6,6 +6,8 @@
 #define FLUTTER_FLOW_TEXTURE_H_
 
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -39,24 +41,61 @@ class Texture {
 
   int64_t Id() { return id_; }
 
+  // Changes whenever the texture is registered or has a new frame marked
+  // available through its registry, and only then, so that an unchanged
+  // generation means that the texture paints what it painted before. Unique
+  // among the textures of a registry.
+  uint64_t frame_generation() const { return frame_generation_; }
+
  private:
+  friend class TextureRegistry;
+
   int64_t id_;
+  uint64_t frame_generation_ = 0;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Texture);
 };
 
+// The textures are kept in an immutable map that is copied on every update,
+// so that registering a texture doesn't have to wait for the raster thread.
+// Each frame takes the map that is current as it begins and looks up its
+// textures there without any locking, also from the threads that paint parts
+// of the frame concurrently.
 class TextureRegistry {
  public:
   TextureRegistry();
 
-  // Called from raster thread.
+  ~TextureRegistry();
+
+  // Called from any thread. Frames that begin afterwards paint the texture.
   void RegisterTexture(std::shared_ptr<Texture> texture);
 
   // Called from raster thread.
   void UnregisterTexture(int64_t id);
 
-  // Called from raster thread.
-  std::shared_ptr<Texture> GetTexture(int64_t id);
+  // Called from raster thread, or from the threads that paint parts of the
+  // current frame. Within a frame, returns the textures that were registered
+  // when it began.
+  std::shared_ptr<Texture> GetTexture(int64_t id) const;
+
+  // Called from raster thread as a frame begins. Takes the textures the
+  // lookups of the frame see.
+  void BeginFrame();
+
+  // Called from raster thread once the frame is done.
+  void EndFrame();
+
+  // Called from raster thread. Lets the texture with |id| know that it has a
+  // new frame to paint.
+  void MarkNewFrameAvailable(int64_t id);
+
+  // Called from raster thread. Whether a new frame was marked available since
+  // the last |OnLayerTreeDrawn|.
+  bool has_new_frames() const { return has_new_frames_; }
+
+  // Called from raster thread once a layer tree has been drawn, which painted
+  // the new frames of the textures it shows.
+  void OnLayerTreeDrawn() { has_new_frames_ = false; }
 
   // Called from raster thread.
   void OnGrContextCreated();
@@ -65,7 +104,18 @@ class TextureRegistry {
   void OnGrContextDestroyed();
 
  private:
-  std::map<int64_t, std::shared_ptr<Texture>> mapping_;
+  using TextureMap = std::map<int64_t, std::shared_ptr<Texture>>;
+
+  // Guards the updates of |textures_| and the frame generations.
+  mutable std::mutex mutex_;
+  std::shared_ptr<const TextureMap> textures_;
+  uint64_t last_frame_generation_ = 0;
+  // The textures of the current frame, only changed on the raster thread
+  // between frames.
+  std::shared_ptr<const TextureMap> frame_textures_;
+  bool has_new_frames_ = false;
+
+  std::shared_ptr<const TextureMap> GetTextures() const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TextureRegistry);
 };
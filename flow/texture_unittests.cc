@@ -5,6 +5,8 @@
 #include "flutter/flow/testing/mock_texture.h"
 #include "flutter/flow/texture.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
 
 namespace flutter {
@@ -95,5 +97,52 @@ TEST(TextureRegistryTest, ReuseSameTextureSlot) {
   ASSERT_TRUE(mock_texture2->unregistered());
 }
 
+TEST(TextureRegistryTest, TracksNewFrames) {
+  TextureRegistry registry;
+  auto mock_texture1 = std::make_shared<MockTexture>(0);
+  auto mock_texture2 = std::make_shared<MockTexture>(1);
+
+  registry.RegisterTexture(mock_texture1);
+  registry.RegisterTexture(mock_texture2);
+  const uint64_t generation1 = mock_texture1->frame_generation();
+  const uint64_t generation2 = mock_texture2->frame_generation();
+  EXPECT_NE(generation1, generation2);
+  EXPECT_FALSE(registry.has_new_frames());
+
+  registry.MarkNewFrameAvailable(0);
+  EXPECT_TRUE(registry.has_new_frames());
+  EXPECT_NE(mock_texture1->frame_generation(), generation1);
+  EXPECT_NE(mock_texture1->frame_generation(), generation2);
+  EXPECT_EQ(mock_texture2->frame_generation(), generation2);
+
+  registry.OnLayerTreeDrawn();
+  EXPECT_FALSE(registry.has_new_frames());
+
+  // Unknown textures are ignored.
+  registry.MarkNewFrameAvailable(2);
+  EXPECT_FALSE(registry.has_new_frames());
+}
+
+TEST(TextureRegistryTest, FramesSeeTexturesRegisteredBeforeTheyBegin) {
+  TextureRegistry registry;
+  auto mock_texture1 = std::make_shared<MockTexture>(0);
+  auto mock_texture2 = std::make_shared<MockTexture>(1);
+  registry.RegisterTexture(mock_texture1);
+
+  registry.BeginFrame();
+  std::thread platform_thread([&registry, &mock_texture2]() {
+    registry.RegisterTexture(mock_texture2);
+  });
+  platform_thread.join();
+  EXPECT_EQ(registry.GetTexture(0), mock_texture1);
+  EXPECT_EQ(registry.GetTexture(1), nullptr);
+  registry.EndFrame();
+
+  registry.BeginFrame();
+  EXPECT_EQ(registry.GetTexture(0), mock_texture1);
+  EXPECT_EQ(registry.GetTexture(1), mock_texture2);
+  registry.EndFrame();
+}
+
 }  // namespace testing
 }  // namespace flutter
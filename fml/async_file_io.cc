@@ -0,0 +1,135 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/async_file_io.h"
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+#if OS_LINUX
+#include "flutter/fml/platform/linux/async_file_io_linux.h"
+#elif OS_WIN
+#include "flutter/fml/platform/win/async_file_io_win.h"
+#endif
+
+namespace fml {
+
+std::unique_ptr<AsyncFileIO> AsyncFileIO::Create() {
+#if OS_LINUX
+  if (auto io_uring = AsyncFileIOLinux::Create()) {
+    return io_uring;
+  }
+#elif OS_WIN
+  if (auto overlapped = AsyncFileIOWin::Create()) {
+    return overlapped;
+  }
+#endif
+  return CreateWithThreadPool();
+}
+
+std::unique_ptr<AsyncFileIO> AsyncFileIO::CreateWithThreadPool(
+    size_t thread_count) {
+  return std::make_unique<ThreadPoolFileIO>(thread_count);
+}
+
+AsyncFileIO::AsyncFileIO() = default;
+
+AsyncFileIO::~AsyncFileIO() = default;
+
+void AsyncFileIO::Read(const fml::UniqueFD& directory,
+                       std::string path,
+                       fml::RefPtr<fml::TaskRunner> task_runner,
+                       ReadCallback callback) {
+  std::vector<ReadRequest> requests;
+  requests.push_back({std::move(path), std::move(callback)});
+  ReadBatch(directory, std::move(requests), std::move(task_runner));
+}
+
+void AsyncFileIO::Deliver(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                          fml::UniqueClosure callback) {
+  if (task_runner) {
+    task_runner->PostTask(std::move(callback));
+  } else {
+    callback();
+  }
+}
+
+std::unique_ptr<fml::Mapping> AsyncFileIO::ReadFileBlocking(
+    const fml::UniqueFD& directory,
+    const std::string& path) {
+  auto file = fml::OpenFileReadOnly(directory, path.c_str());
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  fml::FileMapping mapping(file);
+  if (!mapping.IsValid()) {
+    return nullptr;
+  }
+  // Copying out of the mapping does the reads now, on this thread, instead of
+  // whenever the contents are first used.
+  const uint8_t* data = mapping.GetMapping();
+  return std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>(data, data + mapping.GetSize()));
+}
+
+ThreadPoolFileIO::ThreadPoolFileIO(size_t thread_count)
+    : loop_(fml::ConcurrentMessageLoop::Create(thread_count)),
+      workers_(loop_->GetTaskRunner()) {}
+
+ThreadPoolFileIO::~ThreadPoolFileIO() {
+  // The loop drops tasks that are still queued when it terminates.
+  std::unique_lock lock(pending_mutex_);
+  pending_done_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+void ThreadPoolFileIO::Post(fml::UniqueClosure request) {
+  {
+    std::scoped_lock lock(pending_mutex_);
+    pending_++;
+  }
+  workers_->PostTask([this, request = std::move(request)]() {
+    request();
+    std::scoped_lock lock(pending_mutex_);
+    if (--pending_ == 0) {
+      pending_done_.notify_all();
+    }
+  });
+}
+
+void ThreadPoolFileIO::ReadBatch(const fml::UniqueFD& directory,
+                                 std::vector<ReadRequest> requests,
+                                 fml::RefPtr<fml::TaskRunner> task_runner) {
+  auto shared_directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(directory.get()));
+  for (auto& request : requests) {
+    Post([shared_directory, task_runner, request = std::move(request)]() {
+      TRACE_EVENT0("fml", "AsyncFileIO::Read");
+      auto contents = ReadFileBlocking(*shared_directory, request.path);
+      Deliver(task_runner,
+              [callback = std::move(request.callback),
+               contents = std::move(contents)]() mutable {
+                callback(std::move(contents));
+              });
+    });
+  }
+}
+
+void ThreadPoolFileIO::Write(const fml::UniqueFD& directory,
+                             std::string path,
+                             std::unique_ptr<const fml::Mapping> contents,
+                             fml::RefPtr<fml::TaskRunner> task_runner,
+                             WriteCallback callback) {
+  Post([directory = fml::Duplicate(directory.get()), path = std::move(path),
+        contents = std::move(contents), task_runner,
+        callback = std::move(callback)]() {
+    TRACE_EVENT0("fml", "AsyncFileIO::Write");
+    const bool success =
+        contents && fml::WriteAtomically(directory, path.c_str(), *contents);
+    Deliver(task_runner, [callback, success]() { callback(success); });
+  });
+}
+
+}  // namespace fml
@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_ASYNC_FILE_IO_H_
+#define FLUTTER_FML_ASYNC_FILE_IO_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Reads and writes whole files without blocking the calling
+///             thread.
+///
+///             Each request calls its callback once done. Callbacks are posted
+///             to the task runner given with the request or, if that is null,
+///             called on whichever internal thread completed the request.
+///
+///             Requests still in flight when this is destroyed are completed
+///             first, so their callbacks are never dropped.
+///
+class AsyncFileIO {
+ public:
+  /// Called with the contents of the file, or null if it could not be read.
+  using ReadCallback = std::function<void(std::unique_ptr<fml::Mapping>)>;
+
+  /// Called with whether the file was written.
+  using WriteCallback = std::function<void(bool)>;
+
+  struct ReadRequest {
+    /// The path of the file, relative to the directory of the batch.
+    std::string path;
+    ReadCallback callback;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the best implementation for the platform. That is
+  ///             io_uring on Linux kernels that support it and overlapped I/O
+  ///             on Windows. Elsewhere, a pool of threads makes blocking calls.
+  ///
+  static std::unique_ptr<AsyncFileIO> Create();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the implementation that makes blocking calls on a
+  ///             pool of |thread_count| threads.
+  ///
+  static std::unique_ptr<AsyncFileIO> CreateWithThreadPool(
+      size_t thread_count = 4);
+
+  virtual ~AsyncFileIO();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads the file at |path| relative to |directory|.
+  ///
+  void Read(const fml::UniqueFD& directory,
+            std::string path,
+            fml::RefPtr<fml::TaskRunner> task_runner,
+            ReadCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads all files of |requests| relative to |directory|. The
+  ///             reads are submitted together, which is much cheaper than
+  ///             reading many small files one by one.
+  ///
+  virtual void ReadBatch(const fml::UniqueFD& directory,
+                         std::vector<ReadRequest> requests,
+                         fml::RefPtr<fml::TaskRunner> task_runner) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes |contents| to the file at |path| relative to
+  ///             |directory|, atomically like `fml::WriteAtomically`.
+  ///
+  virtual void Write(const fml::UniqueFD& directory,
+                     std::string path,
+                     std::unique_ptr<const fml::Mapping> contents,
+                     fml::RefPtr<fml::TaskRunner> task_runner,
+                     WriteCallback callback) = 0;
+
+ protected:
+  AsyncFileIO();
+
+  // Calls |callback| on |task_runner|, or right away if that is null.
+  static void Deliver(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                      fml::UniqueClosure callback);
+
+  // Reads the file with blocking calls, or returns null.
+  static std::unique_ptr<fml::Mapping> ReadFileBlocking(
+      const fml::UniqueFD& directory,
+      const std::string& path);
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(AsyncFileIO);
+};
+
+// The fallback implementation, which makes blocking calls on the workers of a
+// concurrent message loop.
+class ThreadPoolFileIO final : public AsyncFileIO {
+ public:
+  explicit ThreadPoolFileIO(size_t thread_count);
+
+  ~ThreadPoolFileIO() override;
+
+  // |AsyncFileIO|
+  void ReadBatch(const fml::UniqueFD& directory,
+                 std::vector<ReadRequest> requests,
+                 fml::RefPtr<fml::TaskRunner> task_runner) override;
+
+  // |AsyncFileIO|
+  void Write(const fml::UniqueFD& directory,
+             std::string path,
+             std::unique_ptr<const fml::Mapping> contents,
+             fml::RefPtr<fml::TaskRunner> task_runner,
+             WriteCallback callback) override;
+
+ private:
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> workers_;
+  // The requests that were posted but haven't completed yet.
+  std::mutex pending_mutex_;
+  std::condition_variable pending_done_;
+  size_t pending_ = 0;
+
+  void Post(fml::UniqueClosure request);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadPoolFileIO);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_ASYNC_FILE_IO_H_
@@ -0,0 +1,165 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/async_file_io.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+namespace {
+
+std::string ToString(const fml::Mapping& mapping) {
+  return {reinterpret_cast<const char*>(mapping.GetMapping()),
+          mapping.GetSize()};
+}
+
+void CheckReadsBatchesOfFiles(std::unique_ptr<AsyncFileIO> io) {
+  fml::ScopedTemporaryDirectory dir;
+  const size_t file_count = 300;
+  for (size_t i = 0; i < file_count; i++) {
+    const auto name = std::to_string(i);
+    ASSERT_TRUE(fml::WriteAtomically(dir.fd(), name.c_str(),
+                                     fml::DataMapping("contents " + name)));
+  }
+  ASSERT_TRUE(fml::OpenFile(dir.fd(), "empty", true,
+                            fml::FilePermission::kReadWrite)
+                  .is_valid());
+
+  // All files, then an empty one and one that isn't there.
+  const size_t request_count = file_count + 2;
+  std::vector<std::unique_ptr<fml::Mapping>> results(request_count);
+  std::vector<bool> called(request_count, false);
+  fml::CountDownLatch latch(request_count);
+  std::vector<AsyncFileIO::ReadRequest> requests;
+  for (size_t i = 0; i < request_count; i++) {
+    std::string path = std::to_string(i);
+    if (i == file_count) {
+      path = "empty";
+    } else if (i == file_count + 1) {
+      path = "missing";
+    }
+    requests.push_back({path, [&, i](std::unique_ptr<fml::Mapping> result) {
+                          results[i] = std::move(result);
+                          called[i] = true;
+                          latch.CountDown();
+                        }});
+  }
+  io->ReadBatch(dir.fd(), std::move(requests), nullptr);
+  latch.Wait();
+
+  for (size_t i = 0; i < file_count; i++) {
+    ASSERT_TRUE(results[i]);
+    ASSERT_EQ(ToString(*results[i]), "contents " + std::to_string(i));
+  }
+  ASSERT_TRUE(results[file_count]);
+  ASSERT_EQ(results[file_count]->GetSize(), 0u);
+  ASSERT_TRUE(called[file_count + 1]);
+  ASSERT_FALSE(results[file_count + 1]);
+  ASSERT_TRUE(fml::RemoveFilesInDirectory(dir.fd()));
+}
+
+void CheckWritesAtomically(std::unique_ptr<AsyncFileIO> io) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(
+      fml::WriteAtomically(dir.fd(), "file", fml::DataMapping("previous")));
+
+  const std::string contents(100000, 'a');
+  fml::AutoResetWaitableEvent written;
+  bool success = false;
+  io->Write(dir.fd(), "file", std::make_unique<fml::DataMapping>(contents),
+            nullptr, [&](bool result) {
+              success = result;
+              written.Signal();
+            });
+  written.Wait();
+  ASSERT_TRUE(success);
+  ASSERT_FALSE(fml::FileExists(dir.fd(), "file.temp"));
+
+  fml::AutoResetWaitableEvent read;
+  std::unique_ptr<fml::Mapping> result;
+  io->Read(dir.fd(), "file", nullptr,
+           [&](std::unique_ptr<fml::Mapping> mapping) {
+             result = std::move(mapping);
+             read.Signal();
+           });
+  read.Wait();
+  ASSERT_TRUE(result);
+  ASSERT_EQ(ToString(*result), contents);
+  ASSERT_TRUE(fml::RemoveFilesInDirectory(dir.fd()));
+}
+
+void CheckCallsBackOnTheTaskRunner(std::unique_ptr<AsyncFileIO> io) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "file", fml::DataMapping("a")));
+  fml::Thread thread;
+  auto task_runner = thread.GetTaskRunner();
+
+  fml::AutoResetWaitableEvent done;
+  bool on_task_runner = false;
+  io->Read(dir.fd(), "file", task_runner,
+           [&](std::unique_ptr<fml::Mapping> mapping) {
+             on_task_runner = task_runner->RunsTasksOnCurrentThread();
+             done.Signal();
+           });
+  done.Wait();
+  ASSERT_TRUE(on_task_runner);
+  ASSERT_TRUE(fml::RemoveFilesInDirectory(dir.fd()));
+}
+
+void CheckCompletesRequestsWhenDestroyed(std::unique_ptr<AsyncFileIO> io) {
+  fml::ScopedTemporaryDirectory dir;
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "file", fml::DataMapping("a")));
+  std::atomic<size_t> completed = {0};
+  std::vector<AsyncFileIO::ReadRequest> requests;
+  for (size_t i = 0; i < 200; i++) {
+    requests.push_back(
+        {"file", [&completed](std::unique_ptr<fml::Mapping> mapping) {
+           if (mapping) {
+             completed++;
+           }
+         }});
+  }
+  io->ReadBatch(dir.fd(), std::move(requests), nullptr);
+  io.reset();
+  ASSERT_EQ(completed, 200u);
+  ASSERT_TRUE(fml::RemoveFilesInDirectory(dir.fd()));
+}
+
+}  // namespace
+
+// Each test runs with the implementation for the platform and with the thread
+// pool, which is what the other platforms use.
+
+TEST(AsyncFileIOTest, ReadsBatchesOfFiles) {
+  CheckReadsBatchesOfFiles(AsyncFileIO::Create());
+  CheckReadsBatchesOfFiles(AsyncFileIO::CreateWithThreadPool(2));
+}
+
+TEST(AsyncFileIOTest, WritesAtomically) {
+  CheckWritesAtomically(AsyncFileIO::Create());
+  CheckWritesAtomically(AsyncFileIO::CreateWithThreadPool(2));
+}
+
+TEST(AsyncFileIOTest, CallsBackOnTheTaskRunner) {
+  CheckCallsBackOnTheTaskRunner(AsyncFileIO::Create());
+  CheckCallsBackOnTheTaskRunner(AsyncFileIO::CreateWithThreadPool(2));
+}
+
+TEST(AsyncFileIOTest, CompletesRequestsWhenDestroyed) {
+  CheckCompletesRequestsWhenDestroyed(AsyncFileIO::Create());
+  CheckCompletesRequestsWhenDestroyed(AsyncFileIO::CreateWithThreadPool(2));
+}
+
+}  // namespace testing
+}  // namespace fml
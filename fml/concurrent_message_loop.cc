@@ -5,25 +5,45 @@
 #include "flutter/fml/concurrent_message_loop.h"
 
 #include <algorithm>
+#include <optional>
 
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+static SyncProfiler::Site gWorkerQueueMutexSite(
+    "ConcurrentMessageLoop::WorkerQueue::mutex");
+static SyncProfiler::Site gTaskDurationSite(
+    "ConcurrentMessageLoop.task_duration");
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
+  return Create(worker_count, Thread::ThreadConfig{"io.flutter.worker."});
+}
+
+std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
+    size_t worker_count,
+    const Thread::ThreadConfig& worker_config) {
   return std::shared_ptr<ConcurrentMessageLoop>{
-      new ConcurrentMessageLoop(worker_count)};
+      new ConcurrentMessageLoop(worker_count, worker_config)};
 }
 
-ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
+ConcurrentMessageLoop::ConcurrentMessageLoop(
+    size_t worker_count,
+    const Thread::ThreadConfig& worker_config)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
   for (size_t i = 0; i < worker_count_; ++i) {
-    workers_.emplace_back([i, this]() {
-      fml::Thread::SetCurrentThreadName(
-          std::string{"io.flutter.worker." + std::to_string(i + 1)});
-      WorkerMain();
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
+  for (size_t i = 0; i < worker_count_; ++i) {
+    Thread::ThreadConfig config = worker_config;
+    config.name += std::to_string(i + 1);
+    workers_.emplace_back([config, i, this]() {
+      fml::Thread::SetCurrentThreadConfig(config);
+      WorkerMain(i);
     });
   }
 
@@ -47,80 +67,195 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(fml::UniqueClosure task,
+                                     ConcurrentTaskPriority priority) {
+  // Tasks posted by a task likely work on the same data, keep them on the
+  // worker that has it cached.
+  size_t worker = GetCurrentWorker();
+  if (worker == kNoWorker) {
+    worker = next_worker_.fetch_add(1, std::memory_order_relaxed);
+  }
+  PostTaskToWorker(std::move(task), worker % worker_count_, priority);
+}
+
+void ConcurrentMessageLoop::PostTaskToWorker(fml::UniqueClosure task,
+                                             size_t worker,
+                                             ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
+  const size_t priority_index = static_cast<size_t>(priority);
+  WorkerQueue& queue = *worker_queues_[worker];
+  {
+    auto lock = SyncProfiler::Lock(queue.mutex, gWorkerQueueMutexSite);
+    queue.tasks[priority_index].push_back(
+        {std::move(task), fml::TimePoint::Now()});
+    pending_tasks_by_priority_[priority_index]++;
+    pending_tasks_++;
+  }
+
+  WakeUpWorkers(false);
+}
+
+void ConcurrentMessageLoop::WakeUpWorkers(bool all) {
+  // Workers count themselves as sleeping before checking for tasks one last
+  // time, so either they see the task or this sees them.
+  if (sleeping_workers_ == 0) {
+    return;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  // Waits for a worker that is about to sleep to start waiting on the
+  // condition. Notifying with the mutex unlocked avoids waking the worker
+  // just to have it wait for the mutex.
+  { std::scoped_lock lock(sleep_mutex_); }
 
-  tasks_condition_.notify_one();
+  if (all) {
+    sleep_condition_.notify_all();
+  } else {
+    sleep_condition_.notify_one();
+  }
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
+void ConcurrentMessageLoop::WorkerMain(size_t worker) {
+  WorkerQueue& queue = *worker_queues_[worker];
   while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
-
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+    if (queue.has_thread_tasks) {
+      std::vector<fml::closure> thread_tasks;
+      {
+        auto lock = SyncProfiler::Lock(queue.mutex, gWorkerQueueMutexSite);
+        std::swap(thread_tasks, queue.thread_tasks);
+        queue.has_thread_tasks = false;
+      }
+      for (const auto& thread_task : thread_tasks) {
+        thread_task();
+      }
+    }
 
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
+    // Tasks still queued at shutdown are dropped.
+    if (shutdown_) {
+      break;
     }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+    if (fml::UniqueClosure task = TakeTask(worker)) {
+      TRACE_EVENT0("fml", "ConcurrentWorkerWake");
+      if (SyncProfiler::IsEnabled()) {
+        const auto start = fml::TimePoint::Now();
+        task();
+        gTaskDurationSite.Get().Add(fml::TimePoint::Now() - start);
+        SyncProfiler::MaybeTraceCounters();
+      } else {
+        task();
+      }
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
+    std::unique_lock lock(sleep_mutex_);
+    sleeping_workers_++;
+    sleep_condition_.wait(lock, [&]() {
+      return pending_tasks_ > 0 || shutdown_ || queue.has_thread_tasks;
+    });
+    sleeping_workers_--;
+  }
+}
 
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
-      task();
+fml::UniqueClosure ConcurrentMessageLoop::TakeTask(size_t worker) {
+  for (size_t priority = 0; priority < kPriorityCount; ++priority) {
+    if (pending_tasks_by_priority_[priority] == 0) {
+      continue;
     }
+    if (fml::UniqueClosure task = TakeTaskOfPriority(worker, priority)) {
+      return task;
+    }
+  }
+  return {};
+}
 
-    // Execute any thread tasks.
-    for (const auto& thread_task : thread_tasks) {
-      thread_task();
+fml::UniqueClosure ConcurrentMessageLoop::TakeTaskOfPriority(size_t worker,
+                                                             size_t priority) {
+  std::optional<QueuedTask> queued_task;
+
+  {
+    WorkerQueue& queue = *worker_queues_[worker];
+    auto lock = SyncProfiler::Lock(queue.mutex, gWorkerQueueMutexSite);
+    auto& tasks = queue.tasks[priority];
+    if (!tasks.empty()) {
+      queued_task = std::move(tasks.front());
+      tasks.pop_front();
     }
+  }
 
-    if (shutdown_now) {
-      break;
+  // Steal the most recently posted task of the first other worker that has
+  // any. The oldest tasks are left to the worker they were posted to.
+  for (size_t i = 1; !queued_task && i < worker_count_ &&
+                     pending_tasks_by_priority_[priority] > 0;
+       ++i) {
+    WorkerQueue& queue = *worker_queues_[(worker + i) % worker_count_];
+    auto lock = SyncProfiler::Lock(queue.mutex, gWorkerQueueMutexSite);
+    auto& tasks = queue.tasks[priority];
+    if (!tasks.empty()) {
+      queued_task = std::move(tasks.back());
+      tasks.pop_back();
     }
   }
+
+  if (!queued_task) {
+    return {};
+  }
+
+  pending_tasks_by_priority_[priority]--;
+  pending_tasks_--;
+  TraceQueueLatency(priority, queued_task->post_time);
+  return std::move(queued_task->task);
+}
+
+void ConcurrentMessageLoop::TraceQueueLatency(size_t priority,
+                                              fml::TimePoint post_time) const {
+  static const char* kCounterNames[kPriorityCount] = {
+      "ConcurrentQueueLatencyHigh",
+      "ConcurrentQueueLatencyNormal",
+      "ConcurrentQueueLatencyLow",
+  };
+  static SyncProfiler::Site sites[kPriorityCount] = {
+      SyncProfiler::Site("ConcurrentMessageLoop.queue_latency.high"),
+      SyncProfiler::Site("ConcurrentMessageLoop.queue_latency.normal"),
+      SyncProfiler::Site("ConcurrentMessageLoop.queue_latency.low"),
+  };
+  const fml::TimeDelta latency = fml::TimePoint::Now() - post_time;
+  FML_TRACE_COUNTER(
+      "fml", kCounterNames[priority], reinterpret_cast<int64_t>(this),  //
+      "micros", latency.ToMicroseconds()                                 //
+  );
+  if (SyncProfiler::IsEnabled()) {
+    sites[priority].Get().Add(latency);
+  }
+}
+
+size_t ConcurrentMessageLoop::GetCurrentWorker() const {
+  const auto current_thread_id = std::this_thread::get_id();
+  for (size_t i = 0; i < worker_thread_ids_.size(); ++i) {
+    if (worker_thread_ids_[i] == current_thread_id) {
+      return i;
+    }
+  }
+  return kNoWorker;
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
-  shutdown_ = true;
-  tasks_condition_.notify_all();
+  {
+    std::scoped_lock lock(sleep_mutex_);
+    shutdown_ = true;
+  }
+  sleep_condition_.notify_all();
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +263,12 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& queue : worker_queues_) {
+    auto lock = SyncProfiler::Lock(queue->mutex, gWorkerQueueMutexSite);
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  WakeUpWorkers(true);
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -154,13 +277,34 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
-void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+void ConcurrentTaskRunner::PostTask(fml::UniqueClosure task,
+                                    ConcurrentTaskPriority priority) {
+  if (!task) {
+    return;
+  }
+
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTask(std::move(task), priority);
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the task on the callers thread.";
+  task();
+}
+
+void ConcurrentTaskRunner::PostTaskWithAffinity(
+    fml::UniqueClosure task,
+    size_t affinity,
+    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTaskToWorker(std::move(task), affinity % loop->worker_count_,
+                           priority);
     return;
   }
 
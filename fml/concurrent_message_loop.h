@@ -5,24 +5,57 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_closure.h"
 
 namespace fml {
 
 class ConcurrentTaskRunner;
 
+// The classes of tasks a ConcurrentMessageLoop runs. Workers run all queued
+// tasks of a class before any task of the classes below it.
+enum class ConcurrentTaskPriority {
+  // Work a pending frame waits on, like the shader compiles Skia offloads.
+  kHigh,
+  // The default class, used by image decodes.
+  kNormal,
+  // Speculative work that may be deferred for as long as there is other work.
+  kLow,
+};
+
+// A pool of workers for tasks that may run on any thread.
+//
+// Each worker has a queue of its own. Tasks posted from a worker are queued on
+// that worker and tasks posted from other threads are spread over the workers
+// in turn. Workers run the tasks of their own queue in the order they were
+// posted and steal the most recently posted tasks of the other queues once
+// theirs is empty. A task of a higher |ConcurrentTaskPriority| is taken,
+// stealing it if need be, before any task of a lower one. The time tasks of
+// each class spend queued is traced as a counter.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
   static std::shared_ptr<ConcurrentMessageLoop> Create(
       size_t worker_count = std::thread::hardware_concurrency());
 
+  // Creates a loop whose workers are configured with |worker_config|. The
+  // number of each worker is appended to the name in the config.
+  static std::shared_ptr<ConcurrentMessageLoop> Create(
+      size_t worker_count,
+      const Thread::ThreadConfig& worker_config);
+
   ~ConcurrentMessageLoop();
 
   size_t GetWorkerCount() const;
@@ -36,24 +69,62 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount =
+      static_cast<size_t>(ConcurrentTaskPriority::kLow) + 1;
+
+  struct QueuedTask {
+    fml::UniqueClosure task;
+    fml::TimePoint post_time;
+  };
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    // The queued tasks of each |ConcurrentTaskPriority|.
+    std::array<std::deque<QueuedTask>, kPriorityCount> tasks;
+    // The tasks posted with |PostTaskToAllWorkers|, which may not be stolen.
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_bool has_thread_tasks = {false};
+  };
+
+  static constexpr size_t kNoWorker = static_cast<size_t>(-1);
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
   std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::atomic_size_t next_worker_ = {0};
+  // The number of tasks in all |WorkerQueue::tasks|. Workers only go to sleep
+  // when there are none.
+  std::atomic_size_t pending_tasks_ = {0};
+  // The number of those tasks of each priority, so that workers only look
+  // through the queues of the classes that have any.
+  std::array<std::atomic_size_t, kPriorityCount> pending_tasks_by_priority_ =
+      {};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  std::atomic_size_t sleeping_workers_ = {0};
+  std::atomic_bool shutdown_ = {false};
+
+  ConcurrentMessageLoop(size_t worker_count,
+                        const Thread::ThreadConfig& worker_config);
+
+  void WorkerMain(size_t worker);
+
+  void PostTask(fml::UniqueClosure task, ConcurrentTaskPriority priority);
+
+  void PostTaskToWorker(fml::UniqueClosure task,
+                        size_t worker,
+                        ConcurrentTaskPriority priority);
 
-  ConcurrentMessageLoop(size_t worker_count);
+  fml::UniqueClosure TakeTask(size_t worker);
 
-  void WorkerMain();
+  fml::UniqueClosure TakeTaskOfPriority(size_t worker, size_t priority);
 
-  void PostTask(const fml::closure& task);
+  void TraceQueueLatency(size_t priority, fml::TimePoint post_time) const;
 
-  bool HasThreadTasksLocked() const;
+  void WakeUpWorkers(bool all);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  size_t GetCurrentWorker() const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -64,7 +135,17 @@ class ConcurrentTaskRunner {
 
   ~ConcurrentTaskRunner();
 
-  void PostTask(const fml::closure& task);
+  void PostTask(
+      fml::UniqueClosure task,
+      ConcurrentTaskPriority priority = ConcurrentTaskPriority::kNormal);
+
+  // Tasks posted with the same |affinity| are queued on the same worker, which
+  // keeps the data they work on in its caches. Idle workers may still steal
+  // them.
+  void PostTaskWithAffinity(
+      fml::UniqueClosure task,
+      size_t affinity,
+      ConcurrentTaskPriority priority = ConcurrentTaskPriority::kNormal);
 
  private:
   friend ConcurrentMessageLoop;
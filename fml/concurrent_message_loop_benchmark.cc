@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static const size_t kTasksPerIteration = 1000;
+
+// Posts small tasks from |state.range(0)| threads at once that are not
+// workers of the loop, like the raster and IO threads do.
+static void BM_ConcurrentLoopPostFromThreads(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create();
+  auto task_runner = loop->GetTaskRunner();
+  const size_t num_threads = state.range(0);
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_threads * kTasksPerIteration);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.emplace_back([&task_runner, &latch]() {
+        for (size_t j = 0; j < kTasksPerIteration; j++) {
+          task_runner->PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_threads *
+                          kTasksPerIteration);
+}
+
+// Fans out from tasks running on the workers, like decodes that split their
+// work in parts do.
+static void BM_ConcurrentLoopFanOutFromWorkers(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create();
+  auto task_runner = loop->GetTaskRunner();
+  const size_t fan_out = state.range(0);
+  const size_t num_parents = kTasksPerIteration / fan_out;
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(num_parents * (fan_out + 1));
+    for (size_t i = 0; i < num_parents; i++) {
+      task_runner->PostTask([&task_runner, &latch, fan_out]() {
+        for (size_t j = 0; j < fan_out; j++) {
+          task_runner->PostTask([&latch]() { latch.CountDown(); });
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_parents * (fan_out + 1));
+}
+
+// Posts tasks that all want the same worker, leaving the others to steal.
+static void BM_ConcurrentLoopPostWithAffinity(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create();
+  auto task_runner = loop->GetTaskRunner();
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTasksPerIteration);
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      task_runner->PostTaskWithAffinity([&latch]() { latch.CountDown(); }, 0);
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+static void BM_ConcurrentLoopPostToAllWorkers(benchmark::State& state) {
+  auto loop = ConcurrentMessageLoop::Create();
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(loop->GetWorkerCount());
+    loop->PostTaskToAllWorkers([&latch]() { latch.CountDown(); });
+    latch.Wait();
+  }
+}
+
+BENCHMARK(BM_ConcurrentLoopPostFromThreads)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentLoopFanOutFromWorkers)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentLoopPostWithAffinity)->UseRealTime();
+BENCHMARK(BM_ConcurrentLoopPostToAllWorkers)->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -6,19 +6,28 @@
 
 #include "flutter/fml/delayed_task.h"
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+
+#include "flutter/fml/logging.h"
+
 namespace fml {
 
 DelayedTask::DelayedTask(size_t order,
-                         const fml::closure& task,
+                         fml::UniqueClosure task,
                          fml::TimePoint target_time)
-    : order_(order), task_(task), target_time_(target_time) {}
+    : order_(order), task_(std::move(task)), target_time_(target_time) {}
 
-DelayedTask::DelayedTask(const DelayedTask& other) = default;
+DelayedTask::DelayedTask(DelayedTask&& other) = default;
+
+DelayedTask& DelayedTask::operator=(DelayedTask&& other) = default;
 
 DelayedTask::~DelayedTask() = default;
 
-const fml::closure& DelayedTask::GetTask() const {
-  return task_;
+fml::UniqueClosure DelayedTask::TakeTask() const {
+  return std::move(task_);
 }
 
 fml::TimePoint DelayedTask::GetTargetTime() const {
@@ -32,4 +41,257 @@ bool DelayedTask::operator>(const DelayedTask& other) const {
   return target_time_ > other.target_time_;
 }
 
+namespace {
+
+constexpr size_t kWheelLevels = 4;
+constexpr size_t kWheelSlotBits = 6;
+constexpr size_t kWheelSlots = 1 << kWheelSlotBits;
+
+}  // namespace
+
+// A task is in the slot of its tick, the number of whole tolerances since the
+// epoch, at the lowest level where the tick only differs from |base_tick| in
+// the bits of that level. Every task in the wheel is at or after |base_tick|,
+// and every task in the heap is before it. Tasks too far away for the top
+// level wait in |overflow| until the wheel runs empty.
+struct DelayedTaskQueue::Wheel {
+  explicit Wheel(int64_t granularity) : granularity(granularity) {}
+
+  const int64_t granularity;
+  uint64_t base_tick = 0;
+  size_t size = 0;
+  std::array<uint64_t, kWheelLevels> occupied = {};
+  std::array<std::array<std::vector<DelayedTask>, kWheelSlots>, kWheelLevels>
+      slots;
+  std::vector<DelayedTask> overflow;
+
+  uint64_t GetTick(const DelayedTask& task) const {
+    const int64_t nanos = task.GetTargetTime().ToEpochDelta().ToNanoseconds();
+    return nanos > 0 ? nanos / granularity : 0;
+  }
+
+  void Insert(DelayedTask task) {
+    const uint64_t tick = GetTick(task);
+    FML_DCHECK(tick >= base_tick);
+    const uint64_t differing = tick ^ base_tick;
+    size_t level = 0;
+    while (level < kWheelLevels &&
+           (differing >> (kWheelSlotBits * (level + 1))) != 0) {
+      level++;
+    }
+    if (level == kWheelLevels) {
+      overflow.push_back(std::move(task));
+      return;
+    }
+    const size_t slot = (tick >> (kWheelSlotBits * level)) % kWheelSlots;
+    slots[level][slot].push_back(std::move(task));
+    occupied[level] |= uint64_t{1} << slot;
+    size++;
+  }
+
+  // Removes the tasks of a slot, leaving it empty.
+  std::vector<DelayedTask> TakeSlot(size_t level, size_t slot) {
+    std::vector<DelayedTask> tasks;
+    tasks.swap(slots[level][slot]);
+    occupied[level] &= ~(uint64_t{1} << slot);
+    size -= tasks.size();
+    return tasks;
+  }
+
+  size_t GetCurrentSlot(size_t level) const {
+    return (base_tick >> (kWheelSlotBits * level)) % kWheelSlots;
+  }
+
+  // The first occupied slot of |level| at or after the one of |base_tick|, or
+  // |kWheelSlots| if there is none.
+  size_t FindSlot(size_t level) const {
+    const size_t current = GetCurrentSlot(level);
+    const uint64_t candidates = occupied[level] >> current;
+    if (candidates == 0) {
+      return kWheelSlots;
+    }
+    size_t slot = current;
+    while (((candidates >> (slot - current)) & 1) == 0) {
+      slot++;
+    }
+    return slot;
+  }
+
+  // Once |base_tick| moves into a slot above the lowest level, the tasks of
+  // that slot may be due before the ones in the levels below. Spreads them
+  // over the levels below, so that the lowest occupied level always has the
+  // earliest tasks.
+  void SpreadCurrentSlots() {
+    for (size_t level = kWheelLevels - 1; level > 0; level--) {
+      const size_t slot = GetCurrentSlot(level);
+      if ((occupied[level] >> slot) & 1) {
+        for (auto& task : TakeSlot(level, slot)) {
+          Insert(std::move(task));
+        }
+      }
+    }
+  }
+};
+
+DelayedTaskQueue::DelayedTaskQueue() = default;
+
+DelayedTaskQueue::~DelayedTaskQueue() = default;
+
+void DelayedTaskQueue::push(DelayedTask task) {
+  if (!wheel_) {
+    PushHeap(std::move(task));
+    return;
+  }
+  const uint64_t tick = wheel_->GetTick(task);
+  if (tick < wheel_->base_tick) {
+    PushHeap(std::move(task));
+    return;
+  }
+  if (wheel_->size == 0 && wheel_->overflow.empty()) {
+    // Moving the base up to the task keeps it out of |overflow|. The heap
+    // only has earlier tasks.
+    wheel_->base_tick = tick;
+  }
+  wheel_->Insert(std::move(task));
+  if (heap_.empty()) {
+    Advance();
+  }
+}
+
+const DelayedTask& DelayedTaskQueue::top() const {
+  FML_DCHECK(!heap_.empty());
+  return heap_.front();
+}
+
+void DelayedTaskQueue::pop() {
+  PopHeap();
+  if (wheel_ && heap_.empty()) {
+    Advance();
+  }
+}
+
+bool DelayedTaskQueue::empty() const {
+  // The heap is only ever empty with the wheel empty too.
+  return heap_.empty();
+}
+
+size_t DelayedTaskQueue::size() const {
+  size_t size = heap_.size();
+  if (wheel_) {
+    size += wheel_->size + wheel_->overflow.size();
+  }
+  return size;
+}
+
+void DelayedTaskQueue::clear() {
+  heap_.clear();
+  if (wheel_) {
+    wheel_ = std::make_unique<Wheel>(wheel_->granularity);
+  }
+}
+
+void DelayedTaskQueue::SetTolerance(fml::TimeDelta tolerance) {
+  if (tolerance == GetTolerance()) {
+    return;
+  }
+  std::vector<DelayedTask> tasks;
+  tasks.reserve(size());
+  while (!heap_.empty()) {
+    tasks.push_back(PopHeap());
+    if (wheel_ && heap_.empty()) {
+      Advance();
+    }
+  }
+  wheel_ = tolerance > fml::TimeDelta::Zero()
+               ? std::make_unique<Wheel>(tolerance.ToNanoseconds())
+               : nullptr;
+  for (auto& task : tasks) {
+    push(std::move(task));
+  }
+}
+
+fml::TimeDelta DelayedTaskQueue::GetTolerance() const {
+  return wheel_ ? fml::TimeDelta::FromNanoseconds(wheel_->granularity)
+                : fml::TimeDelta::Zero();
+}
+
+fml::TimePoint DelayedTaskQueue::GetWakeTime() const {
+  const fml::TimePoint target_time = top().GetTargetTime();
+  if (!wheel_ || target_time == fml::TimePoint::Max() ||
+      target_time <= fml::TimePoint::Now()) {
+    return target_time;
+  }
+  const int64_t slot_end = (wheel_->GetTick(top()) + 1) * wheel_->granularity;
+  return std::max(target_time, fml::TimePoint::FromEpochDelta(
+                                   fml::TimeDelta::FromNanoseconds(slot_end)));
+}
+
+void DelayedTaskQueue::PushHeap(DelayedTask task) {
+  heap_.push_back(std::move(task));
+  std::push_heap(heap_.begin(), heap_.end(), std::greater<DelayedTask>());
+}
+
+DelayedTask DelayedTaskQueue::PopHeap() {
+  FML_DCHECK(!heap_.empty());
+  std::pop_heap(heap_.begin(), heap_.end(), std::greater<DelayedTask>());
+  DelayedTask task = std::move(heap_.back());
+  heap_.pop_back();
+  return task;
+}
+
+void DelayedTaskQueue::Advance() {
+  FML_DCHECK(heap_.empty());
+  Wheel& wheel = *wheel_;
+  while (wheel.size > 0 || !wheel.overflow.empty()) {
+    if (wheel.size == 0) {
+      // Only far away tasks are left. Start over from the earliest of them.
+      std::vector<DelayedTask> overflow;
+      overflow.swap(wheel.overflow);
+      uint64_t earliest = std::numeric_limits<uint64_t>::max();
+      for (const auto& task : overflow) {
+        earliest = std::min(earliest, wheel.GetTick(task));
+      }
+      wheel.base_tick = earliest;
+      for (auto& task : overflow) {
+        wheel.Insert(std::move(task));
+      }
+      continue;
+    }
+
+    size_t level = 0;
+    size_t slot = kWheelSlots;
+    for (; level < kWheelLevels; level++) {
+      slot = wheel.FindSlot(level);
+      if (slot != kWheelSlots) {
+        break;
+      }
+    }
+    FML_DCHECK(level < kWheelLevels);
+
+    const size_t level_shift = kWheelSlotBits * level;
+    const uint64_t slot_start =
+        ((wheel.base_tick >> (level_shift + kWheelSlotBits))
+         << (level_shift + kWheelSlotBits)) |
+        (static_cast<uint64_t>(slot) << level_shift);
+    std::vector<DelayedTask> tasks = wheel.TakeSlot(level, slot);
+    if (level == 0) {
+      // All of these have the same tick, and nothing else in the wheel is
+      // that early.
+      wheel.base_tick = slot_start + 1;
+      wheel.SpreadCurrentSlots();
+      for (auto& task : tasks) {
+        PushHeap(std::move(task));
+      }
+      return;
+    }
+    // Nothing is due before this slot, move on to its start.
+    FML_DCHECK(slot_start > wheel.base_tick);
+    wheel.base_tick = slot_start;
+    for (auto& task : tasks) {
+      wheel.Insert(std::move(task));
+    }
+    wheel.SpreadCurrentSlots();
+  }
+}
+
 }  // namespace fml
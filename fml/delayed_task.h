@@ -5,24 +5,31 @@
 #ifndef FLUTTER_FML_DELAYED_TASK_H_
 #define FLUTTER_FML_DELAYED_TASK_H_
 
-#include "flutter/fml/closure.h"
-#include "flutter/fml/time/time_point.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-#include <queue>
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_closure.h"
 
 namespace fml {
 
 class DelayedTask {
  public:
   DelayedTask(size_t order,
-              const fml::closure& task,
+              fml::UniqueClosure task,
               fml::TimePoint target_time);
 
-  DelayedTask(const DelayedTask& other);
+  DelayedTask(DelayedTask&& other);
+
+  DelayedTask& operator=(DelayedTask&& other);
 
   ~DelayedTask();
 
-  const fml::closure& GetTask() const;
+  // Moves the task out. The order of tasks doesn't depend on the task, so this
+  // may be done to the top of a |DelayedTaskQueue| right before popping it.
+  fml::UniqueClosure TakeTask() const;
 
   fml::TimePoint GetTargetTime() const;
 
@@ -30,13 +37,64 @@ class DelayedTask {
 
  private:
   size_t order_;
-  fml::closure task_;
+  mutable fml::UniqueClosure task_;
   fml::TimePoint target_time_;
 };
 
-using DelayedTaskQueue = std::priority_queue<DelayedTask,
-                                             std::deque<DelayedTask>,
-                                             std::greater<DelayedTask>>;
+// A priority queue of delayed tasks, with the task to run next on top.
+//
+// By default this is a binary heap. With a tolerance set, tasks are first put
+// into the slots of a hierarchical timing wheel, each as wide as the
+// tolerance, and only the tasks of the earliest slot are kept in the heap.
+// Inserting far away tasks, such as timeouts that are hardly ever reached,
+// then takes constant time and keeps the heap small. The order of the tasks
+// is the same either way.
+class DelayedTaskQueue {
+ public:
+  DelayedTaskQueue();
+
+  ~DelayedTaskQueue();
+
+  void push(DelayedTask task);
+
+  const DelayedTask& top() const;
+
+  void pop();
+
+  bool empty() const;
+
+  size_t size() const;
+
+  void clear();
+
+  // Moves the tasks into a timing wheel with slots of |tolerance|, or back
+  // into a plain heap if |tolerance| is zero.
+  void SetTolerance(fml::TimeDelta tolerance);
+
+  fml::TimeDelta GetTolerance() const;
+
+  // The time to wake up for the task on top. With a tolerance, wake ups for
+  // tasks that aren't due yet are deferred to the end of the slot of the
+  // task, so that the tasks of a slot, of this or any other queue with the
+  // same tolerance, are run by a single wake up.
+  fml::TimePoint GetWakeTime() const;
+
+ private:
+  struct Wheel;
+
+  // Tasks that are due before any task in |wheel_|, as a min-heap.
+  std::vector<DelayedTask> heap_;
+  std::unique_ptr<Wheel> wheel_;
+
+  void PushHeap(DelayedTask task);
+
+  DelayedTask PopHeap();
+
+  // Moves the earliest slot of the wheel into the empty heap.
+  void Advance();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DelayedTaskQueue);
+};
 
 }  // namespace fml
 
@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/delayed_task.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+namespace {
+
+// Pushes tasks at random times within |spread| of |start|, popping some in
+// between, into a plain queue and one with |tolerance|, and checks that both
+// pop the tasks in the same order.
+void CheckSameOrder(fml::TimeDelta tolerance,
+                    fml::TimePoint start,
+                    fml::TimeDelta spread) {
+  DelayedTaskQueue heap;
+  DelayedTaskQueue wheel;
+  wheel.SetTolerance(tolerance);
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int64_t> offset(0, spread.ToNanoseconds());
+  size_t order = 0;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 50; i++) {
+      const fml::TimePoint target_time =
+          start + fml::TimeDelta::FromNanoseconds(offset(random));
+      heap.push({order, nullptr, target_time});
+      wheel.push({order, nullptr, target_time});
+      order++;
+    }
+    ASSERT_EQ(heap.size(), wheel.size());
+    // Leave some tasks behind, so tasks are pushed both before and after the
+    // tasks that are in the wheel.
+    for (int i = 0; i < 40; i++) {
+      ASSERT_EQ(heap.top().GetTargetTime(), wheel.top().GetTargetTime());
+      ASSERT_FALSE(heap.top() > wheel.top());
+      ASSERT_FALSE(wheel.top() > heap.top());
+      heap.pop();
+      wheel.pop();
+    }
+    start = start + spread / 20;
+  }
+  while (!heap.empty()) {
+    ASSERT_FALSE(wheel.empty());
+    ASSERT_EQ(heap.top().GetTargetTime(), wheel.top().GetTargetTime());
+    heap.pop();
+    wheel.pop();
+  }
+  ASSERT_TRUE(wheel.empty());
+  ASSERT_EQ(wheel.size(), 0u);
+}
+
+}  // namespace
+
+TEST(DelayedTaskQueueTest, PopsInOrderOfTargetTimeThenPostOrder) {
+  DelayedTaskQueue queue;
+  const auto now = fml::TimePoint::Now();
+  queue.push({0, nullptr, now + fml::TimeDelta::FromMilliseconds(2)});
+  queue.push({1, nullptr, now + fml::TimeDelta::FromMilliseconds(1)});
+  queue.push({2, nullptr, now + fml::TimeDelta::FromMilliseconds(2)});
+  ASSERT_EQ(queue.size(), 3u);
+
+  ASSERT_EQ(queue.top().GetTargetTime(),
+            now + fml::TimeDelta::FromMilliseconds(1));
+  queue.pop();
+  DelayedTask first_of_two = {0, nullptr, queue.top().GetTargetTime()};
+  ASSERT_FALSE(queue.top() > first_of_two);
+  queue.pop();
+  ASSERT_TRUE(queue.top() > first_of_two);
+  queue.pop();
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(DelayedTaskQueueTest, TimingWheelKeepsTheOrderOfTheHeap) {
+  const auto now = fml::TimePoint::Now();
+  // Mostly within the lowest level of the wheel.
+  CheckSameOrder(fml::TimeDelta::FromMilliseconds(1), now,
+                 fml::TimeDelta::FromMilliseconds(50));
+  // Spread out over all levels.
+  CheckSameOrder(fml::TimeDelta::FromMilliseconds(1), now,
+                 fml::TimeDelta::FromSeconds(3600));
+  // Past the top level of the wheel.
+  CheckSameOrder(fml::TimeDelta::FromMicroseconds(1), now,
+                 fml::TimeDelta::FromSeconds(3600));
+}
+
+TEST(DelayedTaskQueueTest, TimingWheelHandlesExtremeTargetTimes) {
+  DelayedTaskQueue queue;
+  queue.SetTolerance(fml::TimeDelta::FromMilliseconds(4));
+  const auto now = fml::TimePoint::Now();
+  queue.push({0, nullptr, fml::TimePoint::Max()});
+  queue.push({1, nullptr, fml::TimePoint()});
+  queue.push({2, nullptr, now});
+  ASSERT_EQ(queue.top().GetTargetTime(), fml::TimePoint());
+  queue.pop();
+  ASSERT_EQ(queue.top().GetTargetTime(), now);
+  queue.pop();
+  ASSERT_EQ(queue.top().GetTargetTime(), fml::TimePoint::Max());
+  ASSERT_EQ(queue.GetWakeTime(), fml::TimePoint::Max());
+  queue.pop();
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(DelayedTaskQueueTest, SettingAToleranceKeepsTheTasks) {
+  DelayedTaskQueue queue;
+  const auto now = fml::TimePoint::Now();
+  for (size_t i = 0; i < 10; i++) {
+    queue.push({i, nullptr, now + fml::TimeDelta::FromSeconds(10 - i)});
+  }
+  queue.SetTolerance(fml::TimeDelta::FromMilliseconds(16));
+  ASSERT_EQ(queue.GetTolerance(), fml::TimeDelta::FromMilliseconds(16));
+  ASSERT_EQ(queue.size(), 10u);
+  queue.SetTolerance(fml::TimeDelta::Zero());
+  ASSERT_EQ(queue.size(), 10u);
+  for (size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(queue.top().GetTargetTime(),
+              now + fml::TimeDelta::FromSeconds(i + 1));
+    queue.pop();
+  }
+}
+
+TEST(DelayedTaskQueueTest, WakeTimesAreCoalescedWithinTheTolerance) {
+  const auto tolerance = fml::TimeDelta::FromMilliseconds(100);
+  DelayedTaskQueue first;
+  DelayedTaskQueue second;
+  first.SetTolerance(tolerance);
+  second.SetTolerance(tolerance);
+  const auto now = fml::TimePoint::Now();
+
+  // Due tasks wake up right away.
+  first.push({0, nullptr, now});
+  ASSERT_EQ(first.GetWakeTime(), now);
+  first.pop();
+
+  // Tasks due within the same slot wake up at the end of it, no matter which
+  // queue they are in.
+  const auto slot_start = fml::TimePoint::FromEpochDelta(
+      tolerance * ((now.ToEpochDelta() + tolerance * 10) / tolerance));
+  first.push({1, nullptr, slot_start + fml::TimeDelta::FromMilliseconds(10)});
+  second.push({2, nullptr, slot_start + fml::TimeDelta::FromMilliseconds(90)});
+  ASSERT_EQ(first.GetWakeTime(), slot_start + tolerance);
+  ASSERT_EQ(second.GetWakeTime(), slot_start + tolerance);
+
+  // Without a tolerance, tasks wake up on time.
+  DelayedTaskQueue exact;
+  exact.push({3, nullptr, slot_start + fml::TimeDelta::FromMilliseconds(10)});
+  ASSERT_EQ(exact.GetWakeTime(),
+            slot_start + fml::TimeDelta::FromMilliseconds(10));
+}
+
+}  // namespace testing
+}  // namespace fml
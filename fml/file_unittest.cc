@@ -296,3 +296,33 @@ TEST(FileTest, FileTestsSupportsUnicode) {
       fml::IsFile(fml::paths::JoinPaths({dir.path(), filename}).c_str()));
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), filename));
 }
+
+TEST(FileTest, MappingsTakeHintsAndPrefetchRanges) {
+  fml::ScopedTemporaryDirectory dir;
+  const std::string contents(3 * 4096 + 17, 'x');
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "hinted",
+                                   fml::DataMapping(contents)));
+
+  auto mapping = fml::FileMapping::CreateReadOnly(dir.fd(), "hinted");
+  ASSERT_TRUE(mapping);
+  ASSERT_EQ(mapping->GetSize(), contents.size());
+
+#if OS_WIN
+  ASSERT_FALSE(mapping->Prefetch());
+#else
+  ASSERT_TRUE(mapping->SetAccessHint(fml::FileMapping::AccessHint::kRandom));
+  ASSERT_TRUE(
+      mapping->SetAccessHint(fml::FileMapping::AccessHint::kSequential));
+  ASSERT_TRUE(mapping->SetAccessHint(fml::FileMapping::AccessHint::kNormal));
+  ASSERT_TRUE(mapping->Prefetch());
+  // Ranges don't need to be page aligned and are clamped to the mapping.
+  ASSERT_TRUE(mapping->Prefetch(4097, 100));
+  ASSERT_TRUE(mapping->Prefetch(3 * 4096 + 1, 4096));
+  ASSERT_FALSE(mapping->Prefetch(contents.size(), 1));
+#endif  // OS_WIN
+
+  ASSERT_EQ(0, ::memcmp(mapping->GetMapping(), contents.data(),
+                        contents.size()));
+  mapping.reset();
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "hinted"));
+}
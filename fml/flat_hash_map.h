@@ -0,0 +1,430 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_FLAT_HASH_MAP_H_
+#define FLUTTER_FML_FLAT_HASH_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/hash.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      A hash map that stores its entries in a single array instead of
+///             allocating a node per entry, for lookup tables that are hit
+///             every frame.
+///
+///             Collisions are resolved by linear probing with Robin Hood
+///             hashing, which bounds the probe lengths, and erasing shifts the
+///             following entries back instead of leaving tombstones. The
+///             interface follows `std::unordered_map`, except that:
+///
+///             * Inserting an entry invalidates all iterators, pointers and
+///               references into the map, and erasing one invalidates those
+///               to the entries after it. |erase| returns the iterator to the
+///               next entry, so that entries can be erased while iterating.
+///             * Entries are `std::pair<Key, Value>`, whose key must not be
+///               modified.
+///             * The hasher must mix all bits of the keys into the low bits
+///               of the hash, which |fml::Hash| does.
+///
+template <typename Key,
+          typename Value,
+          typename Hasher = Hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = size_t;
+  using hasher = Hasher;
+  using key_equal = KeyEqual;
+
+  template <bool kIsConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashMap::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer =
+        std::conditional_t<kIsConst, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<kIsConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    // Converts iterators to const iterators.
+    template <bool kOtherIsConst,
+              typename = std::enable_if_t<kIsConst && !kOtherIsConst>>
+    Iterator(const Iterator<kOtherIsConst>& other)
+        : distance_(other.distance_), slot_(other.slot_) {}
+
+    reference operator*() const { return *slot_; }
+
+    pointer operator->() const { return slot_; }
+
+    Iterator& operator++() {
+      // The array of distances ends with a sentinel that isn't empty.
+      do {
+        ++distance_;
+        ++slot_;
+      } while (*distance_ < 0);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator result = *this;
+      ++*this;
+      return result;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return distance_ == other.distance_;
+    }
+
+    bool operator!=(const Iterator& other) const {
+      return distance_ != other.distance_;
+    }
+
+   private:
+    friend class FlatHashMap;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(const int16_t* distance, pointer slot)
+        : distance_(distance), slot_(slot) {}
+
+    const int16_t* distance_ = nullptr;
+    pointer slot_ = nullptr;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() = default;
+
+  explicit FlatHashMap(size_t capacity) { reserve(capacity); }
+
+  FlatHashMap(FlatHashMap&& other) noexcept { Swap(other); }
+
+  FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+    if (this != &other) {
+      FlatHashMap released(std::move(other));
+      Swap(released);
+    }
+    return *this;
+  }
+
+  ~FlatHashMap() { Deallocate(); }
+
+  iterator begin() {
+    if (size_ == 0) {
+      return end();
+    }
+    size_t index = 0;
+    while (distances_[index] < 0) {
+      index++;
+    }
+    return MakeIterator(index);
+  }
+
+  const_iterator begin() const {
+    return const_cast<FlatHashMap*>(this)->begin();
+  }
+
+  iterator end() { return MakeIterator(slot_count_); }
+
+  const_iterator end() const { return const_cast<FlatHashMap*>(this)->end(); }
+
+  bool empty() const { return size_ == 0; }
+
+  size_t size() const { return size_; }
+
+  // The number of entries that fit before the map grows.
+  size_t capacity() const { return GetMaxSize(capacity_); }
+
+  void clear() {
+    for (size_t i = 0; i < slot_count_; i++) {
+      if (distances_[i] >= 0) {
+        slots_[i].~value_type();
+        distances_[i] = kEmpty;
+      }
+    }
+    size_ = 0;
+  }
+
+  void reserve(size_t size) {
+    size_t capacity = kMinCapacity;
+    while (GetMaxSize(capacity) < size) {
+      capacity *= 2;
+    }
+    if (capacity > capacity_) {
+      Rehash(capacity, std::max(max_distance_, kMinMaxDistance));
+    }
+  }
+
+  iterator find(const Key& key) {
+    size_t index = FindIndex(key);
+    return index == kNotFound ? end() : MakeIterator(index);
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_cast<FlatHashMap*>(this)->find(key);
+  }
+
+  size_t count(const Key& key) const { return FindIndex(key) != kNotFound; }
+
+  bool contains(const Key& key) const { return FindIndex(key) != kNotFound; }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return Emplace(key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return Emplace(std::move(key), std::forward<Args>(args)...);
+  }
+
+  template <typename Pair>
+  std::pair<iterator, bool> insert(Pair&& value) {
+    return Emplace(std::forward<Pair>(value).first,
+                   std::forward<Pair>(value).second);
+  }
+
+  Value& operator[](const Key& key) { return Emplace(key).first->second; }
+
+  Value& operator[](Key&& key) { return Emplace(std::move(key)).first->second; }
+
+  // Erases the entry at |position| and returns the iterator to the entry after
+  // it.
+  iterator erase(const_iterator position) {
+    size_t index = position.distance_ - distances_.get();
+    FML_DCHECK(index < slot_count_ && distances_[index] >= 0);
+    EraseIndex(index);
+    if (distances_[index] >= 0) {
+      // The next entry was shifted into the erased slot.
+      return MakeIterator(index);
+    }
+    iterator next = MakeIterator(index);
+    return ++next;
+  }
+
+  size_t erase(const Key& key) {
+    size_t index = FindIndex(key);
+    if (index == kNotFound) {
+      return 0;
+    }
+    EraseIndex(index);
+    return 1;
+  }
+
+  // Calls |visitor| with each entry whose key has the same hash as |key|,
+  // including the entry for |key| if there is one. Lets hashers that only hash
+  // part of the key find all the entries that share that part.
+  template <typename Visitor>
+  void ForEachWithHashOf(const Key& key, Visitor visitor) {
+    if (size_ == 0) {
+      return;
+    }
+    const size_t hash = hasher_(key);
+    size_t index = hash & mask_;
+    // Entries with the same home slot are next to each other, starting with
+    // the first one whose distance matches.
+    for (int16_t distance = 0; distances_[index] >= distance;
+         index++, distance++) {
+      if (distances_[index] == distance &&
+          hasher_(slots_[index].first) == hash) {
+        visitor(slots_[index]);
+      }
+    }
+  }
+
+ private:
+  static constexpr int16_t kEmpty = -1;
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+  static constexpr size_t kMinCapacity = 8;
+  static constexpr int16_t kMinMaxDistance = 4;
+  static constexpr int16_t kMaxMaxDistance = 8192;
+
+  // The number of home slots, a power of two. The slot array has
+  // |max_distance_| more slots so that probes never wrap around.
+  size_t capacity_ = 0;
+  size_t mask_ = 0;
+  size_t slot_count_ = 0;
+  int16_t max_distance_ = 0;
+  size_t size_ = 0;
+  // The distance of each entry from its home slot, or |kEmpty|. Has one more
+  // element than the slots, a sentinel that ends iteration and probes.
+  std::unique_ptr<int16_t[]> distances_;
+  value_type* slots_ = nullptr;
+  Hasher hasher_;
+  KeyEqual key_equal_;
+
+  // Keeps the load factor under 3/4.
+  static size_t GetMaxSize(size_t capacity) { return capacity / 4 * 3; }
+
+  iterator MakeIterator(size_t index) {
+    if (slots_ == nullptr) {
+      return iterator();
+    }
+    return iterator(&distances_[index], &slots_[index]);
+  }
+
+  size_t FindIndex(const Key& key) const {
+    if (size_ == 0) {
+      return kNotFound;
+    }
+    size_t index = hasher_(key) & mask_;
+    // Entries are ordered by their distance, so the key isn't in the map once
+    // the probe finds an entry closer to its home slot.
+    for (int16_t distance = 0; distances_[index] >= distance;
+         index++, distance++) {
+      if (key_equal_(slots_[index].first, key)) {
+        return index;
+      }
+    }
+    return kNotFound;
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> Emplace(K&& key, Args&&... args) {
+    if (capacity_ == 0) {
+      Rehash(kMinCapacity, kMinMaxDistance);
+    }
+    size_t index = hasher_(key) & mask_;
+    int16_t distance = 0;
+    for (; distances_[index] >= distance; index++, distance++) {
+      if (key_equal_(slots_[index].first, key)) {
+        return {MakeIterator(index), false};
+      }
+    }
+
+    if (size_ >= GetMaxSize(capacity_)) {
+      Rehash(capacity_ * 2, max_distance_);
+      return Emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    // The entries from |index| to the next empty slot move one slot further
+    // from their home slot. The map is rehashed if that takes one of them, or
+    // the new entry, too far.
+    size_t empty = index;
+    bool fits = distance <= max_distance_;
+    for (; fits && distances_[empty] >= 0; empty++) {
+      fits = distances_[empty] < max_distance_ && empty + 1 < slot_count_;
+    }
+    if (!fits) {
+      if (size_ < GetMaxSize(capacity_) / 2 &&
+          max_distance_ < kMaxMaxDistance) {
+        // Probes only get this long in a sparse map when many keys hash
+        // alike, which more slots don't help with.
+        Rehash(capacity_, max_distance_ * 2);
+      } else {
+        Rehash(capacity_ * 2, max_distance_);
+      }
+      return Emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    if (empty > index) {
+      new (&slots_[empty]) value_type(std::move(slots_[empty - 1]));
+      std::move_backward(&slots_[index], &slots_[empty - 1], &slots_[empty]);
+      for (size_t i = empty; i > index; i--) {
+        distances_[i] = distances_[i - 1] + 1;
+      }
+      slots_[index].~value_type();
+    }
+    new (&slots_[index])
+        value_type(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    distances_[index] = distance;
+    size_++;
+    return {MakeIterator(index), true};
+  }
+
+  void EraseIndex(size_t index) {
+    slots_[index].~value_type();
+    // Shifts the following entries back until one is in its home slot. The
+    // sentinel has a distance of zero.
+    for (; distances_[index + 1] > 0; index++) {
+      new (&slots_[index]) value_type(std::move(slots_[index + 1]));
+      slots_[index + 1].~value_type();
+      distances_[index] = distances_[index + 1] - 1;
+    }
+    distances_[index] = kEmpty;
+    size_--;
+  }
+
+  // Moves the entries to new slots. |max_distance| is raised to the base-2
+  // logarithm of |capacity| if it is smaller.
+  void Rehash(size_t capacity, int16_t max_distance) {
+    FlatHashMap map;
+    map.Allocate(capacity, max_distance);
+    for (size_t i = 0; i < slot_count_; i++) {
+      if (distances_[i] >= 0) {
+        map.Emplace(std::move(slots_[i].first), std::move(slots_[i].second));
+      }
+    }
+    Swap(map);
+  }
+
+  void Allocate(size_t capacity, int16_t max_distance) {
+    FML_DCHECK(capacity_ == 0);
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    int16_t log2_capacity = 0;
+    while ((size_t{1} << log2_capacity) < capacity) {
+      log2_capacity++;
+    }
+    max_distance_ = std::max(max_distance, log2_capacity);
+    slot_count_ = capacity + max_distance_;
+    distances_ = std::make_unique<int16_t[]>(slot_count_ + 1);
+    std::fill_n(distances_.get(), slot_count_, kEmpty);
+    distances_[slot_count_] = 0;
+    slots_ = std::allocator<value_type>().allocate(slot_count_);
+  }
+
+  void Deallocate() {
+    if (slots_ == nullptr) {
+      return;
+    }
+    clear();
+    std::allocator<value_type>().deallocate(slots_, slot_count_);
+    slots_ = nullptr;
+    distances_.reset();
+    capacity_ = mask_ = slot_count_ = 0;
+    max_distance_ = 0;
+  }
+
+  void Swap(FlatHashMap& other) {
+    std::swap(capacity_, other.capacity_);
+    std::swap(mask_, other.mask_);
+    std::swap(slot_count_, other.slot_count_);
+    std::swap(max_distance_, other.max_distance_);
+    std::swap(size_, other.size_);
+    std::swap(distances_, other.distances_);
+    std::swap(slots_, other.slots_);
+    std::swap(hasher_, other.hasher_);
+    std::swap(key_equal_, other.key_equal_);
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FlatHashMap);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_FLAT_HASH_MAP_H_
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/flat_hash_map.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+// Shaped like the raster cache keys and entries: an ID and a matrix, of which
+// only the ID is hashed.
+struct Key {
+  uint64_t id;
+  float matrix[9];
+
+  bool operator==(const Key& other) const {
+    if (id != other.id) {
+      return false;
+    }
+    for (size_t i = 0; i < 9; i++) {
+      if (matrix[i] != other.matrix[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+struct Entry {
+  bool used_this_frame = false;
+  size_t access_count = 0;
+  size_t unused_frames = 0;
+  uint64_t last_access = 0;
+  void* image = nullptr;
+};
+
+// The hash the raster cache used with `std::unordered_map`.
+struct StdHash {
+  size_t operator()(const Key& key) const {
+    return std::hash<uint64_t>()(key.id);
+  }
+};
+
+struct FlatHash {
+  size_t operator()(const Key& key) const { return Hash<uint64_t>()(key.id); }
+};
+
+using StdMap = std::unordered_map<Key, Entry, StdHash>;
+using FlatMap = FlatHashMap<Key, Entry, FlatHash>;
+
+Key MakeKey(size_t index) {
+  // Unique IDs are handed out in sequence, and most appear at a single scale.
+  Key key = {index + 1000, {1, 0, 0, 0, 1, 0, 0, 0, 1}};
+  key.matrix[0] = 1.0f + (index % 3);
+  return key;
+}
+
+template <typename Map>
+void Populate(Map& map, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    map[MakeKey(i)].used_this_frame = i % 4 != 0;
+  }
+}
+
+}  // namespace
+
+// Looks up each of |state.range(0)| entries, like drawing a frame does.
+template <typename Map>
+static void BM_HashMapLookup(benchmark::State& state) {
+  const size_t count = state.range(0);
+  Map map;
+  Populate(map, count);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < count; i++) {
+      auto it = map.find(MakeKey(i));
+      benchmark::DoNotOptimize(it->second.access_count++);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_HashMapLookup, StdMap)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_HashMapLookup, FlatMap)->Range(16, 4096);
+
+// Looks up keys of |state.range(0)| entries that aren't in the map.
+template <typename Map>
+static void BM_HashMapLookupMiss(benchmark::State& state) {
+  const size_t count = state.range(0);
+  Map map;
+  Populate(map, count);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < count; i++) {
+      benchmark::DoNotOptimize(map.find(MakeKey(i + count)) == map.end());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_HashMapLookupMiss, StdMap)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_HashMapLookupMiss, FlatMap)->Range(16, 4096);
+
+// Walks |state.range(0)| entries and erases the quarter that went unused,
+// like the raster cache sweeps after a frame.
+template <typename Map>
+static void BM_HashMapSweep(benchmark::State& state) {
+  const size_t count = state.range(0);
+  Map map;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    map.clear();
+    Populate(map, count);
+    state.ResumeTiming();
+    for (auto it = map.begin(); it != map.end();) {
+      if (!it->second.used_this_frame) {
+        it = map.erase(it);
+      } else {
+        it->second.used_this_frame = false;
+        ++it;
+      }
+    }
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_HashMapSweep, StdMap)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_HashMapSweep, FlatMap)->Range(16, 4096);
+
+// Fills a map with |state.range(0)| entries.
+template <typename Map>
+static void BM_HashMapInsert(benchmark::State& state) {
+  const size_t count = state.range(0);
+  while (state.KeepRunning()) {
+    Map map;
+    Populate(map, count);
+    benchmark::DoNotOptimize(map.size());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_HashMapInsert, StdMap)->Range(16, 4096);
+BENCHMARK_TEMPLATE(BM_HashMapInsert, FlatMap)->Range(16, 4096);
+
+}  // namespace benchmarking
+}  // namespace fml
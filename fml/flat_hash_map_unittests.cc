@@ -0,0 +1,175 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/flat_hash_map.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+
+namespace fml {
+namespace testing {
+
+namespace {
+
+// Hashes keys to one of few hashes to test collisions.
+struct CollidingHash {
+  size_t operator()(int key) const { return key % 4; }
+};
+
+}  // namespace
+
+TEST(FlatHashMapTest, InsertFindErase) {
+  FlatHashMap<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_EQ(map.begin(), map.end());
+
+  EXPECT_TRUE(map.insert(std::make_pair(1, "one")).second);
+  EXPECT_FALSE(map.insert(std::make_pair(1, "uno")).second);
+  EXPECT_TRUE(map.try_emplace(2, "two").second);
+  map[3] = "three";
+  EXPECT_EQ(map.size(), 3u);
+  EXPECT_EQ(map.find(1)->second, "one");
+  EXPECT_EQ(map[2], "two");
+  EXPECT_TRUE(map.contains(3));
+  EXPECT_EQ(map.count(4), 0u);
+
+  EXPECT_EQ(map.erase(1), 1u);
+  EXPECT_EQ(map.erase(1), 0u);
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_EQ(map.size(), 2u);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find(2), map.end());
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMap) {
+  FlatHashMap<uint32_t, uint32_t> map;
+  std::unordered_map<uint32_t, uint32_t> expected;
+  std::mt19937 random(42);
+  for (size_t i = 0; i < 100000; i++) {
+    // Few keys so that erases and inserts of existing keys are common.
+    uint32_t key = random() % 2000;
+    switch (random() % 3) {
+      case 0:
+        map[key] = i;
+        expected[key] = i;
+        break;
+      case 1:
+        EXPECT_EQ(map.erase(key), expected.erase(key));
+        break;
+      default: {
+        auto it = map.find(key);
+        auto expected_it = expected.find(key);
+        ASSERT_EQ(it == map.end(), expected_it == expected.end());
+        if (it != map.end()) {
+          EXPECT_EQ(it->second, expected_it->second);
+        }
+      }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+  }
+
+  size_t visited = 0;
+  for (const auto& [key, value] : map) {
+    EXPECT_EQ(expected[key], value);
+    visited++;
+  }
+  EXPECT_EQ(visited, expected.size());
+}
+
+TEST(FlatHashMapTest, EraseWhileIterating) {
+  FlatHashMap<int, int, CollidingHash> map;
+  for (int i = 0; i < 100; i++) {
+    map[i] = i;
+  }
+
+  std::vector<int> visited;
+  for (auto it = map.begin(); it != map.end();) {
+    visited.push_back(it->first);
+    if (it->first % 3 == 0) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Each entry is visited exactly once even though erasing shifts entries.
+  std::sort(visited.begin(), visited.end());
+  ASSERT_EQ(visited.size(), 100u);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(visited[i], i);
+    EXPECT_EQ(map.contains(i), i % 3 != 0);
+  }
+  EXPECT_EQ(map.size(), 66u);
+}
+
+TEST(FlatHashMapTest, ForEachWithHashOf) {
+  FlatHashMap<int, int, CollidingHash> map;
+  for (int i = 0; i < 40; i++) {
+    map[i] = i;
+  }
+  std::vector<int> keys;
+  map.ForEachWithHashOf(
+      6, [&keys](std::pair<int, int>& entry) { keys.push_back(entry.first); });
+  std::sort(keys.begin(), keys.end());
+  ASSERT_EQ(keys.size(), 10u);
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(keys[i], static_cast<int>(i * 4 + 2));
+  }
+}
+
+TEST(FlatHashMapTest, MoveOnlyValuesAreDestroyed) {
+  auto counter = std::make_shared<int>(0);
+  {
+    FlatHashMap<int, std::unique_ptr<std::shared_ptr<int>>> map;
+    for (int i = 0; i < 1000; i++) {
+      map[i] = std::make_unique<std::shared_ptr<int>>(counter);
+    }
+    EXPECT_EQ(counter.use_count(), 1001);
+    for (int i = 0; i < 1000; i += 2) {
+      map.erase(i);
+    }
+    EXPECT_EQ(counter.use_count(), 501);
+
+    FlatHashMap<int, std::unique_ptr<std::shared_ptr<int>>> moved(
+        std::move(map));
+    EXPECT_EQ(moved.size(), 500u);
+    EXPECT_EQ(counter.use_count(), 501);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(FlatHashMapTest, Reserve) {
+  FlatHashMap<int, int> map;
+  map.reserve(1000);
+  EXPECT_GE(map.capacity(), 1000u);
+  const size_t capacity = map.capacity();
+  for (int i = 0; i < 1000; i++) {
+    map[i] = i;
+  }
+  EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, StringKeys) {
+  FlatHashMap<std::string, int> map;
+  for (int i = 0; i < 500; i++) {
+    map[std::to_string(i)] = i;
+  }
+  for (int i = 0; i < 500; i++) {
+    ASSERT_NE(map.find(std::to_string(i)), map.end());
+    EXPECT_EQ(map[std::to_string(i)], i);
+  }
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_HASH_H_
+#define FLUTTER_FML_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace fml {
+
+// Fast hashes for hash tables such as |FlatHashMap|, which index their slots
+// with the low bits of the hash. Unlike |HashCombine| over |std::hash|, which
+// is the identity for integers on most standard libraries, every bit of the
+// input affects every bit of these hashes. They are not stable across
+// releases and must not be persisted.
+
+// Mixes the bits of |value|. This is the finalizer of MurmurHash3, a
+// bijection that takes two multiplications.
+constexpr uint64_t HashMix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+// Mixes |value| into the hash |seed|. The order of the values matters.
+constexpr uint64_t HashMix(uint64_t seed, uint64_t value) {
+  return HashMix(seed ^ (HashMix(value) + 0x9e3779b97f4a7c15ull));
+}
+
+// Hashes |size| bytes at |data|, eight at a time.
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = seed ^ (size * kMultiplier);
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+    uint64_t word;
+    ::memcpy(&word, bytes, sizeof(word));
+    hash = (hash ^ (word * kMultiplier)) * 0xc2b2ae3d27d4eb4full;
+    hash ^= hash >> 29;
+    bytes += sizeof(word);
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    ::memcpy(&word, bytes, size);
+    hash = (hash ^ (word * kMultiplier)) * 0xc2b2ae3d27d4eb4full;
+  }
+  return HashMix(hash);
+}
+
+inline uint64_t HashBytes(std::string_view string, uint64_t seed = 0) {
+  return HashBytes(string.data(), string.size(), seed);
+}
+
+// The default hasher of |FlatHashMap|. Integers, enums, pointers and strings
+// are hashed with the functions above, other types with |std::hash| followed
+// by |HashMix|.
+template <typename T, typename = void>
+struct Hash {
+  size_t operator()(const T& value) const {
+    return static_cast<size_t>(HashMix(std::hash<T>{}(value)));
+  }
+};
+
+template <typename T>
+struct Hash<T,
+            std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T> ||
+                             std::is_pointer_v<T>>> {
+  size_t operator()(T value) const {
+    if constexpr (std::is_pointer_v<T>) {
+      return static_cast<size_t>(HashMix(reinterpret_cast<uintptr_t>(value)));
+    } else {
+      return static_cast<size_t>(HashMix(static_cast<uint64_t>(value)));
+    }
+  }
+};
+
+template <>
+struct Hash<std::string> {
+  size_t operator()(const std::string& value) const {
+    return static_cast<size_t>(HashBytes(value));
+  }
+};
+
+template <>
+struct Hash<std::string_view> {
+  size_t operator()(std::string_view value) const {
+    return static_cast<size_t>(HashBytes(value));
+  }
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_HASH_H_
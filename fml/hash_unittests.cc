@@ -0,0 +1,52 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/hash.h"
+
+#include <set>
+#include <string>
+
+#include "flutter/testing/testing.h"
+
+namespace fml {
+namespace testing {
+
+TEST(HashTest, MixesAllBits) {
+  // Consecutive integers must not end up in the same few low bits.
+  std::set<uint64_t> low_bits;
+  for (uint64_t i = 0; i < 256; i++) {
+    low_bits.insert(HashMix(i << 32) & 0xff);
+  }
+  EXPECT_GT(low_bits.size(), 128u);
+
+  EXPECT_NE(HashMix(1, 2), HashMix(2, 1));
+  EXPECT_EQ(HashMix(1, 2), HashMix(1, 2));
+}
+
+TEST(HashTest, HashBytes) {
+  const std::string hello = "Hello, World!";
+  EXPECT_EQ(HashBytes(hello), HashBytes(std::string("Hello, World!")));
+  EXPECT_NE(HashBytes(hello), HashBytes("Hello, World?"));
+  EXPECT_NE(HashBytes(hello), HashBytes(hello, 1));
+  // Trailing zeros change the length and so the hash.
+  EXPECT_NE(HashBytes("a", 1), HashBytes("a\0", 2));
+  EXPECT_NE(HashBytes(""), HashBytes("", 1));
+
+  // The result does not depend on the alignment of the data.
+  char buffer[32] = {};
+  ::memcpy(buffer + 1, hello.data(), hello.size());
+  EXPECT_EQ(HashBytes(buffer + 1, hello.size()), HashBytes(hello));
+}
+
+TEST(HashTest, Hash) {
+  EXPECT_EQ(Hash<int>{}(42), Hash<int>{}(42));
+  EXPECT_NE(Hash<int>{}(42), Hash<int>{}(43));
+  EXPECT_EQ(Hash<std::string>{}("flutter"), Hash<std::string_view>{}("flutter"));
+  int value = 0;
+  EXPECT_EQ(Hash<int*>{}(&value), Hash<int*>{}(&value));
+  EXPECT_EQ(Hash<double>{}(1.5), Hash<double>{}(1.5));
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -6,6 +6,7 @@
 #define FLUTTER_FML_MAPPING_H_
 
 #include <initializer_list>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -13,6 +14,7 @@
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/fml/native_library.h"
 #include "flutter/fml/unique_fd.h"
 
@@ -40,6 +42,22 @@ class FileMapping final : public Mapping {
     kExecute,
   };
 
+  // How the mapped pages are going to be accessed, so that the kernel can
+  // read ahead accordingly.
+  enum class AccessHint {
+    // The default read ahead.
+    kNormal,
+    // Pages are read in order, read ahead aggressively and drop them soon
+    // after they were accessed.
+    kSequential,
+    // Pages are read in no particular order, don't read ahead.
+    kRandom,
+    // Back the mapping with huge pages where the kernel supports that for
+    // file mappings, which saves page faults and TLB misses on large
+    // mappings that are accessed all over.
+    kHugePages,
+  };
+
   FileMapping(const fml::UniqueFD& fd,
               std::initializer_list<Protection> protection = {
                   Protection::kRead});
@@ -69,11 +87,26 @@ class FileMapping final : public Mapping {
 
   bool IsValid() const;
 
+  // Applies |hint| to the whole mapping. Returns false if the platform doesn't
+  // support the hint, which leaves the mapping as it was.
+  bool SetAccessHint(AccessHint hint) const;
+
+  // Starts reading the pages of |length| bytes from |offset|, clamped to the
+  // mapping, into memory in the background, so that accessing them later
+  // doesn't fault on disk reads. Returns without waiting for the reads, or
+  // false if the platform can't prefetch.
+  bool Prefetch(size_t offset = 0,
+                size_t length = std::numeric_limits<size_t>::max()) const;
+
  private:
   bool valid_ = false;
   size_t size_ = 0;
   uint8_t* mapping_ = nullptr;
   uint8_t* mutable_mapping_ = nullptr;
+  // The mapped bytes, charged to the "FileMappings" counter. These include
+  // the snapshots and assets of the engine, whose pages are only resident
+  // once accessed.
+  MemoryCharge memory_charge_;
 
 #if OS_WIN
   fml::UniqueFD mapping_handle_;
@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/memory/arena.h"
+#include "flutter/fml/memory/object_pool.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+// About the size of a layer: a few pointers, a matrix and a bounds rect.
+struct Object {
+  explicit Object(size_t index) : index(index) {}
+
+  size_t index;
+  void* pointers[4] = {};
+  float matrix[16] = {};
+  float bounds[4] = {};
+  std::vector<int> children;
+};
+
+}  // namespace
+
+// Creates and destroys |state.range(0)| objects per frame with the system
+// allocator.
+static void BM_AllocateFrameNew(benchmark::State& state) {
+  const size_t count = state.range(0);
+  std::vector<std::unique_ptr<Object>> objects;
+  objects.reserve(count);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < count; i++) {
+      objects.push_back(std::make_unique<Object>(i));
+    }
+    benchmark::DoNotOptimize(objects.data());
+    objects.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AllocateFrameNew)->Range(16, 4096);
+
+// Creates |state.range(0)| objects per frame in an arena that's reset after
+// each frame.
+static void BM_AllocateFrameArena(benchmark::State& state) {
+  const size_t count = state.range(0);
+  Arena arena;
+  std::vector<Object*> objects;
+  objects.reserve(count);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < count; i++) {
+      objects.push_back(arena.New<Object>(i));
+    }
+    benchmark::DoNotOptimize(objects.data());
+    objects.clear();
+    arena.Reset();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AllocateFrameArena)->Range(16, 4096);
+
+// Creates and destroys |state.range(0)| objects per frame from a pool.
+static void BM_AllocateFramePool(benchmark::State& state) {
+  const size_t count = state.range(0);
+  ObjectPool<Object> pool;
+  std::vector<ObjectPool<Object>::UniquePtr> objects;
+  objects.reserve(count);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < count; i++) {
+      objects.push_back(pool.MakeUnique(i));
+    }
+    benchmark::DoNotOptimize(objects.data());
+    objects.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_AllocateFramePool)->Range(16, 4096);
+
+}  // namespace benchmarking
+}  // namespace fml
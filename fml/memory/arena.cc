@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace fml {
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {
+  FML_DCHECK(block_size_ > 0);
+}
+
+Arena::~Arena() {
+  RunDestructors();
+}
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+  FML_CHECK(size <= SIZE_MAX - alignment);
+  if (size > block_size_ / 4 && limit_ != 0) {
+    // Allocations that don't fit in a regular block get a block of their own
+    // so that the space left in the current block can still be used.
+    Block block = MakeBlock(size + alignment);
+    uintptr_t address = reinterpret_cast<uintptr_t>(block.data.get());
+    address = (address + alignment - 1) & ~(alignment - 1);
+#if FML_ARENA_USE_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(reinterpret_cast<void*>(address), size);
+#endif
+    blocks_.insert(blocks_.end() - 1, std::move(block));
+    allocated_bytes_ += size;
+    return reinterpret_cast<void*>(address);
+  }
+  AddBlock(std::max(block_size_, size + alignment));
+  void* result = Allocate(size, alignment);
+  FML_DCHECK(result != nullptr);
+  return result;
+}
+
+Arena::Block Arena::MakeBlock(size_t size) {
+  // Not value-initialized, which would zero the block.
+  Block block = {size, std::unique_ptr<uint8_t[]>(new uint8_t[size])};
+#ifndef NDEBUG
+  ::memset(block.data.get(), kPoison, size);
+#endif
+#if FML_ARENA_USE_ASAN
+  ASAN_POISON_MEMORY_REGION(block.data.get(), size);
+#endif
+  reserved_bytes_ += size;
+  return block;
+}
+
+void Arena::AddBlock(size_t size) {
+  Block block = MakeBlock(size);
+  cursor_ = reinterpret_cast<uintptr_t>(block.data.get());
+  limit_ = cursor_ + size;
+  blocks_.push_back(std::move(block));
+}
+
+void Arena::RunDestructors() {
+  // The list is in the reverse order of creation. Destructors may not
+  // allocate in the arena.
+  DestructorNode* node = destructors_;
+  destructors_ = nullptr;
+  while (node != nullptr) {
+    node->destroy(node->object);
+    node = node->next;
+  }
+}
+
+void Arena::Reset() {
+  RunDestructors();
+  allocated_bytes_ = 0;
+  if (blocks_.empty()) {
+    return;
+  }
+
+  if (blocks_.size() > 1) {
+    // Replaces the blocks with one that fits all of them, so that the next
+    // cycle with the same allocations needs a single block.
+    blocks_.clear();
+    size_t size = reserved_bytes_;
+    reserved_bytes_ = 0;
+    AddBlock(size);
+    return;
+  }
+
+  Block& block = blocks_.front();
+  uint8_t* data = block.data.get();
+#if FML_ARENA_USE_ASAN
+  // Allows the poisoning writes below.
+  ASAN_UNPOISON_MEMORY_REGION(data, block.size);
+#endif
+#ifndef NDEBUG
+  ::memset(data, kPoison, cursor_ - reinterpret_cast<uintptr_t>(data));
+#endif
+#if FML_ARENA_USE_ASAN
+  ASAN_POISON_MEMORY_REGION(data, block.size);
+#endif
+  cursor_ = reinterpret_cast<uintptr_t>(data);
+}
+
+}  // namespace fml
@@ -0,0 +1,191 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MEMORY_ARENA_H_
+#define FLUTTER_FML_MEMORY_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define FML_ARENA_USE_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define FML_ARENA_USE_ASAN 1
+#endif
+#endif
+
+#if FML_ARENA_USE_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace fml {
+
+// A bump allocator for objects that share a lifetime, such as the objects
+// built for a single frame. Allocations take a pointer increment and are
+// never freed individually. |Reset()| releases all of them at once and keeps
+// the memory for reuse, so an arena that is reset every frame settles into a
+// single block and stops calling into the system allocator.
+//
+// Objects created with |New()| have their destructors run by |Reset()|, in
+// the reverse order of their creation. Memory returned by |Allocate()| is
+// raw and its contents are never destroyed.
+//
+// In debug builds, released memory is filled with |kPoison| so that uses
+// after a reset stand out, and in ASan builds it is also poisoned.
+//
+// This class is not thread-safe.
+class Arena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 4096;
+
+  static constexpr uint8_t kPoison = 0xcd;
+
+  // Creates an arena that allocates its memory in blocks of at least
+  // |block_size| bytes. No memory is allocated until the first allocation.
+  // Allocations larger than a quarter of |block_size| get blocks of their
+  // own.
+  explicit Arena(size_t block_size = kDefaultBlockSize);
+
+  ~Arena();
+
+  // Returns |size| bytes aligned to |alignment|, which must be a power of
+  // two. The memory stays valid until the next |Reset()|.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    FML_DCHECK(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    uintptr_t address = (cursor_ + alignment - 1) & ~(alignment - 1);
+    if (address < cursor_ || address > limit_ || size > limit_ - address ||
+        limit_ == 0) {
+      return AllocateSlow(size, alignment);
+    }
+    cursor_ = address + size;
+    allocated_bytes_ += size;
+#if FML_ARENA_USE_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(reinterpret_cast<void*>(address), size);
+#endif
+    return reinterpret_cast<void*>(address);
+  }
+
+  // Returns uninitialized storage for |count| objects of type |T|.
+  template <typename T>
+  T* AllocateArray(size_t count) {
+    FML_CHECK(count <= SIZE_MAX / sizeof(T));
+    return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  // Constructs a |T| in the arena. Its destructor runs on |Reset()|, unless
+  // it is trivially destructible.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+      return new (Allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+    } else {
+      auto* node = static_cast<DestructorNode*>(
+          Allocate(sizeof(DestructorNode), alignof(DestructorNode)));
+      T* object = new (Allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+      // Registered after the constructor, which may create objects in the
+      // arena itself and must destroy them later.
+      *node = {[](void* object) { static_cast<T*>(object)->~T(); }, object,
+               destructors_};
+      destructors_ = node;
+      return object;
+    }
+  }
+
+  // Destroys the objects created with |New()| and releases all allocations.
+  // Keeps one block large enough for everything that was allocated since the
+  // last reset.
+  void Reset();
+
+  // The bytes handed out since the last reset, excluding alignment padding.
+  size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  // The bytes held in blocks, in use or not.
+  size_t GetReservedBytes() const { return reserved_bytes_; }
+
+ private:
+  struct DestructorNode {
+    void (*destroy)(void* object);
+    void* object;
+    DestructorNode* next;
+  };
+
+  struct Block {
+    size_t size;
+    std::unique_ptr<uint8_t[]> data;
+  };
+
+  const size_t block_size_;
+  // The current block is last, after the blocks of large allocations and the
+  // blocks that filled up. Blocks are only freed by |Reset()|.
+  std::vector<Block> blocks_;
+  uintptr_t cursor_ = 0;
+  uintptr_t limit_ = 0;
+  DestructorNode* destructors_ = nullptr;
+  size_t allocated_bytes_ = 0;
+  size_t reserved_bytes_ = 0;
+
+  void* AllocateSlow(size_t size, size_t alignment);
+
+  Block MakeBlock(size_t size);
+
+  void AddBlock(size_t size);
+
+  void RunDestructors();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Arena);
+};
+
+// A standard allocator over an |Arena|, for containers whose storage should
+// live in the arena. Deallocation is a no-op, so containers that grow leave
+// their old storage behind until the arena is reset.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {
+    FML_DCHECK(arena_ != nullptr);
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t count) { return arena_->AllocateArray<T>(count); }
+
+  void deallocate(T*, size_t) {}
+
+  Arena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  Arena* arena_;
+};
+
+// A vector whose storage lives in an |Arena|. It must be destroyed or
+// cleared before the arena is reset.
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MEMORY_ARENA_H_
@@ -0,0 +1,149 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+class Recorder {
+ public:
+  Recorder(std::vector<int>* destroyed, int id)
+      : destroyed_(destroyed), id_(id) {}
+
+  ~Recorder() { destroyed_->push_back(id_); }
+
+ private:
+  std::vector<int>* destroyed_;
+  int id_;
+};
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+  Arena arena(256);
+  std::vector<uintptr_t> addresses;
+  for (size_t i = 1; i <= 100; i++) {
+    size_t alignment = size_t{1} << (i % 7);
+    void* memory = arena.Allocate(i, alignment);
+    ASSERT_NE(memory, nullptr);
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+    EXPECT_EQ(address % alignment, 0u);
+    ::memset(memory, static_cast<int>(i), i);
+    addresses.push_back(address);
+  }
+  for (size_t i = 1; i <= 100; i++) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(addresses[i - 1]);
+    for (size_t j = 0; j < i; j++) {
+      ASSERT_EQ(bytes[j], i);
+    }
+  }
+  EXPECT_EQ(arena.GetAllocatedBytes(), 100u * 101u / 2u);
+}
+
+TEST(ArenaTest, LargeAllocationsGetTheirOwnBlock) {
+  Arena arena(64);
+  void* memory = arena.Allocate(1000);
+  ASSERT_NE(memory, nullptr);
+  ::memset(memory, 0, 1000);
+  EXPECT_GE(arena.GetReservedBytes(), 1000u);
+
+  // The current block is still used after a large allocation.
+  Arena other_arena(256);
+  other_arena.Allocate(8);
+  size_t reserved = other_arena.GetReservedBytes();
+  EXPECT_EQ(reserved, 256u);
+  other_arena.Allocate(2000);
+  other_arena.Allocate(8);
+  EXPECT_EQ(other_arena.GetReservedBytes(),
+            reserved + 2000 + alignof(std::max_align_t));
+}
+
+TEST(ArenaTest, ResetRunsDestructorsInReverseOrder) {
+  std::vector<int> destroyed;
+  Arena arena;
+  for (int i = 0; i < 4; i++) {
+    arena.New<Recorder>(&destroyed, i);
+  }
+  arena.New<int>(5);
+  EXPECT_TRUE(destroyed.empty());
+  arena.Reset();
+  EXPECT_EQ(destroyed, std::vector<int>({3, 2, 1, 0}));
+  EXPECT_EQ(arena.GetAllocatedBytes(), 0u);
+
+  arena.New<Recorder>(&destroyed, 4);
+  arena.Reset();
+  EXPECT_EQ(destroyed, std::vector<int>({3, 2, 1, 0, 4}));
+}
+
+TEST(ArenaTest, DestructionRunsDestructors) {
+  std::vector<int> destroyed;
+  {
+    Arena arena;
+    arena.New<Recorder>(&destroyed, 1);
+    arena.New<std::string>(100, 'x');
+  }
+  EXPECT_EQ(destroyed, std::vector<int>({1}));
+}
+
+TEST(ArenaTest, ResetCoalescesBlocks) {
+  Arena arena(128);
+  for (size_t i = 0; i < 64; i++) {
+    arena.Allocate(64);
+  }
+  size_t reserved = arena.GetReservedBytes();
+  EXPECT_GE(reserved, 64u * 64u);
+
+  for (size_t frame = 0; frame < 4; frame++) {
+    arena.Reset();
+    for (size_t i = 0; i < 64; i++) {
+      arena.Allocate(64);
+    }
+    // A repeated frame fits in the coalesced block.
+    EXPECT_EQ(arena.GetReservedBytes(), reserved);
+  }
+}
+
+#ifndef NDEBUG
+TEST(ArenaTest, ResetPoisonsMemory) {
+  Arena arena;
+  uint8_t* bytes = static_cast<uint8_t*>(arena.Allocate(16, 1));
+  ::memset(bytes, 0, 16);
+  arena.Reset();
+  // The first allocation after a reset reuses the same memory.
+  uint8_t* reused = static_cast<uint8_t*>(arena.Allocate(16, 1));
+  ASSERT_EQ(reused, bytes);
+  for (size_t i = 0; i < 16; i++) {
+    EXPECT_EQ(reused[i], Arena::kPoison);
+  }
+}
+#endif
+
+TEST(ArenaTest, ArenaVector) {
+  Arena arena(64);
+  {
+    ArenaVector<int> vector{ArenaAllocator<int>(&arena)};
+    for (int i = 0; i < 1000; i++) {
+      vector.push_back(i);
+    }
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_EQ(vector[i], i);
+    }
+  }
+  EXPECT_GE(arena.GetAllocatedBytes(), 1000 * sizeof(int));
+
+  // Containers created in the arena are destroyed by the reset.
+  auto* nested = arena.New<ArenaVector<std::string>>(
+      ArenaAllocator<std::string>(&arena));
+  nested->emplace_back("a string too long for the small string optimization");
+  arena.Reset();
+}
+
+}  // namespace
+}  // namespace fml
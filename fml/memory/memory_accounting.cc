@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/memory_accounting.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+
+namespace {
+
+struct Registry {
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<MemoryCounter>> counters;
+};
+
+Registry& GetRegistry() {
+  // Never destroyed since charges may be released during shutdown.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+}  // namespace
+
+MemoryCounter::MemoryCounter(std::string name)
+    : name_(std::move(name)), trace_name_("Memory:" + name_) {}
+
+MemoryCounter* MemoryCounter::Get(const std::string& name) {
+  Registry& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  auto& counter = registry.counters[name];
+  if (!counter) {
+    counter.reset(new MemoryCounter(name));
+  }
+  return counter.get();
+}
+
+void MemoryCounter::Add(int64_t bytes) {
+  const int64_t total =
+      bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (total > peak && !peak_bytes_.compare_exchange_weak(
+                             peak, total, std::memory_order_relaxed)) {
+  }
+}
+
+MemoryCharge::MemoryCharge(MemoryCounter* counter, int64_t bytes)
+    : counter_(counter) {
+  Update(bytes);
+}
+
+MemoryCharge::MemoryCharge(MemoryCharge&& other)
+    : counter_(other.counter_), bytes_(other.bytes_) {
+  other.counter_ = nullptr;
+  other.bytes_ = 0;
+}
+
+MemoryCharge& MemoryCharge::operator=(MemoryCharge&& other) {
+  if (this != &other) {
+    Update(0);
+    counter_ = other.counter_;
+    bytes_ = other.bytes_;
+    other.counter_ = nullptr;
+    other.bytes_ = 0;
+  }
+  return *this;
+}
+
+MemoryCharge::~MemoryCharge() {
+  Update(0);
+}
+
+void MemoryCharge::Update(int64_t bytes) {
+  if (counter_ == nullptr || bytes == bytes_) {
+    return;
+  }
+  counter_->Add(bytes - bytes_);
+  bytes_ = bytes;
+}
+
+std::vector<MemoryUsage> GetMemoryUsage() {
+  Registry& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  std::vector<MemoryUsage> usage;
+  usage.reserve(registry.counters.size());
+  for (const auto& [name, counter] : registry.counters) {
+    usage.push_back({name, counter->GetBytes(), counter->GetPeakBytes()});
+  }
+  return usage;
+}
+
+void TraceMemoryUsage() {
+  std::vector<MemoryCounter*> counters;
+  {
+    Registry& registry = GetRegistry();
+    std::scoped_lock lock(registry.mutex);
+    for (const auto& entry : registry.counters) {
+      counters.push_back(entry.second.get());
+    }
+  }
+  for (MemoryCounter* counter : counters) {
+    // The names live as long as the counters, which is forever.
+    FML_TRACE_COUNTER("flutter", counter->GetTraceName(), 0, "bytes",
+                      counter->GetBytes());
+  }
+}
+
+}  // namespace fml
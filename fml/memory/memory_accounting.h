@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MEMORY_MEMORY_ACCOUNTING_H_
+#define FLUTTER_FML_MEMORY_MEMORY_ACCOUNTING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+// A process-wide tally of the bytes held by one subsystem, such as the raster
+// cache or the decoded images. All instances of a subsystem, across all
+// shells, add to the same counter.
+//
+// Counters only know what their subsystem reports. They are meant to explain
+// where the memory of a process goes, not to match what the system reports
+// as its footprint, and they may overlap: the GPU images of the raster cache
+// are also in Skia's resource cache.
+//
+// This class is thread-safe.
+class MemoryCounter {
+ public:
+  // Returns the counter named |name|, registering it on first use. Counters
+  // are never destroyed, so callers may keep the result in a function-local
+  // static.
+  static MemoryCounter* Get(const std::string& name);
+
+  const std::string& GetName() const { return name_; }
+
+  // The name of the trace counter of this counter.
+  const char* GetTraceName() const { return trace_name_.c_str(); }
+
+  // Adds |bytes|, which may be negative, to the tally.
+  void Add(int64_t bytes);
+
+  int64_t GetBytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // The largest value of the tally since the process started.
+  int64_t GetPeakBytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const std::string name_;
+  const std::string trace_name_;
+  std::atomic<int64_t> bytes_ = {0};
+  std::atomic<int64_t> peak_bytes_ = {0};
+
+  explicit MemoryCounter(std::string name);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MemoryCounter);
+};
+
+// The bytes that one object holds, charged to a |MemoryCounter| for as long
+// as the charge lives. Objects that change size update their charge.
+//
+// This class is not thread-safe, though charges to the same counter may live
+// on different threads.
+class MemoryCharge {
+ public:
+  MemoryCharge() = default;
+
+  explicit MemoryCharge(MemoryCounter* counter, int64_t bytes = 0);
+
+  MemoryCharge(MemoryCharge&& other);
+
+  MemoryCharge& operator=(MemoryCharge&& other);
+
+  ~MemoryCharge();
+
+  // Sets the charge to |bytes| and adds the difference to the counter.
+  void Update(int64_t bytes);
+
+  int64_t GetBytes() const { return bytes_; }
+
+ private:
+  MemoryCounter* counter_ = nullptr;
+  int64_t bytes_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MemoryCharge);
+};
+
+struct MemoryUsage {
+  std::string name;
+  int64_t bytes = 0;
+  int64_t peak_bytes = 0;
+};
+
+// Returns the tallies of all counters, sorted by name.
+std::vector<MemoryUsage> GetMemoryUsage();
+
+// Emits the tally of each counter as a trace counter.
+void TraceMemoryUsage();
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MEMORY_MEMORY_ACCOUNTING_H_
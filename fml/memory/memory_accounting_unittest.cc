@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/memory_accounting.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+int64_t GetReportedBytes(const std::string& name) {
+  std::vector<MemoryUsage> usage = GetMemoryUsage();
+  auto it = std::find_if(
+      usage.begin(), usage.end(),
+      [&name](const MemoryUsage& counter) { return counter.name == name; });
+  return it == usage.end() ? -1 : it->bytes;
+}
+
+TEST(MemoryAccountingTest, CountersAreSharedByName) {
+  MemoryCounter* counter = MemoryCounter::Get("Test.Shared");
+  EXPECT_EQ(counter, MemoryCounter::Get("Test.Shared"));
+  EXPECT_NE(counter, MemoryCounter::Get("Test.Other"));
+  EXPECT_EQ(counter->GetName(), "Test.Shared");
+  EXPECT_STREQ(counter->GetTraceName(), "Memory:Test.Shared");
+}
+
+TEST(MemoryAccountingTest, ChargesUpdateTheirCounter) {
+  MemoryCounter* counter = MemoryCounter::Get("Test.Charges");
+  {
+    MemoryCharge first(counter, 100);
+    MemoryCharge second(counter);
+    EXPECT_EQ(counter->GetBytes(), 100);
+    second.Update(50);
+    EXPECT_EQ(counter->GetBytes(), 150);
+    first.Update(10);
+    EXPECT_EQ(counter->GetBytes(), 60);
+    EXPECT_EQ(counter->GetPeakBytes(), 150);
+    EXPECT_EQ(GetReportedBytes("Test.Charges"), 60);
+  }
+  EXPECT_EQ(counter->GetBytes(), 0);
+  EXPECT_EQ(counter->GetPeakBytes(), 150);
+}
+
+TEST(MemoryAccountingTest, ChargesCanBeMoved) {
+  MemoryCounter* counter = MemoryCounter::Get("Test.Moves");
+  MemoryCharge charge(counter, 8);
+  MemoryCharge moved(std::move(charge));
+  EXPECT_EQ(counter->GetBytes(), 8);
+  EXPECT_EQ(moved.GetBytes(), 8);
+
+  MemoryCharge assigned(counter, 4);
+  EXPECT_EQ(counter->GetBytes(), 12);
+  // Assigning releases the previous charge.
+  assigned = std::move(moved);
+  EXPECT_EQ(counter->GetBytes(), 8);
+  assigned = MemoryCharge();
+  EXPECT_EQ(counter->GetBytes(), 0);
+}
+
+TEST(MemoryAccountingTest, ConcurrentCharges) {
+  MemoryCounter* counter = MemoryCounter::Get("Test.Concurrent");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([counter]() {
+      for (int j = 0; j < 1000; j++) {
+        MemoryCharge charge(counter, 16);
+        charge.Update(32);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter->GetBytes(), 0);
+  EXPECT_GE(counter->GetPeakBytes(), 32);
+  EXPECT_LE(counter->GetPeakBytes(), 4 * 32);
+}
+
+}  // namespace
+}  // namespace fml
@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MEMORY_OBJECT_POOL_H_
+#define FLUTTER_FML_MEMORY_OBJECT_POOL_H_
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/arena.h"
+
+namespace fml {
+
+// Recycles the storage of objects of type |T| that are created and destroyed
+// at a high rate, such as per-frame objects. Storage is allocated in chunks of
+// |objects_per_chunk| objects and released objects go on a free list, so a
+// pool that has warmed up no longer calls into the system allocator. The
+// storage is only freed when the pool is destroyed, after all of its objects.
+//
+// Objects may be acquired and released on any thread. A frame's objects are
+// usually created on one thread and destroyed on another, so the free list is
+// shared by all threads under a lock, which is uncontended in that pattern.
+//
+// In debug builds, released objects are filled with |Arena::kPoison|, and in
+// ASan builds they are also poisoned until they are acquired again.
+template <typename T>
+class ObjectPool {
+ public:
+  class Deleter {
+   public:
+    explicit Deleter(ObjectPool* pool = nullptr) : pool_(pool) {}
+
+    void operator()(T* object) const { pool_->Release(object); }
+
+   private:
+    ObjectPool* pool_;
+  };
+
+  using UniquePtr = std::unique_ptr<T, Deleter>;
+
+  explicit ObjectPool(size_t objects_per_chunk = 64)
+      : objects_per_chunk_(objects_per_chunk) {
+    FML_DCHECK(objects_per_chunk_ > 0);
+  }
+
+  ~ObjectPool() { FML_DCHECK(live_count_ == 0); }
+
+  // Constructs a |T| from |args| in recycled storage.
+  template <typename... Args>
+  T* Acquire(Args&&... args) {
+    return new (AcquireSlot()) T(std::forward<Args>(args)...);
+  }
+
+  // Like |Acquire()|, but returns the object to the pool when the pointer is
+  // destroyed.
+  template <typename... Args>
+  UniquePtr MakeUnique(Args&&... args) {
+    return UniquePtr(Acquire(std::forward<Args>(args)...), Deleter(this));
+  }
+
+  // Destroys |object|, which must have been acquired from this pool, and
+  // recycles its storage.
+  void Release(T* object) {
+    if (object == nullptr) {
+      return;
+    }
+    object->~T();
+    Slot* slot = reinterpret_cast<Slot*>(object);
+#ifndef NDEBUG
+    ::memset(static_cast<void*>(slot), Arena::kPoison, sizeof(Slot));
+#endif
+    std::scoped_lock lock(mutex_);
+    slot->next = free_list_;
+    free_list_ = slot;
+    live_count_--;
+#if FML_ARENA_USE_ASAN
+    ASAN_POISON_MEMORY_REGION(slot, sizeof(Slot));
+#endif
+  }
+
+  // The number of objects that were acquired and not released yet.
+  size_t GetLiveCount() const {
+    std::scoped_lock lock(mutex_);
+    return live_count_;
+  }
+
+  // The number of objects that fit in the storage allocated so far.
+  size_t GetCapacity() const {
+    std::scoped_lock lock(mutex_);
+    return chunks_.size() * objects_per_chunk_;
+  }
+
+ private:
+  union Slot {
+    Slot* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  const size_t objects_per_chunk_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Slot[]>> chunks_;
+  Slot* free_list_ = nullptr;
+  size_t live_count_ = 0;
+
+  void* AcquireSlot() {
+    std::scoped_lock lock(mutex_);
+    if (free_list_ == nullptr) {
+      AddChunk();
+    }
+    Slot* slot = free_list_;
+#if FML_ARENA_USE_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(slot, sizeof(Slot));
+#endif
+    free_list_ = slot->next;
+    live_count_++;
+    return slot->storage;
+  }
+
+  void AddChunk() {
+    chunks_.emplace_back(new Slot[objects_per_chunk_]);
+    Slot* chunk = chunks_.back().get();
+    // Threaded so that slots are handed out in address order.
+    for (size_t i = objects_per_chunk_; i > 0; i--) {
+      chunk[i - 1].next = free_list_;
+      free_list_ = &chunk[i - 1];
+#if FML_ARENA_USE_ASAN
+      ASAN_POISON_MEMORY_REGION(&chunk[i - 1], sizeof(Slot));
+#endif
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ObjectPool);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MEMORY_OBJECT_POOL_H_
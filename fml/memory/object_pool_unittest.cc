@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/memory/object_pool.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+struct Node {
+  Node(int value, std::string name) : value(value), name(std::move(name)) {}
+
+  int value;
+  std::string name;
+};
+
+TEST(ObjectPoolTest, AcquireAndRelease) {
+  ObjectPool<Node> pool(4);
+  Node* node = pool.Acquire(1, "one");
+  EXPECT_EQ(node->value, 1);
+  EXPECT_EQ(node->name, "one");
+  EXPECT_EQ(pool.GetLiveCount(), 1u);
+  EXPECT_EQ(pool.GetCapacity(), 4u);
+  pool.Release(node);
+  EXPECT_EQ(pool.GetLiveCount(), 0u);
+
+  // The storage is reused.
+  Node* other = pool.Acquire(2, "two");
+  EXPECT_EQ(other, node);
+  EXPECT_EQ(other->value, 2);
+  pool.Release(other);
+}
+
+TEST(ObjectPoolTest, GrowsByChunks) {
+  ObjectPool<Node> pool(8);
+  std::set<Node*> nodes;
+  for (int i = 0; i < 20; i++) {
+    nodes.insert(pool.Acquire(i, std::to_string(i)));
+  }
+  EXPECT_EQ(nodes.size(), 20u);
+  EXPECT_EQ(pool.GetCapacity(), 24u);
+  for (Node* node : nodes) {
+    EXPECT_EQ(node->name, std::to_string(node->value));
+    pool.Release(node);
+  }
+
+  // A warmed up pool doesn't grow.
+  for (int frame = 0; frame < 3; frame++) {
+    std::vector<Node*> frame_nodes;
+    for (int i = 0; i < 20; i++) {
+      frame_nodes.push_back(pool.Acquire(i, "frame"));
+    }
+    for (Node* node : frame_nodes) {
+      pool.Release(node);
+    }
+  }
+  EXPECT_EQ(pool.GetCapacity(), 24u);
+}
+
+TEST(ObjectPoolTest, MakeUnique) {
+  ObjectPool<Node> pool;
+  {
+    ObjectPool<Node>::UniquePtr node = pool.MakeUnique(3, "three");
+    EXPECT_EQ(node->value, 3);
+    EXPECT_EQ(pool.GetLiveCount(), 1u);
+    ObjectPool<Node>::UniquePtr moved = std::move(node);
+    EXPECT_EQ(pool.GetLiveCount(), 1u);
+  }
+  EXPECT_EQ(pool.GetLiveCount(), 0u);
+}
+
+TEST(ObjectPoolTest, ReleaseOnAnotherThread) {
+  ObjectPool<Node> pool(16);
+  for (int frame = 0; frame < 50; frame++) {
+    std::vector<Node*> nodes;
+    for (int i = 0; i < 100; i++) {
+      nodes.push_back(pool.Acquire(i, "node"));
+    }
+    std::thread releaser([&pool, &nodes]() {
+      for (Node* node : nodes) {
+        pool.Release(node);
+      }
+    });
+    // Acquires concurrently with the releases.
+    std::vector<Node*> more;
+    for (int i = 0; i < 100; i++) {
+      more.push_back(pool.Acquire(i, "more"));
+    }
+    releaser.join();
+    for (Node* node : more) {
+      EXPECT_EQ(node->name, "more");
+      pool.Release(node);
+    }
+  }
+  EXPECT_EQ(pool.GetLiveCount(), 0u);
+}
+
+}  // namespace
+}  // namespace fml
@@ -4,6 +4,9 @@
 
 #include "flutter/fml/message.h"
 
+#include <cstdint>
+#include <cstdlib>
+
 #include "flutter/fml/logging.h"
 
 namespace fml {
@@ -14,7 +17,30 @@ size_t MessageSerializable::GetSerializableTag() const {
 
 Message::Message() = default;
 
-Message::~Message() = default;
+Message::Message(uint8_t* buffer,
+                 size_t buffer_length,
+                 size_t data_length,
+                 bool read_only)
+    : buffer_(buffer),
+      buffer_length_(buffer_length),
+      data_length_(data_length),
+      owns_buffer_(false),
+      read_only_(read_only) {}
+
+Message::~Message() {
+  if (owns_buffer_) {
+    ::free(buffer_);
+  }
+}
+
+Message Message::WithBuffer(uint8_t* buffer, size_t capacity) {
+  return Message(buffer, capacity, 0, false);
+}
+
+Message Message::View(const uint8_t* data, size_t length) {
+  // The buffer is never written to since the message is read only.
+  return Message(const_cast<uint8_t*>(data), length, length, true);
+}
 
 static uint32_t NextPowerOfTwoSize(uint32_t x) {
   if (x == 0) {
@@ -52,6 +78,9 @@ bool Message::Reserve(size_t size) {
   if (buffer_length_ >= size) {
     return true;
   }
+  if (!owns_buffer_) {
+    return false;
+  }
   return Resize(NextPowerOfTwoSize(size));
 }
 
@@ -86,23 +115,36 @@ bool Message::Resize(size_t size) {
   return success;
 }
 
-uint8_t* Message::PrepareEncode(size_t size) {
-  if (!Reserve(data_length_ + size)) {
+static size_t AlignOffset(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+uint8_t* Message::PrepareEncode(size_t size, size_t alignment) {
+  if (read_only_) {
+    return nullptr;
+  }
+  const size_t offset = AlignOffset(data_length_, alignment);
+  if (offset < data_length_ || size > SIZE_MAX - offset ||
+      !Reserve(offset + size)) {
     return nullptr;
   }
 
-  auto old_length = data_length_;
-  data_length_ += size;
-  return buffer_ + old_length;
+  // Zero the padding so that the data doesn't depend on previous contents of
+  // the buffer.
+  if (offset > data_length_) {
+    ::memset(buffer_ + data_length_, 0, offset - data_length_);
+  }
+  data_length_ = offset + size;
+  return buffer_ + offset;
 }
 
-uint8_t* Message::PrepareDecode(size_t size) {
-  if ((size + size_read_) > buffer_length_) {
+const uint8_t* Message::PrepareDecode(size_t size, size_t alignment) {
+  const size_t offset = AlignOffset(size_read_, alignment);
+  if (offset > data_length_ || size > data_length_ - offset) {
     return nullptr;
   }
-  auto* buffer = buffer_ + size_read_;
-  size_read_ += size;
-  return buffer;
+  size_read_ = offset + size;
+  return buffer_ + offset;
 }
 
 void Message::ResetRead() {
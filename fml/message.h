@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -67,12 +68,28 @@ struct Serializable : public std::integral_constant<
 
 // Utility class to encode and decode |Serializable| types to and from a buffer.
 // Elements have to be read back into the same order they were written.
+//
+// By default, the message owns its buffer and grows it as needed. Messages
+// created with |WithBuffer| and |View| use memory owned by the caller instead,
+// so that encoding into a preallocated (or arena owned) buffer and decoding a
+// received buffer don't allocate or copy the buffer. Such memory should be
+// aligned to |alignof(std::max_align_t)| for arrays to be decoded in place.
 class Message {
  public:
   Message();
 
   ~Message();
 
+  // Creates a message that encodes into the |capacity| bytes at |buffer|.
+  // Encoding fails instead of allocating once the buffer is full. The buffer
+  // must outlive the message.
+  static Message WithBuffer(uint8_t* buffer, size_t capacity);
+
+  // Creates a message that decodes the |length| bytes at |data|, typically
+  // those encoded by another message, in place. Nothing can be encoded into
+  // it. The data must outlive the message and all arrays decoded from it.
+  static Message View(const uint8_t* data, size_t length);
+
   const uint8_t* GetBuffer() const;
 
   size_t GetBufferSize() const;
@@ -126,6 +143,24 @@ class Message {
     return true;
   }
 
+  // Encodes |count| elements followed by the elements themselves, aligned so
+  // that |DecodeArray| can refer to them in place.
+  template <typename T,
+            typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+  [[nodiscard]] bool EncodeArray(const T* data, size_t count) {
+    if (count > std::numeric_limits<size_t>::max() / sizeof(T) ||
+        !Encode(count)) {
+      return false;
+    }
+    if (auto* buffer = PrepareEncode(count * sizeof(T), alignof(T))) {
+      if (count > 0) {
+        ::memcpy(buffer, data, count * sizeof(T));
+      }
+      return true;
+    }
+    return false;
+  }
+
   // Decoders.
 
   template <typename T,
@@ -138,6 +173,30 @@ class Message {
     return false;
   }
 
+  // Decodes an array encoded by |EncodeArray| without copying it. |data|
+  // points into the buffer of the message and is only valid as long as the
+  // buffer is. Fails if the buffer isn't suitably aligned for |T|.
+  template <typename T,
+            typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+  [[nodiscard]] bool DecodeArray(const T*& data, size_t& count) {
+    const size_t size_read = size_read_;
+    size_t decoded_count = 0;
+    if (!Decode(decoded_count) ||
+        decoded_count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      size_read_ = size_read;
+      return false;
+    }
+    auto* buffer = PrepareDecode(decoded_count * sizeof(T), alignof(T));
+    if (buffer == nullptr ||
+        reinterpret_cast<uintptr_t>(buffer) % alignof(T) != 0) {
+      size_read_ = size_read;
+      return false;
+    }
+    data = reinterpret_cast<const T*>(buffer);
+    count = decoded_count;
+    return true;
+  }
+
   [[nodiscard]] bool Decode(MessageSerializable& value) {
     return value.Deserialize(*this);
   }
@@ -183,14 +242,22 @@ class Message {
   size_t buffer_length_ = 0;
   size_t data_length_ = 0;
   size_t size_read_ = 0;
+  bool owns_buffer_ = true;
+  bool read_only_ = false;
+
+  Message(uint8_t* buffer,
+          size_t buffer_length,
+          size_t data_length,
+          bool read_only);
 
   [[nodiscard]] bool Reserve(size_t size);
 
   [[nodiscard]] bool Resize(size_t size);
 
-  [[nodiscard]] uint8_t* PrepareEncode(size_t size);
+  [[nodiscard]] uint8_t* PrepareEncode(size_t size, size_t alignment = 1);
 
-  [[nodiscard]] uint8_t* PrepareDecode(size_t size);
+  [[nodiscard]] const uint8_t* PrepareDecode(size_t size,
+                                             size_t alignment = 1);
 
   FML_DISALLOW_COPY_AND_ASSIGN(Message);
 };
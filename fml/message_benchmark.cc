@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/message.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+struct Point {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+std::vector<Point> MakePoints(size_t count) {
+  std::vector<Point> points(count);
+  for (size_t i = 0; i < count; i++) {
+    points[i] = {static_cast<float>(i), static_cast<float>(count - i)};
+  }
+  return points;
+}
+
+// Sums the points so that the decoded data is used.
+float Sum(const Point* points, size_t count) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < count; i++) {
+    sum += points[i].x + points[i].y;
+  }
+  return sum;
+}
+
+}  // namespace
+
+// Encodes |state.range(0)| points one by one into a message that owns and
+// grows its buffer, then decodes them into a vector.
+static void BM_MessageEncodeDecodeCopying(benchmark::State& state) {
+  const auto points = MakePoints(state.range(0));
+  while (state.KeepRunning()) {
+    Message message;
+    bool success = message.Encode(points.size());
+    for (const auto& point : points) {
+      success &= message.Encode(point);
+    }
+
+    size_t count = 0;
+    success &= message.Decode(count);
+    std::vector<Point> decoded(count);
+    for (auto& point : decoded) {
+      success &= message.Decode(point);
+    }
+    benchmark::DoNotOptimize(success);
+    benchmark::DoNotOptimize(Sum(decoded.data(), decoded.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * points.size() * sizeof(Point));
+}
+
+// Encodes the same points as an array into a preallocated buffer, then decodes
+// them in place from a view of the buffer.
+static void BM_MessageEncodeDecodeInPlace(benchmark::State& state) {
+  const auto points = MakePoints(state.range(0));
+  std::vector<std::max_align_t> storage(
+      (sizeof(size_t) + points.size() * sizeof(Point)) /
+          sizeof(std::max_align_t) +
+      1);
+  auto* buffer = reinterpret_cast<uint8_t*>(storage.data());
+  const size_t capacity = storage.size() * sizeof(std::max_align_t);
+  while (state.KeepRunning()) {
+    auto message = Message::WithBuffer(buffer, capacity);
+    bool success = message.EncodeArray(points.data(), points.size());
+
+    auto view = Message::View(message.GetBuffer(), message.GetDataLength());
+    const Point* decoded = nullptr;
+    size_t count = 0;
+    success &= view.DecodeArray(decoded, count);
+    benchmark::DoNotOptimize(success);
+    benchmark::DoNotOptimize(Sum(decoded, count));
+  }
+  state.SetBytesProcessed(state.iterations() * points.size() * sizeof(Point));
+}
+
+BENCHMARK(BM_MessageEncodeDecodeCopying)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_MessageEncodeDecodeInPlace)->RangeMultiplier(16)->Range(16, 4096);
+
+}  // namespace benchmarking
+}  // namespace fml
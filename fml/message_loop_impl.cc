@@ -7,10 +7,12 @@
 #include "flutter/fml/message_loop_impl.h"
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/trace_event.h"
 
 #if OS_MACOSX
@@ -54,8 +56,9 @@ MessageLoopImpl::~MessageLoopImpl() {
   task_queue_->Dispose(queue_id_);
 }
 
-void MessageLoopImpl::PostTask(const fml::closure& task,
-                               fml::TimePoint target_time) {
+void MessageLoopImpl::PostTask(fml::UniqueClosure task,
+                               fml::TimePoint target_time,
+                               TaskPriority priority) {
   FML_DCHECK(task != nullptr);
   FML_DCHECK(task != nullptr);
   if (terminated_) {
@@ -63,7 +66,17 @@ void MessageLoopImpl::PostTask(const fml::closure& task,
     // |task| synchronously within this function.
     return;
   }
-  task_queue_->RegisterTask(queue_id_, task, target_time);
+  task_queue_->RegisterTask(queue_id_, std::move(task), target_time, priority);
+}
+
+void MessageLoopImpl::PostTasks(std::vector<fml::UniqueClosure> tasks,
+                                fml::TimePoint target_time,
+                                TaskPriority priority) {
+  if (terminated_) {
+    return;
+  }
+  task_queue_->RegisterTasks(queue_id_, std::move(tasks), target_time,
+                             priority);
 }
 
 void MessageLoopImpl::AddTaskObserver(intptr_t key,
@@ -119,18 +132,46 @@ void MessageLoopImpl::DoTerminate() {
 
 void MessageLoopImpl::FlushTasks(FlushType type) {
   TRACE_EVENT0("fml", "MessageLoop::FlushTasks");
-  std::vector<fml::closure> invocations;
+  std::vector<fml::UniqueClosure> invocations;
 
   task_queue_->GetTasksToRunNow(queue_id_, type, invocations);
 
+  // The observers are only fetched again when they may have changed, instead
+  // of locking the queue again after every task of the batch.
+  std::vector<fml::closure> observers;
+  size_t observers_version = 0;
+  bool has_observers = false;
+  SyncProfiler::Histogram* task_duration = nullptr;
+  if (SyncProfiler::IsEnabled() && !invocations.empty()) {
+    if (!task_duration_) {
+      task_duration_ = &SyncProfiler::GetForCurrentThread(
+          "task_duration",
+          "TaskQueue" + std::to_string(static_cast<int>(queue_id_)));
+    }
+    task_duration = task_duration_;
+  }
   for (const auto& invocation : invocations) {
-    invocation();
-    std::vector<fml::closure> observers =
-        task_queue_->GetObserversToNotify(queue_id_);
+    if (task_duration) {
+      const auto start = fml::TimePoint::Now();
+      invocation();
+      task_duration->Add(fml::TimePoint::Now() - start);
+    } else {
+      invocation();
+    }
+    const size_t version = task_queue_->GetObserversVersion();
+    if (!has_observers || version != observers_version) {
+      observers = task_queue_->GetObserversToNotify(queue_id_);
+      observers_version = version;
+      has_observers = true;
+    }
     for (const auto& observer : observers) {
       observer();
     }
   }
+
+  if (task_duration) {
+    SyncProfiler::MaybeTraceCounters();
+  }
 }
 
 void MessageLoopImpl::RunExpiredTasksNow() {
@@ -18,6 +18,7 @@
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/message_loop_task_queues.h"
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/fml/wakeable.h"
 
@@ -34,7 +35,13 @@ class MessageLoopImpl : public Wakeable,
 
   virtual void Terminate() = 0;
 
-  void PostTask(const fml::closure& task, fml::TimePoint target_time);
+  void PostTask(fml::UniqueClosure task,
+                fml::TimePoint target_time,
+                TaskPriority priority = TaskPriority::kNormal);
+
+  void PostTasks(std::vector<fml::UniqueClosure> tasks,
+                 fml::TimePoint target_time,
+                 TaskPriority priority = TaskPriority::kNormal);
 
   void AddTaskObserver(intptr_t key, const fml::closure& callback);
 
@@ -63,6 +70,8 @@ class MessageLoopImpl : public Wakeable,
   TaskQueueId queue_id_;
 
   std::atomic_bool terminated_;
+  // Only used on the thread of the loop, see |SyncProfiler|.
+  SyncProfiler::Histogram* task_duration_ = nullptr;
 
   void FlushTasks(FlushType type);
 
@@ -8,6 +8,7 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop_impl.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace fml {
@@ -22,9 +23,50 @@ TaskQueueEntry::TaskQueueEntry()
     : owner_of(_kUnmerged), subsumed_by(_kUnmerged) {
   wakeable = NULL;
   task_observers = TaskObservers();
-  delayed_tasks = DelayedTaskQueue();
 }
 
+// Locks a queue along with the queue it is merged with, if any. The owner is
+// always locked first. The merge state may change before the owner is locked,
+// in which case this starts over with the new state.
+class MessageLoopTaskQueues::MergedQueuesLock {
+ public:
+  MergedQueuesLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id) {
+    TaskQueueEntry* entry = queues.GetEntry(queue_id);
+    while (true) {
+      const TaskQueueId owner_id = entry->subsumed_by.load();
+      owner_ = owner_id == _kUnmerged ? entry : queues.GetEntry(owner_id);
+      owner_lock_ = SyncProfiler::Lock(owner_->mutex, site_);
+      // Merging and unmerging lock the owner, so the state is stable now.
+      if (entry->subsumed_by.load() != owner_id) {
+        owner_lock_.unlock();
+        continue;
+      }
+      const TaskQueueId subsumed_id = owner_->owner_of.load();
+      if (subsumed_id != _kUnmerged) {
+        subsumed_ = queues.GetEntry(subsumed_id);
+        subsumed_lock_ = SyncProfiler::Lock(subsumed_->mutex, site_);
+      }
+      return;
+    }
+  }
+
+  // The entry of the queue that runs the tasks of both queues.
+  TaskQueueEntry* owner() const { return owner_; }
+
+  // The entry of the queue merged into |owner|, or null.
+  TaskQueueEntry* subsumed() const { return subsumed_; }
+
+ private:
+  TaskQueueEntry* owner_ = nullptr;
+  TaskQueueEntry* subsumed_ = nullptr;
+  std::unique_lock<std::mutex> owner_lock_;
+  std::unique_lock<std::mutex> subsumed_lock_;
+
+  static inline SyncProfiler::Site site_{"MessageLoopTaskQueues::mutex"};
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MergedQueuesLock);
+};
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -34,80 +76,174 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  std::lock_guard guard(queue_creation_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
+  FML_CHECK(task_queue_id_counter_ < kQueueSegmentSize * kMaxQueueSegments)
+      << "Too many task queues.";
   ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>();
+  auto& segment = queue_segments_[loop_id / kQueueSegmentSize];
+  if (!segment.load(std::memory_order_relaxed)) {
+    segment.store(new QueueSegment(), std::memory_order_release);
+  }
+  GetSlot(loop_id).store(new TaskQueueEntry(), std::memory_order_release);
   return loop_id;
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : queue_segments_(),
+      task_queue_id_counter_(0),
+      order_(0),
+      observers_version_(0) {}
+
+MessageLoopTaskQueues::~MessageLoopTaskQueues() {
+  for (auto& segment : queue_segments_) {
+    QueueSegment* entries = segment.load();
+    if (!entries) {
+      break;
+    }
+    for (auto& entry : *entries) {
+      delete entry.load();
+    }
+    delete entries;
+  }
+}
 
-MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
+std::atomic<TaskQueueEntry*>& MessageLoopTaskQueues::GetSlot(
+    TaskQueueId queue_id) const {
+  const size_t index = static_cast<size_t>(static_cast<int>(queue_id));
+  FML_CHECK(index < kQueueSegmentSize * kMaxQueueSegments);
+  QueueSegment* segment = queue_segments_[index / kQueueSegmentSize].load(
+      std::memory_order_acquire);
+  FML_CHECK(segment) << "Unknown task queue " << index;
+  return (*segment)[index % kQueueSegmentSize];
+}
+
+TaskQueueEntry* MessageLoopTaskQueues::GetEntry(TaskQueueId queue_id) const {
+  TaskQueueEntry* entry = GetSlot(queue_id).load(std::memory_order_acquire);
+  FML_CHECK(entry) << "Unknown task queue " << static_cast<int>(queue_id);
+  return entry;
+}
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  TaskQueueId subsumed = queue_entry->owner_of;
-  queue_entries_.erase(queue_id);
-  if (subsumed != _kUnmerged) {
-    queue_entries_.erase(subsumed);
+  TaskQueueEntry* entry = nullptr;
+  TaskQueueEntry* subsumed = nullptr;
+  {
+    MergedQueuesLock lock(*this, queue_id);
+    FML_DCHECK(lock.owner() == GetEntry(queue_id));
+    entry = lock.owner();
+    subsumed = lock.subsumed();
+    GetSlot(queue_id).store(nullptr, std::memory_order_release);
+    if (subsumed) {
+      GetSlot(entry->owner_of.load()).store(nullptr, std::memory_order_release);
+    }
   }
+  // The entries hold the mutexes, so they can only go once unlocked. Like with
+  // any other call, the queues may not be used concurrently with |Dispose|.
+  delete entry;
+  delete subsumed;
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
-  TaskQueueId subsumed = queue_entry->owner_of;
-  queue_entry->delayed_tasks = {};
-  if (subsumed != _kUnmerged) {
-    queue_entries_.at(subsumed)->delayed_tasks = {};
+  MergedQueuesLock lock(*this, queue_id);
+  FML_DCHECK(lock.owner() == GetEntry(queue_id));
+  for (auto& tasks : lock.owner()->delayed_tasks) {
+    tasks.clear();
+  }
+  if (lock.subsumed()) {
+    for (auto& tasks : lock.subsumed()->delayed_tasks) {
+      tasks.clear();
+    }
   }
 }
 
 void MessageLoopTaskQueues::RegisterTask(TaskQueueId queue_id,
-                                         const fml::closure& task,
-                                         fml::TimePoint target_time) {
-  std::lock_guard guard(queue_mutex_);
+                                         fml::UniqueClosure task,
+                                         fml::TimePoint target_time,
+                                         TaskPriority priority) {
+  MergedQueuesLock lock(*this, queue_id);
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->delayed_tasks.push({order, task, target_time});
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  queue_entry->delayed_tasks[static_cast<size_t>(priority)].push(
+      {order, std::move(task), target_time});
+  // The owner runs the tasks of both queues. Holding its lock orders this
+  // wake up with the ones for the tasks posted to the owner directly.
+  TaskQueueId loop_to_wake = queue_id;
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
+    loop_to_wake = queue_entry->subsumed_by.load();
+  }
+  WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+}
+
+void MessageLoopTaskQueues::RegisterTasks(TaskQueueId queue_id,
+                                          std::vector<fml::UniqueClosure> tasks,
+                                          fml::TimePoint target_time,
+                                          TaskPriority priority) {
+  if (tasks.empty()) {
+    return;
+  }
+  MergedQueuesLock lock(*this, queue_id);
+  TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  auto& delayed_tasks =
+      queue_entry->delayed_tasks[static_cast<size_t>(priority)];
+  for (auto& task : tasks) {
+    size_t order = order_++;
+    delayed_tasks.push({order, std::move(task), target_time});
+  }
   TaskQueueId loop_to_wake = queue_id;
-  if (queue_entry->subsumed_by != _kUnmerged) {
-    loop_to_wake = queue_entry->subsumed_by;
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
+    loop_to_wake = queue_entry->subsumed_by.load();
   }
-  WakeUpUnlocked(loop_to_wake,
-                 queue_entry->delayed_tasks.top().GetTargetTime());
+  WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 void MessageLoopTaskQueues::GetTasksToRunNow(
     TaskQueueId queue_id,
     FlushType type,
-    std::vector<fml::closure>& invocations) {
-  std::lock_guard guard(queue_mutex_);
+    std::vector<fml::UniqueClosure>& invocations) {
+  MergedQueuesLock lock(*this, queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return;
   }
 
   const auto now = fml::TimePoint::Now();
+  const size_t first_invocation = invocations.size();
+  SyncProfiler::Histogram* queue_latency = nullptr;
+  if (SyncProfiler::IsEnabled()) {
+    if (!lock.owner()->queue_latency) {
+      lock.owner()->queue_latency = &SyncProfiler::GetForCurrentThread(
+          "queue_latency",
+          "TaskQueue" + std::to_string(static_cast<int>(queue_id)));
+    }
+    queue_latency = lock.owner()->queue_latency;
+  }
 
-  while (HasPendingTasksUnlocked(queue_id)) {
-    TaskQueueId top_queue = _kUnmerged;
-    const auto& top = PeekNextTaskUnlocked(queue_id, top_queue);
-    if (top.GetTargetTime() > now) {
+  for (size_t priority = 0; priority < kTaskPriorityCount; priority++) {
+    // Idle tasks wait for a flush with nothing else to run. The wake up below
+    // is for right away if they are due.
+    if (static_cast<TaskPriority>(priority) == TaskPriority::kIdle &&
+        invocations.size() > first_invocation) {
       break;
     }
-    invocations.emplace_back(top.GetTask());
-    queue_entries_.at(top_queue)->delayed_tasks.pop();
-    if (type == FlushType::kSingle) {
+    while (DelayedTaskQueue* tasks = PeekNextTasksUnlocked(
+               queue_id, static_cast<TaskPriority>(priority))) {
+      if (tasks->top().GetTargetTime() > now) {
+        break;
+      }
+      if (queue_latency) {
+        queue_latency->Add(now - tasks->top().GetTargetTime());
+      }
+      invocations.emplace_back(tasks->top().TakeTask());
+      tasks->pop();
+      if (type == FlushType::kSingle) {
+        break;
+      }
+    }
+    if (type == FlushType::kSingle && invocations.size() > first_invocation) {
       break;
     }
   }
@@ -121,25 +257,28 @@ void MessageLoopTaskQueues::GetTasksToRunNow(
 
 void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  Wakeable* wakeable = GetEntry(queue_id)->wakeable;
+  if (wakeable) {
+    wakeable->WakeUp(time);
   }
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
-  if (queue_entry->subsumed_by != _kUnmerged) {
+  MergedQueuesLock lock(*this, queue_id);
+  const TaskQueueEntry* queue_entry = GetEntry(queue_id);
+  if (queue_entry->subsumed_by.load() != _kUnmerged) {
     return 0;
   }
 
   size_t total_tasks = 0;
-  total_tasks += queue_entry->delayed_tasks.size();
+  for (const auto& tasks : queue_entry->delayed_tasks) {
+    total_tasks += tasks.size();
+  }
 
-  TaskQueueId subsumed = queue_entry->owner_of;
-  if (subsumed != _kUnmerged) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
-    total_tasks += subsumed_entry->delayed_tasks.size();
+  if (lock.subsumed()) {
+    for (const auto& tasks : lock.subsumed()->delayed_tasks) {
+      total_tasks += tasks.size();
+    }
   }
   return total_tasks;
 }
@@ -147,33 +286,40 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  entry->task_observers[key] = callback;
+  observers_version_++;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  entry->task_observers.erase(key);
+  observers_version_++;
+}
+
+size_t MessageLoopTaskQueues::GetObserversVersion() const {
+  return observers_version_;
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  MergedQueuesLock lock(*this, queue_id);
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
+  if (GetEntry(queue_id)->subsumed_by.load() != _kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : lock.owner()->task_observers) {
     observers.push_back(observer.second);
   }
 
-  TaskQueueId subsumed = queue_entries_.at(queue_id)->owner_of;
-  if (subsumed != _kUnmerged) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+  if (lock.subsumed()) {
+    for (const auto& observer : lock.subsumed()->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -183,36 +329,56 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  FML_CHECK(!entry->wakeable) << "Wakeable can only be set once.";
+  entry->wakeable = wakeable;
+}
+
+void MessageLoopTaskQueues::SetTimerTolerance(TaskQueueId queue_id,
+                                              fml::TimeDelta tolerance) {
+  MergedQueuesLock lock(*this, queue_id);
+  TaskQueueEntry* entry = GetEntry(queue_id);
+  for (size_t priority = 0; priority < kTaskPriorityCount; priority++) {
+    // High priority tasks are frame critical, those always run on time.
+    if (static_cast<TaskPriority>(priority) != TaskPriority::kHigh) {
+      entry->delayed_tasks[priority].SetTolerance(tolerance);
+    }
+  }
+  TaskQueueId loop_to_wake = queue_id;
+  if (entry->subsumed_by.load() != _kUnmerged) {
+    loop_to_wake = entry->subsumed_by.load();
+  }
+  if (HasPendingTasksUnlocked(loop_to_wake)) {
+    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  }
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  TaskQueueEntry* subsumed_entry = GetEntry(subsumed);
+  // Avoids deadlocks with a concurrent merge of the queues the other way
+  // around. Neither queue is merged with a third one if this succeeds.
+  std::scoped_lock guard(owner_entry->mutex, subsumed_entry->mutex);
 
-  if (owner_entry->owner_of == subsumed) {
+  if (owner_entry->owner_of.load() == subsumed) {
     return true;
   }
 
-  std::vector<TaskQueueId> owner_subsumed_keys = {
-      owner_entry->owner_of, owner_entry->subsumed_by, subsumed_entry->owner_of,
-      subsumed_entry->subsumed_by};
-
-  for (auto key : owner_subsumed_keys) {
-    if (key != _kUnmerged) {
-      return false;
-    }
+  // Neither queue may be merged with any other queue.
+  if (owner_entry->owner_of.load() != _kUnmerged ||
+      owner_entry->subsumed_by.load() != _kUnmerged ||
+      subsumed_entry->owner_of.load() != _kUnmerged ||
+      subsumed_entry->subsumed_by.load() != _kUnmerged) {
+    return false;
   }
 
   owner_entry->owner_of = subsumed;
   subsumed_entry->subsumed_by = owner;
+  observers_version_++;
 
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
@@ -222,16 +388,20 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
-  const TaskQueueId subsumed = owner_entry->owner_of;
-  if (subsumed == _kUnmerged) {
+  MergedQueuesLock lock(*this, owner);
+  TaskQueueEntry* owner_entry = GetEntry(owner);
+  TaskQueueEntry* subsumed_entry = lock.subsumed();
+  if (lock.owner() != owner_entry || !subsumed_entry) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = _kUnmerged;
+  const TaskQueueId subsumed = owner_entry->owner_of.load();
+  subsumed_entry->subsumed_by = _kUnmerged;
   owner_entry->owner_of = _kUnmerged;
+  observers_version_++;
 
+  // Once unmerged, each queue only has its own tasks. Wake each loop for the
+  // first of those.
   if (HasPendingTasksUnlocked(owner)) {
     WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
   }
@@ -245,70 +415,71 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
-  return subsumed == queue_entries_.at(owner)->owner_of || owner == subsumed;
+  return owner == subsumed || subsumed == GetEntry(owner)->owner_of.load();
 }
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
-  bool is_subsumed = entry->subsumed_by != _kUnmerged;
+  const TaskQueueEntry* entry = GetEntry(queue_id);
+  bool is_subsumed = entry->subsumed_by.load() != _kUnmerged;
   if (is_subsumed) {
     return false;
   }
 
-  if (!entry->delayed_tasks.empty()) {
-    return true;
-  }
-
-  const TaskQueueId subsumed = entry->owner_of;
-  if (subsumed == _kUnmerged) {
-    // this is not an owner and queue is empty.
-    return false;
-  } else {
-    return !queue_entries_.at(subsumed)->delayed_tasks.empty();
+  for (size_t priority = 0; priority < kTaskPriorityCount; priority++) {
+    if (PeekNextTasksUnlocked(queue_id, static_cast<TaskPriority>(priority))) {
+      return true;
+    }
   }
+  return false;
 }
 
 fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
     TaskQueueId queue_id) const {
-  TaskQueueId tmp = _kUnmerged;
-  return PeekNextTaskUnlocked(queue_id, tmp).GetTargetTime();
+  FML_DCHECK(HasPendingTasksUnlocked(queue_id));
+  fml::TimePoint wake_time = fml::TimePoint::Max();
+  for (size_t priority = 0; priority < kTaskPriorityCount; priority++) {
+    const DelayedTaskQueue* tasks =
+        PeekNextTasksUnlocked(queue_id, static_cast<TaskPriority>(priority));
+    if (tasks) {
+      wake_time = std::min(wake_time, tasks->GetWakeTime());
+    }
+  }
+  return wake_time;
 }
 
-const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
+DelayedTaskQueue* MessageLoopTaskQueues::PeekNextTasksUnlocked(
     TaskQueueId owner,
-    TaskQueueId& top_queue_id) const {
-  FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
-  const TaskQueueId subsumed = entry->owner_of;
+    TaskPriority priority) const {
+  TaskQueueEntry* entry = GetEntry(owner);
+  DelayedTaskQueue& owner_tasks =
+      entry->delayed_tasks[static_cast<size_t>(priority)];
+  const TaskQueueId subsumed = entry->owner_of.load();
   if (subsumed == _kUnmerged) {
-    top_queue_id = owner;
-    return entry->delayed_tasks.top();
+    return owner_tasks.empty() ? nullptr : &owner_tasks;
   }
 
-  const auto& owner_tasks = entry->delayed_tasks;
-  const auto& subsumed_tasks = queue_entries_.at(subsumed)->delayed_tasks;
+  DelayedTaskQueue& subsumed_tasks =
+      GetEntry(subsumed)->delayed_tasks[static_cast<size_t>(priority)];
 
   // we are owning another task queue
   const bool subsumed_has_task = !subsumed_tasks.empty();
   const bool owner_has_task = !owner_tasks.empty();
   if (owner_has_task && subsumed_has_task) {
-    const auto owner_task = owner_tasks.top();
-    const auto subsumed_task = subsumed_tasks.top();
-    if (owner_task > subsumed_task) {
-      top_queue_id = subsumed;
+    // Compare in place, copying the tasks would copy their closures.
+    if (owner_tasks.top() > subsumed_tasks.top()) {
+      return &subsumed_tasks;
     } else {
-      top_queue_id = owner;
+      return &owner_tasks;
     }
   } else if (owner_has_task) {
-    top_queue_id = owner;
-  } else {
-    top_queue_id = subsumed;
+    return &owner_tasks;
+  } else if (subsumed_has_task) {
+    return &subsumed_tasks;
   }
-  return queue_entries_.at(top_queue_id)->delayed_tasks.top();
+  return nullptr;
 }
 
 }  // namespace fml
@@ -5,15 +5,19 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/delayed_task.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/shared_mutex.h"
+#include "flutter/fml/sync_profiler.h"
+#include "flutter/fml/unique_closure.h"
 #include "flutter/fml/wakeable.h"
 
 namespace fml {
@@ -32,21 +36,46 @@ class TaskQueueId {
 
 static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 
+// The order in which due tasks are run. Tasks of a higher priority that are
+// due run before any due tasks of a lower priority, and tasks of the same
+// priority run in the order of their target times.
+enum class TaskPriority : size_t {
+  // Frame critical work such as vsync callbacks and input dispatch.
+  kHigh,
+  kNormal,
+  // Housekeeping. Idle tasks only run once the queue has no due tasks of the
+  // other priorities left.
+  kIdle,
+};
+
+static constexpr size_t kTaskPriorityCount = 3;
+
 // This is keyed by the |TaskQueueId| and contains all the queue
 // components that make up a single TaskQueue.
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
+
+  // Guards all the other members. Merged queues are always locked together,
+  // the owner first.
+  std::mutex mutex;
   Wakeable* wakeable;
   TaskObservers task_observers;
-  DelayedTaskQueue delayed_tasks;
+  // Indexed by |TaskPriority|.
+  std::array<DelayedTaskQueue, kTaskPriorityCount> delayed_tasks;
+  // The histogram of the time tasks spend past their target time, looked up
+  // on the first flush while the |SyncProfiler| is enabled.
+  SyncProfiler::Histogram* queue_latency = nullptr;
 
   // Note: Both of these can be _kUnmerged, which indicates that
   // this queue has not been merged or subsumed. OR exactly one
   // of these will be _kUnmerged, if owner_of is _kUnmerged, it means
   // that the queue has been subsumed or else it owns another queue.
-  TaskQueueId owner_of;
-  TaskQueueId subsumed_by;
+  //
+  // These are only written with both the owner and the subsumed queue locked,
+  // but may be read without any lock to find the queues to lock.
+  std::atomic<TaskQueueId> owner_of;
+  std::atomic<TaskQueueId> subsumed_by;
 
   TaskQueueEntry();
 
@@ -78,14 +107,22 @@ class MessageLoopTaskQueues
   // Tasks methods.
 
   void RegisterTask(TaskQueueId queue_id,
-                    const fml::closure& task,
-                    fml::TimePoint target_time);
+                    fml::UniqueClosure task,
+                    fml::TimePoint target_time,
+                    TaskPriority priority = TaskPriority::kNormal);
+
+  // Registers all of |tasks| for the same time, with the queue locked and the
+  // loop woken up only once.
+  void RegisterTasks(TaskQueueId queue_id,
+                     std::vector<fml::UniqueClosure> tasks,
+                     fml::TimePoint target_time,
+                     TaskPriority priority = TaskPriority::kNormal);
 
   bool HasPendingTasks(TaskQueueId queue_id) const;
 
   void GetTasksToRunNow(TaskQueueId queue_id,
                         FlushType type,
-                        std::vector<fml::closure>& invocations);
+                        std::vector<fml::UniqueClosure>& invocations);
 
   size_t GetNumPendingTasks(TaskQueueId queue_id) const;
 
@@ -99,10 +136,22 @@ class MessageLoopTaskQueues
 
   std::vector<fml::closure> GetObserversToNotify(TaskQueueId queue_id) const;
 
+  // Changes whenever the observers of any queue may have changed, including
+  // through merging and unmerging queues. Lets loops keep the observers they
+  // got from |GetObserversToNotify| for as long as this stays the same.
+  size_t GetObserversVersion() const;
+
   // Misc.
 
   void SetWakeable(TaskQueueId queue_id, fml::Wakeable* wakeable);
 
+  // Lets the delayed tasks of the queue run up to |tolerance| late, so that
+  // timers due close to each other share a wake up. The tasks are then kept in
+  // a timing wheel, which makes posting cheap for queues with many timers.
+  // High priority tasks always run on time. A zero tolerance, the default,
+  // wakes up for every task exactly at its target time.
+  void SetTimerTolerance(TaskQueueId queue_id, fml::TimeDelta tolerance);
+
   // Invariants for merge and un-merge
   //  1. RegisterTask will always submit to the queue_id that is passed
   //     to it. It is not aware of whether a queue is merged or not. Same with
@@ -125,31 +174,48 @@ class MessageLoopTaskQueues
   bool Owns(TaskQueueId owner, TaskQueueId subsumed) const;
 
  private:
-  class MergedQueuesRunner;
+  class MergedQueuesLock;
+
+  // Queues are looked up without locking in a table of fixed size segments
+  // indexed by their id. Ids are never reused, so a slot only ever goes from
+  // empty to holding its entry and back to empty once the queue is disposed.
+  static constexpr size_t kQueueSegmentSize = 1024;
+  static constexpr size_t kMaxQueueSegments = 4096;
+  using QueueSegment =
+      std::array<std::atomic<TaskQueueEntry*>, kQueueSegmentSize>;
 
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  TaskQueueEntry* GetEntry(TaskQueueId queue_id) const;
+
+  std::atomic<TaskQueueEntry*>& GetSlot(TaskQueueId queue_id) const;
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
 
-  const DelayedTask& PeekNextTaskUnlocked(TaskQueueId owner,
-                                          TaskQueueId& top_queue_id) const;
+  // Returns the tasks of |priority| of the owner or of the queue it owns,
+  // whichever has the task to run next, or null if neither has any.
+  DelayedTaskQueue* PeekNextTasksUnlocked(TaskQueueId owner,
+                                          TaskPriority priority) const;
 
   fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
 
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  // Guards the creation of queues and of the segments that hold them.
+  std::mutex queue_creation_mutex_;
+  std::array<std::atomic<QueueSegment*>, kMaxQueueSegments> queue_segments_;
 
   size_t task_queue_id_counter_;
 
   std::atomic_int order_;
 
+  std::atomic_size_t observers_version_;
+
   FML_FRIEND_MAKE_REF_COUNTED(MessageLoopTaskQueues);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MessageLoopTaskQueues);
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(MessageLoopTaskQueues);
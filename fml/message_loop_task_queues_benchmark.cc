@@ -3,12 +3,15 @@
 // found in the LICENSE file.
 
 #include <cassert>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/delayed_task.h"
 #include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/wakeable.h"
 
 namespace fml {
 namespace benchmarking {
@@ -39,7 +42,7 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {
         }
         tasks_registered.CountDown();
         tasks_registered.Wait();
-        std::vector<fml::closure> invocations;
+        std::vector<fml::UniqueClosure> invocations;
         task_queue->GetTasksToRunNow(TaskQueueId(task_runner_id),
                                      fml::FlushType::kAll, invocations);
         assert(invocations.size() == num_tasks_per_queue);
@@ -57,5 +60,180 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Posts from |state.range(0)| threads at once, each to a queue of its own or,
+// if |shared_queue| is set, all of them to the same queue. The time includes
+// draining the queues.
+static void BM_RegisterTasksConcurrently(benchmark::State& state,
+                                         bool shared_queue) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  const int num_threads = state.range(0);
+  const int num_tasks_per_thread = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  std::vector<TaskQueueId> queue_ids;
+  for (int i = 0; i < (shared_queue ? 1 : num_threads); i++) {
+    queue_ids.push_back(task_queue->CreateTaskQueue());
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+      const TaskQueueId queue_id = queue_ids[i % queue_ids.size()];
+      threads.emplace_back([queue_id, &task_queue, past]() {
+        for (int j = 0; j < num_tasks_per_thread; j++) {
+          task_queue->RegisterTask(
+              queue_id, [] {}, past);
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    std::vector<fml::UniqueClosure> invocations;
+    for (const auto& queue_id : queue_ids) {
+      task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll,
+                                   invocations);
+    }
+    assert(invocations.size() ==
+           static_cast<size_t>(num_threads * num_tasks_per_thread));
+  }
+
+  for (const auto& queue_id : queue_ids) {
+    task_queue->Dispose(queue_id);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_threads *
+                          num_tasks_per_thread);
+}
+
+BENCHMARK_CAPTURE(BM_RegisterTasksConcurrently, queue_per_thread, false)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_RegisterTasksConcurrently, shared_queue, true)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+namespace {
+
+class CountingWakeable : public Wakeable {
+ public:
+  void WakeUp(fml::TimePoint time_point) override { wake_ups++; }
+
+  size_t wake_ups = 0;
+};
+
+}  // namespace
+
+// Posts |state.range(0)| tasks to a queue and drains it, either one task at a
+// time or, if |batched| is set, all of them with a single |RegisterTasks|
+// call. Every call to the queues takes the queue lock once, so the lock
+// acquisitions are the number of calls made.
+static void BM_RegisterTasksBatched(benchmark::State& state, bool batched) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const TaskQueueId queue_id = task_queue->CreateTaskQueue();
+  auto wakeable = std::make_unique<CountingWakeable>();
+  task_queue->SetWakeable(queue_id, wakeable.get());
+
+  const size_t num_tasks = state.range(0);
+  const fml::TimePoint past = fml::TimePoint::Now();
+  size_t lock_acquisitions = 0;
+
+  while (state.KeepRunning()) {
+    if (batched) {
+      std::vector<fml::UniqueClosure> tasks;
+      tasks.reserve(num_tasks);
+      for (size_t i = 0; i < num_tasks; i++) {
+        tasks.emplace_back([] {});
+      }
+      task_queue->RegisterTasks(queue_id, std::move(tasks), past);
+      lock_acquisitions++;
+    } else {
+      for (size_t i = 0; i < num_tasks; i++) {
+        task_queue->RegisterTask(
+            queue_id, [] {}, past);
+      }
+      lock_acquisitions += num_tasks;
+    }
+
+    std::vector<fml::UniqueClosure> invocations;
+    task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+    lock_acquisitions++;
+    assert(invocations.size() == num_tasks);
+  }
+
+  const double iterations = state.iterations();
+  state.counters["WakeUps"] = wakeable->wake_ups / iterations;
+  state.counters["LockAcquisitions"] = lock_acquisitions / iterations;
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+
+  task_queue->Dispose(queue_id);
+}
+
+BENCHMARK_CAPTURE(BM_RegisterTasksBatched, individually, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK_CAPTURE(BM_RegisterTasksBatched, batched, true)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+
+// Keeps |state.range(0)| timeouts pending, like plugin timeouts that are
+// hardly ever reached, while an animation ticker and a few short timers are
+// posted and run every frame. With |tolerance| set, the tasks are kept in a
+// timing wheel and wake ups within the tolerance are coalesced. The wake ups
+// needed are reported per frame.
+static void BM_DelayedTaskQueueTimers(benchmark::State& state,
+                                      fml::TimeDelta tolerance) {
+  DelayedTaskQueue queue;
+  queue.SetTolerance(tolerance);
+  size_t order = 0;
+
+  // Far enough ahead that none of this becomes due while running.
+  const fml::TimePoint start =
+      fml::TimePoint::Now() + fml::TimeDelta::FromSeconds(3600);
+  for (int64_t i = 0; i < state.range(0); i++) {
+    queue.push({order++, nullptr,
+                start + fml::TimeDelta::FromSeconds(3600 * 1000 + i)});
+  }
+
+  fml::TimePoint frame_time = start;
+  size_t wake_ups = 0;
+  while (state.KeepRunning()) {
+    frame_time = frame_time + fml::TimeDelta::FromMilliseconds(16);
+    queue.push({order++, nullptr, frame_time});
+    for (int i = 1; i <= 4; i++) {
+      queue.push({order++, nullptr,
+                  frame_time + fml::TimeDelta::FromMilliseconds(3 * i)});
+    }
+    // Run the tasks of the frame as the loop would, waking up whenever the
+    // wake time of the next task is past the last wake up.
+    fml::TimePoint woken_until;
+    for (int i = 0; i < 5; i++) {
+      if (queue.top().GetTargetTime() > woken_until) {
+        woken_until = queue.GetWakeTime();
+        wake_ups++;
+      }
+      queue.pop();
+    }
+  }
+
+  state.counters["WakeUps"] =
+      benchmark::Counter(wake_ups, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * 5);
+}
+
+BENCHMARK_CAPTURE(BM_DelayedTaskQueueTimers, exact, fml::TimeDelta::Zero())
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_DelayedTaskQueueTimers,
+                  tolerance_8ms,
+                  fml::TimeDelta::FromMilliseconds(8))
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
+
 }  // namespace benchmarking
 }  // namespace fml
@@ -127,7 +127,7 @@ TEST(MessageLoopTaskQueueMergeUnmerge, MergeInvokesBothWakeables) {
 
   task_queue->Merge(queue_id_1, queue_id_2);
 
-  std::vector<fml::closure> invocations;
+  std::vector<fml::UniqueClosure> invocations;
   task_queue->GetTasksToRunNow(queue_id_1, fml::FlushType::kAll, invocations);
 
   latch.Wait();
@@ -157,7 +157,7 @@ TEST(MessageLoopTaskQueueMergeUnmerge,
   task_queue->Merge(queue_id_1, queue_id_2);
   task_queue->Unmerge(queue_id_1);
 
-  std::vector<fml::closure> invocations;
+  std::vector<fml::UniqueClosure> invocations;
 
   task_queue->GetTasksToRunNow(queue_id_1, fml::FlushType::kAll, invocations);
   latch_1.Wait();
@@ -184,7 +184,7 @@ TEST(MessageLoopTaskQueueMergeUnmerge, GetTasksToRunNowBlocksMerge) {
                           }));
 
   std::thread tasks_to_run_now_thread([&]() {
-    std::vector<fml::closure> invocations;
+    std::vector<fml::UniqueClosure> invocations;
     task_queue->GetTasksToRunNow(queue_id_1, fml::FlushType::kAll, invocations);
   });
 
@@ -208,3 +208,41 @@ TEST(MessageLoopTaskQueueMergeUnmerge, GetTasksToRunNowBlocksMerge) {
   tasks_to_run_now_thread.join();
   merge_thread.join();
 }
+
+TEST(MessageLoopTaskQueueMergeUnmerge, ConcurrentPostsSurviveMergeUnmerge) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  auto queue_id_1 = task_queue->CreateTaskQueue();
+  auto queue_id_2 = task_queue->CreateTaskQueue();
+
+  const int num_tasks_per_queue = 1000;
+  fml::CountDownLatch posted(2);
+  auto post_tasks = [&task_queue, &posted](fml::TaskQueueId queue_id) {
+    for (int i = 0; i < num_tasks_per_queue; i++) {
+      task_queue->RegisterTask(
+          queue_id, []() {}, fml::TimePoint::Max());
+    }
+    posted.CountDown();
+  };
+  std::thread thread_1(post_tasks, queue_id_1);
+  std::thread thread_2(post_tasks, queue_id_2);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(task_queue->Merge(queue_id_1, queue_id_2));
+    ASSERT_EQ(0u, task_queue->GetNumPendingTasks(queue_id_2));
+    ASSERT_TRUE(task_queue->Unmerge(queue_id_1));
+  }
+
+  posted.Wait();
+  thread_1.join();
+  thread_2.join();
+
+  ASSERT_EQ(static_cast<size_t>(num_tasks_per_queue),
+            task_queue->GetNumPendingTasks(queue_id_1));
+  ASSERT_EQ(static_cast<size_t>(num_tasks_per_queue),
+            task_queue->GetNumPendingTasks(queue_id_2));
+
+  task_queue->Merge(queue_id_1, queue_id_2);
+  ASSERT_EQ(static_cast<size_t>(2 * num_tasks_per_queue),
+            task_queue->GetNumPendingTasks(queue_id_1));
+}
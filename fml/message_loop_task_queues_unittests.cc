@@ -69,7 +69,7 @@ TEST(MessageLoopTaskQueue, PreserveTaskOrdering) {
   task_queue->RegisterTask(
       queue_id, [&test_val]() { test_val = 2; }, fml::TimePoint::Now());
 
-  std::vector<fml::closure> invocations;
+  std::vector<fml::UniqueClosure> invocations;
   task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
 
   int expected_value = 1;
@@ -81,6 +81,139 @@ TEST(MessageLoopTaskQueue, PreserveTaskOrdering) {
   }
 }
 
+TEST(MessageLoopTaskQueue, HigherPriorityTasksRunFirst) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  std::vector<int> order;
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(2); }, now,
+      fml::TaskPriority::kNormal);
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(1); }, now,
+      fml::TaskPriority::kHigh);
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(3); }, now,
+      fml::TaskPriority::kNormal);
+  ASSERT_EQ(3u, task_queue->GetNumPendingTasks(queue_id));
+
+  std::vector<fml::UniqueClosure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kSingle, invocations);
+  ASSERT_EQ(1u, invocations.size());
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(3u, invocations.size());
+
+  for (auto& invocation : invocations) {
+    invocation();
+  }
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MessageLoopTaskQueue, IdleTasksWaitForOtherTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  fml::TimePoint wake_time = fml::TimePoint::Max();
+  task_queue->SetWakeable(queue_id,
+                          new TestWakeable([&wake_time](fml::TimePoint time) {
+                            wake_time = time;
+                          }));
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, []() {}, now, fml::TaskPriority::kIdle);
+  task_queue->RegisterTask(
+      queue_id, []() {}, now, fml::TaskPriority::kNormal);
+
+  // The idle task is due but waits for the next flush, which is right away.
+  std::vector<fml::UniqueClosure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(1u, invocations.size());
+  ASSERT_EQ(1u, task_queue->GetNumPendingTasks(queue_id));
+  ASSERT_TRUE(wake_time == now);
+
+  invocations.clear();
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(1u, invocations.size());
+  ASSERT_FALSE(task_queue->HasPendingTasks(queue_id));
+  ASSERT_TRUE(wake_time == fml::TimePoint::Max());
+}
+
+TEST(MessageLoopTaskQueue, RegisterTasksWakesUpOnce) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int wake_ups = 0;
+  task_queue->SetWakeable(
+      queue_id, new TestWakeable([&wake_ups](fml::TimePoint) { wake_ups++; }));
+
+  std::vector<int> order;
+  std::vector<fml::UniqueClosure> tasks;
+  for (int i = 0; i < 3; i++) {
+    tasks.emplace_back([&order, i]() { order.push_back(i); });
+  }
+  task_queue->RegisterTasks(queue_id, std::move(tasks), fml::TimePoint::Now());
+  ASSERT_EQ(1, wake_ups);
+  ASSERT_EQ(3u, task_queue->GetNumPendingTasks(queue_id));
+
+  std::vector<fml::UniqueClosure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  for (auto& invocation : invocations) {
+    invocation();
+  }
+  ASSERT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(MessageLoopTaskQueue, TimerToleranceCoalescesWakeUps) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  fml::TimePoint wake_time;
+  task_queue->SetWakeable(queue_id,
+                          new TestWakeable([&wake_time](fml::TimePoint time) {
+                            wake_time = time;
+                          }));
+  const auto tolerance = fml::TimeDelta::FromSeconds(10);
+  task_queue->SetTimerTolerance(queue_id, tolerance);
+
+  const auto now = fml::TimePoint::Now();
+  const auto slot_start = fml::TimePoint::FromEpochDelta(
+      tolerance * ((now.ToEpochDelta() + tolerance * 10) / tolerance));
+  task_queue->RegisterTask(
+      queue_id, []() {}, slot_start + fml::TimeDelta::FromSeconds(5));
+  ASSERT_EQ(wake_time, slot_start + tolerance);
+  task_queue->RegisterTask(
+      queue_id, []() {}, slot_start + fml::TimeDelta::FromSeconds(1));
+  ASSERT_EQ(wake_time, slot_start + tolerance);
+
+  // High priority tasks still wake up on time.
+  task_queue->RegisterTask(
+      queue_id, []() {}, slot_start + fml::TimeDelta::FromSeconds(2),
+      fml::TaskPriority::kHigh);
+  ASSERT_EQ(wake_time, slot_start + fml::TimeDelta::FromSeconds(2));
+  ASSERT_EQ(3u, task_queue->GetNumPendingTasks(queue_id));
+
+  // Due tasks wake up right away.
+  task_queue->RegisterTask(
+      queue_id, []() {}, now);
+  ASSERT_EQ(wake_time, now);
+}
+
+TEST(MessageLoopTaskQueue, ObserversVersionChangesWithObservers) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+
+  size_t version = task_queue->GetObserversVersion();
+  task_queue->AddTaskObserver(queue_id, 1, []() {});
+  ASSERT_NE(version, task_queue->GetObserversVersion());
+
+  version = task_queue->GetObserversVersion();
+  task_queue->RegisterTask(
+      queue_id, []() {}, fml::TimePoint::Now());
+  ASSERT_EQ(version, task_queue->GetObserversVersion());
+
+  task_queue->RemoveTaskObserver(queue_id, 1);
+  ASSERT_NE(version, task_queue->GetObserversVersion());
+}
+
 void TestNotifyObservers(fml::TaskQueueId queue_id) {
   auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
   std::vector<fml::closure> observers =
@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -315,3 +316,77 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTasksOnAllWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  fml::CountDownLatch latch(loop->GetWorkerCount());
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), loop->GetWorkerCount());
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopStealsFromBusyWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+
+  // Keeps the worker for affinity 0 busy while more tasks are queued on it.
+  fml::AutoResetWaitableEvent blocked;
+  fml::AutoResetWaitableEvent unblock;
+  task_runner->PostTaskWithAffinity(
+      [&]() {
+        blocked.Signal();
+        unblock.Wait();
+      },
+      0);
+  blocked.Wait();
+
+  const size_t kCount = 10;
+  fml::CountDownLatch latch(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    task_runner->PostTaskWithAffinity([&latch]() { latch.CountDown(); }, 0);
+  }
+  latch.Wait();
+  unblock.Signal();
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  // Keeps the only worker busy while tasks of every class are queued.
+  fml::AutoResetWaitableEvent blocked;
+  fml::AutoResetWaitableEvent unblock;
+  task_runner->PostTask([&]() {
+    blocked.Signal();
+    unblock.Wait();
+  });
+  blocked.Wait();
+
+  std::vector<fml::ConcurrentTaskPriority> order;
+  fml::CountDownLatch latch(3);
+  for (auto priority : {fml::ConcurrentTaskPriority::kLow,
+                        fml::ConcurrentTaskPriority::kNormal,
+                        fml::ConcurrentTaskPriority::kHigh}) {
+    task_runner->PostTask(
+        [&order, &latch, priority]() {
+          order.push_back(priority);
+          latch.CountDown();
+        },
+        priority);
+  }
+  unblock.Signal();
+  latch.Wait();
+
+  ASSERT_EQ(order.size(), 3u);
+  ASSERT_EQ(order[0], fml::ConcurrentTaskPriority::kHigh);
+  ASSERT_EQ(order[1], fml::ConcurrentTaskPriority::kNormal);
+  ASSERT_EQ(order[2], fml::ConcurrentTaskPriority::kLow);
+}
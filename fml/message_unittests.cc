@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 #include "flutter/fml/message.h"
+
+#include <cstdint>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace fml {
@@ -64,4 +68,89 @@ TEST(MessageTest, CanDecodeTriviallyCopyableTypes) {
   ASSERT_EQ(message.GetDataLength(), message.GetSizeRead());
 }
 
+TEST(MessageTest, DoesNotDecodePastTheEncodedData) {
+  Message message;
+  ASSERT_TRUE(message.Encode(12));
+  ASSERT_TRUE(message.Encode('a'));
+  ASSERT_GT(message.GetBufferSize(), message.GetDataLength());
+
+  int int1 = 0;
+  ASSERT_TRUE(message.Decode(int1));
+  char char1 = 0;
+  ASSERT_TRUE(message.Decode(char1));
+  ASSERT_FALSE(message.Decode(char1));
+}
+
+TEST(MessageTest, EncodesIntoCallerProvidedBuffers) {
+  alignas(std::max_align_t) uint8_t buffer[16];
+  auto message = Message::WithBuffer(buffer, sizeof(buffer));
+  ASSERT_TRUE(message.Encode(uint64_t{1}));
+  ASSERT_TRUE(message.Encode(uint64_t{2}));
+  ASSERT_EQ(message.GetBuffer(), buffer);
+
+  // The buffer is full and is never reallocated.
+  ASSERT_FALSE(message.Encode('a'));
+  ASSERT_EQ(message.GetBuffer(), buffer);
+  ASSERT_EQ(message.GetDataLength(), 16u);
+
+  uint64_t value = 0;
+  ASSERT_TRUE(message.Decode(value));
+  ASSERT_EQ(value, 1u);
+  ASSERT_TRUE(message.Decode(value));
+  ASSERT_EQ(value, 2u);
+}
+
+TEST(MessageTest, DecodesArraysInPlace) {
+  const std::vector<float> floats = {1.0f, 2.0f, 3.0f};
+  const TestStruct structs[2] = {};
+  Message message;
+  ASSERT_TRUE(message.Encode('a'));
+  ASSERT_TRUE(message.EncodeArray(floats.data(), floats.size()));
+  ASSERT_TRUE(message.EncodeArray(structs, 2));
+  ASSERT_TRUE(message.EncodeArray<int>(nullptr, 0));
+
+  auto view = Message::View(message.GetBuffer(), message.GetDataLength());
+  ASSERT_FALSE(view.Encode('b'));
+
+  char c = 0;
+  ASSERT_TRUE(view.Decode(c));
+  ASSERT_EQ(c, 'a');
+
+  const float* decoded_floats = nullptr;
+  size_t count = 0;
+  ASSERT_TRUE(view.DecodeArray(decoded_floats, count));
+  ASSERT_EQ(count, 3u);
+  ASSERT_GE(reinterpret_cast<const uint8_t*>(decoded_floats),
+            message.GetBuffer());
+  ASSERT_LT(reinterpret_cast<const uint8_t*>(decoded_floats),
+            message.GetBuffer() + message.GetDataLength());
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(decoded_floats) % alignof(float), 0u);
+  ASSERT_EQ(std::vector<float>(decoded_floats, decoded_floats + count),
+            floats);
+
+  const TestStruct* decoded_structs = nullptr;
+  ASSERT_TRUE(view.DecodeArray(decoded_structs, count));
+  ASSERT_EQ(count, 2u);
+  ASSERT_EQ(decoded_structs[1].a, 12);
+  ASSERT_EQ(decoded_structs[1].b, 'x');
+
+  const int* ints = nullptr;
+  ASSERT_TRUE(view.DecodeArray(ints, count));
+  ASSERT_EQ(count, 0u);
+  ASSERT_EQ(view.GetSizeRead(), view.GetDataLength());
+}
+
+TEST(MessageTest, RejectsTruncatedArrays) {
+  const int ints[4] = {1, 2, 3, 4};
+  Message message;
+  ASSERT_TRUE(message.EncodeArray(ints, 4));
+
+  auto view = Message::View(message.GetBuffer(), message.GetDataLength() - 1);
+  const int* decoded = nullptr;
+  size_t count = 0;
+  ASSERT_FALSE(view.DecodeArray(decoded, count));
+  ASSERT_EQ(decoded, nullptr);
+  ASSERT_EQ(view.GetSizeRead(), 0u);
+}
+
 }  // namespace fml
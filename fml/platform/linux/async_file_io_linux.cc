@@ -0,0 +1,453 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/platform/linux/async_file_io_linux.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/thread.h"
+
+namespace fml {
+
+namespace {
+
+constexpr unsigned kRingEntries = 128;
+
+// Reads and writes of more than this are split up.
+constexpr size_t kMaxTransferSize = 1 << 30;
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete) {
+  return ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                   min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+}
+
+int IoUringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+  return ::syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+unsigned LoadAcquire(const unsigned* value) {
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* value, unsigned new_value) {
+  __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+}
+
+}  // namespace
+
+struct AsyncFileIOLinux::Operation {
+  enum class Step {
+    kOpen,
+    kRead,
+    kWrite,
+    kSync,
+    // Wakes up the completion thread to have it exit.
+    kStop,
+  };
+
+  Step step = Step::kOpen;
+  bool is_write = false;
+  std::shared_ptr<fml::UniqueFD> directory;
+  std::string path;
+  // Writes go to this file first and then replace |path|.
+  std::string temp_path;
+  fml::UniqueFD file;
+  // What was read so far, or what is to be written.
+  std::vector<uint8_t> buffer;
+  std::unique_ptr<const fml::Mapping> contents;
+  size_t done = 0;
+  fml::RefPtr<fml::TaskRunner> task_runner;
+  ReadCallback read_callback;
+  WriteCallback write_callback;
+
+
+  void Prepare(io_uring_sqe* entry) {
+    ::memset(entry, 0, sizeof(*entry));
+    entry->user_data = reinterpret_cast<uint64_t>(this);
+    switch (step) {
+      case Step::kOpen:
+        entry->opcode = IORING_OP_OPENAT;
+        entry->fd = directory->get();
+        if (is_write) {
+          entry->addr = reinterpret_cast<uint64_t>(temp_path.c_str());
+          entry->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+          entry->len = S_IRUSR | S_IWUSR;
+        } else {
+          entry->addr = reinterpret_cast<uint64_t>(path.c_str());
+          entry->open_flags = O_RDONLY | O_CLOEXEC;
+        }
+        break;
+      case Step::kRead:
+        entry->opcode = IORING_OP_READ;
+        entry->fd = file.get();
+        entry->addr = reinterpret_cast<uint64_t>(buffer.data() + done);
+        entry->len = std::min(buffer.size() - done, kMaxTransferSize);
+        entry->off = done;
+        break;
+      case Step::kWrite:
+        entry->opcode = IORING_OP_WRITE;
+        entry->fd = file.get();
+        entry->addr = reinterpret_cast<uint64_t>(contents->GetMapping() + done);
+        entry->len = std::min(contents->GetSize() - done, kMaxTransferSize);
+        entry->off = done;
+        break;
+      case Step::kSync:
+        entry->opcode = IORING_OP_FSYNC;
+        entry->fd = file.get();
+        break;
+      case Step::kStop:
+        entry->opcode = IORING_OP_NOP;
+        break;
+    }
+  }
+};
+
+std::unique_ptr<AsyncFileIOLinux> AsyncFileIOLinux::Create() {
+  std::unique_ptr<AsyncFileIOLinux> io(new AsyncFileIOLinux());
+  if (!io->Setup()) {
+    return nullptr;
+  }
+  io->completion_thread_ = std::thread([io = io.get()]() {
+    fml::Thread::SetCurrentThreadName("io.flutter.file_io");
+    io->CompletionMain();
+  });
+  return io;
+}
+
+AsyncFileIOLinux::AsyncFileIOLinux() = default;
+
+AsyncFileIOLinux::~AsyncFileIOLinux() {
+  if (completion_thread_.joinable()) {
+    // Queued behind everything else. The thread exits once all operations are
+    // done.
+    auto stop = std::make_unique<Operation>();
+    stop->step = Operation::Step::kStop;
+    std::vector<std::unique_ptr<Operation>> operations;
+    operations.push_back(std::move(stop));
+    Enqueue(std::move(operations));
+    completion_thread_.join();
+  }
+  if (entries_) {
+    ::munmap(entries_, entries_size_);
+  }
+  if (completion_ring_ && completion_ring_ != submission_ring_) {
+    ::munmap(completion_ring_, completion_ring_size_);
+  }
+  if (submission_ring_) {
+    ::munmap(submission_ring_, submission_ring_size_);
+  }
+}
+
+bool AsyncFileIOLinux::Setup() {
+  io_uring_params params = {};
+  ring_fd_.reset(IoUringSetup(kRingEntries, &params));
+  if (!ring_fd_.is_valid()) {
+    return false;
+  }
+
+  // Opening files goes through the ring too, which needs Linux 5.6. Probing
+  // for operations is just as new.
+  std::vector<uint8_t> probe_storage(sizeof(io_uring_probe) +
+                                     256 * sizeof(io_uring_probe_op));
+  auto* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+  if (IoUringRegister(ring_fd_.get(), IORING_REGISTER_PROBE, probe, 256) < 0) {
+    return false;
+  }
+  for (auto opcode : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE,
+                      IORING_OP_FSYNC, IORING_OP_NOP}) {
+    if (opcode > probe->last_op ||
+        !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) {
+      return false;
+    }
+  }
+
+  submission_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  completion_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    submission_ring_size_ =
+        std::max(submission_ring_size_, completion_ring_size_);
+    completion_ring_size_ = submission_ring_size_;
+  }
+
+  submission_ring_ =
+      ::mmap(nullptr, submission_ring_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd_.get(), IORING_OFF_SQ_RING);
+  if (submission_ring_ == MAP_FAILED) {
+    submission_ring_ = nullptr;
+    return false;
+  }
+  if (single_mmap) {
+    completion_ring_ = submission_ring_;
+  } else {
+    completion_ring_ =
+        ::mmap(nullptr, completion_ring_size_, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd_.get(), IORING_OFF_CQ_RING);
+    if (completion_ring_ == MAP_FAILED) {
+      completion_ring_ = nullptr;
+      return false;
+    }
+  }
+  entries_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* entries =
+      ::mmap(nullptr, entries_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd_.get(), IORING_OFF_SQES);
+  if (entries == MAP_FAILED) {
+    return false;
+  }
+  entries_ = static_cast<io_uring_sqe*>(entries);
+
+  auto* submission = static_cast<uint8_t*>(submission_ring_);
+  submission_head_ =
+      reinterpret_cast<unsigned*>(submission + params.sq_off.head);
+  submission_tail_ =
+      reinterpret_cast<unsigned*>(submission + params.sq_off.tail);
+  submission_mask_ =
+      *reinterpret_cast<unsigned*>(submission + params.sq_off.ring_mask);
+  submission_array_ =
+      reinterpret_cast<unsigned*>(submission + params.sq_off.array);
+  auto* completion = static_cast<uint8_t*>(completion_ring_);
+  completion_head_ =
+      reinterpret_cast<unsigned*>(completion + params.cq_off.head);
+  completion_tail_ =
+      reinterpret_cast<unsigned*>(completion + params.cq_off.tail);
+  completion_mask_ =
+      *reinterpret_cast<unsigned*>(completion + params.cq_off.ring_mask);
+  completions_ =
+      reinterpret_cast<io_uring_cqe*>(completion + params.cq_off.cqes);
+  entry_count_ = params.sq_entries;
+  return true;
+}
+
+void AsyncFileIOLinux::ReadBatch(const fml::UniqueFD& directory,
+                                 std::vector<ReadRequest> requests,
+                                 fml::RefPtr<fml::TaskRunner> task_runner) {
+  auto shared_directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(directory.get()));
+  std::vector<std::unique_ptr<Operation>> operations;
+  operations.reserve(requests.size());
+  for (auto& request : requests) {
+    auto operation = std::make_unique<Operation>();
+    operation->directory = shared_directory;
+    operation->path = std::move(request.path);
+    operation->task_runner = task_runner;
+    operation->read_callback = std::move(request.callback);
+    operations.push_back(std::move(operation));
+  }
+  Enqueue(std::move(operations));
+}
+
+void AsyncFileIOLinux::Write(const fml::UniqueFD& directory,
+                             std::string path,
+                             std::unique_ptr<const fml::Mapping> contents,
+                             fml::RefPtr<fml::TaskRunner> task_runner,
+                             WriteCallback callback) {
+  auto operation = std::make_unique<Operation>();
+  if (!contents || !contents->GetMapping()) {
+    Deliver(task_runner, [callback]() { callback(false); });
+    return;
+  }
+  operation->directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(directory.get()));
+  // The same temporary file as |fml::WriteAtomically|.
+  operation->is_write = true;
+  operation->temp_path = path + ".temp";
+  operation->path = std::move(path);
+  operation->contents = std::move(contents);
+  operation->task_runner = std::move(task_runner);
+  operation->write_callback = std::move(callback);
+  std::vector<std::unique_ptr<Operation>> operations;
+  operations.push_back(std::move(operation));
+  Enqueue(std::move(operations));
+}
+
+void AsyncFileIOLinux::Enqueue(
+    std::vector<std::unique_ptr<Operation>> operations) {
+  std::scoped_lock lock(mutex_);
+  for (auto& operation : operations) {
+    waiting_.push_back(std::move(operation));
+  }
+  SubmitLocked();
+}
+
+void AsyncFileIOLinux::SubmitLocked() {
+  unsigned tail = *submission_tail_;
+  const unsigned head = LoadAcquire(submission_head_);
+  while (!waiting_.empty() && in_flight_ < entry_count_ &&
+         tail - head < entry_count_) {
+    const unsigned index = tail & submission_mask_;
+    waiting_.front().release()->Prepare(&entries_[index]);
+    waiting_.pop_front();
+    submission_array_[index] = index;
+    tail++;
+    in_flight_++;
+  }
+  StoreRelease(submission_tail_, tail);
+
+  // Entries the kernel didn't take last time are submitted again.
+  const unsigned to_submit = tail - LoadAcquire(submission_head_);
+  if (to_submit > 0 &&
+      FML_HANDLE_EINTR(IoUringEnter(ring_fd_.get(), to_submit, 0)) < 0) {
+    FML_DLOG(ERROR) << "Could not submit file I/O: " << strerror(errno);
+  }
+}
+
+void AsyncFileIOLinux::CompletionMain() {
+  bool stopping = false;
+  std::vector<std::pair<std::unique_ptr<Operation>, int>> completed;
+  while (true) {
+    if (FML_HANDLE_EINTR(IoUringEnter(ring_fd_.get(), 0, 1)) < 0) {
+      FML_DLOG(ERROR) << "Could not wait for file I/O: " << strerror(errno);
+    }
+
+    unsigned head = *completion_head_;
+    const unsigned tail = LoadAcquire(completion_tail_);
+    for (; head != tail; head++) {
+      const io_uring_cqe& completion = completions_[head & completion_mask_];
+      completed.emplace_back(
+          reinterpret_cast<Operation*>(completion.user_data), completion.res);
+    }
+    StoreRelease(completion_head_, head);
+
+    {
+      std::scoped_lock lock(mutex_);
+      in_flight_ -= completed.size();
+      // Completions make room for operations that are waiting.
+      SubmitLocked();
+    }
+
+    for (auto& [operation, result] : completed) {
+      if (operation->step == Operation::Step::kStop) {
+        stopping = true;
+        continue;
+      }
+      Advance(std::move(operation), result);
+    }
+    completed.clear();
+
+    if (stopping) {
+      std::scoped_lock lock(mutex_);
+      if (in_flight_ == 0 && waiting_.empty()) {
+        return;
+      }
+    }
+  }
+}
+
+void AsyncFileIOLinux::Advance(std::unique_ptr<Operation> operation,
+                               int result) {
+  using Step = Operation::Step;
+  if (result == -EINTR || result == -EAGAIN) {
+    // Try the same step again.
+    std::vector<std::unique_ptr<Operation>> operations;
+    operations.push_back(std::move(operation));
+    Enqueue(std::move(operations));
+    return;
+  }
+  if (result < 0) {
+    Finish(std::move(operation), false);
+    return;
+  }
+
+  switch (operation->step) {
+    case Step::kOpen: {
+      operation->file.reset(result);
+      if (operation->is_write) {
+        operation->step =
+            operation->contents->GetSize() > 0 ? Step::kWrite : Step::kSync;
+        break;
+      }
+      // Doesn't wait on the disk, the inode was just looked up.
+      struct stat stat_buffer = {};
+      if (::fstat(operation->file.get(), &stat_buffer) != 0) {
+        Finish(std::move(operation), false);
+        return;
+      }
+      if (stat_buffer.st_size == 0) {
+        Finish(std::move(operation), true);
+        return;
+      }
+      operation->buffer.resize(stat_buffer.st_size);
+      operation->step = Step::kRead;
+      break;
+    }
+    case Step::kRead:
+      if (result == 0) {
+        // The file got shorter since it was opened.
+        operation->buffer.resize(operation->done);
+        Finish(std::move(operation), true);
+        return;
+      }
+      operation->done += result;
+      if (operation->done == operation->buffer.size()) {
+        Finish(std::move(operation), true);
+        return;
+      }
+      break;
+    case Step::kWrite:
+      operation->done += result;
+      if (operation->done == operation->contents->GetSize()) {
+        operation->step = Step::kSync;
+      }
+      break;
+    case Step::kSync: {
+      operation->file.reset();
+      const int directory = operation->directory->get();
+      const bool renamed =
+          ::renameat(directory, operation->temp_path.c_str(), directory,
+                     operation->path.c_str()) == 0;
+      Finish(std::move(operation), renamed);
+      return;
+    }
+    case Step::kStop:
+      FML_DCHECK(false);
+      return;
+  }
+
+  std::vector<std::unique_ptr<Operation>> operations;
+  operations.push_back(std::move(operation));
+  Enqueue(std::move(operations));
+}
+
+void AsyncFileIOLinux::Finish(std::unique_ptr<Operation> operation,
+                              bool success) {
+  operation->file.reset();
+  auto task_runner = std::move(operation->task_runner);
+  if (operation->is_write) {
+    Deliver(task_runner, [callback = std::move(operation->write_callback),
+                          success]() { callback(success); });
+    return;
+  }
+  std::unique_ptr<fml::Mapping> contents;
+  if (success) {
+    contents =
+        std::make_unique<fml::DataMapping>(std::move(operation->buffer));
+  }
+  Deliver(task_runner,
+          [callback = std::move(operation->read_callback),
+           contents = std::move(contents)]() mutable {
+            callback(std::move(contents));
+          });
+}
+
+}  // namespace fml
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_PLATFORM_LINUX_ASYNC_FILE_IO_LINUX_H_
+#define FLUTTER_FML_PLATFORM_LINUX_ASYNC_FILE_IO_LINUX_H_
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "flutter/fml/async_file_io.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/unique_fd.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace fml {
+
+// Does the file I/O through an io_uring. Opening, reading, writing and syncing
+// files are submitted to the kernel in batches, and a single thread waits for
+// their completions. Closing and renaming files, which don't wait on the disk,
+// are done by that thread directly.
+class AsyncFileIOLinux final : public AsyncFileIO {
+ public:
+  // Returns null if the kernel can't do the operations through an io_uring,
+  // which takes Linux 5.6, or if io_urings are not allowed.
+  static std::unique_ptr<AsyncFileIOLinux> Create();
+
+  ~AsyncFileIOLinux() override;
+
+  // |AsyncFileIO|
+  void ReadBatch(const fml::UniqueFD& directory,
+                 std::vector<ReadRequest> requests,
+                 fml::RefPtr<fml::TaskRunner> task_runner) override;
+
+  // |AsyncFileIO|
+  void Write(const fml::UniqueFD& directory,
+             std::string path,
+             std::unique_ptr<const fml::Mapping> contents,
+             fml::RefPtr<fml::TaskRunner> task_runner,
+             WriteCallback callback) override;
+
+ private:
+  struct Operation;
+
+  fml::UniqueFD ring_fd_;
+  // The memory shared with the kernel.
+  void* submission_ring_ = nullptr;
+  size_t submission_ring_size_ = 0;
+  void* completion_ring_ = nullptr;
+  size_t completion_ring_size_ = 0;
+  io_uring_sqe* entries_ = nullptr;
+  size_t entries_size_ = 0;
+
+  unsigned* submission_head_ = nullptr;
+  unsigned* submission_tail_ = nullptr;
+  unsigned submission_mask_ = 0;
+  unsigned* submission_array_ = nullptr;
+  unsigned* completion_head_ = nullptr;
+  unsigned* completion_tail_ = nullptr;
+  unsigned completion_mask_ = 0;
+  io_uring_cqe* completions_ = nullptr;
+  size_t entry_count_ = 0;
+
+  // Guards the submission ring and the members below.
+  std::mutex mutex_;
+  // Operations waiting for room in the ring.
+  std::deque<std::unique_ptr<Operation>> waiting_;
+  // Operations submitted to the kernel that haven't completed yet. Kept at
+  // most at the size of the submission ring, so the completion ring, which is
+  // twice that size, never overflows.
+  size_t in_flight_ = 0;
+
+  std::thread completion_thread_;
+
+  AsyncFileIOLinux();
+
+  bool Setup();
+
+  void Enqueue(std::vector<std::unique_ptr<Operation>> operations);
+
+  void SubmitLocked();
+
+  void CompletionMain();
+
+  // Continues |operation| once its current step completed with |result|.
+  void Advance(std::unique_ptr<Operation> operation, int result);
+
+  void Finish(std::unique_ptr<Operation> operation, bool success);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AsyncFileIOLinux);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_PLATFORM_LINUX_ASYNC_FILE_IO_LINUX_H_
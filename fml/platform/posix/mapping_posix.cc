@@ -9,6 +9,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <type_traits>
 
 #include "flutter/fml/build_config.h"
@@ -81,6 +82,8 @@ FileMapping::FileMapping(const fml::UniqueFD& handle,
   mapping_ = static_cast<uint8_t*>(mapping);
   size_ = stat_buffer.st_size;
   valid_ = true;
+  memory_charge_ =
+      MemoryCharge(MemoryCounter::Get("FileMappings"), size_);
   if (is_writable) {
     mutable_mapping_ = mapping_;
   }
@@ -104,4 +107,47 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+bool FileMapping::SetAccessHint(AccessHint hint) const {
+  if (mapping_ == nullptr) {
+    return false;
+  }
+
+  int advice = MADV_NORMAL;
+  switch (hint) {
+    case AccessHint::kNormal:
+      advice = MADV_NORMAL;
+      break;
+    case AccessHint::kSequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case AccessHint::kRandom:
+      advice = MADV_RANDOM;
+      break;
+    case AccessHint::kHugePages:
+#if defined(MADV_HUGEPAGE)
+      advice = MADV_HUGEPAGE;
+      break;
+#else
+      return false;
+#endif
+  }
+  return ::madvise(mapping_, size_, advice) == 0;
+}
+
+bool FileMapping::Prefetch(size_t offset, size_t length) const {
+  if (mapping_ == nullptr || offset >= size_) {
+    return false;
+  }
+  length = std::min(length, size_ - offset);
+
+  // The range has to start on a page boundary. The mapping itself does.
+  static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  const size_t page_offset = offset % page_size;
+  offset -= page_offset;
+  length += page_offset;
+
+  // For file mappings, this only schedules the reads.
+  return ::madvise(mapping_ + offset, length, MADV_WILLNEED) == 0;
+}
+
 }  // namespace fml
@@ -0,0 +1,229 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/platform/win/async_file_io_win.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/platform/win/errors_win.h"
+#include "flutter/fml/thread.h"
+
+namespace fml {
+
+namespace {
+
+// The completion keys of the packets on the port.
+constexpr ULONG_PTR kStartKey = 1;
+constexpr ULONG_PTR kReadKey = 2;
+constexpr ULONG_PTR kStopKey = 3;
+
+// Reads of more than this are split up.
+constexpr size_t kMaxReadSize = 1 << 30;
+
+}  // namespace
+
+struct AsyncFileIOWin::Operation {
+  // Must be first, completed reads hand this back.
+  OVERLAPPED overlapped = {};
+  bool is_write = false;
+  std::shared_ptr<fml::UniqueFD> directory;
+  std::string path;
+  fml::UniqueFD file;
+  std::vector<uint8_t> buffer;
+  size_t done = 0;
+  std::unique_ptr<const fml::Mapping> contents;
+  fml::RefPtr<fml::TaskRunner> task_runner;
+  ReadCallback read_callback;
+  WriteCallback write_callback;
+};
+
+std::unique_ptr<AsyncFileIOWin> AsyncFileIOWin::Create() {
+  std::unique_ptr<AsyncFileIOWin> io(new AsyncFileIOWin());
+  io->port_ =
+      ::CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+  if (io->port_ == nullptr) {
+    FML_DLOG(ERROR) << "Could not create an I/O completion port. "
+                    << GetLastErrorMessage();
+    return nullptr;
+  }
+  io->completion_thread_ = std::thread([io = io.get()]() {
+    fml::Thread::SetCurrentThreadName("io.flutter.file_io");
+    io->CompletionMain();
+  });
+  return io;
+}
+
+AsyncFileIOWin::AsyncFileIOWin() = default;
+
+AsyncFileIOWin::~AsyncFileIOWin() {
+  if (completion_thread_.joinable()) {
+    ::PostQueuedCompletionStatus(port_, 0, kStopKey, nullptr);
+    completion_thread_.join();
+  }
+  if (port_ != nullptr) {
+    ::CloseHandle(port_);
+  }
+}
+
+void AsyncFileIOWin::ReadBatch(const fml::UniqueFD& directory,
+                               std::vector<ReadRequest> requests,
+                               fml::RefPtr<fml::TaskRunner> task_runner) {
+  auto shared_directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(directory.get()));
+  for (auto& request : requests) {
+    auto operation = std::make_unique<Operation>();
+    operation->directory = shared_directory;
+    operation->path = std::move(request.path);
+    operation->task_runner = task_runner;
+    operation->read_callback = std::move(request.callback);
+    Start(std::move(operation));
+  }
+}
+
+void AsyncFileIOWin::Write(const fml::UniqueFD& directory,
+                           std::string path,
+                           std::unique_ptr<const fml::Mapping> contents,
+                           fml::RefPtr<fml::TaskRunner> task_runner,
+                           WriteCallback callback) {
+  auto operation = std::make_unique<Operation>();
+  operation->is_write = true;
+  operation->directory =
+      std::make_shared<fml::UniqueFD>(fml::Duplicate(directory.get()));
+  operation->path = std::move(path);
+  operation->contents = std::move(contents);
+  operation->task_runner = std::move(task_runner);
+  operation->write_callback = std::move(callback);
+  Start(std::move(operation));
+}
+
+void AsyncFileIOWin::Start(std::unique_ptr<Operation> operation) {
+  pending_++;
+  // The completion thread picks up the operation in the order it was posted.
+  ::PostQueuedCompletionStatus(port_, 0, kStartKey,
+                               &operation.release()->overlapped);
+}
+
+void AsyncFileIOWin::CompletionMain() {
+  bool stopping = false;
+  while (!stopping || pending_ > 0) {
+    DWORD transferred = 0;
+    ULONG_PTR key = 0;
+    OVERLAPPED* overlapped = nullptr;
+    const BOOL succeeded = ::GetQueuedCompletionStatus(
+        port_, &transferred, &key, &overlapped, INFINITE);
+    if (overlapped == nullptr) {
+      if (key == kStopKey) {
+        stopping = true;
+      }
+      continue;
+    }
+    std::unique_ptr<Operation> operation(
+        CONTAINING_RECORD(overlapped, Operation, overlapped));
+
+    if (key == kStartKey) {
+      if (operation->is_write) {
+        const bool success =
+            operation->contents &&
+            fml::WriteAtomically(*operation->directory,
+                                 operation->path.c_str(),
+                                 *operation->contents);
+        Finish(std::move(operation), success);
+        continue;
+      }
+      auto file =
+          fml::OpenFileReadOnly(*operation->directory, operation->path.c_str());
+      if (file.is_valid()) {
+        operation->file.reset(::ReOpenFile(file.get(), GENERIC_READ,
+                                           FILE_SHARE_READ,
+                                           FILE_FLAG_OVERLAPPED));
+      }
+      LARGE_INTEGER size = {};
+      if (!operation->file.is_valid() ||
+          ::CreateIoCompletionPort(operation->file.get(), port_, kReadKey,
+                                   0) == nullptr ||
+          !::GetFileSizeEx(operation->file.get(), &size)) {
+        Finish(std::move(operation), false);
+        continue;
+      }
+      if (size.QuadPart == 0) {
+        Finish(std::move(operation), true);
+        continue;
+      }
+      operation->buffer.resize(size.QuadPart);
+      ReadNext(std::move(operation));
+      continue;
+    }
+
+    FML_DCHECK(key == kReadKey);
+    if (!succeeded) {
+      if (::GetLastError() == ERROR_HANDLE_EOF) {
+        // The file got shorter since it was opened.
+        operation->buffer.resize(operation->done);
+        Finish(std::move(operation), true);
+      } else {
+        Finish(std::move(operation), false);
+      }
+      continue;
+    }
+    operation->done += transferred;
+    if (transferred == 0 || operation->done == operation->buffer.size()) {
+      operation->buffer.resize(operation->done);
+      Finish(std::move(operation), true);
+      continue;
+    }
+    ReadNext(std::move(operation));
+  }
+}
+
+void AsyncFileIOWin::ReadNext(std::unique_ptr<Operation> operation) {
+  const uint64_t offset = operation->done;
+  operation->overlapped = {};
+  operation->overlapped.Offset = static_cast<DWORD>(offset);
+  operation->overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  const DWORD length = static_cast<DWORD>(
+      std::min(operation->buffer.size() - operation->done, kMaxReadSize));
+  Operation* raw_operation = operation.release();
+  if (!::ReadFile(raw_operation->file.get(),
+                  raw_operation->buffer.data() + raw_operation->done, length,
+                  nullptr, &raw_operation->overlapped)) {
+    const DWORD error = ::GetLastError();
+    if (error == ERROR_HANDLE_EOF) {
+      // The file got shorter since it was opened.
+      raw_operation->buffer.resize(raw_operation->done);
+      Finish(std::unique_ptr<Operation>(raw_operation), true);
+    } else if (error != ERROR_IO_PENDING) {
+      // Nothing was queued for the read.
+      Finish(std::unique_ptr<Operation>(raw_operation), false);
+    }
+  }
+  // Otherwise the completion is queued on the port, even if the read
+  // completed right away.
+}
+
+void AsyncFileIOWin::Finish(std::unique_ptr<Operation> operation,
+                            bool success) {
+  operation->file.reset();
+  auto task_runner = std::move(operation->task_runner);
+  if (operation->is_write) {
+    Deliver(task_runner, [callback = std::move(operation->write_callback),
+                          success]() { callback(success); });
+  } else {
+    std::unique_ptr<fml::Mapping> contents;
+    if (success) {
+      contents =
+          std::make_unique<fml::DataMapping>(std::move(operation->buffer));
+    }
+    Deliver(task_runner,
+            [callback = std::move(operation->read_callback),
+             contents = std::move(contents)]() mutable {
+              callback(std::move(contents));
+            });
+  }
+  pending_--;
+}
+
+}  // namespace fml
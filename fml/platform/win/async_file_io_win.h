@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_PLATFORM_WIN_ASYNC_FILE_IO_WIN_H_
+#define FLUTTER_FML_PLATFORM_WIN_ASYNC_FILE_IO_WIN_H_
+
+#include <windows.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "flutter/fml/async_file_io.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+// Reads files with overlapped I/O on a completion port, which a single thread
+// waits on. Opening a file has no overlapped variant, so that thread opens the
+// files itself, as well as doing the writes, which go through a file mapping
+// like |fml::WriteAtomically|.
+class AsyncFileIOWin final : public AsyncFileIO {
+ public:
+  // Returns null if the completion port could not be created.
+  static std::unique_ptr<AsyncFileIOWin> Create();
+
+  ~AsyncFileIOWin() override;
+
+  // |AsyncFileIO|
+  void ReadBatch(const fml::UniqueFD& directory,
+                 std::vector<ReadRequest> requests,
+                 fml::RefPtr<fml::TaskRunner> task_runner) override;
+
+  // |AsyncFileIO|
+  void Write(const fml::UniqueFD& directory,
+             std::string path,
+             std::unique_ptr<const fml::Mapping> contents,
+             fml::RefPtr<fml::TaskRunner> task_runner,
+             WriteCallback callback) override;
+
+ private:
+  struct Operation;
+
+  HANDLE port_ = nullptr;
+  // Operations that were started but haven't finished yet.
+  std::atomic<size_t> pending_ = {0};
+  std::thread completion_thread_;
+
+  AsyncFileIOWin();
+
+  void Start(std::unique_ptr<Operation> operation);
+
+  void CompletionMain();
+
+  // Starts the next read of |operation|, or finishes it if that fails.
+  void ReadNext(std::unique_ptr<Operation> operation);
+
+  void Finish(std::unique_ptr<Operation> operation, bool success);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AsyncFileIOWin);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_PLATFORM_WIN_ASYNC_FILE_IO_WIN_H_
@@ -96,6 +96,8 @@ FileMapping::FileMapping(const fml::UniqueFD& fd,
   mapping_ = mapping;
   size_ = mapping_size;
   valid_ = true;
+  memory_charge_ =
+      MemoryCharge(MemoryCounter::Get("FileMappings"), size_);
   if (IsWritable(protections)) {
     mutable_mapping_ = mapping_;
   }
@@ -119,4 +121,14 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+bool FileMapping::SetAccessHint(AccessHint hint) const {
+  // Views of file mappings take no access hints.
+  return false;
+}
+
+bool FileMapping::Prefetch(size_t offset, size_t length) const {
+  // PrefetchVirtualMemory needs Windows 8.
+  return false;
+}
+
 }  // namespace fml
@@ -5,7 +5,12 @@
 #define FML_USED_ON_EMBEDDER
 
 #include "flutter/fml/raster_thread_merger.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "flutter/fml/message_loop_impl.h"
+#include "flutter/fml/trace_event.h"
 
 namespace fml {
 
@@ -16,15 +21,29 @@ RasterThreadMerger::RasterThreadMerger(fml::TaskQueueId platform_queue_id,
     : platform_queue_id_(platform_queue_id),
       gpu_queue_id_(gpu_queue_id),
       task_queues_(fml::MessageLoopTaskQueues::GetInstance()),
-      lease_term_(kLeaseNotSet) {
+      lease_term_(kLeaseNotSet),
+      frames_since_unmerge_(std::numeric_limits<size_t>::max()) {
   is_merged_ = task_queues_->Owns(platform_queue_id_, gpu_queue_id_);
 }
 
 void RasterThreadMerger::MergeWithLease(size_t lease_term) {
   FML_DCHECK(lease_term > 0) << "lease_term should be positive.";
   if (!is_merged_) {
+    if (max_lease_term_ > 0) {
+      // Merging again this soon means that the platform views are flickering,
+      // so hold on to the merge for longer.
+      if (frames_since_unmerge_ <= last_lease_term_) {
+        lease_term_scale_ = std::min(lease_term_scale_ * 2, max_lease_term_);
+      } else {
+        lease_term_scale_ = 1;
+      }
+    }
+    TRACE_EVENT0("fml", "RasterThreadMerger::Merge");
     is_merged_ = task_queues_->Merge(platform_queue_id_, gpu_queue_id_);
-    lease_term_ = lease_term;
+    last_lease_term_ = ScaleLeaseTerm(lease_term);
+    lease_term_ = last_lease_term_;
+    merge_count_++;
+    TraceMergeCounts();
   }
 }
 
@@ -42,17 +61,44 @@ bool RasterThreadMerger::IsOnRasterizingThread() const {
 
 void RasterThreadMerger::ExtendLeaseTo(size_t lease_term) {
   FML_DCHECK(lease_term > 0) << "lease_term should be positive.";
+  lease_term = ScaleLeaseTerm(lease_term);
   if (lease_term_ != kLeaseNotSet && (int)lease_term > lease_term_) {
     lease_term_ = lease_term;
   }
 }
 
+void RasterThreadMerger::SetMaxLeaseTerm(size_t max_lease_term) {
+  max_lease_term_ = max_lease_term;
+  if (max_lease_term_ == 0) {
+    lease_term_scale_ = 1;
+  }
+}
+
+size_t RasterThreadMerger::ScaleLeaseTerm(size_t lease_term) const {
+  if (max_lease_term_ == 0) {
+    return lease_term;
+  }
+  return std::max(lease_term,
+                  std::min(lease_term * lease_term_scale_, max_lease_term_));
+}
+
+void RasterThreadMerger::TraceMergeCounts() const {
+  FML_TRACE_COUNTER("fml", "RasterThreadMerger",
+                    reinterpret_cast<int64_t>(this),  //
+                    "merges", merge_count_,           //
+                    "unmerges", unmerge_count_        //
+  );
+}
+
 bool RasterThreadMerger::IsMerged() const {
   return is_merged_;
 }
 
 RasterThreadStatus RasterThreadMerger::DecrementLease() {
   if (!is_merged_) {
+    if (frames_since_unmerge_ < std::numeric_limits<size_t>::max()) {
+      frames_since_unmerge_++;
+    }
     return RasterThreadStatus::kRemainsUnmerged;
   }
 
@@ -68,6 +114,9 @@ RasterThreadStatus RasterThreadMerger::DecrementLease() {
     bool success = task_queues_->Unmerge(platform_queue_id_);
     FML_CHECK(success) << "Unable to un-merge the raster and platform threads.";
     is_merged_ = false;
+    frames_since_unmerge_ = 0;
+    unmerge_count_++;
+    TraceMergeCounts();
     return RasterThreadStatus::kUnmergedNow;
   }
 
@@ -5,6 +5,8 @@
 #ifndef FML_SHELL_COMMON_TASK_RUNNER_MERGER_H_
 #define FML_SHELL_COMMON_TASK_RUNNER_MERGER_H_
 
+#include <atomic>
+
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/message_loop_task_queues.h"
@@ -32,6 +34,15 @@ class RasterThreadMerger
 
   void ExtendLeaseTo(size_t lease_term);
 
+  // Adds hysteresis to the lease terms, so that platform views that keep
+  // appearing and disappearing don't merge and unmerge the threads over and
+  // over. When the threads are merged again within the last lease term of
+  // having been unmerged, the lease terms asked for are doubled, up to
+  // |max_lease_term| frames. Lease terms go back to the ones asked for when
+  // the threads stayed unmerged for longer than that. Zero, the default, uses
+  // the lease terms as asked for.
+  void SetMaxLeaseTerm(size_t max_lease_term);
+
   // Returns |RasterThreadStatus::kUnmergedNow| if this call resulted in
   // splitting the raster and platform threads. Reduces the lease term by 1.
   RasterThreadStatus DecrementLease();
@@ -56,6 +67,21 @@ class RasterThreadMerger
   fml::RefPtr<fml::MessageLoopTaskQueues> task_queues_;
   std::atomic_int lease_term_;
   bool is_merged_;
+  size_t max_lease_term_ = 0;
+  // How many times the lease terms asked for are multiplied by because of
+  // merge churn.
+  size_t lease_term_scale_ = 1;
+  // The lease term of the last merge.
+  size_t last_lease_term_ = 0;
+  // The number of frames since the threads were unmerged last.
+  size_t frames_since_unmerge_;
+  // The number of merges and unmerges, for tracing.
+  int64_t merge_count_ = 0;
+  int64_t unmerge_count_ = 0;
+
+  size_t ScaleLeaseTerm(size_t lease_term) const;
+
+  void TraceMergeCounts() const;
 
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(RasterThreadMerger);
   FML_FRIEND_MAKE_REF_COUNTED(RasterThreadMerger);
@@ -61,6 +61,72 @@ TEST(RasterThreadMerger, RemainMergedTillLeaseExpires) {
   thread2.join();
 }
 
+TEST(RasterThreadMerger, LeaseGrowsWhileMergesChurn) {
+  fml::MessageLoop* loop1 = nullptr;
+  fml::AutoResetWaitableEvent latch1;
+  fml::AutoResetWaitableEvent term1;
+  std::thread thread1([&loop1, &latch1, &term1]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    loop1 = &fml::MessageLoop::GetCurrent();
+    latch1.Signal();
+    term1.Wait();
+  });
+
+  fml::MessageLoop* loop2 = nullptr;
+  fml::AutoResetWaitableEvent latch2;
+  fml::AutoResetWaitableEvent term2;
+  std::thread thread2([&loop2, &latch2, &term2]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    loop2 = &fml::MessageLoop::GetCurrent();
+    latch2.Signal();
+    term2.Wait();
+  });
+
+  latch1.Wait();
+  latch2.Wait();
+
+  fml::TaskQueueId qid1 = loop1->GetTaskRunner()->GetTaskQueueId();
+  fml::TaskQueueId qid2 = loop2->GetTaskRunner()->GetTaskQueueId();
+  const auto raster_thread_merger_ =
+      fml::MakeRefCounted<fml::RasterThreadMerger>(qid1, qid2);
+  raster_thread_merger_->SetMaxLeaseTerm(8);
+
+  // Returns the number of frames the threads stayed merged for.
+  auto merged_frames = [&raster_thread_merger_]() {
+    int frames = 0;
+    while (raster_thread_merger_->IsMerged()) {
+      raster_thread_merger_->DecrementLease();
+      frames++;
+    }
+    return frames;
+  };
+
+  raster_thread_merger_->MergeWithLease(2);
+  ASSERT_EQ(merged_frames(), 2);
+
+  // Merging again within the last lease term doubles the lease, up to the
+  // maximum.
+  raster_thread_merger_->DecrementLease();
+  raster_thread_merger_->MergeWithLease(2);
+  ASSERT_EQ(merged_frames(), 4);
+  raster_thread_merger_->MergeWithLease(2);
+  ASSERT_EQ(merged_frames(), 8);
+  raster_thread_merger_->MergeWithLease(2);
+  ASSERT_EQ(merged_frames(), 8);
+
+  // Staying unmerged for longer than that resets the lease.
+  for (int i = 0; i < 9; i++) {
+    raster_thread_merger_->DecrementLease();
+  }
+  raster_thread_merger_->MergeWithLease(2);
+  ASSERT_EQ(merged_frames(), 2);
+
+  term1.Signal();
+  term2.Signal();
+  thread1.join();
+  thread2.join();
+}
+
 TEST(RasterThreadMerger, IsNotOnRasterizingThread) {
   fml::MessageLoop* loop1 = nullptr;
   fml::AutoResetWaitableEvent latch1;
@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/sync_profiler.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+
+namespace {
+
+constexpr int64_t kTraceCounterIntervalMicros = 1000000;
+
+class Registry {
+ public:
+  SyncProfiler::Histogram& Get(const std::string& name) {
+    std::scoped_lock lock(mutex_);
+    auto& histogram = histograms_[name];
+    if (!histogram) {
+      histogram = std::make_unique<SyncProfiler::Histogram>(name);
+    }
+    return *histogram;
+  }
+
+  template <typename Callback>
+  void ForEach(const Callback& callback) {
+    std::scoped_lock lock(mutex_);
+    for (const auto& entry : histograms_) {
+      callback(*entry.second);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  // Histograms are never removed, so references to them stay valid.
+  std::map<std::string, std::unique_ptr<SyncProfiler::Histogram>> histograms_;
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+thread_local std::string tCurrentThreadName;
+
+std::atomic<int64_t> gLastTraceMicros = {0};
+
+}  // namespace
+
+std::atomic_bool SyncProfiler::enabled_ = {false};
+
+SyncProfiler::Histogram::Histogram(std::string name) : name_(std::move(name)) {}
+
+void SyncProfiler::Histogram::Add(fml::TimeDelta duration) {
+  const int64_t micros = std::max<int64_t>(duration.ToMicroseconds(), 0);
+  size_t bucket = 0;
+  for (int64_t bound = 1; bucket + 1 < kBucketCount && micros >= bound;
+       bound <<= 1) {
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  total_micros_.fetch_add(micros, std::memory_order_relaxed);
+  int64_t max = max_micros_.load(std::memory_order_relaxed);
+  while (micros > max && !max_micros_.compare_exchange_weak(
+                             max, micros, std::memory_order_relaxed)) {
+  }
+}
+
+SyncProfiler::Histogram::Summary SyncProfiler::Histogram::Summarize() const {
+  Summary summary;
+  summary.name = name_;
+  summary.total_micros = total_micros_.load(std::memory_order_relaxed);
+  summary.max_micros = max_micros_.load(std::memory_order_relaxed);
+
+  // The count is taken from the buckets so that the percentiles are
+  // consistent with them while samples are being added.
+  std::array<uint64_t, kBucketCount> buckets;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    summary.count += buckets[i];
+  }
+
+  auto percentile = [&](uint64_t percent) -> int64_t {
+    const uint64_t rank = (summary.count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      seen += buckets[i];
+      if (seen >= rank && buckets[i] > 0) {
+        const int64_t bound = i == 0 ? 1 : int64_t{1} << i;
+        return std::min(bound, summary.max_micros);
+      }
+    }
+    return summary.max_micros;
+  };
+  if (summary.count > 0) {
+    summary.p50_micros = percentile(50);
+    summary.p90_micros = percentile(90);
+    summary.p99_micros = percentile(99);
+  }
+  return summary;
+}
+
+void SyncProfiler::Histogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  total_micros_.store(0, std::memory_order_relaxed);
+  max_micros_.store(0, std::memory_order_relaxed);
+}
+
+SyncProfiler::Histogram& SyncProfiler::Site::Get() {
+  Histogram* histogram = histogram_.load(std::memory_order_acquire);
+  if (histogram == nullptr) {
+    histogram = &SyncProfiler::Get(name_);
+    histogram_.store(histogram, std::memory_order_release);
+  }
+  return *histogram;
+}
+
+void SyncProfiler::Enable() {
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void SyncProfiler::Disable() {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+SyncProfiler::Histogram& SyncProfiler::Get(const std::string& name) {
+  return GetRegistry().Get(name);
+}
+
+SyncProfiler::Histogram& SyncProfiler::GetForCurrentThread(
+    const char* metric,
+    const std::string& fallback_thread_name) {
+  const std::string& thread_name = tCurrentThreadName.empty()
+                                       ? fallback_thread_name
+                                       : tCurrentThreadName;
+  return Get(thread_name + "." + metric);
+}
+
+void SyncProfiler::SetCurrentThreadName(const std::string& name) {
+  tCurrentThreadName = name;
+}
+
+std::vector<SyncProfiler::Histogram::Summary> SyncProfiler::Summarize() {
+  std::vector<Histogram::Summary> summaries;
+  GetRegistry().ForEach([&summaries](const Histogram& histogram) {
+    Histogram::Summary summary = histogram.Summarize();
+    if (summary.count > 0) {
+      summaries.push_back(std::move(summary));
+    }
+  });
+  return summaries;
+}
+
+void SyncProfiler::Reset() {
+  GetRegistry().ForEach([](Histogram& histogram) { histogram.Reset(); });
+}
+
+void SyncProfiler::MaybeTraceCounters() {
+  const int64_t now = fml::TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  int64_t last = gLastTraceMicros.load(std::memory_order_relaxed);
+  if (now - last < kTraceCounterIntervalMicros ||
+      !gLastTraceMicros.compare_exchange_strong(last, now,
+                                                std::memory_order_relaxed)) {
+    return;
+  }
+  GetRegistry().ForEach([](const Histogram& histogram) {
+    const Histogram::Summary summary = histogram.Summarize();
+    if (summary.count == 0) {
+      return;
+    }
+    // The names of the histograms live as long as the process, as trace
+    // names have to.
+    FML_TRACE_COUNTER("fml", histogram.GetName().c_str(), 0,  //
+                      "p50", summary.p50_micros,                //
+                      "p99", summary.p99_micros,                //
+                      "max", summary.max_micros                 //
+    );
+  });
+}
+
+}  // namespace fml
@@ -0,0 +1,166 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNC_PROFILER_H_
+#define FLUTTER_FML_SYNC_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Histograms of the time spent waiting for the locks of the
+///             message loops and of the latency and duration of their tasks.
+///
+///             Profiling is off by default, in which case the instrumented
+///             code only checks a relaxed atomic flag. Histograms are named
+///             after the lock or the thread they profile, are never freed,
+///             and are recorded into without locking, so their pointers can
+///             be cached by the instrumented code.
+///
+class SyncProfiler {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      A histogram of durations with a bucket per power of two
+  ///             microseconds.
+  ///
+  class Histogram {
+   public:
+    // Bucket 0 holds durations under a microsecond and bucket i those in
+    // [2^(i-1), 2^i) microseconds. The last bucket holds everything longer.
+    static constexpr size_t kBucketCount = 32;
+
+    struct Summary {
+      std::string name;
+      uint64_t count = 0;
+      int64_t total_micros = 0;
+      int64_t max_micros = 0;
+      // Upper bounds of the buckets the percentiles fall into.
+      int64_t p50_micros = 0;
+      int64_t p90_micros = 0;
+      int64_t p99_micros = 0;
+    };
+
+    explicit Histogram(std::string name);
+
+    const std::string& GetName() const { return name_; }
+
+    void Add(fml::TimeDelta duration);
+
+    Summary Summarize() const;
+
+    void Reset();
+
+   private:
+    const std::string name_;
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_ = {};
+    std::atomic<int64_t> total_micros_ = {0};
+    std::atomic<int64_t> max_micros_ = {0};
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Histogram);
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The histogram of a lock, looked up on first use. Meant to be
+  ///             a static next to the code that takes the lock.
+  ///
+  class Site {
+   public:
+    explicit constexpr Site(const char* name) : name_(name) {}
+
+    Histogram& Get();
+
+   private:
+    const char* const name_;
+    std::atomic<Histogram*> histogram_ = {nullptr};
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Site);
+  };
+
+  static void Enable();
+
+  static void Disable();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the histogram of the name, creating it if needed.
+  ///
+  static Histogram& Get(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the histogram of the metric for the current thread,
+  ///             named "<thread name>.<metric>". Threads not named with
+  ///             |Thread::SetCurrentThreadName| use |fallback_thread_name|.
+  ///
+  static Histogram& GetForCurrentThread(const char* metric,
+                                        const std::string& fallback_thread_name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Names the current thread in the histograms of
+  ///             |GetForCurrentThread|.
+  ///
+  static void SetCurrentThreadName(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Summarizes the histograms that have samples, sorted by name.
+  ///
+  static std::vector<Histogram::Summary> Summarize();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops the samples of all histograms.
+  ///
+  static void Reset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Traces the summaries of the histograms as counters, at most
+  ///             once a second. Called by the message loops after they ran
+  ///             their tasks.
+  ///
+  static void MaybeTraceCounters();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Locks the mutex like |std::unique_lock| does. While
+  ///             profiling, the time spent waiting for the mutex is recorded
+  ///             into the histogram of |site|, with uncontended acquisitions
+  ///             counting as no wait.
+  ///
+  template <typename Mutex>
+  static std::unique_lock<Mutex> Lock(Mutex& mutex, Site& site) {
+    std::unique_lock<Mutex> lock(mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      if (IsEnabled()) {
+        site.Get().Add(fml::TimeDelta::Zero());
+      }
+      return lock;
+    }
+    if (!IsEnabled()) {
+      lock.lock();
+      return lock;
+    }
+    const auto start = fml::TimePoint::Now();
+    lock.lock();
+    site.Get().Add(fml::TimePoint::Now() - start);
+    return lock;
+  }
+
+ private:
+  static std::atomic_bool enabled_;
+
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(SyncProfiler);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNC_PROFILER_H_
@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/sync_profiler.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+namespace {
+
+// Profiles for the duration of a test.
+class ScopedSyncProfiling {
+ public:
+  ScopedSyncProfiling() {
+    SyncProfiler::Reset();
+    SyncProfiler::Enable();
+  }
+
+  ~ScopedSyncProfiling() {
+    SyncProfiler::Disable();
+    SyncProfiler::Reset();
+  }
+};
+
+const SyncProfiler::Histogram::Summary* Find(
+    const std::vector<SyncProfiler::Histogram::Summary>& summaries,
+    const std::string& name) {
+  for (const auto& summary : summaries) {
+    if (summary.name == name) {
+      return &summary;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(SyncProfilerTest, HistogramSummarizesPercentiles) {
+  SyncProfiler::Histogram histogram("test");
+  for (int i = 0; i < 90; i++) {
+    histogram.Add(TimeDelta::FromMicroseconds(3));
+  }
+  for (int i = 0; i < 9; i++) {
+    histogram.Add(TimeDelta::FromMicroseconds(100));
+  }
+  histogram.Add(TimeDelta::FromMicroseconds(5000));
+
+  const auto summary = histogram.Summarize();
+  EXPECT_EQ(summary.name, "test");
+  EXPECT_EQ(summary.count, 100u);
+  EXPECT_EQ(summary.total_micros, 90 * 3 + 9 * 100 + 5000);
+  EXPECT_EQ(summary.max_micros, 5000);
+  // The upper bounds of the buckets of [2, 4) and [64, 128) microseconds.
+  EXPECT_EQ(summary.p50_micros, 4);
+  EXPECT_EQ(summary.p90_micros, 4);
+  EXPECT_EQ(summary.p99_micros, 128);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Summarize().count, 0u);
+}
+
+TEST(SyncProfilerTest, PercentilesDoNotExceedMax) {
+  SyncProfiler::Histogram histogram("test");
+  histogram.Add(TimeDelta::FromMicroseconds(5));
+  histogram.Add(TimeDelta::Zero());
+  const auto summary = histogram.Summarize();
+  EXPECT_EQ(summary.p50_micros, 1);
+  EXPECT_EQ(summary.p99_micros, 5);
+}
+
+TEST(SyncProfilerTest, LockRecordsNothingWhileDisabled) {
+  SyncProfiler::Reset();
+  static SyncProfiler::Site site("SyncProfilerTest.disabled");
+  std::mutex mutex;
+  { auto lock = SyncProfiler::Lock(mutex, site); }
+  EXPECT_EQ(Find(SyncProfiler::Summarize(), "SyncProfilerTest.disabled"),
+            nullptr);
+}
+
+TEST(SyncProfilerTest, LockRecordsWaits) {
+  ScopedSyncProfiling profiling;
+  static SyncProfiler::Site site("SyncProfilerTest.mutex");
+  std::mutex mutex;
+  { auto lock = SyncProfiler::Lock(mutex, site); }
+
+  fml::AutoResetWaitableEvent locked;
+  auto lock = SyncProfiler::Lock(mutex, site);
+  std::thread waiter([&]() {
+    locked.Signal();
+    auto waiter_lock = SyncProfiler::Lock(mutex, site);
+  });
+  locked.Wait();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  lock.unlock();
+  waiter.join();
+
+  const auto summaries = SyncProfiler::Summarize();
+  const auto* summary = Find(summaries, "SyncProfilerTest.mutex");
+  ASSERT_NE(summary, nullptr);
+  EXPECT_EQ(summary->count, 3u);
+  EXPECT_GT(summary->max_micros, 0);
+}
+
+TEST(SyncProfilerTest, RecordsTaskLatencyAndDurationPerThread) {
+  ScopedSyncProfiling profiling;
+  fml::Thread thread("SyncProfilerTest.thread");
+  fml::AutoResetWaitableEvent ran;
+  thread.GetTaskRunner()->PostTask([&ran]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ran.Signal();
+  });
+  ran.Wait();
+  // The duration is recorded once the task returns.
+  fml::AutoResetWaitableEvent flushed;
+  thread.GetTaskRunner()->PostTask([&flushed]() { flushed.Signal(); });
+  flushed.Wait();
+
+  const auto summaries = SyncProfiler::Summarize();
+  const auto* latency =
+      Find(summaries, "SyncProfilerTest.thread.queue_latency");
+  const auto* duration =
+      Find(summaries, "SyncProfilerTest.thread.task_duration");
+  ASSERT_NE(latency, nullptr);
+  ASSERT_NE(duration, nullptr);
+  EXPECT_GE(latency->count, 1u);
+  EXPECT_GE(duration->count, 1u);
+  EXPECT_GE(duration->max_micros, 1000);
+}
+
+}  // namespace testing
+}  // namespace fml
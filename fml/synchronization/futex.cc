@@ -0,0 +1,179 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/synchronization/futex.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "flutter/fml/build_config.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#if OS_LINUX || OS_ANDROID
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <climits>
+#elif OS_FUCHSIA
+#include <zircon/syscalls.h>
+#elif OS_WIN
+#include <windows.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace fml {
+namespace internal {
+
+#if OS_LINUX || OS_ANDROID
+
+void FutexWait(std::atomic<uint32_t>* address,
+               uint32_t expected,
+               TimeDelta timeout) {
+  struct timespec relative_timeout;
+  struct timespec* timeout_ptr = nullptr;
+  if (timeout >= TimeDelta::Zero()) {
+    relative_timeout = timeout.ToTimespec();
+    timeout_ptr = &relative_timeout;
+  }
+  // Interruptions and timeouts are reported as errors, which callers handle
+  // like spurious wake-ups.
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(address),
+            FUTEX_WAIT_PRIVATE, expected, timeout_ptr, nullptr, 0);
+}
+
+void FutexWakeOne(std::atomic<uint32_t>* address) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE_PRIVATE,
+            1, nullptr, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* address) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE_PRIVATE,
+            INT_MAX, nullptr, nullptr, 0);
+}
+
+#elif OS_FUCHSIA
+
+void FutexWait(std::atomic<uint32_t>* address,
+               uint32_t expected,
+               TimeDelta timeout) {
+  zx_time_t deadline = timeout >= TimeDelta::Zero()
+                           ? zx_deadline_after(timeout.ToNanoseconds())
+                           : ZX_TIME_INFINITE;
+  zx_futex_wait(reinterpret_cast<const zx_futex_t*>(address),
+                static_cast<zx_futex_t>(expected), ZX_HANDLE_INVALID, deadline);
+}
+
+void FutexWakeOne(std::atomic<uint32_t>* address) {
+  zx_futex_wake(reinterpret_cast<const zx_futex_t*>(address), 1);
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* address) {
+  zx_futex_wake(reinterpret_cast<const zx_futex_t*>(address), UINT32_MAX);
+}
+
+#elif OS_WIN
+
+void FutexWait(std::atomic<uint32_t>* address,
+               uint32_t expected,
+               TimeDelta timeout) {
+  DWORD milliseconds = INFINITE;
+  if (timeout >= TimeDelta::Zero()) {
+    // Rounds up so that short timeouts don't spin on zero-length waits.
+    milliseconds = static_cast<DWORD>(
+        std::min<int64_t>((timeout.ToNanoseconds() + 999999) / 1000000,
+                          INFINITE - 1));
+  }
+  ::WaitOnAddress(reinterpret_cast<volatile uint32_t*>(address), &expected,
+                  sizeof(expected), milliseconds);
+}
+
+void FutexWakeOne(std::atomic<uint32_t>* address) {
+  ::WakeByAddressSingle(reinterpret_cast<uint32_t*>(address));
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* address) {
+  ::WakeByAddressAll(reinterpret_cast<uint32_t*>(address));
+}
+
+#else
+
+namespace {
+
+// Waiters on different addresses may share a bucket, so wakes notify all the
+// waiters of a bucket and the others wake up spuriously.
+struct Bucket {
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
+constexpr size_t kBucketCount = 64;
+
+Bucket& GetBucket(std::atomic<uint32_t>* address) {
+  // Never destroyed since threads may wait during shutdown.
+  static Bucket* buckets = new Bucket[kBucketCount];
+  uintptr_t key = reinterpret_cast<uintptr_t>(address);
+  return buckets[(key >> 2 ^ key >> 9) % kBucketCount];
+}
+
+}  // namespace
+
+void FutexWait(std::atomic<uint32_t>* address,
+               uint32_t expected,
+               TimeDelta timeout) {
+  Bucket& bucket = GetBucket(address);
+  std::unique_lock<std::mutex> lock(bucket.mutex);
+  // Wakers take the bucket mutex after changing the value, so checking it
+  // under the mutex can't miss a wake.
+  if (address->load(std::memory_order_relaxed) != expected) {
+    return;
+  }
+  if (timeout >= TimeDelta::Zero()) {
+    bucket.cv.wait_for(lock, std::chrono::nanoseconds(timeout.ToNanoseconds()));
+  } else {
+    bucket.cv.wait(lock);
+  }
+}
+
+void FutexWakeOne(std::atomic<uint32_t>* address) {
+  FutexWakeAll(address);
+}
+
+void FutexWakeAll(std::atomic<uint32_t>* address) {
+  Bucket& bucket = GetBucket(address);
+  { std::scoped_lock lock(bucket.mutex); }
+  bucket.cv.notify_all();
+}
+
+#endif
+
+uint32_t AdaptiveSpinner::GetSpinLimit() const {
+  static const bool is_multi_core = std::thread::hardware_concurrency() > 1;
+  if (!is_multi_core) {
+    return 0;
+  }
+  return std::clamp(estimate_.load(std::memory_order_relaxed) * 2, kMinSpins,
+                    kMaxSpins);
+}
+
+void AdaptiveSpinner::Pause() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#elif defined(_M_ARM64)
+  __yield();
+#endif
+}
+
+}  // namespace internal
+}  // namespace fml
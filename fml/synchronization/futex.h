@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
+#define FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "flutter/fml/time/time_delta.h"
+
+namespace fml {
+namespace internal {
+
+// Wait and wake operations on the address of a 32-bit atomic, the building
+// block of |Semaphore| and the waitable events. These use futexes on Linux,
+// Android and Fuchsia and |WaitOnAddress()| on Windows. Elsewhere they are
+// emulated with a fixed table of condition variables hashed by address.
+//
+// A thread must change the value of the atomic before waking its waiters, and
+// waiters must recheck the value after waking up since wake-ups may be
+// spurious. Waking an address whose atomic was destroyed is safe.
+
+// Blocks while |*address| is |expected|, until woken up or until |timeout|
+// elapses. Returns immediately if |*address| is not |expected|. A negative
+// |timeout| waits forever.
+void FutexWait(std::atomic<uint32_t>* address,
+               uint32_t expected,
+               TimeDelta timeout = TimeDelta::FromNanoseconds(-1));
+
+// Wakes at least one of the threads blocked in |FutexWait()| on |address|.
+void FutexWakeOne(std::atomic<uint32_t>* address);
+
+// Wakes all threads blocked in |FutexWait()| on |address|.
+void FutexWakeAll(std::atomic<uint32_t>* address);
+
+// Spins for a bounded number of iterations until |condition()| holds, before a
+// waiter parks in |FutexWait()|. Most handoffs between threads complete in a
+// few microseconds, which spinning catches without the cost of parking.
+//
+// The number of iterations adapts to how long recent waits on the same object
+// spun before succeeding, and spinning backs off on objects whose waits
+// usually end up parking. Nothing is spun on machines with a single core.
+class AdaptiveSpinner {
+ public:
+  // Returns whether |condition()| held before giving up.
+  template <typename Condition>
+  bool SpinUntil(const Condition& condition) {
+    const uint32_t limit = GetSpinLimit();
+    for (uint32_t i = 0; i < limit; i++) {
+      if (condition()) {
+        UpdateEstimate(i);
+        return true;
+      }
+      Pause();
+    }
+    if (limit > 0) {
+      // The wait is going to park, so spin less on this object next time.
+      UpdateEstimate(0);
+    }
+    return false;
+  }
+
+ private:
+  // About 10 to 20 microseconds on current cores.
+  static constexpr uint32_t kMaxSpins = 2048;
+  static constexpr uint32_t kMinSpins = 16;
+
+  // An estimate of the iterations that a wait takes. Updated racily by the
+  // waiters, which is fine for a heuristic.
+  std::atomic<uint32_t> estimate_ = {kMaxSpins / 4};
+
+  uint32_t GetSpinLimit() const;
+
+  void UpdateEstimate(uint32_t spins) {
+    uint32_t estimate = estimate_.load(std::memory_order_relaxed);
+    // An exponential moving average of the iterations.
+    int64_t delta = (static_cast<int64_t>(spins) - estimate) / 8;
+    estimate_.store(static_cast<uint32_t>(estimate + delta),
+                    std::memory_order_relaxed);
+  }
+
+  static void Pause();
+};
+
+}  // namespace internal
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
@@ -0,0 +1,74 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/synchronization/reader_biased_shared_mutex.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/futex.h"
+
+namespace fml {
+
+SharedMutex* SharedMutex::CreateReaderBiased() {
+  return new ReaderBiasedSharedMutex();
+}
+
+ReaderBiasedSharedMutex::ReaderBiasedSharedMutex() = default;
+
+ReaderBiasedSharedMutex::~ReaderBiasedSharedMutex() {
+  FML_DCHECK(writer_.load() == 0);
+}
+
+size_t ReaderBiasedSharedMutex::GetSlotIndex() {
+  // Threads are spread over the slots in the order they first read.
+  static std::atomic<size_t> next_index = {0};
+  thread_local size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % kSlotCount;
+  return index;
+}
+
+void ReaderBiasedSharedMutex::LockShared() {
+  std::atomic<uint32_t>& readers = slots_[GetSlotIndex()].readers;
+  while (true) {
+    // Sequentially consistent with the writer, which sets |writer_| before
+    // reading the counters: either the writer sees this reader or this reader
+    // sees the writer.
+    readers.fetch_add(1, std::memory_order_seq_cst);
+    if (writer_.load(std::memory_order_seq_cst) == 0) {
+      return;
+    }
+    // Backs off until the writer is done.
+    if (readers.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+      internal::FutexWakeAll(&readers);
+    }
+    internal::FutexWait(&writer_, 1);
+  }
+}
+
+void ReaderBiasedSharedMutex::UnlockShared() {
+  std::atomic<uint32_t>& readers = slots_[GetSlotIndex()].readers;
+  if (readers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+      writer_.load(std::memory_order_seq_cst) != 0) {
+    // The last reader of this slot wakes up the waiting writer.
+    internal::FutexWakeAll(&readers);
+  }
+}
+
+void ReaderBiasedSharedMutex::Lock() {
+  writer_mutex_.lock();
+  writer_.store(1, std::memory_order_seq_cst);
+  for (Slot& slot : slots_) {
+    uint32_t readers;
+    while ((readers = slot.readers.load(std::memory_order_seq_cst)) != 0) {
+      internal::FutexWait(&slot.readers, readers);
+    }
+  }
+}
+
+void ReaderBiasedSharedMutex::Unlock() {
+  writer_.store(0, std::memory_order_seq_cst);
+  internal::FutexWakeAll(&writer_);
+  writer_mutex_.unlock();
+}
+
+}  // namespace fml
@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNCHRONIZATION_READER_BIASED_SHARED_MUTEX_H_
+#define FLUTTER_FML_SYNCHRONIZATION_READER_BIASED_SHARED_MUTEX_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/shared_mutex.h"
+
+namespace fml {
+
+// A reader/writer lock for structures that are read far more often than they
+// are written. Readers count themselves in one of several counters, each on
+// its own cache line, picked by thread. Readers on different threads therefore
+// don't write to the same cache line, which they do with
+// |SharedMutex::Create()|, where every acquire bounces the line of the lock
+// between cores.
+//
+// Writers are expensive: they wait for the readers of every counter to leave,
+// and wake up the readers that waited for them. Writers have priority, so
+// recursively acquiring a shared lock may deadlock while a writer waits.
+class ReaderBiasedSharedMutex final : public SharedMutex {
+ public:
+  static constexpr size_t kSlotCount = 16;
+
+  ~ReaderBiasedSharedMutex() override;
+
+  // |SharedMutex|
+  void Lock() override;
+
+  // |SharedMutex|
+  void LockShared() override;
+
+  // |SharedMutex|
+  void Unlock() override;
+
+  // |SharedMutex|
+  void UnlockShared() override;
+
+ private:
+  friend SharedMutex* SharedMutex::CreateReaderBiased();
+
+  struct alignas(64) Slot {
+    std::atomic<uint32_t> readers = {0};
+  };
+
+  Slot slots_[kSlotCount];
+  // 1 while a writer holds or waits for the lock.
+  alignas(64) std::atomic<uint32_t> writer_ = {0};
+  // Serializes writers.
+  std::mutex writer_mutex_;
+
+  ReaderBiasedSharedMutex();
+
+  static size_t GetSlotIndex();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ReaderBiasedSharedMutex);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNCHRONIZATION_READER_BIASED_SHARED_MUTEX_H_
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/synchronization/reader_biased_shared_mutex.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+TEST(ReaderBiasedSharedMutexTest, ReadersShareTheLock) {
+  std::unique_ptr<SharedMutex> mutex(SharedMutex::CreateReaderBiased());
+  std::atomic<int> readers = 0;
+  std::atomic<bool> all_in = false;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      SharedLock lock(*mutex);
+      readers++;
+      // Only finishes if all readers hold the lock at the same time.
+      while (readers.load() < 4 && !all_in.load()) {
+        std::this_thread::yield();
+      }
+      all_in = true;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(all_in.load());
+}
+
+TEST(ReaderBiasedSharedMutexTest, WritersExcludeReadersAndWriters) {
+  std::unique_ptr<SharedMutex> mutex(SharedMutex::CreateReaderBiased());
+  // Written under the exclusive lock as two halves that must always match.
+  int64_t first = 0;
+  int64_t second = 0;
+  std::atomic<bool> torn = false;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 2000; j++) {
+        UniqueLock lock(*mutex);
+        first++;
+        std::this_thread::yield();
+        second++;
+      }
+    });
+  }
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 5000; j++) {
+        SharedLock lock(*mutex);
+        if (first != second) {
+          torn = true;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(torn.load());
+  EXPECT_EQ(first, 4000);
+  EXPECT_EQ(second, 4000);
+}
+
+TEST(ReaderBiasedSharedMutexTest, WriterWaitsForReaders) {
+  std::unique_ptr<SharedMutex> mutex(SharedMutex::CreateReaderBiased());
+  std::atomic<bool> read_done = false;
+  std::atomic<bool> write_done = false;
+  mutex->LockShared();
+  std::thread writer([&]() {
+    UniqueLock lock(*mutex);
+    EXPECT_TRUE(read_done.load());
+    write_done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(write_done.load());
+  read_done = true;
+  mutex->UnlockShared();
+  writer.join();
+  EXPECT_TRUE(write_done.load());
+}
+
+}  // namespace
+}  // namespace fml
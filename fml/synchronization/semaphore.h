@@ -5,15 +5,18 @@
 #ifndef FLUTTER_FML_SYNCHRONIZATION_SEMAPHORE_H_
 #define FLUTTER_FML_SYNCHRONIZATION_SEMAPHORE_H_
 
-#include <memory>
+#include <atomic>
+#include <cstdint>
 
 #include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/futex.h"
 
 namespace fml {
 
-class PlatformSemaphore;
-
+// A counting semaphore. |TryWait()| and |Signal()| are atomic operations on
+// the count that only call into the kernel to wake threads blocked in
+// |Wait()|.
 class Semaphore {
  public:
   explicit Semaphore(uint32_t count);
@@ -22,12 +25,20 @@ class Semaphore {
 
   bool IsValid() const;
 
+  // Decrements the count if it is positive. Returns whether it did.
   [[nodiscard]] bool TryWait();
 
+  // Blocks the calling thread until the count is positive, then decrements it.
+  // Spins briefly before blocking.
+  void Wait();
+
   void Signal();
 
  private:
-  std::unique_ptr<PlatformSemaphore> _impl;
+  std::atomic<uint32_t> count_;
+  // The number of threads blocked in |Wait()|.
+  std::atomic<uint32_t> waiters_ = {0};
+  internal::AdaptiveSpinner spinner_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(Semaphore);
 };
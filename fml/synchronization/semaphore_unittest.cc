@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
+#include <chrono>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/synchronization/semaphore.h"
 #include "gtest/gtest.h"
@@ -25,3 +28,38 @@ TEST(SemaphoreTest, WaitOnZeroSignalThenWait) {
   ASSERT_TRUE(sem.TryWait());
   ASSERT_FALSE(sem.TryWait());
 }
+
+TEST(SemaphoreTest, WaitBlocksUntilSignaled) {
+  fml::Semaphore sem(0);
+  std::atomic_bool signaled(false);
+  std::thread thread([&sem, &signaled]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    signaled = true;
+    sem.Signal();
+  });
+  sem.Wait();
+  ASSERT_TRUE(signaled);
+  ASSERT_FALSE(sem.TryWait());
+  thread.join();
+}
+
+TEST(SemaphoreTest, ConcurrentWaitsConsumeEverySignal) {
+  fml::Semaphore sem(0);
+  constexpr size_t kThreads = 4;
+  constexpr size_t kWaitsPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; i++) {
+    threads.emplace_back([&sem]() {
+      for (size_t j = 0; j < kWaitsPerThread; j++) {
+        sem.Wait();
+      }
+    });
+  }
+  for (size_t i = 0; i < kThreads * kWaitsPerThread; i++) {
+    sem.Signal();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(sem.TryWait());
+}
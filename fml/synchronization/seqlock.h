@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNCHRONIZATION_SEQLOCK_H_
+#define FLUTTER_FML_SYNCHRONIZATION_SEQLOCK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+// Holds a small trivially copyable value that is read often from several
+// threads and written rarely. Reads don't write to shared memory at all: they
+// copy the value and retry if a write happened meanwhile, so readers never
+// contend with each other and never block writers. Writers are serialized
+// with each other.
+//
+// Reads take time proportional to the size of |T| and retry while a write is
+// in progress, so |T| should be at most a few cache lines. Larger or
+// non-trivially copyable state belongs under a |SharedMutex|.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock values are copied byte by byte.");
+
+ public:
+  SeqLock() : SeqLock(T{}) {}
+
+  explicit SeqLock(const T& value) { StoreWords(value); }
+
+  T Load() const {
+    T value;
+    while (!TryLoad(&value)) {
+      std::this_thread::yield();
+    }
+    return value;
+  }
+
+  void Store(const T& value) {
+    // Claims the lock by making the sequence odd. Acquires the data of the
+    // previous writer.
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    while ((sequence & 1) != 0 ||
+           !sequence_.compare_exchange_weak(sequence, sequence + 1,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+      if ((sequence & 1) != 0) {
+        std::this_thread::yield();
+        sequence = sequence_.load(std::memory_order_relaxed);
+      }
+    }
+    // Orders the odd sequence before the data, for readers that see the new
+    // data.
+    std::atomic_thread_fence(std::memory_order_release);
+    StoreWords(value);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t kWordCount =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint32_t> sequence_ = {0};
+  // Atomic so that reads racing with a write are well defined. Their relaxed
+  // accesses compile to plain loads and stores.
+  std::atomic<uint64_t> words_[kWordCount];
+
+  bool TryLoad(T* value) const {
+    const uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1) != 0) {
+      return false;
+    }
+    uint64_t words[kWordCount];
+    for (size_t i = 0; i < kWordCount; i++) {
+      words[i] = words_[i].load(std::memory_order_relaxed);
+    }
+    // Orders the data before the second read of the sequence.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != sequence) {
+      return false;
+    }
+    ::memcpy(static_cast<void*>(value), words, sizeof(T));
+    return true;
+  }
+
+  void StoreWords(const T& value) {
+    uint64_t words[kWordCount] = {};
+    ::memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < kWordCount; i++) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SeqLock);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNCHRONIZATION_SEQLOCK_H_
@@ -0,0 +1,80 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/synchronization/seqlock.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace {
+
+// Larger than a word and not a multiple of one.
+struct Metrics {
+  double width;
+  double height;
+  double pixel_ratio;
+  int32_t generation;
+};
+
+TEST(SeqLockTest, LoadsWhatWasStored) {
+  SeqLock<Metrics> lock({1, 2, 3, 4});
+  Metrics metrics = lock.Load();
+  EXPECT_EQ(metrics.width, 1);
+  EXPECT_EQ(metrics.height, 2);
+  EXPECT_EQ(metrics.pixel_ratio, 3);
+  EXPECT_EQ(metrics.generation, 4);
+
+  lock.Store({5, 6, 7, 8});
+  metrics = lock.Load();
+  EXPECT_EQ(metrics.width, 5);
+  EXPECT_EQ(metrics.generation, 8);
+
+  SeqLock<int> small;
+  EXPECT_EQ(small.Load(), 0);
+  small.Store(42);
+  EXPECT_EQ(small.Load(), 42);
+}
+
+TEST(SeqLockTest, ReadsAreNeverTorn) {
+  SeqLock<Metrics> lock({0, 0, 0, 0});
+  std::atomic<bool> done = false;
+  std::atomic<bool> torn = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; i++) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        Metrics metrics = lock.Load();
+        if (metrics.width != metrics.generation ||
+            metrics.height != 2 * metrics.width ||
+            metrics.pixel_ratio != 3 * metrics.width) {
+          torn = true;
+        }
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int i = 0; i < 2; i++) {
+    writers.emplace_back([&lock]() {
+      for (int32_t j = 1; j <= 5000; j++) {
+        lock.Store({static_cast<double>(j), 2.0 * j, 3.0 * j, j});
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_FALSE(torn.load());
+  EXPECT_EQ(lock.Load().generation, 5000);
+}
+
+}  // namespace
+}  // namespace fml
@@ -11,6 +11,11 @@ namespace fml {
 class SharedMutex {
  public:
   static SharedMutex* Create();
+
+  // Creates a lock that makes shared acquires cheaper and contend less, at
+  // the cost of much more expensive exclusive acquires. See
+  // |ReaderBiasedSharedMutex|.
+  static SharedMutex* CreateReaderBiased();
   virtual ~SharedMutex() = default;
 
   virtual void Lock() = 0;
@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/synchronization/seqlock.h"
+#include "flutter/fml/synchronization/shared_mutex.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+
+namespace fml {
+namespace benchmarking {
+
+// Measures the round trip latency of handing off between two threads, like
+// the vsync and pipeline handoffs between the UI and raster threads do. Every
+// iteration signals the other thread and waits for it to signal back.
+template <typename T>
+static void RunPingPong(benchmark::State& state,
+                        T& ping,
+                        T& pong,
+                        void (*wait)(T&),
+                        void (*signal)(T&)) {
+  std::atomic_bool done(false);
+  std::thread thread([&]() {
+    while (true) {
+      wait(ping);
+      if (done) {
+        break;
+      }
+      signal(pong);
+    }
+  });
+
+  while (state.KeepRunning()) {
+    signal(ping);
+    wait(pong);
+  }
+
+  done = true;
+  signal(ping);
+  thread.join();
+}
+
+static void BM_AutoResetWaitableEventPingPong(benchmark::State& state) {
+  AutoResetWaitableEvent ping;
+  AutoResetWaitableEvent pong;
+  RunPingPong<AutoResetWaitableEvent>(
+      state, ping, pong, [](AutoResetWaitableEvent& ev) { ev.Wait(); },
+      [](AutoResetWaitableEvent& ev) { ev.Signal(); });
+}
+BENCHMARK(BM_AutoResetWaitableEventPingPong)->UseRealTime();
+
+static void BM_SemaphorePingPong(benchmark::State& state) {
+  Semaphore ping(0);
+  Semaphore pong(0);
+  RunPingPong<Semaphore>(
+      state, ping, pong, [](Semaphore& sem) { sem.Wait(); },
+      [](Semaphore& sem) { sem.Signal(); });
+}
+BENCHMARK(BM_SemaphorePingPong)->UseRealTime();
+
+// The cost of the fast paths that don't block or wake another thread.
+static void BM_AutoResetWaitableEventSignalThenWait(benchmark::State& state) {
+  AutoResetWaitableEvent ev;
+  while (state.KeepRunning()) {
+    ev.Signal();
+    ev.Wait();
+  }
+}
+BENCHMARK(BM_AutoResetWaitableEventSignalThenWait);
+
+static void BM_SemaphoreSignalThenTryWait(benchmark::State& state) {
+  Semaphore sem(0);
+  while (state.KeepRunning()) {
+    sem.Signal();
+    benchmark::DoNotOptimize(sem.TryWait());
+  }
+}
+BENCHMARK(BM_SemaphoreSignalThenTryWait);
+
+// The cost of reading small shared state from several threads at once, as the
+// isolates of all threads look up shared registries. Each read holds the lock
+// only long enough to copy the state. Every 1024th iteration of the first
+// thread writes instead.
+struct SharedState {
+  int64_t values[4];
+};
+
+template <typename Read, typename Write>
+static void RunReadMostly(benchmark::State& state, Read read, Write write) {
+  int64_t iteration = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0 && (++iteration & 1023) == 0) {
+      write(SharedState{{iteration, iteration, iteration, iteration}});
+    } else {
+      benchmark::DoNotOptimize(read());
+    }
+  }
+}
+
+static void BM_ReadMostlyStdMutex(benchmark::State& state) {
+  static std::mutex mutex;
+  static SharedState shared = {};
+  RunReadMostly(
+      state,
+      []() {
+        std::scoped_lock lock(mutex);
+        return shared;
+      },
+      [](const SharedState& value) {
+        std::scoped_lock lock(mutex);
+        shared = value;
+      });
+}
+BENCHMARK(BM_ReadMostlyStdMutex)->ThreadRange(1, 8)->UseRealTime();
+
+template <SharedMutex* (*Create)()>
+static void RunReadMostlySharedMutex(benchmark::State& state) {
+  static std::unique_ptr<SharedMutex> mutex(Create());
+  static SharedState shared = {};
+  RunReadMostly(
+      state,
+      []() {
+        SharedLock lock(*mutex);
+        return shared;
+      },
+      [](const SharedState& value) {
+        UniqueLock lock(*mutex);
+        shared = value;
+      });
+}
+
+static void BM_ReadMostlySharedMutex(benchmark::State& state) {
+  RunReadMostlySharedMutex<SharedMutex::Create>(state);
+}
+BENCHMARK(BM_ReadMostlySharedMutex)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ReadMostlyReaderBiasedSharedMutex(benchmark::State& state) {
+  RunReadMostlySharedMutex<SharedMutex::CreateReaderBiased>(state);
+}
+BENCHMARK(BM_ReadMostlyReaderBiasedSharedMutex)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+static void BM_ReadMostlySeqLock(benchmark::State& state) {
+  static SeqLock<SharedState> shared;
+  RunReadMostly(
+      state, []() { return shared.Load(); },
+      [](const SharedState& value) { shared.Store(value); });
+}
+BENCHMARK(BM_ReadMostlySeqLock)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -8,160 +8,166 @@
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 
-#include <errno.h>
-#include <time.h>
-
 namespace fml {
 
-// Waits with a timeout on |condition()|. Returns true on timeout, or false if
-// |condition()| ever returns true. |condition()| should have no side effects
-// (and will always be called with |*mutex| held).
-template <typename ConditionFn>
-bool WaitWithTimeoutImpl(std::unique_lock<std::mutex>* locker,
-                         std::condition_variable* cv,
-                         ConditionFn condition,
-                         TimeDelta timeout) {
-  FML_DCHECK(locker->owns_lock());
-
-  if (condition())
-    return false;
+namespace {
 
-  // We may get spurious wakeups.
-  TimeDelta wait_remaining = timeout;
-  TimePoint start = TimePoint::Now();
-  while (true) {
-    if (std::cv_status::timeout ==
-        cv->wait_for(*locker,
-                     std::chrono::nanoseconds(wait_remaining.ToNanoseconds())))
-      return true;  // Definitely timed out.
-
-    // We may have been awoken.
-    if (condition())
-      return false;
-
-    // Or the wakeup may have been spurious.
-    TimePoint now = TimePoint::Now();
-    FML_DCHECK(now >= start);
-    TimeDelta elapsed = now - start;
-    // It's possible that we may have timed out anyway.
-    if (elapsed >= timeout)
-      return true;
+TimePoint GetDeadline(TimeDelta timeout) {
+  TimePoint now = TimePoint::Now();
+  if (timeout >= TimePoint::Max() - now) {
+    return TimePoint::Max();
+  }
+  return now + timeout;
+}
 
-    // Otherwise, recalculate the amount that we have left to wait.
-    wait_remaining = timeout - elapsed;
+// Returns the timeout to pass to |FutexWait()| to wait until |deadline|, or a
+// zero |TimeDelta| if it has passed.
+TimeDelta GetFutexTimeout(TimePoint deadline) {
+  if (deadline == TimePoint::Max()) {
+    // Waits forever.
+    return TimeDelta::FromNanoseconds(-1);
   }
+  TimeDelta remaining = deadline - TimePoint::Now();
+  return remaining > TimeDelta::Zero() ? remaining : TimeDelta::Zero();
 }
 
+}  // namespace
+
 // AutoResetWaitableEvent ------------------------------------------------------
 
 void AutoResetWaitableEvent::Signal() {
-  std::scoped_lock locker(mutex_);
-  signaled_ = true;
-  cv_.notify_one();
+  uint32_t state = state_.fetch_or(kSignaled, std::memory_order_acq_rel);
+  // If the event was already signaled, a waiter was woken up by that signal.
+  if ((state & kSignaled) == 0 && state >= kWaiter) {
+    internal::FutexWakeOne(&state_);
+  }
 }
 
 void AutoResetWaitableEvent::Reset() {
-  std::scoped_lock locker(mutex_);
-  signaled_ = false;
+  state_.fetch_and(~kSignaled, std::memory_order_acq_rel);
 }
 
 void AutoResetWaitableEvent::Wait() {
-  std::unique_lock<std::mutex> locker(mutex_);
-  while (!signaled_)
-    cv_.wait(locker);
-  signaled_ = false;
+  WaitUntil(TimePoint::Max());
 }
 
 bool AutoResetWaitableEvent::WaitWithTimeout(TimeDelta timeout) {
-  std::unique_lock<std::mutex> locker(mutex_);
-
-  if (signaled_) {
-    signaled_ = false;
+  if (TryConsumeSignal()) {
     return false;
   }
+  return WaitUntil(GetDeadline(timeout));
+}
 
-  // We may get spurious wakeups.
-  TimeDelta wait_remaining = timeout;
-  TimePoint start = TimePoint::Now();
-  while (true) {
-    if (std::cv_status::timeout ==
-        cv_.wait_for(locker,
-                     std::chrono::nanoseconds(wait_remaining.ToNanoseconds())))
-      return true;  // Definitely timed out.
-
-    // We may have been awoken.
-    if (signaled_)
-      break;
-
-    // Or the wakeup may have been spurious.
-    TimePoint now = TimePoint::Now();
-    FML_DCHECK(now >= start);
-    TimeDelta elapsed = now - start;
-    // It's possible that we may have timed out anyway.
-    if (elapsed >= timeout)
-      return true;
+bool AutoResetWaitableEvent::IsSignaledForTest() {
+  return (state_.load(std::memory_order_acquire) & kSignaled) != 0;
+}
 
-    // Otherwise, recalculate the amount that we have left to wait.
-    wait_remaining = timeout - elapsed;
+bool AutoResetWaitableEvent::TryConsumeSignal() {
+  uint32_t state = state_.load(std::memory_order_relaxed);
+  while ((state & kSignaled) != 0) {
+    if (state_.compare_exchange_weak(state, state & ~kSignaled,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+      return true;
+    }
   }
-
-  signaled_ = false;
   return false;
 }
 
-bool AutoResetWaitableEvent::IsSignaledForTest() {
-  std::scoped_lock locker(mutex_);
-  return signaled_;
+bool AutoResetWaitableEvent::WaitUntil(TimePoint deadline) {
+  if (spinner_.SpinUntil([this]() { return TryConsumeSignal(); })) {
+    return false;
+  }
+
+  uint32_t state = state_.fetch_add(kWaiter, std::memory_order_acq_rel);
+  state += kWaiter;
+  while (true) {
+    if ((state & kSignaled) != 0) {
+      // Consumes the signal and stops waiting in one step.
+      if (state_.compare_exchange_weak(state, (state & ~kSignaled) - kWaiter,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return false;
+      }
+      continue;
+    }
+    TimeDelta timeout = GetFutexTimeout(deadline);
+    if (timeout == TimeDelta::Zero()) {
+      // A signal may still arrive until the waiter is unregistered, in which
+      // case its wake-up may have gone to this thread, so the signal is
+      // consumed instead of leaving it to threads that are still blocked.
+      if (state_.compare_exchange_weak(state, state - kWaiter,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+      continue;
+    }
+    internal::FutexWait(&state_, state, timeout);
+    state = state_.load(std::memory_order_relaxed);
+  }
 }
 
 // ManualResetWaitableEvent ----------------------------------------------------
 
 void ManualResetWaitableEvent::Signal() {
-  std::scoped_lock locker(mutex_);
-  signaled_ = true;
-  signal_id_++;
-  cv_.notify_all();
+  uint32_t state = state_.load(std::memory_order_relaxed);
+  while (!state_.compare_exchange_weak(state, (state | kSignaled) + kSignalID,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+  }
+  if ((state & kWaiterMask) != 0) {
+    internal::FutexWakeAll(&state_);
+  }
 }
 
 void ManualResetWaitableEvent::Reset() {
-  std::scoped_lock locker(mutex_);
-  signaled_ = false;
+  state_.fetch_and(~kSignaled, std::memory_order_acq_rel);
 }
 
 void ManualResetWaitableEvent::Wait() {
-  std::unique_lock<std::mutex> locker(mutex_);
-
-  if (signaled_)
-    return;
-
-  auto last_signal_id = signal_id_;
-  do {
-    cv_.wait(locker);
-  } while (signal_id_ == last_signal_id);
+  WaitUntil(TimePoint::Max());
 }
 
 bool ManualResetWaitableEvent::WaitWithTimeout(TimeDelta timeout) {
-  std::unique_lock<std::mutex> locker(mutex_);
-
-  auto last_signal_id = signal_id_;
-  // Disable thread-safety analysis for the lambda: We could annotate it with
-  // |FML_EXCLUSIVE_LOCKS_REQUIRED(mutex_)|, but then the analyzer currently
-  // isn't able to figure out that |WaitWithTimeoutImpl()| calls it while
-  // holding |mutex_|.
-  bool rv = WaitWithTimeoutImpl(
-      &locker, &cv_,
-      [this, last_signal_id]() {
-        // Also check |signaled_| in case we're already signaled.
-        return signaled_ || signal_id_ != last_signal_id;
-      },
-      timeout);
-  FML_DCHECK(rv || signaled_ || signal_id_ != last_signal_id);
-  return rv;
+  if (IsSignaledForTest()) {
+    return false;
+  }
+  return WaitUntil(GetDeadline(timeout));
 }
 
 bool ManualResetWaitableEvent::IsSignaledForTest() {
-  std::scoped_lock locker(mutex_);
-  return signaled_;
+  return (state_.load(std::memory_order_acquire) & kSignaled) != 0;
+}
+
+bool ManualResetWaitableEvent::WaitUntil(TimePoint deadline) {
+  uint32_t state = state_.load(std::memory_order_acquire);
+  if ((state & kSignaled) != 0) {
+    return false;
+  }
+
+  const uint32_t last_signal_id = state & kSignalIDMask;
+  auto was_signaled = [last_signal_id](uint32_t value) {
+    return (value & kSignalIDMask) != last_signal_id;
+  };
+  if (spinner_.SpinUntil([this, &was_signaled]() {
+        return was_signaled(state_.load(std::memory_order_acquire));
+      })) {
+    return false;
+  }
+
+  state = state_.fetch_add(kWaiter, std::memory_order_acq_rel) + kWaiter;
+  FML_DCHECK((state & kWaiterMask) != 0) << "Too many waiting threads.";
+  while (!was_signaled(state)) {
+    TimeDelta timeout = GetFutexTimeout(deadline);
+    if (timeout == TimeDelta::Zero()) {
+      state = state_.fetch_sub(kWaiter, std::memory_order_acquire);
+      return !was_signaled(state);
+    }
+    internal::FutexWait(&state_, state, timeout);
+    state = state_.load(std::memory_order_acquire);
+  }
+  state_.fetch_sub(kWaiter, std::memory_order_relaxed);
+  return false;
 }
 
 }  // namespace fml
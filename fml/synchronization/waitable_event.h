@@ -10,11 +10,13 @@
 #ifndef FLUTTER_FML_SYNCHRONIZATION_WAITABLE_EVENT_H_
 #define FLUTTER_FML_SYNCHRONIZATION_WAITABLE_EVENT_H_
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/futex.h"
 #include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 
 namespace fml {
 
@@ -38,8 +40,8 @@ class AutoResetWaitableEvent final {
   //   call to |Signal()|.
   // * A |Signal()|, followed by a |Reset()|, may cause *no* waiting thread to
   //   be unblocked.
-  // * We rely on pthreads's queueing for picking which waiting thread to
-  //   unblock, rather than enforcing FIFO ordering.
+  // * We rely on the operating system's queueing for picking which waiting
+  //   thread to unblock, rather than enforcing FIFO ordering.
   void Signal();
 
   // Put the event into the unsignaled state. Generally, this is not recommended
@@ -48,7 +50,8 @@ class AutoResetWaitableEvent final {
 
   // Blocks the calling thread until the event is signaled. Upon unblocking, the
   // event is returned to the unsignaled state, so that (unless |Reset()| is
-  // called) each |Signal()| unblocks exactly one |Wait()|.
+  // called) each |Signal()| unblocks exactly one |Wait()|. Spins briefly before
+  // blocking, since most signals arrive within microseconds.
   void Wait();
 
   // Like |Wait()|, but with a timeout. Also unblocks if |timeout| expires
@@ -62,11 +65,21 @@ class AutoResetWaitableEvent final {
   bool IsSignaledForTest();
 
  private:
-  std::condition_variable cv_;
-  std::mutex mutex_;
+  // The low bit of |state_| is set while the event is signaled and the other
+  // bits count the threads blocked waiting. Keeping both in one word lets
+  // |Signal()| skip the wake when nothing waits without touching the event
+  // after setting the bit, at which point a waiter may already destroy it.
+  static constexpr uint32_t kSignaled = 1u;
+  static constexpr uint32_t kWaiter = 2u;
 
-  // True if this event is in the signaled state.
-  bool signaled_ = false;
+  std::atomic<uint32_t> state_ = {0u};
+  internal::AdaptiveSpinner spinner_;
+
+  // Clears the signaled state if set. Returns whether it was.
+  bool TryConsumeSignal();
+
+  // Returns true if |deadline| passes without the event being signaled.
+  bool WaitUntil(TimePoint deadline);
 
   FML_DISALLOW_COPY_AND_ASSIGN(AutoResetWaitableEvent);
 };
@@ -104,20 +117,24 @@ class ManualResetWaitableEvent final {
   bool IsSignaledForTest();
 
  private:
-  std::condition_variable cv_;
-  std::mutex mutex_;
-
-  // True if this event is in the signaled state.
-  bool signaled_ = false;
-
-  // While |std::condition_variable::notify_all()| (|pthread_cond_broadcast()|)
-  // will wake all waiting threads, one has to deal with spurious wake-ups.
-  // Checking |signaled_| isn't sufficient, since another thread may have been
-  // awoken and (manually) reset |signaled_|. This is a counter that is
-  // incremented in |Signal()| before calling
-  // |std::condition_variable::notify_all()|. A waiting thread knows it was
-  // awoken if |signal_id_| is different from when it started waiting.
-  unsigned signal_id_ = 0u;
+  // The low bit of |state_| is set while the event is signaled, the next bits
+  // count the threads blocked waiting and the remaining bits hold a signal ID.
+  //
+  // Checking the signaled bit isn't sufficient for a waiting thread that is
+  // woken up, since another thread may have (manually) reset the event in the
+  // meantime. |Signal()| increments the ID, so a waiting thread knows it was
+  // signaled if the ID is different from when it started waiting.
+  static constexpr uint32_t kSignaled = 1u;
+  static constexpr uint32_t kWaiter = 2u;
+  static constexpr uint32_t kWaiterMask = 0x1ffeu;
+  static constexpr uint32_t kSignalID = 0x2000u;
+  static constexpr uint32_t kSignalIDMask = ~(kWaiterMask | kSignaled);
+
+  std::atomic<uint32_t> state_ = {0u};
+  internal::AdaptiveSpinner spinner_;
+
+  // Returns true if |deadline| passes without the event being signaled.
+  bool WaitUntil(TimePoint deadline);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ManualResetWaitableEvent);
 };
@@ -9,6 +9,7 @@
 #include <stdlib.h>
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -123,6 +124,41 @@ TEST(AutoResetWaitableEventTest, MultipleWaiters) {
   }
 }
 
+TEST(AutoResetWaitableEventTest, PingPong) {
+  AutoResetWaitableEvent ping;
+  AutoResetWaitableEvent pong;
+  constexpr size_t kRoundTrips = 10000u;
+
+  std::thread thread([&ping, &pong]() {
+    for (size_t i = 0u; i < kRoundTrips; i++) {
+      ping.Wait();
+      pong.Signal();
+    }
+  });
+
+  // Each signal must wake up the other thread, whether it is still spinning
+  // or already blocked.
+  for (size_t i = 0u; i < kRoundTrips; i++) {
+    ping.Signal();
+    EXPECT_FALSE(pong.WaitWithTimeout(kActionTimeout));
+  }
+  thread.join();
+  EXPECT_FALSE(ping.IsSignaledForTest());
+  EXPECT_FALSE(pong.IsSignaledForTest());
+}
+
+TEST(AutoResetWaitableEventTest, DestroyedByWaiter) {
+  // Events are often on the stack of the waiting thread, which returns as soon
+  // as it is signaled.
+  for (size_t i = 0u; i < 1000u; i++) {
+    auto ev = std::make_unique<AutoResetWaitableEvent>();
+    std::thread thread([ev = ev.get()]() { ev->Signal(); });
+    ev->Wait();
+    ev.reset();
+    thread.join();
+  }
+}
+
 // ManualResetWaitableEvent ----------------------------------------------------
 
 TEST(ManualResetWaitableEventTest, Basic) {
@@ -177,5 +213,36 @@ TEST(ManualResetWaitableEventTest, SignalMultiple) {
   }
 }
 
+TEST(ManualResetWaitableEventTest, SignalThenResetWakesWaiters) {
+  ManualResetWaitableEvent ev;
+
+  for (size_t i = 0u; i < 10u; i++) {
+    std::atomic_uint wake_count(0u);
+    std::vector<std::thread> threads;
+    for (size_t j = 0u; j < 4u; j++) {
+      threads.push_back(std::thread([&ev, &wake_count]() {
+        if (rand() % 2 == 0)
+          ev.Wait();
+        else
+          EXPECT_FALSE(ev.WaitWithTimeout(kActionTimeout));
+        wake_count.fetch_add(1u);
+      }));
+    }
+
+    // As above, count on the threads having advanced to waiting.
+    SleepFor(kTinyTimeout + kTinyTimeout);
+
+    // Threads that were waiting when the event was signaled are woken up even
+    // though it is reset right away.
+    ev.Signal();
+    ev.Reset();
+
+    for (auto& thread : threads)
+      thread.join();
+    EXPECT_EQ(threads.size(), wake_count.load());
+    EXPECT_FALSE(ev.IsSignaledForTest());
+  }
+}
+
 }  // namespace
 }  // namespace fml
@@ -5,12 +5,15 @@
 #ifndef FLUTTER_FML_TASK_RUNNER_H_
 #define FLUTTER_FML_TASK_RUNNER_H_
 
+#include <vector>
+
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_closure.h"
 
 namespace fml {
 
@@ -20,19 +23,35 @@ class TaskRunner : public fml::RefCountedThreadSafe<TaskRunner> {
  public:
   virtual ~TaskRunner();
 
-  virtual void PostTask(const fml::closure& task);
+  // Tasks are moved rather than copied all the way to the thread that runs
+  // them. Both `fml::closure`s and callables that can't be copied can be
+  // posted.
+  virtual void PostTask(fml::UniqueClosure task);
 
-  virtual void PostTaskForTime(const fml::closure& task,
+  virtual void PostTaskForTime(fml::UniqueClosure task,
                                fml::TimePoint target_time);
 
-  virtual void PostDelayedTask(const fml::closure& task, fml::TimeDelta delay);
+  virtual void PostDelayedTask(fml::UniqueClosure task, fml::TimeDelta delay);
+
+  // Like |PostTask| and |PostTaskForTime|, but due tasks of a higher
+  // |priority| run before the ones of a lower priority. See |TaskPriority|.
+  virtual void PostTaskWithPriority(fml::UniqueClosure task,
+                                    TaskPriority priority);
+
+  virtual void PostTaskForTimeWithPriority(fml::UniqueClosure task,
+                                           fml::TimePoint target_time,
+                                           TaskPriority priority);
+
+  // Posts all of |tasks| to run in order, locking the queue of the loop and
+  // waking it up only once for all of them.
+  virtual void PostTasks(std::vector<fml::UniqueClosure> tasks);
 
   virtual bool RunsTasksOnCurrentThread();
 
   virtual TaskQueueId GetTaskQueueId();
 
   static void RunNowOrPostTask(fml::RefPtr<fml::TaskRunner> runner,
-                               const fml::closure& task);
+                               fml::UniqueClosure task);
 
  protected:
   TaskRunner(fml::RefPtr<MessageLoopImpl> loop);
@@ -14,25 +14,43 @@
 #include <pthread.h>
 #endif
 
+#if OS_LINUX || OS_ANDROID
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_ring_buffer.h"
 
 namespace fml {
 
-Thread::Thread(const std::string& name) : joined_(false) {
+Thread::Thread(const std::string& name) : Thread(ThreadConfig{name}) {}
+
+Thread::Thread(ThreadConfig config, ThreadConfigSetter setter)
+    : joined_(false) {
   fml::AutoResetWaitableEvent latch;
   fml::RefPtr<fml::TaskRunner> runner;
-  thread_ = std::make_unique<std::thread>([&latch, &runner, name]() -> void {
-    SetCurrentThreadName(name);
-    fml::MessageLoop::EnsureInitializedForCurrentThread();
-    auto& loop = MessageLoop::GetCurrent();
-    runner = loop.GetTaskRunner();
-    latch.Signal();
-    loop.Run();
-  });
+  thread_ = std::make_unique<std::thread>(
+      [&latch, &runner, &config, &setter]() -> void {
+        if (setter) {
+          setter(config);
+        } else {
+          SetCurrentThreadName(config.name);
+        }
+        fml::MessageLoop::EnsureInitializedForCurrentThread();
+        auto& loop = MessageLoop::GetCurrent();
+        runner = loop.GetTaskRunner();
+        latch.Signal();
+        loop.Run();
+      });
   latch.Wait();
   task_runner_ = runner;
 }
@@ -70,6 +88,8 @@ void Thread::SetCurrentThreadName(const std::string& name) {
   if (name == "") {
     return;
   }
+  tracing::TraceRingBuffer::SetCurrentThreadName(name);
+  SyncProfiler::SetCurrentThreadName(name);
 #if OS_MACOSX
   pthread_setname_np(name.c_str());
 #elif OS_LINUX || OS_ANDROID
@@ -91,4 +111,103 @@ void Thread::SetCurrentThreadName(const std::string& name) {
 #endif
 }
 
+void Thread::SetCurrentThreadConfig(const ThreadConfig& config) {
+  SetCurrentThreadName(config.name);
+  if (config.priority != ThreadPriority::kNormal &&
+      !SetCurrentThreadPriority(config.priority)) {
+    FML_LOG(ERROR) << "Could not set the priority of thread '" << config.name
+                   << "'.";
+  }
+  if (config.affinity_mask != 0 &&
+      !SetCurrentThreadAffinity(config.affinity_mask)) {
+    FML_LOG(ERROR) << "Could not set the affinity of thread '" << config.name
+                   << "'.";
+  }
+}
+
+bool Thread::SetCurrentThreadPriority(ThreadPriority priority) {
+#if OS_LINUX || OS_ANDROID
+  // Nice values, from the most preferred to the fallback. Raising the priority
+  // of a thread above normal may not be permitted, in which case a smaller
+  // raise is tried. Android describes -8 as "most important display threads,
+  // for compositing the screen and retrieving input events", display threads
+  // stay slightly below that.
+  std::vector<int> nice_values;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      nice_values = {10};
+      break;
+    case ThreadPriority::kNormal:
+      nice_values = {0};
+      break;
+    case ThreadPriority::kUI:
+      nice_values = {-1};
+      break;
+    case ThreadPriority::kDisplay:
+      nice_values = {-5, -2};
+      break;
+  }
+  const id_t thread_id = static_cast<id_t>(syscall(SYS_gettid));
+  for (int nice_value : nice_values) {
+    if (::setpriority(PRIO_PROCESS, thread_id, nice_value) == 0) {
+      return true;
+    }
+  }
+  return false;
+#elif OS_MACOSX
+  qos_class_t qos_class = QOS_CLASS_DEFAULT;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      qos_class = QOS_CLASS_UTILITY;
+      break;
+    case ThreadPriority::kNormal:
+      qos_class = QOS_CLASS_DEFAULT;
+      break;
+    case ThreadPriority::kUI:
+    case ThreadPriority::kDisplay:
+      qos_class = QOS_CLASS_USER_INTERACTIVE;
+      break;
+  }
+  return pthread_set_qos_class_self_np(qos_class, 0) == 0;
+#elif OS_WIN
+  int thread_priority = THREAD_PRIORITY_NORMAL;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      thread_priority = THREAD_PRIORITY_BELOW_NORMAL;
+      break;
+    case ThreadPriority::kNormal:
+      thread_priority = THREAD_PRIORITY_NORMAL;
+      break;
+    case ThreadPriority::kUI:
+      thread_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+      break;
+    case ThreadPriority::kDisplay:
+      thread_priority = THREAD_PRIORITY_HIGHEST;
+      break;
+  }
+  return ::SetThreadPriority(::GetCurrentThread(), thread_priority) != 0;
+#else
+  return false;
+#endif
+}
+
+bool Thread::SetCurrentThreadAffinity(uint64_t affinity_mask) {
+#if OS_LINUX || OS_ANDROID
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (size_t cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+    if (affinity_mask & (uint64_t{1} << cpu)) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  return ::sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#elif OS_WIN
+  return ::SetThreadAffinityMask(::GetCurrentThread(),
+                                 static_cast<DWORD_PTR>(affinity_mask)) != 0;
+#else
+  // Darwin and Fuchsia don't let threads pick their cores.
+  return false;
+#endif
+}
+
 }  // namespace fml
@@ -6,7 +6,10 @@
 #define FLUTTER_FML_THREAD_H_
 
 #include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <string>
 #include <thread>
 
 #include "flutter/fml/macros.h"
@@ -16,8 +19,36 @@ namespace fml {
 
 class Thread {
  public:
+  // How urgent the work of a thread is. The platforms map these to their own
+  // priorities, or quality of service classes.
+  enum class ThreadPriority {
+    // Work that can wait, like loading resources.
+    kBackground,
+    // Leaves the priority the thread inherited alone.
+    kNormal,
+    // Work that a frame waits for, like building it.
+    kUI,
+    // Work that puts pixels on the screen, like rasterizing a frame.
+    kDisplay,
+  };
+
+  struct ThreadConfig {
+    std::string name;
+    ThreadPriority priority = ThreadPriority::kNormal;
+    // The cores the thread may run on, one bit per core. Zero lets the
+    // scheduler choose from all of them.
+    uint64_t affinity_mask = 0;
+  };
+
+  // Applies a config to the thread it is called on. Embedders that manage
+  // thread priorities themselves can provide their own.
+  using ThreadConfigSetter = std::function<void(const ThreadConfig&)>;
+
   explicit Thread(const std::string& name = "");
 
+  explicit Thread(ThreadConfig config,
+                  ThreadConfigSetter setter = SetCurrentThreadConfig);
+
   ~Thread();
 
   fml::RefPtr<fml::TaskRunner> GetTaskRunner() const;
@@ -26,6 +57,16 @@ class Thread {
 
   static void SetCurrentThreadName(const std::string& name);
 
+  // Sets the name, priority and core affinity of the current thread as far as
+  // the platform supports it.
+  static void SetCurrentThreadConfig(const ThreadConfig& config);
+
+  // Returns false if the priority could not be set.
+  static bool SetCurrentThreadPriority(ThreadPriority priority);
+
+  // Returns false if the affinity could not be set.
+  static bool SetCurrentThreadAffinity(uint64_t affinity_mask);
+
  private:
   std::unique_ptr<std::thread> thread_;
   fml::RefPtr<fml::TaskRunner> task_runner_;
@@ -4,8 +4,13 @@
 
 #include "gtest/gtest.h"
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/thread.h"
 
+#if OS_LINUX
+#include <sched.h>
+#endif
+
 TEST(Thread, CanStartAndEnd) {
   fml::Thread thread;
   ASSERT_TRUE(thread.GetTaskRunner());
@@ -24,3 +29,50 @@ TEST(Thread, HasARunningMessageLoop) {
   thread.Join();
   ASSERT_TRUE(done);
 }
+
+TEST(Thread, AppliesItsConfigWithTheSetter) {
+  fml::Thread::ThreadConfig applied_config;
+  std::thread::id setter_thread_id;
+  fml::Thread::ThreadConfig config{"test.thread",
+                                   fml::Thread::ThreadPriority::kDisplay, 1};
+  fml::Thread thread(config, [&](const fml::Thread::ThreadConfig& applied) {
+    applied_config = applied;
+    setter_thread_id = std::this_thread::get_id();
+  });
+
+  std::thread::id thread_id;
+  thread.GetTaskRunner()->PostTask(
+      [&thread_id]() { thread_id = std::this_thread::get_id(); });
+  thread.Join();
+
+  ASSERT_EQ(setter_thread_id, thread_id);
+  ASSERT_EQ(applied_config.name, "test.thread");
+  ASSERT_EQ(applied_config.priority, fml::Thread::ThreadPriority::kDisplay);
+  ASSERT_EQ(applied_config.affinity_mask, 1u);
+}
+
+#if OS_LINUX
+TEST(Thread, CanLowerItsPriorityAndPinItself) {
+  // Pin to the first core this process may run on.
+  cpu_set_t allowed;
+  ASSERT_EQ(::sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int cpu = 0;
+  while (cpu < 64 && !CPU_ISSET(cpu, &allowed)) {
+    cpu++;
+  }
+  ASSERT_LT(cpu, 64);
+
+  fml::Thread thread(fml::Thread::ThreadConfig{
+      "test.thread", fml::Thread::ThreadPriority::kBackground,
+      uint64_t{1} << cpu});
+  bool pinned = false;
+  thread.GetTaskRunner()->PostTask([&pinned, cpu]() {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    pinned = ::sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0 &&
+             CPU_COUNT(&cpu_set) == 1 && CPU_ISSET(cpu, &cpu_set);
+  });
+  thread.Join();
+  ASSERT_TRUE(pinned);
+}
+#endif  // OS_LINUX
@@ -11,31 +11,75 @@
 #include "flutter/fml/ascii_trie.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_ring_buffer.h"
 
 namespace fml {
 namespace tracing {
 
-#if FLUTTER_TIMELINE_ENABLED
-
 namespace {
+
+#if FLUTTER_TIMELINE_ENABLED
 AsciiTrie gAllowlist;
+#endif  // FLUTTER_TIMELINE_ENABLED
 
-inline void FlutterTimelineEvent(const char* label,
-                                 int64_t timestamp0,
-                                 int64_t timestamp1_or_async_id,
-                                 Dart_Timeline_Event_Type type,
-                                 intptr_t argument_count,
-                                 const char** argument_names,
-                                 const char** argument_values) {
+// Events go to the ring buffers while they are recording, and to the Dart
+// timeline otherwise. The Dart timeline is compiled out of release builds
+// but the ring buffers are not.
+void FlutterTimelineEvent(const char* category,
+                          const char* label,
+                          int64_t timestamp0,
+                          int64_t timestamp1_or_async_id,
+                          Dart_Timeline_Event_Type type,
+                          intptr_t argument_count,
+                          const char** argument_names,
+                          const char** argument_values) {
+  if (TraceRingBuffer::IsEnabled()) {
+    TraceRingBuffer::RecordWithStrings(category, label, timestamp0,
+                                       timestamp1_or_async_id, type,
+                                       argument_count, argument_names,
+                                       argument_values);
+    return;
+  }
+#if FLUTTER_TIMELINE_ENABLED
   if (gAllowlist.Query(label)) {
     Dart_TimelineEvent(label, timestamp0, timestamp1_or_async_id, type,
                        argument_count, argument_names, argument_values);
   }
+#endif  // FLUTTER_TIMELINE_ENABLED
 }
+
+int64_t TimelineGetMicros() {
+  if (TraceRingBuffer::IsEnabled()) {
+    return TraceRingBuffer::Now();
+  }
+#if FLUTTER_TIMELINE_ENABLED
+  return Dart_TimelineGetMicros();
+#else
+  // Nothing records the event.
+  return 0;
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
 }  // namespace
 
+std::atomic<uint32_t> TraceCategories::enabled_ = {~0u};
+
+void TraceCategories::SetEnabled(const std::vector<std::string>& categories) {
+  if (categories.empty()) {
+    enabled_ = ~0u;
+    return;
+  }
+  uint32_t enabled = 0;
+  for (const auto& category : categories) {
+    enabled |= GetBit(category.c_str());
+  }
+  enabled_ = enabled;
+}
+
 void TraceSetAllowlist(const std::vector<std::string>& allowlist) {
+#if FLUTTER_TIMELINE_ENABLED
   gAllowlist.Fill(allowlist);
+#endif  // FLUTTER_TIMELINE_ENABLED
 }
 
 size_t TraceNonce() {
@@ -60,6 +104,7 @@ void TraceTimelineEvent(TraceArg category_group,
   }
 
   FlutterTimelineEvent(
+      category_group,                            // category
       name,                                      // label
       timestamp_micros,                          // timestamp0
       identifier,                                // timestamp1_or_async_id
@@ -78,7 +123,7 @@ void TraceTimelineEvent(TraceArg category_group,
                         const std::vector<std::string>& values) {
   TraceTimelineEvent(category_group,            // group
                      name,                      // name
-                     Dart_TimelineGetMicros(),  // timestamp_micros
+                     TimelineGetMicros(),       // timestamp_micros
                      identifier,                // identifier
                      type,                      // type
                      c_names,                   // names
@@ -87,8 +132,9 @@ void TraceTimelineEvent(TraceArg category_group,
 }
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                       // label
-                       Dart_TimelineGetMicros(),   // timestamp0
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
+                       TimelineGetMicros(),        // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
                        0,                          // argument_count
@@ -103,8 +149,9 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                       // label
-                       Dart_TimelineGetMicros(),   // timestamp0
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
+                       TimelineGetMicros(),        // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
                        1,                          // argument_count
@@ -121,8 +168,9 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                       // label
-                       Dart_TimelineGetMicros(),   // timestamp0
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
+                       TimelineGetMicros(),        // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
                        2,                          // argument_count
@@ -132,8 +180,9 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
-  FlutterTimelineEvent(name,                      // label
-                       Dart_TimelineGetMicros(),  // timestamp0
+  FlutterTimelineEvent(nullptr,                   // category
+                       name,                      // label
+                       TimelineGetMicros(),       // timestamp0
                        0,                         // timestamp1_or_async_id
                        Dart_Timeline_Event_End,   // event type
                        0,                         // argument_count
@@ -145,8 +194,9 @@ void TraceEventEnd(TraceArg name) {
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
-                       Dart_TimelineGetMicros(),  // timestamp0
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
+                       TimelineGetMicros(),       // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
                        0,                                // argument_count
@@ -158,8 +208,9 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
-                       Dart_TimelineGetMicros(),       // timestamp0
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
+                       TimelineGetMicros(),            // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
                        0,                              // argument_count
@@ -175,8 +226,9 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                      // label
-                       Dart_TimelineGetMicros(),  // timestamp0
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
+                       TimelineGetMicros(),       // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
                        1,                                // argument_count
@@ -192,8 +244,9 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                           // label
-                       Dart_TimelineGetMicros(),       // timestamp0
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
+                       TimelineGetMicros(),            // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
                        1,                              // argument_count
@@ -203,8 +256,9 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                         // label
-                       Dart_TimelineGetMicros(),     // timestamp0
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
+                       TimelineGetMicros(),          // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
                        0,                            // argument_count
@@ -219,8 +273,9 @@ void TraceEventInstant1(TraceArg category_group,
                         TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                         // label
-                       Dart_TimelineGetMicros(),     // timestamp0
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
+                       TimelineGetMicros(),          // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
                        1,                            // argument_count
@@ -237,8 +292,9 @@ void TraceEventInstant2(TraceArg category_group,
                         TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                         // label
-                       Dart_TimelineGetMicros(),     // timestamp0
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
+                       TimelineGetMicros(),          // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
                        2,                            // argument_count
@@ -250,8 +306,9 @@ void TraceEventInstant2(TraceArg category_group,
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
-                       Dart_TimelineGetMicros(),  // timestamp0
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
+                       TimelineGetMicros(),       // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Begin,  // event type
                        0,                               // argument_count
@@ -263,8 +320,9 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
-                       Dart_TimelineGetMicros(),       // timestamp0
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
+                       TimelineGetMicros(),            // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Step,  // event type
                        0,                              // argument_count
@@ -274,8 +332,9 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-  FlutterTimelineEvent(name,                          // label
-                       Dart_TimelineGetMicros(),      // timestamp0
+  FlutterTimelineEvent(category_group,                // category
+                       name,                          // label
+                       TimelineGetMicros(),           // timestamp0
                        id,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_End,  // event type
                        0,                             // argument_count
@@ -284,96 +343,5 @@ void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
   );
 }
 
-#else  // FLUTTER_TIMELINE_ENABLED
-
-void TraceSetAllowlist(const std::vector<std::string>& allowlist) {}
-
-size_t TraceNonce() {
-  return 0;
-}
-
-void TraceTimelineEvent(TraceArg category_group,
-                        TraceArg name,
-                        int64_t timestamp_micros,
-                        TraceIDArg identifier,
-                        Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
-
-void TraceTimelineEvent(TraceArg category_group,
-                        TraceArg name,
-                        TraceIDArg identifier,
-                        Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
-
-void TraceEvent0(TraceArg category_group, TraceArg name) {}
-
-void TraceEvent1(TraceArg category_group,
-                 TraceArg name,
-                 TraceArg arg1_name,
-                 TraceArg arg1_val) {}
-
-void TraceEvent2(TraceArg category_group,
-                 TraceArg name,
-                 TraceArg arg1_name,
-                 TraceArg arg1_val,
-                 TraceArg arg2_name,
-                 TraceArg arg2_val) {}
-
-void TraceEventEnd(TraceArg name) {}
-
-void TraceEventAsyncComplete(TraceArg category_group,
-                             TraceArg name,
-                             TimePoint begin,
-                             TimePoint end) {}
-
-void TraceEventAsyncBegin0(TraceArg category_group,
-                           TraceArg name,
-                           TraceIDArg id) {}
-
-void TraceEventAsyncEnd0(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id) {}
-
-void TraceEventAsyncBegin1(TraceArg category_group,
-                           TraceArg name,
-                           TraceIDArg id,
-                           TraceArg arg1_name,
-                           TraceArg arg1_val) {}
-
-void TraceEventAsyncEnd1(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id,
-                         TraceArg arg1_name,
-                         TraceArg arg1_val) {}
-
-void TraceEventInstant0(TraceArg category_group, TraceArg name) {}
-
-void TraceEventInstant1(TraceArg category_group,
-                        TraceArg name,
-                        TraceArg arg1_name,
-                        TraceArg arg1_val) {}
-
-void TraceEventInstant2(TraceArg category_group,
-                        TraceArg name,
-                        TraceArg arg1_name,
-                        TraceArg arg1_val,
-                        TraceArg arg2_name,
-                        TraceArg arg2_val) {}
-
-void TraceEventFlowBegin0(TraceArg category_group,
-                          TraceArg name,
-                          TraceIDArg id) {}
-
-void TraceEventFlowStep0(TraceArg category_group,
-                         TraceArg name,
-                         TraceIDArg id) {}
-
-void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-}
-
-#endif  // FLUTTER_TIMELINE_ENABLED
-
 }  // namespace tracing
 }  // namespace fml
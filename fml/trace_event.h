@@ -35,6 +35,7 @@
 
 #endif  //  defined(OS_FUCHSIA)
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -43,6 +44,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_ring_buffer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 #if (FLUTTER_RELEASE && !defined(OS_FUCHSIA))
@@ -51,75 +53,131 @@
 #define FLUTTER_TIMELINE_ENABLED 1
 #endif
 
+// Trace events are compiled in depending on the level of their category.
+// Frame level categories ("flutter") describe the work of each frame. Detail
+// level categories ("flutter.detail" for the work of each layer and raster
+// cache entry, "fml" for the work of each task) are much more frequent and are
+// compiled out of release builds. Unknown categories are at the frame level.
+// Embedders can pick the level with -DFML_TRACE_LEVEL=<level>.
+#define FML_TRACE_LEVEL_NONE 0
+#define FML_TRACE_LEVEL_FRAME 1
+#define FML_TRACE_LEVEL_DETAIL 2
+
+#ifndef FML_TRACE_LEVEL
+#if FLUTTER_RELEASE
+#define FML_TRACE_LEVEL FML_TRACE_LEVEL_FRAME
+#else
+#define FML_TRACE_LEVEL FML_TRACE_LEVEL_DETAIL
+#endif
+#endif  // FML_TRACE_LEVEL
+
 #if !defined(OS_FUCHSIA)
 #ifndef TRACE_EVENT_HIDE_MACROS
 
 #define __FML__TOKEN_CAT__(x, y) x##y
 #define __FML__TOKEN_CAT__2(x, y) __FML__TOKEN_CAT__(x, y)
-#define __FML__AUTO_TRACE_END(name)                                  \
-  ::fml::tracing::ScopedInstantEnd __FML__TOKEN_CAT__2(__trace_end_, \
-                                                       __LINE__)(name);
+#define __FML__TRACE_END_NAME __FML__TOKEN_CAT__2(__trace_end_, __LINE__)
+#define __FML__AUTO_TRACE_END(category_group, name) \
+  ::fml::tracing::ScopedInstantEnd __FML__TRACE_END_NAME(  \
+      FML_TRACE_CATEGORY_ENABLED(category_group) ? (name) : nullptr);
+
+// Whether events of the category are compiled in and currently enabled. The
+// arguments of events in disabled categories are not evaluated.
+#define FML_TRACE_CATEGORY_ENABLED(category_group)                     \
+  (::fml::tracing::TraceCategories::IsCompiledIn(category_group) && \
+   ::fml::tracing::TraceCategories::IsEnabled(category_group))
 
 // This macro has the FML_ prefix so that it does not collide with the macros
 // from lib/trace/event.h on Fuchsia.
 //
 // TODO(chinmaygarde): All macros here should have the FML prefix.
-#define FML_TRACE_COUNTER(category_group, name, counter_id, arg1, ...)         \
-  ::fml::tracing::TraceCounter((category_group), (name), (counter_id), (arg1), \
-                               __VA_ARGS__);
+#define FML_TRACE_COUNTER(category_group, name, counter_id, arg1, ...)    \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                       \
+    ::fml::tracing::TraceCounter((category_group), (name), (counter_id), \
+                                 (arg1), __VA_ARGS__);                    \
+  }
 
-#define FML_TRACE_EVENT(category_group, name, ...)                   \
-  ::fml::tracing::TraceEvent((category_group), (name), __VA_ARGS__); \
-  __FML__AUTO_TRACE_END(name)
+#define FML_TRACE_EVENT(category_group, name, ...)                     \
+  __FML__AUTO_TRACE_END(category_group, name)                          \
+  if (__FML__TRACE_END_NAME.IsEnabled()) {                             \
+    ::fml::tracing::TraceEvent((category_group), (name), __VA_ARGS__); \
+  }
 
-#define TRACE_EVENT0(category_group, name)           \
-  ::fml::tracing::TraceEvent0(category_group, name); \
-  __FML__AUTO_TRACE_END(name)
+#define TRACE_EVENT0(category_group, name)             \
+  __FML__AUTO_TRACE_END(category_group, name)          \
+  if (__FML__TRACE_END_NAME.IsEnabled()) {             \
+    ::fml::tracing::TraceEvent0(category_group, name); \
+  }
 
-#define TRACE_EVENT1(category_group, name, arg1_name, arg1_val)           \
-  ::fml::tracing::TraceEvent1(category_group, name, arg1_name, arg1_val); \
-  __FML__AUTO_TRACE_END(name)
+#define TRACE_EVENT1(category_group, name, arg1_name, arg1_val)             \
+  __FML__AUTO_TRACE_END(category_group, name)                               \
+  if (__FML__TRACE_END_NAME.IsEnabled()) {                                  \
+    ::fml::tracing::TraceEvent1(category_group, name, arg1_name, arg1_val); \
+  }
 
 #define TRACE_EVENT2(category_group, name, arg1_name, arg1_val, arg2_name, \
                      arg2_val)                                             \
-  ::fml::tracing::TraceEvent2(category_group, name, arg1_name, arg1_val,   \
-                              arg2_name, arg2_val);                        \
-  __FML__AUTO_TRACE_END(name)
+  __FML__AUTO_TRACE_END(category_group, name)                              \
+  if (__FML__TRACE_END_NAME.IsEnabled()) {                                 \
+    ::fml::tracing::TraceEvent2(category_group, name, arg1_name, arg1_val, \
+                                arg2_name, arg2_val);                      \
+  }
 
-#define TRACE_EVENT_ASYNC_BEGIN0(category_group, name, id) \
-  ::fml::tracing::TraceEventAsyncBegin0(category_group, name, id);
+#define TRACE_EVENT_ASYNC_BEGIN0(category_group, name, id)             \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                    \
+    ::fml::tracing::TraceEventAsyncBegin0(category_group, name, id); \
+  }
 
-#define TRACE_EVENT_ASYNC_END0(category_group, name, id) \
-  ::fml::tracing::TraceEventAsyncEnd0(category_group, name, id);
+#define TRACE_EVENT_ASYNC_END0(category_group, name, id)             \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                  \
+    ::fml::tracing::TraceEventAsyncEnd0(category_group, name, id); \
+  }
 
-#define TRACE_EVENT_ASYNC_BEGIN1(category_group, name, id, arg1_name,        \
-                                 arg1_val)                                   \
-  ::fml::tracing::TraceEventAsyncBegin1(category_group, name, id, arg1_name, \
-                                        arg1_val);
+#define TRACE_EVENT_ASYNC_BEGIN1(category_group, name, id, arg1_name,          \
+                                 arg1_val)                                     \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                            \
+    ::fml::tracing::TraceEventAsyncBegin1(category_group, name, id, arg1_name, \
+                                          arg1_val);                           \
+  }
 
 #define TRACE_EVENT_ASYNC_END1(category_group, name, id, arg1_name, arg1_val) \
-  ::fml::tracing::TraceEventAsyncEnd1(category_group, name, id, arg1_name,    \
-                                      arg1_val);
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                           \
+    ::fml::tracing::TraceEventAsyncEnd1(category_group, name, id, arg1_name,  \
+                                        arg1_val);                            \
+  }
 
-#define TRACE_EVENT_INSTANT0(category_group, name) \
-  ::fml::tracing::TraceEventInstant0(category_group, name);
+#define TRACE_EVENT_INSTANT0(category_group, name)             \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {            \
+    ::fml::tracing::TraceEventInstant0(category_group, name); \
+  }
 
-#define TRACE_EVENT_INSTANT1(category_group, name, arg1_name, arg1_val) \
-  ::fml::tracing::TraceEventInstant1(category_group, name, arg1_name, arg1_val);
+#define TRACE_EVENT_INSTANT1(category_group, name, arg1_name, arg1_val)   \
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                       \
+    ::fml::tracing::TraceEventInstant1(category_group, name, arg1_name, \
+                                       arg1_val);                         \
+  }
 
 #define TRACE_EVENT_INSTANT2(category_group, name, arg1_name, arg1_val, \
                              arg2_name, arg2_val)                       \
-  ::fml::tracing::TraceEventInstant2(category_group, name, arg1_name,   \
-                                     arg1_val, arg2_name, arg2_val);
+  if (FML_TRACE_CATEGORY_ENABLED(category_group)) {                     \
+    ::fml::tracing::TraceEventInstant2(category_group, name, arg1_name, \
+                                       arg1_val, arg2_name, arg2_val);  \
+  }
 
-#define TRACE_FLOW_BEGIN(category, name, id) \
-  ::fml::tracing::TraceEventFlowBegin0(category, name, id);
+#define TRACE_FLOW_BEGIN(category, name, id)                    \
+  if (FML_TRACE_CATEGORY_ENABLED(category)) {                   \
+    ::fml::tracing::TraceEventFlowBegin0(category, name, id); \
+  }
 
-#define TRACE_FLOW_STEP(category, name, id) \
-  ::fml::tracing::TraceEventFlowStep0(category, name, id);
+#define TRACE_FLOW_STEP(category, name, id)                    \
+  if (FML_TRACE_CATEGORY_ENABLED(category)) {                  \
+    ::fml::tracing::TraceEventFlowStep0(category, name, id); \
+  }
 
-#define TRACE_FLOW_END(category, name, id) \
-  ::fml::tracing::TraceEventFlowEnd0(category, name, id);
+#define TRACE_FLOW_END(category, name, id)                    \
+  if (FML_TRACE_CATEGORY_ENABLED(category)) {                 \
+    ::fml::tracing::TraceEventFlowEnd0(category, name, id); \
+  }
 
 #endif  // TRACE_EVENT_HIDE_MACROS
 #endif  // !defined(OS_FUCHSIA)
@@ -130,6 +188,59 @@ namespace tracing {
 using TraceArg = const char*;
 using TraceIDArg = int64_t;
 
+//------------------------------------------------------------------------------
+/// @brief      The levels of trace categories, see |FML_TRACE_LEVEL|, and
+///             which categories are enabled at runtime.
+///
+class TraceCategories {
+ public:
+  static constexpr int GetLevel(const char* category) {
+    return (Equals(category, "flutter.detail") || Equals(category, "fml"))
+               ? FML_TRACE_LEVEL_DETAIL
+               : FML_TRACE_LEVEL_FRAME;
+  }
+
+  static constexpr bool IsCompiledIn(const char* category) {
+    return GetLevel(category) <= FML_TRACE_LEVEL;
+  }
+
+  static bool IsEnabled(const char* category) {
+    return (enabled_.load(std::memory_order_relaxed) & GetBit(category)) != 0;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Only traces events in the given categories, or in all of them
+  ///             if |categories| is empty, which is the default. Categories
+  ///             other than the ones of the engine can only be enabled
+  ///             together.
+  ///
+  static void SetEnabled(const std::vector<std::string>& categories);
+
+ private:
+  static std::atomic<uint32_t> enabled_;
+
+  static constexpr bool Equals(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+      a++;
+      b++;
+    }
+    return *a == *b;
+  }
+
+  static constexpr uint32_t GetBit(const char* category) {
+    if (Equals(category, "flutter")) {
+      return 1u << 0;
+    }
+    if (Equals(category, "flutter.detail")) {
+      return 1u << 1;
+    }
+    if (Equals(category, "fml")) {
+      return 1u << 2;
+    }
+    return 1u << 3;
+  }
+};
+
 void TraceSetAllowlist(const std::vector<std::string>& allowlist);
 
 void TraceTimelineEvent(TraceArg category_group,
@@ -199,6 +310,11 @@ void TraceCounter(TraceArg category,
                   TraceArg name,
                   TraceIDArg identifier,
                   Args... args) {
+  if (TraceRingBuffer::IsEnabled()) {
+    TraceRingBuffer::Record(category, name, TraceRingBuffer::Now(), identifier,
+                            Dart_Timeline_Event_Counter, args...);
+    return;
+  }
 #if FLUTTER_TIMELINE_ENABLED
   auto split = SplitArguments(args...);
   TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
@@ -216,6 +332,11 @@ void TraceCounterNopHACK(TraceArg category,
 
 template <typename... Args>
 void TraceEvent(TraceArg category, TraceArg name, Args... args) {
+  if (TraceRingBuffer::IsEnabled()) {
+    TraceRingBuffer::Record(category, name, TraceRingBuffer::Now(), 0,
+                            Dart_Timeline_Event_Begin, args...);
+    return;
+  }
 #if FLUTTER_TIMELINE_ENABLED
   auto split = SplitArguments(args...);
   TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin, split.first,
@@ -245,10 +366,6 @@ void TraceEventAsyncComplete(TraceArg category_group,
                              TimePoint begin,
                              TimePoint end,
                              Args... args) {
-#if FLUTTER_TIMELINE_ENABLED
-  auto identifier = TraceNonce();
-  const auto split = SplitArguments(args...);
-
   if (begin > end) {
     std::swap(begin, end);
   }
@@ -256,6 +373,18 @@ void TraceEventAsyncComplete(TraceArg category_group,
   const int64_t begin_micros = begin.ToEpochDelta().ToMicroseconds();
   const int64_t end_micros = end.ToEpochDelta().ToMicroseconds();
 
+  if (TraceRingBuffer::IsEnabled()) {
+    auto identifier = TraceNonce();
+    TraceRingBuffer::Record(category_group, name, begin_micros, identifier,
+                            Dart_Timeline_Event_Async_Begin, args...);
+    TraceRingBuffer::Record(category_group, name, end_micros, identifier,
+                            Dart_Timeline_Event_Async_End, args...);
+    return;
+  }
+#if FLUTTER_TIMELINE_ENABLED
+  auto identifier = TraceNonce();
+  const auto split = SplitArguments(args...);
+
   TraceTimelineEvent(category_group,                   // group
                      name,                             // name
                      begin_micros,                     // timestamp_micros
@@ -316,11 +445,19 @@ void TraceEventFlowStep0(TraceArg category_group, TraceArg name, TraceIDArg id);
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id);
 
+// Ends the event with the given label when it goes out of scope, unless the
+// label is null because the event wasn't traced.
 class ScopedInstantEnd {
  public:
   ScopedInstantEnd(const char* str) : label_(str) {}
 
-  ~ScopedInstantEnd() { TraceEventEnd(label_); }
+  ~ScopedInstantEnd() {
+    if (label_ != nullptr) {
+      TraceEventEnd(label_);
+    }
+  }
+
+  bool IsEnabled() const { return label_ != nullptr; }
 
  private:
   const char* label_;
@@ -0,0 +1,52 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_ring_buffer.h"
+
+namespace fml {
+namespace benchmarking {
+
+// Traces a scope with arguments the way the rasterizer and animator do, going
+// to the Dart timeline.
+static void BM_TraceEventWithArgumentsToTimeline(benchmark::State& state) {
+  tracing::TraceRingBuffer::Disable();
+  int64_t frame = 0;
+  while (state.KeepRunning()) {
+    FML_TRACE_EVENT("flutter", "BM_TraceEvent", "frame", frame++, "layer",
+                    "PictureLayer");
+  }
+}
+
+// The same scope while recording into the ring buffers.
+static void BM_TraceEventWithArgumentsToRingBuffer(benchmark::State& state) {
+  tracing::TraceRingBuffer::Enable();
+  int64_t frame = 0;
+  while (state.KeepRunning()) {
+    FML_TRACE_EVENT("flutter", "BM_TraceEvent", "frame", frame++, "layer",
+                    "PictureLayer");
+  }
+  tracing::TraceRingBuffer::Disable();
+  tracing::TraceRingBuffer::Clear();
+}
+
+// The same scope in a category that is disabled at runtime.
+static void BM_TraceEventWithArgumentsInDisabledCategory(
+    benchmark::State& state) {
+  tracing::TraceCategories::SetEnabled({"fml"});
+  int64_t frame = 0;
+  while (state.KeepRunning()) {
+    FML_TRACE_EVENT("flutter", "BM_TraceEvent", "frame", frame++, "layer",
+                    "PictureLayer");
+  }
+  tracing::TraceCategories::SetEnabled({});
+}
+
+BENCHMARK(BM_TraceEventWithArgumentsToTimeline);
+BENCHMARK(BM_TraceEventWithArgumentsToRingBuffer);
+BENCHMARK(BM_TraceEventWithArgumentsInDisabledCategory);
+
+}  // namespace benchmarking
+}  // namespace fml
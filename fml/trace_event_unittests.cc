@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_event.h"
+
+#include <string>
+
+#include "flutter/fml/trace_ring_buffer.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+static_assert(TraceCategories::GetLevel("flutter") == FML_TRACE_LEVEL_FRAME);
+static_assert(TraceCategories::GetLevel("flutter.detail") ==
+              FML_TRACE_LEVEL_DETAIL);
+static_assert(TraceCategories::GetLevel("fml") == FML_TRACE_LEVEL_DETAIL);
+static_assert(TraceCategories::GetLevel("gfx") == FML_TRACE_LEVEL_FRAME);
+static_assert(TraceCategories::IsCompiledIn("flutter"));
+
+namespace {
+
+int CountEvaluation(int& count) {
+  return ++count;
+}
+
+}  // namespace
+
+TEST(TraceEventTest, DoesNotEvaluateArgumentsOfDisabledCategories) {
+  int count = 0;
+  TraceCategories::SetEnabled({"flutter"});
+  EXPECT_TRUE(TraceCategories::IsEnabled("flutter"));
+  EXPECT_FALSE(TraceCategories::IsEnabled("fml"));
+  EXPECT_FALSE(TraceCategories::IsEnabled("gfx"));
+  {
+    FML_TRACE_EVENT("fml", "DisabledEvent", "count", CountEvaluation(count));
+    TRACE_EVENT_INSTANT1("flutter.detail", "DisabledInstant", "count",
+                         std::to_string(CountEvaluation(count)).c_str());
+    FML_TRACE_COUNTER("fml", "DisabledCounter", 0, "count",
+                      CountEvaluation(count));
+  }
+  EXPECT_EQ(count, 0);
+
+  {
+    FML_TRACE_EVENT("flutter", "EnabledEvent", "count",
+                    CountEvaluation(count));
+  }
+  EXPECT_EQ(count, 1);
+
+  TraceCategories::SetEnabled({});
+  EXPECT_TRUE(TraceCategories::IsEnabled("fml"));
+  EXPECT_TRUE(TraceCategories::IsEnabled("gfx"));
+}
+
+TEST(TraceEventTest, DoesNotTraceDisabledCategories) {
+  TraceRingBuffer::Clear();
+  TraceRingBuffer::Enable();
+  TraceCategories::SetEnabled({"flutter", "gfx"});
+  {
+    TRACE_EVENT0("flutter.detail", "DisabledScope");
+    TRACE_EVENT0("flutter", "EnabledScope");
+    TRACE_EVENT_INSTANT0("input", "OtherCategoryInstant");
+  }
+  TraceCategories::SetEnabled({});
+  const std::string json = TraceRingBuffer::ExportChromeJSON();
+  TraceRingBuffer::Disable();
+  TraceRingBuffer::Clear();
+
+  EXPECT_EQ(json.find("DisabledScope"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"EnabledScope\",\"cat\":\"flutter\","
+                      "\"ph\":\"B\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"EnabledScope\",\"cat\":\"flutter\","
+                      "\"ph\":\"E\""),
+            std::string::npos);
+  // Categories other than the engine's are enabled together.
+  EXPECT_NE(json.find("OtherCategoryInstant"), std::string::npos);
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
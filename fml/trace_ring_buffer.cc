@@ -0,0 +1,371 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_ring_buffer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+constexpr size_t kMaxThreadNameLength = 31;
+
+struct Slot {
+  // Twice the index of the record in the slot plus one while the record is
+  // being written, and twice the index plus two once it is complete. This
+  // lets the exporter detect records that are overwritten while it copies
+  // them.
+  std::atomic<uint64_t> sequence = {0};
+  TraceRecord record;
+};
+
+// The events of one thread. Buffers are never freed so that the exporter can
+// access them while their threads exit, instead the buffer of an exited thread
+// is reused by the next thread that records events if it has the capacity that
+// is currently configured.
+struct ThreadBuffer {
+  ThreadBuffer(size_t capacity, int thread_id)
+      : slots(new Slot[capacity]), mask(capacity - 1), thread_id(thread_id) {}
+
+  const std::unique_ptr<Slot[]> slots;
+  const size_t mask;
+  int thread_id;
+  // The index of the next record. Only written by the owning thread.
+  std::atomic<uint64_t> end = {0};
+  // Records before this index were cleared or belong to a previous thread.
+  std::atomic<uint64_t> begin = {0};
+  // Guarded by the registry mutex.
+  char thread_name[kMaxThreadNameLength + 1] = {};
+  bool in_use = true;
+};
+
+class Registry {
+ public:
+  ThreadBuffer* Acquire(size_t capacity, const char* thread_name) {
+    std::scoped_lock lock(mutex_);
+    ThreadBuffer* buffer = nullptr;
+    for (const auto& free_buffer : buffers_) {
+      if (!free_buffer->in_use && free_buffer->mask + 1 == capacity) {
+        buffer = free_buffer.get();
+        buffer->in_use = true;
+        buffer->thread_id = next_thread_id_++;
+        buffer->begin.store(buffer->end.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+        break;
+      }
+    }
+    if (buffer == nullptr) {
+      buffers_.push_back(
+          std::make_unique<ThreadBuffer>(capacity, next_thread_id_++));
+      buffer = buffers_.back().get();
+    }
+    ::strncpy(buffer->thread_name, thread_name, kMaxThreadNameLength);
+    return buffer;
+  }
+
+  void Release(ThreadBuffer* buffer) {
+    std::scoped_lock lock(mutex_);
+    buffer->in_use = false;
+  }
+
+  void SetThreadName(ThreadBuffer* buffer, const char* thread_name) {
+    std::scoped_lock lock(mutex_);
+    ::strncpy(buffer->thread_name, thread_name, kMaxThreadNameLength);
+  }
+
+  template <typename Visitor>
+  void VisitBuffers(const Visitor& visitor) {
+    std::scoped_lock lock(mutex_);
+    for (const auto& buffer : buffers_) {
+      visitor(*buffer);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  int next_thread_id_ = 1;
+};
+
+Registry& GetRegistry() {
+  // Never destroyed since threads may record events during shutdown.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+std::atomic<size_t> gCapacity = {TraceRingBuffer::kDefaultCapacity};
+
+// Hands the buffer of the thread back to the registry when the thread exits.
+struct ThreadState {
+  ~ThreadState() {
+    if (buffer != nullptr) {
+      GetRegistry().Release(buffer);
+      buffer = nullptr;
+    }
+  }
+
+  ThreadBuffer* buffer = nullptr;
+  uint64_t index = 0;
+  char thread_name[kMaxThreadNameLength + 1] = {};
+};
+
+thread_local ThreadState tThreadState;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+const char* GetPhase(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+    default:
+      return "i";
+  }
+}
+
+bool HasID(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Async_Begin:
+    case Dart_Timeline_Event_Async_End:
+    case Dart_Timeline_Event_Async_Instant:
+    case Dart_Timeline_Event_Counter:
+    case Dart_Timeline_Event_Flow_Begin:
+    case Dart_Timeline_Event_Flow_Step:
+    case Dart_Timeline_Event_Flow_End:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void WriteString(std::ostringstream& stream, const char* string) {
+  stream << '"';
+  for (const char* c = string; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      stream << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      char escaped[7];
+      ::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+      stream << escaped;
+    } else {
+      stream << *c;
+    }
+  }
+  stream << '"';
+}
+
+void WriteRecord(std::ostringstream& stream,
+                 const TraceRecord& record,
+                 int thread_id) {
+  stream << "{\"name\":";
+  WriteString(stream, record.name);
+  stream << ",\"cat\":";
+  WriteString(stream, record.category ? record.category : "flutter");
+  stream << ",\"ph\":\"" << GetPhase(record.type) << "\",\"ts\":"
+         << record.timestamp_micros << ",\"pid\":0,\"tid\":" << thread_id;
+  if (HasID(record.type)) {
+    stream << ",\"id\":" << record.id;
+  }
+  if (record.type == Dart_Timeline_Event_Instant) {
+    stream << ",\"s\":\"t\"";
+  } else if (record.type == Dart_Timeline_Event_Flow_End) {
+    stream << ",\"bp\":\"e\"";
+  }
+  if (record.argument_count > 0) {
+    stream << ",\"args\":{";
+    for (size_t i = 0; i < record.argument_count; i++) {
+      const TraceRecord::Argument& argument = record.arguments[i];
+      if (i > 0) {
+        stream << ',';
+      }
+      WriteString(stream, argument.name);
+      stream << ':';
+      switch (argument.type) {
+        case TraceRecord::ArgumentType::kInt:
+          stream << argument.int_value;
+          break;
+        case TraceRecord::ArgumentType::kDouble:
+          stream << argument.double_value;
+          break;
+        case TraceRecord::ArgumentType::kString:
+          WriteString(stream, argument.string_value);
+          break;
+      }
+    }
+    stream << '}';
+  }
+  stream << '}';
+}
+
+}  // namespace
+
+std::atomic<bool> TraceRingBuffer::enabled_ = {false};
+
+void TraceRingBuffer::Enable(size_t capacity) {
+  FML_DCHECK(capacity > 0);
+  gCapacity = RoundUpToPowerOfTwo(capacity);
+  enabled_ = true;
+}
+
+void TraceRingBuffer::Disable() {
+  enabled_ = false;
+}
+
+void TraceRingBuffer::Clear() {
+  GetRegistry().VisitBuffers([](ThreadBuffer& buffer) {
+    buffer.begin.store(buffer.end.load(std::memory_order_acquire),
+                       std::memory_order_relaxed);
+  });
+}
+
+void TraceRingBuffer::SetCurrentThreadName(const std::string& name) {
+  ThreadState& state = tThreadState;
+  ::strncpy(state.thread_name, name.c_str(), kMaxThreadNameLength);
+  if (state.buffer != nullptr) {
+    GetRegistry().SetThreadName(state.buffer, state.thread_name);
+  }
+}
+
+TraceRecord* TraceRingBuffer::BeginRecord() {
+  ThreadState& state = tThreadState;
+  if (state.buffer == nullptr) {
+    state.buffer = GetRegistry().Acquire(gCapacity, state.thread_name);
+    state.index = state.buffer->end.load(std::memory_order_relaxed);
+  }
+  Slot& slot = state.buffer->slots[state.index & state.buffer->mask];
+  slot.sequence.store(state.index * 2 + 1, std::memory_order_relaxed);
+  // Keeps the writes to the record from becoming visible before the sequence
+  // marks it as being written.
+  std::atomic_thread_fence(std::memory_order_release);
+  return &slot.record;
+}
+
+void TraceRingBuffer::EndRecord() {
+  ThreadState& state = tThreadState;
+  Slot& slot = state.buffer->slots[state.index & state.buffer->mask];
+  state.index++;
+  slot.sequence.store(state.index * 2, std::memory_order_release);
+  state.buffer->end.store(state.index, std::memory_order_release);
+}
+
+void TraceRingBuffer::RecordWithStrings(const char* category,
+                                        const char* name,
+                                        int64_t timestamp_micros,
+                                        int64_t id,
+                                        Dart_Timeline_Event_Type type,
+                                        intptr_t argument_count,
+                                        const char** argument_names,
+                                        const char** argument_values) {
+  TraceRecord* record = BeginRecord();
+  record->category = category;
+  record->name = name;
+  record->timestamp_micros = timestamp_micros;
+  record->id = id;
+  record->type = type;
+  record->argument_count = static_cast<uint8_t>(std::min<intptr_t>(
+      argument_count, static_cast<intptr_t>(TraceRecord::kMaxArguments)));
+  for (size_t i = 0; i < record->argument_count; i++) {
+    record->arguments[i].name = argument_names[i];
+    SetArgument(record->arguments[i], argument_values[i]);
+  }
+  EndRecord();
+}
+
+void TraceRingBuffer::SetArgument(TraceRecord::Argument& argument,
+                                  const char* value) {
+  argument.type = TraceRecord::ArgumentType::kString;
+  if (value == nullptr) {
+    argument.string_value[0] = '\0';
+    return;
+  }
+  ::strncpy(argument.string_value, value, TraceRecord::kMaxStringLength);
+  argument.string_value[TraceRecord::kMaxStringLength] = '\0';
+}
+
+std::string TraceRingBuffer::ExportChromeJSON() {
+  std::ostringstream stream;
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  auto separate = [&stream, &first]() {
+    if (!first) {
+      stream << ',';
+    }
+    first = false;
+  };
+
+  GetRegistry().VisitBuffers([&](ThreadBuffer& buffer) {
+    const uint64_t end = buffer.end.load(std::memory_order_acquire);
+    const uint64_t capacity = buffer.mask + 1;
+    uint64_t begin = buffer.begin.load(std::memory_order_relaxed);
+    if (end - begin > capacity) {
+      begin = end - capacity;
+    }
+    if (begin == end) {
+      return;
+    }
+
+    separate();
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+           << buffer.thread_id << ",\"args\":{\"name\":";
+    if (buffer.thread_name[0] != '\0') {
+      WriteString(stream, buffer.thread_name);
+    } else {
+      stream << "\"Thread " << buffer.thread_id << '"';
+    }
+    stream << "}}";
+
+    for (uint64_t index = begin; index < end; index++) {
+      const Slot& slot = buffer.slots[index & buffer.mask];
+      if (slot.sequence.load(std::memory_order_acquire) != index * 2 + 2) {
+        continue;
+      }
+      TraceRecord record;
+      ::memcpy(&record, &slot.record, sizeof(record));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != index * 2 + 2) {
+        // Overwritten while it was being copied.
+        continue;
+      }
+      separate();
+      WriteRecord(stream, record, buffer.thread_id);
+    }
+  });
+
+  stream << "],\"displayTimeUnit\":\"ms\"}";
+  return stream.str();
+}
+
+}  // namespace tracing
+}  // namespace fml
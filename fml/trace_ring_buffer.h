@@ -0,0 +1,186 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RING_BUFFER_H_
+#define FLUTTER_FML_TRACE_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "flutter/fml/time/time_point.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+//------------------------------------------------------------------------------
+/// @brief      A trace event recorded in a |TraceRingBuffer|.
+///
+///             Records have a fixed size so that recording never allocates.
+///             Names are not copied and must have static storage duration,
+///             as the string literals passed to the trace macros do. String
+///             argument values are copied and truncated.
+///
+struct TraceRecord {
+  static constexpr size_t kMaxArguments = 4;
+  static constexpr size_t kMaxStringLength = 23;
+
+  enum class ArgumentType : uint8_t {
+    kInt,
+    kDouble,
+    kString,
+  };
+
+  struct Argument {
+    const char* name;
+    ArgumentType type;
+    union {
+      int64_t int_value;
+      double double_value;
+      char string_value[kMaxStringLength + 1];
+    };
+  };
+
+  const char* category;
+  const char* name;
+  int64_t timestamp_micros;
+  int64_t id;
+  Dart_Timeline_Event_Type type;
+  uint8_t argument_count;
+  Argument arguments[kMaxArguments];
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A tracing backend that records trace events into a ring buffer
+///             per thread instead of sending them to the Dart timeline.
+///
+///             Recording an event neither locks nor allocates, and the trace
+///             macros only check a relaxed atomic flag while recording is
+///             disabled. The buffers keep the most recent events of each
+///             thread and can be exported in the Chrome JSON trace format,
+///             which Perfetto and chrome://tracing open.
+///
+class TraceRingBuffer {
+ public:
+  static constexpr size_t kDefaultCapacity = 8192;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts recording trace events into the ring buffers. Each
+  ///             thread that records its first event gets a buffer of
+  ///             |capacity| events, rounded up to a power of two.
+  ///
+  static void Enable(size_t capacity = kDefaultCapacity);
+
+  static void Disable();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops the events recorded so far.
+  ///
+  static void Clear();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Exports the events recorded so far in the Chrome JSON trace
+  ///             format. Can be called while threads are recording, in which
+  ///             case events that are overwritten while being exported are
+  ///             left out.
+  ///
+  static std::string ExportChromeJSON();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Names the current thread in exported traces.
+  ///
+  static void SetCurrentThreadName(const std::string& name);
+
+  static int64_t Now() {
+    return TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  }
+
+  template <typename... Args>
+  static void Record(const char* category,
+                     const char* name,
+                     int64_t timestamp_micros,
+                     int64_t id,
+                     Dart_Timeline_Event_Type type,
+                     const Args&... args) {
+    TraceRecord* record = BeginRecord();
+    record->category = category;
+    record->name = name;
+    record->timestamp_micros = timestamp_micros;
+    record->id = id;
+    record->type = type;
+    record->argument_count = 0;
+    SetArguments(*record, args...);
+    EndRecord();
+  }
+
+  // Records an event with |argument_count| string arguments.
+  static void RecordWithStrings(const char* category,
+                                const char* name,
+                                int64_t timestamp_micros,
+                                int64_t id,
+                                Dart_Timeline_Event_Type type,
+                                intptr_t argument_count,
+                                const char** argument_names,
+                                const char** argument_values);
+
+  static void SetArgument(TraceRecord::Argument& argument, const char* value);
+
+  static void SetArgument(TraceRecord::Argument& argument,
+                          const std::string& value) {
+    SetArgument(argument, value.c_str());
+  }
+
+  static void SetArgument(TraceRecord::Argument& argument, TimePoint value) {
+    argument.type = TraceRecord::ArgumentType::kInt;
+    argument.int_value = value.ToEpochDelta().ToNanoseconds();
+  }
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  static void SetArgument(TraceRecord::Argument& argument, T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+      argument.type = TraceRecord::ArgumentType::kDouble;
+      argument.double_value = value;
+    } else {
+      argument.type = TraceRecord::ArgumentType::kInt;
+      argument.int_value = static_cast<int64_t>(value);
+    }
+  }
+
+ private:
+  static std::atomic<bool> enabled_;
+
+  // Returns the next record of the buffer of the current thread. Must be
+  // followed by |EndRecord| once the record is written.
+  static TraceRecord* BeginRecord();
+
+  static void EndRecord();
+
+  static void SetArguments(TraceRecord& record) {}
+
+  template <typename Key, typename Value, typename... Args>
+  static void SetArguments(TraceRecord& record,
+                           const Key& key,
+                           const Value& value,
+                           const Args&... args) {
+    if (record.argument_count == TraceRecord::kMaxArguments) {
+      return;
+    }
+    TraceRecord::Argument& argument =
+        record.arguments[record.argument_count++];
+    argument.name = key;
+    SetArgument(argument, value);
+    SetArguments(record, args...);
+  }
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RING_BUFFER_H_
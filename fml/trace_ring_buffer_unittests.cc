@@ -0,0 +1,129 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_ring_buffer.h"
+
+#include <string>
+#include <thread>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+namespace {
+
+// Records into the ring buffers for the duration of a test.
+class ScopedRingBufferTracing {
+ public:
+  explicit ScopedRingBufferTracing(
+      size_t capacity = TraceRingBuffer::kDefaultCapacity) {
+    TraceRingBuffer::Clear();
+    TraceRingBuffer::Enable(capacity);
+  }
+
+  ~ScopedRingBufferTracing() {
+    TraceRingBuffer::Disable();
+    TraceRingBuffer::Clear();
+  }
+};
+
+bool Contains(const std::string& string, const std::string& substring) {
+  return string.find(substring) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(TraceRingBufferTest, RecordsNothingWhileDisabled) {
+  TraceRingBuffer::Clear();
+  { TRACE_EVENT0("flutter", "RingBufferDisabledEvent"); }
+  ASSERT_FALSE(Contains(TraceRingBuffer::ExportChromeJSON(),
+                        "RingBufferDisabledEvent"));
+}
+
+TEST(TraceRingBufferTest, RecordsEventsAndArguments) {
+  ScopedRingBufferTracing tracing;
+  {
+    FML_TRACE_EVENT("flutter", "RingBufferEvent", "int", 3, "string",
+                    std::string("a \"quote\""), "double", 0.5);
+    TRACE_EVENT_INSTANT1("flutter", "RingBufferInstant", "key", "value");
+    FML_TRACE_COUNTER("flutter", "RingBufferCounter", 7, "count", 42);
+  }
+  TRACE_EVENT_ASYNC_BEGIN0("flutter", "RingBufferAsync", 11);
+  TRACE_EVENT_ASYNC_END0("flutter", "RingBufferAsync", 11);
+
+  const std::string json = TraceRingBuffer::ExportChromeJSON();
+  EXPECT_TRUE(Contains(json, "{\"traceEvents\":["));
+  EXPECT_TRUE(Contains(json, "\"name\":\"RingBufferEvent\",\"cat\":\"flutter\","
+                             "\"ph\":\"B\""));
+  EXPECT_TRUE(Contains(
+      json,
+      "\"args\":{\"int\":3,\"string\":\"a \\\"quote\\\"\",\"double\":0.5}"));
+  EXPECT_TRUE(Contains(json, "\"name\":\"RingBufferEvent\",\"cat\":\"flutter\","
+                             "\"ph\":\"E\""));
+  EXPECT_TRUE(Contains(json, "\"s\":\"t\",\"args\":{\"key\":\"value\"}"));
+  EXPECT_TRUE(Contains(json, "\"id\":7,\"args\":{\"count\":42}"));
+  EXPECT_TRUE(Contains(json, "\"ph\":\"b\""));
+  EXPECT_TRUE(Contains(json, "\"ph\":\"e\""));
+  EXPECT_TRUE(Contains(json, "\"id\":11"));
+
+  TraceRingBuffer::Clear();
+  EXPECT_FALSE(
+      Contains(TraceRingBuffer::ExportChromeJSON(), "RingBufferEvent"));
+}
+
+TEST(TraceRingBufferTest, TruncatesStringArguments) {
+  ScopedRingBufferTracing tracing;
+  const std::string value(100, 'x');
+  FML_TRACE_EVENT("flutter", "RingBufferLongString", "value", value);
+  TRACE_EVENT0("flutter", "RingBufferLongStringEnd");
+
+  const std::string json = TraceRingBuffer::ExportChromeJSON();
+  const std::string truncated(TraceRecord::kMaxStringLength, 'x');
+  EXPECT_TRUE(Contains(json, "\"value\":\"" + truncated + "\""));
+}
+
+TEST(TraceRingBufferTest, KeepsTheMostRecentEventsOfEachThread) {
+  ScopedRingBufferTracing tracing(4);
+  std::thread thread([]() {
+    for (int i = 0; i < 10; i++) {
+      TRACE_EVENT_INSTANT1("flutter", "RingBufferWrap", "index",
+                           std::to_string(i).c_str());
+    }
+  });
+  thread.join();
+
+  const std::string json = TraceRingBuffer::ExportChromeJSON();
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FALSE(Contains(json, "{\"index\":\"" + std::to_string(i) + "\"}"));
+  }
+  for (int i = 6; i < 10; i++) {
+    EXPECT_TRUE(Contains(json, "{\"index\":\"" + std::to_string(i) + "\"}"));
+  }
+}
+
+TEST(TraceRingBufferTest, NamesThreads) {
+  ScopedRingBufferTracing tracing;
+  {
+    fml::Thread thread("ring_buffer_thread");
+    fml::AutoResetWaitableEvent latch;
+    thread.GetTaskRunner()->PostTask([&latch]() {
+      TRACE_EVENT_INSTANT0("flutter", "RingBufferThreadEvent");
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+
+  const std::string json = TraceRingBuffer::ExportChromeJSON();
+  EXPECT_TRUE(Contains(json, "\"args\":{\"name\":\"ring_buffer_thread\"}"));
+  EXPECT_TRUE(Contains(json, "RingBufferThreadEvent"));
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
@@ -0,0 +1,156 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_UNIQUE_CLOSURE_H_
+#define FLUTTER_FML_UNIQUE_CLOSURE_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      A move-only `void()` callable for tasks.
+///
+///             Unlike `fml::closure`, the callable is never copied, so
+///             callables that can't be copied can be used without
+///             `fml::MakeCopyable`. A callable of up to |kInlineSize| bytes
+///             whose move constructor does not throw is stored inline instead
+///             of on the heap, which covers the captures of most tasks.
+///
+class UniqueClosure {
+ public:
+  static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+  UniqueClosure() = default;
+
+  UniqueClosure(std::nullptr_t) {}
+
+  template <typename Callable,
+            typename Stored = std::decay_t<Callable>,
+            typename = std::enable_if_t<
+                !std::is_same_v<Stored, UniqueClosure> &&
+                std::is_invocable_r_v<void, Stored&>>>
+  UniqueClosure(Callable&& callable) {
+    if (IsNull(callable)) {
+      return;
+    }
+    if constexpr (IsStoredInline<Stored>()) {
+      new (storage_) Stored(std::forward<Callable>(callable));
+      ops_ = &kInlineOps<Stored>;
+    } else {
+      new (storage_) Stored*(new Stored(std::forward<Callable>(callable)));
+      ops_ = &kHeapOps<Stored>;
+    }
+  }
+
+  UniqueClosure(UniqueClosure&& other) noexcept : ops_(other.ops_) {
+    if (ops_) {
+      ops_->move(other.storage_, storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  UniqueClosure& operator=(UniqueClosure&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      if (other.ops_) {
+        other.ops_->move(other.storage_, storage_);
+        ops_ = std::exchange(other.ops_, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  UniqueClosure& operator=(std::nullptr_t) {
+    Reset();
+    return *this;
+  }
+
+  ~UniqueClosure() { Reset(); }
+
+  void operator()() const {
+    FML_DCHECK(ops_);
+    ops_->invoke(storage_);
+  }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  bool operator==(std::nullptr_t) const { return ops_ == nullptr; }
+
+  bool operator!=(std::nullptr_t) const { return ops_ != nullptr; }
+
+  // Whether the callable is stored inline, for tests.
+  bool IsInline() const { return ops_ && ops_->is_inline; }
+
+ private:
+  struct Ops {
+    void (*invoke)(void* storage);
+    // Move constructs the callable at |to| and destroys the one at |from|.
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+    bool is_inline;
+  };
+
+  template <typename Stored>
+  static constexpr bool IsStoredInline() {
+    return sizeof(Stored) <= kInlineSize &&
+           alignof(Stored) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Stored>;
+  }
+
+  template <typename Stored>
+  static constexpr Ops kInlineOps = {
+      [](void* storage) { (*static_cast<Stored*>(storage))(); },
+      [](void* from, void* to) {
+        new (to) Stored(std::move(*static_cast<Stored*>(from)));
+        static_cast<Stored*>(from)->~Stored();
+      },
+      [](void* storage) { static_cast<Stored*>(storage)->~Stored(); },
+      true,
+  };
+
+  template <typename Stored>
+  static constexpr Ops kHeapOps = {
+      [](void* storage) { (**static_cast<Stored**>(storage))(); },
+      [](void* from, void* to) {
+        new (to) Stored*(*static_cast<Stored**>(from));
+      },
+      [](void* storage) { delete *static_cast<Stored**>(storage); },
+      false,
+  };
+
+  template <typename Callable>
+  static bool IsNull(const Callable& callable) {
+    // Function pointers and wrappers like `fml::closure` may be empty.
+    if constexpr (std::is_pointer_v<Callable> ||
+                  std::is_convertible_v<std::nullptr_t, Callable>) {
+      return callable == nullptr;
+    } else {
+      return false;
+    }
+  }
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) mutable unsigned char storage_[kInlineSize];
+  const Ops* ops_ = nullptr;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(UniqueClosure);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_UNIQUE_CLOSURE_H_
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/unique_closure.h"
+
+#include <array>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(UniqueClosureTest, EmptyClosuresAreNull) {
+  UniqueClosure closure;
+  ASSERT_FALSE(closure);
+  ASSERT_TRUE(closure == nullptr);
+
+  UniqueClosure from_empty_function = fml::closure();
+  ASSERT_FALSE(from_empty_function);
+
+  void (*function)() = nullptr;
+  UniqueClosure from_null_pointer = function;
+  ASSERT_FALSE(from_null_pointer);
+}
+
+TEST(UniqueClosureTest, SmallCallablesAreStoredInline) {
+  int count = 0;
+  UniqueClosure closure = [&count]() { count++; };
+  ASSERT_TRUE(closure.IsInline());
+  closure();
+  closure();
+  ASSERT_EQ(count, 2);
+
+  UniqueClosure from_function = fml::closure([&count]() { count++; });
+  ASSERT_TRUE(from_function.IsInline());
+  from_function();
+  ASSERT_EQ(count, 3);
+}
+
+TEST(UniqueClosureTest, LargeCallablesAreStoredOnTheHeap) {
+  std::array<char, UniqueClosure::kInlineSize + 1> data = {};
+  int count = 0;
+  UniqueClosure closure = [data, &count]() { count += data[0] + 1; };
+  ASSERT_FALSE(closure.IsInline());
+  UniqueClosure moved = std::move(closure);
+  ASSERT_FALSE(closure);
+  moved();
+  ASSERT_EQ(count, 1);
+}
+
+TEST(UniqueClosureTest, HoldsMoveOnlyCallables) {
+  auto value = std::make_unique<int>(1);
+  int* pointer = value.get();
+  int result = 0;
+  UniqueClosure closure = [value = std::move(value), &result]() {
+    result = *value;
+  };
+  ASSERT_TRUE(closure.IsInline());
+
+  UniqueClosure moved;
+  moved = std::move(closure);
+  ASSERT_FALSE(closure);
+  moved();
+  ASSERT_EQ(result, 1);
+  ASSERT_EQ(*pointer, 1);
+}
+
+TEST(UniqueClosureTest, DestroysTheCallable) {
+  auto shared = std::make_shared<int>(0);
+  std::weak_ptr<int> weak = shared;
+  {
+    UniqueClosure closure = [shared = std::move(shared)]() {};
+    UniqueClosure moved = std::move(closure);
+    ASSERT_FALSE(weak.expired());
+    moved = nullptr;
+    ASSERT_TRUE(weak.expired());
+  }
+
+  std::array<char, UniqueClosure::kInlineSize> data = {};
+  shared = std::make_shared<int>(0);
+  weak = shared;
+  {
+    UniqueClosure closure = [shared = std::move(shared), data]() {};
+    ASSERT_FALSE(closure.IsInline());
+    ASSERT_FALSE(weak.expired());
+  }
+  ASSERT_TRUE(weak.expired());
+}
+
+}  // namespace testing
+}  // namespace fml
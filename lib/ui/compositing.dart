@@ -281,6 +281,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushTransform(engineLayer, matrix4);
     final TransformEngineLayer layer = TransformEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -305,6 +306,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushOffset(engineLayer, dx, dy);
     final OffsetEngineLayer layer = OffsetEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -332,6 +334,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushClipRect(engineLayer, rect.left, rect.right, rect.top, rect.bottom, clipBehavior.index);
     final ClipRectEngineLayer layer = ClipRectEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -360,6 +363,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushClipRRect(engineLayer, rrect._value32, clipBehavior.index);
     final ClipRRectEngineLayer layer = ClipRRectEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -388,6 +392,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushClipPath(engineLayer, path, clipBehavior.index);
     final ClipPathEngineLayer layer = ClipPathEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -415,6 +420,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushOpacity(engineLayer, alpha, offset!.dx, offset.dy);
     final OpacityEngineLayer layer = OpacityEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -442,6 +448,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushColorFilter(engineLayer, nativeFilter);
     final ColorFilterEngineLayer layer = ColorFilterEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -469,6 +476,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushImageFilter(engineLayer, nativeFilter);
     final ImageFilterEngineLayer layer = ImageFilterEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -493,6 +501,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
     final EngineLayer engineLayer = EngineLayer._();
     _pushBackdropFilter(engineLayer, filter._toNativeImageFilter());
     final BackdropFilterEngineLayer layer = BackdropFilterEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -527,6 +536,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
       blendMode.index,
     );
     final ShaderMaskEngineLayer layer = ShaderMaskEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -576,6 +586,7 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
       clipBehavior.index,
     );
     final PhysicalShapeEngineLayer layer = PhysicalShapeEngineLayer._(engineLayer);
+    _retainOldLayer(oldLayer);
     assert(_debugPushLayer(layer));
     return layer;
   }
@@ -598,6 +609,16 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
 
   void _pop() native 'SceneBuilder_pop';
 
+  // Lets the engine keep the layer of [oldLayer] in place of the one just
+  // pushed if it turns out to paint the same once it is popped.
+  void _retainOldLayer(_EngineLayerWrapper? oldLayer) {
+    if (oldLayer != null) {
+      _setOldLayer(oldLayer._nativeLayer);
+    }
+  }
+
+  void _setOldLayer(EngineLayer oldLayer) native 'SceneBuilder_setOldLayer';
+
   /// Add a retained engine layer subtree from previous frames.
   ///
   /// All the engine layers that are in the subtree of the retained layer will
@@ -28,16 +28,18 @@ DART_BIND_ALL(Scene, FOR_EACH_BINDING)
 
 void Scene::create(Dart_Handle scene_handle,
                    std::shared_ptr<flutter::Layer> rootLayer,
+                   std::shared_ptr<flutter::LayerArena> arena,
                    uint32_t rasterizerTracingThreshold,
                    bool checkerboardRasterCacheImages,
                    bool checkerboardOffscreenLayers) {
   auto scene = fml::MakeRefCounted<Scene>(
-      std::move(rootLayer), rasterizerTracingThreshold,
+      std::move(rootLayer), std::move(arena), rasterizerTracingThreshold,
       checkerboardRasterCacheImages, checkerboardOffscreenLayers);
   scene->AssociateWithDartWrapper(scene_handle);
 }
 
 Scene::Scene(std::shared_ptr<flutter::Layer> rootLayer,
+             std::shared_ptr<flutter::LayerArena> arena,
              uint32_t rasterizerTracingThreshold,
              bool checkerboardRasterCacheImages,
              bool checkerboardOffscreenLayers) {
@@ -49,6 +51,7 @@ Scene::Scene(std::shared_ptr<flutter::Layer> rootLayer,
       static_cast<float>(viewport_metrics.physical_depth),
       static_cast<float>(viewport_metrics.device_pixel_ratio));
   layer_tree_->set_root_layer(std::move(rootLayer));
+  layer_tree_->set_arena(std::move(arena));
   layer_tree_->set_rasterizer_tracing_threshold(rasterizerTracingThreshold);
   layer_tree_->set_checkerboard_raster_cache_images(
       checkerboardRasterCacheImages);
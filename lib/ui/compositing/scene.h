@@ -26,6 +26,7 @@ class Scene : public RefCountedDartWrappable<Scene> {
   ~Scene() override;
   static void create(Dart_Handle scene_handle,
                      std::shared_ptr<flutter::Layer> rootLayer,
+                     std::shared_ptr<flutter::LayerArena> arena,
                      uint32_t rasterizerTracingThreshold,
                      bool checkerboardRasterCacheImages,
                      bool checkerboardOffscreenLayers);
@@ -42,6 +43,7 @@ class Scene : public RefCountedDartWrappable<Scene> {
 
  private:
   explicit Scene(std::shared_ptr<flutter::Layer> rootLayer,
+                 std::shared_ptr<flutter::LayerArena> arena,
                  uint32_t rasterizerTracingThreshold,
                  bool checkerboardRasterCacheImages,
                  bool checkerboardOffscreenLayers);
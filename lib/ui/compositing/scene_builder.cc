@@ -58,6 +58,7 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, SceneBuilder);
   V(SceneBuilder, pop)                              \
   V(SceneBuilder, addPlatformView)                  \
   V(SceneBuilder, addRetained)                      \
+  V(SceneBuilder, setOldLayer)                      \
   V(SceneBuilder, addPicture)                       \
   V(SceneBuilder, addTexture)                       \
   V(SceneBuilder, addPerformanceOverlay)            \
@@ -81,10 +82,10 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
   });
 }
 
-SceneBuilder::SceneBuilder() {
+SceneBuilder::SceneBuilder() : arena_(LayerArena::Create()) {
   // Add a ContainerLayer as the root layer, so that AddLayer operations are
   // always valid.
-  PushLayer(std::make_shared<flutter::ContainerLayer>());
+  layer_stack_.push_back({arena_->Make<flutter::ContainerLayer>()});
 }
 
 SceneBuilder::~SceneBuilder() = default;
@@ -93,17 +94,15 @@ void SceneBuilder::pushTransform(Dart_Handle layer_handle,
                                  tonic::Float64List& matrix4) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
   auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushOffset(Dart_Handle layer_handle, double dx, double dy) {
   SkMatrix sk_matrix = SkMatrix::Translate(dx, dy);
   auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
@@ -116,8 +115,7 @@ void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   auto layer =
       std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
@@ -126,8 +124,7 @@ void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   auto layer =
       std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
@@ -137,8 +134,7 @@ void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
   FML_DCHECK(clip_behavior != flutter::Clip::none);
   auto layer =
       std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer, path->path().approximateBytesUsed());
 }
 
 void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
@@ -147,31 +143,27 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
                                double dy) {
   auto layer =
       std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
                                    const ColorFilter* color_filter) {
   auto layer =
       std::make_shared<flutter::ColorFilterLayer>(color_filter->filter());
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushImageFilter(Dart_Handle layer_handle,
                                    const ImageFilter* image_filter) {
   auto layer =
       std::make_shared<flutter::ImageFilterLayer>(image_filter->filter());
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushBackdropFilter(Dart_Handle layer_handle,
                                       ImageFilter* filter) {
   auto layer = std::make_shared<flutter::BackdropFilterLayer>(filter->filter());
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
@@ -185,8 +177,7 @@ void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
                                  maskRectBottom);
   auto layer = std::make_shared<flutter::ShaderMaskLayer>(
       shader->shader(), rect, static_cast<SkBlendMode>(blendMode));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer);
 }
 
 void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
@@ -197,14 +188,22 @@ void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
                                      int clipBehavior) {
   auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
       static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
-      static_cast<float>(elevation), path->path(),
+      static_cast<float>(elevation), path->GetInternedPath(),
       static_cast<flutter::Clip>(clipBehavior));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
+  PushLayer(layer_handle, layer, path->path().approximateBytesUsed());
 }
 
 void SceneBuilder::addRetained(fml::RefPtr<EngineLayer> retainedLayer) {
-  AddLayer(retainedLayer->Layer());
+  // The retained layer is reported by its own EngineLayer.
+  AddLayer(retainedLayer->Layer(), 0);
+}
+
+void SceneBuilder::setOldLayer(fml::RefPtr<EngineLayer> oldLayer) {
+  if (!UIDartState::Current()->IsLayerRetentionEnabled() ||
+      layer_stack_.size() <= 1) {
+    return;
+  }
+  layer_stack_.back().old_layer = oldLayer->Layer();
 }
 
 void SceneBuilder::pop() {
@@ -216,12 +215,19 @@ void SceneBuilder::addPicture(double dx,
                               Picture* picture,
                               int hints) {
   SkPoint offset = SkPoint::Make(dx, dy);
+  if (auto display_list = picture->display_list()) {
+    auto layer = arena_->Make<flutter::PictureLayer>(
+        offset, UIDartState::CreateGPUObject(std::move(display_list)),
+        !!(hints & 1), !!(hints & 2));
+    AddLayer(std::move(layer), picture->GetAllocationSize());
+    return;
+  }
   SkRect pictureRect = picture->picture()->cullRect();
   pictureRect.offset(offset.x(), offset.y());
-  auto layer = std::make_unique<flutter::PictureLayer>(
+  auto layer = arena_->Make<flutter::PictureLayer>(
       offset, UIDartState::CreateGPUObject(picture->picture()), !!(hints & 1),
       !!(hints & 2));
-  AddLayer(std::move(layer));
+  AddLayer(std::move(layer), picture->GetAllocationSize());
 }
 
 void SceneBuilder::addTexture(double dx,
@@ -231,10 +237,10 @@ void SceneBuilder::addTexture(double dx,
                               int64_t textureId,
                               bool freeze,
                               int filterQuality) {
-  auto layer = std::make_unique<flutter::TextureLayer>(
+  auto layer = arena_->Make<flutter::TextureLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), textureId, freeze,
       static_cast<SkFilterQuality>(filterQuality));
-  AddLayer(std::move(layer));
+  AddLayer(std::move(layer), sizeof(flutter::TextureLayer));
 }
 
 void SceneBuilder::addPlatformView(double dx,
@@ -242,9 +248,9 @@ void SceneBuilder::addPlatformView(double dx,
                                    double width,
                                    double height,
                                    int64_t viewId) {
-  auto layer = std::make_unique<flutter::PlatformViewLayer>(
+  auto layer = arena_->Make<flutter::PlatformViewLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), viewId);
-  AddLayer(std::move(layer));
+  AddLayer(std::move(layer), sizeof(flutter::PlatformViewLayer));
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
@@ -254,10 +260,10 @@ void SceneBuilder::addChildScene(double dx,
                                  double height,
                                  SceneHost* sceneHost,
                                  bool hitTestable) {
-  auto layer = std::make_unique<flutter::ChildSceneLayer>(
+  auto layer = arena_->Make<flutter::ChildSceneLayer>(
       sceneHost->id(), SkPoint::Make(dx, dy), SkSize::Make(width, height),
       hitTestable);
-  AddLayer(std::move(layer));
+  AddLayer(std::move(layer), sizeof(flutter::ChildSceneLayer));
 }
 #endif
 
@@ -268,9 +274,9 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
                                          double bottom) {
   SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
   auto layer =
-      std::make_unique<flutter::PerformanceOverlayLayer>(enabledOptions);
+      arena_->Make<flutter::PerformanceOverlayLayer>(enabledOptions);
   layer->set_paint_bounds(rect);
-  AddLayer(std::move(layer));
+  AddLayer(std::move(layer), sizeof(flutter::PerformanceOverlayLayer));
 }
 
 void SceneBuilder::setRasterizerTracingThreshold(uint32_t frameInterval) {
@@ -288,30 +294,63 @@ void SceneBuilder::setCheckerboardOffscreenLayers(bool checkerboard) {
 void SceneBuilder::build(Dart_Handle scene_handle) {
   FML_DCHECK(layer_stack_.size() >= 1);
 
-  Scene::create(scene_handle, layer_stack_[0], rasterizer_tracing_threshold_,
+  // Attaches the layers that were pushed but never popped.
+  while (layer_stack_.size() > 1) {
+    PopLayer();
+  }
+
+  Scene::create(scene_handle, layer_stack_[0].layer, arena_,
+                rasterizer_tracing_threshold_,
                 checkerboard_raster_cache_images_,
                 checkerboard_offscreen_layers_);
   ClearDartWrapper();  // may delete this object.
 }
 
-void SceneBuilder::AddLayer(std::shared_ptr<Layer> layer) {
+void SceneBuilder::AddLayer(std::shared_ptr<Layer> layer,
+                            size_t retained_bytes) {
   FML_DCHECK(layer);
 
   if (!layer_stack_.empty()) {
-    layer_stack_.back()->Add(std::move(layer));
+    layer_stack_.back().layer->Add(std::move(layer));
+    layer_stack_.back().retained_bytes += retained_bytes;
   }
 }
 
-void SceneBuilder::PushLayer(std::shared_ptr<ContainerLayer> layer) {
-  AddLayer(layer);
-  layer_stack_.push_back(std::move(layer));
+// The layer is only added to its parent once it is popped and all of its
+// children are known.
+void SceneBuilder::PushLayer(Dart_Handle layer_handle,
+                             std::shared_ptr<ContainerLayer> layer,
+                             size_t extra_bytes) {
+  auto engine_layer = EngineLayer::MakeRetained(layer);
+  engine_layer->AssociateWithDartWrapper(layer_handle);
+  layer_stack_.push_back({std::move(layer), std::move(engine_layer), nullptr,
+                          sizeof(ContainerLayer) + extra_bytes});
 }
 
 void SceneBuilder::PopLayer() {
   // We never pop the root layer, so that AddLayer operations are always valid.
-  if (layer_stack_.size() > 1) {
-    layer_stack_.pop_back();
+  if (layer_stack_.size() <= 1) {
+    return;
   }
+  PushedLayer pushed = std::move(layer_stack_.back());
+  layer_stack_.pop_back();
+  std::shared_ptr<ContainerLayer> layer = std::move(pushed.layer);
+
+  // The old layer paints the same if the content hashes match, which the
+  // animator also relies on to skip frames. Keeping it preserves the unique id
+  // that its raster cache entries are keyed by, and the layers don't change
+  // once built, so it can be shared with the previous frame.
+  if (pushed.old_layer) {
+    std::optional<uint64_t> hash = layer->GetContentHash();
+    if (hash && hash == pushed.old_layer->GetContentHash()) {
+      layer = std::move(pushed.old_layer);
+      pushed.engine_layer->SetLayer(layer);
+    }
+  }
+
+  // The pushed layers below this one report their own memory.
+  pushed.engine_layer->SetRetainedBytes(pushed.retained_bytes);
+  AddLayer(std::move(layer), 0);
 }
 
 }  // namespace flutter
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/color_filter.h"
@@ -77,6 +78,10 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
 
   void addRetained(fml::RefPtr<EngineLayer> retainedLayer);
 
+  // Offers |oldLayer| to replace the layer that was just pushed once it is
+  // popped, see |PopLayer|.
+  void setOldLayer(fml::RefPtr<EngineLayer> oldLayer);
+
   void pop();
 
   void addPerformanceOverlay(uint64_t enabledOptions,
@@ -121,11 +126,34 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
  private:
   SceneBuilder();
 
-  void AddLayer(std::shared_ptr<Layer> layer);
-  void PushLayer(std::shared_ptr<ContainerLayer> layer);
+  // Adds |layer| to the layer on top of the stack. |retained_bytes| is the
+  // memory it holds that isn't reported by an EngineLayer of its own.
+  void AddLayer(std::shared_ptr<Layer> layer, size_t retained_bytes);
+  // Pushes |layer| and associates it with the EngineLayer |layer_handle|.
+  // |extra_bytes| is the memory the layer holds beyond the layer object, like
+  // the path it clips to.
+  void PushLayer(Dart_Handle layer_handle,
+                 std::shared_ptr<ContainerLayer> layer,
+                 size_t extra_bytes = 0);
   void PopLayer();
 
-  std::vector<std::shared_ptr<ContainerLayer>> layer_stack_;
+  // A layer that was pushed and not popped yet.
+  struct PushedLayer {
+    std::shared_ptr<ContainerLayer> layer;
+    // The Dart object returned for the layer, null for the root layer.
+    fml::RefPtr<EngineLayer> engine_layer;
+    // The layer of a previous frame that was passed as the oldLayer of this
+    // one, if it may be retained in its place.
+    std::shared_ptr<ContainerLayer> old_layer;
+    // The memory held by the layer and the children that don't report their
+    // own, which is reported to the garbage collector for |engine_layer|.
+    size_t retained_bytes = 0;
+  };
+
+  // Backs the layers of this frame that can't be retained by the framework.
+  // Layers returned to Dart as EngineLayers stay on the heap.
+  std::shared_ptr<LayerArena> arena_;
+  std::vector<PushedLayer> layer_stack_;
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
   bool checkerboard_offscreen_layers_ = false;
@@ -18,6 +18,7 @@
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/image_filter.h"
 #include "flutter/lib/ui/painting/image_shader.h"
+#include "flutter/lib/ui/painting/image_stream_decoder.h"
 #include "flutter/lib/ui/painting/path.h"
 #include "flutter/lib/ui/painting/path_measure.h"
 #include "flutter/lib/ui/painting/picture.h"
@@ -71,6 +72,7 @@ void DartUI::InitForGlobal() {
     FrameInfo::RegisterNatives(g_natives);
     ImageFilter::RegisterNatives(g_natives);
     ImageShader::RegisterNatives(g_natives);
+    ImageStreamDecoder::RegisterNatives(g_natives);
     IsolateNameServerNatives::RegisterNatives(g_natives);
     Paragraph::RegisterNatives(g_natives);
     ParagraphBuilder::RegisterNatives(g_natives);
@@ -88,10 +90,18 @@ void DartUI::InitForGlobal() {
   }
 }
 
-void DartUI::InitForIsolate() {
+void DartUI::InitForIsolate(bool enable_canvas_command_buffer) {
   FML_DCHECK(g_natives);
-  Dart_Handle result = Dart_SetNativeResolver(
-      Dart_LookupLibrary(ToDart("dart:ui")), GetNativeFunction, GetSymbol);
+  Dart_Handle library = Dart_LookupLibrary(ToDart("dart:ui"));
+  Dart_Handle result =
+      Dart_SetNativeResolver(library, GetNativeFunction, GetSymbol);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+
+  result = Dart_SetField(
+      library, ToDart("_canvasCommandBufferEnabled"),
+      enable_canvas_command_buffer ? Dart_True() : Dart_False());
   if (Dart_IsError(result)) {
     Dart_PropagateError(result);
   }
@@ -12,7 +12,7 @@ namespace flutter {
 class DartUI {
  public:
   static void InitForGlobal();
-  static void InitForIsolate();
+  static void InitForIsolate(bool enable_canvas_command_buffer);
 
  private:
   FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DartUI);
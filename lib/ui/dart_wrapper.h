@@ -5,6 +5,10 @@
 #ifndef FLUTTER_LIB_UI_DART_WRAPPER_H_
 #define FLUTTER_LIB_UI_DART_WRAPPER_H_
 
+#include <cstddef>
+#include <new>
+
+#include "flutter/fml/memory/object_pool.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "third_party/tonic/dart_wrappable.h"
 
@@ -23,6 +27,57 @@ class RefCountedDartWrappable : public fml::RefCountedThreadSafe<T>,
   }
 };
 
+// The storage of a pooled |RefCountedDartWrappable|, see
+// |DEFINE_POOLED_ALLOCATION|. It is left uninitialized until the object is
+// constructed in it.
+template <size_t size, size_t alignment>
+struct PooledWrappableStorage {
+  PooledWrappableStorage() {}
+
+  alignas(alignment) unsigned char bytes[size];
+};
+
+template <typename T>
+using PooledWrappableStorageFor = PooledWrappableStorage<sizeof(T), alignof(T)>;
+
+template <typename T>
+fml::ObjectPool<PooledWrappableStorageFor<T>>& GetPooledWrappablePool() {
+  // Never destroyed, as wrappers can be finalized after exit handlers ran.
+  static auto* pool = new fml::ObjectPool<PooledWrappableStorageFor<T>>(256);
+  return *pool;
+}
+
+// Allocates the objects of a |RefCountedDartWrappable| from a pool instead of
+// the system allocator. For natives that Dart code creates thousands of every
+// frame, such as layers and paths, whose allocation and deallocation would
+// otherwise be a good part of their cost. Objects of subclasses are allocated
+// as usual.
+#define DEFINE_POOLED_ALLOCATION()                         \
+ public:                                                   \
+  static void* operator new(size_t size);                  \
+  static void operator delete(void* pointer, size_t size); \
+                                                           \
+ private:                                                  \
+  static constexpr bool kPooledAllocation = true
+
+#define IMPLEMENT_POOLED_ALLOCATION(ClassName)                          \
+  void* ClassName::operator new(size_t size) {                          \
+    if (size != sizeof(ClassName)) {                                    \
+      return ::operator new(size);                                      \
+    }                                                                   \
+    return flutter::GetPooledWrappablePool<ClassName>().Acquire();     \
+  }                                                                     \
+                                                                        \
+  void ClassName::operator delete(void* pointer, size_t size) {         \
+    if (size != sizeof(ClassName)) {                                    \
+      ::operator delete(pointer);                                       \
+      return;                                                           \
+    }                                                                   \
+    flutter::GetPooledWrappablePool<ClassName>().Release(               \
+        static_cast<flutter::PooledWrappableStorageFor<ClassName>*>(    \
+            pointer));                                                  \
+  }
+
 }  // namespace flutter
 
 #endif  // FLUTTER_LIB_UI_DART_WRAPPER_H_
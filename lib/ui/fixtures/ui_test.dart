@@ -36,15 +36,97 @@ void createVertices() {
 }
 void _validateVertices(Vertices vertices) native 'ValidateVertices';
 
+@pragma('vm:entry-point')
+void createBufferVertices() {
+  final Vertices vertices = Vertices.buffers(VertexMode.triangles, 3, hasColors: true);
+  final Float32List positions = vertices.positionBuffer!;
+  // The buffers start out filled with zeros.
+  final double initialCoordinate = positions[2];
+  positions[2] = 100.0;
+  positions[4] = 50.0;
+  positions[5] = 80.0;
+  vertices.colorBuffer!.fillRange(0, 3, const Color(0xFFFF0000).value);
+  vertices.update();
+  _validateBufferVertices(
+    vertices,
+    initialCoordinate == 0.0 && vertices.textureCoordinateBuffer == null,
+  );
+}
+void _validateBufferVertices(Vertices vertices, bool buffersWereAllocated) native 'ValidateBufferVertices';
+
 @pragma('vm:entry-point')
 void frameCallback(FrameInfo info) {
   print('called back');
 }
 
+@pragma('vm:entry-point')
+void frameCallbackNotifiesNative(FrameInfo info) {
+  _notifyFrame(info != null);
+}
+void _notifyFrame(bool decoded) native 'NotifyFrame';
+
 @pragma('vm:entry-point')
 void messageCallback(dynamic data) {
 }
 
+@pragma('vm:entry-point')
+void recordCanvasCommands() {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint paint = Paint()..color = const Color(0xFF00FF00);
+  final Paint shaded = Paint()
+    ..shader = Gradient.linear(
+      Offset.zero,
+      const Offset(10.0, 10.0),
+      <Color>[const Color(0xFF000000), const Color(0xFFFFFFFF)],
+    );
+  const Rect rect = Rect.fromLTRB(0.0, 0.0, 10.0, 10.0);
+  final RRect rrect = RRect.fromRectAndRadius(rect, const Radius.circular(2.0));
+
+  canvas.save();
+  canvas.translate(10.0, 10.0);
+  canvas.scale(2.0);
+  canvas.rotate(0.5);
+  canvas.skew(0.1, 0.1);
+  canvas.clipRect(const Rect.fromLTRB(0.0, 0.0, 100.0, 100.0));
+  canvas.clipRRect(rrect);
+  canvas.drawColor(const Color(0xFF0000FF), BlendMode.srcOver);
+  canvas.drawLine(Offset.zero, const Offset(10.0, 10.0), paint);
+  canvas.drawPaint(paint);
+  canvas.drawRect(rect, shaded);
+  canvas.drawRRect(rrect, paint);
+  canvas.drawOval(rect, shaded);
+  canvas.drawCircle(const Offset(5.0, 5.0), 5.0, paint);
+  final int nestedSaveCount = canvas.getSaveCount();
+  // Paths aren't recorded, so this replays the commands before it.
+  canvas.drawPath(Path()..addRect(rect), paint);
+  canvas.restore();
+  _validateCanvasCommands(nestedSaveCount, canvas.getSaveCount(), recorder.endRecording());
+}
+void _validateCanvasCommands(int nestedSaveCount, int saveCount, Picture picture) native 'ValidateCanvasCommands';
+
+@pragma('vm:entry-point')
+void recordRects(int count) {
+  final PictureRecorder recorder = PictureRecorder();
+  final Canvas canvas = Canvas(recorder);
+  final Paint paint = Paint()..color = const Color(0xFF00FF00);
+  for (int i = 0; i < count; i++) {
+    canvas.save();
+    canvas.translate(i.toDouble(), 0.0);
+    canvas.drawRect(const Rect.fromLTRB(0.0, 0.0, 10.0, 10.0), paint);
+    canvas.restore();
+  }
+  recorder.endRecording();
+}
+
+@pragma('vm:entry-point')
+void buildPath(int count) {
+  final Path path = Path();
+  for (int i = 0; i < count; i++) {
+    path.lineTo(i.toDouble(), 1.0);
+  }
+}
+
 
 // Draw a circle on a Canvas that has a PictureRecorder. Take the image from
 // the PictureRecorder, and encode it as png. Check that the png data is
@@ -65,3 +147,54 @@ Future<void> encodeImageProducesExternalUint8List() async {
 void _encodeImage(Image i, int format, void Function(Uint8List result))
   native 'EncodeImage';
 void _validateExternal(Uint8List result) native 'ValidateExternal';
+
+// Encode a large image both at once and as a stream, and check that the
+// streamed chunks add up to the same bytes.
+@pragma('vm:entry-point')
+Future<void> encodeImageAsStream() async {
+  final PictureRecorder pictureRecorder = PictureRecorder();
+  final Canvas canvas = Canvas(pictureRecorder);
+  for (int i = 0; i < 100; i++) {
+    canvas.drawCircle(Offset(i * 10.0, i * 5.0), 20.0, Paint()..color = Color(0xFF000000 + i * 0x020301));
+  }
+  final Picture picture = pictureRecorder.endRecording();
+  final Image image = await picture.toImage(1000, 500);
+  final List<bool> matches = <bool>[];
+  int chunkCount = 0;
+  for (final ImageByteFormat format in <ImageByteFormat>[ImageByteFormat.png, ImageByteFormat.rawRgba]) {
+    final ByteData whole = (await image.toByteData(format: format))!;
+    final List<int> streamed = <int>[];
+    await for (final ByteData chunk in image.toByteDataStream(format: format)) {
+      streamed.addAll(chunk.buffer.asUint8List(chunk.offsetInBytes, chunk.lengthInBytes));
+      chunkCount++;
+    }
+    final Uint8List expected = whole.buffer.asUint8List(whole.offsetInBytes, whole.lengthInBytes);
+    bool equal = streamed.length == expected.length;
+    for (int i = 0; equal && i < expected.length; i++) {
+      equal = streamed[i] == expected[i];
+    }
+    matches.add(equal);
+  }
+  _validateStream(matches[0], matches[1], chunkCount);
+}
+void _validateStream(bool pngMatches, bool rawMatches, int chunkCount) native 'ValidateStream';
+
+// Rasterizes several pictures in one call and reports the sizes of the images.
+@pragma('vm:entry-point')
+Future<void> toImagesOfPictures() async {
+  final List<Picture> pictures = <Picture>[];
+  for (int i = 0; i < 3; i++) {
+    final PictureRecorder pictureRecorder = PictureRecorder();
+    final Canvas canvas = Canvas(pictureRecorder);
+    canvas.drawCircle(Offset(10.0 * i, 10.0), 5.0, Paint());
+    pictures.add(pictureRecorder.endRecording());
+  }
+  final List<Image> images = await Picture.toImages(pictures, 40, 20);
+  final List<Image> gpuImages = await Picture.toImages(pictures, 40, 20, gpuResident: true);
+  _validateImages(
+    images.length,
+    gpuImages.length,
+    <Image>[...images, ...gpuImages].every((Image image) => image.width == 40 && image.height == 20),
+  );
+}
+void _validateImages(int count, int gpuCount, bool sizesMatch) native 'ValidateImages';
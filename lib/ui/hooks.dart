@@ -169,6 +169,17 @@ void _dispatchPlatformMessage(String name, ByteData? data, int responseId) {
   }
 }
 
+@pragma('vm:entry-point')
+// ignore: unused_element
+void _dispatchPlatformMessages(
+    String name, List<Object?> data, List<Object?> responseIds) {
+  assert(data.length == responseIds.length);
+  for (int index = 0; index < data.length; index += 1) {
+    _dispatchPlatformMessage(
+        name, data[index] as ByteData?, responseIds[index]! as int);
+  }
+}
+
 @pragma('vm:entry-point')
 // ignore: unused_element
 void _dispatchPointerDataPacket(ByteData packet) {
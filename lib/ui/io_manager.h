@@ -5,6 +5,8 @@
 #ifndef FLUTTER_LIB_UI_IO_MANAGER_H_
 #define FLUTTER_LIB_UI_IO_MANAGER_H_
 
+#include <vector>
+
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -16,6 +18,16 @@ namespace flutter {
 // i.e. the shell's IOManager.
 class IOManager {
  public:
+  // A thread besides the IO thread that textures can be uploaded on, with a
+  // resource context of its own in the share group of the one returned by
+  // |GetResourceContext|. Its resource context may only be used on its task
+  // runner, and the images it uploads must be released to its unref queue.
+  struct UploadWorker {
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    fml::WeakPtr<GrContext> resource_context;
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue;
+  };
+
   virtual ~IOManager() = default;
 
   virtual fml::WeakPtr<IOManager> GetWeakIOManager() const = 0;
@@ -25,6 +37,9 @@ class IOManager {
   virtual fml::RefPtr<flutter::SkiaUnrefQueue> GetSkiaUnrefQueue() const = 0;
 
   virtual std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() = 0;
+
+  // The upload workers, if any. Must be called on the IO thread.
+  virtual std::vector<UploadWorker> GetUploadWorkers() const { return {}; }
 };
 
 }  // namespace flutter
@@ -6,12 +6,13 @@
 
 namespace flutter {
 
-IsolateNameServer::IsolateNameServer() {}
+IsolateNameServer::IsolateNameServer()
+    : mutex_(fml::SharedMutex::CreateReaderBiased()) {}
 
 IsolateNameServer::~IsolateNameServer() = default;
 
 Dart_Port IsolateNameServer::LookupIsolatePortByName(const std::string& name) {
-  std::scoped_lock lock(mutex_);
+  fml::SharedLock lock(*mutex_);
   return LookupIsolatePortByNameUnprotected(name);
 }
 
@@ -26,7 +27,7 @@ Dart_Port IsolateNameServer::LookupIsolatePortByNameUnprotected(
 
 bool IsolateNameServer::RegisterIsolatePortWithName(Dart_Port port,
                                                     const std::string& name) {
-  std::scoped_lock lock(mutex_);
+  fml::UniqueLock lock(*mutex_);
   if (LookupIsolatePortByNameUnprotected(name) != ILLEGAL_PORT) {
     // Name is already registered.
     return false;
@@ -36,7 +37,7 @@ bool IsolateNameServer::RegisterIsolatePortWithName(Dart_Port port,
 }
 
 bool IsolateNameServer::RemoveIsolateNameMapping(const std::string& name) {
-  std::scoped_lock lock(mutex_);
+  fml::UniqueLock lock(*mutex_);
   auto port_iterator = port_mapping_.find(name);
   if (port_iterator == port_mapping_.end()) {
     return false;
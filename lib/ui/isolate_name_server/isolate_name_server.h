@@ -6,10 +6,11 @@
 #define FLUTTER_LIB_UI_ISOLATE_NAME_SERVER_H_
 
 #include <map>
-#include <mutex>
+#include <memory>
 #include <string>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/shared_mutex.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 
 namespace flutter {
@@ -35,7 +36,8 @@ class IsolateNameServer {
  private:
   Dart_Port LookupIsolatePortByNameUnprotected(const std::string& name);
 
-  mutable std::mutex mutex_;
+  // Lookups from the isolates of all threads far outnumber registrations.
+  std::unique_ptr<fml::SharedMutex> mutex_;
   std::map<std::string, Dart_Port> port_mapping_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(IsolateNameServer);
@@ -1621,6 +1621,35 @@ class Image extends NativeFieldWrapperClass2 {
   /// Returns an error message on failure, null on success.
   String? _toByteData(int format, _Callback<Uint8List?> callback) native 'Image_toByteData';
 
+  /// Converts the [Image] object into a stream of read-only byte arrays.
+  ///
+  /// The bytes are the same as those [toByteData] returns in the given
+  /// [format], but they are emitted in order as they are encoded, so that
+  /// large images can be written out or sent on before they are fully
+  /// encoded and without one buffer holding all of them.
+  ///
+  /// The stream closes once the image is encoded, or emits an error if
+  /// encoding fails.
+  Stream<ByteData> toByteDataStream({ImageByteFormat format = ImageByteFormat.png}) {
+    final StreamController<ByteData> controller = StreamController<ByteData>();
+    final String? error = _toByteDataStream(format.index, (Uint8List chunk) {
+      // [chunk] wraps a read-only SkData buffer.
+      controller.add(UnmodifiableByteDataView(chunk.buffer.asByteData()));
+    }, (bool success) {
+      if (!success) {
+        controller.addError(Exception('Failed to encode the image.'));
+      }
+      controller.close();
+    });
+    if (error != null) {
+      throw Exception(error);
+    }
+    return controller.stream;
+  }
+
+  /// Returns an error message on failure, null on success.
+  String? _toByteDataStream(int format, _Callback<Uint8List> chunkCallback, _Callback<bool> doneCallback) native 'Image_toByteDataStream';
+
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
   void dispose() native 'Image_dispose';
@@ -1704,6 +1733,10 @@ class Codec extends NativeFieldWrapperClass2 {
 /// The data can be for either static or animated images. The following image
 /// formats are supported: {@macro flutter.dart:ui.imageFormats}
 ///
+/// KTX and KTX2 containers of ETC2 or BC1 compressed textures are also
+/// supported. They are uploaded to the GPU without being decoded where the GPU
+/// supports their compression type, and are always used at their own size.
+///
 /// The `targetWidth` and `targetHeight` arguments specify the size of the
 /// output image, in image pixels. If they are not equal to the intrinsic
 /// dimensions of the image, then the image will be scaled after being decoded.
@@ -1831,6 +1864,59 @@ void decodeImageFromPixels(
       .then((FrameInfo frameInfo) => callback(frameInfo.image));
 }
 
+/// Decodes an image from its encoded bytes while they are still arriving, such
+/// as an image that is being downloaded.
+///
+/// Pass the bytes to [addChunk] as they arrive and call [close] after the last
+/// chunk. Images in formats that can be decoded incrementally, like PNG and
+/// GIF, are decoded as the chunks arrive, and the partially decoded images are
+/// passed to `onProgress`, with the rows that were not received yet left
+/// transparent. Other images are decoded once [close] is called. Only the first
+/// frame of animated images is decoded.
+///
+/// The `targetWidth`, `targetHeight` and `allowUpscaling` arguments behave like
+/// those of [instantiateImageCodec], and apply to the partial images too.
+class ImageStreamDecoder extends NativeFieldWrapperClass2 {
+  /// Creates a decoder that has not received any bytes yet.
+  @pragma('vm:entry-point')
+  ImageStreamDecoder({
+    int? targetWidth,
+    int? targetHeight,
+    bool allowUpscaling = false,
+    ImageDecoderCallback? onProgress,
+  }) {
+    _constructor(
+      targetWidth ?? _kDoNotResizeDimension,
+      targetHeight ?? _kDoNotResizeDimension,
+      allowUpscaling,
+      onProgress,
+    );
+  }
+  void _constructor(int targetWidth, int targetHeight, bool allowUpscaling,
+      ImageDecoderCallback? onProgress) native 'ImageStreamDecoder_constructor';
+
+  /// Appends the next bytes of the encoded image.
+  ///
+  /// The bytes are copied, so `chunk` may be reused afterwards. Throws if
+  /// [close] was already called.
+  void addChunk(Uint8List chunk) {
+    final String? error = _addChunk(chunk);
+    if (error != null)
+      throw Exception(error);
+  }
+  String? _addChunk(Uint8List chunk) native 'ImageStreamDecoder_addChunk';
+
+  /// Marks the end of the encoded image.
+  ///
+  /// The returned future completes with the fully decoded image, or with an
+  /// error if the image could not be decoded. No partial images are passed to
+  /// `onProgress` after it completed.
+  Future<Image> close() {
+    return _futurize(_close);
+  }
+  String? _close(_Callback<Image> callback) native 'ImageStreamDecoder_close';
+}
+
 /// Determines the winding rule that decides how the interior of a [Path] is
 /// calculated.
 ///
@@ -3350,6 +3436,70 @@ class Vertices extends NativeFieldWrapperClass2 {
       throw ArgumentError('Invalid configuration for vertices.');
   }
 
+  /// Creates a set of vertex data for use with [Canvas.drawVertices] whose
+  /// positions, texture coordinates and colors are kept in buffers shared with
+  /// the engine.
+  ///
+  /// The buffers are [positionBuffer], [textureCoordinateBuffer] and
+  /// [colorBuffer], which are encoded like the lists of [Vertices.raw] and
+  /// start out filled with zeros. Writing into them and calling [update]
+  /// changes the vertices that are drawn afterwards, without creating new
+  /// lists or [Vertices] for meshes that change every frame.
+  ///
+  /// The [mode] parameter must not be null, and [vertexCount] must be
+  /// positive.
+  ///
+  /// If the [indices] list is provided, all values in the list must be
+  /// valid indices of the vertices.
+  Vertices.buffers(
+    VertexMode mode,
+    int vertexCount, {
+    bool hasTextureCoordinates = false,
+    bool hasColors = false,
+    Uint16List? indices,
+  }) : assert(mode != null), // ignore: unnecessary_null_comparison
+       assert(vertexCount != null) { // ignore: unnecessary_null_comparison
+    if (vertexCount <= 0)
+      throw ArgumentError.value(vertexCount, 'vertexCount', 'must be positive');
+    if (indices != null && indices.any((int i) => i < 0 || i >= vertexCount))
+      throw ArgumentError('"indices" values must be valid indices of the vertices.');
+
+    if (!_initBuffers(this, mode.index, vertexCount, hasTextureCoordinates, hasColors, indices))
+      throw ArgumentError('Invalid configuration for vertices.');
+  }
+
+  /// The positions of vertices created with [Vertices.buffers], as repeated
+  /// pairs of x,y coordinates, or null for other vertices.
+  late final Float32List? positionBuffer = _getPositionBuffer();
+
+  /// The texture coordinates of vertices created with [Vertices.buffers] with
+  /// `hasTextureCoordinates`, as repeated pairs of x,y coordinates, or null.
+  late final Float32List? textureCoordinateBuffer = _getTextureCoordinateBuffer();
+
+  /// The colors of vertices created with [Vertices.buffers] with `hasColors`,
+  /// encoded like [Color.value], or null.
+  late final Int32List? colorBuffer = _getColorBuffer();
+
+  /// Draws the current contents of the buffers of vertices created with
+  /// [Vertices.buffers] from now on.
+  ///
+  /// The pictures that drew the vertices before keep drawing what they drew.
+  void update() {
+    if (!_update())
+      throw StateError('Only vertices created with Vertices.buffers can be updated.');
+  }
+
+  bool _initBuffers(Vertices outVertices,
+                    int mode,
+                    int vertexCount,
+                    bool hasTextureCoordinates,
+                    bool hasColors,
+                    Uint16List? indices) native 'Vertices_initBuffers';
+  Float32List? _getPositionBuffer() native 'Vertices_getPositionBuffer';
+  Float32List? _getTextureCoordinateBuffer() native 'Vertices_getTextureCoordinateBuffer';
+  Int32List? _getColorBuffer() native 'Vertices_getColorBuffer';
+  bool _update() native 'Vertices_update';
+
   bool _init(Vertices outVertices,
              int mode,
              Float32List positions,
@@ -3440,6 +3590,8 @@ class Canvas extends NativeFieldWrapperClass2 {
     _recorder!._canvas = this;
     cullRect ??= Rect.largest;
     _constructor(recorder, cullRect.left, cullRect.top, cullRect.right, cullRect.bottom);
+    if (_canvasCommandBufferEnabled)
+      _commands = _CanvasCommands(this);
   }
   void _constructor(PictureRecorder recorder,
                     double left,
@@ -3452,6 +3604,24 @@ class Canvas extends NativeFieldWrapperClass2 {
   // garbage collected until PictureRecorder.endRecording is called.
   PictureRecorder? _recorder;
 
+  // The commands recorded since they were last replayed into the engine,
+  // when the command buffer is enabled. The methods that aren't recorded
+  // replay the recorded commands first, so the engine sees every command in
+  // order.
+  _CanvasCommands? _commands;
+
+  void _flushCommands() {
+    final _CanvasCommands? commands = _commands;
+    if (commands == null || commands.isEmpty)
+      return;
+    try {
+      _replayCommands(commands._data, commands._length, commands._objects);
+    } finally {
+      commands.clear();
+    }
+  }
+  void _replayCommands(ByteData data, int length, List<Object?> objects) native 'Canvas_replayCommands';
+
   /// Saves a copy of the current transform and clip on the save stack.
   ///
   /// Call [restore] to pop the save stack.
@@ -3460,7 +3630,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   ///  * [saveLayer], which does the same thing but additionally also groups the
   ///    commands done until the matching [restore].
-  void save() native 'Canvas_save';
+  void save() {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.save();
+    else
+      _save();
+  }
+  void _save() native 'Canvas_save';
 
   /// Saves a copy of the current transform and clip on the save stack, and then
   /// creates a new group which subsequent calls will become a part of. When the
@@ -3572,6 +3749,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///  * [BlendMode], which discusses the use of [Paint.blendMode] with
   ///    [saveLayer].
   void saveLayer(Rect? bounds, Paint paint) {
+    _flushCommands();
     assert(paint != null); // ignore: unnecessary_null_comparison
     if (bounds == null) {
       _saveLayerWithoutBounds(paint._objects, paint._data);
@@ -3597,7 +3775,14 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If the state was pushed with with [saveLayer], then this call will also
   /// cause the new layer to be composited into the previous layer.
-  void restore() native 'Canvas_restore';
+  void restore() {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.restore();
+    else
+      _restore();
+  }
+  void _restore() native 'Canvas_restore';
 
   /// Returns the number of items on the save stack, including the
   /// initial state. This means it returns 1 for a clean canvas, and
@@ -3605,11 +3790,22 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// each matching call to [restore] decrements it.
   ///
   /// This number cannot go below 1.
-  int getSaveCount() native 'Canvas_getSaveCount';
+  int getSaveCount() {
+    _flushCommands();
+    return _getSaveCount();
+  }
+  int _getSaveCount() native 'Canvas_getSaveCount';
 
   /// Add a translation to the current transform, shifting the coordinate space
   /// horizontally by the first argument and vertically by the second argument.
-  void translate(double dx, double dy) native 'Canvas_translate';
+  void translate(double dx, double dy) {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.translate(dx, dy);
+    else
+      _translate(dx, dy);
+  }
+  void _translate(double dx, double dy) native 'Canvas_translate';
 
   /// Add an axis-aligned scale to the current transform, scaling by the first
   /// argument in the horizontal direction and the second in the vertical
@@ -3617,22 +3813,43 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If [sy] is unspecified, [sx] will be used for the scale in both
   /// directions.
-  void scale(double sx, [double? sy]) => _scale(sx, sy ?? sx);
+  void scale(double sx, [double? sy]) {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.scale(sx, sy ?? sx);
+    else
+      _scale(sx, sy ?? sx);
+  }
 
   void _scale(double sx, double sy) native 'Canvas_scale';
 
   /// Add a rotation to the current transform. The argument is in radians clockwise.
-  void rotate(double radians) native 'Canvas_rotate';
+  void rotate(double radians) {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.rotate(radians);
+    else
+      _rotate(radians);
+  }
+  void _rotate(double radians) native 'Canvas_rotate';
 
   /// Add an axis-aligned skew to the current transform, with the first argument
   /// being the horizontal skew in rise over run units clockwise around the
   /// origin, and the second argument being the vertical skew in rise over run
   /// units clockwise around the origin.
-  void skew(double sx, double sy) native 'Canvas_skew';
+  void skew(double sx, double sy) {
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.skew(sx, sy);
+    else
+      _skew(sx, sy);
+  }
+  void _skew(double sx, double sy) native 'Canvas_skew';
 
   /// Multiply the current transform by the specified 4⨉4 transformation matrix
   /// specified as a list of values in column-major order.
   void transform(Float64List matrix4) {
+    _flushCommands();
     assert(matrix4 != null); // ignore: unnecessary_null_comparison
     if (matrix4.length != 16)
       throw ArgumentError('"matrix4" must have 16 entries.');
@@ -3655,7 +3872,11 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(rect));
     assert(clipOp != null); // ignore: unnecessary_null_comparison
     assert(doAntiAlias != null); // ignore: unnecessary_null_comparison
-    _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
+    else
+      _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index, doAntiAlias);
   }
   void _clipRect(double left,
                  double top,
@@ -3675,7 +3896,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipRRect(RRect rrect, {bool doAntiAlias = true}) {
     assert(_rrectIsValid(rrect));
     assert(doAntiAlias != null); // ignore: unnecessary_null_comparison
-    _clipRRect(rrect._value32, doAntiAlias);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.clipRRect(rrect._value32, doAntiAlias);
+    else
+      _clipRRect(rrect._value32, doAntiAlias);
   }
   void _clipRRect(Float32List rrect, bool doAntiAlias) native 'Canvas_clipRRect';
 
@@ -3689,6 +3914,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// in incorrect blending at the clip boundary. See [saveLayer] for a
   /// discussion of how to address that.
   void clipPath(Path path, {bool doAntiAlias = true}) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(path != null); // path is checked on the engine side
     assert(doAntiAlias != null); // ignore: unnecessary_null_comparison
@@ -3702,7 +3928,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawColor(Color color, BlendMode blendMode) {
     assert(color != null); // ignore: unnecessary_null_comparison
     assert(blendMode != null); // ignore: unnecessary_null_comparison
-    _drawColor(color.value, blendMode.index);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawColor(color.value, blendMode.index);
+    else
+      _drawColor(color.value, blendMode.index);
   }
   void _drawColor(int color, int blendMode) native 'Canvas_drawColor';
 
@@ -3714,7 +3944,11 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_offsetIsValid(p1));
     assert(_offsetIsValid(p2));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint);
+    else
+      _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
   }
   void _drawLine(double x1,
                  double y1,
@@ -3729,7 +3963,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [drawColor] instead.
   void drawPaint(Paint paint) {
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawPaint(paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawPaint(paint);
+    else
+      _drawPaint(paint._objects, paint._data);
   }
   void _drawPaint(List<dynamic>? paintObjects, ByteData paintData) native 'Canvas_drawPaint';
 
@@ -3738,8 +3976,12 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRect(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawRect(rect.left, rect.top, rect.right, rect.bottom,
-              paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawRect(rect.left, rect.top, rect.right, rect.bottom, paint);
+    else
+      _drawRect(rect.left, rect.top, rect.right, rect.bottom,
+                paint._objects, paint._data);
   }
   void _drawRect(double left,
                  double top,
@@ -3753,7 +3995,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRRect(RRect rrect, Paint paint) {
     assert(_rrectIsValid(rrect));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawRRect(rrect._value32, paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawRRect(rrect._value32, paint);
+    else
+      _drawRRect(rrect._value32, paint._objects, paint._data);
   }
   void _drawRRect(Float32List rrect,
                   List<dynamic>? paintObjects,
@@ -3765,6 +4011,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// This shape is almost but not quite entirely unlike an annulus.
   void drawDRRect(RRect outer, RRect inner, Paint paint) {
+    _flushCommands();
     assert(_rrectIsValid(outer));
     assert(_rrectIsValid(inner));
     assert(paint != null); // ignore: unnecessary_null_comparison
@@ -3781,8 +4028,12 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawOval(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawOval(rect.left, rect.top, rect.right, rect.bottom,
-              paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawOval(rect.left, rect.top, rect.right, rect.bottom, paint);
+    else
+      _drawOval(rect.left, rect.top, rect.right, rect.bottom,
+                paint._objects, paint._data);
   }
   void _drawOval(double left,
                  double top,
@@ -3798,7 +4049,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawCircle(Offset c, double radius, Paint paint) {
     assert(_offsetIsValid(c));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawCircle(c.dx, c.dy, radius, paint);
+    else
+      _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
   }
   void _drawCircle(double x,
                    double y,
@@ -3818,6 +4073,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// This method is optimized for drawing arcs and should be faster than [Path.arcTo].
   void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
+    _flushCommands();
     assert(_rectIsValid(rect));
     assert(paint != null); // ignore: unnecessary_null_comparison
     _drawArc(rect.left, rect.top, rect.right, rect.bottom, startAngle,
@@ -3839,6 +4095,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [Paint.style]. If the path is filled, then sub-paths within it are
   /// implicitly closed (see [Path.close]).
   void drawPath(Path path, Paint paint) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(path != null); // path is checked on the engine side
     assert(paint != null); // ignore: unnecessary_null_comparison
@@ -3855,7 +4112,11 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(image != null); // image is checked on the engine side
     assert(_offsetIsValid(offset));
     assert(paint != null); // ignore: unnecessary_null_comparison
-    _drawImage(image, offset.dx, offset.dy, paint._objects, paint._data);
+    final _CanvasCommands? commands = _commands;
+    if (commands != null)
+      commands.drawImage(image, offset.dx, offset.dy, paint);
+    else
+      _drawImage(image, offset.dx, offset.dy, paint._objects, paint._data);
   }
   void _drawImage(Image image,
                   double x,
@@ -3878,6 +4139,12 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(src));
     assert(_rectIsValid(dst));
     assert(paint != null); // ignore: unnecessary_null_comparison
+    final _CanvasCommands? commands = _commands;
+    if (commands != null) {
+      commands.drawImageRect(image, src.left, src.top, src.right, src.bottom,
+                             dst.left, dst.top, dst.right, dst.bottom, paint);
+      return;
+    }
     _drawImageRect(image,
                    src.left,
                    src.top,
@@ -3916,6 +4183,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// cover the destination rectangle while maintaining their relative
   /// positions.
   void drawImageNine(Image image, Rect center, Rect dst, Paint paint) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(image != null); // image is checked on the engine side
     assert(_rectIsValid(center));
@@ -3948,6 +4216,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// Draw the given picture onto the canvas. To create a picture, see
   /// [PictureRecorder].
   void drawPicture(Picture picture) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(picture != null); // picture is checked on the engine side
     _drawPicture(picture);
@@ -3975,6 +4244,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// described by adding half of the [ParagraphConstraints.width] given to
   /// [Paragraph.layout], to the `offset` argument's [Offset.dx] coordinate.
   void drawParagraph(Paragraph paragraph, Offset offset) {
+    _flushCommands();
     assert(paragraph != null); // ignore: unnecessary_null_comparison
     assert(_offsetIsValid(offset));
     paragraph._paint(this, offset.dx, offset.dy);
@@ -3989,6 +4259,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///  * [drawRawPoints], which takes `points` as a [Float32List] rather than a
   ///    [List<Offset>].
   void drawPoints(PointMode pointMode, List<Offset> points, Paint paint) {
+    _flushCommands();
     assert(pointMode != null); // ignore: unnecessary_null_comparison
     assert(points != null); // ignore: unnecessary_null_comparison
     assert(paint != null); // ignore: unnecessary_null_comparison
@@ -4005,6 +4276,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///  * [drawPoints], which takes `points` as a [List<Offset>] rather than a
   ///    [List<Float32List>].
   void drawRawPoints(PointMode pointMode, Float32List points, Paint paint) {
+    _flushCommands();
     assert(pointMode != null); // ignore: unnecessary_null_comparison
     assert(points != null); // ignore: unnecessary_null_comparison
     assert(paint != null); // ignore: unnecessary_null_comparison
@@ -4027,6 +4299,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///   * [Vertices.raw], which creates the vertices using typed data lists
   ///     rather than unencoded lists.
   void drawVertices(Vertices vertices, BlendMode blendMode, Paint paint) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(vertices != null); // vertices is checked on the engine side
     assert(paint != null); // ignore: unnecessary_null_comparison
@@ -4057,6 +4330,7 @@ class Canvas extends NativeFieldWrapperClass2 {
                  BlendMode blendMode,
                  Rect? cullRect,
                  Paint paint) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(atlas != null); // atlas is checked on the engine side
     assert(transforms != null); // ignore: unnecessary_null_comparison
@@ -4128,6 +4402,7 @@ class Canvas extends NativeFieldWrapperClass2 {
                     BlendMode blendMode,
                     Rect? cullRect,
                     Paint paint) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(atlas != null); // atlas is checked on the engine side
     assert(rstTransforms != null); // ignore: unnecessary_null_comparison
@@ -4166,6 +4441,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// The arguments must not be null.
   void drawShadow(Path path, Color color, double elevation, bool transparentOccluder) {
+    _flushCommands();
     // ignore: unnecessary_null_comparison
     assert(path != null); // path is checked on the engine side
     assert(color != null); // ignore: unnecessary_null_comparison
@@ -4178,6 +4454,264 @@ class Canvas extends NativeFieldWrapperClass2 {
                    bool transparentOccluder) native 'Canvas_drawShadow';
 }
 
+// Set by the engine when the Canvas command buffer is enabled.
+@pragma('vm:entry-point')
+bool _canvasCommandBufferEnabled = false;
+
+/// Records the most frequent [Canvas] commands, so that they're replayed into
+/// the engine in one native call instead of a native call each.
+///
+/// Each command is a 32-bit opcode followed by its arguments, which are 32-bit
+/// floats and integers. Paints are the index of their objects in [_objects]
+/// plus one, or zero if they have none, followed by a copy of their data.
+/// Images are an index in [_objects].
+class _CanvasCommands {
+  _CanvasCommands(this._canvas);
+
+  // Must be kept in sync with CanvasCommand in canvas_commands.h.
+  static const int _kSave = 0;
+  static const int _kRestore = 1;
+  static const int _kTranslate = 2;
+  static const int _kScale = 3;
+  static const int _kRotate = 4;
+  static const int _kSkew = 5;
+  static const int _kClipRect = 6;
+  static const int _kClipRRect = 7;
+  static const int _kDrawColor = 8;
+  static const int _kDrawLine = 9;
+  static const int _kDrawPaint = 10;
+  static const int _kDrawRect = 11;
+  static const int _kDrawRRect = 12;
+  static const int _kDrawOval = 13;
+  static const int _kDrawCircle = 14;
+  static const int _kDrawImage = 15;
+  static const int _kDrawImageRect = 16;
+
+  // The number of words of the arguments of commands.
+  static const int _kPaintWords = 1 + Paint._kDataByteCount ~/ 4;
+  static const int _kRRectWords = 12;
+
+  // The commands are replayed once they reach this size, even if no command
+  // that isn't recorded comes.
+  static const int _kMaxLength = 64 * 1024;
+
+  final Canvas _canvas;
+  ByteData _data = ByteData(4 * 1024);
+  int _length = 0;
+  final List<Object?> _objects = <Object?>[];
+
+  // Paints keep their objects in a list that changes with them, so the
+  // commands refer to copies of it. Consecutive commands with the same
+  // objects share a copy.
+  List<dynamic>? _lastPaintObjects;
+  int _lastPaintObjectsIndex = 0;
+
+  bool get isEmpty => _length == 0;
+
+  void clear() {
+    _length = 0;
+    _objects.clear();
+    _lastPaintObjects = null;
+  }
+
+  void save() {
+    _begin(_kSave, 0);
+    _end();
+  }
+
+  void restore() {
+    _begin(_kRestore, 0);
+    _end();
+  }
+
+  void translate(double dx, double dy) {
+    _begin(_kTranslate, 2);
+    _addFloat(dx);
+    _addFloat(dy);
+    _end();
+  }
+
+  void scale(double sx, double sy) {
+    _begin(_kScale, 2);
+    _addFloat(sx);
+    _addFloat(sy);
+    _end();
+  }
+
+  void rotate(double radians) {
+    _begin(_kRotate, 1);
+    _addFloat(radians);
+    _end();
+  }
+
+  void skew(double sx, double sy) {
+    _begin(_kSkew, 2);
+    _addFloat(sx);
+    _addFloat(sy);
+    _end();
+  }
+
+  void clipRect(double left, double top, double right, double bottom, int clipOp, bool doAntiAlias) {
+    _begin(_kClipRect, 6);
+    _addRect(left, top, right, bottom);
+    _addInt(clipOp);
+    _addInt(doAntiAlias ? 1 : 0);
+    _end();
+  }
+
+  void clipRRect(Float32List rrect, bool doAntiAlias) {
+    _begin(_kClipRRect, _kRRectWords + 1);
+    _addRRect(rrect);
+    _addInt(doAntiAlias ? 1 : 0);
+    _end();
+  }
+
+  void drawColor(int color, int blendMode) {
+    _begin(_kDrawColor, 2);
+    _addInt(color);
+    _addInt(blendMode);
+    _end();
+  }
+
+  void drawLine(double x1, double y1, double x2, double y2, Paint paint) {
+    _begin(_kDrawLine, 4 + _kPaintWords);
+    _addFloat(x1);
+    _addFloat(y1);
+    _addFloat(x2);
+    _addFloat(y2);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawPaint(Paint paint) {
+    _begin(_kDrawPaint, _kPaintWords);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawRect(double left, double top, double right, double bottom, Paint paint) {
+    _begin(_kDrawRect, 4 + _kPaintWords);
+    _addRect(left, top, right, bottom);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawRRect(Float32List rrect, Paint paint) {
+    _begin(_kDrawRRect, _kRRectWords + _kPaintWords);
+    _addRRect(rrect);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawOval(double left, double top, double right, double bottom, Paint paint) {
+    _begin(_kDrawOval, 4 + _kPaintWords);
+    _addRect(left, top, right, bottom);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawCircle(double x, double y, double radius, Paint paint) {
+    _begin(_kDrawCircle, 3 + _kPaintWords);
+    _addFloat(x);
+    _addFloat(y);
+    _addFloat(radius);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawImage(Image image, double x, double y, Paint paint) {
+    _begin(_kDrawImage, 3 + _kPaintWords);
+    _addObject(image);
+    _addFloat(x);
+    _addFloat(y);
+    _addPaint(paint);
+    _end();
+  }
+
+  void drawImageRect(Image image,
+                     double srcLeft,
+                     double srcTop,
+                     double srcRight,
+                     double srcBottom,
+                     double dstLeft,
+                     double dstTop,
+                     double dstRight,
+                     double dstBottom,
+                     Paint paint) {
+    _begin(_kDrawImageRect, 9 + _kPaintWords);
+    _addObject(image);
+    _addRect(srcLeft, srcTop, srcRight, srcBottom);
+    _addRect(dstLeft, dstTop, dstRight, dstBottom);
+    _addPaint(paint);
+    _end();
+  }
+
+  // Makes room for a command with `words` words of arguments and adds its
+  // opcode.
+  void _begin(int opcode, int words) {
+    final int length = _length + (words + 1) * 4;
+    if (length > _data.lengthInBytes) {
+      final ByteData data = ByteData(math.max(_data.lengthInBytes * 2, length));
+      data.buffer.asUint8List().setRange(0, _length, _data.buffer.asUint8List());
+      _data = data;
+    }
+    _addInt(opcode);
+  }
+
+  void _end() {
+    if (_length >= _kMaxLength)
+      _canvas._flushCommands();
+  }
+
+  void _addInt(int value) {
+    _data.setUint32(_length, value, _kFakeHostEndian);
+    _length += 4;
+  }
+
+  void _addFloat(double value) {
+    _data.setFloat32(_length, value, _kFakeHostEndian);
+    _length += 4;
+  }
+
+  void _addRect(double left, double top, double right, double bottom) {
+    _addFloat(left);
+    _addFloat(top);
+    _addFloat(right);
+    _addFloat(bottom);
+  }
+
+  void _addRRect(Float32List rrect) {
+    for (int i = 0; i < _kRRectWords; i += 1)
+      _addFloat(rrect[i]);
+  }
+
+  void _addObject(Object object) {
+    _addInt(_objects.length);
+    _objects.add(object);
+  }
+
+  void _addPaint(Paint paint) {
+    final List<dynamic>? objects = paint._objects;
+    if (objects == null) {
+      _addInt(0);
+    } else {
+      final List<dynamic>? last = _lastPaintObjects;
+      if (last == null ||
+          !identical(last[0], objects[0]) ||
+          !identical(last[1], objects[1]) ||
+          !identical(last[2], objects[2])) {
+        _lastPaintObjects = List<dynamic>.of(objects, growable: false);
+        _objects.add(_lastPaintObjects);
+        _lastPaintObjectsIndex = _objects.length;
+      }
+      _addInt(_lastPaintObjectsIndex);
+    }
+    final ByteData data = paint._data;
+    for (int offset = 0; offset < Paint._kDataByteCount; offset += 4)
+      _addInt(data.getUint32(offset, _kFakeHostEndian));
+  }
+}
+
 /// An object representing a sequence of recorded graphical operations.
 ///
 /// To create a [Picture], use a [PictureRecorder].
@@ -4202,15 +4736,46 @@ class Picture extends NativeFieldWrapperClass2 {
   ///
   /// Although the image is returned synchronously, the picture is actually
   /// rasterized the first time the image is drawn and then cached.
-  Future<Image> toImage(int width, int height) {
+  ///
+  /// If `gpuResident` is true, the image is left on the GPU instead of being
+  /// read back into memory, which is faster when the image is only drawn. It
+  /// is read back when its bytes are asked for.
+  Future<Image> toImage(int width, int height, {bool gpuResident = false}) {
+    if (width <= 0 || height <= 0)
+      throw Exception('Invalid image dimensions.');
+    return _futurize(
+      (_Callback<Image> callback) => _toImage(width, height, gpuResident, callback)
+    );
+  }
+
+  String _toImage(int width, int height, bool gpuResident, _Callback<Image> callback) native 'Picture_toImage';
+
+  /// Creates an image from each of the `pictures`, like [toImage].
+  ///
+  /// All the pictures are rasterized in one go, which is faster than calling
+  /// [toImage] for each of them, for example to make thumbnails.
+  static Future<List<Image>> toImages(
+    List<Picture> pictures,
+    int width,
+    int height, {
+    bool gpuResident = false,
+  }) {
     if (width <= 0 || height <= 0)
       throw Exception('Invalid image dimensions.');
+    if (pictures.isEmpty)
+      return Future<List<Image>>.value(<Image>[]);
     return _futurize(
-      (_Callback<Image> callback) => _toImage(width, height, callback)
+      (_Callback<List<Image>> callback) => _toImages(pictures, width, height, gpuResident, callback)
     );
   }
 
-  String _toImage(int width, int height, _Callback<Image> callback) native 'Picture_toImage';
+  static String _toImages(
+    List<Picture> pictures,
+    int width,
+    int height,
+    bool gpuResident,
+    _Callback<List<Image>> callback,
+  ) native 'Picture_toImages';
 
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
@@ -4252,6 +4817,7 @@ class PictureRecorder extends NativeFieldWrapperClass2 {
   Picture endRecording() {
     if (_canvas == null)
       throw StateError('PictureRecorder did not start recording.');
+    _canvas!._flushCommands();
     final Picture picture = Picture._();
     _endRecording(picture);
     _canvas!._recorder = null;
@@ -7,7 +7,10 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <vector>
+
 #include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/lib/ui/painting/canvas_commands.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/matrix.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -19,6 +22,7 @@
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/typed_data/dart_byte_data.h"
 
 using tonic::ToDart;
 
@@ -62,7 +66,8 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
   V(Canvas, drawPoints)             \
   V(Canvas, drawVertices)           \
   V(Canvas, drawAtlas)              \
-  V(Canvas, drawShadow)
+  V(Canvas, drawShadow)             \
+  V(Canvas, replayCommands)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -181,7 +186,7 @@ void Canvas::clipPath(const CanvasPath* path, bool doAntiAlias) {
     Dart_ThrowException(
         ToDart("Canvas.clipPath called with non-genuine Path."));
   external_allocation_size_ += path->path().approximateBytesUsed();
-  canvas_->clipPath(path->path(), doAntiAlias);
+  canvas_->clipPath(path->GetInternedPath(), doAntiAlias);
 }
 
 void Canvas::drawColor(SkColor color, SkBlendMode blend_mode) {
@@ -281,7 +286,7 @@ void Canvas::drawPath(const CanvasPath* path,
     Dart_ThrowException(
         ToDart("Canvas.drawPath called with non-genuine Path."));
   external_allocation_size_ += path->path().approximateBytesUsed();
-  canvas_->drawPath(path->path(), *paint.paint());
+  canvas_->drawPath(path->GetInternedPath(), *paint.paint());
 }
 
 void Canvas::drawImage(const CanvasImage* image,
@@ -353,6 +358,10 @@ void Canvas::drawPicture(Picture* picture) {
     Dart_ThrowException(
         ToDart("Canvas.drawPicture called with non-genuine Picture."));
   external_allocation_size_ += picture->GetAllocationSize();
+  if (auto display_list = picture->display_list()) {
+    display_list->RenderTo(canvas_);
+    return;
+  }
   canvas_->drawPicture(picture->picture().get());
 }
 
@@ -427,8 +436,35 @@ void Canvas::drawShadow(const CanvasPath* path,
   SkScalar dpr =
       UIDartState::Current()->window()->viewport_metrics().device_pixel_ratio;
   external_allocation_size_ += path->path().approximateBytesUsed();
-  flutter::PhysicalShapeLayer::DrawShadow(canvas_, path->path(), color,
-                                          elevation, transparentOccluder, dpr);
+  flutter::PhysicalShapeLayer::DrawShadow(canvas_, path->GetInternedPath(),
+                                          color, elevation,
+                                          transparentOccluder, dpr);
+}
+
+void Canvas::replayCommands(Dart_Handle data, int length, Dart_Handle objects) {
+  if (!canvas_)
+    return;
+
+  bool replayed = false;
+  {
+    // Decoding the paints calls into Dart, which can't be done while the
+    // command buffer is acquired, so the commands are copied out of it first.
+    std::vector<uint8_t> commands;
+    {
+      tonic::DartByteData byte_data(data);
+      if (length < 0 ||
+          static_cast<size_t>(length) > byte_data.length_in_bytes()) {
+        length = 0;
+      }
+      const uint8_t* bytes = static_cast<const uint8_t*>(byte_data.data());
+      commands.assign(bytes, bytes + length);
+    }
+    replayed =
+        ReplayCanvasCommands(this, commands.data(), commands.size(), objects);
+  }
+  if (!replayed)
+    Dart_ThrowException(
+        ToDart("Canvas command buffer contained malformed commands."));
 }
 
 void Canvas::Invalidate() {
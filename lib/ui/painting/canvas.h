@@ -164,6 +164,10 @@ class Canvas : public RefCountedDartWrappable<Canvas> {
                   double elevation,
                   bool transparentOccluder);
 
+  // Replays the first |length| bytes of the commands recorded into |data| by
+  // the Dart Canvas. See canvas_commands.h.
+  void replayCommands(Dart_Handle data, int length, Dart_Handle objects);
+
   SkCanvas* canvas() const { return canvas_; }
   void Invalidate();
 
@@ -0,0 +1,250 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+#include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/paint.h"
+#include "flutter/lib/ui/painting/rrect.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/logging/dart_error.h"
+
+namespace flutter {
+namespace {
+
+// The number of floats of an encoded RRect: its rect and the radii of its
+// four corners.
+constexpr size_t kRRectFloatCount = 12;
+
+// Reads the 32-bit words of a command buffer.
+class CommandReader {
+ public:
+  CommandReader(const uint8_t* commands, size_t size)
+      : commands_(commands), size_(size) {}
+
+  bool AtEnd() const { return offset_ == size_; }
+
+  bool ReadUInt32(uint32_t* value) { return Read(value, sizeof(*value)); }
+
+  bool ReadFloats(float* values, size_t count) {
+    return Read(values, sizeof(*values) * count);
+  }
+
+  // Returns the next |size| bytes, or null if there aren't that many left.
+  const uint8_t* ReadBytes(size_t size) {
+    if (size_ - offset_ < size) {
+      return nullptr;
+    }
+    const uint8_t* bytes = commands_ + offset_;
+    offset_ += size;
+    return bytes;
+  }
+
+ private:
+  const uint8_t* const commands_;
+  const size_t size_;
+  size_t offset_ = 0;
+
+  bool Read(void* value, size_t size) {
+    const uint8_t* bytes = ReadBytes(size);
+    if (!bytes) {
+      return false;
+    }
+    memcpy(value, bytes, size);
+    return true;
+  }
+};
+
+Dart_Handle GetObject(Dart_Handle objects, uint32_t index) {
+  Dart_Handle object = Dart_ListGetAt(objects, index);
+  return tonic::LogIfError(object) ? nullptr : object;
+}
+
+bool ReadPaint(CommandReader& reader, Dart_Handle objects, Paint* paint) {
+  uint32_t objects_index = 0;
+  if (!reader.ReadUInt32(&objects_index)) {
+    return false;
+  }
+  // The paint data is word aligned, which is all Paint reads it as.
+  const uint8_t* data = reader.ReadBytes(Paint::kDataByteCount);
+  if (!data) {
+    return false;
+  }
+  Dart_Handle paint_objects = Dart_Null();
+  if (objects_index != 0) {
+    paint_objects = GetObject(objects, objects_index - 1);
+    if (!paint_objects || !Dart_IsList(paint_objects)) {
+      return false;
+    }
+  }
+  *paint = Paint::FromEncodedData(paint_objects, data);
+  return true;
+}
+
+bool ReadRRect(CommandReader& reader, RRect* rrect) {
+  float values[kRRectFloatCount];
+  if (!reader.ReadFloats(values, kRRectFloatCount)) {
+    return false;
+  }
+  SkVector radii[4] = {{values[4], values[5]},
+                       {values[6], values[7]},
+                       {values[8], values[9]},
+                       {values[10], values[11]}};
+  rrect->sk_rrect.setRectRadii(
+      SkRect::MakeLTRB(values[0], values[1], values[2], values[3]), radii);
+  rrect->is_null = false;
+  return true;
+}
+
+// Returns null if the index isn't that of an Image.
+CanvasImage* ReadImage(CommandReader& reader, Dart_Handle objects) {
+  uint32_t index = 0;
+  if (!reader.ReadUInt32(&index)) {
+    return nullptr;
+  }
+  Dart_Handle image = GetObject(objects, index);
+  if (!image || Dart_IsNull(image)) {
+    return nullptr;
+  }
+  return tonic::DartConverter<CanvasImage*>::FromDart(image);
+}
+
+}  // namespace
+
+bool ReplayCanvasCommands(Canvas* canvas,
+                          const uint8_t* commands,
+                          size_t size,
+                          Dart_Handle objects) {
+  if (size % sizeof(uint32_t) != 0 || !Dart_IsList(objects)) {
+    return false;
+  }
+
+  CommandReader reader(commands, size);
+  PaintData paint_data;
+  float args[8];
+  while (!reader.AtEnd()) {
+    uint32_t opcode = 0;
+    reader.ReadUInt32(&opcode);
+    if (opcode > static_cast<uint32_t>(CanvasCommand::kLast)) {
+      FML_LOG(ERROR) << "Unknown canvas command " << opcode << ".";
+      return false;
+    }
+
+    Paint paint;
+    RRect rrect;
+    bool read = true;
+    switch (static_cast<CanvasCommand>(opcode)) {
+      case CanvasCommand::kSave:
+        canvas->save();
+        break;
+      case CanvasCommand::kRestore:
+        canvas->restore();
+        break;
+      case CanvasCommand::kTranslate:
+        if ((read = reader.ReadFloats(args, 2)))
+          canvas->translate(args[0], args[1]);
+        break;
+      case CanvasCommand::kScale:
+        if ((read = reader.ReadFloats(args, 2)))
+          canvas->scale(args[0], args[1]);
+        break;
+      case CanvasCommand::kRotate:
+        if ((read = reader.ReadFloats(args, 1)))
+          canvas->rotate(args[0]);
+        break;
+      case CanvasCommand::kSkew:
+        if ((read = reader.ReadFloats(args, 2)))
+          canvas->skew(args[0], args[1]);
+        break;
+      case CanvasCommand::kClipRect: {
+        uint32_t clip_op = 0;
+        uint32_t anti_alias = 0;
+        read = reader.ReadFloats(args, 4) && reader.ReadUInt32(&clip_op) &&
+               reader.ReadUInt32(&anti_alias) &&
+               clip_op <= static_cast<uint32_t>(SkClipOp::kIntersect);
+        if (read)
+          canvas->clipRect(args[0], args[1], args[2], args[3],
+                           static_cast<SkClipOp>(clip_op), anti_alias != 0);
+        break;
+      }
+      case CanvasCommand::kClipRRect: {
+        uint32_t anti_alias = 0;
+        read = ReadRRect(reader, &rrect) && reader.ReadUInt32(&anti_alias);
+        if (read)
+          canvas->clipRRect(rrect, anti_alias != 0);
+        break;
+      }
+      case CanvasCommand::kDrawColor: {
+        uint32_t color = 0;
+        uint32_t blend_mode = 0;
+        read = reader.ReadUInt32(&color) && reader.ReadUInt32(&blend_mode) &&
+               blend_mode <= static_cast<uint32_t>(SkBlendMode::kLastMode);
+        if (read)
+          canvas->drawColor(color, static_cast<SkBlendMode>(blend_mode));
+        break;
+      }
+      case CanvasCommand::kDrawLine:
+        read = reader.ReadFloats(args, 4) && ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawLine(args[0], args[1], args[2], args[3], paint,
+                           paint_data);
+        break;
+      case CanvasCommand::kDrawPaint:
+        if ((read = ReadPaint(reader, objects, &paint)))
+          canvas->drawPaint(paint, paint_data);
+        break;
+      case CanvasCommand::kDrawRect:
+        read = reader.ReadFloats(args, 4) && ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawRect(args[0], args[1], args[2], args[3], paint,
+                           paint_data);
+        break;
+      case CanvasCommand::kDrawRRect:
+        read = ReadRRect(reader, &rrect) && ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawRRect(rrect, paint, paint_data);
+        break;
+      case CanvasCommand::kDrawOval:
+        read = reader.ReadFloats(args, 4) && ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawOval(args[0], args[1], args[2], args[3], paint,
+                           paint_data);
+        break;
+      case CanvasCommand::kDrawCircle:
+        read = reader.ReadFloats(args, 3) && ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawCircle(args[0], args[1], args[2], paint, paint_data);
+        break;
+      case CanvasCommand::kDrawImage: {
+        CanvasImage* image = ReadImage(reader, objects);
+        read = image && reader.ReadFloats(args, 2) &&
+               ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawImage(image, args[0], args[1], paint, paint_data);
+        break;
+      }
+      case CanvasCommand::kDrawImageRect: {
+        CanvasImage* image = ReadImage(reader, objects);
+        read = image && reader.ReadFloats(args, 8) &&
+               ReadPaint(reader, objects, &paint);
+        if (read)
+          canvas->drawImageRect(image, args[0], args[1], args[2], args[3],
+                                args[4], args[5], args[6], args[7], paint,
+                                paint_data);
+        break;
+      }
+    }
+    if (!read) {
+      FML_LOG(ERROR) << "Malformed canvas command " << opcode << ".";
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace flutter
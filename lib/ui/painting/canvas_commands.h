@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+#define FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "third_party/dart/runtime/include/dart_api.h"
+
+namespace flutter {
+
+class Canvas;
+
+// The commands a Dart Canvas records into its command buffer, instead of
+// making a native call for each of them, when the command buffer is enabled.
+//
+// Each command is a 32-bit opcode followed by its arguments, which are 32-bit
+// floats and integers, in the order of the arguments of the Canvas method.
+// Paints are the index of their object list plus one, or zero if they have
+// none, followed by their encoded data. Images are an index in the object
+// list too.
+//
+// Must be kept in sync with _CanvasCommands in painting.dart.
+enum class CanvasCommand : uint32_t {
+  kSave,
+  kRestore,
+  kTranslate,
+  kScale,
+  kRotate,
+  kSkew,
+  kClipRect,
+  kClipRRect,
+  kDrawColor,
+  kDrawLine,
+  kDrawPaint,
+  kDrawRect,
+  kDrawRRect,
+  kDrawOval,
+  kDrawCircle,
+  kDrawImage,
+  kDrawImageRect,
+  kLast = kDrawImageRect,
+};
+
+// Replays the |size| bytes of recorded |commands| into |canvas|, looking the
+// paint objects and images they refer to up in the |objects| list.
+//
+// The commands must not be in the Dart heap, since decoding the paints calls
+// into Dart. Returns false at the first malformed command, after replaying
+// the commands before it.
+bool ReplayCanvasCommands(Canvas* canvas,
+                          const uint8_t* commands,
+                          size_t size,
+                          Dart_Handle objects);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
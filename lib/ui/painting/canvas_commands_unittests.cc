@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/picture.h"
+#include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+TEST_F(ShellTest, CanvasReplaysRecordedCommandsInOrder) {
+  fml::AutoResetWaitableEvent message_latch;
+
+  auto nativeValidateCanvasCommands = [&](Dart_NativeArguments args) {
+    auto nested_save_count =
+        tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 0));
+    auto save_count =
+        tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 1));
+    ASSERT_EQ(nested_save_count, 2);
+    ASSERT_EQ(save_count, 1);
+
+    intptr_t peer = 0;
+    Dart_Handle result = Dart_GetNativeInstanceField(
+        Dart_GetNativeArgument(args, 2), tonic::DartWrappable::kPeerIndex,
+        &peer);
+    ASSERT_FALSE(Dart_IsError(result));
+    Picture* picture = reinterpret_cast<Picture*>(peer);
+    // At least the eight draws the fixture makes.
+    ASSERT_GE(picture->picture()->approximateOpCount(), 8);
+    message_latch.Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  settings.enable_canvas_command_buffer = true;
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateCanvasCommands",
+                    CREATE_NATIVE_ENTRY(nativeValidateCanvasCommands));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("recordCanvasCommands");
+
+  shell->RunEngine(std::move(configuration), [&](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch.Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -10,6 +10,7 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/compressed_texture.h"
 #include "flutter/lib/ui/painting/frame_info.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
@@ -198,9 +199,19 @@ static void InstantiateImageCodec(Dart_NativeArguments args) {
   const bool allow_upscaling =
       tonic::DartConverter<bool>::FromDart(Dart_GetNativeArgument(args, 5));
 
+  std::optional<CompressedTexture> compressed_texture;
+  if (!image_info && CompressedTexture::IsContainer(*buffer)) {
+    compressed_texture = CompressedTexture::Parse(buffer);
+    if (!compressed_texture) {
+      Dart_SetReturnValue(args,
+                          ToDart("Could not read the compressed texture."));
+      return;
+    }
+  }
+
   std::unique_ptr<SkCodec> codec;
   bool single_frame;
-  if (image_info) {
+  if (image_info || compressed_texture) {
     single_frame = true;
   } else {
     codec = SkCodec::MakeFromData(buffer);
@@ -216,6 +227,7 @@ static void InstantiateImageCodec(Dart_NativeArguments args) {
   if (single_frame) {
     ImageDecoder::ImageDescriptor descriptor;
     descriptor.decompressed_image_info = image_info;
+    descriptor.compressed_texture = std::move(compressed_texture);
 
     if (target_width > 0) {
       descriptor.target_width = target_width;
@@ -230,7 +242,11 @@ static void InstantiateImageCodec(Dart_NativeArguments args) {
 
     ui_codec = fml::MakeRefCounted<SingleFrameCodec>(std::move(descriptor));
   } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(std::move(codec));
+    ImageDecoder::AnimatedImageOptions options;
+    if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+      options = image_decoder->GetAnimatedImageOptions();
+    }
+    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(std::move(codec), options);
   }
 
   tonic::DartInvoke(callback_handle, {ToDart(ui_codec)});
@@ -32,7 +32,9 @@ class Codec : public RefCountedDartWrappable<Codec> {
 
   virtual Dart_Handle getNextFrame(Dart_Handle callback_handle) = 0;
 
-  void dispose();
+  // Releases the codec's Dart wrapper. Subclasses also stop the decodes in
+  // flight whose frames nobody will ask for anymore.
+  virtual void dispose();
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 };
@@ -0,0 +1,289 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/compressed_texture.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+namespace {
+
+constexpr uint8_t kKTXIdentifier[] = {0xAB, 'K',  'T',  'X',  ' ',  '1',
+                                      '1',  0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr uint8_t kKTX2Identifier[] = {0xAB, 'K',  'T',  'X',  ' ',  '2',
+                                       '0',  0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t kIdentifierSize = sizeof(kKTXIdentifier);
+
+// The size of the KTX header, which is followed by the key/value data and
+// then by each level, prefixed by its size.
+constexpr size_t kKTXHeaderSize = 64;
+constexpr uint32_t kKTXEndianness = 0x04030201;
+constexpr uint32_t kKTXSwappedEndianness = 0x01020304;
+
+// The size of the KTX2 header and index, which are followed by the level
+// index, the offsets and sizes of each level.
+constexpr size_t kKTX2LevelIndexOffset = 80;
+constexpr size_t kKTX2LevelIndexEntrySize = 24;
+
+// From the OpenGL ES and Vulkan specifications.
+constexpr uint32_t kGLCompressedRGBS3TCDXT1 = 0x83F0;
+constexpr uint32_t kGLCompressedRGBAS3TCDXT1 = 0x83F1;
+constexpr uint32_t kGLETC1RGB8 = 0x8D64;
+constexpr uint32_t kGLCompressedRGB8ETC2 = 0x9274;
+constexpr uint32_t kVkFormatBC1RGBUnormBlock = 131;
+constexpr uint32_t kVkFormatBC1RGBAUnormBlock = 133;
+constexpr uint32_t kVkFormatETC2R8G8B8UnormBlock = 147;
+
+// Reads the little or big endian integers of a container.
+class Reader {
+ public:
+  explicit Reader(const SkData& data) : data_(data) {}
+
+  void set_swapped(bool swapped) { swapped_ = swapped; }
+
+  bool ReadUInt32(size_t offset, uint32_t* value) const {
+    return Read(offset, sizeof(*value), value);
+  }
+
+  bool ReadUInt64(size_t offset, uint64_t* value) const {
+    return Read(offset, sizeof(*value), value);
+  }
+
+ private:
+  const SkData& data_;
+  bool swapped_ = false;
+
+  template <typename T>
+  bool Read(size_t offset, size_t size, T* value) const {
+    if (offset > data_.size() || data_.size() - offset < size) {
+      return false;
+    }
+    uint8_t bytes[sizeof(T)];
+    memcpy(bytes, data_.bytes() + offset, size);
+    // Containers are little endian unless swapped, like the platforms.
+    if (swapped_) {
+      std::reverse(bytes, bytes + size);
+    }
+    memcpy(value, bytes, size);
+    return true;
+  }
+};
+
+bool StartsWith(const SkData& data, const uint8_t (&identifier)[12]) {
+  return data.size() >= kIdentifierSize &&
+         memcmp(data.data(), identifier, kIdentifierSize) == 0;
+}
+
+SkISize LevelDimensions(const SkISize& dimensions, size_t level) {
+  return SkISize::Make(std::max(dimensions.width() >> level, 1),
+                       std::max(dimensions.height() >> level, 1));
+}
+
+// All the supported compression types store 4x4 blocks of pixels in 8 bytes.
+size_t LevelSize(const SkISize& dimensions) {
+  return ((static_cast<size_t>(dimensions.width()) + 3) / 4) *
+         ((static_cast<size_t>(dimensions.height()) + 3) / 4) * 8;
+}
+
+size_t FullMipChainLevelCount(const SkISize& dimensions) {
+  size_t count = 1;
+  for (int size = std::max(dimensions.width(), dimensions.height()); size > 1;
+       size >>= 1) {
+    count++;
+  }
+  return count;
+}
+
+std::optional<SkImage::CompressionType> TypeForGLFormat(uint32_t format) {
+  switch (format) {
+    case kGLETC1RGB8:
+    case kGLCompressedRGB8ETC2:
+      return SkImage::CompressionType::kETC2_RGB8_UNORM;
+    case kGLCompressedRGBS3TCDXT1:
+      return SkImage::CompressionType::kBC1_RGB8_UNORM;
+    case kGLCompressedRGBAS3TCDXT1:
+      return SkImage::CompressionType::kBC1_RGBA8_UNORM;
+  }
+  return std::nullopt;
+}
+
+std::optional<SkImage::CompressionType> TypeForVkFormat(uint32_t format) {
+  switch (format) {
+    case kVkFormatETC2R8G8B8UnormBlock:
+      return SkImage::CompressionType::kETC2_RGB8_UNORM;
+    case kVkFormatBC1RGBUnormBlock:
+      return SkImage::CompressionType::kBC1_RGB8_UNORM;
+    case kVkFormatBC1RGBAUnormBlock:
+      return SkImage::CompressionType::kBC1_RGBA8_UNORM;
+  }
+  return std::nullopt;
+}
+
+// Returns the number of levels to read of a texture with |level_count|
+// levels: all of them if they're a full mip chain, otherwise only the base
+// level.
+size_t LevelsToRead(const SkISize& dimensions, uint32_t level_count) {
+  return level_count == FullMipChainLevelCount(dimensions) ? level_count : 1;
+}
+
+std::optional<CompressedTexture> ParseKTX(const sk_sp<SkData>& data) {
+  Reader reader(*data);
+  uint32_t endianness = 0;
+  if (!reader.ReadUInt32(kIdentifierSize, &endianness) ||
+      (endianness != kKTXEndianness && endianness != kKTXSwappedEndianness)) {
+    FML_LOG(ERROR) << "Invalid KTX header.";
+    return std::nullopt;
+  }
+  reader.set_swapped(endianness == kKTXSwappedEndianness);
+
+  uint32_t header[13];
+  for (size_t i = 0; i < 13; i++) {
+    if (!reader.ReadUInt32(kIdentifierSize + i * 4, &header[i])) {
+      FML_LOG(ERROR) << "Invalid KTX header.";
+      return std::nullopt;
+    }
+  }
+  const uint32_t gl_type = header[1];
+  const uint32_t gl_internal_format = header[4];
+  const uint32_t width = header[6];
+  const uint32_t height = header[7];
+  const uint32_t depth = header[8];
+  const uint32_t array_elements = header[9];
+  const uint32_t faces = header[10];
+  const uint32_t level_count = std::max(header[11], 1u);
+  const uint32_t key_value_bytes = header[12];
+
+  auto type = TypeForGLFormat(gl_internal_format);
+  if (gl_type != 0 || !type) {
+    FML_LOG(ERROR) << "Unsupported KTX texture format 0x" << std::hex
+                   << gl_internal_format << ".";
+    return std::nullopt;
+  }
+  if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX ||
+      depth != 0 || array_elements != 0 || faces != 1) {
+    FML_LOG(ERROR) << "Only 2D KTX textures are supported.";
+    return std::nullopt;
+  }
+
+  CompressedTexture texture;
+  texture.type = *type;
+  texture.dimensions = SkISize::Make(width, height);
+  const size_t levels_to_read = LevelsToRead(texture.dimensions, level_count);
+  size_t offset = kKTXHeaderSize + key_value_bytes;
+  for (size_t level = 0; level < levels_to_read; level++) {
+    uint32_t level_size = 0;
+    if (!reader.ReadUInt32(offset, &level_size) ||
+        level_size != LevelSize(LevelDimensions(texture.dimensions, level)) ||
+        data->size() - offset - 4 < level_size) {
+      FML_LOG(ERROR) << "Invalid KTX level " << level << ".";
+      return std::nullopt;
+    }
+    offset += 4;
+    texture.levels.push_back(
+        SkData::MakeSubset(data.get(), offset, level_size));
+    // Levels are padded to 4 bytes, which the block sizes already are.
+    offset += level_size;
+  }
+  return texture;
+}
+
+std::optional<CompressedTexture> ParseKTX2(const sk_sp<SkData>& data) {
+  Reader reader(*data);
+  uint32_t header[9];
+  for (size_t i = 0; i < 9; i++) {
+    if (!reader.ReadUInt32(kIdentifierSize + i * 4, &header[i])) {
+      FML_LOG(ERROR) << "Invalid KTX2 header.";
+      return std::nullopt;
+    }
+  }
+  const uint32_t vk_format = header[0];
+  const uint32_t width = header[2];
+  const uint32_t height = header[3];
+  const uint32_t depth = header[4];
+  const uint32_t layers = header[5];
+  const uint32_t faces = header[6];
+  const uint32_t level_count = std::max(header[7], 1u);
+  const uint32_t supercompression = header[8];
+
+  auto type = TypeForVkFormat(vk_format);
+  if (!type || supercompression != 0) {
+    FML_LOG(ERROR) << "Unsupported KTX2 texture format " << vk_format
+                   << " with supercompression " << supercompression << ".";
+    return std::nullopt;
+  }
+  if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX ||
+      depth != 0 || layers != 0 || faces != 1) {
+    FML_LOG(ERROR) << "Only 2D KTX2 textures are supported.";
+    return std::nullopt;
+  }
+
+  CompressedTexture texture;
+  texture.type = *type;
+  texture.dimensions = SkISize::Make(width, height);
+  const size_t levels_to_read = LevelsToRead(texture.dimensions, level_count);
+  for (size_t level = 0; level < levels_to_read; level++) {
+    const size_t entry =
+        kKTX2LevelIndexOffset + level * kKTX2LevelIndexEntrySize;
+    uint64_t level_offset = 0;
+    uint64_t level_size = 0;
+    if (!reader.ReadUInt64(entry, &level_offset) ||
+        !reader.ReadUInt64(entry + 8, &level_size) ||
+        level_size != LevelSize(LevelDimensions(texture.dimensions, level)) ||
+        level_offset > data->size() ||
+        data->size() - level_offset < level_size) {
+      FML_LOG(ERROR) << "Invalid KTX2 level " << level << ".";
+      return std::nullopt;
+    }
+    texture.levels.push_back(
+        SkData::MakeSubset(data.get(), level_offset, level_size));
+  }
+  return texture;
+}
+
+}  // namespace
+
+std::optional<CompressedTexture> CompressedTexture::Parse(
+    const sk_sp<SkData>& data) {
+  if (!data) {
+    return std::nullopt;
+  }
+  if (StartsWith(*data, kKTXIdentifier)) {
+    return ParseKTX(data);
+  }
+  if (StartsWith(*data, kKTX2Identifier)) {
+    return ParseKTX2(data);
+  }
+  return std::nullopt;
+}
+
+bool CompressedTexture::IsContainer(const SkData& data) {
+  return StartsWith(data, kKTXIdentifier) || StartsWith(data, kKTX2Identifier);
+}
+
+bool CompressedTexture::HasMipmaps() const {
+  return levels.size() > 1;
+}
+
+sk_sp<SkData> CompressedTexture::PackLevels() const {
+  if (levels.size() == 1) {
+    return levels.front();
+  }
+  size_t size = 0;
+  for (const auto& level : levels) {
+    size += level->size();
+  }
+  auto packed = SkData::MakeUninitialized(size);
+  auto* bytes = static_cast<uint8_t*>(packed->writable_data());
+  for (const auto& level : levels) {
+    memcpy(bytes, level->data(), level->size());
+    bytes += level->size();
+  }
+  return packed;
+}
+
+}  // namespace flutter
@@ -0,0 +1,49 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_COMPRESSED_TEXTURE_H_
+#define FLUTTER_LIB_UI_PAINTING_COMPRESSED_TEXTURE_H_
+
+#include <optional>
+#include <vector>
+
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+// A GPU compressed texture read from a KTX or KTX2 container. The texture is
+// uploaded to the GPU as is instead of being decoded, where the GPU supports
+// its compression type.
+//
+// Only the compression types Skia can upload are read: ETC2 (and ETC1, which
+// ETC2 decoders decode) and BC1.
+struct CompressedTexture {
+  SkImage::CompressionType type = SkImage::CompressionType::kNone;
+  SkISize dimensions = SkISize::MakeEmpty();
+  // The levels of the texture, from the base level down. Either only the base
+  // level or its full mip chain. The levels share the container's data.
+  std::vector<sk_sp<SkData>> levels;
+
+  // Returns the texture in |data| if it's a KTX or KTX2 container of a single
+  // 2D texture of a supported compression type. Returns nothing for other data
+  // and for malformed containers.
+  static std::optional<CompressedTexture> Parse(const sk_sp<SkData>& data);
+
+  // Whether |data| starts with the identifier of a KTX or KTX2 container.
+  static bool IsContainer(const SkData& data);
+
+  // Whether the texture has its mip chain.
+  bool HasMipmaps() const;
+
+  // Returns the levels one after the other, which is how Skia reads the
+  // levels of a texture. Only copies the data if there are several levels.
+  sk_sp<SkData> PackLevels() const;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_COMPRESSED_TEXTURE_H_
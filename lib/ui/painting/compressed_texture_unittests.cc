@@ -0,0 +1,177 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/compressed_texture.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+// The sizes of the levels of an 8x8 texture of 4x4 blocks of 8 bytes.
+static const std::vector<size_t> kLevelSizes = {32, 8, 8, 8};
+
+static void AppendUInt32(std::vector<uint8_t>* bytes, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    bytes->push_back((value >> (i * 8)) & 0xFF);
+  }
+}
+
+static void AppendUInt64(std::vector<uint8_t>* bytes, uint64_t value) {
+  AppendUInt32(bytes, value & 0xFFFFFFFF);
+  AppendUInt32(bytes, value >> 32);
+}
+
+// Fills each level with its index.
+static void AppendLevel(std::vector<uint8_t>* bytes, size_t level) {
+  bytes->insert(bytes->end(), kLevelSizes[level], static_cast<uint8_t>(level));
+}
+
+static sk_sp<SkData> MakeKTX(uint32_t gl_internal_format,
+                             uint32_t level_count) {
+  std::vector<uint8_t> bytes = {0xAB, 'K',  'T',  'X',  ' ',  '1',
+                                '1',  0xBB, '\r', '\n', 0x1A, '\n'};
+  AppendUInt32(&bytes, 0x04030201);          // endianness
+  AppendUInt32(&bytes, 0);                   // glType
+  AppendUInt32(&bytes, 1);                   // glTypeSize
+  AppendUInt32(&bytes, 0);                   // glFormat
+  AppendUInt32(&bytes, gl_internal_format);  // glInternalFormat
+  AppendUInt32(&bytes, 0x1907);              // glBaseInternalFormat
+  AppendUInt32(&bytes, 8);                   // pixelWidth
+  AppendUInt32(&bytes, 8);                   // pixelHeight
+  AppendUInt32(&bytes, 0);                   // pixelDepth
+  AppendUInt32(&bytes, 0);                   // numberOfArrayElements
+  AppendUInt32(&bytes, 1);                   // numberOfFaces
+  AppendUInt32(&bytes, level_count);         // numberOfMipmapLevels
+  AppendUInt32(&bytes, 4);                   // bytesOfKeyValueData
+  AppendUInt32(&bytes, 0);                   // key/value data
+  for (size_t level = 0; level < level_count; level++) {
+    AppendUInt32(&bytes, kLevelSizes[level]);
+    AppendLevel(&bytes, level);
+  }
+  return SkData::MakeWithCopy(bytes.data(), bytes.size());
+}
+
+static sk_sp<SkData> MakeKTX2(uint32_t vk_format, uint32_t level_count) {
+  std::vector<uint8_t> bytes = {0xAB, 'K',  'T',  'X',  ' ',  '2',
+                                '0',  0xBB, '\r', '\n', 0x1A, '\n'};
+  AppendUInt32(&bytes, vk_format);    // vkFormat
+  AppendUInt32(&bytes, 1);            // typeSize
+  AppendUInt32(&bytes, 8);            // pixelWidth
+  AppendUInt32(&bytes, 8);            // pixelHeight
+  AppendUInt32(&bytes, 0);            // pixelDepth
+  AppendUInt32(&bytes, 0);            // layerCount
+  AppendUInt32(&bytes, 1);            // faceCount
+  AppendUInt32(&bytes, level_count);  // levelCount
+  AppendUInt32(&bytes, 0);            // supercompressionScheme
+  // The data format descriptor and the key/value and supercompression data,
+  // which are empty.
+  for (int i = 0; i < 4; i++) {
+    AppendUInt32(&bytes, 0);
+  }
+  AppendUInt64(&bytes, 0);
+  AppendUInt64(&bytes, 0);
+
+  // The levels are stored smallest first, after the level index.
+  const size_t data_offset = bytes.size() + level_count * 24;
+  std::vector<size_t> offsets(level_count);
+  size_t offset = data_offset;
+  for (size_t level = level_count; level-- > 0;) {
+    offsets[level] = offset;
+    offset += kLevelSizes[level];
+  }
+  for (size_t level = 0; level < level_count; level++) {
+    AppendUInt64(&bytes, offsets[level]);
+    AppendUInt64(&bytes, kLevelSizes[level]);
+    AppendUInt64(&bytes, kLevelSizes[level]);
+  }
+  for (size_t level = level_count; level-- > 0;) {
+    AppendLevel(&bytes, level);
+  }
+  return SkData::MakeWithCopy(bytes.data(), bytes.size());
+}
+
+static void ExpectLevelsArePacked(const CompressedTexture& texture) {
+  auto packed = texture.PackLevels();
+  ASSERT_TRUE(packed);
+  const auto* bytes = static_cast<const uint8_t*>(packed->data());
+  size_t offset = 0;
+  for (size_t level = 0; level < texture.levels.size(); level++) {
+    for (size_t i = 0; i < kLevelSizes[level]; i++) {
+      ASSERT_EQ(bytes[offset + i], level);
+    }
+    offset += kLevelSizes[level];
+  }
+  ASSERT_EQ(packed->size(), offset);
+}
+
+TEST(CompressedTextureTest, ReadsKTXTextures) {
+  // GL_COMPRESSED_RGB8_ETC2
+  auto data = MakeKTX(0x9274, 4);
+  ASSERT_TRUE(CompressedTexture::IsContainer(*data));
+  auto texture = CompressedTexture::Parse(data);
+  ASSERT_TRUE(texture.has_value());
+  ASSERT_EQ(texture->type, SkImage::CompressionType::kETC2_RGB8_UNORM);
+  ASSERT_EQ(texture->dimensions, SkISize::Make(8, 8));
+  ASSERT_EQ(texture->levels.size(), 4u);
+  ASSERT_TRUE(texture->HasMipmaps());
+  ExpectLevelsArePacked(*texture);
+
+  // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+  texture = CompressedTexture::Parse(MakeKTX(0x83F1, 1));
+  ASSERT_TRUE(texture.has_value());
+  ASSERT_EQ(texture->type, SkImage::CompressionType::kBC1_RGBA8_UNORM);
+  ASSERT_EQ(texture->levels.size(), 1u);
+  ASSERT_FALSE(texture->HasMipmaps());
+  ExpectLevelsArePacked(*texture);
+}
+
+TEST(CompressedTextureTest, ReadsKTX2Textures) {
+  // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+  auto data = MakeKTX2(147, 4);
+  ASSERT_TRUE(CompressedTexture::IsContainer(*data));
+  auto texture = CompressedTexture::Parse(data);
+  ASSERT_TRUE(texture.has_value());
+  ASSERT_EQ(texture->type, SkImage::CompressionType::kETC2_RGB8_UNORM);
+  ASSERT_EQ(texture->dimensions, SkISize::Make(8, 8));
+  ASSERT_EQ(texture->levels.size(), 4u);
+  ExpectLevelsArePacked(*texture);
+}
+
+TEST(CompressedTextureTest, OnlyReadsTheBaseLevelOfPartialMipChains) {
+  auto texture = CompressedTexture::Parse(MakeKTX(0x9274, 2));
+  ASSERT_TRUE(texture.has_value());
+  ASSERT_EQ(texture->levels.size(), 1u);
+
+  texture = CompressedTexture::Parse(MakeKTX2(147, 3));
+  ASSERT_TRUE(texture.has_value());
+  ASSERT_EQ(texture->levels.size(), 1u);
+  ExpectLevelsArePacked(*texture);
+}
+
+TEST(CompressedTextureTest, RejectsUnsupportedAndMalformedTextures) {
+  // GL_COMPRESSED_RGBA_ASTC_4x4_KHR and VK_FORMAT_ASTC_4x4_UNORM_BLOCK.
+  ASSERT_FALSE(CompressedTexture::Parse(MakeKTX(0x93B0, 1)).has_value());
+  ASSERT_FALSE(CompressedTexture::Parse(MakeKTX2(157, 1)).has_value());
+
+  auto data = MakeKTX(0x9274, 4);
+  auto truncated = SkData::MakeWithCopy(data->data(), data->size() - 1);
+  ASSERT_TRUE(CompressedTexture::IsContainer(*truncated));
+  ASSERT_FALSE(CompressedTexture::Parse(truncated).has_value());
+
+  data = MakeKTX2(147, 1);
+  truncated = SkData::MakeWithCopy(data->data(), 40);
+  ASSERT_FALSE(CompressedTexture::Parse(truncated).has_value());
+
+  const char png[] = "\x89PNG\r\n\x1A\n\0\0\0\0";
+  auto not_a_container = SkData::MakeWithCopy(png, sizeof(png));
+  ASSERT_FALSE(CompressedTexture::IsContainer(*not_a_container));
+  ASSERT_FALSE(CompressedTexture::Parse(not_a_container).has_value());
+}
+
+}  // namespace testing
+}  // namespace flutter
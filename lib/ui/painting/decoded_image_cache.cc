@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include "flutter/fml/hash.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+static uint64_t HashTarget(std::optional<uint32_t> target) {
+  return target ? (uint64_t{1} << 32) | target.value() : 0;
+}
+
+DecodedImageCache::Key::Key(sk_sp<SkData> p_data,
+                            std::optional<uint32_t> p_target_width,
+                            std::optional<uint32_t> p_target_height,
+                            ImageUpscalingMode p_image_upscaling)
+    : data(std::move(p_data)),
+      data_hash(fml::HashBytes(data->data(), data->size())),
+      target_width(p_target_width),
+      target_height(p_target_height),
+      image_upscaling(p_image_upscaling) {}
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  if (data_hash != other.data_hash || target_width != other.target_width ||
+      target_height != other.target_height ||
+      image_upscaling != other.image_upscaling) {
+    return false;
+  }
+  return data == other.data || data->equals(other.data.get());
+}
+
+size_t DecodedImageCache::Key::Hash::operator()(const Key& key) const {
+  uint64_t hash = fml::HashMix(key.data_hash, HashTarget(key.target_width));
+  hash = fml::HashMix(hash, HashTarget(key.target_height));
+  hash = fml::HashMix(hash, static_cast<uint64_t>(key.image_upscaling));
+  return static_cast<size_t>(hash);
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      memory_charge_(fml::MemoryCounter::Get("DecodedImageCache")) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+bool DecodedImageCache::Request(const Key& key, Callback callback) {
+  SkiaGPUObject<SkImage> image;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      auto [pending, inserted] = pending_.try_emplace(key);
+      pending->second.push_back(std::move(callback));
+      return inserted;
+    }
+    // Moves the entry to the front.
+    entries_.splice(entries_.begin(), entries_, found->second);
+    const Entry& entry = *found->second;
+    image = {entry.image.get(), entry.image.queue()};
+  }
+  TRACE_EVENT0("flutter", "DecodedImageCache::Hit");
+  callback(std::move(image));
+  return false;
+}
+
+void DecodedImageCache::Complete(const Key& key,
+                                 SkiaGPUObject<SkImage> image) {
+  std::vector<Callback> callbacks;
+  // Each callback gets a reference of its own.
+  const sk_sp<SkImage> shared_image = image.get();
+  const fml::RefPtr<SkiaUnrefQueue> unref_queue = image.queue();
+  LRUList evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    auto pending = pending_.find(key);
+    FML_DCHECK(pending != pending_.end());
+    if (pending != pending_.end()) {
+      callbacks = std::move(pending->second);
+      pending_.erase(pending);
+    }
+
+    const size_t bytes =
+        shared_image ? shared_image->imageInfo().computeMinByteSize() +
+                           key.data->size()
+                     : 0;
+    if (shared_image && bytes <= max_bytes_ && index_.count(key) == 0) {
+      evicted = EvictLocked(max_bytes_ - bytes, false);
+      entries_.push_front({key, std::move(image), shared_image.get(), bytes});
+      index_.emplace(key, entries_.begin());
+      bytes_ += bytes;
+      memory_charge_.Update(bytes_);
+    }
+  }
+
+  for (auto& callback : callbacks) {
+    if (shared_image) {
+      callback({shared_image, unref_queue});
+    } else {
+      callback({});
+    }
+  }
+}
+
+bool DecodedImageCache::Abandon(const Key& key) {
+  Callback callback;
+  {
+    std::scoped_lock lock(mutex_);
+    auto pending = pending_.find(key);
+    FML_DCHECK(pending != pending_.end());
+    if (pending == pending_.end() || pending->second.size() != 1) {
+      return false;
+    }
+    callback = std::move(pending->second.front());
+    pending_.erase(pending);
+  }
+  callback({});
+  return true;
+}
+
+void DecodedImageCache::PurgeUnusedImages() {
+  LRUList evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    evicted = EvictLocked(0, true);
+  }
+}
+
+void DecodedImageCache::Clear() {
+  LRUList evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    evicted = EvictLocked(0, false);
+  }
+}
+
+size_t DecodedImageCache::GetBytes() const {
+  std::scoped_lock lock(mutex_);
+  return bytes_;
+}
+
+size_t DecodedImageCache::GetImageCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+DecodedImageCache::LRUList DecodedImageCache::EvictLocked(size_t max_bytes,
+                                                          bool only_unused) {
+  LRUList evicted;
+  auto entry = entries_.end();
+  while (bytes_ > max_bytes && entry != entries_.begin()) {
+    --entry;
+    if (only_unused && !entry->raw_image->unique()) {
+      continue;
+    }
+    index_.erase(entry->key);
+    bytes_ -= entry->bytes;
+    auto next = std::next(entry);
+    evicted.splice(evicted.end(), entries_, entry);
+    entry = next;
+  }
+  memory_charge_.Update(bytes_);
+  return evicted;
+}
+
+}  // namespace flutter
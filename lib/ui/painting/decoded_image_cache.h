@@ -0,0 +1,127 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+enum class ImageUpscalingMode;
+
+// The images decoded by an |ImageDecoder|, keyed by the contents of their
+// encoded data and the size they were decoded to.
+//
+// Requests for an image that is being decoded wait for that decode instead of
+// starting their own, so an image shown in several places at once is only
+// decoded and uploaded once. Decoded images are then kept up to a budget of
+// bytes, evicting the least recently requested ones first, so that the
+// framework evicting an image from its own cache and asking for it again
+// doesn't decode it again either.
+//
+// This class is thread-safe. Requests are made on the worker threads and the
+// decodes complete on the IO thread or the upload workers.
+class DecodedImageCache {
+ public:
+  struct Key {
+    Key(sk_sp<SkData> data,
+        std::optional<uint32_t> target_width,
+        std::optional<uint32_t> target_height,
+        ImageUpscalingMode image_upscaling);
+
+    sk_sp<SkData> data;
+    uint64_t data_hash;
+    std::optional<uint32_t> target_width;
+    std::optional<uint32_t> target_height;
+    ImageUpscalingMode image_upscaling;
+
+    // Compares the contents of the data, not only their hashes.
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      size_t operator()(const Key& key) const;
+    };
+  };
+
+  using Callback = std::function<void(SkiaGPUObject<SkImage>)>;
+
+  // Creates a cache that keeps up to |max_bytes| of decoded images, counting
+  // their encoded data too. Zero keeps no decoded images, but requests still
+  // wait for the decodes in flight.
+  explicit DecodedImageCache(size_t max_bytes);
+
+  ~DecodedImageCache();
+
+  // Requests the image for |key|. If it is cached, |callback| is called right
+  // away, and if it is being decoded, when that decode completes. Otherwise,
+  // returns true and the caller must decode the image and pass it to
+  // |Complete()|, which then calls |callback|.
+  bool Request(const Key& key, Callback callback);
+
+  // Completes the decode of |key| that a |Request()| asked for, with a null
+  // |image| if it failed. Calls the callbacks of all requests for |key| and
+  // caches the image if it fits into the budget.
+  void Complete(const Key& key, SkiaGPUObject<SkImage> image);
+
+  // Abandons the decode of |key| that a |Request()| asked for if no other
+  // request waits for it, in which case the callback of the request is called
+  // with a null image and true is returned. Otherwise, the decode must still
+  // be passed to |Complete()|.
+  bool Abandon(const Key& key);
+
+  // Evicts the images that nothing but the cache refers to anymore.
+  void PurgeUnusedImages();
+
+  // Evicts all images. Decodes in flight still complete.
+  void Clear();
+
+  // The bytes of the cached images and their encoded data.
+  size_t GetBytes() const;
+
+  size_t GetImageCount() const;
+
+ private:
+  struct Entry {
+    Key key;
+    SkiaGPUObject<SkImage> image;
+    // The same image as |image|, whose reference count tells whether
+    // anything else refers to it.
+    SkImage* raw_image;
+    size_t bytes;
+  };
+
+  using LRUList = std::list<Entry>;
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  // Most recently requested first.
+  LRUList entries_;
+  std::unordered_map<Key, LRUList::iterator, Key::Hash> index_;
+  std::unordered_map<Key, std::vector<Callback>, Key::Hash> pending_;
+  size_t bytes_ = 0;
+  fml::MemoryCharge memory_charge_;
+
+  // Returns the entries that were evicted, which must be destroyed without
+  // the lock held.
+  LRUList EvictLocked(size_t max_bytes, bool only_unused);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
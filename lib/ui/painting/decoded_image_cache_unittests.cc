@@ -0,0 +1,177 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/testing/thread_test.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+static DecodedImageCache::Key MakeKey(const std::string& contents,
+                                      std::optional<uint32_t> width = {}) {
+  return DecodedImageCache::Key(
+      SkData::MakeWithCopy(contents.data(), contents.size()), width, {},
+      ImageUpscalingMode::kNotAllowed);
+}
+
+class DecodedImageCacheTest : public ThreadTest {
+ public:
+  DecodedImageCacheTest()
+      : unref_queue_(fml::MakeRefCounted<SkiaUnrefQueue>(
+            GetCurrentTaskRunner(),
+            fml::TimeDelta::FromSeconds(0))) {}
+
+  ~DecodedImageCacheTest() { DrainUnrefQueue(); }
+
+  // A 10x10 image, which takes 400 bytes.
+  SkiaGPUObject<SkImage> MakeImage() {
+    return {SkSurface::MakeRasterN32Premul(10, 10)->makeImageSnapshot(),
+            unref_queue_};
+  }
+
+  // Releases the references that the dropped images still hold.
+  void DrainUnrefQueue() { unref_queue_->Drain(); }
+
+ private:
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+};
+
+TEST_F(DecodedImageCacheTest, KeysCompareTheContentsOfTheData) {
+  EXPECT_TRUE(MakeKey("image") == MakeKey("image"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("other"));
+  EXPECT_FALSE(MakeKey("image") == MakeKey("image", 10));
+  EXPECT_TRUE(MakeKey("image", 10) == MakeKey("image", 10));
+  EXPECT_EQ(DecodedImageCache::Key::Hash{}(MakeKey("image")),
+            DecodedImageCache::Key::Hash{}(MakeKey("image")));
+}
+
+TEST_F(DecodedImageCacheTest, ConcurrentRequestsShareOneDecode) {
+  DecodedImageCache cache(0);
+  std::vector<sk_sp<SkImage>> results;
+  auto callback = [&results](SkiaGPUObject<SkImage> image) {
+    results.push_back(image.get());
+  };
+
+  EXPECT_TRUE(cache.Request(MakeKey("image"), callback));
+  EXPECT_FALSE(cache.Request(MakeKey("image"), callback));
+  EXPECT_TRUE(cache.Request(MakeKey("image", 10), callback));
+  EXPECT_TRUE(results.empty());
+
+  auto image = MakeImage();
+  SkImage* raw_image = image.get().get();
+  cache.Complete(MakeKey("image"), std::move(image));
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].get(), raw_image);
+  EXPECT_EQ(results[1].get(), raw_image);
+
+  // Without a budget, the image is not kept.
+  EXPECT_EQ(cache.GetImageCount(), 0u);
+  EXPECT_TRUE(cache.Request(MakeKey("image"), callback));
+
+  // Failed decodes call back with null images.
+  cache.Complete(MakeKey("image", 10), {});
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[2], nullptr);
+  cache.Complete(MakeKey("image"), {});
+}
+
+TEST_F(DecodedImageCacheTest, AbandonsDecodesNoOtherRequestWaitsFor) {
+  DecodedImageCache cache(0);
+  std::vector<sk_sp<SkImage>> results;
+  auto callback = [&results](SkiaGPUObject<SkImage> image) {
+    results.push_back(image.get());
+  };
+
+  ASSERT_TRUE(cache.Request(MakeKey("image"), callback));
+  EXPECT_TRUE(cache.Abandon(MakeKey("image")));
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0], nullptr);
+
+  // The next request decodes the image again.
+  ASSERT_TRUE(cache.Request(MakeKey("image"), callback));
+  EXPECT_FALSE(cache.Request(MakeKey("image"), callback));
+  EXPECT_FALSE(cache.Abandon(MakeKey("image")));
+  EXPECT_EQ(results.size(), 1u);
+  cache.Complete(MakeKey("image"), MakeImage());
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_NE(results[1], nullptr);
+  EXPECT_NE(results[2], nullptr);
+}
+
+TEST_F(DecodedImageCacheTest, CachedImagesAreReused) {
+  DecodedImageCache cache(10000);
+  std::vector<sk_sp<SkImage>> results;
+  auto callback = [&results](SkiaGPUObject<SkImage> image) {
+    results.push_back(image.get());
+  };
+
+  ASSERT_TRUE(cache.Request(MakeKey("image"), callback));
+  cache.Complete(MakeKey("image"), MakeImage());
+  EXPECT_EQ(cache.GetImageCount(), 1u);
+  EXPECT_EQ(cache.GetBytes(), 400u + 5u);
+
+  EXPECT_FALSE(cache.Request(MakeKey("image"), callback));
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0], results[1]);
+}
+
+TEST_F(DecodedImageCacheTest, EvictsLeastRecentlyRequestedImages) {
+  // Fits two images with their one byte keys.
+  DecodedImageCache cache(802);
+  auto ignore = [](SkiaGPUObject<SkImage> image) {};
+  for (const char* name : {"a", "b"}) {
+    ASSERT_TRUE(cache.Request(MakeKey(name), ignore));
+    cache.Complete(MakeKey(name), MakeImage());
+  }
+  EXPECT_EQ(cache.GetImageCount(), 2u);
+
+  // "a" becomes the most recently requested, so "b" goes.
+  EXPECT_FALSE(cache.Request(MakeKey("a"), ignore));
+  ASSERT_TRUE(cache.Request(MakeKey("c"), ignore));
+  cache.Complete(MakeKey("c"), MakeImage());
+  EXPECT_EQ(cache.GetImageCount(), 2u);
+  EXPECT_EQ(cache.GetBytes(), 802u);
+  EXPECT_FALSE(cache.Request(MakeKey("a"), ignore));
+  EXPECT_FALSE(cache.Request(MakeKey("c"), ignore));
+  EXPECT_TRUE(cache.Request(MakeKey("b"), ignore));
+  cache.Complete(MakeKey("b"), {});
+
+  // Images larger than the budget are not kept.
+  DecodedImageCache small_cache(100);
+  ASSERT_TRUE(small_cache.Request(MakeKey("a"), ignore));
+  small_cache.Complete(MakeKey("a"), MakeImage());
+  EXPECT_EQ(small_cache.GetImageCount(), 0u);
+}
+
+TEST_F(DecodedImageCacheTest, PurgeUnusedImagesKeepsImagesInUse) {
+  DecodedImageCache cache(10000);
+  sk_sp<SkImage> in_use;
+  ASSERT_TRUE(cache.Request(MakeKey("a"), [&in_use](auto image) {
+    in_use = image.get();
+  }));
+  cache.Complete(MakeKey("a"), MakeImage());
+  ASSERT_TRUE(cache.Request(MakeKey("b"), [](auto image) {}));
+  cache.Complete(MakeKey("b"), MakeImage());
+  EXPECT_EQ(cache.GetImageCount(), 2u);
+
+  DrainUnrefQueue();
+  cache.PurgeUnusedImages();
+  EXPECT_EQ(cache.GetImageCount(), 1u);
+  EXPECT_FALSE(cache.Request(MakeKey("a"), [](auto image) {}));
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetImageCount(), 0u);
+  EXPECT_EQ(cache.GetBytes(), 0u);
+  EXPECT_TRUE(in_use != nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -19,13 +19,18 @@ EngineLayer::EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer)
 EngineLayer::~EngineLayer() = default;
 
 size_t EngineLayer::GetAllocationSize() const {
-  // Provide an approximation of the total memory impact of this object to the
-  // Dart GC.  The ContainerLayer may hold references to a tree of other layers,
-  // which in turn may contain Skia objects.
-  return 3000;
-};
+  return sizeof(EngineLayer) + retained_bytes_;
+}
+
+void EngineLayer::SetRetainedBytes(size_t retained_bytes) {
+  retained_bytes_ = retained_bytes;
+  if (dart_wrapper()) {
+    Dart_UpdateExternalSize(dart_wrapper(), GetAllocationSize());
+  }
+}
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, EngineLayer);
+IMPLEMENT_POOLED_ALLOCATION(EngineLayer);
 
 #define FOR_EACH_BINDING(V)  // nothing to bind
 
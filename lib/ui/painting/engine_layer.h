@@ -19,6 +19,7 @@ class EngineLayer;
 
 class EngineLayer : public RefCountedDartWrappable<EngineLayer> {
   DEFINE_WRAPPERTYPEINFO();
+  DEFINE_POOLED_ALLOCATION();
 
  public:
   ~EngineLayer() override;
@@ -30,19 +31,26 @@ class EngineLayer : public RefCountedDartWrappable<EngineLayer> {
     return fml::MakeRefCounted<EngineLayer>(layer);
   }
 
-  static void MakeRetained(Dart_Handle dart_handle,
-                           std::shared_ptr<flutter::ContainerLayer> layer) {
-    auto engine_layer = fml::MakeRefCounted<EngineLayer>(layer);
-    engine_layer->AssociateWithDartWrapper(dart_handle);
-  }
-
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
   std::shared_ptr<flutter::ContainerLayer> Layer() const { return layer_; }
 
+  // Makes this refer to |layer| instead, when the SceneBuilder keeps an
+  // equivalent layer of a previous frame in place of the one it built.
+  void SetLayer(std::shared_ptr<flutter::ContainerLayer> layer) {
+    layer_ = std::move(layer);
+  }
+
+  // Sets the bytes of native memory that the layer keeps alive, not counting
+  // the layers below it that have EngineLayers of their own, and reports them
+  // to the Dart garbage collector.
+  void SetRetainedBytes(size_t retained_bytes);
+
  private:
   explicit EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer);
   std::shared_ptr<flutter::ContainerLayer> layer_;
+  // Until the layer is popped, only its own object is known.
+  size_t retained_bytes_ = sizeof(flutter::ContainerLayer);
 
   FML_FRIEND_MAKE_REF_COUNTED(EngineLayer);
 };
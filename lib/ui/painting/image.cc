@@ -16,10 +16,11 @@ typedef CanvasImage Image;
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Image);
 
-#define FOR_EACH_BINDING(V) \
-  V(Image, width)           \
-  V(Image, height)          \
-  V(Image, toByteData)      \
+#define FOR_EACH_BINDING(V)  \
+  V(Image, width)            \
+  V(Image, height)           \
+  V(Image, toByteData)       \
+  V(Image, toByteDataStream) \
   V(Image, dispose)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
@@ -28,7 +29,12 @@ void CanvasImage::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
-CanvasImage::CanvasImage() = default;
+static fml::MemoryCounter* GetImagesMemoryCounter() {
+  static fml::MemoryCounter* counter = fml::MemoryCounter::Get("Images");
+  return counter;
+}
+
+CanvasImage::CanvasImage() : memory_charge_(GetImagesMemoryCounter()) {}
 
 CanvasImage::~CanvasImage() = default;
 
@@ -36,17 +42,40 @@ Dart_Handle CanvasImage::toByteData(int format, Dart_Handle callback) {
   return EncodeImage(this, format, callback);
 }
 
+Dart_Handle CanvasImage::toByteDataStream(int format,
+                                          Dart_Handle chunk_callback,
+                                          Dart_Handle done_callback) {
+  return EncodeImageInChunks(this, format, chunk_callback, done_callback);
+}
+
+void CanvasImage::set_image(flutter::SkiaGPUObject<SkImage> image) {
+  image_ = std::move(image);
+  sk_sp<SkImage> sk_image = image_.get();
+  memory_charge_.Update(
+      sk_image ? static_cast<int64_t>(
+                     sk_image->imageInfo().computeMinByteSize())
+               : 0);
+  if (dart_wrapper()) {
+    Dart_UpdateExternalSize(dart_wrapper(), GetAllocationSize());
+  }
+}
+
 void CanvasImage::dispose() {
   ClearDartWrapper();
-  image_.reset();
+  // The texture may be large, don't wait for the next drain of the queue.
+  image_.reset_promptly();
+  memory_charge_.Update(0);
 }
 
 size_t CanvasImage::GetAllocationSize() const {
   if (auto image = image_.get()) {
-    const auto& info = image->imageInfo();
-    const auto kMipmapOverhead = 4.0 / 3.0;
-    const size_t image_byte_size = info.computeMinByteSize() * kMipmapOverhead;
-    return image_byte_size + sizeof(this);
+    const size_t image_byte_size = image->imageInfo().computeMinByteSize();
+    // Textures are uploaded with mipmaps, which add a third to their size.
+    // Raster images only hold their pixels.
+    if (image->isTextureBacked()) {
+      return image_byte_size + image_byte_size / 3 + sizeof(CanvasImage);
+    }
+    return image_byte_size + sizeof(CanvasImage);
   } else {
     return sizeof(CanvasImage);
   }
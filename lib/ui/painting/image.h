@@ -6,6 +6,7 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_H_
 
 #include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -32,12 +33,14 @@ class CanvasImage final : public RefCountedDartWrappable<CanvasImage> {
 
   Dart_Handle toByteData(int format, Dart_Handle callback);
 
+  Dart_Handle toByteDataStream(int format,
+                               Dart_Handle chunk_callback,
+                               Dart_Handle done_callback);
+
   void dispose();
 
   sk_sp<SkImage> image() const { return image_.get(); }
-  void set_image(flutter::SkiaGPUObject<SkImage> image) {
-    image_ = std::move(image);
-  }
+  void set_image(flutter::SkiaGPUObject<SkImage> image);
 
   size_t GetAllocationSize() const override;
 
@@ -47,6 +50,8 @@ class CanvasImage final : public RefCountedDartWrappable<CanvasImage> {
   CanvasImage();
 
   flutter::SkiaGPUObject<SkImage> image_;
+  // The pixels of |image_|, charged to the "Images" counter.
+  fml::MemoryCharge memory_charge_;
 };
 
 }  // namespace flutter
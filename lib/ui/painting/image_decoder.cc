@@ -5,9 +5,13 @@
 #include "flutter/lib/ui/painting/image_decoder.h"
 
 #include <algorithm>
+#include <list>
+#include <mutex>
 
 #include "flutter/fml/make_copyable.h"
+#include "third_party/skia/include/codec/SkAndroidCodec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
 #include "third_party/skia/src/codec/SkCodecImageGenerator.h"
 
 namespace flutter {
@@ -17,13 +21,132 @@ constexpr double kAspectRatioChangedThreshold = 0.01;
 
 }  // namespace
 
+static SkiaGPUObject<SkImage> UploadOnIOThread(
+    const fml::WeakPtr<IOManager>& io_manager,
+    sk_sp<SkImage> image,
+    const fml::tracing::TraceFlow& flow);
+
+static std::vector<ImageUploadQueue::Worker> GetUploadQueueWorkers(
+    const fml::WeakPtr<IOManager>& io_manager);
+
+// The decodes that haven't started yet. Each decode posts a task to the
+// workers at its priority, which starts whichever pending decode has the
+// highest priority then, so that decodes whose priority was raised since
+// they were posted overtake the others. Cancelled decodes are dropped instead
+// of started.
+class ImageDecodeQueue
+    : public std::enable_shared_from_this<ImageDecodeQueue> {
+ public:
+  explicit ImageDecodeQueue(
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner)
+      : concurrent_task_runner_(std::move(concurrent_task_runner)) {}
+
+  // Queues |decode|, which runs on a worker unless |token| is cancelled
+  // before it starts. |drop| is called on a worker instead then.
+  void Push(std::shared_ptr<ImageDecodeToken> token,
+            fml::UniqueClosure decode,
+            fml::UniqueClosure drop) {
+    const fml::ConcurrentTaskPriority priority = token->GetPriority();
+    {
+      std::scoped_lock lock(mutex_);
+      pending_.push_back(
+          {std::move(token), std::move(decode), std::move(drop)});
+    }
+    PostRunNext(priority);
+  }
+
+  // Posts a task that starts the pending decode of the highest priority.
+  // There may be more of these tasks than pending decodes, as raising the
+  // priority of a decode posts another one.
+  void PostRunNext(fml::ConcurrentTaskPriority priority) {
+    concurrent_task_runner_->PostTask(
+        [queue = shared_from_this()]() { queue->RunNext(); }, priority);
+  }
+
+ private:
+  struct PendingDecode {
+    std::shared_ptr<ImageDecodeToken> token;
+    fml::UniqueClosure decode;
+    fml::UniqueClosure drop;
+  };
+
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  std::mutex mutex_;
+  // In the order the decodes were posted.
+  std::list<PendingDecode> pending_;
+
+  void RunNext() {
+    PendingDecode next;
+    {
+      std::scoped_lock lock(mutex_);
+      auto found = pending_.end();
+      for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+        // Higher priorities compare lower.
+        if (found == pending_.end() ||
+            it->token->GetPriority() < found->token->GetPriority()) {
+          found = it;
+        }
+      }
+      if (found == pending_.end()) {
+        return;
+      }
+      next = std::move(*found);
+      pending_.erase(found);
+    }
+    if (next.token->IsCancelled()) {
+      TRACE_EVENT0("flutter", "ImageDecodeCancelled");
+      next.drop();
+    } else {
+      next.decode();
+    }
+  }
+};
+
+ImageDecodeToken::ImageDecodeToken(std::weak_ptr<ImageDecodeQueue> queue)
+    : queue_(std::move(queue)) {}
+
+ImageDecodeToken::~ImageDecodeToken() = default;
+
+void ImageDecodeToken::Cancel() {
+  cancelled_ = true;
+}
+
+void ImageDecodeToken::SetPriority(fml::ConcurrentTaskPriority priority) {
+  const fml::ConcurrentTaskPriority previous = priority_.exchange(priority);
+  // Higher priorities compare lower.
+  if (priority >= previous) {
+    return;
+  }
+  if (auto queue = queue_.lock()) {
+    queue->PostRunNext(priority);
+  }
+}
+
 ImageDecoder::ImageDecoder(
     TaskRunners runners,
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-    fml::WeakPtr<IOManager> io_manager)
+    fml::WeakPtr<IOManager> io_manager,
+    size_t cache_max_bytes,
+    ImageDecoderBackends backends,
+    AnimatedImageOptions animated_image_options)
     : runners_(std::move(runners)),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      cache_(std::make_shared<DecodedImageCache>(cache_max_bytes)),
+      backends_(std::move(backends)),
+      upload_queue_(std::make_shared<ImageUploadQueue>(
+          runners_.GetIOTaskRunner(),
+          [io_manager = io_manager_](sk_sp<SkImage> image,
+                                     const fml::tracing::TraceFlow& flow) {
+            return UploadOnIOThread(io_manager, std::move(image), flow);
+          },
+          ImageUploadQueue::kDefaultMaxBatchBytes,
+          [io_manager = io_manager_]() {
+            return GetUploadQueueWorkers(io_manager);
+          })),
+      decode_queue_(
+          std::make_shared<ImageDecodeQueue>(concurrent_task_runner_)),
+      animated_image_options_(animated_image_options),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -164,11 +287,68 @@ static sk_sp<SkImage> ImageFromDecompressedData(
   return ResizeRasterImage(std::move(image), resized_dimensions, flow);
 }
 
-sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
-                                       std::optional<uint32_t> target_width,
-                                       std::optional<uint32_t> target_height,
-                                       ImageUpscalingMode image_upscaling,
-                                       const fml::tracing::TraceFlow& flow) {
+// Decodes |data| at a fraction of its size by only decoding every few rows and
+// columns, for codecs that can't scale while decoding, like the PNG codec. The
+// result is no smaller than |target_dimensions|, in the colors of |info|.
+// Returns null if sampling would not shrink the image.
+static sk_sp<SkImage> ImageFromSampledData(
+    sk_sp<SkData> data,
+    const SkImageInfo& info,
+    const SkISize& target_dimensions,
+    const fml::tracing::TraceFlow& flow) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  if (target_dimensions.isEmpty()) {
+    return nullptr;
+  }
+
+  auto codec = SkAndroidCodec::MakeFromData(std::move(data));
+  if (codec == nullptr) {
+    return nullptr;
+  }
+
+  const auto& dimensions = codec->getInfo().dimensions();
+  const int sample_size =
+      std::min(dimensions.width() / target_dimensions.width(),
+               dimensions.height() / target_dimensions.height());
+  if (sample_size <= 1) {
+    return nullptr;
+  }
+
+  auto sampled_image_info =
+      info.makeDimensions(codec->getSampledDimensions(sample_size));
+
+  SkBitmap sampled_bitmap;
+  if (!sampled_bitmap.tryAllocPixels(sampled_image_info)) {
+    FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
+                   << sampled_image_info.computeMinByteSize() << "B";
+    return nullptr;
+  }
+
+  SkAndroidCodec::AndroidOptions options;
+  options.fSampleSize = sample_size;
+  const auto& pixmap = sampled_bitmap.pixmap();
+  if (codec->getAndroidPixels(pixmap.info(), pixmap.writable_addr(),
+                              pixmap.rowBytes(),
+                              &options) != SkCodec::kSuccess) {
+    return nullptr;
+  }
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  sampled_bitmap.setImmutable();
+
+  return SkImage::MakeFromBitmap(sampled_bitmap);
+}
+
+sk_sp<SkImage> ImageFromCompressedData(
+    sk_sp<SkData> data,
+    std::optional<uint32_t> target_width,
+    std::optional<uint32_t> target_height,
+    ImageUpscalingMode image_upscaling,
+    const fml::tracing::TraceFlow& flow,
+    const std::function<bool()>& should_abandon) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
 
@@ -235,9 +415,25 @@ sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
             << "Could not create a scaled image from a scaled bitmap.";
         return nullptr;
       }
+      if (should_abandon && should_abandon()) {
+        return nullptr;
+      }
       return ResizeRasterImage(std::move(decoded_image), resized_dimensions,
                                flow);
     }
+  } else if (codec_ptr->getOrigin() == kTopLeft_SkEncodedOrigin) {
+    // Otherwise, sample the image while decoding so only a small resize is
+    // left to do. Sampling doesn't respect the image orientation, so oriented
+    // images are decoded at full resolution.
+    auto sampled_image = ImageFromSampledData(data, image_generator->getInfo(),
+                                              resized_dimensions, flow);
+    if (sampled_image) {
+      if (should_abandon && should_abandon()) {
+        return nullptr;
+      }
+      return ResizeRasterImage(std::move(sampled_image), resized_dimensions,
+                               flow);
+    }
   }
 
   auto image = SkImage::MakeFromEncoded(data);
@@ -248,9 +444,49 @@ sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
   return ResizeRasterImage(std::move(image), resized_dimensions, flow);
 }
 
+sk_sp<SkImage> ImageFromBackends(const ImageDecoderBackends& backends,
+                                 const sk_sp<SkData>& data,
+                                 std::optional<uint32_t> target_width,
+                                 std::optional<uint32_t> target_height,
+                                 ImageUpscalingMode image_upscaling,
+                                 const fml::tracing::TraceFlow& flow) {
+  for (const auto& backend : backends) {
+    auto source_dimensions = backend->GetDimensionsIfAccepted(*data);
+    if (!source_dimensions) {
+      continue;
+    }
+
+    TRACE_EVENT0("flutter", __FUNCTION__);
+    flow.Step(__FUNCTION__);
+
+    auto resized_dimensions =
+        GetResizedDimensions(source_dimensions.value(), target_width,
+                             target_height, image_upscaling);
+    if (resized_dimensions.isEmpty()) {
+      return nullptr;
+    }
+
+    auto image = backend->Decode(*data, resized_dimensions);
+    if (!image) {
+      FML_LOG(ERROR) << "Image decoder backend failed, falling back to Skia.";
+      return nullptr;
+    }
+    if (image->dimensions() == resized_dimensions) {
+      return image;
+    }
+    return ResizeRasterImage(std::move(image), resized_dimensions, flow);
+  }
+  return nullptr;
+}
+
+// Uploads |image| with |resource_context|, on the thread it belongs to. The
+// cross context image waits for the upload to complete on the GPU before the
+// raster thread draws it, whichever resource context uploaded it.
 static SkiaGPUObject<SkImage> UploadRasterImage(
     sk_sp<SkImage> image,
-    fml::WeakPtr<IOManager> io_manager,
+    const fml::WeakPtr<GrContext>& resource_context,
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue,
+    const std::shared_ptr<fml::SyncSwitch>& is_gpu_disabled_sync_switch,
     const fml::tracing::TraceFlow& flow) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
@@ -259,7 +495,7 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   // the this method.
   FML_DCHECK(!image->isTextureBacked());
 
-  if (!io_manager->GetResourceContext() || !io_manager->GetSkiaUnrefQueue()) {
+  if (!resource_context || !unref_queue) {
     FML_LOG(ERROR)
         << "Could not acquire context of release queue for texture upload.";
     return {};
@@ -272,7 +508,7 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   }
 
   SkiaGPUObject<SkImage> result;
-  io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+  is_gpu_disabled_sync_switch->Execute(
       fml::SyncSwitch::Handlers()
           .SetIfTrue([&result, &pixmap, &image] {
             SkSafeRef(image.get());
@@ -284,28 +520,236 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
                 image.get());
             result = {std::move(texture_image), nullptr};
           })
-          .SetIfFalse([&result, context = io_manager->GetResourceContext(),
-                       &pixmap, queue = io_manager->GetSkiaUnrefQueue()] {
+          .SetIfFalse([&result, &resource_context, &pixmap, &unref_queue] {
             TRACE_EVENT0("flutter", "MakeCrossContextImageFromPixmap");
             sk_sp<SkImage> texture_image = SkImage::MakeCrossContextFromPixmap(
-                context.get(),  // context
-                pixmap,         // pixmap
-                true,           // buildMips,
-                true            // limitToMaxTextureSize
+                resource_context.get(),  // context
+                pixmap,                  // pixmap
+                true,                    // buildMips,
+                true                     // limitToMaxTextureSize
             );
             if (!texture_image) {
               FML_LOG(ERROR) << "Could not make x-context image.";
               result = {};
             } else {
-              result = {std::move(texture_image), queue};
+              result = {std::move(texture_image), unref_queue};
             }
           }));
 
   return result;
 }
 
-void ImageDecoder::Decode(ImageDescriptor descriptor,
-                          const ImageResult& callback) {
+// Decompresses the image on the current worker thread, then queues it for
+// upload on the IO thread, which calls |done| once it's uploaded.
+//
+// |abandon| is called if |token| is cancelled once the image is decoded. Unless
+// it returns false, the decode stops there and |done| is not called.
+static void DecompressAndUpload(
+    ImageDecoder::ImageDescriptor descriptor,
+    const ImageDecoderBackends& backends,
+    const std::shared_ptr<ImageUploadQueue>& upload_queue,
+    std::shared_ptr<fml::tracing::TraceFlow> flow,
+    std::function<void(SkiaGPUObject<SkImage>)> done,
+    const ImageDecodeToken& token,
+    const std::function<bool()>& abandon) {
+  // Step 1: Decompress the image.
+  // On Worker.
+
+  bool abandoned = false;
+  auto should_abandon = [&token, &abandon, &abandoned]() {
+    if (!abandoned && token.IsCancelled()) {
+      abandoned = abandon();
+    }
+    return abandoned;
+  };
+
+  sk_sp<SkImage> decompressed;
+  if (descriptor.decompressed_image_info) {
+    decompressed = ImageFromDecompressedData(
+        std::move(descriptor.data),                  //
+        descriptor.decompressed_image_info.value(),  //
+        descriptor.target_width,                     //
+        descriptor.target_height,                    //
+        descriptor.image_upscaling,                  //
+        *flow                                        //
+    );
+  } else {
+    decompressed = ImageFromBackends(backends,                    //
+                                     descriptor.data,             //
+                                     descriptor.target_width,     //
+                                     descriptor.target_height,    //
+                                     descriptor.image_upscaling,  //
+                                     *flow);
+    if (!decompressed) {
+      decompressed = ImageFromCompressedData(std::move(descriptor.data),  //
+                                             descriptor.target_width,     //
+                                             descriptor.target_height,    //
+                                             descriptor.image_upscaling,  //
+                                             *flow,                       //
+                                             should_abandon);
+    }
+  }
+
+  if (should_abandon()) {
+    TRACE_EVENT0("flutter", "ImageDecodeCancelled");
+    return;
+  }
+
+  if (!decompressed) {
+    FML_LOG(ERROR) << "Could not decompress image.";
+    done({});
+    return;
+  }
+
+  // Step 2: Update the image to the GPU.
+  // On IO Thread.
+
+  upload_queue->Enqueue(std::move(decompressed), std::move(flow),
+                        std::move(done));
+}
+
+static SkiaGPUObject<SkImage> UploadOnIOThread(
+    const fml::WeakPtr<IOManager>& io_manager,
+    sk_sp<SkImage> image,
+    const fml::tracing::TraceFlow& flow) {
+  if (!io_manager) {
+    FML_LOG(ERROR) << "Could not acquire IO manager.";
+    return {};
+  }
+
+  // If the IO manager does not have a resource context, the caller
+  // might not have set one or a software backend could be in use.
+  // Either way, just return the image as-is.
+  if (!io_manager->GetResourceContext()) {
+    return {std::move(image), io_manager->GetSkiaUnrefQueue()};
+  }
+
+  auto uploaded = UploadRasterImage(
+      std::move(image), io_manager->GetResourceContext(),
+      io_manager->GetSkiaUnrefQueue(), io_manager->GetIsGpuDisabledSyncSwitch(),
+      flow);
+  if (!uploaded.get()) {
+    FML_LOG(ERROR) << "Could not upload image to the GPU.";
+  }
+  return uploaded;
+}
+
+// Returns the upload workers of |io_manager| as workers of the upload queue.
+// On the IO thread.
+static std::vector<ImageUploadQueue::Worker> GetUploadQueueWorkers(
+    const fml::WeakPtr<IOManager>& io_manager) {
+  std::vector<ImageUploadQueue::Worker> workers;
+  if (!io_manager) {
+    return workers;
+  }
+  for (auto& upload_worker : io_manager->GetUploadWorkers()) {
+    auto task_runner = upload_worker.task_runner;
+    workers.push_back(
+        {std::move(task_runner),
+         [upload_worker = std::move(upload_worker),
+          is_gpu_disabled_sync_switch =
+              io_manager->GetIsGpuDisabledSyncSwitch()](
+             sk_sp<SkImage> image, const fml::tracing::TraceFlow& flow) {
+           // On the upload worker.
+           auto uploaded = UploadRasterImage(
+               std::move(image), upload_worker.resource_context,
+               upload_worker.unref_queue, is_gpu_disabled_sync_switch, flow);
+           if (!uploaded.get()) {
+             FML_LOG(ERROR) << "Could not upload image to the GPU.";
+           }
+           return uploaded;
+         }});
+  }
+  return workers;
+}
+
+// Uploads |texture| as is if the resource context supports its compression
+// type. Returns null otherwise, or if the upload failed.
+static SkiaGPUObject<SkImage> UploadCompressedTextureOnIOThread(
+    const fml::WeakPtr<IOManager>& io_manager,
+    const CompressedTexture& texture,
+    const sk_sp<SkData>& data,
+    const fml::tracing::TraceFlow& flow) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+  if (!io_manager) {
+    FML_LOG(ERROR) << "Could not acquire IO manager.";
+    return {};
+  }
+
+  // Each GPU supports its own set of compression types.
+  auto context = io_manager->GetResourceContext();
+  if (!context || !context->compressedBackendFormat(texture.type).isValid()) {
+    return {};
+  }
+
+  SkiaGPUObject<SkImage> result;
+  io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+      fml::SyncSwitch::Handlers().SetIfFalse([&] {
+        sk_sp<SkImage> texture_image = SkImage::MakeTextureFromCompressed(
+            context.get(), data, texture.dimensions.width(),
+            texture.dimensions.height(), texture.type,
+            texture.HasMipmaps() ? GrMipMapped::kYes : GrMipMapped::kNo);
+        if (!texture_image) {
+          FML_LOG(ERROR) << "Could not upload compressed texture.";
+          return;
+        }
+        result = {std::move(texture_image), io_manager->GetSkiaUnrefQueue()};
+      }));
+  return result;
+}
+
+// Uploads |texture| on the IO thread without decompressing it where the GPU
+// supports its compression type. Otherwise, decompresses it back on a worker
+// thread and queues the decompressed image for upload like any other.
+static void UploadCompressedTexture(
+    CompressedTexture texture,
+    const fml::RefPtr<fml::TaskRunner>& io_task_runner,
+    fml::WeakPtr<IOManager> io_manager,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    std::shared_ptr<ImageUploadQueue> upload_queue,
+    std::shared_ptr<fml::tracing::TraceFlow> flow,
+    std::function<void(SkiaGPUObject<SkImage>)> done) {
+  // On Worker.
+  sk_sp<SkData> data = texture.PackLevels();
+
+  io_task_runner->PostTask(fml::MakeCopyable(
+      [texture = std::move(texture), data = std::move(data),
+       io_manager = std::move(io_manager),
+       concurrent_task_runner = std::move(concurrent_task_runner),
+       upload_queue = std::move(upload_queue), flow = std::move(flow),
+       done = std::move(done)]() mutable {
+        // On IO Thread.
+        auto uploaded =
+            UploadCompressedTextureOnIOThread(io_manager, texture, data, *flow);
+        if (uploaded.get()) {
+          done(std::move(uploaded));
+          return;
+        }
+
+        concurrent_task_runner->PostTask(fml::MakeCopyable(
+            [texture = std::move(texture), data = std::move(data),
+             upload_queue = std::move(upload_queue), flow = std::move(flow),
+             done = std::move(done)]() mutable {
+              // On Worker.
+              TRACE_EVENT0("flutter", "DecompressCompressedTexture");
+              sk_sp<SkImage> decompressed = SkImage::MakeRasterFromCompressed(
+                  std::move(data), texture.dimensions.width(),
+                  texture.dimensions.height(), texture.type);
+              if (!decompressed) {
+                FML_LOG(ERROR) << "Could not decompress compressed texture.";
+                done({});
+                return;
+              }
+              upload_queue->Enqueue(std::move(decompressed), std::move(flow),
+                                    std::move(done));
+            }));
+      }));
+}
+
+std::shared_ptr<ImageDecodeToken> ImageDecoder::Decode(
+    ImageDescriptor descriptor,
+    const ImageResult& callback) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
 
@@ -326,76 +770,85 @@ void ImageDecoder::Decode(ImageDescriptor descriptor,
         }));
   };
 
+  auto token = std::make_shared<ImageDecodeToken>(decode_queue_);
+
   if (!descriptor.data || descriptor.data->size() == 0) {
     result({}, std::move(flow));
-    return;
+    return token;
   }
 
-  concurrent_task_runner_->PostTask(
-      fml::MakeCopyable([descriptor,                              //
-                         io_manager = io_manager_,                //
-                         io_runner = runners_.GetIOTaskRunner(),  //
-                         result,                                  //
-                         flow = std::move(flow)                   //
+  // Shared by the decode, or the drop of a cancelled decode, and the
+  // callback, which runs after it.
+  auto shared_flow = std::make_shared<fml::tracing::TraceFlow>(std::move(flow));
+  auto done = [result, shared_flow](SkiaGPUObject<SkImage> image) {
+    result(std::move(image), std::move(*shared_flow));
+  };
+
+  decode_queue_->Push(
+      token,
+      [descriptor,                                        //
+       io_task_runner = runners_.GetIOTaskRunner(),       //
+       io_manager = io_manager_,                          //
+       concurrent_task_runner = concurrent_task_runner_,  //
+       upload_queue = upload_queue_,                      //
+       cache = cache_,                                    //
+       backends = backends_,                              //
+       done,                                              //
+       shared_flow,                                       //
+       token                                              //
   ]() mutable {
-        // Step 1: Decompress the image.
-        // On Worker.
-
-        auto decompressed =
-            descriptor.decompressed_image_info
-                ? ImageFromDecompressedData(
-                      std::move(descriptor.data),                  //
-                      descriptor.decompressed_image_info.value(),  //
-                      descriptor.target_width,                     //
-                      descriptor.target_height,                    //
-                      descriptor.image_upscaling,                  //
-                      flow                                         //
-                      )
-                : ImageFromCompressedData(std::move(descriptor.data),  //
-                                          descriptor.target_width,     //
-                                          descriptor.target_height,    //
-                                          descriptor.image_upscaling,  //
-                                          flow);
-
-        if (!decompressed) {
-          FML_LOG(ERROR) << "Could not decompress image.";
-          result({}, std::move(flow));
+        if (descriptor.compressed_texture) {
+          UploadCompressedTexture(std::move(*descriptor.compressed_texture),
+                                  io_task_runner, std::move(io_manager),
+                                  std::move(concurrent_task_runner),
+                                  std::move(upload_queue),
+                                  std::move(shared_flow), std::move(done));
           return;
         }
 
-        // Step 2: Update the image to the GPU.
-        // On IO Thread.
+        // Raw pixels are only copied, which isn't worth caching.
+        if (descriptor.decompressed_image_info) {
+          auto abandon = [done]() {
+            done({});
+            return true;
+          };
+          DecompressAndUpload(std::move(descriptor), backends, upload_queue,
+                              std::move(shared_flow), std::move(done), *token,
+                              abandon);
+          return;
+        }
 
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_LOG(ERROR) << "Could not acquire IO manager.";
-            return result({}, std::move(flow));
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.get()) {
-            FML_LOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
-        }));
-      }));
+        DecodedImageCache::Key key(descriptor.data, descriptor.target_width,
+                                   descriptor.target_height,
+                                   descriptor.image_upscaling);
+        if (!cache->Request(key, std::move(done))) {
+          return;
+        }
+        // Other requests of the same image may still wait for it.
+        auto abandon = [cache, key]() { return cache->Abandon(key); };
+        DecompressAndUpload(std::move(descriptor), backends, upload_queue,
+                            std::move(shared_flow),
+                            [cache, key](SkiaGPUObject<SkImage> image) {
+                              cache->Complete(key, std::move(image));
+                            },
+                            *token, abandon);
+      },
+      [done]() { done({}); });
+  return token;
+}
+
+const std::shared_ptr<DecodedImageCache>& ImageDecoder::GetCache() const {
+  return cache_;
+}
+
+const std::shared_ptr<fml::ConcurrentTaskRunner>&
+ImageDecoder::GetConcurrentTaskRunner() const {
+  return concurrent_task_runner_;
+}
+
+const ImageDecoder::AnimatedImageOptions&
+ImageDecoder::GetAnimatedImageOptions() const {
+  return animated_image_options_;
 }
 
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 
+#include <atomic>
 #include <memory>
 #include <optional>
 
@@ -15,6 +16,10 @@
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/compressed_texture.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+#include "flutter/lib/ui/painting/image_decoder_backend.h"
+#include "flutter/lib/ui/painting/image_upload_queue.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -26,17 +31,69 @@ namespace flutter {
 // Whether to allow for image upscaling when resizing an image.
 enum class ImageUpscalingMode { kAllowed, kNotAllowed };
 
+class ImageDecodeQueue;
+
+// A handle to a decode started by |ImageDecoder::Decode|, with which it can be
+// cancelled or moved ahead of other decodes. This class is thread-safe.
+class ImageDecodeToken {
+ public:
+  explicit ImageDecodeToken(std::weak_ptr<ImageDecodeQueue> queue);
+
+  ~ImageDecodeToken();
+
+  // Cancels the decode. A decode that hasn't started is dropped, and a decode
+  // that is running stops before resizing and uploading the image, unless
+  // other decodes of the same image wait for it. The callback of the decode is
+  // then called with a null image.
+  void Cancel();
+
+  bool IsCancelled() const { return cancelled_; }
+
+  // Sets the priority of the decode, e.g. to |ConcurrentTaskPriority::kHigh|
+  // once its image becomes visible. Decodes that haven't started are started
+  // in the order of their priority.
+  void SetPriority(fml::ConcurrentTaskPriority priority);
+
+  fml::ConcurrentTaskPriority GetPriority() const { return priority_; }
+
+ private:
+  std::weak_ptr<ImageDecodeQueue> queue_;
+  std::atomic_bool cancelled_ = {false};
+  std::atomic<fml::ConcurrentTaskPriority> priority_ = {
+      fml::ConcurrentTaskPriority::kNormal};
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecodeToken);
+};
+
 // An object that coordinates image decompression and texture upload across
 // multiple threads/components in the shell. This object must be created,
 // accessed and collected on the UI thread (typically the engine or its runtime
 // controller). None of the expensive operations performed by this component
 // occur in a frame pipeline.
+//
+// Decodes of encoded images go through a |DecodedImageCache|, which keeps up to
+// |cache_max_bytes| of decoded images. Encoded images that one of the
+// |backends| accepts are decoded by it instead of Skia's codecs.
 class ImageDecoder {
  public:
+  // How the codecs of animated images decode their frames.
+  struct AnimatedImageOptions {
+    // The number of frames decoded ahead of the frame last requested. Zero
+    // decodes each frame when it is requested.
+    int look_ahead_frames = 0;
+    // The maximum number of bytes of decoded frames that an animated image
+    // keeps so that the loops after the first don't decode them again. Only
+    // animations whose frames all fit are kept.
+    size_t frame_cache_max_bytes = 0;
+  };
+
   ImageDecoder(
       TaskRunners runners,
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-      fml::WeakPtr<IOManager> io_manager);
+      fml::WeakPtr<IOManager> io_manager,
+      size_t cache_max_bytes = 0,
+      ImageDecoderBackends backends = {},
+      AnimatedImageOptions animated_image_options = {});
 
   ~ImageDecoder();
 
@@ -48,6 +105,9 @@ class ImageDecoder {
   struct ImageDescriptor {
     sk_sp<SkData> data;
     std::optional<ImageInfo> decompressed_image_info;
+    // Set for GPU compressed textures, which are uploaded as is at their own
+    // size where the GPU supports their compression type.
+    std::optional<CompressedTexture> compressed_texture;
     std::optional<uint32_t> target_width;
     std::optional<uint32_t> target_height;
     ImageUpscalingMode image_upscaling = ImageUpscalingMode::kNotAllowed;
@@ -60,24 +120,58 @@ class ImageDecoder {
   // concurrently. Texture upload is done on the IO thread and the result
   // returned back on the UI thread. On error, the texture is null but the
   // callback is guaranteed to return on the UI thread.
-  void Decode(ImageDescriptor descriptor, const ImageResult& result);
+  //
+  // The returned token cancels the decode or changes its priority.
+  std::shared_ptr<ImageDecodeToken> Decode(ImageDescriptor descriptor,
+                                           const ImageResult& result);
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The cache of decoded images, which may be purged from any thread.
+  const std::shared_ptr<DecodedImageCache>& GetCache() const;
+
+  // The worker threads that images are decoded on.
+  const std::shared_ptr<fml::ConcurrentTaskRunner>& GetConcurrentTaskRunner()
+      const;
+
+  const AnimatedImageOptions& GetAnimatedImageOptions() const;
+
  private:
   TaskRunners runners_;
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   fml::WeakPtr<IOManager> io_manager_;
+  // Shared with the decodes in flight, which may outlive the decoder.
+  std::shared_ptr<DecodedImageCache> cache_;
+  ImageDecoderBackends backends_;
+  // Shared with the decodes in flight, like |cache_|.
+  std::shared_ptr<ImageUploadQueue> upload_queue_;
+  // The decodes that haven't started, shared with the workers that start
+  // them.
+  std::shared_ptr<ImageDecodeQueue> decode_queue_;
+  const AnimatedImageOptions animated_image_options_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
 };
 
-sk_sp<SkImage> ImageFromCompressedData(sk_sp<SkData> data,
-                                       std::optional<uint32_t> target_width,
-                                       std::optional<uint32_t> target_height,
-                                       ImageUpscalingMode image_upscaling,
-                                       const fml::tracing::TraceFlow& flow);
+// Returns null if |should_abandon| returns true once the image is decoded,
+// before it is resized.
+sk_sp<SkImage> ImageFromCompressedData(
+    sk_sp<SkData> data,
+    std::optional<uint32_t> target_width,
+    std::optional<uint32_t> target_height,
+    ImageUpscalingMode image_upscaling,
+    const fml::tracing::TraceFlow& flow,
+    const std::function<bool()>& should_abandon = nullptr);
+
+// Decodes the image with the first of |backends| that accepts it. Returns null
+// if none accepts it or the backend failed to decode it.
+sk_sp<SkImage> ImageFromBackends(const ImageDecoderBackends& backends,
+                                 const sk_sp<SkData>& data,
+                                 std::optional<uint32_t> target_width,
+                                 std::optional<uint32_t> target_height,
+                                 ImageUpscalingMode image_upscaling,
+                                 const fml::tracing::TraceFlow& flow);
 
 }  // namespace flutter
 
@@ -0,0 +1,37 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decoder_backend.h"
+
+#include <cstring>
+
+namespace flutter {
+
+ImageDecoderBackend::ImageDecoderBackend() = default;
+
+ImageDecoderBackend::~ImageDecoderBackend() = default;
+
+static bool HasBytesAt(const SkData& data, size_t offset, const char* bytes) {
+  const size_t size = ::strlen(bytes);
+  return data.size() >= offset + size &&
+         ::memcmp(data.bytes() + offset, bytes, size) == 0;
+}
+
+std::optional<SkEncodedImageFormat> ImageDecoderBackend::SniffFormat(
+    const SkData& data) {
+  if (HasBytesAt(data, 0, "\xFF\xD8\xFF")) {
+    return SkEncodedImageFormat::kJPEG;
+  }
+  // HEIF files start with an "ftyp" box whose major brand names the format.
+  if (HasBytesAt(data, 4, "ftyp")) {
+    for (const char* brand : {"heic", "heix", "hevc", "hevx", "mif1", "msf1"}) {
+      if (HasBytesAt(data, 8, brand)) {
+        return SkEncodedImageFormat::kHEIF;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace flutter
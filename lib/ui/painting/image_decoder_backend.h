@@ -0,0 +1,59 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_BACKEND_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_BACKEND_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkEncodedImageFormat.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+// A decoder that the |ImageDecoder| uses instead of Skia's codecs for the
+// compressed images it accepts, such as a platform decoder that decodes JPEG
+// in hardware. The |ImageDecoder| falls back to Skia's codecs for the images
+// that no backend accepts or that a backend fails to decode.
+//
+// Backends are called on the concurrent worker threads, possibly for several
+// images at once.
+class ImageDecoderBackend {
+ public:
+  ImageDecoderBackend();
+
+  virtual ~ImageDecoderBackend();
+
+  // Returns the dimensions of the image in |data|, after its orientation is
+  // applied, if this backend should decode it. Returns nothing to leave the
+  // image to the other backends or to Skia, such as for formats the backend
+  // doesn't support and images too small to be worth sending to hardware.
+  virtual std::optional<SkISize> GetDimensionsIfAccepted(
+      const SkData& data) const = 0;
+
+  // Decodes the image in |data| into a raster image of |target_dimensions|,
+  // or of the closest dimensions this backend decodes to, which the
+  // |ImageDecoder| then resizes to |target_dimensions|. Returns null if the
+  // image could not be decoded.
+  virtual sk_sp<SkImage> Decode(const SkData& data,
+                                const SkISize& target_dimensions) const = 0;
+
+  // Returns the format of |data| if it's one that the platforms have
+  // decoders for, judging by its first bytes.
+  static std::optional<SkEncodedImageFormat> SniffFormat(const SkData& data);
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderBackend);
+};
+
+using ImageDecoderBackends = std::vector<std::shared_ptr<ImageDecoderBackend>>;
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_BACKEND_H_
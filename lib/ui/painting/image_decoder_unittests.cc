@@ -4,6 +4,7 @@
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
@@ -16,6 +17,8 @@
 #include "flutter/testing/test_gl_surface.h"
 #include "flutter/testing/testing.h"
 #include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/tonic/converter/dart_converter.h"
 
 namespace flutter {
 namespace testing {
@@ -320,6 +323,80 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithoutAGPUContext) {
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest, CancelsAndReprioritizesPendingDecodes) {
+  // A single worker starts the decodes one by one.
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Keeps the worker busy until all decodes are queued.
+  fml::AutoResetWaitableEvent worker_latch;
+  loop->GetTaskRunner()->PostTask([&]() { worker_latch.Wait(); });
+
+  // Only accessed on the UI thread.
+  std::vector<std::string> decoded;
+  std::optional<bool> cancelled_decode_succeeded;
+  fml::CountDownLatch decodes_done(3);
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+
+    // The target sizes keep the decodes from sharing a cache entry.
+    auto decode = [&](uint32_t target_width,
+                      ImageDecoder::ImageResult callback) {
+      ImageDecoder::ImageDescriptor image_descriptor;
+      image_descriptor.data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+      image_descriptor.target_width = target_width;
+      return image_decoder->Decode(std::move(image_descriptor), callback);
+    };
+    auto record = [&](std::string name) {
+      return [&, name](SkiaGPUObject<SkImage> image) {
+        EXPECT_TRUE(image.get());
+        decoded.push_back(name);
+        decodes_done.CountDown();
+      };
+    };
+
+    decode(100, [&](SkiaGPUObject<SkImage> image) {
+      cancelled_decode_succeeded = image.get() != nullptr;
+      decodes_done.CountDown();
+    })->Cancel();
+    decode(200, record("normal"));
+    decode(300, record("high"))
+        ->SetPriority(fml::ConcurrentTaskPriority::kHigh);
+    worker_latch.Signal();
+  });
+  decodes_done.Wait();
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    EXPECT_EQ(cancelled_decode_succeeded, false);
+    EXPECT_EQ(decoded, (std::vector<std::string>{"high", "normal"}));
+    image_decoder.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   const auto image_dimensions =
       SkImage::MakeFromEncoded(OpenFixtureAsSkData("DashInNooglerHat.jpg"))
@@ -606,6 +683,29 @@ TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   assert_image(decode({}, 100));
 }
 
+TEST(ImageDecoderTest, VerifySampledDecodingOfCodecsThatCannotScale) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(data != nullptr);
+  auto codec = SkCodec::MakeFromData(data);
+  ASSERT_TRUE(codec != nullptr);
+  ASSERT_EQ(codec->dimensions(), SkISize::Make(300, 100));
+  // The PNG codec has no native scaling, so decoding to a smaller size
+  // samples rows and columns instead.
+  ASSERT_EQ(codec->getScaledDimensions(0.1), codec->dimensions());
+
+  auto decode = [data](std::optional<uint32_t> target_width,
+                       std::optional<uint32_t> target_height) {
+    return ImageFromCompressedData(data, target_width, target_height,
+                                   ImageUpscalingMode::kNotAllowed,
+                                   fml::tracing::TraceFlow(""));
+  };
+
+  ASSERT_EQ(decode(100, 33)->dimensions(), SkISize::Make(100, 33));
+  ASSERT_EQ(decode(30, {})->dimensions(), SkISize::Make(30, 10));
+  ASSERT_EQ(decode({}, 7)->dimensions(), SkISize::Make(21, 7));
+  ASSERT_EQ(decode(1, 1)->dimensions(), SkISize::Make(1, 1));
+}
+
 TEST_F(ImageDecoderFixtureTest,
        MultiFrameCodecCanBeCollectedBeforeIOTasksFinish) {
   // This test verifies that the MultiFrameCodec safely shares state between
@@ -697,5 +797,183 @@ TEST_F(ImageDecoderFixtureTest,
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest,
+       MultiFrameCodecDecodesAheadAndLoopsFromTheFrameCache) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+
+  auto gif_mapping = OpenFixtureAsSkData("hello_loop_2.gif");
+  ASSERT_TRUE(gif_mapping);
+  auto gif_codec = SkCodec::MakeFromData(gif_mapping);
+  ASSERT_TRUE(gif_codec);
+  // Two loops of the animation and the first frame of the third, all
+  // requested at once.
+  const int request_count = gif_codec->getFrameCount() * 2 + 1;
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<TestIOManager> io_manager;
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    latch.Signal();
+  });
+  latch.Wait();
+
+  fml::CountDownLatch frames_latch(request_count);
+  int decoded_frames = 0;
+  AddNativeCallback("NotifyFrame",
+                    CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+                      if (tonic::DartConverter<bool>::FromDart(
+                              Dart_GetNativeArgument(args, 0))) {
+                        decoded_frames++;
+                      }
+                      frames_latch.CountDown();
+                    }));
+
+  auto isolate =
+      RunDartCodeInIsolate(vm_ref, settings, runners, "main", {},
+                           GetFixturesPath(), io_manager->GetWeakIOManager());
+
+  fml::RefPtr<MultiFrameCodec> codec;
+  runners.GetUITaskRunner()->PostTask([&]() {
+    EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle closure = Dart_GetField(
+          Dart_RootLibrary(),
+          Dart_NewStringFromCString("frameCallbackNotifiesNative"));
+      if (Dart_IsError(closure) || !Dart_IsClosure(closure)) {
+        return false;
+      }
+
+      ImageDecoder::AnimatedImageOptions options;
+      options.look_ahead_frames = 2;
+      options.frame_cache_max_bytes = 64 << 20;
+      codec = fml::MakeRefCounted<MultiFrameCodec>(std::move(gif_codec),
+                                                   options);
+      for (int i = 0; i < request_count; i++) {
+        codec->getNextFrame(closure);
+      }
+      return true;
+    }));
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // The callbacks run on the UI thread.
+  frames_latch.Wait();
+  EXPECT_EQ(decoded_frames, request_count);
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+      codec = nullptr;
+      return true;
+    }));
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Destroy the IO manager
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+TEST(ImageDecoderTest, SniffsTheFormatsOfPlatformDecoders) {
+  auto jpeg = OpenFixtureAsSkData("Horizontal.jpg");
+  ASSERT_TRUE(jpeg != nullptr);
+  ASSERT_EQ(ImageDecoderBackend::SniffFormat(*jpeg),
+            SkEncodedImageFormat::kJPEG);
+
+  auto png = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(png != nullptr);
+  ASSERT_FALSE(ImageDecoderBackend::SniffFormat(*png).has_value());
+
+  const char heif_header[] = "\0\0\0\x18" "ftypheic";
+  auto heif = SkData::MakeWithCopy(heif_header, sizeof(heif_header));
+  ASSERT_EQ(ImageDecoderBackend::SniffFormat(*heif),
+            SkEncodedImageFormat::kHEIF);
+  ASSERT_FALSE(
+      ImageDecoderBackend::SniffFormat(*SkData::MakeEmpty()).has_value());
+}
+
+// Accepts all images as 300x100 and decodes them to |decoded_dimensions|, or
+// to the target dimensions if there are none.
+class TestImageDecoderBackend final : public ImageDecoderBackend {
+ public:
+  TestImageDecoderBackend(bool accept,
+                          std::optional<SkISize> decoded_dimensions = {})
+      : accept_(accept), decoded_dimensions_(decoded_dimensions) {}
+
+  std::optional<SkISize> GetDimensionsIfAccepted(
+      const SkData& data) const override {
+    if (!accept_) {
+      return std::nullopt;
+    }
+    return SkISize::Make(300, 100);
+  }
+
+  sk_sp<SkImage> Decode(const SkData& data,
+                        const SkISize& target_dimensions) const override {
+    requested_dimensions_ = target_dimensions;
+    const auto dimensions = decoded_dimensions_.value_or(target_dimensions);
+    if (dimensions.isEmpty()) {
+      return nullptr;
+    }
+    auto surface = SkSurface::MakeRasterN32Premul(dimensions.width(),
+                                                  dimensions.height());
+    return surface->makeImageSnapshot();
+  }
+
+  mutable SkISize requested_dimensions_ = SkISize::MakeEmpty();
+
+ private:
+  const bool accept_;
+  const std::optional<SkISize> decoded_dimensions_;
+};
+
+TEST(ImageDecoderTest, BackendsDecodeTheImagesTheyAccept) {
+  auto data = SkData::MakeWithCString("image");
+  auto decode = [data](const ImageDecoderBackends& backends,
+                       std::optional<uint32_t> target_width) {
+    return ImageFromBackends(backends, data, target_width, {},
+                             ImageUpscalingMode::kNotAllowed,
+                             fml::tracing::TraceFlow(""));
+  };
+
+  // No backend accepts the image, so it's left to Skia.
+  ASSERT_EQ(decode({}, 30), nullptr);
+  ASSERT_EQ(decode({std::make_shared<TestImageDecoderBackend>(false)}, 30),
+            nullptr);
+
+  // The first backend that accepts the image decodes it, to the dimensions
+  // that the target dimensions resolve to.
+  auto rejecting = std::make_shared<TestImageDecoderBackend>(false);
+  auto accepting = std::make_shared<TestImageDecoderBackend>(true);
+  auto image = decode({rejecting, accepting}, 30);
+  ASSERT_TRUE(image != nullptr);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(30, 10));
+  ASSERT_EQ(accepting->requested_dimensions_, SkISize::Make(30, 10));
+  ASSERT_EQ(decode({accepting}, {})->dimensions(), SkISize::Make(300, 100));
+
+  // Images the backend decodes to other dimensions are resized.
+  auto approximate =
+      std::make_shared<TestImageDecoderBackend>(true, SkISize::Make(60, 20));
+  image = decode({approximate}, 30);
+  ASSERT_TRUE(image != nullptr);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(30, 10));
+
+  // Failed decodes fall back to Skia.
+  auto failing =
+      std::make_shared<TestImageDecoderBackend>(true, SkISize::MakeEmpty());
+  ASSERT_EQ(decode({failing}, 30), nullptr);
+}
+
 }  // namespace testing
 }  // namespace flutter
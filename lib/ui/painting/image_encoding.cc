@@ -4,11 +4,14 @@
 
 #include "flutter/lib/ui/painting/image_encoding.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
@@ -16,7 +19,9 @@
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/encode/SkPngEncoder.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 #include "third_party/tonic/typed_data/typed_list.h"
@@ -35,6 +40,57 @@ enum ImageByteFormat {
   kPNG,
 };
 
+// The size of the chunks that streamed encodings are handed to Dart in.
+constexpr size_t kEncodedChunkSize = 64 * 1024;
+
+// The number of rows that streamed PNG encodings encode at a time.
+constexpr int kEncodedRowsPerStrip = 64;
+
+using ChunkCallback = std::function<void(sk_sp<SkData>)>;
+
+// Hands the bytes written to it to a callback in chunks of |chunk_size|, so
+// that the bytes an encoder produces can be passed on before it finishes.
+class ChunkedWStream : public SkWStream {
+ public:
+  ChunkedWStream(size_t chunk_size, ChunkCallback on_chunk)
+      : chunk_size_(chunk_size), on_chunk_(std::move(on_chunk)) {
+    pending_.reserve(chunk_size_);
+  }
+
+  bool write(const void* buffer, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+    bytes_written_ += size;
+    while (size > 0) {
+      size_t count = std::min(size, chunk_size_ - pending_.size());
+      pending_.insert(pending_.end(), bytes, bytes + count);
+      bytes += count;
+      size -= count;
+      if (pending_.size() == chunk_size_) {
+        flush();
+      }
+    }
+    return true;
+  }
+
+  void flush() override {
+    if (pending_.empty()) {
+      return;
+    }
+    on_chunk_(SkData::MakeWithCopy(pending_.data(), pending_.size()));
+    pending_.clear();
+  }
+
+  size_t bytesWritten() const override { return bytes_written_; }
+
+ private:
+  const size_t chunk_size_;
+  ChunkCallback on_chunk_;
+  std::vector<uint8_t> pending_;
+  size_t bytes_written_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ChunkedWStream);
+};
+
 void FinalizeSkData(void* isolate_callback_data,
                     Dart_WeakPersistentHandle handle,
                     void* peer) {
@@ -62,6 +118,18 @@ void InvokeDataCallback(std::unique_ptr<DartPersistentValue> callback,
   DartInvoke(callback->value(), {dart_data});
 }
 
+// Runs |task| on the concurrent workers when there are some, so that several
+// images encode in parallel and the IO thread stays free for texture uploads.
+void PostEncodeTask(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner,
+    fml::closure task) {
+  if (concurrent_task_runner) {
+    concurrent_task_runner->PostTask(std::move(task));
+  } else {
+    task();
+  }
+}
+
 sk_sp<SkImage> ConvertToRasterUsingResourceContext(
     sk_sp<SkImage> image,
     GrContext* resource_context) {
@@ -161,29 +229,29 @@ sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
     return nullptr;
   }
 
-  // The color types already match. No need to swizzle. Return early.
-  if (pixmap.colorType() == color_type) {
-    return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
+  const SkImageInfo info = pixmap.info().makeColorType(color_type);
+
+  // The pixels are already laid out as requested. Raster images are
+  // immutable, so the data can refer to them for as long as it keeps the image
+  // alive instead of copying them.
+  if (pixmap.colorType() == color_type &&
+      pixmap.rowBytes() == info.minRowBytes()) {
+    return SkData::MakeWithProc(
+        pixmap.addr(), pixmap.computeByteSize(),
+        [](const void* pixels, void* image) {
+          reinterpret_cast<SkImage*>(image)->unref();
+        },
+        raster_image.release());
   }
 
-  // Perform swizzle if the type doesnt match the specification.
-  auto surface = SkSurface::MakeRaster(
-      SkImageInfo::Make(raster_image->width(), raster_image->height(),
-                        color_type, kPremul_SkAlphaType, nullptr));
-
-  if (!surface) {
-    FML_LOG(ERROR) << "Could not setup the surface for swizzle.";
-    return nullptr;
-  }
-
-  surface->writePixels(pixmap, 0, 0);
-
-  if (!surface->peekPixels(&pixmap)) {
-    FML_LOG(ERROR) << "Pixel address is not available.";
+  // Otherwise swizzle or repack the pixels straight into the data.
+  sk_sp<SkData> data = SkData::MakeUninitialized(info.computeMinByteSize());
+  if (!pixmap.readPixels(info, data->writable_data(), info.minRowBytes())) {
+    FML_LOG(ERROR) << "Could not convert the pixels of the raster image.";
     return nullptr;
   }
 
-  return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
+  return data;
 }
 
 sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
@@ -216,6 +284,54 @@ sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
   return nullptr;
 }
 
+// Encodes |raster_image| in |format|, handing the encoded bytes to |on_chunk|
+// as they are produced. Returns whether the whole image was encoded.
+bool EncodeImageInChunks(sk_sp<SkImage> raster_image,
+                         ImageByteFormat format,
+                         const ChunkCallback& on_chunk) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+
+  if (!raster_image) {
+    return false;
+  }
+
+  if (format != kPNG) {
+    // Raw pixels aren't encoded, so they are only split up without copying.
+    sk_sp<SkData> data = EncodeImage(std::move(raster_image), format);
+    if (!data) {
+      return false;
+    }
+    for (size_t offset = 0; offset < data->size();
+         offset += kEncodedChunkSize) {
+      const size_t length = std::min(kEncodedChunkSize, data->size() - offset);
+      on_chunk(SkData::MakeSubset(data.get(), offset, length));
+    }
+    return true;
+  }
+
+  SkPixmap pixmap;
+  if (!raster_image->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Could not read the pixels of the raster image.";
+    return false;
+  }
+
+  ChunkedWStream stream(kEncodedChunkSize, on_chunk);
+  std::unique_ptr<SkEncoder> encoder =
+      SkPngEncoder::Make(&stream, pixmap, SkPngEncoder::Options());
+  if (!encoder) {
+    FML_LOG(ERROR) << "Could not convert raster image to PNG.";
+    return false;
+  }
+  for (int row = 0; row < pixmap.height(); row += kEncodedRowsPerStrip) {
+    if (!encoder->encodeRows(kEncodedRowsPerStrip)) {
+      FML_LOG(ERROR) << "Could not convert raster image to PNG.";
+      return false;
+    }
+  }
+  stream.flush();
+  return true;
+}
+
 void EncodeImageAndInvokeDataCallback(
     sk_sp<SkImage> image,
     std::unique_ptr<DartPersistentValue> callback,
@@ -223,6 +339,7 @@ void EncodeImageAndInvokeDataCallback(
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
     fml::RefPtr<fml::TaskRunner> raster_task_runner,
     fml::RefPtr<fml::TaskRunner> io_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     GrContext* resource_context,
     fml::WeakPtr<SnapshotDelegate> snapshot_delegate) {
   auto callback_task = fml::MakeCopyable(
@@ -231,11 +348,90 @@ void EncodeImageAndInvokeDataCallback(
       });
 
   auto encode_task = [callback_task = std::move(callback_task), format,
-                      ui_task_runner](sk_sp<SkImage> raster_image) {
-    sk_sp<SkData> encoded = EncodeImage(std::move(raster_image), format);
-    ui_task_runner->PostTask([callback_task = std::move(callback_task),
-                              encoded = std::move(encoded)]() mutable {
-      callback_task(std::move(encoded));
+                      ui_task_runner,
+                      concurrent_task_runner](sk_sp<SkImage> raster_image) {
+    PostEncodeTask(concurrent_task_runner, [callback_task, format,
+                                            ui_task_runner, raster_image]() {
+      sk_sp<SkData> encoded = EncodeImage(raster_image, format);
+      ui_task_runner->PostTask([callback_task, encoded]() mutable {
+        callback_task(std::move(encoded));
+      });
+    });
+  };
+
+  ConvertImageToRaster(std::move(image), encode_task, raster_task_runner,
+                       io_task_runner, resource_context, snapshot_delegate);
+}
+
+// The Dart callbacks of a streamed encoding. They are only used and released
+// on the UI thread.
+struct ChunkCallbacks {
+  std::unique_ptr<DartPersistentValue> on_chunk;
+  std::unique_ptr<DartPersistentValue> on_done;
+};
+
+void InvokeChunkCallback(const std::shared_ptr<ChunkCallbacks>& callbacks,
+                         sk_sp<SkData> chunk) {
+  if (!callbacks->on_chunk) {
+    return;
+  }
+  std::shared_ptr<tonic::DartState> dart_state =
+      callbacks->on_chunk->dart_state().lock();
+  if (!dart_state) {
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+  void* bytes = const_cast<void*>(chunk->data());
+  const intptr_t length = chunk->size();
+  void* peer = reinterpret_cast<void*>(chunk.release());
+  Dart_Handle dart_data = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kUint8, bytes, length, peer, length, FinalizeSkData);
+  DartInvoke(callbacks->on_chunk->value(), {dart_data});
+}
+
+void InvokeDoneCallback(const std::shared_ptr<ChunkCallbacks>& callbacks,
+                        bool success) {
+  // Released here rather than wherever the last task holding the callbacks
+  // happens to be destroyed.
+  std::unique_ptr<DartPersistentValue> on_chunk =
+      std::move(callbacks->on_chunk);
+  std::unique_ptr<DartPersistentValue> on_done = std::move(callbacks->on_done);
+  if (!on_done) {
+    return;
+  }
+  std::shared_ptr<tonic::DartState> dart_state = on_done->dart_state().lock();
+  if (!dart_state) {
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+  DartInvoke(on_done->value(), {ToDart(success)});
+}
+
+void EncodeImageAndInvokeChunkCallbacks(
+    sk_sp<SkImage> image,
+    std::shared_ptr<ChunkCallbacks> callbacks,
+    ImageByteFormat format,
+    fml::RefPtr<fml::TaskRunner> ui_task_runner,
+    fml::RefPtr<fml::TaskRunner> raster_task_runner,
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    GrContext* resource_context,
+    fml::WeakPtr<SnapshotDelegate> snapshot_delegate) {
+  auto encode_task = [callbacks, format, ui_task_runner,
+                      concurrent_task_runner](sk_sp<SkImage> raster_image) {
+    PostEncodeTask(concurrent_task_runner, [callbacks, format, ui_task_runner,
+                                            raster_image]() {
+      // The chunks are posted in order, ahead of the completion.
+      bool success = EncodeImageInChunks(
+          raster_image, format,
+          [callbacks, ui_task_runner](sk_sp<SkData> chunk) {
+            ui_task_runner->PostTask([callbacks, chunk]() {
+              InvokeChunkCallback(callbacks, chunk);
+            });
+          });
+      ui_task_runner->PostTask([callbacks, success]() {
+        InvokeDoneCallback(callbacks, success);
+      });
     });
   };
 
@@ -243,6 +439,13 @@ void EncodeImageAndInvokeDataCallback(
                        io_task_runner, resource_context, snapshot_delegate);
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner> GetEncodeTaskRunner() {
+  if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+    return image_decoder->GetConcurrentTaskRunner();
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
@@ -266,17 +469,57 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
        image_format, ui_task_runner = task_runners.GetUITaskRunner(),
        raster_task_runner = task_runners.GetRasterTaskRunner(),
        io_task_runner = task_runners.GetIOTaskRunner(),
+       concurrent_task_runner = GetEncodeTaskRunner(),
        io_manager = UIDartState::Current()->GetIOManager(),
        snapshot_delegate =
            UIDartState::Current()->GetSnapshotDelegate()]() mutable {
         EncodeImageAndInvokeDataCallback(
             std::move(image), std::move(callback), image_format,
             std::move(ui_task_runner), std::move(raster_task_runner),
-            std::move(io_task_runner), io_manager->GetResourceContext().get(),
+            std::move(io_task_runner), std::move(concurrent_task_runner),
+            io_manager->GetResourceContext().get(),
             std::move(snapshot_delegate));
       }));
 
   return Dart_Null();
 }
 
+Dart_Handle EncodeImageInChunks(CanvasImage* canvas_image,
+                                int format,
+                                Dart_Handle chunk_callback_handle,
+                                Dart_Handle done_callback_handle) {
+  if (!canvas_image)
+    return ToDart("encode called with non-genuine Image.");
+
+  if (!Dart_IsClosure(chunk_callback_handle) ||
+      !Dart_IsClosure(done_callback_handle))
+    return ToDart("Callback must be a function.");
+
+  ImageByteFormat image_format = static_cast<ImageByteFormat>(format);
+
+  auto callbacks = std::make_shared<ChunkCallbacks>();
+  callbacks->on_chunk = std::make_unique<DartPersistentValue>(
+      tonic::DartState::Current(), chunk_callback_handle);
+  callbacks->on_done = std::make_unique<DartPersistentValue>(
+      tonic::DartState::Current(), done_callback_handle);
+
+  const auto& task_runners = UIDartState::Current()->GetTaskRunners();
+
+  task_runners.GetIOTaskRunner()->PostTask(
+      [callbacks, image = canvas_image->image(), image_format,
+       ui_task_runner = task_runners.GetUITaskRunner(),
+       raster_task_runner = task_runners.GetRasterTaskRunner(),
+       io_task_runner = task_runners.GetIOTaskRunner(),
+       concurrent_task_runner = GetEncodeTaskRunner(),
+       io_manager = UIDartState::Current()->GetIOManager(),
+       snapshot_delegate = UIDartState::Current()->GetSnapshotDelegate()]() {
+        EncodeImageAndInvokeChunkCallbacks(
+            image, callbacks, image_format, ui_task_runner, raster_task_runner,
+            io_task_runner, concurrent_task_runner,
+            io_manager->GetResourceContext().get(), snapshot_delegate);
+      });
+
+  return Dart_Null();
+}
+
 }  // namespace flutter
@@ -15,6 +15,14 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
                         Dart_Handle callback_handle);
 
+// Encodes the image like |EncodeImage|, but invokes the chunk callback with
+// each part of the encoded bytes as it is produced, in order, and then the done
+// callback with whether the whole image was encoded.
+Dart_Handle EncodeImageInChunks(CanvasImage* canvas_image,
+                                int format,
+                                Dart_Handle chunk_callback_handle,
+                                Dart_Handle done_callback_handle);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
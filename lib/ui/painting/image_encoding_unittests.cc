@@ -71,5 +71,48 @@ TEST_F(ShellTest, EncodeImageGivesExternalTypedData) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, EncodeImageAsStreamGivesTheSameBytesInChunks) {
+  fml::AutoResetWaitableEvent message_latch;
+
+  auto nativeValidateStream = [&](Dart_NativeArguments args) {
+    auto png_matches =
+        tonic::DartConverter<bool>::FromDart(Dart_GetNativeArgument(args, 0));
+    auto raw_matches =
+        tonic::DartConverter<bool>::FromDart(Dart_GetNativeArgument(args, 1));
+    auto chunk_count =
+        tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 2));
+    EXPECT_TRUE(png_matches);
+    EXPECT_TRUE(raw_matches);
+    // The 2,000,000 raw bytes alone take more than one chunk.
+    EXPECT_GT(chunk_count, 2);
+    message_latch.Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateStream",
+                    CREATE_NATIVE_ENTRY(nativeValidateStream));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("encodeImageAsStream");
+
+  shell->RunEngine(std::move(configuration), [&](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch.Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -49,6 +49,10 @@ void ImageFilter::initImage(CanvasImage* image) {
 }
 
 void ImageFilter::initPicture(Picture* picture) {
+  if (auto display_list = picture->display_list()) {
+    filter_ = SkPictureImageFilter::Make(display_list->ToSkPicture());
+    return;
+  }
   filter_ = SkPictureImageFilter::Make(picture->picture());
 }
 
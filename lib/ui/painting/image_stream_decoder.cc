@@ -0,0 +1,489 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_stream_decoder.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+#include "third_party/tonic/typed_data/typed_list.h"
+
+namespace flutter {
+
+// Partial images are only shown while the full resolution image isn't much
+// larger than the target size, since they are decoded at full resolution. A
+// sampled decode of all the data is cheaper otherwise.
+static constexpr uint32_t kMaxIncrementalDownscale = 2;
+
+// The encoded bytes received so far and the codec that decodes them. The
+// buffer is filled on the UI thread and decoded on the worker threads, one
+// decode at a time.
+class ImageStreamDecoder::State : public std::enable_shared_from_this<State> {
+ public:
+  State(fml::RefPtr<fml::TaskRunner> ui_task_runner,
+        std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+        std::optional<uint32_t> target_width,
+        std::optional<uint32_t> target_height)
+      : ui_task_runner_(std::move(ui_task_runner)),
+        worker_task_runner_(std::move(worker_task_runner)),
+        target_width_(target_width),
+        target_height_(target_height) {}
+
+  // Sets the decoder that decoded images are delivered to, or null once it
+  // is gone. Called on the UI thread.
+  void SetOwner(ImageStreamDecoder* owner) {
+    owner_ = owner;
+    if (owner_ == nullptr) {
+      std::scoped_lock lock(mutex_);
+      abandoned_ = true;
+    }
+  }
+
+  void AddChunk(const uint8_t* chunk, size_t size) {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(!closed_);
+    data_.insert(data_.end(), chunk, chunk + size);
+    ScheduleDecodeLocked();
+  }
+
+  void Close() {
+    std::scoped_lock lock(mutex_);
+    closed_ = true;
+    ScheduleDecodeLocked();
+  }
+
+  // Allows the next partial image to be delivered. Called on the UI thread.
+  void OnPartialImageDelivered() {
+    partial_image_in_flight_ = false;
+  }
+
+  size_t GetBufferedBytes() {
+    std::scoped_lock lock(mutex_);
+    return data_.size() + bitmap_bytes_;
+  }
+
+  // Reads from the buffer for |BufferStream|, on the decoding worker.
+  size_t Read(size_t position, void* buffer, size_t size) {
+    std::scoped_lock lock(mutex_);
+    if (position >= data_.size()) {
+      return 0;
+    }
+    size = std::min(size, data_.size() - position);
+    if (buffer != nullptr) {
+      ::memcpy(buffer, data_.data() + position, size);
+    }
+    return size;
+  }
+
+  bool IsAtEnd(size_t position) {
+    std::scoped_lock lock(mutex_);
+    return closed_ && position >= data_.size();
+  }
+
+ private:
+  enum class Mode {
+    // Waiting for enough data to create a codec and start decoding.
+    kProbing,
+    // Decoding the data as it arrives.
+    kIncremental,
+    // Waiting for all data to decode it at once.
+    kWholeData,
+    kFinished,
+  };
+
+  const fml::RefPtr<fml::TaskRunner> ui_task_runner_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  const std::optional<uint32_t> target_width_;
+  const std::optional<uint32_t> target_height_;
+  // Only accessed on the UI thread.
+  ImageStreamDecoder* owner_ = nullptr;
+  std::atomic<bool> partial_image_in_flight_ = {false};
+
+  std::mutex mutex_;
+  std::vector<uint8_t> data_;
+  bool closed_ = false;
+  bool abandoned_ = false;
+  bool decode_running_ = false;
+  bool decode_requested_ = false;
+  size_t bitmap_bytes_ = 0;
+
+  // Only accessed by the decode that is running.
+  Mode mode_ = Mode::kProbing;
+  std::unique_ptr<SkCodec> codec_;
+  SkBitmap bitmap_;
+
+  void ScheduleDecodeLocked() {
+    if (decode_running_) {
+      decode_requested_ = true;
+      return;
+    }
+    decode_running_ = true;
+    worker_task_runner_->PostTask(
+        [state = shared_from_this()]() { state->RunDecodes(); });
+  }
+
+  void RunDecodes() {
+    while (true) {
+      {
+        std::scoped_lock lock(mutex_);
+        if (abandoned_) {
+          decode_running_ = false;
+          return;
+        }
+        decode_requested_ = false;
+      }
+      Decode();
+      std::scoped_lock lock(mutex_);
+      if (!decode_requested_) {
+        decode_running_ = false;
+        return;
+      }
+    }
+  }
+
+  void Decode() {
+    TRACE_EVENT0("flutter", "ImageStreamDecoder::Decode");
+    bool closed;
+    size_t size;
+    {
+      std::scoped_lock lock(mutex_);
+      closed = closed_;
+      size = data_.size();
+    }
+
+    if (mode_ == Mode::kProbing &&
+        (size >= SkCodec::MinBufferedBytesNeeded() || closed)) {
+      StartIncrementalDecode(closed);
+    }
+
+    if (mode_ == Mode::kIncremental) {
+      const SkCodec::Result result = codec_->incrementalDecode();
+      if (result == SkCodec::kSuccess) {
+        PostPixels(true);
+        mode_ = Mode::kFinished;
+        return;
+      }
+      if (result == SkCodec::kIncompleteInput && !closed) {
+        PostPixels(false);
+        return;
+      }
+      // Decoding the data as a whole shows what it can of truncated images.
+      mode_ = Mode::kWholeData;
+    }
+
+    if (closed && mode_ != Mode::kFinished) {
+      mode_ = Mode::kFinished;
+      PostData();
+    }
+  }
+
+  void StartIncrementalDecode(bool closed) {
+    codec_ = SkCodec::MakeFromStream(std::make_unique<BufferStream>(this));
+    if (!codec_) {
+      // Probably too little data for the header yet.
+      if (closed) {
+        mode_ = Mode::kWholeData;
+      }
+      return;
+    }
+
+    // Incremental decodes don't respect the image orientation.
+    const SkImageInfo& info = codec_->getInfo();
+    if (codec_->getOrigin() != kTopLeft_SkEncodedOrigin ||
+        IsMuchLargerThanTarget(info.dimensions())) {
+      StopIncrementalDecode();
+      return;
+    }
+
+    SkImageInfo decode_info =
+        info.makeColorType(kN32_SkColorType)
+            .makeAlphaType(info.alphaType() == kUnpremul_SkAlphaType
+                               ? kPremul_SkAlphaType
+                               : info.alphaType());
+    if (!bitmap_.tryAllocPixels(decode_info)) {
+      StopIncrementalDecode();
+      return;
+    }
+    // Rows that are not decoded yet show as transparent.
+    bitmap_.eraseColor(SK_ColorTRANSPARENT);
+    {
+      std::scoped_lock lock(mutex_);
+      bitmap_bytes_ = bitmap_.computeByteSize();
+    }
+
+    const SkCodec::Result result = codec_->startIncrementalDecode(
+        decode_info, bitmap_.getPixels(), bitmap_.rowBytes());
+    if (result == SkCodec::kSuccess) {
+      mode_ = Mode::kIncremental;
+    } else if (result == SkCodec::kIncompleteInput && !closed) {
+      // Some codecs need the first frame's header to start, so try again
+      // with a fresh codec once more data arrived.
+      codec_.reset();
+    } else {
+      StopIncrementalDecode();
+    }
+  }
+
+  void StopIncrementalDecode() {
+    codec_.reset();
+    bitmap_.reset();
+    {
+      std::scoped_lock lock(mutex_);
+      bitmap_bytes_ = 0;
+    }
+    mode_ = Mode::kWholeData;
+  }
+
+  bool IsMuchLargerThanTarget(const SkISize& dimensions) const {
+    return (target_width_ && static_cast<uint32_t>(dimensions.width()) >
+                                 target_width_.value() *
+                                     kMaxIncrementalDownscale) ||
+           (target_height_ && static_cast<uint32_t>(dimensions.height()) >
+                                  target_height_.value() *
+                                      kMaxIncrementalDownscale);
+  }
+
+  // Posts a copy of the pixels decoded so far, unless the previous partial
+  // image is still being delivered.
+  void PostPixels(bool complete) {
+    if (!complete && partial_image_in_flight_.exchange(true)) {
+      return;
+    }
+    ImageDecoder::ImageDescriptor descriptor;
+    descriptor.data =
+        SkData::MakeWithCopy(bitmap_.getPixels(), bitmap_.computeByteSize());
+    descriptor.decompressed_image_info =
+        ImageDecoder::ImageInfo{bitmap_.info(), bitmap_.rowBytes()};
+    if (complete) {
+      StopIncrementalDecode();
+    }
+    Post(std::move(descriptor), complete);
+  }
+
+  // Posts all the encoded data to be decoded at once.
+  void PostData() {
+    // The codec may still read from the buffer.
+    codec_.reset();
+    std::vector<uint8_t>* data = nullptr;
+    {
+      std::scoped_lock lock(mutex_);
+      data = new std::vector<uint8_t>(std::move(data_));
+      data_.clear();
+    }
+    ImageDecoder::ImageDescriptor descriptor;
+    descriptor.data = SkData::MakeWithProc(
+        data->data(), data->size(),
+        [](const void* ptr, void* context) {
+          delete static_cast<std::vector<uint8_t>*>(context);
+        },
+        data);
+    Post(std::move(descriptor), true);
+  }
+
+  void Post(ImageDecoder::ImageDescriptor descriptor, bool complete) {
+    ui_task_runner_->PostTask(
+        [weak_state = weak_from_this(), descriptor, complete]() {
+          auto state = weak_state.lock();
+          if (state && state->owner_) {
+            state->owner_->OnDecoded(descriptor, complete);
+          }
+        });
+  }
+
+  // What the codec reads the buffer through. Reads past the data received so
+  // far come up short until the buffer is closed, which the codecs treat as
+  // incomplete input.
+  class BufferStream final : public SkStream {
+   public:
+    explicit BufferStream(State* state) : state_(state) {}
+
+    size_t read(void* buffer, size_t size) override {
+      const size_t read = state_->Read(position_, buffer, size);
+      position_ += read;
+      return read;
+    }
+
+    size_t peek(void* buffer, size_t size) const override {
+      return state_->Read(position_, buffer, size);
+    }
+
+    bool isAtEnd() const override { return state_->IsAtEnd(position_); }
+
+    bool rewind() override {
+      position_ = 0;
+      return true;
+    }
+
+    bool hasPosition() const override { return true; }
+
+    size_t getPosition() const override { return position_; }
+
+   private:
+    // Outlives the stream, which belongs to the codec of the state.
+    State* const state_;
+    size_t position_ = 0;
+  };
+
+  FML_DISALLOW_COPY_AND_ASSIGN(State);
+};
+
+static void ImageStreamDecoder_constructor(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  DartCallConstructor(&ImageStreamDecoder::Create, args);
+}
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, ImageStreamDecoder);
+
+#define FOR_EACH_BINDING(V)       \
+  V(ImageStreamDecoder, addChunk) \
+  V(ImageStreamDecoder, close)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void ImageStreamDecoder::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({{"ImageStreamDecoder_constructor",
+                      ImageStreamDecoder_constructor, 5, true},
+                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<ImageStreamDecoder> ImageStreamDecoder::Create(
+    int target_width,
+    int target_height,
+    bool allow_upscaling,
+    Dart_Handle on_progress) {
+  auto* dart_state = UIDartState::Current();
+  auto decoder = dart_state->GetImageDecoder();
+  FML_CHECK(decoder);
+
+  ImageDecoder::ImageDescriptor descriptor;
+  if (target_width > 0) {
+    descriptor.target_width = target_width;
+  }
+  if (target_height > 0) {
+    descriptor.target_height = target_height;
+  }
+  descriptor.image_upscaling = allow_upscaling
+                                   ? ImageUpscalingMode::kAllowed
+                                   : ImageUpscalingMode::kNotAllowed;
+
+  auto state = std::make_shared<State>(
+      dart_state->GetTaskRunners().GetUITaskRunner(),
+      decoder->GetConcurrentTaskRunner(), descriptor.target_width,
+      descriptor.target_height);
+  return fml::MakeRefCounted<ImageStreamDecoder>(
+      std::move(state), decoder, std::move(descriptor), on_progress);
+}
+
+ImageStreamDecoder::ImageStreamDecoder(
+    std::shared_ptr<State> state,
+    fml::WeakPtr<ImageDecoder> image_decoder,
+    ImageDecoder::ImageDescriptor descriptor,
+    Dart_Handle on_progress)
+    : state_(std::move(state)),
+      image_decoder_(std::move(image_decoder)),
+      descriptor_(std::move(descriptor)) {
+  if (!Dart_IsNull(on_progress)) {
+    on_progress_.Set(tonic::DartState::Current(), on_progress);
+  }
+  state_->SetOwner(this);
+}
+
+ImageStreamDecoder::~ImageStreamDecoder() {
+  state_->SetOwner(nullptr);
+}
+
+Dart_Handle ImageStreamDecoder::addChunk(Dart_Handle chunk) {
+  if (closed_) {
+    return tonic::ToDart("The decoder is already closed.");
+  }
+  tonic::Uint8List list(chunk);
+  state_->AddChunk(list.data(), list.num_elements());
+  return Dart_Null();
+}
+
+Dart_Handle ImageStreamDecoder::close(Dart_Handle callback) {
+  if (!Dart_IsClosure(callback)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+  if (closed_) {
+    return tonic::ToDart("The decoder is already closed.");
+  }
+  closed_ = true;
+  on_complete_.Set(tonic::DartState::Current(), callback);
+  self_ = this;
+  state_->Close();
+  return Dart_Null();
+}
+
+size_t ImageStreamDecoder::GetAllocationSize() const {
+  return sizeof(*this) + state_->GetBufferedBytes();
+}
+
+void ImageStreamDecoder::OnDecoded(ImageDecoder::ImageDescriptor descriptor,
+                                   bool complete) {
+  if (!image_decoder_) {
+    DeliverImage({}, complete);
+    return;
+  }
+  descriptor.target_width = descriptor_.target_width;
+  descriptor.target_height = descriptor_.target_height;
+  descriptor.image_upscaling = descriptor_.image_upscaling;
+  // Keeps this object alive for the delivery, which must happen on the UI
+  // thread, like the release of the reference.
+  auto* raw_self = new fml::RefPtr<ImageStreamDecoder>(this);
+  image_decoder_->Decode(std::move(descriptor),
+                         [raw_self, complete](auto image) {
+                           std::unique_ptr<fml::RefPtr<ImageStreamDecoder>>
+                               self(raw_self);
+                           (*self)->DeliverImage(std::move(image), complete);
+                         });
+}
+
+void ImageStreamDecoder::DeliverImage(SkiaGPUObject<SkImage> image,
+                                      bool complete) {
+  if (!complete) {
+    state_->OnPartialImageDelivered();
+  }
+  // Partial images that arrive after the complete one find the progress
+  // callback cleared.
+  tonic::DartPersistentValue& callback = complete ? on_complete_ : on_progress_;
+  if (callback.is_empty() || (!complete && !image.get())) {
+    return;
+  }
+  auto dart_state = callback.dart_state().lock();
+  if (!dart_state) {
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state.get());
+
+  Dart_Handle result = Dart_Null();
+  if (image.get()) {
+    auto canvas_image = CanvasImage::Create();
+    canvas_image->set_image(std::move(image));
+    result = tonic::ToDart(canvas_image);
+  }
+  tonic::DartInvoke(callback.value(), {result});
+
+  if (complete) {
+    on_complete_.Clear();
+    on_progress_.Clear();
+    // May destroy this object.
+    self_ = nullptr;
+  }
+}
+
+}  // namespace flutter
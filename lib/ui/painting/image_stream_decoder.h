@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_STREAM_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_STREAM_DECODER_H_
+
+#include <memory>
+
+#include "flutter/lib/ui/dart_wrapper.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "third_party/tonic/dart_persistent_value.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace flutter {
+
+// Decodes an encoded image while its bytes are still arriving, such as an
+// image that is being downloaded, so that decoding overlaps with the download
+// instead of starting after it.
+//
+// The chunks are appended to a buffer that a codec reads from on the worker
+// threads. Codecs that decode incrementally, like the PNG and GIF codecs,
+// decode what the bytes received so far cover as chunks arrive, and the
+// partially decoded images are resized and uploaded by the |ImageDecoder| and
+// handed to the progress callback. Only one partial image is in flight at a
+// time, so chunks that arrive faster than partial images can be made refine
+// the next one instead of queueing up. Other codecs, and images much larger
+// than their target size, decode once the last chunk arrived, through the
+// same path as |SingleFrameCodec|.
+//
+// Only the first frame of animated images is decoded.
+class ImageStreamDecoder final
+    : public RefCountedDartWrappable<ImageStreamDecoder> {
+  DEFINE_WRAPPERTYPEINFO();
+  FML_FRIEND_MAKE_REF_COUNTED(ImageStreamDecoder);
+
+ public:
+  static fml::RefPtr<ImageStreamDecoder> Create(int target_width,
+                                                int target_height,
+                                                bool allow_upscaling,
+                                                Dart_Handle on_progress);
+
+  ~ImageStreamDecoder() override;
+
+  // Appends |chunk|, a Uint8List, to the encoded image. Returns an error
+  // message if the decoder is already closed.
+  Dart_Handle addChunk(Dart_Handle chunk);
+
+  // Marks the end of the encoded image. |callback| is called with the fully
+  // decoded image, or with null if it could not be decoded.
+  Dart_Handle close(Dart_Handle callback);
+
+  // |DartWrappable|
+  size_t GetAllocationSize() const override;
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  class State;
+
+  // Shared with the decodes on the worker threads.
+  std::shared_ptr<State> state_;
+  fml::WeakPtr<ImageDecoder> image_decoder_;
+  ImageDecoder::ImageDescriptor descriptor_;
+  tonic::DartPersistentValue on_progress_;
+  tonic::DartPersistentValue on_complete_;
+  bool closed_ = false;
+  // Keeps this object alive from |close()| until |on_complete_| is called.
+  fml::RefPtr<ImageStreamDecoder> self_;
+
+  ImageStreamDecoder(std::shared_ptr<State> state,
+                     fml::WeakPtr<ImageDecoder> image_decoder,
+                     ImageDecoder::ImageDescriptor descriptor,
+                     Dart_Handle on_progress);
+
+  // Called on the UI thread with the pixels or encoded data of a partially
+  // or fully decoded image.
+  void OnDecoded(ImageDecoder::ImageDescriptor descriptor, bool complete);
+
+  void DeliverImage(SkiaGPUObject<SkImage> image, bool complete);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageStreamDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_STREAM_DECODER_H_
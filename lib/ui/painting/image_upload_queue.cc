@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_upload_queue.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+ImageUploadQueue::ImageUploadQueue(fml::RefPtr<fml::TaskRunner> io_task_runner,
+                                   Uploader uploader,
+                                   size_t max_batch_bytes,
+                                   WorkersProvider workers_provider)
+    : max_batch_bytes_(max_batch_bytes),
+      workers_provider_(std::move(workers_provider)) {
+  lanes_.push_back({std::move(io_task_runner), std::move(uploader)});
+}
+
+ImageUploadQueue::~ImageUploadQueue() = default;
+
+void ImageUploadQueue::Enqueue(sk_sp<SkImage> image,
+                               std::shared_ptr<fml::tracing::TraceFlow> flow,
+                               Callback done) {
+  const size_t bytes = image->imageInfo().computeMinByteSize();
+  std::scoped_lock lock(mutex_);
+  pending_.push_back({std::move(image), std::move(flow), std::move(done),
+                      bytes});
+  pending_bytes_ += bytes;
+  ScheduleFlushesLocked();
+}
+
+void ImageUploadQueue::ScheduleFlushesLocked() {
+  for (size_t i = 0;
+       i < lanes_.size() && scheduled_flush_count_ < pending_.size(); i++) {
+    Lane& lane = lanes_[i];
+    if (lane.flush_scheduled) {
+      continue;
+    }
+    lane.flush_scheduled = true;
+    scheduled_flush_count_++;
+    lane.task_runner->PostTask(
+        [queue = shared_from_this(), i]() { queue->Flush(i); });
+  }
+}
+
+void ImageUploadQueue::Flush(size_t lane_index) {
+  // The workers are only known once the IO thread has a resource context,
+  // which it gets before it runs any upload.
+  if (lane_index == 0 && workers_provider_) {
+    std::vector<Worker> workers = workers_provider_();
+    workers_provider_ = nullptr;
+    std::scoped_lock lock(mutex_);
+    for (auto& worker : workers) {
+      lanes_.push_back(
+          {std::move(worker.task_runner), std::move(worker.uploader)});
+    }
+    ScheduleFlushesLocked();
+  }
+
+  // Always takes at least one upload, however large. A burst is split between
+  // the lanes rather than taken by the first one.
+  std::vector<PendingUpload> batch;
+  size_t batch_bytes = 0;
+  Uploader uploader;
+  {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(lanes_[lane_index].task_runner->RunsTasksOnCurrentThread());
+    uploader = lanes_[lane_index].uploader;
+    const size_t max_batch_bytes =
+        std::min(max_batch_bytes_, pending_bytes_ / lanes_.size());
+    while (!pending_.empty() &&
+           (batch.empty() ||
+            batch_bytes + pending_.front().bytes <= max_batch_bytes)) {
+      batch_bytes += pending_.front().bytes;
+      batch.push_back(std::move(pending_.front()));
+      pending_.pop_front();
+    }
+    pending_bytes_ -= batch_bytes;
+  }
+
+  TRACE_EVENT2("flutter", "ImageUploadQueue::Flush", "images",
+               std::to_string(batch.size()).c_str(), "bytes",
+               std::to_string(batch_bytes).c_str());
+  const auto start = fml::TimePoint::Now();
+  for (auto& upload : batch) {
+    upload.done(uploader(std::move(upload.image), *upload.flow));
+  }
+  const double seconds = (fml::TimePoint::Now() - start).ToSecondsF();
+
+  size_t depth;
+  size_t pending_bytes;
+  {
+    // The images queued meanwhile wait for the IO tasks posted before them.
+    std::scoped_lock lock(mutex_);
+    depth = pending_.size();
+    pending_bytes = pending_bytes_;
+    lanes_[lane_index].flush_scheduled = false;
+    scheduled_flush_count_--;
+    ScheduleFlushesLocked();
+  }
+
+  TraceCounters(depth, pending_bytes, seconds > 0 ? batch_bytes / seconds : 0);
+}
+
+void ImageUploadQueue::TraceCounters(size_t depth,
+                                     size_t bytes,
+                                     double bytes_per_second) {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "ImageUploadQueue",
+                    reinterpret_cast<int64_t>(this),                  //
+                    "Depth", depth,                                   //
+                    "MBytes", bytes * 1e-6,                           //
+                    "UploadMBytesPerSecond", bytes_per_second * 1e-6  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
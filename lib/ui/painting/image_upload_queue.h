@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+// Uploads the images decoded on the worker threads to the GPU on the IO thread,
+// several per IO task.
+//
+// A burst of decoded images, like a grid of images appearing at once, would
+// otherwise post one IO task per image. Instead, the first image queued posts a
+// task that uploads the images queued by the time it runs, up to a budget of
+// bytes per task, and posts another task for the rest. This keeps the IO
+// thread responsive to its other tasks while a burst is uploaded.
+//
+// Where the IO manager has upload workers, threads with resource contexts of
+// their own, they take batches from the same queue concurrently with the IO
+// thread. A burst is then split evenly between them.
+//
+// The queue depth, the bytes queued and the upload throughput are traced as
+// the "ImageUploadQueue" counter.
+//
+// This class is thread-safe.
+class ImageUploadQueue final
+    : public std::enable_shared_from_this<ImageUploadQueue> {
+ public:
+  // Uploads an image on the IO thread, or on an upload worker, or returns
+  // null if it failed.
+  using Uploader = std::function<SkiaGPUObject<SkImage>(
+      sk_sp<SkImage> image,
+      const fml::tracing::TraceFlow& flow)>;
+
+  // A thread besides the IO thread that uploads images with its own resource
+  // context, see |IOManager::GetUploadWorkers|.
+  struct Worker {
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    Uploader uploader;
+  };
+
+  // Returns the workers that upload images besides the IO thread. Called once,
+  // on the IO thread before its first upload, since the workers are only
+  // started along with the resource context.
+  using WorkersProvider = std::function<std::vector<Worker>()>;
+
+  using Callback = std::function<void(SkiaGPUObject<SkImage>)>;
+
+  // More than a few frames' worth of uploads on most devices, but little
+  // enough to not hold up the other IO tasks for long.
+  static constexpr size_t kDefaultMaxBatchBytes = 8 << 20;
+
+  ImageUploadQueue(fml::RefPtr<fml::TaskRunner> io_task_runner,
+                   Uploader uploader,
+                   size_t max_batch_bytes = kDefaultMaxBatchBytes,
+                   WorkersProvider workers_provider = nullptr);
+
+  ~ImageUploadQueue();
+
+  // Queues |image| for upload. |done| is called on the IO thread or on the
+  // upload worker that uploaded the image, with the uploaded image, or with a
+  // null image if the upload failed.
+  void Enqueue(sk_sp<SkImage> image,
+               std::shared_ptr<fml::tracing::TraceFlow> flow,
+               Callback done);
+
+ private:
+  struct PendingUpload {
+    sk_sp<SkImage> image;
+    std::shared_ptr<fml::tracing::TraceFlow> flow;
+    Callback done;
+    size_t bytes;
+  };
+
+  // The IO thread, then the upload workers.
+  struct Lane {
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    Uploader uploader;
+    bool flush_scheduled = false;
+  };
+
+  const size_t max_batch_bytes_;
+  WorkersProvider workers_provider_;
+  std::mutex mutex_;
+  std::vector<Lane> lanes_;
+  std::deque<PendingUpload> pending_;
+  size_t pending_bytes_ = 0;
+  size_t scheduled_flush_count_ = 0;
+
+  // Schedules flushes on the idle lanes, up to one per queued image.
+  void ScheduleFlushesLocked();
+
+  // Uploads the next batch on the thread of the lane at |lane_index|.
+  void Flush(size_t lane_index);
+
+  void TraceCounters(size_t depth, size_t bytes, double bytes_per_second);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageUploadQueue);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
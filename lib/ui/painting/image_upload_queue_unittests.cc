@@ -0,0 +1,178 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_upload_queue.h"
+
+#include <atomic>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/thread_test.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+class ImageUploadQueueTest : public ThreadTest {
+ public:
+  ImageUploadQueueTest() : io_task_runner_(CreateNewThread("io")) {}
+
+  // A 10x10 image, which takes 400 bytes.
+  static sk_sp<SkImage> MakeImage() {
+    return SkSurface::MakeRasterN32Premul(10, 10)->makeImageSnapshot();
+  }
+
+  // Creates a queue whose uploads record the images they were given, on the
+  // IO thread.
+  std::shared_ptr<ImageUploadQueue> CreateQueue(size_t max_batch_bytes) {
+    return std::make_shared<ImageUploadQueue>(
+        io_task_runner_,
+        [this](sk_sp<SkImage> image, const fml::tracing::TraceFlow& flow) {
+          EXPECT_TRUE(io_task_runner_->RunsTasksOnCurrentThread());
+          uploaded_.push_back(image.get());
+          return SkiaGPUObject<SkImage>();
+        },
+        max_batch_bytes);
+  }
+
+  // Creates a queue with an upload worker on |worker_task_runner|. Counts the
+  // uploads on each thread.
+  std::shared_ptr<ImageUploadQueue> CreateQueueWithWorker(
+      fml::RefPtr<fml::TaskRunner> worker_task_runner,
+      std::atomic<size_t>* io_uploads,
+      std::atomic<size_t>* worker_uploads) {
+    return std::make_shared<ImageUploadQueue>(
+        io_task_runner_,
+        [this, io_uploads](sk_sp<SkImage> image,
+                           const fml::tracing::TraceFlow& flow) {
+          EXPECT_TRUE(io_task_runner_->RunsTasksOnCurrentThread());
+          (*io_uploads)++;
+          return SkiaGPUObject<SkImage>();
+        },
+        ImageUploadQueue::kDefaultMaxBatchBytes,
+        [worker_task_runner, worker_uploads]() {
+          ImageUploadQueue::Worker worker = {
+              worker_task_runner,
+              [worker_task_runner, worker_uploads](
+                  sk_sp<SkImage> image, const fml::tracing::TraceFlow& flow) {
+                EXPECT_TRUE(worker_task_runner->RunsTasksOnCurrentThread());
+                (*worker_uploads)++;
+                return SkiaGPUObject<SkImage>();
+              }};
+          return std::vector<ImageUploadQueue::Worker>({worker});
+        });
+  }
+
+  // Keeps the IO thread busy until the returned event is signaled.
+  std::shared_ptr<fml::ManualResetWaitableEvent> BlockIOThread() {
+    auto unblock = std::make_shared<fml::ManualResetWaitableEvent>();
+    io_task_runner_->PostTask([unblock]() { unblock->Wait(); });
+    return unblock;
+  }
+
+  // Runs |task| on the IO thread after the tasks posted so far.
+  void PostIOTask(fml::closure task) { io_task_runner_->PostTask(task); }
+
+  // Only accessed on the IO thread until the uploads are done.
+  std::vector<SkImage*> uploaded_;
+
+ private:
+  fml::RefPtr<fml::TaskRunner> io_task_runner_;
+};
+
+TEST_F(ImageUploadQueueTest, UploadsQueuedImagesInOneTask) {
+  auto queue = CreateQueue(ImageUploadQueue::kDefaultMaxBatchBytes);
+  std::vector<sk_sp<SkImage>> images = {MakeImage(), MakeImage(), MakeImage()};
+
+  auto unblock = BlockIOThread();
+  fml::CountDownLatch done(images.size());
+  for (const auto& image : images) {
+    queue->Enqueue(image, std::make_shared<fml::tracing::TraceFlow>(""),
+                   [&done](SkiaGPUObject<SkImage> uploaded) {
+                     done.CountDown();
+                   });
+  }
+  // Runs after the task that uploads the batch.
+  size_t uploaded_before_next_task = 0;
+  PostIOTask([this, &uploaded_before_next_task]() {
+    uploaded_before_next_task = uploaded_.size();
+  });
+  unblock->Signal();
+  done.Wait();
+
+  fml::AutoResetWaitableEvent latch;
+  PostIOTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  EXPECT_EQ(uploaded_before_next_task, 3u);
+  ASSERT_EQ(uploaded_.size(), 3u);
+  for (size_t i = 0; i < images.size(); i++) {
+    EXPECT_EQ(uploaded_[i], images[i].get());
+  }
+}
+
+TEST_F(ImageUploadQueueTest, YieldsToOtherTasksBetweenBatches) {
+  // Fits one image per batch.
+  auto queue = CreateQueue(400);
+
+  auto unblock = BlockIOThread();
+  fml::CountDownLatch done(3);
+  for (size_t i = 0; i < 3; i++) {
+    queue->Enqueue(MakeImage(), std::make_shared<fml::tracing::TraceFlow>(""),
+                   [&done](SkiaGPUObject<SkImage> uploaded) {
+                     done.CountDown();
+                   });
+  }
+  size_t uploaded_before_next_task = 0;
+  PostIOTask([this, &uploaded_before_next_task]() {
+    uploaded_before_next_task = uploaded_.size();
+  });
+  unblock->Signal();
+  done.Wait();
+
+  fml::AutoResetWaitableEvent latch;
+  PostIOTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  EXPECT_EQ(uploaded_before_next_task, 1u);
+  EXPECT_EQ(uploaded_.size(), 3u);
+}
+
+TEST_F(ImageUploadQueueTest, SplitsBurstsWithWorkers) {
+  auto worker_task_runner = CreateNewThread("worker");
+  std::atomic<size_t> io_uploads = 0;
+  std::atomic<size_t> worker_uploads = 0;
+  auto queue =
+      CreateQueueWithWorker(worker_task_runner, &io_uploads, &worker_uploads);
+
+  auto unblock_io = BlockIOThread();
+  fml::ManualResetWaitableEvent unblock_worker;
+  worker_task_runner->PostTask([&unblock_worker]() { unblock_worker.Wait(); });
+  fml::CountDownLatch done(8);
+  for (size_t i = 0; i < 8; i++) {
+    queue->Enqueue(MakeImage(), std::make_shared<fml::tracing::TraceFlow>(""),
+                   [&done](SkiaGPUObject<SkImage> uploaded) {
+                     done.CountDown();
+                   });
+  }
+  // Runs after the first batch of the IO thread, which leaves the rest of the
+  // burst to the worker.
+  size_t uploaded_before_next_task = 0;
+  PostIOTask([&io_uploads, &uploaded_before_next_task]() {
+    uploaded_before_next_task = io_uploads;
+  });
+  unblock_io->Signal();
+
+  fml::AutoResetWaitableEvent latch;
+  PostIOTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  unblock_worker.Signal();
+  done.Wait();
+
+  EXPECT_EQ(uploaded_before_next_task, 4u);
+  EXPECT_EQ(io_uploads + worker_uploads, 8u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,28 +4,51 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
+
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
 namespace flutter {
 
-MultiFrameCodec::MultiFrameCodec(std::unique_ptr<SkCodec> codec)
-    : state_(new State(std::move(codec))) {}
+MultiFrameCodec::MultiFrameCodec(std::unique_ptr<SkCodec> codec,
+                                 ImageDecoder::AnimatedImageOptions options)
+    : state_(std::make_shared<State>(std::move(codec), options)) {}
 
-MultiFrameCodec::~MultiFrameCodec() = default;
+MultiFrameCodec::~MultiFrameCodec() {
+  state_->Abandon();
+}
 
-MultiFrameCodec::State::State(std::unique_ptr<SkCodec> codec)
+static bool FramesFitInCache(const SkCodec& codec,
+                             int frameCount,
+                             size_t maxBytes) {
+  const size_t frameBytes =
+      codec.getInfo().makeColorType(kN32_SkColorType).computeMinByteSize();
+  return maxBytes > 0 && frameBytes > 0 &&
+         static_cast<size_t>(frameCount) <= maxBytes / frameBytes;
+}
+
+MultiFrameCodec::State::State(std::unique_ptr<SkCodec> codec,
+                              ImageDecoder::AnimatedImageOptions options)
     : codec_(std::move(codec)),
       frameCount_(codec_->getFrameCount()),
       repetitionCount_(codec_->getRepetitionCount()),
-      nextFrameIndex_(0) {}
+      lookAheadFrames_(std::max(options.look_ahead_frames, 0)),
+      cacheAllFrames_(FramesFitInCache(*codec_,
+                                       frameCount_,
+                                       options.frame_cache_max_bytes)),
+      nextFrameIndex_(0) {
+  if (cacheAllFrames_) {
+    cachedFrames_.resize(frameCount_);
+  }
+}
 
 static void InvokeNextFrameCallback(
     fml::RefPtr<FrameInfo> frameInfo,
-    std::unique_ptr<DartPersistentValue> callback,
-    size_t trace_id) {
+    std::unique_ptr<DartPersistentValue> callback) {
   std::shared_ptr<tonic::DartState> dart_state = callback->dart_state().lock();
   if (!dart_state) {
     FML_DLOG(ERROR) << "Could not acquire Dart state while attempting to fire "
@@ -40,8 +63,10 @@ static void InvokeNextFrameCallback(
   }
 }
 
-// Copied the source bitmap to the destination. If this cannot occur due to
-// running out of memory or the image info not being compatible, returns false.
+// Copied the source bitmap to the destination, reusing the destination's
+// pixels if they have the right size and color type. If this cannot occur due
+// to running out of memory or the image info not being compatible, returns
+// false.
 static bool CopyToBitmap(SkBitmap* dst,
                          SkColorType dstColorType,
                          const SkBitmap& src) {
@@ -50,8 +75,13 @@ static bool CopyToBitmap(SkBitmap* dst,
     return false;
   }
 
-  SkBitmap tmpDst;
   SkImageInfo dstInfo = srcPM.info().makeColorType(dstColorType);
+  SkPixmap dstPM;
+  if (dst->info() == dstInfo && dst->peekPixels(&dstPM)) {
+    return srcPM.readPixels(dstPM);
+  }
+
+  SkBitmap tmpDst;
   if (!tmpDst.setInfo(dstInfo)) {
     return false;
   }
@@ -60,7 +90,6 @@ static bool CopyToBitmap(SkBitmap* dst,
     return false;
   }
 
-  SkPixmap dstPM;
   if (!tmpDst.peekPixels(&dstPM)) {
     return false;
   }
@@ -73,14 +102,126 @@ static bool CopyToBitmap(SkBitmap* dst,
   return true;
 }
 
-sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
-    fml::WeakPtr<GrContext> resourceContext) {
-  SkBitmap bitmap = SkBitmap();
+void MultiFrameCodec::State::GetNextFrame(
+    std::unique_ptr<DartPersistentValue> callback,
+    TaskContext context) {
+  std::scoped_lock lock(mutex_);
+  context_ = std::move(context);
+  callbacks_.push_back(std::move(callback));
+  if (!readyFrames_.empty()) {
+    Frame frame = std::move(readyFrames_.front());
+    readyFrames_.pop_front();
+    auto waiting = std::move(callbacks_.front());
+    callbacks_.pop_front();
+    ReturnFrameLocked(std::move(waiting), std::move(frame));
+  }
+  ReturnCachedFramesLocked();
+  ScheduleDecodesLocked();
+}
+
+void MultiFrameCodec::State::Abandon() {
+  std::deque<std::unique_ptr<DartPersistentValue>> callbacks;
+  fml::RefPtr<fml::TaskRunner> ui_task_runner;
+  {
+    std::scoped_lock lock(mutex_);
+    abandoned_ = true;
+    callbacks.swap(callbacks_);
+    readyFrames_.clear();
+    freeBitmaps_.clear();
+    cachedFrames_.clear();
+    ui_task_runner = context_.ui_task_runner;
+  }
+  if (callbacks.empty()) {
+    return;
+  }
+  ui_task_runner->PostTask(
+      fml::MakeCopyable([callbacks = std::move(callbacks)]() mutable {
+        for (auto& callback : callbacks) {
+          callback->Clear();
+        }
+      }));
+}
+
+void MultiFrameCodec::State::ScheduleDecodesLocked() {
+  if (abandoned_ || decoding_ || decodedAllFrames_ ||
+      readyFrames_.size() + framesInFlight_ >=
+          callbacks_.size() + lookAheadFrames_) {
+    return;
+  }
+  decoding_ = true;
+  auto task = [weak_state = weak_from_this()]() {
+    if (auto state = weak_state.lock()) {
+      state->DecodeFrames();
+    }
+  };
+  if (context_.concurrent_task_runner) {
+    context_.concurrent_task_runner->PostTask(task);
+  } else {
+    context_.io_task_runner->PostTask(task);
+  }
+}
+
+void MultiFrameCodec::State::DecodeFrames() {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::DecodeFrames");
+  while (true) {
+    SkBitmap bitmap;
+    fml::RefPtr<fml::TaskRunner> io_task_runner;
+    fml::WeakPtr<IOManager> io_manager;
+    {
+      std::scoped_lock lock(mutex_);
+      if (abandoned_ || decodedAllFrames_ ||
+          readyFrames_.size() + framesInFlight_ >=
+              callbacks_.size() + lookAheadFrames_) {
+        decoding_ = false;
+        return;
+      }
+      framesInFlight_++;
+      if (!freeBitmaps_.empty()) {
+        bitmap = std::move(freeBitmaps_.back());
+        freeBitmaps_.pop_back();
+      }
+      io_task_runner = context_.io_task_runner;
+      io_manager = context_.io_manager;
+    }
+
+    const int index = nextFrameIndex_;
+    const bool decoded = DecodeNextFrame(&bitmap);
+    SkCodec::FrameInfo frameInfo;
+    codec_->getFrameInfo(index, &frameInfo);
+    nextFrameIndex_ = (index + 1) % frameCount_;
+
+    if (cacheAllFrames_ && index == frameCount_ - 1) {
+      // The frames in flight complete the cache, so the decoding buffers are
+      // no longer needed.
+      lastRequiredFrame_.reset();
+      std::scoped_lock lock(mutex_);
+      decodedAllFrames_ = true;
+      freeBitmaps_.clear();
+    }
+
+    io_task_runner->PostTask(fml::MakeCopyable(
+        [weak_state = weak_from_this(), io_manager, bitmap = std::move(bitmap),
+         decoded, index, duration = frameInfo.fDuration]() mutable {
+          if (auto state = weak_state.lock()) {
+            state->UploadFrame(io_manager, std::move(bitmap), decoded, index,
+                               duration);
+          }
+        }));
+  }
+}
+
+bool MultiFrameCodec::State::DecodeNextFrame(SkBitmap* bitmap) {
   SkImageInfo info = codec_->getInfo().makeColorType(kN32_SkColorType);
   if (info.alphaType() == kUnpremul_SkAlphaType) {
     info = info.makeAlphaType(kPremul_SkAlphaType);
   }
-  bitmap.allocPixels(info);
+  if (bitmap->info() != info || !bitmap->getPixels()) {
+    if (!bitmap->tryAllocPixels(info)) {
+      FML_LOG(ERROR) << "Could not allocate pixels for frame "
+                     << nextFrameIndex_;
+      return false;
+    }
+  }
 
   SkCodec::Options options;
   options.fFrameIndex = nextFrameIndex_;
@@ -92,7 +233,7 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
       FML_LOG(ERROR) << "Frame " << nextFrameIndex_ << " depends on frame "
                      << requiredFrameIndex
                      << " and no required frames are cached.";
-      return nullptr;
+      return false;
     } else if (lastRequiredFrameIndex_ != requiredFrameIndex) {
       FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
                      << " is not cached. Using " << lastRequiredFrameIndex_
@@ -100,65 +241,120 @@ sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
     }
 
     if (lastRequiredFrame_->getPixels() &&
-        CopyToBitmap(&bitmap, lastRequiredFrame_->colorType(),
+        CopyToBitmap(bitmap, lastRequiredFrame_->colorType(),
                      *lastRequiredFrame_)) {
       options.fPriorFrame = requiredFrameIndex;
     }
   }
 
-  if (SkCodec::kSuccess != codec_->getPixels(info, bitmap.getPixels(),
-                                             bitmap.rowBytes(), &options)) {
+  if (SkCodec::kSuccess != codec_->getPixels(info, bitmap->getPixels(),
+                                             bitmap->rowBytes(), &options)) {
     FML_LOG(ERROR) << "Could not getPixels for frame " << nextFrameIndex_;
-    return nullptr;
+    return false;
   }
 
-  // Hold onto this if we need it to decode future frames.
+  // Hold onto this if we need it to decode future frames. This shares the
+  // pixels, so the bitmap won't be reused for later frames.
   if (frameInfo.fDisposalMethod == SkCodecAnimation::DisposalMethod::kKeep) {
-    lastRequiredFrame_ = std::make_unique<SkBitmap>(bitmap);
+    lastRequiredFrame_ = std::make_unique<SkBitmap>(*bitmap);
     lastRequiredFrameIndex_ = nextFrameIndex_;
   }
+  return true;
+}
+
+void MultiFrameCodec::State::UploadFrame(fml::WeakPtr<IOManager> io_manager,
+                                         SkBitmap bitmap,
+                                         bool decoded,
+                                         int index,
+                                         int duration) {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::UploadFrame");
+  Frame frame;
+  frame.duration = duration;
+  if (decoded && io_manager) {
+    sk_sp<SkImage> image;
+    auto resourceContext = io_manager->GetResourceContext();
+    if (resourceContext) {
+      SkPixmap pixmap(bitmap.info(), bitmap.pixelRef()->pixels(),
+                      bitmap.pixelRef()->rowBytes());
+      image = SkImage::MakeCrossContextFromPixmap(resourceContext.get(),
+                                                  pixmap, true);
+    } else {
+      // Defer decoding until time of draw later on the raster thread. Can
+      // happen when GL operations are currently forbidden such as in the
+      // background on iOS.
+      image = SkImage::MakeFromBitmap(bitmap);
+    }
+    if (image) {
+      frame.image = {std::move(image), io_manager->GetSkiaUnrefQueue()};
+    }
+  }
+
+  std::scoped_lock lock(mutex_);
+  framesInFlight_--;
+  if (abandoned_) {
+    return;
+  }
 
-  if (resourceContext) {
-    SkPixmap pixmap(bitmap.info(), bitmap.pixelRef()->pixels(),
-                    bitmap.pixelRef()->rowBytes());
-    return SkImage::MakeCrossContextFromPixmap(resourceContext.get(), pixmap,
-                                               true);
+  // Both kinds of images copy the pixels of the mutable bitmap, so they can be
+  // reused unless a later frame requires them.
+  if (bitmap.pixelRef() && bitmap.pixelRef()->unique() && !decodedAllFrames_ &&
+      freeBitmaps_.size() <= static_cast<size_t>(lookAheadFrames_)) {
+    freeBitmaps_.push_back(std::move(bitmap));
+  }
+
+  if (cacheAllFrames_) {
+    cachedFrames_[index] = CopyFrame(frame);
+  }
+  if (!callbacks_.empty()) {
+    auto callback = std::move(callbacks_.front());
+    callbacks_.pop_front();
+    ReturnFrameLocked(std::move(callback), std::move(frame));
   } else {
-    // Defer decoding until time of draw later on the raster thread. Can happen
-    // when GL operations are currently forbidden such as in the background
-    // on iOS.
-    return SkImage::MakeFromBitmap(bitmap);
+    readyFrames_.push_back(std::move(frame));
+  }
+  ReturnCachedFramesLocked();
+  ScheduleDecodesLocked();
+}
+
+MultiFrameCodec::Frame MultiFrameCodec::State::CopyFrame(const Frame& frame) {
+  Frame copy;
+  copy.duration = frame.duration;
+  if (frame.image.get()) {
+    copy.image = {frame.image.get(), frame.image.queue()};
+  }
+  return copy;
+}
+
+void MultiFrameCodec::State::ReturnCachedFramesLocked() {
+  if (!decodedAllFrames_ || framesInFlight_ > 0 || !readyFrames_.empty()) {
+    return;
+  }
+  while (!callbacks_.empty()) {
+    auto callback = std::move(callbacks_.front());
+    callbacks_.pop_front();
+    ReturnFrameLocked(std::move(callback),
+                      CopyFrame(cachedFrames_[nextReturnedFrameIndex_]));
   }
 }
 
-void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
+void MultiFrameCodec::State::ReturnFrameLocked(
     std::unique_ptr<DartPersistentValue> callback,
-    fml::RefPtr<fml::TaskRunner> ui_task_runner,
-    fml::WeakPtr<GrContext> resourceContext,
-    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-    size_t trace_id) {
-  fml::RefPtr<FrameInfo> frameInfo = NULL;
-  sk_sp<SkImage> skImage = GetNextFrameImage(resourceContext);
-  if (skImage) {
-    fml::RefPtr<CanvasImage> image = CanvasImage::Create();
-    image->set_image({skImage, std::move(unref_queue)});
-    SkCodec::FrameInfo skFrameInfo;
-    codec_->getFrameInfo(nextFrameIndex_, &skFrameInfo);
-    frameInfo =
-        fml::MakeRefCounted<FrameInfo>(std::move(image), skFrameInfo.fDuration);
-  }
-  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
-
-  ui_task_runner->PostTask(fml::MakeCopyable(
-      [callback = std::move(callback), frameInfo, trace_id]() mutable {
-        InvokeNextFrameCallback(frameInfo, std::move(callback), trace_id);
+    Frame frame) {
+  nextReturnedFrameIndex_ = (nextReturnedFrameIndex_ + 1) % frameCount_;
+  context_.ui_task_runner->PostTask(fml::MakeCopyable(
+      [callback = std::move(callback), frame = std::move(frame)]() mutable {
+        fml::RefPtr<FrameInfo> frameInfo;
+        if (frame.image.get()) {
+          fml::RefPtr<CanvasImage> image = CanvasImage::Create();
+          image->set_image(std::move(frame.image));
+          frameInfo =
+              fml::MakeRefCounted<FrameInfo>(std::move(image), frame.duration);
+        }
+        InvokeNextFrameCallback(std::move(frameInfo), std::move(callback));
       }));
 }
 
 Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
-  static size_t trace_counter = 1;
-  const size_t trace_id = trace_counter++;
-
   if (!Dart_IsClosure(callback_handle)) {
     return tonic::ToDart("Callback must be a function");
   }
@@ -166,24 +362,17 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   auto* dart_state = UIDartState::Current();
 
   const auto& task_runners = dart_state->GetTaskRunners();
+  TaskContext context;
+  context.ui_task_runner = task_runners.GetUITaskRunner();
+  context.io_task_runner = task_runners.GetIOTaskRunner();
+  context.io_manager = dart_state->GetIOManager();
+  if (auto image_decoder = dart_state->GetImageDecoder()) {
+    context.concurrent_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
 
-  task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
-      [callback = std::make_unique<DartPersistentValue>(
-           tonic::DartState::Current(), callback_handle),
-       weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
-       ui_task_runner = task_runners.GetUITaskRunner(),
-       io_manager = dart_state->GetIOManager()]() mutable {
-        auto state = weak_state.lock();
-        if (!state) {
-          ui_task_runner->PostTask(fml::MakeCopyable(
-              [callback = std::move(callback)]() { callback->Clear(); }));
-          return;
-        }
-        state->GetNextFrameAndInvokeCallback(
-            std::move(callback), std::move(ui_task_runner),
-            io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
-            trace_id);
-      }));
+  state_->GetNextFrame(std::make_unique<DartPersistentValue>(
+                           tonic::DartState::Current(), callback_handle),
+                       std::move(context));
 
   return Dart_Null();
 }
@@ -5,14 +5,33 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/codec.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
 
 namespace flutter {
 
+// Decodes the frames of an animated image on the worker threads and uploads
+// them on the IO thread.
+//
+// Up to |AnimatedImageOptions::look_ahead_frames| frames are decoded ahead of
+// the frames requested, so that the next frame is usually ready when it is
+// requested. The pixel buffers of uploaded frames are reused for the frames
+// decoded after them. Animations whose frames all fit in
+// |AnimatedImageOptions::frame_cache_max_bytes| keep their frames after the
+// first loop and stop decoding.
 class MultiFrameCodec : public Codec {
  public:
-  MultiFrameCodec(std::unique_ptr<SkCodec> codec);
+  MultiFrameCodec(std::unique_ptr<SkCodec> codec,
+                  ImageDecoder::AnimatedImageOptions options = {});
 
   ~MultiFrameCodec() override;
 
@@ -26,25 +45,46 @@ class MultiFrameCodec : public Codec {
   Dart_Handle getNextFrame(Dart_Handle args) override;
 
  private:
-  // Captures the state shared between the IO and UI task runners.
+  // The task runners and resources the decoding work uses, which are the same
+  // for every request made by the isolate that owns the codec.
+  struct TaskContext {
+    fml::RefPtr<fml::TaskRunner> ui_task_runner;
+    fml::RefPtr<fml::TaskRunner> io_task_runner;
+    // Frames are decoded on the IO thread if there are no worker threads.
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
+    fml::WeakPtr<IOManager> io_manager;
+  };
+
+  // A decoded frame. The image is null if the frame failed to decode.
+  struct Frame {
+    SkiaGPUObject<SkImage> image;
+    int duration = 0;
+  };
+
+  // Captures the state shared between the UI, worker and IO task runners.
   //
   // The state is initialized on the UI task runner when the Dart object is
-  // created. Decoding occurs on the IO task runner. Since it is possible for
-  // the UI object to be collected independently of the IO task runner work,
-  // it is not safe for this state to live directly on the MultiFrameCodec.
-  // Instead, the MultiFrameCodec creates this object when it is constructed,
-  // shares it with the IO task runner's decoding work, and sets the live_
-  // member to false when it is destructed.
-  struct State {
-    State(std::unique_ptr<SkCodec> codec);
+  // created. Decoding occurs on the worker task runners and uploads on the IO
+  // task runner. Since it is possible for the UI object to be collected
+  // independently of the worker and IO task runner work, it is not safe for
+  // this state to live directly on the MultiFrameCodec. Instead, the
+  // MultiFrameCodec creates this object when it is constructed, shares weak
+  // references to it with the decoding work, and abandons it when it is
+  // destructed.
+  struct State : public std::enable_shared_from_this<State> {
+    State(std::unique_ptr<SkCodec> codec,
+          ImageDecoder::AnimatedImageOptions options);
 
     const std::unique_ptr<SkCodec> codec_;
     const int frameCount_;
     const int repetitionCount_;
+    const int lookAheadFrames_;
+    // Whether the decoded frames of the whole animation fit in the frame
+    // cache.
+    const bool cacheAllFrames_;
 
-    // The non-const members and functions below here are only read or written
-    // to on the IO thread. They are not safe to access or write on the UI
-    // thread.
+    // The members below here up to the mutex are only read or written to by
+    // the decode task, of which at most one runs at a time.
     int nextFrameIndex_;
     // The last decoded frame that's required to decode any subsequent frames.
     std::unique_ptr<SkBitmap> lastRequiredFrame_;
@@ -52,17 +92,62 @@ class MultiFrameCodec : public Codec {
     // The index of the last decoded required frame.
     int lastRequiredFrameIndex_ = -1;
 
-    sk_sp<SkImage> GetNextFrameImage(fml::WeakPtr<GrContext> resourceContext);
-
-    void GetNextFrameAndInvokeCallback(
-        std::unique_ptr<DartPersistentValue> callback,
-        fml::RefPtr<fml::TaskRunner> ui_task_runner,
-        fml::WeakPtr<GrContext> resourceContext,
-        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-        size_t trace_id);
+    // Guards the members below.
+    std::mutex mutex_;
+    TaskContext context_;
+    // Set when the MultiFrameCodec is collected.
+    bool abandoned_ = false;
+    bool decoding_ = false;
+    // The callbacks waiting for frames, in the order they were requested.
+    std::deque<std::unique_ptr<DartPersistentValue>> callbacks_;
+    // The uploaded frames that haven't been requested yet, in order.
+    std::deque<Frame> readyFrames_;
+    // The frames being decoded or uploaded.
+    int framesInFlight_ = 0;
+    // The pixel buffers of uploaded frames, to decode later frames into.
+    std::vector<SkBitmap> freeBitmaps_;
+    // Every frame of the animation, once |decodedAllFrames_| is set and the
+    // frames in flight have been uploaded. Only used if |cacheAllFrames_|.
+    std::vector<Frame> cachedFrames_;
+    bool decodedAllFrames_ = false;
+    // The index of the frame returned by the next request.
+    int nextReturnedFrameIndex_ = 0;
+
+    // Requests the next frame for |callback|. On the UI thread.
+    void GetNextFrame(std::unique_ptr<DartPersistentValue> callback,
+                      TaskContext context);
+
+    // Drops the frames and the waiting callbacks. On the UI thread.
+    void Abandon();
+
+    // Decodes frames until enough are decoded ahead. On a worker thread.
+    void DecodeFrames();
+
+    // Decodes the frame at |nextFrameIndex_| into |bitmap|, reusing its
+    // pixels if it has any.
+    bool DecodeNextFrame(SkBitmap* bitmap);
+
+    // Uploads a decoded frame and returns it to the first waiting callback.
+    // On the IO thread.
+    void UploadFrame(fml::WeakPtr<IOManager> io_manager,
+                     SkBitmap bitmap,
+                     bool decoded,
+                     int index,
+                     int duration);
+
+    void ScheduleDecodesLocked();
+
+    void ReturnFrameLocked(std::unique_ptr<DartPersistentValue> callback,
+                           Frame frame);
+
+    static Frame CopyFrame(const Frame& frame);
+
+    // Returns the cached frames to the waiting callbacks, once no more frames
+    // will be uploaded.
+    void ReturnCachedFramesLocked();
   };
 
-  // Shared across the UI and IO task runners.
+  // Shared across the UI, worker and IO task runners.
   std::shared_ptr<State> state_;
 
   FML_FRIEND_MAKE_REF_COUNTED(MultiFrameCodec);
@@ -33,7 +33,8 @@ constexpr int kMaskFilterBlurStyleIndex = 10;
 constexpr int kMaskFilterSigmaIndex = 11;
 constexpr int kInvertColorIndex = 12;
 constexpr int kDitherIndex = 13;
-constexpr size_t kDataByteCount = 56;  // 4 * (last index + 1)
+static_assert(Paint::kDataByteCount == 4 * (kDitherIndex + 1),
+              "Paint::kDataByteCount must match the last index.");
 
 // Indices for objects.
 constexpr int kShaderIndex = 0;
@@ -70,6 +71,24 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
   if (is_null_)
     return;
 
+  if (!DecodeObjects(paint_objects))
+    return;
+
+  tonic::DartByteData byte_data(paint_data);
+  FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
+  DecodeData(byte_data.data());
+}
+
+Paint Paint::FromEncodedData(Dart_Handle paint_objects,
+                             const void* paint_data) {
+  Paint paint;
+  paint.is_null_ = false;
+  if (paint.DecodeObjects(paint_objects))
+    paint.DecodeData(paint_data);
+  return paint;
+}
+
+bool Paint::DecodeObjects(Dart_Handle paint_objects) {
   Dart_Handle values[kObjectCount];
   if (!Dart_IsNull(paint_objects)) {
     FML_DCHECK(Dart_IsList(paint_objects));
@@ -78,7 +97,7 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
 
     FML_CHECK(length == kObjectCount);
     if (Dart_IsError(Dart_ListGetRange(paint_objects, 0, kObjectCount, values)))
-      return;
+      return false;
 
     Dart_Handle shader = values[kShaderIndex];
     if (!Dart_IsNull(shader)) {
@@ -100,12 +119,12 @@ Paint::Paint(Dart_Handle paint_objects, Dart_Handle paint_data) {
       paint_.setImageFilter(decoded->filter());
     }
   }
+  return true;
+}
 
-  tonic::DartByteData byte_data(paint_data);
-  FML_CHECK(byte_data.length_in_bytes() == kDataByteCount);
-
-  const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
+void Paint::DecodeData(const void* paint_data) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(paint_data);
+  const float* float_data = static_cast<const float*>(paint_data);
 
   paint_.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
 
@@ -12,14 +12,26 @@ namespace flutter {
 
 class Paint {
  public:
+  // The size of the encoded data of a Paint, which is 4 bytes per field.
+  static constexpr size_t kDataByteCount = 56;
+
   Paint() = default;
   Paint(Dart_Handle paint_objects, Dart_Handle paint_data);
 
+  // Decodes a Paint whose |kDataByteCount| bytes of encoded data were copied
+  // out of its ByteData, such as into a Canvas command buffer.
+  static Paint FromEncodedData(Dart_Handle paint_objects,
+                               const void* paint_data);
+
   const SkPaint* paint() const { return is_null_ ? nullptr : &paint_; }
 
  private:
   friend struct tonic::DartConverter<Paint>;
 
+  // Returns false if the objects could not be read.
+  bool DecodeObjects(Dart_Handle paint_objects);
+  void DecodeData(const void* paint_data);
+
   SkPaint paint_;
   bool is_null_ = true;
 };
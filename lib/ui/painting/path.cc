@@ -8,6 +8,7 @@
 #include <math.h>
 
 #include "flutter/lib/ui/painting/matrix.h"
+#include "flutter/lib/ui/painting/path_cache.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
@@ -26,6 +27,7 @@ static void Path_constructor(Dart_NativeArguments args) {
 }
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Path);
+IMPLEMENT_POOLED_ALLOCATION(CanvasPath);
 
 #define FOR_EACH_BINDING(V)          \
   V(Path, addArc)                    \
@@ -297,6 +299,19 @@ void CanvasPath::clone(Dart_Handle path_handle) {
   path->path_ = path_;
 }
 
+const SkPath& CanvasPath::GetInternedPath() const {
+  uint32_t generation_id = path_.getGenerationID();
+  if (generation_id == interned_generation_id_) {
+    return path_;
+  }
+  auto* dart_state = UIDartState::Current();
+  if (PathCache* cache = dart_state ? dart_state->GetPathCache() : nullptr) {
+    path_ = cache->Intern(path_);
+  }
+  interned_generation_id_ = path_.getGenerationID();
+  return path_;
+}
+
 // This is doomed to be called too early, since Paths are mutable.
 // However, it can help for some of the clone/shift/transform type methods
 // where the resultant path will initially have a meaningful size.
@@ -19,6 +19,7 @@ namespace flutter {
 
 class CanvasPath : public RefCountedDartWrappable<CanvasPath> {
   DEFINE_WRAPPERTYPEINFO();
+  DEFINE_POOLED_ALLOCATION();
   FML_FRIEND_MAKE_REF_COUNTED(CanvasPath);
 
  public:
@@ -110,6 +111,11 @@ class CanvasPath : public RefCountedDartWrappable<CanvasPath> {
 
   const SkPath& path() const { return path_; }
 
+  // Returns the path after interning it into the |PathCache| of the isolate,
+  // if it has one, so that it shares the generation ID of the paths drawn
+  // before with the same contents. Canvas draws this instead of |path()|.
+  const SkPath& GetInternedPath() const;
+
   size_t GetAllocationSize() const override;
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
@@ -117,7 +123,11 @@ class CanvasPath : public RefCountedDartWrappable<CanvasPath> {
  private:
   CanvasPath();
 
-  SkPath path_;
+  // Interning only replaces the path with an equal one, so it can be done to
+  // a const path.
+  mutable SkPath path_;
+  // The generation ID of |path_| when it was last interned.
+  mutable uint32_t interned_generation_id_ = 0;
 };
 
 }  // namespace flutter
@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/path_cache.h"
+
+#include <vector>
+
+#include "flutter/fml/hash.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// The conic weights aren't hashed, which SkPath doesn't expose, but they are
+// compared when the hashes are equal.
+static uint64_t HashPath(const SkPath& path) {
+  std::vector<uint8_t> verbs(path.countVerbs());
+  path.getVerbs(verbs.data(), verbs.size());
+  std::vector<SkPoint> points(path.countPoints());
+  path.getPoints(points.data(), points.size());
+
+  uint64_t hash = fml::HashMix(static_cast<uint64_t>(path.getFillType()));
+  hash = fml::HashBytes(verbs.data(), verbs.size(), hash);
+  return fml::HashBytes(points.data(), points.size() * sizeof(SkPoint), hash);
+}
+
+PathCache::Key::Key(const SkPath& p_path)
+    : path(p_path), hash(HashPath(p_path)) {}
+
+bool PathCache::Key::operator==(const Key& other) const {
+  return hash == other.hash && path == other.path;
+}
+
+size_t PathCache::Key::Hash::operator()(const Key& key) const {
+  return static_cast<size_t>(key.hash);
+}
+
+PathCache::PathCache(size_t max_entries) : max_entries_(max_entries) {}
+
+PathCache::~PathCache() = default;
+
+SkPath PathCache::Intern(const SkPath& path) {
+  if (max_entries_ == 0 || path.isVolatile() || path.isEmpty()) {
+    return path;
+  }
+
+  Key key(path);
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    stats_.hits++;
+    // Moves the entry to the front.
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->path;
+  }
+
+  stats_.misses++;
+  if (entries_.size() == max_entries_) {
+    index_.erase(entries_.back());
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+  entries_.push_front(key);
+  index_.emplace(std::move(key), entries_.begin());
+  return path;
+}
+
+void PathCache::Clear() {
+  index_.clear();
+  entries_.clear();
+}
+
+void PathCache::TraceCounters() const {
+#if !FLUTTER_RELEASE
+  const size_t lookups = stats_.hits + stats_.misses;
+  FML_TRACE_COUNTER("flutter", "PathCache",
+                    reinterpret_cast<int64_t>(this),                       //
+                    "Count", entries_.size(),                              //
+                    "Hits", stats_.hits,                                   //
+                    "Misses", stats_.misses,                               //
+                    "Evictions", stats_.evictions,                         //
+                    "HitRate", lookups ? stats_.hits * 1.0 / lookups : 0.0  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
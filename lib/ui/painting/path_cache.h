@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PATH_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_PATH_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkPath.h"
+
+namespace flutter {
+
+// The paths drawn by an isolate, keyed by their contents.
+//
+// The framework builds a new Path for every frame that draws one, even when
+// its contents don't change, so Skia sees a path with a new generation ID each
+// frame and can't find the masks and tessellations it cached for the last one.
+// Interning a path returns a copy of the first path drawn with the same
+// contents, which shares its SkPathRef and so its generation ID.
+//
+// The cache keeps up to a number of paths, evicting the least recently
+// interned ones first. It is only used on the UI thread of its isolate.
+class PathCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  // Creates a cache that keeps up to |max_entries| paths.
+  explicit PathCache(size_t max_entries);
+
+  ~PathCache();
+
+  // Returns a path equal to |path| that shares the generation ID of the paths
+  // interned before with the same contents. Volatile and empty paths are
+  // returned as they are.
+  SkPath Intern(const SkPath& path);
+
+  void Clear();
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  const Stats& GetStats() const { return stats_; }
+
+  // Emits the entry count and the hit rate to the timeline.
+  void TraceCounters() const;
+
+ private:
+  struct Key {
+    explicit Key(const SkPath& path);
+
+    SkPath path;
+    uint64_t hash;
+
+    // Compares the contents of the paths, not only their hashes.
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      size_t operator()(const Key& key) const;
+    };
+  };
+
+  using LRUList = std::list<Key>;
+
+  const size_t max_entries_;
+  // Most recently interned first.
+  LRUList entries_;
+  std::unordered_map<Key, LRUList::iterator, Key::Hash> index_;
+  Stats stats_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PathCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PATH_CACHE_H_
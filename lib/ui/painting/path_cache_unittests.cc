@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/path_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static SkPath MakeBadge(float width) {
+  SkPath path;
+  path.addRoundRect(SkRect::MakeWH(width, 20), 10, 10);
+  return path;
+}
+
+TEST(PathCacheTest, EqualPathsShareAGenerationID) {
+  PathCache cache(10);
+  SkPath first = cache.Intern(MakeBadge(40));
+  SkPath second = cache.Intern(MakeBadge(40));
+  SkPath other = cache.Intern(MakeBadge(50));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first.getGenerationID(), second.getGenerationID());
+  EXPECT_NE(first.getGenerationID(), other.getGenerationID());
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+}
+
+TEST(PathCacheTest, ComparesTheFillTypeAndConicWeights) {
+  PathCache cache(10);
+  SkPath even_odd = MakeBadge(40);
+  even_odd.setFillType(SkPathFillType::kEvenOdd);
+  SkPath conic;
+  conic.conicTo(10, 0, 10, 10, 0.5f);
+  SkPath other_conic;
+  other_conic.conicTo(10, 0, 10, 10, 0.7f);
+
+  cache.Intern(MakeBadge(40));
+  cache.Intern(conic);
+  EXPECT_NE(cache.Intern(even_odd).getFillType(), SkPathFillType::kWinding);
+  EXPECT_EQ(cache.Intern(other_conic), other_conic);
+  EXPECT_EQ(cache.GetStats().hits, 0u);
+}
+
+TEST(PathCacheTest, MutatingAnInternedPathLeavesTheCacheUnchanged) {
+  PathCache cache(10);
+  SkPath path = cache.Intern(MakeBadge(40));
+  path.lineTo(100, 100);
+
+  SkPath interned = cache.Intern(MakeBadge(40));
+  EXPECT_EQ(interned, MakeBadge(40));
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+}
+
+TEST(PathCacheTest, EvictsTheLeastRecentlyInternedPaths) {
+  PathCache cache(2);
+  cache.Intern(MakeBadge(10));
+  cache.Intern(MakeBadge(20));
+  // Makes the first path the most recently interned.
+  cache.Intern(MakeBadge(10));
+  cache.Intern(MakeBadge(30));
+
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  cache.Intern(MakeBadge(10));
+  EXPECT_EQ(cache.GetStats().hits, 2u);
+  cache.Intern(MakeBadge(20));
+  EXPECT_EQ(cache.GetStats().misses, 4u);
+}
+
+TEST(PathCacheTest, SkipsVolatileAndEmptyPaths) {
+  PathCache cache(10);
+  SkPath path = MakeBadge(40);
+  path.setIsVolatile(true);
+  cache.Intern(path);
+  cache.Intern(SkPath());
+
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+  EXPECT_EQ(cache.GetStats().misses, 0u);
+}
+
+TEST(PathCacheTest, ZeroEntriesInternsNothing) {
+  PathCache cache(0);
+  SkPath first = cache.Intern(MakeBadge(40));
+  SkPath second = cache.Intern(MakeBadge(40));
+
+  EXPECT_NE(first.getGenerationID(), second.getGenerationID());
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
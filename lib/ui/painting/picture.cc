@@ -18,13 +18,20 @@
 namespace flutter {
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Picture);
+IMPLEMENT_POOLED_ALLOCATION(Picture);
 
 #define FOR_EACH_BINDING(V) \
   V(Picture, toImage)       \
   V(Picture, dispose)       \
   V(Picture, GetAllocationSize)
 
-DART_BIND_ALL(Picture, FOR_EACH_BINDING)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+DART_NATIVE_CALLBACK_STATIC(Picture, toImages)
+
+void Picture::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)
+                         DART_REGISTER_NATIVE_STATIC(Picture, toImages)});
+}
 
 fml::RefPtr<Picture> Picture::Create(Dart_Handle dart_handle,
                                      flutter::SkiaGPUObject<SkPicture> picture,
@@ -36,32 +43,102 @@ fml::RefPtr<Picture> Picture::Create(Dart_Handle dart_handle,
   return canvas_picture;
 }
 
+fml::RefPtr<Picture> Picture::Create(
+    Dart_Handle dart_handle,
+    flutter::SkiaGPUObject<DisplayList> display_list,
+    size_t external_allocation_size) {
+  auto canvas_picture = fml::MakeRefCounted<Picture>(std::move(display_list),
+                                                     external_allocation_size);
+
+  canvas_picture->AssociateWithDartWrapper(dart_handle);
+  return canvas_picture;
+}
+
+static fml::MemoryCounter* GetPicturesMemoryCounter() {
+  static fml::MemoryCounter* counter = fml::MemoryCounter::Get("Pictures");
+  return counter;
+}
+
 Picture::Picture(flutter::SkiaGPUObject<SkPicture> picture,
                  size_t external_allocation_size)
     : picture_(std::move(picture)),
-      external_allocation_size_(external_allocation_size) {}
+      external_allocation_size_(external_allocation_size),
+      memory_charge_(GetPicturesMemoryCounter(),
+                     GetAllocationSize() - sizeof(Picture)) {}
+
+Picture::Picture(flutter::SkiaGPUObject<DisplayList> display_list,
+                 size_t external_allocation_size)
+    : display_list_(std::move(display_list)),
+      external_allocation_size_(external_allocation_size),
+      memory_charge_(GetPicturesMemoryCounter(),
+                     GetAllocationSize() - sizeof(Picture)) {}
 
 Picture::~Picture() = default;
 
+sk_sp<SkPicture> Picture::GetSkPicture() const {
+  if (auto display_list = display_list_.get()) {
+    // Snapshots are made of SkPictures.
+    return display_list->ToSkPicture();
+  }
+  return picture_.get();
+}
+
 Dart_Handle Picture::toImage(uint32_t width,
                              uint32_t height,
+                             bool gpu_resident,
                              Dart_Handle raw_image_callback) {
-  if (!picture_.get()) {
+  sk_sp<SkPicture> picture = GetSkPicture();
+  if (!picture) {
     return tonic::ToDart("Picture is null");
   }
 
-  return RasterizeToImage(picture_.get(), width, height, raw_image_callback);
+  return RasterizeToImages({std::move(picture)}, width, height, gpu_resident,
+                           false, raw_image_callback);
+}
+
+Dart_Handle Picture::toImages(Dart_Handle pictures,
+                              uint32_t width,
+                              uint32_t height,
+                              bool gpu_resident,
+                              Dart_Handle raw_image_callback) {
+  intptr_t length = 0;
+  if (!Dart_IsList(pictures) ||
+      Dart_IsError(Dart_ListLength(pictures, &length))) {
+    return tonic::ToDart("Pictures were invalid");
+  }
+
+  std::vector<sk_sp<SkPicture>> sk_pictures;
+  sk_pictures.reserve(length);
+  for (intptr_t i = 0; i < length; i++) {
+    Picture* picture =
+        tonic::DartConverter<Picture*>::FromDart(Dart_ListGetAt(pictures, i));
+    sk_sp<SkPicture> sk_picture = picture ? picture->GetSkPicture() : nullptr;
+    if (!sk_picture) {
+      return tonic::ToDart("Picture is null");
+    }
+    sk_pictures.push_back(std::move(sk_picture));
+  }
+
+  return RasterizeToImages(std::move(sk_pictures), width, height, gpu_resident,
+                           true, raw_image_callback);
 }
 
 void Picture::dispose() {
   ClearDartWrapper();
-  picture_.reset();
+  // Pictures may hold large images, don't wait for the next drain of the
+  // queue.
+  picture_.reset_promptly();
+  display_list_.reset_promptly();
+  memory_charge_.Update(0);
 }
 
 size_t Picture::GetAllocationSize() const {
   if (auto picture = picture_.get()) {
     return picture->approximateBytesUsed() + sizeof(Picture) +
            external_allocation_size_;
+  } else if (auto display_list = display_list_.get()) {
+    return display_list->bytes_used() + sizeof(Picture) +
+           external_allocation_size_;
   } else {
     return sizeof(Picture);
   }
@@ -71,6 +148,16 @@ Dart_Handle Picture::RasterizeToImage(sk_sp<SkPicture> picture,
                                       uint32_t width,
                                       uint32_t height,
                                       Dart_Handle raw_image_callback) {
+  return RasterizeToImages({std::move(picture)}, width, height, false, false,
+                           raw_image_callback);
+}
+
+Dart_Handle Picture::RasterizeToImages(std::vector<sk_sp<SkPicture>> pictures,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       bool gpu_resident,
+                                       bool as_list,
+                                       Dart_Handle raw_image_callback) {
   if (Dart_IsNull(raw_image_callback) || !Dart_IsClosure(raw_image_callback)) {
     return tonic::ToDart("Image callback was invalid");
   }
@@ -94,43 +181,73 @@ Dart_Handle Picture::RasterizeToImage(sk_sp<SkPicture> picture,
 
   auto picture_bounds = SkISize::Make(width, height);
 
-  auto ui_task = fml::MakeCopyable([image_callback, unref_queue](
-                                       sk_sp<SkImage> raster_image) mutable {
-    auto dart_state = image_callback->dart_state().lock();
-    if (!dart_state) {
-      // The root isolate could have died in the meantime.
-      return;
-    }
-    tonic::DartState::Scope scope(dart_state);
-
-    if (!raster_image) {
-      tonic::DartInvoke(image_callback->Get(), {Dart_Null()});
-      return;
-    }
-
-    auto dart_image = CanvasImage::Create();
-    dart_image->set_image({std::move(raster_image), std::move(unref_queue)});
-    auto* raw_dart_image = tonic::ToDart(std::move(dart_image));
-
-    // All done!
-    tonic::DartInvoke(image_callback->Get(), {raw_dart_image});
-
-    // image_callback is associated with the Dart isolate and must be deleted
-    // on the UI thread
-    delete image_callback;
-  });
+  auto ui_task = fml::MakeCopyable(
+      [image_callback, unref_queue, as_list](
+          std::vector<sk_sp<SkImage>> raster_images,
+          fml::RefPtr<SkiaUnrefQueue> snapshot_unref_queue) mutable {
+        auto dart_state = image_callback->dart_state().lock();
+        if (!dart_state) {
+          // The root isolate could have died in the meantime.
+          return;
+        }
+        tonic::DartState::Scope scope(dart_state);
+
+        std::vector<Dart_Handle> dart_images;
+        for (auto& raster_image : raster_images) {
+          if (!raster_image) {
+            tonic::DartInvoke(image_callback->Get(), {Dart_Null()});
+            delete image_callback;
+            return;
+          }
+          // GPU-resident images must be released on the thread of their
+          // context.
+          auto& queue = raster_image->isTextureBacked() ? snapshot_unref_queue
+                                                        : unref_queue;
+          auto dart_image = CanvasImage::Create();
+          dart_image->set_image({std::move(raster_image), queue});
+          dart_images.push_back(tonic::ToDart(std::move(dart_image)));
+        }
+
+        Dart_Handle result = Dart_Null();
+        if (as_list) {
+          result = Dart_NewList(dart_images.size());
+          for (size_t i = 0; i < dart_images.size(); i++) {
+            Dart_ListSetAt(result, i, dart_images[i]);
+          }
+        } else if (!dart_images.empty()) {
+          result = dart_images.front();
+        }
+
+        // All done!
+        tonic::DartInvoke(image_callback->Get(), {result});
+
+        // image_callback is associated with the Dart isolate and must be
+        // deleted on the UI thread
+        delete image_callback;
+      });
 
-  // Kick things off on the raster rask runner.
+  // Kick things off on the raster rask runner. All the pictures are drawn in
+  // the one task, which makes the render context current once.
   fml::TaskRunner::RunNowOrPostTask(
       raster_task_runner,
-      [ui_task_runner, snapshot_delegate, picture, picture_bounds, ui_task] {
-        sk_sp<SkImage> raster_image =
-            snapshot_delegate->MakeRasterSnapshot(picture, picture_bounds);
+      fml::MakeCopyable([ui_task_runner, snapshot_delegate,
+                         pictures = std::move(pictures), picture_bounds,
+                         gpu_resident, ui_task]() mutable {
+        std::vector<sk_sp<SkImage>> raster_images =
+            snapshot_delegate->MakeRasterSnapshots(pictures, picture_bounds,
+                                                   gpu_resident);
+        fml::RefPtr<SkiaUnrefQueue> snapshot_unref_queue =
+            snapshot_delegate->GetSnapshotUnrefQueue();
 
         fml::TaskRunner::RunNowOrPostTask(
             ui_task_runner,
-            [ui_task, raster_image]() { ui_task(raster_image); });
-      });
+            fml::MakeCopyable(
+                [ui_task, raster_images = std::move(raster_images),
+                 snapshot_unref_queue]() mutable {
+                  ui_task(std::move(raster_images),
+                          std::move(snapshot_unref_queue));
+                }));
+      }));
 
   return Dart_Null();
 }
@@ -5,7 +5,11 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 #define FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 
+#include <vector>
+
+#include "flutter/flow/display_list.h"
 #include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -20,6 +24,7 @@ class Canvas;
 
 class Picture : public RefCountedDartWrappable<Picture> {
   DEFINE_WRAPPERTYPEINFO();
+  DEFINE_POOLED_ALLOCATION();
   FML_FRIEND_MAKE_REF_COUNTED(Picture);
 
  public:
@@ -27,13 +32,32 @@ class Picture : public RefCountedDartWrappable<Picture> {
   static fml::RefPtr<Picture> Create(Dart_Handle dart_handle,
                                      flutter::SkiaGPUObject<SkPicture> picture,
                                      size_t external_allocation_size);
+  static fml::RefPtr<Picture> Create(
+      Dart_Handle dart_handle,
+      flutter::SkiaGPUObject<DisplayList> display_list,
+      size_t external_allocation_size);
 
+  // Only one of the picture and the display list is set.
   sk_sp<SkPicture> picture() const { return picture_.get(); }
+  sk_sp<DisplayList> display_list() const { return display_list_.get(); }
+
+  // The picture, or the display list recorded into an SkPicture.
+  sk_sp<SkPicture> GetSkPicture() const;
 
   Dart_Handle toImage(uint32_t width,
                       uint32_t height,
+                      bool gpu_resident,
                       Dart_Handle raw_image_callback);
 
+  // Rasterizes each of the |pictures| list into an image of |width| by
+  // |height|, in a single task on the raster thread, and calls
+  // |raw_image_callback| with the list of images.
+  static Dart_Handle toImages(Dart_Handle pictures,
+                              uint32_t width,
+                              uint32_t height,
+                              bool gpu_resident,
+                              Dart_Handle raw_image_callback);
+
   void dispose();
 
   size_t GetAllocationSize() const override;
@@ -45,14 +69,31 @@ class Picture : public RefCountedDartWrappable<Picture> {
                                       uint32_t height,
                                       Dart_Handle raw_image_callback);
 
+  // Rasterizes |pictures| on the raster thread and calls |raw_image_callback|
+  // with the list of images if |as_list|, or with the only image otherwise.
+  // With |gpu_resident|, the images are not read back from the GPU, and can
+  // only be drawn and encoded by the engine.
+  static Dart_Handle RasterizeToImages(std::vector<sk_sp<SkPicture>> pictures,
+                                       uint32_t width,
+                                       uint32_t height,
+                                       bool gpu_resident,
+                                       bool as_list,
+                                       Dart_Handle raw_image_callback);
+
   size_t external_allocation_size() const { return external_allocation_size_; }
 
  private:
   Picture(flutter::SkiaGPUObject<SkPicture> picture,
           size_t external_allocation_size_);
+  Picture(flutter::SkiaGPUObject<DisplayList> display_list,
+          size_t external_allocation_size_);
 
   flutter::SkiaGPUObject<SkPicture> picture_;
+  flutter::SkiaGPUObject<DisplayList> display_list_;
   size_t external_allocation_size_;
+  // The bytes of the picture or display list, charged to the "Pictures"
+  // counter until the picture is disposed of.
+  fml::MemoryCharge memory_charge_;
 };
 
 }  // namespace flutter
@@ -39,6 +39,10 @@ PictureRecorder::PictureRecorder() {}
 PictureRecorder::~PictureRecorder() {}
 
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
+  if (UIDartState::Current()->IsDisplayListEnabled()) {
+    display_list_recorder_ = std::make_unique<DisplayListRecorder>(bounds);
+    return display_list_recorder_.get();
+  }
   return picture_recorder_.beginRecording(bounds, &rtree_factory_);
 }
 
@@ -46,11 +50,18 @@ fml::RefPtr<Picture> PictureRecorder::endRecording(Dart_Handle dart_picture) {
   if (!canvas_)
     return nullptr;
 
-  fml::RefPtr<Picture> picture =
-      Picture::Create(dart_picture,
-                      UIDartState::CreateGPUObject(
-                          picture_recorder_.finishRecordingAsPicture()),
-                      canvas_->external_allocation_size());
+  fml::RefPtr<Picture> picture;
+  if (display_list_recorder_) {
+    picture = Picture::Create(
+        dart_picture,
+        UIDartState::CreateGPUObject(display_list_recorder_->Finish()),
+        canvas_->external_allocation_size());
+  } else {
+    picture = Picture::Create(dart_picture,
+                              UIDartState::CreateGPUObject(
+                                  picture_recorder_.finishRecordingAsPicture()),
+                              canvas_->external_allocation_size());
+  }
 
   canvas_->Invalidate();
   canvas_ = nullptr;
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PICTURE_RECORDER_H_
 #define FLUTTER_LIB_UI_PAINTING_PICTURE_RECORDER_H_
 
+#include <memory>
+
+#include "flutter/flow/display_list.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 
@@ -37,6 +40,9 @@ class PictureRecorder : public RefCountedDartWrappable<PictureRecorder> {
 
   SkRTreeFactory rtree_factory_;
   SkPictureRecorder picture_recorder_;
+  // Set instead of recording into |picture_recorder_| when display lists are
+  // enabled.
+  std::unique_ptr<DisplayListRecorder> display_list_recorder_;
   fml::RefPtr<Canvas> canvas_;
 };
 
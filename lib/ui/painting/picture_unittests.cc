@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/picture.h"
+#include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+TEST_F(ShellTest, PictureToImagesRasterizesEachPicture) {
+  fml::AutoResetWaitableEvent message_latch;
+
+  auto nativeValidateImages = [&](Dart_NativeArguments args) {
+    auto count =
+        tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 0));
+    auto gpu_count =
+        tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 1));
+    auto sizes_match =
+        tonic::DartConverter<bool>::FromDart(Dart_GetNativeArgument(args, 2));
+    EXPECT_EQ(count, 3);
+    // Without a GPU context, GPU-resident images are raster images.
+    EXPECT_EQ(gpu_count, 3);
+    EXPECT_TRUE(sizes_match);
+    message_latch.Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  settings.snapshot_surface_pool_size = 2;
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateImages",
+                    CREATE_NATIVE_ENTRY(nativeValidateImages));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("toImagesOfPictures");
+
+  shell->RunEngine(std::move(configuration), [&](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch.Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
+}  // namespace testing
+}  // namespace flutter
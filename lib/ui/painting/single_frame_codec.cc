@@ -57,9 +57,15 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   fml::RefPtr<SingleFrameCodec>* raw_codec_ref =
       new fml::RefPtr<SingleFrameCodec>(this);
 
-  decoder->Decode(descriptor_, [raw_codec_ref](auto image) {
+  decode_token_ = decoder->Decode(descriptor_, [raw_codec_ref](auto image) {
     std::unique_ptr<fml::RefPtr<SingleFrameCodec>> codec_ref(raw_codec_ref);
     fml::RefPtr<SingleFrameCodec> codec(std::move(*codec_ref));
+    codec->decode_token_.reset();
+
+    if (codec->pending_callbacks_.empty()) {
+      // The codec was disposed of while the image was decoded.
+      return;
+    }
 
     auto state = codec->pending_callbacks_.front().dart_state().lock();
 
@@ -95,12 +101,22 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   // The encoded data is no longer needed now that it has been handed off
   // to the decoder.
   descriptor_.data.reset();
+  descriptor_.compressed_texture.reset();
 
   status_ = Status::kInProgress;
 
   return Dart_Null();
 }
 
+void SingleFrameCodec::dispose() {
+  if (decode_token_) {
+    decode_token_->Cancel();
+    decode_token_.reset();
+  }
+  pending_callbacks_.clear();
+  Codec::dispose();
+}
+
 size_t SingleFrameCodec::GetAllocationSize() const {
   const auto& data = descriptor_.data;
   const auto data_byte_size = data ? data->size() : 0;
@@ -27,6 +27,9 @@ class SingleFrameCodec : public Codec {
   // |Codec|
   Dart_Handle getNextFrame(Dart_Handle args) override;
 
+  // |Codec|
+  void dispose() override;
+
   // |DartWrappable|
   size_t GetAllocationSize() const override;
 
@@ -36,6 +39,9 @@ class SingleFrameCodec : public Codec {
   ImageDecoder::ImageDescriptor descriptor_;
   fml::RefPtr<FrameInfo> cached_frame_;
   std::vector<DartPersistentValue> pending_callbacks_;
+  // Cancels the decode in progress if the codec is disposed before it
+  // completes.
+  std::shared_ptr<ImageDecodeToken> decode_token_;
 
   FML_FRIEND_MAKE_REF_COUNTED(SingleFrameCodec);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(SingleFrameCodec);
@@ -6,7 +6,9 @@
 #include "flutter/lib/ui/ui_dart_state.h"
 
 #include <algorithm>
+#include <cstring>
 
+#include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
 
@@ -14,22 +16,60 @@ namespace flutter {
 
 namespace {
 
+// The typed data is copied into the builder as it is laid out, which is the
+// only copy SkVertices, which owns its storage, allows.
+static_assert(sizeof(SkPoint) == 2 * sizeof(float),
+              "Points must be laid out as pairs of floats");
+static_assert(sizeof(SkColor) == sizeof(int32_t),
+              "Colors must be laid out as 32-bit integers");
+
 void DecodePoints(const tonic::Float32List& coords, SkPoint* points) {
-  for (int i = 0; i < coords.num_elements(); i += 2)
-    points[i / 2] = SkPoint::Make(coords[i], coords[i + 1]);
+  memcpy(points, coords.data(), (coords.num_elements() / 2) * sizeof(SkPoint));
+}
+
+void DecodeColors(const tonic::Int32List& colors, SkColor* out) {
+  memcpy(out, colors.data(), colors.num_elements() * sizeof(SkColor));
+}
+
+sk_sp<SkData> MakeBuffer(size_t size) {
+  sk_sp<SkData> buffer = SkData::MakeUninitialized(size);
+  memset(buffer->writable_data(), 0, size);
+  return buffer;
+}
+
+void FinalizeBuffer(void* isolate_callback_data,
+                    Dart_WeakPersistentHandle handle,
+                    void* peer) {
+  reinterpret_cast<SkData*>(peer)->unref();
 }
 
-template <typename T>
-void DecodeInts(const tonic::Int32List& ints, T* out) {
-  for (int i = 0; i < ints.num_elements(); i++)
-    out[i] = ints[i];
+// Returns typed data that writes into |buffer| and keeps a reference to it.
+Dart_Handle ShareBuffer(const sk_sp<SkData>& buffer,
+                        Dart_TypedData_Type type,
+                        size_t element_size) {
+  if (!buffer) {
+    return Dart_Null();
+  }
+  // SkData are generally read-only, but these buffers are only written by Dart
+  // and only read by |Vertices::update()|, both on the UI thread.
+  void* bytes = const_cast<void*>(buffer->data());
+  buffer->ref();
+  return Dart_NewExternalTypedDataWithFinalizer(
+      type, bytes, buffer->size() / element_size, buffer.get(), buffer->size(),
+      FinalizeBuffer);
 }
 
 }  // namespace
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Vertices);
 
-#define FOR_EACH_BINDING(V) V(Vertices, init)
+#define FOR_EACH_BINDING(V)               \
+  V(Vertices, init)                       \
+  V(Vertices, initBuffers)                \
+  V(Vertices, getPositionBuffer)          \
+  V(Vertices, getTextureCoordinateBuffer) \
+  V(Vertices, getColorBuffer)             \
+  V(Vertices, update)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -73,7 +113,7 @@ bool Vertices::init(Dart_Handle vertices_handle,
   if (colors.data()) {
     // SkVertices::Builder assumes equal numbers of elements
     FML_DCHECK(positions.num_elements() / 2 == colors.num_elements());
-    DecodeInts<SkColor>(colors, builder.colors());
+    DecodeColors(colors, builder.colors());
   }
 
   if (indices.data()) {
@@ -88,8 +128,93 @@ bool Vertices::init(Dart_Handle vertices_handle,
   return true;
 }
 
+bool Vertices::initBuffers(Dart_Handle vertices_handle,
+                           SkVertices::VertexMode vertex_mode,
+                           int vertex_count,
+                           bool has_texture_coordinates,
+                           bool has_colors,
+                           const tonic::Uint16List& indices) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  if (vertex_count <= 0) {
+    return false;
+  }
+
+  auto vertices = fml::MakeRefCounted<Vertices>();
+  vertices->vertex_mode_ = vertex_mode;
+  vertices->vertex_count_ = vertex_count;
+  vertices->position_buffer_ = MakeBuffer(vertex_count * sizeof(SkPoint));
+  if (has_texture_coordinates) {
+    vertices->texture_coordinate_buffer_ =
+        MakeBuffer(vertex_count * sizeof(SkPoint));
+  }
+  if (has_colors) {
+    vertices->color_buffer_ = MakeBuffer(vertex_count * sizeof(SkColor));
+  }
+  if (indices.data()) {
+    vertices->indices_.assign(indices.data(),
+                              indices.data() + indices.num_elements());
+  }
+  if (!vertices->update()) {
+    return false;
+  }
+  vertices->AssociateWithDartWrapper(vertices_handle);
+
+  return true;
+}
+
+Dart_Handle Vertices::getPositionBuffer() {
+  return ShareBuffer(position_buffer_, Dart_TypedData_kFloat32, sizeof(float));
+}
+
+Dart_Handle Vertices::getTextureCoordinateBuffer() {
+  return ShareBuffer(texture_coordinate_buffer_, Dart_TypedData_kFloat32,
+                     sizeof(float));
+}
+
+Dart_Handle Vertices::getColorBuffer() {
+  return ShareBuffer(color_buffer_, Dart_TypedData_kInt32, sizeof(int32_t));
+}
+
+bool Vertices::update() {
+  if (!position_buffer_) {
+    return false;
+  }
+
+  uint32_t builderFlags = 0;
+  if (texture_coordinate_buffer_)
+    builderFlags |= SkVertices::kHasTexCoords_BuilderFlag;
+  if (color_buffer_)
+    builderFlags |= SkVertices::kHasColors_BuilderFlag;
+
+  SkVertices::Builder builder(vertex_mode_, vertex_count_, indices_.size(),
+                              builderFlags);
+  if (!builder.isValid())
+    return false;
+
+  // SkVertices can't share the buffers, since the pictures that draw them
+  // must not see later writes, so they are copied once here.
+  memcpy(builder.positions(), position_buffer_->data(),
+         position_buffer_->size());
+  if (texture_coordinate_buffer_) {
+    memcpy(builder.texCoords(), texture_coordinate_buffer_->data(),
+           texture_coordinate_buffer_->size());
+  }
+  if (color_buffer_) {
+    memcpy(builder.colors(), color_buffer_->data(), color_buffer_->size());
+  }
+  std::copy(indices_.begin(), indices_.end(), builder.indices());
+
+  vertices_ = builder.detach();
+  return true;
+}
+
 size_t Vertices::GetAllocationSize() const {
-  return sizeof(Vertices) + vertices_->approximateSize();
+  size_t size = sizeof(Vertices) + vertices_->approximateSize();
+  for (const auto& buffer :
+       {position_buffer_, texture_coordinate_buffer_, color_buffer_}) {
+    size += buffer ? buffer->size() : 0;
+  }
+  return size + indices_.size() * sizeof(uint16_t);
 }
 
 }  // namespace flutter
@@ -5,7 +5,10 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_VERTICES_H_
 #define FLUTTER_LIB_UI_PAINTING_VERTICES_H_
 
+#include <vector>
+
 #include "flutter/lib/ui/dart_wrapper.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkVertices.h"
 #include "third_party/tonic/typed_data/typed_list.h"
 
@@ -31,6 +34,26 @@ class Vertices : public RefCountedDartWrappable<Vertices> {
                    const tonic::Int32List& colors,
                    const tonic::Uint16List& indices);
 
+  // Creates vertices whose attributes are kept in buffers owned by the engine,
+  // which Dart writes into in place through the typed data returned by the
+  // getters below, and which |update()| draws from.
+  static bool initBuffers(Dart_Handle vertices_handle,
+                          SkVertices::VertexMode vertex_mode,
+                          int vertex_count,
+                          bool has_texture_coordinates,
+                          bool has_colors,
+                          const tonic::Uint16List& indices);
+
+  // Return typed data that shares the buffers, or null if the vertices have
+  // no such buffer.
+  Dart_Handle getPositionBuffer();
+  Dart_Handle getTextureCoordinateBuffer();
+  Dart_Handle getColorBuffer();
+
+  // Makes the current contents of the buffers the vertices that are drawn.
+  // The pictures that drew the vertices before keep what they drew.
+  bool update();
+
   const sk_sp<SkVertices>& vertices() const { return vertices_; }
 
   size_t GetAllocationSize() const override;
@@ -39,6 +62,14 @@ class Vertices : public RefCountedDartWrappable<Vertices> {
   Vertices();
 
   sk_sp<SkVertices> vertices_;
+
+  // Only set by |initBuffers()|.
+  SkVertices::VertexMode vertex_mode_ = SkVertices::kTriangles_VertexMode;
+  int vertex_count_ = 0;
+  sk_sp<SkData> position_buffer_;
+  sk_sp<SkData> texture_coordinate_buffer_;
+  sk_sp<SkData> color_buffer_;
+  std::vector<uint16_t> indices_;
 };
 
 }  // namespace flutter
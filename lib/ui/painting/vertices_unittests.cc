@@ -57,5 +57,51 @@ TEST_F(ShellTest, VerticesAccuratelyReportsSize) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, VerticesDrawTheirBuffersAfterAnUpdate) {
+  fml::AutoResetWaitableEvent message_latch;
+
+  auto nativeValidateBufferVertices = [&](Dart_NativeArguments args) {
+    auto handle = Dart_GetNativeArgument(args, 0);
+    intptr_t peer = 0;
+    Dart_Handle result = Dart_GetNativeInstanceField(
+        handle, tonic::DartWrappable::kPeerIndex, &peer);
+    ASSERT_FALSE(Dart_IsError(result));
+    ASSERT_TRUE(
+        tonic::DartConverter<bool>::FromDart(Dart_GetNativeArgument(args, 1)));
+    Vertices* vertices = reinterpret_cast<Vertices*>(peer);
+    ASSERT_TRUE(vertices->vertices());
+    EXPECT_EQ(vertices->vertices()->bounds(), SkRect::MakeLTRB(0, 0, 100, 80));
+    // The buffers are counted along with the vertices.
+    EXPECT_GT(vertices->GetAllocationSize(),
+              vertices->vertices()->approximateSize() + 3 * sizeof(SkPoint));
+    message_latch.Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateBufferVertices",
+                    CREATE_NATIVE_ENTRY(nativeValidateBufferVertices));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("createBufferVertices");
+
+  shell->RunEngine(std::move(configuration), [&](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch.Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 }  // namespace testing
 }  // namespace flutter
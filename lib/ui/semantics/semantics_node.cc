@@ -6,6 +6,8 @@
 
 #include <string.h>
 
+#include <cmath>
+
 namespace flutter {
 
 constexpr int32_t kMinPlatformViewId = -1;
@@ -14,8 +16,14 @@ SemanticsNode::SemanticsNode() = default;
 
 SemanticsNode::SemanticsNode(const SemanticsNode& other) = default;
 
+SemanticsNode::SemanticsNode(SemanticsNode&& other) = default;
+
 SemanticsNode::~SemanticsNode() = default;
 
+SemanticsNode& SemanticsNode::operator=(const SemanticsNode& other) = default;
+
+SemanticsNode& SemanticsNode::operator=(SemanticsNode&& other) = default;
+
 bool SemanticsNode::HasAction(SemanticsAction action) const {
   return (actions & static_cast<int32_t>(action)) != 0;
 }
@@ -28,4 +36,52 @@ bool SemanticsNode::IsPlatformViewNode() const {
   return platformViewId > kMinPlatformViewId;
 }
 
+// Whether two doubles are equal, treating NaN, which marks an unset scroll
+// position or extent, as equal to itself.
+static bool DoublesAreEqual(double a, double b) {
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+int32_t SemanticsNode::GetChangedFields(const SemanticsNode& previous) const {
+  int32_t changed = 0;
+  if (flags != previous.flags) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kFlags);
+  }
+  if (actions != previous.actions ||
+      customAccessibilityActions != previous.customAccessibilityActions) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kActions);
+  }
+  if (maxValueLength != previous.maxValueLength ||
+      currentValueLength != previous.currentValueLength ||
+      textSelectionBase != previous.textSelectionBase ||
+      textSelectionExtent != previous.textSelectionExtent) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kTextEditing);
+  }
+  if (platformViewId != previous.platformViewId) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kPlatformViewId);
+  }
+  if (scrollChildren != previous.scrollChildren ||
+      scrollIndex != previous.scrollIndex ||
+      !DoublesAreEqual(scrollPosition, previous.scrollPosition) ||
+      !DoublesAreEqual(scrollExtentMax, previous.scrollExtentMax) ||
+      !DoublesAreEqual(scrollExtentMin, previous.scrollExtentMin)) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kScroll);
+  }
+  if (label != previous.label || hint != previous.hint ||
+      value != previous.value || increasedValue != previous.increasedValue ||
+      decreasedValue != previous.decreasedValue ||
+      textDirection != previous.textDirection) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kStrings);
+  }
+  if (rect != previous.rect || transform != previous.transform ||
+      elevation != previous.elevation || thickness != previous.thickness) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kGeometry);
+  }
+  if (childrenInTraversalOrder != previous.childrenInTraversalOrder ||
+      childrenInHitTestOrder != previous.childrenInHitTestOrder) {
+    changed |= static_cast<int32_t>(SemanticsNodeFields::kChildren);
+  }
+  return changed;
+}
+
 }  // namespace flutter
@@ -79,16 +79,50 @@ enum class SemanticsFlags : int32_t {
 const int kScrollableSemanticsFlags =
     static_cast<int32_t>(SemanticsFlags::kHasImplicitScrolling);
 
+// Groups of SemanticsNode fields, as reported by
+// SemanticsNode::GetChangedFields.
+enum class SemanticsNodeFields : int32_t {
+  kFlags = 1 << 0,
+  // actions and customAccessibilityActions.
+  kActions = 1 << 1,
+  // maxValueLength, currentValueLength, textSelectionBase and
+  // textSelectionExtent.
+  kTextEditing = 1 << 2,
+  kPlatformViewId = 1 << 3,
+  // scrollChildren, scrollIndex, scrollPosition, scrollExtentMax and
+  // scrollExtentMin.
+  kScroll = 1 << 4,
+  // label, hint, value, increasedValue, decreasedValue and textDirection.
+  kStrings = 1 << 5,
+  // rect, transform, elevation and thickness.
+  kGeometry = 1 << 6,
+  // childrenInTraversalOrder and childrenInHitTestOrder.
+  kChildren = 1 << 7,
+};
+
+const int32_t kAllSemanticsNodeFields = (1 << 8) - 1;
+
 struct SemanticsNode {
   SemanticsNode();
 
   SemanticsNode(const SemanticsNode& other);
 
+  SemanticsNode(SemanticsNode&& other);
+
   ~SemanticsNode();
 
+  SemanticsNode& operator=(const SemanticsNode& other);
+
+  SemanticsNode& operator=(SemanticsNode&& other);
+
   bool HasAction(SemanticsAction action) const;
   bool HasFlag(SemanticsFlags flag) const;
 
+  // The SemanticsNodeFields that differ between this node and |previous|,
+  // so that platforms can skip work for the parts of a node that an update
+  // didn't change.
+  int32_t GetChangedFields(const SemanticsNode& previous) const;
+
   // Whether this node is for embedded platform views.
   bool IsPlatformViewNode() const;
 
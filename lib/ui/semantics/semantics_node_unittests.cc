@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/semantics/semantics_node.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(SemanticsNodeTest, IdenticalNodesHaveNoChangedFields) {
+  SemanticsNode node;
+  node.id = 1;
+  node.label = "label";
+  node.rect = SkRect::MakeLTRB(0, 0, 10, 10);
+  node.childrenInTraversalOrder = {2, 3};
+
+  SemanticsNode copy = node;
+  EXPECT_EQ(copy.GetChangedFields(node), 0);
+  // Unset scroll positions are NaN, which must not count as a change.
+  EXPECT_EQ(SemanticsNode().GetChangedFields(SemanticsNode()), 0);
+}
+
+TEST(SemanticsNodeTest, ReportsEachChangedGroupOfFields) {
+  SemanticsNode previous;
+  previous.label = "label";
+  previous.childrenInTraversalOrder = {2, 3};
+
+  SemanticsNode node = previous;
+  node.label = "new label";
+  EXPECT_EQ(node.GetChangedFields(previous),
+            static_cast<int32_t>(SemanticsNodeFields::kStrings));
+
+  node = previous;
+  node.scrollPosition = 10.0;
+  node.childrenInTraversalOrder = {3, 2};
+  EXPECT_EQ(node.GetChangedFields(previous),
+            static_cast<int32_t>(SemanticsNodeFields::kScroll) |
+                static_cast<int32_t>(SemanticsNodeFields::kChildren));
+
+  node = previous;
+  node.flags = static_cast<int32_t>(SemanticsFlags::kIsButton);
+  node.actions = static_cast<int32_t>(SemanticsAction::kTap);
+  node.rect = SkRect::MakeLTRB(0, 0, 1, 1);
+  EXPECT_EQ(node.GetChangedFields(previous),
+            static_cast<int32_t>(SemanticsNodeFields::kFlags) |
+                static_cast<int32_t>(SemanticsNodeFields::kActions) |
+                static_cast<int32_t>(SemanticsNodeFields::kGeometry));
+}
+
+TEST(SemanticsNodeTest, MovesStringsAndChildren) {
+  SemanticsNode node;
+  node.label = std::string(100, 'a');
+  node.childrenInTraversalOrder = {1, 2, 3};
+  const char* label_data = node.label.data();
+  const int32_t* children_data = node.childrenInTraversalOrder.data();
+
+  SemanticsNode moved = std::move(node);
+  EXPECT_EQ(moved.label.data(), label_data);
+  EXPECT_EQ(moved.childrenInTraversalOrder.data(), children_data);
+}
+
+}  // namespace testing
+}  // namespace flutter
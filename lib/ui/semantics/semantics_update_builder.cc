@@ -74,7 +74,9 @@ void SemanticsUpdateBuilder::updateNode(
             (scrollChildren > 0 && childrenInHitTestOrder.data()))
       << "Semantics update contained scrollChildren but did not have "
          "childrenInHitTestOrder";
-  SemanticsNode node;
+  // Built in place, since nodes hold several strings and vectors.
+  SemanticsNode& node = nodes_[id];
+  node = SemanticsNode();
   node.id = id;
   node.flags = flags;
   node.actions = actions;
@@ -91,28 +93,27 @@ void SemanticsUpdateBuilder::updateNode(
   node.rect = SkRect::MakeLTRB(left, top, right, bottom);
   node.elevation = elevation;
   node.thickness = thickness;
-  node.label = label;
-  node.hint = hint;
-  node.value = value;
-  node.increasedValue = increasedValue;
-  node.decreasedValue = decreasedValue;
+  node.label = std::move(label);
+  node.hint = std::move(hint);
+  node.value = std::move(value);
+  node.increasedValue = std::move(increasedValue);
+  node.decreasedValue = std::move(decreasedValue);
   node.textDirection = textDirection;
   SkScalar scalarTransform[16];
   for (int i = 0; i < 16; ++i) {
     scalarTransform[i] = transform.data()[i];
   }
   node.transform = SkM44::ColMajor(scalarTransform);
-  node.childrenInTraversalOrder =
-      std::vector<int32_t>(childrenInTraversalOrder.data(),
-                           childrenInTraversalOrder.data() +
-                               childrenInTraversalOrder.num_elements());
-  node.childrenInHitTestOrder = std::vector<int32_t>(
+  node.childrenInTraversalOrder.assign(
+      childrenInTraversalOrder.data(),
+      childrenInTraversalOrder.data() +
+          childrenInTraversalOrder.num_elements());
+  node.childrenInHitTestOrder.assign(
       childrenInHitTestOrder.data(),
       childrenInHitTestOrder.data() + childrenInHitTestOrder.num_elements());
-  node.customAccessibilityActions = std::vector<int32_t>(
+  node.customAccessibilityActions.assign(
       localContextActions.data(),
       localContextActions.data() + localContextActions.num_elements());
-  nodes_[id] = node;
 }
 
 void SemanticsUpdateBuilder::updateCustomAction(int id,
@@ -122,8 +123,8 @@ void SemanticsUpdateBuilder::updateCustomAction(int id,
   CustomAccessibilityAction action;
   action.id = id;
   action.overrideId = overrideId;
-  action.label = label;
-  action.hint = hint;
+  action.label = std::move(label);
+  action.hint = std::move(hint);
   actions_[id] = action;
 }
 
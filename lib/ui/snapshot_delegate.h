@@ -5,6 +5,9 @@
 #ifndef FLUTTER_LIB_UI_SNAPSHOT_DELEGATE_H_
 #define FLUTTER_LIB_UI_SNAPSHOT_DELEGATE_H_
 
+#include <vector>
+
+#include "flutter/flow/skia_gpu_object.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
@@ -15,6 +18,19 @@ class SnapshotDelegate {
   virtual sk_sp<SkImage> MakeRasterSnapshot(sk_sp<SkPicture> picture,
                                             SkISize picture_size) = 0;
 
+  // Draws each of |pictures| into an image of |picture_size| in one go. With
+  // |gpu_resident|, images drawn with a GPU context are left on the GPU
+  // instead of being read back, and must be released through
+  // |GetSnapshotUnrefQueue()|. The images that can't be drawn are null.
+  virtual std::vector<sk_sp<SkImage>> MakeRasterSnapshots(
+      const std::vector<sk_sp<SkPicture>>& pictures,
+      SkISize picture_size,
+      bool gpu_resident) = 0;
+
+  // The queue that GPU-resident snapshots are released on, which drains on
+  // the thread they were drawn on.
+  virtual fml::RefPtr<SkiaUnrefQueue> GetSnapshotUnrefQueue() const = 0;
+
   virtual sk_sp<SkImage> ConvertToRasterImage(sk_sp<SkImage> image) = 0;
 };
 
@@ -1926,6 +1926,23 @@ class Paragraph extends NativeFieldWrapperClass2 {
   void layout(ParagraphConstraints constraints) => _layout(constraints.width);
   void _layout(double width) native 'Paragraph_layout';
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// of `constraints`, like calling [layout] on each of them.
+  ///
+  /// The paragraphs are laid out at the same time on the engine's worker
+  /// threads, which is faster than laying them out one after another when there
+  /// are many of them, such as the messages of a chat. This returns once all of
+  /// them are laid out.
+  static void layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs.length == constraints.length);
+    final Float64List widths = Float64List(constraints.length);
+    for (int i = 0; i < constraints.length; i++) {
+      widths[i] = constraints[i].width;
+    }
+    _layoutAll(paragraphs, widths);
+  }
+  static void _layoutAll(List<Paragraph> paragraphs, Float64List widths) native 'Paragraph_layoutAll';
+
   List<TextBox> _decodeTextBoxes(Float32List encoded) {
     final int count = encoded.length ~/ 5;
     final List<TextBox> boxes = <TextBox>[];
@@ -101,8 +101,10 @@ SkTypeface* AssetManagerFontStyleSet::createTypeface(int i) {
 
   TypefaceAsset& asset = assets_[index];
   if (!asset.typeface) {
+    // Fonts are mapped rather than read, so that only the parts of their
+    // tables that are used get paged in.
     std::unique_ptr<fml::Mapping> asset_mapping =
-        asset_manager_->GetAsMapping(asset.asset);
+        asset_manager_->GetAsDemandPagedMapping(asset.asset);
     if (asset_mapping == nullptr) {
       return nullptr;
     }
@@ -10,6 +10,7 @@
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/test_font_data.h"
+#include "minikin/Layout.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
 #include "third_party/skia/include/core/SkFontMgr.h"
@@ -70,6 +71,15 @@ void FontCollection::SetupDefaultFontManager() {
   collection_->SetupDefaultFontManager();
 }
 
+void FontCollection::PurgeCaches() {
+  collection_->ClearFontFamilyCache();
+  minikin::Layout::purgeCaches();
+}
+
+void FontCollection::SetLayoutCacheMaxBytes(size_t max_bytes) {
+  minikin::Layout::setCacheMaxBytes(max_bytes);
+}
+
 void FontCollection::RegisterFonts(
     std::shared_ptr<AssetManager> asset_manager) {
   std::unique_ptr<fml::Mapping> manifest_mapping =
@@ -98,6 +108,8 @@ void FontCollection::RegisterFonts(
 
   auto font_provider =
       std::make_unique<AssetManagerFontProvider>(asset_manager);
+  auto remainder_font_provider =
+      std::make_unique<AssetManagerFontProvider>(asset_manager);
 
   for (const auto& family : document.GetArray()) {
     auto family_name = family.FindMember("family");
@@ -124,11 +136,27 @@ void FontCollection::RegisterFonts(
       // TODO: Handle weights and styles.
       font_provider->RegisterAsset(family_name->value.GetString(),
                                    font_asset->value.GetString());
+
+      // Fonts subset at build time name the font holding the characters that
+      // were left out, which is only loaded once text needs one of them.
+      auto font_remainder = family_font.FindMember("remainder");
+      if (font_remainder != family_font.MemberEnd() &&
+          font_remainder->value.IsString()) {
+        remainder_font_provider->RegisterAsset(
+            family_name->value.GetString(), font_remainder->value.GetString());
+      }
     }
   }
 
   collection_->SetAssetFontManager(
       sk_make_sp<txt::AssetFontManager>(std::move(font_provider)));
+  if (remainder_font_provider->GetFamilyCount() > 0) {
+    collection_->SetRemainderFontManager(
+        sk_make_sp<txt::RemainderFontManager>(
+            std::move(remainder_font_provider)));
+  } else {
+    collection_->SetRemainderFontManager(nullptr);
+  }
 }
 
 void FontCollection::RegisterTestFonts() {
@@ -31,6 +31,14 @@ class FontCollection {
 
   void SetupDefaultFontManager();
 
+  // Drops the font fallback and text layout caches. They are rebuilt as text
+  // is laid out again.
+  void PurgeCaches();
+
+  // Sets the bytes that the text layout cache may hold. The cache is shared
+  // by all font collections in the process.
+  static void SetLayoutCacheMaxBytes(size_t max_bytes);
+
   void RegisterFonts(std::shared_ptr<AssetManager> asset_manager);
 
   void RegisterTestFonts();
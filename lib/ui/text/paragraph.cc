@@ -4,10 +4,20 @@
 
 #include "flutter/lib/ui/text/paragraph.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
@@ -37,9 +47,15 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
   V(Paragraph, getPositionForOffset)    \
   V(Paragraph, computeLineMetrics)
 
-DART_BIND_ALL(Paragraph, FOR_EACH_BINDING)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+DART_NATIVE_CALLBACK_STATIC(Paragraph, layoutAll)
+
+void Paragraph::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)
+                         DART_REGISTER_NATIVE_STATIC(Paragraph, layoutAll)});
+}
 
-Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
+Paragraph::Paragraph(std::shared_ptr<txt::Paragraph> paragraph)
     : m_paragraph(std::move(paragraph)) {}
 
 Paragraph::~Paragraph() = default;
@@ -52,46 +68,128 @@ size_t Paragraph::GetAllocationSize() const {
 }
 
 double Paragraph::width() {
-  return m_paragraph->GetMaxWidth();
+  return GetLaidOutParagraph().GetMaxWidth();
 }
 
 double Paragraph::height() {
-  return m_paragraph->GetHeight();
+  return GetLaidOutParagraph().GetHeight();
 }
 
 double Paragraph::longestLine() {
-  return m_paragraph->GetLongestLine();
+  return GetLaidOutParagraph().GetLongestLine();
 }
 
 double Paragraph::minIntrinsicWidth() {
-  return m_paragraph->GetMinIntrinsicWidth();
+  return GetLaidOutParagraph().GetMinIntrinsicWidth();
 }
 
 double Paragraph::maxIntrinsicWidth() {
-  return m_paragraph->GetMaxIntrinsicWidth();
+  return GetLaidOutParagraph().GetMaxIntrinsicWidth();
 }
 
 double Paragraph::alphabeticBaseline() {
-  return m_paragraph->GetAlphabeticBaseline();
+  return GetLaidOutParagraph().GetAlphabeticBaseline();
 }
 
 double Paragraph::ideographicBaseline() {
-  return m_paragraph->GetIdeographicBaseline();
+  return GetLaidOutParagraph().GetIdeographicBaseline();
 }
 
 bool Paragraph::didExceedMaxLines() {
-  return m_paragraph->DidExceedMaxLines();
+  return GetLaidOutParagraph().DidExceedMaxLines();
+}
+
+txt::Paragraph& Paragraph::GetLaidOutParagraph() {
+  if (m_width) {
+    // Does nothing if the paragraph is still laid out at the width.
+    m_paragraph->Layout(*m_width);
+  }
+  return *m_paragraph;
 }
 
 void Paragraph::layout(double width) {
+  m_width = width;
   m_paragraph->Layout(width);
 }
 
+void Paragraph::layoutAll(Dart_Handle paragraphs,
+                          const tonic::Float64List& widths) {
+  TRACE_EVENT0("flutter", "Paragraph::layoutAll");
+  intptr_t length = 0;
+  if (!Dart_IsList(paragraphs) ||
+      Dart_IsError(Dart_ListLength(paragraphs, &length)) ||
+      static_cast<size_t>(length) != widths.num_elements()) {
+    Dart_ThrowException(
+        ToDart("Paragraph.layoutAll called with invalid paragraphs."));
+    return;
+  }
+
+  // Workers that start after the last paragraph was claimed still look at
+  // |next|, so the state outlives this call until they are done with it.
+  struct Batch {
+    explicit Batch(size_t count) : latch(count) {}
+
+    std::vector<std::pair<txt::Paragraph*, double>> paragraphs;
+    std::atomic<size_t> next = {0};
+    fml::CountDownLatch latch;
+  };
+  // The list keeps the paragraphs alive until this call returns. Paragraphs
+  // that share their laid out paragraph, see ParagraphCache, only lay it out
+  // once, since it can't be laid out on two threads at the same time. The
+  // others lay it out at their own width when they are next used.
+  std::vector<std::pair<txt::Paragraph*, double>> unique_paragraphs;
+  std::unordered_set<txt::Paragraph*> claimed;
+  for (intptr_t i = 0; i < length; i++) {
+    Paragraph* paragraph = tonic::DartConverter<Paragraph*>::FromDart(
+        Dart_ListGetAt(paragraphs, i));
+    if (!paragraph) {
+      Dart_ThrowException(ToDart("Paragraph.layoutAll called with null."));
+      return;
+    }
+    paragraph->m_width = widths[i];
+    if (claimed.insert(paragraph->m_paragraph.get()).second) {
+      unique_paragraphs.push_back({paragraph->m_paragraph.get(), widths[i]});
+    }
+  }
+  length = unique_paragraphs.size();
+  auto batch = std::make_shared<Batch>(length);
+  batch->paragraphs = std::move(unique_paragraphs);
+
+  // Paragraphs are claimed one at a time, so that a long paragraph doesn't
+  // hold up the short ones queued behind it on the same worker.
+  auto layout_claimed = [](Batch& batch) {
+    for (size_t i = batch.next.fetch_add(1); i < batch.paragraphs.size();
+         i = batch.next.fetch_add(1)) {
+      batch.paragraphs[i].first->Layout(batch.paragraphs[i].second);
+      batch.latch.CountDown();
+    }
+  };
+
+  // Only the minikin shaper lays out different paragraphs on different threads
+  // at the same time.
+  std::shared_ptr<fml::ConcurrentTaskRunner> runner;
+  auto image_decoder = UIDartState::Current()->GetImageDecoder();
+  if (image_decoder && !UIDartState::Current()->IsSkParagraphEnabled()) {
+    runner = image_decoder->GetConcurrentTaskRunner();
+  }
+  if (runner && length > 1) {
+    const size_t worker_tasks =
+        std::min<size_t>(length - 1, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < worker_tasks; i++) {
+      runner->PostTask([batch, layout_claimed]() { layout_claimed(*batch); });
+    }
+  }
+
+  layout_claimed(*batch);
+  // Waits for the paragraphs claimed by the workers.
+  batch->latch.Wait();
+}
+
 void Paragraph::paint(Canvas* canvas, double x, double y) {
   SkCanvas* sk_canvas = canvas->canvas();
   if (!sk_canvas)
     return;
-  m_paragraph->Paint(sk_canvas, x, y);
+  GetLaidOutParagraph().Paint(sk_canvas, x, y);
 }
 
 static tonic::Float32List EncodeTextBoxes(
@@ -118,29 +216,32 @@ tonic::Float32List Paragraph::getRectsForRange(unsigned start,
                                                unsigned end,
                                                unsigned boxHeightStyle,
                                                unsigned boxWidthStyle) {
-  std::vector<txt::Paragraph::TextBox> boxes = m_paragraph->GetRectsForRange(
-      start, end, static_cast<txt::Paragraph::RectHeightStyle>(boxHeightStyle),
-      static_cast<txt::Paragraph::RectWidthStyle>(boxWidthStyle));
+  std::vector<txt::Paragraph::TextBox> boxes =
+      GetLaidOutParagraph().GetRectsForRange(
+          start, end,
+          static_cast<txt::Paragraph::RectHeightStyle>(boxHeightStyle),
+          static_cast<txt::Paragraph::RectWidthStyle>(boxWidthStyle));
   return EncodeTextBoxes(boxes);
 }
 
 tonic::Float32List Paragraph::getRectsForPlaceholders() {
   std::vector<txt::Paragraph::TextBox> boxes =
-      m_paragraph->GetRectsForPlaceholders();
+      GetLaidOutParagraph().GetRectsForPlaceholders();
   return EncodeTextBoxes(boxes);
 }
 
 Dart_Handle Paragraph::getPositionForOffset(double dx, double dy) {
   Dart_Handle result = Dart_NewListOf(Dart_CoreType_Int, 2);
   txt::Paragraph::PositionWithAffinity pos =
-      m_paragraph->GetGlyphPositionAtCoordinate(dx, dy);
+      GetLaidOutParagraph().GetGlyphPositionAtCoordinate(dx, dy);
   Dart_ListSetAt(result, 0, ToDart(pos.position));
   Dart_ListSetAt(result, 1, ToDart(static_cast<int>(pos.affinity)));
   return result;
 }
 
 Dart_Handle Paragraph::getWordBoundary(unsigned offset) {
-  txt::Paragraph::Range<size_t> point = m_paragraph->GetWordBoundary(offset);
+  txt::Paragraph::Range<size_t> point =
+      GetLaidOutParagraph().GetWordBoundary(offset);
   Dart_Handle result = Dart_NewListOf(Dart_CoreType_Int, 2);
   Dart_ListSetAt(result, 0, ToDart(point.start));
   Dart_ListSetAt(result, 1, ToDart(point.end));
@@ -148,7 +249,8 @@ Dart_Handle Paragraph::getWordBoundary(unsigned offset) {
 }
 
 Dart_Handle Paragraph::getLineBoundary(unsigned offset) {
-  std::vector<txt::LineMetrics> metrics = m_paragraph->GetLineMetrics();
+  std::vector<txt::LineMetrics> metrics =
+      GetLaidOutParagraph().GetLineMetrics();
   int line_start = -1;
   int line_end = -1;
   for (txt::LineMetrics& line : metrics) {
@@ -165,7 +267,8 @@ Dart_Handle Paragraph::getLineBoundary(unsigned offset) {
 }
 
 tonic::Float64List Paragraph::computeLineMetrics() {
-  std::vector<txt::LineMetrics> metrics = m_paragraph->GetLineMetrics();
+  std::vector<txt::LineMetrics> metrics =
+      GetLaidOutParagraph().GetLineMetrics();
 
   // Layout:
   // boxes.size() groups of 9 which are the line metrics
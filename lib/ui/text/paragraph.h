@@ -5,12 +5,15 @@
 #ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 #define FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 
+#include <optional>
+
 #include "flutter/fml/message_loop.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/canvas.h"
 #include "flutter/lib/ui/text/line_metrics.h"
 #include "flutter/lib/ui/text/text_box.h"
 #include "flutter/third_party/txt/src/txt/paragraph.h"
+#include "third_party/tonic/typed_data/typed_list.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -23,8 +26,10 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   FML_FRIEND_MAKE_REF_COUNTED(Paragraph);
 
  public:
+  // |txt_paragraph| may be shared with other paragraphs that were built with
+  // the same contents, see ParagraphCache.
   static void Create(Dart_Handle paragraph_handle,
-                     std::unique_ptr<txt::Paragraph> txt_paragraph) {
+                     std::shared_ptr<txt::Paragraph> txt_paragraph) {
     auto paragraph = fml::MakeRefCounted<Paragraph>(std::move(txt_paragraph));
     paragraph->AssociateWithDartWrapper(paragraph_handle);
   }
@@ -41,6 +46,12 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   bool didExceedMaxLines();
 
   void layout(double width);
+
+  // Lays out each of |paragraphs| with the width at the same index of
+  // |widths|, spreading them over the concurrent workers and returning once
+  // all are laid out.
+  static void layoutAll(Dart_Handle paragraphs,
+                        const tonic::Float64List& widths);
   void paint(Canvas* canvas, double x, double y);
 
   tonic::Float32List getRectsForRange(unsigned start,
@@ -58,9 +69,16 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
-  std::unique_ptr<txt::Paragraph> m_paragraph;
+  std::shared_ptr<txt::Paragraph> m_paragraph;
+  // The width this paragraph was last laid out at, which the paragraphs that
+  // share |m_paragraph| may have laid it out at another width since.
+  std::optional<double> m_width;
+
+  explicit Paragraph(std::shared_ptr<txt::Paragraph> paragraph);
 
-  explicit Paragraph(std::unique_ptr<txt::Paragraph> paragraph);
+  // Lays |m_paragraph| out again at |m_width| if another paragraph sharing it
+  // laid it out at another width.
+  txt::Paragraph& GetLaidOutParagraph();
 };
 
 }  // namespace flutter
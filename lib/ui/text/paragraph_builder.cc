@@ -4,11 +4,15 @@
 
 #include "flutter/lib/ui/text/paragraph_builder.h"
 
+#include <limits>
+#include <string>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/text/paragraph_cache.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/third_party/txt/src/txt/font_style.h"
@@ -28,6 +32,51 @@
 namespace flutter {
 namespace {
 
+// Roughly what the glyph positions, text blobs and measurements of a laid out
+// paragraph take per code unit of its text, on top of its content key.
+const size_t kCachedBytesPerCodeUnit = 128;
+
+void AppendBytes(std::string* key, const void* data, size_t size) {
+  key->append(static_cast<const char*>(data), size);
+}
+
+template <typename T>
+void AppendValue(std::string* key, T value) {
+  AppendBytes(key, &value, sizeof(T));
+}
+
+void AppendString(std::string* key, const std::string& string) {
+  AppendValue(key, string.size());
+  key->append(string);
+}
+
+void AppendString(std::string* key, const std::u16string& string) {
+  AppendValue(key, string.size());
+  AppendBytes(key, string.data(), string.size() * sizeof(char16_t));
+}
+
+void AppendStrings(std::string* key, const std::vector<std::string>& strings) {
+  AppendValue(key, strings.size());
+  for (const std::string& string : strings) {
+    AppendString(key, string);
+  }
+}
+
+void AppendInt32List(std::string* key, const tonic::Int32List& list) {
+  AppendValue(key, list.num_elements());
+  AppendBytes(key, list.data(), list.num_elements() * sizeof(int32_t));
+}
+
+void AppendByteData(std::string* key, Dart_Handle data) {
+  if (Dart_IsNull(data)) {
+    AppendValue(key, std::numeric_limits<size_t>::max());
+    return;
+  }
+  tonic::DartByteData byte_data(data);
+  AppendValue(key, byte_data.length_in_bytes());
+  AppendBytes(key, byte_data.data(), byte_data.length_in_bytes());
+}
+
 // TextStyle
 
 const int tsColorIndex = 1;
@@ -234,7 +283,20 @@ ParagraphBuilder::ParagraphBuilder(
     double fontSize,
     double height,
     const std::u16string& ellipsis,
-    const std::string& locale) {
+    const std::string& locale)
+    : m_isCacheable(UIDartState::Current()->GetParagraphCache() != nullptr) {
+  if (m_isCacheable) {
+    m_contentKey.push_back('C');
+    AppendInt32List(&m_contentKey, encoded);
+    AppendByteData(&m_contentKey, strutData);
+    AppendString(&m_contentKey, fontFamily);
+    AppendStrings(&m_contentKey, strutFontFamilies);
+    AppendValue(&m_contentKey, fontSize);
+    AppendValue(&m_contentKey, height);
+    AppendString(&m_contentKey, ellipsis);
+    AppendString(&m_contentKey, locale);
+  }
+
   int32_t mask = encoded[0];
   txt::ParagraphStyle style;
 
@@ -292,13 +354,15 @@ ParagraphBuilder::ParagraphBuilder(
       UIDartState::Current()->window()->client()->GetFontCollection();
 
 #if FLUTTER_ENABLE_SKSHAPER
-#define FLUTTER_PARAGRAPH_BUILDER txt::ParagraphBuilder::CreateSkiaBuilder
-#else
-#define FLUTTER_PARAGRAPH_BUILDER txt::ParagraphBuilder::CreateTxtBuilder
-#endif
+  if (UIDartState::Current()->IsSkParagraphEnabled()) {
+    m_paragraphBuilder = txt::ParagraphBuilder::CreateSkiaBuilder(
+        style, font_collection.GetFontCollection());
+    return;
+  }
+#endif  // FLUTTER_ENABLE_SKSHAPER
 
-  m_paragraphBuilder =
-      FLUTTER_PARAGRAPH_BUILDER(style, font_collection.GetFontCollection());
+  m_paragraphBuilder = txt::ParagraphBuilder::CreateTxtBuilder(
+      style, font_collection.GetFontCollection());
 }
 
 ParagraphBuilder::~ParagraphBuilder() = default;
@@ -361,6 +425,28 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
                                  Dart_Handle font_features_data) {
   FML_DCHECK(encoded.num_elements() == 8);
 
+  // Shaders and filters are compared by identity, so paragraphs painted with
+  // them aren't cached.
+  if (!Dart_IsNull(background_objects) || !Dart_IsNull(foreground_objects)) {
+    m_isCacheable = false;
+    m_contentKey.clear();
+  }
+  if (m_isCacheable) {
+    m_contentKey.push_back('S');
+    AppendInt32List(&m_contentKey, encoded);
+    AppendStrings(&m_contentKey, fontFamilies);
+    AppendValue(&m_contentKey, fontSize);
+    AppendValue(&m_contentKey, letterSpacing);
+    AppendValue(&m_contentKey, wordSpacing);
+    AppendValue(&m_contentKey, height);
+    AppendValue(&m_contentKey, decorationThickness);
+    AppendString(&m_contentKey, locale);
+    AppendByteData(&m_contentKey, background_data);
+    AppendByteData(&m_contentKey, foreground_data);
+    AppendByteData(&m_contentKey, shadows_data);
+    AppendByteData(&m_contentKey, font_features_data);
+  }
+
   int32_t mask = encoded[0];
 
   // Set to use the properties of the previous style if the property is not
@@ -459,6 +545,9 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
 }
 
 void ParagraphBuilder::pop() {
+  if (m_isCacheable) {
+    m_contentKey.push_back('P');
+  }
   m_paragraphBuilder->Pop();
 }
 
@@ -475,6 +564,11 @@ Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
   if (error_code != U_BUFFER_OVERFLOW_ERROR)
     return tonic::ToDart("string is not well-formed UTF-16");
 
+  if (m_isCacheable) {
+    m_contentKey.push_back('T');
+    AppendString(&m_contentKey, text);
+  }
+  m_textLength += text.size();
   m_paragraphBuilder->AddText(text);
 
   return Dart_Null();
@@ -489,13 +583,44 @@ Dart_Handle ParagraphBuilder::addPlaceholder(double width,
       width, height, static_cast<txt::PlaceholderAlignment>(alignment),
       static_cast<txt::TextBaseline>(baseline), baseline_offset);
 
+  if (m_isCacheable) {
+    m_contentKey.push_back('H');
+    AppendValue(&m_contentKey, width);
+    AppendValue(&m_contentKey, height);
+    AppendValue(&m_contentKey, alignment);
+    AppendValue(&m_contentKey, baseline_offset);
+    AppendValue(&m_contentKey, baseline);
+  }
+  m_textLength++;
   m_paragraphBuilder->AddPlaceholder(placeholder_run);
 
   return Dart_Null();
 }
 
 void ParagraphBuilder::build(Dart_Handle paragraph_handle) {
-  Paragraph::Create(paragraph_handle, m_paragraphBuilder->Build());
+  ParagraphCache* cache = UIDartState::Current()->GetParagraphCache();
+  if (!cache || !m_isCacheable) {
+    Paragraph::Create(paragraph_handle, m_paragraphBuilder->Build());
+    return;
+  }
+
+  // The same contents lay out differently once the fonts change.
+  std::shared_ptr<txt::FontCollection> font_collection =
+      UIDartState::Current()
+          ->window()
+          ->client()
+          ->GetFontCollection()
+          .GetFontCollection();
+  AppendValue(&m_contentKey, font_collection.get());
+  AppendValue(&m_contentKey, font_collection->GetFontsGeneration());
+
+  std::shared_ptr<txt::Paragraph> paragraph = cache->Get(m_contentKey);
+  if (!paragraph) {
+    paragraph = m_paragraphBuilder->Build();
+    cache->Put(m_contentKey, paragraph,
+               m_contentKey.size() + m_textLength * kCachedBytesPerCodeUnit);
+  }
+  Paragraph::Create(paragraph_handle, std::move(paragraph));
 }
 
 }  // namespace flutter
@@ -84,6 +84,12 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
                             const std::string& locale);
 
   std::unique_ptr<txt::ParagraphBuilder> m_paragraphBuilder;
+  // Everything passed to the builder, which keys the built paragraph in the
+  // isolate's ParagraphCache. Only kept while the paragraph can be cached,
+  // which it can't when its paints have shaders or filters.
+  bool m_isCacheable;
+  std::string m_contentKey;
+  size_t m_textLength = 0;
 };
 
 }  // namespace flutter
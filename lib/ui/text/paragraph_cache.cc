@@ -0,0 +1,74 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_cache.h"
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ParagraphCache::ParagraphCache(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      memory_charge_(fml::MemoryCounter::Get("ParagraphCache")) {}
+
+ParagraphCache::~ParagraphCache() = default;
+
+std::shared_ptr<txt::Paragraph> ParagraphCache::Get(const std::string& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    stats_.misses++;
+    return nullptr;
+  }
+  stats_.hits++;
+  // Moves the entry to the front.
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->paragraph;
+}
+
+void ParagraphCache::Put(const std::string& key,
+                         std::shared_ptr<txt::Paragraph> paragraph,
+                         size_t bytes) {
+  if (!paragraph || bytes > max_bytes_ || index_.count(key) != 0) {
+    return;
+  }
+  Trim(max_bytes_ - bytes);
+  entries_.push_front({key, std::move(paragraph), bytes});
+  index_.emplace(key, entries_.begin());
+  bytes_ += bytes;
+  memory_charge_.Update(bytes_);
+}
+
+void ParagraphCache::Clear() {
+  index_.clear();
+  entries_.clear();
+  bytes_ = 0;
+  memory_charge_.Update(bytes_);
+}
+
+void ParagraphCache::Trim(size_t max_bytes) {
+  while (bytes_ > max_bytes && !entries_.empty()) {
+    bytes_ -= entries_.back().bytes;
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+  memory_charge_.Update(bytes_);
+}
+
+void ParagraphCache::TraceCounters() const {
+#if !FLUTTER_RELEASE
+  const size_t lookups = stats_.hits + stats_.misses;
+  FML_TRACE_COUNTER("flutter", "ParagraphCache",
+                    reinterpret_cast<int64_t>(this),                       //
+                    "Bytes", bytes_,                                       //
+                    "Count", entries_.size(),                              //
+                    "Hits", stats_.hits,                                   //
+                    "Misses", stats_.misses,                               //
+                    "Evictions", stats_.evictions,                         //
+                    "HitRate", lookups ? stats_.hits * 1.0 / lookups : 0.0  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_CACHE_H_
+#define FLUTTER_LIB_UI_TEXT_PARAGRAPH_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "flutter/third_party/txt/src/txt/paragraph.h"
+
+namespace flutter {
+
+// The paragraphs built by an isolate, keyed by everything that was passed to
+// the ParagraphBuilder that built them.
+//
+// The framework builds a new Paragraph whenever a widget that shows text is
+// rebuilt, even when its text and style don't change, and each new paragraph
+// is shaped, broken into lines and turned into text blobs again. A builder
+// whose contents match a cached paragraph returns the cached paragraph
+// instead, which is already laid out, and laying it out again at the width it
+// was last laid out at does nothing. Its text blobs are the same too, so
+// Skia's caches of their glyphs keep hitting.
+//
+// The cache keeps paragraphs up to an estimate of the bytes they take,
+// evicting the least recently used ones first. It is only used on the UI
+// thread of its isolate.
+class ParagraphCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  // Creates a cache that keeps paragraphs up to |max_bytes|.
+  explicit ParagraphCache(size_t max_bytes);
+
+  ~ParagraphCache();
+
+  // Returns the paragraph put with |key|, or null if there is none.
+  std::shared_ptr<txt::Paragraph> Get(const std::string& key);
+
+  // Caches |paragraph| with |key|, as taking |bytes|. Paragraphs that take
+  // more than the whole cache aren't cached.
+  void Put(const std::string& key,
+           std::shared_ptr<txt::Paragraph> paragraph,
+           size_t bytes);
+
+  void Clear();
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  size_t GetBytes() const { return bytes_; }
+
+  const Stats& GetStats() const { return stats_; }
+
+  // Emits the bytes, the entry count and the hit rate to the timeline.
+  void TraceCounters() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<txt::Paragraph> paragraph;
+    size_t bytes;
+  };
+
+  using LRUList = std::list<Entry>;
+
+  const size_t max_bytes_;
+  size_t bytes_ = 0;
+  // Most recently used first.
+  LRUList entries_;
+  std::unordered_map<std::string, LRUList::iterator> index_;
+  Stats stats_;
+  // |bytes_|, charged to the "ParagraphCache" counter.
+  fml::MemoryCharge memory_charge_;
+
+  void Trim(size_t max_bytes);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParagraphCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_TEXT_PARAGRAPH_CACHE_H_
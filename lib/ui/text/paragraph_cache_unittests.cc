@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_cache.h"
+
+#include "flutter/third_party/txt/src/txt/font_collection.h"
+#include "flutter/third_party/txt/src/txt/paragraph_builder.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static std::shared_ptr<txt::Paragraph> MakeParagraph() {
+  return txt::ParagraphBuilder::CreateTxtBuilder(
+             txt::ParagraphStyle(), std::make_shared<txt::FontCollection>())
+      ->Build();
+}
+
+TEST(ParagraphCacheTest, ReturnsTheParagraphPutWithAKey) {
+  ParagraphCache cache(1000);
+  std::shared_ptr<txt::Paragraph> paragraph = MakeParagraph();
+  EXPECT_EQ(cache.Get("title"), nullptr);
+  cache.Put("title", paragraph, 100);
+
+  EXPECT_EQ(cache.Get("title"), paragraph);
+  EXPECT_EQ(cache.Get("subtitle"), nullptr);
+  EXPECT_EQ(cache.GetBytes(), 100u);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+}
+
+TEST(ParagraphCacheTest, KeepsTheFirstParagraphPutWithAKey) {
+  ParagraphCache cache(1000);
+  std::shared_ptr<txt::Paragraph> first = MakeParagraph();
+  cache.Put("title", first, 100);
+  cache.Put("title", MakeParagraph(), 100);
+
+  EXPECT_EQ(cache.Get("title"), first);
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+  EXPECT_EQ(cache.GetBytes(), 100u);
+}
+
+TEST(ParagraphCacheTest, EvictsTheLeastRecentlyUsedParagraphs) {
+  ParagraphCache cache(300);
+  cache.Put("first", MakeParagraph(), 100);
+  cache.Put("second", MakeParagraph(), 100);
+  cache.Put("third", MakeParagraph(), 100);
+  // Makes the first paragraph the most recently used.
+  EXPECT_NE(cache.Get("first"), nullptr);
+  cache.Put("fourth", MakeParagraph(), 150);
+
+  EXPECT_NE(cache.Get("first"), nullptr);
+  EXPECT_EQ(cache.Get("second"), nullptr);
+  EXPECT_EQ(cache.Get("third"), nullptr);
+  EXPECT_NE(cache.Get("fourth"), nullptr);
+  EXPECT_EQ(cache.GetBytes(), 250u);
+  EXPECT_EQ(cache.GetStats().evictions, 2u);
+}
+
+TEST(ParagraphCacheTest, SkipsParagraphsLargerThanTheCache) {
+  ParagraphCache cache(100);
+  cache.Put("small", MakeParagraph(), 100);
+  cache.Put("large", MakeParagraph(), 101);
+
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+  EXPECT_NE(cache.Get("small"), nullptr);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+  EXPECT_EQ(cache.GetBytes(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
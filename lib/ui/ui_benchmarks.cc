@@ -9,6 +9,8 @@
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/logging/dart_error.h"
 
 #include <future>
 
@@ -69,4 +71,77 @@ static void BM_PlatformMessageResponseDartComplete(benchmark::State& state) {
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
+// Records |state.range(0)| rects, each in its own save and translate, with a
+// native call per command or with the Canvas command buffer.
+static void BM_CanvasRecordRects(benchmark::State& state,
+                                 bool enable_command_buffer) {
+  ThreadHost thread_host("test",
+                         ThreadHost::Type::Platform | ThreadHost::Type::GPU |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  settings.enable_canvas_command_buffer = enable_command_buffer;
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetFixturesPath(), {});
+
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle args[] = {tonic::ToDart(state.range(0))};
+      Dart_Handle result =
+          Dart_Invoke(Dart_RootLibrary(),
+                      Dart_NewStringFromCString("recordRects"), 1, args);
+      return !tonic::LogIfError(result);
+    });
+    FML_CHECK(successful);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_CanvasRecordRects, native_calls, false)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CanvasRecordRects, command_buffer, true)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Adds |state.range(0)| lines to a path, a native call with only primitive
+// arguments each, so mostly measures the argument conversion of tonic.
+static void BM_PathLineTo(benchmark::State& state) {
+  ThreadHost thread_host("test",
+                         ThreadHost::Type::Platform | ThreadHost::Type::GPU |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  Fixture fixture;
+  auto settings = fixture.CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto isolate =
+      testing::RunDartCodeInIsolate(vm_ref, settings, task_runners, "main", {},
+                                    testing::GetFixturesPath(), {});
+
+  while (state.KeepRunning()) {
+    bool successful = isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle args[] = {tonic::ToDart(state.range(0))};
+      Dart_Handle result =
+          Dart_Invoke(Dart_RootLibrary(),
+                      Dart_NewStringFromCString("buildPath"), 1, args);
+      return !tonic::LogIfError(result);
+    });
+    FML_CHECK(successful);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PathLineTo)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -26,7 +26,12 @@ UIDartState::UIDartState(
     std::string logger_prefix,
     UnhandledExceptionCallback unhandled_exception_callback,
     std::shared_ptr<IsolateNameServer> isolate_name_server,
-    bool is_root_isolate)
+    bool is_root_isolate,
+    bool enable_display_list,
+    size_t path_cache_max_entries,
+    size_t paragraph_cache_max_bytes,
+    bool enable_skparagraph,
+    bool retain_unchanged_layers)
     : task_runners_(std::move(task_runners)),
       add_callback_(std::move(add_callback)),
       remove_callback_(std::move(remove_callback)),
@@ -38,6 +43,20 @@ UIDartState::UIDartState(
       advisory_script_entrypoint_(std::move(advisory_script_entrypoint)),
       logger_prefix_(std::move(logger_prefix)),
       is_root_isolate_(is_root_isolate),
+      enable_display_list_(enable_display_list),
+      path_cache_(path_cache_max_entries > 0
+                      ? std::make_unique<PathCache>(path_cache_max_entries)
+                      : nullptr),
+      paragraph_cache_(
+          paragraph_cache_max_bytes > 0
+              ? std::make_unique<ParagraphCache>(paragraph_cache_max_bytes)
+              : nullptr),
+#if FLUTTER_ENABLE_SKSHAPER
+      enable_skparagraph_(enable_skparagraph),
+#else
+      enable_skparagraph_(false),
+#endif  // FLUTTER_ENABLE_SKSHAPER
+      retain_unchanged_layers_(retain_unchanged_layers),
       unhandled_exception_callback_(unhandled_exception_callback),
       isolate_name_server_(std::move(isolate_name_server)) {
   AddOrRemoveTaskObserver(true /* add */);
@@ -18,7 +18,9 @@
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/isolate_name_server/isolate_name_server.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/path_cache.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
+#include "flutter/lib/ui/text/paragraph_cache.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/tonic/dart_microtask_queue.h"
@@ -36,6 +38,10 @@ class UIDartState : public tonic::DartState {
   Dart_Port main_port() const { return main_port_; }
   // Root isolate of the VM application
   bool IsRootIsolate() const { return is_root_isolate_; }
+  // Whether pictures are recorded into display lists instead of SkPictures.
+  bool IsDisplayListEnabled() const { return enable_display_list_; }
+  // Whether SceneBuilder retains unchanged layers passed as oldLayer.
+  bool IsLayerRetentionEnabled() const { return retain_unchanged_layers_; }
   static void ThrowIfUIOperationsProhibited();
 
   void SetDebugName(const std::string name);
@@ -62,6 +68,18 @@ class UIDartState : public tonic::DartState {
 
   fml::WeakPtr<ImageDecoder> GetImageDecoder() const;
 
+  // The cache that the paths drawn by the isolate are interned into, or null
+  // if path caching is disabled.
+  PathCache* GetPathCache() const { return path_cache_.get(); }
+
+  // The cache of the paragraphs built by the isolate, or null if paragraph
+  // caching is disabled.
+  ParagraphCache* GetParagraphCache() const { return paragraph_cache_.get(); }
+
+  // Whether the isolate's paragraphs are laid out by SkParagraph instead of
+  // libtxt. Always false in builds without SkParagraph.
+  bool IsSkParagraphEnabled() const { return enable_skparagraph_; }
+
   std::shared_ptr<IsolateNameServer> GetIsolateNameServer() const;
 
   tonic::DartErrorHandleType GetLastError();
@@ -93,7 +111,12 @@ class UIDartState : public tonic::DartState {
               std::string logger_prefix,
               UnhandledExceptionCallback unhandled_exception_callback,
               std::shared_ptr<IsolateNameServer> isolate_name_server,
-              bool is_root_isolate_);
+              bool is_root_isolate_,
+              bool enable_display_list,
+              size_t path_cache_max_entries,
+              size_t paragraph_cache_max_bytes,
+              bool enable_skparagraph,
+              bool retain_unchanged_layers);
 
   ~UIDartState() override;
 
@@ -118,6 +141,11 @@ class UIDartState : public tonic::DartState {
   const std::string logger_prefix_;
   Dart_Port main_port_ = ILLEGAL_PORT;
   const bool is_root_isolate_;
+  const bool enable_display_list_;
+  std::unique_ptr<PathCache> path_cache_;
+  std::unique_ptr<ParagraphCache> paragraph_cache_;
+  const bool enable_skparagraph_;
+  const bool retain_unchanged_layers_;
   std::string debug_name_;
   std::unique_ptr<Window> window_;
   tonic::DartMicrotaskQueue microtask_queue_;
@@ -11,17 +11,30 @@ namespace flutter {
 PlatformMessage::PlatformMessage(std::string channel,
                                  std::vector<uint8_t> data,
                                  fml::RefPtr<PlatformMessageResponse> response)
+    : PlatformMessage(std::move(channel),
+                      std::make_unique<fml::DataMapping>(std::move(data)),
+                      std::move(response)) {}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 std::unique_ptr<fml::Mapping> data,
+                                 fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(std::move(data)),
+      data_(data ? std::move(data)
+                 : std::make_unique<fml::DataMapping>(std::vector<uint8_t>{})),
       hasData_(true),
       response_(std::move(response)) {}
 PlatformMessage::PlatformMessage(std::string channel,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(),
+      data_(std::make_unique<fml::DataMapping>(std::vector<uint8_t>{})),
       hasData_(false),
       response_(std::move(response)) {}
 
 PlatformMessage::~PlatformMessage() = default;
 
+std::unique_ptr<fml::Mapping> PlatformMessage::releaseData() {
+  auto data = std::move(data_);
+  data_ = std::make_unique<fml::DataMapping>(std::vector<uint8_t>{});
+  return data;
+}
+
 }  // namespace flutter
@@ -14,6 +14,33 @@
 
 namespace flutter {
 
+namespace {
+
+// Below this size, copying the payload into the Dart heap is cheaper than
+// setting up a finalizer for external typed data.
+constexpr size_t kMessageCopyThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data,
+                     Dart_WeakPersistentHandle handle,
+                     void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+}  // namespace
+
+Dart_Handle MappingToByteData(std::unique_ptr<fml::Mapping> data) {
+  const size_t size = data->GetSize();
+  if (size < kMessageCopyThreshold) {
+    return tonic::DartByteData::Create(data->GetMapping(), size);
+  }
+  // Message handlers only read the payload, so the mapping is handed over even
+  // though its bytes are read-only on this side.
+  void* bytes = const_cast<uint8_t*>(data->GetMapping());
+  return Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, data.release(), size,
+      FinalizeMapping);
+}
+
 PlatformMessageResponseDart::PlatformMessageResponseDart(
     tonic::DartPersistentValue callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner)
@@ -40,8 +67,7 @@ void PlatformMessageResponseDart::Complete(std::unique_ptr<fml::Mapping> data) {
           return;
         tonic::DartState::Scope scope(dart_state);
 
-        Dart_Handle byte_buffer =
-            tonic::DartByteData::Create(data->GetMapping(), data->GetSize());
+        Dart_Handle byte_buffer = MappingToByteData(std::move(data));
         tonic::DartInvoke(callback.Release(), {byte_buffer});
       }));
 }
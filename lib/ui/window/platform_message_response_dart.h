@@ -11,6 +11,11 @@
 
 namespace flutter {
 
+// Creates a ByteData holding the bytes of |data| for the current isolate.
+// Payloads below a small size are copied into the Dart heap. Larger ones are
+// handed to Dart as external typed data that owns |data|, without a copy.
+Dart_Handle MappingToByteData(std::unique_ptr<fml::Mapping> data);
+
 class PlatformMessageResponseDart : public PlatformMessageResponse {
   FML_FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDart);
 
@@ -0,0 +1,49 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/platform_message.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(PlatformMessageTest, CanBeCreatedFromVector) {
+  auto message = fml::MakeRefCounted<PlatformMessage>(
+      "channel", std::vector<uint8_t>{1, 2, 3}, nullptr);
+  ASSERT_TRUE(message->hasData());
+  ASSERT_EQ(message->data().GetSize(), 3u);
+  ASSERT_EQ(message->data().GetMapping()[2], 3u);
+}
+
+TEST(PlatformMessageTest, MessagesWithoutDataHaveEmptyPayloads) {
+  auto message = fml::MakeRefCounted<PlatformMessage>("channel", nullptr);
+  ASSERT_FALSE(message->hasData());
+  ASSERT_EQ(message->data().GetSize(), 0u);
+}
+
+TEST(PlatformMessageTest, PayloadIsHandedOnWithoutCopies) {
+  const uint8_t bytes[] = {4, 5, 6, 7};
+  bool released = false;
+  auto message = fml::MakeRefCounted<PlatformMessage>(
+      "channel",
+      std::make_unique<fml::NonOwnedMapping>(
+          bytes, sizeof(bytes),
+          [&released](const uint8_t* data, size_t size) { released = true; }),
+      nullptr);
+  ASSERT_EQ(message->data().GetMapping(), bytes);
+
+  auto data = message->releaseData();
+  ASSERT_EQ(data->GetMapping(), bytes);
+  ASSERT_EQ(data->GetSize(), sizeof(bytes));
+  ASSERT_EQ(message->data().GetSize(), 0u);
+
+  // The sender gets its memory back once the receiver is done with it, even
+  // if the message outlives the payload.
+  ASSERT_FALSE(released);
+  data.reset();
+  ASSERT_TRUE(released);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -14,7 +14,8 @@ PointerDataPacketConverter::PointerDataPacketConverter() : pointer_(0) {}
 PointerDataPacketConverter::~PointerDataPacketConverter() = default;
 
 std::unique_ptr<PointerDataPacket> PointerDataPacketConverter::Convert(
-    std::unique_ptr<PointerDataPacket> packet) {
+    std::unique_ptr<PointerDataPacket> packet,
+    std::vector<PointerData>* coalesced_pointers) {
   size_t kBytesPerPointerData = kPointerDataFieldCount * kBytesPerField;
   auto buffer = packet->data();
   size_t buffer_length = buffer.size();
@@ -29,6 +30,10 @@ std::unique_ptr<PointerDataPacket> PointerDataPacketConverter::Convert(
     ConvertPointerData(pointer_data, converted_pointers);
   }
 
+  if (coalescing_enabled_) {
+    CoalesceMoves(converted_pointers, coalesced_pointers);
+  }
+
   // Writes converted_pointers into converted_packet.
   auto converted_packet =
       std::make_unique<flutter::PointerDataPacket>(converted_pointers.size());
@@ -272,6 +277,45 @@ bool PointerDataPacketConverter::LocationNeedsUpdate(
          state.physical_y != pointer_data.physical_y;
 }
 
+void PointerDataPacketConverter::CoalesceMoves(
+    std::vector<PointerData>& converted_pointers,
+    std::vector<PointerData>* coalesced_pointers) {
+  std::vector<PointerData> coalesced;
+  // The index in coalesced of the last move or hover of each device, as long
+  // as no other event of that device has come after it.
+  std::map<int64_t, size_t> last_moves;
+  for (const PointerData& pointer_data : converted_pointers) {
+    bool is_move = pointer_data.signal_kind == PointerData::SignalKind::kNone &&
+                   (pointer_data.change == PointerData::Change::kMove ||
+                    pointer_data.change == PointerData::Change::kHover);
+    if (!is_move) {
+      last_moves.erase(pointer_data.device);
+      coalesced.push_back(pointer_data);
+      continue;
+    }
+
+    auto iter = last_moves.find(pointer_data.device);
+    if (iter != last_moves.end()) {
+      PointerData& previous = coalesced[iter->second];
+      if (previous.change == pointer_data.change &&
+          previous.buttons == pointer_data.buttons) {
+        if (coalesced_pointers) {
+          coalesced_pointers->push_back(previous);
+        }
+        PointerData merged = pointer_data;
+        merged.physical_delta_x += previous.physical_delta_x;
+        merged.physical_delta_y += previous.physical_delta_y;
+        merged.synthesized = previous.synthesized && pointer_data.synthesized;
+        previous = merged;
+        continue;
+      }
+    }
+    last_moves[pointer_data.device] = coalesced.size();
+    coalesced.push_back(pointer_data);
+  }
+  converted_pointers = std::move(coalesced);
+}
+
 void PointerDataPacketConverter::UpdatePointerIdentifier(
     PointerData& pointer_data,
     PointerState& state,
@@ -81,14 +81,36 @@ class PointerDataPacketConverter {
   ///             It may contain synthetic pointer data as the result of
   ///             converter's attempt to correct illegal pointer transitions.
   ///
+  /// @param[in]  coalesced_pointers       If coalescing is enabled and this
+  ///                                      is not null, the moves and hovers
+  ///                                      that were coalesced away are
+  ///                                      appended to it, for code that needs
+  ///                                      every sample.
+  ///
   std::unique_ptr<PointerDataPacket> Convert(
-      std::unique_ptr<PointerDataPacket> packet);
+      std::unique_ptr<PointerDataPacket> packet,
+      std::vector<PointerData>* coalesced_pointers = nullptr);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether consecutive moves, or consecutive hovers, of a
+  ///             device within a packet are coalesced into the last of them.
+  ///             The coalesced event carries the sum of their deltas.
+  ///
+  ///             Embedders that batch the events of a frame into one packet
+  ///             can use this to avoid sending high polling rate mice events
+  ///             to the framework one by one. Disabled by default.
+  ///
+  /// @param[in]  enabled  Whether to coalesce moves and hovers.
+  ///
+  void SetCoalescingEnabled(bool enabled) { coalescing_enabled_ = enabled; }
 
  private:
   std::map<int64_t, PointerState> states_;
 
   int64_t pointer_;
 
+  bool coalescing_enabled_ = false;
+
   void ConvertPointerData(PointerData pointer_data,
                           std::vector<PointerData>& converted_pointers);
 
@@ -103,6 +125,9 @@ class PointerDataPacketConverter {
   bool LocationNeedsUpdate(const PointerData pointer_data,
                            const PointerState state);
 
+  void CoalesceMoves(std::vector<PointerData>& converted_pointers,
+                     std::vector<PointerData>* coalesced_pointers);
+
   FML_DISALLOW_COPY_AND_ASSIGN(PointerDataPacketConverter);
 };
 
@@ -570,5 +570,80 @@ TEST(PointerDataPacketConverterTest, CanConvetScroll) {
   ASSERT_EQ(result[6].scroll_delta_y, 0.0);
 }
 
+TEST(PointerDataPacketConverterTest, CanCoalesceHovers) {
+  PointerDataPacketConverter converter;
+  converter.SetCoalescingEnabled(true);
+  auto packet = std::make_unique<PointerDataPacket>(4);
+  PointerData data;
+  CreateSimulatedMousePointerData(data, PointerData::Change::kAdd,
+                                  PointerData::SignalKind::kNone, 0, 0.0, 0.0,
+                                  0.0, 0.0);
+  packet->SetPointerData(0, data);
+  for (int i = 1; i <= 3; i++) {
+    CreateSimulatedMousePointerData(data, PointerData::Change::kHover,
+                                    PointerData::SignalKind::kNone, 0, i, 2 * i,
+                                    0.0, 0.0);
+    packet->SetPointerData(i, data);
+  }
+
+  std::vector<PointerData> coalesced;
+  auto converted_packet = converter.Convert(std::move(packet), &coalesced);
+
+  std::vector<PointerData> result;
+  UnpackPointerPacket(result, std::move(converted_packet));
+
+  ASSERT_EQ(result.size(), (size_t)2);
+  ASSERT_EQ(result[0].change, PointerData::Change::kAdd);
+  ASSERT_EQ(result[1].change, PointerData::Change::kHover);
+  ASSERT_EQ(result[1].physical_x, 3.0);
+  ASSERT_EQ(result[1].physical_y, 6.0);
+  // The coalesced hover moves as far as all three did.
+  ASSERT_EQ(result[1].physical_delta_x, 3.0);
+  ASSERT_EQ(result[1].physical_delta_y, 6.0);
+
+  ASSERT_EQ(coalesced.size(), (size_t)2);
+  ASSERT_EQ(coalesced[0].physical_x, 1.0);
+  ASSERT_EQ(coalesced[1].physical_x, 2.0);
+}
+
+TEST(PointerDataPacketConverterTest, CoalescingKeepsOtherEventsInOrder) {
+  PointerDataPacketConverter converter;
+  converter.SetCoalescingEnabled(true);
+  auto packet = std::make_unique<PointerDataPacket>(7);
+  PointerData data;
+  CreateSimulatedPointerData(data, PointerData::Change::kAdd, 0, 0.0, 0.0);
+  packet->SetPointerData(0, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 0, 0.0, 0.0);
+  packet->SetPointerData(1, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 1.0, 0.0);
+  packet->SetPointerData(2, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 2.0, 0.0);
+  packet->SetPointerData(3, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kUp, 0, 2.0, 0.0);
+  packet->SetPointerData(4, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 0, 2.0, 0.0);
+  packet->SetPointerData(5, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 3.0, 0.0);
+  packet->SetPointerData(6, data);
+
+  auto converted_packet = converter.Convert(std::move(packet));
+
+  std::vector<PointerData> result;
+  UnpackPointerPacket(result, std::move(converted_packet));
+
+  ASSERT_EQ(result.size(), (size_t)6);
+  ASSERT_EQ(result[0].change, PointerData::Change::kAdd);
+  ASSERT_EQ(result[1].change, PointerData::Change::kDown);
+  ASSERT_EQ(result[2].change, PointerData::Change::kMove);
+  ASSERT_EQ(result[2].physical_x, 2.0);
+  ASSERT_EQ(result[2].physical_delta_x, 2.0);
+  ASSERT_EQ(result[3].change, PointerData::Change::kUp);
+  ASSERT_EQ(result[4].change, PointerData::Change::kDown);
+  // A move after the up isn't coalesced with the moves before it.
+  ASSERT_EQ(result[5].change, PointerData::Change::kMove);
+  ASSERT_EQ(result[5].physical_x, 3.0);
+  ASSERT_EQ(result[5].physical_delta_x, 1.0);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -281,7 +281,8 @@ void Window::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   }
   tonic::DartState::Scope scope(dart_state);
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      message->hasData() ? MappingToByteData(message->releaseData())
+                         : Dart_Null();
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -301,6 +302,46 @@ void Window::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
                               tonic::ToDart(response_id)}));
 }
 
+void Window::DispatchPlatformMessages(
+    const std::string& channel,
+    const std::vector<fml::RefPtr<PlatformMessage>>& messages) {
+  std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
+  if (!dart_state) {
+    FML_DLOG(WARNING)
+        << "Dropping platform messages for lack of DartState on channel: "
+        << channel;
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+
+  Dart_Handle data_list = Dart_NewList(messages.size());
+  if (Dart_IsError(data_list)) {
+    FML_DLOG(WARNING)
+        << "Dropping platform messages because of a Dart error on channel: "
+        << channel;
+    return;
+  }
+  std::vector<int> response_ids(messages.size(), 0);
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const auto& message = messages[i];
+    Dart_Handle data_handle =
+        message->hasData() ? MappingToByteData(message->releaseData())
+                           : Dart_Null();
+    if (Dart_IsError(data_handle)) {
+      data_handle = Dart_Null();
+    }
+    Dart_ListSetAt(data_list, i, data_handle);
+    if (auto response = message->response()) {
+      response_ids[i] = next_response_id_++;
+      pending_responses_[response_ids[i]] = response;
+    }
+  }
+
+  tonic::LogIfError(tonic::DartInvokeField(
+      library_.value(), "_dispatchPlatformMessages",
+      {tonic::ToDart(channel), data_list, tonic::ToDart(response_ids)}));
+}
+
 void Window::DispatchPointerDataPacket(const PointerDataPacket& packet) {
   std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
   if (!dart_state)
@@ -349,6 +390,14 @@ void Window::BeginFrame(fml::TimePoint frameTime) {
   UIDartState::Current()->FlushMicrotasksNow();
 
   tonic::LogIfError(tonic::DartInvokeField(library_.value(), "_drawFrame", {}));
+
+  if (PathCache* path_cache = UIDartState::Current()->GetPathCache()) {
+    path_cache->TraceCounters();
+  }
+  if (ParagraphCache* paragraph_cache =
+          UIDartState::Current()->GetParagraphCache()) {
+    paragraph_cache->TraceCounters();
+  }
 }
 
 void Window::ReportTimings(std::vector<int64_t> timings) {
@@ -83,6 +83,10 @@ class Window final {
   void UpdateSemanticsEnabled(bool enabled);
   void UpdateAccessibilityFeatures(int32_t flags);
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
+  // Hands |messages|, all sent on |channel|, to Dart in a single call.
+  void DispatchPlatformMessages(
+      const std::string& channel,
+      const std::vector<fml::RefPtr<PlatformMessage>>& messages);
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
   void DispatchSemanticsAction(int32_t id,
                                SemanticsAction action,
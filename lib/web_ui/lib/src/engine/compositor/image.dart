@@ -53,6 +53,12 @@ class CkAnimatedImage implements ui.Image {
       {ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba}) {
     throw 'unimplemented';
   }
+
+  @override
+  Stream<ByteData> toByteDataStream(
+      {ui.ImageByteFormat format = ui.ImageByteFormat.png}) {
+    throw 'unimplemented';
+  }
 }
 
 /// A [ui.Image] backed by an `SkImage` from Skia.
@@ -78,6 +84,12 @@ class CkImage implements ui.Image {
       {ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba}) {
     throw 'unimplemented';
   }
+
+  @override
+  Stream<ByteData> toByteDataStream(
+      {ui.ImageByteFormat format = ui.ImageByteFormat.png}) {
+    throw 'unimplemented';
+  }
 }
 
 /// A [Codec] that wraps an `SkAnimatedImage`.
@@ -19,7 +19,7 @@ class CkPicture implements ui.Picture {
   }
 
   @override
-  Future<ui.Image> toImage(int width, int height) {
+  Future<ui.Image> toImage(int width, int height, {bool gpuResident = false}) {
     throw UnsupportedError('Picture.toImage not yet implemented for CanvasKit and HTML');
   }
 }
@@ -110,4 +110,18 @@ class CkVertices implements ui.Vertices {
       return false;
     }
   }
+
+  @override
+  Float32List? get positionBuffer => null;
+
+  @override
+  Float32List? get textureCoordinateBuffer => null;
+
+  @override
+  Int32List? get colorBuffer => null;
+
+  @override
+  void update() {
+    throw StateError('Only vertices created with Vertices.buffers can be updated.');
+  }
 }
@@ -142,6 +142,13 @@ class HtmlImage implements ui.Image {
     });
   }
 
+  @override
+  Stream<ByteData> toByteDataStream(
+      {ui.ImageByteFormat format = ui.ImageByteFormat.png}) {
+    return Stream<ByteData>.fromFuture(toByteData(format: format)
+        .then((ByteData? data) => data!));
+  }
+
   // Returns absolutely positioned actual image element on first call and
   // clones on subsequent calls.
   html.ImageElement cloneImageElement() {
@@ -45,7 +45,7 @@ class EnginePicture implements ui.Picture {
   EnginePicture(this.recordingCanvas, this.cullRect);
 
   @override
-  Future<ui.Image> toImage(int width, int height) async {
+  Future<ui.Image> toImage(int width, int height, {bool gpuResident = false}) async {
     final ui.Rect imageRect = ui.Rect.fromLTRB(0, 0, width.toDouble(), height.toDouble());
     final BitmapCanvas canvas = BitmapCanvas(imageRect);
     recordingCanvas!.apply(canvas, imageRect);
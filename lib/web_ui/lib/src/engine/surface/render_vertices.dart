@@ -48,6 +48,20 @@ class SurfaceVertices implements ui.Vertices {
     }
     return list;
   }
+
+  @override
+  Float32List? get positionBuffer => null;
+
+  @override
+  Float32List? get textureCoordinateBuffer => null;
+
+  @override
+  Int32List? get colorBuffer => null;
+
+  @override
+  void update() {
+    throw StateError('Only vertices created with Vertices.buffers can be updated.');
+  }
 }
 
 void initWebGl() {
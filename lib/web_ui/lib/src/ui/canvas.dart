@@ -122,6 +122,33 @@ class Vertices {
         colors: colors,
         indices: indices);
   }
+
+  /// Creates a set of vertex data whose buffers are shared with the engine.
+  ///
+  /// Not supported on the web, where there is no engine to share them with.
+  factory Vertices.buffers(
+    VertexMode mode,
+    int vertexCount, {
+    bool hasTextureCoordinates = false,
+    bool hasColors = false,
+    Uint16List? indices,
+  }) {
+    throw UnsupportedError('Vertices.buffers is not supported on the web.');
+  }
+
+  /// Always null on the web, which doesn't support [Vertices.buffers].
+  Float32List? get positionBuffer => null;
+
+  /// Always null on the web, which doesn't support [Vertices.buffers].
+  Float32List? get textureCoordinateBuffer => null;
+
+  /// Always null on the web, which doesn't support [Vertices.buffers].
+  Int32List? get colorBuffer => null;
+
+  /// Throws on the web, which doesn't support [Vertices.buffers].
+  void update() {
+    throw StateError('Only vertices created with Vertices.buffers can be updated.');
+  }
 }
 
 /// Records a [Picture] containing a sequence of graphical operations.
@@ -603,7 +630,21 @@ abstract class Picture {
   ///
   /// Although the image is returned synchronously, the picture is actually
   /// rasterized the first time the image is drawn and then cached.
-  Future<Image> toImage(int width, int height);
+  ///
+  /// `gpuResident` is ignored on the web.
+  Future<Image> toImage(int width, int height, {bool gpuResident = false});
+
+  /// Creates an image from each of the `pictures`, like [toImage].
+  static Future<List<Image>> toImages(
+    List<Picture> pictures,
+    int width,
+    int height, {
+    bool gpuResident = false,
+  }) {
+    return Future.wait(<Future<Image>>[
+      for (final Picture picture in pictures) picture.toImage(width, height),
+    ]);
+  }
 
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
@@ -1215,6 +1215,16 @@ abstract class Image {
   Future<ByteData?> toByteData(
       {ImageByteFormat format = ImageByteFormat.rawRgba});
 
+  /// Converts the [Image] object into a stream of byte arrays.
+  ///
+  /// The bytes are the same as those [toByteData] returns in the given
+  /// [format], but they are emitted in order as they are encoded.
+  ///
+  /// The stream closes once the image is encoded, or emits an error if
+  /// encoding fails.
+  Stream<ByteData> toByteDataStream(
+      {ImageByteFormat format = ImageByteFormat.png});
+
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
   void dispose();
@@ -1662,6 +1672,49 @@ void decodeImageFromPixels(
       .then((FrameInfo frameInfo) => callback(frameInfo.image));
 }
 
+/// Decodes an image from its encoded bytes while they are still arriving.
+///
+/// On the web, the chunks are buffered and the image is decoded once [close]
+/// is called, so `onProgress` is never called.
+class ImageStreamDecoder {
+  ImageStreamDecoder({
+    int? targetWidth,
+    int? targetHeight,
+    bool allowUpscaling = false,
+    ImageDecoderCallback? onProgress,
+  })  : _targetWidth = targetWidth,
+        _targetHeight = targetHeight,
+        _allowUpscaling = allowUpscaling;
+
+  final int? _targetWidth;
+  final int? _targetHeight;
+  final bool _allowUpscaling;
+  final BytesBuilder _bytes = BytesBuilder();
+  bool _closed = false;
+
+  void addChunk(Uint8List chunk) {
+    if (_closed) {
+      throw Exception('The decoder is already closed.');
+    }
+    _bytes.add(chunk);
+  }
+
+  Future<Image> close() async {
+    if (_closed) {
+      throw Exception('The decoder is already closed.');
+    }
+    _closed = true;
+    final Codec codec = await instantiateImageCodec(
+      _bytes.takeBytes(),
+      targetWidth: _targetWidth,
+      targetHeight: _targetHeight,
+      allowUpscaling: _allowUpscaling,
+    );
+    final FrameInfo frameInfo = await codec.getNextFrame();
+    return frameInfo.image;
+  }
+}
+
 /// A single shadow.
 ///
 /// Multiple shadows are stacked together in a [TextStyle].
@@ -1410,6 +1410,17 @@ abstract class Paragraph {
   /// The [ParagraphConstraints] control how wide the text is allowed to be.
   void layout(ParagraphConstraints constraints);
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// of `constraints`, like calling [layout] on each of them.
+  ///
+  /// On the web, the paragraphs are laid out one after another.
+  static void layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs.length == constraints.length);
+    for (int i = 0; i < paragraphs.length; i++) {
+      paragraphs[i].layout(constraints[i]);
+    }
+  }
+
   /// Returns a list of text boxes that enclose the given text range.
   ///
   /// The [boxHeightStyle] and [boxWidthStyle] parameters allow customization
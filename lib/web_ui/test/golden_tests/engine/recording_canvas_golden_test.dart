@@ -679,6 +679,12 @@ class TestImage implements Image {
     throw UnsupportedError('Cannot encode test image');
   }
 
+  @override
+  Stream<ByteData> toByteDataStream(
+      {ImageByteFormat format = ImageByteFormat.png}) {
+    throw UnsupportedError('Cannot encode test image');
+  }
+
   @override
   String toString() => '[$width\u00D7$height]';
 
@@ -7,6 +7,7 @@
 #include <cstdlib>
 #include <tuple>
 
+#include "flutter/fml/closure.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/posix_wrappers.h"
 #include "flutter/fml/trace_event.h"
@@ -116,6 +117,89 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRootIsolate(
   return (*root_isolate_data)->GetWeakIsolatePtr();
 }
 
+std::weak_ptr<DartIsolate> DartIsolate::SpawnRootIsolate(
+    DartIsolate& spawning_isolate,
+    TaskRunners task_runners,
+    std::unique_ptr<Window> window,
+    fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+    fml::WeakPtr<IOManager> io_manager,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    fml::WeakPtr<ImageDecoder> image_decoder,
+    std::string advisory_script_uri,
+    std::string advisory_script_entrypoint) {
+  TRACE_EVENT0("flutter", "DartIsolate::SpawnRootIsolate");
+  FML_DCHECK(spawning_isolate.IsRootIsolate());
+  FML_DCHECK(Dart_CurrentIsolate() == nullptr);
+
+  DartIsolateGroupData& group_data = spawning_isolate.GetIsolateGroupData();
+
+  if (!DartVM::IsRunningPrecompiledCode()) {
+    return CreateRootIsolate(group_data.GetSettings(),                //
+                             group_data.GetIsolateSnapshot(),         //
+                             std::move(task_runners),                 //
+                             std::move(window),                       //
+                             std::move(snapshot_delegate),            //
+                             std::move(io_manager),                   //
+                             std::move(unref_queue),                  //
+                             std::move(image_decoder),                //
+                             std::move(advisory_script_uri),          //
+                             std::move(advisory_script_entrypoint),   //
+                             nullptr,                                 //
+                             group_data.GetIsolateCreateCallback(),   //
+                             group_data.GetIsolateShutdownCallback()  //
+    );
+  }
+
+  auto isolate_data = std::make_unique<std::shared_ptr<DartIsolate>>(
+      std::shared_ptr<DartIsolate>(new DartIsolate(
+          group_data.GetSettings(),      // settings
+          task_runners,                  // task runners
+          std::move(snapshot_delegate),  // snapshot delegate
+          std::move(io_manager),         // IO manager
+          std::move(unref_queue),        // Skia unref queue
+          std::move(image_decoder),      // Image Decoder
+          advisory_script_uri,           // advisory URI
+          advisory_script_entrypoint,    // advisory entrypoint
+          true                           // is_root_isolate
+          )));
+
+  // The isolate joins the group of the spawning isolate and so shares its
+  // group data. Only the isolate data is handed to the VM.
+  DartErrorString error;
+  const fml::TimePoint creation_start = fml::TimePoint::Now();
+  Dart_Isolate vm_isolate = Dart_CreateIsolateInGroup(
+      spawning_isolate.isolate(),          // group member
+      advisory_script_entrypoint.c_str(),  // name
+      reinterpret_cast<Dart_IsolateShutdownCallback>(
+          DartIsolate::DartIsolateShutdownCallback),  // shutdown callback
+      reinterpret_cast<Dart_IsolateCleanupCallback>(
+          DartIsolate::DartIsolateCleanupCallback),  // cleanup callback
+      isolate_data.get(),                            // isolate data
+      error.error()                                  // error (out)
+  );
+
+  if (vm_isolate == nullptr) {
+    FML_LOG(ERROR) << "Dart_CreateIsolateInGroup failed: " << error.str();
+    return {};
+  }
+
+  // Ownership of the isolate data has been transferred to the Dart VM.
+  std::shared_ptr<DartIsolate> spawned_isolate(*isolate_data);
+  isolate_data.release();
+  spawned_isolate->startup_timing_.Set(IsolateStartupTiming::kIsolateCreation,
+                                       fml::TimePoint::Now() - creation_start);
+
+  if (!InitializeIsolate(spawned_isolate, vm_isolate, error.error())) {
+    FML_LOG(ERROR) << "Could not initialize the spawned isolate: "
+                   << error.str();
+    return {};
+  }
+
+  spawned_isolate->SetWindow(std::move(window));
+
+  return spawned_isolate->GetWeakIsolatePtr();
+}
+
 DartIsolate::DartIsolate(const Settings& settings,
                          TaskRunners task_runners,
                          fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
@@ -137,8 +221,16 @@ DartIsolate::DartIsolate(const Settings& settings,
                   settings.log_tag,
                   settings.unhandled_exception_callback,
                   DartVMRef::GetIsolateNameServer(),
-                  is_root_isolate),
-      disable_http_(settings.disable_http) {
+                  is_root_isolate,
+                  settings.enable_display_list,
+                  settings.path_cache_max_entries,
+                  settings.paragraph_cache_max_bytes,
+                  settings.enable_skparagraph,
+                  settings.retain_unchanged_layers),
+      disable_http_(settings.disable_http),
+      enable_canvas_command_buffer_(settings.enable_canvas_command_buffer),
+      message_batch_max_count_(settings.message_batch_max_count),
+      message_batch_budget_us_(settings.message_batch_budget_us) {
   phase_ = Phase::Uninitialized;
 }
 
@@ -159,6 +251,33 @@ std::string DartIsolate::GetServiceId() {
   return service_id;
 }
 
+const IsolateStartupTiming& DartIsolate::GetStartupTiming() const {
+  return startup_timing_;
+}
+
+void DartIsolate::RecordFrameRequest() {
+  if (startup_timing_.IsComplete() || !main_entry_time_) {
+    return;
+  }
+  startup_timing_.Set(IsolateStartupTiming::kMainToFirstFrameRequest,
+                      fml::TimePoint::Now() - *main_entry_time_);
+  startup_timing_.SetComplete();
+
+  auto micros = [this](IsolateStartupTiming::Phase phase) {
+    return startup_timing_.Get(phase).ToMicroseconds();
+  };
+  FML_TRACE_COUNTER(
+      "flutter", "IsolateStartupTiming", reinterpret_cast<int64_t>(this),
+      "SnapshotMappingMicros", micros(IsolateStartupTiming::kSnapshotMapping),
+      "IsolateCreationMicros", micros(IsolateStartupTiming::kIsolateCreation),
+      "LoadKernelMicros", micros(IsolateStartupTiming::kLoadKernel),
+      "LibrarySetupMicros", micros(IsolateStartupTiming::kLibrarySetup),
+      "RootLibraryLookupMicros",
+      micros(IsolateStartupTiming::kRootLibraryLookup),
+      "MainToFirstFrameRequestMicros",
+      micros(IsolateStartupTiming::kMainToFirstFrameRequest));
+}
+
 bool DartIsolate::Initialize(Dart_Isolate dart_isolate) {
   TRACE_EVENT0("flutter", "DartIsolate::Initialize");
   if (phase_ != Phase::Uninitialized) {
@@ -211,6 +330,8 @@ void DartIsolate::SetMessageHandlingTaskRunner(
 
   message_handling_task_runner_ = runner;
 
+  message_handler().SetBatchLimits(message_batch_max_count_,
+                                   message_batch_budget_us_);
   message_handler().Initialize(
       [runner](std::function<void()> task) { runner->PostTask(task); });
 }
@@ -260,11 +381,13 @@ bool DartIsolate::LoadLibraries() {
     return false;
   }
 
+  const fml::TimePoint start = fml::TimePoint::Now();
+
   tonic::DartState::Scope scope(this);
 
   DartIO::InitForIsolate(disable_http_);
 
-  DartUI::InitForIsolate();
+  DartUI::InitForIsolate(enable_canvas_command_buffer_);
 
   const bool is_service_isolate = Dart_IsServiceIsolate(isolate());
 
@@ -276,6 +399,8 @@ bool DartIsolate::LoadLibraries() {
         "ui", std::make_unique<tonic::DartClassProvider>(this, "dart:ui"));
   }
 
+  startup_timing_.Set(IsolateStartupTiming::kLibrarySetup,
+                      fml::TimePoint::Now() - start);
   phase_ = Phase::LibrariesSetup;
   return true;
 }
@@ -288,7 +413,11 @@ bool DartIsolate::PrepareForRunningFromPrecompiledCode() {
 
   tonic::DartState::Scope scope(this);
 
-  if (Dart_IsNull(Dart_RootLibrary())) {
+  const fml::TimePoint lookup_start = fml::TimePoint::Now();
+  const bool has_root_library = !Dart_IsNull(Dart_RootLibrary());
+  startup_timing_.Add(IsolateStartupTiming::kRootLibraryLookup,
+                      fml::TimePoint::Now() - lookup_start);
+  if (!has_root_library) {
     return false;
   }
 
@@ -321,6 +450,12 @@ bool DartIsolate::LoadKernel(std::shared_ptr<const fml::Mapping> mapping,
   // Mapping must be retained until isolate shutdown.
   kernel_buffers_.push_back(mapping);
 
+  const fml::TimePoint start = fml::TimePoint::Now();
+  fml::ScopedCleanupClosure record_duration([this, start]() {
+    startup_timing_.Add(IsolateStartupTiming::kLoadKernel,
+                        fml::TimePoint::Now() - start);
+  });
+
   Dart_Handle library =
       Dart_LoadLibraryFromKernel(mapping->GetMapping(), mapping->GetSize());
   if (tonic::LogIfError(library)) {
@@ -496,11 +631,15 @@ bool DartIsolate::MarkIsolateRunnable() {
 
   tonic::DartState::Scope scope(this);
 
+  const fml::TimePoint lookup_start = fml::TimePoint::Now();
   auto user_entrypoint_function =
       Dart_GetField(Dart_RootLibrary(), tonic::ToDart(entrypoint_name.c_str()));
+  startup_timing_.Add(IsolateStartupTiming::kRootLibraryLookup,
+                      fml::TimePoint::Now() - lookup_start);
 
   auto entrypoint_args = tonic::ToDart(args);
 
+  main_entry_time_ = fml::TimePoint::Now();
   if (!InvokeMainEntrypoint(user_entrypoint_function, entrypoint_args)) {
     return false;
   }
@@ -526,12 +665,16 @@ bool DartIsolate::MarkIsolateRunnable() {
 
   tonic::DartState::Scope scope(this);
 
+  const fml::TimePoint lookup_start = fml::TimePoint::Now();
   auto user_entrypoint_function =
       Dart_GetField(Dart_LookupLibrary(tonic::ToDart(library_name.c_str())),
                     tonic::ToDart(entrypoint_name.c_str()));
+  startup_timing_.Add(IsolateStartupTiming::kRootLibraryLookup,
+                      fml::TimePoint::Now() - lookup_start);
 
   auto entrypoint_args = tonic::ToDart(args);
 
+  main_entry_time_ = fml::TimePoint::Now();
   if (!InvokeMainEntrypoint(user_entrypoint_function, entrypoint_args)) {
     return false;
   }
@@ -587,6 +730,14 @@ Dart_Isolate DartIsolate::DartCreateAndStartServiceIsolate(
     return nullptr;
   }
 
+  // The VM asks for the service isolate on a thread of its own, which waits
+  // here while the startup is deferred.
+  if (!DartServiceIsolate::WaitForStartupRelease()) {
+    *error = fml::strdup(
+        "The VM shut down before the deferred service isolate started.");
+    return nullptr;
+  }
+
   TaskRunners null_task_runners("io.flutter." DART_VM_SERVICE_ISOLATE_NAME,
                                 nullptr, nullptr, nullptr, nullptr);
 
@@ -768,6 +919,7 @@ Dart_Isolate DartIsolate::CreateDartIsolateGroup(
   TRACE_EVENT0("flutter", "DartIsolate::CreateDartIsolateGroup");
 
   // Create the Dart VM isolate and give it the embedder object as the baton.
+  const fml::TimePoint creation_start = fml::TimePoint::Now();
   Dart_Isolate isolate = Dart_CreateIsolateGroup(
       (*isolate_group_data)->GetAdvisoryScriptURI().c_str(),
       (*isolate_group_data)->GetAdvisoryScriptEntrypoint().c_str(),
@@ -781,6 +933,12 @@ Dart_Isolate DartIsolate::CreateDartIsolateGroup(
 
   // Ownership of the isolate data objects has been transferred to the Dart VM.
   std::shared_ptr<DartIsolate> embedder_isolate(*isolate_data);
+  embedder_isolate->startup_timing_.Set(
+      IsolateStartupTiming::kSnapshotMapping,
+      (*isolate_group_data)->GetIsolateSnapshot()->GetMappingDuration());
+  embedder_isolate->startup_timing_.Set(
+      IsolateStartupTiming::kIsolateCreation,
+      fml::TimePoint::Now() - creation_start);
   isolate_group_data.release();
   isolate_data.release();
 
@@ -6,6 +6,7 @@
 #define FLUTTER_RUNTIME_DART_ISOLATE_H_
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -13,11 +14,13 @@
 #include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/dart_snapshot.h"
+#include "flutter/runtime/isolate_startup_timing.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/tonic/dart_state.h"
 
@@ -203,6 +206,52 @@ class DartIsolate : public UIDartState {
       const fml::closure& isolate_create_callback,
       const fml::closure& isolate_shutdown_callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a root isolate in the isolate group of a running root
+  ///             isolate. The spawned isolate shares the heap, the program
+  ///             and the `DartIsolateGroupData` of the group, so it skips the
+  ///             snapshot setup a new group needs and is ready for a `Run`
+  ///             call after the same preparation a root isolate gets.
+  ///
+  ///             Isolate groups only share the program of precompiled code.
+  ///             When running from kernel, this creates a new isolate group
+  ///             from the isolate snapshot and callbacks of the spawning group
+  ///             instead.
+  ///
+  ///             The spawning isolate may not be entered while this is called.
+  ///             Since root isolates are only entered on their UI task runner,
+  ///             this must be called on that task runner.
+  ///
+  /// @param[in]  spawning_isolate            The root isolate whose group the
+  ///                                         new isolate joins.
+  /// @param[in]  task_runners                The task runners used by the new
+  ///                                         root isolate.
+  /// @param[in]  window                      The window associated with the
+  ///                                         new root isolate.
+  /// @param[in]  snapshot_delegate           The snapshot delegate.
+  /// @param[in]  io_manager                  The i/o manager.
+  /// @param[in]  unref_queue                 The Skia unref queue.
+  /// @param[in]  image_decoder               The image decoder.
+  /// @param[in]  advisory_script_uri         The advisory script uri. This is
+  ///                                         only used in instrumentation.
+  /// @param[in]  advisory_script_entrypoint  The advisory script entrypoint.
+  ///                                         This is only used in
+  ///                                         instrumentation.
+  ///
+  /// @return     A weak pointer to the spawned root isolate, with the same
+  ///             restrictions as the one returned by `CreateRootIsolate`.
+  ///
+  static std::weak_ptr<DartIsolate> SpawnRootIsolate(
+      DartIsolate& spawning_isolate,
+      TaskRunners task_runners,
+      std::unique_ptr<Window> window,
+      fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+      fml::WeakPtr<IOManager> io_manager,
+      fml::RefPtr<SkiaUnrefQueue> skia_unref_queue,
+      fml::WeakPtr<ImageDecoder> image_decoder,
+      std::string advisory_script_uri,
+      std::string advisory_script_entrypoint);
+
   // |UIDartState|
   ~DartIsolate() override;
 
@@ -230,6 +279,22 @@ class DartIsolate : public UIDartState {
   ///
   std::string GetServiceId();
 
+  //----------------------------------------------------------------------------
+  /// @brief      The time this isolate spent in each step of its startup. The
+  ///             timing is complete once the main entrypoint requested its
+  ///             first frame.
+  ///
+  /// @return     The startup timing.
+  ///
+  const IsolateStartupTiming& GetStartupTiming() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notes that the isolate requested a frame. The first request
+  ///             after the main entrypoint was invoked completes the startup
+  ///             timing, which is then also added to the timeline.
+  ///
+  void RecordFrameRequest();
+
   //----------------------------------------------------------------------------
   /// @brief      Prepare the isolate for running for a precompiled code bundle.
   ///             The Dart VM must be configured for running precompiled code.
@@ -399,6 +464,11 @@ class DartIsolate : public UIDartState {
   std::vector<std::unique_ptr<AutoFireClosure>> shutdown_callbacks_;
   fml::RefPtr<fml::TaskRunner> message_handling_task_runner_;
   const bool disable_http_;
+  const bool enable_canvas_command_buffer_;
+  const size_t message_batch_max_count_;
+  const int64_t message_batch_budget_us_;
+  IsolateStartupTiming startup_timing_;
+  std::optional<fml::TimePoint> main_entry_time_;
 
   DartIsolate(const Settings& settings,
               TaskRunners task_runners,
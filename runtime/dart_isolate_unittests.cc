@@ -54,6 +54,60 @@ TEST_F(DartIsolateTest, RootIsolateCreationAndShutdown) {
   ASSERT_TRUE(root_isolate->Shutdown());
 }
 
+TEST_F(DartIsolateTest, RootIsolateCanBeSpawnedIntoExistingGroup) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  ASSERT_TRUE(vm_ref);
+  auto vm_data = vm_ref.GetVMData();
+  ASSERT_TRUE(vm_data);
+  TaskRunners task_runners(GetCurrentTestName(),    //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner()   //
+  );
+  auto weak_isolate = DartIsolate::CreateRootIsolate(
+      vm_data->GetSettings(),             // settings
+      vm_data->GetIsolateSnapshot(),      // isolate snapshot
+      task_runners,                       // task runners
+      nullptr,                            // window
+      {},                                 // snapshot delegate
+      {},                                 // io manager
+      {},                                 // unref queue
+      {},                                 // image decoder
+      "main.dart",                        // advisory uri
+      "main",                             // advisory entrypoint
+      nullptr,                            // flags
+      settings.isolate_create_callback,   // isolate create callback
+      settings.isolate_shutdown_callback  // isolate shutdown callback
+  );
+  auto root_isolate = weak_isolate.lock();
+  ASSERT_TRUE(root_isolate);
+  auto weak_spawned_isolate = DartIsolate::SpawnRootIsolate(
+      *root_isolate,            // spawning isolate
+      std::move(task_runners),  // task runners
+      nullptr,                  // window
+      {},                       // snapshot delegate
+      {},                       // io manager
+      {},                       // unref queue
+      {},                       // image decoder
+      "main.dart",              // advisory uri
+      "spawned"                 // advisory entrypoint
+  );
+  auto spawned_isolate = weak_spawned_isolate.lock();
+  ASSERT_TRUE(spawned_isolate);
+  ASSERT_NE(spawned_isolate, root_isolate);
+  ASSERT_TRUE(spawned_isolate->IsRootIsolate());
+  ASSERT_EQ(spawned_isolate->GetPhase(), DartIsolate::Phase::LibrariesSetup);
+  if (DartVM::IsRunningPrecompiledCode()) {
+    ASSERT_EQ(Dart_IsolateGroupData(spawned_isolate->isolate()),
+              Dart_IsolateGroupData(root_isolate->isolate()));
+  }
+  ASSERT_TRUE(spawned_isolate->Shutdown());
+  ASSERT_TRUE(root_isolate->Shutdown());
+}
+
 TEST_F(DartIsolateTest, IsolateShutdownCallbackIsInIsolateScope) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   auto settings = CreateSettingsForFixture();
@@ -110,6 +164,43 @@ TEST_F(DartIsolateTest, IsolateCanLoadAndRunDartCode) {
   ASSERT_EQ(isolate->get()->GetPhase(), DartIsolate::Phase::Running);
 }
 
+TEST_F(DartIsolateTest, IsolateRecordsStartupTiming) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  const auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  TaskRunners task_runners(GetCurrentTestName(),    //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner(),  //
+                           GetCurrentTaskRunner()   //
+  );
+  auto isolate = RunDartCodeInIsolate(vm_ref, settings, task_runners, "main",
+                                      {}, GetFixturesPath());
+  ASSERT_TRUE(isolate);
+  DartIsolate* root_isolate = isolate->get();
+  const IsolateStartupTiming& timing = root_isolate->GetStartupTiming();
+  ASSERT_FALSE(timing.IsComplete());
+  ASSERT_GT(timing.Get(IsolateStartupTiming::kIsolateCreation),
+            fml::TimeDelta::Zero());
+  ASSERT_GT(timing.Get(IsolateStartupTiming::kLibrarySetup),
+            fml::TimeDelta::Zero());
+  if (!DartVM::IsRunningPrecompiledCode()) {
+    ASSERT_GT(timing.Get(IsolateStartupTiming::kLoadKernel),
+              fml::TimeDelta::Zero());
+  }
+
+  root_isolate->RecordFrameRequest();
+  ASSERT_TRUE(timing.IsComplete());
+  const fml::TimeDelta main_to_frame =
+      timing.Get(IsolateStartupTiming::kMainToFirstFrameRequest);
+  ASSERT_GT(main_to_frame, fml::TimeDelta::Zero());
+
+  // Later frame requests leave the timing as it is.
+  root_isolate->RecordFrameRequest();
+  ASSERT_EQ(timing.Get(IsolateStartupTiming::kMainToFirstFrameRequest),
+            main_to_frame);
+}
+
 TEST_F(DartIsolateTest, IsolateCannotLoadAndRunUnknownDartEntrypoint) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   const auto settings = CreateSettingsForFixture();
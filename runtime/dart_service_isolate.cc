@@ -54,6 +54,11 @@ std::mutex DartServiceIsolate::callbacks_mutex_;
 std::set<std::unique_ptr<DartServiceIsolate::ObservatoryServerStateCallback>>
     DartServiceIsolate::callbacks_;
 
+std::mutex DartServiceIsolate::startup_mutex_;
+std::condition_variable DartServiceIsolate::startup_condition_;
+DartServiceIsolate::StartupState DartServiceIsolate::startup_state_ =
+    DartServiceIsolate::StartupState::kReleased;
+
 void DartServiceIsolate::NotifyServerState(Dart_NativeArguments args) {
   Dart_Handle exception = nullptr;
   std::string uri =
@@ -122,6 +127,34 @@ bool DartServiceIsolate::RemoveServerStatusCallback(
   return true;
 }
 
+void DartServiceIsolate::SetStartupDeferred(bool deferred) {
+  std::scoped_lock lock(startup_mutex_);
+  startup_state_ = deferred ? StartupState::kHeld : StartupState::kReleased;
+}
+
+void DartServiceIsolate::ReleaseStartup() {
+  std::scoped_lock lock(startup_mutex_);
+  if (startup_state_ == StartupState::kHeld) {
+    startup_state_ = StartupState::kReleased;
+    startup_condition_.notify_all();
+  }
+}
+
+void DartServiceIsolate::CancelStartup() {
+  std::scoped_lock lock(startup_mutex_);
+  if (startup_state_ == StartupState::kHeld) {
+    startup_state_ = StartupState::kCancelled;
+    startup_condition_.notify_all();
+  }
+}
+
+bool DartServiceIsolate::WaitForStartupRelease() {
+  std::unique_lock lock(startup_mutex_);
+  startup_condition_.wait(
+      lock, [] { return startup_state_ != StartupState::kHeld; });
+  return startup_state_ == StartupState::kReleased;
+}
+
 void DartServiceIsolate::Shutdown(Dart_NativeArguments args) {
   // NO-OP.
 }
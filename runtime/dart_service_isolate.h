@@ -5,6 +5,7 @@
 #ifndef FLUTTER_RUNTIME_DART_SERVICE_ISOLATE_H_
 #define FLUTTER_RUNTIME_DART_SERVICE_ISOLATE_H_
 
+#include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <set>
@@ -95,6 +96,45 @@ class DartServiceIsolate {
   ///
   static bool RemoveServerStatusCallback(CallbackHandle handle);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the creation of the service isolate requested by
+  ///             the VM is held back until `ReleaseStartup` or `CancelStartup`
+  ///             is called. See `Settings::defer_observatory_startup`. Must be
+  ///             called before the VM is initialized.
+  ///
+  ///             This method is thread safe.
+  ///
+  /// @param[in]  deferred  Whether the startup is held back.
+  ///
+  static void SetStartupDeferred(bool deferred);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Lets the service isolate held back start.
+  ///             Does nothing if the startup is not held back.
+  ///
+  ///             This method is thread safe.
+  ///
+  static void ReleaseStartup();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gives up on the startup of the service isolate held back,
+  ///             which must happen before the VM shuts down.
+  ///             Does nothing if the startup is not held back.
+  ///
+  ///             This method is thread safe.
+  ///
+  static void CancelStartup();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Blocks the thread creating the service isolate while its
+  ///             startup is held back.
+  ///
+  ///             This method is thread safe.
+  ///
+  /// @return     False if the startup was cancelled.
+  ///
+  static bool WaitForStartupRelease();
+
  private:
   // Native entries.
   static void NotifyServerState(Dart_NativeArguments args);
@@ -102,6 +142,11 @@ class DartServiceIsolate {
 
   static std::mutex callbacks_mutex_;
   static std::set<std::unique_ptr<ObservatoryServerStateCallback>> callbacks_;
+
+  enum class StartupState { kReleased, kHeld, kCancelled };
+  static std::mutex startup_mutex_;
+  static std::condition_variable startup_condition_;
+  static StartupState startup_state_;
 };
 
 }  // namespace flutter
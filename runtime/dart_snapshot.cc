@@ -4,10 +4,14 @@
 
 #include "flutter/runtime/dart_snapshot.h"
 
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <utility>
 
 #include "flutter/fml/native_library.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/runtime/dart_vm.h"
@@ -28,14 +32,44 @@ const char* DartSnapshot::kIsolateInstructionsSymbol =
 
 #if !DART_SNAPSHOT_STATIC_LINK
 
-static std::unique_ptr<const fml::Mapping> GetFileMapping(
+// Maps the snapshot at |path|, or returns the mapping of it that is still
+// used by another snapshot of the process.
+//
+// The mappings are read-only and backed by the file, so that their pages are
+// shared with the other processes running the same snapshot. Engines that
+// resolve the same snapshot from settings also share a single mapping
+// instead of mapping it again each.
+static std::shared_ptr<const fml::Mapping> GetFileMapping(
     const std::string& path,
     bool executable) {
-  if (executable) {
-    return fml::FileMapping::CreateReadExecute(path);
-  } else {
-    return fml::FileMapping::CreateReadOnly(path);
+  TRACE_EVENT1("flutter", "DartSnapshot::GetFileMapping", "path",
+               path.c_str());
+  using Key = std::pair<std::string, bool>;
+  static std::mutex mutex;
+  static auto* mappings =
+      new std::map<Key, std::weak_ptr<const fml::Mapping>>();
+
+  std::scoped_lock lock(mutex);
+  auto found = mappings->find(Key{path, executable});
+  if (found != mappings->end()) {
+    if (auto mapping = found->second.lock()) {
+      TRACE_EVENT_INSTANT0("flutter", "DartSnapshot::ReusedFileMapping");
+      return mapping;
+    }
+    mappings->erase(found);
+  }
+
+  std::shared_ptr<fml::FileMapping> mapping =
+      executable ? fml::FileMapping::CreateReadExecute(path)
+                 : fml::FileMapping::CreateReadOnly(path);
+  if (!mapping) {
+    return nullptr;
   }
+  // The snapshots are only run once the shell is set up. Having the kernel
+  // read them in the meantime saves faulting on their pages one by one.
+  mapping->Prefetch();
+  mappings->emplace(Key{path, executable}, mapping);
+  return mapping;
 }
 
 // The first party embedders don't yet use the stable embedder API and depend on
@@ -55,9 +89,12 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
     const std::vector<std::string>& native_library_path,
     const char* native_library_symbol_name,
     bool is_executable) {
+  TRACE_EVENT1("flutter", "DartSnapshot::SearchMapping", "symbol",
+               native_library_symbol_name);
   // Ask the embedder. There is no fallback as we expect the embedders (via
   // their embedding APIs) to just specify the mappings directly.
   if (embedder_mapping_callback) {
+    TRACE_EVENT0("flutter", "EmbedderMapping");
     return embedder_mapping_callback();
   }
 
@@ -70,6 +107,7 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
 
   // Look in application specified native library if specified.
   for (const std::string& path : native_library_path) {
+    TRACE_EVENT1("flutter", "NativeLibraryMapping", "path", path.c_str());
     auto native_library = fml::NativeLibrary::Create(path.c_str());
     auto symbol_mapping = std::make_unique<const fml::SymbolMapping>(
         native_library, native_library_symbol_name);
@@ -80,6 +118,7 @@ static std::shared_ptr<const fml::Mapping> SearchMapping(
 
   // Look inside the currently loaded process.
   {
+    TRACE_EVENT0("flutter", "CurrentProcessMapping");
     auto loaded_process = fml::NativeLibrary::CreateForCurrentProcess();
     auto symbol_mapping = std::make_unique<const fml::SymbolMapping>(
         loaded_process, native_library_symbol_name);
@@ -170,10 +209,12 @@ fml::RefPtr<DartSnapshot> DartSnapshot::VMSnapshotFromSettings(
 fml::RefPtr<DartSnapshot> DartSnapshot::IsolateSnapshotFromSettings(
     const Settings& settings) {
   TRACE_EVENT0("flutter", "DartSnapshot::IsolateSnapshotFromSettings");
+  const fml::TimePoint start = fml::TimePoint::Now();
   auto snapshot =
       fml::MakeRefCounted<DartSnapshot>(ResolveIsolateData(settings),         //
                                         ResolveIsolateInstructions(settings)  //
       );
+  snapshot->mapping_duration_ = fml::TimePoint::Now() - start;
   if (snapshot->IsValid()) {
     return snapshot;
   }
@@ -202,4 +243,8 @@ const uint8_t* DartSnapshot::GetInstructionsMapping() const {
   return instructions_ ? instructions_->GetMapping() : nullptr;
 }
 
+fml::TimeDelta DartSnapshot::GetMappingDuration() const {
+  return mapping_duration_;
+}
+
 }  // namespace flutter
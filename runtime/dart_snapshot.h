@@ -11,6 +11,7 @@
 #include "flutter/common/settings.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/time/time_delta.h"
 
 namespace flutter {
 
@@ -139,9 +140,19 @@ class DartSnapshot : public fml::RefCountedThreadSafe<DartSnapshot> {
   ///
   const uint8_t* GetInstructionsMapping() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the time spent resolving and mapping the components of
+  ///             this snapshot.
+  ///
+  /// @return     The mapping duration. Zero for snapshots that were not
+  ///             resolved from settings.
+  ///
+  fml::TimeDelta GetMappingDuration() const;
+
  private:
   std::shared_ptr<const fml::Mapping> data_;
   std::shared_ptr<const fml::Mapping> instructions_;
+  fml::TimeDelta mapping_duration_;
 
   DartSnapshot(std::shared_ptr<const fml::Mapping> data,
                std::shared_ptr<const fml::Mapping> instructions);
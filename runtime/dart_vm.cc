@@ -265,7 +265,9 @@ DartVM::DartVM(std::shared_ptr<const DartVMData> vm_data,
       concurrent_message_loop_(fml::ConcurrentMessageLoop::Create()),
       skia_concurrent_executor_(
           [runner = concurrent_message_loop_->GetTaskRunner()](
-              fml::closure work) { runner->PostTask(work); }),
+              fml::closure work, fml::ConcurrentTaskPriority priority) {
+            runner->PostTask(work, priority);
+          }),
       vm_data_(vm_data),
       isolate_name_server_(std::move(isolate_name_server)),
       service_protocol_(std::make_shared<ServiceProtocol>()) {
@@ -393,6 +395,10 @@ DartVM::DartVM(std::shared_ptr<const DartVMData> vm_data,
 
   DartUI::InitForGlobal();
 
+  DartServiceIsolate::SetStartupDeferred(settings_.enable_observatory &&
+                                         settings_.defer_observatory_startup &&
+                                         !settings_.start_paused);
+
   {
     TRACE_EVENT0("flutter", "Dart_Initialize");
     Dart_InitializeParams params = {};
@@ -453,6 +459,8 @@ DartVM::DartVM(std::shared_ptr<const DartVMData> vm_data,
     Dart_SetDartLibrarySourcesKernel(dart_library_sources->GetMapping(),
                                      dart_library_sources->GetSize());
   }
+
+  creation_timestamp_ = Dart_TimelineGetMicros();
 }
 
 DartVM::~DartVM() {
@@ -464,6 +472,9 @@ DartVM::~DartVM() {
     Dart_ExitIsolate();
   }
 
+  // The VM waits for the service isolate to start while it shuts down.
+  DartServiceIsolate::CancelStartup();
+
   char* result = Dart_Cleanup();
 
   dart::bin::CleanupDartIo();
@@ -499,4 +510,8 @@ std::shared_ptr<fml::ConcurrentMessageLoop> DartVM::GetConcurrentMessageLoop() {
   return concurrent_message_loop_;
 }
 
+int64_t DartVM::GetCreationTimestamp() const {
+  return creation_timestamp_;
+}
+
 }  // namespace flutter
@@ -160,6 +160,14 @@ class DartVM {
   ///
   std::shared_ptr<fml::ConcurrentMessageLoop> GetConcurrentMessageLoop();
 
+  //----------------------------------------------------------------------------
+  /// @brief      When this Dart VM instance finished initializing.
+  ///
+  /// @return     The timestamp in microseconds, on the clock of
+  ///             `Dart_TimelineGetMicros`.
+  ///
+  int64_t GetCreationTimestamp() const;
+
  private:
   const Settings settings_;
   std::shared_ptr<fml::ConcurrentMessageLoop> concurrent_message_loop_;
@@ -167,6 +175,7 @@ class DartVM {
   std::shared_ptr<const DartVMData> vm_data_;
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
   const std::shared_ptr<ServiceProtocol> service_protocol_;
+  int64_t creation_timestamp_ = 0;
 
   friend class DartVMRef;
   friend class DartIsolate;
@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/idle_scheduler.h"
+
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// Longer windows between frames are the app being idle rather than the time
+// left in the interval of an animation frame.
+static constexpr fml::TimeDelta kMaxFrameGap =
+    fml::TimeDelta::FromMilliseconds(100);
+
+// The percentile of the recent windows between frames used as the prediction.
+// A low one, as a collection that runs into a frame costs much more than one
+// that isn't started.
+static constexpr double kPredictionPercentile = 0.1;
+
+IdleScheduler::IdleScheduler() {
+  frame_gaps_.reserve(kSampleCount);
+}
+
+IdleScheduler::~IdleScheduler() = default;
+
+void IdleScheduler::AddFrame(const FrameTiming& timing) {
+  std::scoped_lock lock(mutex_);
+  const fml::TimeDelta gap =
+      timing.Get(FrameTiming::kBuildStart) - last_build_finish_;
+  last_build_finish_ =
+      std::max(last_build_finish_, timing.Get(FrameTiming::kBuildFinish));
+  if (gap < fml::TimeDelta::Zero() || gap > kMaxFrameGap) {
+    return;
+  }
+  if (frame_gaps_.size() < kSampleCount) {
+    frame_gaps_.push_back(gap);
+  } else {
+    frame_gaps_[next_sample_] = gap;
+  }
+  next_sample_ = (next_sample_ + 1) % kSampleCount;
+}
+
+void IdleScheduler::DidBuildFrame(fml::TimePoint time) {
+  last_build_ = time;
+}
+
+std::optional<fml::TimeDelta> IdleScheduler::PredictFrameGap() const {
+  std::vector<fml::TimeDelta> gaps;
+  {
+    std::scoped_lock lock(mutex_);
+    if (frame_gaps_.size() < kMinSampleCount) {
+      return std::nullopt;
+    }
+    gaps = frame_gaps_;
+  }
+  const size_t index =
+      std::min(gaps.size() - 1,
+               static_cast<size_t>(gaps.size() * kPredictionPercentile));
+  std::nth_element(gaps.begin(), gaps.begin() + index, gaps.end());
+  return gaps[index];
+}
+
+fml::TimePoint IdleScheduler::GetIdleDeadline(fml::TimePoint now,
+                                              fml::TimePoint deadline) {
+  stats_.notifications++;
+  std::optional<fml::TimeDelta> gap = PredictFrameGap();
+  if (gap && last_build_ != fml::TimePoint()) {
+    const fml::TimePoint next_build = last_build_ + *gap;
+    // Once the predicted start has passed without a frame, the animation is
+    // over.
+    if (now < next_build && next_build < deadline) {
+      deadline = next_build;
+      stats_.shortened_notifications++;
+    }
+  }
+  if (deadline > now) {
+    stats_.idle_time = stats_.idle_time + (deadline - now);
+  }
+  return deadline;
+}
+
+void IdleScheduler::PostIdleTask(fml::closure task) {
+  tasks_.push_back(std::move(task));
+}
+
+void IdleScheduler::RunIdleTasks(fml::TimePoint deadline) {
+  while (!tasks_.empty() && fml::TimePoint::Now() < deadline) {
+    TRACE_EVENT0("flutter", "IdleTask");
+    fml::closure task = std::move(tasks_.front());
+    tasks_.pop_front();
+    task();
+    stats_.tasks_run++;
+  }
+}
+
+IdleScheduler::Stats IdleScheduler::GetStats() const {
+  return stats_;
+}
+
+void IdleScheduler::TraceCounters() const {
+#if !FLUTTER_RELEASE
+  std::optional<fml::TimeDelta> gap = PredictFrameGap();
+  FML_TRACE_COUNTER("flutter", "IdleScheduler",
+                    reinterpret_cast<int64_t>(this),                      //
+                    "Notifications", stats_.notifications,                //
+                    "Shortened", stats_.shortened_notifications,          //
+                    "TasksRun", stats_.tasks_run,                         //
+                    "PendingTasks", tasks_.size(),                        //
+                    "IdleMs", stats_.idle_time.ToMillisecondsF(),         //
+                    "PredictedGapMs", gap ? gap->ToMillisecondsF() : 0.0  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNTIME_IDLE_SCHEDULER_H_
+#define FLUTTER_RUNTIME_IDLE_SCHEDULER_H_
+
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// Fits the idle notifications of the root isolate, and the deferrable work
+/// queued to run when it is idle, into the time the UI thread is likely to be
+/// free between frames.
+///
+/// The animator notifies the isolate that it is idle until the end of the
+/// current frame interval, which is later than the start of the next build
+/// when frames are delayed or build quickly, so a collection the VM starts
+/// with that deadline can run into the next frame. While frames are being
+/// built one after the other, the scheduler predicts when the next build
+/// starts from the recent windows between the end of a build and the start of
+/// the next one, and ends the idle deadlines there instead. Between sparse
+/// frames, the deadlines are left as they are.
+///
+/// Frames are added on the raster thread. Everything else is done on the UI
+/// thread.
+class IdleScheduler {
+ public:
+  struct Stats {
+    size_t notifications = 0;
+    // The notifications whose deadline was moved to the predicted start of
+    // the next build.
+    size_t shortened_notifications = 0;
+    size_t tasks_run = 0;
+    // The idle time the VM was notified of.
+    fml::TimeDelta idle_time;
+  };
+
+  /// The number of recent windows between frames predictions are made from.
+  static constexpr size_t kSampleCount = 32;
+
+  /// The number of windows needed before predictions are made.
+  static constexpr size_t kMinSampleCount = 8;
+
+  IdleScheduler();
+
+  ~IdleScheduler();
+
+  /// Adds the window between the build of the frame before |timing| and its
+  /// own. Windows longer than an animation's are ignored.
+  void AddFrame(const FrameTiming& timing);
+
+  /// Records that the UI thread finished building a frame at |time|.
+  void DidBuildFrame(fml::TimePoint time);
+
+  /// The deadline the VM should be notified of for an idle period from |now|
+  /// to |deadline|.
+  fml::TimePoint GetIdleDeadline(fml::TimePoint now, fml::TimePoint deadline);
+
+  /// Queues |task| to run in an idle period, after the VM was notified.
+  void PostIdleTask(fml::closure task);
+
+  /// Runs the queued tasks, oldest first, until |deadline| passes. The rest
+  /// wait for the next idle period.
+  void RunIdleTasks(fml::TimePoint deadline);
+
+  size_t GetPendingTaskCount() const { return tasks_.size(); }
+
+  Stats GetStats() const;
+
+  /// Emits the stats and the prediction to the timeline.
+  void TraceCounters() const;
+
+ private:
+  mutable std::mutex mutex_;
+  // The recent windows between the end of a build and the start of the
+  // next, and the end of the last build, which are added on the raster
+  // thread.
+  std::vector<fml::TimeDelta> frame_gaps_;
+  size_t next_sample_ = 0;
+  fml::TimePoint last_build_finish_;
+  // The end of the last build recorded on the UI thread, which frame timings
+  // only report once the frame is rasterized.
+  fml::TimePoint last_build_;
+  std::deque<fml::closure> tasks_;
+  Stats stats_;
+
+  std::optional<fml::TimeDelta> PredictFrameGap() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IdleScheduler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_RUNTIME_IDLE_SCHEDULER_H_
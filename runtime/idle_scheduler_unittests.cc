@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/idle_scheduler.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static fml::TimePoint Ms(int64_t ms) {
+  return fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromMilliseconds(ms));
+}
+
+// Adds |count| frames that take |build_ms| to build, starting every
+// |interval_ms| from |start_ms|. Returns when the last build finished.
+static fml::TimePoint AddFrames(IdleScheduler& scheduler,
+                                size_t count,
+                                int64_t start_ms,
+                                int64_t build_ms,
+                                int64_t interval_ms) {
+  fml::TimePoint build_finish;
+  for (size_t i = 0; i < count; i++) {
+    const int64_t build_start = start_ms + i * interval_ms;
+    build_finish = Ms(build_start + build_ms);
+    FrameTiming timing;
+    timing.Set(FrameTiming::kBuildStart, Ms(build_start));
+    timing.Set(FrameTiming::kBuildFinish, build_finish);
+    timing.Set(FrameTiming::kRasterStart, build_finish);
+    timing.Set(FrameTiming::kRasterFinish, build_finish);
+    scheduler.AddFrame(timing);
+  }
+  scheduler.DidBuildFrame(build_finish);
+  return build_finish;
+}
+
+TEST(IdleSchedulerTest, KeepsDeadlinesWithoutEnoughFrames) {
+  IdleScheduler scheduler;
+  const fml::TimePoint last_build =
+      AddFrames(scheduler, IdleScheduler::kMinSampleCount, 1000, 4, 16);
+  EXPECT_EQ(scheduler.GetIdleDeadline(last_build, Ms(1000)), Ms(1000));
+  EXPECT_EQ(scheduler.GetStats().shortened_notifications, 0u);
+}
+
+TEST(IdleSchedulerTest, EndsDeadlinesWhenTheNextFrameIsPredicted) {
+  IdleScheduler scheduler;
+  // Builds take 4ms every 16ms, leaving 12ms between them.
+  const fml::TimePoint last_build =
+      AddFrames(scheduler, IdleScheduler::kSampleCount, 1000, 4, 16);
+  const fml::TimePoint now = last_build + fml::TimeDelta::FromMilliseconds(2);
+
+  EXPECT_EQ(scheduler.GetIdleDeadline(now, last_build +
+                                               fml::TimeDelta::FromSeconds(1)),
+            last_build + fml::TimeDelta::FromMilliseconds(12));
+  // Deadlines before the next frame are left as they are.
+  EXPECT_EQ(scheduler.GetIdleDeadline(now, now), now);
+
+  IdleScheduler::Stats stats = scheduler.GetStats();
+  EXPECT_EQ(stats.notifications, 2u);
+  EXPECT_EQ(stats.shortened_notifications, 1u);
+  EXPECT_EQ(stats.idle_time.ToMilliseconds(), 10);
+}
+
+TEST(IdleSchedulerTest, KeepsDeadlinesOnceTheAnimationIsOver) {
+  IdleScheduler scheduler;
+  const fml::TimePoint last_build =
+      AddFrames(scheduler, IdleScheduler::kSampleCount, 1000, 4, 16);
+  // No frame was built in the 51ms after the last one.
+  const fml::TimePoint now = last_build + fml::TimeDelta::FromMilliseconds(51);
+  const fml::TimePoint deadline = now + fml::TimeDelta::FromMilliseconds(100);
+  EXPECT_EQ(scheduler.GetIdleDeadline(now, deadline), deadline);
+}
+
+TEST(IdleSchedulerTest, IgnoresTheTimeBetweenSparseFrames) {
+  IdleScheduler scheduler;
+  // A second between frames isn't an animation.
+  const fml::TimePoint last_build =
+      AddFrames(scheduler, IdleScheduler::kSampleCount, 1000, 4, 1000);
+  const fml::TimePoint now = last_build + fml::TimeDelta::FromMilliseconds(2);
+  const fml::TimePoint deadline = now + fml::TimeDelta::FromMilliseconds(100);
+  EXPECT_EQ(scheduler.GetIdleDeadline(now, deadline), deadline);
+}
+
+TEST(IdleSchedulerTest, RunsIdleTasksUntilTheDeadline) {
+  IdleScheduler scheduler;
+  int runs = 0;
+  scheduler.PostIdleTask([&runs]() { runs++; });
+  scheduler.PostIdleTask([&runs]() { runs++; });
+
+  // The deadline has passed.
+  scheduler.RunIdleTasks(fml::TimePoint::Now());
+  EXPECT_EQ(runs, 0);
+  EXPECT_EQ(scheduler.GetPendingTaskCount(), 2u);
+
+  scheduler.RunIdleTasks(fml::TimePoint::Now() +
+                         fml::TimeDelta::FromSeconds(10));
+  EXPECT_EQ(runs, 2);
+  EXPECT_EQ(scheduler.GetPendingTaskCount(), 0u);
+  EXPECT_EQ(scheduler.GetStats().tasks_run, 2u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,37 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/isolate_startup_timing.h"
+
+namespace flutter {
+
+const char* IsolateStartupTiming::GetPhaseName(Phase phase) {
+  switch (phase) {
+    case kSnapshotMapping:
+      return "snapshotMapping";
+    case kIsolateCreation:
+      return "isolateCreation";
+    case kLoadKernel:
+      return "loadKernel";
+    case kLibrarySetup:
+      return "librarySetup";
+    case kRootLibraryLookup:
+      return "rootLibraryLookup";
+    case kMainToFirstFrameRequest:
+      return "mainToFirstFrameRequest";
+    case kCount:
+      break;
+  }
+  return "unknown";
+}
+
+fml::TimeDelta IsolateStartupTiming::GetTotal() const {
+  fml::TimeDelta total;
+  for (const fml::TimeDelta& duration : durations_) {
+    total = total + duration;
+  }
+  return total;
+}
+
+}  // namespace flutter
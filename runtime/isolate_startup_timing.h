@@ -0,0 +1,60 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNTIME_ISOLATE_STARTUP_TIMING_H_
+#define FLUTTER_RUNTIME_ISOLATE_STARTUP_TIMING_H_
+
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+/// The time a root isolate spent in each step of its startup, from mapping its
+/// snapshot to the first frame its main entrypoint requests. The steps run one
+/// after the other on the UI thread, except for the snapshot mapping which is
+/// done when the shell is created. Steps that did not run, such as loading
+/// kernel when running precompiled code, are zero.
+class IsolateStartupTiming {
+ public:
+  enum Phase {
+    // Resolving and mapping the isolate snapshot.
+    kSnapshotMapping,
+    // Creating the isolate (group) in the VM from the snapshot.
+    kIsolateCreation,
+    // Loading the kernel pieces of the application.
+    kLoadKernel,
+    // Setting up the engine libraries (dart:ui, dart:io) in the isolate.
+    kLibrarySetup,
+    // Looking up the root library and the main entrypoint in it.
+    kRootLibraryLookup,
+    // From invoking the main entrypoint until it requests the first frame.
+    kMainToFirstFrameRequest,
+    kCount,
+  };
+
+  static const char* GetPhaseName(Phase phase);
+
+  fml::TimeDelta Get(Phase phase) const { return durations_[phase]; }
+  void Set(Phase phase, fml::TimeDelta duration) {
+    durations_[phase] = duration;
+  }
+  void Add(Phase phase, fml::TimeDelta duration) {
+    durations_[phase] = durations_[phase] + duration;
+  }
+
+  // The sum of all phases.
+  fml::TimeDelta GetTotal() const;
+
+  // Whether the main entrypoint has requested its first frame, after which
+  // the timing does not change anymore.
+  bool IsComplete() const { return complete_; }
+  void SetComplete() { complete_ = true; }
+
+ private:
+  fml::TimeDelta durations_[kCount];
+  bool complete_ = false;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_RUNTIME_ISOLATE_STARTUP_TIMING_H_
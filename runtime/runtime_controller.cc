@@ -30,6 +30,40 @@ RuntimeController::RuntimeController(
     const fml::closure& p_isolate_create_callback,
     const fml::closure& p_isolate_shutdown_callback,
     std::shared_ptr<const fml::Mapping> p_persistent_isolate_data)
+    : RuntimeController(p_client,
+                        p_vm,
+                        std::move(p_isolate_snapshot),
+                        std::move(p_task_runners),
+                        std::move(p_snapshot_delegate),
+                        std::move(p_io_manager),
+                        std::move(p_unref_queue),
+                        std::move(p_image_decoder),
+                        std::move(p_advisory_script_uri),
+                        std::move(p_advisory_script_entrypoint),
+                        idle_notification_callback,
+                        p_window_data,
+                        p_isolate_create_callback,
+                        p_isolate_shutdown_callback,
+                        std::move(p_persistent_isolate_data),
+                        nullptr) {}
+
+RuntimeController::RuntimeController(
+    RuntimeDelegate& p_client,
+    DartVM* p_vm,
+    fml::RefPtr<const DartSnapshot> p_isolate_snapshot,
+    TaskRunners p_task_runners,
+    fml::WeakPtr<SnapshotDelegate> p_snapshot_delegate,
+    fml::WeakPtr<IOManager> p_io_manager,
+    fml::RefPtr<SkiaUnrefQueue> p_unref_queue,
+    fml::WeakPtr<ImageDecoder> p_image_decoder,
+    std::string p_advisory_script_uri,
+    std::string p_advisory_script_entrypoint,
+    const std::function<void(int64_t)>& idle_notification_callback,
+    const WindowData& p_window_data,
+    const fml::closure& p_isolate_create_callback,
+    const fml::closure& p_isolate_shutdown_callback,
+    std::shared_ptr<const fml::Mapping> p_persistent_isolate_data,
+    std::shared_ptr<DartIsolate> spawning_isolate)
     : client_(p_client),
       vm_(p_vm),
       isolate_snapshot_(std::move(p_isolate_snapshot)),
@@ -48,22 +82,37 @@ RuntimeController::RuntimeController(
   // Create the root isolate as soon as the runtime controller is initialized.
   // It will be run at a later point when the engine provides a run
   // configuration and then runs the isolate.
-  auto strong_root_isolate =
-      DartIsolate::CreateRootIsolate(vm_->GetVMData()->GetSettings(),  //
-                                     isolate_snapshot_,                //
-                                     task_runners_,                    //
-                                     std::make_unique<Window>(this),   //
-                                     snapshot_delegate_,               //
-                                     io_manager_,                      //
-                                     unref_queue_,                     //
-                                     image_decoder_,                   //
-                                     p_advisory_script_uri,            //
-                                     p_advisory_script_entrypoint,     //
-                                     nullptr,                          //
-                                     isolate_create_callback_,         //
-                                     isolate_shutdown_callback_        //
-                                     )
-          .lock();
+  std::weak_ptr<DartIsolate> weak_root_isolate;
+  if (spawning_isolate) {
+    weak_root_isolate =
+        DartIsolate::SpawnRootIsolate(*spawning_isolate,               //
+                                      task_runners_,                   //
+                                      std::make_unique<Window>(this),  //
+                                      snapshot_delegate_,              //
+                                      io_manager_,                     //
+                                      unref_queue_,                    //
+                                      image_decoder_,                  //
+                                      advisory_script_uri_,            //
+                                      advisory_script_entrypoint_      //
+        );
+  } else {
+    weak_root_isolate =
+        DartIsolate::CreateRootIsolate(vm_->GetVMData()->GetSettings(),  //
+                                       isolate_snapshot_,                //
+                                       task_runners_,                    //
+                                       std::make_unique<Window>(this),   //
+                                       snapshot_delegate_,               //
+                                       io_manager_,                      //
+                                       unref_queue_,                     //
+                                       image_decoder_,                   //
+                                       advisory_script_uri_,             //
+                                       advisory_script_entrypoint_,      //
+                                       nullptr,                          //
+                                       isolate_create_callback_,         //
+                                       isolate_shutdown_callback_        //
+        );
+  }
+  auto strong_root_isolate = weak_root_isolate.lock();
 
   FML_CHECK(strong_root_isolate) << "Could not create root isolate.";
 
@@ -109,7 +158,7 @@ bool RuntimeController::IsRootIsolateRunning() const {
 }
 
 std::unique_ptr<RuntimeController> RuntimeController::Clone() const {
-  return std::unique_ptr<RuntimeController>(new RuntimeController(
+  auto clone = std::unique_ptr<RuntimeController>(new RuntimeController(
       client_,                      //
       vm_,                          //
       isolate_snapshot_,            //
@@ -126,6 +175,47 @@ std::unique_ptr<RuntimeController> RuntimeController::Clone() const {
       isolate_shutdown_callback_,   //
       persistent_isolate_data_      //
       ));
+  clone->idle_scheduler_ = idle_scheduler_;
+  return clone;
+}
+
+std::unique_ptr<RuntimeController> RuntimeController::Spawn(
+    RuntimeDelegate& client,
+    fml::WeakPtr<ImageDecoder> image_decoder,
+    std::string advisory_script_uri,
+    std::string advisory_script_entrypoint,
+    const std::function<void(int64_t)>& idle_notification_callback,
+    const WindowData& window_data,
+    std::shared_ptr<const fml::Mapping> persistent_isolate_data) const {
+  TRACE_EVENT0("flutter", "RuntimeController::Spawn");
+  std::shared_ptr<DartIsolate> spawning_isolate = root_isolate_.lock();
+  FML_CHECK(spawning_isolate) << "Cannot spawn from a collected root isolate.";
+  return std::unique_ptr<RuntimeController>(new RuntimeController(
+      client,                                 //
+      vm_,                                    //
+      isolate_snapshot_,                      //
+      task_runners_,                          //
+      snapshot_delegate_,                     //
+      io_manager_,                            //
+      unref_queue_,                           //
+      std::move(image_decoder),               //
+      std::move(advisory_script_uri),         //
+      std::move(advisory_script_entrypoint),  //
+      idle_notification_callback,             //
+      window_data,                            //
+      isolate_create_callback_,               //
+      isolate_shutdown_callback_,             //
+      std::move(persistent_isolate_data),     //
+      std::move(spawning_isolate)             //
+      ));
+}
+
+DartVM* RuntimeController::GetDartVM() const {
+  return vm_;
+}
+
+fml::WeakPtr<IOManager> RuntimeController::GetIOManager() const {
+  return io_manager_;
 }
 
 bool RuntimeController::FlushRuntimeStateToIsolate() {
@@ -206,6 +296,9 @@ bool RuntimeController::SetAccessibilityFeatures(int32_t flags) {
 bool RuntimeController::BeginFrame(fml::TimePoint frame_time) {
   if (auto* window = GetWindowIfAvailable()) {
     window->BeginFrame(frame_time);
+    if (idle_scheduler_) {
+      idle_scheduler_->DidBuildFrame(fml::TimePoint::Now());
+    }
     return true;
   }
   return false;
@@ -227,6 +320,15 @@ bool RuntimeController::NotifyIdle(int64_t deadline) {
 
   tonic::DartState::Scope scope(root_isolate);
 
+  if (idle_scheduler_) {
+    // The deadline is on the clock of Dart_TimelineGetMicros.
+    const int64_t dart_now = Dart_TimelineGetMicros();
+    const fml::TimePoint now = fml::TimePoint::Now();
+    const fml::TimePoint idle_deadline = idle_scheduler_->GetIdleDeadline(
+        now, now + fml::TimeDelta::FromMicroseconds(deadline - dart_now));
+    deadline = dart_now + (idle_deadline - now).ToMicroseconds();
+  }
+
   Dart_NotifyIdle(deadline);
 
   // Idle notifications being in isolate scope are part of the contract.
@@ -234,6 +336,26 @@ bool RuntimeController::NotifyIdle(int64_t deadline) {
     TRACE_EVENT0("flutter", "EmbedderIdleNotification");
     idle_notification_callback_(deadline);
   }
+
+  if (idle_scheduler_) {
+    idle_scheduler_->RunIdleTasks(
+        fml::TimePoint::Now() + fml::TimeDelta::FromMicroseconds(
+                                    deadline - Dart_TimelineGetMicros()));
+    idle_scheduler_->TraceCounters();
+  }
+  return true;
+}
+
+void RuntimeController::SetIdleScheduler(
+    std::shared_ptr<IdleScheduler> scheduler) {
+  idle_scheduler_ = std::move(scheduler);
+}
+
+bool RuntimeController::PostIdleTask(fml::closure task) {
+  if (!idle_scheduler_) {
+    return false;
+  }
+  idle_scheduler_->PostIdleTask(std::move(task));
   return true;
 }
 
@@ -248,6 +370,18 @@ bool RuntimeController::DispatchPlatformMessage(
   return false;
 }
 
+bool RuntimeController::DispatchPlatformMessages(
+    const std::string& channel,
+    const std::vector<fml::RefPtr<PlatformMessage>>& messages) {
+  if (auto* window = GetWindowIfAvailable()) {
+    TRACE_EVENT1("flutter", "RuntimeController::DispatchPlatformMessages",
+                 "mode", "basic");
+    window->DispatchPlatformMessages(channel, messages);
+    return true;
+  }
+  return false;
+}
+
 bool RuntimeController::DispatchPointerDataPacket(
     const PointerDataPacket& packet) {
   if (auto* window = GetWindowIfAvailable()) {
@@ -283,6 +417,9 @@ std::string RuntimeController::DefaultRouteName() {
 
 // |WindowClient|
 void RuntimeController::ScheduleFrame() {
+  if (std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock()) {
+    root_isolate->RecordFrameRequest();
+  }
   client_.ScheduleFrame();
 }
 
@@ -365,6 +502,12 @@ std::pair<bool, uint32_t> RuntimeController::GetRootIsolateReturnCode() {
   return root_isolate_return_code_;
 }
 
+IsolateStartupTiming RuntimeController::GetRootIsolateStartupTiming() {
+  std::shared_ptr<DartIsolate> root_isolate = root_isolate_.lock();
+  return root_isolate ? root_isolate->GetStartupTiming()
+                      : IsolateStartupTiming{};
+}
+
 RuntimeController::Locale::Locale(std::string language_code_,
                                   std::string country_code_,
                                   std::string script_code_,
@@ -17,6 +17,8 @@
 #include "flutter/lib/ui/window/pointer_data_packet.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/runtime/idle_scheduler.h"
+#include "flutter/runtime/isolate_startup_timing.h"
 #include "flutter/runtime/window_data.h"
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
@@ -135,6 +137,61 @@ class RuntimeController final : public WindowClient {
   ///
   std::unique_ptr<RuntimeController> Clone() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Create a runtime controller whose root isolate is spawned
+  ///             into the isolate group of this runtime controller's root
+  ///             isolate. This skips the isolate group setup and shares the
+  ///             heap and program of the group. The spawned runtime controller
+  ///             shares the VM, the isolate snapshot, the task runners and the
+  ///             GPU resource handles of this one but keeps its own window
+  ///             state. The isolate create and shutdown callbacks are those of
+  ///             the isolate group.
+  ///
+  ///             This may only be called on the UI task runner while the root
+  ///             isolate of this runtime controller is alive.
+  ///
+  /// @see        `DartIsolate::SpawnRootIsolate`
+  ///
+  /// @param      client                      The runtime delegate of the
+  ///                                         spawned runtime controller.
+  /// @param[in]  image_decoder               The image decoder.
+  /// @param[in]  advisory_script_uri         The advisory script URI (only used
+  ///                                         for debugging).
+  /// @param[in]  advisory_script_entrypoint  The advisory script entrypoint
+  ///                                         (only used for debugging).
+  /// @param[in]  idle_notification_callback  The idle notification callback.
+  /// @param[in]  window_data                 The window data (if exists).
+  /// @param[in]  persistent_isolate_data     Unstructured persistent read-only
+  ///                                         data that the spawned root isolate
+  ///                                         can access in a synchronous
+  ///                                         manner.
+  ///
+  /// @return     The spawned runtime controller.
+  ///
+  std::unique_ptr<RuntimeController> Spawn(
+      RuntimeDelegate& client,
+      fml::WeakPtr<ImageDecoder> image_decoder,
+      std::string advisory_script_uri,
+      std::string advisory_script_entrypoint,
+      const std::function<void(int64_t)>& idle_notification_callback,
+      const WindowData& window_data,
+      std::shared_ptr<const fml::Mapping> persistent_isolate_data) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The VM the root isolate of this runtime controller runs in.
+  ///
+  /// @return     The Dart VM.
+  ///
+  DartVM* GetDartVM() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The IO manager used by the root isolate of this runtime
+  ///             controller.
+  ///
+  /// @return     The IO manager.
+  ///
+  fml::WeakPtr<IOManager> GetIOManager() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Forward the specified window metrics to the running isolate.
   ///             If the isolate is not running, these metrics will be saved and
@@ -333,6 +390,29 @@ class RuntimeController final : public WindowClient {
   ///
   bool NotifyIdle(int64_t deadline);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the scheduler that fits idle notifications into the
+  ///             time that is likely to be free between frames, and runs the
+  ///             idle tasks. Without one, the given deadlines are used as
+  ///             they are.
+  ///
+  /// @param[in]  scheduler  The shared scheduler, which the shell adds frame
+  ///             timings to.
+  ///
+  void SetIdleScheduler(std::shared_ptr<IdleScheduler> scheduler);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues deferrable work to run on the UI task runner in an
+  ///             idle period, after the VM was notified, while the idle
+  ///             deadline hasn't passed.
+  ///
+  /// @param[in]  task  The work to run.
+  ///
+  /// @return     Whether the task was queued, which it isn't without an idle
+  ///             scheduler.
+  ///
+  bool PostIdleTask(fml::closure task);
+
   //----------------------------------------------------------------------------
   /// @brief      Returns if the root isolate is running. The isolate must be
   ///             transitioned to the running phase manually. The isolate can
@@ -353,6 +433,21 @@ class RuntimeController final : public WindowClient {
   ///
   bool DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatch several platform messages sent on the same channel
+  ///             to the running root isolate in a single call.
+  ///
+  /// @param[in]  channel   The channel all the messages were sent on.
+  /// @param[in]  messages  The messages to dispatch, in the order they were
+  ///                       sent.
+  ///
+  /// @return     If the messages were dispatched to the running root isolate.
+  ///             This may fail is an isolate is not running.
+  ///
+  bool DispatchPlatformMessages(
+      const std::string& channel,
+      const std::vector<fml::RefPtr<PlatformMessage>>& messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Dispatch the specified pointer data message to the running
   ///             root isolate.
@@ -440,6 +535,15 @@ class RuntimeController final : public WindowClient {
   ///
   std::pair<bool, uint32_t> GetRootIsolateReturnCode();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the time the root isolate spent in each step of its
+  ///             startup.
+  ///
+  /// @return     The startup timing of the root isolate, or an empty timing
+  ///             if there is no root isolate.
+  ///
+  IsolateStartupTiming GetRootIsolateStartupTiming();
+
  private:
   struct Locale {
     Locale(std::string language_code_,
@@ -472,6 +576,25 @@ class RuntimeController final : public WindowClient {
   const fml::closure isolate_create_callback_;
   const fml::closure isolate_shutdown_callback_;
   std::shared_ptr<const fml::Mapping> persistent_isolate_data_;
+  std::shared_ptr<IdleScheduler> idle_scheduler_;
+
+  RuntimeController(
+      RuntimeDelegate& client,
+      DartVM* vm,
+      fml::RefPtr<const DartSnapshot> isolate_snapshot,
+      TaskRunners task_runners,
+      fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+      fml::WeakPtr<IOManager> io_manager,
+      fml::RefPtr<SkiaUnrefQueue> unref_queue,
+      fml::WeakPtr<ImageDecoder> image_decoder,
+      std::string advisory_script_uri,
+      std::string advisory_script_entrypoint,
+      const std::function<void(int64_t)>& idle_notification_callback,
+      const WindowData& window_data,
+      const fml::closure& isolate_create_callback,
+      const fml::closure& isolate_shutdown_callback,
+      std::shared_ptr<const fml::Mapping> persistent_isolate_data,
+      std::shared_ptr<DartIsolate> spawning_isolate);
 
   Window* GetWindowIfAvailable();
 
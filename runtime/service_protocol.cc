@@ -33,8 +33,25 @@ const std::string_view ServiceProtocol::kSetAssetBundlePathExtensionName =
     "_flutter.setAssetBundlePath";
 const std::string_view ServiceProtocol::kGetDisplayRefreshRateExtensionName =
     "_flutter.getDisplayRefreshRate";
+const std::string_view ServiceProtocol::kGetFrameTimingHistogramsExtensionName =
+    "_flutter.getFrameTimingHistograms";
 const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
     "_flutter.getSkSLs";
+const std::string_view
+    ServiceProtocol::kGetSkSLPrecompilationProgressExtensionName =
+        "_flutter.getSkSLPrecompilationProgress";
+const std::string_view ServiceProtocol::kGetTraceRingBuffersExtensionName =
+    "_flutter.getTraceRingBuffers";
+const std::string_view ServiceProtocol::kGetMemoryUsageExtensionName =
+    "_flutter.getMemoryUsage";
+const std::string_view ServiceProtocol::kGetIsolateStartupTimingExtensionName =
+    "_flutter.getIsolateStartupTiming";
+const std::string_view ServiceProtocol::kGetStartupTimingExtensionName =
+    "_flutter.getStartupTiming";
+const std::string_view ServiceProtocol::kGetLayerCostsExtensionName =
+    "_flutter.getLayerCosts";
+const std::string_view ServiceProtocol::kGetSyncProfileExtensionName =
+    "_flutter.getSyncProfile";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -52,7 +69,15 @@ ServiceProtocol::ServiceProtocol()
           kFlushUIThreadTasksExtensionName,
           kSetAssetBundlePathExtensionName,
           kGetDisplayRefreshRateExtensionName,
+          kGetFrameTimingHistogramsExtensionName,
           kGetSkSLsExtensionName,
+          kGetSkSLPrecompilationProgressExtensionName,
+          kGetTraceRingBuffersExtensionName,
+          kGetMemoryUsageExtensionName,
+          kGetIsolateStartupTimingExtensionName,
+          kGetStartupTimingExtensionName,
+          kGetLayerCostsExtensionName,
+          kGetSyncProfileExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
@@ -27,7 +27,15 @@ class ServiceProtocol {
   static const std::string_view kFlushUIThreadTasksExtensionName;
   static const std::string_view kSetAssetBundlePathExtensionName;
   static const std::string_view kGetDisplayRefreshRateExtensionName;
+  static const std::string_view kGetFrameTimingHistogramsExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
+  static const std::string_view kGetSkSLPrecompilationProgressExtensionName;
+  static const std::string_view kGetTraceRingBuffersExtensionName;
+  static const std::string_view kGetMemoryUsageExtensionName;
+  static const std::string_view kGetIsolateStartupTimingExtensionName;
+  static const std::string_view kGetStartupTimingExtensionName;
+  static const std::string_view kGetLayerCostsExtensionName;
+  static const std::string_view kGetSyncProfileExtensionName;
 
   class Handler {
    public:
@@ -17,10 +17,12 @@ void SkiaConcurrentExecutor::add(fml::closure work) {
   if (!work) {
     return;
   }
-  on_work_([work]() {
-    TRACE_EVENT0("flutter", "SkiaExecutor");
-    work();
-  });
+  on_work_(
+      [work]() {
+        TRACE_EVENT0("flutter", "SkiaExecutor");
+        work();
+      },
+      fml::ConcurrentTaskPriority::kHigh);
 }
 
 }  // namespace flutter
@@ -6,6 +6,7 @@
 #define FLUTTER_RUNTIME_SKIA_CONCURRENT_EXECUTOR_H_
 
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkExecutor.h"
 
@@ -24,13 +25,19 @@ namespace flutter {
 ///             worker pool is held next to the process global Dart VM instance.
 ///             The Skia executor is wired up there as well.
 ///
+///             Skia only offloads work that a frame is about to wait on, like
+///             threaded shader compiles and path mask rendering. So this work
+///             is scheduled ahead of image decodes sharing the same workers.
+///
 class SkiaConcurrentExecutor : public SkExecutor {
  public:
   //----------------------------------------------------------------------------
   /// The callback invoked by the executor to schedule the given task onto an
-  /// engine managed background thread.
+  /// engine managed background thread with the given priority.
   ///
-  using OnWorkCallback = std::function<void(fml::closure work)>;
+  using OnWorkCallback =
+      std::function<void(fml::closure work,
+                         fml::ConcurrentTaskPriority priority)>;
 
   //----------------------------------------------------------------------------
   /// @brief      Create a new instance of the executor.
@@ -4,6 +4,9 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include <algorithm>
+#include <string>
+
 #include "flutter/fml/trace_event.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
@@ -17,29 +20,51 @@ namespace {
 constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
     fml::TimeDelta::FromMilliseconds(51);
 
+// How much earlier than predicted a frame whose start is delayed is scheduled
+// to complete, to absorb the error of the prediction.
+constexpr fml::TimeDelta kPredictedFrameMargin =
+    fml::TimeDelta::FromMilliseconds(2);
+
+// Shorter delays are not worth the added task.
+constexpr fml::TimeDelta kMinBeginFrameDelay =
+    fml::TimeDelta::FromMilliseconds(1);
+
+// How often the preferred frame rate is checked while no frames are built.
+constexpr fml::TimeDelta kFrameRateUpdateInterval =
+    fml::TimeDelta::FromMilliseconds(250);
+
+uint32_t GetDefaultPipelineDepth(const TaskRunners& task_runners) {
+#if FLUTTER_SHELL_ENABLE_METAL
+  return 2;
+#else   // FLUTTER_SHELL_ENABLE_METAL
+  // TODO(dnfield): We should remove this logic and set the pipeline depth
+  // back to 2 in this case. See
+  // https://github.com/flutter/engine/pull/9132 for discussion.
+  return task_runners.GetPlatformTaskRunner() ==
+                 task_runners.GetRasterTaskRunner()
+             ? 1
+             : 2;
+#endif  // FLUTTER_SHELL_ENABLE_METAL
+}
+
 }  // namespace
 
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   uint32_t pipeline_depth,
+                   bool low_latency_pipeline)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
+      last_vsync_start_time_(),
       last_frame_begin_time_(),
       last_frame_target_time_(),
       dart_frame_deadline_(0),
-#if FLUTTER_SHELL_ENABLE_METAL
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
-#else   // FLUTTER_SHELL_ENABLE_METAL
-      // TODO(dnfield): We should remove this logic and set the pipeline depth
-      // back to 2 in this case. See
-      // https://github.com/flutter/engine/pull/9132 for discussion.
       layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(
-          task_runners.GetPlatformTaskRunner() ==
-                  task_runners.GetRasterTaskRunner()
-              ? 1
-              : 2)),
-#endif  // FLUTTER_SHELL_ENABLE_METAL
+          pipeline_depth > 0 ? pipeline_depth
+                             : GetDefaultPipelineDepth(task_runners_),
+          low_latency_pipeline)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
@@ -52,12 +77,41 @@ Animator::Animator(Delegate& delegate,
 
 Animator::~Animator() = default;
 
+void Animator::SetFrameTimePredictor(
+    std::shared_ptr<FrameTimePredictor> predictor) {
+  frame_time_predictor_ = std::move(predictor);
+}
+
+void Animator::SetSkipUnchangedFrames(bool skip_unchanged_frames) {
+  skip_unchanged_frames_ = skip_unchanged_frames;
+  last_content_hash_.reset();
+}
+
+void Animator::SetAdaptiveFrameRate(bool adaptive_frame_rate) {
+  if (adaptive_frame_rate == !!frame_rate_hinter_) {
+    return;
+  }
+  if (adaptive_frame_rate) {
+    frame_rate_hinter_ = std::make_unique<FrameRateHinter>();
+    return;
+  }
+  const bool had_preference = frame_rate_hinter_->preferred_frame_rate() !=
+                              FrameRateHinter::kNoPreference;
+  frame_rate_hinter_.reset();
+  if (had_preference) {
+    waiter_->SetPreferredFrameRate(FrameRateHinter::kNoPreference);
+  }
+}
+
 float Animator::GetDisplayRefreshRate() const {
   return waiter_->GetDisplayRefreshRate();
 }
 
 void Animator::Stop() {
   paused_ = true;
+  // The output surface may be gone, so the next frame must be drawn even if it
+  // is unchanged.
+  last_content_hash_.reset();
 }
 
 void Animator::Start() {
@@ -98,7 +152,7 @@ static int64_t FxlToDartOrEarlier(fml::TimePoint time) {
   return (time - fxl_now).ToMicroseconds() + dart_now;
 }
 
-void Animator::BeginFrame(fml::TimePoint frame_start_time,
+void Animator::BeginFrame(fml::TimePoint vsync_start_time,
                           fml::TimePoint frame_target_time) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
 
@@ -133,9 +187,15 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   // to service potential frame.
   FML_DCHECK(producer_continuation_);
 
-  last_frame_begin_time_ = frame_start_time;
+  last_vsync_start_time_ = vsync_start_time;
+  last_frame_begin_time_ = fml::TimePoint::Now();
   last_frame_target_time_ = frame_target_time;
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
+  if (frame_rate_hinter_) {
+    frame_rate_hinter_->OnBeginFrame(vsync_start_time,
+                                     frame_target_time - vsync_start_time);
+    UpdatePreferredFrameRate();
+  }
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
                  FrameParity());
@@ -171,6 +231,41 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   }
 }
 
+void Animator::ScheduleBeginFrame(fml::TimePoint frame_start_time,
+                                  fml::TimePoint frame_target_time) {
+  std::optional<fml::TimeDelta> predicted_duration;
+  if (frame_time_predictor_) {
+    predicted_duration = frame_time_predictor_->PredictFrameDuration();
+  }
+  if (!predicted_duration) {
+    BeginFrame(frame_start_time, frame_target_time);
+    return;
+  }
+
+  // Never delay by more than half of the frame interval, so that a prediction
+  // that is off by a lot still leaves time to complete the frame.
+  const fml::TimePoint now = fml::TimePoint::Now();
+  const fml::TimeDelta delay = std::min(
+      frame_target_time - now - *predicted_duration - kPredictedFrameMargin,
+      (frame_target_time - frame_start_time) / 2);
+  if (delay < kMinBeginFrameDelay) {
+    BeginFrame(frame_start_time, frame_target_time);
+    return;
+  }
+
+  const std::string delay_us = std::to_string(delay.ToMicroseconds());
+  TRACE_EVENT_INSTANT1("flutter", "Animator::ScheduleBeginFrame", "delay_us",
+                       delay_us.c_str());
+  task_runners_.GetUITaskRunner()->PostDelayedTask(
+      [self = weak_factory_.GetWeakPtr(), frame_start_time,
+       frame_target_time]() {
+        if (self) {
+          self->BeginFrame(frame_start_time, frame_target_time);
+        }
+      },
+      delay);
+}
+
 void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
   if (dimension_change_pending_ &&
       layer_tree->frame_size() != last_layer_tree_size_) {
@@ -180,19 +275,59 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
   if (layer_tree) {
     // Note the frame time for instrumentation.
-    layer_tree->RecordBuildTime(last_frame_begin_time_,
+    layer_tree->RecordBuildTime(last_vsync_start_time_, last_frame_begin_time_,
                                 last_frame_target_time_);
   }
 
+  std::optional<uint64_t> content_hash;
+  if (skip_unchanged_frames_ && layer_tree) {
+    content_hash = layer_tree->GetContentHash();
+    if (content_hash && content_hash == last_content_hash_) {
+      // The rasterizer already shows this frame. The pending continuation is
+      // reused by the next frame.
+      TRACE_EVENT_INSTANT0("flutter", "Skipped Unchanged Frame");
+      return;
+    }
+  }
+
   // Commit the pending continuation.
   bool result = producer_continuation_.Complete(std::move(layer_tree));
   if (!result) {
     FML_DLOG(INFO) << "No pending continuation to commit";
+  } else {
+    last_content_hash_ = content_hash;
   }
 
   delegate_.OnAnimatorDraw(layer_tree_pipeline_, last_frame_target_time_);
 }
 
+void Animator::UpdatePreferredFrameRate() {
+  std::optional<float> frame_rate = frame_rate_hinter_->Update(
+      fml::TimePoint::Now(), waiter_->GetDisplayRefreshRate());
+  if (frame_rate) {
+    const std::string fps = std::to_string(*frame_rate);
+    TRACE_EVENT_INSTANT1("flutter", "Animator::UpdatePreferredFrameRate", "fps",
+                         fps.c_str());
+    waiter_->SetPreferredFrameRate(*frame_rate);
+  }
+
+  if (frame_rate_update_scheduled_ || !frame_rate_hinter_->HasPendingUpdate()) {
+    return;
+  }
+  frame_rate_update_scheduled_ = true;
+  task_runners_.GetUITaskRunner()->PostDelayedTask(
+      [self = weak_factory_.GetWeakPtr()]() {
+        if (!self) {
+          return;
+        }
+        self->frame_rate_update_scheduled_ = false;
+        if (self->frame_rate_hinter_) {
+          self->UpdatePreferredFrameRate();
+        }
+      },
+      kFrameRateUpdateInterval);
+}
+
 bool Animator::CanReuseLastLayerTree() {
   return !regenerate_layer_tree_;
 }
@@ -242,7 +377,7 @@ void Animator::AwaitVSync() {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree();
           } else {
-            self->BeginFrame(frame_start_time, frame_target_time);
+            self->ScheduleBeginFrame(frame_start_time, frame_target_time);
           }
         }
       });
@@ -6,12 +6,15 @@
 #define FLUTTER_SHELL_COMMON_ANIMATOR_H_
 
 #include <deque>
+#include <optional>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_rate_hinter.h"
+#include "flutter/shell/common/frame_time_predictor.h"
 #include "flutter/shell/common/pipeline.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -41,9 +44,14 @@ class Animator final {
     virtual void OnAnimatorDrawLastLayerTree() = 0;
   };
 
+  /// A |pipeline_depth| of zero picks the default depth of the layer tree
+  /// pipeline for the platform. With |low_latency_pipeline|, the pipeline
+  /// replaces a queued layer tree with a newer one, see |Pipeline|.
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           uint32_t pipeline_depth = 0,
+           bool low_latency_pipeline = false);
 
   ~Animator();
 
@@ -70,6 +78,30 @@ class Animator final {
   /// @see      `PointerDataDispatcher::ScheduleSecondaryVsyncCallback`.
   void ScheduleSecondaryVsyncCallback(const fml::closure& callback);
 
+  //--------------------------------------------------------------------------
+  /// @brief    Delays the start of each frame's UI work after vsync for as long
+  ///           as |predictor| predicts the frame to still complete before its
+  ///           target time, which shortens the time between input being
+  ///           handled and the frame showing it. Passing null starts frames
+  ///           at vsync, which is the default.
+  ///
+  void SetFrameTimePredictor(std::shared_ptr<FrameTimePredictor> predictor);
+
+  //--------------------------------------------------------------------------
+  /// @brief    Drops layer trees that paint the same frame as the last layer
+  ///           tree handed to the rasterizer instead of rasterizing them
+  ///           again, see `LayerTree::GetContentHash`. Disabled by default.
+  ///
+  void SetSkipUnchangedFrames(bool skip_unchanged_frames);
+
+  //--------------------------------------------------------------------------
+  /// @brief    Asks the vsync waiter for a lower refresh rate while frames are
+  ///           built less often than the display refreshes, and for the
+  ///           highest rate again once they aren't, see |FrameRateHinter|.
+  ///           Disabled by default.
+  ///
+  void SetAdaptiveFrameRate(bool adaptive_frame_rate);
+
   void Start();
 
   void Stop();
@@ -83,9 +115,19 @@ class Animator final {
  private:
   using LayerTreePipeline = Pipeline<flutter::LayerTree>;
 
-  void BeginFrame(fml::TimePoint frame_start_time,
+  // Builds the frame started by the vsync at |vsync_start_time|. The build
+  // starts now.
+  void BeginFrame(fml::TimePoint vsync_start_time,
                   fml::TimePoint frame_target_time);
 
+  // Calls |BeginFrame| now, or as late as the frame time predictor allows.
+  void ScheduleBeginFrame(fml::TimePoint frame_start_time,
+                          fml::TimePoint frame_target_time);
+
+  // Hands a changed preferred frame rate to the vsync waiter, and checks
+  // again later while it may still change without more frames.
+  void UpdatePreferredFrameRate();
+
   bool CanReuseLastLayerTree();
   void DrawLastLayerTree();
 
@@ -97,6 +139,7 @@ class Animator final {
   TaskRunners task_runners_;
   std::shared_ptr<VsyncWaiter> waiter_;
 
+  fml::TimePoint last_vsync_start_time_;
   fml::TimePoint last_frame_begin_time_;
   fml::TimePoint last_frame_target_time_;
   int64_t dart_frame_deadline_;
@@ -111,6 +154,13 @@ class Animator final {
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_;
   std::deque<uint64_t> trace_flow_ids_;
+  std::shared_ptr<FrameTimePredictor> frame_time_predictor_;
+  bool skip_unchanged_frames_ = false;
+  // The content hash of the last layer tree handed to the rasterizer, if it
+  // had one.
+  std::optional<uint64_t> last_content_hash_;
+  std::unique_ptr<FrameRateHinter> frame_rate_hinter_;
+  bool frame_rate_update_scheduled_ = false;
 
   fml::WeakPtrFactory<Animator> weak_factory_;
 
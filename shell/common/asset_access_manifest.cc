@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/asset_access_manifest.h"
+
+#include <algorithm>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/paths.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// static
+std::vector<std::string> AssetAccessManifest::Read(const std::string& path) {
+  std::vector<std::string> asset_names;
+  auto mapping = fml::FileMapping::CreateReadOnly(path);
+  if (!mapping || mapping->GetSize() == 0) {
+    return asset_names;
+  }
+  const char* data = reinterpret_cast<const char*>(mapping->GetMapping());
+  const char* end = data + mapping->GetSize();
+  while (data < end) {
+    const char* line_end = std::find(data, end, '\n');
+    if (line_end > data) {
+      asset_names.emplace_back(data, line_end);
+    }
+    data = line_end + 1;
+  }
+  return asset_names;
+}
+
+// static
+bool AssetAccessManifest::Write(const std::string& path,
+                                const std::vector<std::string>& asset_names) {
+  auto directory = fml::OpenDirectory(fml::paths::GetDirectoryName(path).c_str(),
+                                      false, fml::FilePermission::kReadWrite);
+  if (!directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the directory of the asset access "
+                      "manifest at "
+                   << path;
+    return false;
+  }
+
+  std::string contents;
+  for (const auto& asset_name : asset_names) {
+    contents.append(asset_name);
+    contents.push_back('\n');
+  }
+  const std::string file_name =
+      path.substr(path.find_last_of("/\\") + 1);  // npos + 1 is zero.
+  if (!fml::WriteAtomically(directory, file_name.c_str(),
+                            fml::DataMapping(contents))) {
+    FML_LOG(ERROR) << "Could not write the asset access manifest at " << path;
+    return false;
+  }
+  return true;
+}
+
+// static
+void AssetAccessManifest::Prefetch(
+    std::shared_ptr<AssetManager> asset_manager,
+    const std::vector<std::string>& asset_names,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  if (!asset_manager || !worker_task_runner) {
+    return;
+  }
+  // The names are posted in the order the assets were looked up, so the
+  // workers start with the assets needed first.
+  for (const auto& asset_name : asset_names) {
+    worker_task_runner->PostTask([asset_manager, asset_name]() {
+      TRACE_EVENT1("flutter", "AssetAccessManifest::Prefetch", "name",
+                   asset_name.c_str());
+      // Looking the asset up reads it ahead. The pages stay cached once the
+      // mapping is gone.
+      auto mapping = asset_manager->GetAsMapping(asset_name);
+    });
+  }
+}
+
+}  // namespace flutter
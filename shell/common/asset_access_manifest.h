@@ -0,0 +1,51 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_ASSET_ACCESS_MANIFEST_H_
+#define FLUTTER_SHELL_COMMON_ASSET_ACCESS_MANIFEST_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+/// The assets a run looked up before its first frame, in the order they were
+/// first looked up.
+///
+/// A run started with |Settings::record_asset_access_manifest| records the
+/// manifest. Later runs read it and prefetch the assets concurrently while the
+/// isolate is starting, so that their lookups on the UI and IO threads don't
+/// block on disk reads.
+///
+/// The manifest is a text file with an asset name on each line.
+class AssetAccessManifest {
+ public:
+  /// Returns the asset names of the manifest at |path|, or none if it can't be
+  /// read.
+  static std::vector<std::string> Read(const std::string& path);
+
+  /// Atomically replaces the manifest at |path| with |asset_names|.
+  static bool Write(const std::string& path,
+                    const std::vector<std::string>& asset_names);
+
+  /// Starts reading the assets named |asset_names| into memory in parallel on
+  /// |worker_task_runner|. Assets mapped from files are read ahead into the
+  /// page cache, where they stay for their actual lookup.
+  static void Prefetch(
+      std::shared_ptr<AssetManager> asset_manager,
+      const std::vector<std::string>& asset_names,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(AssetAccessManifest);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_ASSET_ACCESS_MANIFEST_H_
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/asset_access_manifest.h"
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/paths.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(AssetAccessManifestTest, WrittenManifestCanBeRead) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const auto path = fml::paths::JoinPaths({temp_dir.path(), "manifest"});
+
+  ASSERT_TRUE(AssetAccessManifest::Read(path).empty());
+
+  const std::vector<std::string> asset_names = {
+      "FontManifest.json",
+      "fonts/MaterialIcons-Regular.otf",
+      "assets/images/logo.png",
+  };
+  ASSERT_TRUE(AssetAccessManifest::Write(path, asset_names));
+  ASSERT_EQ(AssetAccessManifest::Read(path), asset_names);
+
+  ASSERT_TRUE(AssetAccessManifest::Write(path, {"AssetManifest.json"}));
+  ASSERT_EQ(AssetAccessManifest::Read(path),
+            std::vector<std::string>{"AssetManifest.json"});
+
+  fml::UnlinkFile(temp_dir.fd(), "manifest");
+}
+
+TEST(AssetAccessManifestTest, AssetManagerRecordsFoundAssetsInOrder) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  ASSERT_TRUE(fml::WriteAtomically(temp_dir.fd(), "a",
+                                   fml::DataMapping(std::string("a"))));
+  ASSERT_TRUE(fml::WriteAtomically(temp_dir.fd(), "b",
+                                   fml::DataMapping(std::string("b"))));
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+      fml::OpenDirectory(temp_dir.path().c_str(), false,
+                         fml::FilePermission::kRead)));
+
+  ASSERT_NE(asset_manager.GetAsMapping("a"), nullptr);
+  asset_manager.StartRecordingAccesses();
+  ASSERT_NE(asset_manager.GetAsMapping("b"), nullptr);
+  ASSERT_EQ(asset_manager.GetAsMapping("missing"), nullptr);
+  ASSERT_NE(asset_manager.GetAsDemandPagedMapping("a"), nullptr);
+  ASSERT_NE(asset_manager.GetAsMapping("b"), nullptr);
+
+  ASSERT_EQ(asset_manager.StopRecordingAccesses(),
+            (std::vector<std::string>{"b", "a"}));
+
+  ASSERT_NE(asset_manager.GetAsMapping("a"), nullptr);
+  ASSERT_TRUE(asset_manager.StopRecordingAccesses().empty());
+
+  fml::UnlinkFile(temp_dir.fd(), "a");
+  fml::UnlinkFile(temp_dir.fd(), "b");
+}
+
+}  // namespace testing
+}  // namespace flutter
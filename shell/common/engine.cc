@@ -4,6 +4,7 @@
 
 #include "flutter/shell/common/engine.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -14,6 +15,7 @@
 #include "flutter/fml/file.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/synchronization/sync_switch.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/lib/snapshot/snapshot.h"
@@ -45,7 +47,8 @@ Engine::Engine(Delegate& delegate,
                std::unique_ptr<Animator> animator,
                fml::WeakPtr<IOManager> io_manager,
                fml::RefPtr<SkiaUnrefQueue> unref_queue,
-               fml::WeakPtr<SnapshotDelegate> snapshot_delegate)
+               fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+               ImageDecoderBackends image_decoder_backends)
     : delegate_(delegate),
       settings_(std::move(settings)),
       animator_(std::move(animator)),
@@ -53,9 +56,17 @@ Engine::Engine(Delegate& delegate,
       have_surface_(false),
       image_decoder_(task_runners,
                      vm.GetConcurrentWorkerTaskRunner(),
-                     io_manager),
+                     io_manager,
+                     settings_.decoded_image_cache_max_bytes,
+                     std::move(image_decoder_backends),
+                     {settings_.animated_image_look_ahead_frames,
+                      settings_.animated_image_frame_cache_max_bytes}),
       task_runners_(std::move(task_runners)),
       weak_factory_(this) {
+  if (settings_.layout_cache_max_bytes > 0) {
+    FontCollection::SetLayoutCacheMaxBytes(settings_.layout_cache_max_bytes);
+  }
+
   // Runtime controller is initialized here because it takes a reference to this
   // object as its delegate. The delegate may be called in the constructor and
   // we want to be fully initilazed by that point.
@@ -80,8 +91,65 @@ Engine::Engine(Delegate& delegate,
   pointer_data_dispatcher_ = dispatcher_maker(*this);
 }
 
+Engine::Engine(Delegate& delegate,
+               const PointerDataDispatcherMaker& dispatcher_maker,
+               const RuntimeController& spawning_runtime_controller,
+               TaskRunners task_runners,
+               const WindowData window_data,
+               Settings settings,
+               std::unique_ptr<Animator> animator,
+               ImageDecoderBackends image_decoder_backends)
+    : delegate_(delegate),
+      settings_(std::move(settings)),
+      animator_(std::move(animator)),
+      activity_running_(true),
+      have_surface_(false),
+      image_decoder_(task_runners,
+                     spawning_runtime_controller.GetDartVM()
+                         ->GetConcurrentWorkerTaskRunner(),
+                     spawning_runtime_controller.GetIOManager(),
+                     settings_.decoded_image_cache_max_bytes,
+                     std::move(image_decoder_backends),
+                     {settings_.animated_image_look_ahead_frames,
+                      settings_.animated_image_frame_cache_max_bytes}),
+      task_runners_(std::move(task_runners)),
+      weak_factory_(this) {
+  runtime_controller_ = spawning_runtime_controller.Spawn(
+      *this,                                 // runtime delegate
+      image_decoder_.GetWeakPtr(),           // image decoder
+      settings_.advisory_script_uri,         // advisory script uri
+      settings_.advisory_script_entrypoint,  // advisory script entrypoint
+      settings_.idle_notification_callback,  // idle notification callback
+      window_data,                           // window data
+      settings_.persistent_isolate_data      // persistent isolate data
+  );
+
+  pointer_data_dispatcher_ = dispatcher_maker(*this);
+}
+
 Engine::~Engine() = default;
 
+std::unique_ptr<Engine> Engine::Spawn(
+    Delegate& delegate,
+    const PointerDataDispatcherMaker& dispatcher_maker,
+    const WindowData window_data,
+    Settings settings,
+    std::unique_ptr<Animator> animator,
+    ImageDecoderBackends image_decoder_backends) const {
+  TRACE_EVENT0("flutter", "Engine::Spawn");
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  return std::unique_ptr<Engine>(
+      new Engine(delegate,                          //
+                 dispatcher_maker,                  //
+                 *runtime_controller_,              //
+                 task_runners_,                     //
+                 window_data,                       //
+                 std::move(settings),               //
+                 std::move(animator),               //
+                 std::move(image_decoder_backends)  //
+                 ));
+}
+
 float Engine::GetDisplayRefreshRate() const {
   return animator_->GetDisplayRefreshRate();
 }
@@ -95,6 +163,25 @@ void Engine::SetupDefaultFontManager() {
   font_collection_.SetupDefaultFontManager();
 }
 
+void Engine::SetupDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
+  TRACE_EVENT0("flutter", "Engine::SetupDefaultFontManager");
+  font_collection_.GetFontCollection()->SetDefaultFontManager(
+      std::move(font_manager));
+}
+
+void Engine::NotifyMemoryPressure(MemoryPressureLevel level) {
+  TRACE_EVENT0("flutter", "Engine::NotifyMemoryPressure");
+  if (level == MemoryPressureLevel::kModerate) {
+    image_decoder_.GetCache()->PurgeUnusedImages();
+    // A frame's worth of time is enough for a young generation collection.
+    static constexpr int64_t kModerateIdleMicros = 16000;
+    NotifyIdle(Dart_TimelineGetMicros() + kModerateIdleMicros);
+    return;
+  }
+  image_decoder_.GetCache()->Clear();
+  font_collection_.PurgeCaches();
+}
+
 bool Engine::UpdateAssetManager(
     std::shared_ptr<AssetManager> new_asset_manager) {
   if (asset_manager_ == new_asset_manager) {
@@ -117,6 +204,60 @@ bool Engine::UpdateAssetManager(
   return true;
 }
 
+void Engine::WarmUpGlyphs(const std::vector<GlyphWarmUp::Spec>& specs) {
+  TRACE_EVENT0("flutter", "Engine::WarmUpGlyphs");
+  struct Task {
+    std::string font_family;
+    sk_sp<SkTypeface> typeface;
+    float font_size;
+    std::string characters;
+  };
+  std::vector<Task> tasks;
+  std::shared_ptr<txt::FontCollection> font_collection =
+      font_collection_.GetFontCollection();
+  for (const GlyphWarmUp::Spec& spec : specs) {
+    sk_sp<SkTypeface> typeface =
+        font_collection->MatchTypeface(spec.font_family);
+    if (!typeface) {
+      FML_LOG(ERROR) << "Could not find the font family \""
+                     << spec.font_family << "\" to warm up the glyphs of.";
+      continue;
+    }
+    for (float font_size : spec.font_sizes) {
+      tasks.push_back({spec.font_family, typeface, font_size, spec.characters});
+    }
+  }
+  if (tasks.empty()) {
+    return;
+  }
+
+  // The tasks count down the ones left, which traces the progress.
+  auto remaining = std::make_shared<std::atomic<size_t>>(tasks.size());
+  fml::WeakPtr<IOManager> io_manager = runtime_controller_->GetIOManager();
+  for (Task& task : tasks) {
+    task_runners_.GetIOTaskRunner()->PostTaskWithPriority(
+        [task = std::move(task), io_manager, remaining]() {
+          TRACE_EVENT2("flutter", "GlyphWarmUp", "family",
+                       task.font_family.c_str(), "size",
+                       std::to_string(task.font_size).c_str());
+          if (io_manager && io_manager->GetResourceContext()) {
+            io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+                fml::SyncSwitch::Handlers().SetIfFalse([&] {
+                  GlyphWarmUp::Rasterize(
+                      io_manager->GetResourceContext().get(), task.typeface,
+                      task.font_size, task.characters);
+                }));
+          }
+          const size_t remaining_count = --*remaining;
+          FML_TRACE_COUNTER("flutter", "GlyphWarmUp",
+                            reinterpret_cast<int64_t>(remaining.get()),  //
+                            "Remaining", remaining_count                 //
+          );
+        },
+        fml::TaskPriority::kIdle);
+  }
+}
+
 bool Engine::Restart(RunConfiguration configuration) {
   TRACE_EVENT0("flutter", "Engine::Restart");
   if (!configuration.IsValid()) {
@@ -124,6 +265,8 @@ bool Engine::Restart(RunConfiguration configuration) {
     return false;
   }
   delegate_.OnPreEngineRestart();
+  pending_semantics_nodes_.clear();
+  pending_semantics_actions_.clear();
   runtime_controller_ = runtime_controller_->Clone();
   UpdateAssetManager(nullptr);
   return Run(std::move(configuration)) == Engine::RunStatus::Success;
@@ -221,11 +364,29 @@ Engine::RunStatus Engine::PrepareAndLaunchIsolate(
     }
   }
 
+  // The fonts of the assets are registered by now.
+  if (!glyphs_warmed_up_) {
+    glyphs_warmed_up_ = true;
+    std::vector<GlyphWarmUp::Spec> specs;
+    for (const std::string& spec : settings_.glyph_warm_up) {
+      if (std::optional<GlyphWarmUp::Spec> parsed =
+              GlyphWarmUp::ParseSpec(spec)) {
+        specs.push_back(std::move(*parsed));
+      } else {
+        FML_LOG(ERROR) << "Glyph warm-up spec \"" << spec
+                       << "\" was malformed.";
+      }
+    }
+    WarmUpGlyphs(specs);
+  }
+
   return RunStatus::Success;
 }
 
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
+  viewport_metrics_sent_this_frame_ = false;
+  FlushPendingViewportMetrics();
   runtime_controller_->BeginFrame(frame_time);
 }
 
@@ -241,6 +402,10 @@ void Engine::NotifyIdle(int64_t deadline) {
   runtime_controller_->NotifyIdle(deadline);
 }
 
+void Engine::SetIdleScheduler(std::shared_ptr<IdleScheduler> scheduler) {
+  runtime_controller_->SetIdleScheduler(std::move(scheduler));
+}
+
 std::pair<bool, uint32_t> Engine::GetUIIsolateReturnCode() {
   return runtime_controller_->GetRootIsolateReturnCode();
 }
@@ -253,6 +418,10 @@ std::string Engine::GetUIIsolateName() {
   return runtime_controller_->GetIsolateName();
 }
 
+IsolateStartupTiming Engine::GetUIIsolateStartupTiming() {
+  return runtime_controller_->GetRootIsolateStartupTiming();
+}
+
 bool Engine::UIIsolateHasLivePorts() {
   return runtime_controller_->HasLivePorts();
 }
@@ -273,11 +442,25 @@ void Engine::OnOutputSurfaceDestroyed() {
 }
 
 void Engine::SetViewportMetrics(const ViewportMetrics& metrics) {
+  // Only defer the metrics while a frame is certain to begin and deliver them.
+  if (viewport_metrics_sent_this_frame_ && animator_ && have_surface_ &&
+      activity_running_) {
+    TRACE_EVENT_INSTANT0("flutter", "Engine::SetViewportMetrics deferred");
+    pending_viewport_metrics_ = metrics;
+    ScheduleFrame();
+    return;
+  }
+  pending_viewport_metrics_.reset();
+  ApplyViewportMetrics(metrics);
+}
+
+void Engine::ApplyViewportMetrics(const ViewportMetrics& metrics) {
   bool dimensions_changed =
       viewport_metrics_.physical_height != metrics.physical_height ||
       viewport_metrics_.physical_width != metrics.physical_width ||
       viewport_metrics_.physical_depth != metrics.physical_depth;
   viewport_metrics_ = metrics;
+  viewport_metrics_sent_this_frame_ = true;
   runtime_controller_->SetViewportMetrics(viewport_metrics_);
   if (animator_) {
     if (dimensions_changed)
@@ -287,6 +470,14 @@ void Engine::SetViewportMetrics(const ViewportMetrics& metrics) {
   }
 }
 
+void Engine::FlushPendingViewportMetrics() {
+  if (pending_viewport_metrics_) {
+    ViewportMetrics metrics = *pending_viewport_metrics_;
+    pending_viewport_metrics_.reset();
+    ApplyViewportMetrics(metrics);
+  }
+}
+
 void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   if (message->channel() == kLifecycleChannel) {
     if (HandleLifecyclePlatformMessage(message.get()))
@@ -314,9 +505,28 @@ void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
                     << message->channel();
 }
 
+void Engine::DispatchPlatformMessages(
+    const std::string& channel,
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  const bool handled_by_engine = channel == kLifecycleChannel ||
+                                 channel == kLocalizationChannel ||
+                                 channel == kSettingsChannel ||
+                                 channel == kNavigationChannel;
+  if (messages.size() > 1 && !handled_by_engine &&
+      runtime_controller_->IsRootIsolateRunning() &&
+      runtime_controller_->DispatchPlatformMessages(channel, messages)) {
+    return;
+  }
+
+  for (auto& message : messages) {
+    DispatchPlatformMessage(std::move(message));
+  }
+}
+
 bool Engine::HandleLifecyclePlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string state(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string state(reinterpret_cast<const char*>(data.GetMapping()),
+                    data.GetSize());
   if (state == "AppLifecycleState.paused" ||
       state == "AppLifecycleState.detached") {
     activity_running_ = false;
@@ -343,7 +553,8 @@ bool Engine::HandleNavigationPlatformMessage(
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -359,7 +570,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -394,7 +606,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
 
 void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string jsonData(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string jsonData(reinterpret_cast<const char*>(data.GetMapping()),
+                       data.GetSize());
   if (runtime_controller_->SetUserSettingsData(std::move(jsonData)) &&
       have_surface_) {
     ScheduleFrame();
@@ -416,14 +629,37 @@ void Engine::DispatchSemanticsAction(int id,
 }
 
 void Engine::SetSemanticsEnabled(bool enabled) {
+  if (!enabled) {
+    pending_semantics_nodes_.clear();
+    pending_semantics_actions_.clear();
+  }
   runtime_controller_->SetSemanticsEnabled(enabled);
 }
 
+void Engine::SetSemanticsClientActive(bool active) {
+  if (semantics_client_active_ == active) {
+    return;
+  }
+  semantics_client_active_ = active;
+  if (active &&
+      (!pending_semantics_nodes_.empty() ||
+       !pending_semantics_actions_.empty())) {
+    TRACE_EVENT0("flutter", "Engine::FlushPendingSemantics");
+    SemanticsNodeUpdates nodes;
+    CustomAccessibilityActionUpdates actions;
+    nodes.swap(pending_semantics_nodes_);
+    actions.swap(pending_semantics_actions_);
+    delegate_.OnEngineUpdateSemantics(std::move(nodes), std::move(actions));
+  }
+}
+
 void Engine::SetAccessibilityFeatures(int32_t flags) {
   runtime_controller_->SetAccessibilityFeatures(flags);
 }
 
 void Engine::StopAnimator() {
+  // No frame is going to deliver them.
+  FlushPendingViewportMetrics();
   animator_->Stop();
 }
 
@@ -458,6 +694,19 @@ void Engine::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
 void Engine::UpdateSemantics(SemanticsNodeUpdates update,
                              CustomAccessibilityActionUpdates actions) {
+  if (!semantics_client_active_) {
+    // Every update of a node carries all of its properties, so only the last
+    // one needs to be kept.
+    for (auto& node : update) {
+      pending_semantics_nodes_.insert_or_assign(node.first,
+                                                std::move(node.second));
+    }
+    for (auto& action : actions) {
+      pending_semantics_actions_.insert_or_assign(action.first,
+                                                  std::move(action.second));
+    }
+    return;
+  }
   delegate_.OnEngineUpdateSemantics(std::move(update), std::move(actions));
 }
 
@@ -505,19 +754,28 @@ void Engine::HandleAssetPlatformMessage(fml::RefPtr<PlatformMessage> message) {
     return;
   }
   const auto& data = message->data();
-  std::string asset_name(reinterpret_cast<const char*>(data.data()),
-                         data.size());
-
-  if (asset_manager_) {
-    std::unique_ptr<fml::Mapping> asset_mapping =
-        asset_manager_->GetAsMapping(asset_name);
-    if (asset_mapping) {
-      response->Complete(std::move(asset_mapping));
-      return;
-    }
+  std::string asset_name(reinterpret_cast<const char*>(data.GetMapping()),
+                         data.GetSize());
+
+  if (!asset_manager_) {
+    response->CompleteEmpty();
+    return;
   }
 
-  response->CompleteEmpty();
+  // Images and other assets of the framework are loaded over this channel,
+  // don't block the UI thread on the file system while they are read. The
+  // callback keeps the asset manager alive while the asset is read.
+  asset_manager_->GetAsMappingAsync(
+      asset_name, task_runners_.GetIOTaskRunner(),
+      task_runners_.GetUITaskRunner(),
+      [response, asset_manager = asset_manager_](
+          std::unique_ptr<fml::Mapping> asset_mapping) {
+        if (asset_mapping) {
+          response->Complete(std::move(asset_mapping));
+        } else {
+          response->CompleteEmpty();
+        }
+      });
 }
 
 const std::string& Engine::GetLastEntrypoint() const {
@@ -6,11 +6,13 @@
 #define SHELL_COMMON_ENGINE_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "flutter/assets/asset_manager.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/macros.h"
+#include "flutter/flow/glyph_warm_up.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
 #include "flutter/lib/ui/semantics/custom_accessibility_action.h"
@@ -23,6 +25,7 @@
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
 #include "flutter/shell/common/animator.h"
+#include "flutter/shell/common/memory_pressure.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/rasterizer.h"
@@ -289,6 +292,9 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   /// @param[in]  io_manager         The IO manager used by this root isolate to
   ///                                schedule tasks that manage resources on the
   ///                                GPU.
+  /// @param[in]  image_decoder_backends  The platform's image decoders, which
+  ///                                the image decoder prefers over Skia's
+  ///                                codecs for the images they accept.
   ///
   Engine(Delegate& delegate,
          const PointerDataDispatcherMaker& dispatcher_maker,
@@ -300,7 +306,8 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
          std::unique_ptr<Animator> animator,
          fml::WeakPtr<IOManager> io_manager,
          fml::RefPtr<SkiaUnrefQueue> unref_queue,
-         fml::WeakPtr<SnapshotDelegate> snapshot_delegate);
+         fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+         ImageDecoderBackends image_decoder_backends = {});
 
   //----------------------------------------------------------------------------
   /// @brief      Destroys the engine engine. Called by the shell on the UI task
@@ -311,6 +318,39 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   ~Engine() override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an engine whose root isolate is spawned into the
+  ///             isolate group of this engine's root isolate. The spawned
+  ///             engine shares the VM, the isolate snapshot, the task runners,
+  ///             the IO manager and the snapshot delegate of this engine, and
+  ///             starts without the isolate group setup of a new engine. It
+  ///             must be launched with its own run configuration like any
+  ///             other engine.
+  ///
+  ///             This may only be called on the UI task runner while this
+  ///             engine is alive.
+  ///
+  /// @see        `RuntimeController::Spawn`
+  ///
+  /// @param      delegate                The delegate of the spawned engine.
+  /// @param      dispatcher_maker        The pointer data dispatcher maker of
+  ///                                     the spawned engine.
+  /// @param[in]  window_data             The initial window data of the
+  ///                                     spawned engine.
+  /// @param[in]  settings                The settings of the spawned engine.
+  /// @param[in]  animator                The animator of the spawned engine.
+  /// @param[in]  image_decoder_backends  The platform's image decoders.
+  ///
+  /// @return     The spawned engine.
+  ///
+  std::unique_ptr<Engine> Spawn(
+      Delegate& delegate,
+      const PointerDataDispatcherMaker& dispatcher_maker,
+      const WindowData window_data,
+      Settings settings,
+      std::unique_ptr<Animator> animator,
+      ImageDecoderBackends image_decoder_backends = {}) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Gets the refresh rate in frames per second of the vsync waiter
   ///             used by the animator managed by this engine. This information
@@ -387,6 +427,28 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void SetupDefaultFontManager();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Setup the default font manager with one that was created
+  ///             ahead of time, usually on a worker thread while the rest of
+  ///             the shell was being set up.
+  ///
+  /// @param[in]  font_manager  The default font manager of the platform.
+  ///
+  void SetupDefaultFontManager(sk_sp<SkFontMgr> font_manager);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the system is running low on memory.
+  ///             At `MemoryPressureLevel::kCritical` and above, the font
+  ///             fallback and text layout caches and the decoded image cache
+  ///             are purged. At the moderate level, only the decoded images
+  ///             that no image object refers to anymore are evicted and the
+  ///             Dart VM is given a short idle period to collect garbage in;
+  ///             the shell notifies it of more severe levels itself.
+  ///
+  /// @param[in]  level  How much memory should be given up.
+  ///
+  void NotifyMemoryPressure(MemoryPressureLevel level);
+
   //----------------------------------------------------------------------------
   /// @brief      Updates the asset manager referenced by the root isolate of a
   ///             Flutter application. This happens implicitly in the call to
@@ -409,6 +471,20 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   bool UpdateAssetManager(std::shared_ptr<AssetManager> asset_manager);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Rasterizes the glyphs of the given font families at the given
+  ///             sizes on the resource context, so that the first frames
+  ///             showing them don't have to. The families are looked up in
+  ///             the font collection of the engine, so the fonts of the assets
+  ///             are only found once the asset manager is set. Each family
+  ///             and size is rasterized by an idle priority task of the IO
+  ///             task runner. This is done with the specs of
+  ///             `Settings::glyph_warm_up` when the engine is first run.
+  ///
+  /// @param[in]  specs  The font families, sizes and characters to rasterize.
+  ///
+  void WarmUpGlyphs(const std::vector<GlyphWarmUp::Spec>& specs);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that it is time to begin working on a new
   ///             frame previously scheduled via a call to
@@ -494,6 +570,16 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void NotifyIdle(int64_t deadline);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the scheduler that fits the idle notifications of the
+  ///             root isolate into the time likely to be free between frames.
+  ///             It is kept across hot restarts.
+  ///
+  /// @param[in]  scheduler  The scheduler, which the shell adds the timings
+  ///                        of rasterized frames to.
+  ///
+  void SetIdleScheduler(std::shared_ptr<IdleScheduler> scheduler);
+
   //----------------------------------------------------------------------------
   /// @brief      Dart code cannot fully measure the time it takes for a
   ///             specific frame to be rendered. This is because Dart code only
@@ -553,6 +639,15 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   std::string GetUIIsolateName();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the time the root isolate spent in each step of its
+  ///             startup, from mapping its snapshot to the first frame its
+  ///             main entrypoint requested.
+  ///
+  /// @return     The startup timing of the root isolate.
+  ///
+  IsolateStartupTiming GetUIIsolateStartupTiming();
+
   //----------------------------------------------------------------------------
   /// @brief      It is an unexpected challenge to determine when a Dart
   ///             application is "done". The application cannot simply terminate
@@ -647,6 +742,12 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///             rendering viewport in texels as well as edge insets if
   ///             present.
   ///
+  ///             The framework is told of at most one update of the metrics
+  ///             per frame. Updates made after the framework was told of one
+  ///             and before the next frame begins replace each other, and the
+  ///             latest is delivered as that frame begins, so that a burst of
+  ///             them, as during a live resize, is not laid out once each.
+  ///
   /// @see        `ViewportMetrics`
   ///
   /// @param[in]  metrics  The metrics
@@ -663,6 +764,22 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the embedder has sent it several
+  ///             messages on the same channel, which are handed to the Dart
+  ///             application in a single call. Messages on the channels the
+  ///             engine handles itself, or sent before the root isolate runs,
+  ///             are dispatched one by one instead.
+  ///
+  /// @see        `DispatchPlatformMessage`, `PlatformMessageBuffers`
+  ///
+  /// @param[in]  channel   The channel all the messages were sent on.
+  /// @param[in]  messages  The messages, in the order they were sent.
+  ///
+  void DispatchPlatformMessages(
+      const std::string& channel,
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that the embedder has sent it a pointer
   ///             data packet. A pointer data packet may contain multiple
@@ -710,6 +827,22 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void SetSemanticsEnabled(bool enabled);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine whether anything on the platform consumes
+  ///             the accessibility tree. Semantics may stay enabled without a
+  ///             consumer, for instance after a one-time accessibility probe.
+  ///             While there is none, the semantics updates of the framework
+  ///             are merged here instead of being sent to the platform view
+  ///             every frame, and the merged update is sent once a consumer
+  ///             becomes active again. This call originates in the platform
+  ///             view and is forwarded to the engine here on the UI task
+  ///             runner by the shell.
+  ///
+  /// @param[in]  active  Whether a consumer of the accessibility tree is
+  ///                     active. The default is true.
+  ///
+  void SetSemanticsClientActive(bool active);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that the embedder has expressed an opinion
   ///             about where the flags to set on the accessibility tree. This
@@ -766,14 +899,33 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   std::string last_entry_point_library_;
   std::string initial_route_;
   ViewportMetrics viewport_metrics_;
+  // Metrics set after the framework was told of an update in the current
+  // frame, delivered as the next frame begins.
+  std::optional<ViewportMetrics> pending_viewport_metrics_;
+  bool viewport_metrics_sent_this_frame_ = false;
   std::shared_ptr<AssetManager> asset_manager_;
   bool activity_running_;
   bool have_surface_;
   FontCollection font_collection_;
   ImageDecoder image_decoder_;
   TaskRunners task_runners_;
+  bool glyphs_warmed_up_ = false;
+  bool semantics_client_active_ = true;
+  // The semantics updates held back while no client is active, merged by
+  // node and action identifier.
+  SemanticsNodeUpdates pending_semantics_nodes_;
+  CustomAccessibilityActionUpdates pending_semantics_actions_;
   fml::WeakPtrFactory<Engine> weak_factory_;
 
+  Engine(Delegate& delegate,
+         const PointerDataDispatcherMaker& dispatcher_maker,
+         const RuntimeController& spawning_runtime_controller,
+         TaskRunners task_runners,
+         const WindowData window_data,
+         Settings settings,
+         std::unique_ptr<Animator> animator,
+         ImageDecoderBackends image_decoder_backends);
+
   // |RuntimeDelegate|
   std::string DefaultRouteName() override;
 
@@ -799,6 +951,10 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
 
   void StopAnimator();
 
+  void ApplyViewportMetrics(const ViewportMetrics& metrics);
+
+  void FlushPendingViewportMetrics();
+
   void StartAnimatorIfPossible();
 
   bool HandleLifecyclePlatformMessage(PlatformMessage* message);
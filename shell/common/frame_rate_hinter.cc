@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_rate_hinter.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+// The demand is counted over a short window, so a rate still counts as
+// showing it when it is off by this factor.
+static constexpr double kDemandTolerance = 1.1;
+
+FrameRateHinter::FrameRateHinter() = default;
+
+FrameRateHinter::~FrameRateHinter() = default;
+
+void FrameRateHinter::OnBeginFrame(fml::TimePoint vsync_start_time,
+                                   fml::TimeDelta vsync_interval) {
+  if (consecutive_frame_count_ > 0 &&
+      vsync_start_time - last_vsync_start_time_ <=
+          vsync_interval + vsync_interval / 2) {
+    consecutive_frame_count_++;
+  } else {
+    consecutive_frame_count_ = 1;
+  }
+  last_vsync_start_time_ = vsync_start_time;
+  frame_times_.push_back(vsync_start_time);
+}
+
+std::optional<float> FrameRateHinter::Update(fml::TimePoint now,
+                                             float display_refresh_rate) {
+  max_refresh_rate_ = std::max(max_refresh_rate_, display_refresh_rate);
+  while (!frame_times_.empty() && now - frame_times_.front() > kDemandWindow) {
+    frame_times_.pop_front();
+  }
+  if (max_refresh_rate_ / 2 < kMinFrameRate) {
+    // The display has no lower rate worth asking for.
+    return std::nullopt;
+  }
+
+  // The content builds a frame on every vsync of the lowered rate.
+  if (preferred_frame_rate_ != kNoPreference &&
+      consecutive_frame_count_ >= kSaturatedFrameCount &&
+      !frame_times_.empty()) {
+    if (last_lower_time_ && now - *last_lower_time_ < lower_delay_ * 2) {
+      lower_delay_ = std::min(lower_delay_ * 2, kMaxLowerDelay);
+    } else {
+      lower_delay_ = kMinLowerDelay;
+    }
+    preferred_frame_rate_ = kNoPreference;
+    low_demand_start_time_.reset();
+    consecutive_frame_count_ = 0;
+    return preferred_frame_rate_;
+  }
+
+  const double demand = frame_times_.size() / kDemandWindow.ToSecondsF();
+  const float current_frame_rate = preferred_frame_rate_ == kNoPreference
+                                       ? max_refresh_rate_
+                                       : preferred_frame_rate_;
+  const float frame_rate = GetLowestFrameRateFor(demand);
+  if (frame_rate >= current_frame_rate) {
+    low_demand_start_time_.reset();
+    return std::nullopt;
+  }
+  if (!low_demand_start_time_) {
+    low_demand_start_time_ = now;
+  }
+  if (now - *low_demand_start_time_ < lower_delay_) {
+    return std::nullopt;
+  }
+
+  preferred_frame_rate_ = frame_rate;
+  last_lower_time_ = now;
+  low_demand_start_time_.reset();
+  consecutive_frame_count_ = 0;
+  return preferred_frame_rate_;
+}
+
+bool FrameRateHinter::HasPendingUpdate() const {
+  return low_demand_start_time_.has_value() || !frame_times_.empty();
+}
+
+float FrameRateHinter::GetLowestFrameRateFor(double demand) const {
+  float frame_rate = max_refresh_rate_;
+  for (int divisor = 2;; divisor++) {
+    const float lower_frame_rate = max_refresh_rate_ / divisor;
+    if (lower_frame_rate < kMinFrameRate ||
+        lower_frame_rate * kDemandTolerance < demand) {
+      return frame_rate;
+    }
+    frame_rate = lower_frame_rate;
+  }
+}
+
+}  // namespace flutter
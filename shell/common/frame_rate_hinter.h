@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_RATE_HINTER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_RATE_HINTER_H_
+
+#include <deque>
+#include <optional>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// Decides which refresh rate to ask the display for from how often frames
+/// are actually built, see |VsyncWaiter::SetPreferredFrameRate|.
+///
+/// While frames are built on every vsync, the content may want more frames
+/// than the display currently shows, so the hinter asks for the highest rate
+/// right away. Once fewer frames are built than a lower rate could show for
+/// long enough, it asks for that rate. When the content wants the high rate
+/// again soon after it was lowered, the time needed to lower it is doubled,
+/// which keeps content animating at a rate in between the two from making the
+/// display switch back and forth.
+///
+/// All methods must be called on the UI thread.
+class FrameRateHinter {
+ public:
+  /// The rate that lets the platform pick the refresh rate, which is the
+  /// highest one of the display.
+  static constexpr float kNoPreference = 0.0f;
+
+  /// The lowest rate asked for, even for static content, so that the first
+  /// frame of an animation isn't held back for long.
+  static constexpr float kMinFrameRate = 30.0f;
+
+  /// The frames built within this long are counted towards the demand.
+  static constexpr fml::TimeDelta kDemandWindow =
+      fml::TimeDelta::FromMilliseconds(500);
+
+  /// How long the demand must stay low before the rate is first lowered.
+  static constexpr fml::TimeDelta kMinLowerDelay =
+      fml::TimeDelta::FromSeconds(1);
+
+  /// The time needed to lower the rate doesn't grow past this.
+  static constexpr fml::TimeDelta kMaxLowerDelay =
+      fml::TimeDelta::FromSeconds(16);
+
+  /// The number of frames built on consecutive vsyncs after which the rate is
+  /// raised.
+  static constexpr size_t kSaturatedFrameCount = 3;
+
+  FrameRateHinter();
+
+  ~FrameRateHinter();
+
+  /// Records that a frame was built for the vsync at |vsync_start_time|,
+  /// whose interval is |vsync_interval|.
+  void OnBeginFrame(fml::TimePoint vsync_start_time,
+                    fml::TimeDelta vsync_interval);
+
+  /// Returns the rate to ask the display for if it changed, given that the
+  /// display currently refreshes at |display_refresh_rate|, or nothing.
+  std::optional<float> Update(fml::TimePoint now, float display_refresh_rate);
+
+  /// Whether |Update| may change the rate later without more frames being
+  /// built.
+  bool HasPendingUpdate() const;
+
+  float preferred_frame_rate() const { return preferred_frame_rate_; }
+
+ private:
+  std::deque<fml::TimePoint> frame_times_;
+  fml::TimePoint last_vsync_start_time_;
+  size_t consecutive_frame_count_ = 0;
+  // The highest refresh rate the display reported, which the platform falls
+  // back to without a preference.
+  float max_refresh_rate_ = 0.0f;
+  float preferred_frame_rate_ = kNoPreference;
+  std::optional<fml::TimePoint> low_demand_start_time_;
+  std::optional<fml::TimePoint> last_lower_time_;
+  fml::TimeDelta lower_delay_ = kMinLowerDelay;
+
+  // The lowest rate that is the refresh rate of the display divided by a whole
+  // number and still shows |demand| frames per second.
+  float GetLowestFrameRateFor(double demand) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameRateHinter);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_RATE_HINTER_H_
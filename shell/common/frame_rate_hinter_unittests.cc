@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_rate_hinter.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static constexpr float kDisplayRefreshRate = 120.0f;
+
+// Builds a frame on every |vsyncs_per_frame|th vsync of a 120Hz display for
+// |duration|, starting at |*now|, and returns the last rate the hinter asked
+// for, if any.
+static std::optional<float> BuildFrames(FrameRateHinter& hinter,
+                                        fml::TimePoint* now,
+                                        fml::TimeDelta duration,
+                                        int vsyncs_per_frame) {
+  const fml::TimeDelta interval =
+      fml::TimeDelta::FromSecondsF(1.0 / kDisplayRefreshRate);
+  const fml::TimePoint end = *now + duration;
+  std::optional<float> last_frame_rate;
+  for (int vsync = 0; *now < end; vsync++, *now = *now + interval) {
+    if (vsyncs_per_frame > 0 && vsync % vsyncs_per_frame == 0) {
+      hinter.OnBeginFrame(*now, interval);
+    }
+    std::optional<float> frame_rate =
+        hinter.Update(*now, kDisplayRefreshRate);
+    if (frame_rate) {
+      last_frame_rate = frame_rate;
+    }
+  }
+  return last_frame_rate;
+}
+
+TEST(FrameRateHinterTest, KeepsRateWhileSaturated) {
+  FrameRateHinter hinter;
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_FALSE(BuildFrames(hinter, &now, fml::TimeDelta::FromSeconds(5), 1));
+  EXPECT_EQ(hinter.preferred_frame_rate(), FrameRateHinter::kNoPreference);
+}
+
+TEST(FrameRateHinterTest, LowersRateAfterDelay) {
+  FrameRateHinter hinter;
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_FALSE(
+      BuildFrames(hinter, &now, fml::TimeDelta::FromMilliseconds(900), 3));
+  EXPECT_EQ(BuildFrames(hinter, &now, fml::TimeDelta::FromSeconds(1), 3),
+            40.0f);
+}
+
+TEST(FrameRateHinterTest, LowersRateToMinimumWhenIdle) {
+  FrameRateHinter hinter;
+  fml::TimePoint now = fml::TimePoint::Now();
+  BuildFrames(hinter, &now, fml::TimeDelta::FromMilliseconds(100), 1);
+  EXPECT_TRUE(hinter.HasPendingUpdate());
+  EXPECT_EQ(BuildFrames(hinter, &now, fml::TimeDelta::FromSeconds(2), 0),
+            FrameRateHinter::kMinFrameRate);
+  EXPECT_FALSE(hinter.HasPendingUpdate());
+}
+
+TEST(FrameRateHinterTest, BacksOffAfterRaisingRate) {
+  FrameRateHinter hinter;
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_EQ(BuildFrames(hinter, &now, fml::TimeDelta::FromSeconds(2), 0),
+            FrameRateHinter::kMinFrameRate);
+
+  // An animation starts right after the rate was lowered.
+  EXPECT_EQ(BuildFrames(hinter, &now, fml::TimeDelta::FromMilliseconds(50), 1),
+            FrameRateHinter::kNoPreference);
+
+  // Lowering the rate again now takes twice as long.
+  EXPECT_FALSE(
+      BuildFrames(hinter, &now, fml::TimeDelta::FromMilliseconds(1500), 0));
+  EXPECT_EQ(BuildFrames(hinter, &now, fml::TimeDelta::FromSeconds(1), 0),
+            FrameRateHinter::kMinFrameRate);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,521 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/sync_switch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/shell/common/layer_tree_recording.h"
+#include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+#ifdef SHELL_ENABLE_GL
+#include "flutter/shell/gpu/gpu_surface_gl.h"
+#include "flutter/testing/test_gl_surface.h"
+#endif  // SHELL_ENABLE_GL
+
+namespace flutter {
+
+namespace {
+
+// The environment variable naming a directory of recordings to replay on top
+// of the synthetic ones, one |LayerTreeRecording| per subdirectory.
+constexpr char kRecordingsDirectoryVariable[] = "FLUTTER_LAYER_TREE_RECORDINGS";
+
+enum class ReplayBackend {
+  kSoftware,
+#ifdef SHELL_ENABLE_GL
+  kGL,
+#endif  // SHELL_ENABLE_GL
+};
+
+using RecordingFactory = std::function<std::unique_ptr<LayerTreeRecording>()>;
+
+class SoftwareReplaySurface : public GPUSurfaceSoftwareDelegate {
+ public:
+  // |GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    if (!backing_store_ || backing_store_->width() != size.width() ||
+        backing_store_->height() != size.height()) {
+      backing_store_ = SkSurface::MakeRasterN32Premul(size.width(),
+                                                      size.height(), nullptr);
+    }
+    return backing_store_;
+  }
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return true;
+  }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+};
+
+#ifdef SHELL_ENABLE_GL
+class GLReplaySurface : public GPUSurfaceGLDelegate {
+ public:
+  explicit GLReplaySurface(SkISize size) : gl_surface_(size) {}
+
+  // |GPUSurfaceGLDelegate|
+  std::unique_ptr<GLContextResult> GLContextMakeCurrent() override {
+    return std::make_unique<GLContextDefaultResult>(gl_surface_.MakeCurrent());
+  }
+
+  // |GPUSurfaceGLDelegate|
+  bool GLContextClearCurrent() override { return gl_surface_.ClearCurrent(); }
+
+  // |GPUSurfaceGLDelegate|
+  bool GLContextPresent() override { return gl_surface_.Present(); }
+
+  // |GPUSurfaceGLDelegate|
+  intptr_t GLContextFBO() const override {
+    return gl_surface_.GetFramebuffer();
+  }
+
+  // |GPUSurfaceGLDelegate|
+  GLProcResolver GetGLProcResolver() const override {
+    return [surface = &gl_surface_](const char* name) -> void* {
+      return surface->GetProcAddress(name);
+    };
+  }
+
+  // |GPUSurfaceGLDelegate|
+  ExternalViewEmbedder* GetExternalViewEmbedder() override { return nullptr; }
+
+ private:
+  testing::TestGLSurface gl_surface_;
+};
+#endif  // SHELL_ENABLE_GL
+
+// Draws the frames of a recording through |Rasterizer::Draw| on a raster
+// thread of its own, the way the shell does.
+class FrameReplayer : public Rasterizer::Delegate {
+ public:
+  FrameReplayer(ReplayBackend backend, SkISize frame_size)
+      : thread_host_("io.flutter.bench.", ThreadHost::Type::GPU),
+        task_runners_("replay",
+                      thread_host_.raster_thread->GetTaskRunner(),
+                      thread_host_.raster_thread->GetTaskRunner(),
+                      thread_host_.raster_thread->GetTaskRunner(),
+                      thread_host_.raster_thread->GetTaskRunner()) {
+    unref_queue_ = fml::MakeRefCounted<SkiaUnrefQueue>(
+        task_runners_.GetRasterTaskRunner(), fml::TimeDelta::Zero());
+    RunOnRasterThread([&]() {
+      std::unique_ptr<Surface> surface;
+      switch (backend) {
+        case ReplayBackend::kSoftware:
+          software_surface_ = std::make_unique<SoftwareReplaySurface>();
+          surface = std::make_unique<GPUSurfaceSoftware>(
+              software_surface_.get(), true);
+          break;
+#ifdef SHELL_ENABLE_GL
+        case ReplayBackend::kGL:
+          gl_surface_ = std::make_unique<GLReplaySurface>(frame_size);
+          surface = std::make_unique<GPUSurfaceGL>(gl_surface_.get(), true);
+          break;
+#endif  // SHELL_ENABLE_GL
+      }
+      if (!surface || !surface->IsValid()) {
+        return;
+      }
+      rasterizer_ = std::make_unique<Rasterizer>(
+          *this, task_runners_, std::make_shared<fml::SyncSwitch>());
+      rasterizer_->Setup(std::move(surface));
+    });
+  }
+
+  ~FrameReplayer() {
+    RunOnRasterThread([&]() {
+      if (rasterizer_) {
+        rasterizer_->Teardown();
+      }
+      rasterizer_.reset();
+      software_surface_.reset();
+#ifdef SHELL_ENABLE_GL
+      gl_surface_.reset();
+#endif  // SHELL_ENABLE_GL
+    });
+  }
+
+  bool IsValid() const { return rasterizer_ != nullptr; }
+
+  // Rasterizes the frame at |index| and returns how long each phase took.
+  FrameTiming Draw(const LayerTreeRecording& recording, size_t index) {
+    auto layer_tree = recording.BuildLayerTree(index, unref_queue_);
+    const auto now = fml::TimePoint::Now();
+    target_time_ = now + fml::TimeDelta::FromMillisecondsF(
+                             fml::kDefaultFrameBudget.count());
+    layer_tree->RecordBuildTime(now, now, target_time_);
+
+    auto pipeline = fml::MakeRefCounted<Pipeline<LayerTree>>(1);
+    if (!pipeline->Produce().Complete(std::move(layer_tree))) {
+      return {};
+    }
+    RunOnRasterThread([&]() { rasterizer_->Draw(pipeline); });
+    return last_frame_timing_;
+  }
+
+  // |Rasterizer::Delegate|
+  void OnFrameRasterized(const FrameTiming& frame_timing) override {
+    last_frame_timing_ = frame_timing;
+  }
+
+  // |Rasterizer::Delegate|
+  fml::Milliseconds GetFrameBudget() override {
+    return fml::kDefaultFrameBudget;
+  }
+
+  // |Rasterizer::Delegate|
+  fml::TimePoint GetLatestFrameTargetTime() const override {
+    return target_time_;
+  }
+
+ private:
+  ThreadHost thread_host_;
+  TaskRunners task_runners_;
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  std::unique_ptr<SoftwareReplaySurface> software_surface_;
+#ifdef SHELL_ENABLE_GL
+  std::unique_ptr<GLReplaySurface> gl_surface_;
+#endif  // SHELL_ENABLE_GL
+  std::unique_ptr<Rasterizer> rasterizer_;
+  fml::TimePoint target_time_;
+  FrameTiming last_frame_timing_;
+
+  void RunOnRasterThread(const fml::closure& task) {
+    fml::AutoResetWaitableEvent latch;
+    task_runners_.GetRasterTaskRunner()->PostTask([&]() {
+      task();
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameReplayer);
+};
+
+sk_sp<SkPicture> RecordPicture(const SkRect& bounds,
+                               const std::function<void(SkCanvas*)>& draw) {
+  SkPictureRecorder recorder;
+  draw(recorder.beginRecording(bounds));
+  return recorder.finishRecordingAsPicture();
+}
+
+void DrawTextLines(SkCanvas* canvas,
+                   SkPoint origin,
+                   size_t line_count,
+                   SkScalar font_size) {
+  SkFont font;
+  font.setSize(font_size);
+  SkPaint paint;
+  paint.setColor(SK_ColorBLACK);
+  for (size_t i = 0; i < line_count; i++) {
+    auto blob = SkTextBlob::MakeFromString(
+        "The quick brown fox jumps over the lazy dog, again and again.", font);
+    canvas->drawTextBlob(blob, origin.x(),
+                         origin.y() + (i + 1) * font_size * 1.4f, paint);
+  }
+}
+
+LayerTreeRecording::Layer PictureLayerAt(size_t picture,
+                                         SkPoint offset,
+                                         bool is_complex = false) {
+  LayerTreeRecording::Layer layer;
+  layer.type = LayerTreeRecording::Layer::Type::kPicture;
+  layer.picture = picture;
+  layer.offset = offset;
+  layer.is_complex = is_complex;
+  return layer;
+}
+
+// A list of cards scrolling under a fixed app bar.
+std::unique_ptr<LayerTreeRecording> MakeScrollingRecording() {
+  constexpr SkScalar kItemHeight = 220;
+  constexpr size_t kItemCount = 40;
+  constexpr size_t kFrameCount = 120;
+  const SkISize frame_size = SkISize::Make(1080, 1920);
+  auto recording = std::make_unique<LayerTreeRecording>(frame_size, 2.75f);
+
+  std::vector<size_t> items;
+  for (size_t i = 0; i < kItemCount; i++) {
+    const SkRect bounds = SkRect::MakeWH(frame_size.width(), kItemHeight);
+    items.push_back(recording->AddPicture(
+        RecordPicture(bounds, [&bounds, i](SkCanvas* canvas) {
+          SkPaint paint;
+          paint.setAntiAlias(true);
+          paint.setColor(i % 2 ? 0xFFE3F2FD : 0xFFFFFFFF);
+          canvas->drawRRect(
+              SkRRect::MakeRectXY(bounds.makeInset(24, 12), 16, 16), paint);
+          paint.setColor(0xFF1E88E5);
+          canvas->drawCircle(110, kItemHeight / 2, 60, paint);
+          DrawTextLines(canvas, SkPoint::Make(200, 40), 3, 40);
+        })));
+  }
+  const size_t app_bar = recording->AddPicture(RecordPicture(
+      SkRect::MakeWH(frame_size.width(), 240), [&](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setColor(0xFF1565C0);
+        canvas->drawRect(SkRect::MakeWH(frame_size.width(), 240), paint);
+        DrawTextLines(canvas, SkPoint::Make(48, 120), 1, 64);
+      }));
+
+  for (size_t frame = 0; frame < kFrameCount; frame++) {
+    LayerTreeRecording::Layer list;
+    list.type = LayerTreeRecording::Layer::Type::kClipRect;
+    list.clip_rect = SkRect::MakeLTRB(0, 240, frame_size.width(),
+                                      frame_size.height());
+    LayerTreeRecording::Layer scroll;
+    scroll.type = LayerTreeRecording::Layer::Type::kTransform;
+    scroll.matrix = SkMatrix::MakeTrans(0, 240 - frame * 32.0f);
+    for (size_t i = 0; i < kItemCount; i++) {
+      scroll.children.push_back(
+          PictureLayerAt(items[i], SkPoint::Make(0, i * kItemHeight)));
+    }
+    list.children.push_back(std::move(scroll));
+
+    LayerTreeRecording::Layer root;
+    root.children.push_back(std::move(list));
+    root.children.push_back(PictureLayerAt(app_bar, SkPoint::Make(0, 0)));
+    recording->AddFrame(std::move(root));
+  }
+  return recording;
+}
+
+// A page sliding and fading in over another one.
+std::unique_ptr<LayerTreeRecording> MakeTransitionRecording() {
+  constexpr size_t kFrameCount = 60;
+  const SkISize frame_size = SkISize::Make(1080, 1920);
+  auto recording = std::make_unique<LayerTreeRecording>(frame_size, 2.75f);
+
+  const SkRect bounds = SkRect::Make(frame_size);
+  size_t pages[2];
+  for (size_t page = 0; page < 2; page++) {
+    pages[page] = recording->AddPicture(
+        RecordPicture(bounds, [&bounds, page](SkCanvas* canvas) {
+          SkPaint paint;
+          paint.setAntiAlias(true);
+          paint.setColor(page ? 0xFFFFF3E0 : 0xFFF1F8E9);
+          canvas->drawRect(bounds, paint);
+          for (int row = 0; row < 8; row++) {
+            for (int column = 0; column < 3; column++) {
+              paint.setColor(page ? 0xFFFB8C00 : 0xFF7CB342);
+              canvas->drawRRect(
+                  SkRRect::MakeRectXY(
+                      SkRect::MakeXYWH(48 + column * 340, 300 + row * 200,
+                                       300, 160),
+                      24, 24),
+                  paint);
+            }
+          }
+          DrawTextLines(canvas, SkPoint::Make(48, 40), 3, 56);
+        }));
+  }
+
+  for (size_t frame = 0; frame < kFrameCount; frame++) {
+    const float t = static_cast<float>(frame) / (kFrameCount - 1);
+
+    LayerTreeRecording::Layer incoming;
+    incoming.type = LayerTreeRecording::Layer::Type::kTransform;
+    incoming.matrix = SkMatrix::MakeTrans((1.0f - t) * frame_size.width(), 0);
+    LayerTreeRecording::Layer fade;
+    fade.type = LayerTreeRecording::Layer::Type::kOpacity;
+    fade.alpha = static_cast<SkAlpha>(255 * t);
+    fade.children.push_back(
+        PictureLayerAt(pages[1], SkPoint::Make(0, 0), true));
+    incoming.children.push_back(std::move(fade));
+
+    LayerTreeRecording::Layer outgoing;
+    outgoing.type = LayerTreeRecording::Layer::Type::kTransform;
+    outgoing.matrix = SkMatrix::MakeScale(1.0f - 0.1f * t);
+    outgoing.children.push_back(
+        PictureLayerAt(pages[0], SkPoint::Make(0, 0), true));
+
+    LayerTreeRecording::Layer root;
+    root.children.push_back(std::move(outgoing));
+    root.children.push_back(std::move(incoming));
+    recording->AddFrame(std::move(root));
+  }
+  return recording;
+}
+
+// A screen of paragraphs with a blinking cursor, so that only one small
+// picture changes from frame to frame.
+std::unique_ptr<LayerTreeRecording> MakeTextRecording() {
+  constexpr size_t kParagraphCount = 12;
+  constexpr SkScalar kParagraphHeight = 160;
+  constexpr size_t kFrameCount = 60;
+  const SkISize frame_size = SkISize::Make(1080, 1920);
+  auto recording = std::make_unique<LayerTreeRecording>(frame_size, 2.75f);
+
+  std::vector<size_t> paragraphs;
+  for (size_t i = 0; i < kParagraphCount; i++) {
+    const SkRect bounds = SkRect::MakeWH(frame_size.width(), kParagraphHeight);
+    paragraphs.push_back(recording->AddPicture(
+        RecordPicture(bounds, [](SkCanvas* canvas) {
+          DrawTextLines(canvas, SkPoint::Make(48, 0), 4, 32);
+        })));
+  }
+  size_t cursors[2];
+  for (size_t i = 0; i < 2; i++) {
+    cursors[i] = recording->AddPicture(
+        RecordPicture(SkRect::MakeWH(4, 48), [i](SkCanvas* canvas) {
+          SkPaint paint;
+          paint.setColor(i ? SK_ColorTRANSPARENT : SK_ColorBLUE);
+          canvas->drawRect(SkRect::MakeWH(4, 48), paint);
+        }));
+  }
+
+  for (size_t frame = 0; frame < kFrameCount; frame++) {
+    LayerTreeRecording::Layer root;
+    for (size_t i = 0; i < kParagraphCount; i++) {
+      root.children.push_back(PictureLayerAt(
+          paragraphs[i], SkPoint::Make(0, i * kParagraphHeight), true));
+    }
+    root.children.push_back(PictureLayerAt(cursors[(frame / 30) % 2],
+                                           SkPoint::Make(600, 1800)));
+    recording->AddFrame(std::move(root));
+  }
+  return recording;
+}
+
+}  // namespace
+
+// Replays the frames of a recording in a loop. The iteration time is the
+// time each frame spent in |Rasterizer::Draw|, which is then broken down into
+// the preroll and paint of its layer tree, and the flush of the frame to the
+// surface.
+static void BM_ReplayFrames(benchmark::State& state,
+                            ReplayBackend backend,
+                            RecordingFactory make_recording) {
+  auto recording = make_recording();
+  if (!recording || recording->GetFrameCount() == 0) {
+    state.SkipWithError("Could not load the recording.");
+    return;
+  }
+  FrameReplayer replayer(backend, recording->GetFrameSize());
+  if (!replayer.IsValid()) {
+    state.SkipWithError("Could not set up the surface.");
+    return;
+  }
+
+  fml::TimeDelta preroll, paint, flush;
+  size_t frame = 0;
+  while (state.KeepRunning()) {
+    FrameTiming timing =
+        replayer.Draw(*recording, frame++ % recording->GetFrameCount());
+    state.SetIterationTime((timing.Get(FrameTiming::kRasterFinish) -
+                            timing.Get(FrameTiming::kRasterStart))
+                               .ToSecondsF());
+    preroll = preroll + timing.GetPrerollDuration();
+    paint = paint + timing.GetPaintDuration();
+    flush = flush + timing.GetSubmitDuration();
+  }
+  const auto average = [](fml::TimeDelta total) {
+    return benchmark::Counter(total.ToMicrosecondsF(),
+                              benchmark::Counter::kAvgIterations);
+  };
+  state.counters["PrerollMicros"] = average(preroll);
+  state.counters["PaintMicros"] = average(paint);
+  state.counters["FlushMicros"] = average(flush);
+}
+
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  scrolling_software,
+                  ReplayBackend::kSoftware,
+                  MakeScrollingRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  transition_software,
+                  ReplayBackend::kSoftware,
+                  MakeTransitionRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  text_software,
+                  ReplayBackend::kSoftware,
+                  MakeTextRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+#ifdef SHELL_ENABLE_GL
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  scrolling_gl,
+                  ReplayBackend::kGL,
+                  MakeScrollingRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  transition_gl,
+                  ReplayBackend::kGL,
+                  MakeTransitionRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ReplayFrames,
+                  text_gl,
+                  ReplayBackend::kGL,
+                  MakeTextRecording)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+#endif  // SHELL_ENABLE_GL
+
+// Registers replays of the recordings found in the directory named by
+// |kRecordingsDirectoryVariable|, on each backend.
+static bool RegisterRecordedFrameBenchmarks() {
+  const char* path = std::getenv(kRecordingsDirectoryVariable);
+  if (path == nullptr) {
+    return false;
+  }
+  auto recordings = fml::OpenDirectory(path, false, fml::FilePermission::kRead);
+  if (!recordings.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the recordings in " << path << ".";
+    return false;
+  }
+  const std::string recordings_path = path;
+  fml::VisitFiles(recordings, [&recordings_path](const fml::UniqueFD& directory,
+                                                 const std::string& name) {
+    if (!fml::IsDirectory(directory, name.c_str())) {
+      return true;
+    }
+    // Recordings are only loaded when their benchmarks run.
+    RecordingFactory load = [recordings_path, name]() {
+      auto recordings = fml::OpenDirectory(recordings_path.c_str(), false,
+                                           fml::FilePermission::kRead);
+      return LayerTreeRecording::Load(fml::OpenDirectory(
+          recordings, name.c_str(), false, fml::FilePermission::kRead));
+    };
+    benchmark::RegisterBenchmark(
+        ("BM_ReplayFrames/" + name + "_software").c_str(), BM_ReplayFrames,
+        ReplayBackend::kSoftware, load)
+        ->UseManualTime()
+        ->Unit(benchmark::kMicrosecond);
+#ifdef SHELL_ENABLE_GL
+    benchmark::RegisterBenchmark(("BM_ReplayFrames/" + name + "_gl").c_str(),
+                                 BM_ReplayFrames, ReplayBackend::kGL, load)
+        ->UseManualTime()
+        ->Unit(benchmark::kMicrosecond);
+#endif  // SHELL_ENABLE_GL
+    return true;
+  });
+  return true;
+}
+
+[[maybe_unused]] static const bool recorded_frame_benchmarks_registered =
+    RegisterRecordedFrameBenchmarks();
+
+}  // namespace flutter
@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_time_predictor.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+// The percentile of the recent durations of a phase used as its prediction.
+static constexpr double kPredictionPercentile = 0.9;
+
+static fml::TimeDelta GetPercentile(std::vector<fml::TimeDelta> durations,
+                                    double percentile) {
+  const size_t index = std::min(
+      durations.size() - 1, static_cast<size_t>(durations.size() * percentile));
+  std::nth_element(durations.begin(), durations.begin() + index,
+                   durations.end());
+  return durations[index];
+}
+
+FrameTimePredictor::FrameTimePredictor() {
+  build_durations_.reserve(kSampleCount);
+  raster_durations_.reserve(kSampleCount);
+}
+
+FrameTimePredictor::~FrameTimePredictor() = default;
+
+void FrameTimePredictor::AddFrame(const FrameTiming& timing) {
+  const fml::TimeDelta build_duration =
+      timing.Get(FrameTiming::kBuildFinish) -
+      timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta raster_duration =
+      timing.Get(FrameTiming::kRasterFinish) -
+      timing.Get(FrameTiming::kBuildFinish);
+  if (build_duration < fml::TimeDelta::Zero() ||
+      raster_duration < fml::TimeDelta::Zero()) {
+    return;
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (build_durations_.size() < kSampleCount) {
+    build_durations_.push_back(build_duration);
+    raster_durations_.push_back(raster_duration);
+  } else {
+    build_durations_[next_sample_] = build_duration;
+    raster_durations_[next_sample_] = raster_duration;
+  }
+  next_sample_ = (next_sample_ + 1) % kSampleCount;
+}
+
+std::optional<fml::TimeDelta> FrameTimePredictor::PredictFrameDuration()
+    const {
+  std::vector<fml::TimeDelta> build_durations;
+  std::vector<fml::TimeDelta> raster_durations;
+  {
+    std::scoped_lock lock(mutex_);
+    if (build_durations_.size() < kMinSampleCount) {
+      return std::nullopt;
+    }
+    build_durations = build_durations_;
+    raster_durations = raster_durations_;
+  }
+  return GetPercentile(std::move(build_durations), kPredictionPercentile) +
+         GetPercentile(std::move(raster_durations), kPredictionPercentile);
+}
+
+}  // namespace flutter
@@ -0,0 +1,58 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
+
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+/// Predicts how long the next frame takes from the start of its build on the
+/// UI thread to the end of its rasterization, from the timings of recent
+/// frames.
+///
+/// Frames are added on the raster thread and predictions are made on the UI
+/// thread.
+class FrameTimePredictor {
+ public:
+  /// The number of recent frames predictions are made from.
+  static constexpr size_t kSampleCount = 32;
+
+  /// The number of frames needed before predictions are made.
+  static constexpr size_t kMinSampleCount = 8;
+
+  FrameTimePredictor();
+
+  ~FrameTimePredictor();
+
+  void AddFrame(const FrameTiming& timing);
+
+  /// A duration that the build and raster phases of the next frame are likely
+  /// to complete in, or nothing if not enough frames have been added yet.
+  ///
+  /// Each phase is predicted with a high percentile of its recent durations
+  /// rather than their average, as finishing a frame late costs much more
+  /// than finishing it early. The raster phase includes the time the layer
+  /// tree waited for the raster thread.
+  std::optional<fml::TimeDelta> PredictFrameDuration() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<fml::TimeDelta> build_durations_;
+  std::vector<fml::TimeDelta> raster_durations_;
+  size_t next_sample_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimePredictor);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
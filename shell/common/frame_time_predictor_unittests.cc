@@ -0,0 +1,57 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_time_predictor.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static FrameTiming MakeTiming(int64_t build_ms, int64_t raster_ms) {
+  const fml::TimePoint start = fml::TimePoint::Now();
+  const fml::TimePoint build_finish =
+      start + fml::TimeDelta::FromMilliseconds(build_ms);
+  FrameTiming timing;
+  timing.Set(FrameTiming::kBuildStart, start);
+  timing.Set(FrameTiming::kBuildFinish, build_finish);
+  timing.Set(FrameTiming::kRasterStart, build_finish);
+  timing.Set(FrameTiming::kRasterFinish,
+             build_finish + fml::TimeDelta::FromMilliseconds(raster_ms));
+  return timing;
+}
+
+TEST(FrameTimePredictorTest, NeedsEnoughFrames) {
+  FrameTimePredictor predictor;
+  for (size_t i = 1; i < FrameTimePredictor::kMinSampleCount; i++) {
+    predictor.AddFrame(MakeTiming(2, 3));
+    ASSERT_FALSE(predictor.PredictFrameDuration());
+  }
+  predictor.AddFrame(MakeTiming(2, 3));
+  ASSERT_TRUE(predictor.PredictFrameDuration());
+  ASSERT_EQ(predictor.PredictFrameDuration()->ToMilliseconds(), 5);
+}
+
+TEST(FrameTimePredictorTest, PredictsAHighPercentile) {
+  FrameTimePredictor predictor;
+  for (size_t i = 0; i < FrameTimePredictor::kSampleCount; i++) {
+    // One frame in eight is slow to rasterize.
+    predictor.AddFrame(MakeTiming(2, i % 8 == 0 ? 10 : 3));
+  }
+  ASSERT_EQ(predictor.PredictFrameDuration()->ToMilliseconds(), 12);
+}
+
+TEST(FrameTimePredictorTest, ForgetsOldFrames) {
+  FrameTimePredictor predictor;
+  for (size_t i = 0; i < FrameTimePredictor::kSampleCount; i++) {
+    predictor.AddFrame(MakeTiming(8, 8));
+  }
+  for (size_t i = 0; i < FrameTimePredictor::kSampleCount; i++) {
+    predictor.AddFrame(MakeTiming(1, 1));
+  }
+  ASSERT_EQ(predictor.PredictFrameDuration()->ToMilliseconds(), 2);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_histograms.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+static int64_t GetPercentile(const std::vector<int64_t>& sorted_values,
+                             double percentile) {
+  const size_t index =
+      std::min(sorted_values.size() - 1,
+               static_cast<size_t>(sorted_values.size() * percentile));
+  return sorted_values[index];
+}
+
+const char* FrameTimingHistograms::GetMetricName(Metric metric) {
+  switch (metric) {
+    case kVsyncLatency:
+      return "vsyncLatencyMicros";
+    case kBuild:
+      return "buildMicros";
+    case kQueueDelay:
+      return "queueDelayMicros";
+    case kPreroll:
+      return "prerollMicros";
+    case kPaint:
+      return "paintMicros";
+    case kSubmit:
+      return "submitMicros";
+    case kRaster:
+      return "rasterMicros";
+    case kGpuRaster:
+      return "gpuRasterMicros";
+    case kRasterCacheHits:
+      return "rasterCacheHits";
+    case kRasterCacheMisses:
+      return "rasterCacheMisses";
+    case kMetricCount:
+      break;
+  }
+  return "unknown";
+}
+
+void FrameTimingHistograms::Samples::Add(int64_t value) {
+  if (values.size() < kSampleCount) {
+    values.push_back(value);
+  } else {
+    values[next] = value;
+  }
+  next = (next + 1) % kSampleCount;
+}
+
+FrameTimingHistograms::FrameTimingHistograms() {
+  for (auto& samples : samples_) {
+    samples.values.reserve(kSampleCount);
+  }
+}
+
+FrameTimingHistograms::~FrameTimingHistograms() = default;
+
+void FrameTimingHistograms::AddFrame(const FrameTiming& timing) {
+  auto micros = [](fml::TimeDelta duration) {
+    return std::max<int64_t>(duration.ToMicroseconds(), 0);
+  };
+  const fml::TimePoint build_start = timing.Get(FrameTiming::kBuildStart);
+  const fml::TimePoint build_finish = timing.Get(FrameTiming::kBuildFinish);
+  const fml::TimePoint raster_start = timing.Get(FrameTiming::kRasterStart);
+  const fml::TimePoint raster_finish = timing.Get(FrameTiming::kRasterFinish);
+
+  std::scoped_lock lock(mutex_);
+  frame_count_++;
+  if (timing.GetVsyncStart() != fml::TimePoint()) {
+    samples_[kVsyncLatency].Add(micros(build_start - timing.GetVsyncStart()));
+  }
+  samples_[kBuild].Add(micros(build_finish - build_start));
+  samples_[kQueueDelay].Add(micros(raster_start - build_finish));
+  samples_[kPreroll].Add(micros(timing.GetPrerollDuration()));
+  samples_[kPaint].Add(micros(timing.GetPaintDuration()));
+  samples_[kSubmit].Add(micros(timing.GetSubmitDuration()));
+  samples_[kRaster].Add(micros(raster_finish - raster_start));
+  if (timing.GetGpuRasterDuration() > fml::TimeDelta::Zero()) {
+    samples_[kGpuRaster].Add(micros(timing.GetGpuRasterDuration()));
+  }
+  samples_[kRasterCacheHits].Add(timing.GetRasterCacheHitCount());
+  samples_[kRasterCacheMisses].Add(timing.GetRasterCacheMissCount());
+}
+
+size_t FrameTimingHistograms::GetFrameCount() const {
+  std::scoped_lock lock(mutex_);
+  return frame_count_;
+}
+
+std::array<FrameTimingHistograms::Summary, FrameTimingHistograms::kMetricCount>
+FrameTimingHistograms::Summarize() const {
+  std::array<std::vector<int64_t>, kMetricCount> values;
+  {
+    std::scoped_lock lock(mutex_);
+    for (size_t i = 0; i < kMetricCount; i++) {
+      values[i] = samples_[i].values;
+    }
+  }
+
+  std::array<Summary, kMetricCount> summaries;
+  for (size_t i = 0; i < kMetricCount; i++) {
+    std::vector<int64_t>& sorted_values = values[i];
+    if (sorted_values.empty()) {
+      continue;
+    }
+    std::sort(sorted_values.begin(), sorted_values.end());
+    Summary& summary = summaries[i];
+    summary.sample_count = sorted_values.size();
+    summary.p50 = GetPercentile(sorted_values, 0.5);
+    summary.p90 = GetPercentile(sorted_values, 0.9);
+    summary.p99 = GetPercentile(sorted_values, 0.99);
+    summary.max = sorted_values.back();
+  }
+  return summaries;
+}
+
+}  // namespace flutter
@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+/// Aggregates the timings of recent frames into percentiles of each part of a
+/// frame, so that they can be collected without recording a timeline.
+///
+/// Frames are added on the raster thread, summaries can be requested on any
+/// thread.
+class FrameTimingHistograms {
+ public:
+  /// The number of recent frames the percentiles are computed from.
+  static constexpr size_t kSampleCount = 300;
+
+  enum Metric {
+    // From the vsync to the start of the build on the UI thread. Only sampled
+    // from frames started by a vsync.
+    kVsyncLatency,
+    kBuild,
+    // From the end of the build to the start of the raster phase.
+    kQueueDelay,
+    kPreroll,
+    kPaint,
+    kSubmit,
+    kRaster,
+    // Only sampled from frames that measured it, see
+    // |FrameTiming::GetGpuRasterDuration|.
+    kGpuRaster,
+    kRasterCacheHits,
+    kRasterCacheMisses,
+    kMetricCount,
+  };
+
+  /// The name of |metric| in service protocol responses. Durations are in
+  /// microseconds.
+  static const char* GetMetricName(Metric metric);
+
+  struct Summary {
+    size_t sample_count = 0;
+    int64_t p50 = 0;
+    int64_t p90 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+  };
+
+  FrameTimingHistograms();
+
+  ~FrameTimingHistograms();
+
+  void AddFrame(const FrameTiming& timing);
+
+  /// The number of frames added so far, including the ones that aren't
+  /// sampled anymore.
+  size_t GetFrameCount() const;
+
+  /// The percentiles of each metric, indexed by |Metric|.
+  std::array<Summary, kMetricCount> Summarize() const;
+
+ private:
+  struct Samples {
+    std::vector<int64_t> values;
+    size_t next = 0;
+
+    void Add(int64_t value);
+  };
+
+  mutable std::mutex mutex_;
+  std::array<Samples, kMetricCount> samples_;
+  size_t frame_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistograms);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
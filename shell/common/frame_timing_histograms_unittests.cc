@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_histograms.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static FrameTiming MakeTiming(int64_t build_ms, int64_t raster_ms) {
+  const fml::TimePoint vsync = fml::TimePoint::Now();
+  const fml::TimePoint start = vsync + fml::TimeDelta::FromMilliseconds(1);
+  const fml::TimePoint build_finish =
+      start + fml::TimeDelta::FromMilliseconds(build_ms);
+  const fml::TimePoint raster_start =
+      build_finish + fml::TimeDelta::FromMilliseconds(2);
+  FrameTiming timing;
+  timing.SetVsyncStart(vsync);
+  timing.Set(FrameTiming::kBuildStart, start);
+  timing.Set(FrameTiming::kBuildFinish, build_finish);
+  timing.Set(FrameTiming::kRasterStart, raster_start);
+  timing.Set(FrameTiming::kRasterFinish,
+             raster_start + fml::TimeDelta::FromMilliseconds(raster_ms));
+  timing.SetPrerollDuration(fml::TimeDelta::FromMicroseconds(raster_ms * 100));
+  timing.SetRasterCacheCounts(3, 1);
+  return timing;
+}
+
+TEST(FrameTimingHistogramsTest, SummarizesEachMetric) {
+  FrameTimingHistograms histograms;
+  for (int64_t i = 1; i <= 100; i++) {
+    histograms.AddFrame(MakeTiming(i, 2 * i));
+  }
+  EXPECT_EQ(histograms.GetFrameCount(), 100u);
+
+  auto summaries = histograms.Summarize();
+  const auto& build = summaries[FrameTimingHistograms::kBuild];
+  EXPECT_EQ(build.sample_count, 100u);
+  EXPECT_EQ(build.p50, 51000);
+  EXPECT_EQ(build.p90, 91000);
+  EXPECT_EQ(build.p99, 100000);
+  EXPECT_EQ(build.max, 100000);
+
+  EXPECT_EQ(summaries[FrameTimingHistograms::kRaster].p50, 102000);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kPreroll].p50, 10200);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kVsyncLatency].max, 1000);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kQueueDelay].max, 2000);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kRasterCacheHits].p99, 3);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kRasterCacheMisses].p99, 1);
+
+  // No frame measured its GPU time.
+  EXPECT_EQ(summaries[FrameTimingHistograms::kGpuRaster].sample_count, 0u);
+}
+
+TEST(FrameTimingHistogramsTest, ForgetsOldFrames) {
+  FrameTimingHistograms histograms;
+  for (size_t i = 0; i < FrameTimingHistograms::kSampleCount; i++) {
+    histograms.AddFrame(MakeTiming(20, 20));
+  }
+  for (size_t i = 0; i < FrameTimingHistograms::kSampleCount; i++) {
+    histograms.AddFrame(MakeTiming(1, 1));
+  }
+  EXPECT_EQ(histograms.GetFrameCount(),
+            2 * FrameTimingHistograms::kSampleCount);
+
+  auto summaries = histograms.Summarize();
+  EXPECT_EQ(summaries[FrameTimingHistograms::kBuild].sample_count,
+            FrameTimingHistograms::kSampleCount);
+  EXPECT_EQ(summaries[FrameTimingHistograms::kBuild].max, 1000);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/testing/testing.h"
 
@@ -412,5 +413,144 @@ TEST_F(ShellTest, CanCorrectlySynthesizePointerPacket) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+// Records the packets dispatched by a PointerDataDispatcher, and lets the test
+// decide when VSYNC happens.
+class TestDispatcherDelegate : public PointerDataDispatcher::Delegate {
+ public:
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    const auto* data =
+        reinterpret_cast<const PointerData*>(packet->data().data());
+    dispatched_.emplace_back(
+        data, data + packet->data().size() / sizeof(PointerData));
+  }
+
+  void ScheduleSecondaryVsyncCallback(const fml::closure& callback) override {
+    vsync_callback_ = callback;
+  }
+
+  void FireVsync() {
+    fml::closure callback = std::move(vsync_callback_);
+    vsync_callback_ = nullptr;
+    if (callback) {
+      callback();
+    }
+  }
+
+  bool IsVsyncScheduled() const { return vsync_callback_ != nullptr; }
+
+  std::vector<std::vector<PointerData>> dispatched_;
+
+ private:
+  fml::closure vsync_callback_;
+};
+
+// Creates a touch event for device 0 at |time_stamp| microseconds.
+static std::unique_ptr<PointerDataPacket> CreateTouchPacket(
+    PointerData::Change change,
+    int64_t time_stamp,
+    double x) {
+  PointerData data;
+  CreateSimulatedPointerData(data, change, x, 0.0);
+  data.time_stamp = time_stamp;
+  auto packet = std::make_unique<PointerDataPacket>(1);
+  packet->SetPointerData(0, data);
+  return packet;
+}
+
+// Creates a ResamplingPointerDataDispatcher whose clock reads |*now|
+// microseconds.
+static std::unique_ptr<ResamplingPointerDataDispatcher>
+CreateResamplingDispatcher(PointerDataDispatcher::Delegate& delegate,
+                           const int64_t* now) {
+  return std::make_unique<ResamplingPointerDataDispatcher>(
+      delegate, ResamplingPointerDataDispatcher::kDefaultResampleLatency,
+      [now] {
+        return fml::TimePoint::FromEpochDelta(
+            fml::TimeDelta::FromMicroseconds(*now));
+      });
+}
+
+TEST(ResamplingPointerDataDispatcherTest, InterpolatesToSampleTime) {
+  TestDispatcherDelegate delegate;
+  int64_t now = 0;
+  auto dispatcher = CreateResamplingDispatcher(delegate, &now);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 0, 0.0), 1);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 8000, 8.0), 2);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 16000, 16.0), 3);
+  EXPECT_TRUE(delegate.dispatched_.empty());
+
+  // The sample time is 5ms before the VSYNC, between the last two moves.
+  now = 15000;
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_.size(), 1u);
+  ASSERT_EQ(delegate.dispatched_[0].size(), 1u);
+  EXPECT_EQ(delegate.dispatched_[0][0].time_stamp, 10000);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_[0][0].physical_x, 10.0);
+
+  // The last move is still pending for the next VSYNC.
+  EXPECT_TRUE(delegate.IsVsyncScheduled());
+  now = 21000;
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_.size(), 2u);
+  EXPECT_EQ(delegate.dispatched_[1][0].time_stamp, 16000);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_[1][0].physical_x, 16.0);
+  EXPECT_FALSE(delegate.IsVsyncScheduled());
+}
+
+TEST(ResamplingPointerDataDispatcherTest, LimitsExtrapolation) {
+  TestDispatcherDelegate delegate;
+  int64_t now = 0;
+  auto dispatcher = CreateResamplingDispatcher(delegate, &now);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kDown, 0, 0.0), 1);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 4000, 4.0), 2);
+
+  // The down is dispatched immediately, and extrapolated from by no more than
+  // half the time between it and the move.
+  ASSERT_EQ(delegate.dispatched_.size(), 1u);
+  now = 15000;
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_.size(), 2u);
+  EXPECT_EQ(delegate.dispatched_[1][0].time_stamp, 6000);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_[1][0].physical_x, 6.0);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, KeepsMovesAfterSampleTime) {
+  TestDispatcherDelegate delegate;
+  int64_t now = 0;
+  auto dispatcher = CreateResamplingDispatcher(delegate, &now);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 12000, 12.0), 1);
+
+  now = 15000;
+  delegate.FireVsync();
+  EXPECT_TRUE(delegate.dispatched_.empty());
+  EXPECT_TRUE(delegate.IsVsyncScheduled());
+}
+
+TEST(ResamplingPointerDataDispatcherTest, DispatchesPendingMovesBeforeUp) {
+  TestDispatcherDelegate delegate;
+  int64_t now = 0;
+  auto dispatcher = CreateResamplingDispatcher(delegate, &now);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kMove, 1000, 1.0), 1);
+  dispatcher->DispatchPacket(
+      CreateTouchPacket(PointerData::Change::kUp, 2000, 2.0), 2);
+
+  ASSERT_EQ(delegate.dispatched_.size(), 1u);
+  ASSERT_EQ(delegate.dispatched_[0].size(), 2u);
+  EXPECT_EQ(delegate.dispatched_[0][0].change, PointerData::Change::kMove);
+  EXPECT_EQ(delegate.dispatched_[0][1].change, PointerData::Change::kUp);
+
+  now = 15000;
+  delegate.FireVsync();
+  EXPECT_EQ(delegate.dispatched_.size(), 1u);
+}
+
 }  // namespace testing
 }  // namespace flutter
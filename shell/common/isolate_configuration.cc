@@ -6,6 +6,7 @@
 
 #include "flutter/fml/make_copyable.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/kernel_mapping_cache.h"
 
 namespace flutter {
 
@@ -38,7 +39,7 @@ class AppSnapshotIsolateConfiguration final : public IsolateConfiguration {
 
 class KernelIsolateConfiguration : public IsolateConfiguration {
  public:
-  KernelIsolateConfiguration(std::unique_ptr<const fml::Mapping> kernel)
+  KernelIsolateConfiguration(std::shared_ptr<const fml::Mapping> kernel)
       : kernel_(std::move(kernel)) {}
 
   // |IsolateConfiguration|
@@ -50,7 +51,7 @@ class KernelIsolateConfiguration : public IsolateConfiguration {
   }
 
  private:
-  std::unique_ptr<const fml::Mapping> kernel_;
+  std::shared_ptr<const fml::Mapping> kernel_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(KernelIsolateConfiguration);
 };
@@ -58,7 +59,7 @@ class KernelIsolateConfiguration : public IsolateConfiguration {
 class KernelListIsolateConfiguration final : public IsolateConfiguration {
  public:
   KernelListIsolateConfiguration(
-      std::vector<std::future<std::unique_ptr<const fml::Mapping>>>
+      std::vector<std::future<std::shared_ptr<const fml::Mapping>>>
           kernel_pieces)
       : kernel_pieces_(std::move(kernel_pieces)) {}
 
@@ -81,7 +82,7 @@ class KernelListIsolateConfiguration final : public IsolateConfiguration {
   }
 
  private:
-  std::vector<std::future<std::unique_ptr<const fml::Mapping>>> kernel_pieces_;
+  std::vector<std::future<std::shared_ptr<const fml::Mapping>>> kernel_pieces_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(KernelListIsolateConfiguration);
 };
@@ -113,21 +114,25 @@ static std::vector<std::string> ParseKernelListPaths(
   return kernel_pieces_paths;
 }
 
-static std::vector<std::future<std::unique_ptr<const fml::Mapping>>>
+static std::vector<std::future<std::shared_ptr<const fml::Mapping>>>
 PrepareKernelMappings(std::vector<std::string> kernel_pieces_paths,
                       std::shared_ptr<AssetManager> asset_manager,
                       fml::RefPtr<fml::TaskRunner> io_worker) {
   FML_DCHECK(asset_manager);
-  std::vector<std::future<std::unique_ptr<const fml::Mapping>>> fetch_futures;
+  std::vector<std::future<std::shared_ptr<const fml::Mapping>>> fetch_futures;
 
   for (const auto& kernel_pieces_path : kernel_pieces_paths) {
-    std::promise<std::unique_ptr<const fml::Mapping>> fetch_promise;
+    std::promise<std::shared_ptr<const fml::Mapping>> fetch_promise;
     fetch_futures.push_back(fetch_promise.get_future());
+    // The pieces that didn't change since the last run are checked against
+    // the cached ones on the worker too, while the isolate loads the pieces
+    // before them.
     auto fetch_task =
         fml::MakeCopyable([asset_manager, kernel_pieces_path,
                            fetch_promise = std::move(fetch_promise)]() mutable {
-          fetch_promise.set_value(
-              asset_manager->GetAsMapping(kernel_pieces_path));
+          fetch_promise.set_value(KernelMappingCache::GetInstance().Get(
+              kernel_pieces_path,
+              asset_manager->GetAsMapping(kernel_pieces_path)));
         });
     // Fulfill the promise on the worker if one is available or the current
     // thread if one is not.
@@ -170,7 +175,8 @@ std::unique_ptr<IsolateConfiguration> IsolateConfiguration::InferFromSettings(
     std::unique_ptr<fml::Mapping> kernel =
         asset_manager->GetAsMapping(settings.application_kernel_asset);
     if (kernel) {
-      return CreateForKernel(std::move(kernel));
+      return CreateForKernel(settings.application_kernel_asset,
+                             std::move(kernel));
     }
   }
 
@@ -202,11 +208,18 @@ std::unique_ptr<IsolateConfiguration> IsolateConfiguration::CreateForKernel(
   return std::make_unique<KernelIsolateConfiguration>(std::move(kernel));
 }
 
+std::unique_ptr<IsolateConfiguration> IsolateConfiguration::CreateForKernel(
+    const std::string& name,
+    std::unique_ptr<const fml::Mapping> kernel) {
+  return std::make_unique<KernelIsolateConfiguration>(
+      KernelMappingCache::GetInstance().Get(name, std::move(kernel)));
+}
+
 std::unique_ptr<IsolateConfiguration> IsolateConfiguration::CreateForKernelList(
     std::vector<std::unique_ptr<const fml::Mapping>> kernel_pieces) {
-  std::vector<std::future<std::unique_ptr<const fml::Mapping>>> pieces;
+  std::vector<std::future<std::shared_ptr<const fml::Mapping>>> pieces;
   for (auto& piece : kernel_pieces) {
-    std::promise<std::unique_ptr<const fml::Mapping>> promise;
+    std::promise<std::shared_ptr<const fml::Mapping>> promise;
     pieces.push_back(promise.get_future());
     promise.set_value(std::move(piece));
   }
@@ -214,7 +227,7 @@ std::unique_ptr<IsolateConfiguration> IsolateConfiguration::CreateForKernelList(
 }
 
 std::unique_ptr<IsolateConfiguration> IsolateConfiguration::CreateForKernelList(
-    std::vector<std::future<std::unique_ptr<const fml::Mapping>>>
+    std::vector<std::future<std::shared_ptr<const fml::Mapping>>>
         kernel_pieces) {
   return std::make_unique<KernelListIsolateConfiguration>(
       std::move(kernel_pieces));
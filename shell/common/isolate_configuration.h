@@ -87,7 +87,7 @@ class IsolateConfiguration {
   /// @return     A JIT isolate configuration.
   ///
   static std::unique_ptr<IsolateConfiguration> CreateForKernelList(
-      std::vector<std::future<std::unique_ptr<const fml::Mapping>>>
+      std::vector<std::future<std::shared_ptr<const fml::Mapping>>>
           kernel_pieces);
 
   //----------------------------------------------------------------------------
@@ -105,6 +105,24 @@ class IsolateConfiguration {
   static std::unique_ptr<IsolateConfiguration> CreateForKernel(
       std::unique_ptr<const fml::Mapping> kernel);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a JIT isolate configuration using the kernel snapshot
+  ///             loaded from the given path or asset. If an isolate of the
+  ///             process was already prepared from a kernel with the same
+  ///             contents loaded from there, that kernel is used instead and
+  ///             the one given is released.
+  ///
+  /// @see        KernelMappingCache
+  ///
+  /// @param[in]  name    The path or asset name the kernel was loaded from.
+  /// @param[in]  kernel  The kernel snapshot.
+  ///
+  /// @return     A JIT isolate configuration.
+  ///
+  static std::unique_ptr<IsolateConfiguration> CreateForKernel(
+      const std::string& name,
+      std::unique_ptr<const fml::Mapping> kernel);
+
   //----------------------------------------------------------------------------
   /// @brief      Creates a JIT isolate configuration using the specified
   ///              snapshots. This is a convenience method for the
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/jank_watchdog.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_ring_buffer.h"
+
+namespace flutter {
+
+JankWatchdog::JankWatchdog(std::string directory,
+                           fml::TimeDelta budget,
+                           size_t slow_frame_count,
+                           fml::TimeDelta interval)
+    : directory_(std::move(directory)),
+      budget_(budget),
+      slow_frame_count_(slow_frame_count),
+      interval_(interval) {}
+
+JankWatchdog::~JankWatchdog() = default;
+
+bool JankWatchdog::IsSlow(const FrameTiming& timing,
+                          fml::TimeDelta frame_budget) const {
+  const fml::TimeDelta budget =
+      budget_ > fml::TimeDelta::Zero() ? budget_ : frame_budget;
+  const fml::TimeDelta build = timing.Get(FrameTiming::kBuildFinish) -
+                               timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta raster = timing.Get(FrameTiming::kRasterFinish) -
+                                timing.Get(FrameTiming::kRasterStart);
+  return build > budget || raster > budget;
+}
+
+std::optional<JankWatchdog::Capture> JankWatchdog::OnFrameRasterized(
+    const FrameTiming& timing,
+    fml::TimeDelta frame_budget) {
+  const bool slow = IsSlow(timing, frame_budget);
+  window_.emplace_back(timing, slow);
+  if (window_.size() > kWindowFrameCount) {
+    window_.pop_front();
+  }
+
+  // Only a slow frame triggers a capture, so that it is the frame captured.
+  if (capture_count_ == kMaxCaptures || !slow) {
+    return std::nullopt;
+  }
+  const size_t slow_frames =
+      std::count_if(window_.begin(), window_.end(),
+                    [](const auto& frame) { return frame.second; });
+  if (slow_frames <= slow_frame_count_) {
+    return std::nullopt;
+  }
+  const fml::TimePoint now = timing.Get(FrameTiming::kRasterFinish);
+  if (last_capture_time_ && now - *last_capture_time_ < interval_) {
+    return std::nullopt;
+  }
+
+  last_capture_time_ = now;
+  capture_count_++;
+  Capture capture;
+  capture.directory = directory_;
+  capture.name =
+      "jank_" + std::to_string(now.ToEpochDelta().ToMilliseconds());
+  std::vector<FrameTiming> timings;
+  timings.reserve(window_.size());
+  for (const auto& frame : window_) {
+    timings.push_back(frame.first);
+  }
+  capture.frame_timings = DescribeFrameTimings(timings);
+  window_.clear();
+  return capture;
+}
+
+bool JankWatchdog::WriteCapture(const Capture& capture,
+                                const fml::Mapping* picture) {
+  TRACE_EVENT0("flutter", "JankWatchdog::WriteCapture");
+  auto directory = fml::OpenDirectory(capture.directory.c_str(), true,
+                                      fml::FilePermission::kReadWrite);
+  if (!directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the jank capture directory "
+                   << capture.directory << ".";
+    return false;
+  }
+  auto capture_directory = fml::OpenDirectory(
+      directory, capture.name.c_str(), true, fml::FilePermission::kReadWrite);
+  if (!capture_directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not create the jank capture " << capture.name
+                   << ".";
+    return false;
+  }
+
+  bool written = fml::WriteAtomically(
+      capture_directory, "frame_timings.json",
+      fml::DataMapping(capture.frame_timings));
+  if (picture) {
+    written &= fml::WriteAtomically(capture_directory, "frame.skp", *picture);
+  }
+  if (fml::tracing::TraceRingBuffer::IsEnabled()) {
+    written &= fml::WriteAtomically(
+        capture_directory, "trace.json",
+        fml::DataMapping(fml::tracing::TraceRingBuffer::ExportChromeJSON()));
+  }
+  if (!written) {
+    FML_LOG(ERROR) << "Could not write the jank capture " << capture.name
+                   << ".";
+    return false;
+  }
+  FML_LOG(INFO) << "Wrote the jank capture " << capture.name << " to "
+                << capture.directory << ".";
+  return true;
+}
+
+std::string JankWatchdog::DescribeFrameTimings(
+    const std::vector<FrameTiming>& timings) {
+  auto micros = [](fml::TimePoint point) {
+    return point.ToEpochDelta().ToMicroseconds();
+  };
+  std::ostringstream stream;
+  stream << "[";
+  for (auto i = timings.begin(); i != timings.end(); ++i) {
+    const FrameTiming& timing = *i;
+    if (i != timings.begin()) {
+      stream << ",";
+    }
+    stream << "{\"vsyncStart\":" << micros(timing.GetVsyncStart())
+           << ",\"buildStart\":" << micros(timing.Get(FrameTiming::kBuildStart))
+           << ",\"buildFinish\":"
+           << micros(timing.Get(FrameTiming::kBuildFinish))
+           << ",\"rasterStart\":"
+           << micros(timing.Get(FrameTiming::kRasterStart))
+           << ",\"rasterFinish\":"
+           << micros(timing.Get(FrameTiming::kRasterFinish))
+           << ",\"preroll\":" << timing.GetPrerollDuration().ToMicroseconds()
+           << ",\"paint\":" << timing.GetPaintDuration().ToMicroseconds()
+           << ",\"submit\":" << timing.GetSubmitDuration().ToMicroseconds()
+           << ",\"gpuRaster\":"
+           << timing.GetGpuRasterDuration().ToMicroseconds()
+           << ",\"rasterCacheHits\":" << timing.GetRasterCacheHitCount()
+           << ",\"rasterCacheMisses\":" << timing.GetRasterCacheMissCount()
+           << ",\"supersededFrames\":" << timing.GetSupersededFrameCount()
+           << "}";
+  }
+  stream << "]";
+  return stream.str();
+}
+
+}  // namespace flutter
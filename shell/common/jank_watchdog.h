@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_JANK_WATCHDOG_H_
+#define FLUTTER_SHELL_COMMON_JANK_WATCHDOG_H_
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// Watches the timings of the rasterized frames for jank and decides when the
+/// rasterizer captures what is needed to reproduce it, so that jank seen on a
+/// device in the field can be investigated without reproducing it first.
+///
+/// A frame is slow when it takes longer than the budget to build or to
+/// rasterize. A capture is due when more than a given number of the last
+/// |kWindowFrameCount| frames were slow, so that a single hiccup doesn't
+/// trigger one. Captures are rate limited to one per interval and to
+/// |kMaxCaptures| per process, as they are written to the storage of the
+/// device.
+///
+/// Each capture is a directory named after the time of the frame that
+/// triggered it, in the directory of the watchdog, with:
+///   - frame.skp: The layer tree of the frame, see
+///     |Rasterizer::ScreenshotType::SkiaPicture|.
+///   - trace.json: The trace ring buffers in the Chrome JSON trace format, if
+///     |fml::tracing::TraceRingBuffer| is enabled. The buffers hold the last
+///     few seconds of a running app.
+///   - frame_timings.json: The timings of the frames of the window.
+///
+/// The watchdog is used on the raster thread. Captures are written on any
+/// thread.
+class JankWatchdog {
+ public:
+  static constexpr size_t kWindowFrameCount = 60;
+  static constexpr size_t kMaxCaptures = 10;
+
+  /// The artifacts of a capture that are collected when it is triggered.
+  struct Capture {
+    std::string directory;
+    std::string name;
+    std::string frame_timings;
+  };
+
+  /// |budget| is the time a frame may take to build or to rasterize, zero uses
+  /// the frame budget of the display at the time of each frame. A capture is
+  /// made when more than |slow_frame_count| frames of the window were slow, at
+  /// most once per |interval|.
+  JankWatchdog(std::string directory,
+               fml::TimeDelta budget,
+               size_t slow_frame_count,
+               fml::TimeDelta interval);
+
+  ~JankWatchdog();
+
+  /// Adds a rasterized frame to the window. Returns the capture to make if it
+  /// is due, in which case the window starts over.
+  std::optional<Capture> OnFrameRasterized(const FrameTiming& timing,
+                                           fml::TimeDelta frame_budget);
+
+  /// Writes |capture| with the serialized |picture| of the frame, which may be
+  /// null if it could not be recorded. Returns whether the capture was
+  /// written.
+  static bool WriteCapture(const Capture& capture,
+                           const fml::Mapping* picture);
+
+  /// Describes |timings| as a JSON array. Times are in microseconds, points
+  /// in time are relative to the epoch of |fml::TimePoint|.
+  static std::string DescribeFrameTimings(
+      const std::vector<FrameTiming>& timings);
+
+ private:
+  const std::string directory_;
+  const fml::TimeDelta budget_;
+  const size_t slow_frame_count_;
+  const fml::TimeDelta interval_;
+  // The frames of the window and whether each was slow.
+  std::deque<std::pair<FrameTiming, bool>> window_;
+  size_t capture_count_ = 0;
+  std::optional<fml::TimePoint> last_capture_time_;
+
+  bool IsSlow(const FrameTiming& timing, fml::TimeDelta frame_budget) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(JankWatchdog);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_JANK_WATCHDOG_H_
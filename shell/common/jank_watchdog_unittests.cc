@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/jank_watchdog.h"
+
+#include "flutter/fml/file.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static const fml::TimeDelta kBudget = fml::TimeDelta::FromMilliseconds(16);
+
+// A frame that starts building at |start| and takes |build| and then |raster|
+// milliseconds.
+static FrameTiming MakeFrame(fml::TimePoint start,
+                             int64_t build,
+                             int64_t raster) {
+  FrameTiming timing;
+  timing.Set(FrameTiming::kBuildStart, start);
+  timing.Set(FrameTiming::kBuildFinish,
+             start + fml::TimeDelta::FromMilliseconds(build));
+  timing.Set(FrameTiming::kRasterStart, timing.Get(FrameTiming::kBuildFinish));
+  timing.Set(FrameTiming::kRasterFinish,
+             timing.Get(FrameTiming::kRasterStart) +
+                 fml::TimeDelta::FromMilliseconds(raster));
+  return timing;
+}
+
+TEST(JankWatchdogTest, CapturesWhenMoreThanTheCountOfFramesWereSlow) {
+  JankWatchdog watchdog("jank", fml::TimeDelta::Zero(), 2,
+                        fml::TimeDelta::Zero());
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 20, 4), kBudget));
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 4), kBudget));
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+  auto capture = watchdog.OnFrameRasterized(MakeFrame(now, 4, 30), kBudget);
+  ASSERT_TRUE(capture);
+  EXPECT_EQ(capture->directory, "jank");
+  EXPECT_EQ(capture->name.rfind("jank_", 0), 0u);
+  // The window starts over after a capture.
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 30), kBudget));
+}
+
+TEST(JankWatchdogTest, OnlyCountsTheFramesOfTheWindow) {
+  JankWatchdog watchdog("jank", fml::TimeDelta::Zero(), 1,
+                        fml::TimeDelta::Zero());
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 20, 4), kBudget));
+  for (size_t i = 0; i < JankWatchdog::kWindowFrameCount; i++) {
+    EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 4), kBudget));
+  }
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 20, 4), kBudget));
+}
+
+TEST(JankWatchdogTest, UsesTheConfiguredBudgetOverTheFrameBudget) {
+  JankWatchdog watchdog("jank", fml::TimeDelta::FromMilliseconds(30), 0,
+                        fml::TimeDelta::Zero());
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+  EXPECT_TRUE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 40), kBudget));
+}
+
+TEST(JankWatchdogTest, RateLimitsCaptures) {
+  JankWatchdog watchdog("jank", fml::TimeDelta::Zero(), 0,
+                        fml::TimeDelta::FromSeconds(60));
+  fml::TimePoint now = fml::TimePoint::Now();
+  EXPECT_TRUE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+  now = now + fml::TimeDelta::FromSeconds(30);
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+  now = now + fml::TimeDelta::FromSeconds(31);
+  EXPECT_TRUE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+
+  for (size_t i = 2; i < JankWatchdog::kMaxCaptures; i++) {
+    now = now + fml::TimeDelta::FromSeconds(61);
+    EXPECT_TRUE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+  }
+  now = now + fml::TimeDelta::FromSeconds(61);
+  EXPECT_FALSE(watchdog.OnFrameRasterized(MakeFrame(now, 4, 20), kBudget));
+}
+
+TEST(JankWatchdogTest, WritesCapturesIntoTheirOwnDirectory) {
+  fml::ScopedTemporaryDirectory directory;
+  JankWatchdog watchdog(directory.path(), fml::TimeDelta::Zero(), 0,
+                        fml::TimeDelta::Zero());
+  auto capture = watchdog.OnFrameRasterized(
+      MakeFrame(fml::TimePoint::Now(), 4, 20), kBudget);
+  ASSERT_TRUE(capture);
+  EXPECT_EQ(capture->frame_timings.front(), '[');
+  EXPECT_NE(capture->frame_timings.find("\"rasterFinish\":"),
+            std::string::npos);
+
+  const std::string picture_data = "skp";
+  fml::DataMapping picture(picture_data);
+  ASSERT_TRUE(JankWatchdog::WriteCapture(*capture, &picture));
+
+  auto capture_directory =
+      fml::OpenDirectoryReadOnly(directory.fd(), capture->name.c_str());
+  ASSERT_TRUE(capture_directory.is_valid());
+  auto timings = fml::FileMapping::CreateReadOnly(capture_directory,
+                                                  "frame_timings.json");
+  ASSERT_TRUE(timings);
+  EXPECT_EQ(timings->GetSize(), capture->frame_timings.size());
+  auto skp = fml::FileMapping::CreateReadOnly(capture_directory, "frame.skp");
+  ASSERT_TRUE(skp);
+  EXPECT_EQ(skp->GetSize(), picture_data.size());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,71 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/kernel_mapping_cache.h"
+
+#include <cstring>
+#include <optional>
+
+#include "flutter/fml/hash.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+KernelMappingCache& KernelMappingCache::GetInstance() {
+  static KernelMappingCache* cache = new KernelMappingCache();
+  return *cache;
+}
+
+KernelMappingCache::KernelMappingCache() = default;
+
+KernelMappingCache::~KernelMappingCache() = default;
+
+std::shared_ptr<const fml::Mapping> KernelMappingCache::Get(
+    const std::string& name,
+    std::unique_ptr<const fml::Mapping> mapping) {
+  if (!mapping || mapping->GetSize() == 0) {
+    return nullptr;
+  }
+  TRACE_EVENT1("flutter", "KernelMappingCache::Get", "name", name.c_str());
+
+  // The contents are compared without the lock held, the pieces of a kernel
+  // are loaded in parallel.
+  const size_t size = mapping->GetSize();
+  const uint64_t hash = fml::HashBytes(mapping->GetMapping(), size);
+  std::optional<Entry> cached;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = entries_.find(name);
+    if (found != entries_.end()) {
+      cached = found->second;
+    }
+  }
+  if (cached && cached->hash == hash &&
+      cached->mapping->GetSize() == size &&
+      ::memcmp(cached->mapping->GetMapping(), mapping->GetMapping(), size) ==
+          0) {
+    TRACE_EVENT_INSTANT0("flutter", "KernelMappingCache::ReusedMapping");
+    return cached->mapping;
+  }
+
+  std::shared_ptr<const fml::Mapping> shared = std::move(mapping);
+  std::scoped_lock lock(mutex_);
+  entries_.insert_or_assign(name, Entry{shared, hash});
+  return shared;
+}
+
+void KernelMappingCache::Clear() {
+  std::map<std::string, Entry> entries;
+  {
+    std::scoped_lock lock(mutex_);
+    entries.swap(entries_);
+  }
+}
+
+size_t KernelMappingCache::GetCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace flutter
@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_KERNEL_MAPPING_CACHE_H_
+#define FLUTTER_SHELL_COMMON_KERNEL_MAPPING_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+// The kernel blobs the isolates of the process were last prepared from, keyed
+// by the path or asset name they were loaded from.
+//
+// In JIT mode, every restart prepares a new isolate from the kernel again, and
+// large apps run hundreds of megabytes of it, most of which didn't change
+// since the previous run. Handing a freshly loaded blob to the cache returns
+// the blob that was already loaded from the same place if their contents are
+// the same, which is checked with a hash of the contents before comparing them
+// byte by byte. The fresh one is then dropped right away, so the isolates keep
+// using the pages already faulted in and, for assets that had to be copied out
+// of their bundle, only one copy is kept alive.
+//
+// This class is thread-safe.
+class KernelMappingCache {
+ public:
+  // The cache of the process.
+  static KernelMappingCache& GetInstance();
+
+  KernelMappingCache();
+
+  ~KernelMappingCache();
+
+  // Returns the kernel loaded from |name| that has the same contents as
+  // |mapping|, which is the cached one if the contents didn't change and
+  // |mapping| itself otherwise. The kernel returned replaces the cached one.
+  // Returns null if |mapping| is null or empty.
+  std::shared_ptr<const fml::Mapping> Get(
+      const std::string& name,
+      std::unique_ptr<const fml::Mapping> mapping);
+
+  // Drops the cached kernels. The isolates that run them keep them alive.
+  void Clear();
+
+  size_t GetCount() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const fml::Mapping> mapping;
+    uint64_t hash;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Entry> entries_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(KernelMappingCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_KERNEL_MAPPING_CACHE_H_
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/kernel_mapping_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static std::unique_ptr<const fml::Mapping> MakeKernel(
+    const std::string& contents) {
+  return std::make_unique<fml::DataMapping>(contents);
+}
+
+TEST(KernelMappingCacheTest, ReusesKernelWithSameContents) {
+  KernelMappingCache cache;
+  auto first = cache.Get("app.dill", MakeKernel("kernel"));
+  ASSERT_TRUE(first);
+  auto second = cache.Get("app.dill", MakeKernel("kernel"));
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.GetCount(), 1u);
+}
+
+TEST(KernelMappingCacheTest, ReplacesKernelWithChangedContents) {
+  KernelMappingCache cache;
+  auto first = cache.Get("app.dill", MakeKernel("kernel"));
+  auto changed = cache.Get("app.dill", MakeKernel("kernel2"));
+  ASSERT_TRUE(changed);
+  EXPECT_NE(first, changed);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(changed->GetMapping()),
+                        changed->GetSize()),
+            "kernel2");
+  EXPECT_EQ(cache.Get("app.dill", MakeKernel("kernel2")), changed);
+  EXPECT_EQ(cache.GetCount(), 1u);
+}
+
+TEST(KernelMappingCacheTest, KeysKernelsByName) {
+  KernelMappingCache cache;
+  auto app = cache.Get("app.dill", MakeKernel("kernel"));
+  auto packages = cache.Get("packages.dill", MakeKernel("kernel"));
+  EXPECT_NE(app, packages);
+  EXPECT_EQ(cache.GetCount(), 2u);
+}
+
+TEST(KernelMappingCacheTest, IgnoresEmptyKernels) {
+  KernelMappingCache cache;
+  EXPECT_FALSE(cache.Get("app.dill", nullptr));
+  EXPECT_FALSE(cache.Get("app.dill", MakeKernel("")));
+  EXPECT_EQ(cache.GetCount(), 0u);
+}
+
+TEST(KernelMappingCacheTest, ClearKeepsKernelsInUseAlive) {
+  KernelMappingCache cache;
+  auto kernel = cache.Get("app.dill", MakeKernel("kernel"));
+  cache.Clear();
+  EXPECT_EQ(cache.GetCount(), 0u);
+  EXPECT_EQ(kernel->GetSize(), 6u);
+  EXPECT_NE(cache.Get("app.dill", MakeKernel("kernel")), kernel);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,248 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/layer_tree_recording.h"
+
+#include <cstring>
+#include <utility>
+
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/lib/ui/window/viewport_metrics.h"
+#include "rapidjson/document.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr char kManifestFileName[] = "recording.json";
+
+bool ParseFloats(const rapidjson::Value& value, float* floats, size_t count) {
+  if (!value.IsArray() || value.Size() != count) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!value[i].IsNumber()) {
+      return false;
+    }
+    floats[i] = value[i].GetFloat();
+  }
+  return true;
+}
+
+bool ParseLayer(const rapidjson::Value& value,
+                size_t picture_count,
+                LayerTreeRecording::Layer* layer) {
+  using Type = LayerTreeRecording::Layer::Type;
+
+  if (!value.IsObject() || !value.HasMember("type") ||
+      !value["type"].IsString()) {
+    FML_LOG(ERROR) << "Recorded layer has no type.";
+    return false;
+  }
+  const char* type = value["type"].GetString();
+
+  if (value.HasMember("offset")) {
+    float offset[2];
+    if (!ParseFloats(value["offset"], offset, 2)) {
+      FML_LOG(ERROR) << "Recorded layer has a malformed offset.";
+      return false;
+    }
+    layer->offset = SkPoint::Make(offset[0], offset[1]);
+  }
+
+  if (strcmp(type, "container") == 0) {
+    layer->type = Type::kContainer;
+  } else if (strcmp(type, "transform") == 0) {
+    layer->type = Type::kTransform;
+    float matrix[9];
+    if (!value.HasMember("matrix") ||
+        !ParseFloats(value["matrix"], matrix, 9)) {
+      FML_LOG(ERROR) << "Recorded transform layer has a malformed matrix.";
+      return false;
+    }
+    layer->matrix.set9(matrix);
+  } else if (strcmp(type, "opacity") == 0) {
+    layer->type = Type::kOpacity;
+    if (!value.HasMember("alpha") || !value["alpha"].IsUint() ||
+        value["alpha"].GetUint() > 255) {
+      FML_LOG(ERROR) << "Recorded opacity layer has a malformed alpha.";
+      return false;
+    }
+    layer->alpha = static_cast<SkAlpha>(value["alpha"].GetUint());
+  } else if (strcmp(type, "clip_rect") == 0) {
+    layer->type = Type::kClipRect;
+    float rect[4];
+    if (!value.HasMember("rect") || !ParseFloats(value["rect"], rect, 4)) {
+      FML_LOG(ERROR) << "Recorded clip rect layer has a malformed rect.";
+      return false;
+    }
+    layer->clip_rect = SkRect::MakeLTRB(rect[0], rect[1], rect[2], rect[3]);
+  } else if (strcmp(type, "picture") == 0) {
+    layer->type = Type::kPicture;
+    if (!value.HasMember("picture") || !value["picture"].IsUint() ||
+        value["picture"].GetUint() >= picture_count) {
+      FML_LOG(ERROR) << "Recorded picture layer refers to no picture.";
+      return false;
+    }
+    layer->picture = value["picture"].GetUint();
+    layer->is_complex =
+        value.HasMember("complex") && value["complex"].IsTrue();
+    layer->will_change =
+        value.HasMember("will_change") && value["will_change"].IsTrue();
+    return true;
+  } else {
+    FML_LOG(ERROR) << "Recorded layer has unknown type " << type << ".";
+    return false;
+  }
+
+  if (value.HasMember("children")) {
+    const auto& children = value["children"];
+    if (!children.IsArray()) {
+      FML_LOG(ERROR) << "Recorded layer has malformed children.";
+      return false;
+    }
+    layer->children.resize(children.Size());
+    for (size_t i = 0; i < children.Size(); i++) {
+      if (!ParseLayer(children[i], picture_count, &layer->children[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<LayerTreeRecording> LayerTreeRecording::Load(
+    const fml::UniqueFD& directory) {
+  auto manifest = fml::FileMapping::CreateReadOnly(directory, kManifestFileName);
+  if (!manifest) {
+    FML_LOG(ERROR) << "Could not read " << kManifestFileName << ".";
+    return nullptr;
+  }
+
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(manifest->GetMapping()),
+                 manifest->GetSize());
+  if (document.HasParseError() || !document.IsObject()) {
+    FML_LOG(ERROR) << "Could not parse " << kManifestFileName << ".";
+    return nullptr;
+  }
+
+  if (!document.HasMember("width") || !document["width"].IsUint() ||
+      !document.HasMember("height") || !document["height"].IsUint()) {
+    FML_LOG(ERROR) << "Recording has no frame size.";
+    return nullptr;
+  }
+  float device_pixel_ratio = 1.0f;
+  if (document.HasMember("device_pixel_ratio") &&
+      document["device_pixel_ratio"].IsNumber()) {
+    device_pixel_ratio = document["device_pixel_ratio"].GetFloat();
+  }
+  auto recording = std::make_unique<LayerTreeRecording>(
+      SkISize::Make(document["width"].GetUint(), document["height"].GetUint()),
+      device_pixel_ratio);
+
+  if (!document.HasMember("pictures") || !document["pictures"].IsArray()) {
+    FML_LOG(ERROR) << "Recording has no pictures.";
+    return nullptr;
+  }
+  for (const auto& name : document["pictures"].GetArray()) {
+    if (!name.IsString()) {
+      FML_LOG(ERROR) << "Recording has a malformed picture name.";
+      return nullptr;
+    }
+    auto mapping = fml::FileMapping::CreateReadOnly(directory, name.GetString());
+    sk_sp<SkPicture> picture =
+        mapping ? SkPicture::MakeFromData(mapping->GetMapping(),
+                                          mapping->GetSize())
+                : nullptr;
+    if (!picture) {
+      FML_LOG(ERROR) << "Could not deserialize picture " << name.GetString()
+                     << ".";
+      return nullptr;
+    }
+    recording->AddPicture(std::move(picture));
+  }
+
+  if (!document.HasMember("frames") || !document["frames"].IsArray()) {
+    FML_LOG(ERROR) << "Recording has no frames.";
+    return nullptr;
+  }
+  for (const auto& frame : document["frames"].GetArray()) {
+    Layer root;
+    if (!ParseLayer(frame, recording->pictures_.size(), &root)) {
+      return nullptr;
+    }
+    recording->AddFrame(std::move(root));
+  }
+
+  return recording;
+}
+
+LayerTreeRecording::LayerTreeRecording(SkISize frame_size,
+                                       float device_pixel_ratio)
+    : frame_size_(frame_size), device_pixel_ratio_(device_pixel_ratio) {}
+
+LayerTreeRecording::~LayerTreeRecording() = default;
+
+size_t LayerTreeRecording::AddPicture(sk_sp<SkPicture> picture) {
+  FML_DCHECK(picture);
+  pictures_.push_back(std::move(picture));
+  return pictures_.size() - 1;
+}
+
+void LayerTreeRecording::AddFrame(Layer root) {
+  frames_.push_back(std::move(root));
+}
+
+std::unique_ptr<LayerTree> LayerTreeRecording::BuildLayerTree(
+    size_t index,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue) const {
+  FML_DCHECK(index < frames_.size());
+  auto layer_tree = std::make_unique<LayerTree>(
+      frame_size_, static_cast<float>(kUnsetDepth), device_pixel_ratio_);
+  layer_tree->set_root_layer(BuildLayer(frames_[index], unref_queue));
+  return layer_tree;
+}
+
+std::shared_ptr<flutter::Layer> LayerTreeRecording::BuildLayer(
+    const Layer& layer,
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue) const {
+  std::shared_ptr<ContainerLayer> container;
+  switch (layer.type) {
+    case Layer::Type::kPicture:
+      FML_DCHECK(layer.picture < pictures_.size());
+      return std::make_shared<PictureLayer>(
+          layer.offset,
+          SkiaGPUObject<SkPicture>(pictures_[layer.picture], unref_queue),
+          layer.is_complex, layer.will_change);
+    case Layer::Type::kContainer:
+      container = std::make_shared<ContainerLayer>();
+      break;
+    case Layer::Type::kTransform:
+      container = std::make_shared<TransformLayer>(layer.matrix);
+      break;
+    case Layer::Type::kOpacity:
+      container = std::make_shared<OpacityLayer>(layer.alpha, layer.offset);
+      break;
+    case Layer::Type::kClipRect:
+      container =
+          std::make_shared<ClipRectLayer>(layer.clip_rect, Clip::hardEdge);
+      break;
+  }
+  for (const auto& child : layer.children) {
+    container->Add(BuildLayer(child, unref_queue));
+  }
+  return container;
+}
+
+}  // namespace flutter
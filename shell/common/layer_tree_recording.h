@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_LAYER_TREE_RECORDING_H_
+#define FLUTTER_SHELL_COMMON_LAYER_TREE_RECORDING_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+/// A sequence of frames that can be turned into layer trees again, so that
+/// they can be rasterized without running the app that produced them.
+///
+/// Frames refer to pictures by their index in the recording, so pictures that
+/// are shared by several frames are the same |SkPicture| in each of their
+/// layer trees, as they would be in the app, and can hit the raster cache.
+///
+/// A recording on disk is a directory with a `recording.json` manifest and
+/// the serialized pictures it refers to, for example:
+///
+///   {
+///     "width": 1080, "height": 1920, "device_pixel_ratio": 2.75,
+///     "pictures": ["item.skp", "header.skp"],
+///     "frames": [
+///       {"type": "transform", "matrix": [1, 0, 0, 0, 1, -50, 0, 0, 1],
+///        "children": [{"type": "picture", "picture": 0, "offset": [0, 0],
+///                      "complex": true}]}
+///     ]
+///   }
+///
+/// Layers are `container`, `transform` with a row major 3x3 `matrix`,
+/// `opacity` with an `alpha` from 0 to 255 and an `offset`, `clip_rect` with
+/// a `rect` of left, top, right and bottom, and `picture` with a `picture`
+/// index, an `offset`, and `complex` and `will_change` hints.
+class LayerTreeRecording {
+ public:
+  struct Layer {
+    enum class Type {
+      kContainer,
+      kTransform,
+      kOpacity,
+      kClipRect,
+      kPicture,
+    };
+
+    Type type = Type::kContainer;
+    // kTransform.
+    SkMatrix matrix = SkMatrix::I();
+    // kOpacity.
+    SkAlpha alpha = 255;
+    // kOpacity and kPicture.
+    SkPoint offset = SkPoint::Make(0, 0);
+    // kClipRect.
+    SkRect clip_rect = SkRect::MakeEmpty();
+    // kPicture.
+    size_t picture = 0;
+    bool is_complex = false;
+    bool will_change = false;
+    std::vector<Layer> children;
+  };
+
+  /// Loads the recording in |directory|, or returns nullptr and logs why it
+  /// could not be loaded.
+  static std::unique_ptr<LayerTreeRecording> Load(
+      const fml::UniqueFD& directory);
+
+  LayerTreeRecording(SkISize frame_size, float device_pixel_ratio);
+
+  ~LayerTreeRecording();
+
+  /// Adds a picture that layers can refer to, and returns its index.
+  size_t AddPicture(sk_sp<SkPicture> picture);
+
+  /// Adds a frame with the layers under |root|. The pictures they refer to
+  /// must have been added already.
+  void AddFrame(Layer root);
+
+  size_t GetFrameCount() const { return frames_.size(); }
+
+  const SkISize& GetFrameSize() const { return frame_size_; }
+
+  /// Builds the layer tree of the frame at |index|. The layer trees built for
+  /// a frame share nothing but their pictures, which their layers release
+  /// through |unref_queue|.
+  std::unique_ptr<LayerTree> BuildLayerTree(
+      size_t index,
+      fml::RefPtr<SkiaUnrefQueue> unref_queue) const;
+
+ private:
+  const SkISize frame_size_;
+  const float device_pixel_ratio_;
+  std::vector<sk_sp<SkPicture>> pictures_;
+  std::vector<Layer> frames_;
+
+  std::shared_ptr<flutter::Layer> BuildLayer(
+      const Layer& layer,
+      const fml::RefPtr<SkiaUnrefQueue>& unref_queue) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerTreeRecording);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_LAYER_TREE_RECORDING_H_
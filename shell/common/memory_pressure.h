@@ -0,0 +1,41 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_MEMORY_PRESSURE_H_
+#define FLUTTER_SHELL_COMMON_MEMORY_PRESSURE_H_
+
+#include <cstddef>
+
+namespace flutter {
+
+/// How much memory the embedder wants the engine to give up, in increasing
+/// order. Each level frees everything the levels before it free.
+enum class MemoryPressureLevel {
+  /// The system is running low on memory while the app is visible. Caches
+  /// are trimmed of what the current frames don't use.
+  kModerate,
+  /// The system is running very low on memory while the app is visible. All
+  /// caches that can be rebuilt without rasterizing visible content again are
+  /// dropped.
+  kCritical,
+  /// The app is not visible. Everything that can be rebuilt is dropped,
+  /// including the raster cache entries of the current frame.
+  kBackground,
+};
+
+/// What a memory pressure notification freed. Memory freed by the Dart heap,
+/// the text layout caches, the decoded image cache and the image decoding
+/// queue is not accounted for.
+struct MemoryPressureReport {
+  MemoryPressureLevel level = MemoryPressureLevel::kModerate;
+  /// The bytes of raster cache images that were evicted.
+  size_t raster_cache_bytes_freed = 0;
+  /// The bytes of GPU resources that the Skia context of the onscreen surface
+  /// released, raster cache images included.
+  size_t gpu_resource_bytes_freed = 0;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_MEMORY_PRESSURE_H_
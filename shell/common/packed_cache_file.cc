@@ -0,0 +1,433 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/packed_cache_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/hash.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'L', 'T', 'P', 'A', 'C', 'K', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+// Followed by the key and the value.
+struct RecordHeader {
+  uint32_t key_size;
+  uint32_t value_size;
+  // The hash of the key and the value.
+  uint64_t checksum;
+};
+
+uint64_t Checksum(const void* key,
+                  size_t key_size,
+                  const void* value,
+                  size_t value_size) {
+  return fml::HashBytes(value, value_size, fml::HashBytes(key, key_size));
+}
+
+}  // namespace
+
+PackedCacheFile::PackedCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                                 std::string file_name,
+                                 bool read_only)
+    : directory_(std::move(directory)),
+      file_name_(std::move(file_name)),
+      read_only_(read_only),
+      pending_charge_(fml::MemoryCounter::Get("PersistentCache")) {
+  std::scoped_lock lock(mutex_);
+  OpenLocked();
+}
+
+PackedCacheFile::~PackedCacheFile() {
+  std::scoped_lock lock(mutex_);
+  FlushLocked();
+}
+
+bool PackedCacheFile::IsValid() const {
+  std::scoped_lock lock(mutex_);
+  return mapping_ != nullptr;
+}
+
+bool PackedCacheFile::OpenLocked() {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Open");
+  mapping_.reset();
+  index_.clear();
+  size_ = 0;
+  stale_bytes_ = 0;
+  if (!directory_ || !directory_->is_valid()) {
+    return false;
+  }
+  file_ = read_only_ ? fml::OpenFileReadOnly(*directory_, file_name_.c_str())
+                     : fml::OpenFile(*directory_, file_name_.c_str(), true,
+                                     fml::FilePermission::kReadWrite);
+  if (!file_.is_valid() || !MapLocked()) {
+    mapping_.reset();
+    return false;
+  }
+
+  FileHeader header = {};
+  if (mapping_->GetSize() >= sizeof(header)) {
+    ::memcpy(&header, mapping_->GetMapping(), sizeof(header));
+  }
+  if (::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    if (read_only_ || !ResetLocked()) {
+      mapping_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  IndexLocked();
+  if (!read_only_ && size_ < mapping_->GetSize()) {
+    // Drops the torn record at the end, so that appends follow the last
+    // record that is intact.
+    FML_LOG(WARNING) << "Dropping " << mapping_->GetSize() - size_
+                     << " bytes of torn records from " << file_name_;
+    mapping_.reset();
+    if (!fml::TruncateFile(file_, size_) || !MapLocked()) {
+      mapping_.reset();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PackedCacheFile::MapLocked() {
+  mapping_.reset();
+  auto mapping =
+      read_only_
+          ? std::make_unique<fml::FileMapping>(file_)
+          : std::make_unique<fml::FileMapping>(
+                file_, std::initializer_list<fml::FileMapping::Protection>{
+                           fml::FileMapping::Protection::kRead,
+                           fml::FileMapping::Protection::kWrite});
+  if (!mapping->IsValid()) {
+    return false;
+  }
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+bool PackedCacheFile::ResetLocked() {
+  FileHeader header = {};
+  ::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  mapping_.reset();
+  if (!fml::TruncateFile(file_, 0) ||
+      !fml::TruncateFile(file_, sizeof(header)) || !MapLocked() ||
+      mapping_->GetMutableMapping() == nullptr) {
+    return false;
+  }
+  ::memcpy(mapping_->GetMutableMapping(), &header, sizeof(header));
+  index_.clear();
+  size_ = sizeof(header);
+  stale_bytes_ = 0;
+  return true;
+}
+
+void PackedCacheFile::IndexLocked() {
+  const uint8_t* bytes = mapping_->GetMapping();
+  const size_t file_size = mapping_->GetSize();
+  size_t offset = sizeof(FileHeader);
+  while (file_size - offset >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    ::memcpy(&header, bytes + offset, sizeof(header));
+    const size_t size = sizeof(header) + header.key_size + header.value_size;
+    if (header.key_size == 0 || size > file_size - offset) {
+      break;
+    }
+    const uint8_t* key = bytes + offset + sizeof(header);
+    const uint8_t* value = key + header.key_size;
+    if (Checksum(key, header.key_size, value, header.value_size) !=
+        header.checksum) {
+      break;
+    }
+    IndexRecordLocked(
+        std::string(reinterpret_cast<const char*>(key), header.key_size),
+        Record{offset, size, ++use_clock_});
+    offset += size;
+  }
+  size_ = offset;
+}
+
+void PackedCacheFile::IndexRecordLocked(std::string key, Record record) {
+  auto inserted = index_.try_emplace(std::move(key), record);
+  if (!inserted.second) {
+    stale_bytes_ += inserted.first->second.size;
+    inserted.first->second = record;
+  }
+}
+
+sk_sp<SkData> PackedCacheFile::CopyValueLocked(const Record& record) const {
+  RecordHeader header;
+  ::memcpy(&header, mapping_->GetMapping() + record.offset, sizeof(header));
+  return SkData::MakeWithCopy(mapping_->GetMapping() + record.offset +
+                                  sizeof(header) + header.key_size,
+                              header.value_size);
+}
+
+sk_sp<SkData> PackedCacheFile::Load(const SkData& key) {
+  std::scoped_lock lock(mutex_);
+  std::string key_string(reinterpret_cast<const char*>(key.data()),
+                         key.size());
+  auto pending = pending_index_.find(key_string);
+  if (pending != pending_index_.end()) {
+    return pending_[pending->second].second;
+  }
+  if (!mapping_) {
+    return nullptr;
+  }
+  auto found = index_.find(key_string);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  found->second.last_use = ++use_clock_;
+  return CopyValueLocked(found->second);
+}
+
+std::vector<PackedCacheFile::Entry> PackedCacheFile::LoadAll() {
+  TRACE_EVENT0("flutter", "PackedCacheFile::LoadAll");
+  std::scoped_lock lock(mutex_);
+  FlushLocked();
+  std::vector<const std::pair<const std::string, Record>*> records;
+  records.reserve(index_.size());
+  for (const auto& record : index_) {
+    records.push_back(&record);
+  }
+  std::sort(records.begin(), records.end(), [](auto* a, auto* b) {
+    return a->second.offset < b->second.offset;
+  });
+
+  std::vector<Entry> entries;
+  entries.reserve(records.size());
+  for (const auto* record : records) {
+    entries.push_back(
+        {SkData::MakeWithCopy(record->first.data(), record->first.size()),
+         CopyValueLocked(record->second)});
+  }
+  return entries;
+}
+
+bool PackedCacheFile::Store(const SkData& key, const SkData& value) {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Store");
+  std::scoped_lock lock(mutex_);
+  if (read_only_ || !mapping_ || key.size() == 0) {
+    return false;
+  }
+  QueueLocked(SkData::MakeWithCopy(key.data(), key.size()),
+              SkData::MakeWithCopy(value.data(), value.size()));
+  return FlushLocked();
+}
+
+bool PackedCacheFile::StoreLater(sk_sp<SkData> key, sk_sp<SkData> value) {
+  std::scoped_lock lock(mutex_);
+  if (read_only_ || !mapping_ || !key || key->size() == 0 || !value) {
+    return false;
+  }
+  const bool was_empty = pending_.empty();
+  QueueLocked(std::move(key), std::move(value));
+  return was_empty;
+}
+
+void PackedCacheFile::QueueLocked(sk_sp<SkData> key, sk_sp<SkData> value) {
+  pending_bytes_ += key->size() + value->size();
+  auto inserted = pending_index_.try_emplace(
+      std::string(reinterpret_cast<const char*>(key->data()), key->size()),
+      pending_.size());
+  if (inserted.second) {
+    pending_.push_back({std::move(key), std::move(value)});
+  } else {
+    sk_sp<SkData>& queued = pending_[inserted.first->second].second;
+    pending_bytes_ -= queued->size() + key->size();
+    queued = std::move(value);
+  }
+  pending_charge_.Update(pending_bytes_);
+}
+
+bool PackedCacheFile::Flush() {
+  std::scoped_lock lock(mutex_);
+  return FlushLocked();
+}
+
+bool PackedCacheFile::FlushLocked() {
+  if (pending_.empty()) {
+    return true;
+  }
+  TRACE_EVENT0("flutter", "PackedCacheFile::Flush");
+  std::vector<Entry> entries = std::move(pending_);
+  pending_.clear();
+  pending_index_.clear();
+  pending_bytes_ = 0;
+  pending_charge_.Update(pending_bytes_);
+  if (read_only_ || !mapping_) {
+    return false;
+  }
+
+  const size_t offset = size_;
+  size_t size = 0;
+  for (const Entry& entry : entries) {
+    size += sizeof(RecordHeader) + entry.first->size() + entry.second->size();
+  }
+  // Some platforms can't resize files while they are mapped.
+  mapping_.reset();
+  if (!fml::TruncateFile(file_, offset + size) || !MapLocked() ||
+      mapping_->GetMutableMapping() == nullptr) {
+    // Leaves the file as it was indexed.
+    fml::TruncateFile(file_, offset);
+    MapLocked();
+    return false;
+  }
+
+  size_t record_offset = offset;
+  for (const Entry& entry : entries) {
+    const SkData& key = *entry.first;
+    const SkData& value = *entry.second;
+    RecordHeader header;
+    header.key_size = key.size();
+    header.value_size = value.size();
+    header.checksum =
+        Checksum(key.data(), key.size(), value.data(), value.size());
+    const size_t record_size = sizeof(header) + key.size() + value.size();
+    uint8_t* record = mapping_->GetMutableMapping() + record_offset;
+    ::memcpy(record, &header, sizeof(header));
+    ::memcpy(record + sizeof(header), key.data(), key.size());
+    ::memcpy(record + sizeof(header) + key.size(), value.data(), value.size());
+    IndexRecordLocked(
+        std::string(reinterpret_cast<const char*>(key.data()), key.size()),
+        Record{record_offset, record_size, ++use_clock_});
+    record_offset += record_size;
+  }
+  size_ = offset + size;
+
+  TrimLocked();
+  return true;
+}
+
+void PackedCacheFile::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+}
+
+void PackedCacheFile::TrimLocked() {
+  const size_t live_bytes = size_ - sizeof(FileHeader) - stale_bytes_;
+  if (max_bytes_ != 0 && live_bytes > max_bytes_) {
+    // Evicts more than needed, so that the next stores don't compact again.
+    EvictLocked(max_bytes_ - max_bytes_ / 4);
+    CompactLocked();
+  } else if (stale_bytes_ > kMinCompactionBytes &&
+             stale_bytes_ > size_ - stale_bytes_) {
+    CompactLocked();
+  }
+}
+
+void PackedCacheFile::EvictLocked(size_t max_bytes) {
+  using Iterator = std::unordered_map<std::string, Record>::iterator;
+  std::vector<Iterator> records;
+  records.reserve(index_.size());
+  for (auto it = index_.begin(); it != index_.end(); ++it) {
+    records.push_back(it);
+  }
+  std::sort(records.begin(), records.end(), [](Iterator a, Iterator b) {
+    return a->second.last_use < b->second.last_use;
+  });
+  size_t live_bytes = size_ - sizeof(FileHeader) - stale_bytes_;
+  for (Iterator record : records) {
+    if (live_bytes <= max_bytes) {
+      break;
+    }
+    live_bytes -= record->second.size;
+    stale_bytes_ += record->second.size;
+    index_.erase(record);
+  }
+}
+
+bool PackedCacheFile::Compact() {
+  std::scoped_lock lock(mutex_);
+  return CompactLocked();
+}
+
+bool PackedCacheFile::CompactLocked() {
+  TRACE_EVENT0("flutter", "PackedCacheFile::Compact");
+  if (read_only_ || !mapping_) {
+    return false;
+  }
+  std::vector<Record> records;
+  records.reserve(index_.size());
+  std::unordered_map<std::string, uint64_t> last_uses;
+  for (const auto& record : index_) {
+    records.push_back(record.second);
+    last_uses.emplace(record.first, record.second.last_use);
+  }
+  std::sort(records.begin(), records.end(),
+            [](const Record& a, const Record& b) {
+              return a.offset < b.offset;
+            });
+
+  std::vector<uint8_t> compacted(mapping_->GetMapping(),
+                                 mapping_->GetMapping() + sizeof(FileHeader));
+  compacted.reserve(size_ - stale_bytes_);
+  for (const Record& record : records) {
+    const uint8_t* bytes = mapping_->GetMapping() + record.offset;
+    compacted.insert(compacted.end(), bytes, bytes + record.size);
+  }
+
+  // The file is replaced by renaming the compacted one over it, which some
+  // platforms don't allow while it is open.
+  mapping_.reset();
+  file_.reset();
+  if (!fml::WriteAtomically(*directory_, file_name_.c_str(),
+                            fml::DataMapping(std::move(compacted)))) {
+    FML_LOG(ERROR) << "Could not compact " << file_name_;
+    OpenLocked();
+    return false;
+  }
+  if (!OpenLocked()) {
+    return false;
+  }
+  // Reopening ranks the entries by when they were stored again.
+  for (auto& record : index_) {
+    auto found = last_uses.find(record.first);
+    if (found != last_uses.end()) {
+      record.second.last_use = found->second;
+    }
+  }
+  return true;
+}
+
+size_t PackedCacheFile::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return index_.size();
+}
+
+size_t PackedCacheFile::GetFileSize() const {
+  std::scoped_lock lock(mutex_);
+  return size_;
+}
+
+size_t PackedCacheFile::GetStaleBytes() const {
+  std::scoped_lock lock(mutex_);
+  return stale_bytes_;
+}
+
+size_t PackedCacheFile::GetPendingCount() const {
+  std::scoped_lock lock(mutex_);
+  return pending_.size();
+}
+
+}  // namespace flutter
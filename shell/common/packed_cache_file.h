@@ -0,0 +1,162 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PACKED_CACHE_FILE_H_
+#define FLUTTER_SHELL_COMMON_PACKED_CACHE_FILE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// The entries of a persistent cache, packed into a single file instead of a
+/// file for each.
+///
+/// The file is a log of records, each holding a key and its value, and a new
+/// value for a key is appended to it as another record. Opening the file maps
+/// it and indexes its records by their key, the last record of a key
+/// replacing the earlier ones, so that loading all the entries takes a single
+/// open. Appends aren't synced to disk; a record that was torn by a crash
+/// fails its checksum and is dropped with the records after it.
+///
+/// Entries can also be queued to be appended later, with the entries queued
+/// after them, so that a burst of new entries resizes and maps the file once.
+/// Loading sees the queued entries.
+///
+/// Once most of the file is made of records that were replaced, storing
+/// entries compacts the file, rewriting it atomically with only the last
+/// record of each key. So does going over the budget set for the file,
+/// evicting the least recently used entries first.
+///
+/// It is thread-safe.
+class PackedCacheFile {
+ public:
+  using Entry = std::pair<sk_sp<SkData>, sk_sp<SkData>>;
+
+  /// The bytes of replaced records, both above which and above the bytes of
+  /// the last records of each key, the file is compacted.
+  static constexpr size_t kMinCompactionBytes = 256 * 1024;
+
+  /// Opens the file named |file_name| in |directory|, creating it unless
+  /// |read_only|. A file written by another version of the format is emptied,
+  /// or ignored if |read_only|.
+  PackedCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                  std::string file_name,
+                  bool read_only);
+
+  ~PackedCacheFile();
+
+  bool IsValid() const;
+
+  /// Returns the value stored for |key|, or null if there is none.
+  sk_sp<SkData> Load(const SkData& key);
+
+  /// Flushes the queued entries, then returns copies of all the entries, in
+  /// the order their keys were first stored.
+  std::vector<Entry> LoadAll();
+
+  /// Appends a record of |value| for |key|, after those of the queued
+  /// entries. Returns false if the file is read only or couldn't be written
+  /// to.
+  bool Store(const SkData& key, const SkData& value);
+
+  /// Queues |value| for |key| to be appended by the next |Flush|, replacing
+  /// the value queued for it if there is one. Returns whether the queue was
+  /// empty, in which case the caller should arrange for a flush.
+  bool StoreLater(sk_sp<SkData> key, sk_sp<SkData> value);
+
+  /// Appends records of the queued entries at once. Returns false if the
+  /// file couldn't be written to, in which case the entries are dropped.
+  bool Flush();
+
+  /// Sets the bytes that the last records of each key may take, above which
+  /// storing evicts the least recently used entries, down to three quarters
+  /// of them. Entries are used when they are stored or loaded; those that
+  /// weren't in this run rank by when they were stored. Zero doesn't limit
+  /// the file.
+  void SetMaxBytes(size_t max_bytes);
+
+  /// Rewrites the file with only the last record of each key.
+  bool Compact();
+
+  size_t GetEntryCount() const;
+
+  /// The bytes of the file, including those of replaced records.
+  size_t GetFileSize() const;
+
+  /// The bytes of the records that were replaced by later ones.
+  size_t GetStaleBytes() const;
+
+  size_t GetPendingCount() const;
+
+ private:
+  struct Record {
+    // The offset of the record's header in the file.
+    size_t offset;
+    // The bytes of the record, including its header.
+    size_t size;
+    // When the entry was last stored or loaded, on |use_clock_|.
+    uint64_t last_use;
+  };
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const std::string file_name_;
+  const bool read_only_;
+  mutable std::mutex mutex_;
+  fml::UniqueFD file_;
+  std::unique_ptr<fml::FileMapping> mapping_;
+  // The bytes of the header and the records that were indexed.
+  size_t size_ = 0;
+  size_t stale_bytes_ = 0;
+  // The records by their key.
+  std::unordered_map<std::string, Record> index_;
+  uint64_t use_clock_ = 0;
+  size_t max_bytes_ = 0;
+  // The entries to append on the next flush, in the order they were queued,
+  // and their indices by key.
+  std::vector<Entry> pending_;
+  std::unordered_map<std::string, size_t> pending_index_;
+  size_t pending_bytes_ = 0;
+  // |pending_bytes_|, charged to the "PersistentCache" counter.
+  fml::MemoryCharge pending_charge_;
+
+  bool OpenLocked();
+
+  bool MapLocked();
+
+  bool ResetLocked();
+
+  void IndexLocked();
+
+  void IndexRecordLocked(std::string key, Record record);
+
+  void QueueLocked(sk_sp<SkData> key, sk_sp<SkData> value);
+
+  bool FlushLocked();
+
+  // Compacts the file if it is mostly stale or over its budget.
+  void TrimLocked();
+
+  void EvictLocked(size_t max_bytes);
+
+  bool CompactLocked();
+
+  sk_sp<SkData> CopyValueLocked(const Record& record) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedCacheFile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PACKED_CACHE_FILE_H_
@@ -0,0 +1,188 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/packed_cache_file.h"
+
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static constexpr char kFileName[] = "cache.pack";
+
+class PackedCacheFileTest : public ::testing::Test {
+ public:
+  PackedCacheFileTest()
+      : directory_(std::make_shared<fml::UniqueFD>(
+            fml::OpenDirectory(temp_dir_.path().c_str(),
+                               false,
+                               fml::FilePermission::kReadWrite))) {}
+
+  ~PackedCacheFileTest() override {
+    fml::RemoveFilesInDirectory(temp_dir_.fd());
+  }
+
+ protected:
+  fml::ScopedTemporaryDirectory temp_dir_;
+  std::shared_ptr<fml::UniqueFD> directory_;
+};
+
+static sk_sp<SkData> MakeData(const std::string& string) {
+  return SkData::MakeWithCopy(string.data(), string.size());
+}
+
+static std::string ToString(const sk_sp<SkData>& data) {
+  return data ? std::string(static_cast<const char*>(data->data()),
+                            data->size())
+              : "(null)";
+}
+
+TEST_F(PackedCacheFileTest, LoadsTheLastValueStoredForEachKey) {
+  {
+    PackedCacheFile file(directory_, kFileName, false);
+    ASSERT_TRUE(file.IsValid());
+    EXPECT_TRUE(file.Store(*MakeData("a"), *MakeData("first")));
+    EXPECT_TRUE(file.Store(*MakeData("b"), *MakeData("second")));
+    EXPECT_TRUE(file.Store(*MakeData("a"), *MakeData("third")));
+    EXPECT_EQ(ToString(file.Load(*MakeData("a"))), "third");
+    EXPECT_EQ(file.Load(*MakeData("c")), nullptr);
+  }
+
+  // The entries are read back from the file.
+  PackedCacheFile file(directory_, kFileName, true);
+  ASSERT_TRUE(file.IsValid());
+  EXPECT_EQ(file.GetEntryCount(), 2u);
+  EXPECT_GT(file.GetStaleBytes(), 0u);
+  auto entries = file.LoadAll();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(ToString(entries[0].first), "b");
+  EXPECT_EQ(ToString(entries[0].second), "second");
+  EXPECT_EQ(ToString(entries[1].first), "a");
+  EXPECT_EQ(ToString(entries[1].second), "third");
+  EXPECT_FALSE(file.Store(*MakeData("c"), *MakeData("read only")));
+}
+
+TEST_F(PackedCacheFileTest, CompactingKeepsOnlyTheLastValues) {
+  PackedCacheFile file(directory_, kFileName, false);
+  file.Store(*MakeData("a"), *MakeData("first"));
+  file.Store(*MakeData("a"), *MakeData("second"));
+  file.Store(*MakeData("b"), *MakeData("third"));
+  const size_t size = file.GetFileSize();
+
+  ASSERT_TRUE(file.Compact());
+  EXPECT_EQ(file.GetStaleBytes(), 0u);
+  EXPECT_LT(file.GetFileSize(), size);
+  EXPECT_EQ(ToString(file.Load(*MakeData("a"))), "second");
+  EXPECT_EQ(ToString(file.Load(*MakeData("b"))), "third");
+
+  // Appends still work after compacting.
+  EXPECT_TRUE(file.Store(*MakeData("c"), *MakeData("fourth")));
+  EXPECT_EQ(file.GetEntryCount(), 3u);
+}
+
+TEST_F(PackedCacheFileTest, StoringCompactsFilesThatAreMostlyStale) {
+  PackedCacheFile file(directory_, kFileName, false);
+  const std::string value(64 * 1024, 'x');
+  for (size_t i = 0; i * value.size() <= PackedCacheFile::kMinCompactionBytes;
+       i++) {
+    file.Store(*MakeData("a"), *MakeData(value));
+  }
+  EXPECT_EQ(file.GetStaleBytes(), 0u);
+  EXPECT_LT(file.GetFileSize(), 2 * value.size());
+}
+
+TEST_F(PackedCacheFileTest, DropsTornRecords) {
+  size_t intact_size;
+  {
+    PackedCacheFile file(directory_, kFileName, false);
+    file.Store(*MakeData("a"), *MakeData("first"));
+    intact_size = file.GetFileSize();
+    file.Store(*MakeData("b"), *MakeData("second"));
+  }
+  {
+    auto fd = fml::OpenFile(*directory_, kFileName, false,
+                            fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(fd, intact_size + 20));
+  }
+
+  PackedCacheFile file(directory_, kFileName, false);
+  EXPECT_EQ(file.GetEntryCount(), 1u);
+  EXPECT_EQ(file.GetFileSize(), intact_size);
+  EXPECT_TRUE(file.Store(*MakeData("c"), *MakeData("third")));
+
+  PackedCacheFile reopened(directory_, kFileName, true);
+  EXPECT_EQ(ToString(reopened.Load(*MakeData("a"))), "first");
+  EXPECT_EQ(reopened.Load(*MakeData("b")), nullptr);
+  EXPECT_EQ(ToString(reopened.Load(*MakeData("c"))), "third");
+}
+
+TEST_F(PackedCacheFileTest, EmptiesFilesInAnotherFormat) {
+  ASSERT_TRUE(fml::WriteAtomically(*directory_, kFileName,
+                                   fml::DataMapping("not a pack file")));
+
+  PackedCacheFile read_only(directory_, kFileName, true);
+  EXPECT_FALSE(read_only.IsValid());
+
+  PackedCacheFile file(directory_, kFileName, false);
+  EXPECT_TRUE(file.IsValid());
+  EXPECT_EQ(file.GetEntryCount(), 0u);
+  EXPECT_TRUE(file.Store(*MakeData("a"), *MakeData("first")));
+}
+
+TEST_F(PackedCacheFileTest, AppendsQueuedEntriesWhenFlushed) {
+  {
+    PackedCacheFile file(directory_, kFileName, false);
+    ASSERT_TRUE(file.IsValid());
+    const size_t empty_size = file.GetFileSize();
+    EXPECT_TRUE(file.StoreLater(MakeData("a"), MakeData("first")));
+    EXPECT_FALSE(file.StoreLater(MakeData("b"), MakeData("second")));
+    EXPECT_FALSE(file.StoreLater(MakeData("a"), MakeData("third")));
+
+    // Queued entries are loaded before they are written.
+    EXPECT_EQ(file.GetPendingCount(), 2u);
+    EXPECT_EQ(file.GetFileSize(), empty_size);
+    EXPECT_EQ(ToString(file.Load(*MakeData("a"))), "third");
+
+    EXPECT_TRUE(file.Flush());
+    EXPECT_EQ(file.GetPendingCount(), 0u);
+    EXPECT_EQ(file.GetEntryCount(), 2u);
+    EXPECT_EQ(file.GetStaleBytes(), 0u);
+
+    // Destroying the file flushes the entries still queued.
+    EXPECT_TRUE(file.StoreLater(MakeData("c"), MakeData("fourth")));
+  }
+
+  PackedCacheFile reopened(directory_, kFileName, false);
+  EXPECT_EQ(reopened.GetEntryCount(), 3u);
+  EXPECT_EQ(ToString(reopened.Load(*MakeData("a"))), "third");
+  EXPECT_EQ(ToString(reopened.Load(*MakeData("b"))), "second");
+  EXPECT_EQ(ToString(reopened.Load(*MakeData("c"))), "fourth");
+}
+
+TEST_F(PackedCacheFileTest, EvictsTheLeastRecentlyUsedEntriesOverBudget) {
+  const std::string value(1000, 'x');
+  PackedCacheFile file(directory_, kFileName, false);
+  ASSERT_TRUE(file.IsValid());
+  file.SetMaxBytes(3500);
+  EXPECT_TRUE(file.Store(*MakeData("a"), *MakeData(value)));
+  EXPECT_TRUE(file.Store(*MakeData("b"), *MakeData(value)));
+  EXPECT_TRUE(file.Store(*MakeData("c"), *MakeData(value)));
+  // Makes "a" more recently used than "b" and "c".
+  EXPECT_NE(file.Load(*MakeData("a")), nullptr);
+  EXPECT_TRUE(file.Store(*MakeData("d"), *MakeData(value)));
+
+  // Evicting down to three quarters of the budget leaves two entries.
+  EXPECT_EQ(file.GetEntryCount(), 2u);
+  EXPECT_EQ(file.GetStaleBytes(), 0u);
+  EXPECT_NE(file.Load(*MakeData("a")), nullptr);
+  EXPECT_EQ(file.Load(*MakeData("b")), nullptr);
+  EXPECT_EQ(file.Load(*MakeData("c")), nullptr);
+  EXPECT_NE(file.Load(*MakeData("d")), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
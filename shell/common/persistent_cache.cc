@@ -4,6 +4,7 @@
 
 #include "flutter/shell/common/persistent_cache.h"
 
+#include <cstring>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -11,12 +12,16 @@
 #include "rapidjson/document.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 
+#include "flutter/fml/async_file_io.h"
 #include "flutter/fml/base32.h"
+#include "flutter/fml/closure.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/version/version.h"
 
@@ -50,6 +55,9 @@ bool PersistentCache::gIsReadOnly = false;
 
 std::atomic<bool> PersistentCache::cache_sksl_ = false;
 std::atomic<bool> PersistentCache::strategy_set_ = false;
+std::atomic<bool> PersistentCache::pack_entries_ = false;
+std::atomic<int64_t> PersistentCache::precompilation_budget_us_ = 0;
+std::atomic<size_t> PersistentCache::max_packed_bytes_ = 0;
 
 void PersistentCache::SetCacheSkSL(bool value) {
   if (strategy_set_ && value != cache_sksl_) {
@@ -154,23 +162,67 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
-  fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
-                                       const std::string& filename) {
-    sk_sp<SkData> key = ParseBase32(filename);
-    sk_sp<SkData> data = LoadFile(directory, filename);
-    if (key != nullptr && data != nullptr) {
-      result.push_back({key, data});
-    } else {
-      FML_LOG(ERROR) << "Failed to load: " << filename;
-    }
-    return true;
-  };
 
   // Only visit sksl_cache_directory_ if this persistent cache is valid.
   // However, we'd like to continue visit the asset dir even if this persistent
   // cache is invalid.
   if (IsValid()) {
+    std::shared_ptr<PackedCacheFile> packed_file;
+    if (pack_entries_) {
+      packed_file = GetPackedFile(true);
+      result = packed_file->LoadAll();
+    }
+
+    std::vector<std::string> filenames;
+    fml::FileVisitor visitor = [&filenames](const fml::UniqueFD& directory,
+                                            const std::string& filename) {
+      // Skips the packed file and the temporary file it is compacted into.
+      if (filename.compare(0, sizeof(kPackedFileName) - 1, kPackedFileName) !=
+          0) {
+        filenames.push_back(filename);
+      }
+      return true;
+    };
     fml::VisitFiles(*sksl_cache_directory_, visitor);
+
+    // There may be hundreds of shaders, so read them all in one batch instead
+    // of one file after the other.
+    std::vector<sk_sp<SkData>> data(filenames.size());
+    std::vector<fml::AsyncFileIO::ReadRequest> requests;
+    requests.reserve(filenames.size());
+    fml::CountDownLatch latch(filenames.size());
+    for (size_t i = 0; i < filenames.size(); i++) {
+      auto callback = [&data, &latch, i](std::unique_ptr<fml::Mapping> file) {
+        if (file && file->GetSize() > 0) {
+          data[i] = SkData::MakeWithCopy(file->GetMapping(), file->GetSize());
+        }
+        latch.CountDown();
+      };
+      requests.push_back({filenames[i], std::move(callback)});
+    }
+    fml::AsyncFileIO::Create()->ReadBatch(*sksl_cache_directory_,
+                                          std::move(requests), nullptr);
+    latch.Wait();
+
+    std::vector<std::string> migrated;
+    for (size_t i = 0; i < filenames.size(); i++) {
+      sk_sp<SkData> key = ParseBase32(filenames[i]);
+      if (key != nullptr && data[i] != nullptr) {
+        result.push_back({key, data[i]});
+        if (packed_file) {
+          packed_file->StoreLater(key, data[i]);
+          migrated.push_back(filenames[i]);
+        }
+      } else {
+        FML_LOG(ERROR) << "Failed to load: " << filenames[i];
+      }
+    }
+    // Moves the entries into the packed file, with a single append.
+    if (!migrated.empty() && packed_file->Flush()) {
+      for (const std::string& filename : migrated) {
+        fml::UnlinkFile(*sksl_cache_directory_, filename.c_str());
+      }
+    }
   }
 
   std::unique_ptr<fml::Mapping> mapping = nullptr;
@@ -239,6 +291,15 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (!IsValid()) {
     return nullptr;
   }
+  if (IsVkPipelineCacheKey(key)) {
+    return LoadVkPipelineCache();
+  }
+  if (pack_entries_) {
+    if (auto result = GetPackedFile(false)->Load(key)) {
+      TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
+      return result;
+    }
+  }
   auto file_name = SkKeyToFilePath(key);
   if (file_name.size() == 0) {
     return nullptr;
@@ -252,14 +313,31 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   return result;
 }
 
+static void RunOnWorker(fml::RefPtr<fml::TaskRunner> worker,
+                        fml::closure task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(std::move(task));
+  }
+}
+
 static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
                                  std::shared_ptr<fml::UniqueFD> cache_directory,
                                  std::string key,
                                  std::unique_ptr<fml::Mapping> value) {
+  // Charges the data to the "PersistentCache" counter until it's written.
+  fml::MemoryCharge memory_charge(fml::MemoryCounter::Get("PersistentCache"),
+                                  value->GetSize());
   auto task =
-      fml::MakeCopyable([cache_directory,             //
-                         file_name = std::move(key),  //
-                         mapping = std::move(value)   //
+      fml::MakeCopyable([cache_directory,                          //
+                         file_name = std::move(key),               //
+                         mapping = std::move(value),               //
+                         memory_charge = std::move(memory_charge)  //
   ]() mutable {
         TRACE_EVENT0("flutter", "PersistentCacheStore");
         if (!fml::WriteAtomically(*cache_directory,   //
@@ -270,20 +348,44 @@ static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
               << "Could not write cache contents to persistent store.";
         }
       });
+  RunOnWorker(std::move(worker), std::move(task));
+}
 
+// How long the entries stored into a packed file are queued before they are
+// written, so that a burst of new shaders is appended at once.
+static constexpr fml::TimeDelta kPackedStoreDelay =
+    fml::TimeDelta::FromMilliseconds(500);
+
+static void PersistentCachePackedStore(
+    fml::RefPtr<fml::TaskRunner> worker,
+    std::shared_ptr<PackedCacheFile> packed_file,
+    sk_sp<SkData> key,
+    sk_sp<SkData> value) {
+  if (!packed_file->StoreLater(std::move(key), std::move(value))) {
+    // The flush of the entries queued before is still to come.
+    return;
+  }
+  auto task = [packed_file = std::move(packed_file)]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStore");
+    if (!packed_file->Flush()) {
+      FML_DLOG(WARNING)
+          << "Could not write cache contents to persistent store.";
+    }
+  };
   if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
+    RunOnWorker(std::move(worker), std::move(task));
+    return;
   }
+  worker->PostDelayedTask(std::move(task), kPackedStoreDelay);
 }
 
 // |GrContextOptions::PersistentCache|
 void PersistentCache::store(const SkData& key, const SkData& data) {
+  if (IsVkPipelineCacheKey(key)) {
+    StoreVkPipelineCache(data);
+    return;
+  }
+
   stored_new_shaders_ = true;
 
   if (is_read_only_) {
@@ -294,6 +396,14 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
+  if (pack_entries_) {
+    PersistentCachePackedStore(GetWorkerTaskRunner(),
+                               GetPackedFile(cache_sksl_),
+                               SkData::MakeWithCopy(key.data(), key.size()),
+                               SkData::MakeWithCopy(data.data(), data.size()));
+    return;
+  }
+
   auto file_name = SkKeyToFilePath(key);
 
   if (file_name.size() == 0) {
@@ -312,6 +422,21 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
                        std::move(file_name), std::move(mapping));
 }
 
+void PersistentCache::FlushPendingStores() {
+  std::shared_ptr<PackedCacheFile> packed_file, packed_sksl_file;
+  {
+    std::scoped_lock lock(packed_files_mutex_);
+    packed_file = packed_file_;
+    packed_sksl_file = packed_sksl_file_;
+  }
+  if (packed_file) {
+    packed_file->Flush();
+  }
+  if (packed_sksl_file) {
+    packed_sksl_file->Flush();
+  }
+}
+
 void PersistentCache::DumpSkp(const SkData& data) {
   if (is_read_only_ || !IsValid()) {
     FML_LOG(ERROR) << "Could not dump SKP from read-only or invalid persistent "
@@ -330,6 +455,161 @@ void PersistentCache::DumpSkp(const SkData& data) {
                        std::move(file_name), std::move(mapping));
 }
 
+void PersistentCache::StoreShaderWarmUp(const SkData& data) {
+  if (is_read_only_ || !IsValid()) {
+    return;
+  }
+  auto mapping = std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>{data.bytes(), data.bytes() + data.size()});
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_,
+                       kShaderWarmUpFileName, std::move(mapping));
+}
+
+sk_sp<SkData> PersistentCache::LoadShaderWarmUp() {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadShaderWarmUp");
+  if (IsValid()) {
+    if (auto data = LoadFile(*cache_directory_, kShaderWarmUpFileName)) {
+      return data;
+    }
+  }
+  if (asset_manager_ != nullptr) {
+    auto mapping = asset_manager_->GetAsMapping(kShaderWarmUpFileName);
+    if (mapping != nullptr && mapping->GetSize() > 0) {
+      return SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+    }
+  }
+  return nullptr;
+}
+
+// Skia's |GrVkGpu::kPipelineCache_PersistentCacheKeyType|, which is the whole
+// key that the pipeline cache is loaded and stored under.
+static constexpr uint32_t kSkiaVkPipelineCacheKeyType = 1;
+
+// "FVPC", marking a pipeline cache file.
+static constexpr uint32_t kVkPipelineCacheMagic = 0x43505646;
+
+// Precedes the data of the pipeline cache in its file.
+struct VkPipelineCacheFileHeader {
+  uint32_t magic;
+  uint32_t vendor_id;
+  uint32_t device_id;
+  uint32_t driver_version;
+  uint64_t data_size;
+};
+
+bool PersistentCache::IsVkPipelineCacheKey(const SkData& key) {
+  return key.size() == sizeof(kSkiaVkPipelineCacheKeyType) &&
+         memcmp(key.data(), &kSkiaVkPipelineCacheKeyType, key.size()) == 0;
+}
+
+void PersistentCache::SetVkPipelineCacheDevice(uint32_t vendor_id,
+                                               uint32_t device_id,
+                                               uint32_t driver_version) {
+  std::scoped_lock lock(vk_pipeline_cache_mutex_);
+  vk_pipeline_cache_device_ = {vendor_id, device_id, driver_version};
+}
+
+sk_sp<SkData> PersistentCache::LoadVkPipelineCache() {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadVkPipelineCache");
+  std::scoped_lock lock(vk_pipeline_cache_mutex_);
+  if (!vk_pipeline_cache_device_) {
+    return nullptr;
+  }
+  sk_sp<SkData> file = LoadFile(*cache_directory_, kVkPipelineCacheFileName);
+  if (file == nullptr) {
+    return nullptr;
+  }
+
+  // Skia checks the vendor and device against the header that the driver
+  // writes, but not the driver version, with which the format of the data may
+  // change.
+  VkPipelineCacheFileHeader header = {};
+  if (file->size() >= sizeof(header)) {
+    memcpy(&header, file->data(), sizeof(header));
+  }
+  if (header.magic != kVkPipelineCacheMagic ||
+      header.vendor_id != vk_pipeline_cache_device_->vendor_id ||
+      header.device_id != vk_pipeline_cache_device_->device_id ||
+      header.driver_version != vk_pipeline_cache_device_->driver_version ||
+      header.data_size != file->size() - sizeof(header)) {
+    FML_LOG(INFO) << "Ignoring a Vulkan pipeline cache from another device or "
+                     "driver version.";
+    vk_pipeline_cache_stats_.rejected = true;
+    return nullptr;
+  }
+
+  vk_pipeline_cache_stats_.loaded = true;
+  vk_pipeline_cache_stats_.loaded_bytes = header.data_size;
+  FML_TRACE_COUNTER("flutter", "VkPipelineCache",
+                    reinterpret_cast<int64_t>(this),                       //
+                    "LoadedBytes", vk_pipeline_cache_stats_.loaded_bytes,  //
+                    "StoredBytes", vk_pipeline_cache_stats_.stored_bytes   //
+  );
+  return SkData::MakeWithCopy(file->bytes() + sizeof(header),
+                              header.data_size);
+}
+
+void PersistentCache::StoreVkPipelineCache(const SkData& data) {
+  TRACE_EVENT0("flutter", "PersistentCache::StoreVkPipelineCache");
+  if (is_read_only_ || data.size() == 0) {
+    return;
+  }
+  std::scoped_lock lock(vk_pipeline_cache_mutex_);
+  if (!vk_pipeline_cache_device_) {
+    return;
+  }
+  if (data.size() > kMaxVkPipelineCacheBytes) {
+    vk_pipeline_cache_stats_.oversized_store_count++;
+    return;
+  }
+
+  const VkPipelineCacheFileHeader header = {
+      kVkPipelineCacheMagic,                      // magic
+      vk_pipeline_cache_device_->vendor_id,       // vendor id
+      vk_pipeline_cache_device_->device_id,       // device id
+      vk_pipeline_cache_device_->driver_version,  // driver version
+      data.size(),                                // data size
+  };
+  std::vector<uint8_t> file(sizeof(header) + data.size());
+  memcpy(file.data(), &header, sizeof(header));
+  memcpy(file.data() + sizeof(header), data.data(), data.size());
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_,
+                       kVkPipelineCacheFileName,
+                       std::make_unique<fml::DataMapping>(std::move(file)));
+
+  vk_pipeline_cache_stats_.store_count++;
+  vk_pipeline_cache_stats_.stored_bytes = data.size();
+  FML_TRACE_COUNTER("flutter", "VkPipelineCache",
+                    reinterpret_cast<int64_t>(this),                       //
+                    "LoadedBytes", vk_pipeline_cache_stats_.loaded_bytes,  //
+                    "StoredBytes", vk_pipeline_cache_stats_.stored_bytes   //
+  );
+}
+
+void PersistentCache::StoreVkPipelineCacheWhenIdle(
+    sk_sp<GrContext> context,
+    fml::RefPtr<fml::TaskRunner> raster_task_runner) {
+  if (!context || context->backend() != GrBackendApi::kVulkan ||
+      vk_pipeline_cache_store_scheduled_.exchange(true)) {
+    return;
+  }
+  raster_task_runner->PostTaskWithPriority(
+      [context = std::move(context)]() {
+        GetCacheForProcess()->vk_pipeline_cache_store_scheduled_ = false;
+        if (!context->abandoned()) {
+          TRACE_EVENT0("flutter", "GrContext::storeVkPipelineCacheData");
+          context->storeVkPipelineCacheData();
+        }
+      },
+      fml::TaskPriority::kIdle);
+}
+
+PersistentCache::VkPipelineCacheStats
+PersistentCache::GetVkPipelineCacheStats() const {
+  std::scoped_lock lock(vk_pipeline_cache_mutex_);
+  return vk_pipeline_cache_stats_;
+}
+
 void PersistentCache::AddWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
   std::scoped_lock lock(worker_task_runners_mutex_);
@@ -356,6 +636,45 @@ fml::RefPtr<fml::TaskRunner> PersistentCache::GetWorkerTaskRunner() const {
   return worker;
 }
 
+void PersistentCache::StartPrecompilation(size_t total) {
+  std::scoped_lock lock(precompilation_mutex_);
+  precompilation_progress_ = {};
+  precompilation_progress_.total = total;
+}
+
+void PersistentCache::DidPrecompile(bool compiled) {
+  std::scoped_lock lock(precompilation_mutex_);
+  precompilation_progress_.processed++;
+  precompilation_progress_.compiled += compiled ? 1 : 0;
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SkSLPrecompilation",
+                    reinterpret_cast<int64_t>(this),                  //
+                    "Total", precompilation_progress_.total,          //
+                    "Processed", precompilation_progress_.processed,  //
+                    "Compiled", precompilation_progress_.compiled     //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
+PersistentCache::PrecompilationProgress
+PersistentCache::GetPrecompilationProgress() const {
+  std::scoped_lock lock(precompilation_mutex_);
+  return precompilation_progress_;
+}
+
+std::shared_ptr<PackedCacheFile> PersistentCache::GetPackedFile(bool sksl) {
+  std::scoped_lock lock(packed_files_mutex_);
+  std::shared_ptr<PackedCacheFile>& file =
+      sksl ? packed_sksl_file_ : packed_file_;
+  if (!file) {
+    file = std::make_shared<PackedCacheFile>(
+        sksl ? sksl_cache_directory_ : cache_directory_, kPackedFileName,
+        is_read_only_);
+    file->SetMaxBytes(max_packed_bytes_);
+  }
+  return file;
+}
+
 void PersistentCache::SetAssetManager(std::shared_ptr<AssetManager> value) {
   TRACE_EVENT_INSTANT0("flutter", "PersistentCache::SetAssetManager");
   asset_manager_ = value;
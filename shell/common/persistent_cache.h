@@ -7,12 +7,16 @@
 
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/shell/common/packed_cache_file.h"
+#include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/skia/include/gpu/GrContextOptions.h"
 
 namespace flutter {
@@ -74,8 +78,105 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   static void SetCacheSkSL(bool value);
   static void MarkStrategySet() { strategy_set_ = true; }
 
+  // Whether new entries are appended to a file packing all the entries of a
+  // cache directory, instead of being written to a file each. Loading reads
+  // the entries of the packed file first, then those in files of their own,
+  // which loading SkSLs moves into the packed file.
+  //
+  // The new entries are queued for a short while and appended together.
+  // |FlushPendingStores| writes them at once.
+  static bool pack_entries() { return pack_entries_; }
+  static void SetPackEntries(bool value) { pack_entries_ = value; }
+
+  // The bytes that the entries of each packed file may take, above which the
+  // least recently used ones are evicted. Zero doesn't limit them. This must
+  // be called before the packed files are first used.
+  static void SetMaxPackedBytes(size_t value) { max_packed_bytes_ = value; }
+
+  // Writes the entries queued to be appended to the packed files, on the
+  // calling thread.
+  void FlushPendingStores();
+
+  // How long precompiling the SkSLs loaded at startup may keep the raster
+  // thread busy at a time. The rest are precompiled in later tasks, between
+  // frames. Zero precompiles them all before the first frame.
+  static fml::TimeDelta precompilation_budget() {
+    return fml::TimeDelta::FromMicroseconds(precompilation_budget_us_);
+  }
+  static void SetPrecompilationBudget(fml::TimeDelta budget) {
+    precompilation_budget_us_ = budget.ToMicroseconds();
+  }
+
+  struct PrecompilationProgress {
+    // The number of SkSLs loaded to be precompiled.
+    size_t total = 0;
+    // The number of SkSLs that were tried.
+    size_t processed = 0;
+    // The number of SkSLs that Skia precompiled.
+    size_t compiled = 0;
+
+    bool done() const { return processed == total; }
+  };
+
+  // Records that precompiling |total| SkSLs has started.
+  void StartPrecompilation(size_t total);
+
+  // Records that one more SkSL was tried, and whether Skia precompiled it.
+  void DidPrecompile(bool compiled);
+
+  PrecompilationProgress GetPrecompilationProgress() const;
+
+  // Writes the draw ops recorded for shader warm-up by a training run,
+  // replacing those written before.
+  void StoreShaderWarmUp(const SkData& data);
+
+  // Loads the draw ops recorded for shader warm-up, from the cache directory
+  // or else from the assets. Returns null if there are none.
+  sk_sp<SkData> LoadShaderWarmUp();
+
+  // Skia loads the pipeline cache of the Vulkan driver through this cache when
+  // it creates its first pipeline, and stores it when
+  // |GrContext::storeVkPipelineCacheData| is called. It goes to a file of its
+  // own, along with the device it was created on, and is only loaded back on
+  // the same device and driver version. Until the device is set, the pipeline
+  // cache is neither loaded nor stored.
+  void SetVkPipelineCacheDevice(uint32_t vendor_id,
+                                uint32_t device_id,
+                                uint32_t driver_version);
+
+  // Stores the pipeline cache of |context| from an idle task of
+  // |raster_task_runner|, unless a store is already scheduled. Skia adds the
+  // pipelines it creates to the cache, so this is meant to be called after
+  // frames that stored new shaders. This does nothing for other backends.
+  void StoreVkPipelineCacheWhenIdle(
+      sk_sp<GrContext> context,
+      fml::RefPtr<fml::TaskRunner> raster_task_runner);
+
+  struct VkPipelineCacheStats {
+    // Whether the pipeline cache of a previous run was handed to Skia.
+    bool loaded = false;
+    // Whether a pipeline cache was found but not loaded, for being from
+    // another device or driver version, or malformed.
+    bool rejected = false;
+    size_t loaded_bytes = 0;
+    size_t store_count = 0;
+    size_t stored_bytes = 0;
+    // The stores dropped for being larger than |kMaxVkPipelineCacheBytes|.
+    size_t oversized_store_count = 0;
+  };
+
+  VkPipelineCacheStats GetVkPipelineCacheStats() const;
+
+  // The largest pipeline cache that is stored.
+  static constexpr size_t kMaxVkPipelineCacheBytes = 8 * 1024 * 1024;
+
   static constexpr char kSkSLSubdirName[] = "sksl";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kPackedFileName[] = "io.flutter.cache.pack";
+  static constexpr char kShaderWarmUpFileName[] =
+      "io.flutter.shader_warm_up.skp";
+  static constexpr char kVkPipelineCacheFileName[] =
+      "io.flutter.vk_pipeline_cache";
 
  private:
   static std::string cache_base_path_;
@@ -95,11 +196,35 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // strategy_set_ becomes true.
   static std::atomic<bool> strategy_set_;
 
+  static std::atomic<bool> pack_entries_;
+
+  static std::atomic<int64_t> precompilation_budget_us_;
+
+  static std::atomic<size_t> max_packed_bytes_;
+
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  // The packed files of |cache_directory_| and |sksl_cache_directory_|,
+  // opened when they are first used.
+  mutable std::mutex packed_files_mutex_;
+  std::shared_ptr<PackedCacheFile> packed_file_;
+  std::shared_ptr<PackedCacheFile> packed_sksl_file_;
+
+  mutable std::mutex precompilation_mutex_;
+  PrecompilationProgress precompilation_progress_;
+
+  struct VkPipelineCacheDevice {
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+  };
+  mutable std::mutex vk_pipeline_cache_mutex_;
+  std::optional<VkPipelineCacheDevice> vk_pipeline_cache_device_;
+  VkPipelineCacheStats vk_pipeline_cache_stats_;
+  std::atomic<bool> vk_pipeline_cache_store_scheduled_ = false;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -114,8 +239,20 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // |GrContextOptions::PersistentCache|
   void store(const SkData& key, const SkData& data) override;
 
+  // Whether |key| is the one Skia loads and stores the Vulkan pipeline cache
+  // under.
+  static bool IsVkPipelineCacheKey(const SkData& key);
+
+  sk_sp<SkData> LoadVkPipelineCache();
+
+  void StoreVkPipelineCache(const SkData& data);
+
   fml::RefPtr<fml::TaskRunner> GetWorkerTaskRunner() const;
 
+  // Returns the packed file of the SkSL cache directory if |sksl|, or of the
+  // cache directory otherwise.
+  std::shared_ptr<PackedCacheFile> GetPackedFile(bool sksl);
+
   FML_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
 };
 
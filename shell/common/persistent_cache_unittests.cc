@@ -240,5 +240,75 @@ TEST_F(ShellTest, CanRemoveOldPersistentCache) {
   fml::RemoveFilesInDirectory(base_dir.fd());
 }
 
+TEST_F(ShellTest, TracksSkSLPrecompilationProgress) {
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+
+  cache->StartPrecompilation(3);
+  cache->DidPrecompile(true);
+  cache->DidPrecompile(false);
+  PersistentCache::PrecompilationProgress progress =
+      cache->GetPrecompilationProgress();
+  EXPECT_EQ(progress.total, 3u);
+  EXPECT_EQ(progress.processed, 2u);
+  EXPECT_EQ(progress.compiled, 1u);
+  EXPECT_FALSE(progress.done());
+
+  cache->DidPrecompile(true);
+  progress = cache->GetPrecompilationProgress();
+  EXPECT_EQ(progress.compiled, 2u);
+  EXPECT_TRUE(progress.done());
+
+  // Starting again forgets the previous progress.
+  cache->StartPrecompilation(0);
+  progress = cache->GetPrecompilationProgress();
+  EXPECT_EQ(progress.processed, 0u);
+  EXPECT_TRUE(progress.done());
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(ShellTest, StoresVkPipelineCacheForTheSameDeviceOnly) {
+  fml::ScopedTemporaryDirectory base_dir;
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+  GrContextOptions::PersistentCache* skia_cache = cache;
+
+  // Skia loads and stores the pipeline cache under its key type alone.
+  const uint32_t key_type = 1;
+  sk_sp<SkData> key = SkData::MakeWithCopy(&key_type, sizeof(key_type));
+  sk_sp<SkData> data = SkData::MakeWithCString("pipelines");
+
+  // Nothing is stored until the device is known.
+  skia_cache->store(*key, *data);
+  EXPECT_EQ(cache->GetVkPipelineCacheStats().store_count, 0u);
+
+  cache->SetVkPipelineCacheDevice(1, 2, 3);
+  cache->ResetStoredNewShaders();
+  skia_cache->store(*key, *data);
+  EXPECT_EQ(cache->GetVkPipelineCacheStats().store_count, 1u);
+  // The pipeline cache is neither a shader nor an SkSL.
+  EXPECT_FALSE(cache->StoredNewShaders());
+  EXPECT_EQ(cache->LoadSkSLs().size(), 0u);
+
+  sk_sp<SkData> loaded = cache->load(*key);
+  ASSERT_TRUE(loaded);
+  EXPECT_TRUE(loaded->equals(data.get()));
+  EXPECT_TRUE(cache->GetVkPipelineCacheStats().loaded);
+  EXPECT_EQ(cache->GetVkPipelineCacheStats().loaded_bytes, data->size());
+
+  // Another driver version may not read the data the same way.
+  cache->SetVkPipelineCacheDevice(1, 2, 4);
+  EXPECT_FALSE(cache->load(*key));
+  EXPECT_TRUE(cache->GetVkPipelineCacheStats().rejected);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 }  // namespace testing
 }  // namespace flutter
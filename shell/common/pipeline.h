@@ -7,6 +7,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/trace_event.h"
 
@@ -26,6 +27,11 @@ size_t GetNextPipelineTraceID();
 
 /// A thread-safe queue of resources for a single consumer and a single
 /// producer.
+///
+/// A pipeline made with |latest_wins| never makes the consumer catch up on
+/// stale resources: a resource produced while another one is still queued
+/// replaces it, and the producer may produce even when the pipeline is full as
+/// long as there is a queued resource to replace.
 template <class R>
 class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
  public:
@@ -90,14 +96,22 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth, bool latest_wins = false)
+      : depth_(depth),
+        latest_wins_(latest_wins),
+        empty_(depth),
+        available_(0),
+        inflight_(0),
+        superseded_count_(0) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
   ProducerContinuation Produce() {
+    if (latest_wins_) {
+      return ProduceLatest();
+    }
     if (!empty_.TryWait()) {
       return {};
     }
@@ -148,10 +162,15 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     ResourcePtr resource;
     size_t trace_id = 0;
     size_t items_count = 0;
+    bool reserved = true;
 
     {
-      std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
+      auto lock = LockQueue();
+      QueueItem& item = queue_.front();
+      resource = std::move(item.resource);
+      trace_id = item.trace_id;
+      reserved = item.reserved;
+      superseded_count_ = item.superseded_count;
       queue_.pop_front();
       items_count = queue_.size();
     }
@@ -161,8 +180,10 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
       consumer(std::move(resource));
     }
 
-    empty_.Signal();
-    --inflight_;
+    if (reserved) {
+      empty_.Signal();
+      --inflight_;
+    }
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
@@ -171,18 +192,61 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
                            : PipelineConsumeResult::Done;
   }
 
+  /// The number of resources that the resource being consumed replaced in a
+  /// pipeline made with |latest_wins|. Only valid within the consumer.
+  size_t GetSupersededCount() const { return superseded_count_; }
+
  private:
+  struct QueueItem {
+    ResourcePtr resource;
+    size_t trace_id;
+    // Whether the item holds one of the |depth_| reservations.
+    bool reserved;
+    // The number of items this one replaced.
+    size_t superseded_count;
+  };
+
   const uint32_t depth_;
+  const bool latest_wins_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
   std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  std::deque<QueueItem> queue_;
+  size_t superseded_count_;
+
+  std::unique_lock<std::mutex> LockQueue() {
+    static fml::SyncProfiler::Site site("Pipeline::queue_mutex");
+    return fml::SyncProfiler::Lock(queue_mutex_, site);
+  }
+
+  ProducerContinuation ProduceLatest() {
+    bool reserved = empty_.TryWait();
+    if (!reserved) {
+      // A full pipeline can still take a resource that replaces a queued one.
+      auto lock = LockQueue();
+      if (queue_.empty()) {
+        return {};
+      }
+    } else {
+      ++inflight_;
+      FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                        reinterpret_cast<int64_t>(this),      //
+                        "frames in flight", inflight_.load()  //
+      );
+    }
+
+    return ProducerContinuation{
+        [this, reserved](ResourcePtr resource, size_t trace_id) {
+          return ProducerCommitLatest(std::move(resource), trace_id, reserved);
+        },                          // continuation
+        GetNextPipelineTraceID()};  // trace id
+  }
 
   bool ProducerCommit(ResourcePtr resource, size_t trace_id) {
     {
-      std::scoped_lock lock(queue_mutex_);
-      queue_.emplace_back(std::move(resource), trace_id);
+      auto lock = LockQueue();
+      queue_.push_back({std::move(resource), trace_id, true, 0});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -192,14 +256,14 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
   bool ProducerCommitIfEmpty(ResourcePtr resource, size_t trace_id) {
     {
-      std::scoped_lock lock(queue_mutex_);
+      auto lock = LockQueue();
       if (!queue_.empty()) {
         // Bail if the queue is not empty, opens up spaces to produce other
         // frames.
         empty_.Signal();
         return false;
       }
-      queue_.emplace_back(std::move(resource), trace_id);
+      queue_.push_back({std::move(resource), trace_id, true, 0});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -207,6 +271,54 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     return true;
   }
 
+  bool ProducerCommitLatest(ResourcePtr resource,
+                            size_t trace_id,
+                            bool reserved) {
+    bool release_reservation = false;
+    bool pushed = false;
+    size_t superseded_trace_id = 0;
+    // Destroyed once the queue mutex is released.
+    ResourcePtr superseded;
+    {
+      auto lock = LockQueue();
+      if (!resource) {
+        // A dropped continuation must not replace a queued resource.
+        release_reservation = reserved;
+      } else if (!queue_.empty()) {
+        QueueItem& stale = queue_.back();
+        superseded_trace_id = stale.trace_id;
+        superseded = std::move(stale.resource);
+        stale.resource = std::move(resource);
+        stale.trace_id = trace_id;
+        stale.superseded_count++;
+        // The queued item keeps one reservation between the two.
+        release_reservation = reserved && stale.reserved;
+        stale.reserved = stale.reserved || reserved;
+      } else {
+        // The consumer took the queued resource in the meantime. If this one
+        // was produced without a reservation, the pipeline briefly holds one
+        // resource more than its depth.
+        queue_.push_back({std::move(resource), trace_id, reserved, 0});
+        pushed = true;
+      }
+    }
+
+    if (release_reservation) {
+      empty_.Signal();
+      --inflight_;
+    }
+    if (superseded_trace_id != 0) {
+      TRACE_EVENT_INSTANT0("flutter", "PipelineItemSuperseded");
+      TRACE_FLOW_END("flutter", "PipelineItem", superseded_trace_id);
+      TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", superseded_trace_id);
+    }
+    if (pushed) {
+      // Ensure the queue mutex is not held as that would be a pessimization.
+      available_.Signal();
+    }
+    return pushed || superseded_trace_id != 0;
+  }
+
   FML_DISALLOW_COPY_AND_ASSIGN(Pipeline);
 };
 
@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/ring_pipeline.h"
+
+namespace flutter {
+
+// Produces and consumes a resource on the same thread, which measures the
+// overhead of the pipeline itself.
+template <class P>
+static void BM_PipelineProduceConsume(benchmark::State& state) {
+  auto pipeline = fml::MakeRefCounted<P>(2);
+  typename P::Consumer consumer = [](std::unique_ptr<int> resource) {
+    benchmark::DoNotOptimize(resource);
+  };
+  while (state.KeepRunning()) {
+    auto continuation = pipeline->Produce();
+    bool result = continuation.Complete(std::make_unique<int>(1));
+    benchmark::DoNotOptimize(result);
+    PipelineConsumeResult consume_result = pipeline->Consume(consumer);
+    benchmark::DoNotOptimize(consume_result);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_PipelineProduceConsume, Pipeline<int>);
+BENCHMARK_TEMPLATE(BM_PipelineProduceConsume, RingPipeline<int>);
+
+// Hands resources from a producer thread to a consumer thread that polls the
+// pipeline, one at a time, which measures the handoff latency.
+template <class P>
+static void BM_PipelineHandoff(benchmark::State& state) {
+  auto pipeline = fml::MakeRefCounted<P>(2);
+  std::atomic<bool> done = {false};
+  std::atomic<int> consumed = {0};
+  std::thread consumer_thread([&]() {
+    typename P::Consumer consumer = [&](std::unique_ptr<int> resource) {
+      consumed.fetch_add(1, std::memory_order_release);
+    };
+    while (!done.load(std::memory_order_relaxed)) {
+      PipelineConsumeResult result = pipeline->Consume(consumer);
+      benchmark::DoNotOptimize(result);
+    }
+  });
+
+  int produced = 0;
+  while (state.KeepRunning()) {
+    auto continuation = pipeline->Produce();
+    bool result = continuation.Complete(std::make_unique<int>(produced++));
+    benchmark::DoNotOptimize(result);
+    while (consumed.load(std::memory_order_acquire) < produced) {
+    }
+  }
+
+  done = true;
+  consumer_thread.join();
+}
+
+BENCHMARK_TEMPLATE(BM_PipelineHandoff, Pipeline<int>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PipelineHandoff, RingPipeline<int>)->UseRealTime();
+
+}  // namespace flutter
@@ -130,5 +130,83 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, LatestWinsReplacesQueuedResource) {
+  const int depth = 2;
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(depth, true);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  bool result = continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result, true);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, true);
+
+  PipelineConsumeResult consume_result_1 =
+      pipeline->Consume([&](std::unique_ptr<int> v) {
+        ASSERT_EQ(*v, test_val_2);
+        ASSERT_EQ(pipeline->GetSupersededCount(), 1u);
+      });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::NoneAvailable);
+
+  // Both reservations were given back.
+  Continuation continuation_3 = pipeline->Produce();
+  Continuation continuation_4 = pipeline->Produce();
+  ASSERT_TRUE(continuation_3);
+  ASSERT_TRUE(continuation_4);
+}
+
+TEST(PipelineTest, LatestWinsProducesIntoAFullPipeline) {
+  const int depth = 1;
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(depth, true);
+
+  Continuation continuation_1 = pipeline->Produce();
+  // Nothing is queued that a second resource could replace.
+  ASSERT_FALSE(pipeline->Produce());
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+
+  for (int i = 2; i <= 4; i++) {
+    Continuation continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation);
+    ASSERT_TRUE(continuation.Complete(std::make_unique<int>(i)));
+  }
+
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([&](std::unique_ptr<int> v) {
+        ASSERT_EQ(*v, 4);
+        ASSERT_EQ(pipeline->GetSupersededCount(), 3u);
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+
+  // The single reservation is free again.
+  Continuation continuation_5 = pipeline->Produce();
+  ASSERT_TRUE(continuation_5);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, LatestWinsDroppedContinuationKeepsQueuedResource) {
+  const int depth = 2;
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(depth, true);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(1)));
+  { Continuation dropped = pipeline->Produce(); }
+
+  PipelineConsumeResult consume_result =
+      pipeline->Consume([&](std::unique_ptr<int> v) {
+        ASSERT_EQ(*v, 1);
+        ASSERT_EQ(pipeline->GetSupersededCount(), 0u);
+      });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+}
+
 }  // namespace testing
 }  // namespace flutter
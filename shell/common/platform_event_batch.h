@@ -0,0 +1,45 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PLATFORM_EVENT_BATCH_H_
+#define FLUTTER_SHELL_COMMON_PLATFORM_EVENT_BATCH_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/lib/ui/window/platform_message.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+#include "flutter/lib/ui/window/viewport_metrics.h"
+
+namespace flutter {
+
+/// Events of different kinds sent by the embedder at the same time, which are
+/// delivered to the engine together by a single task on the UI thread instead
+/// of a task per event.
+///
+/// The events are applied in a fixed order: the viewport metrics first, so
+/// that the other events see the new size of the view, then the platform
+/// messages in the order they were added, then the pointer data as a single
+/// packet.
+struct PlatformEventBatch {
+  /// The latest viewport metrics of the batch, if it changes them.
+  std::optional<ViewportMetrics> viewport_metrics;
+
+  /// The platform messages of the batch, in the order they were sent.
+  std::vector<fml::RefPtr<PlatformMessage>> platform_messages;
+
+  /// The pointer events of the batch, or null if it has none.
+  std::unique_ptr<PointerDataPacket> pointer_data_packet;
+
+  /// Whether there is nothing to deliver.
+  bool IsEmpty() const {
+    return !viewport_metrics && platform_messages.empty() &&
+           (!pointer_data_packet || pointer_data_packet->data().empty());
+  }
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PLATFORM_EVENT_BATCH_H_
@@ -0,0 +1,144 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_buffers.h"
+
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+PlatformMessageBuffers::PlatformMessageBuffers() = default;
+
+PlatformMessageBuffers::~PlatformMessageBuffers() = default;
+
+void PlatformMessageBuffers::ConfigureChannel(const std::string& channel,
+                                              const ChannelConfig& config) {
+  std::scoped_lock lock(mutex_);
+  auto found = channels_.find(channel);
+  if (config.capacity == 0) {
+    // The pending drain task removes the channel once it has delivered the
+    // queued messages the way they were queued for.
+    if (found != channels_.end()) {
+      if (found->second.drain_pending) {
+        found->second.config.capacity = 0;
+      } else {
+        channels_.erase(found);
+      }
+    }
+    drained_condition_.notify_all();
+    return;
+  }
+
+  Channel& buffered_channel = channels_[channel];
+  buffered_channel.config = config;
+  while (buffered_channel.messages.size() > config.capacity) {
+    DropMessage(std::move(buffered_channel.messages.front()));
+    buffered_channel.messages.pop_front();
+  }
+  drained_condition_.notify_all();
+}
+
+PlatformMessageBuffers::PushResult PlatformMessageBuffers::Push(
+    const fml::RefPtr<PlatformMessage>& message,
+    bool can_block) {
+  std::unique_lock lock(mutex_);
+  auto found = channels_.find(message->channel());
+  if (shutdown_ || found == channels_.end() ||
+      found->second.config.capacity == 0) {
+    return PushResult::kNotBuffered;
+  }
+
+  Channel* channel = &found->second;
+  if (channel->messages.size() >= channel->config.capacity) {
+    switch (channel->config.overflow_policy) {
+      case OverflowPolicy::kBlockProducer:
+        if (can_block) {
+          TRACE_EVENT0("flutter", "PlatformMessageBuffers::WaitForDrain");
+          drained_condition_.wait(lock, [&]() {
+            auto current = channels_.find(message->channel());
+            return shutdown_ || current == channels_.end() ||
+                   current->second.messages.size() <
+                       current->second.config.capacity;
+          });
+          // The channel may have been removed or reconfigured meanwhile.
+          found = channels_.find(message->channel());
+          if (shutdown_ || found == channels_.end() ||
+              found->second.config.capacity == 0) {
+            return PushResult::kNotBuffered;
+          }
+          channel = &found->second;
+          break;
+        }
+        [[fallthrough]];
+      case OverflowPolicy::kDropOldest:
+        DropMessage(std::move(channel->messages.front()));
+        channel->messages.pop_front();
+        break;
+      case OverflowPolicy::kCoalesceLatest:
+        DropMessage(std::move(channel->messages.back()));
+        channel->messages.pop_back();
+        break;
+    }
+  }
+
+  channel->messages.push_back(message);
+  if (channel->drain_pending) {
+    return PushResult::kQueued;
+  }
+  channel->drain_pending = true;
+  return PushResult::kNeedsDrain;
+}
+
+PlatformMessageBuffers::DrainedMessages PlatformMessageBuffers::Drain(
+    const std::string& channel) {
+  DrainedMessages drained;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = channels_.find(channel);
+    if (found == channels_.end()) {
+      return drained;
+    }
+    drained.messages.assign(
+        std::make_move_iterator(found->second.messages.begin()),
+        std::make_move_iterator(found->second.messages.end()));
+    drained.batch_delivery = found->second.config.batch_delivery;
+    if (found->second.config.capacity == 0) {
+      channels_.erase(found);
+    } else {
+      found->second.messages.clear();
+      found->second.drain_pending = false;
+    }
+  }
+  drained_condition_.notify_all();
+  return drained;
+}
+
+size_t PlatformMessageBuffers::GetDroppedMessageCount() const {
+  std::scoped_lock lock(mutex_);
+  return dropped_message_count_;
+}
+
+void PlatformMessageBuffers::Shutdown() {
+  {
+    std::scoped_lock lock(mutex_);
+    shutdown_ = true;
+  }
+  drained_condition_.notify_all();
+}
+
+void PlatformMessageBuffers::DropMessage(
+    fml::RefPtr<PlatformMessage> message) {
+  dropped_message_count_++;
+  FML_TRACE_COUNTER("flutter", "PlatformMessageBuffers",
+                    reinterpret_cast<int64_t>(this),          //
+                    "DroppedMessages", dropped_message_count_  //
+  );
+  if (auto response = message->response()) {
+    response->CompleteEmpty();
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BUFFERS_H_
+#define FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BUFFERS_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/window/platform_message.h"
+
+namespace flutter {
+
+/// Bounded queues for the platform messages of high rate channels, like
+/// sensor streams, on their way from the platform thread to the UI thread.
+///
+/// Messages of channels without a queue are each dispatched in a UI task of
+/// their own. Messages of channels with a queue are dispatched together by a
+/// single UI task that drains the queue, which is only posted when the first
+/// message is queued. A queue that fills up before the UI thread gets to it
+/// overflows according to the policy of its channel.
+///
+/// Thread safe. Messages are pushed on the platform thread and drained on the
+/// UI thread.
+class PlatformMessageBuffers {
+ public:
+  enum class OverflowPolicy {
+    // The oldest queued message is dropped to make room.
+    kDropOldest,
+    // The producer waits for the queue to be drained. Where the producer runs
+    // on the UI thread, the oldest message is dropped instead.
+    kBlockProducer,
+    // The most recently queued message is replaced, so that only the latest
+    // state of the channel is delivered.
+    kCoalesceLatest,
+  };
+
+  struct ChannelConfig {
+    // The most messages queued at once. Zero removes the queue.
+    size_t capacity = 0;
+    OverflowPolicy overflow_policy = OverflowPolicy::kDropOldest;
+    // Whether the drained messages are handed to Dart in a single call
+    // instead of one call per message.
+    bool batch_delivery = false;
+  };
+
+  enum class PushResult {
+    // The channel has no queue, the message must be dispatched by the caller.
+    kNotBuffered,
+    // The message is the first in the queue, the caller must schedule a call
+    // to |Drain|.
+    kNeedsDrain,
+    // The message joined messages that are already going to be drained.
+    kQueued,
+  };
+
+  struct DrainedMessages {
+    std::vector<fml::RefPtr<PlatformMessage>> messages;
+    bool batch_delivery = false;
+  };
+
+  PlatformMessageBuffers();
+
+  ~PlatformMessageBuffers();
+
+  /// Sets the queue of |channel| up, or removes it for a capacity of zero.
+  /// Messages already queued are still drained.
+  void ConfigureChannel(const std::string& channel,
+                        const ChannelConfig& config);
+
+  /// Queues |message| if its channel has a queue. Messages dropped because
+  /// of an overflow are completed with an empty response.
+  ///
+  /// @param[in]  can_block  Whether the caller may wait for a drain on a
+  ///                        channel with the `kBlockProducer` policy.
+  PushResult Push(const fml::RefPtr<PlatformMessage>& message,
+                  bool can_block);
+
+  /// Takes the queued messages of |channel|, in the order they were pushed.
+  DrainedMessages Drain(const std::string& channel);
+
+  /// The number of messages dropped or replaced because of overflows so far.
+  size_t GetDroppedMessageCount() const;
+
+  /// Wakes up and turns away blocked producers. Messages pushed afterwards
+  /// are not buffered.
+  void Shutdown();
+
+ private:
+  struct Channel {
+    ChannelConfig config;
+    std::deque<fml::RefPtr<PlatformMessage>> messages;
+    bool drain_pending = false;
+  };
+
+  mutable std::mutex mutex_;
+  std::condition_variable drained_condition_;
+  std::unordered_map<std::string, Channel> channels_;
+  size_t dropped_message_count_ = 0;
+  bool shutdown_ = false;
+
+  void DropMessage(fml::RefPtr<PlatformMessage> message);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageBuffers);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BUFFERS_H_
@@ -0,0 +1,168 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_buffers.h"
+
+#include <thread>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class CountingResponse : public PlatformMessageResponse {
+ public:
+  void Complete(std::unique_ptr<fml::Mapping> data) override { completed_++; }
+  void CompleteEmpty() override { empty_completed_++; }
+
+  size_t completed_ = 0;
+  size_t empty_completed_ = 0;
+};
+
+fml::RefPtr<PlatformMessage> MakeMessage(
+    uint8_t value,
+    fml::RefPtr<PlatformMessageResponse> response = nullptr) {
+  return fml::MakeRefCounted<PlatformMessage>(
+      "sensor", std::vector<uint8_t>{value}, std::move(response));
+}
+
+uint8_t GetValue(const fml::RefPtr<PlatformMessage>& message) {
+  return message->data().GetMapping()[0];
+}
+
+PlatformMessageBuffers::ChannelConfig MakeConfig(
+    size_t capacity,
+    PlatformMessageBuffers::OverflowPolicy policy) {
+  PlatformMessageBuffers::ChannelConfig config;
+  config.capacity = capacity;
+  config.overflow_policy = policy;
+  return config;
+}
+
+}  // namespace
+
+TEST(PlatformMessageBuffersTest, ChannelsWithoutQueueAreNotBuffered) {
+  PlatformMessageBuffers buffers;
+  ASSERT_EQ(buffers.Push(MakeMessage(1), false),
+            PlatformMessageBuffers::PushResult::kNotBuffered);
+}
+
+TEST(PlatformMessageBuffersTest, OnlyFirstQueuedMessageNeedsDrain) {
+  PlatformMessageBuffers buffers;
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(4, PlatformMessageBuffers::OverflowPolicy::kDropOldest));
+
+  ASSERT_EQ(buffers.Push(MakeMessage(1), false),
+            PlatformMessageBuffers::PushResult::kNeedsDrain);
+  ASSERT_EQ(buffers.Push(MakeMessage(2), false),
+            PlatformMessageBuffers::PushResult::kQueued);
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 2u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 1u);
+  ASSERT_EQ(GetValue(drained.messages[1]), 2u);
+
+  ASSERT_EQ(buffers.Push(MakeMessage(3), false),
+            PlatformMessageBuffers::PushResult::kNeedsDrain);
+}
+
+TEST(PlatformMessageBuffersTest, DropOldestRespondsToDroppedMessages) {
+  PlatformMessageBuffers buffers;
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(2, PlatformMessageBuffers::OverflowPolicy::kDropOldest));
+  auto response = fml::MakeRefCounted<CountingResponse>();
+
+  buffers.Push(MakeMessage(1, response), false);
+  buffers.Push(MakeMessage(2), false);
+  buffers.Push(MakeMessage(3), false);
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 2u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 2u);
+  ASSERT_EQ(GetValue(drained.messages[1]), 3u);
+  ASSERT_EQ(response->empty_completed_, 1u);
+  ASSERT_EQ(buffers.GetDroppedMessageCount(), 1u);
+}
+
+TEST(PlatformMessageBuffersTest, CoalesceLatestReplacesNewestMessage) {
+  PlatformMessageBuffers buffers;
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(2, PlatformMessageBuffers::OverflowPolicy::kCoalesceLatest));
+
+  buffers.Push(MakeMessage(1), false);
+  buffers.Push(MakeMessage(2), false);
+  buffers.Push(MakeMessage(3), false);
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 2u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 1u);
+  ASSERT_EQ(GetValue(drained.messages[1]), 3u);
+}
+
+TEST(PlatformMessageBuffersTest, BlockProducerWaitsForDrain) {
+  PlatformMessageBuffers buffers;
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(1, PlatformMessageBuffers::OverflowPolicy::kBlockProducer));
+  buffers.Push(MakeMessage(1), true);
+
+  fml::AutoResetWaitableEvent pushed;
+  std::thread producer([&]() {
+    buffers.Push(MakeMessage(2), true);
+    pushed.Signal();
+  });
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 1u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 1u);
+
+  pushed.Wait();
+  producer.join();
+  drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 1u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 2u);
+  ASSERT_EQ(buffers.GetDroppedMessageCount(), 0u);
+}
+
+TEST(PlatformMessageBuffersTest, BlockProducerDropsOldestWhenItCannotBlock) {
+  PlatformMessageBuffers buffers;
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(1, PlatformMessageBuffers::OverflowPolicy::kBlockProducer));
+  buffers.Push(MakeMessage(1), false);
+  buffers.Push(MakeMessage(2), false);
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 1u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 2u);
+}
+
+TEST(PlatformMessageBuffersTest, RemovedChannelsDeliverQueuedMessages) {
+  PlatformMessageBuffers buffers;
+  auto config =
+      MakeConfig(4, PlatformMessageBuffers::OverflowPolicy::kDropOldest);
+  config.batch_delivery = true;
+  buffers.ConfigureChannel("sensor", config);
+  buffers.Push(MakeMessage(1), false);
+
+  buffers.ConfigureChannel(
+      "sensor",
+      MakeConfig(0, PlatformMessageBuffers::OverflowPolicy::kDropOldest));
+  ASSERT_EQ(buffers.Push(MakeMessage(2), false),
+            PlatformMessageBuffers::PushResult::kNotBuffered);
+
+  auto drained = buffers.Drain("sensor");
+  ASSERT_EQ(drained.messages.size(), 1u);
+  ASSERT_EQ(GetValue(drained.messages[0]), 1u);
+  ASSERT_TRUE(drained.batch_delivery);
+}
+
+}  // namespace testing
+}  // namespace flutter
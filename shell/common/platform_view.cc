@@ -31,6 +31,10 @@ std::unique_ptr<VsyncWaiter> PlatformView::CreateVSyncWaiter() {
   return std::make_unique<VsyncWaiterFallback>(task_runners_);
 }
 
+ImageDecoderBackends PlatformView::CreateImageDecoderBackends() {
+  return {};
+}
+
 void PlatformView::DispatchPlatformMessage(
     fml::RefPtr<PlatformMessage> message) {
   delegate_.OnPlatformViewDispatchPlatformMessage(std::move(message));
@@ -42,6 +46,14 @@ void PlatformView::DispatchPointerDataPacket(
       pointer_data_packet_converter_.Convert(std::move(packet)));
 }
 
+void PlatformView::DispatchEventBatch(PlatformEventBatch batch) {
+  if (batch.pointer_data_packet) {
+    batch.pointer_data_packet = pointer_data_packet_converter_.Convert(
+        std::move(batch.pointer_data_packet));
+  }
+  delegate_.OnPlatformViewDispatchEventBatch(std::move(batch));
+}
+
 void PlatformView::DispatchSemanticsAction(int32_t id,
                                            SemanticsAction action,
                                            std::vector<uint8_t> args) {
@@ -52,6 +64,10 @@ void PlatformView::SetSemanticsEnabled(bool enabled) {
   delegate_.OnPlatformViewSetSemanticsEnabled(enabled);
 }
 
+void PlatformView::SetSemanticsClientActive(bool active) {
+  delegate_.OnPlatformViewSetSemanticsClientActive(active);
+}
+
 void PlatformView::SetAccessibilityFeatures(int32_t flags) {
   delegate_.OnPlatformViewSetAccessibilityFeatures(flags);
 }
@@ -89,6 +105,12 @@ sk_sp<GrContext> PlatformView::CreateResourceContext() const {
 
 void PlatformView::ReleaseResourceContext() const {}
 
+sk_sp<GrContext> PlatformView::CreateWorkerResourceContext() const {
+  return nullptr;
+}
+
+void PlatformView::ReleaseWorkerResourceContext() const {}
+
 PointerDataDispatcherMaker PlatformView::GetDispatcherMaker() {
   return [](DefaultPointerDataDispatcher::Delegate& delegate) {
     return std::make_unique<DefaultPointerDataDispatcher>(delegate);
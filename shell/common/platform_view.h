@@ -12,12 +12,14 @@
 #include "flutter/flow/texture.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/lib/ui/painting/image_decoder_backend.h"
 #include "flutter/lib/ui/semantics/custom_accessibility_action.h"
 #include "flutter/lib/ui/semantics/semantics_node.h"
 #include "flutter/lib/ui/window/platform_message.h"
 #include "flutter/lib/ui/window/pointer_data_packet.h"
 #include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 #include "flutter/lib/ui/window/viewport_metrics.h"
+#include "flutter/shell/common/platform_event_batch.h"
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/vsync_waiter.h"
 #include "third_party/skia/include/core/SkSize.h"
@@ -123,6 +125,16 @@ class PlatformView {
     virtual void OnPlatformViewDispatchPointerDataPacket(
         std::unique_ptr<PointerDataPacket> packet) = 0;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate that the platform view has dispatched
+    ///             several events at once. They must be forwarded to the
+    ///             engine on the UI thread together, in a single task.
+    ///
+    /// @param[in]  batch  The events, with the pointer data already
+    ///                    converted.
+    ///
+    virtual void OnPlatformViewDispatchEventBatch(PlatformEventBatch batch) = 0;
+
     //--------------------------------------------------------------------------
     /// @brief      Notifies the delegate that the platform view has encountered
     ///             an accessibility related action on the specified node. This
@@ -151,6 +163,17 @@ class PlatformView {
     ///
     virtual void OnPlatformViewSetSemanticsEnabled(bool enabled) = 0;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate whether anything on the platform
+    ///             consumes the accessibility tree. While nothing does, the
+    ///             semantics updates are held back on the UI thread instead of
+    ///             being sent to the platform view.
+    ///
+    /// @param[in]  active  Whether a consumer of the accessibility tree is
+    ///                     active.
+    ///
+    virtual void OnPlatformViewSetSemanticsClientActive(bool active) = 0;
+
     //--------------------------------------------------------------------------
     /// @brief      Notifies the delegate that the embedder has expressed an
     ///             opinion about the features to enable in the accessibility
@@ -270,6 +293,19 @@ class PlatformView {
   ///
   virtual std::unique_ptr<VsyncWaiter> CreateVSyncWaiter();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Invoked by the shell to obtain the platform's image decoders,
+  ///             if the `enable_platform_image_decoders` setting is on. The
+  ///             image decoder of the engine tries them in order before it
+  ///             falls back to Skia's codecs.
+  ///
+  /// @attention  The backends are called on the concurrent worker threads and
+  ///             may outlive the platform view, so they must not refer to it.
+  ///
+  /// @return     The image decoder backends. None by default.
+  ///
+  virtual ImageDecoderBackends CreateImageDecoderBackends();
+
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to dispatch a platform message to a
   ///             running root isolate hosted by the engine. If an isolate is
@@ -333,6 +369,22 @@ class PlatformView {
   ///
   virtual void SetSemanticsEnabled(bool enabled);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to tell the engine whether anything on the
+  ///             platform, such as a screen reader, currently consumes the
+  ///             accessibility tree. Semantics may stay enabled while nothing
+  ///             does, for instance after a one-time accessibility probe or
+  ///             for automation tooling. While no client is active, the
+  ///             semantics updates are merged by the engine instead of being
+  ///             sent to `UpdateSemantics` every frame. The merged update is
+  ///             sent as soon as a client becomes active again. Clients are
+  ///             assumed to be active until told otherwise.
+  ///
+  /// @param[in]  active  Whether a consumer of the accessibility tree is
+  ///                     active.
+  ///
+  void SetSemanticsClientActive(bool active);
+
   //----------------------------------------------------------------------------
   /// @brief      Used by the embedder to specify the features to enable in the
   ///             accessibility tree generated by the isolate. This information
@@ -441,6 +493,30 @@ class PlatformView {
   ///
   virtual void ReleaseResourceContext() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates another resource context in the share group of the
+  ///             one returned by `CreateResourceContext()`, for a thread that
+  ///             uploads textures concurrently with the IO thread. Platforms
+  ///             that can't have more than one resource context return
+  ///             `nullptr`, which is the default.
+  ///
+  /// @attention  This is called on the upload thread, each time on another
+  ///             one, and the context must be usable on it.
+  ///
+  /// @return     The Skia GPU context, or `nullptr`.
+  ///
+  virtual sk_sp<GrContext> CreateWorkerResourceContext() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Used by the shell to notify the embedder that a context
+  ///             previously obtained via a call to
+  ///             `CreateWorkerResourceContext()` is being collected.
+  ///
+  /// @attention  This is called on the upload thread the context was created
+  ///             on.
+  ///
+  virtual void ReleaseWorkerResourceContext() const;
+
   //--------------------------------------------------------------------------
   /// @brief      Returns a platform-specific PointerDataDispatcherMaker so the
   ///             `Engine` can construct the PointerDataPacketDispatcher based
@@ -502,6 +578,18 @@ class PlatformView {
   ///
   void DispatchPointerDataPacket(std::unique_ptr<PointerDataPacket> packet);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatches viewport metrics, platform messages and pointer
+  ///             events from the embedder to the framework together. Unlike
+  ///             the methods for each kind of event, this wakes up the UI
+  ///             thread once for the whole batch.
+  ///
+  /// @see        `PlatformEventBatch`
+  ///
+  /// @param[in]  batch  The events to dispatch.
+  ///
+  void DispatchEventBatch(PlatformEventBatch batch);
+
   //--------------------------------------------------------------------------
   /// @brief      Used by the embedder to specify a texture that it wants the
   ///             rasterizer to composite within the Flutter layer tree. All
@@ -4,6 +4,8 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <algorithm>
+
 namespace flutter {
 
 PointerDataDispatcher::~PointerDataDispatcher() = default;
@@ -13,6 +15,16 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate,
+    fml::TimeDelta resample_latency,
+    Clock clock)
+    : DefaultPointerDataDispatcher(delegate),
+      resample_latency_(resample_latency),
+      clock_(std::move(clock)),
+      weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -60,4 +72,187 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+namespace {
+
+// Whether |data| is a move that the resampling dispatcher can hold and
+// resample.
+bool IsResampledMove(const PointerData& data) {
+  return data.change == PointerData::Change::kMove &&
+         data.signal_kind == PointerData::SignalKind::kNone &&
+         (data.kind == PointerData::DeviceKind::kTouch ||
+          data.kind == PointerData::DeviceKind::kStylus ||
+          data.kind == PointerData::DeviceKind::kInvertedStylus);
+}
+
+// Returns |to| with its position moved to where the line through |from| and
+// |to| is at |time_stamp|.
+PointerData ResamplePosition(const PointerData& from,
+                             const PointerData& to,
+                             int64_t time_stamp) {
+  double alpha = static_cast<double>(time_stamp - from.time_stamp) /
+                 (to.time_stamp - from.time_stamp);
+  PointerData result = to;
+  result.time_stamp = time_stamp;
+  result.physical_x =
+      from.physical_x + alpha * (to.physical_x - from.physical_x);
+  result.physical_y =
+      from.physical_y + alpha * (to.physical_y - from.physical_y);
+  return result;
+}
+
+}  // namespace
+
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  const auto* data =
+      reinterpret_cast<const PointerData*>(packet->data().data());
+  size_t count = packet->data().size() / sizeof(PointerData);
+
+  if (!std::all_of(data, data + count, IsResampledMove)) {
+    DispatchWithPendingMoves(data, count, trace_flow_id);
+    return;
+  }
+
+  pending_moves_.insert(pending_moves_.end(), data, data + count);
+  pending_trace_flow_id_ = trace_flow_id;
+  ScheduleResample();
+}
+
+void ResamplingPointerDataDispatcher::ScheduleResample() {
+  if (is_resample_scheduled_ || pending_moves_.empty()) {
+    return;
+  }
+  is_resample_scheduled_ = true;
+  delegate_.ScheduleSecondaryVsyncCallback(
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->is_resample_scheduled_ = false;
+          dispatcher->ResamplePendingMoves();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::ResamplePendingMoves() {
+  if (pending_moves_.empty()) {
+    return;
+  }
+  const int64_t sample_time =
+      (clock_() - resample_latency_).ToEpochDelta().ToMicroseconds();
+  const int64_t min_delta = kMinSampleDelta.ToMicroseconds();
+
+  // The index in |pending_moves_| of the last move of each device up to the
+  // sample time, in the order the devices first appear.
+  std::vector<int64_t> devices;
+  std::unordered_map<int64_t, size_t> last_consumed;
+  for (size_t i = 0; i < pending_moves_.size(); ++i) {
+    const PointerData& move = pending_moves_[i];
+    if (move.time_stamp > sample_time) {
+      continue;
+    }
+    if (last_consumed.count(move.device) == 0) {
+      devices.push_back(move.device);
+    }
+    last_consumed[move.device] = i;
+  }
+
+  std::vector<PointerData> resampled;
+  std::vector<PointerData> remaining;
+  for (int64_t device : devices) {
+    size_t last_index = last_consumed[device];
+    const PointerData& last = pending_moves_[last_index];
+
+    // Find the sample before |last|, and the one after the sample time.
+    const PointerData* previous = nullptr;
+    const PointerData* next = nullptr;
+    for (size_t i = 0; i < pending_moves_.size(); ++i) {
+      if (pending_moves_[i].device != device) {
+        continue;
+      }
+      if (i < last_index) {
+        previous = &pending_moves_[i];
+      } else if (i > last_index) {
+        next = &pending_moves_[i];
+        break;
+      }
+    }
+    if (previous == nullptr) {
+      auto it = last_samples_.find(device);
+      if (it != last_samples_.end()) {
+        previous = &it->second;
+      }
+    }
+
+    PointerData result = last;
+    if (next != nullptr) {
+      if (next->time_stamp - last.time_stamp >= min_delta) {
+        result = ResamplePosition(last, *next, sample_time);
+      }
+    } else if (previous != nullptr) {
+      int64_t delta = last.time_stamp - previous->time_stamp;
+      if (delta >= min_delta) {
+        int64_t max_prediction =
+            std::min(delta / 2, kMaxPrediction.ToMicroseconds());
+        result = ResamplePosition(
+            *previous, last,
+            std::min(sample_time, last.time_stamp + max_prediction));
+      }
+    }
+    resampled.push_back(result);
+    last_samples_[device] = last;
+  }
+
+  for (size_t i = 0; i < pending_moves_.size(); ++i) {
+    const PointerData& move = pending_moves_[i];
+    auto it = last_consumed.find(move.device);
+    if (it == last_consumed.end() || i > it->second) {
+      remaining.push_back(move);
+    }
+  }
+  pending_moves_ = std::move(remaining);
+
+  if (!resampled.empty()) {
+    DispatchData(resampled, pending_trace_flow_id_);
+  }
+  ScheduleResample();
+}
+
+void ResamplingPointerDataDispatcher::DispatchWithPendingMoves(
+    const PointerData* data,
+    size_t count,
+    uint64_t trace_flow_id) {
+  std::vector<PointerData> all_data = std::move(pending_moves_);
+  pending_moves_.clear();
+  all_data.insert(all_data.end(), data, data + count);
+
+  for (const PointerData& datum : all_data) {
+    switch (datum.change) {
+      case PointerData::Change::kDown:
+      case PointerData::Change::kMove:
+        last_samples_[datum.device] = datum;
+        break;
+      case PointerData::Change::kCancel:
+      case PointerData::Change::kUp:
+      case PointerData::Change::kRemove:
+        last_samples_.erase(datum.device);
+        break;
+      default:
+        break;
+    }
+  }
+
+  DispatchData(all_data, trace_flow_id);
+}
+
+void ResamplingPointerDataDispatcher::DispatchData(
+    const std::vector<PointerData>& data,
+    uint64_t trace_flow_id) {
+  auto packet = std::make_unique<PointerDataPacket>(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    packet->SetPointerData(i, data[i]);
+  }
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               trace_flow_id);
+}
+
 }  // namespace flutter
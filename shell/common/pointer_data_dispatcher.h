@@ -5,6 +5,12 @@
 #ifndef POINTER_DATA_DISPATCHER_H_
 #define POINTER_DATA_DISPATCHER_H_
 
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/shell/common/animator.h"
 
@@ -162,6 +168,92 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that holds touch and stylus moves until the next VSYNC, and
+/// then dispatches a single move per device whose position is resampled to a
+/// fixed latency before the VSYNC.
+///
+/// This smooths out scrolling when the input sample rate isn't a multiple of
+/// the display refresh rate, e.g. 120Hz touch on a 90Hz display, where a
+/// dispatcher that forwards whole samples would move the content by one or two
+/// samples' worth on alternate frames.
+///
+/// It works like Android's input resampling:
+///
+/// At each VSYNC, the sample time is the current time less
+/// `resample_latency`. For each device, the moves up to the sample time are
+/// consumed, and the position dispatched is interpolated between the last of
+/// them and the first move after the sample time. If there is no later move
+/// yet, the position is extrapolated from the last two moves, by no more than
+/// half the time between them or `kMaxPrediction`. Moves later than the sample
+/// time stay pending for the next VSYNC.
+///
+/// Any other event, such as a down or an up, is dispatched right away along
+/// with all the pending moves before it, so events are never reordered.
+///
+/// This relies on `PointerData::time_stamp` being in microseconds on the same
+/// clock as `fml::TimePoint::Now`, which is the case for Android's event times.
+class ResamplingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  /// Returns the current time. Replaceable for tests.
+  using Clock = std::function<fml::TimePoint()>;
+
+  /// The latency Android resamples input events to.
+  static constexpr fml::TimeDelta kDefaultResampleLatency =
+      fml::TimeDelta::FromMilliseconds(5);
+
+  /// The furthest a position is extrapolated past its last sample.
+  static constexpr fml::TimeDelta kMaxPrediction =
+      fml::TimeDelta::FromMilliseconds(8);
+
+  /// The least time between two samples for them to be resampled, since
+  /// samples closer than this are likely to be noisy.
+  static constexpr fml::TimeDelta kMinSampleDelta =
+      fml::TimeDelta::FromMilliseconds(2);
+
+  ResamplingPointerDataDispatcher(
+      Delegate& delegate,
+      fml::TimeDelta resample_latency = kDefaultResampleLatency,
+      Clock clock = fml::TimePoint::Now);
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~ResamplingPointerDataDispatcher();
+
+ private:
+  const fml::TimeDelta resample_latency_;
+  const Clock clock_;
+
+  // The moves that haven't been dispatched yet, in the order they arrived.
+  std::vector<PointerData> pending_moves_;
+  uint64_t pending_trace_flow_id_ = 0;
+
+  // The last move or down consumed for each device that is in contact, which
+  // is extrapolated from when there is only one new move.
+  std::unordered_map<int64_t, PointerData> last_samples_;
+
+  bool is_resample_scheduled_ = false;
+
+  fml::WeakPtrFactory<ResamplingPointerDataDispatcher> weak_factory_;
+
+  void ScheduleResample();
+
+  void ResamplePendingMoves();
+
+  // Dispatches |data| with all the pending moves before it, unresampled.
+  void DispatchWithPendingMoves(const PointerData* data,
+                                size_t count,
+                                uint64_t trace_flow_id);
+
+  // Dispatches |data| as a packet.
+  void DispatchData(const std::vector<PointerData>& data,
+                    uint64_t trace_flow_id);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ResamplingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
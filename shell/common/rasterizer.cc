@@ -4,6 +4,7 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include <cmath>
 #include <utility>
 
 #include "flutter/fml/time/time_delta.h"
@@ -53,6 +54,11 @@ Rasterizer::Rasterizer(
       task_runners_(std::move(task_runners)),
       compositor_context_(std::move(compositor_context)),
       user_override_resource_cache_bytes_(false),
+      gpu_resource_memory_charge_(
+          fml::MemoryCounter::Get("GPUResourceCache")),
+      snapshot_unref_queue_(fml::MakeRefCounted<SkiaUnrefQueue>(
+          task_runners_.GetRasterTaskRunner(),
+          fml::TimeDelta::FromMilliseconds(8))),
       weak_factory_(this),
       is_gpu_disabled_sync_switch_(is_gpu_disabled_sync_switch) {
   FML_DCHECK(compositor_context_);
@@ -72,10 +78,16 @@ fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> Rasterizer::GetSnapshotDelegate()
 void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
   surface_ = std::move(surface);
   if (max_cache_bytes_.has_value()) {
-    SetResourceCacheMaxBytes(max_cache_bytes_.value(),
-                             user_override_resource_cache_bytes_);
+    ApplyResourceCacheMaxBytes(max_cache_bytes_.value());
   }
-  compositor_context_->OnGrContextCreated();
+  // The entries of a retained raster cache can only be drawn with the
+  // GrContext they were rasterized with.
+  GrContext* context = surface_->GetContext();
+  const bool reuse_raster_cache = retained_cache_context_ &&
+                                  retained_cache_context_.get() == context &&
+                                  !context->abandoned();
+  retained_cache_context_ = nullptr;
+  compositor_context_->OnGrContextCreated(reuse_raster_cache);
 #if !defined(OS_FUCHSIA)
   // TODO(sanjayc77): https://github.com/flutter/flutter/issues/53179. Add
   // support for raster thread merger for Fuchsia.
@@ -85,31 +97,103 @@ void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
     const auto gpu_id = task_runners_.GetRasterTaskRunner()->GetTaskQueueId();
     raster_thread_merger_ =
         fml::MakeRefCounted<fml::RasterThreadMerger>(platform_id, gpu_id);
+    raster_thread_merger_->SetMaxLeaseTerm(max_merged_lease_term_);
   }
 #endif
 }
 
 void Rasterizer::Teardown() {
-  compositor_context_->OnGrContextDestroyed();
+  GrContext* context = surface_ ? surface_->GetContext() : nullptr;
+  if (context) {
+    // The app may be killed in the background, so the pipeline cache is
+    // stored while the context is still around.
+    context->storeVkPipelineCacheData();
+  }
+  const bool retain_raster_cache = retain_raster_cache_on_teardown_ && context;
+  if (retain_raster_cache) {
+    // Holding a reference does not keep a context owned by the surface from
+    // being abandoned, which is checked for in |Setup|.
+    retained_cache_context_ = sk_ref_sp(context);
+  }
+  compositor_context_->OnGrContextDestroyed(retain_raster_cache);
+  snapshot_surface_pool_.Clear();
   surface_.reset();
   last_layer_tree_.reset();
+  deferred_layer_tree_.reset();
+  if (!retain_raster_cache) {
+    gpu_resource_memory_charge_.Update(0);
+  }
 }
 
-void Rasterizer::NotifyLowMemoryWarning() const {
-  if (!surface_) {
-    FML_DLOG(INFO) << "Rasterizer::PurgeCaches called with no surface.";
-    return;
+void Rasterizer::NotifyLowMemoryWarning() {
+  NotifyMemoryPressure(MemoryPressureLevel::kCritical);
+}
+
+MemoryPressureReport Rasterizer::NotifyMemoryPressure(
+    MemoryPressureLevel level) {
+  TRACE_EVENT0("flutter", "Rasterizer::NotifyMemoryPressure");
+  MemoryPressureReport report;
+  report.level = level;
+
+  auto& raster_cache = compositor_context_->raster_cache();
+  const size_t raster_cache_bytes = raster_cache.GetCachedBytes();
+  // Entries retained across unused frames are the cheapest to give up.
+  raster_cache.PurgeUnusedEntries();
+  if (level == MemoryPressureLevel::kBackground ||
+      (level == MemoryPressureLevel::kCritical && retained_cache_context_)) {
+    // Nothing is drawn with the cache retained for the next surface until
+    // then, and nothing is drawn at all while in the background.
+    raster_cache.Clear();
+  }
+  if (level != MemoryPressureLevel::kModerate) {
+    retained_cache_context_ = nullptr;
+  }
+  const size_t raster_cache_bytes_after = raster_cache.GetCachedBytes();
+  if (raster_cache_bytes > raster_cache_bytes_after) {
+    report.raster_cache_bytes_freed =
+        raster_cache_bytes - raster_cache_bytes_after;
+  }
+
+  // The budget of the resource cache shrinks along, and stays that way for
+  // the next surface.
+  const bool adapt_resource_cache = resource_cache_sizer_ &&
+                                    !user_override_resource_cache_bytes_ &&
+                                    resource_cache_sizer_->GetMaxBytes() > 0;
+  if (adapt_resource_cache) {
+    resource_cache_sizer_->OnMemoryPressure(level);
   }
-  auto context = surface_->GetContext();
+
+  GrContext* context = surface_ ? surface_->GetContext() : nullptr;
   if (!context) {
-    FML_DLOG(INFO) << "Rasterizer::PurgeCaches called with no GrContext.";
-    return;
+    if (adapt_resource_cache) {
+      ApplyResourceCacheMaxBytes(resource_cache_sizer_->GetMaxBytes());
+    }
+    FML_DLOG(INFO) << "Rasterizer::NotifyMemoryPressure called with no "
+                      "GrContext.";
+    return report;
   }
-  context->freeGpuResources();
+  // The raster cache images released above are only returned to the context
+  // here, so their bytes are counted again as GPU resources.
+  size_t gpu_bytes = 0;
+  context->getResourceCacheUsage(nullptr, &gpu_bytes);
+  if (adapt_resource_cache) {
+    ApplyResourceCacheMaxBytes(resource_cache_sizer_->GetMaxBytes());
+  }
+  if (level == MemoryPressureLevel::kModerate) {
+    context->purgeUnlockedResources(/*scratchResourcesOnly=*/true);
+  } else {
+    context->freeGpuResources();
+  }
+  size_t gpu_bytes_after = 0;
+  context->getResourceCacheUsage(nullptr, &gpu_bytes_after);
+  if (gpu_bytes > gpu_bytes_after) {
+    report.gpu_resource_bytes_freed = gpu_bytes - gpu_bytes_after;
+  }
+  return report;
 }
 
-flutter::TextureRegistry* Rasterizer::GetTextureRegistry() {
-  return &compositor_context_->texture_registry();
+std::shared_ptr<flutter::TextureRegistry> Rasterizer::GetTextureRegistry() {
+  return compositor_context_->shared_texture_registry();
 }
 
 flutter::LayerTree* Rasterizer::GetLastLayerTree() {
@@ -120,6 +204,23 @@ void Rasterizer::DrawLastLayerTree() {
   if (!last_layer_tree_ || !surface_) {
     return;
   }
+  // The last layer tree is only drawn again for the new frames of its
+  // textures. Skip the frame if they were already drawn with a newer layer
+  // tree.
+  if (!compositor_context_->texture_registry().has_new_frames()) {
+    TRACE_EVENT_INSTANT0("flutter", "No new texture frames, skipping");
+    return;
+  }
+  DrawToSurface(*last_layer_tree_);
+}
+
+void Rasterizer::DrawLastLayerTreeAtSize(const SkISize& frame_size) {
+  if (!last_layer_tree_ || !surface_ || frame_size.isEmpty() ||
+      last_layer_tree_->frame_size() == frame_size) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "Rasterizer::DrawLastLayerTreeAtSize");
+  last_layer_tree_->set_frame_size(frame_size);
   DrawToSurface(*last_layer_tree_);
 }
 
@@ -135,7 +236,8 @@ void Rasterizer::Draw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) {
   RasterStatus raster_status = RasterStatus::kFailed;
   Pipeline<flutter::LayerTree>::Consumer consumer =
       [&](std::unique_ptr<LayerTree> layer_tree) {
-        raster_status = DoDraw(std::move(layer_tree));
+        raster_status =
+            DoDraw(std::move(layer_tree), pipeline->GetSupersededCount());
       };
 
   PipelineConsumeResult consume_result = pipeline->Consume(consumer);
@@ -179,13 +281,20 @@ void Rasterizer::Draw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) {
 
 namespace {
 sk_sp<SkImage> DrawSnapshot(
-    sk_sp<SkSurface> surface,
-    const std::function<void(SkCanvas*)>& draw_callback) {
+    const sk_sp<SkSurface>& surface,
+    const std::function<void(SkCanvas*)>& draw_callback,
+    bool gpu_resident) {
   if (surface == nullptr || surface->getCanvas() == nullptr) {
     return nullptr;
   }
 
-  draw_callback(surface->getCanvas());
+  {
+    SkCanvas* canvas = surface->getCanvas();
+    // The surface may be reused from an earlier snapshot.
+    SkAutoCanvasRestore save(canvas, true);
+    canvas->clear(SK_ColorTRANSPARENT);
+    draw_callback(canvas);
+  }
   surface->getCanvas()->flush();
 
   sk_sp<SkImage> device_snapshot;
@@ -194,8 +303,8 @@ sk_sp<SkImage> DrawSnapshot(
     device_snapshot = surface->makeImageSnapshot();
   }
 
-  if (device_snapshot == nullptr) {
-    return nullptr;
+  if (device_snapshot == nullptr || gpu_resident) {
+    return device_snapshot;
   }
 
   {
@@ -212,22 +321,41 @@ sk_sp<SkImage> DrawSnapshot(
 sk_sp<SkImage> Rasterizer::DoMakeRasterSnapshot(
     SkISize size,
     std::function<void(SkCanvas*)> draw_callback) {
+  return DoMakeRasterSnapshots(
+             size, 1,
+             [&draw_callback](SkCanvas* canvas, size_t) {
+               draw_callback(canvas);
+             },
+             false)
+      .front();
+}
+
+std::vector<sk_sp<SkImage>> Rasterizer::DoMakeRasterSnapshots(
+    SkISize size,
+    size_t count,
+    const std::function<void(SkCanvas*, size_t)>& draw_callback,
+    bool gpu_resident) {
   TRACE_EVENT0("flutter", __FUNCTION__);
-  sk_sp<SkImage> result;
+  std::vector<sk_sp<SkImage>> results(count);
   SkImageInfo image_info = SkImageInfo::MakeN32Premul(
       size.width(), size.height(), SkColorSpace::MakeSRGB());
+  // The pixels of raster snapshots are shared with their surfaces, which are
+  // therefore not pooled.
+  auto draw_raster_snapshots = [&] {
+    for (size_t i = 0; i < count; i++) {
+      results[i] = DrawSnapshot(
+          SkSurface::MakeRaster(image_info),
+          [&](SkCanvas* canvas) { draw_callback(canvas, i); }, false);
+    }
+  };
   if (surface_ == nullptr || surface_->GetContext() == nullptr) {
     // Raster surface is fine if there is no on screen surface. This might
     // happen in case of software rendering.
-    sk_sp<SkSurface> surface = SkSurface::MakeRaster(image_info);
-    result = DrawSnapshot(surface, draw_callback);
+    draw_raster_snapshots();
   } else {
     is_gpu_disabled_sync_switch_->Execute(
         fml::SyncSwitch::Handlers()
-            .SetIfTrue([&] {
-              sk_sp<SkSurface> surface = SkSurface::MakeRaster(image_info);
-              result = DrawSnapshot(surface, draw_callback);
-            })
+            .SetIfTrue(draw_raster_snapshots)
             .SetIfFalse([&] {
               auto context_switch = surface_->MakeRenderContextCurrent();
               if (!context_switch->GetResult()) {
@@ -236,24 +364,49 @@ sk_sp<SkImage> Rasterizer::DoMakeRasterSnapshot(
 
               // When there is an on screen surface, we need a render target
               // SkSurface because we want to access texture backed images.
-              sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(
-                  surface_->GetContext(),  // context
-                  SkBudgeted::kNo,         // budgeted
-                  image_info               // image info
-              );
-              result = DrawSnapshot(surface, draw_callback);
+              GrContext* context = surface_->GetContext();
+              for (size_t i = 0; i < count; i++) {
+                // A GPU-resident snapshot keeps using the texture of its
+                // surface, which therefore cannot be reused.
+                sk_sp<SkSurface> surface =
+                    gpu_resident
+                        ? SkSurface::MakeRenderTarget(context, SkBudgeted::kNo,
+                                                      image_info)
+                        : snapshot_surface_pool_.Acquire(context, image_info);
+                results[i] = DrawSnapshot(
+                    surface,
+                    [&](SkCanvas* canvas) { draw_callback(canvas, i); },
+                    gpu_resident);
+                if (!gpu_resident) {
+                  snapshot_surface_pool_.Release(std::move(surface));
+                }
+              }
             }));
   }
 
-  return result;
+  return results;
 }
 
 sk_sp<SkImage> Rasterizer::MakeRasterSnapshot(sk_sp<SkPicture> picture,
                                               SkISize picture_size) {
-  return DoMakeRasterSnapshot(picture_size,
-                              [picture = std::move(picture)](SkCanvas* canvas) {
-                                canvas->drawPicture(picture);
-                              });
+  return MakeRasterSnapshots({std::move(picture)}, picture_size, false)
+      .front();
+}
+
+std::vector<sk_sp<SkImage>> Rasterizer::MakeRasterSnapshots(
+    const std::vector<sk_sp<SkPicture>>& pictures,
+    SkISize picture_size,
+    bool gpu_resident) {
+  return DoMakeRasterSnapshots(
+      picture_size, pictures.size(),
+      [&pictures](SkCanvas* canvas, size_t index) {
+        canvas->drawPicture(pictures[index]);
+      },
+      gpu_resident);
+}
+
+fml::RefPtr<SkiaUnrefQueue> Rasterizer::GetSnapshotUnrefQueue() const {
+  return snapshot_unref_queue_;
 }
 
 sk_sp<SkImage> Rasterizer::ConvertToRasterImage(sk_sp<SkImage> image) {
@@ -276,8 +429,23 @@ sk_sp<SkImage> Rasterizer::ConvertToRasterImage(sk_sp<SkImage> image) {
                               });
 }
 
-RasterStatus Rasterizer::DoDraw(
-    std::unique_ptr<flutter::LayerTree> layer_tree) {
+void Rasterizer::ScheduleDeferredDraw() {
+  TRACE_EVENT_INSTANT0("flutter", "Rasterizer::ScheduleDeferredDraw");
+  task_runners_.GetRasterTaskRunner()->PostTask(
+      [weak_this = weak_factory_.GetWeakPtr()]() {
+        if (!weak_this || !weak_this->deferred_layer_tree_) {
+          return;
+        }
+        if (weak_this->raster_thread_merger_ &&
+            !weak_this->raster_thread_merger_->IsOnRasterizingThread()) {
+          return;
+        }
+        weak_this->DoDraw(std::move(weak_this->deferred_layer_tree_), 0);
+      });
+}
+
+RasterStatus Rasterizer::DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree,
+                                size_t superseded_frame_count) {
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
 
   if (!layer_tree || !surface_) {
@@ -288,19 +456,29 @@ RasterStatus Rasterizer::DoDraw(
 #if !defined(OS_FUCHSIA)
   const fml::TimePoint frame_target_time = layer_tree->target_time();
 #endif
+  timing.SetVsyncStart(layer_tree->vsync_start());
   timing.Set(FrameTiming::kBuildStart, layer_tree->build_start());
   timing.Set(FrameTiming::kBuildFinish, layer_tree->build_finish());
   timing.Set(FrameTiming::kRasterStart, fml::TimePoint::Now());
+  timing.SetSupersededFrameCount(superseded_frame_count);
 
   PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
   persistent_cache->ResetStoredNewShaders();
 
-  RasterStatus raster_status = DrawToSurface(*layer_tree);
+  RasterStatus raster_status = DrawToSurface(*layer_tree, &timing);
+  if (auto gpu_time = surface_->TakeGpuFrameTime()) {
+    compositor_context_->AddGpuFrameTime(*gpu_time);
+    timing.SetGpuRasterDuration(*gpu_time);
+  }
   if (raster_status == RasterStatus::kSuccess) {
     last_layer_tree_ = std::move(layer_tree);
+    deferred_layer_tree_.reset();
   } else if (raster_status == RasterStatus::kResubmit) {
     resubmitted_layer_tree_ = std::move(layer_tree);
     return raster_status;
+  } else if (surface_->DeferredLastFrame()) {
+    deferred_layer_tree_ = std::move(layer_tree);
+    ScheduleDeferredDraw();
   }
 
   if (persistent_cache->IsDumpingSkp() &&
@@ -310,6 +488,14 @@ RasterStatus Rasterizer::DoDraw(
     persistent_cache->DumpSkp(*screenshot.data);
   }
 
+  // The pipelines of new shaders went into the Vulkan pipeline cache too.
+  if (persistent_cache->StoredNewShaders() && surface_ &&
+      surface_->GetContext()) {
+    persistent_cache->StoreVkPipelineCacheWhenIdle(
+        sk_ref_sp(surface_->GetContext()),
+        task_runners_.GetRasterTaskRunner());
+  }
+
   // TODO(liyuqian): in Fuchsia, the rasterization doesn't finish when
   // Rasterizer::DoDraw finishes. Future work is needed to adapt the timestamp
   // for Fuchsia to capture SceneUpdateContext::ExecutePaintTasks.
@@ -317,6 +503,15 @@ RasterStatus Rasterizer::DoDraw(
   timing.Set(FrameTiming::kRasterFinish, raster_finish_time);
   delegate_.OnFrameRasterized(timing);
 
+  if (jank_watchdog_ && raster_status == RasterStatus::kSuccess) {
+    auto capture = jank_watchdog_->OnFrameRasterized(
+        timing,
+        fml::TimeDelta::FromMillisecondsF(delegate_.GetFrameBudget().count()));
+    if (capture) {
+      CaptureJank(std::move(*capture));
+    }
+  }
+
 // SceneDisplayLag events are disabled on Fuchsia.
 // see: https://github.com/flutter/flutter/issues/56598
 #if !defined(OS_FUCHSIA)
@@ -373,7 +568,8 @@ RasterStatus Rasterizer::DoDraw(
   return raster_status;
 }
 
-RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
+RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree,
+                                       FrameTiming* timing) {
   TRACE_EVENT0("flutter", "Rasterizer::DrawToSurface");
   FML_DCHECK(surface_);
 
@@ -411,6 +607,12 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   auto root_surface_canvas =
       embedder_root_canvas ? embedder_root_canvas : frame->SkiaCanvas();
 
+  std::unique_ptr<SkCanvas> shader_warm_up_canvas;
+  if (shader_warm_up_recorder_ && root_surface_canvas) {
+    shader_warm_up_canvas = shader_warm_up_recorder_->Tee(root_surface_canvas);
+    root_surface_canvas = shader_warm_up_canvas.get();
+  }
+
   auto compositor_frame = compositor_context_->AcquireFrame(
       surface_->GetContext(),       // skia GrContext
       root_surface_canvas,          // root surface canvas
@@ -422,10 +624,15 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   );
 
   if (compositor_frame) {
+    compositor_frame->set_surface_buffer_age(frame->buffer_age());
     RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
     if (raster_status == RasterStatus::kFailed) {
       return raster_status;
     }
+    // The layer tree showed the new frames of its textures.
+    compositor_context_->texture_registry().OnLayerTreeDrawn();
+    frame->set_damage(compositor_frame->damage());
+    const fml::TimePoint submit_start = fml::TimePoint::Now();
     if (external_view_embedder != nullptr) {
       FML_DCHECK(!frame->IsSubmitted());
       external_view_embedder->SubmitFrame(surface_->GetContext(),
@@ -433,13 +640,37 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
     } else {
       frame->Submit();
     }
+    if (timing) {
+      const auto& raster_cache = compositor_context_->raster_cache();
+      timing->SetPrerollDuration(compositor_frame->preroll_duration());
+      timing->SetPaintDuration(compositor_frame->paint_duration());
+      timing->SetSubmitDuration(fml::TimePoint::Now() - submit_start);
+      timing->SetRasterCacheCounts(raster_cache.GetFrameHitCount(),
+                                   raster_cache.GetFrameMissCount());
+    }
 
     FireNextFrameCallbackIfPresent();
 
+    if (shader_warm_up_recorder_ && shader_warm_up_recorder_->has_new_ops()) {
+      PersistentCache::GetCacheForProcess()->StoreShaderWarmUp(
+          *shader_warm_up_recorder_->Serialize());
+    }
+
+    // Populate the raster cache entries deferred during this frame in the time
+    // left before the next frame is due.
+    auto& raster_cache = compositor_context_->raster_cache();
+    if (raster_cache.GetPendingEntriesCount() > 0) {
+      raster_cache.RasterizePendingEntries(
+          surface_->GetContext(), delegate_.GetLatestFrameTargetTime());
+    }
+
     if (surface_->GetContext()) {
       TRACE_EVENT0("flutter", "PerformDeferredSkiaCleanup");
       surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
     }
+    UpdateAdaptiveResourceCache(surface_->GetContext());
+    UpdateMemoryAccounting(surface_->GetContext());
+    TraceGLContextSwitches();
 
     return raster_status;
   }
@@ -451,7 +682,7 @@ static sk_sp<SkData> SerializeTypeface(SkTypeface* typeface, void* ctx) {
   return typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
 }
 
-static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
+static sk_sp<SkPicture> ScreenshotLayerTreeAsPicture(
     flutter::LayerTree* tree,
     flutter::CompositorContext& compositor_context) {
   FML_DCHECK(tree != nullptr);
@@ -470,10 +701,7 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
 
   frame->Raster(*tree, true);
 
-  SkSerialProcs procs = {0};
-  procs.fTypefaceProc = SerializeTypeface;
-
-  return recorder.finishRecordingAsPicture()->serialize(&procs);
+  return recorder.finishRecordingAsPicture();
 }
 
 static sk_sp<SkSurface> CreateSnapshotSurface(GrContext* surface_context,
@@ -494,15 +722,19 @@ static sk_sp<SkSurface> CreateSnapshotSurface(GrContext* surface_context,
   return SkSurface::MakeRaster(image_info);
 }
 
-sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
+sk_sp<SkImage> Rasterizer::ScreenshotLayerTreeAsImage(
     flutter::LayerTree* tree,
     flutter::CompositorContext& compositor_context,
     GrContext* surface_context,
-    bool compressed) {
+    float scale) {
+  FML_DCHECK(scale > 0.0f);
+  const SkISize size =
+      SkISize::Make(std::ceil(tree->frame_size().width() * scale),
+                    std::ceil(tree->frame_size().height() * scale));
+
   // Attempt to create a snapshot surface depending on whether we have access to
   // a valid GPU rendering context.
-  auto snapshot_surface =
-      CreateSnapshotSurface(surface_context, tree->frame_size());
+  auto snapshot_surface = CreateSnapshotSurface(surface_context, size);
   if (snapshot_surface == nullptr) {
     FML_LOG(ERROR) << "Screenshot: unable to create snapshot surface";
     return nullptr;
@@ -511,10 +743,10 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
   // Draw the current layer tree into the snapshot surface.
   auto* canvas = snapshot_surface->getCanvas();
 
-  // There is no root surface transformation for the screenshot layer. Reset the
-  // matrix to identity.
-  SkMatrix root_surface_transformation;
-  root_surface_transformation.reset();
+  // There is no root surface transformation for the screenshot layer other
+  // than the requested scale.
+  SkMatrix root_surface_transformation = SkMatrix::Scale(scale, scale);
+  canvas->setMatrix(root_surface_transformation);
 
   // We want to ensure we call the base method for
   // CompositorContext::AcquireFrame instead of the platform-specific method.
@@ -550,62 +782,206 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
     FML_LOG(ERROR) << "Screenshot: unable to make raster image";
     return nullptr;
   }
+  return cpu_snapshot;
+}
 
-  // If the caller want the pixels to be compressed, there is a Skia utility to
-  // compress to PNG. Use that.
-  if (compressed) {
-    return cpu_snapshot->encodeToData();
-  }
-
-  // Copy it into a bitmap and return the same.
-  SkPixmap pixmap;
-  if (!cpu_snapshot->peekPixels(&pixmap)) {
-    FML_LOG(ERROR) << "Screenshot: unable to obtain bitmap pixels";
-    return nullptr;
+// Encodes a raster image captured by |ScreenshotLayerTreeAsImage|. Safe to call
+// on any thread.
+static sk_sp<SkData> EncodeScreenshotImage(sk_sp<SkImage> image,
+                                           Rasterizer::ScreenshotType type) {
+  switch (type) {
+    case Rasterizer::ScreenshotType::CompressedImage:
+      // There is a Skia utility to compress to PNG. Use that.
+      return image->encodeToData();
+    case Rasterizer::ScreenshotType::UncompressedImage: {
+      // Hand out the pixels of the image without copying them.
+      SkPixmap pixmap;
+      if (!image->peekPixels(&pixmap)) {
+        FML_LOG(ERROR) << "Screenshot: unable to obtain bitmap pixels";
+        return nullptr;
+      }
+      return SkData::MakeWithProc(
+          pixmap.addr(), pixmap.computeByteSize(),
+          [](const void* pixels, void* image) {
+            static_cast<SkImage*>(image)->unref();
+          },
+          image.release());
+    }
+    case Rasterizer::ScreenshotType::UncompressedRGBAImage: {
+      const SkImageInfo info =
+          image->imageInfo().makeColorType(kRGBA_8888_SkColorType);
+      auto data = SkData::MakeUninitialized(info.computeMinByteSize());
+      if (!image->readPixels(info, data->writable_data(), info.minRowBytes(),
+                             0, 0)) {
+        FML_LOG(ERROR) << "Screenshot: unable to convert bitmap pixels";
+        return nullptr;
+      }
+      return data;
+    }
+    case Rasterizer::ScreenshotType::SkiaPicture:
+      break;
   }
-  return SkData::MakeWithCopy(pixmap.addr32(), pixmap.computeByteSize());
+  FML_DCHECK(false);
+  return nullptr;
 }
 
 Rasterizer::Screenshot Rasterizer::ScreenshotLastLayerTree(
     Rasterizer::ScreenshotType type,
     bool base64_encode) {
+  // Without an encode task runner, the callback is invoked before returning.
+  Rasterizer::Screenshot result;
+  ScreenshotLastLayerTree(type, base64_encode, 1.0f, nullptr,
+                          [&result](Screenshot screenshot) {
+                            result = std::move(screenshot);
+                          });
+  return result;
+}
+
+void Rasterizer::ScreenshotLastLayerTree(
+    Rasterizer::ScreenshotType type,
+    bool base64_encode,
+    float scale,
+    std::shared_ptr<fml::ConcurrentTaskRunner> encode_task_runner,
+    ScreenshotCallback callback) {
   auto* layer_tree = GetLastLayerTree();
   if (layer_tree == nullptr) {
     FML_LOG(ERROR) << "Last layer tree was null when screenshotting.";
-    return {};
+    callback({});
+    return;
   }
 
-  sk_sp<SkData> data = nullptr;
-
   GrContext* surface_context = surface_ ? surface_->GetContext() : nullptr;
 
-  switch (type) {
-    case ScreenshotType::SkiaPicture:
-      data = ScreenshotLayerTreeAsPicture(layer_tree, *compositor_context_);
-      break;
-    case ScreenshotType::UncompressedImage:
-      data = ScreenshotLayerTreeAsImage(layer_tree, *compositor_context_,
-                                        surface_context, false);
-      break;
-    case ScreenshotType::CompressedImage:
-      data = ScreenshotLayerTreeAsImage(layer_tree, *compositor_context_,
-                                        surface_context, true);
-      break;
+  // Only drawing the layer tree and reading back its pixels needs the raster
+  // thread, the encoding can happen anywhere.
+  sk_sp<SkPicture> picture;
+  sk_sp<SkImage> image;
+  SkISize size = layer_tree->frame_size();
+  if (type == ScreenshotType::SkiaPicture) {
+    picture = ScreenshotLayerTreeAsPicture(layer_tree, *compositor_context_);
+  } else {
+    image = ScreenshotLayerTreeAsImage(layer_tree, *compositor_context_,
+                                       surface_context, scale);
+    if (image) {
+      size = image->dimensions();
+    }
   }
-
-  if (data == nullptr) {
+  if (picture == nullptr && image == nullptr) {
     FML_LOG(ERROR) << "Screenshot data was null.";
-    return {};
+    callback({});
+    return;
+  }
+
+  auto encode = [type, base64_encode, size, picture = std::move(picture),
+                 image = std::move(image), callback = std::move(callback)]() {
+    TRACE_EVENT0("flutter", "Rasterizer::EncodeScreenshot");
+    sk_sp<SkData> data;
+    if (picture) {
+      SkSerialProcs procs = {0};
+      procs.fTypefaceProc = SerializeTypeface;
+      data = picture->serialize(&procs);
+    } else {
+      data = EncodeScreenshotImage(image, type);
+    }
+
+    if (data == nullptr) {
+      FML_LOG(ERROR) << "Screenshot data was null.";
+      callback({});
+      return;
+    }
+
+    if (base64_encode) {
+      size_t b64_size = SkBase64::Encode(data->data(), data->size(), nullptr);
+      auto b64_data = SkData::MakeUninitialized(b64_size);
+      SkBase64::Encode(data->data(), data->size(), b64_data->writable_data());
+      data = std::move(b64_data);
+    }
+    callback(Rasterizer::Screenshot{std::move(data), size});
+  };
+
+  if (encode_task_runner) {
+    encode_task_runner->PostTask(std::move(encode));
+  } else {
+    encode();
+  }
+}
+
+// Plays |picture| of |picture_size| back into the pixels of |job|.
+static bool RasterizeOffscreenJob(const sk_sp<SkPicture>& picture,
+                                  const SkISize& picture_size,
+                                  const Rasterizer::OffscreenRasterJob& job) {
+  TRACE_EVENT0("flutter", "Rasterizer::RasterizeOffscreenJob");
+  const auto image_info =
+      SkImageInfo::MakeN32Premul(job.size.width(), job.size.height());
+  auto surface =
+      SkSurface::MakeRasterDirect(image_info, job.pixels, job.row_bytes);
+  if (surface == nullptr) {
+    FML_LOG(ERROR) << "Could not wrap the pixels of an offscreen raster job.";
+    return false;
+  }
+  auto* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->scale(
+      static_cast<SkScalar>(job.size.width()) / picture_size.width(),
+      static_cast<SkScalar>(job.size.height()) / picture_size.height());
+  canvas->drawPicture(picture);
+  canvas->flush();
+  return true;
+}
+
+void Rasterizer::RasterizeLastLayerTree(
+    std::vector<OffscreenRasterJob> jobs,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  TRACE_EVENT1("flutter", "Rasterizer::RasterizeLastLayerTree", "jobs",
+               std::to_string(jobs.size()).c_str());
+  auto* layer_tree = GetLastLayerTree();
+  if (layer_tree == nullptr || layer_tree->frame_size().isEmpty()) {
+    FML_LOG(ERROR) << "There is no layer tree to rasterize offscreen.";
+    for (const auto& job : jobs) {
+      job.callback(false);
+    }
+    return;
   }
 
-  if (base64_encode) {
-    size_t b64_size = SkBase64::Encode(data->data(), data->size(), nullptr);
-    auto b64_data = SkData::MakeUninitialized(b64_size);
-    SkBase64::Encode(data->data(), data->size(), b64_data->writable_data());
-    return Rasterizer::Screenshot{b64_data, layer_tree->frame_size()};
+  // Flattening the layer tree once lets every job skip the preroll and share
+  // the recorded commands, which are immutable and safe to play back from
+  // several threads at once.
+  const SkISize picture_size = layer_tree->frame_size();
+  sk_sp<SkPicture> picture =
+      ScreenshotLayerTreeAsPicture(layer_tree, *compositor_context_);
+
+  for (auto& job : jobs) {
+    auto rasterize = [picture, picture_size, job = std::move(job)]() {
+      job.callback(picture != nullptr &&
+                   RasterizeOffscreenJob(picture, picture_size, job));
+    };
+    if (worker_task_runner) {
+      worker_task_runner->PostTask(std::move(rasterize));
+    } else {
+      rasterize();
+    }
   }
+}
+
+void Rasterizer::SetJankWatchdog(
+    std::unique_ptr<JankWatchdog> watchdog,
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner) {
+  jank_watchdog_ = std::move(watchdog);
+  jank_capture_task_runner_ = std::move(worker_task_runner);
+}
 
-  return Rasterizer::Screenshot{data, layer_tree->frame_size()};
+void Rasterizer::CaptureJank(JankWatchdog::Capture capture) {
+  TRACE_EVENT0("flutter", "Rasterizer::CaptureJank");
+  ScreenshotLastLayerTree(
+      ScreenshotType::SkiaPicture, false, 1.0f, jank_capture_task_runner_,
+      [capture = std::move(capture)](Screenshot screenshot) {
+        std::unique_ptr<fml::Mapping> picture;
+        if (screenshot.data) {
+          picture = std::make_unique<fml::NonOwnedMapping>(
+              screenshot.data->bytes(), screenshot.data->size());
+        }
+        JankWatchdog::WriteCapture(capture, picture.get());
+      });
 }
 
 void Rasterizer::SetNextFrameCallback(const fml::closure& callback) {
@@ -631,6 +1007,14 @@ void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
     return;
   }
 
+  if (resource_cache_sizer_ && !from_user) {
+    resource_cache_sizer_->SetBaseMaxBytes(max_bytes);
+    max_bytes = resource_cache_sizer_->GetMaxBytes();
+  }
+  ApplyResourceCacheMaxBytes(max_bytes);
+}
+
+void Rasterizer::ApplyResourceCacheMaxBytes(size_t max_bytes) {
   max_cache_bytes_ = max_bytes;
   if (!surface_) {
     return;
@@ -644,6 +1028,51 @@ void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
   }
 }
 
+void Rasterizer::EnableAdaptiveResourceCache(size_t device_memory_bytes) {
+  resource_cache_sizer_ =
+      std::make_unique<ResourceCacheSizer>(device_memory_bytes);
+  if (max_cache_bytes_.has_value() && !user_override_resource_cache_bytes_) {
+    SetResourceCacheMaxBytes(max_cache_bytes_.value(), false);
+  }
+}
+
+void Rasterizer::UpdateAdaptiveResourceCache(GrContext* context) {
+  if (!resource_cache_sizer_ || user_override_resource_cache_bytes_ ||
+      !context) {
+    return;
+  }
+  size_t used_bytes = 0;
+  context->getResourceCacheUsage(nullptr, &used_bytes);
+  if (resource_cache_sizer_->OnFrame(used_bytes)) {
+    ApplyResourceCacheMaxBytes(resource_cache_sizer_->GetMaxBytes());
+  }
+  FML_TRACE_COUNTER("flutter", "ResourceCacheChurn",
+                    reinterpret_cast<int64_t>(this),  //
+                    "ChurnPercent",
+                    static_cast<int64_t>(
+                        resource_cache_sizer_->GetChurnRate() * 100),  //
+                    "MaxBytes", resource_cache_sizer_->GetMaxBytes()   //
+  );
+}
+
+void Rasterizer::TraceGLContextSwitches() {
+  const auto stats = GLContextTracker::TakeStats();
+  FML_TRACE_COUNTER("flutter", "GLContextSwitches",
+                    reinterpret_cast<int64_t>(this),           //
+                    "Switches", stats.switches,                //
+                    "AvoidedSwitches", stats.avoided_switches  //
+  );
+}
+
+void Rasterizer::UpdateMemoryAccounting(GrContext* context) {
+  if (context) {
+    size_t used_bytes = 0;
+    context->getResourceCacheUsage(nullptr, &used_bytes);
+    gpu_resource_memory_charge_.Update(static_cast<int64_t>(used_bytes));
+  }
+  fml::TraceMemoryUsage();
+}
+
 std::optional<size_t> Rasterizer::GetResourceCacheMaxBytes() const {
   if (!surface_) {
     return std::nullopt;
@@ -5,15 +5,19 @@
 #ifndef SHELL_COMMON_RASTERIZER_H_
 #define SHELL_COMMON_RASTERIZER_H_
 
+#include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/shader_warm_up.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -21,7 +25,12 @@
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
+#include "flutter/shell/common/jank_watchdog.h"
+#include "flutter/shell/common/memory_pressure.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/resource_cache_sizer.h"
+#include "flutter/shell/common/snapshot_surface_pool.h"
+#include "third_party/skia/include/gpu/GrContext.h"
 
 namespace flutter {
 
@@ -187,10 +196,124 @@ class Rasterizer final : public SnapshotDelegate {
   //----------------------------------------------------------------------------
   /// @brief      Notifies the rasterizer that there is a low memory situation
   ///             and it must purge as many unnecessary resources as possible.
-  ///             Currently, the Skia context associated with onscreen rendering
-  ///             is told to free GPU resources.
+  ///             This is `MemoryPressureLevel::kCritical`.
   ///
-  void NotifyLowMemoryWarning() const;
+  /// @see        `Rasterizer::NotifyMemoryPressure`
+  ///
+  void NotifyLowMemoryWarning();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the rasterizer that the system is running low on
+  ///             memory, and purges resources according to how severe that
+  ///             is:
+  ///
+  ///             * `kModerate`: Raster cache entries not used by the last frame
+  ///               and GPU resources Skia holds no references to beyond its
+  ///               budgeted scratch resources are released.
+  ///             * `kCritical`: A raster cache retained across a teardown is
+  ///               cleared, and the Skia context associated with onscreen
+  ///               rendering is told to free all GPU resources it can.
+  ///             * `kBackground`: The raster cache is cleared entirely.
+  ///
+  ///             An adaptive resource cache budget shrinks along.
+  ///
+  /// @param[in]  level  How much memory should be given up.
+  ///
+  /// @return     The bytes released by the raster cache and the Skia context.
+  ///
+  MemoryPressureReport NotifyMemoryPressure(MemoryPressureLevel level);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets whether the raster cache is kept when the surface is
+  ///             torn down via `Rasterizer::Teardown`. The images of the cache
+  ///             live on the Skia context of the surface rather than on the
+  ///             surface itself. If the next surface passed to
+  ///             `Rasterizer::Setup` renders with the same context and that
+  ///             context has not been abandoned in the meantime, the first
+  ///             frames drawn into it use the cache instead of rasterizing
+  ///             everything again. Otherwise, the cache is cleared as usual.
+  ///
+  /// @attention  Surfaces that own their Skia context abandon it when they are
+  ///             destroyed, in which case the cache is never reused.
+  ///
+  /// @param[in]  retain  Whether to retain the raster cache on teardown.
+  ///
+  void SetRetainRasterCacheOnTeardown(bool retain) {
+    retain_raster_cache_on_teardown_ = retain;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the longest lease term, in frames, that the raster
+  ///             thread merger of the next surfaces stretches the lease of a
+  ///             merge to when platform views keep appearing and disappearing.
+  ///             Zero keeps the lease terms the external view embedder asks
+  ///             for.
+  ///
+  /// @see        `fml::RasterThreadMerger::SetMaxLeaseTerm`
+  ///
+  /// @param[in]  max_lease_term  The longest lease term in frames.
+  ///
+  void SetMaxMergedLeaseTerm(size_t max_lease_term) {
+    max_merged_lease_term_ = max_lease_term;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets how many offscreen surfaces are kept between the
+  ///             snapshots made for `Picture.toImage` and `Scene.toImage`, so
+  ///             that snapshots of the same size reuse a render target instead
+  ///             of allocating one each. The surfaces are dropped when the
+  ///             surface of the rasterizer is torn down.
+  ///
+  /// @param[in]  max_surfaces  The number of surfaces to keep. Zero keeps
+  ///                           none.
+  ///
+  void SetSnapshotSurfacePoolSize(size_t max_surfaces) {
+    snapshot_surface_pool_.SetMaxSurfaces(max_surfaces);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the watchdog that decides when a slow frame is captured.
+  ///             The layer tree of the frame is then recorded as an SKP on the
+  ///             raster thread, and serialized and written with the trace ring
+  ///             buffers and the recent frame timings on
+  ///             `worker_task_runner`.
+  ///
+  /// @see        `JankWatchdog`
+  ///
+  /// @param[in]  watchdog            The watchdog, or null to capture nothing.
+  /// @param[in]  worker_task_runner  The task runner captures are written on.
+  ///
+  void SetJankWatchdog(
+      std::unique_ptr<JankWatchdog> watchdog,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the recorder of the draw ops that shader warm-up replays
+  ///             at startup. The frames drawn into the root canvas are then
+  ///             recorded, and the recorded ops are written to the persistent
+  ///             cache after each frame that recorded new ones.
+  ///
+  /// @see        `ShaderWarmUpRecorder`
+  ///
+  /// @param[in]  recorder  The recorder, or null to record nothing.
+  ///
+  void SetShaderWarmUpRecorder(std::unique_ptr<ShaderWarmUpRecorder> recorder) {
+    shader_warm_up_recorder_ = std::move(recorder);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Makes the budget of Skia's resource cache adapt to the app,
+  ///             starting from the one the platform picks for the viewport.
+  ///             It grows while the cache keeps filling up and shrinks when
+  ///             the extra room goes unused or the system runs low on memory.
+  ///             The budget is no longer adapted once one is set by user code.
+  ///
+  /// @see        `ResourceCacheSizer`
+  ///
+  /// @param[in]  device_memory_bytes  The physical memory of the device, or
+  ///                                  zero if it is not known.
+  ///
+  void EnableAdaptiveResourceCache(size_t device_memory_bytes);
 
   //----------------------------------------------------------------------------
   /// @brief      Gets a weak pointer to the rasterizer. The rasterizer may only
@@ -232,6 +355,17 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   void DrawLastLayerTree();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Draws the last layer tree again into a frame of
+  ///             `frame_size`, so that the render surface follows a resize of
+  ///             the view at display rate while the framework lays out the
+  ///             contents at the new size. Does nothing if the last layer
+  ///             tree was already of that size.
+  ///
+  /// @param[in]  frame_size  The new size of the view in physical pixels.
+  ///
+  void DrawLastLayerTreeAtSize(const SkISize& frame_size);
+
   //----------------------------------------------------------------------------
   /// @brief      Gets the registry of external textures currently in use by the
   ///             rasterizer. These textures may be updated at a cadence
@@ -239,9 +373,12 @@ class Rasterizer final : public SnapshotDelegate {
   ///             external texture is referenced in the Flutter layer tree, that
   ///             texture is composited within the Flutter layer tree.
   ///
-  /// @return     A pointer to the external texture registry.
+  ///             The registry may be updated from other threads, which keep
+  ///             it alive while they do.
+  ///
+  /// @return     The external texture registry.
   ///
-  flutter::TextureRegistry* GetTextureRegistry();
+  std::shared_ptr<flutter::TextureRegistry> GetTextureRegistry();
 
   //----------------------------------------------------------------------------
   /// @brief      Takes the next item from the layer tree pipeline and executes
@@ -297,6 +434,13 @@ class Rasterizer final : public SnapshotDelegate {
     ///
     UncompressedImage,
 
+    //--------------------------------------------------------------------------
+    /// A format used to denote uncompressed image data with 8 bits per
+    /// component in RGBA order, independent of the native color type of the
+    /// platform.
+    ///
+    UncompressedRGBAImage,
+
     //--------------------------------------------------------------------------
     /// A format used to denote compressed image data. The PNG compressed
     /// container is used.
@@ -365,6 +509,85 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   Screenshot ScreenshotLastLayerTree(ScreenshotType type, bool base64_encode);
 
+  using ScreenshotCallback = std::function<void(Screenshot)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Screenshots the last layer tree like the synchronous variant,
+  ///             but only draws the layer tree and reads back its pixels on
+  ///             the calling raster thread. Encoding the screenshot, which
+  ///             usually takes much longer, happens on `encode_task_runner`.
+  ///
+  /// @param[in]  type                The type of the screenshot to gather.
+  /// @param[in]  base64_encode       Whether Base 64 encoding must be applied
+  ///                                 to the data after a screenshot has been
+  ///                                 captured.
+  /// @param[in]  scale               The factor to scale image screenshots by,
+  ///                                 which makes downscaled screenshots cheaper
+  ///                                 to read back and encode. Ignored for Skia
+  ///                                 pictures.
+  /// @param[in]  encode_task_runner  The task runner to encode the screenshot
+  ///                                 on, or null to encode it right away.
+  /// @param[in]  callback            Called with the screenshot, or an empty
+  ///                                 one if it could not be captured. It is
+  ///                                 invoked on `encode_task_runner`, or
+  ///                                 before returning if capturing failed or
+  ///                                 there is no task runner.
+  ///
+  void ScreenshotLastLayerTree(
+      ScreenshotType type,
+      bool base64_encode,
+      float scale,
+      std::shared_ptr<fml::ConcurrentTaskRunner> encode_task_runner,
+      ScreenshotCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      A request to rasterize the last layer tree into pixels owned
+  ///             by the caller.
+  ///
+  struct OffscreenRasterJob {
+    //--------------------------------------------------------------------------
+    /// The size of the output in pixels. The layer tree is scaled to fill it.
+    ///
+    SkISize size = SkISize::MakeEmpty();
+
+    //--------------------------------------------------------------------------
+    /// The caller-owned output, in the native 32 bits per pixel premultiplied
+    /// format denoted by `kN32_SkColorType`. It must stay valid until
+    /// `callback` is invoked.
+    ///
+    void* pixels = nullptr;
+
+    //--------------------------------------------------------------------------
+    /// The number of bytes between the starts of two rows of `pixels`.
+    ///
+    size_t row_bytes = 0;
+
+    //--------------------------------------------------------------------------
+    /// Called once the job is done with whether the pixels were written.
+    ///
+    std::function<void(bool)> callback;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Rasterizes the last layer tree into the buffers of `jobs`
+  ///             without going through the on-screen surface, for embedders
+  ///             that only render offscreen.
+  ///
+  ///             The layer tree is flattened into a picture once on the
+  ///             calling raster thread, after which each job is played back
+  ///             on the CPU. Since no `GrContext` is involved, the jobs can
+  ///             run in parallel on `worker_task_runner`, which makes this
+  ///             unsuitable for layer trees with GPU backed textures.
+  ///
+  /// @param[in]  jobs                The jobs to rasterize.
+  /// @param[in]  worker_task_runner  The task runner to rasterize the jobs
+  ///                                 on in parallel, or null to rasterize
+  ///                                 them back-to-back before returning.
+  ///
+  void RasterizeLastLayerTree(
+      std::vector<OffscreenRasterJob> jobs,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
+
   //----------------------------------------------------------------------------
   /// @brief      Sets a callback that will be executed when the next layer tree
   ///             in rendered to the on-screen surface. This is used by
@@ -441,36 +664,97 @@ class Rasterizer final : public SnapshotDelegate {
   // has not successfully rasterized. This can happen due to the change in the
   // thread configuration. This will be inserted to the front of the pipeline.
   std::unique_ptr<flutter::LayerTree> resubmitted_layer_tree_;
+  // Set when the surface had no buffer ready in time for this layer tree. It
+  // is drawn again from a later task unless a newer layer tree is drawn first.
+  std::unique_ptr<flutter::LayerTree> deferred_layer_tree_;
   fml::closure next_frame_callback_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
+  std::unique_ptr<ResourceCacheSizer> resource_cache_sizer_;
+  bool retain_raster_cache_on_teardown_ = false;
+  size_t max_merged_lease_term_ = 0;
+  // The context the raster cache was populated with when it was retained by
+  // the last teardown.
+  sk_sp<GrContext> retained_cache_context_;
+  // The bytes in Skia's resource cache, charged to the "GPUResourceCache"
+  // counter.
+  fml::MemoryCharge gpu_resource_memory_charge_;
+  SnapshotSurfacePool snapshot_surface_pool_{0};
+  std::unique_ptr<JankWatchdog> jank_watchdog_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> jank_capture_task_runner_;
+  std::unique_ptr<ShaderWarmUpRecorder> shader_warm_up_recorder_;
+  // Releases the GPU-resident snapshots on the raster thread.
+  fml::RefPtr<SkiaUnrefQueue> snapshot_unref_queue_;
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
 
+  // Sets the budget of Skia's resource cache of the current surface.
+  void ApplyResourceCacheMaxBytes(size_t max_bytes);
+
+  // Adapts the budget of Skia's resource cache to its usage by the last frame.
+  void UpdateAdaptiveResourceCache(GrContext* context);
+
+  // Updates the memory charged for Skia's resource cache and traces the
+  // memory counters of the process.
+  void UpdateMemoryAccounting(GrContext* context);
+
+  // Traces the GL context switches made and avoided on the raster thread since
+  // the last frame.
+  void TraceGLContextSwitches();
+
   // |SnapshotDelegate|
   sk_sp<SkImage> MakeRasterSnapshot(sk_sp<SkPicture> picture,
                                     SkISize picture_size) override;
 
+  // |SnapshotDelegate|
+  std::vector<sk_sp<SkImage>> MakeRasterSnapshots(
+      const std::vector<sk_sp<SkPicture>>& pictures,
+      SkISize picture_size,
+      bool gpu_resident) override;
+
+  // |SnapshotDelegate|
+  fml::RefPtr<SkiaUnrefQueue> GetSnapshotUnrefQueue() const override;
+
   // |SnapshotDelegate|
   sk_sp<SkImage> ConvertToRasterImage(sk_sp<SkImage> image) override;
 
-  sk_sp<SkData> ScreenshotLayerTreeAsImage(
+  // Draws |tree| scaled by |scale| and reads the result back into a raster
+  // image.
+  sk_sp<SkImage> ScreenshotLayerTreeAsImage(
       flutter::LayerTree* tree,
       flutter::CompositorContext& compositor_context,
       GrContext* surface_context,
-      bool compressed);
+      float scale);
 
   sk_sp<SkImage> DoMakeRasterSnapshot(
       SkISize size,
       std::function<void(SkCanvas*)> draw_callback);
 
-  RasterStatus DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree);
+  // Draws |count| snapshots of |size| with one switch to the render context,
+  // calling |draw_callback| with the index of each.
+  std::vector<sk_sp<SkImage>> DoMakeRasterSnapshots(
+      SkISize size,
+      size_t count,
+      const std::function<void(SkCanvas*, size_t)>& draw_callback,
+      bool gpu_resident);
+
+  RasterStatus DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree,
+                      size_t superseded_frame_count);
 
-  RasterStatus DrawToSurface(flutter::LayerTree& layer_tree);
+  // Draws |deferred_layer_tree_| again from a task, which lets the pipeline
+  // yield newer layer trees in the meantime.
+  void ScheduleDeferredDraw();
+
+  // Records the breakdown of the raster phase in |timing| if it is not null.
+  RasterStatus DrawToSurface(flutter::LayerTree& layer_tree,
+                             FrameTiming* timing = nullptr);
 
   void FireNextFrameCallbackIfPresent();
 
+  // Records the last layer tree and writes it with the rest of |capture|.
+  void CaptureJank(JankWatchdog::Capture capture);
+
   FML_DISALLOW_COPY_AND_ASSIGN(Rasterizer);
 };
 
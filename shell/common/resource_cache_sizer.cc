@@ -0,0 +1,127 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/resource_cache_sizer.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+namespace {
+
+constexpr size_t kGigabyte = static_cast<size_t>(1) << 30;
+
+// A frame ends with the cache full when it uses this fraction of the budget.
+// Skia purges down to the budget at the end of a frame, so anything uploaded
+// during the next one evicts a resource that may still be needed.
+constexpr double kFullFraction = 0.9;
+
+// The budget grows when this fraction of the frames of a window ended with
+// the cache full.
+constexpr double kGrowChurnRate = 0.25;
+
+// The number of windows the budget is not grown for after memory pressure.
+constexpr size_t kPressureCooldownWindows = 5;
+
+}  // namespace
+
+ResourceCacheSizer::MemoryClass ResourceCacheSizer::GetMemoryClass(
+    size_t device_memory_bytes) {
+  if (device_memory_bytes == 0) {
+    return MemoryClass::kMedium;
+  }
+  // Devices report a little less than their nominal memory.
+  if (device_memory_bytes <= 2 * kGigabyte + kGigabyte / 4) {
+    return MemoryClass::kLow;
+  }
+  if (device_memory_bytes >= 6 * kGigabyte - kGigabyte / 2) {
+    return MemoryClass::kHigh;
+  }
+  return MemoryClass::kMedium;
+}
+
+ResourceCacheSizer::ResourceCacheSizer(size_t device_memory_bytes)
+    : memory_class_(GetMemoryClass(device_memory_bytes)),
+      device_memory_bytes_(device_memory_bytes) {}
+
+ResourceCacheSizer::~ResourceCacheSizer() = default;
+
+void ResourceCacheSizer::SetBaseMaxBytes(size_t base_max_bytes) {
+  switch (memory_class_) {
+    case MemoryClass::kLow:
+      base_max_bytes_ = base_max_bytes / 2;
+      break;
+    case MemoryClass::kMedium:
+      base_max_bytes_ = base_max_bytes;
+      break;
+    case MemoryClass::kHigh:
+      base_max_bytes_ = base_max_bytes + base_max_bytes / 2;
+      break;
+  }
+  max_bytes_ = base_max_bytes_;
+  ResetWindow();
+}
+
+size_t ResourceCacheSizer::GetCeilingBytes() const {
+  size_t ceiling = base_max_bytes_ * 2;
+  if (device_memory_bytes_ > 0) {
+    ceiling = std::min(ceiling, device_memory_bytes_ / 16);
+  }
+  return std::max(ceiling, base_max_bytes_);
+}
+
+bool ResourceCacheSizer::OnFrame(size_t used_bytes) {
+  if (max_bytes_ == 0) {
+    return false;
+  }
+
+  window_frames_++;
+  if (used_bytes >= max_bytes_ * kFullFraction) {
+    window_full_frames_++;
+  }
+  window_peak_bytes_ = std::max(window_peak_bytes_, used_bytes);
+  if (window_frames_ < kWindowFrameCount) {
+    return false;
+  }
+
+  churn_rate_ = static_cast<double>(window_full_frames_) / window_frames_;
+  const size_t peak_bytes = window_peak_bytes_;
+  ResetWindow();
+
+  const size_t old_max_bytes = max_bytes_;
+  if (cooldown_windows_ > 0) {
+    cooldown_windows_--;
+  } else if (churn_rate_ >= kGrowChurnRate) {
+    max_bytes_ = std::min(GetCeilingBytes(), max_bytes_ + max_bytes_ / 4);
+  }
+  if (churn_rate_ == 0.0 && peak_bytes < max_bytes_ / 2 &&
+      max_bytes_ > base_max_bytes_) {
+    max_bytes_ = std::max(base_max_bytes_, max_bytes_ - max_bytes_ / 5);
+  }
+  return max_bytes_ != old_max_bytes;
+}
+
+void ResourceCacheSizer::OnMemoryPressure(MemoryPressureLevel level) {
+  switch (level) {
+    case MemoryPressureLevel::kModerate:
+      max_bytes_ = std::min(max_bytes_, base_max_bytes_);
+      break;
+    case MemoryPressureLevel::kCritical:
+      max_bytes_ = std::min(max_bytes_, base_max_bytes_ / 2);
+      break;
+    case MemoryPressureLevel::kBackground:
+      max_bytes_ = std::min(max_bytes_, base_max_bytes_ / 4);
+      break;
+  }
+  cooldown_windows_ = kPressureCooldownWindows;
+  ResetWindow();
+}
+
+void ResourceCacheSizer::ResetWindow() {
+  window_frames_ = 0;
+  window_full_frames_ = 0;
+  window_peak_bytes_ = 0;
+}
+
+}  // namespace flutter
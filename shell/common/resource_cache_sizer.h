@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_RESOURCE_CACHE_SIZER_H_
+#define FLUTTER_SHELL_COMMON_RESOURCE_CACHE_SIZER_H_
+
+#include <cstddef>
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/common/memory_pressure.h"
+
+namespace flutter {
+
+/// Adapts the budget of Skia's resource cache to how the app uses it.
+///
+/// The budget starts at the one the platform picks for the viewport, scaled
+/// by how much memory the device has. It grows when the cache keeps filling
+/// up, as resources are then evicted only to be uploaded again a few frames
+/// later, and shrinks back when the extra room goes unused or the system runs
+/// low on memory.
+///
+/// Not thread safe. The rasterizer uses it on the raster thread.
+class ResourceCacheSizer {
+ public:
+  /// The number of frames the churn rate is measured over.
+  static constexpr size_t kWindowFrameCount = 60;
+
+  enum class MemoryClass {
+    // Devices with 2GB of memory or less.
+    kLow,
+    // Devices with more than 2GB and less than 6GB of memory, or of which the
+    // memory is not known.
+    kMedium,
+    // Devices with 6GB of memory or more.
+    kHigh,
+  };
+
+  static MemoryClass GetMemoryClass(size_t device_memory_bytes);
+
+  /// @param device_memory_bytes The physical memory of the device, or zero if
+  ///                            it is not known.
+  explicit ResourceCacheSizer(size_t device_memory_bytes);
+
+  ~ResourceCacheSizer();
+
+  /// Sets the budget the platform picked for the viewport. The budget is
+  /// reset to it, scaled by the memory class of the device.
+  void SetBaseMaxBytes(size_t base_max_bytes);
+
+  /// Records the bytes used by the resource cache at the end of a frame, and
+  /// returns whether that changed the budget.
+  bool OnFrame(size_t used_bytes);
+
+  /// Shrinks the budget to the base budget for `kModerate`, and below it for
+  /// more severe levels. It doesn't grow again for a few windows after that.
+  void OnMemoryPressure(MemoryPressureLevel level);
+
+  /// The budget of the resource cache, or zero if no base budget was set yet.
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  /// The most the budget grows to.
+  size_t GetCeilingBytes() const;
+
+  /// The fraction of the frames in the last complete window that ended with
+  /// the resource cache full.
+  double GetChurnRate() const { return churn_rate_; }
+
+ private:
+  const MemoryClass memory_class_;
+  const size_t device_memory_bytes_;
+  size_t base_max_bytes_ = 0;
+  size_t max_bytes_ = 0;
+  size_t window_frames_ = 0;
+  size_t window_full_frames_ = 0;
+  size_t window_peak_bytes_ = 0;
+  size_t cooldown_windows_ = 0;
+  double churn_rate_ = 0.0;
+
+  void ResetWindow();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ResourceCacheSizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_RESOURCE_CACHE_SIZER_H_
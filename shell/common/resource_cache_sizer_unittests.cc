@@ -0,0 +1,122 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/resource_cache_sizer.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr size_t kMegabyte = 1 << 20;
+constexpr size_t kGigabyte = 1 << 30;
+
+// Records a window of frames that all used |used_bytes|, and returns whether
+// the last one changed the budget.
+bool RunWindow(ResourceCacheSizer& sizer, size_t used_bytes) {
+  bool changed = false;
+  for (size_t i = 0; i < ResourceCacheSizer::kWindowFrameCount; i++) {
+    changed = sizer.OnFrame(used_bytes);
+  }
+  return changed;
+}
+
+}  // namespace
+
+TEST(ResourceCacheSizerTest, ScalesTheBaseBudgetByMemoryClass) {
+  EXPECT_EQ(ResourceCacheSizer::GetMemoryClass(0),
+            ResourceCacheSizer::MemoryClass::kMedium);
+  EXPECT_EQ(ResourceCacheSizer::GetMemoryClass(2 * kGigabyte),
+            ResourceCacheSizer::MemoryClass::kLow);
+  EXPECT_EQ(ResourceCacheSizer::GetMemoryClass(4 * kGigabyte),
+            ResourceCacheSizer::MemoryClass::kMedium);
+  EXPECT_EQ(ResourceCacheSizer::GetMemoryClass(8 * kGigabyte),
+            ResourceCacheSizer::MemoryClass::kHigh);
+
+  ResourceCacheSizer low(2 * kGigabyte);
+  low.SetBaseMaxBytes(100 * kMegabyte);
+  EXPECT_EQ(low.GetMaxBytes(), 50 * kMegabyte);
+
+  ResourceCacheSizer unknown(0);
+  unknown.SetBaseMaxBytes(100 * kMegabyte);
+  EXPECT_EQ(unknown.GetMaxBytes(), 100 * kMegabyte);
+
+  ResourceCacheSizer high(8 * kGigabyte);
+  high.SetBaseMaxBytes(100 * kMegabyte);
+  EXPECT_EQ(high.GetMaxBytes(), 150 * kMegabyte);
+}
+
+TEST(ResourceCacheSizerTest, GrowsWhileTheCacheChurnsUpToTheCeiling) {
+  ResourceCacheSizer sizer(0);
+  EXPECT_FALSE(sizer.OnFrame(kMegabyte));
+  sizer.SetBaseMaxBytes(100 * kMegabyte);
+
+  // A cache with room to spare keeps its budget.
+  EXPECT_FALSE(RunWindow(sizer, 60 * kMegabyte));
+  EXPECT_EQ(sizer.GetChurnRate(), 0.0);
+  EXPECT_EQ(sizer.GetMaxBytes(), 100 * kMegabyte);
+
+  EXPECT_TRUE(RunWindow(sizer, 100 * kMegabyte));
+  EXPECT_EQ(sizer.GetChurnRate(), 1.0);
+  EXPECT_EQ(sizer.GetMaxBytes(), 125 * kMegabyte);
+
+  for (size_t i = 0; i < 10; i++) {
+    RunWindow(sizer, sizer.GetMaxBytes());
+  }
+  EXPECT_EQ(sizer.GetMaxBytes(), sizer.GetCeilingBytes());
+  EXPECT_EQ(sizer.GetCeilingBytes(), 200 * kMegabyte);
+}
+
+TEST(ResourceCacheSizerTest, CeilingIsBoundByDeviceMemory) {
+  ResourceCacheSizer sizer(4 * kGigabyte);
+  sizer.SetBaseMaxBytes(200 * kMegabyte);
+  EXPECT_EQ(sizer.GetCeilingBytes(), 256 * kMegabyte);
+
+  // The ceiling is never below the base budget.
+  sizer.SetBaseMaxBytes(300 * kMegabyte);
+  EXPECT_EQ(sizer.GetCeilingBytes(), 300 * kMegabyte);
+}
+
+TEST(ResourceCacheSizerTest, ShrinksBackWhenTheExtraRoomGoesUnused) {
+  ResourceCacheSizer sizer(0);
+  sizer.SetBaseMaxBytes(100 * kMegabyte);
+  RunWindow(sizer, 100 * kMegabyte);
+  RunWindow(sizer, 125 * kMegabyte);
+  ASSERT_GT(sizer.GetMaxBytes(), 125 * kMegabyte);
+
+  for (size_t i = 0; i < 10; i++) {
+    RunWindow(sizer, 10 * kMegabyte);
+  }
+  EXPECT_EQ(sizer.GetMaxBytes(), 100 * kMegabyte);
+}
+
+TEST(ResourceCacheSizerTest, ShrinksUnderMemoryPressure) {
+  ResourceCacheSizer sizer(0);
+  sizer.SetBaseMaxBytes(100 * kMegabyte);
+  RunWindow(sizer, 100 * kMegabyte);
+  ASSERT_EQ(sizer.GetMaxBytes(), 125 * kMegabyte);
+
+  sizer.OnMemoryPressure(MemoryPressureLevel::kModerate);
+  EXPECT_EQ(sizer.GetMaxBytes(), 100 * kMegabyte);
+  sizer.OnMemoryPressure(MemoryPressureLevel::kCritical);
+  EXPECT_EQ(sizer.GetMaxBytes(), 50 * kMegabyte);
+  sizer.OnMemoryPressure(MemoryPressureLevel::kBackground);
+  EXPECT_EQ(sizer.GetMaxBytes(), 25 * kMegabyte);
+
+  // Churn right after memory pressure doesn't grow the budget again.
+  for (size_t i = 0; i < 5; i++) {
+    EXPECT_FALSE(RunWindow(sizer, 25 * kMegabyte));
+  }
+  EXPECT_TRUE(RunWindow(sizer, 25 * kMegabyte));
+  EXPECT_EQ(sizer.GetMaxBytes(), 25 * kMegabyte + 25 * kMegabyte / 4);
+
+  // A new viewport resets the budget.
+  sizer.SetBaseMaxBytes(100 * kMegabyte);
+  EXPECT_EQ(sizer.GetMaxBytes(), 100 * kMegabyte);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,221 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_RING_PIPELINE_H_
+#define FLUTTER_SHELL_COMMON_RING_PIPELINE_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/pipeline.h"
+
+namespace flutter {
+
+/// A lock-free variant of |Pipeline| for a single producer and a single
+/// consumer thread.
+///
+/// Resources are handed over through a ring of |depth| slots allocated up
+/// front, and continuations refer back to the pipeline directly, so producing
+/// and consuming a resource neither locks nor allocates.
+///
+/// The interface is the same as that of |Pipeline|, with one restriction:
+/// |Produce| continuations may only be completed on the producer thread, and
+/// |ProduceIfEmpty| continuations only on the consumer thread, which is how
+/// the rasterizer resubmits a frame it could not draw. Resources produced that
+/// way go into a slot that only the consumer accesses.
+template <class R>
+class RingPipeline : public fml::RefCountedThreadSafe<RingPipeline<R>> {
+ public:
+  using Resource = R;
+  using ResourcePtr = std::unique_ptr<Resource>;
+
+  /// Denotes a spot in the pipeline reserved for the producer to finish
+  /// preparing a completed pipeline resource.
+  class ProducerContinuation {
+   public:
+    ProducerContinuation() = default;
+
+    ProducerContinuation(ProducerContinuation&& other)
+        : pipeline_(other.pipeline_),
+          if_empty_(other.if_empty_),
+          trace_id_(other.trace_id_) {
+      other.pipeline_ = nullptr;
+      other.trace_id_ = 0;
+    }
+
+    ProducerContinuation& operator=(ProducerContinuation&& other) {
+      std::swap(pipeline_, other.pipeline_);
+      std::swap(if_empty_, other.if_empty_);
+      std::swap(trace_id_, other.trace_id_);
+      return *this;
+    }
+
+    ~ProducerContinuation() {
+      if (pipeline_) {
+        pipeline_->Commit(nullptr, trace_id_, if_empty_);
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
+        // The continuation is being dropped on the floor. End the flow.
+        TRACE_FLOW_END("flutter", "PipelineItem", trace_id_);
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id_);
+      }
+    }
+
+    [[nodiscard]] bool Complete(ResourcePtr resource) {
+      bool result = false;
+      if (pipeline_) {
+        result = pipeline_->Commit(std::move(resource), trace_id_, if_empty_);
+        pipeline_ = nullptr;
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
+        TRACE_FLOW_STEP("flutter", "PipelineItem", trace_id_);
+      }
+      return result;
+    }
+
+    operator bool() const { return pipeline_ != nullptr; }
+
+   private:
+    friend class RingPipeline;
+
+    RingPipeline* pipeline_ = nullptr;
+    bool if_empty_ = false;
+    size_t trace_id_ = 0;
+
+    ProducerContinuation(RingPipeline* pipeline, bool if_empty, size_t trace_id)
+        : pipeline_(pipeline), if_empty_(if_empty), trace_id_(trace_id) {
+      TRACE_FLOW_BEGIN("flutter", "PipelineItem", trace_id_);
+      TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineItem", trace_id_);
+      TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id_);
+    }
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
+  };
+
+  explicit RingPipeline(uint32_t depth)
+      : slots_(depth), empty_(static_cast<int>(depth)) {}
+
+  ~RingPipeline() = default;
+
+  bool IsValid() const { return !slots_.empty(); }
+
+  ProducerContinuation Produce() { return Reserve(false); }
+
+  // Create a `ProducerContinuation` that will only push the task if the queue
+  // is empty. Unlike |Produce|, it must be completed on the consumer thread.
+  // Prefer using |Produce|. ProducerContinuation returned by this method
+  // doesn't guarantee that the frame will be rendered.
+  ProducerContinuation ProduceIfEmpty() { return Reserve(true); }
+
+  using Consumer = std::function<void(ResourcePtr)>;
+
+  /// @note Procedure doesn't copy all closures.
+  [[nodiscard]] PipelineConsumeResult Consume(const Consumer& consumer) {
+    if (consumer == nullptr) {
+      return PipelineConsumeResult::NoneAvailable;
+    }
+
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (has_front_) {
+      resource = std::move(front_.first);
+      trace_id = front_.second;
+      has_front_ = false;
+    } else if (head != tail_.load(std::memory_order_acquire)) {
+      Slot& slot = slots_[head % slots_.size()];
+      resource = std::move(slot.first);
+      trace_id = slot.second;
+      // Hand the slot back to the producer.
+      head_.store(head + 1, std::memory_order_release);
+    } else {
+      return PipelineConsumeResult::NoneAvailable;
+    }
+
+    {
+      TRACE_EVENT0("flutter", "PipelineConsume");
+      consumer(std::move(resource));
+    }
+
+    // Releasing the reservation after the slot was handed back lets the
+    // producer that acquires it write to the slot.
+    empty_.fetch_add(1, std::memory_order_release);
+    --inflight_;
+
+    TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
+
+    return HasItems() ? PipelineConsumeResult::MoreAvailable
+                      : PipelineConsumeResult::Done;
+  }
+
+ private:
+  using Slot = std::pair<ResourcePtr, size_t>;
+
+  // Only the producer writes |tail_| and only the consumer writes |head_|. Both
+  // only ever increase, the slot of an index is the index modulo the depth.
+  std::vector<Slot> slots_;
+  alignas(64) std::atomic<size_t> head_ = {0};
+  alignas(64) std::atomic<size_t> tail_ = {0};
+  // The number of slots that have not been reserved by a continuation.
+  std::atomic<int> empty_;
+  std::atomic<int> inflight_ = {0};
+  // The resource resubmitted by the consumer through |ProduceIfEmpty|.
+  Slot front_;
+  bool has_front_ = false;
+
+  ProducerContinuation Reserve(bool if_empty) {
+    int empty = empty_.load(std::memory_order_relaxed);
+    do {
+      if (empty <= 0) {
+        return {};
+      }
+    } while (!empty_.compare_exchange_weak(empty, empty - 1,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed));
+    ++inflight_;
+    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                      reinterpret_cast<int64_t>(this),      //
+                      "frames in flight", inflight_.load()  //
+    );
+
+    return ProducerContinuation{this, if_empty, GetNextPipelineTraceID()};
+  }
+
+  bool HasItems() const {
+    return has_front_ || head_.load(std::memory_order_relaxed) !=
+                             tail_.load(std::memory_order_acquire);
+  }
+
+  bool Commit(ResourcePtr resource, size_t trace_id, bool if_empty) {
+    if (if_empty) {
+      if (HasItems()) {
+        // Bail if the queue is not empty, opens up spaces to produce other
+        // frames.
+        --inflight_;
+        empty_.fetch_add(1, std::memory_order_release);
+        return false;
+      }
+      front_ = {std::move(resource), trace_id};
+      has_front_ = true;
+      return true;
+    }
+
+    // The reservation guarantees that the consumer is done with the slot.
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    slots_[tail % slots_.size()] = {std::move(resource), trace_id};
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RingPipeline);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_RING_PIPELINE_H_
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <memory>
+#include <thread>
+
+#include "flutter/shell/common/ring_pipeline.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+using IntRingPipeline = RingPipeline<int>;
+using RingContinuation = IntRingPipeline::ProducerContinuation;
+
+TEST(RingPipelineTest, ConsumeOneVal) {
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(2);
+
+  RingContinuation continuation = pipeline->Produce();
+
+  const int test_val = 1;
+  bool result = continuation.Complete(std::make_unique<int>(test_val));
+  ASSERT_EQ(result, true);
+
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&test_val](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val); });
+
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+}
+
+TEST(RingPipelineTest, PushingMoreThanDepthCompletesFirstSubmission) {
+  const int depth = 1;
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(depth);
+
+  RingContinuation continuation_1 = pipeline->Produce();
+  RingContinuation continuation_2 = pipeline->Produce();
+  ASSERT_FALSE(continuation_2);
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  bool result = continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result, true);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, false);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  // Consuming frees the slot for the next frame.
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(RingPipelineTest, WrapsAroundInOrder) {
+  const int depth = 2;
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(depth);
+
+  for (int i = 0; i < 5; i++) {
+    RingContinuation continuation_1 = pipeline->Produce();
+    RingContinuation continuation_2 = pipeline->Produce();
+    ASSERT_TRUE(continuation_1.Complete(std::make_unique<int>(2 * i)));
+    ASSERT_TRUE(continuation_2.Complete(std::make_unique<int>(2 * i + 1)));
+
+    PipelineConsumeResult consume_result_1 = pipeline->Consume(
+        [i](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2 * i); });
+    ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+    PipelineConsumeResult consume_result_2 = pipeline->Consume(
+        [i](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2 * i + 1); });
+    ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+  }
+}
+
+TEST(RingPipelineTest, ProduceIfEmptyDoesNotConsumeWhenQueueIsNotEmpty) {
+  const int depth = 2;
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(depth);
+
+  RingContinuation continuation_1 = pipeline->Produce();
+  RingContinuation continuation_2 = pipeline->ProduceIfEmpty();
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  bool result = continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result, true);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, false);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  // The bailed out reservation was given back.
+  RingContinuation continuation_3 = pipeline->Produce();
+  RingContinuation continuation_4 = pipeline->Produce();
+  ASSERT_TRUE(continuation_3);
+  ASSERT_TRUE(continuation_4);
+}
+
+TEST(RingPipelineTest, ResubmittedResourceIsConsumedFirst) {
+  const int depth = 2;
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(depth);
+
+  RingContinuation resubmit = pipeline->ProduceIfEmpty();
+  ASSERT_TRUE(resubmit.Complete(std::make_unique<int>(1)));
+  RingContinuation continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation.Complete(std::make_unique<int>(2)));
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [](std::unique_ptr<int> v) { ASSERT_EQ(*v, 1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+  PipelineConsumeResult consume_result_2 = pipeline->Consume(
+      [](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(RingPipelineTest, HandsOverAcrossThreadsInOrder) {
+  const int depth = 3;
+  const int count = 10000;
+  fml::RefPtr<IntRingPipeline> pipeline =
+      fml::MakeRefCounted<IntRingPipeline>(depth);
+
+  std::thread producer([pipeline, count]() {
+    for (int i = 0; i < count;) {
+      RingContinuation continuation = pipeline->Produce();
+      if (!continuation) {
+        std::this_thread::yield();
+        continue;
+      }
+      ASSERT_TRUE(continuation.Complete(std::make_unique<int>(i++)));
+    }
+  });
+
+  int expected = 0;
+  while (expected < count) {
+    PipelineConsumeResult result =
+        pipeline->Consume([&expected](std::unique_ptr<int> v) {
+          ASSERT_EQ(*v, expected);
+          expected++;
+        });
+    if (result == PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
@@ -24,9 +25,16 @@ RunConfiguration RunConfiguration::InferFromSettings(
         fml::Duplicate(settings.assets_dir)));
   }
 
-  asset_manager->PushBack(
-      std::make_unique<DirectoryAssetBundle>(fml::OpenDirectory(
-          settings.assets_path.c_str(), false, fml::FilePermission::kRead)));
+  // The assets path is either the flutter_assets directory or a bundle packed
+  // into a single file.
+  if (fml::IsFile(settings.assets_path)) {
+    asset_manager->PushBack(std::make_unique<PackedAssetBundle>(fml::OpenFile(
+        settings.assets_path.c_str(), false, fml::FilePermission::kRead)));
+  } else {
+    asset_manager->PushBack(
+        std::make_unique<DirectoryAssetBundle>(fml::OpenDirectory(
+            settings.assets_path.c_str(), false, fml::FilePermission::kRead)));
+  }
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
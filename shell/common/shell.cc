@@ -10,21 +10,29 @@
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/flow/shader_warm_up.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/log_settings.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/memory/memory_accounting.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/sync_profiler.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_ring_buffer.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/runtime/dart_service_isolate.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/asset_access_manifest.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
+#include "flutter/third_party/txt/src/txt/platform.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -39,6 +47,41 @@ constexpr char kSystemChannel[] = "flutter/system";
 constexpr char kTypeKey[] = "type";
 constexpr char kFontChange[] = "fontsChange";
 
+// Dispatches the messages queued for |channel| to |engine|. Called on the UI
+// thread.
+static void DrainPlatformMessageBuffer(const fml::WeakPtr<Engine>& engine,
+                                       PlatformMessageBuffers* buffers,
+                                       const std::string& channel) {
+  auto drained = buffers->Drain(channel);
+  if (!engine) {
+    return;
+  }
+  if (drained.batch_delivery) {
+    engine->DispatchPlatformMessages(channel, std::move(drained.messages));
+    return;
+  }
+  for (auto& drained_message : drained.messages) {
+    engine->DispatchPlatformMessage(std::move(drained_message));
+  }
+}
+
+// Starts the upload workers of |io_manager| with resource contexts from
+// |platform_view|, once the IO manager has a resource context to share them
+// with. Called on the IO thread.
+static void StartIOUploadWorkers(ShellIOManager* io_manager,
+                                 const PlatformView* platform_view,
+                                 size_t count) {
+  if (count == 0 || !io_manager->GetResourceContext()) {
+    return;
+  }
+  io_manager->StartUploadWorkers(
+      count,
+      [platform_view]() {
+        return platform_view->CreateWorkerResourceContext();
+      },
+      [platform_view]() { platform_view->ReleaseWorkerResourceContext(); });
+}
+
 std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     DartVMRef vm,
     TaskRunners task_runners,
@@ -55,6 +98,19 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   auto shell =
       std::unique_ptr<Shell>(new Shell(std::move(vm), task_runners, settings));
 
+  // Creating the default font manager scans the fonts of the system, which
+  // doesn't depend on any of the other subsystems. Start it on a worker so that
+  // it overlaps with the setup of the rest of the shell.
+  auto font_manager_promise =
+      std::make_shared<std::promise<sk_sp<SkFontMgr>>>();
+  std::shared_future<sk_sp<SkFontMgr>> font_manager_future =
+      font_manager_promise->get_future();
+  shell->GetDartVM()->GetConcurrentWorkerTaskRunner()->PostTask(
+      [font_manager_promise]() {
+        TRACE_EVENT0("flutter", "ShellSetupFontManager");
+        font_manager_promise->set_value(txt::GetDefaultFontManager());
+      });
+
   // Create the rasterizer on the raster thread.
   std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
   auto rasterizer_future = rasterizer_promise.get_future();
@@ -68,59 +124,159 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        auto& raster_cache = rasterizer->compositor_context()->raster_cache();
+        raster_cache.SetMaxBytes(shell->GetSettings().raster_cache_max_bytes);
+        raster_cache.SetMaxUnusedFrames(
+            shell->GetSettings().raster_cache_max_unused_frames);
+        raster_cache.SetDeferPopulation(
+            shell->GetSettings().deferred_raster_cache_population);
+        raster_cache.SetAtlasMaxEntrySize(
+            shell->GetSettings().raster_cache_atlas_max_entry_size);
+        raster_cache.SetScaleTolerance(
+            shell->GetSettings().raster_cache_scale_tolerance);
+        raster_cache.SetUseCostModel(
+            shell->GetSettings().raster_cache_cost_model);
+        raster_cache.SetCacheShadows(shell->GetSettings().raster_cache_shadows);
+        auto& backdrop_filter_cache =
+            rasterizer->compositor_context()->backdrop_filter_cache();
+        backdrop_filter_cache.SetMaxDownsample(
+            shell->GetSettings().backdrop_filter_max_downsample);
+        backdrop_filter_cache.SetReuseEnabled(
+            shell->GetSettings().reuse_filtered_backdrops);
+        rasterizer->SetRetainRasterCacheOnTeardown(
+            shell->GetSettings().retain_raster_cache_on_teardown);
+        rasterizer->SetMaxMergedLeaseTerm(
+            shell->GetSettings().raster_thread_merger_max_lease_term);
+        rasterizer->SetSnapshotSurfacePoolSize(
+            shell->GetSettings().snapshot_surface_pool_size);
+        if (shell->GetSettings().adaptive_resource_cache) {
+          rasterizer->EnableAdaptiveResourceCache(
+              shell->GetSettings().device_memory_mb << 20);
+        }
+        if (shell->GetSettings().parallel_preroll) {
+          rasterizer->compositor_context()->SetConcurrentTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (shell->GetSettings().parallel_paint) {
+          rasterizer->compositor_context()->SetConcurrentPaintTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        rasterizer->compositor_context()->SetLayerCostProfilingEnabled(
+            shell->GetSettings().profile_layer_costs);
+        if (shell->GetSettings().performance_overlay_mode == "lightweight") {
+          rasterizer->compositor_context()->SetPerformanceOverlayMode(
+              PerformanceOverlayMode::kLightweight);
+        } else if (shell->GetSettings().performance_overlay_mode == "export") {
+          rasterizer->compositor_context()->SetPerformanceOverlayMode(
+              PerformanceOverlayMode::kExportOnly);
+        }
+        if (shell->GetSettings().record_shader_warm_up) {
+          rasterizer->SetShaderWarmUpRecorder(
+              std::make_unique<ShaderWarmUpRecorder>());
+        }
+        if (!shell->GetSettings().jank_capture_path.empty()) {
+          const Settings& settings = shell->GetSettings();
+          rasterizer->SetJankWatchdog(
+              std::make_unique<JankWatchdog>(
+                  settings.jank_capture_path,
+                  fml::TimeDelta::FromMilliseconds(
+                      settings.jank_capture_budget_ms),
+                  settings.jank_capture_slow_frame_count,
+                  fml::TimeDelta::FromSeconds(
+                      settings.jank_capture_interval_s)),
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
 
-  // Create the platform view on the platform thread (this thread).
-  auto platform_view = on_create_platform_view(*shell.get());
-  if (!platform_view || !platform_view->GetWeakPtr()) {
-    return nullptr;
-  }
+  std::unique_ptr<PlatformView> platform_view;
+  std::unique_ptr<VsyncWaiter> vsync_waiter;
+  ImageDecoderBackends image_decoder_backends;
+  {
+    TRACE_EVENT0("flutter", "ShellSetupPlatformView");
+    // Create the platform view on the platform thread (this thread).
+    platform_view = on_create_platform_view(*shell.get());
+    if (!platform_view || !platform_view->GetWeakPtr()) {
+      return nullptr;
+    }
 
-  // Ask the platform view for the vsync waiter. This will be used by the engine
-  // to create the animator.
-  auto vsync_waiter = platform_view->CreateVSyncWaiter();
-  if (!vsync_waiter) {
-    return nullptr;
+    // Ask the platform view for the vsync waiter. This will be used by the
+    // engine to create the animator.
+    vsync_waiter = platform_view->CreateVSyncWaiter();
+    if (!vsync_waiter) {
+      return nullptr;
+    }
+
+    if (shell->GetSettings().enable_platform_image_decoders) {
+      image_decoder_backends = platform_view->CreateImageDecoderBackends();
+    }
   }
 
   // Create the IO manager on the IO thread. The IO manager must be initialized
   // first because it has state that the other subsystems depend on. It must
   // first be booted and the necessary references obtained to initialize the
-  // other subsystems.
+  // other subsystems. Its resource context can only be created once the
+  // platform view exists, so the IO manager starts out without one and gets it
+  // later. This lets the engine and its root isolate be created while the
+  // resource context is being set up.
   std::promise<std::unique_ptr<ShellIOManager>> io_manager_promise;
   auto io_manager_future = io_manager_promise.get_future();
   std::promise<fml::WeakPtr<ShellIOManager>> weak_io_manager_promise;
-  auto weak_io_manager_future = weak_io_manager_promise.get_future();
+  auto weak_io_manager_future = weak_io_manager_promise.get_future().share();
   std::promise<fml::RefPtr<SkiaUnrefQueue>> unref_queue_promise;
   auto unref_queue_future = unref_queue_promise.get_future();
   auto io_task_runner = shell->GetTaskRunners().GetIOTaskRunner();
-
-  // TODO(gw280): The WeakPtr here asserts that we are derefing it on the
-  // same thread as it was created on. We are currently on the IO thread
-  // inside this lambda but we need to deref the PlatformView, which was
-  // constructed on the platform thread.
-  //
-  // https://github.com/flutter/flutter/issues/42948
+  const auto drain_budget = fml::TimeDelta::FromMicroseconds(
+      shell->GetSettings().unref_queue_drain_budget_us);
   fml::TaskRunner::RunNowOrPostTask(
       io_task_runner,
       [&io_manager_promise,                                               //
        &weak_io_manager_promise,                                          //
        &unref_queue_promise,                                              //
-       platform_view = platform_view->GetWeakPtr(),                       //
        io_task_runner,                                                    //
+       drain_budget,                                                      //
        is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupIOSubsystem");
         auto io_manager = std::make_unique<ShellIOManager>(
-            platform_view.getUnsafe()->CreateResourceContext(),
-            is_backgrounded_sync_switch, io_task_runner);
+            nullptr, is_backgrounded_sync_switch, io_task_runner);
+        io_manager->GetSkiaUnrefQueue()->SetDrainBudget(drain_budget);
         weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
         unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
         io_manager_promise.set_value(std::move(io_manager));
       });
 
+  // Hand the resource context to the IO manager. This task is posted before
+  // the shell is set up, so no texture upload can observe the IO manager
+  // without a resource context.
+  //
+  // TODO(gw280): The WeakPtr here asserts that we are derefing it on the
+  // same thread as it was created on. We are currently on the IO thread
+  // inside this lambda but we need to deref the PlatformView, which was
+  // constructed on the platform thread.
+  //
+  // https://github.com/flutter/flutter/issues/42948
+  fml::AutoResetWaitableEvent resource_context_latch;
+  const size_t upload_worker_count =
+      shell->GetSettings().io_upload_worker_count;
+  fml::TaskRunner::RunNowOrPostTask(
+      io_task_runner,
+      [&resource_context_latch,                      //
+       &weak_io_manager_future,                      //
+       platform_view = platform_view->GetWeakPtr(),  //
+       upload_worker_count                           //
+  ]() {
+        TRACE_EVENT0("flutter", "ShellSetupResourceContext");
+        if (auto io_manager = weak_io_manager_future.get()) {
+          io_manager->NotifyResourceContextAvailable(
+              platform_view.getUnsafe()->CreateResourceContext());
+          StartIOUploadWorkers(io_manager.get(), platform_view.getUnsafe(),
+                               upload_worker_count);
+        }
+        resource_context_latch.Signal();
+      });
+
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
   auto dispatcher_maker = platform_view->GetDispatcherMaker();
@@ -136,6 +292,7 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                          &window_data,                                    //
                          isolate_snapshot = std::move(isolate_snapshot),  //
                          vsync_waiter = std::move(vsync_waiter),          //
+                         &image_decoder_backends,                         //
                          &weak_io_manager_future,                         //
                          &snapshot_delegate_future,                       //
                          &unref_queue_future                              //
@@ -145,24 +302,60 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
-
-        engine_promise.set_value(std::make_unique<Engine>(
-            *shell,                         //
-            dispatcher_maker,               //
-            *shell->GetDartVM(),            //
-            std::move(isolate_snapshot),    //
-            task_runners,                   //
-            window_data,                    //
-            shell->GetSettings(),           //
-            std::move(animator),            //
-            weak_io_manager_future.get(),   //
-            unref_queue_future.get(),       //
-            snapshot_delegate_future.get()  //
-            ));
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings().layer_tree_pipeline_depth,
+            shell->GetSettings().low_latency_pipeline);
+        animator->SetFrameTimePredictor(shell->frame_time_predictor_);
+        animator->SetSkipUnchangedFrames(
+            shell->GetSettings().skip_unchanged_frames);
+        animator->SetAdaptiveFrameRate(
+            shell->GetSettings().adaptive_frame_rate);
+
+        auto engine = std::make_unique<Engine>(
+            *shell,                            //
+            dispatcher_maker,                  //
+            *shell->GetDartVM(),               //
+            std::move(isolate_snapshot),       //
+            task_runners,                      //
+            window_data,                       //
+            shell->GetSettings(),              //
+            std::move(animator),               //
+            weak_io_manager_future.get(),      //
+            unref_queue_future.get(),          //
+            snapshot_delegate_future.get(),    //
+            std::move(image_decoder_backends)  //
+        );
+        if (shell->idle_scheduler_) {
+          engine->SetIdleScheduler(shell->idle_scheduler_);
+        }
+        engine_promise.set_value(std::move(engine));
       }));
 
+  // The platform view must outlive the creation of the resource context.
+  resource_context_latch.Wait();
+
+  // Replay the draw ops recorded by a training run on the resource context,
+  // so that the driver compiles their shaders while the engine starts up.
+  if (shell->GetSettings().shader_warm_up) {
+    io_task_runner->PostTask([io_manager = weak_io_manager_future.get()]() {
+      TRACE_EVENT0("flutter", "ShellShaderWarmUp");
+      if (!io_manager || !io_manager->GetResourceContext()) {
+        return;
+      }
+      sk_sp<SkData> ops =
+          PersistentCache::GetCacheForProcess()->LoadShaderWarmUp();
+      if (!ops) {
+        FML_LOG(INFO) << "No shader warm-up ops found.";
+        return;
+      }
+      io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+          fml::SyncSwitch::Handlers().SetIfFalse([&] {
+            ShaderWarmUp::Replay(io_manager->GetResourceContext().get(), *ops);
+          }));
+    });
+  }
+
   if (!shell->Setup(std::move(platform_view),  //
                     engine_future.get(),       //
                     rasterizer_future.get(),   //
@@ -171,6 +364,17 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     return nullptr;
   }
 
+  // Install the default font manager before any task posted by the embedder
+  // runs on the UI thread. This only waits if the font manager is not ready
+  // by the time the UI thread gets to it.
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners.GetUITaskRunner(),
+      [engine = shell->weak_engine_, font_manager_future]() {
+        if (engine) {
+          engine->SetupDefaultFontManager(font_manager_future.get());
+        }
+      });
+
   return shell;
 }
 
@@ -218,6 +422,20 @@ static void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetAllowlist(prefixes);
     }
 
+    if (!settings.trace_categories.empty()) {
+      std::vector<std::string> categories;
+      Tokenize(settings.trace_categories, &categories, ',');
+      fml::tracing::TraceCategories::SetEnabled(categories);
+    }
+
+    if (settings.trace_ring_buffer_size > 0) {
+      fml::tracing::TraceRingBuffer::Enable(settings.trace_ring_buffer_size);
+    }
+
+    if (settings.profile_sync) {
+      fml::SyncProfiler::Enable();
+    }
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -257,6 +475,10 @@ std::unique_ptr<Shell> Shell::Create(
     Shell::CreateCallback<Rasterizer> on_create_rasterizer) {
   PerformInitializationTasks(settings);
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  PersistentCache::SetPackEntries(settings.pack_persistent_cache);
+  PersistentCache::SetMaxPackedBytes(settings.persistent_cache_max_bytes);
+  PersistentCache::SetPrecompilationBudget(fml::TimeDelta::FromMicroseconds(
+      settings.sksl_precompilation_budget_us));
 
   TRACE_EVENT0("flutter", "Shell::Create");
 
@@ -285,6 +507,10 @@ std::unique_ptr<Shell> Shell::Create(
     DartVMRef vm) {
   PerformInitializationTasks(settings);
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  PersistentCache::SetPackEntries(settings.pack_persistent_cache);
+  PersistentCache::SetMaxPackedBytes(settings.persistent_cache_max_bytes);
+  PersistentCache::SetPrecompilationBudget(fml::TimeDelta::FromMicroseconds(
+      settings.sksl_precompilation_budget_us));
 
   TRACE_EVENT0("flutter", "Shell::CreateWithSnapshots");
 
@@ -326,12 +552,34 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
       settings_(std::move(settings)),
       vm_(std::move(vm)),
       is_gpu_disabled_sync_switch_(new fml::SyncSwitch()),
+      platform_message_buffers_(std::make_shared<PlatformMessageBuffers>()),
+      pending_viewport_metrics_(std::make_shared<PendingViewportMetrics>()),
       weak_factory_(this),
       weak_factory_gpu_(nullptr) {
   FML_CHECK(vm_) << "Must have access to VM to create a shell.";
+  startup_profiler_.Record(StartupProfiler::kEngineMainEnter,
+                           settings_.engine_start_timestamp.count());
+  startup_profiler_.Record(StartupProfiler::kVMCreated,
+                           vm_->GetCreationTimestamp());
+  if (settings_.predictive_frame_scheduling) {
+    frame_time_predictor_ = std::make_shared<FrameTimePredictor>();
+  }
+  if (settings_.frame_aware_idle_notifications) {
+    idle_scheduler_ = std::make_shared<IdleScheduler>();
+  }
   FML_DCHECK(task_runners_.IsValid());
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (settings_.timer_tolerance_ms > 0) {
+    const auto tolerance =
+        fml::TimeDelta::FromMilliseconds(settings_.timer_tolerance_ms);
+    auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+    task_queues->SetTimerTolerance(
+        task_runners_.GetUITaskRunner()->GetTaskQueueId(), tolerance);
+    task_queues->SetTimerTolerance(
+        task_runners_.GetIOTaskRunner()->GetTaskQueueId(), tolerance);
+  }
+
   // Generate a WeakPtrFactory for use with the raster thread. This does not
   // need to wait on a latch because it can only ever be used from the raster
   // thread from this class, so we have ordering guarantees.
@@ -344,11 +592,11 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
   // Install service protocol handlers.
 
   service_protocol_handlers_[ServiceProtocol::kScreenshotExtensionName] = {
-      task_runners_.GetRasterTaskRunner(),
+      task_runners_.GetIOTaskRunner(),
       std::bind(&Shell::OnServiceProtocolScreenshot, this,
                 std::placeholders::_1, std::placeholders::_2)};
   service_protocol_handlers_[ServiceProtocol::kScreenshotSkpExtensionName] = {
-      task_runners_.GetRasterTaskRunner(),
+      task_runners_.GetIOTaskRunner(),
       std::bind(&Shell::OnServiceProtocolScreenshotSKP, this,
                 std::placeholders::_1, std::placeholders::_2)};
   service_protocol_handlers_[ServiceProtocol::kRunInViewExtensionName] = {
@@ -370,16 +618,54 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
           task_runners_.GetUITaskRunner(),
           std::bind(&Shell::OnServiceProtocolGetDisplayRefreshRate, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingHistogramsExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingHistograms, this,
+                    std::placeholders::_1, std::placeholders::_2)};
   service_protocol_handlers_[ServiceProtocol::kGetSkSLsExtensionName] = {
       task_runners_.GetIOTaskRunner(),
       std::bind(&Shell::OnServiceProtocolGetSkSLs, this, std::placeholders::_1,
                 std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetSkSLPrecompilationProgressExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetSkSLPrecompilationProgress,
+                    this, std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetTraceRingBuffersExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetTraceRingBuffers, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetMemoryUsageExtensionName] = {
+      task_runners_.GetIOTaskRunner(),
+      std::bind(&Shell::OnServiceProtocolGetMemoryUsage, this,
+                std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetIsolateStartupTimingExtensionName] = {
+          task_runners_.GetUITaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetIsolateStartupTiming, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetStartupTimingExtensionName] =
+      {task_runners_.GetIOTaskRunner(),
+       std::bind(&Shell::OnServiceProtocolGetStartupTiming, this,
+                 std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetLayerCostsExtensionName] = {
+      task_runners_.GetRasterTaskRunner(),
+      std::bind(&Shell::OnServiceProtocolGetLayerCosts, this,
+                std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetSyncProfileExtensionName] = {
+      task_runners_.GetIOTaskRunner(),
+      std::bind(&Shell::OnServiceProtocolGetSyncProfile, this,
+                std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
   PersistentCache::GetCacheForProcess()->RemoveWorkerTaskRunner(
       task_runners_.GetIOTaskRunner());
 
+  platform_message_buffers_->Shutdown();
+
   vm_->GetServiceProtocol()->RemoveHandler(this);
 
   fml::AutoResetWaitableEvent ui_latch, gpu_latch, platform_latch, io_latch;
@@ -395,8 +681,11 @@ Shell::~Shell() {
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetRasterTaskRunner(),
       fml::MakeCopyable([rasterizer = std::move(rasterizer_),
+                         texture_registry = std::move(texture_registry_),
                          weak_factory_gpu = std::move(weak_factory_gpu_),
                          &gpu_latch]() mutable {
+        // The textures are collected on the raster thread.
+        texture_registry.reset();
         rasterizer.reset();
         weak_factory_gpu.reset();
         gpu_latch.Signal();
@@ -412,6 +701,9 @@ Shell::~Shell() {
         if (platform_view) {
           platform_view->ReleaseResourceContext();
         }
+        // The delayed write of the queued shaders is dropped with the IO task
+        // runner once the last shell is gone.
+        PersistentCache::GetCacheForProcess()->FlushPendingStores();
         io_latch.Signal();
       }));
 
@@ -431,25 +723,61 @@ Shell::~Shell() {
 }
 
 void Shell::NotifyLowMemoryWarning() const {
+  NotifyMemoryPressure(MemoryPressureLevel::kCritical);
+}
+
+void Shell::NotifyMemoryPressure(
+    MemoryPressureLevel level,
+    std::function<void(MemoryPressureReport)> callback) const {
   auto trace_id = fml::tracing::TraceNonce();
-  TRACE_EVENT_ASYNC_BEGIN0("flutter", "Shell::NotifyLowMemoryWarning",
-                           trace_id);
-  // This does not require a current isolate but does require a running VM.
-  // Since a valid shell will not be returned to the embedder without a valid
-  // DartVMRef, we can be certain that this is a safe spot to assume a VM is
-  // running.
-  ::Dart_NotifyLowMemory();
+  TRACE_EVENT_ASYNC_BEGIN1("flutter", "Shell::NotifyMemoryPressure", trace_id,
+                           "level",
+                           std::to_string(static_cast<int>(level)).c_str());
+
+  if (level != MemoryPressureLevel::kModerate) {
+    // This does not require a current isolate but does require a running VM.
+    // Since a valid shell will not be returned to the embedder without a
+    // valid DartVMRef, we can be certain that this is a safe spot to assume a
+    // VM is running.
+    ::Dart_NotifyLowMemory();
+
+    // The IO Manager uses resource cache limits of 0, so it is not necessary
+    // to purge them. Images released by the UI thread are only unreferenced
+    // once the unref queue drains though.
+    task_runners_.GetIOTaskRunner()->PostTask(
+        [io_manager = io_manager_->GetWeakPtr()]() {
+          if (io_manager) {
+            io_manager->GetSkiaUnrefQueue()->Drain();
+          }
+        });
+  }
+
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = weak_engine_, level]() {
+        if (engine) {
+          engine->NotifyMemoryPressure(level);
+        }
+      });
 
   task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
+      [rasterizer = rasterizer_->GetWeakPtr(), level, trace_id,
+       platform_task_runner = task_runners_.GetPlatformTaskRunner(),
+       callback = std::move(callback)]() {
+        MemoryPressureReport report;
+        report.level = level;
         if (rasterizer) {
-          rasterizer->NotifyLowMemoryWarning();
+          report = rasterizer->NotifyMemoryPressure(level);
         }
-        TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
+        FML_TRACE_COUNTER("flutter", "MemoryPressureBytesFreed", trace_id,
+                          "raster_cache", report.raster_cache_bytes_freed,
+                          "gpu_resources", report.gpu_resource_bytes_freed);
+        TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyMemoryPressure",
                                trace_id);
+        if (callback) {
+          platform_task_runner->PostTask(
+              [callback = std::move(callback), report]() { callback(report); });
+        }
       });
-  // The IO Manager uses resource cache limits of 0, so it is not necessary
-  // to purge them.
 }
 
 void Shell::RunEngine(RunConfiguration run_configuration) {
@@ -470,11 +798,17 @@ void Shell::RunEngine(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  startup_profiler_.Record(StartupProfiler::kRunEngine);
+  PrepareAssetAccessManifest(run_configuration.GetAssetManager());
+
+  // The shell waits for the engine to be collected on the UI thread before it
+  // goes away, so the profiler outlives the engine.
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
       fml::MakeCopyable(
           [run_configuration = std::move(run_configuration),
-           weak_engine = weak_engine_, result]() mutable {
+           weak_engine = weak_engine_, profiler = &startup_profiler_,
+           result]() mutable {
             if (!weak_engine) {
               FML_LOG(ERROR)
                   << "Could not launch engine with configuration - no engine.";
@@ -484,11 +818,37 @@ void Shell::RunEngine(
             auto run_result = weak_engine->Run(std::move(run_configuration));
             if (run_result == flutter::Engine::RunStatus::Failure) {
               FML_LOG(ERROR) << "Could not launch engine with configuration.";
+            } else if (run_result == flutter::Engine::RunStatus::Success) {
+              profiler->Record(StartupProfiler::kRootIsolateRunning);
             }
             result(run_result);
           }));
 }
 
+void Shell::PrepareAssetAccessManifest(
+    const std::shared_ptr<AssetManager>& asset_manager) {
+  const std::string& path = settings_.asset_access_manifest_path;
+  if (path.empty() || !asset_manager) {
+    return;
+  }
+
+  if (settings_.record_asset_access_manifest) {
+    asset_manager->StartRecordingAccesses();
+    recording_asset_manager_ = asset_manager;
+    return;
+  }
+
+  // Even reading the manifest is kept off the platform thread.
+  auto worker_task_runner = vm_->GetConcurrentWorkerTaskRunner();
+  worker_task_runner->PostTask(
+      [path, asset_manager, worker_task_runner]() {
+        TRACE_EVENT0("flutter", "Shell::PrefetchAssets");
+        AssetAccessManifest::Prefetch(asset_manager,
+                                      AssetAccessManifest::Read(path),
+                                      worker_task_runner);
+      });
+}
+
 std::optional<DartErrorCode> Shell::GetUIIsolateLastError() const {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
@@ -520,6 +880,24 @@ bool Shell::EngineHasLivePorts() const {
   return weak_engine_->UIIsolateHasLivePorts();
 }
 
+void Shell::ConfigurePlatformMessageChannel(
+    const std::string& channel,
+    const PlatformMessageBuffers::ChannelConfig& config) {
+  platform_message_buffers_->ConfigureChannel(channel, config);
+}
+
+void Shell::SetPlatformMessageHandler(const std::string& channel,
+                                      fml::RefPtr<fml::TaskRunner> task_runner,
+                                      PlatformMessageHandler handler) {
+  std::scoped_lock lock(platform_message_handlers_mutex_);
+  if (!handler || !task_runner) {
+    platform_message_handlers_.erase(channel);
+    return;
+  }
+  platform_message_handlers_[channel] = {std::move(task_runner),
+                                         std::move(handler)};
+}
+
 bool Shell::IsSetup() const {
   return is_setup_;
 }
@@ -546,16 +924,10 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_engine_ = engine_->GetWeakPtr();
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
-
-  // Setup the time-consuming default font manager right after engine created.
-  fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
-                                    [engine = weak_engine_] {
-                                      if (engine) {
-                                        engine->SetupDefaultFontManager();
-                                      }
-                                    });
+  texture_registry_ = rasterizer_->GetTextureRegistry();
 
   is_setup_ = true;
+  startup_profiler_.Record(StartupProfiler::kShellCreated);
 
   vm_->GetServiceProtocol()->AddHandler(this, GetServiceProtocolDescription());
 
@@ -580,6 +952,10 @@ const Settings& Shell::GetSettings() const {
   return settings_;
 }
 
+const StartupProfiler& Shell::GetStartupProfiler() const {
+  return startup_profiler_;
+}
+
 const TaskRunners& Shell::GetTaskRunners() const {
   return task_runners_;
 }
@@ -671,10 +1047,13 @@ void Shell::OnPlatformViewCreated(std::unique_ptr<Surface> surface) {
   FML_DCHECK(platform_view);
 
   auto io_task = [io_manager = io_manager_->GetWeakPtr(), platform_view,
-                  ui_task_runner = task_runners_.GetUITaskRunner(), ui_task] {
+                  ui_task_runner = task_runners_.GetUITaskRunner(), ui_task,
+                  upload_worker_count = settings_.io_upload_worker_count] {
     if (io_manager && !io_manager->GetResourceContext()) {
       io_manager->NotifyResourceContextAvailable(
           platform_view->CreateResourceContext());
+      StartIOUploadWorkers(io_manager.get(), platform_view,
+                           upload_worker_count);
     }
     // Step 1: Next, post a task on the UI thread to tell the engine that it has
     // an output surface.
@@ -709,11 +1088,16 @@ void Shell::OnPlatformViewDestroyed() {
     // Execute any pending Skia object deletions while GPU access is still
     // allowed.
     io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
-        fml::SyncSwitch::Handlers().SetIfFalse(
-            [&] { io_manager->GetSkiaUnrefQueue()->Drain(); }));
+        fml::SyncSwitch::Handlers().SetIfFalse([&] {
+          io_manager->GetSkiaUnrefQueue()->Drain();
+          io_manager->DrainUploadWorkerUnrefQueues();
+        }));
     // Step 3: All done. Signal the latch that the platform thread is waiting
     // on.
     latch.Signal();
+    // The app may be killed in the background, so the shaders that are still
+    // queued are written, without holding the platform thread back.
+    PersistentCache::GetCacheForProcess()->FlushPendingStores();
   };
 
   auto raster_task = [rasterizer = rasterizer_->GetWeakPtr(),
@@ -769,25 +1153,56 @@ void Shell::OnPlatformViewDestroyed() {
   }
 }
 
+void Shell::UpdateRasterizerViewportMetrics(const ViewportMetrics& metrics) {
+  {
+    std::scoped_lock lock(pending_viewport_metrics_->mutex);
+    pending_viewport_metrics_->for_rasterizer = metrics;
+    if (pending_viewport_metrics_->rasterizer_task_posted) {
+      return;
+    }
+    pending_viewport_metrics_->rasterizer_task_posted = true;
+  }
+  task_runners_.GetRasterTaskRunner()->PostTask(
+      [rasterizer = rasterizer_->GetWeakPtr(),
+       pending = pending_viewport_metrics_] {
+        std::optional<ViewportMetrics> metrics;
+        {
+          std::scoped_lock lock(pending->mutex);
+          metrics = std::move(pending->for_rasterizer);
+          pending->for_rasterizer.reset();
+          pending->rasterizer_task_posted = false;
+        }
+        if (!rasterizer || !metrics) {
+          return;
+        }
+        // This is the formula Android uses.
+        // https://android.googlesource.com/platform/frameworks/base/+/master/libs/hwui/renderthread/CacheManager.cpp#41
+        size_t max_bytes =
+            metrics->physical_width * metrics->physical_height * 12 * 4;
+        rasterizer->SetResourceCacheMaxBytes(max_bytes, false);
+        // Keep the surface following the view until the framework draws a
+        // frame of its new size.
+        rasterizer->DrawLastLayerTreeAtSize(SkISize::Make(
+            metrics->physical_width, metrics->physical_height));
+      });
+}
+
 // |PlatformView::Delegate|
 void Shell::OnPlatformViewSetViewportMetrics(const ViewportMetrics& metrics) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
-  // This is the formula Android uses.
-  // https://android.googlesource.com/platform/frameworks/base/+/master/libs/hwui/renderthread/CacheManager.cpp#41
-  size_t max_bytes = metrics.physical_width * metrics.physical_height * 12 * 4;
-  task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), max_bytes] {
-        if (rasterizer) {
-          rasterizer->SetResourceCacheMaxBytes(max_bytes, false);
-        }
-      });
+  UpdateRasterizerViewportMetrics(metrics);
 
+  if (!pending_viewport_metrics_->SetForEngine(metrics)) {
+    TRACE_EVENT_INSTANT0("flutter", "ViewportMetricsCoalesced");
+    return;
+  }
   task_runners_.GetUITaskRunner()->PostTask(
-      [engine = engine_->GetWeakPtr(), metrics]() {
-        if (engine) {
-          engine->SetViewportMetrics(metrics);
+      [engine = engine_->GetWeakPtr(), pending = pending_viewport_metrics_]() {
+        std::optional<ViewportMetrics> metrics = pending->TakeForEngine();
+        if (engine && metrics) {
+          engine->SetViewportMetrics(*metrics);
         }
       });
 }
@@ -798,6 +1213,22 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  const bool can_block =
+      !task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread();
+  switch (platform_message_buffers_->Push(message, can_block)) {
+    case PlatformMessageBuffers::PushResult::kNotBuffered:
+      break;
+    case PlatformMessageBuffers::PushResult::kNeedsDrain:
+      task_runners_.GetUITaskRunner()->PostTask(
+          [engine = engine_->GetWeakPtr(), buffers = platform_message_buffers_,
+           channel = message->channel()] {
+            DrainPlatformMessageBuffer(engine, buffers.get(), channel);
+          });
+      return;
+    case PlatformMessageBuffers::PushResult::kQueued:
+      return;
+  }
+
   task_runners_.GetUITaskRunner()->PostTask(
       [engine = engine_->GetWeakPtr(), message = std::move(message)] {
         if (engine) {
@@ -813,16 +1244,101 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
   TRACE_FLOW_BEGIN("flutter", "PointerEvent", next_pointer_flow_id_);
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
-  task_runners_.GetUITaskRunner()->PostTask(
+  task_runners_.GetUITaskRunner()->PostTaskWithPriority(
       fml::MakeCopyable([engine = weak_engine_, packet = std::move(packet),
                          flow_id = next_pointer_flow_id_]() mutable {
         if (engine) {
           engine->DispatchPointerDataPacket(std::move(packet), flow_id);
         }
-      }));
+      }),
+      fml::TaskPriority::kHigh);
   next_pointer_flow_id_++;
 }
 
+// |PlatformView::Delegate|
+void Shell::OnPlatformViewDispatchEventBatch(PlatformEventBatch batch) {
+  TRACE_EVENT0("flutter", "Shell::OnPlatformViewDispatchEventBatch");
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+
+  if (batch.IsEmpty()) {
+    return;
+  }
+
+  // The metrics of the batch go through the pending ones as well, so that a
+  // task delivering older metrics doesn't override them.
+  const bool has_viewport_metrics = batch.viewport_metrics.has_value();
+  if (has_viewport_metrics) {
+    UpdateRasterizerViewportMetrics(*batch.viewport_metrics);
+    pending_viewport_metrics_->SetForEngine(*batch.viewport_metrics);
+    batch.viewport_metrics.reset();
+  }
+
+  // Messages of channels with a queue still go through it, so that they stay
+  // in order with the messages already queued, but the queues they start are
+  // drained by the batch's task rather than by tasks of their own.
+  const bool can_block =
+      !task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread();
+  std::vector<fml::RefPtr<PlatformMessage>> unbuffered_messages;
+  std::vector<std::string> channels_to_drain;
+  for (auto& message : batch.platform_messages) {
+    switch (platform_message_buffers_->Push(message, can_block)) {
+      case PlatformMessageBuffers::PushResult::kNotBuffered:
+        unbuffered_messages.push_back(std::move(message));
+        break;
+      case PlatformMessageBuffers::PushResult::kNeedsDrain:
+        channels_to_drain.push_back(message->channel());
+        break;
+      case PlatformMessageBuffers::PushResult::kQueued:
+        break;
+    }
+  }
+  batch.platform_messages = std::move(unbuffered_messages);
+
+  const bool has_pointer_data = batch.pointer_data_packet &&
+                                !batch.pointer_data_packet->data().empty();
+  uint64_t flow_id = next_pointer_flow_id_;
+  if (has_pointer_data) {
+    TRACE_FLOW_BEGIN("flutter", "PointerEvent", flow_id);
+    next_pointer_flow_id_++;
+  }
+
+  // A batch of pointer events alone is input dispatch, like a pointer data
+  // packet on its own. Anything else keeps its place among the other tasks,
+  // so that messages are not delivered ahead of those sent before them.
+  const bool pointer_data_only = has_pointer_data && !has_viewport_metrics &&
+                                 batch.platform_messages.empty() &&
+                                 channels_to_drain.empty();
+
+  task_runners_.GetUITaskRunner()->PostTaskWithPriority(
+      fml::MakeCopyable([engine = weak_engine_,
+                         buffers = platform_message_buffers_,
+                         pending_metrics = pending_viewport_metrics_,
+                         batch = std::move(batch),
+                         channels_to_drain = std::move(channels_to_drain),
+                         has_pointer_data, flow_id]() mutable {
+        if (!engine) {
+          return;
+        }
+        if (std::optional<ViewportMetrics> metrics =
+                pending_metrics->TakeForEngine()) {
+          engine->SetViewportMetrics(*metrics);
+        }
+        for (auto& message : batch.platform_messages) {
+          engine->DispatchPlatformMessage(std::move(message));
+        }
+        for (const auto& channel : channels_to_drain) {
+          DrainPlatformMessageBuffer(engine, buffers.get(), channel);
+        }
+        if (has_pointer_data) {
+          engine->DispatchPointerDataPacket(
+              std::move(batch.pointer_data_packet), flow_id);
+        }
+      }),
+      pointer_data_only ? fml::TaskPriority::kHigh
+                        : fml::TaskPriority::kNormal);
+}
+
 // |PlatformView::Delegate|
 void Shell::OnPlatformViewDispatchSemanticsAction(int32_t id,
                                                   SemanticsAction action,
@@ -851,6 +1367,19 @@ void Shell::OnPlatformViewSetSemanticsEnabled(bool enabled) {
       });
 }
 
+// |PlatformView::Delegate|
+void Shell::OnPlatformViewSetSemanticsClientActive(bool active) {
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = engine_->GetWeakPtr(), active] {
+        if (engine) {
+          engine->SetSemanticsClientActive(active);
+        }
+      });
+}
+
 // |PlatformView::Delegate|
 void Shell::OnPlatformViewSetAccessibilityFeatures(int32_t flags) {
   FML_DCHECK(is_setup_);
@@ -870,14 +1399,9 @@ void Shell::OnPlatformViewRegisterTexture(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
-  task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), texture] {
-        if (rasterizer) {
-          if (auto* registry = rasterizer->GetTextureRegistry()) {
-            registry->RegisterTexture(texture);
-          }
-        }
-      });
+  // The registry takes updates from any thread, so the texture is painted from
+  // the next frame on without waiting for the raster thread.
+  texture_registry_->RegisterTexture(std::move(texture));
 }
 
 // |PlatformView::Delegate|
@@ -885,13 +1409,10 @@ void Shell::OnPlatformViewUnregisterTexture(int64_t texture_id) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  // Textures are told that they are unregistered on the raster thread.
   task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), texture_id]() {
-        if (rasterizer) {
-          if (auto* registry = rasterizer->GetTextureRegistry()) {
-            registry->UnregisterTexture(texture_id);
-          }
-        }
+      [registry = texture_registry_, texture_id]() {
+        registry->UnregisterTexture(texture_id);
       });
 }
 
@@ -902,20 +1423,8 @@ void Shell::OnPlatformViewMarkTextureFrameAvailable(int64_t texture_id) {
 
   // Tell the rasterizer that one of its textures has a new frame available.
   task_runners_.GetRasterTaskRunner()->PostTask(
-      [rasterizer = rasterizer_->GetWeakPtr(), texture_id]() {
-        auto* registry = rasterizer->GetTextureRegistry();
-
-        if (!registry) {
-          return;
-        }
-
-        auto texture = registry->GetTexture(texture_id);
-
-        if (!texture) {
-          return;
-        }
-
-        texture->MarkNewFrameAvailable();
+      [registry = texture_registry_, texture_id]() {
+        registry->MarkNewFrameAvailable(texture_id);
       });
 
   // Schedule a new frame without having to rebuild the layer tree.
@@ -950,6 +1459,9 @@ void Shell::OnAnimatorBeginFrame(fml::TimePoint frame_target_time) {
     latest_frame_target_time_.emplace(frame_target_time);
   }
   if (engine_) {
+    // Displays with variable refresh rates may have changed theirs since the
+    // last frame.
+    display_refresh_rate_ = engine_->GetDisplayRefreshRate();
     engine_->BeginFrame(frame_target_time);
   }
 }
@@ -1033,6 +1545,18 @@ void Shell::OnEngineHandlePlatformMessage(
     return;
   }
 
+  {
+    std::scoped_lock lock(platform_message_handlers_mutex_);
+    auto found = platform_message_handlers_.find(message->channel());
+    if (found != platform_message_handlers_.end()) {
+      found->second.task_runner->PostTask(
+          [handler = found->second.handler, message = std::move(message)]() {
+            handler(std::move(message));
+          });
+      return;
+    }
+  }
+
   task_runners_.GetPlatformTaskRunner()->PostTask(
       [view = platform_view_->GetWeakPtr(), message = std::move(message)]() {
         if (view) {
@@ -1045,7 +1569,8 @@ void Shell::HandleEngineSkiaMessage(fml::RefPtr<PlatformMessage> message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return;
   auto root = document.GetObject();
@@ -1140,12 +1665,49 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (startup_profiler_.Record(StartupProfiler::kFirstFrameRasterized)) {
+    auto since_main_enter = [this](StartupProfiler::Milestone milestone) {
+      return startup_profiler_.GetSinceMainEnter(milestone);
+    };
+    FML_TRACE_COUNTER(
+        "flutter", "StartupTiming", reinterpret_cast<int64_t>(this),
+        "VMCreatedMicros", since_main_enter(StartupProfiler::kVMCreated),
+        "ShellCreatedMicros", since_main_enter(StartupProfiler::kShellCreated),
+        "RunEngineMicros", since_main_enter(StartupProfiler::kRunEngine),
+        "RootIsolateRunningMicros",
+        since_main_enter(StartupProfiler::kRootIsolateRunning),
+        "FirstFrameRasterizedMicros",
+        since_main_enter(StartupProfiler::kFirstFrameRasterized));
+    // Start the service isolate if it was deferred until the first frame.
+    DartServiceIsolate::ReleaseStartup();
+  }
+
+  // The assets looked up until the first frame are the ones worth prefetching
+  // at the next launch.
+  if (recording_asset_manager_) {
+    auto asset_names = recording_asset_manager_->StopRecordingAccesses();
+    recording_asset_manager_ = nullptr;
+    vm_->GetConcurrentWorkerTaskRunner()->PostTask(
+        [path = settings_.asset_access_manifest_path,
+         asset_names = std::move(asset_names)]() {
+          AssetAccessManifest::Write(path, asset_names);
+        });
+  }
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (frame_time_predictor_) {
+    frame_time_predictor_->AddFrame(timing);
+  }
+  if (idle_scheduler_) {
+    idle_scheduler_->AddFrame(timing);
+  }
+  frame_timing_histograms_.AddFrame(timing);
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1269,9 +1831,11 @@ static void ServiceProtocolFailureError(rapidjson::Document& response,
 bool Shell::OnServiceProtocolScreenshot(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
     rapidjson::Document& response) {
-  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
-  auto screenshot = rasterizer_->ScreenshotLastLayerTree(
-      Rasterizer::ScreenshotType::CompressedImage, true);
+  // Only the readback blocks the raster thread, the screenshot is encoded on
+  // a worker thread while this IO thread waits.
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto screenshot =
+      Screenshot(Rasterizer::ScreenshotType::CompressedImage, true);
   if (screenshot.data) {
     response.SetObject();
     auto& allocator = response.GetAllocator();
@@ -1290,9 +1854,8 @@ bool Shell::OnServiceProtocolScreenshot(
 bool Shell::OnServiceProtocolScreenshotSKP(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
     rapidjson::Document& response) {
-  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
-  auto screenshot = rasterizer_->ScreenshotLastLayerTree(
-      Rasterizer::ScreenshotType::SkiaPicture, true);
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto screenshot = Screenshot(Rasterizer::ScreenshotType::SkiaPicture, true);
   if (screenshot.data) {
     response.SetObject();
     auto& allocator = response.GetAllocator();
@@ -1334,8 +1897,9 @@ bool Shell::OnServiceProtocolRunInView(
       std::make_unique<fml::FileMapping>(fml::OpenFile(
           main_script_path.c_str(), false, fml::FilePermission::kRead));
 
+  // A restart that runs the same kernel again keeps the one already loaded.
   auto isolate_configuration = IsolateConfiguration::CreateForKernel(
-      std::move(main_script_file_mapping));
+      main_script_path, std::move(main_script_file_mapping));
 
   RunConfiguration configuration(std::move(isolate_configuration));
 
@@ -1393,6 +1957,39 @@ bool Shell::OnServiceProtocolGetDisplayRefreshRate(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetFrameTimingHistograms(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "FrameTimingHistograms", allocator);
+  response.AddMember(
+      "frameCount",
+      static_cast<uint64_t>(frame_timing_histograms_.GetFrameCount()),
+      allocator);
+
+  rapidjson::Value metrics_json(rapidjson::kObjectType);
+  const auto summaries = frame_timing_histograms_.Summarize();
+  for (size_t i = 0; i < summaries.size(); i++) {
+    const FrameTimingHistograms::Summary& summary = summaries[i];
+    rapidjson::Value summary_json(rapidjson::kObjectType);
+    summary_json.AddMember("count",
+                           static_cast<uint64_t>(summary.sample_count),
+                           allocator);
+    summary_json.AddMember("p50", summary.p50, allocator);
+    summary_json.AddMember("p90", summary.p90, allocator);
+    summary_json.AddMember("p99", summary.p99, allocator);
+    summary_json.AddMember("max", summary.max, allocator);
+    metrics_json.AddMember(
+        rapidjson::StringRef(FrameTimingHistograms::GetMetricName(
+            static_cast<FrameTimingHistograms::Metric>(i))),
+        summary_json, allocator);
+  }
+  response.AddMember("metrics", metrics_json, allocator);
+  return true;
+}
+
 bool Shell::OnServiceProtocolGetSkSLs(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
     rapidjson::Document& response) {
@@ -1419,6 +2016,192 @@ bool Shell::OnServiceProtocolGetSkSLs(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetSkSLPrecompilationProgress(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  const PersistentCache::PrecompilationProgress progress =
+      PersistentCache::GetCacheForProcess()->GetPrecompilationProgress();
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "SkSLPrecompilationProgress", allocator);
+  response.AddMember("total", static_cast<uint64_t>(progress.total),
+                     allocator);
+  response.AddMember("processed", static_cast<uint64_t>(progress.processed),
+                     allocator);
+  response.AddMember("compiled", static_cast<uint64_t>(progress.compiled),
+                     allocator);
+  response.AddMember("done", progress.done(), allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetTraceRingBuffers(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  response.SetObject();
+  response.AddMember("type", "TraceRingBuffers", response.GetAllocator());
+  response.AddMember("enabled", fml::tracing::TraceRingBuffer::IsEnabled(),
+                     response.GetAllocator());
+  const std::string trace = fml::tracing::TraceRingBuffer::ExportChromeJSON();
+  response.AddMember("trace", rapidjson::Value(trace, response.GetAllocator()),
+                     response.GetAllocator());
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetMemoryUsage(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  std::vector<fml::MemoryUsage> usage = fml::GetMemoryUsage();
+  // Skia's CPU caches are process-wide, so they are read here rather than
+  // charged by each rasterizer.
+  usage.push_back({"SkiaFontCache",
+                   static_cast<int64_t>(SkGraphics::GetFontCacheUsed()), 0});
+  usage.push_back(
+      {"SkiaResourceCache",
+       static_cast<int64_t>(SkGraphics::GetResourceCacheTotalBytesUsed()), 0});
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "EngineMemoryUsage", allocator);
+  rapidjson::Value counters(rapidjson::kArrayType);
+  for (const fml::MemoryUsage& counter : usage) {
+    rapidjson::Value value(rapidjson::kObjectType);
+    value.AddMember("name", rapidjson::Value(counter.name, allocator),
+                    allocator);
+    value.AddMember("bytes", counter.bytes, allocator);
+    if (counter.peak_bytes > 0) {
+      value.AddMember("peakBytes", counter.peak_bytes, allocator);
+    }
+    counters.PushBack(value, allocator);
+  }
+  response.AddMember("counters", counters, allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetIsolateStartupTiming(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  const IsolateStartupTiming timing = engine_->GetUIIsolateStartupTiming();
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "IsolateStartupTiming", allocator);
+  response.AddMember("complete", timing.IsComplete(), allocator);
+  rapidjson::Value phases_json(rapidjson::kObjectType);
+  for (size_t i = 0; i < IsolateStartupTiming::kCount; i++) {
+    const auto phase = static_cast<IsolateStartupTiming::Phase>(i);
+    phases_json.AddMember(
+        rapidjson::StringRef(IsolateStartupTiming::GetPhaseName(phase)),
+        timing.Get(phase).ToMicroseconds(), allocator);
+  }
+  response.AddMember("phases", phases_json, allocator);
+  response.AddMember("total", timing.GetTotal().ToMicroseconds(), allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetStartupTiming(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "StartupTiming", allocator);
+  response.AddMember(
+      "engineMainEnter",
+      startup_profiler_.Get(StartupProfiler::kEngineMainEnter), allocator);
+  // Milestones that weren't reached, or whose time is unknown, are left out.
+  rapidjson::Value milestones_json(rapidjson::kObjectType);
+  for (size_t i = 0; i < StartupProfiler::kMilestoneCount; i++) {
+    const auto milestone = static_cast<StartupProfiler::Milestone>(i);
+    const int64_t since_main_enter =
+        startup_profiler_.GetSinceMainEnter(milestone);
+    if (since_main_enter < 0) {
+      continue;
+    }
+    milestones_json.AddMember(
+        rapidjson::StringRef(StartupProfiler::GetMilestoneName(milestone)),
+        since_main_enter, allocator);
+  }
+  response.AddMember("milestones", milestones_json, allocator);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetLayerCosts(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  if (!rasterizer_) {
+    ServiceProtocolFailureError(response, "The rasterizer is not available.");
+    return false;
+  }
+  const LayerCostProfiler* profiler =
+      rasterizer_->compositor_context()->layer_cost_profiler();
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "LayerCosts", allocator);
+  response.AddMember("enabled", profiler != nullptr, allocator);
+  rapidjson::Value layers_json(rapidjson::kArrayType);
+  if (profiler) {
+    for (const auto& cost : profiler->GetLastFrameCosts()) {
+      rapidjson::Value layer_json(rapidjson::kObjectType);
+      layer_json.AddMember("id", cost.layer_id, allocator);
+      layer_json.AddMember("type", rapidjson::StringRef(cost.type_name),
+                           allocator);
+      layer_json.AddMember("depth", static_cast<uint64_t>(cost.depth),
+                           allocator);
+      layer_json.AddMember("prerollMicros", cost.preroll_time.ToMicroseconds(),
+                           allocator);
+      layer_json.AddMember("paintMicros", cost.paint_time.ToMicroseconds(),
+                           allocator);
+      layer_json.AddMember("selfPrerollMicros",
+                           cost.self_preroll_time.ToMicroseconds(), allocator);
+      layer_json.AddMember("selfPaintMicros",
+                           cost.self_paint_time.ToMicroseconds(), allocator);
+      layer_json.AddMember("painted", cost.painted, allocator);
+      layer_json.AddMember("rasterCacheHits",
+                           static_cast<uint64_t>(cost.raster_cache_hits),
+                           allocator);
+      layer_json.AddMember("rasterCacheMisses",
+                           static_cast<uint64_t>(cost.raster_cache_misses),
+                           allocator);
+      layers_json.PushBack(layer_json, allocator);
+    }
+  }
+  response.AddMember("layers", layers_json, allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetSyncProfile(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "SyncProfile", allocator);
+  response.AddMember("enabled", fml::SyncProfiler::IsEnabled(), allocator);
+  rapidjson::Value histograms_json(rapidjson::kArrayType);
+  for (const auto& summary : fml::SyncProfiler::Summarize()) {
+    rapidjson::Value histogram_json(rapidjson::kObjectType);
+    histogram_json.AddMember("name", rapidjson::Value(summary.name, allocator),
+                             allocator);
+    histogram_json.AddMember("count", summary.count, allocator);
+    histogram_json.AddMember("totalMicros", summary.total_micros, allocator);
+    histogram_json.AddMember("p50Micros", summary.p50_micros, allocator);
+    histogram_json.AddMember("p90Micros", summary.p90_micros, allocator);
+    histogram_json.AddMember("p99Micros", summary.p99_micros, allocator);
+    histogram_json.AddMember("maxMicros", summary.max_micros, allocator);
+    histograms_json.PushBack(histogram_json, allocator);
+  }
+  response.AddMember("histograms", histograms_json, allocator);
+  if (params.count("reset") != 0) {
+    fml::SyncProfiler::Reset();
+  }
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1463,21 +2246,33 @@ Rasterizer::Screenshot Shell::Screenshot(
   TRACE_EVENT0("flutter", "Shell::Screenshot");
   fml::AutoResetWaitableEvent latch;
   Rasterizer::Screenshot screenshot;
+  Screenshot(screenshot_type, base64_encode, 1.0f,
+             [&latch, &screenshot](Rasterizer::Screenshot result) {
+               screenshot = std::move(result);
+               latch.Signal();
+             });
+  latch.Wait();
+  return screenshot;
+}
+
+void Shell::Screenshot(Rasterizer::ScreenshotType screenshot_type,
+                       bool base64_encode,
+                       float scale,
+                       Rasterizer::ScreenshotCallback callback) {
   fml::TaskRunner::RunNowOrPostTask(
-      task_runners_.GetRasterTaskRunner(), [&latch,                        //
-                                            rasterizer = GetRasterizer(),  //
-                                            &screenshot,                   //
-                                            screenshot_type,               //
-                                            base64_encode                  //
-  ]() {
-        if (rasterizer) {
-          screenshot = rasterizer->ScreenshotLastLayerTree(screenshot_type,
-                                                           base64_encode);
+      task_runners_.GetRasterTaskRunner(),
+      [rasterizer = GetRasterizer(),
+       encode_task_runner = vm_->GetConcurrentWorkerTaskRunner(),
+       screenshot_type, base64_encode, scale,
+       callback = std::move(callback)]() {
+        if (!rasterizer) {
+          callback({});
+          return;
         }
-        latch.Signal();
+        rasterizer->ScreenshotLastLayerTree(screenshot_type, base64_encode,
+                                            scale, encode_task_runner,
+                                            callback);
       });
-  latch.Wait();
-  return screenshot;
 }
 
 fml::Status Shell::WaitForFirstFrame(fml::TimeDelta timeout) {
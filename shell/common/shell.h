@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <mutex>
+#include <optional>
 #include <string_view>
 #include <unordered_map>
 
@@ -31,9 +32,13 @@
 #include "flutter/runtime/service_protocol.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_timing_histograms.h"
+#include "flutter/shell/common/memory_pressure.h"
+#include "flutter/shell/common/platform_message_buffers.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "flutter/shell/common/startup_profiler.h"
 
 namespace flutter {
 
@@ -236,6 +241,12 @@ class Shell final : public PlatformView::Delegate,
   ///
   const Settings& GetSettings() const;
 
+  //------------------------------------------------------------------------------
+  /// @return     When this shell reached the milestones of its startup. Can be
+  ///             read on any thread.
+  ///
+  const StartupProfiler& GetStartupProfiler() const;
+
   //------------------------------------------------------------------------------
   /// @brief      If callers wish to interact directly with any shell
   ///             subcomponents, they must (on the platform thread) obtain a
@@ -282,10 +293,76 @@ class Shell final : public PlatformView::Delegate,
 
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to notify that there is a low memory
-  ///             warning. The shell will attempt to purge caches. Current, only
-  ///             the rasterizer cache is purged.
+  ///             warning. The shell will attempt to purge caches. This is
+  ///             `MemoryPressureLevel::kCritical`.
+  ///
+  /// @see        `Shell::NotifyMemoryPressure`
+  ///
   void NotifyLowMemoryWarning() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to notify that the system is running low on
+  ///             memory. Caches are trimmed in order of how cheap they are to
+  ///             rebuild, and more of them the more severe the level: the
+  ///             raster cache, the queue of images being released on the IO
+  ///             thread, the text layout caches, the Skia resource caches and
+  ///             finally the Dart heap.
+  ///
+  /// @see        `Rasterizer::NotifyMemoryPressure`,
+  ///             `Engine::NotifyMemoryPressure`
+  ///
+  /// @param[in]  level     How much memory should be given up.
+  /// @param[in]  callback  An optional callback that is invoked on the
+  ///                       platform task runner with the bytes freed by the
+  ///                       rasterizer once it is done.
+  ///
+  void NotifyMemoryPressure(
+      MemoryPressureLevel level,
+      std::function<void(MemoryPressureReport)> callback = nullptr) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to queue the platform messages of a high
+  ///             rate channel on their way to the UI thread, so that a single
+  ///             UI task delivers all the messages that arrived since the last
+  ///             one. Can be called on any thread.
+  ///
+  /// @see        `PlatformMessageBuffers`
+  ///
+  /// @param[in]  channel  The name of the channel.
+  /// @param[in]  config   The capacity and overflow policy of the queue. A
+  ///                      capacity of zero removes it again.
+  ///
+  void ConfigurePlatformMessageChannel(
+      const std::string& channel,
+      const PlatformMessageBuffers::ChannelConfig& config);
+
+  //----------------------------------------------------------------------------
+  /// @brief      A handler for the platform messages of a channel that runs on
+  ///             a task runner of the embedder's choosing.
+  ///
+  using PlatformMessageHandler =
+      std::function<void(fml::RefPtr<PlatformMessage>)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to handle the platform messages sent on a
+  ///             channel by calling a handler on a background task runner,
+  ///             instead of handing them to the platform view on the platform
+  ///             thread. Plugins that do heavy work for each message, like a
+  ///             database, then no longer hold up input and vsync handling on
+  ///             the platform thread. The handler may respond to messages on
+  ///             any thread. Can be called on any thread.
+  ///
+  /// @param[in]  channel      The name of the channel.
+  /// @param[in]  task_runner  The task runner to call the handler on.
+  /// @param[in]  handler      The handler. It is copied into the tasks posted
+  ///                          to the task runner, so what it refers to must
+  ///                          outlive those tasks. A null handler returns
+  ///                          the channel to the platform view.
+  ///
+  void SetPlatformMessageHandler(const std::string& channel,
+                                 fml::RefPtr<fml::TaskRunner> task_runner,
+                                 PlatformMessageHandler handler);
+
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to check if all shell subcomponents are
   ///             initialized. It is the embedder's responsibility to make this
@@ -312,6 +389,25 @@ class Shell final : public PlatformView::Delegate,
   Rasterizer::Screenshot Screenshot(Rasterizer::ScreenshotType type,
                                     bool base64_encode);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Captures a screenshot of the last layer tree rendered by the
+  ///             rasterizer in this shell without waiting for it. The raster
+  ///             thread only draws the layer tree and reads back its pixels,
+  ///             the screenshot is encoded on a worker thread.
+  ///
+  /// @param[in]  type           The type of screenshot to capture.
+  /// @param[in]  base64_encode  If the screenshot data should be base64
+  ///                            encoded.
+  /// @param[in]  scale          The factor to scale image screenshots by.
+  /// @param[in]  callback       Called with the screenshot result on a worker
+  ///                            thread, or on the raster thread if capturing
+  ///                            failed.
+  ///
+  void Screenshot(Rasterizer::ScreenshotType type,
+                  bool base64_encode,
+                  float scale,
+                  Rasterizer::ScreenshotCallback callback);
+
   //----------------------------------------------------------------------------
   /// @brief   Pauses the calling thread until the first frame is presented.
   ///
@@ -377,12 +473,53 @@ class Shell final : public PlatformView::Delegate,
   std::unique_ptr<Rasterizer> rasterizer_;       // on GPU task runner
   std::unique_ptr<ShellIOManager> io_manager_;   // on IO task runner
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
+  // Shared with the UI tasks that drain them, which may outlive the shell.
+  std::shared_ptr<PlatformMessageBuffers> platform_message_buffers_;
+
+  // The latest viewport metrics set by the platform that are yet to reach the
+  // engine and the rasterizer. Shared with the tasks delivering them, which
+  // may outlive the shell. Metrics set while such a task is pending replace
+  // the ones it delivers instead of posting a task of their own, so that a
+  // burst of them, as during a live resize, costs a single update.
+  struct PendingViewportMetrics {
+    std::mutex mutex;
+    std::optional<ViewportMetrics> for_engine;
+    std::optional<ViewportMetrics> for_rasterizer;
+    bool rasterizer_task_posted = false;
+
+    // Sets the metrics for the engine. Returns whether no metrics were
+    // pending, in which case a task needs to deliver them.
+    bool SetForEngine(const ViewportMetrics& metrics) {
+      std::scoped_lock lock(mutex);
+      const bool was_empty = !for_engine.has_value();
+      for_engine = metrics;
+      return was_empty;
+    }
+
+    std::optional<ViewportMetrics> TakeForEngine() {
+      std::scoped_lock lock(mutex);
+      std::optional<ViewportMetrics> metrics = std::move(for_engine);
+      for_engine.reset();
+      return metrics;
+    }
+  };
+  std::shared_ptr<PendingViewportMetrics> pending_viewport_metrics_;
+  struct TaskRunnerBoundHandler {
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    PlatformMessageHandler handler;
+  };
+  std::mutex platform_message_handlers_mutex_;
+  std::unordered_map<std::string, TaskRunnerBoundHandler>
+      platform_message_handlers_;
 
   fml::WeakPtr<Engine> weak_engine_;  // to be shared across threads
   fml::TaskRunnerAffineWeakPtr<Rasterizer>
       weak_rasterizer_;  // to be shared across threads
   fml::WeakPtr<PlatformView>
       weak_platform_view_;  // to be shared across threads
+  // The external textures of the rasterizer, registered from the platform
+  // thread directly.
+  std::shared_ptr<TextureRegistry> texture_registry_;
 
   std::unordered_map<std::string_view,  // method
                      std::pair<fml::RefPtr<fml::TaskRunner>,
@@ -411,6 +548,20 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // Created with |Settings::predictive_frame_scheduling|. Fed on the raster
+  // thread and read by the animator on the UI thread.
+  std::shared_ptr<FrameTimePredictor> frame_time_predictor_;
+
+  // Created with |Settings::frame_aware_idle_notifications|. Fed on the raster
+  // thread and used by the runtime controller on the UI thread.
+  std::shared_ptr<IdleScheduler> idle_scheduler_;
+
+  // Fed on the raster thread and summarized for the service protocol.
+  FrameTimingHistograms frame_timing_histograms_;
+
+  // Recorded on the platform, UI and raster threads.
+  StartupProfiler startup_profiler_;
+
   // A cache of `Engine::GetDisplayRefreshRate` (only callable in the UI thread)
   // so we can access it from `Rasterizer` (in the raster thread).
   //
@@ -418,9 +569,19 @@ class Shell final : public PlatformView::Delegate,
   // and read from the raster thread.
   std::atomic<float> display_refresh_rate_ = 0.0f;
 
+  // Recording the assets looked up until the first frame, for the asset
+  // access manifest. Set on the platform thread before the engine runs and
+  // taken on the raster thread once the first frame is rasterized.
+  std::shared_ptr<AssetManager> recording_asset_manager_;
+
   // How many frames have been timed since last report.
   size_t UnreportedFramesCount() const;
 
+  // Prefetches the assets of the asset access manifest, or starts recording
+  // the ones looked up by |asset_manager| for it.
+  void PrepareAssetAccessManifest(
+      const std::shared_ptr<AssetManager>& asset_manager);
+
   Shell(DartVMRef vm, TaskRunners task_runners, Settings settings);
 
   static std::unique_ptr<Shell> CreateShellOnPlatformThread(
@@ -439,6 +600,10 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  // Resizes the resource cache of the rasterizer for a view of |metrics|, and
+  // draws the last frame again at the size of the view.
+  void UpdateRasterizerViewportMetrics(const ViewportMetrics& metrics);
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
@@ -457,6 +622,9 @@ class Shell final : public PlatformView::Delegate,
   void OnPlatformViewDispatchPointerDataPacket(
       std::unique_ptr<PointerDataPacket> packet) override;
 
+  // |PlatformView::Delegate|
+  void OnPlatformViewDispatchEventBatch(PlatformEventBatch batch) override;
+
   // |PlatformView::Delegate|
   void OnPlatformViewDispatchSemanticsAction(
       int32_t id,
@@ -466,6 +634,9 @@ class Shell final : public PlatformView::Delegate,
   // |PlatformView::Delegate|
   void OnPlatformViewSetSemanticsEnabled(bool enabled) override;
 
+  // |PlatformView::Delegate|
+  void OnPlatformViewSetSemanticsClientActive(bool active) override;
+
   // |shell:PlatformView::Delegate|
   void OnPlatformViewSetAccessibilityFeatures(int32_t flags) override;
 
@@ -577,6 +748,13 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  //
+  // Durations are in microseconds, see |FrameTimingHistograms|.
+  bool OnServiceProtocolGetFrameTimingHistograms(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   // Service protocol handler
   //
   // The returned SkSLs are base64 encoded. Decode before storing them to files.
@@ -584,6 +762,63 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  //
+  // Reports how many of the SkSLs found at startup have been precompiled,
+  // which goes on between frames when a precompilation budget is set.
+  bool OnServiceProtocolGetSkSLPrecompilationProgress(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // The trace is a string in the Chrome JSON trace format, see
+  // |fml::tracing::TraceRingBuffer|.
+  bool OnServiceProtocolGetTraceRingBuffers(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Reports the memory counters of the process, see |fml::MemoryCounter|.
+  // The counters overlap: GPU images of the raster cache and uploaded images
+  // are also in the GPU resource cache.
+  bool OnServiceProtocolGetMemoryUsage(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Durations are in microseconds, see |IsolateStartupTiming|.
+  bool OnServiceProtocolGetIsolateStartupTiming(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Timestamps are in microseconds since the engine was entered, see
+  // |StartupProfiler|.
+  bool OnServiceProtocolGetStartupTiming(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Reports the costs of the layers of the last frame in preroll order, see
+  // |LayerCostProfiler|. Times are in microseconds.
+  bool OnServiceProtocolGetLayerCosts(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Reports the lock wait, task queue latency and task duration histograms of
+  // the process, see |fml::SyncProfiler|. Times are in microseconds. Passing
+  // "reset" drops the samples once they are reported.
+  bool OnServiceProtocolGetSyncProfile(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   // For accessing the Shell via the raster thread, necessary for various
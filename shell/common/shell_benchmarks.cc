@@ -4,6 +4,7 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
@@ -12,9 +13,17 @@
 
 namespace flutter {
 
+// The time spent in each phase of a single shell startup.
+struct StartupPhases {
+  fml::TimeDelta thread_host;
+  fml::TimeDelta shell_create;
+  fml::TimeDelta ui_setup;
+};
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
-                                    bool measure_shutdown) {
+                                    bool measure_shutdown,
+                                    StartupPhases* phases = nullptr) {
   auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
                                        fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
@@ -41,6 +50,7 @@ static void StartupAndShutdownShell(benchmark::State& state,
       };
     }
 
+    const auto thread_host_start = fml::TimePoint::Now();
     thread_host = std::make_unique<ThreadHost>(
         "io.flutter.bench.", ThreadHost::Type::Platform |
                                  ThreadHost::Type::GPU | ThreadHost::Type::IO |
@@ -52,6 +62,7 @@ static void StartupAndShutdownShell(benchmark::State& state,
                              thread_host->ui_thread->GetTaskRunner(),
                              thread_host->io_thread->GetTaskRunner());
 
+    const auto shell_create_start = fml::TimePoint::Now();
     shell = Shell::Create(
         std::move(task_runners), settings,
         [](Shell& shell) {
@@ -62,6 +73,11 @@ static void StartupAndShutdownShell(benchmark::State& state,
               shell, shell.GetTaskRunners(),
               shell.GetIsGpuDisabledSyncSwitch());
         });
+
+    if (phases) {
+      phases->thread_host = shell_create_start - thread_host_start;
+      phases->shell_create = fml::TimePoint::Now() - shell_create_start;
+    }
   }
 
   FML_CHECK(shell);
@@ -75,10 +91,14 @@ static void StartupAndShutdownShell(benchmark::State& state,
     // this time should still be included.
     benchmarking::ScopedPauseTiming pause(
         state, !measure_shutdown || !measure_startup);
+    const auto ui_setup_start = fml::TimePoint::Now();
     fml::AutoResetWaitableEvent latch;
     fml::TaskRunner::RunNowOrPostTask(thread_host->ui_thread->GetTaskRunner(),
                                       [&latch]() { latch.Signal(); });
     latch.Wait();
+    if (phases) {
+      phases->ui_setup = fml::TimePoint::Now() - ui_setup_start;
+    }
   }
 
   {
@@ -122,4 +142,28 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// Breaks the startup time down into the creation of the threads, the blocking
+// part of |Shell::Create| and the tasks the shell leaves on the UI thread, such
+// as the default font manager setup. The individual subsystems are traced as
+// "ShellSetup*" events.
+static void BM_ShellInitializationPhases(benchmark::State& state) {
+  fml::TimeDelta thread_host, shell_create, ui_setup;
+  while (state.KeepRunning()) {
+    StartupPhases phases;
+    StartupAndShutdownShell(state, true, false, &phases);
+    thread_host = thread_host + phases.thread_host;
+    shell_create = shell_create + phases.shell_create;
+    ui_setup = ui_setup + phases.ui_setup;
+  }
+  const auto average = [](fml::TimeDelta total) {
+    return benchmark::Counter(total.ToMicrosecondsF(),
+                              benchmark::Counter::kAvgIterations);
+  };
+  state.counters["ThreadHostMicros"] = average(thread_host);
+  state.counters["ShellCreateMicros"] = average(shell_create);
+  state.counters["UISetupMicros"] = average(ui_setup);
+}
+
+BENCHMARK(BM_ShellInitializationPhases);
+
 }  // namespace flutter
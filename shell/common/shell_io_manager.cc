@@ -4,8 +4,12 @@
 
 #include "flutter/shell/common/shell_io_manager.h"
 
+#include <string>
+
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 
@@ -76,6 +80,7 @@ ShellIOManager::ShellIOManager(
 }
 
 ShellIOManager::~ShellIOManager() {
+  StopUploadWorkers();
   // Last chance to drain the IO queue as the platform side reference to the
   // underlying OpenGL context may be going away.
   is_gpu_disabled_sync_switch_->Execute(
@@ -98,6 +103,87 @@ void ShellIOManager::UpdateResourceContext(sk_sp<GrContext> resource_context) {
       resource_context_ ? std::make_unique<fml::WeakPtrFactory<GrContext>>(
                               resource_context_.get())
                         : nullptr;
+  unref_queue_->UpdateResourceContext(GetResourceContext());
+}
+
+void ShellIOManager::StartUploadWorkers(
+    size_t count,
+    std::function<sk_sp<GrContext>()> create_context,
+    fml::closure release_context) {
+  if (workers_started_) {
+    return;
+  }
+  workers_started_ = true;
+  TRACE_EVENT0("flutter", "ShellIOManager::StartUploadWorkers");
+  release_worker_context_ = std::move(release_context);
+  for (size_t i = 0; i < count; i++) {
+    auto worker = std::make_unique<Worker>();
+    worker->thread = std::make_unique<fml::Thread>(
+        "io.flutter.io.worker." + std::to_string(i + 1));
+    auto task_runner = worker->thread->GetTaskRunner();
+
+    fml::AutoResetWaitableEvent latch;
+    task_runner->PostTask([&latch, &create_context, worker = worker.get(),
+                           task_runner, this] {
+      worker->resource_context = create_context();
+      if (worker->resource_context) {
+        // Do not cache the uploaded textures, like on the IO thread.
+        worker->resource_context->setResourceCacheLimits(0, 0);
+        worker->resource_context_weak_factory =
+            std::make_unique<fml::WeakPtrFactory<GrContext>>(
+                worker->resource_context.get());
+        worker->weak_resource_context =
+            worker->resource_context_weak_factory->GetWeakPtr();
+        worker->unref_queue = fml::MakeRefCounted<flutter::SkiaUnrefQueue>(
+            task_runner, fml::TimeDelta::FromMilliseconds(8),
+            worker->weak_resource_context);
+      } else if (release_worker_context_) {
+        release_worker_context_();
+      }
+      latch.Signal();
+    });
+    latch.Wait();
+
+    if (!worker->resource_context) {
+      FML_LOG(ERROR) << "Could not create the resource context of an upload "
+                        "worker. Textures are uploaded on "
+                     << workers_.size() + 1 << " threads.";
+      break;
+    }
+    workers_.push_back(std::move(worker));
+  }
+}
+
+void ShellIOManager::DrainUploadWorkerUnrefQueues() {
+  for (const auto& worker : workers_) {
+    fml::AutoResetWaitableEvent latch;
+    worker->thread->GetTaskRunner()->PostTask(
+        [&latch, queue = worker->unref_queue] {
+          queue->Drain();
+          latch.Signal();
+        });
+    latch.Wait();
+  }
+}
+
+void ShellIOManager::StopUploadWorkers() {
+  for (auto& worker : workers_) {
+    fml::AutoResetWaitableEvent latch;
+    worker->thread->GetTaskRunner()->PostTask([&latch, &worker, this] {
+      is_gpu_disabled_sync_switch_->Execute(
+          fml::SyncSwitch::Handlers().SetIfFalse(
+              [&] { worker->unref_queue->Drain(); }));
+      worker->resource_context_weak_factory.reset();
+      worker->resource_context.reset();
+      if (release_worker_context_) {
+        release_worker_context_();
+      }
+      latch.Signal();
+    });
+    latch.Wait();
+    worker->thread->Join();
+  }
+  workers_.clear();
 }
 
 fml::WeakPtr<ShellIOManager> ShellIOManager::GetWeakPtr() {
@@ -126,4 +212,15 @@ std::shared_ptr<fml::SyncSwitch> ShellIOManager::GetIsGpuDisabledSyncSwitch() {
   return is_gpu_disabled_sync_switch_;
 }
 
+// |IOManager|
+std::vector<IOManager::UploadWorker> ShellIOManager::GetUploadWorkers() const {
+  std::vector<UploadWorker> upload_workers;
+  for (const auto& worker : workers_) {
+    upload_workers.push_back({worker->thread->GetTaskRunner(),
+                              worker->weak_resource_context,
+                              worker->unref_queue});
+  }
+  return upload_workers;
+}
+
 }  // namespace flutter
@@ -5,11 +5,14 @@
 #ifndef FLUTTER_SHELL_COMMON_SHELL_IO_MANAGER_H_
 #define FLUTTER_SHELL_COMMON_SHELL_IO_MANAGER_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/thread.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
@@ -41,6 +44,20 @@ class ShellIOManager final : public IOManager {
   // resource context, but may be called if the Dart VM is restarted.
   void UpdateResourceContext(sk_sp<GrContext> resource_context);
 
+  // Starts up to |count| threads that textures are uploaded on concurrently
+  // with the IO thread, see |IOManager::GetUploadWorkers|. Each calls
+  // |create_context| to create its resource context, in the share group of
+  // the one of the IO manager, and stops again if it returns null. Each calls
+  // |release_context| once its resource context is collected, when the IO
+  // manager is. Does nothing if the workers were started already.
+  void StartUploadWorkers(size_t count,
+                          std::function<sk_sp<GrContext>()> create_context,
+                          fml::closure release_context);
+
+  // Unrefs the objects queued for collection on the upload workers, and
+  // waits for them to be collected.
+  void DrainUploadWorkerUnrefQueues();
+
   fml::WeakPtr<ShellIOManager> GetWeakPtr();
 
   // |IOManager|
@@ -55,7 +72,21 @@ class ShellIOManager final : public IOManager {
   // |IOManager|
   std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() override;
 
+  // |IOManager|
+  std::vector<UploadWorker> GetUploadWorkers() const override;
+
  private:
+  // The state of an upload worker, which apart from the thread is only used on
+  // the thread.
+  struct Worker {
+    std::unique_ptr<fml::Thread> thread;
+    sk_sp<GrContext> resource_context;
+    std::unique_ptr<fml::WeakPtrFactory<GrContext>>
+        resource_context_weak_factory;
+    fml::WeakPtr<GrContext> weak_resource_context;
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue;
+  };
+
   // Resource context management.
   sk_sp<GrContext> resource_context_;
   std::unique_ptr<fml::WeakPtrFactory<GrContext>>
@@ -68,6 +99,13 @@ class ShellIOManager final : public IOManager {
 
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
 
+  std::vector<std::unique_ptr<Worker>> workers_;
+  bool workers_started_ = false;
+  fml::closure release_worker_context_;
+
+  // Collects the resource contexts of the upload workers and stops them.
+  void StopUploadWorkers();
+
   FML_DISALLOW_COPY_AND_ASSIGN(ShellIOManager);
 };
 
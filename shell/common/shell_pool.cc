@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shell_pool.h"
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ShellPool::ShellPool(size_t capacity,
+                     CreateShellCallback create_shell,
+                     fml::RefPtr<fml::TaskRunner> refill_task_runner)
+    : state_(std::make_shared<State>(capacity, std::move(create_shell))),
+      refill_task_runner_(std::move(refill_task_runner)) {
+  FML_DCHECK(state_->create_shell);
+}
+
+ShellPool::~ShellPool() {
+  std::deque<std::unique_ptr<Shell>> idle_shells;
+  {
+    std::scoped_lock lock(state_->mutex);
+    state_->shut_down = true;
+    idle_shells.swap(state_->idle_shells);
+  }
+  for (auto& shell : idle_shells) {
+    DestroyShell(std::move(shell));
+  }
+}
+
+void ShellPool::Prewarm() {
+  Fill(state_);
+}
+
+std::unique_ptr<Shell> ShellPool::Acquire() {
+  TRACE_EVENT0("flutter", "ShellPool::Acquire");
+  std::unique_ptr<Shell> shell;
+  {
+    std::scoped_lock lock(state_->mutex);
+    if (!state_->idle_shells.empty()) {
+      shell = std::move(state_->idle_shells.front());
+      state_->idle_shells.pop_front();
+    }
+  }
+
+  if (!shell) {
+    TRACE_EVENT0("flutter", "ShellPoolMiss");
+    shell = state_->create_shell();
+  }
+
+  if (refill_task_runner_) {
+    refill_task_runner_->PostTask([state = state_]() { Fill(state); });
+  }
+
+  return shell;
+}
+
+size_t ShellPool::GetIdleShellCount() const {
+  std::scoped_lock lock(state_->mutex);
+  return state_->idle_shells.size();
+}
+
+void ShellPool::Fill(const std::shared_ptr<State>& state) {
+  while (true) {
+    {
+      std::scoped_lock lock(state->mutex);
+      if (state->shut_down ||
+          state->idle_shells.size() + state->pending_shells >=
+              state->capacity) {
+        return;
+      }
+      state->pending_shells++;
+    }
+
+    std::unique_ptr<Shell> shell;
+    {
+      TRACE_EVENT0("flutter", "ShellPool::Fill");
+      shell = state->create_shell();
+    }
+
+    {
+      std::scoped_lock lock(state->mutex);
+      state->pending_shells--;
+      if (shell && !state->shut_down) {
+        state->idle_shells.push_back(std::move(shell));
+        continue;
+      }
+    }
+
+    // Either the shell could not be created, in which case filling the pool
+    // is given up until the next call, or the pool is gone.
+    if (shell) {
+      DestroyShell(std::move(shell));
+    }
+    return;
+  }
+}
+
+void ShellPool::DestroyShell(std::unique_ptr<Shell> shell) {
+  auto platform_task_runner = shell->GetTaskRunners().GetPlatformTaskRunner();
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(platform_task_runner,
+                                    [&shell, &latch]() mutable {
+                                      shell.reset();
+                                      latch.Signal();
+                                    });
+  latch.Wait();
+}
+
+}  // namespace flutter
@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+#define FLUTTER_SHELL_COMMON_SHELL_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/shell/common/shell.h"
+
+namespace flutter {
+
+/// Keeps a number of shells that are set up but not running yet, so that a
+/// view added to a process that already runs Flutter doesn't have to wait for
+/// the startup of a shell.
+///
+/// The shells of a pool share the process-wide |DartVM|. They are created
+/// with the callback given to the pool, which is called on the thread that
+/// calls |Prewarm| or |Acquire| and, if the pool has one, on the refill task
+/// runner. The callback must stay valid until all of those calls returned.
+/// Just like a shell, a pooled shell is destroyed on its platform thread, so
+/// the pool must not be destroyed on the platform thread of a shell that is
+/// still being created.
+class ShellPool {
+ public:
+  using CreateShellCallback = std::function<std::unique_ptr<Shell>()>;
+
+  /// Creates an empty pool that keeps up to |capacity| idle shells. If a
+  /// |refill_task_runner| is given, the pool is refilled on it whenever a
+  /// shell is acquired.
+  ShellPool(size_t capacity,
+            CreateShellCallback create_shell,
+            fml::RefPtr<fml::TaskRunner> refill_task_runner = nullptr);
+
+  ~ShellPool();
+
+  /// Creates shells until the pool holds |capacity| idle shells. Blocks until
+  /// they are set up.
+  void Prewarm();
+
+  /// Hands out an idle shell, or creates one if the pool is empty. The shell
+  /// is owned by the caller and has to be run like any other shell.
+  std::unique_ptr<Shell> Acquire();
+
+  size_t GetIdleShellCount() const;
+
+ private:
+  struct State {
+    State(size_t capacity, CreateShellCallback create_shell)
+        : capacity(capacity), create_shell(std::move(create_shell)) {}
+
+    const size_t capacity;
+    const CreateShellCallback create_shell;
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Shell>> idle_shells;
+    // The number of shells being created to fill the pool.
+    size_t pending_shells = 0;
+    bool shut_down = false;
+  };
+
+  // Shared with refill tasks, which may still run after the pool is gone.
+  const std::shared_ptr<State> state_;
+  const fml::RefPtr<fml::TaskRunner> refill_task_runner_;
+
+  static void Fill(const std::shared_ptr<State>& state);
+
+  static void DestroyShell(std::unique_ptr<Shell> shell);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShellPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHELL_POOL_H_
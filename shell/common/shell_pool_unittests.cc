@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/shell/common/shell_pool.h"
+
+#include <atomic>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/shell/common/shell_test.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST_F(ShellTest, ShellPoolHandsOutPrewarmedShells) {
+  auto settings = CreateSettingsForFixture();
+  std::atomic<size_t> created_shells = {0};
+  {
+    ShellPool pool(2, [&]() {
+      created_shells++;
+      return CreateShell(settings);
+    });
+    ASSERT_EQ(pool.GetIdleShellCount(), 0u);
+
+    pool.Prewarm();
+    ASSERT_EQ(created_shells, 2u);
+    ASSERT_EQ(pool.GetIdleShellCount(), 2u);
+
+    auto shell = pool.Acquire();
+    ASSERT_TRUE(shell);
+    ASSERT_TRUE(shell->IsSetup());
+    ASSERT_EQ(created_shells, 2u);
+    ASSERT_EQ(pool.GetIdleShellCount(), 1u);
+
+    pool.Prewarm();
+    ASSERT_EQ(created_shells, 3u);
+    ASSERT_EQ(pool.GetIdleShellCount(), 2u);
+
+    DestroyShell(std::move(shell));
+  }
+  ASSERT_EQ(created_shells, 3u);
+}
+
+TEST_F(ShellTest, ShellPoolRefillsOnTheRefillTaskRunner) {
+  auto settings = CreateSettingsForFixture();
+  fml::Thread refill_thread("refill");
+  auto refill_task_runner = refill_thread.GetTaskRunner();
+  {
+    ShellPool pool(
+        1, [&]() { return CreateShell(settings); }, refill_task_runner);
+
+    // An empty pool creates the shell in place and refills afterwards.
+    auto shell = pool.Acquire();
+    ASSERT_TRUE(shell);
+
+    fml::AutoResetWaitableEvent latch;
+    refill_task_runner->PostTask([&latch]() { latch.Signal(); });
+    latch.Wait();
+    ASSERT_EQ(pool.GetIdleShellCount(), 1u);
+
+    DestroyShell(std::move(shell));
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
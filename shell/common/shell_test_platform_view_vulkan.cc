@@ -112,6 +112,11 @@ bool ShellTestPlatformViewVulkan::OffScreenSurface::CreateSkiaGrContext() {
   }
   PersistentCache::MarkStrategySet();
   options.fPersistentCache = PersistentCache::GetCacheForProcess();
+  VkPhysicalDeviceProperties properties;
+  if (logical_device_->GetPhysicalDeviceProperties(&properties)) {
+    PersistentCache::GetCacheForProcess()->SetVkPipelineCacheDevice(
+        properties.vendorID, properties.deviceID, properties.driverVersion);
+  }
 
   sk_sp<GrContext> context = GrContext::MakeVulkan(backend_context, options);
 
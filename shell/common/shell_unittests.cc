@@ -830,6 +830,37 @@ TEST_F(ShellTest, SetResourceCacheSize) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, CoalescesViewportMetricsToTheLatest) {
+  Settings settings = CreateSettingsForFixture();
+  auto task_runner = CreateNewThread();
+  TaskRunners task_runners("test", task_runner, task_runner, task_runner,
+                           task_runner);
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+
+  // A burst of metrics, as during a live resize, before the other threads get
+  // to any of them.
+  fml::TaskRunner::RunNowOrPostTask(
+      shell->GetTaskRunners().GetPlatformTaskRunner(), [&shell]() {
+        for (double width = 100; width <= 400; width += 10) {
+          shell->GetPlatformView()->SetViewportMetrics(
+              {1.0, width, 200, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+        }
+      });
+  PumpOneFrame(shell.get());
+
+  EXPECT_EQ(GetRasterizerResourceCacheBytesSync(*shell), 3840000U);
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 TEST_F(ShellTest, SetResourceCacheSizeEarly) {
   Settings settings = CreateSettingsForFixture();
   auto task_runner = CreateNewThread();
@@ -898,6 +929,44 @@ TEST_F(ShellTest, SetResourceCacheSizeNotifiesDart) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, NotifyMemoryPressureReportsOnThePlatformThread) {
+  Settings settings = CreateSettingsForFixture();
+  ThreadHost thread_host("io.flutter.test." + GetCurrentTestName() + ".",
+                         ThreadHost::Type::Platform | ThreadHost::Type::GPU |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  // Create the surface needed by rasterizer
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+
+  for (auto level :
+       {MemoryPressureLevel::kModerate, MemoryPressureLevel::kCritical,
+        MemoryPressureLevel::kBackground}) {
+    fml::AutoResetWaitableEvent latch;
+    shell->NotifyMemoryPressure(
+        level, [&latch, level, &task_runners](MemoryPressureReport report) {
+          EXPECT_TRUE(task_runners.GetPlatformTaskRunner()
+                          ->RunsTasksOnCurrentThread());
+          EXPECT_EQ(report.level, level);
+          latch.Signal();
+        });
+    latch.Wait();
+  }
+
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 TEST_F(ShellTest, CanCreateImagefromDecompressedBytes) {
   Settings settings = CreateSettingsForFixture();
   auto task_runner = CreateNewThread();
@@ -1309,6 +1378,37 @@ TEST_F(ShellTest, RasterizerScreenshot) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, ScreenshotCanBeDownscaledAndEncodedAsynchronously) {
+  Settings settings = CreateSettingsForFixture();
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  auto task_runner = CreateNewThread();
+  TaskRunners task_runners("test", task_runner, task_runner, task_runner,
+                           task_runner);
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(ValidateShell(shell.get()));
+  PlatformViewNotifyCreated(shell.get());
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  PumpOneFrame(shell.get(), 101, 40);
+
+  fml::AutoResetWaitableEvent latch;
+  Rasterizer::Screenshot screenshot;
+  shell->Screenshot(Rasterizer::ScreenshotType::UncompressedRGBAImage, false,
+                    0.5f, [&latch, &screenshot](Rasterizer::Screenshot result) {
+                      screenshot = std::move(result);
+                      latch.Signal();
+                    });
+  latch.Wait();
+
+  ASSERT_NE(screenshot.data, nullptr);
+  EXPECT_EQ(screenshot.frame_size, SkISize::Make(51, 20));
+  EXPECT_EQ(screenshot.data->size(), 51u * 20u * 4u);
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 TEST_F(ShellTest, RasterizerMakeRasterSnapshot) {
   Settings settings = CreateSettingsForFixture();
   auto configuration = RunConfiguration::InferFromSettings(settings);
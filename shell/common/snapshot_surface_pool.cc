@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/snapshot_surface_pool.h"
+
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+SnapshotSurfacePool::SnapshotSurfacePool(size_t max_surfaces)
+    : max_surfaces_(max_surfaces),
+      memory_charge_(fml::MemoryCounter::Get("SnapshotSurfacePool")) {}
+
+SnapshotSurfacePool::~SnapshotSurfacePool() = default;
+
+void SnapshotSurfacePool::SetMaxSurfaces(size_t max_surfaces) {
+  max_surfaces_ = max_surfaces;
+  Trim(max_surfaces_);
+}
+
+sk_sp<SkSurface> SnapshotSurfacePool::Acquire(GrContext* context,
+                                              const SkImageInfo& image_info) {
+  // The most recently released surfaces are the most likely to match.
+  for (auto it = surfaces_.rbegin(); it != surfaces_.rend(); ++it) {
+    if (it->context == context && it->surface->imageInfo() == image_info) {
+      sk_sp<SkSurface> surface = std::move(it->surface);
+      surfaces_.erase(std::next(it).base());
+      reuse_count_++;
+      UpdateMemoryCharge();
+      return surface;
+    }
+  }
+
+  if (context == nullptr) {
+    return SkSurface::MakeRaster(image_info);
+  }
+  return SkSurface::MakeRenderTarget(context,          // context
+                                     SkBudgeted::kNo,  // budgeted
+                                     image_info        // image info
+  );
+}
+
+void SnapshotSurfacePool::Release(sk_sp<SkSurface> surface) {
+  if (!surface || max_surfaces_ == 0) {
+    return;
+  }
+  Trim(max_surfaces_ - 1);
+  GrContext* context = surface->getCanvas()->getGrContext();
+  surfaces_.push_back({context, std::move(surface)});
+  UpdateMemoryCharge();
+}
+
+void SnapshotSurfacePool::Clear() {
+  Trim(0);
+}
+
+void SnapshotSurfacePool::Trim(size_t max_surfaces) {
+  if (surfaces_.size() <= max_surfaces) {
+    return;
+  }
+  surfaces_.erase(surfaces_.begin(),
+                  surfaces_.begin() + (surfaces_.size() - max_surfaces));
+  UpdateMemoryCharge();
+}
+
+void SnapshotSurfacePool::UpdateMemoryCharge() {
+  int64_t bytes = 0;
+  for (const auto& entry : surfaces_) {
+    bytes += entry.surface->imageInfo().computeMinByteSize();
+  }
+  memory_charge_.Update(bytes);
+}
+
+}  // namespace flutter
@@ -0,0 +1,74 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
+#define FLUTTER_SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
+
+#include <deque>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+// The offscreen surfaces that the rasterizer draws snapshots into, kept
+// between snapshots so that those of the same size and format reuse a render
+// target instead of allocating one each.
+//
+// A surface must only be released into the pool once nothing refers to the
+// snapshots taken of it anymore, which would otherwise be copied the next time
+// the surface is drawn into. The pool is only used on the raster thread.
+class SnapshotSurfacePool {
+ public:
+  // Creates a pool that keeps up to |max_surfaces| released surfaces.
+  explicit SnapshotSurfacePool(size_t max_surfaces);
+
+  ~SnapshotSurfacePool();
+
+  // Drops the least recently released surfaces beyond |max_surfaces|.
+  void SetMaxSurfaces(size_t max_surfaces);
+
+  // Returns a released surface with |image_info| that renders with |context|,
+  // or a new one if there is none. A null |context| makes raster surfaces.
+  // Reused surfaces keep what was last drawn into them.
+  sk_sp<SkSurface> Acquire(GrContext* context, const SkImageInfo& image_info);
+
+  // Returns |surface| to the pool, dropping the least recently released
+  // surface if it is full.
+  void Release(sk_sp<SkSurface> surface);
+
+  // Drops all released surfaces, as when their context goes away.
+  void Clear();
+
+  size_t GetSurfaceCount() const { return surfaces_.size(); }
+
+  // The number of acquired surfaces that were reused.
+  size_t GetReuseCount() const { return reuse_count_; }
+
+ private:
+  struct Entry {
+    GrContext* context;
+    sk_sp<SkSurface> surface;
+  };
+
+  size_t max_surfaces_;
+  // Least recently released first.
+  std::deque<Entry> surfaces_;
+  size_t reuse_count_ = 0;
+  // The bytes of the released surfaces, charged to the "SnapshotSurfacePool"
+  // counter.
+  fml::MemoryCharge memory_charge_;
+
+  void Trim(size_t max_surfaces);
+
+  void UpdateMemoryCharge();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SnapshotSurfacePool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
@@ -0,0 +1,63 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/snapshot_surface_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static SkImageInfo MakeInfo(int width, int height) {
+  return SkImageInfo::MakeN32Premul(width, height);
+}
+
+TEST(SnapshotSurfacePoolTest, ReusesReleasedSurfacesOfTheSameInfo) {
+  SnapshotSurfacePool pool(2);
+  sk_sp<SkSurface> surface = pool.Acquire(nullptr, MakeInfo(10, 10));
+  ASSERT_TRUE(surface);
+  SkSurface* raw_surface = surface.get();
+  pool.Release(std::move(surface));
+  EXPECT_EQ(pool.GetSurfaceCount(), 1u);
+
+  EXPECT_NE(pool.Acquire(nullptr, MakeInfo(20, 10)).get(), raw_surface);
+  EXPECT_EQ(pool.GetReuseCount(), 0u);
+
+  sk_sp<SkSurface> reused = pool.Acquire(nullptr, MakeInfo(10, 10));
+  EXPECT_EQ(reused.get(), raw_surface);
+  EXPECT_EQ(pool.GetReuseCount(), 1u);
+  EXPECT_EQ(pool.GetSurfaceCount(), 0u);
+}
+
+TEST(SnapshotSurfacePoolTest, DropsTheLeastRecentlyReleasedSurfaces) {
+  SnapshotSurfacePool pool(2);
+  sk_sp<SkSurface> first = pool.Acquire(nullptr, MakeInfo(10, 10));
+  sk_sp<SkSurface> second = pool.Acquire(nullptr, MakeInfo(20, 20));
+  sk_sp<SkSurface> third = pool.Acquire(nullptr, MakeInfo(30, 30));
+  pool.Release(first);
+  pool.Release(second);
+  pool.Release(third);
+  EXPECT_EQ(pool.GetSurfaceCount(), 2u);
+
+  EXPECT_NE(pool.Acquire(nullptr, MakeInfo(10, 10)), first);
+  EXPECT_EQ(pool.Acquire(nullptr, MakeInfo(20, 20)), second);
+
+  pool.SetMaxSurfaces(0);
+  EXPECT_EQ(pool.GetSurfaceCount(), 0u);
+  pool.Release(third);
+  EXPECT_EQ(pool.GetSurfaceCount(), 0u);
+}
+
+TEST(SnapshotSurfacePoolTest, ClearDropsAllSurfaces) {
+  SnapshotSurfacePool pool(4);
+  pool.Release(pool.Acquire(nullptr, MakeInfo(10, 10)));
+  pool.Release(pool.Acquire(nullptr, MakeInfo(20, 20)));
+  EXPECT_EQ(pool.GetSurfaceCount(), 2u);
+
+  pool.Clear();
+  EXPECT_EQ(pool.GetSurfaceCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_profiler.h"
+
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace flutter {
+
+const char* StartupProfiler::GetMilestoneName(Milestone milestone) {
+  switch (milestone) {
+    case kEngineMainEnter:
+      return "engineMainEnter";
+    case kVMCreated:
+      return "vmCreated";
+    case kShellCreated:
+      return "shellCreated";
+    case kRunEngine:
+      return "runEngine";
+    case kRootIsolateRunning:
+      return "rootIsolateRunning";
+    case kFirstFrameRasterized:
+      return "firstFrameRasterized";
+    case kMilestoneCount:
+      break;
+  }
+  return "unknown";
+}
+
+int64_t StartupProfiler::Now() {
+  return Dart_TimelineGetMicros();
+}
+
+StartupProfiler::StartupProfiler() {
+  for (auto& timestamp : timestamps_) {
+    timestamp.store(0, std::memory_order_relaxed);
+  }
+}
+
+StartupProfiler::~StartupProfiler() = default;
+
+bool StartupProfiler::Record(Milestone milestone, int64_t timestamp) {
+  if (timestamp <= 0) {
+    return false;
+  }
+  int64_t expected = 0;
+  return timestamps_[milestone].compare_exchange_strong(
+      expected, timestamp, std::memory_order_relaxed);
+}
+
+int64_t StartupProfiler::Get(Milestone milestone) const {
+  return timestamps_[milestone].load(std::memory_order_relaxed);
+}
+
+int64_t StartupProfiler::GetSinceMainEnter(Milestone milestone) const {
+  const int64_t main_enter = Get(kEngineMainEnter);
+  const int64_t timestamp = Get(milestone);
+  if (main_enter == 0 || timestamp == 0) {
+    return -1;
+  }
+  return timestamp - main_enter;
+}
+
+}  // namespace flutter
@@ -0,0 +1,74 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STARTUP_PROFILER_H_
+#define FLUTTER_SHELL_COMMON_STARTUP_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+/// Records when a shell reached the milestones of its startup, from the
+/// embedder entering the engine to the first frame being rasterized, so that
+/// startup can be broken down without recording a timeline.
+///
+/// Recording a milestone is a single atomic store, so the profiler is always
+/// on. Milestones are recorded on several threads and can be read on any
+/// thread. Timestamps are in microseconds of the clock of
+/// |Dart_TimelineGetMicros|, the clock of |Settings::engine_start_timestamp|.
+class StartupProfiler {
+ public:
+  enum Milestone {
+    // The embedder entered the engine, see
+    // |Settings::engine_start_timestamp|.
+    kEngineMainEnter,
+    // The Dart VM the shell runs on was created. This is before the shell was
+    // created if the VM was kept alive for, or by, another shell.
+    kVMCreated,
+    // The shell, with its platform view, rasterizer, IO manager and engine,
+    // was set up.
+    kShellCreated,
+    // The shell was asked to run with a run configuration, whose assets were
+    // resolved by then.
+    kRunEngine,
+    // The root isolate was launched and its main entrypoint has returned. See
+    // |IsolateStartupTiming| for the steps of the launch.
+    kRootIsolateRunning,
+    kFirstFrameRasterized,
+    kMilestoneCount,
+  };
+
+  /// The name of |milestone| in service protocol responses.
+  static const char* GetMilestoneName(Milestone milestone);
+
+  /// The current time on the clock of the timestamps.
+  static int64_t Now();
+
+  StartupProfiler();
+
+  ~StartupProfiler();
+
+  /// Records that |milestone| was reached at |timestamp|, unless it was
+  /// recorded before. Returns whether it was recorded.
+  bool Record(Milestone milestone, int64_t timestamp = Now());
+
+  /// The time |milestone| was reached, or 0 if it wasn't.
+  int64_t Get(Milestone milestone) const;
+
+  /// The time from entering the engine until |milestone| was reached, or -1 if
+  /// either wasn't recorded.
+  int64_t GetSinceMainEnter(Milestone milestone) const;
+
+ private:
+  std::atomic<int64_t> timestamps_[kMilestoneCount];
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupProfiler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_STARTUP_PROFILER_H_
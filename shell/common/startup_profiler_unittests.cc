@@ -0,0 +1,32 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_profiler.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(StartupProfilerTest, KeepsTheFirstTimeAMilestoneIsReached) {
+  StartupProfiler profiler;
+  EXPECT_EQ(profiler.Get(StartupProfiler::kShellCreated), 0);
+  EXPECT_TRUE(profiler.Record(StartupProfiler::kShellCreated, 100));
+  EXPECT_FALSE(profiler.Record(StartupProfiler::kShellCreated, 200));
+  EXPECT_EQ(profiler.Get(StartupProfiler::kShellCreated), 100);
+}
+
+TEST(StartupProfilerTest, ReportsMilestonesSinceMainEnter) {
+  StartupProfiler profiler;
+  profiler.Record(StartupProfiler::kFirstFrameRasterized, 1500);
+  EXPECT_EQ(profiler.GetSinceMainEnter(StartupProfiler::kFirstFrameRasterized),
+            -1);
+  profiler.Record(StartupProfiler::kEngineMainEnter, 1000);
+  EXPECT_EQ(profiler.GetSinceMainEnter(StartupProfiler::kFirstFrameRasterized),
+            500);
+  EXPECT_EQ(profiler.GetSinceMainEnter(StartupProfiler::kRunEngine), -1);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -253,6 +253,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_service_port_fallback =
       command_line.HasOption(FlagForSwitch(Switch::EnableServicePortFallback));
 
+  settings.defer_observatory_startup =
+      command_line.HasOption(FlagForSwitch(Switch::DeferObservatoryStartup));
+
   // Checked mode overrides.
   settings.disable_dart_asserts =
       command_line.HasOption(FlagForSwitch(Switch::DisableDartAsserts));
@@ -290,6 +293,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
     }
   }
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceCategories),
+                              &settings.trace_categories);
+
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
@@ -299,6 +305,310 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.verbose_logging =
       command_line.HasOption(FlagForSwitch(Switch::VerboseLogging));
 
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheMaxBytes,
+                        &settings.raster_cache_max_bytes)) {
+      FML_LOG(INFO) << "Raster cache max bytes specified was malformed. Will "
+                       "default to an unbounded cache.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheAtlasMaxEntrySize))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheAtlasMaxEntrySize,
+                        &settings.raster_cache_atlas_max_entry_size)) {
+      FML_LOG(INFO) << "Raster cache atlas max entry size specified was "
+                       "malformed. Will default to a disabled atlas.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheScaleTolerance))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheScaleTolerance,
+                        &settings.raster_cache_scale_tolerance)) {
+      FML_LOG(INFO) << "Raster cache scale tolerance specified was malformed. "
+                       "Will default to rasterizing every scale.";
+    }
+  }
+
+  settings.deferred_raster_cache_population = command_line.HasOption(
+      FlagForSwitch(Switch::DeferredRasterCachePopulation));
+
+  settings.raster_cache_cost_model =
+      command_line.HasOption(FlagForSwitch(Switch::RasterCacheCostModel));
+
+  settings.raster_cache_shadows =
+      command_line.HasOption(FlagForSwitch(Switch::RasterCacheShadows));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::BackdropFilterMaxDownsample))) {
+    if (!GetSwitchValue(command_line, Switch::BackdropFilterMaxDownsample,
+                        &settings.backdrop_filter_max_downsample)) {
+      FML_LOG(INFO) << "Backdrop filter max downsample specified was "
+                       "malformed. Will default to full resolution.";
+    }
+  }
+
+  settings.reuse_filtered_backdrops =
+      command_line.HasOption(FlagForSwitch(Switch::ReuseFilteredBackdrops));
+
+  settings.retain_raster_cache_on_teardown = command_line.HasOption(
+      FlagForSwitch(Switch::RetainRasterCacheOnTeardown));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::LayerTreePipelineDepth))) {
+    if (!GetSwitchValue(command_line, Switch::LayerTreePipelineDepth,
+                        &settings.layer_tree_pipeline_depth) ||
+        settings.layer_tree_pipeline_depth < 1 ||
+        settings.layer_tree_pipeline_depth > 3) {
+      FML_LOG(INFO) << "Layer tree pipeline depth specified was malformed. "
+                       "Will default to the platform's depth.";
+      settings.layer_tree_pipeline_depth = 0;
+    }
+  }
+
+  settings.low_latency_pipeline =
+      command_line.HasOption(FlagForSwitch(Switch::LowLatencyPipeline));
+
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::VulkanPresentMode),
+                                  &settings.vulkan_present_mode) &&
+      settings.vulkan_present_mode != "fifo" &&
+      settings.vulkan_present_mode != "fifo-relaxed" &&
+      settings.vulkan_present_mode != "mailbox") {
+    FML_LOG(INFO) << "Vulkan present mode specified was malformed. Will "
+                     "default to fifo.";
+    settings.vulkan_present_mode.clear();
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::VulkanMaxFramesInFlight))) {
+    if (!GetSwitchValue(command_line, Switch::VulkanMaxFramesInFlight,
+                        &settings.vulkan_max_frames_in_flight)) {
+      FML_LOG(INFO) << "Vulkan max frames in flight specified was malformed. "
+                       "Will default to one frame per swapchain image.";
+    }
+  }
+
+  settings.predictive_frame_scheduling = command_line.HasOption(
+      FlagForSwitch(Switch::PredictiveFrameScheduling));
+
+  settings.frame_aware_idle_notifications = command_line.HasOption(
+      FlagForSwitch(Switch::FrameAwareIdleNotifications));
+
+  settings.skip_unchanged_frames =
+      command_line.HasOption(FlagForSwitch(Switch::SkipUnchangedFrames));
+
+  settings.adaptive_frame_rate =
+      command_line.HasOption(FlagForSwitch(Switch::AdaptiveFrameRate));
+
+  settings.profile_layer_costs =
+      command_line.HasOption(FlagForSwitch(Switch::ProfileLayerCosts));
+
+  if (command_line.GetOptionValue(
+          FlagForSwitch(Switch::PerformanceOverlayMode),
+          &settings.performance_overlay_mode) &&
+      settings.performance_overlay_mode != "lightweight" &&
+      settings.performance_overlay_mode != "export") {
+    FML_LOG(INFO) << "Performance overlay mode specified was malformed. Will "
+                     "default to the full graphs.";
+    settings.performance_overlay_mode.clear();
+  }
+
+  settings.profile_sync =
+      command_line.HasOption(FlagForSwitch(Switch::ProfileSync));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterThreadMergerMaxLeaseTerm))) {
+    if (!GetSwitchValue(command_line, Switch::RasterThreadMergerMaxLeaseTerm,
+                        &settings.raster_thread_merger_max_lease_term)) {
+      FML_LOG(INFO) << "Raster thread merger max lease term specified was "
+                       "malformed. Will default to "
+                    << settings.raster_thread_merger_max_lease_term;
+    }
+  }
+
+  settings.adaptive_resource_cache =
+      command_line.HasOption(FlagForSwitch(Switch::AdaptiveResourceCache));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::DeviceMemoryMB))) {
+    if (!GetSwitchValue(command_line, Switch::DeviceMemoryMB,
+                        &settings.device_memory_mb)) {
+      FML_LOG(INFO) << "Device memory specified was malformed. Will default "
+                       "to "
+                    << settings.device_memory_mb;
+    }
+  }
+
+  settings.parallel_preroll =
+      command_line.HasOption(FlagForSwitch(Switch::ParallelPreroll));
+
+  settings.parallel_paint =
+      command_line.HasOption(FlagForSwitch(Switch::ParallelPaint));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::TimerToleranceMs))) {
+    if (!GetSwitchValue(command_line, Switch::TimerToleranceMs,
+                        &settings.timer_tolerance_ms)) {
+      FML_LOG(INFO) << "Timer tolerance specified was malformed. Will default "
+                       "to "
+                    << settings.timer_tolerance_ms;
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::MessageBatchMaxCount))) {
+    if (!GetSwitchValue(command_line, Switch::MessageBatchMaxCount,
+                        &settings.message_batch_max_count)) {
+      FML_LOG(INFO) << "Message batch max count specified was malformed. Will "
+                       "default to "
+                    << settings.message_batch_max_count;
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::MessageBatchBudgetUs))) {
+    if (!GetSwitchValue(command_line, Switch::MessageBatchBudgetUs,
+                        &settings.message_batch_budget_us)) {
+      FML_LOG(INFO) << "Message batch budget specified was malformed. Will "
+                       "default to "
+                    << settings.message_batch_budget_us;
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::TraceRingBufferSize))) {
+    if (!GetSwitchValue(command_line, Switch::TraceRingBufferSize,
+                        &settings.trace_ring_buffer_size)) {
+      FML_LOG(INFO) << "Trace ring buffer size specified was malformed. Will "
+                       "default to "
+                    << settings.trace_ring_buffer_size;
+    }
+  }
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::JankCapturePath),
+                              &settings.jank_capture_path);
+
+  if (command_line.HasOption(FlagForSwitch(Switch::JankCaptureBudgetMs))) {
+    if (!GetSwitchValue(command_line, Switch::JankCaptureBudgetMs,
+                        &settings.jank_capture_budget_ms)) {
+      FML_LOG(INFO) << "Jank capture budget specified was malformed. Will "
+                       "default to the frame budget of the display.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::JankCaptureSlowFrameCount))) {
+    if (!GetSwitchValue(command_line, Switch::JankCaptureSlowFrameCount,
+                        &settings.jank_capture_slow_frame_count)) {
+      FML_LOG(INFO) << "Jank capture slow frame count specified was "
+                       "malformed. Will default to "
+                    << settings.jank_capture_slow_frame_count;
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::JankCaptureIntervalS))) {
+    if (!GetSwitchValue(command_line, Switch::JankCaptureIntervalS,
+                        &settings.jank_capture_interval_s)) {
+      FML_LOG(INFO) << "Jank capture interval specified was malformed. Will "
+                       "default to "
+                    << settings.jank_capture_interval_s;
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::DecodedImageCacheMaxBytes,
+                        &settings.decoded_image_cache_max_bytes)) {
+      FML_LOG(INFO) << "Decoded image cache max bytes specified was "
+                       "malformed. Will default to not caching decoded "
+                       "images.";
+    }
+  }
+
+  settings.enable_platform_image_decoders = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePlatformImageDecoders));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageLookAheadFrames))) {
+    if (!GetSwitchValue(command_line, Switch::AnimatedImageLookAheadFrames,
+                        &settings.animated_image_look_ahead_frames)) {
+      FML_LOG(INFO) << "Animated image look ahead frames specified was "
+                       "malformed. Will default to decoding each frame when "
+                       "it is requested.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageFrameCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::AnimatedImageFrameCacheMaxBytes,
+                        &settings.animated_image_frame_cache_max_bytes)) {
+      FML_LOG(INFO) << "Animated image frame cache max bytes specified was "
+                       "malformed. Will default to not caching frames.";
+    }
+  }
+
+  settings.enable_canvas_command_buffer = command_line.HasOption(
+      FlagForSwitch(Switch::EnableCanvasCommandBuffer));
+  settings.enable_display_list =
+      command_line.HasOption(FlagForSwitch(Switch::EnableDisplayList));
+  settings.retain_unchanged_layers =
+      command_line.HasOption(FlagForSwitch(Switch::RetainUnchangedLayers));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::PathCacheMaxEntries))) {
+    if (!GetSwitchValue(command_line, Switch::PathCacheMaxEntries,
+                        &settings.path_cache_max_entries)) {
+      FML_LOG(INFO) << "Path cache max entries specified was malformed. Will "
+                       "default to not interning paths.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ParagraphCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::ParagraphCacheMaxBytes,
+                        &settings.paragraph_cache_max_bytes)) {
+      FML_LOG(INFO) << "Paragraph cache max bytes specified was malformed. "
+                       "Will default to not caching paragraphs.";
+    }
+  }
+
+  settings.enable_skparagraph =
+      command_line.HasOption(FlagForSwitch(Switch::EnableSkParagraph));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::SnapshotSurfacePoolSize))) {
+    if (!GetSwitchValue(command_line, Switch::SnapshotSurfacePoolSize,
+                        &settings.snapshot_surface_pool_size)) {
+      FML_LOG(INFO) << "Snapshot surface pool size specified was malformed. "
+                       "Will default to not pooling surfaces.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::UnrefQueueDrainBudgetUs))) {
+    if (!GetSwitchValue(command_line, Switch::UnrefQueueDrainBudgetUs,
+                        &settings.unref_queue_drain_budget_us)) {
+      FML_LOG(INFO) << "Unref queue drain budget specified was malformed. "
+                       "Will default to draining all objects at once.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::IOUploadWorkerCount))) {
+    if (!GetSwitchValue(command_line, Switch::IOUploadWorkerCount,
+                        &settings.io_upload_worker_count)) {
+      FML_LOG(INFO) << "IO upload worker count specified was malformed. "
+                       "Will default to uploading on the IO thread only.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::LayoutCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::LayoutCacheMaxBytes,
+                        &settings.layout_cache_max_bytes)) {
+      FML_LOG(INFO) << "Layout cache max bytes specified was malformed. Will "
+                       "default to 2 MiB.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheMaxUnusedFrames))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheMaxUnusedFrames,
+                        &settings.raster_cache_max_unused_frames)) {
+      FML_LOG(INFO) << "Raster cache max unused frames specified was "
+                       "malformed. Will default to "
+                    << settings.raster_cache_max_unused_frames;
+    }
+  }
+
   command_line.GetOptionValue(FlagForSwitch(Switch::FlutterAssetsDir),
                               &settings.assets_path);
 
@@ -391,6 +701,39 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
 
   settings.cache_sksl =
       command_line.HasOption(FlagForSwitch(Switch::CacheSkSL));
+  settings.pack_persistent_cache =
+      command_line.HasOption(FlagForSwitch(Switch::PackPersistentCache));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::PersistentCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::PersistentCacheMaxBytes,
+                        &settings.persistent_cache_max_bytes)) {
+      FML_LOG(INFO) << "Persistent cache max bytes specified was malformed. "
+                       "Will default to not limiting the cache.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::SkSLPrecompilationBudgetUs))) {
+    if (!GetSwitchValue(command_line, Switch::SkSLPrecompilationBudgetUs,
+                        &settings.sksl_precompilation_budget_us)) {
+      FML_LOG(INFO) << "SkSL precompilation budget specified was malformed. "
+                       "Will default to precompiling all SkSLs at once.";
+    }
+  }
+
+  settings.record_shader_warm_up =
+      command_line.HasOption(FlagForSwitch(Switch::RecordShaderWarmUp));
+  settings.shader_warm_up =
+      command_line.HasOption(FlagForSwitch(Switch::ShaderWarmUp));
+  for (std::string_view spec :
+       command_line.GetOptionValues(FlagForSwitch(Switch::GlyphWarmUp))) {
+    settings.glyph_warm_up.emplace_back(spec);
+  }
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::AssetAccessManifest),
+                              &settings.asset_access_manifest_path);
+  settings.record_asset_access_manifest =
+      command_line.HasOption(FlagForSwitch(Switch::RecordAssetAccessManifest));
 
   return settings;
 }
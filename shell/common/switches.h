@@ -116,6 +116,11 @@ DEF_SWITCH(EnableServicePortFallback,
            "enable-service-port-fallback",
            "Allow the VM service to fallback to automatic port selection if"
            " binding to a specified port fails.")
+DEF_SWITCH(DeferObservatoryStartup,
+           "defer-observatory-startup",
+           "Start the VM service after the first frame rather than along "
+           "with the Dart VM, so that it does not add to the startup time. "
+           "Has no effect with --start-paused.")
 DEF_SWITCH(StartPaused,
            "start-paused",
            "Start the application paused in the Dart debugger.")
@@ -137,6 +142,11 @@ DEF_SWITCH(
     "trace-allowlist",
     "Filters out all trace events except those that are specified in this "
     "comma separated list of allowed prefixes.")
+DEF_SWITCH(TraceCategories,
+           "trace-categories",
+           "Only trace events in this comma separated list of categories, "
+           "such as flutter, flutter.detail and fml. The arguments of events "
+           "in other categories are not computed.")
 DEF_SWITCH(DumpSkpOnShaderCompilation,
            "dump-skp-on-shader-compilation",
            "Automatically dump the skp that triggers new shader compilations. "
@@ -148,6 +158,53 @@ DEF_SWITCH(CacheSkSL,
            "should only be used during development phases. The generated SkSLs "
            "can later be used in the release build for shader precompilation "
            "at launch in order to eliminate the shader-compile jank.")
+DEF_SWITCH(PackPersistentCache,
+           "pack-persistent-cache",
+           "Append the shaders of the persistent cache to a single file of "
+           "its directory instead of writing a file for each, so that they "
+           "are loaded with a single open and read. Shaders already stored in "
+           "files of their own are still loaded.")
+DEF_SWITCH(PersistentCacheMaxBytes,
+           "persistent-cache-max-bytes",
+           "The bytes that the shaders of the packed persistent cache may take "
+           "on disk, above which the least recently used ones are evicted. "
+           "Only used with --pack-persistent-cache. Zero, the default, "
+           "doesn't limit them.")
+DEF_SWITCH(SkSLPrecompilationBudgetUs,
+           "sksl-precompilation-budget-us",
+           "The microseconds that precompiling the SkSLs found at startup may "
+           "keep the raster thread busy at a time. The remaining SkSLs are "
+           "precompiled between frames, so that the first frame isn't held "
+           "back by all of them. Zero, the default, precompiles them all "
+           "before the first frame.")
+DEF_SWITCH(RecordShaderWarmUp,
+           "record-shader-warm-up",
+           "Record a draw op for each combination of paint, blend mode, shader "
+           "and geometry class drawn by the frames into the persistent cache. "
+           "This is meant for training runs, whose recordings are then "
+           "replayed with --shader-warm-up.")
+DEF_SWITCH(ShaderWarmUp,
+           "shader-warm-up",
+           "Replay the draw ops recorded with --record-shader-warm-up into an "
+           "offscreen surface at startup, so that the GPU driver compiles "
+           "their shaders before the first frame. Unlike --cache-sksl, this "
+           "works on any rendering backend.")
+DEF_SWITCH(GlyphWarmUp,
+           "glyph-warm-up",
+           "Rasterize the glyphs of a font family at some sizes at idle time "
+           "after launch, so that the first frames showing them don't. The "
+           "value is of the form \"<font family>:<size>[,<size>...]"
+           "[:<characters>]\", the characters defaulting to printable ASCII. "
+           "May be repeated.")
+DEF_SWITCH(AssetAccessManifest,
+           "asset-access-manifest",
+           "The path of a manifest of the assets looked up before the first "
+           "frame. The assets it lists are read ahead concurrently at launch, "
+           "while the isolate is starting.")
+DEF_SWITCH(RecordAssetAccessManifest,
+           "record-asset-access-manifest",
+           "Write the assets looked up before the first frame to the manifest "
+           "given with --asset-access-manifest, instead of prefetching them.")
 DEF_SWITCH(
     TraceSystrace,
     "trace-systrace",
@@ -183,6 +240,256 @@ DEF_SWITCH(DisableHttp,
            "HTTP and WebSocket protocols. Localhost or loopback addresses are "
            "exempted. This flag can be specified if the embedder wants this "
            "for a particular platform.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The maximum number of bytes of rasterized pictures and layers that "
+           "may be held by the raster cache. When the limit is exceeded, the "
+           "least recently used entries are evicted. By default, the raster "
+           "cache is unbounded.")
+DEF_SWITCH(RasterCacheMaxUnusedFrames,
+           "raster-cache-max-unused-frames",
+           "The number of consecutive frames a raster cache entry may go "
+           "unused before it is evicted. Retaining entries for a few frames "
+           "avoids re-rasterizing content that is briefly hidden. By default, "
+           "entries are evicted as soon as a frame does not use them.")
+DEF_SWITCH(DeferredRasterCachePopulation,
+           "deferred-raster-cache-population",
+           "Draw pictures that become worth raster caching directly and "
+           "rasterize them into the cache in the idle time left after the "
+           "frame is submitted, instead of during Preroll. This avoids jank on "
+           "the first frames complex pictures appear in.")
+DEF_SWITCH(RasterCacheAtlasMaxEntrySize,
+           "raster-cache-atlas-max-entry-size",
+           "Raster cache entries whose width and height in pixels are both at "
+           "most this value are packed into shared atlas textures instead of "
+           "getting a texture each. By default, the atlas is disabled.")
+DEF_SWITCH(RasterCacheScaleTolerance,
+           "raster-cache-scale-tolerance",
+           "While a raster cached picture or layer is drawn scaled by at most "
+           "a factor of one plus this value, e.g. during a pinch-zoom, the "
+           "cached image is stretched instead of rasterized again until the "
+           "scale settles. By default, every new scale is rasterized.")
+DEF_SWITCH(RasterCacheCostModel,
+           "raster-cache-cost-model",
+           "Cache pictures once the time saved by drawing their cached image "
+           "is expected to pay for rasterizing them, as estimated from the "
+           "ops they contain, instead of after they were drawn in a fixed "
+           "number of frames. Over the byte budget, the entries saving the "
+           "least time per byte are evicted first.")
+DEF_SWITCH(RasterCacheShadows,
+           "raster-cache-shadows",
+           "Cache the shadows of physical shapes as images in the raster "
+           "cache, so that shadows drawn with the same shape, elevation and "
+           "color in consecutive frames are only blurred once.")
+DEF_SWITCH(BackdropFilterMaxDownsample,
+           "backdrop-filter-max-downsample",
+           "The largest factor the backdrops of large blurs of backdrop "
+           "filters may be downsampled by before being blurred, trading "
+           "sharpness for speed. Defaults to 1, which keeps them at full "
+           "resolution.")
+DEF_SWITCH(ReuseFilteredBackdrops,
+           "reuse-filtered-backdrops",
+           "Keep the filtered backdrops of backdrop filters that paint into "
+           "the surface of the frame, and reuse them in the next frame when "
+           "the content below them did not change.")
+DEF_SWITCH(RetainRasterCacheOnTeardown,
+           "retain-raster-cache-on-teardown",
+           "Keep the raster cache when the surface is destroyed, for example "
+           "when the app goes to the background, and reuse it if the next "
+           "surface renders with the same graphics context.")
+DEF_SWITCH(LayerTreePipelineDepth,
+           "layer-tree-pipeline-depth",
+           "The number of frames, from 1 to 3, that may be in flight between "
+           "the UI and the raster thread. Defaults to the platform's depth.")
+DEF_SWITCH(LowLatencyPipeline,
+           "low-latency-pipeline",
+           "Replace a frame waiting for the raster thread with the newest "
+           "one instead of rendering it late.")
+DEF_SWITCH(VulkanPresentMode,
+           "vulkan-present-mode",
+           "The present mode of Vulkan swapchains: fifo, fifo-relaxed or "
+           "mailbox. Modes the surface doesn't support fall back to fifo, "
+           "which is the default.")
+DEF_SWITCH(VulkanMaxFramesInFlight,
+           "vulkan-max-frames-in-flight",
+           "The number of frames that may be rendering or waiting to be "
+           "presented in a Vulkan swapchain. By default, one frame per "
+           "swapchain image.")
+DEF_SWITCH(PredictiveFrameScheduling,
+           "predictive-frame-scheduling",
+           "Start building each frame as late after vsync as the durations of "
+           "recent frames predict it can still complete in time, to reduce "
+           "the latency between input and the frame showing it.")
+DEF_SWITCH(FrameAwareIdleNotifications,
+           "frame-aware-idle-notifications",
+           "End the idle time given to the Dart VM for garbage collection "
+           "when the next frame of an animation is predicted to start, from "
+           "the time between recent frames, instead of at the end of the "
+           "frame interval.")
+DEF_SWITCH(SkipUnchangedFrames,
+           "skip-unchanged-frames",
+           "Skip rasterizing frames whose layer tree paints the same content "
+           "as the previous frame.")
+DEF_SWITCH(AdaptiveFrameRate,
+           "adaptive-frame-rate",
+           "Ask the display for a lower refresh rate while frames are built "
+           "less often than it refreshes, and for its highest rate again once "
+           "animations need it.")
+DEF_SWITCH(ProfileLayerCosts,
+           "profile-layer-costs",
+           "Measure the time each layer takes to preroll and paint. The "
+           "costliest layers of each frame are added to the timeline and the "
+           "costs of the last frame can be requested over the service "
+           "protocol.")
+DEF_SWITCH(PerformanceOverlayMode,
+           "performance-overlay-mode",
+           "How the performance overlay shows the statistics of the frames: "
+           "lightweight draws each graph as a single image, and export draws "
+           "nothing and only reports the frame times as trace counters. By "
+           "default, the full graphs are drawn.")
+DEF_SWITCH(ProfileSync,
+           "profile-sync",
+           "Record histograms of the time spent waiting for the locks of the "
+           "message loops and of the queue latency and duration of the tasks "
+           "of each thread. The histograms are traced as counters and can be "
+           "requested over the service protocol.")
+DEF_SWITCH(RasterThreadMergerMaxLeaseTerm,
+           "raster-thread-merger-max-lease-term",
+           "The longest number of frames the raster and platform threads stay "
+           "merged for when platform views keep appearing and disappearing. "
+           "Merging again shortly after unmerging doubles the lease term up "
+           "to this. By default, the threads unmerge a fixed number of "
+           "frames after the last platform view.")
+DEF_SWITCH(AdaptiveResourceCache,
+           "adaptive-resource-cache",
+           "Grow the budget of the Skia resource cache past the one picked for "
+           "the viewport when resources keep getting evicted and uploaded "
+           "again, and shrink it under memory pressure.")
+DEF_SWITCH(DeviceMemoryMB,
+           "device-memory-mb",
+           "The physical memory of the device in megabytes, used to size "
+           "caches to the memory class of the device.")
+DEF_SWITCH(ParallelPreroll,
+           "parallel-preroll",
+           "Preroll independent layer subtrees of large scenes concurrently on "
+           "the worker threads instead of serially on the raster thread.")
+DEF_SWITCH(ParallelPaint,
+           "parallel-paint",
+           "Record sibling layers of large scenes into deferred display lists "
+           "concurrently on the worker threads, and replay them in order on "
+           "the raster thread. Only applies to GPU surfaces.")
+DEF_SWITCH(TimerToleranceMs,
+           "timer-tolerance-ms",
+           "Let delayed tasks on the UI and IO threads run up to this many "
+           "milliseconds late, so that timers due close to each other share a "
+           "wake up of the thread. Frame critical tasks always run on time.")
+DEF_SWITCH(MessageBatchMaxCount,
+           "message-batch-max-count",
+           "Handle up to this many pending messages of the root isolate, such "
+           "as results streamed from another isolate, in one task on the UI "
+           "thread instead of one task each.")
+DEF_SWITCH(MessageBatchBudgetUs,
+           "message-batch-budget-us",
+           "The time in microseconds after which a batch of root isolate "
+           "messages leaves the rest to a later task, so that frame work can "
+           "run in between. Only used with --message-batch-max-count.")
+DEF_SWITCH(TraceRingBufferSize,
+           "trace-ring-buffer-size",
+           "Record trace events into ring buffers of this many events per "
+           "thread instead of the Dart timeline, also in release mode. The "
+           "_flutter.getTraceRingBuffers service extension exports them in "
+           "the Chrome JSON trace format.")
+DEF_SWITCH(JankCapturePath,
+           "jank-capture-path",
+           "The directory to write captures of jank to. When more than "
+           "--jank-capture-slow-frame-count of the last 60 frames were slow, "
+           "the layer tree of the slow frame is written as an SKP, with the "
+           "trace ring buffers and the timings of the frames.")
+DEF_SWITCH(JankCaptureBudgetMs,
+           "jank-capture-budget-ms",
+           "The time in milliseconds a frame may take to build or to "
+           "rasterize before it counts as slow for --jank-capture-path. "
+           "Defaults to the frame budget of the display.")
+DEF_SWITCH(JankCaptureSlowFrameCount,
+           "jank-capture-slow-frame-count",
+           "The number of the last 60 frames that may be slow before a jank "
+           "capture is made. Defaults to 2.")
+DEF_SWITCH(JankCaptureIntervalS,
+           "jank-capture-interval-s",
+           "The minimum time in seconds between two jank captures. Defaults "
+           "to 300.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The maximum number of bytes of decoded images that the image "
+           "decoder keeps, so that decoding the same image to the same size "
+           "again reuses them. The least recently used images are evicted "
+           "first. By default, no decoded images are kept.")
+DEF_SWITCH(EnablePlatformImageDecoders,
+           "enable-platform-image-decoders",
+           "Decode compressed images with the platform's image decoders, such "
+           "as hardware JPEG and HEIF decoders, where available. Images the "
+           "platform decoders don't accept are decoded by Skia.")
+DEF_SWITCH(AnimatedImageLookAheadFrames,
+           "animated-image-look-ahead-frames",
+           "The number of frames of animated images to decode ahead of the "
+           "frame being shown, on the worker threads. By default, each frame "
+           "is decoded when it is requested.")
+DEF_SWITCH(AnimatedImageFrameCacheMaxBytes,
+           "animated-image-frame-cache-max-bytes",
+           "The maximum number of bytes of decoded frames that an animated "
+           "image keeps, so that the later loops of short animations don't "
+           "decode their frames again. By default, no frames are kept.")
+DEF_SWITCH(EnableCanvasCommandBuffer,
+           "enable-canvas-command-buffer",
+           "Record the most frequent Canvas commands into a buffer in Dart "
+           "and replay them into the picture recorder in one native call, "
+           "instead of making a native call for each command.")
+DEF_SWITCH(EnableDisplayList,
+           "enable-display-list",
+           "Record pictures into display lists owned by the engine instead "
+           "of into Skia pictures, which lets the raster thread skip the "
+           "draws outside of the clip and apply opacity to their paints.")
+DEF_SWITCH(RetainUnchangedLayers,
+           "retain-unchanged-layers",
+           "Keep the layers of the previous frame that a new frame rebuilds "
+           "with the same content, so that they keep their raster cache "
+           "entries instead of being replaced by new layers.")
+DEF_SWITCH(PathCacheMaxEntries,
+           "path-cache-max-entries",
+           "The maximum number of paths that are interned by their contents, "
+           "so that paths rebuilt with the same contents share the masks and "
+           "tessellations Skia cached for them. By default, no paths are "
+           "interned.")
+DEF_SWITCH(ParagraphCacheMaxBytes,
+           "paragraph-cache-max-bytes",
+           "The maximum bytes of the paragraphs that are kept by the text and "
+           "styles they were built with, so that paragraphs rebuilt with the "
+           "same contents are already laid out. By default, no paragraphs are "
+           "kept.")
+DEF_SWITCH(EnableSkParagraph,
+           "enable-skparagraph",
+           "Lay out paragraphs with Skia's SkParagraph instead of libtxt, in "
+           "builds that include it.")
+DEF_SWITCH(SnapshotSurfacePoolSize,
+           "snapshot-surface-pool-size",
+           "The number of offscreen surfaces kept between the snapshots made "
+           "by Picture.toImage and Scene.toImage, so that snapshots of the "
+           "same size reuse a render target. By default, none are kept.")
+DEF_SWITCH(UnrefQueueDrainBudgetUs,
+           "unref-queue-drain-budget-us",
+           "The microseconds that each drain of the released GPU objects on "
+           "the IO thread may take before it yields to texture uploads and "
+           "other IO work. By default, all the objects are released at once.")
+DEF_SWITCH(IOUploadWorkerCount,
+           "io-upload-worker-count",
+           "The number of threads that upload decoded images to the GPU "
+           "besides the IO thread, each with its own resource context, where "
+           "the platform supports it. By default, images are only uploaded "
+           "on the IO thread.")
+DEF_SWITCH(LayoutCacheMaxBytes,
+           "layout-cache-max-bytes",
+           "The maximum number of bytes of shaped words that are cached for "
+           "laying out text again. By default, up to 2 MiB are cached.")
 DEF_SWITCH(
     ForceMultithreading,
     "force-multithreading",
@@ -4,31 +4,45 @@
 
 #include "flutter/shell/common/thread_host.h"
 
+#include <utility>
+
 namespace flutter {
 
 ThreadHost::ThreadHost() = default;
 
 ThreadHost::ThreadHost(ThreadHost&&) = default;
 
-ThreadHost::ThreadHost(std::string name_prefix, uint64_t mask) {
+ThreadHost::ThreadHost(std::string name_prefix, uint64_t mask)
+    : ThreadHost(std::move(name_prefix), mask, {}) {}
+
+ThreadHost::ThreadHost(std::string name_prefix,
+                       uint64_t mask,
+                       ThreadConfigs configs,
+                       fml::Thread::ThreadConfigSetter setter) {
+  auto make_thread = [&](Type type, const std::string& suffix) {
+    fml::Thread::ThreadConfig config = configs[type];
+    config.name = name_prefix + suffix;
+    return std::make_unique<fml::Thread>(std::move(config), setter);
+  };
+
   if (mask & ThreadHost::Type::Platform) {
-    platform_thread = std::make_unique<fml::Thread>(name_prefix + ".platform");
+    platform_thread = make_thread(ThreadHost::Type::Platform, ".platform");
   }
 
   if (mask & ThreadHost::Type::UI) {
-    ui_thread = std::make_unique<fml::Thread>(name_prefix + ".ui");
+    ui_thread = make_thread(ThreadHost::Type::UI, ".ui");
   }
 
   if (mask & ThreadHost::Type::GPU) {
-    raster_thread = std::make_unique<fml::Thread>(name_prefix + ".raster");
+    raster_thread = make_thread(ThreadHost::Type::GPU, ".raster");
   }
 
   if (mask & ThreadHost::Type::IO) {
-    io_thread = std::make_unique<fml::Thread>(name_prefix + ".io");
+    io_thread = make_thread(ThreadHost::Type::IO, ".io");
   }
 
   if (mask & ThreadHost::Type::Profiler) {
-    profiler_thread = std::make_unique<fml::Thread>(name_prefix + ".profiler");
+    profiler_thread = make_thread(ThreadHost::Type::Profiler, ".profiler");
   }
 }
 
@@ -5,7 +5,9 @@
 #ifndef FLUTTER_SHELL_COMMON_THREAD_HOST_H_
 #define FLUTTER_SHELL_COMMON_THREAD_HOST_H_
 
+#include <map>
 #include <memory>
+#include <string>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/thread.h"
@@ -36,6 +38,17 @@ struct ThreadHost {
 
   ThreadHost(std::string name_prefix, uint64_t type_mask);
 
+  // The priority and core affinity of the threads of the host, by type. The
+  // names in the configs are ignored, threads are named after the prefix of
+  // the host. Threads without a config get a normal priority.
+  using ThreadConfigs = std::map<Type, fml::Thread::ThreadConfig>;
+
+  ThreadHost(std::string name_prefix,
+             uint64_t type_mask,
+             ThreadConfigs configs,
+             fml::Thread::ThreadConfigSetter setter =
+                 fml::Thread::SetCurrentThreadConfig);
+
   ~ThreadHost();
 
   void Reset();
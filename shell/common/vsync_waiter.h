@@ -36,6 +36,11 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   // Return kUnknownRefreshRateFPS if the refresh rate is unknown.
   virtual float GetDisplayRefreshRate() const;
 
+  // Asks the platform to refresh the display at |fps| frames per second, or at
+  // the rate it picks if |fps| is zero. The platform may ignore the request.
+  // Called on the UI thread. Does nothing by default.
+  virtual void SetPreferredFrameRate(float fps);
+
  protected:
   // On some backends, the |FireCallback| needs to be made from a static C
   // method.
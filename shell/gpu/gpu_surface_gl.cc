@@ -6,7 +6,9 @@
 
 #include "flutter/fml/base32.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop.h"
 #include "flutter/fml/size.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
@@ -34,18 +36,7 @@ static const int kGrCacheMaxCount = 8192;
 // system channel.
 static const size_t kGrCacheMaxByteSize = 24 * (1 << 20);
 
-GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate,
-                           bool render_to_surface)
-    : delegate_(delegate),
-      render_to_surface_(render_to_surface),
-      weak_factory_(this) {
-  auto context_switch = delegate_->GLContextMakeCurrent();
-  if (!context_switch->GetResult()) {
-    FML_LOG(ERROR)
-        << "Could not make the context current to setup the gr context.";
-    return;
-  }
-
+sk_sp<GrContext> GPUSurfaceGL::MakeGLContext(GPUSurfaceGLDelegate* delegate) {
   GrContextOptions options;
 
   if (PersistentCache::cache_sksl()) {
@@ -65,29 +56,48 @@ GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate,
   // A similar work-around is also used in shell/common/io_manager.cc.
   options.fDisableGpuYUVConversion = true;
 
-  auto context = GrContext::MakeGL(delegate_->GetGLInterface(), options);
+  auto context = GrContext::MakeGL(delegate->GetGLInterface(), options);
 
   if (context == nullptr) {
     FML_LOG(ERROR) << "Failed to setup Skia Gr context.";
+    return nullptr;
+  }
+
+  context->setResourceCacheLimits(kGrCacheMaxCount, kGrCacheMaxByteSize);
+
+  return context;
+}
+
+GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate,
+                           bool render_to_surface)
+    : delegate_(delegate),
+      render_to_surface_(render_to_surface),
+      weak_factory_(this) {
+  auto context_switch = delegate_->GLContextMakeCurrent();
+  if (!context_switch->GetResult()) {
+    FML_LOG(ERROR)
+        << "Could not make the context current to setup the gr context.";
     return;
   }
 
-  context_ = std::move(context);
+  context_ = MakeGLContext(delegate_);
 
-  context_->setResourceCacheLimits(kGrCacheMaxCount, kGrCacheMaxByteSize);
+  if (context_ == nullptr) {
+    return;
+  }
 
   context_owner_ = true;
 
   valid_ = true;
 
-  std::vector<PersistentCache::SkSLCache> caches =
-      PersistentCache::GetCacheForProcess()->LoadSkSLs();
-  int compiled_count = 0;
-  for (const auto& cache : caches) {
-    compiled_count += context_->precompileShader(*cache.first, *cache.second);
+  pending_sksls_ = PersistentCache::GetCacheForProcess()->LoadSkSLs();
+  PersistentCache::GetCacheForProcess()->StartPrecompilation(
+      pending_sksls_.size());
+  if (PrecompilePendingSkSLs(PersistentCache::precompilation_budget())) {
+    SchedulePendingSkSLs();
   }
-  FML_LOG(INFO) << "Found " << caches.size() << " SkSL shaders; precompiled "
-                << compiled_count;
+
+  CreateTimer();
 
   delegate_->GLContextClearCurrent();
 }
@@ -106,6 +116,8 @@ GPUSurfaceGL::GPUSurfaceGL(sk_sp<GrContext> gr_context,
     return;
   }
 
+  CreateTimer();
+
   delegate_->GLContextClearCurrent();
 
   valid_ = true;
@@ -123,6 +135,7 @@ GPUSurfaceGL::~GPUSurfaceGL() {
     return;
   }
 
+  timer_ = nullptr;
   onscreen_surface_ = nullptr;
   if (context_owner_) {
     context_->releaseResourcesAndAbandonContext();
@@ -137,6 +150,55 @@ bool GPUSurfaceGL::IsValid() {
   return valid_;
 }
 
+bool GPUSurfaceGL::PrecompilePendingSkSLs(fml::TimeDelta budget) {
+  TRACE_EVENT0("flutter", "GPUSurfaceGL::PrecompilePendingSkSLs");
+  PersistentCache* cache = PersistentCache::GetCacheForProcess();
+  const bool bounded = budget > fml::TimeDelta::Zero();
+  const fml::TimePoint deadline = fml::TimePoint::Now() + budget;
+  while (next_sksl_index_ < pending_sksls_.size()) {
+    if (bounded && fml::TimePoint::Now() >= deadline) {
+      return true;
+    }
+    const PersistentCache::SkSLCache& sksl = pending_sksls_[next_sksl_index_];
+    next_sksl_index_++;
+    const bool compiled = context_->precompileShader(*sksl.first, *sksl.second);
+    precompiled_sksl_count_ += compiled ? 1 : 0;
+    cache->DidPrecompile(compiled);
+  }
+  FML_LOG(INFO) << "Found " << pending_sksls_.size()
+                << " SkSL shaders; precompiled " << precompiled_sksl_count_;
+  // The SkSLs aren't needed anymore, so their memory is released.
+  std::vector<PersistentCache::SkSLCache>().swap(pending_sksls_);
+  next_sksl_index_ = 0;
+  return false;
+}
+
+void GPUSurfaceGL::SchedulePendingSkSLs() {
+  fml::MessageLoop::GetCurrent().GetTaskRunner()->PostTask(
+      [weak = weak_factory_.GetWeakPtr()]() {
+        if (!weak) {
+          return;
+        }
+        auto context_switch = weak->delegate_->GLContextMakeCurrent();
+        if (!context_switch->GetResult()) {
+          FML_LOG(ERROR) << "Could not make the context current to precompile "
+                            "SkSL shaders.";
+          return;
+        }
+        if (weak->PrecompilePendingSkSLs(
+                PersistentCache::precompilation_budget())) {
+          weak->SchedulePendingSkSLs();
+        }
+      });
+}
+
+void GPUSurfaceGL::CreateTimer() {
+  auto timer = std::make_unique<GPUSurfaceGLTimer>(delegate_->GetGLInterface());
+  if (timer->IsValid()) {
+    timer_ = std::move(timer);
+  }
+}
+
 static SkColorType FirstSupportedColorType(GrContext* context,
                                            GrGLenum* format) {
 #define RETURN_IF_RENDERABLE(x, y)                 \
@@ -257,28 +319,48 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
   }
 
   surface->getCanvas()->setMatrix(root_surface_transformation);
+
+  if (timer_) {
+    timer_->BeginFrame();
+  }
+
   SurfaceFrame::SubmitCallback submit_callback =
       [weak = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) {
-        return weak ? weak->PresentSurface(canvas) : false;
+        return weak ? weak->PresentSurface(canvas, surface_frame.damage())
+                    : false;
       };
 
-  return std::make_unique<SurfaceFrame>(
+  auto frame = std::make_unique<SurfaceFrame>(
       surface, delegate_->SurfaceSupportsReadback(), submit_callback,
       std::move(context_switch));
+  frame->set_buffer_age(delegate_->GLContextFBOBufferAge());
+  return frame;
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas,
+                                  const std::optional<SkIRect>& damage) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
     return false;
   }
 
+  const SkIRect frame_damage = damage.value_or(
+      SkIRect::MakeWH(onscreen_surface_->width(), onscreen_surface_->height()));
+
+  // Skia defers rendering to the window framebuffer until the flush, so the
+  // damage region can still be set here.
+  delegate_->GLContextSetDamageRegion(frame_damage);
+
   {
     TRACE_EVENT0("flutter", "SkCanvas::Flush");
     onscreen_surface_->getCanvas()->flush();
   }
 
-  if (!delegate_->GLContextPresent()) {
+  if (timer_) {
+    timer_->EndFrame();
+  }
+
+  if (!delegate_->GLContextPresentWithDamage(frame_damage)) {
     return false;
   }
 
@@ -335,4 +417,9 @@ std::unique_ptr<GLContextResult> GPUSurfaceGL::MakeRenderContextCurrent() {
   return delegate_->GLContextMakeCurrent();
 }
 
+// |Surface|
+std::optional<fml::TimeDelta> GPUSurfaceGL::TakeGpuFrameTime() {
+  return timer_ ? timer_->TakeFrameTime() : std::nullopt;
+}
+
 }  // namespace flutter
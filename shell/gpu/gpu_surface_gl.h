@@ -7,13 +7,18 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/gl_context_switch.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/shell/gpu/gpu_surface_gl_delegate.h"
+#include "flutter/shell/common/persistent_cache.h"
+#include "flutter/shell/gpu/gpu_surface_gl_timer.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
 namespace flutter {
@@ -22,6 +27,10 @@ class GPUSurfaceGL : public Surface {
  public:
   GPUSurfaceGL(GPUSurfaceGLDelegate* delegate, bool render_to_surface);
 
+  // Creates a GrContext for the GL context of |delegate|, which must be
+  // current, set up like the ones the surfaces create for themselves.
+  static sk_sp<GrContext> MakeGLContext(GPUSurfaceGLDelegate* delegate);
+
   // Creates a new GL surface reusing an existing GrContext.
   GPUSurfaceGL(sk_sp<GrContext> gr_context,
                GPUSurfaceGLDelegate* delegate,
@@ -48,6 +57,9 @@ class GPUSurfaceGL : public Surface {
   // |Surface|
   std::unique_ptr<GLContextResult> MakeRenderContextCurrent() override;
 
+  // |Surface|
+  std::optional<fml::TimeDelta> TakeGpuFrameTime() override;
+
  private:
   GPUSurfaceGLDelegate* delegate_;
   sk_sp<GrContext> context_;
@@ -59,15 +71,32 @@ class GPUSurfaceGL : public Surface {
   // external view embedder is present.
   const bool render_to_surface_;
   bool valid_ = false;
+  // Null when the GL implementation doesn't support timer queries.
+  std::unique_ptr<GPUSurfaceGLTimer> timer_;
+  // The SkSLs loaded from the persistent cache that are left to precompile
+  // from |next_sksl_index_| on.
+  std::vector<PersistentCache::SkSLCache> pending_sksls_;
+  size_t next_sksl_index_ = 0;
+  size_t precompiled_sksl_count_ = 0;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceGL> weak_factory_;
 
+  void CreateTimer();
+
+  // Precompiles the pending SkSLs, in the order they were loaded, with the
+  // context current. Stops once |budget| has passed, unless it is zero.
+  // Returns whether any are left.
+  bool PrecompilePendingSkSLs(fml::TimeDelta budget);
+
+  // Continues precompiling the pending SkSLs in a later task of this thread.
+  void SchedulePendingSkSLs();
+
   bool CreateOrUpdateSurfaces(const SkISize& size);
 
   sk_sp<SkSurface> AcquireRenderSurface(
       const SkISize& untransformed_size,
       const SkMatrix& root_surface_transformation);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(SkCanvas* canvas, const std::optional<SkIRect>& damage);
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
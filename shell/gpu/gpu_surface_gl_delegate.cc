@@ -10,6 +10,16 @@ namespace flutter {
 
 GPUSurfaceGLDelegate::~GPUSurfaceGLDelegate() = default;
 
+bool GPUSurfaceGLDelegate::GLContextPresentWithDamage(const SkIRect& damage) {
+  return GLContextPresent();
+}
+
+void GPUSurfaceGLDelegate::GLContextSetDamageRegion(const SkIRect& damage) {}
+
+int GPUSurfaceGLDelegate::GLContextFBOBufferAge() const {
+  return 0;
+}
+
 bool GPUSurfaceGLDelegate::GLContextFBOResetAfterPresent() const {
   return false;
 }
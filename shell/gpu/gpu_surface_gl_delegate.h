@@ -10,6 +10,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_delegate.h"
 #include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 
 namespace flutter {
@@ -32,6 +33,24 @@ class GPUSurfaceGLDelegate : public GPUSurfaceDelegate {
   // context and not any of the contexts dedicated for IO.
   virtual bool GLContextPresent() = 0;
 
+  // Called to present the main GL surface when only |damage| was repainted
+  // since the buffer was last presented. Delegates that can't present part of
+  // the surface present all of it with GLContextPresent().
+  virtual bool GLContextPresentWithDamage(const SkIRect& damage);
+
+  // Called before the frame is flushed to the main GL surface with the region
+  // that will be repainted, so that delegates supporting
+  // EGL_KHR_partial_update can let the driver skip loading and storing the
+  // rest of the buffer. Only called after GLContextFBOBufferAge() for the
+  // frame.
+  virtual void GLContextSetDamageRegion(const SkIRect& damage);
+
+  // The age of the buffer backing the main window bound framebuffer, as
+  // reported by EGL_EXT_buffer_age: the number of frames since it was last
+  // presented, or 0 if its contents are undefined. The rasterizer only
+  // repaints the parts of a buffer with persistent contents that changed.
+  virtual int GLContextFBOBufferAge() const;
+
   // The ID of the main window bound framebuffer. Typically FBO0.
   virtual intptr_t GLContextFBO() const = 0;
 
@@ -0,0 +1,139 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_gl_timer.h"
+
+// See the note in gpu_surface_gl.cc on why these are defined here.
+#define GPU_GL_TIME_ELAPSED 0x88BF
+#define GPU_GL_QUERY_RESULT 0x8866
+#define GPU_GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GPU_GL_GPU_DISJOINT 0x8FBB
+
+namespace flutter {
+
+GPUSurfaceGLTimer::GPUSurfaceGLTimer(sk_sp<const GrGLInterface> gl_interface)
+    : gl_(std::move(gl_interface)) {
+  if (!gl_) {
+    return;
+  }
+
+  const auto& functions = gl_->fFunctions;
+  if (!functions.fGenQueries || !functions.fDeleteQueries ||
+      !functions.fBeginQuery || !functions.fEndQuery ||
+      !functions.fGetQueryObjectiv || !functions.fGetQueryObjectui64v) {
+    return;
+  }
+
+  if (gl_->fStandard == kGL_GrGLStandard) {
+    // Timer queries are core since OpenGL 3.3 and the 64 bit query results
+    // are only resolved when they are supported.
+    valid_ = true;
+  } else if (gl_->hasExtension("GL_EXT_disjoint_timer_query")) {
+    // Results measured while the GPU was disjoint, e.g. because its clock
+    // changed, are meaningless.
+    if (!functions.fGetIntegerv) {
+      return;
+    }
+    valid_ = true;
+    check_disjoint_ = true;
+  }
+}
+
+GPUSurfaceGLTimer::~GPUSurfaceGLTimer() {
+  if (!valid_) {
+    return;
+  }
+  if (active_query_ != 0) {
+    gl_->fFunctions.fEndQuery(GPU_GL_TIME_ELAPSED);
+    free_queries_.push_back(active_query_);
+  }
+  free_queries_.insert(free_queries_.end(), pending_queries_.begin(),
+                       pending_queries_.end());
+  if (!free_queries_.empty()) {
+    gl_->fFunctions.fDeleteQueries(static_cast<GrGLsizei>(free_queries_.size()),
+                                   free_queries_.data());
+  }
+}
+
+void GPUSurfaceGLTimer::BeginFrame() {
+  if (!valid_) {
+    return;
+  }
+
+  const auto& functions = gl_->fFunctions;
+  if (active_query_ != 0) {
+    functions.fEndQuery(GPU_GL_TIME_ELAPSED);
+    free_queries_.push_back(active_query_);
+    active_query_ = 0;
+  }
+
+  if (pending_queries_.size() >= kMaxPendingQueries) {
+    return;
+  }
+
+  if (free_queries_.empty()) {
+    GrGLuint query = 0;
+    functions.fGenQueries(1, &query);
+    if (query == 0) {
+      return;
+    }
+    free_queries_.push_back(query);
+  }
+  active_query_ = free_queries_.back();
+  free_queries_.pop_back();
+  functions.fBeginQuery(GPU_GL_TIME_ELAPSED, active_query_);
+}
+
+void GPUSurfaceGLTimer::EndFrame() {
+  if (!valid_) {
+    return;
+  }
+
+  if (active_query_ != 0) {
+    gl_->fFunctions.fEndQuery(GPU_GL_TIME_ELAPSED);
+    pending_queries_.push_back(active_query_);
+    active_query_ = 0;
+  }
+  CollectResults();
+}
+
+std::optional<fml::TimeDelta> GPUSurfaceGLTimer::TakeFrameTime() {
+  auto frame_time = completed_frame_time_;
+  completed_frame_time_ = std::nullopt;
+  return frame_time;
+}
+
+void GPUSurfaceGLTimer::CollectResults() {
+  const auto& functions = gl_->fFunctions;
+  std::optional<fml::TimeDelta> frame_time;
+  // Queries complete in the order they were issued.
+  while (!pending_queries_.empty()) {
+    GrGLuint query = pending_queries_.front();
+    GrGLint available = 0;
+    functions.fGetQueryObjectiv(query, GPU_GL_QUERY_RESULT_AVAILABLE,
+                                &available);
+    if (!available) {
+      break;
+    }
+    GrGLuint64 elapsed_nanoseconds = 0;
+    functions.fGetQueryObjectui64v(query, GPU_GL_QUERY_RESULT,
+                                   &elapsed_nanoseconds);
+    frame_time = fml::TimeDelta::FromNanoseconds(elapsed_nanoseconds);
+    pending_queries_.pop_front();
+    free_queries_.push_back(query);
+  }
+
+  if (check_disjoint_) {
+    GrGLint disjoint = 0;
+    functions.fGetIntegerv(GPU_GL_GPU_DISJOINT, &disjoint);
+    if (disjoint) {
+      return;
+    }
+  }
+  if (frame_time) {
+    completed_frame_time_ = frame_time;
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,67 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_GPU_GPU_SURFACE_GL_TIMER_H_
+#define SHELL_GPU_GPU_SURFACE_GL_TIMER_H_
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/gpu/gl/GrGLInterface.h"
+
+namespace flutter {
+
+// Measures the time the GPU spends on the frames of a GPUSurfaceGL with
+// GL_TIME_ELAPSED timer queries, where EXT_disjoint_timer_query (OpenGL ES) or
+// ARB_timer_query (OpenGL) is available.
+//
+// A query brackets the GL commands issued for each frame. Results are polled
+// without stalling the pipeline, so the time of a frame becomes available a
+// few frames after it was submitted. All methods, including the destructor,
+// must be called with the GL context the timer was created for current.
+class GPUSurfaceGLTimer {
+ public:
+  explicit GPUSurfaceGLTimer(sk_sp<const GrGLInterface> gl_interface);
+
+  ~GPUSurfaceGLTimer();
+
+  // Whether the GL implementation supports timer queries.
+  bool IsValid() const { return valid_; }
+
+  // Starts timing the GL commands of a new frame. A frame that was begun but
+  // never ended is discarded.
+  void BeginFrame();
+
+  // Stops timing the current frame and collects the results of the frames
+  // that have completed on the GPU since.
+  void EndFrame();
+
+  // Returns the time of the most recently completed frame collected since the
+  // last call, if any.
+  std::optional<fml::TimeDelta> TakeFrameTime();
+
+ private:
+  // Frames are no longer timed while this many queries await their results,
+  // which bounds the number of query objects when the GPU falls behind.
+  static constexpr size_t kMaxPendingQueries = 4;
+
+  sk_sp<const GrGLInterface> gl_;
+  bool valid_ = false;
+  bool check_disjoint_ = false;
+  GrGLuint active_query_ = 0;
+  std::deque<GrGLuint> pending_queries_;
+  std::vector<GrGLuint> free_queries_;
+  std::optional<fml::TimeDelta> completed_frame_time_;
+
+  void CollectResults();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGLTimer);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_GPU_GPU_SURFACE_GL_TIMER_H_
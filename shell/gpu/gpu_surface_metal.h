@@ -7,18 +7,39 @@
 
 #include <Metal/Metal.h>
 
+#include <memory>
+
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/platform/darwin/scoped_nsobject.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/shell/gpu/gpu_surface_delegate.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
 @class CAMetalLayer;
+@protocol CAMetalDrawable;
 
 namespace flutter {
 
+// Renders into the drawables of a |CAMetalLayer|.
+//
+// The layer hands out at most |kMaxDrawableCount| drawables, and acquiring
+// one blocks until one is no longer in use. Rather than blocking the raster
+// thread on that, the next drawable is acquired on a thread of its own as
+// soon as a frame is presented, and |AcquireFrame| waits for it no longer than
+// |kDrawableAcquireTimeout|. A frame that times out is deferred, and drawn
+// with the drawable once it has been acquired.
 class GPUSurfaceMetal : public Surface {
  public:
+  // Triple buffering, so that a frame can be rendered while one is waiting to
+  // be displayed and another is on screen.
+  static constexpr NSUInteger kMaxDrawableCount = 3;
+
+  // About half a frame at 60Hz.
+  static constexpr fml::TimeDelta kDrawableAcquireTimeout =
+      fml::TimeDelta::FromMilliseconds(8);
+
   GPUSurfaceMetal(GPUSurfaceDelegate* delegate,
                   fml::scoped_nsobject<CAMetalLayer> layer,
                   sk_sp<GrContext> context,
@@ -28,11 +49,19 @@ class GPUSurfaceMetal : public Surface {
   ~GPUSurfaceMetal() override;
 
  private:
+  struct DrawableRequest;
+
   GPUSurfaceDelegate* delegate_;
   fml::scoped_nsobject<CAMetalLayer> layer_;
   sk_sp<GrContext> context_;
   fml::scoped_nsprotocol<id<MTLCommandQueue>> command_queue_;
-  GrMTLHandle next_drawable_ = nullptr;
+  bool presents_with_transaction_ = false;
+  bool deferred_last_frame_ = false;
+  // The acquisition of the drawable of the next frame, if one was started.
+  std::shared_ptr<DrawableRequest> next_drawable_;
+  // Acquires the drawables. Declared last so that it is joined before the
+  // rest of the surface is collected.
+  fml::Thread drawable_thread_;
 
   // |Surface|
   bool IsValid() override;
@@ -52,7 +81,17 @@ class GPUSurfaceMetal : public Surface {
   // |Surface|
   std::unique_ptr<GLContextResult> MakeRenderContextCurrent() override;
 
-  void ReleaseUnusedDrawableIfNecessary();
+  // |Surface|
+  bool DeferredLastFrame() const override;
+
+  // Starts acquiring the drawable of the next frame on |drawable_thread_|.
+  void RequestNextDrawable();
+
+  // Waits for the drawable requested for the next frame, for no longer than
+  // |kDrawableAcquireTimeout|. Returns null if it is not ready in time, or if
+  // the layer did not hand one out.
+  fml::scoped_nsprotocol<id<CAMetalDrawable>> WaitForNextDrawable(
+      bool* timed_out);
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceMetal);
 };
@@ -6,15 +6,24 @@
 
 #include <QuartzCore/CAMetalLayer.h>
 
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/mtl/GrMtlTypes.h"
 #include "third_party/skia/include/ports/SkCFObject.h"
 
 static_assert(!__has_feature(objc_arc), "ARC must be disabled.");
 
 namespace flutter {
 
+struct GPUSurfaceMetal::DrawableRequest {
+  fml::ManualResetWaitableEvent acquired;
+  // Only read once |acquired| is signaled.
+  fml::scoped_nsprotocol<id<CAMetalDrawable>> drawable;
+};
+
 GPUSurfaceMetal::GPUSurfaceMetal(GPUSurfaceDelegate* delegate,
                                  fml::scoped_nsobject<CAMetalLayer> layer,
                                  sk_sp<GrContext> context,
@@ -22,16 +31,24 @@ GPUSurfaceMetal::GPUSurfaceMetal(GPUSurfaceDelegate* delegate,
     : delegate_(delegate),
       layer_(std::move(layer)),
       context_(std::move(context)),
-      command_queue_(std::move(command_queue)) {
+      command_queue_(std::move(command_queue)),
+      drawable_thread_(fml::Thread::ThreadConfig{"io.flutter.drawable",
+                                                 fml::Thread::ThreadPriority::kDisplay}) {
   layer_.get().pixelFormat = MTLPixelFormatBGRA8Unorm;
   // Flutter needs to read from the color attachment in cases where there are effects such as
   // backdrop filters.
   layer_.get().framebufferOnly = NO;
+  if (@available(iOS 11.2, macOS 10.13.2, *)) {
+    layer_.get().maximumDrawableCount = kMaxDrawableCount;
+  }
+  if (@available(iOS 11.0, macOS 10.13, *)) {
+    // Bounds the wait of the drawable thread on a layer that is not being displayed.
+    layer_.get().allowsNextDrawableTimeout = YES;
+  }
+  presents_with_transaction_ = layer_.get().presentsWithTransaction;
 }
 
-GPUSurfaceMetal::~GPUSurfaceMetal() {
-  ReleaseUnusedDrawableIfNecessary();
-}
+GPUSurfaceMetal::~GPUSurfaceMetal() = default;
 
 // |Surface|
 bool GPUSurfaceMetal::IsValid() {
@@ -40,6 +57,8 @@ bool GPUSurfaceMetal::IsValid() {
 
 // |Surface|
 std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& frame_size) {
+  deferred_last_frame_ = false;
+
   if (!IsValid()) {
     FML_LOG(ERROR) << "Metal surface was invalid.";
     return nullptr;
@@ -53,24 +72,57 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& frame
   const auto drawable_size = CGSizeMake(frame_size.width(), frame_size.height());
 
   if (!CGSizeEqualToSize(drawable_size, layer_.get().drawableSize)) {
+    // A drawable that is being acquired may be of the old size.
+    next_drawable_.reset();
     layer_.get().drawableSize = drawable_size;
   }
 
-  ReleaseUnusedDrawableIfNecessary();
-
   // When there are platform views in the scene, the drawable needs to be presented in the same
   // transaction as the one created for platform views. When the drawable are being presented from
-  // the raster thread, there is no such transaction.
-  layer_.get().presentsWithTransaction = [[NSThread currentThread] isMainThread];
-
-  auto surface = SkSurface::MakeFromCAMetalLayer(context_.get(),            // context
-                                                 layer_.get(),              // layer
-                                                 kTopLeft_GrSurfaceOrigin,  // origin
-                                                 1,                         // sample count
-                                                 kBGRA_8888_SkColorType,    // color type
-                                                 nullptr,                   // colorspace
-                                                 nullptr,                   // surface properties
-                                                 &next_drawable_  // drawable (transfer out)
+  // the raster thread, there is no such transaction. The layer is only updated when this changes,
+  // which is when the raster thread is merged with or unmerged from the main thread.
+  const bool presents_with_transaction = [[NSThread currentThread] isMainThread];
+  if (presents_with_transaction != presents_with_transaction_) {
+    presents_with_transaction_ = presents_with_transaction;
+    layer_.get().presentsWithTransaction = presents_with_transaction;
+  }
+
+  bool timed_out = false;
+  auto drawable = WaitForNextDrawable(&timed_out);
+  if (drawable && (drawable.get().texture.width != static_cast<NSUInteger>(frame_size.width()) ||
+                   drawable.get().texture.height != static_cast<NSUInteger>(frame_size.height()))) {
+    // The size of the layer changed while the drawable was being acquired.
+    drawable.reset();
+    drawable = WaitForNextDrawable(&timed_out);
+  }
+
+  if (timed_out) {
+    // The acquisition goes on, and the frame is drawn again once it may be done.
+    TRACE_EVENT_INSTANT0("flutter", "GPUSurfaceMetal::DeferFrame");
+    deferred_last_frame_ = true;
+    return nullptr;
+  }
+
+  if (!drawable) {
+    FML_LOG(ERROR) << "Could not acquire the next Metal drawable.";
+    return nullptr;
+  }
+
+  GrMtlTextureInfo texture_info;
+  texture_info.fTexture =
+      sk_cf_obj<const void*>{[reinterpret_cast<NSObject*>(drawable.get().texture) retain]};
+  GrBackendRenderTarget render_target(frame_size.width(),   // width
+                                      frame_size.height(),  // height
+                                      1,                    // sample count
+                                      texture_info          // texture info
+  );
+
+  auto surface = SkSurface::MakeFromBackendRenderTarget(context_.get(),            // context
+                                                        render_target,             // render target
+                                                        kTopLeft_GrSurfaceOrigin,  // origin
+                                                        kBGRA_8888_SkColorType,    // color type
+                                                        nullptr,                   // colorspace
+                                                        nullptr  // surface properties
   );
 
   if (!surface) {
@@ -78,7 +130,8 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& frame
     return nullptr;
   }
 
-  auto submit_callback = [this](const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
+  auto submit_callback = [this, drawable](const SurfaceFrame& surface_frame,
+                                          SkCanvas* canvas) -> bool {
     TRACE_EVENT0("flutter", "GPUSurfaceMetal::Submit");
     if (canvas == nullptr) {
       FML_DLOG(ERROR) << "Canvas not available.";
@@ -87,22 +140,16 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& frame
 
     canvas->flush();
 
-    if (next_drawable_ == nullptr) {
-      FML_DLOG(ERROR) << "Could not acquire next Metal drawable from the SkSurface.";
-      return false;
-    }
-
     auto command_buffer =
         fml::scoped_nsprotocol<id<MTLCommandBuffer>>([[command_queue_.get() commandBuffer] retain]);
 
-    fml::scoped_nsprotocol<id<CAMetalDrawable>> drawable(
-        reinterpret_cast<id<CAMetalDrawable>>(next_drawable_));
-    next_drawable_ = nullptr;
-
     [command_buffer.get() commit];
     [command_buffer.get() waitUntilScheduled];
     [drawable.get() present];
 
+    // Overlap the wait for the drawable of the next frame with the build of that frame.
+    RequestNextDrawable();
+
     return true;
   };
 
@@ -132,16 +179,45 @@ std::unique_ptr<GLContextResult> GPUSurfaceMetal::MakeRenderContextCurrent() {
   return std::make_unique<GLContextDefaultResult>(true);
 }
 
-void GPUSurfaceMetal::ReleaseUnusedDrawableIfNecessary() {
-  // If the previous surface frame was not submitted before  a new one is acquired, the old drawable
-  // needs to be released. An RAII wrapper may not be used because this needs to interoperate with
-  // Skia APIs.
-  if (next_drawable_ == nullptr) {
+// |Surface|
+bool GPUSurfaceMetal::DeferredLastFrame() const {
+  return deferred_last_frame_;
+}
+
+void GPUSurfaceMetal::RequestNextDrawable() {
+  if (next_drawable_) {
     return;
   }
+  auto request = std::make_shared<DrawableRequest>();
+  next_drawable_ = request;
+  drawable_thread_.GetTaskRunner()->PostTask([layer = layer_, request]() {
+    TRACE_EVENT0("flutter", "GPUSurfaceMetal::NextDrawable");
+    @autoreleasepool {
+      request->drawable.reset([[layer.get() nextDrawable] retain]);
+    }
+    request->acquired.Signal();
+  });
+}
+
+fml::scoped_nsprotocol<id<CAMetalDrawable>> GPUSurfaceMetal::WaitForNextDrawable(
+    bool* timed_out) {
+  RequestNextDrawable();
+
+  const auto wait_start = fml::TimePoint::Now();
+  {
+    TRACE_EVENT0("flutter", "GPUSurfaceMetal::WaitForNextDrawable");
+    *timed_out = next_drawable_->acquired.WaitWithTimeout(kDrawableAcquireTimeout);
+  }
+  const auto wait_time = fml::TimePoint::Now() - wait_start;
+  FML_TRACE_COUNTER("flutter", "GPUSurfaceMetal", reinterpret_cast<int64_t>(this),  //
+                    "DrawableWaitMicros", wait_time.ToMicroseconds()                //
+  );
 
-  CFRelease(next_drawable_);
-  next_drawable_ = nullptr;
+  if (*timed_out) {
+    return {};
+  }
+  auto request = std::move(next_drawable_);
+  return request->drawable;
 }
 
 }  // namespace flutter
@@ -66,10 +66,15 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    auto surface = surface_frame.SkiaSurface();
+    const auto damage = surface_frame.damage().value_or(
+        SkIRect::MakeWH(surface->width(), surface->height()));
+    return self->delegate_->PresentBackingStoreWithDamage(surface, damage);
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  frame->set_buffer_age(delegate_->GetBackingStoreAge());
+  return frame;
 }
 
 // |Surface|
@@ -12,4 +12,14 @@ ExternalViewEmbedder* GPUSurfaceSoftwareDelegate::GetExternalViewEmbedder() {
   return nullptr;
 }
 
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
+int GPUSurfaceSoftwareDelegate::GetBackingStoreAge() const {
+  return 0;
+}
+
 }  // namespace flutter
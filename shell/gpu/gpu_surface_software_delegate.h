@@ -52,6 +52,32 @@ class GPUSurfaceSoftwareDelegate : public GPUSurfaceDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called by the platform when a frame has been rendered into the
+  ///             backing store, of which only a region was repainted since it
+  ///             was last presented. Delegates that can't present part of the
+  ///             backing store present all of it with |PresentBackingStore|.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  damage         The region of the backing store that was
+  ///                            repainted.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreWithDamage(sk_sp<SkSurface> backing_store,
+                                             const SkIRect& damage);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the age of the backing store last returned by
+  ///             |AcquireBackingStore|. The rasterizer only repaints the parts
+  ///             of a backing store with persistent contents that changed.
+  ///
+  /// @return     The number of frames since the backing store was last
+  ///             presented, or zero if its contents are undefined.
+  ///
+  virtual int GetBackingStoreAge() const;
 };
 
 }  // namespace flutter
@@ -3,15 +3,45 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/gpu/gpu_surface_vulkan.h"
+
 #include "flutter/fml/logging.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/vk/GrVkTypes.h"
 
 namespace flutter {
 
+static SkColorType ColorTypeFromFormat(VkFormat format) {
+  switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+      return kRGBA_8888_SkColorType;
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+      return kBGRA_8888_SkColorType;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+      return kRGBA_F16_SkColorType;
+    default:
+      return kUnknown_SkColorType;
+  }
+}
+
 GPUSurfaceVulkan::GPUSurfaceVulkan(
     GPUSurfaceVulkanDelegate* delegate,
     std::unique_ptr<vulkan::VulkanNativeSurface> native_surface,
-    bool render_to_surface)
-    : window_(delegate->vk(), std::move(native_surface), render_to_surface),
+    bool render_to_surface,
+    const vulkan::VulkanSwapchainConfig& swapchain_config)
+    : window_(std::make_unique<vulkan::VulkanWindow>(delegate->vk(),
+                                                     std::move(native_surface),
+                                                     render_to_surface,
+                                                     swapchain_config)),
+      delegate_(delegate),
+      render_to_surface_(render_to_surface),
+      weak_factory_(this) {}
+
+GPUSurfaceVulkan::GPUSurfaceVulkan(GPUSurfaceVulkanDelegate* delegate,
+                                   sk_sp<GrContext> context,
+                                   bool render_to_surface)
+    : skia_context_(std::move(context)),
       delegate_(delegate),
       render_to_surface_(render_to_surface),
       weak_factory_(this) {}
@@ -19,7 +49,10 @@ GPUSurfaceVulkan::GPUSurfaceVulkan(
 GPUSurfaceVulkan::~GPUSurfaceVulkan() = default;
 
 bool GPUSurfaceVulkan::IsValid() {
-  return window_.IsValid();
+  if (!window_) {
+    return skia_context_ != nullptr;
+  }
+  return window_->IsValid();
 }
 
 std::unique_ptr<SurfaceFrame> GPUSurfaceVulkan::AcquireFrame(
@@ -33,7 +66,11 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkan::AcquireFrame(
         });
   }
 
-  auto surface = window_.AcquireSurface();
+  if (!window_) {
+    return AcquireDelegateFrame(size);
+  }
+
+  auto surface = window_->AcquireSurface();
 
   if (surface == nullptr) {
     return nullptr;
@@ -48,7 +85,61 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceVulkan::AcquireFrame(
     if (canvas == nullptr || !weak_this) {
       return false;
     }
-    return weak_this->window_.SwapBuffers();
+    return weak_this->window_->SwapBuffers();
+  };
+  return std::make_unique<SurfaceFrame>(std::move(surface), true,
+                                        std::move(callback));
+}
+
+std::unique_ptr<SurfaceFrame> GPUSurfaceVulkan::AcquireDelegateFrame(
+    const SkISize& size) {
+  auto image = delegate_->AcquireImage(size);
+  if (image.image == VK_NULL_HANDLE) {
+    FML_LOG(ERROR) << "Could not acquire an image to render into.";
+    return nullptr;
+  }
+
+  const auto color_type = ColorTypeFromFormat(image.format);
+  if (color_type == kUnknown_SkColorType) {
+    FML_LOG(ERROR) << "Unsupported format of image to render into: "
+                   << image.format;
+    return nullptr;
+  }
+
+  // The whole image is rendered, so its previous contents are not needed.
+  const GrVkImageInfo image_info = {
+      image.image,                // image
+      GrVkAlloc(),                // alloc
+      VK_IMAGE_TILING_OPTIMAL,    // tiling
+      VK_IMAGE_LAYOUT_UNDEFINED,  // layout
+      image.format,               // format
+      1,                          // level count
+  };
+  GrBackendRenderTarget backend_render_target(size.width(), size.height(), 0,
+                                              image_info);
+  SkSurfaceProps props(SkSurfaceProps::InitType::kLegacyFontHost_InitType);
+
+  auto surface = SkSurface::MakeFromBackendRenderTarget(
+      skia_context_.get(),       // context
+      backend_render_target,     // backend render target
+      kTopLeft_GrSurfaceOrigin,  // origin
+      color_type,                // color type
+      SkColorSpace::MakeSRGB(),  // color space
+      &props                     // surface properties
+  );
+  if (surface == nullptr) {
+    FML_LOG(ERROR) << "Could not wrap the image to render into.";
+    return nullptr;
+  }
+
+  SurfaceFrame::SubmitCallback callback =
+      [weak_this = weak_factory_.GetWeakPtr(), image](
+          const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
+    if (canvas == nullptr || !weak_this) {
+      return false;
+    }
+    surface_frame.SkiaSurface()->flushAndSubmit();
+    return weak_this->delegate_->PresentImage(image);
   };
   return std::make_unique<SurfaceFrame>(std::move(surface), true,
                                         std::move(callback));
@@ -63,11 +154,22 @@ SkMatrix GPUSurfaceVulkan::GetRootTransformation() const {
 }
 
 GrContext* GPUSurfaceVulkan::GetContext() {
-  return window_.GetSkiaGrContext();
+  if (!window_) {
+    return skia_context_.get();
+  }
+  return window_->GetSkiaGrContext();
 }
 
 flutter::ExternalViewEmbedder* GPUSurfaceVulkan::GetExternalViewEmbedder() {
   return delegate_->GetExternalViewEmbedder();
 }
 
+// |Surface|
+std::optional<fml::TimeDelta> GPUSurfaceVulkan::TakeGpuFrameTime() {
+  if (!window_) {
+    return std::nullopt;
+  }
+  return window_->TakeGpuFrameTime();
+}
+
 }  // namespace flutter
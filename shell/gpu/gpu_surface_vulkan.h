@@ -20,6 +20,13 @@ class GPUSurfaceVulkan : public Surface {
  public:
   GPUSurfaceVulkan(GPUSurfaceVulkanDelegate* delegate,
                    std::unique_ptr<vulkan::VulkanNativeSurface> native_surface,
+                   bool render_to_surface,
+                   const vulkan::VulkanSwapchainConfig& swapchain_config = {});
+
+  // Creates a surface that renders into the images acquired from the delegate
+  // with |context|, instead of into a swapchain for a native surface.
+  GPUSurfaceVulkan(GPUSurfaceVulkanDelegate* delegate,
+                   sk_sp<GrContext> context,
                    bool render_to_surface);
 
   ~GPUSurfaceVulkan() override;
@@ -39,13 +46,20 @@ class GPUSurfaceVulkan : public Surface {
   // |Surface|
   flutter::ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
+  // |Surface|
+  std::optional<fml::TimeDelta> TakeGpuFrameTime() override;
+
  private:
-  vulkan::VulkanWindow window_;
+  // Null for surfaces that render into the images of the delegate.
+  std::unique_ptr<vulkan::VulkanWindow> window_;
+  sk_sp<GrContext> skia_context_;
   GPUSurfaceVulkanDelegate* delegate_;
   const bool render_to_surface_;
 
   fml::WeakPtrFactory<GPUSurfaceVulkan> weak_factory_;
 
+  std::unique_ptr<SurfaceFrame> AcquireDelegateFrame(const SkISize& size);
+
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceVulkan);
 };
 
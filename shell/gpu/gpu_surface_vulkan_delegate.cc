@@ -12,4 +12,13 @@ ExternalViewEmbedder* GPUSurfaceVulkanDelegate::GetExternalViewEmbedder() {
   return nullptr;
 }
 
+GPUSurfaceVulkanDelegate::Image GPUSurfaceVulkanDelegate::AcquireImage(
+    const SkISize& size) {
+  return {};
+}
+
+bool GPUSurfaceVulkanDelegate::PresentImage(const Image& image) {
+  return false;
+}
+
 }  // namespace flutter
@@ -8,6 +8,7 @@
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/shell/gpu/gpu_surface_delegate.h"
 #include "flutter/vulkan/vulkan_proc_table.h"
+#include "third_party/skia/include/core/SkSize.h"
 
 namespace flutter {
 
@@ -20,6 +21,19 @@ class GPUSurfaceVulkanDelegate : public GPUSurfaceDelegate {
 
   // Obtain a reference to the Vulkan implementation's proc table.
   virtual fml::RefPtr<vulkan::VulkanProcTable> vk() = 0;
+
+  struct Image {
+    VkImage image = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+  };
+
+  // Obtain the image to render the next frame into, for surfaces that render
+  // into images supplied by the delegate instead of a swapchain of their own.
+  virtual Image AcquireImage(const SkISize& size);
+
+  // Present an image obtained from |AcquireImage| once all the work of
+  // rendering into it has been submitted.
+  virtual bool PresentImage(const Image& image);
 };
 
 }  // namespace flutter
@@ -189,6 +189,15 @@ AndroidContextGL::AndroidContextGL(
 }
 
 AndroidContextGL::~AndroidContextGL() {
+  worker_resource_surfaces_.clear();
+  for (EGLContext context : worker_resource_contexts_) {
+    if (!TeardownContext(environment_->Display(), context)) {
+      FML_LOG(ERROR) << "Could not tear down an EGL worker resource context. "
+                        "Possible resource leak.";
+      LogLastEGLError();
+    }
+  }
+
   if (!TeardownContext(environment_->Display(), context_)) {
     FML_LOG(ERROR)
         << "Could not tear down the EGL context. Possible resource leak.";
@@ -235,6 +244,45 @@ bool AndroidContextGL::IsValid() const {
   return valid_;
 }
 
+bool AndroidContextGL::MakeWorkerResourceContextCurrent() {
+  if (!valid_) {
+    return false;
+  }
+  EGLDisplay display = environment_->Display();
+
+  bool success = false;
+  EGLContext context = EGL_NO_CONTEXT;
+  std::tie(success, context) = CreateContext(display, config_, context_);
+  if (!success) {
+    FML_LOG(ERROR) << "Could not create an EGL worker resource context";
+    LogLastEGLError();
+    return false;
+  }
+  std::scoped_lock lock(worker_resource_mutex_);
+  worker_resource_contexts_.push_back(context);
+
+  const EGLint attribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+  EGLSurface surface = eglCreatePbufferSurface(display, config_, attribs);
+  if (surface == EGL_NO_SURFACE) {
+    FML_LOG(ERROR) << "Could not create an EGL worker resource surface";
+    LogLastEGLError();
+    return false;
+  }
+  worker_resource_surfaces_.push_back(
+      std::make_unique<AndroidEGLSurface>(surface, display, context));
+  return worker_resource_surfaces_.back()->MakeCurrent();
+}
+
+bool AndroidContextGL::ClearWorkerResourceContextCurrent() {
+  if (eglMakeCurrent(environment_->Display(), EGL_NO_SURFACE, EGL_NO_SURFACE,
+                     EGL_NO_CONTEXT) != EGL_TRUE) {
+    FML_LOG(ERROR) << "Could not clear the current context";
+    LogLastEGLError();
+    return false;
+  }
+  return true;
+}
+
 bool AndroidContextGL::ClearCurrent() {
   if (eglGetCurrentContext() != context_) {
     return true;
@@ -5,6 +5,10 @@
 #ifndef FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 #define FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
@@ -111,12 +115,32 @@ class AndroidContextGL : public AndroidContext {
   ///
   bool ClearCurrent();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates another EGL context in the share group of the
+  ///             onscreen context, for a thread that uploads textures besides
+  ///             the IO thread, and makes it current on the calling thread
+  ///             with a 1x1 pbuffer surface. The context is torn down along
+  ///             with this context.
+  ///
+  /// @return     Whether the context was made current.
+  ///
+  bool MakeWorkerResourceContextCurrent();
+
+  //----------------------------------------------------------------------------
+  /// @return     Whether the context current on the calling thread was
+  ///             cleared.
+  ///
+  bool ClearWorkerResourceContextCurrent();
+
  private:
   fml::RefPtr<AndroidEnvironmentGL> environment_;
   EGLConfig config_;
   EGLContext context_;
   EGLContext resource_context_;
   bool valid_ = false;
+  std::mutex worker_resource_mutex_;
+  std::vector<EGLContext> worker_resource_contexts_;
+  std::vector<std::unique_ptr<AndroidEGLSurface>> worker_resource_surfaces_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(AndroidContextGL);
 };
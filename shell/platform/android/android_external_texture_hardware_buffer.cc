@@ -0,0 +1,422 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/android/android_external_texture_hardware_buffer.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <android/native_window.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/native_library.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+// The NDK only declares the image reader and hardware buffer functions from
+// API 26, and the engine supports older versions, so they are resolved at
+// runtime and the few types used are declared here.
+struct AImageReader;
+struct AImage;
+struct AHardwareBuffer;
+
+namespace flutter {
+
+using MediaStatus = int32_t;
+
+static constexpr MediaStatus kAMediaOk = 0;
+static constexpr int32_t kAImageFormatPrivate = 0x22;
+static constexpr uint64_t kAHardwareBufferUsageGpuSampledImage = 1ull << 8;
+
+// The image that is displayed, the image that is being acquired and the
+// image that is being produced, plus one image that Skia may still be
+// sampling from.
+static constexpr int32_t kMaxImages = 4;
+
+struct ImageCropRect {
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+};
+
+struct ImageListener {
+  void* context;
+  void (*on_image_available)(void* context, AImageReader* reader);
+};
+
+struct AndroidExternalTextureHardwareBuffer::Procs {
+  fml::RefPtr<fml::NativeLibrary> media_library;
+  fml::RefPtr<fml::NativeLibrary> android_library;
+
+  MediaStatus (*AImageReader_newWithUsage)(int32_t width,
+                                           int32_t height,
+                                           int32_t format,
+                                           uint64_t usage,
+                                           int32_t max_images,
+                                           AImageReader** reader) = nullptr;
+  void (*AImageReader_delete)(AImageReader* reader) = nullptr;
+  MediaStatus (*AImageReader_getWindow)(AImageReader* reader,
+                                        ANativeWindow** window) = nullptr;
+  MediaStatus (*AImageReader_setImageListener)(
+      AImageReader* reader,
+      ImageListener* listener) = nullptr;
+  MediaStatus (*AImageReader_acquireLatestImageAsync)(AImageReader* reader,
+                                                      AImage** image,
+                                                      int* fence_fd) = nullptr;
+  void (*AImage_deleteAsync)(AImage* image, int release_fence_fd) = nullptr;
+  MediaStatus (*AImage_getHardwareBuffer)(const AImage* image,
+                                          AHardwareBuffer** buffer) = nullptr;
+  MediaStatus (*AImage_getWidth)(const AImage* image, int32_t* width) = nullptr;
+  MediaStatus (*AImage_getHeight)(const AImage* image,
+                                  int32_t* height) = nullptr;
+  MediaStatus (*AImage_getCropRect)(const AImage* image,
+                                    ImageCropRect* rect) = nullptr;
+  jobject (*ANativeWindow_toSurface)(JNIEnv* env,
+                                     ANativeWindow* window) = nullptr;
+
+  PFNEGLGETNATIVECLIENTBUFFERANDROIDPROC eglGetNativeClientBufferANDROID =
+      nullptr;
+  PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR = nullptr;
+  PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = nullptr;
+  PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES = nullptr;
+
+  // Fences are optional. Without them, the raster thread waits on the CPU for
+  // the producer, and the producer may reuse the buffers of released frames
+  // right away.
+  PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR = nullptr;
+  PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = nullptr;
+  PFNEGLWAITSYNCKHRPROC eglWaitSyncKHR = nullptr;
+  PFNEGLDUPNATIVEFENCEFDANDROIDPROC eglDupNativeFenceFDANDROID = nullptr;
+};
+
+struct AndroidExternalTextureHardwareBuffer::ImageReader {
+  const Procs* procs = nullptr;
+  AImageReader* reader = nullptr;
+  fml::RefPtr<fml::TaskRunner> platform_task_runner;
+  std::function<void()> on_frame_available;
+  ImageListener listener = {};
+
+  ~ImageReader() {
+    if (reader != nullptr) {
+      procs->AImageReader_delete(reader);
+    }
+  }
+
+  static void OnImageAvailable(void* context, AImageReader* reader) {
+    auto image_reader = static_cast<ImageReader*>(context);
+    image_reader->platform_task_runner->PostTask(
+        image_reader->on_frame_available);
+  }
+};
+
+struct AndroidExternalTextureHardwareBuffer::Frame {
+  // Frames may outlive the texture while Skia holds on to their images, and
+  // images must be deleted before their reader.
+  std::shared_ptr<ImageReader> reader;
+  AImage* image = nullptr;
+  EGLDisplay display = EGL_NO_DISPLAY;
+  EGLImageKHR egl_image = EGL_NO_IMAGE_KHR;
+  GLuint texture = 0;
+};
+
+template <typename Proc>
+static bool ResolveSymbol(const fml::RefPtr<fml::NativeLibrary>& library,
+                          const char* name,
+                          Proc* proc) {
+  *proc = reinterpret_cast<Proc>(library->ResolveSymbol(name));
+  return *proc != nullptr;
+}
+
+template <typename Proc>
+static bool ResolveEGLProc(const char* name, Proc* proc) {
+  *proc = reinterpret_cast<Proc>(eglGetProcAddress(name));
+  return *proc != nullptr;
+}
+
+const AndroidExternalTextureHardwareBuffer::Procs*
+AndroidExternalTextureHardwareBuffer::GetProcs() {
+  static const Procs* procs = []() -> const Procs* {
+    auto procs = std::make_unique<Procs>();
+    procs->media_library = fml::NativeLibrary::Create("libmediandk.so");
+    procs->android_library = fml::NativeLibrary::Create("libandroid.so");
+    if (!procs->media_library || !procs->android_library) {
+      return nullptr;
+    }
+    const auto& media = procs->media_library;
+    const bool resolved =
+        ResolveSymbol(media, "AImageReader_newWithUsage",
+                      &procs->AImageReader_newWithUsage) &&
+        ResolveSymbol(media, "AImageReader_delete",
+                      &procs->AImageReader_delete) &&
+        ResolveSymbol(media, "AImageReader_getWindow",
+                      &procs->AImageReader_getWindow) &&
+        ResolveSymbol(media, "AImageReader_setImageListener",
+                      &procs->AImageReader_setImageListener) &&
+        ResolveSymbol(media, "AImageReader_acquireLatestImageAsync",
+                      &procs->AImageReader_acquireLatestImageAsync) &&
+        ResolveSymbol(media, "AImage_deleteAsync",
+                      &procs->AImage_deleteAsync) &&
+        ResolveSymbol(media, "AImage_getHardwareBuffer",
+                      &procs->AImage_getHardwareBuffer) &&
+        ResolveSymbol(media, "AImage_getWidth", &procs->AImage_getWidth) &&
+        ResolveSymbol(media, "AImage_getHeight", &procs->AImage_getHeight) &&
+        ResolveSymbol(media, "AImage_getCropRect",
+                      &procs->AImage_getCropRect) &&
+        ResolveSymbol(procs->android_library, "ANativeWindow_toSurface",
+                      &procs->ANativeWindow_toSurface) &&
+        ResolveEGLProc("eglGetNativeClientBufferANDROID",
+                       &procs->eglGetNativeClientBufferANDROID) &&
+        ResolveEGLProc("eglCreateImageKHR", &procs->eglCreateImageKHR) &&
+        ResolveEGLProc("eglDestroyImageKHR", &procs->eglDestroyImageKHR) &&
+        ResolveEGLProc("glEGLImageTargetTexture2DOES",
+                       &procs->glEGLImageTargetTexture2DOES);
+    if (!resolved) {
+      return nullptr;
+    }
+    ResolveEGLProc("eglCreateSyncKHR", &procs->eglCreateSyncKHR);
+    ResolveEGLProc("eglDestroySyncKHR", &procs->eglDestroySyncKHR);
+    ResolveEGLProc("eglWaitSyncKHR", &procs->eglWaitSyncKHR);
+    ResolveEGLProc("eglDupNativeFenceFDANDROID",
+                   &procs->eglDupNativeFenceFDANDROID);
+    return procs.release();
+  }();
+  return procs;
+}
+
+bool AndroidExternalTextureHardwareBuffer::IsSupported() {
+  return GetProcs() != nullptr;
+}
+
+AndroidExternalTextureHardwareBuffer::AndroidExternalTextureHardwareBuffer(
+    int64_t id,
+    int32_t width,
+    int32_t height,
+    fml::RefPtr<fml::TaskRunner> platform_task_runner,
+    std::function<void()> on_frame_available)
+    : Texture(id), procs_(GetProcs()) {
+  if (procs_ == nullptr) {
+    return;
+  }
+  auto reader = std::make_shared<ImageReader>();
+  reader->procs = procs_;
+  reader->platform_task_runner = std::move(platform_task_runner);
+  reader->on_frame_available = std::move(on_frame_available);
+  if (procs_->AImageReader_newWithUsage(
+          width, height, kAImageFormatPrivate,
+          kAHardwareBufferUsageGpuSampledImage, kMaxImages,
+          &reader->reader) != kAMediaOk) {
+    FML_LOG(ERROR) << "Could not create the image reader of a texture.";
+    return;
+  }
+  reader->listener = {reader.get(), &ImageReader::OnImageAvailable};
+  if (procs_->AImageReader_setImageListener(reader->reader,
+                                            &reader->listener) != kAMediaOk) {
+    FML_LOG(ERROR) << "Could not listen to the image reader of a texture.";
+    return;
+  }
+  reader_ = std::move(reader);
+}
+
+AndroidExternalTextureHardwareBuffer::~AndroidExternalTextureHardwareBuffer() {
+  if (reader_) {
+    // The reader is kept alive by the frames Skia still holds on to, but the
+    // texture is gone.
+    procs_->AImageReader_setImageListener(reader_->reader, nullptr);
+  }
+}
+
+bool AndroidExternalTextureHardwareBuffer::IsValid() const {
+  return reader_ != nullptr;
+}
+
+fml::jni::ScopedJavaLocalRef<jobject>
+AndroidExternalTextureHardwareBuffer::GetSurface(JNIEnv* env) const {
+  ANativeWindow* window = nullptr;
+  if (!IsValid() ||
+      procs_->AImageReader_getWindow(reader_->reader, &window) != kAMediaOk) {
+    return fml::jni::ScopedJavaLocalRef<jobject>();
+  }
+  return fml::jni::ScopedJavaLocalRef<jobject>(
+      env, procs_->ANativeWindow_toSurface(env, window));
+}
+
+// |Texture|
+void AndroidExternalTextureHardwareBuffer::Paint(
+    SkCanvas& canvas,
+    const SkRect& bounds,
+    bool freeze,
+    GrContext* context,
+    SkFilterQuality filter_quality) {
+  if (!IsValid() || context == nullptr) {
+    return;
+  }
+  if (!freeze && new_frame_ready_) {
+    AcquireLatestImage(context);
+    new_frame_ready_ = false;
+  }
+  if (!image_) {
+    return;
+  }
+  SkPaint paint;
+  paint.setFilterQuality(filter_quality);
+  canvas.drawImageRect(image_, crop_rect_, bounds, &paint,
+                       SkCanvas::kFast_SrcRectConstraint);
+}
+
+void AndroidExternalTextureHardwareBuffer::AcquireLatestImage(
+    GrContext* context) {
+  TRACE_EVENT0("flutter", "AndroidExternalTextureHardwareBuffer::Acquire");
+  AImage* image = nullptr;
+  int fence_fd = -1;
+  if (procs_->AImageReader_acquireLatestImageAsync(reader_->reader, &image,
+                                                   &fence_fd) != kAMediaOk ||
+      image == nullptr) {
+    // The previous frame stays displayed.
+    return;
+  }
+
+  AHardwareBuffer* buffer = nullptr;
+  int32_t width = 0;
+  int32_t height = 0;
+  ImageCropRect crop = {};
+  if (procs_->AImage_getHardwareBuffer(image, &buffer) != kAMediaOk ||
+      buffer == nullptr ||
+      procs_->AImage_getWidth(image, &width) != kAMediaOk ||
+      procs_->AImage_getHeight(image, &height) != kAMediaOk ||
+      procs_->AImage_getCropRect(image, &crop) != kAMediaOk) {
+    FML_LOG(ERROR) << "Could not get the hardware buffer of a texture frame.";
+    procs_->AImage_deleteAsync(image, fence_fd);
+    return;
+  }
+
+  EGLDisplay display = eglGetCurrentDisplay();
+  const EGLint image_attributes[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE,
+                                     EGL_NONE};
+  EGLImageKHR egl_image = procs_->eglCreateImageKHR(
+      display, EGL_NO_CONTEXT, EGL_NATIVE_BUFFER_ANDROID,
+      procs_->eglGetNativeClientBufferANDROID(buffer), image_attributes);
+  if (egl_image == EGL_NO_IMAGE_KHR) {
+    FML_LOG(ERROR) << "Could not create an EGL image from a texture frame.";
+    procs_->AImage_deleteAsync(image, fence_fd);
+    return;
+  }
+
+  // Make the GPU wait for the producer to be done with the frame. The sync
+  // takes ownership of the fence once it is created.
+  if (fence_fd >= 0) {
+    EGLSyncKHR sync = EGL_NO_SYNC_KHR;
+    if (procs_->eglCreateSyncKHR != nullptr &&
+        procs_->eglWaitSyncKHR != nullptr &&
+        procs_->eglDestroySyncKHR != nullptr) {
+      const EGLint sync_attributes[] = {EGL_SYNC_NATIVE_FENCE_FD_ANDROID,
+                                        fence_fd, EGL_NONE};
+      sync = procs_->eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID,
+                                      sync_attributes);
+    }
+    if (sync != EGL_NO_SYNC_KHR) {
+      procs_->eglWaitSyncKHR(display, sync, 0);
+      procs_->eglDestroySyncKHR(display, sync);
+    } else {
+      pollfd poll_fd = {fence_fd, POLLIN, 0};
+      int result;
+      do {
+        result = poll(&poll_fd, 1, -1);
+      } while (result < 0 && errno == EINTR);
+      close(fence_fd);
+    }
+  }
+
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_EXTERNAL_OES, texture);
+  glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  procs_->glEGLImageTargetTexture2DOES(GL_TEXTURE_EXTERNAL_OES, egl_image);
+  // Skia tracks the bound texture, which was changed behind its back.
+  context->resetContext(kTextureBinding_GrGLBackendState);
+
+  auto frame = new Frame{reader_, image, display, egl_image, texture};
+
+  GrGLTextureInfo texture_info = {GL_TEXTURE_EXTERNAL_OES, texture,
+                                  GL_RGBA8_OES};
+  GrBackendTexture backend_texture(width, height, GrMipMapped::kNo,
+                                   texture_info);
+  auto sk_image = SkImage::MakeFromTexture(
+      context,                   // context
+      backend_texture,           // texture handle
+      kTopLeft_GrSurfaceOrigin,  // origin
+      kRGBA_8888_SkColorType,    // color type
+      kPremul_SkAlphaType,       // alpha type
+      nullptr,                   // colorspace
+      &ReleaseFrame,             // texture release proc
+      frame                      // texture release context
+  );
+  if (!sk_image) {
+    FML_LOG(ERROR) << "Could not create an image from a texture frame.";
+    ReleaseFrame(frame);
+    return;
+  }
+  image_ = std::move(sk_image);
+  crop_rect_ = SkRect::MakeLTRB(crop.left, crop.top, crop.right, crop.bottom);
+  if (crop_rect_.isEmpty()) {
+    crop_rect_ = SkRect::MakeIWH(width, height);
+  }
+}
+
+void AndroidExternalTextureHardwareBuffer::ReleaseFrame(void* context) {
+  auto frame = static_cast<Frame*>(context);
+  const Procs* procs = frame->reader->procs;
+
+  // Hand the buffer back to the producer along with a fence that signals once
+  // the GPU is done sampling from it.
+  int release_fence_fd = -1;
+  if (procs->eglCreateSyncKHR != nullptr &&
+      procs->eglDestroySyncKHR != nullptr &&
+      procs->eglDupNativeFenceFDANDROID != nullptr) {
+    EGLSyncKHR sync = procs->eglCreateSyncKHR(
+        frame->display, EGL_SYNC_NATIVE_FENCE_ANDROID, nullptr);
+    if (sync != EGL_NO_SYNC_KHR) {
+      // The fence is only created once the commands are flushed.
+      glFlush();
+      release_fence_fd =
+          procs->eglDupNativeFenceFDANDROID(frame->display, sync);
+      procs->eglDestroySyncKHR(frame->display, sync);
+    }
+  }
+
+  glDeleteTextures(1, &frame->texture);
+  procs->eglDestroyImageKHR(frame->display, frame->egl_image);
+  procs->AImage_deleteAsync(frame->image, release_fence_fd);
+  delete frame;
+}
+
+// |Texture|
+void AndroidExternalTextureHardwareBuffer::OnGrContextCreated() {
+  // The frame was released with the previous context, so acquire the next one
+  // on the new context.
+  new_frame_ready_ = true;
+}
+
+// |Texture|
+void AndroidExternalTextureHardwareBuffer::OnGrContextDestroyed() {
+  // Release the frame while its context is still current.
+  image_.reset();
+}
+
+// |Texture|
+void AndroidExternalTextureHardwareBuffer::MarkNewFrameAvailable() {
+  new_frame_ready_ = true;
+}
+
+// |Texture|
+void AndroidExternalTextureHardwareBuffer::OnTextureUnregistered() {}
+
+}  // namespace flutter
@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_ANDROID_EXTERNAL_TEXTURE_HARDWARE_BUFFER_H_
+#define FLUTTER_SHELL_PLATFORM_ANDROID_EXTERNAL_TEXTURE_HARDWARE_BUFFER_H_
+
+#include <jni.h>
+
+#include <functional>
+#include <memory>
+
+#include "flutter/flow/texture.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/platform/android/scoped_java_ref.h"
+#include "flutter/fml/task_runner.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An external texture whose frames are produced into an
+///             `AImageReader` and imported as `AHardwareBuffer`s backed
+///             EGLImages.
+///
+///             Unlike `AndroidExternalTextureGL`, no JNI calls are made on the
+///             raster thread, and the producer and the raster thread
+///             synchronize with the fences of the frames rather than
+///             `SurfaceTexture.updateTexImage`.
+///
+///             This requires API 26 and the OpenGL ES rendering API.
+///
+class AndroidExternalTextureHardwareBuffer : public flutter::Texture {
+ public:
+  //----------------------------------------------------------------------------
+  /// @return     Whether the device supports hardware buffer textures.
+  ///
+  static bool IsSupported();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the image reader of the texture.
+  ///
+  /// @param[in]  id                    The identifier of the texture.
+  /// @param[in]  width                 The width of the frames.
+  /// @param[in]  height                The height of the frames.
+  /// @param[in]  platform_task_runner  The runner on which
+  ///                                   `on_frame_available` is invoked.
+  /// @param[in]  on_frame_available    Invoked when the producer queued a
+  ///                                   frame.
+  ///
+  AndroidExternalTextureHardwareBuffer(
+      int64_t id,
+      int32_t width,
+      int32_t height,
+      fml::RefPtr<fml::TaskRunner> platform_task_runner,
+      std::function<void()> on_frame_available);
+
+  ~AndroidExternalTextureHardwareBuffer() override;
+
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The `android.view.Surface` the producer renders frames to.
+  ///
+  fml::jni::ScopedJavaLocalRef<jobject> GetSurface(JNIEnv* env) const;
+
+  // |Texture|
+  void Paint(SkCanvas& canvas,
+             const SkRect& bounds,
+             bool freeze,
+             GrContext* context,
+             SkFilterQuality filter_quality) override;
+
+  // |Texture|
+  void OnGrContextCreated() override;
+
+  // |Texture|
+  void OnGrContextDestroyed() override;
+
+  // |Texture|
+  void MarkNewFrameAvailable() override;
+
+  // |Texture|
+  void OnTextureUnregistered() override;
+
+ private:
+  struct Procs;
+  struct ImageReader;
+  struct Frame;
+
+  const Procs* procs_;
+  std::shared_ptr<ImageReader> reader_;
+  bool new_frame_ready_ = false;
+  sk_sp<SkImage> image_;
+  SkRect crop_rect_ = SkRect::MakeEmpty();
+
+  // Acquires the latest frame of the image reader and wraps it in |image_|.
+  void AcquireLatestImage(GrContext* context);
+
+  static const Procs* GetProcs();
+
+  static void ReleaseFrame(void* context);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AndroidExternalTextureHardwareBuffer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_ANDROID_EXTERNAL_TEXTURE_HARDWARE_BUFFER_H_
@@ -7,8 +7,6 @@
 #include "flutter/shell/platform/android/android_shell_holder.h"
 
 #include <pthread.h>
-#include <sys/resource.h>
-#include <sys/time.h>
 
 #include <sstream>
 #include <string>
@@ -41,11 +39,19 @@ AndroidShellHolder::AndroidShellHolder(
   FML_CHECK(pthread_key_create(&thread_destruct_key_, ThreadDestructCallback) ==
             0);
 
+  ThreadHost::ThreadConfigs thread_configs;
+  thread_configs[ThreadHost::Type::UI].priority =
+      fml::Thread::ThreadPriority::kUI;
+  thread_configs[ThreadHost::Type::GPU].priority =
+      fml::Thread::ThreadPriority::kDisplay;
+
   if (is_background_view) {
-    thread_host_ = {thread_label, ThreadHost::Type::UI};
+    thread_host_ = {thread_label, ThreadHost::Type::UI, thread_configs};
   } else {
-    thread_host_ = {thread_label, ThreadHost::Type::UI | ThreadHost::Type::GPU |
-                                      ThreadHost::Type::IO};
+    thread_host_ = {thread_label,
+                    ThreadHost::Type::UI | ThreadHost::Type::GPU |
+                        ThreadHost::Type::IO,
+                    thread_configs};
   }
 
   // Detach from JNI when the UI and raster threads exit.
@@ -149,26 +155,6 @@ AndroidShellHolder::AndroidShellHolder(
   FML_DCHECK(platform_view_);
 
   is_valid_ = shell_ != nullptr;
-
-  if (is_valid_) {
-    shell_->GetTaskRunners().GetRasterTaskRunner()->PostTask([]() {
-      // Android describes -8 as "most important display threads, for
-      // compositing the screen and retrieving input events". Conservatively
-      // set the raster thread to slightly lower priority than it.
-      if (::setpriority(PRIO_PROCESS, gettid(), -5) != 0) {
-        // Defensive fallback. Depending on the OEM, it may not be possible
-        // to set priority to -5.
-        if (::setpriority(PRIO_PROCESS, gettid(), -2) != 0) {
-          FML_LOG(ERROR) << "Failed to set GPU task runner priority";
-        }
-      }
-    });
-    shell_->GetTaskRunners().GetUITaskRunner()->PostTask([]() {
-      if (::setpriority(PRIO_PROCESS, gettid(), -1) != 0) {
-        FML_LOG(ERROR) << "Failed to set UI task runner priority";
-      }
-    });
-  }
 }
 
 AndroidShellHolder::~AndroidShellHolder() {
@@ -215,4 +201,9 @@ void AndroidShellHolder::NotifyLowMemoryWarning() {
   FML_DCHECK(shell_);
   shell_->NotifyLowMemoryWarning();
 }
+
+void AndroidShellHolder::NotifyMemoryPressure(MemoryPressureLevel level) {
+  FML_DCHECK(shell_);
+  shell_->NotifyMemoryPressure(level);
+}
 }  // namespace flutter
@@ -50,6 +50,8 @@ class AndroidShellHolder {
 
   void NotifyLowMemoryWarning();
 
+  void NotifyMemoryPressure(MemoryPressureLevel level);
+
  private:
   const flutter::Settings settings_;
   const std::shared_ptr<PlatformViewAndroidJNI> jni_facade_;
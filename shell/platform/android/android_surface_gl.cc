@@ -17,9 +17,11 @@ AndroidSurfaceGL::AndroidSurfaceGL(
     std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
     const AndroidSurface::Factory& surface_factory)
     : external_view_embedder_(
-          std::make_unique<AndroidExternalViewEmbedder>(android_context,
-                                                        jni_facade,
-                                                        surface_factory)),
+          std::make_unique<AndroidExternalViewEmbedder>(
+              android_context,
+              jni_facade,
+              surface_factory,
+              AndroidExternalViewEmbedder::DefaultSurfacePoolConfig())),
       android_context_(
           std::static_pointer_cast<AndroidContextGL>(android_context)),
       native_window_(nullptr),
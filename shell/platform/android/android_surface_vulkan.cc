@@ -8,18 +8,34 @@
 
 #include "flutter/fml/logging.h"
 #include "flutter/shell/gpu/gpu_surface_vulkan.h"
+#include "flutter/shell/platform/android/flutter_main.h"
 #include "flutter/vulkan/vulkan_native_surface_android.h"
 
 namespace flutter {
 
+static vulkan::VulkanSwapchainConfig SwapchainConfigFromSettings(
+    const Settings& settings) {
+  vulkan::VulkanSwapchainConfig config;
+  if (settings.vulkan_present_mode == "mailbox") {
+    config.present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+  } else if (settings.vulkan_present_mode == "fifo-relaxed") {
+    config.present_mode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+  }
+  config.max_frames_in_flight =
+      static_cast<uint32_t>(settings.vulkan_max_frames_in_flight);
+  return config;
+}
+
 AndroidSurfaceVulkan::AndroidSurfaceVulkan(
     std::shared_ptr<AndroidContext> android_context,
     std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
     AndroidSurface::Factory surface_factory)
     : external_view_embedder_(
-          std::make_unique<AndroidExternalViewEmbedder>(android_context,
-                                                        jni_facade,
-                                                        surface_factory)),
+          std::make_unique<AndroidExternalViewEmbedder>(
+              android_context,
+              jni_facade,
+              surface_factory,
+              AndroidExternalViewEmbedder::DefaultSurfacePoolConfig())),
       proc_table_(fml::MakeRefCounted<vulkan::VulkanProcTable>()) {}
 
 AndroidSurfaceVulkan::~AndroidSurfaceVulkan() = default;
@@ -51,7 +67,8 @@ std::unique_ptr<Surface> AndroidSurfaceVulkan::CreateGPUSurface(
   }
 
   auto gpu_surface = std::make_unique<GPUSurfaceVulkan>(
-      this, std::move(vulkan_surface_android), true);
+      this, std::move(vulkan_surface_android), true,
+      SwapchainConfigFromSettings(FlutterMain::Get().GetSettings()));
 
   if (!gpu_surface->IsValid()) {
     return nullptr;
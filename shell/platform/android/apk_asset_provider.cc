@@ -1,8 +1,11 @@
+#include <sys/mman.h>
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/platform/android/apk_asset_provider.h"
 
 namespace flutter {
@@ -21,6 +24,74 @@ bool APKAssetProvider::IsValid() const {
   return true;
 }
 
+// The bytes of the assets inflated into memory and the bytes mapped from the
+// APK, since the start of the process.
+static std::atomic<int64_t> inflated_asset_bytes(0);
+static std::atomic<int64_t> mapped_asset_bytes(0);
+
+static void TraceAssetBytes() {
+  FML_TRACE_COUNTER("flutter", "APKAssetBytes", 0,            //
+                    "Inflated", inflated_asset_bytes.load(),  //
+                    "Mapped", mapped_asset_bytes.load()       //
+  );
+}
+
+// Maps an asset stored without compression straight from the APK, so that its
+// pages are read in on demand and shared with other processes mapping the
+// APK, instead of being copied into the heap of the asset manager.
+class APKAssetFileMapping : public fml::Mapping {
+ public:
+  // Returns null if the asset is compressed.
+  static std::unique_ptr<APKAssetFileMapping> Create(AAsset* asset) {
+    off64_t start = 0;
+    off64_t length = 0;
+    fml::UniqueFD fd(AAsset_openFileDescriptor64(asset, &start, &length));
+    if (!fd.is_valid() || length <= 0) {
+      return nullptr;
+    }
+
+    // Entries are only aligned to a few bytes in the APK, but mappings have to
+    // start on a page boundary.
+    static const off64_t page_size = ::sysconf(_SC_PAGESIZE);
+    const off64_t page_offset = start % page_size;
+    const size_t mapped_size = static_cast<size_t>(length + page_offset);
+    void* base = ::mmap64(nullptr, mapped_size, PROT_READ, MAP_PRIVATE,
+                          fd.get(), start - page_offset);
+    if (base == MAP_FAILED) {
+      FML_DLOG(ERROR) << "Could not map an asset from the APK.";
+      return nullptr;
+    }
+    return std::unique_ptr<APKAssetFileMapping>(new APKAssetFileMapping(
+        base, mapped_size, page_offset, static_cast<size_t>(length)));
+  }
+
+  ~APKAssetFileMapping() override { ::munmap(base_, mapped_size_); }
+
+  size_t GetSize() const override { return size_; }
+
+  const uint8_t* GetMapping() const override { return data_; }
+
+  // Starts reading the asset into memory in the background.
+  void Prefetch() const { ::madvise(base_, mapped_size_, MADV_WILLNEED); }
+
+ private:
+  void* const base_;
+  const size_t mapped_size_;
+  const uint8_t* const data_;
+  const size_t size_;
+
+  APKAssetFileMapping(void* base,
+                      size_t mapped_size,
+                      size_t page_offset,
+                      size_t size)
+      : base_(base),
+        mapped_size_(mapped_size),
+        data_(static_cast<const uint8_t*>(base) + page_offset),
+        size_(size) {}
+
+  FML_DISALLOW_COPY_AND_ASSIGN(APKAssetFileMapping);
+};
+
 class APKAssetMapping : public fml::Mapping {
  public:
   APKAssetMapping(AAsset* asset) : asset_(asset) {}
@@ -41,6 +112,17 @@ class APKAssetMapping : public fml::Mapping {
 
 std::unique_ptr<fml::Mapping> APKAssetProvider::GetAsMapping(
     const std::string& asset_name) const {
+  return OpenMapping(asset_name, true);
+}
+
+std::unique_ptr<fml::Mapping> APKAssetProvider::GetAsDemandPagedMapping(
+    const std::string& asset_name) const {
+  return OpenMapping(asset_name, false);
+}
+
+std::unique_ptr<fml::Mapping> APKAssetProvider::OpenMapping(
+    const std::string& asset_name,
+    bool prefetch) const {
   std::stringstream ss;
   ss << directory_.c_str() << "/" << asset_name;
   AAsset* asset =
@@ -49,7 +131,21 @@ std::unique_ptr<fml::Mapping> APKAssetProvider::GetAsMapping(
     return nullptr;
   }
 
-  return std::make_unique<APKAssetMapping>(asset);
+  if (auto file_mapping = APKAssetFileMapping::Create(asset)) {
+    AAsset_close(asset);
+    if (prefetch) {
+      file_mapping->Prefetch();
+    }
+    mapped_asset_bytes += file_mapping->GetSize();
+    TraceAssetBytes();
+    return file_mapping;
+  }
+
+  // The asset is compressed, so the asset manager inflates it into a buffer.
+  auto mapping = std::make_unique<APKAssetMapping>(asset);
+  inflated_asset_bytes += mapping->GetSize();
+  TraceAssetBytes();
+  return mapping;
 }
 
 }  // namespace flutter
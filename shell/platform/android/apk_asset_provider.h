@@ -33,6 +33,15 @@ class APKAssetProvider final : public AssetResolver {
   std::unique_ptr<fml::Mapping> GetAsMapping(
       const std::string& asset_name) const override;
 
+  // |flutter::AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsDemandPagedMapping(
+      const std::string& asset_name) const override;
+
+  // Maps assets stored without compression straight from the APK, and reads
+  // them ahead if |prefetch| is set. Compressed assets are inflated.
+  std::unique_ptr<fml::Mapping> OpenMapping(const std::string& asset_name,
+                                            bool prefetch) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(APKAssetProvider);
 };
 
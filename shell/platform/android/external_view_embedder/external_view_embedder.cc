@@ -12,11 +12,28 @@ AndroidExternalViewEmbedder::AndroidExternalViewEmbedder(
     std::shared_ptr<AndroidContext> android_context,
     std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
     const AndroidSurface::Factory& surface_factory)
+    : AndroidExternalViewEmbedder(android_context,
+                                  jni_facade,
+                                  surface_factory,
+                                  SurfacePool::Config{}) {}
+
+AndroidExternalViewEmbedder::AndroidExternalViewEmbedder(
+    std::shared_ptr<AndroidContext> android_context,
+    std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+    const AndroidSurface::Factory& surface_factory,
+    const SurfacePool::Config& surface_pool_config)
     : ExternalViewEmbedder(),
       android_context_(android_context),
       jni_facade_(jni_facade),
       surface_factory_(surface_factory),
-      surface_pool_(std::make_unique<SurfacePool>()) {}
+      surface_pool_(std::make_unique<SurfacePool>(surface_pool_config)) {}
+
+SurfacePool::Config AndroidExternalViewEmbedder::DefaultSurfacePoolConfig() {
+  SurfacePool::Config config;
+  config.prewarm_count = kMaxLayerAllocations;
+  config.max_idle_frames = kDefaultMergedLeaseDuration / 2;
+  return config;
+}
 
 // |ExternalViewEmbedder|
 void AndroidExternalViewEmbedder::PrerollCompositeEmbeddedView(
@@ -91,6 +108,8 @@ bool AndroidExternalViewEmbedder::SubmitFrame(
   // below.
   SkAutoCanvasRestore save(background_canvas, /*doSave=*/true);
 
+  // Reused by every r-tree query below.
+  std::vector<SkRect> intersection_rects;
   for (size_t i = 0; i < current_frame_view_count; i++) {
     int64_t view_id = composition_order_[i];
 
@@ -112,8 +131,8 @@ bool AndroidExternalViewEmbedder::SubmitFrame(
       int64_t current_view_id = composition_order_[j];
       SkRect current_view_rect = GetViewRect(current_view_id);
       // Each rect corresponds to a native view that renders Flutter UI.
-      std::list<SkRect> intersection_rects =
-          rtree->searchNonOverlappingDrawnRects(current_view_rect);
+      rtree->searchNonOverlappingDrawnRects(current_view_rect,
+                                            &intersection_rects);
       auto allocation_size = intersection_rects.size();
 
       // Limit the number of native views, so it doesn't grow forever.
@@ -154,6 +173,11 @@ bool AndroidExternalViewEmbedder::SubmitFrame(
     frame->Submit();
   }
 
+  if (current_frame_view_count > 0) {
+    surface_pool_->PrewarmLayers(context, android_context_, jni_facade_,
+                                 surface_factory_);
+  }
+
   for (int64_t view_id : composition_order_) {
     SkRect view_rect = GetViewRect(view_id);
     const EmbeddedViewParams& params = view_params_.at(view_id);
@@ -292,6 +316,9 @@ void AndroidExternalViewEmbedder::EndFrame(
   surface_pool_->RecycleLayers();
   // JNI method must be called on the platform thread.
   if (raster_thread_merger->IsOnPlatformThread()) {
+    if (surface_pool_->ShouldDestroyLayers()) {
+      surface_pool_->DestroyLayers(jni_facade_);
+    }
     jni_facade_->FlutterViewEndFrame();
   }
 }
@@ -33,6 +33,19 @@ class AndroidExternalViewEmbedder final : public ExternalViewEmbedder {
       std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
       const AndroidSurface::Factory& surface_factory);
 
+  AndroidExternalViewEmbedder(
+      std::shared_ptr<AndroidContext> android_context,
+      std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+      const AndroidSurface::Factory& surface_factory,
+      const SurfacePool::Config& surface_pool_config);
+
+  // The configuration of the overlay surface pool used by the Android
+  // surfaces: as many overlays as a platform view may need are created at
+  // once, and the overlays are destroyed once unused for half the merged
+  // lease, so that it happens while the rasterizer runs on the platform
+  // thread.
+  static SurfacePool::Config DefaultSurfacePoolConfig();
+
   // |ExternalViewEmbedder|
   void PrerollCompositeEmbeddedView(
       int view_id,
@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/android/external_view_embedder/surface_pool.h"
 
+#include "flutter/fml/trace_event.h"
+
 namespace flutter {
 
 OverlayLayer::OverlayLayer(int id,
@@ -15,41 +17,65 @@ OverlayLayer::OverlayLayer(int id,
 
 OverlayLayer::~OverlayLayer() = default;
 
-SurfacePool::SurfacePool() = default;
+SurfacePool::SurfacePool() : SurfacePool(Config{}) {}
+
+SurfacePool::SurfacePool(const Config& config) : config_(config) {}
 
 SurfacePool::~SurfacePool() = default;
 
-std::shared_ptr<OverlayLayer> SurfacePool::GetLayer(
+void SurfacePool::CreateLayer(
     GrContext* gr_context,
     std::shared_ptr<AndroidContext> android_context,
     std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
     const AndroidSurface::Factory& surface_factory) {
-  intptr_t gr_context_key = reinterpret_cast<intptr_t>(gr_context);
-  // Allocate a new surface if there isn't one available.
-  if (available_layer_index_ >= layers_.size()) {
-    std::unique_ptr<AndroidSurface> android_surface =
-        surface_factory(android_context, jni_facade);
+  TRACE_EVENT0("flutter", "SurfacePool::CreateLayer");
+  std::unique_ptr<AndroidSurface> android_surface =
+      surface_factory(android_context, jni_facade);
 
-    FML_CHECK(android_surface && android_surface->IsValid())
-        << "Could not create an OpenGL, Vulkan or Software surface to setup "
-           "rendering.";
+  FML_CHECK(android_surface && android_surface->IsValid())
+      << "Could not create an OpenGL, Vulkan or Software surface to setup "
+         "rendering.";
 
-    std::unique_ptr<PlatformViewAndroidJNI::OverlayMetadata> java_metadata =
-        jni_facade->FlutterViewCreateOverlaySurface();
+  std::unique_ptr<PlatformViewAndroidJNI::OverlayMetadata> java_metadata =
+      jni_facade->FlutterViewCreateOverlaySurface();
 
-    FML_CHECK(java_metadata->window);
-    android_surface->SetNativeWindow(java_metadata->window);
+  FML_CHECK(java_metadata->window);
+  android_surface->SetNativeWindow(java_metadata->window);
 
-    std::unique_ptr<Surface> surface =
-        android_surface->CreateGPUSurface(gr_context);
+  std::unique_ptr<Surface> surface =
+      android_surface->CreateGPUSurface(gr_context);
 
-    std::shared_ptr<OverlayLayer> layer =
-        std::make_shared<OverlayLayer>(java_metadata->id,           //
-                                       std::move(android_surface),  //
-                                       std::move(surface)           //
-        );
-    layer->gr_context_key = gr_context_key;
-    layers_.push_back(layer);
+  std::shared_ptr<OverlayLayer> layer =
+      std::make_shared<OverlayLayer>(java_metadata->id,           //
+                                     std::move(android_surface),  //
+                                     std::move(surface)           //
+      );
+  layer->gr_context_key = reinterpret_cast<intptr_t>(gr_context);
+  layers_.push_back(layer);
+
+  recent_creations_.push_back(fml::TimePoint::Now());
+  TraceCounters();
+}
+
+void SurfacePool::PrewarmLayers(
+    GrContext* gr_context,
+    std::shared_ptr<AndroidContext> android_context,
+    std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+    const AndroidSurface::Factory& surface_factory) {
+  while (layers_.size() < config_.prewarm_count) {
+    CreateLayer(gr_context, android_context, jni_facade, surface_factory);
+  }
+}
+
+std::shared_ptr<OverlayLayer> SurfacePool::GetLayer(
+    GrContext* gr_context,
+    std::shared_ptr<AndroidContext> android_context,
+    std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+    const AndroidSurface::Factory& surface_factory) {
+  intptr_t gr_context_key = reinterpret_cast<intptr_t>(gr_context);
+  // Allocate a new surface if there isn't one available.
+  if (available_layer_index_ >= layers_.size()) {
+    CreateLayer(gr_context, android_context, jni_facade, surface_factory);
   }
   std::shared_ptr<OverlayLayer> layer = layers_[available_layer_index_];
   // Since the surfaces are recycled, it's possible that the GrContext is
@@ -67,9 +93,19 @@ std::shared_ptr<OverlayLayer> SurfacePool::GetLayer(
 }
 
 void SurfacePool::RecycleLayers() {
+  if (available_layer_index_ == 0) {
+    idle_frame_count_++;
+  } else {
+    idle_frame_count_ = 0;
+  }
   available_layer_index_ = 0;
 }
 
+bool SurfacePool::ShouldDestroyLayers() const {
+  return config_.max_idle_frames > 0 && layers_.size() > 0 &&
+         idle_frame_count_ >= config_.max_idle_frames;
+}
+
 void SurfacePool::DestroyLayers(
     std::shared_ptr<PlatformViewAndroidJNI> jni_facade) {
   if (layers_.size() > 0) {
@@ -77,6 +113,8 @@ void SurfacePool::DestroyLayers(
   }
   layers_.clear();
   available_layer_index_ = 0;
+  idle_frame_count_ = 0;
+  TraceCounters();
 }
 
 std::vector<std::shared_ptr<OverlayLayer>> SurfacePool::GetUnusedLayers() {
@@ -87,4 +125,19 @@ std::vector<std::shared_ptr<OverlayLayer>> SurfacePool::GetUnusedLayers() {
   return results;
 }
 
+void SurfacePool::TraceCounters() {
+#if !FLUTTER_RELEASE
+  const auto now = fml::TimePoint::Now();
+  while (!recent_creations_.empty() &&
+         now - recent_creations_.front() > fml::TimeDelta::FromSeconds(1)) {
+    recent_creations_.pop_front();
+  }
+  FML_TRACE_COUNTER("flutter", "SurfacePool",
+                    reinterpret_cast<int64_t>(this),                //
+                    "Layers", layers_.size(),                       //
+                    "CreationsPerSecond", recent_creations_.size()  //
+  );
+#endif  // !FLUTTER_RELEASE
+}
+
 }  // namespace flutter
@@ -5,7 +5,10 @@
 #ifndef FLUTTER_SHELL_PLATFORM_ANDROID_EXTERNAL_VIEW_EMBEDDER_SURFACE_POOL_H_
 #define FLUTTER_SHELL_PLATFORM_ANDROID_EXTERNAL_VIEW_EMBEDDER_SURFACE_POOL_H_
 
+#include <deque>
+
 #include "flutter/flow/surface.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/shell/platform/android/context/android_context.h"
 #include "flutter/shell/platform/android/surface/android_surface.h"
 
@@ -44,8 +47,21 @@ struct OverlayLayer {
 // This class isn't thread safe.
 class SurfacePool {
  public:
+  struct Config {
+    // The number of layers to create at once when layers are first needed, so
+    // that frames that need more of them later don't have to create them.
+    size_t prewarm_count = 0;
+    // The number of consecutive frames without any used layers after which
+    // `ShouldDestroyLayers` returns true, or zero to keep the layers until they
+    // are destroyed explicitly. Frames that only use fewer layers keep them
+    // all, so a count of overlays that drops and rises doesn't recreate them.
+    size_t max_idle_frames = 0;
+  };
+
   SurfacePool();
 
+  explicit SurfacePool(const Config& config);
+
   ~SurfacePool();
 
   // Gets a layer from the pool if available, or allocates a new one.
@@ -57,13 +73,23 @@ class SurfacePool {
       std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
       const AndroidSurface::Factory& surface_factory);
 
+  // Creates layers until the pool has `Config::prewarm_count` of them.
+  void PrewarmLayers(GrContext* gr_context,
+                     std::shared_ptr<AndroidContext> android_context,
+                     std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+                     const AndroidSurface::Factory& surface_factory);
+
   // Gets the layers in the pool that aren't currently used.
   // This method doesn't mark the layers as unused.
   std::vector<std::shared_ptr<OverlayLayer>> GetUnusedLayers();
 
-  // Marks the layers in the pool as available for reuse.
+  // Marks the layers in the pool as available for reuse, and ends the frame.
   void RecycleLayers();
 
+  // Whether the pool has layers that went unused for
+  // `Config::max_idle_frames` frames.
+  bool ShouldDestroyLayers() const;
+
   // Destroys all the layers in the pool.
   void DestroyLayers(std::shared_ptr<PlatformViewAndroidJNI> jni_facade);
 
@@ -82,6 +108,18 @@ class SurfacePool {
   //  entry at position 0 cannot be reused.
   size_t available_layer_index_ = 0;
   std::vector<std::shared_ptr<OverlayLayer>> layers_;
+  const Config config_;
+  // The number of consecutive frames that didn't use any layer.
+  size_t idle_frame_count_ = 0;
+  // The times layers were created in the last second.
+  std::deque<fml::TimePoint> recent_creations_;
+
+  void CreateLayer(GrContext* gr_context,
+                   std::shared_ptr<AndroidContext> android_context,
+                   std::shared_ptr<PlatformViewAndroidJNI> jni_facade,
+                   const AndroidSurface::Factory& surface_factory);
+
+  void TraceCounters();
 };
 
 }  // namespace flutter
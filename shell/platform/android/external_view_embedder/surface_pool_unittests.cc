@@ -200,5 +200,100 @@ TEST(SurfacePool, DestroyLayers) {
   ASSERT_TRUE(pool->GetUnusedLayers().empty());
 }
 
+TEST(SurfacePool, PrewarmLayers) {
+  SurfacePool::Config config;
+  config.prewarm_count = 2;
+  auto pool = std::make_unique<SurfacePool>(config);
+
+  auto gr_context = GrContext::MakeMock(nullptr);
+  auto android_context =
+      std::make_shared<AndroidContext>(AndroidRenderingAPI::kSoftware);
+
+  auto jni_mock = std::make_shared<JNIMock>();
+  auto window = fml::MakeRefCounted<AndroidNativeWindow>(nullptr);
+  EXPECT_CALL(*jni_mock, FlutterViewCreateOverlaySurface())
+      .Times(2)
+      .WillOnce(Return(
+          ByMove(std::make_unique<PlatformViewAndroidJNI::OverlayMetadata>(
+              0, window))))
+      .WillOnce(Return(
+          ByMove(std::make_unique<PlatformViewAndroidJNI::OverlayMetadata>(
+              1, window))));
+
+  auto surface_factory =
+      [gr_context, window](std::shared_ptr<AndroidContext> android_context,
+                           std::shared_ptr<PlatformViewAndroidJNI> jni_facade) {
+        auto android_surface_mock = std::make_unique<AndroidSurfaceMock>();
+        EXPECT_CALL(*android_surface_mock, CreateGPUSurface(gr_context.get()));
+        EXPECT_CALL(*android_surface_mock, SetNativeWindow(window));
+        EXPECT_CALL(*android_surface_mock, IsValid()).WillOnce(Return(true));
+        return android_surface_mock;
+      };
+  pool->PrewarmLayers(gr_context.get(), android_context, jni_mock,
+                      surface_factory);
+  ASSERT_EQ(2UL, pool->GetUnusedLayers().size());
+
+  // The pool is already warm, so no layer is created.
+  pool->PrewarmLayers(gr_context.get(), android_context, jni_mock,
+                      surface_factory);
+  auto layer_1 = pool->GetLayer(gr_context.get(), android_context, jni_mock,
+                                surface_factory);
+  auto layer_2 = pool->GetLayer(gr_context.get(), android_context, jni_mock,
+                                surface_factory);
+  ASSERT_EQ(0, layer_1->id);
+  ASSERT_EQ(1, layer_2->id);
+}
+
+TEST(SurfacePool, ShouldDestroyLayers__AfterIdleFrames) {
+  SurfacePool::Config config;
+  config.max_idle_frames = 2;
+  auto pool = std::make_unique<SurfacePool>(config);
+
+  // There are no layers to destroy.
+  pool->RecycleLayers();
+  pool->RecycleLayers();
+  ASSERT_FALSE(pool->ShouldDestroyLayers());
+
+  auto gr_context = GrContext::MakeMock(nullptr);
+  auto android_context =
+      std::make_shared<AndroidContext>(AndroidRenderingAPI::kSoftware);
+
+  auto jni_mock = std::make_shared<JNIMock>();
+  auto window = fml::MakeRefCounted<AndroidNativeWindow>(nullptr);
+  EXPECT_CALL(*jni_mock, FlutterViewCreateOverlaySurface())
+      .WillOnce(Return(
+          ByMove(std::make_unique<PlatformViewAndroidJNI::OverlayMetadata>(
+              0, window))));
+
+  auto surface_factory =
+      [gr_context, window](std::shared_ptr<AndroidContext> android_context,
+                           std::shared_ptr<PlatformViewAndroidJNI> jni_facade) {
+        auto android_surface_mock = std::make_unique<AndroidSurfaceMock>();
+        EXPECT_CALL(*android_surface_mock, CreateGPUSurface(gr_context.get()));
+        EXPECT_CALL(*android_surface_mock, SetNativeWindow(window));
+        EXPECT_CALL(*android_surface_mock, IsValid()).WillOnce(Return(true));
+        return android_surface_mock;
+      };
+  pool->GetLayer(gr_context.get(), android_context, jni_mock, surface_factory);
+  pool->RecycleLayers();
+  ASSERT_FALSE(pool->ShouldDestroyLayers());
+
+  pool->RecycleLayers();
+  ASSERT_FALSE(pool->ShouldDestroyLayers());
+
+  // A frame that uses the layer resets the idle frames.
+  pool->GetLayer(gr_context.get(), android_context, jni_mock, surface_factory);
+  pool->RecycleLayers();
+  pool->RecycleLayers();
+  ASSERT_FALSE(pool->ShouldDestroyLayers());
+
+  pool->RecycleLayers();
+  ASSERT_TRUE(pool->ShouldDestroyLayers());
+
+  EXPECT_CALL(*jni_mock, FlutterViewDestroyOverlaySurfaces());
+  pool->DestroyLayers(jni_mock);
+  ASSERT_FALSE(pool->ShouldDestroyLayers());
+}
+
 }  // namespace testing
 }  // namespace flutter
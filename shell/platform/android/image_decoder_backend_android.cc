@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/android/image_decoder_backend_android.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+
+namespace flutter {
+
+// Smaller images decode faster with Skia than it takes to set up a decode in
+// the platform's decoders.
+static constexpr int64_t kMinPixels = 256 * 256;
+
+// From <android/imagedecoder.h> and <android/bitmap.h>, which the NDK only
+// declares for API level 30 and up.
+struct AImageDecoder;
+struct AImageDecoderHeaderInfo;
+static constexpr int kAImageDecoderSuccess = 0;
+static constexpr int32_t kAndroidBitmapFormatRGBA8888 = 1;
+
+struct ImageDecoderBackendAndroid::Functions {
+  int (*create_from_buffer)(const void* buffer,
+                            size_t length,
+                            AImageDecoder** out_decoder);
+  void (*destroy)(AImageDecoder* decoder);
+  const AImageDecoderHeaderInfo* (*get_header_info)(
+      const AImageDecoder* decoder);
+  int32_t (*get_width)(const AImageDecoderHeaderInfo* info);
+  int32_t (*get_height)(const AImageDecoderHeaderInfo* info);
+  int (*set_android_bitmap_format)(AImageDecoder* decoder, int32_t format);
+  int (*set_target_size)(AImageDecoder* decoder, int32_t width, int32_t height);
+  size_t (*get_minimum_stride)(AImageDecoder* decoder);
+  int (*decode_image)(AImageDecoder* decoder,
+                      void* pixels,
+                      size_t stride,
+                      size_t size);
+};
+
+template <typename Function>
+static bool ResolveFunction(fml::NativeLibrary& library,
+                            const char* name,
+                            Function* function) {
+  *function = reinterpret_cast<Function>(library.ResolveSymbol(name));
+  return *function != nullptr;
+}
+
+std::shared_ptr<ImageDecoderBackendAndroid>
+ImageDecoderBackendAndroid::Create() {
+  auto library = fml::NativeLibrary::Create("libjnigraphics.so");
+  if (!library) {
+    return nullptr;
+  }
+
+  auto functions = std::make_unique<Functions>();
+  if (!ResolveFunction(*library, "AImageDecoder_createFromBuffer",
+                       &functions->create_from_buffer) ||
+      !ResolveFunction(*library, "AImageDecoder_delete",
+                       &functions->destroy) ||
+      !ResolveFunction(*library, "AImageDecoder_getHeaderInfo",
+                       &functions->get_header_info) ||
+      !ResolveFunction(*library, "AImageDecoderHeaderInfo_getWidth",
+                       &functions->get_width) ||
+      !ResolveFunction(*library, "AImageDecoderHeaderInfo_getHeight",
+                       &functions->get_height) ||
+      !ResolveFunction(*library, "AImageDecoder_setAndroidBitmapFormat",
+                       &functions->set_android_bitmap_format) ||
+      !ResolveFunction(*library, "AImageDecoder_setTargetSize",
+                       &functions->set_target_size) ||
+      !ResolveFunction(*library, "AImageDecoder_getMinimumStride",
+                       &functions->get_minimum_stride) ||
+      !ResolveFunction(*library, "AImageDecoder_decodeImage",
+                       &functions->decode_image)) {
+    // Android 10 and older.
+    return nullptr;
+  }
+
+  return std::shared_ptr<ImageDecoderBackendAndroid>(
+      new ImageDecoderBackendAndroid(std::move(library), std::move(functions)));
+}
+
+ImageDecoderBackendAndroid::ImageDecoderBackendAndroid(
+    fml::RefPtr<fml::NativeLibrary> library,
+    std::unique_ptr<Functions> functions)
+    : library_(std::move(library)), functions_(std::move(functions)) {}
+
+ImageDecoderBackendAndroid::~ImageDecoderBackendAndroid() = default;
+
+std::optional<SkISize> ImageDecoderBackendAndroid::GetDimensionsIfAccepted(
+    const SkData& data) const {
+  auto format = SniffFormat(data);
+  if (!format) {
+    return std::nullopt;
+  }
+
+  // AImageDecoder doesn't apply the EXIF orientation on all versions, so
+  // leave rotated JPEGs to Skia.
+  if (format == SkEncodedImageFormat::kJPEG) {
+    auto codec = SkCodec::MakeFromData(SkData::MakeWithoutCopy(
+        data.data(), data.size()));
+    if (!codec || codec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+      return std::nullopt;
+    }
+  }
+
+  AImageDecoder* decoder = nullptr;
+  if (functions_->create_from_buffer(data.data(), data.size(), &decoder) !=
+      kAImageDecoderSuccess) {
+    return std::nullopt;
+  }
+  const auto* info = functions_->get_header_info(decoder);
+  const auto dimensions = SkISize::Make(functions_->get_width(info),
+                                        functions_->get_height(info));
+  functions_->destroy(decoder);
+
+  if (dimensions.area() < kMinPixels) {
+    return std::nullopt;
+  }
+  return dimensions;
+}
+
+sk_sp<SkImage> ImageDecoderBackendAndroid::Decode(
+    const SkData& data,
+    const SkISize& target_dimensions) const {
+  TRACE_EVENT0("flutter", "ImageDecoderBackendAndroid::Decode");
+  AImageDecoder* decoder = nullptr;
+  if (functions_->create_from_buffer(data.data(), data.size(), &decoder) !=
+      kAImageDecoderSuccess) {
+    return nullptr;
+  }
+  // Destroys the decoder on every return.
+  std::unique_ptr<AImageDecoder, void (*)(AImageDecoder*)> decoder_holder(
+      decoder, functions_->destroy);
+
+  if (functions_->set_android_bitmap_format(
+          decoder, kAndroidBitmapFormatRGBA8888) != kAImageDecoderSuccess ||
+      functions_->set_target_size(decoder, target_dimensions.width(),
+                                  target_dimensions.height()) !=
+          kAImageDecoderSuccess) {
+    return nullptr;
+  }
+
+  // Decodes are premultiplied unless asked otherwise.
+  const auto info = SkImageInfo::Make(target_dimensions, kRGBA_8888_SkColorType,
+                                      kPremul_SkAlphaType);
+  const size_t row_bytes = functions_->get_minimum_stride(decoder);
+  const size_t size = info.computeByteSize(row_bytes);
+  sk_sp<SkData> pixels = SkData::MakeUninitialized(size);
+  if (functions_->decode_image(decoder, pixels->writable_data(), row_bytes,
+                               size) != kAImageDecoderSuccess) {
+    FML_LOG(ERROR) << "AImageDecoder failed to decode the image.";
+    return nullptr;
+  }
+
+  return SkImage::MakeRasterData(info, std::move(pixels), row_bytes);
+}
+
+}  // namespace flutter
@@ -0,0 +1,49 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_ANDROID_IMAGE_DECODER_BACKEND_ANDROID_H_
+#define FLUTTER_SHELL_PLATFORM_ANDROID_IMAGE_DECODER_BACKEND_ANDROID_H_
+
+#include <memory>
+
+#include "flutter/fml/native_library.h"
+#include "flutter/lib/ui/painting/image_decoder_backend.h"
+
+namespace flutter {
+
+// Decodes JPEG and HEIF images with the NDK's AImageDecoder, which uses the
+// platform's decoders, including the hardware ones, and scales while
+// decoding. AImageDecoder is available from Android 11 and is looked up at
+// runtime, so the engine still loads on older versions.
+class ImageDecoderBackendAndroid final : public ImageDecoderBackend {
+ public:
+  // Returns null if the platform has no AImageDecoder.
+  static std::shared_ptr<ImageDecoderBackendAndroid> Create();
+
+  ~ImageDecoderBackendAndroid() override;
+
+  // |ImageDecoderBackend|
+  std::optional<SkISize> GetDimensionsIfAccepted(
+      const SkData& data) const override;
+
+  // |ImageDecoderBackend|
+  sk_sp<SkImage> Decode(const SkData& data,
+                        const SkISize& target_dimensions) const override;
+
+ private:
+  struct Functions;
+
+  // Keeps the functions loaded.
+  fml::RefPtr<fml::NativeLibrary> library_;
+  std::unique_ptr<Functions> functions_;
+
+  ImageDecoderBackendAndroid(fml::RefPtr<fml::NativeLibrary> library,
+                             std::unique_ptr<Functions> functions);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderBackendAndroid);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_ANDROID_IMAGE_DECODER_BACKEND_ANDROID_H_
@@ -5,6 +5,7 @@
 package io.flutter.embedding.android;
 
 import static android.content.ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW;
+import static android.content.ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN;
 
 import android.app.Activity;
 import android.content.Context;
@@ -22,6 +23,7 @@ import io.flutter.Log;
 import io.flutter.app.FlutterActivity;
 import io.flutter.embedding.engine.FlutterEngine;
 import io.flutter.embedding.engine.FlutterEngineCache;
+import io.flutter.embedding.engine.FlutterJNI;
 import io.flutter.embedding.engine.FlutterShellArgs;
 import io.flutter.embedding.engine.dart.DartExecutor;
 import io.flutter.embedding.engine.renderer.FlutterUiDisplayListener;
@@ -651,9 +653,9 @@ import java.util.Arrays;
   void onTrimMemory(int level) {
     ensureAlive();
     if (flutterEngine != null) {
-      // This is always an indication that the Dart VM should collect memory
-      // and free any unneeded resources.
-      flutterEngine.getDartExecutor().notifyLowMemoryWarning();
+      // This is always an indication that the engine should free unneeded
+      // resources, more of them the more severe the trim level is.
+      flutterEngine.getDartExecutor().notifyMemoryPressure(memoryPressureLevelOf(level));
       // Use a trim level delivered while the application is running so the
       // framework has a chance to react to the notification.
       if (level == TRIM_MEMORY_RUNNING_LOW) {
@@ -665,6 +667,17 @@ import java.util.Arrays;
     }
   }
 
+  /** Maps an {@code onTrimMemory()} level to a {@code FlutterJNI.MEMORY_PRESSURE_LEVEL_*}. */
+  private static int memoryPressureLevelOf(int trimLevel) {
+    if (trimLevel >= TRIM_MEMORY_UI_HIDDEN) {
+      return FlutterJNI.MEMORY_PRESSURE_LEVEL_BACKGROUND;
+    }
+    if (trimLevel >= TRIM_MEMORY_RUNNING_LOW) {
+      return FlutterJNI.MEMORY_PRESSURE_LEVEL_CRITICAL;
+    }
+    return FlutterJNI.MEMORY_PRESSURE_LEVEL_MODERATE;
+  }
+
   /**
    * Invoke this from {@link Activity#onLowMemory()}.
    *
@@ -554,6 +554,23 @@ public class FlutterJNI {
 
   private native void nativeSetSemanticsEnabled(long nativePlatformViewId, boolean enabled);
 
+  /**
+   * Tells Flutter whether anything consumes its semantics tree, such as a screen reader or an
+   * accessibility service querying nodes.
+   *
+   * <p>While semantics is enabled but no client is active, Flutter holds back the semantics
+   * updates instead of sending them to {@link AccessibilityDelegate#updateSemantics(ByteBuffer,
+   * String[])} every frame, and sends them all at once when a client becomes active.
+   */
+  @UiThread
+  public void setSemanticsClientActive(boolean active) {
+    ensureRunningOnMainThread();
+    ensureAttachedToNative();
+    nativeSetSemanticsClientActive(nativePlatformViewId, active);
+  }
+
+  private native void nativeSetSemanticsClientActive(long nativePlatformViewId, boolean active);
+
   // TODO(mattcarroll): figure out what flags are supported and add javadoc about when/why/where to
   // use this.
   @UiThread
@@ -581,6 +598,28 @@ public class FlutterJNI {
   private native void nativeRegisterTexture(
       long nativePlatformViewId, long textureId, @NonNull SurfaceTexture surfaceTexture);
 
+  /**
+   * Registers a texture whose frames are produced into a native image reader, and returns the
+   * {@link Surface} that producers render frames to.
+   *
+   * <p>Flutter imports the frames as hardware buffers without calling into Java on the raster
+   * thread, and synchronizes with producers through the fences of the frames.
+   *
+   * @return The {@link Surface} of the texture, or null if hardware buffer textures aren't
+   *     supported, in which case {@link #registerTexture(long, SurfaceTexture)} should be used.
+   */
+  @UiThread
+  @Nullable
+  public Surface registerHardwareBufferTexture(long textureId, int width, int height) {
+    ensureRunningOnMainThread();
+    ensureAttachedToNative();
+    return nativeRegisterHardwareBufferTexture(nativePlatformViewId, textureId, width, height);
+  }
+
+  @Nullable
+  private native Surface nativeRegisterHardwareBufferTexture(
+      long nativePlatformViewId, long textureId, int width, int height);
+
   /**
    * Call this method to inform Flutter that a texture previously registered with {@link
    * #registerTexture(long, SurfaceTexture)} has a new frame available.
@@ -975,6 +1014,37 @@ public class FlutterJNI {
 
   private native void nativeNotifyLowMemoryWarning(long nativePlatformViewId);
 
+  /**
+   * The system is running low on memory while the application is visible. Only caches that the
+   * current frames don't use are trimmed.
+   */
+  public static final int MEMORY_PRESSURE_LEVEL_MODERATE = 0;
+
+  /**
+   * The system is running very low on memory while the application is visible. This is the level
+   * of {@link #notifyLowMemoryWarning()}.
+   */
+  public static final int MEMORY_PRESSURE_LEVEL_CRITICAL = 1;
+
+  /**
+   * The application is not visible. Everything that can be rebuilt when it becomes visible again
+   * is released.
+   */
+  public static final int MEMORY_PRESSURE_LEVEL_BACKGROUND = 2;
+
+  /**
+   * Notifies the engine that the system is running low on memory, with one of the {@code
+   * MEMORY_PRESSURE_LEVEL_*} levels. The engine trims more of its caches the more severe the level.
+   */
+  @UiThread
+  public void notifyMemoryPressure(int level) {
+    ensureRunningOnMainThread();
+    ensureAttachedToNative();
+    nativeNotifyMemoryPressure(nativePlatformViewId, level);
+  }
+
+  private native void nativeNotifyMemoryPressure(long nativePlatformViewId, int level);
+
   private void ensureRunningOnMainThread() {
     if (Looper.myLooper() != mainLooper) {
       throw new RuntimeException(
@@ -245,6 +245,19 @@ public class DartExecutor implements BinaryMessenger {
     }
   }
 
+  /**
+   * Notify the engine that the system is running low on memory, with one of the {@code
+   * FlutterJNI.MEMORY_PRESSURE_LEVEL_*} levels.
+   *
+   * <p>Like {@link #notifyLowMemoryWarning()}, this does not notify a Flutter application about
+   * memory pressure.
+   */
+  public void notifyMemoryPressure(int level) {
+    if (flutterJNI.isAttached()) {
+      flutterJNI.notifyMemoryPressure(level);
+    }
+  }
+
   /**
    * Configuration options that specify which Dart entrypoint function is executed and where to find
    * that entrypoint and other assets required for Dart execution.
@@ -4,6 +4,7 @@
 
 package io.flutter.embedding.engine.loader;
 
+import android.app.ActivityManager;
 import android.content.Context;
 import android.content.pm.ApplicationInfo;
 import android.content.pm.PackageManager;
@@ -232,6 +233,15 @@ public class FlutterLoader {
         shellArgs.add("--log-tag=" + settings.getLogTag());
       }
 
+      // Lets the engine size its caches to the memory class of the device.
+      ActivityManager activityManager =
+          (ActivityManager) applicationContext.getSystemService(Context.ACTIVITY_SERVICE);
+      if (activityManager != null) {
+        ActivityManager.MemoryInfo memoryInfo = new ActivityManager.MemoryInfo();
+        activityManager.getMemoryInfo(memoryInfo);
+        shellArgs.add("--device-memory-mb=" + (memoryInfo.totalMem >> 20));
+      }
+
       long initTimeMillis = SystemClock.uptimeMillis() - initStartTimestampMillis;
 
       // TODO(cyanlaz): Remove this when dynamic thread merging is done.
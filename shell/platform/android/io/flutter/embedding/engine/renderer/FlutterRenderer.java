@@ -164,6 +164,64 @@ public class FlutterRenderer implements TextureRegistry {
       released = true;
     }
   }
+
+  /**
+   * Creates a texture whose frames are produced into a {@link Surface} of the given size, for
+   * producers such as video decoders or cameras.
+   *
+   * <p>On API 26 and above with OpenGL ES rendering, the frames are imported as hardware buffers,
+   * which avoids the JNI call and the implicit synchronization of {@link
+   * SurfaceTexture#updateTexImage()} on every frame.
+   *
+   * @return The entry of the texture, or null if hardware buffer textures aren't supported, in
+   *     which case {@link #createSurfaceTexture()} should be used instead.
+   */
+  @Nullable
+  public SurfaceProducerEntry createHardwareBufferTexture(int width, int height) {
+    if (Build.VERSION.SDK_INT < Build.VERSION_CODES.O) {
+      return null;
+    }
+    final long id = nextTextureId.getAndIncrement();
+    final Surface surface = flutterJNI.registerHardwareBufferTexture(id, width, height);
+    if (surface == null) {
+      return null;
+    }
+    Log.v(TAG, "New hardware buffer texture ID: " + id);
+    return new HardwareBufferRegistryEntry(id, surface);
+  }
+
+  final class HardwareBufferRegistryEntry implements TextureRegistry.SurfaceProducerEntry {
+    private final long id;
+    @NonNull private final Surface surface;
+    private boolean released;
+
+    HardwareBufferRegistryEntry(long id, @NonNull Surface surface) {
+      this.id = id;
+      this.surface = surface;
+    }
+
+    @Override
+    @NonNull
+    public Surface surface() {
+      return surface;
+    }
+
+    @Override
+    public long id() {
+      return id;
+    }
+
+    @Override
+    public void release() {
+      if (released) {
+        return;
+      }
+      Log.v(TAG, "Releasing a hardware buffer texture (" + id + ").");
+      surface.release();
+      unregisterTexture(id);
+      released = true;
+    }
+  }
   // ------ END TextureRegistry IMPLEMENTATION ----
 
   /**
@@ -112,6 +112,16 @@ public class AccessibilityChannel {
     flutterJNI.setSemanticsEnabled(false);
   }
 
+  /**
+   * Informs Flutter whether anything currently consumes its semantics tree.
+   *
+   * <p>Accessibility may be enabled while no service reads the tree. Until one does, Flutter holds
+   * back its semantics updates.
+   */
+  public void setSemanticsClientActive(boolean active) {
+    flutterJNI.setSemanticsClientActive(active);
+  }
+
   /**
    * Instructs Flutter to activate/deactivate accessibility features corresponding to the flags
    * provided by {@code accessibilityFeatureFlags}.
@@ -223,6 +223,11 @@ public class AccessibilityBridge extends AccessibilityNodeProvider {
 
   @Nullable private OnAccessibilityChangeListener onAccessibilityChangeListener;
 
+  // Whether Flutter was told that something consumes its semantics tree. Accessibility can be
+  // enabled while nothing reads the tree, e.g., for services that only probe it once, so Flutter
+  // holds back its semantics updates until touch exploration starts or a service queries a node.
+  private boolean semanticsClientActive = true;
+
   // Handler for all messages received from Flutter via the {@code accessibilityChannel}
   private final AccessibilityChannel.AccessibilityMessageHandler accessibilityMessageHandler =
       new AccessibilityChannel.AccessibilityMessageHandler() {
@@ -277,6 +282,7 @@ public class AccessibilityBridge extends AccessibilityNodeProvider {
               if (accessibilityEnabled) {
                 accessibilityChannel.setAccessibilityMessageHandler(accessibilityMessageHandler);
                 accessibilityChannel.onAndroidAccessibilityEnabled();
+                setSemanticsClientActive(accessibilityManager.isTouchExplorationEnabled());
               } else {
                 accessibilityChannel.setAccessibilityMessageHandler(null);
                 accessibilityChannel.onAndroidAccessibilityDisabled();
@@ -375,6 +381,7 @@ public class AccessibilityBridge extends AccessibilityNodeProvider {
             @Override
             public void onTouchExplorationStateChanged(boolean isTouchExplorationEnabled) {
               if (isTouchExplorationEnabled) {
+                setSemanticsClientActive(true);
                 accessibilityFeatureFlags |= AccessibilityFeature.ACCESSIBLE_NAVIGATION.value;
               } else {
                 onTouchExplorationExit();
@@ -506,6 +513,10 @@ public class AccessibilityBridge extends AccessibilityNodeProvider {
   // Supressing Lint warning for new API, as we are version guarding all calls to newer APIs
   @SuppressLint("NewApi")
   public AccessibilityNodeInfo createAccessibilityNodeInfo(int virtualViewId) {
+    // A service reads the tree. The nodes held back by Flutter arrive with the next update, which
+    // tells the service that the content changed.
+    setSemanticsClientActive(true);
+
     if (virtualViewId >= MIN_ENGINE_GENERATED_NODE_ID) {
       // The node is in the engine generated range, and is provided by the accessibility view
       // embedder.
@@ -1244,6 +1255,14 @@ public class AccessibilityBridge extends AccessibilityNodeProvider {
     }
   }
 
+  private void setSemanticsClientActive(boolean active) {
+    if (semanticsClientActive == active) {
+      return;
+    }
+    semanticsClientActive = active;
+    accessibilityChannel.setSemanticsClientActive(active);
+  }
+
   /**
    * Updates the Android cache of Flutter's currently registered custom accessibility actions.
    *
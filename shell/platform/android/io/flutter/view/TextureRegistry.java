@@ -5,6 +5,7 @@
 package io.flutter.view;
 
 import android.graphics.SurfaceTexture;
+import android.view.Surface;
 
 // TODO(mattcarroll): re-evalute docs in this class and add nullability annotations.
 /**
@@ -31,4 +32,16 @@ public interface TextureRegistry {
     /** Deregisters and releases this SurfaceTexture. */
     void release();
   }
+
+  /** A registry entry for a texture whose frames are produced into a managed Surface. */
+  interface SurfaceProducerEntry {
+    /** @return The Surface that frames are produced into. */
+    Surface surface();
+
+    /** @return The identity of this texture. */
+    long id();
+
+    /** Deregisters this texture and releases its Surface. */
+    void release();
+  }
 }
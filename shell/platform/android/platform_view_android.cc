@@ -12,6 +12,7 @@
 #include "flutter/shell/gpu/gpu_surface_gl_delegate.h"
 #include "flutter/shell/platform/android/android_context_gl.h"
 #include "flutter/shell/platform/android/android_external_texture_gl.h"
+#include "flutter/shell/platform/android/android_external_texture_hardware_buffer.h"
 #include "flutter/shell/platform/android/android_surface_gl.h"
 #include "flutter/shell/platform/android/android_surface_software.h"
 
@@ -20,6 +21,7 @@
 #endif  // SHELL_ENABLE_VULKAN
 
 #include "flutter/shell/platform/android/context/android_context.h"
+#include "flutter/shell/platform/android/image_decoder_backend_android.h"
 #include "flutter/shell/platform/android/jni/platform_view_android_jni.h"
 #include "flutter/shell/platform/android/platform_message_response_android.h"
 #include "flutter/shell/platform/android/vsync_waiter_android.h"
@@ -70,6 +72,7 @@ PlatformViewAndroid::PlatformViewAndroid(
   FML_CHECK(android_context && android_context->IsValid())
       << "Could not create an Android context.";
 
+  android_context_ = android_context;
   android_surface_ = SurfaceFactory(std::move(android_context), jni_facade);
   FML_CHECK(android_surface_ && android_surface_->IsValid())
       << "Could not create an OpenGL, Vulkan or Software surface to setup "
@@ -87,6 +90,11 @@ PlatformViewAndroid::~PlatformViewAndroid() = default;
 
 void PlatformViewAndroid::NotifyCreated(
     fml::RefPtr<AndroidNativeWindow> native_window) {
+  native_window_ = native_window;
+  if (preferred_frame_rate_ > 0) {
+    native_window_->SetFrameRate(preferred_frame_rate_);
+  }
+
   if (android_surface_) {
     InstallFirstFrameCallback();
 
@@ -106,6 +114,11 @@ void PlatformViewAndroid::NotifyCreated(
 
 void PlatformViewAndroid::NotifySurfaceWindowChanged(
     fml::RefPtr<AndroidNativeWindow> native_window) {
+  native_window_ = native_window;
+  if (preferred_frame_rate_ > 0) {
+    native_window_->SetFrameRate(preferred_frame_rate_);
+  }
+
   if (android_surface_) {
     fml::AutoResetWaitableEvent latch;
     fml::TaskRunner::RunNowOrPostTask(
@@ -122,6 +135,7 @@ void PlatformViewAndroid::NotifySurfaceWindowChanged(
 
 void PlatformViewAndroid::NotifyDestroyed() {
   PlatformView::NotifyDestroyed();
+  native_window_ = nullptr;
 
   if (android_surface_) {
     fml::AutoResetWaitableEvent latch;
@@ -289,11 +303,11 @@ void PlatformViewAndroid::UpdateSemantics(
 
     std::vector<std::string> strings;
     size_t position = 0;
-    for (const auto& value : update) {
+    for (auto& value : update) {
       // If you edit this code, make sure you update kBytesPerNode
       // and/or kBytesPerChild above to match the number of values you are
       // sending.
-      const flutter::SemanticsNode& node = value.second;
+      flutter::SemanticsNode& node = value.second;
       buffer_int32[position++] = node.id;
       buffer_int32[position++] = node.flags;
       buffer_int32[position++] = node.actions;
@@ -311,31 +325,31 @@ void PlatformViewAndroid::UpdateSemantics(
         buffer_int32[position++] = -1;
       } else {
         buffer_int32[position++] = strings.size();
-        strings.push_back(node.label);
+        strings.push_back(std::move(node.label));
       }
       if (node.value.empty()) {
         buffer_int32[position++] = -1;
       } else {
         buffer_int32[position++] = strings.size();
-        strings.push_back(node.value);
+        strings.push_back(std::move(node.value));
       }
       if (node.increasedValue.empty()) {
         buffer_int32[position++] = -1;
       } else {
         buffer_int32[position++] = strings.size();
-        strings.push_back(node.increasedValue);
+        strings.push_back(std::move(node.increasedValue));
       }
       if (node.decreasedValue.empty()) {
         buffer_int32[position++] = -1;
       } else {
         buffer_int32[position++] = strings.size();
-        strings.push_back(node.decreasedValue);
+        strings.push_back(std::move(node.decreasedValue));
       }
       if (node.hint.empty()) {
         buffer_int32[position++] = -1;
       } else {
         buffer_int32[position++] = strings.size();
-        strings.push_back(node.hint);
+        strings.push_back(std::move(node.hint));
       }
       buffer_int32[position++] = node.textDirection;
       buffer_float32[position++] = node.rect.left();
@@ -406,9 +420,66 @@ void PlatformViewAndroid::RegisterExternalTexture(
       texture_id, surface_texture, std::move(jni_facade_)));
 }
 
+fml::jni::ScopedJavaLocalRef<jobject>
+PlatformViewAndroid::RegisterHardwareBufferTexture(JNIEnv* env,
+                                                   int64_t texture_id,
+                                                   int32_t width,
+                                                   int32_t height) {
+  if (!android_context_ ||
+      android_context_->RenderingApi() != AndroidRenderingAPI::kOpenGLES ||
+      !AndroidExternalTextureHardwareBuffer::IsSupported()) {
+    return fml::jni::ScopedJavaLocalRef<jobject>();
+  }
+  auto texture = std::make_shared<AndroidExternalTextureHardwareBuffer>(
+      texture_id, width, height, task_runners_.GetPlatformTaskRunner(),
+      [weak_view = GetWeakPtr(), texture_id]() {
+        if (weak_view) {
+          weak_view->MarkTextureFrameAvailable(texture_id);
+        }
+      });
+  if (!texture->IsValid()) {
+    return fml::jni::ScopedJavaLocalRef<jobject>();
+  }
+  auto surface = texture->GetSurface(env);
+  if (surface.is_null()) {
+    return surface;
+  }
+  RegisterTexture(std::move(texture));
+  return surface;
+}
+
 // |PlatformView|
 std::unique_ptr<VsyncWaiter> PlatformViewAndroid::CreateVSyncWaiter() {
-  return std::make_unique<VsyncWaiterAndroid>(task_runners_);
+  return std::make_unique<VsyncWaiterAndroid>(
+      task_runners_, [weak_view = GetWeakPtr()](float fps) {
+        if (weak_view) {
+          static_cast<PlatformViewAndroid*>(weak_view.get())
+              ->SetPreferredFrameRate(fps);
+        }
+      });
+}
+
+void PlatformViewAndroid::SetPreferredFrameRate(float fps) {
+  preferred_frame_rate_ = fps;
+  if (native_window_) {
+    native_window_->SetFrameRate(fps);
+  }
+}
+
+// |PlatformView|
+PointerDataDispatcherMaker PlatformViewAndroid::GetDispatcherMaker() {
+  return [](DefaultPointerDataDispatcher::Delegate& delegate) {
+    return std::make_unique<ResamplingPointerDataDispatcher>(delegate);
+  };
+}
+
+// |PlatformView|
+ImageDecoderBackends PlatformViewAndroid::CreateImageDecoderBackends() {
+  auto backend = ImageDecoderBackendAndroid::Create();
+  if (!backend) {
+    return {};
+  }
+  return {std::move(backend)};
 }
 
 // |PlatformView|
@@ -446,6 +517,31 @@ void PlatformViewAndroid::ReleaseResourceContext() const {
   }
 }
 
+// |PlatformView|
+sk_sp<GrContext> PlatformViewAndroid::CreateWorkerResourceContext() const {
+  // Only OpenGL resource contexts are shared with upload workers so far.
+  if (!android_context_ ||
+      android_context_->RenderingApi() != AndroidRenderingAPI::kOpenGLES) {
+    return nullptr;
+  }
+  auto context = static_cast<AndroidContextGL*>(android_context_.get());
+  if (!context->MakeWorkerResourceContextCurrent()) {
+    return nullptr;
+  }
+  return ShellIOManager::CreateCompatibleResourceLoadingContext(
+      GrBackend::kOpenGL_GrBackend,
+      GPUSurfaceGLDelegate::GetDefaultPlatformGLInterface());
+}
+
+// |PlatformView|
+void PlatformViewAndroid::ReleaseWorkerResourceContext() const {
+  if (android_context_ &&
+      android_context_->RenderingApi() == AndroidRenderingAPI::kOpenGLES) {
+    static_cast<AndroidContextGL*>(android_context_.get())
+        ->ClearWorkerResourceContextCurrent();
+  }
+}
+
 // |PlatformView|
 std::unique_ptr<std::vector<std::string>>
 PlatformViewAndroid::ComputePlatformResolvedLocales(
@@ -77,14 +77,29 @@ class PlatformViewAndroid final : public PlatformView {
       int64_t texture_id,
       const fml::jni::JavaObjectWeakGlobalRef& surface_texture);
 
+  // Registers a texture whose frames are produced into an image reader, and
+  // returns the `android.view.Surface` of the reader. Returns null if the
+  // device or the rendering API don't support hardware buffer textures, in
+  // which case a `SurfaceTexture` should be registered instead.
+  fml::jni::ScopedJavaLocalRef<jobject> RegisterHardwareBufferTexture(
+      JNIEnv* env,
+      int64_t texture_id,
+      int32_t width,
+      int32_t height);
+
  private:
   const std::shared_ptr<PlatformViewAndroidJNI> jni_facade_;
 
+  std::shared_ptr<AndroidContext> android_context_;
   std::unique_ptr<AndroidSurface> android_surface_;
   // We use id 0 to mean that no response is expected.
   int next_response_id_ = 1;
   std::unordered_map<int, fml::RefPtr<flutter::PlatformMessageResponse>>
       pending_responses_;
+  // The window of the surface, which the preferred frame rate of the animator
+  // is applied to.
+  fml::RefPtr<AndroidNativeWindow> native_window_;
+  float preferred_frame_rate_ = 0.0f;
 
   // |PlatformView|
   void UpdateSemantics(
@@ -101,6 +116,12 @@ class PlatformViewAndroid final : public PlatformView {
   // |PlatformView|
   std::unique_ptr<VsyncWaiter> CreateVSyncWaiter() override;
 
+  // |PlatformView|
+  PointerDataDispatcherMaker GetDispatcherMaker() override;
+
+  // |PlatformView|
+  ImageDecoderBackends CreateImageDecoderBackends() override;
+
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override;
 
@@ -110,12 +131,20 @@ class PlatformViewAndroid final : public PlatformView {
   // |PlatformView|
   void ReleaseResourceContext() const override;
 
+  // |PlatformView|
+  sk_sp<GrContext> CreateWorkerResourceContext() const override;
+
+  // |PlatformView|
+  void ReleaseWorkerResourceContext() const override;
+
   // |PlatformView|
   std::unique_ptr<std::vector<std::string>> ComputePlatformResolvedLocales(
       const std::vector<std::string>& supported_locale_data) override;
 
   void InstallFirstFrameCallback();
 
+  void SetPreferredFrameRate(float fps);
+
   void FireFirstFrameCallback();
 
   FML_DISALLOW_COPY_AND_ASSIGN(PlatformViewAndroid);
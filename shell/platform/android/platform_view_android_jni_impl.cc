@@ -203,8 +203,9 @@ static void RunBundleAndSnapshotFromLibrary(JNIEnv* env,
       FML_DLOG(ERROR) << "Unable to load the kernel blob asset.";
       return;
     }
-    isolate_configuration =
-        IsolateConfiguration::CreateForKernel(std::move(kernel_blob));
+    isolate_configuration = IsolateConfiguration::CreateForKernel(
+        ANDROID_SHELL_HOLDER->GetSettings().application_kernel_asset,
+        std::move(kernel_blob));
   }
 
   RunConfiguration config(std::move(isolate_configuration),
@@ -410,6 +411,13 @@ static void SetSemanticsEnabled(JNIEnv* env,
   ANDROID_SHELL_HOLDER->GetPlatformView()->SetSemanticsEnabled(enabled);
 }
 
+static void SetSemanticsClientActive(JNIEnv* env,
+                                     jobject jcaller,
+                                     jlong shell_holder,
+                                     jboolean active) {
+  ANDROID_SHELL_HOLDER->GetPlatformView()->SetSemanticsClientActive(active);
+}
+
 static void SetAccessibilityFeatures(JNIEnv* env,
                                      jobject jcaller,
                                      jlong shell_holder,
@@ -432,6 +440,21 @@ static void RegisterTexture(JNIEnv* env,
   );
 }
 
+static jobject RegisterHardwareBufferTexture(JNIEnv* env,
+                                             jobject jcaller,
+                                             jlong shell_holder,
+                                             jlong texture_id,
+                                             jint width,
+                                             jint height) {
+  return ANDROID_SHELL_HOLDER->GetPlatformView()
+      ->RegisterHardwareBufferTexture(env,                               //
+                                      static_cast<int64_t>(texture_id),  //
+                                      width,                             //
+                                      height                             //
+                                      )
+      .Release();
+}
+
 static void MarkTextureFrameAvailable(JNIEnv* env,
                                       jobject jcaller,
                                       jlong shell_holder,
@@ -478,6 +501,30 @@ static void NotifyLowMemoryWarning(JNIEnv* env,
   ANDROID_SHELL_HOLDER->NotifyLowMemoryWarning();
 }
 
+static void NotifyMemoryPressure(JNIEnv* env,
+                                 jobject obj,
+                                 jlong shell_holder,
+                                 jint level) {
+  // The levels are those of FlutterJNI.MEMORY_PRESSURE_LEVEL_*.
+  switch (level) {
+    case 0:
+      ANDROID_SHELL_HOLDER->NotifyMemoryPressure(
+          MemoryPressureLevel::kModerate);
+      break;
+    case 1:
+      ANDROID_SHELL_HOLDER->NotifyMemoryPressure(
+          MemoryPressureLevel::kCritical);
+      break;
+    case 2:
+      ANDROID_SHELL_HOLDER->NotifyMemoryPressure(
+          MemoryPressureLevel::kBackground);
+      break;
+    default:
+      FML_DLOG(ERROR) << "Unknown memory pressure level " << level;
+      break;
+  }
+}
+
 static jboolean FlutterTextUtilsIsEmoji(JNIEnv* env,
                                         jobject obj,
                                         jint codePoint) {
@@ -553,6 +600,11 @@ bool RegisterApi(JNIEnv* env) {
           .signature = "(J)V",
           .fnPtr = reinterpret_cast<void*>(&NotifyLowMemoryWarning),
       },
+      {
+          .name = "nativeNotifyMemoryPressure",
+          .signature = "(JI)V",
+          .fnPtr = reinterpret_cast<void*>(&NotifyMemoryPressure),
+      },
 
       // Start of methods from FlutterView
       {
@@ -600,6 +652,11 @@ bool RegisterApi(JNIEnv* env) {
           .signature = "(JZ)V",
           .fnPtr = reinterpret_cast<void*>(&SetSemanticsEnabled),
       },
+      {
+          .name = "nativeSetSemanticsClientActive",
+          .signature = "(JZ)V",
+          .fnPtr = reinterpret_cast<void*>(&SetSemanticsClientActive),
+      },
       {
           .name = "nativeSetAccessibilityFeatures",
           .signature = "(JI)V",
@@ -615,6 +672,11 @@ bool RegisterApi(JNIEnv* env) {
           .signature = "(JJLandroid/graphics/SurfaceTexture;)V",
           .fnPtr = reinterpret_cast<void*>(&RegisterTexture),
       },
+      {
+          .name = "nativeRegisterHardwareBufferTexture",
+          .signature = "(JJII)Landroid/view/Surface;",
+          .fnPtr = reinterpret_cast<void*>(&RegisterHardwareBufferTexture),
+      },
       {
           .name = "nativeMarkTextureFrameAvailable",
           .signature = "(JJ)V",
@@ -928,10 +990,10 @@ void PlatformViewAndroidJNIImpl::FlutterViewHandlePlatformMessage(
 
   if (message->hasData()) {
     fml::jni::ScopedJavaLocalRef<jbyteArray> message_array(
-        env, env->NewByteArray(message->data().size()));
+        env, env->NewByteArray(message->data().GetSize()));
     env->SetByteArrayRegion(
-        message_array.obj(), 0, message->data().size(),
-        reinterpret_cast<const jbyte*>(message->data().data()));
+        message_array.obj(), 0, message->data().GetSize(),
+        reinterpret_cast<const jbyte*>(message->data().GetMapping()));
     env->CallVoidMethod(java_object.obj(), g_handle_platform_message_method,
                         java_channel.obj(), message_array.obj(), responseId);
   } else {
@@ -1154,12 +1216,11 @@ void PlatformViewAndroidJNIImpl::FlutterViewOnDisplayPlatformView(
   jobject mutatorsStack = env->NewObject(g_mutators_stack_class->obj(),
                                          g_mutators_stack_init_method);
 
-  std::vector<std::shared_ptr<Mutator>>::const_iterator iter =
-      mutators_stack.Begin();
+  MutatorsStack::const_iterator iter = mutators_stack.Begin();
   while (iter != mutators_stack.End()) {
-    switch ((*iter)->GetType()) {
+    switch (iter->GetType()) {
       case transform: {
-        const SkMatrix& matrix = (*iter)->GetMatrix();
+        const SkMatrix& matrix = iter->GetMatrix();
         SkScalar matrix_array[9];
         matrix.get9(matrix_array);
         fml::jni::ScopedJavaLocalRef<jfloatArray> transformMatrix(
@@ -1172,7 +1233,7 @@ void PlatformViewAndroidJNIImpl::FlutterViewOnDisplayPlatformView(
         break;
       }
       case clip_rect: {
-        const SkRect& rect = (*iter)->GetRect();
+        const SkRect& rect = iter->GetRect();
         env->CallVoidMethod(mutatorsStack,
                             g_mutators_stack_push_cliprect_method,
                             (int)rect.left(), (int)rect.top(),
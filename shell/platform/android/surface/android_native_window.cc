@@ -4,8 +4,36 @@
 
 #include "flutter/shell/platform/android/surface/android_native_window.h"
 
+#if OS_ANDROID
+#include "flutter/fml/native_library.h"
+#endif  // OS_ANDROID
+
 namespace flutter {
 
+#if OS_ANDROID
+// The NDK only declares ANativeWindow_setFrameRate from API 30, so it is
+// resolved at runtime.
+using SetFrameRateProc = int32_t (*)(ANativeWindow* window,
+                                     float frame_rate,
+                                     int8_t compatibility);
+
+// ANATIVEWINDOW_FRAME_RATE_COMPATIBILITY_DEFAULT.
+static constexpr int8_t kFrameRateCompatibilityDefault = 0;
+
+static SetFrameRateProc GetSetFrameRateProc() {
+  static const SetFrameRateProc proc = []() -> SetFrameRateProc {
+    auto library = fml::NativeLibrary::Create("libandroid.so");
+    if (!library) {
+      return nullptr;
+    }
+    // libandroid is never unloaded, so the symbol outlives |library|.
+    return reinterpret_cast<SetFrameRateProc>(
+        library->ResolveSymbol("ANativeWindow_setFrameRate"));
+  }();
+  return proc;
+}
+#endif  // OS_ANDROID
+
 AndroidNativeWindow::AndroidNativeWindow(Handle window) : window_(window) {}
 
 AndroidNativeWindow::~AndroidNativeWindow() {
@@ -35,4 +63,16 @@ SkISize AndroidNativeWindow::GetSize() const {
 #endif  // OS_ANDROID
 }
 
+bool AndroidNativeWindow::SetFrameRate(float fps) const {
+#if OS_ANDROID
+  SetFrameRateProc set_frame_rate = GetSetFrameRateProc();
+  if (window_ == nullptr || set_frame_rate == nullptr) {
+    return false;
+  }
+  return set_frame_rate(window_, fps, kFrameRateCompatibilityDefault) == 0;
+#else   // OS_ANDROID
+  return false;
+#endif  // OS_ANDROID
+}
+
 }  // namespace flutter
@@ -32,6 +32,12 @@ class AndroidNativeWindow
 
   SkISize GetSize() const;
 
+  /// Asks the compositor to refresh the display showing the window at |fps|
+  /// frames per second, or at the rate it picks if |fps| is zero. Returns
+  /// false if the OS doesn't support frame rates for windows, which it does
+  /// from API 30.
+  bool SetFrameRate(float fps) const;
+
  private:
   Handle window_;
 
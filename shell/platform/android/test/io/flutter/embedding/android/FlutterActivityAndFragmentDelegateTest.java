@@ -20,6 +20,7 @@ import androidx.lifecycle.Lifecycle;
 import io.flutter.embedding.android.FlutterActivityAndFragmentDelegate.Host;
 import io.flutter.embedding.engine.FlutterEngine;
 import io.flutter.embedding.engine.FlutterEngineCache;
+import io.flutter.embedding.engine.FlutterJNI;
 import io.flutter.embedding.engine.FlutterShellArgs;
 import io.flutter.embedding.engine.dart.DartExecutor;
 import io.flutter.embedding.engine.plugins.activity.ActivityControlSurface;
@@ -461,7 +462,12 @@ public class FlutterActivityAndFragmentDelegateTest {
     delegate.onTrimMemory(TRIM_MEMORY_UI_HIDDEN);
 
     // Verify that the call was forwarded to the engine.
-    verify(mockFlutterEngine.getDartExecutor(), times(7)).notifyLowMemoryWarning();
+    verify(mockFlutterEngine.getDartExecutor(), times(1))
+        .notifyMemoryPressure(FlutterJNI.MEMORY_PRESSURE_LEVEL_MODERATE);
+    verify(mockFlutterEngine.getDartExecutor(), times(2))
+        .notifyMemoryPressure(FlutterJNI.MEMORY_PRESSURE_LEVEL_CRITICAL);
+    verify(mockFlutterEngine.getDartExecutor(), times(4))
+        .notifyMemoryPressure(FlutterJNI.MEMORY_PRESSURE_LEVEL_BACKGROUND);
     verify(mockFlutterEngine.getSystemChannel(), times(1)).sendMemoryPressureWarning();
   }
 
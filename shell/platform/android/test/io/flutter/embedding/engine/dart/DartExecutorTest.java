@@ -49,4 +49,15 @@ public class DartExecutorTest {
     dartExecutor.notifyLowMemoryWarning();
     verify(mockFlutterJNI, times(1)).notifyLowMemoryWarning();
   }
+
+  @Test
+  public void itNotifiesMemoryPressure() {
+    FlutterJNI mockFlutterJNI = mock(FlutterJNI.class);
+    when(mockFlutterJNI.isAttached()).thenReturn(true);
+
+    DartExecutor dartExecutor = new DartExecutor(mockFlutterJNI, mock(AssetManager.class));
+    dartExecutor.notifyMemoryPressure(FlutterJNI.MEMORY_PRESSURE_LEVEL_BACKGROUND);
+    verify(mockFlutterJNI, times(1))
+        .notifyMemoryPressure(FlutterJNI.MEMORY_PRESSURE_LEVEL_BACKGROUND);
+  }
 }
@@ -4,23 +4,93 @@
 
 #include "flutter/shell/platform/android/vsync_waiter_android.h"
 
+#include <atomic>
 #include <cmath>
 #include <utility>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/native_library.h"
 #include "flutter/fml/platform/android/jni_util.h"
 #include "flutter/fml/platform/android/scoped_java_ref.h"
 #include "flutter/fml/size.h"
 #include "flutter/fml/trace_event.h"
 
+// The NDK only declares AChoreographer_postFrameCallback64 from API 29, and
+// the engine supports older versions, so the choreographer functions are
+// resolved at runtime.
+struct AChoreographer;
+
 namespace flutter {
 
 static fml::jni::ScopedJavaGlobalRef<jclass>* g_vsync_waiter_class = nullptr;
 static jmethodID g_async_wait_for_vsync_method_ = nullptr;
+static jfieldID g_refresh_rate_fps_field_ = nullptr;
+
+// The refresh period reported by the NDK choreographer, or zero if unknown.
+static std::atomic<int64_t> g_vsync_period_nanos = 0;
+
+struct AChoreographerProcs {
+  using FrameCallback64 = void (*)(int64_t frame_time_nanos, void* data);
+  using RefreshRateCallback = void (*)(int64_t vsync_period_nanos, void* data);
+
+  fml::RefPtr<fml::NativeLibrary> library;
+  AChoreographer* (*AChoreographer_getInstance)() = nullptr;
+  void (*AChoreographer_postFrameCallback64)(AChoreographer* choreographer,
+                                             FrameCallback64 callback,
+                                             void* data) = nullptr;
+  // Only available from API 30.
+  void (*AChoreographer_registerRefreshRateCallback)(
+      AChoreographer* choreographer,
+      RefreshRateCallback callback,
+      void* data) = nullptr;
+};
+
+// Returns null if the NDK choreographer can't post frame callbacks.
+static const AChoreographerProcs* GetAChoreographerProcs() {
+  static const AChoreographerProcs* procs = []() -> AChoreographerProcs* {
+    auto library = fml::NativeLibrary::Create("libandroid.so");
+    if (!library) {
+      return nullptr;
+    }
+    auto procs = new AChoreographerProcs();
+    procs->library = library;
+    procs->AChoreographer_getInstance =
+        reinterpret_cast<decltype(procs->AChoreographer_getInstance)>(
+            library->ResolveSymbol("AChoreographer_getInstance"));
+    procs->AChoreographer_postFrameCallback64 =
+        reinterpret_cast<decltype(procs->AChoreographer_postFrameCallback64)>(
+            library->ResolveSymbol("AChoreographer_postFrameCallback64"));
+    procs->AChoreographer_registerRefreshRateCallback = reinterpret_cast<
+        decltype(procs->AChoreographer_registerRefreshRateCallback)>(
+        library->ResolveSymbol("AChoreographer_registerRefreshRateCallback"));
+    if (procs->AChoreographer_getInstance == nullptr ||
+        procs->AChoreographer_postFrameCallback64 == nullptr) {
+      delete procs;
+      return nullptr;
+    }
+    return procs;
+  }();
+  return procs;
+}
+
+// The refresh rate the Java embedding reported for the default display.
+static float GetJavaRefreshRateFPS() {
+  JNIEnv* env = fml::jni::AttachCurrentThread();
+  if (g_vsync_waiter_class == nullptr) {
+    return VsyncWaiter::kUnknownRefreshRateFPS;
+  }
+  jclass clazz = g_vsync_waiter_class->obj();
+  if (clazz == nullptr) {
+    return VsyncWaiter::kUnknownRefreshRateFPS;
+  }
+  return env->GetStaticFloatField(clazz, g_refresh_rate_fps_field_);
+}
 
-VsyncWaiterAndroid::VsyncWaiterAndroid(flutter::TaskRunners task_runners)
-    : VsyncWaiter(std::move(task_runners)) {}
+VsyncWaiterAndroid::VsyncWaiterAndroid(flutter::TaskRunners task_runners,
+                                       SetFrameRateCallback set_frame_rate)
+    : VsyncWaiter(std::move(task_runners)),
+      set_frame_rate_(std::move(set_frame_rate)) {}
 
 VsyncWaiterAndroid::~VsyncWaiterAndroid() = default;
 
@@ -29,6 +99,13 @@ void VsyncWaiterAndroid::AwaitVSync() {
   auto* weak_this = new std::weak_ptr<VsyncWaiter>(shared_from_this());
   jlong java_baton = reinterpret_cast<jlong>(weak_this);
 
+  // The UI thread has a looper, so the NDK choreographer calls back on it
+  // without going through the platform thread and JNI.
+  if (task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread() &&
+      PostAChoreographerFrameCallback(java_baton)) {
+    return;
+  }
+
   task_runners_.GetPlatformTaskRunner()->PostTask([java_baton]() {
     JNIEnv* env = fml::jni::AttachCurrentThread();
     env->CallStaticVoidMethod(g_vsync_waiter_class->obj(),     //
@@ -39,16 +116,75 @@ void VsyncWaiterAndroid::AwaitVSync() {
 }
 
 float VsyncWaiterAndroid::GetDisplayRefreshRate() const {
-  JNIEnv* env = fml::jni::AttachCurrentThread();
-  if (g_vsync_waiter_class == nullptr) {
-    return kUnknownRefreshRateFPS;
+  const int64_t vsync_period_nanos = g_vsync_period_nanos.load();
+  if (vsync_period_nanos > 0) {
+    return static_cast<float>(1e9 / vsync_period_nanos);
   }
-  jclass clazz = g_vsync_waiter_class->obj();
-  if (clazz == nullptr) {
-    return kUnknownRefreshRateFPS;
+  return GetJavaRefreshRateFPS();
+}
+
+// |VsyncWaiter|
+void VsyncWaiterAndroid::SetPreferredFrameRate(float fps) {
+  if (!set_frame_rate_) {
+    return;
   }
-  jfieldID fid = env->GetStaticFieldID(clazz, "refreshRateFPS", "F");
-  return env->GetStaticFloatField(clazz, fid);
+  // The surface is owned by the platform thread.
+  task_runners_.GetPlatformTaskRunner()->PostTask(
+      [set_frame_rate = set_frame_rate_, fps]() { set_frame_rate(fps); });
+}
+
+// static
+bool VsyncWaiterAndroid::PostAChoreographerFrameCallback(jlong java_baton) {
+  const AChoreographerProcs* procs = GetAChoreographerProcs();
+  if (procs == nullptr) {
+    return false;
+  }
+  // The choreographer is specific to the thread, and must be fetched on it.
+  static thread_local AChoreographer* choreographer = nullptr;
+  if (choreographer == nullptr) {
+    choreographer = procs->AChoreographer_getInstance();
+    if (choreographer == nullptr) {
+      return false;
+    }
+    if (procs->AChoreographer_registerRefreshRateCallback != nullptr) {
+      procs->AChoreographer_registerRefreshRateCallback(
+          choreographer, &OnAChoreographerRefreshRate, nullptr);
+    }
+  }
+  procs->AChoreographer_postFrameCallback64(
+      choreographer, &OnAChoreographerFrame,
+      reinterpret_cast<void*>(java_baton));
+  return true;
+}
+
+// static
+void VsyncWaiterAndroid::OnAChoreographerFrame(int64_t frame_time_nanos,
+                                               void* data) {
+  TRACE_EVENT0("flutter", "VSYNC");
+
+  int64_t vsync_period_nanos = g_vsync_period_nanos.load();
+  if (vsync_period_nanos <= 0) {
+    // Before API 30, the NDK choreographer doesn't report the refresh rate.
+    float fps = GetJavaRefreshRateFPS();
+    if (fps <= 0) {
+      fps = 60;
+    }
+    vsync_period_nanos = static_cast<int64_t>(1e9 / fps);
+  }
+
+  auto frame_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromNanoseconds(frame_time_nanos));
+  auto target_time =
+      frame_time + fml::TimeDelta::FromNanoseconds(vsync_period_nanos);
+
+  ConsumePendingCallback(reinterpret_cast<jlong>(data), frame_time,
+                         target_time);
+}
+
+// static
+void VsyncWaiterAndroid::OnAChoreographerRefreshRate(int64_t vsync_period_nanos,
+                                                     void* data) {
+  g_vsync_period_nanos = vsync_period_nanos;
 }
 
 // static
@@ -104,6 +240,11 @@ bool VsyncWaiterAndroid::Register(JNIEnv* env) {
 
   FML_CHECK(g_async_wait_for_vsync_method_ != nullptr);
 
+  g_refresh_rate_fps_field_ =
+      env->GetStaticFieldID(g_vsync_waiter_class->obj(), "refreshRateFPS", "F");
+
+  FML_CHECK(g_refresh_rate_fps_field_ != nullptr);
+
   return env->RegisterNatives(clazz, methods, fml::size(methods)) == 0;
 }
 
@@ -7,6 +7,7 @@
 
 #include <jni.h>
 
+#include <functional>
 #include <memory>
 
 #include "flutter/fml/macros.h"
@@ -18,16 +19,33 @@ class VsyncWaiterAndroid final : public VsyncWaiter {
  public:
   static bool Register(JNIEnv* env);
 
-  VsyncWaiterAndroid(flutter::TaskRunners task_runners);
+  using SetFrameRateCallback = std::function<void(float fps)>;
+
+  // |set_frame_rate| is called on the platform thread with the frame rates
+  // the animator prefers, see |VsyncWaiter::SetPreferredFrameRate|.
+  VsyncWaiterAndroid(flutter::TaskRunners task_runners,
+                     SetFrameRateCallback set_frame_rate = nullptr);
 
   ~VsyncWaiterAndroid() override;
 
   float GetDisplayRefreshRate() const override;
 
+  // |VsyncWaiter|
+  void SetPreferredFrameRate(float fps) override;
+
  private:
   // |VsyncWaiter|
   void AwaitVSync() override;
 
+  static void OnAChoreographerFrame(int64_t frame_time_nanos, void* data);
+
+  static void OnAChoreographerRefreshRate(int64_t vsync_period_nanos,
+                                          void* data);
+
+  // Posts a frame callback to the NDK choreographer of the current thread.
+  // Returns false if the OS doesn't support frame callbacks from native code.
+  static bool PostAChoreographerFrameCallback(jlong java_baton);
+
   static void OnNativeVsync(JNIEnv* env,
                             jclass jcaller,
                             jlong frameTimeNanos,
@@ -38,6 +56,8 @@ class VsyncWaiterAndroid final : public VsyncWaiter {
                                      fml::TimePoint frame_start_time,
                                      fml::TimePoint frame_target_time);
 
+  SetFrameRateCallback set_frame_rate_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterAndroid);
 };
 
@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/basic_message_channel.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/binary_messenger.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/cpp/json_message_codec.h"
+
+namespace flutter {
+namespace benchmarking {
+
+namespace {
+
+constexpr char kChannelName[] = "benchmark/echo";
+
+// A messenger that delivers messages to its own handlers, standing in for the
+// engine and the Dart side of a channel. Like the engine, it copies messages
+// and replies on their way through.
+class LoopbackBinaryMessenger : public BinaryMessenger {
+ public:
+  // |flutter::BinaryMessenger|
+  void Send(const std::string& channel,
+            const uint8_t* message,
+            size_t message_size,
+            BinaryReply reply) const override {
+    auto it = handlers_.find(channel);
+    if (it == handlers_.end()) {
+      if (reply) {
+        reply(nullptr, 0);
+      }
+      return;
+    }
+    std::vector<uint8_t> message_copy(message, message + message_size);
+    it->second(message_copy.data(), message_copy.size(),
+               [reply](const uint8_t* data, size_t size) {
+                 std::vector<uint8_t> reply_copy(data, data + size);
+                 if (reply) {
+                   reply(reply_copy.data(), reply_copy.size());
+                 }
+               });
+  }
+
+  // |flutter::BinaryMessenger|
+  void SetMessageHandler(const std::string& channel,
+                         BinaryMessageHandler handler) override {
+    if (!handler) {
+      handlers_.erase(channel);
+      return;
+    }
+    handlers_[channel] = std::move(handler);
+  }
+
+ private:
+  std::map<std::string, BinaryMessageHandler> handlers_;
+};
+
+// Sends |message| over a channel whose other end echoes it back, decoding
+// each reply with |codec|, until |state| is done.
+template <typename T>
+void RoundTrip(benchmark::State& state,
+               const MessageCodec<T>& codec,
+               const T& message) {
+  LoopbackBinaryMessenger messenger;
+  BasicMessageChannel<T> echo(&messenger, kChannelName, &codec);
+  echo.SetMessageHandler(
+      [](const T& message, const MessageReply<T>& reply) { reply(message); });
+
+  BasicMessageChannel<T> channel(&messenger, kChannelName, &codec);
+  size_t message_size = codec.EncodeMessage(message)->size();
+  while (state.KeepRunning()) {
+    channel.Send(message, [&codec](const uint8_t* reply, size_t reply_size) {
+      auto decoded = codec.DecodeMessage(reply, reply_size);
+      benchmark::DoNotOptimize(decoded);
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * message_size * 2);
+}
+
+}  // namespace
+
+static void BM_ChannelRoundTripBinary(benchmark::State& state) {
+  LoopbackBinaryMessenger messenger;
+  messenger.SetMessageHandler(
+      kChannelName,
+      [](const uint8_t* message, size_t message_size, BinaryReply reply) {
+        reply(message, message_size);
+      });
+
+  std::vector<uint8_t> message(state.range(0), 0x2a);
+  while (state.KeepRunning()) {
+    messenger.Send(kChannelName, message.data(), message.size(),
+                   [](const uint8_t* reply, size_t reply_size) {
+                     benchmark::DoNotOptimize(reply);
+                   });
+  }
+  state.SetBytesProcessed(state.iterations() * message.size() * 2);
+}
+
+static void BM_ChannelRoundTripStandardByteList(benchmark::State& state) {
+  EncodableValue message(std::vector<uint8_t>(state.range(0), 0x2a));
+  RoundTrip(state, StandardMessageCodec::GetInstance(), message);
+}
+
+static void BM_ChannelRoundTripStandardString(benchmark::State& state) {
+  EncodableValue message(std::string(state.range(0), 'a'));
+  RoundTrip(state, StandardMessageCodec::GetInstance(), message);
+}
+
+static void BM_ChannelRoundTripJsonString(benchmark::State& state) {
+  rapidjson::Document message;
+  std::string text(state.range(0), 'a');
+  message.SetString(text.data(),
+                    static_cast<rapidjson::SizeType>(text.size()),
+                    message.GetAllocator());
+  RoundTrip(state, JsonMessageCodec::GetInstance(), message);
+}
+
+BENCHMARK(BM_ChannelRoundTripBinary)->RangeMultiplier(16)->Range(16, 16 << 20);
+BENCHMARK(BM_ChannelRoundTripStandardByteList)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_ChannelRoundTripStandardString)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_ChannelRoundTripJsonString)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+
+}  // namespace benchmarking
+}  // namespace flutter
@@ -2,12 +2,13 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_BYTE_STREAM_WRAPPERS_H_
-#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_BYTE_STREAM_WRAPPERS_H_
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_BYTE_STREAM_WRAPPERS_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_BYTE_STREAM_WRAPPERS_H_
 
 // Utility classes for interacting with a buffer of bytes as a stream, for use
 // in message channel codecs.
 
+#include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
@@ -44,6 +45,23 @@ class ByteBufferStreamReader {
     location_ += length;
   }
 
+  // Returns a pointer to the next |length| bytes in the wrapped buffer, without
+  // copying them, and advances past them. Returns nullptr if fewer than
+  // |length| bytes remain.
+  const uint8_t* ReadBytesInPlace(size_t length) {
+    if (!HasRemaining(length)) {
+      return nullptr;
+    }
+    const uint8_t* bytes = &bytes_[location_];
+    location_ += length;
+    return bytes;
+  }
+
+  // Returns whether at least |length| more bytes can be read.
+  bool HasRemaining(size_t length) const {
+    return location_ <= size_ && length <= size_ - location_;
+  }
+
   // Advances the read cursor to the next multiple of |alignment| relative to
   // the start of the wrapped byte buffer, unless it is already aligned.
   void ReadAlignment(uint8_t alignment) {
@@ -102,4 +120,4 @@ class ByteBufferStreamWriter {
 
 }  // namespace flutter
 
-#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_BYTE_STREAM_WRAPPERS_H_
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_BYTE_STREAM_WRAPPERS_H_
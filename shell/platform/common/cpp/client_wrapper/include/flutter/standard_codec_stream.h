@@ -0,0 +1,122 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "byte_stream_wrappers.h"
+
+namespace flutter {
+
+// Receives the values of a message in the standard codec encoding as they are
+// read by a StandardCodecStreamReader, as an alternative to decoding the
+// message into an EncodableValue tree.
+//
+// Pointers passed to the visitor are only valid for the duration of the call.
+// They usually point into the message itself, so nothing is copied unless the
+// visitor keeps the data.
+//
+// All methods do nothing by default.
+class StandardCodecVisitor {
+ public:
+  virtual ~StandardCodecVisitor() = default;
+
+  virtual void VisitNull() {}
+  virtual void VisitBool(bool value) {}
+  virtual void VisitInt(int32_t value) {}
+  virtual void VisitLong(int64_t value) {}
+  virtual void VisitDouble(double value) {}
+  // |value| is not null terminated.
+  virtual void VisitString(const char* value, size_t length) {}
+  virtual void VisitByteList(const uint8_t* values, size_t count) {}
+  virtual void VisitIntList(const int32_t* values, size_t count) {}
+  virtual void VisitLongList(const int64_t* values, size_t count) {}
+  virtual void VisitDoubleList(const double* values, size_t count) {}
+
+  // Called before the |length| values of a list are visited, and EndList
+  // after.
+  virtual void BeginList(size_t length) {}
+  virtual void EndList() {}
+
+  // Called before the |length| entries of a map are visited, each as its key
+  // followed by its value, and EndMap after.
+  virtual void BeginMap(size_t length) {}
+  virtual void EndMap() {}
+};
+
+// Reads values in the standard codec encoding from a buffer and reports them
+// to a StandardCodecVisitor, without allocating anything for them.
+class StandardCodecStreamReader {
+ public:
+  // Creates a reader reading from |bytes|, which must have a length of |size|.
+  // |bytes| must remain valid for the lifetime of this object.
+  StandardCodecStreamReader(const uint8_t* bytes, size_t size);
+  ~StandardCodecStreamReader();
+
+  // Prevent copying.
+  StandardCodecStreamReader(StandardCodecStreamReader const&) = delete;
+  StandardCodecStreamReader& operator=(StandardCodecStreamReader const&) =
+      delete;
+
+  // Reads the next value, including all the values in it for lists and maps,
+  // and reports it to |visitor|. Returns false if the buffer doesn't hold a
+  // valid encoding, in which case |visitor| may have seen part of the value.
+  bool ReadValue(StandardCodecVisitor* visitor);
+
+ private:
+  ByteBufferStreamReader stream_;
+
+  bool ReadSize(size_t* size);
+
+  template <typename T>
+  bool ReadList(size_t* count, const T** values, std::vector<T>* scratch);
+};
+
+// Writes values in the standard codec encoding to a buffer one at a time, as
+// an alternative to building an EncodableValue tree to encode.
+//
+// Lists and maps are written by starting them with their length, then writing
+// that many values, or keys and values alternating for maps.
+class StandardCodecStreamWriter {
+ public:
+  // Creates a writer that appends to |buffer|.
+  // |buffer| must remain valid for the lifetime of this object.
+  explicit StandardCodecStreamWriter(std::vector<uint8_t>* buffer);
+  ~StandardCodecStreamWriter();
+
+  // Prevent copying.
+  StandardCodecStreamWriter(StandardCodecStreamWriter const&) = delete;
+  StandardCodecStreamWriter& operator=(StandardCodecStreamWriter const&) =
+      delete;
+
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteInt(int32_t value);
+  void WriteLong(int64_t value);
+  void WriteDouble(double value);
+  void WriteString(const char* value, size_t length);
+  void WriteString(const std::string& value);
+  void WriteByteList(const uint8_t* values, size_t count);
+  void WriteIntList(const int32_t* values, size_t count);
+  void WriteLongList(const int64_t* values, size_t count);
+  void WriteDoubleList(const double* values, size_t count);
+  void BeginList(size_t length);
+  void BeginMap(size_t length);
+
+ private:
+  ByteBufferStreamWriter stream_;
+
+  void WriteSize(size_t size);
+
+  template <typename T>
+  void WriteList(uint8_t type, const T* values, size_t count);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
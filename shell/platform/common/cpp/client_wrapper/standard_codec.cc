@@ -3,15 +3,18 @@
 // found in the LICENSE file.
 
 // This file contains what would normally be standard_codec_serializer.cc,
-// standard_message_codec.cc, and standard_method_codec.cc. They are grouped
-// together to simplify use of the client wrapper, since the common case is
-// that any client that needs one of these files needs all three.
+// standard_codec_stream.cc, standard_message_codec.cc, and
+// standard_method_codec.cc. They are grouped together to simplify use of the
+// client wrapper, since the common case is that any client that needs one of
+// these files needs all of them.
 
+#include "include/flutter/standard_codec_stream.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
 #include "standard_codec_serializer.h"
 
 #include <assert.h>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
@@ -74,6 +77,50 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Reads the variable-length size from the current position in |stream|.
+// Returns false if |stream| ends before the size does.
+bool ReadEncodedSize(ByteBufferStreamReader* stream, size_t* size) {
+  if (!stream->HasRemaining(1)) {
+    return false;
+  }
+  uint8_t byte = stream->ReadByte();
+  if (byte < 254) {
+    *size = byte;
+    return true;
+  }
+  if (byte == 254) {
+    uint16_t value;
+    if (!stream->HasRemaining(2)) {
+      return false;
+    }
+    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
+    *size = value;
+    return true;
+  }
+  uint32_t value;
+  if (!stream->HasRemaining(4)) {
+    return false;
+  }
+  stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
+  *size = value;
+  return true;
+}
+
+// Writes the variable-length size encoding to |stream|.
+void WriteEncodedSize(size_t size, ByteBufferStreamWriter* stream) {
+  if (size < 254) {
+    stream->WriteByte(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    stream->WriteByte(254);
+    uint16_t value = static_cast<uint16_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
+  } else {
+    stream->WriteByte(255);
+    uint32_t value = static_cast<uint32_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
+  }
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -112,7 +159,7 @@ EncodableValue StandardCodecSerializer::ReadValue(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -129,7 +176,7 @@ EncodableValue StandardCodecSerializer::ReadValue(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -139,7 +186,7 @@ EncodableValue StandardCodecSerializer::ReadValue(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
   }
   std::cerr << "Unknown type in StandardCodecSerializer::ReadValue: "
@@ -210,33 +257,18 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
 }
 
 size_t StandardCodecSerializer::ReadSize(ByteBufferStreamReader* stream) const {
-  uint8_t byte = stream->ReadByte();
-  if (byte < 254) {
-    return byte;
-  } else if (byte == 254) {
-    uint16_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
-    return value;
-  } else {
-    uint32_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
-    return value;
+  size_t size = 0;
+  if (!ReadEncodedSize(stream, &size)) {
+    std::cerr << "Invalid size in StandardCodecSerializer::ReadSize"
+              << std::endl;
+    return 0;
   }
+  return size;
 }
 
 void StandardCodecSerializer::WriteSize(size_t size,
                                         ByteBufferStreamWriter* stream) const {
-  if (size < 254) {
-    stream->WriteByte(static_cast<uint8_t>(size));
-  } else if (size <= 0xffff) {
-    stream->WriteByte(254);
-    uint16_t value = static_cast<uint16_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
-  } else {
-    stream->WriteByte(255);
-    uint32_t value = static_cast<uint32_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
-  }
+  WriteEncodedSize(size, stream);
 }
 
 template <typename T>
@@ -251,12 +283,12 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
 void StandardCodecSerializer::WriteVector(
-    const std::vector<T> vector,
+    const std::vector<T>& vector,
     ByteBufferStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -271,6 +303,278 @@ void StandardCodecSerializer::WriteVector(
                      count * type_size);
 }
 
+// ===== standard_codec_stream.h =====
+
+StandardCodecStreamReader::StandardCodecStreamReader(const uint8_t* bytes,
+                                                     size_t size)
+    : stream_(bytes, size) {}
+
+StandardCodecStreamReader::~StandardCodecStreamReader() = default;
+
+bool StandardCodecStreamReader::ReadValue(StandardCodecVisitor* visitor) {
+  if (!stream_.HasRemaining(1)) {
+    return false;
+  }
+  EncodedType type = static_cast<EncodedType>(stream_.ReadByte());
+  switch (type) {
+    case EncodedType::kNull:
+      visitor->VisitNull();
+      return true;
+    case EncodedType::kTrue:
+      visitor->VisitBool(true);
+      return true;
+    case EncodedType::kFalse:
+      visitor->VisitBool(false);
+      return true;
+    case EncodedType::kInt32: {
+      const uint8_t* bytes = stream_.ReadBytesInPlace(4);
+      if (!bytes) {
+        return false;
+      }
+      int32_t int_value;
+      std::memcpy(&int_value, bytes, 4);
+      visitor->VisitInt(int_value);
+      return true;
+    }
+    case EncodedType::kInt64: {
+      const uint8_t* bytes = stream_.ReadBytesInPlace(8);
+      if (!bytes) {
+        return false;
+      }
+      int64_t long_value;
+      std::memcpy(&long_value, bytes, 8);
+      visitor->VisitLong(long_value);
+      return true;
+    }
+    case EncodedType::kFloat64: {
+      stream_.ReadAlignment(8);
+      const uint8_t* bytes = stream_.ReadBytesInPlace(8);
+      if (!bytes) {
+        return false;
+      }
+      double double_value;
+      std::memcpy(&double_value, bytes, 8);
+      visitor->VisitDouble(double_value);
+      return true;
+    }
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t length;
+      if (!ReadSize(&length)) {
+        return false;
+      }
+      const uint8_t* bytes = stream_.ReadBytesInPlace(length);
+      if (!bytes) {
+        return false;
+      }
+      visitor->VisitString(reinterpret_cast<const char*>(bytes), length);
+      return true;
+    }
+    case EncodedType::kUInt8List: {
+      size_t count;
+      const uint8_t* values;
+      std::vector<uint8_t> scratch;
+      if (!ReadList(&count, &values, &scratch)) {
+        return false;
+      }
+      visitor->VisitByteList(values, count);
+      return true;
+    }
+    case EncodedType::kInt32List: {
+      size_t count;
+      const int32_t* values;
+      std::vector<int32_t> scratch;
+      if (!ReadList(&count, &values, &scratch)) {
+        return false;
+      }
+      visitor->VisitIntList(values, count);
+      return true;
+    }
+    case EncodedType::kInt64List: {
+      size_t count;
+      const int64_t* values;
+      std::vector<int64_t> scratch;
+      if (!ReadList(&count, &values, &scratch)) {
+        return false;
+      }
+      visitor->VisitLongList(values, count);
+      return true;
+    }
+    case EncodedType::kFloat64List: {
+      size_t count;
+      const double* values;
+      std::vector<double> scratch;
+      if (!ReadList(&count, &values, &scratch)) {
+        return false;
+      }
+      visitor->VisitDoubleList(values, count);
+      return true;
+    }
+    case EncodedType::kList: {
+      size_t length;
+      if (!ReadSize(&length)) {
+        return false;
+      }
+      visitor->BeginList(length);
+      for (size_t i = 0; i < length; ++i) {
+        if (!ReadValue(visitor)) {
+          return false;
+        }
+      }
+      visitor->EndList();
+      return true;
+    }
+    case EncodedType::kMap: {
+      size_t length;
+      if (!ReadSize(&length)) {
+        return false;
+      }
+      visitor->BeginMap(length);
+      for (size_t i = 0; i < length; ++i) {
+        if (!ReadValue(visitor) || !ReadValue(visitor)) {
+          return false;
+        }
+      }
+      visitor->EndMap();
+      return true;
+    }
+  }
+  std::cerr << "Unknown type in StandardCodecStreamReader::ReadValue: "
+            << static_cast<int>(type) << std::endl;
+  return false;
+}
+
+bool StandardCodecStreamReader::ReadSize(size_t* size) {
+  return ReadEncodedSize(&stream_, size);
+}
+
+template <typename T>
+bool StandardCodecStreamReader::ReadList(size_t* count,
+                                         const T** values,
+                                         std::vector<T>* scratch) {
+  if (!ReadSize(count)) {
+    return false;
+  }
+  if (sizeof(T) > 1) {
+    stream_.ReadAlignment(sizeof(T));
+  }
+  if (*count == 0) {
+    // Empty lists written by older encoders may lack the alignment padding.
+    *values = scratch->data();
+    return true;
+  }
+  if (*count > SIZE_MAX / sizeof(T)) {
+    return false;
+  }
+  const uint8_t* bytes = stream_.ReadBytesInPlace(*count * sizeof(T));
+  if (!bytes) {
+    return false;
+  }
+  // The encoding aligns the values relative to the start of the message, so
+  // they are aligned in memory as long as the message is.
+  if (reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0) {
+    *values = reinterpret_cast<const T*>(bytes);
+  } else {
+    scratch->resize(*count);
+    std::memcpy(scratch->data(), bytes, *count * sizeof(T));
+    *values = scratch->data();
+  }
+  return true;
+}
+
+StandardCodecStreamWriter::StandardCodecStreamWriter(
+    std::vector<uint8_t>* buffer)
+    : stream_(buffer) {}
+
+StandardCodecStreamWriter::~StandardCodecStreamWriter() = default;
+
+void StandardCodecStreamWriter::WriteNull() {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kNull));
+}
+
+void StandardCodecStreamWriter::WriteBool(bool value) {
+  stream_.WriteByte(static_cast<uint8_t>(value ? EncodedType::kTrue
+                                               : EncodedType::kFalse));
+}
+
+void StandardCodecStreamWriter::WriteInt(int32_t value) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kInt32));
+  stream_.WriteBytes(reinterpret_cast<const uint8_t*>(&value), 4);
+}
+
+void StandardCodecStreamWriter::WriteLong(int64_t value) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kInt64));
+  stream_.WriteBytes(reinterpret_cast<const uint8_t*>(&value), 8);
+}
+
+void StandardCodecStreamWriter::WriteDouble(double value) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kFloat64));
+  stream_.WriteAlignment(8);
+  stream_.WriteBytes(reinterpret_cast<const uint8_t*>(&value), 8);
+}
+
+void StandardCodecStreamWriter::WriteString(const char* value, size_t length) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kString));
+  WriteSize(length);
+  if (length > 0) {
+    stream_.WriteBytes(reinterpret_cast<const uint8_t*>(value), length);
+  }
+}
+
+void StandardCodecStreamWriter::WriteString(const std::string& value) {
+  WriteString(value.data(), value.size());
+}
+
+void StandardCodecStreamWriter::WriteByteList(const uint8_t* values,
+                                              size_t count) {
+  WriteList(static_cast<uint8_t>(EncodedType::kUInt8List), values, count);
+}
+
+void StandardCodecStreamWriter::WriteIntList(const int32_t* values,
+                                             size_t count) {
+  WriteList(static_cast<uint8_t>(EncodedType::kInt32List), values, count);
+}
+
+void StandardCodecStreamWriter::WriteLongList(const int64_t* values,
+                                              size_t count) {
+  WriteList(static_cast<uint8_t>(EncodedType::kInt64List), values, count);
+}
+
+void StandardCodecStreamWriter::WriteDoubleList(const double* values,
+                                                size_t count) {
+  WriteList(static_cast<uint8_t>(EncodedType::kFloat64List), values, count);
+}
+
+void StandardCodecStreamWriter::BeginList(size_t length) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kList));
+  WriteSize(length);
+}
+
+void StandardCodecStreamWriter::BeginMap(size_t length) {
+  stream_.WriteByte(static_cast<uint8_t>(EncodedType::kMap));
+  WriteSize(length);
+}
+
+void StandardCodecStreamWriter::WriteSize(size_t size) {
+  WriteEncodedSize(size, &stream_);
+}
+
+template <typename T>
+void StandardCodecStreamWriter::WriteList(uint8_t type,
+                                          const T* values,
+                                          size_t count) {
+  stream_.WriteByte(type);
+  WriteSize(count);
+  // The Dart side aligns typed lists even when they are empty.
+  if (sizeof(T) > 1) {
+    stream_.WriteAlignment(sizeof(T));
+  }
+  if (count > 0) {
+    stream_.WriteBytes(reinterpret_cast<const uint8_t*>(values),
+                       count * sizeof(T));
+  }
+}
+
 // ===== standard_message_codec.h =====
 
 // static
@@ -5,7 +5,7 @@
 #ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_ENCODABLE_VALUE_SERIALIZER_H_
 #define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_ENCODABLE_VALUE_SERIALIZER_H_
 
-#include "byte_stream_wrappers.h"
+#include "include/flutter/byte_stream_wrappers.h"
 #include "include/flutter/encodable_value.h"
 
 namespace flutter {
@@ -45,7 +45,7 @@ class StandardCodecSerializer {
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the support list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector,
+  void WriteVector(const std::vector<T>& vector,
                    ByteBufferStreamWriter* stream) const;
 };
 
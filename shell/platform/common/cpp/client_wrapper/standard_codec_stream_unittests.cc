@@ -0,0 +1,146 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_codec_stream.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/testing/encodable_value_utils.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// Records the values it visits as text.
+class RecordingVisitor : public StandardCodecVisitor {
+ public:
+  void VisitNull() override { log_ << "null "; }
+  void VisitBool(bool value) override { log_ << value << " "; }
+  void VisitInt(int32_t value) override { log_ << "int:" << value << " "; }
+  void VisitLong(int64_t value) override { log_ << "long:" << value << " "; }
+  void VisitDouble(double value) override {
+    log_ << "double:" << value << " ";
+  }
+  void VisitString(const char* value, size_t length) override {
+    log_ << "string:" << std::string(value, length) << " ";
+  }
+  void VisitByteList(const uint8_t* values, size_t count) override {
+    log_ << "bytes:" << count << " ";
+  }
+  void VisitDoubleList(const double* values, size_t count) override {
+    double_list_ = values;
+    log_ << "doubles:";
+    for (size_t i = 0; i < count; ++i) {
+      log_ << values[i] << ",";
+    }
+    log_ << " ";
+  }
+  void BeginList(size_t length) override { log_ << "list:" << length << " "; }
+  void EndList() override { log_ << "end "; }
+  void BeginMap(size_t length) override { log_ << "map:" << length << " "; }
+  void EndMap() override { log_ << "end "; }
+
+  std::string GetLog() const { return log_.str(); }
+
+  const double* double_list_ = nullptr;
+
+ private:
+  std::ostringstream log_;
+};
+
+EncodableValue CreateTestValue() {
+  return EncodableValue(EncodableList{
+      EncodableValue(),
+      EncodableValue(true),
+      EncodableValue(7),
+      EncodableValue(INT64_C(1) << 40),
+      EncodableValue(2.5),
+      EncodableValue("text"),
+      EncodableValue(std::vector<uint8_t>{1, 2, 3}),
+      EncodableValue(EncodableMap{
+          {EncodableValue("key"), EncodableValue(std::vector<double>{1, 2})},
+      }),
+  });
+}
+
+}  // namespace
+
+TEST(StandardCodecStream, WriterMatchesMessageCodec) {
+  std::vector<uint8_t> buffer;
+  StandardCodecStreamWriter writer(&buffer);
+  writer.BeginList(8);
+  writer.WriteNull();
+  writer.WriteBool(true);
+  writer.WriteInt(7);
+  writer.WriteLong(INT64_C(1) << 40);
+  writer.WriteDouble(2.5);
+  writer.WriteString("text");
+  const uint8_t bytes[] = {1, 2, 3};
+  writer.WriteByteList(bytes, 3);
+  writer.BeginMap(1);
+  writer.WriteString("key");
+  const double doubles[] = {1, 2};
+  writer.WriteDoubleList(doubles, 2);
+
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      CreateTestValue());
+  EXPECT_EQ(buffer, *encoded);
+}
+
+TEST(StandardCodecStream, ReaderVisitsValuesInOrder) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      CreateTestValue());
+  StandardCodecStreamReader reader(encoded->data(), encoded->size());
+  RecordingVisitor visitor;
+  ASSERT_TRUE(reader.ReadValue(&visitor));
+  EXPECT_EQ(visitor.GetLog(),
+            "list:8 null 1 int:7 long:1099511627776 double:2.5 string:text "
+            "bytes:3 map:1 string:key doubles:1,2, end end ");
+}
+
+TEST(StandardCodecStream, ReaderVisitsAlignedTypedListsInPlace) {
+  std::vector<double> doubles = {1, 2, 3};
+  auto encoded =
+      StandardMessageCodec::GetInstance().EncodeMessage(EncodableValue(doubles));
+  StandardCodecStreamReader reader(encoded->data(), encoded->size());
+  RecordingVisitor visitor;
+  ASSERT_TRUE(reader.ReadValue(&visitor));
+  const uint8_t* list = reinterpret_cast<const uint8_t*>(visitor.double_list_);
+  EXPECT_GE(list, encoded->data());
+  EXPECT_LT(list, encoded->data() + encoded->size());
+}
+
+TEST(StandardCodecStream, ReaderRejectsTruncatedMessages) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      CreateTestValue());
+  for (size_t size = 0; size < encoded->size(); ++size) {
+    StandardCodecStreamReader reader(encoded->data(), size);
+    RecordingVisitor visitor;
+    EXPECT_FALSE(reader.ReadValue(&visitor)) << "size " << size;
+  }
+}
+
+TEST(StandardCodecStream, WrittenValuesDecodeToEncodableValues) {
+  std::vector<uint8_t> buffer;
+  StandardCodecStreamWriter writer(&buffer);
+  writer.BeginMap(2);
+  writer.WriteString("name");
+  writer.WriteString("file.txt");
+  writer.WriteString("sizes");
+  const int64_t sizes[] = {1, -1};
+  writer.WriteLongList(sizes, 2);
+
+  auto decoded = StandardMessageCodec::GetInstance().DecodeMessage(buffer);
+  EncodableValue expected(EncodableMap{
+      {EncodableValue("name"), EncodableValue("file.txt")},
+      {EncodableValue("sizes"), EncodableValue(std::vector<int64_t>{1, -1})},
+  });
+  EXPECT_TRUE(testing::EncodableValuesAreEqual(*decoded, expected));
+}
+
+}  // namespace flutter
@@ -0,0 +1,141 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_codec_stream.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+namespace benchmarking {
+
+namespace {
+
+// A list of |count| maps, shaped like a list of records sent by a plugin.
+EncodableValue CreateRecords(int64_t count) {
+  EncodableList records;
+  for (int64_t i = 0; i < count; ++i) {
+    records.push_back(EncodableValue(EncodableMap{
+        {EncodableValue("id"), EncodableValue(i)},
+        {EncodableValue("name"), EncodableValue("record")},
+        {EncodableValue("score"), EncodableValue(0.5 * i)},
+    }));
+  }
+  return EncodableValue(std::move(records));
+}
+
+void WriteRecords(StandardCodecStreamWriter* writer, int64_t count) {
+  writer->BeginList(count);
+  for (int64_t i = 0; i < count; ++i) {
+    writer->BeginMap(3);
+    writer->WriteString("id");
+    writer->WriteLong(i);
+    writer->WriteString("name");
+    writer->WriteString("record");
+    writer->WriteString("score");
+    writer->WriteDouble(0.5 * i);
+  }
+}
+
+// Counts the values it visits, so that reading isn't optimized away.
+class CountingVisitor : public StandardCodecVisitor {
+ public:
+  void VisitLong(int64_t value) override { count_++; }
+  void VisitDouble(double value) override { count_++; }
+  void VisitString(const char* value, size_t length) override { count_++; }
+  void VisitDoubleList(const double* values, size_t count) override {
+    count_ += count;
+  }
+
+  size_t count_ = 0;
+};
+
+}  // namespace
+
+static void BM_StandardCodecEncodeRecords(benchmark::State& state) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(CreateRecords(state.range(0)));
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_StandardCodecStreamWriteRecords(benchmark::State& state) {
+  std::vector<uint8_t> buffer;
+  while (state.KeepRunning()) {
+    buffer.clear();
+    StandardCodecStreamWriter writer(&buffer);
+    WriteRecords(&writer, state.range(0));
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+static void BM_StandardCodecDecodeRecords(benchmark::State& state) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(CreateRecords(state.range(0)));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecStreamReadRecords(benchmark::State& state) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(CreateRecords(state.range(0)));
+  while (state.KeepRunning()) {
+    StandardCodecStreamReader reader(encoded->data(), encoded->size());
+    CountingVisitor visitor;
+    bool success = reader.ReadValue(&visitor);
+    benchmark::DoNotOptimize(success);
+    benchmark::DoNotOptimize(visitor.count_);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeDoubleList(benchmark::State& state) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(
+      EncodableValue(std::vector<double>(state.range(0), 1.0)));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecStreamReadDoubleList(benchmark::State& state) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(
+      EncodableValue(std::vector<double>(state.range(0), 1.0)));
+  while (state.KeepRunning()) {
+    StandardCodecStreamReader reader(encoded->data(), encoded->size());
+    CountingVisitor visitor;
+    bool success = reader.ReadValue(&visitor);
+    benchmark::DoNotOptimize(success);
+    benchmark::DoNotOptimize(visitor.count_);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+BENCHMARK(BM_StandardCodecEncodeRecords)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_StandardCodecStreamWriteRecords)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096);
+BENCHMARK(BM_StandardCodecDecodeRecords)->RangeMultiplier(16)->Range(16, 4096);
+BENCHMARK(BM_StandardCodecStreamReadRecords)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096);
+BENCHMARK(BM_StandardCodecDecodeDoubleList)
+    ->RangeMultiplier(16)
+    ->Range(16, 65536);
+BENCHMARK(BM_StandardCodecStreamReadDoubleList)
+    ->RangeMultiplier(16)
+    ->Range(16, 65536);
+
+}  // namespace benchmarking
+}  // namespace flutter
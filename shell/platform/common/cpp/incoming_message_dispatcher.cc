@@ -17,42 +17,61 @@ void IncomingMessageDispatcher::HandleMessage(
     const FlutterDesktopMessage& message,
     const std::function<void(void)>& input_block_cb,
     const std::function<void(void)>& input_unblock_cb) {
-  std::string channel(message.channel);
+  auto it = channel_ids_.find(message.channel);
+  if (it == channel_ids_.end()) {
+    FlutterDesktopMessengerSendResponse(messenger_, message.response_handle,
+                                        nullptr, 0);
+    return;
+  }
+  HandleMessage(it->second, message, input_block_cb, input_unblock_cb);
+}
+
+void IncomingMessageDispatcher::HandleMessage(
+    ChannelId channel_id,
+    const FlutterDesktopMessage& message,
+    const std::function<void(void)>& input_block_cb,
+    const std::function<void(void)>& input_unblock_cb) {
+  // Copied, since the callback may register handlers and grow the table.
+  ChannelHandler handler = handlers_[channel_id];
 
-  // Find the handler for the channel; if there isn't one, report the failure.
-  if (callbacks_.find(channel) == callbacks_.end()) {
+  // If there isn't a handler for the channel, report the failure.
+  if (!handler.callback) {
     FlutterDesktopMessengerSendResponse(messenger_, message.response_handle,
                                         nullptr, 0);
     return;
   }
-  auto& callback_info = callbacks_[channel];
-  FlutterDesktopMessageCallback message_callback = callback_info.first;
 
   // Process the call, handling input blocking if requested.
-  bool block_input = input_blocking_channels_.count(channel) > 0;
-  if (block_input) {
-    input_block_cb();
+  if (!handler.block_input) {
+    handler.callback(messenger_, &message, handler.user_data);
+    return;
   }
-  message_callback(messenger_, &message, callback_info.second);
-  if (block_input) {
-    input_unblock_cb();
+  input_block_cb();
+  handler.callback(messenger_, &message, handler.user_data);
+  input_unblock_cb();
+}
+
+IncomingMessageDispatcher::ChannelId IncomingMessageDispatcher::GetChannelId(
+    const std::string& channel) {
+  auto result = channel_ids_.emplace(channel, handlers_.size());
+  if (result.second) {
+    handlers_.emplace_back();
   }
+  return result.first->second;
 }
 
 void IncomingMessageDispatcher::SetMessageCallback(
     const std::string& channel,
     FlutterDesktopMessageCallback callback,
     void* user_data) {
-  if (!callback) {
-    callbacks_.erase(channel);
-    return;
-  }
-  callbacks_[channel] = std::make_pair(callback, user_data);
+  ChannelHandler& handler = handlers_[GetChannelId(channel)];
+  handler.callback = callback;
+  handler.user_data = callback ? user_data : nullptr;
 }
 
 void IncomingMessageDispatcher::EnableInputBlockingForChannel(
     const std::string& channel) {
-  input_blocking_channels_.insert(channel);
+  handlers_[GetChannelId(channel)].block_input = true;
 }
 
 }  // namespace flutter
@@ -6,10 +6,9 @@
 #define FLUTTER_SHELL_PLATFORM_CPP_INCOMING_MESSAGE_DISPATCHER_H_
 
 #include <functional>
-#include <map>
-#include <set>
 #include <string>
-#include <utility>
+#include <unordered_map>
+#include <vector>
 
 #include "flutter/shell/platform/common/cpp/public/flutter_messenger.h"
 
@@ -19,6 +18,9 @@ namespace flutter {
 // Flutter engine, and dispatching incoming messages to those handlers.
 class IncomingMessageDispatcher {
  public:
+  // An interned channel name, which indexes the dispatcher's handler table.
+  using ChannelId = size_t;
+
   // Creates a new IncomingMessageDispatcher. |messenger| must remain valid as
   // long as this object exists.
   explicit IncomingMessageDispatcher(FlutterDesktopMessengerRef messenger);
@@ -42,6 +44,23 @@ class IncomingMessageDispatcher {
       const std::function<void(void)>& input_block_cb = [] {},
       const std::function<void(void)>& input_unblock_cb = [] {});
 
+  // Routes |message| to the registered handler for the channel identified by
+  // |channel_id|, as above, but without looking up its channel name.
+  //
+  // |channel_id| must have been returned by GetChannelId for the channel
+  // named in |message|.
+  void HandleMessage(
+      ChannelId channel_id,
+      const FlutterDesktopMessage& message,
+      const std::function<void(void)>& input_block_cb = [] {},
+      const std::function<void(void)>& input_unblock_cb = [] {});
+
+  // Returns the ID of |channel|, assigning one if it doesn't have one yet.
+  //
+  // IDs are stable for the lifetime of this object, so callers that see many
+  // messages on the same channel can resolve its name once.
+  ChannelId GetChannelId(const std::string& channel);
+
   // Registers a message callback for incoming messages from the Flutter
   // side on the specified channel. |callback| will be called with the message
   // and |user_data| any time a message arrives on that channel.
@@ -62,15 +81,20 @@ class IncomingMessageDispatcher {
   // Handle for interacting with the C messaging API.
   FlutterDesktopMessengerRef messenger_;
 
-  // A map from channel names to the FlutterDesktopMessageCallback that should
-  // be called for incoming messages on that channel, along with the void* user
-  // data to pass to it.
-  std::map<std::string, std::pair<FlutterDesktopMessageCallback, void*>>
-      callbacks_;
+  // The handler for a channel, and whether it blocks input.
+  struct ChannelHandler {
+    FlutterDesktopMessageCallback callback = nullptr;
+    void* user_data = nullptr;
+    // Whether input blocking should be enabled during the call to the
+    // callback.
+    bool block_input = false;
+  };
+
+  // A map from channel names to their IDs.
+  std::unordered_map<std::string, ChannelId> channel_ids_;
 
-  // Channel names for which input blocking should be enabled during the call to
-  // that channel's handler.
-  std::set<std::string> input_blocking_channels_;
+  // The handlers of all channels that have an ID, indexed by ID.
+  std::vector<ChannelHandler> handlers_;
 };
 
 }  // namespace flutter
@@ -0,0 +1,113 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/cpp/incoming_message_dispatcher.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/cpp/client_wrapper/testing/stub_flutter_api.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// Counts the empty responses sent for messages without a handler.
+class TestApi : public testing::StubFlutterApi {
+ public:
+  void MessengerSendResponse(const FlutterDesktopMessageResponseHandle* handle,
+                             const uint8_t* data,
+                             size_t data_length) override {
+    responses_++;
+  }
+
+  int responses_ = 0;
+};
+
+FlutterDesktopMessage CreateMessage(const char* channel) {
+  FlutterDesktopMessage message = {};
+  message.struct_size = sizeof(FlutterDesktopMessage);
+  message.channel = channel;
+  return message;
+}
+
+// Records the channel of each message it is called with.
+void RecordChannel(FlutterDesktopMessengerRef messenger,
+                   const FlutterDesktopMessage* message,
+                   void* user_data) {
+  static_cast<std::vector<std::string>*>(user_data)->push_back(
+      message->channel);
+}
+
+}  // namespace
+
+TEST(IncomingMessageDispatcher, DispatchesByChannel) {
+  testing::ScopedStubFlutterApi scoped_api_stub(std::make_unique<TestApi>());
+  auto* test_api = static_cast<TestApi*>(scoped_api_stub.stub());
+  IncomingMessageDispatcher dispatcher(nullptr);
+  std::vector<std::string> a_messages;
+  std::vector<std::string> b_messages;
+  dispatcher.SetMessageCallback("a", RecordChannel, &a_messages);
+  dispatcher.SetMessageCallback("b", RecordChannel, &b_messages);
+
+  dispatcher.HandleMessage(CreateMessage("a"));
+  dispatcher.HandleMessage(CreateMessage("b"));
+  dispatcher.HandleMessage(CreateMessage("b"));
+  dispatcher.HandleMessage(CreateMessage("c"));
+
+  EXPECT_EQ(a_messages.size(), 1u);
+  EXPECT_EQ(b_messages.size(), 2u);
+  EXPECT_EQ(test_api->responses_, 1);
+}
+
+TEST(IncomingMessageDispatcher, DispatchesByChannelId) {
+  testing::ScopedStubFlutterApi scoped_api_stub(std::make_unique<TestApi>());
+  IncomingMessageDispatcher dispatcher(nullptr);
+  std::vector<std::string> messages;
+  IncomingMessageDispatcher::ChannelId id = dispatcher.GetChannelId("a");
+  EXPECT_EQ(dispatcher.GetChannelId("a"), id);
+  EXPECT_NE(dispatcher.GetChannelId("b"), id);
+
+  dispatcher.SetMessageCallback("a", RecordChannel, &messages);
+  dispatcher.HandleMessage(id, CreateMessage("a"));
+
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0], "a");
+}
+
+TEST(IncomingMessageDispatcher, UnregisteredChannelSendsEmptyResponse) {
+  testing::ScopedStubFlutterApi scoped_api_stub(std::make_unique<TestApi>());
+  auto* test_api = static_cast<TestApi*>(scoped_api_stub.stub());
+  IncomingMessageDispatcher dispatcher(nullptr);
+  std::vector<std::string> messages;
+  dispatcher.SetMessageCallback("a", RecordChannel, &messages);
+  dispatcher.SetMessageCallback("a", nullptr, nullptr);
+
+  dispatcher.HandleMessage(CreateMessage("a"));
+
+  EXPECT_TRUE(messages.empty());
+  EXPECT_EQ(test_api->responses_, 1);
+}
+
+TEST(IncomingMessageDispatcher, BlocksInputOnlyForBlockingChannels) {
+  testing::ScopedStubFlutterApi scoped_api_stub(std::make_unique<TestApi>());
+  IncomingMessageDispatcher dispatcher(nullptr);
+  std::vector<std::string> messages;
+  dispatcher.SetMessageCallback("a", RecordChannel, &messages);
+  dispatcher.SetMessageCallback("b", RecordChannel, &messages);
+  dispatcher.EnableInputBlockingForChannel("b");
+
+  std::string log;
+  auto block = [&log] { log += "block "; };
+  auto unblock = [&log] { log += "unblock "; };
+  dispatcher.HandleMessage(CreateMessage("a"), block, unblock);
+  EXPECT_EQ(log, "");
+  dispatcher.HandleMessage(CreateMessage("b"), block, unblock);
+  EXPECT_EQ(log, "block unblock ");
+  EXPECT_EQ(messages.size(), 2u);
+}
+
+}  // namespace flutter
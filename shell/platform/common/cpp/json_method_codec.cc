@@ -5,6 +5,7 @@
 #include "flutter/shell/platform/common/cpp/json_method_codec.h"
 
 #include "flutter/shell/platform/common/cpp/json_message_codec.h"
+#include "flutter/shell/platform/common/cpp/json_stream.h"
 
 namespace flutter {
 
@@ -30,6 +31,16 @@ std::unique_ptr<rapidjson::Document> ExtractElement(
   return extracted;
 }
 
+// Writes |value|, or null if there is no value.
+void WriteOptionalValue(JsonByteBufferWriter* writer,
+                        const rapidjson::Document* value) {
+  if (value) {
+    value->Accept(*writer);
+  } else {
+    writer->Null();
+  }
+}
+
 }  // namespace
 
 // static
@@ -66,34 +77,30 @@ JsonMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 
 std::unique_ptr<std::vector<uint8_t>> JsonMethodCodec::EncodeMethodCallInternal(
     const MethodCall<rapidjson::Document>& method_call) const {
-  // TODO: Consider revisiting the codec APIs to avoid the need to copy
-  // everything when doing encoding (e.g., by having a version that takes
-  // owership of the object to encode, so that it can be moved instead).
-  rapidjson::Document message(rapidjson::kObjectType);
-  auto& allocator = message.GetAllocator();
-  rapidjson::Value name(method_call.method_name(), allocator);
-  rapidjson::Value arguments;
-  if (method_call.arguments()) {
-    arguments.CopyFrom(*method_call.arguments(), allocator);
-  }
-  message.AddMember(kMessageMethodKey, name, allocator);
-  message.AddMember(kMessageArgumentsKey, arguments, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(message);
+  // The envelope is written around the arguments rather than built as a
+  // document, so that the arguments don't have to be copied into it.
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  JsonByteBufferOutputStream stream(encoded.get());
+  JsonByteBufferWriter writer(stream);
+  writer.StartObject();
+  writer.Key(kMessageMethodKey);
+  WriteJsonString(&writer, method_call.method_name());
+  writer.Key(kMessageArgumentsKey);
+  WriteOptionalValue(&writer, method_call.arguments());
+  writer.EndObject();
+  return encoded;
 }
 
 std::unique_ptr<std::vector<uint8_t>>
 JsonMethodCodec::EncodeSuccessEnvelopeInternal(
     const rapidjson::Document* result) const {
-  rapidjson::Document envelope;
-  envelope.SetArray();
-  rapidjson::Value result_value;
-  if (result) {
-    result_value.CopyFrom(*result, envelope.GetAllocator());
-  }
-  envelope.PushBack(result_value, envelope.GetAllocator());
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  JsonByteBufferOutputStream stream(encoded.get());
+  JsonByteBufferWriter writer(stream);
+  writer.StartArray();
+  WriteOptionalValue(&writer, result);
+  writer.EndArray();
+  return encoded;
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -101,17 +108,15 @@ JsonMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const rapidjson::Document* error_details) const {
-  rapidjson::Document envelope(rapidjson::kArrayType);
-  auto& allocator = envelope.GetAllocator();
-  envelope.PushBack(rapidjson::Value(error_code, allocator), allocator);
-  envelope.PushBack(rapidjson::Value(error_message, allocator), allocator);
-  rapidjson::Value details_value;
-  if (error_details) {
-    details_value.CopyFrom(*error_details, allocator);
-  }
-  envelope.PushBack(details_value, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  JsonByteBufferOutputStream stream(encoded.get());
+  JsonByteBufferWriter writer(stream);
+  writer.StartArray();
+  WriteJsonString(&writer, error_code);
+  WriteJsonString(&writer, error_message);
+  WriteOptionalValue(&writer, error_details);
+  writer.EndArray();
+  return encoded;
 }
 
 bool JsonMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_JSON_STREAM_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_JSON_STREAM_H_
+
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/writer.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace flutter {
+
+// A rapidjson output stream that appends to a byte vector, so that JSON can be
+// written straight into a message without an intermediate string buffer.
+class JsonByteBufferOutputStream {
+ public:
+  typedef char Ch;
+
+  // Creates a stream that appends to |buffer|.
+  // |buffer| must remain valid for the lifetime of this object.
+  explicit JsonByteBufferOutputStream(std::vector<uint8_t>* buffer)
+      : buffer_(buffer) {}
+
+  void Put(Ch c) { buffer_->push_back(static_cast<uint8_t>(c)); }
+  void Flush() {}
+
+ private:
+  std::vector<uint8_t>* buffer_;
+};
+
+// A rapidjson Writer for JsonByteBufferOutputStream, usable as the handler
+// for rapidjson::Value::Accept as well as for writing JSON value by value.
+using JsonByteBufferWriter = rapidjson::Writer<JsonByteBufferOutputStream>;
+
+// A rapidjson input stream for parsing a mutable buffer in situ.
+//
+// Unlike rapidjson::InsituStringStream, the buffer doesn't need to be null
+// terminated, so it can be used on the data of a message directly.
+class JsonInsituByteStream {
+ public:
+  typedef char Ch;
+
+  JsonInsituByteStream(uint8_t* buffer, size_t size)
+      : begin_(reinterpret_cast<Ch*>(buffer)),
+        src_(begin_),
+        end_(begin_ + size),
+        dst_(nullptr) {}
+
+  Ch Peek() const { return src_ == end_ ? '\0' : *src_; }
+  Ch Take() { return src_ == end_ ? '\0' : *src_++; }
+  size_t Tell() const { return static_cast<size_t>(src_ - begin_); }
+
+  // Decoded strings are written over the input they were decoded from, which
+  // is never shorter than them.
+  Ch* PutBegin() { return dst_ = src_; }
+  void Put(Ch c) { *dst_++ = c; }
+  size_t PutEnd(Ch* begin) { return static_cast<size_t>(dst_ - begin); }
+  void Flush() {}
+
+ private:
+  Ch* begin_;
+  Ch* src_;
+  Ch* end_;
+  Ch* dst_;
+};
+
+// Parses the JSON in |message| and reports it to |handler|, which must
+// implement rapidjson's Handler concept, without building a
+// rapidjson::Document. Strings passed to |handler| are only valid for the
+// duration of the call.
+template <typename Handler>
+rapidjson::ParseResult ParseJson(const uint8_t* message,
+                                 size_t message_size,
+                                 Handler* handler) {
+  rapidjson::MemoryStream stream(reinterpret_cast<const char*>(message),
+                                 message_size);
+  rapidjson::Reader reader;
+  return reader.Parse(stream, *handler);
+}
+
+// Like ParseJson, but decodes strings within |message| itself rather than
+// into a copy. Strings passed to |handler| are null terminated and remain
+// valid as long as |message| does, but |message| no longer holds the original
+// JSON afterwards.
+template <typename Handler>
+rapidjson::ParseResult ParseJsonInsitu(uint8_t* message,
+                                       size_t message_size,
+                                       Handler* handler) {
+  JsonInsituByteStream stream(message, message_size);
+  rapidjson::Reader reader;
+  return reader.Parse<rapidjson::kParseInsituFlag>(stream, *handler);
+}
+
+// Writes |value| as a JSON string.
+inline bool WriteJsonString(JsonByteBufferWriter* writer,
+                            const std::string& value) {
+  return writer->String(value.data(),
+                        static_cast<rapidjson::SizeType>(value.size()));
+}
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_JSON_STREAM_H_
@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/cpp/json_stream.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// Records the values it is given as text, and the location of the last string.
+class RecordingHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          RecordingHandler> {
+ public:
+  bool Null() { return Record("null"); }
+  bool Bool(bool value) { return Record(value ? "true" : "false"); }
+  bool Int(int value) { return Record("int:" + std::to_string(value)); }
+  bool Uint(unsigned value) { return Record("int:" + std::to_string(value)); }
+  bool String(const char* value, rapidjson::SizeType length, bool copy) {
+    last_string_ = value;
+    return Record("string:" + std::string(value, length));
+  }
+  bool Key(const char* value, rapidjson::SizeType length, bool copy) {
+    return Record("key:" + std::string(value, length));
+  }
+  bool StartObject() { return Record("{"); }
+  bool EndObject(rapidjson::SizeType count) { return Record("}"); }
+  bool StartArray() { return Record("["); }
+  bool EndArray(rapidjson::SizeType count) { return Record("]"); }
+
+  std::string log_;
+  const char* last_string_ = nullptr;
+
+ private:
+  bool Record(const std::string& entry) {
+    log_ += entry + " ";
+    return true;
+  }
+};
+
+std::vector<uint8_t> ToBytes(const std::string& json) {
+  return std::vector<uint8_t>(json.begin(), json.end());
+}
+
+}  // namespace
+
+TEST(JsonStream, WriterAppendsToBuffer) {
+  std::vector<uint8_t> buffer = ToBytes("prefix");
+  JsonByteBufferOutputStream stream(&buffer);
+  JsonByteBufferWriter writer(stream);
+  writer.StartObject();
+  writer.Key("a");
+  writer.StartArray();
+  writer.Int(-7);
+  WriteJsonString(&writer, "b\"c");
+  writer.Null();
+  writer.EndArray();
+  writer.EndObject();
+
+  EXPECT_EQ(std::string(buffer.begin(), buffer.end()),
+            "prefix{\"a\":[-7,\"b\\\"c\",null]}");
+}
+
+TEST(JsonStream, ParseReportsValuesToHandler) {
+  std::vector<uint8_t> message =
+      ToBytes("{\"a\": [1, -2, true, null], \"b\": \"text\"}");
+  RecordingHandler handler;
+  rapidjson::ParseResult result =
+      ParseJson(message.data(), message.size(), &handler);
+  ASSERT_FALSE(result.IsError());
+  EXPECT_EQ(handler.log_,
+            "{ key:a [ int:1 int:-2 true null ] key:b string:text } ");
+}
+
+TEST(JsonStream, ParseRejectsTruncatedMessages) {
+  std::vector<uint8_t> message = ToBytes("[1, \"text\"]");
+  for (size_t size = 0; size < message.size(); ++size) {
+    RecordingHandler handler;
+    EXPECT_TRUE(ParseJson(message.data(), size, &handler).IsError())
+        << "size " << size;
+  }
+}
+
+TEST(JsonStream, InsituParseDecodesStringsInBuffer) {
+  // Not null terminated, unlike the buffers rapidjson parses in situ itself.
+  std::vector<uint8_t> message = ToBytes("[\"a\\nb\"]");
+  RecordingHandler handler;
+  rapidjson::ParseResult result =
+      ParseJsonInsitu(message.data(), message.size(), &handler);
+  ASSERT_FALSE(result.IsError());
+  EXPECT_EQ(handler.log_, "[ string:a\nb ] ");
+
+  const uint8_t* string = reinterpret_cast<const uint8_t*>(handler.last_string_);
+  EXPECT_GE(string, message.data());
+  EXPECT_LT(string, message.data() + message.size());
+  EXPECT_STREQ(handler.last_string_, "a\nb");
+}
+
+TEST(JsonStream, InsituParseRejectsTruncatedMessages) {
+  const std::string json = "[1, \"text\"]";
+  for (size_t size = 0; size < json.size(); ++size) {
+    std::vector<uint8_t> message = ToBytes(json);
+    RecordingHandler handler;
+    EXPECT_TRUE(ParseJsonInsitu(message.data(), size, &handler).IsError())
+        << "size " << size;
+  }
+}
+
+}  // namespace flutter
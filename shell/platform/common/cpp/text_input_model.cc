@@ -29,11 +29,47 @@ bool IsTrailingSurrogate(char32_t code_point) {
 
 }  // namespace
 
-TextInputModel::TextInputModel()
-    : selection_base_(text_.begin()), selection_extent_(text_.begin()) {}
+TextInputModel::TextInputModel() = default;
 
 TextInputModel::~TextInputModel() = default;
 
+void TextInputModel::MoveGapTo(size_t position) {
+  size_t gap_size = gap_end_ - gap_start_;
+  if (position < gap_start_) {
+    std::copy_backward(buffer_.begin() + position,
+                       buffer_.begin() + gap_start_,
+                       buffer_.begin() + gap_end_);
+  } else if (position > gap_start_) {
+    std::copy(buffer_.begin() + gap_end_,
+              buffer_.begin() + position + gap_size,
+              buffer_.begin() + gap_start_);
+  }
+  gap_start_ = position;
+  gap_end_ = position + gap_size;
+}
+
+void TextInputModel::Insert(size_t position, const std::u16string& text) {
+  MoveGapTo(position);
+  if (gap_end_ - gap_start_ < text.size()) {
+    // Grow geometrically, so that repeated typing is amortized O(1).
+    size_t after_gap = buffer_.size() - gap_end_;
+    size_t new_size =
+        std::max(buffer_.size() * 2, length() + text.size() + 16);
+    buffer_.resize(new_size);
+    std::copy_backward(buffer_.begin() + gap_end_,
+                       buffer_.begin() + gap_end_ + after_gap,
+                       buffer_.end());
+    gap_end_ = new_size - after_gap;
+  }
+  std::copy(text.begin(), text.end(), buffer_.begin() + gap_start_);
+  gap_start_ += text.size();
+}
+
+void TextInputModel::Erase(size_t start, size_t end) {
+  MoveGapTo(start);
+  gap_end_ += end - start;
+}
+
 bool TextInputModel::SetEditingState(size_t selection_base,
                                      size_t selection_extent,
                                      const std::string& text) {
@@ -42,14 +78,17 @@ bool TextInputModel::SetEditingState(size_t selection_base,
   }
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf16_converter;
-  text_ = utf16_converter.from_bytes(text);
-  selection_base_ = text_.begin() + selection_base;
-  selection_extent_ = text_.begin() + selection_extent;
+  buffer_ = utf16_converter.from_bytes(text);
+  gap_start_ = buffer_.size();
+  gap_end_ = buffer_.size();
+  selection_base_ = selection_base;
+  selection_extent_ = selection_extent;
   return true;
 }
 
 void TextInputModel::DeleteSelected() {
-  selection_base_ = text_.erase(selection_start(), selection_end());
+  Erase(selection_start(), selection_end());
+  selection_base_ = selection_start();
   selection_extent_ = selection_base_;
 }
 
@@ -71,7 +110,7 @@ void TextInputModel::AddText(const std::u16string& text) {
   if (selection_base_ != selection_extent_) {
     DeleteSelected();
   }
-  selection_extent_ = text_.insert(selection_extent_, text.begin(), text.end());
+  Insert(selection_extent_, text);
   selection_extent_ += text.length();
   selection_base_ = selection_extent_;
 }
@@ -87,9 +126,10 @@ bool TextInputModel::Backspace() {
     DeleteSelected();
     return true;
   }
-  if (selection_base_ != text_.begin()) {
-    int count = IsTrailingSurrogate(*(selection_base_ - 1)) ? 2 : 1;
-    selection_base_ = text_.erase(selection_base_ - count, selection_base_);
+  if (selection_base_ != 0) {
+    int count = IsTrailingSurrogate(CharAt(selection_base_ - 1)) ? 2 : 1;
+    Erase(selection_base_ - count, selection_base_);
+    selection_base_ -= count;
     selection_extent_ = selection_base_;
     return true;
   }
@@ -101,9 +141,9 @@ bool TextInputModel::Delete() {
     DeleteSelected();
     return true;
   }
-  if (selection_base_ != text_.end()) {
-    int count = IsLeadingSurrogate(*selection_base_) ? 2 : 1;
-    selection_base_ = text_.erase(selection_base_, selection_base_ + count);
+  if (selection_base_ != length()) {
+    int count = IsLeadingSurrogate(CharAt(selection_base_)) ? 2 : 1;
+    Erase(selection_base_, selection_base_ + count);
     selection_extent_ = selection_base_;
     return true;
   }
@@ -111,37 +151,37 @@ bool TextInputModel::Delete() {
 }
 
 bool TextInputModel::DeleteSurrounding(int offset_from_cursor, int count) {
-  auto start = selection_extent_;
+  size_t start = selection_extent_;
   if (offset_from_cursor < 0) {
     for (int i = 0; i < -offset_from_cursor; i++) {
       // If requested start is before the available text then reduce the
       // number of characters to delete.
-      if (start == text_.begin()) {
+      if (start == 0) {
         count = i;
         break;
       }
-      start -= IsTrailingSurrogate(*(start - 1)) ? 2 : 1;
+      start -= IsTrailingSurrogate(CharAt(start - 1)) ? 2 : 1;
     }
   } else {
-    for (int i = 0; i < offset_from_cursor && start != text_.end(); i++) {
-      start += IsLeadingSurrogate(*start) ? 2 : 1;
+    for (int i = 0; i < offset_from_cursor && start != length(); i++) {
+      start += IsLeadingSurrogate(CharAt(start)) ? 2 : 1;
     }
   }
 
-  auto end = start;
-  for (int i = 0; i < count && end != text_.end(); i++) {
-    end += IsLeadingSurrogate(*start) ? 2 : 1;
+  size_t end = start;
+  for (int i = 0; i < count && end != length(); i++) {
+    end += IsLeadingSurrogate(CharAt(end)) ? 2 : 1;
   }
 
   if (start == end) {
     return false;
   }
 
-  auto new_base = text_.erase(start, end);
+  Erase(start, end);
 
   // Cursor moves only if deleted area is before it.
   if (offset_from_cursor <= 0) {
-    selection_base_ = new_base;
+    selection_base_ = start;
   }
 
   // Clear selection.
@@ -151,21 +191,22 @@ bool TextInputModel::DeleteSurrounding(int offset_from_cursor, int count) {
 }
 
 bool TextInputModel::MoveCursorToBeginning() {
-  if (selection_base_ == text_.begin() && selection_extent_ == text_.begin())
+  if (selection_base_ == 0 && selection_extent_ == 0)
     return false;
 
-  selection_base_ = text_.begin();
-  selection_extent_ = text_.begin();
+  selection_base_ = 0;
+  selection_extent_ = 0;
 
   return true;
 }
 
 bool TextInputModel::MoveCursorToEnd() {
-  if (selection_base_ == text_.end() && selection_extent_ == text_.end())
+  size_t end = length();
+  if (selection_base_ == end && selection_extent_ == end)
     return false;
 
-  selection_base_ = text_.end();
-  selection_extent_ = text_.end();
+  selection_base_ = end;
+  selection_extent_ = end;
 
   return true;
 }
@@ -178,8 +219,8 @@ bool TextInputModel::MoveCursorForward() {
     return true;
   }
   // If not at the end, move the extent forward.
-  if (selection_extent_ != text_.end()) {
-    int count = IsLeadingSurrogate(*selection_base_) ? 2 : 1;
+  if (selection_extent_ != length()) {
+    int count = IsLeadingSurrogate(CharAt(selection_base_)) ? 2 : 1;
     selection_base_ += count;
     selection_extent_ = selection_base_;
     return true;
@@ -196,8 +237,8 @@ bool TextInputModel::MoveCursorBack() {
     return true;
   }
   // If not at the start, move the beginning backward.
-  if (selection_base_ != text_.begin()) {
-    int count = IsTrailingSurrogate(*(selection_base_ - 1)) ? 2 : 1;
+  if (selection_base_ != 0) {
+    int count = IsTrailingSurrogate(CharAt(selection_base_ - 1)) ? 2 : 1;
     selection_base_ -= count;
     selection_extent_ = selection_base_;
     return true;
@@ -206,18 +247,35 @@ bool TextInputModel::MoveCursorBack() {
 }
 
 std::string TextInputModel::GetText() const {
+  std::u16string text;
+  text.reserve(length());
+  text.append(buffer_, 0, gap_start_);
+  text.append(buffer_, gap_end_, std::u16string::npos);
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf8_converter;
-  return utf8_converter.to_bytes(text_);
+  return utf8_converter.to_bytes(text);
 }
 
 int TextInputModel::GetCursorOffset() const {
-  // Measure the length of the current text up to the cursor.
-  // There is probably a much more efficient way of doing this.
-  auto leading_text = text_.substr(0, selection_extent_ - text_.begin());
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(leading_text).size();
+  // Measure the UTF-8 length of the text up to the cursor without converting
+  // it.
+  int offset = 0;
+  for (size_t i = 0; i < selection_extent_; ++i) {
+    char16_t c = CharAt(i);
+    if (c < 0x80) {
+      offset += 1;
+    } else if (c < 0x800) {
+      offset += 2;
+    } else if (IsLeadingSurrogate(c) && i + 1 < selection_extent_ &&
+               IsTrailingSurrogate(CharAt(i + 1))) {
+      // A surrogate pair encodes a code point that takes 4 bytes.
+      offset += 4;
+      ++i;
+    } else {
+      offset += 3;
+    }
+  }
+  return offset;
 }
 
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_PLATFORM_CPP_TEXT_INPUT_MODEL_H_
 #define FLUTTER_SHELL_PLATFORM_CPP_TEXT_INPUT_MODEL_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -101,32 +102,52 @@ class TextInputModel {
   int GetCursorOffset() const;
 
   // The position where the selection starts.
-  int selection_base() const {
-    return static_cast<int>(selection_base_ - text_.begin());
-  }
+  int selection_base() const { return static_cast<int>(selection_base_); }
 
   // The position of the cursor.
-  int selection_extent() const {
-    return static_cast<int>(selection_extent_ - text_.begin());
-  }
+  int selection_extent() const { return static_cast<int>(selection_extent_); }
 
  private:
+  // The number of UTF-16 code units in the text.
+  size_t length() const { return buffer_.size() - (gap_end_ - gap_start_); }
+
+  // Returns the UTF-16 code unit at |position| in the text.
+  char16_t CharAt(size_t position) const {
+    return buffer_[position < gap_start_ ? position
+                                         : position + (gap_end_ - gap_start_)];
+  }
+
+  // Moves the gap so that it starts at |position| in the text.
+  void MoveGapTo(size_t position);
+
+  // Inserts |text| at |position| in the text.
+  void Insert(size_t position, const std::u16string& text);
+
+  // Erases the text from |start| up to |end|.
+  void Erase(size_t start, size_t end);
+
   void DeleteSelected();
 
-  std::u16string text_;
-  std::u16string::iterator selection_base_;
-  std::u16string::iterator selection_extent_;
+  // The text is held in a gap buffer: buffer_ holds the text before the
+  // cursor, then unused space between gap_start_ and gap_end_, then the text
+  // after it. Since edits happen at the cursor, typing and deleting only move
+  // the gap's bounds rather than the rest of the text.
+  std::u16string buffer_;
+  size_t gap_start_ = 0;
+  size_t gap_end_ = 0;
+
+  // The selection, as UTF-16 code unit offsets into the text.
+  size_t selection_base_ = 0;
+  size_t selection_extent_ = 0;
 
   // Returns the left hand side of the selection.
-  std::u16string::iterator selection_start() {
-    return selection_base_ < selection_extent_ ? selection_base_
-                                               : selection_extent_;
+  size_t selection_start() const {
+    return std::min(selection_base_, selection_extent_);
   }
 
   // Returns the right hand side of the selection.
-  std::u16string::iterator selection_end() {
-    return selection_base_ > selection_extent_ ? selection_base_
-                                               : selection_extent_;
+  size_t selection_end() const {
+    return std::max(selection_base_, selection_extent_);
   }
 };
 
@@ -593,4 +593,38 @@ TEST(TextInputModel, GetCursorOffsetReverseSelection) {
   EXPECT_EQ(model->GetCursorOffset(), 1);
 }
 
+TEST(TextInputModel, EditAtSeveralPositions) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetEditingState(1, 1, "ABCDE");
+  model->AddText("x");
+  EXPECT_STREQ(model->GetText().c_str(), "AxBCDE");
+  EXPECT_TRUE(model->MoveCursorToEnd());
+  model->AddText(u"yz");
+  EXPECT_STREQ(model->GetText().c_str(), "AxBCDEyz");
+  EXPECT_TRUE(model->MoveCursorToBeginning());
+  EXPECT_TRUE(model->Delete());
+  EXPECT_STREQ(model->GetText().c_str(), "xBCDEyz");
+  EXPECT_TRUE(model->MoveCursorForward());
+  EXPECT_TRUE(model->MoveCursorForward());
+  EXPECT_TRUE(model->Backspace());
+  EXPECT_STREQ(model->GetText().c_str(), "xCDEyz");
+  EXPECT_EQ(model->selection_base(), 1);
+  EXPECT_EQ(model->selection_extent(), 1);
+}
+
+TEST(TextInputModel, EditLargeText) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetEditingState(0, 0, std::string(100000, 'a'));
+  for (int i = 0; i < 1000; i++) {
+    model->AddCodePoint('b');
+  }
+  for (int i = 0; i < 500; i++) {
+    EXPECT_TRUE(model->Backspace());
+  }
+  std::string text = model->GetText();
+  EXPECT_EQ(text.size(), 100500u);
+  EXPECT_EQ(text.substr(0, 501), std::string(500, 'b') + "a");
+  EXPECT_EQ(model->GetCursorOffset(), 500);
+}
+
 }  // namespace flutter
@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_DARWIN_COMMON_IMAGE_DECODER_BACKEND_IMAGE_IO_H_
+#define FLUTTER_SHELL_PLATFORM_DARWIN_COMMON_IMAGE_DECODER_BACKEND_IMAGE_IO_H_
+
+#include "flutter/lib/ui/painting/image_decoder_backend.h"
+
+namespace flutter {
+
+// Decodes JPEG and HEIF images with ImageIO, which uses the hardware decoders
+// of the device where it has them. ImageIO applies the image orientation and
+// scales while decoding.
+class ImageDecoderBackendImageIO final : public ImageDecoderBackend {
+ public:
+  ImageDecoderBackendImageIO();
+
+  ~ImageDecoderBackendImageIO() override;
+
+  // |ImageDecoderBackend|
+  std::optional<SkISize> GetDimensionsIfAccepted(
+      const SkData& data) const override;
+
+  // |ImageDecoderBackend|
+  sk_sp<SkImage> Decode(const SkData& data,
+                        const SkISize& target_dimensions) const override;
+
+ private:
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoderBackendImageIO);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_DARWIN_COMMON_IMAGE_DECODER_BACKEND_IMAGE_IO_H_
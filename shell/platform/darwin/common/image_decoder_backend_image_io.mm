@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/darwin/common/image_decoder_backend_image_io.h"
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <ImageIO/ImageIO.h>
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/platform/darwin/cf_utils.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// Smaller images decode faster with Skia than it takes to set up a decode in
+// ImageIO.
+static constexpr int64_t kMinPixels = 256 * 256;
+
+ImageDecoderBackendImageIO::ImageDecoderBackendImageIO() = default;
+
+ImageDecoderBackendImageIO::~ImageDecoderBackendImageIO() = default;
+
+static fml::CFRef<CGImageSourceRef> CreateImageSource(const SkData& data) {
+  // The data outlives the source, so it doesn't need to be copied.
+  fml::CFRef<CFDataRef> cf_data(CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, data.bytes(),
+                                                            data.size(), kCFAllocatorNull));
+  if (!cf_data) {
+    return {};
+  }
+  return fml::CFRef<CGImageSourceRef>(CGImageSourceCreateWithData(cf_data, nullptr));
+}
+
+static int64_t GetIntProperty(CFDictionaryRef properties, CFStringRef key) {
+  auto value = static_cast<CFNumberRef>(CFDictionaryGetValue(properties, key));
+  int64_t result = 0;
+  if (value == nullptr || !CFNumberGetValue(value, kCFNumberSInt64Type, &result)) {
+    return 0;
+  }
+  return result;
+}
+
+std::optional<SkISize> ImageDecoderBackendImageIO::GetDimensionsIfAccepted(
+    const SkData& data) const {
+  if (!SniffFormat(data)) {
+    return std::nullopt;
+  }
+
+  auto source = CreateImageSource(data);
+  if (!source) {
+    return std::nullopt;
+  }
+  fml::CFRef<CFDictionaryRef> properties(CGImageSourceCopyPropertiesAtIndex(source, 0, nullptr));
+  if (!properties) {
+    return std::nullopt;
+  }
+
+  int64_t width = GetIntProperty(properties, kCGImagePropertyPixelWidth);
+  int64_t height = GetIntProperty(properties, kCGImagePropertyPixelHeight);
+  if (width * height < kMinPixels) {
+    return std::nullopt;
+  }
+  // Orientations 5 to 8 rotate the image by a quarter turn.
+  if (GetIntProperty(properties, kCGImagePropertyOrientation) >= 5) {
+    std::swap(width, height);
+  }
+  return SkISize::Make(width, height);
+}
+
+sk_sp<SkImage> ImageDecoderBackendImageIO::Decode(const SkData& data,
+                                                  const SkISize& target_dimensions) const {
+  TRACE_EVENT0("flutter", "ImageDecoderBackendImageIO::Decode");
+  auto source = CreateImageSource(data);
+  if (!source) {
+    return nullptr;
+  }
+
+  // Thumbnails are decoded at the requested size and with the orientation
+  // applied. The requested size is the longer side of the image, which
+  // ImageIO never exceeds.
+  NSDictionary* options = @{
+    (id)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+    (id)kCGImageSourceCreateThumbnailWithTransform : @YES,
+    (id)kCGImageSourceShouldCacheImmediately : @YES,
+    (id)kCGImageSourceThumbnailMaxPixelSize :
+        @(std::max(target_dimensions.width(), target_dimensions.height())),
+  };
+  fml::CFRef<CGImageRef> image(
+      CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options));
+  if (!image) {
+    return nullptr;
+  }
+
+  const auto info = SkImageInfo::Make(CGImageGetWidth(image), CGImageGetHeight(image),
+                                      kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+  const size_t row_bytes = info.minRowBytes();
+  sk_sp<SkData> pixels = SkData::MakeUninitialized(info.computeByteSize(row_bytes));
+  fml::CFRef<CGColorSpaceRef> color_space(CGColorSpaceCreateDeviceRGB());
+  fml::CFRef<CGContextRef> context(CGBitmapContextCreate(
+      pixels->writable_data(), info.width(), info.height(), 8, row_bytes, color_space,
+      kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big));
+  if (!context) {
+    FML_LOG(ERROR) << "Could not create a bitmap context to draw the decoded image into.";
+    return nullptr;
+  }
+  CGContextSetBlendMode(context, kCGBlendModeCopy);
+  CGContextDrawImage(context, CGRectMake(0, 0, info.width(), info.height()), image);
+
+  return SkImage::MakeRasterData(info, std::move(pixels), row_bytes);
+}
+
+}  // namespace flutter
@@ -143,6 +143,11 @@ static flutter::Settings DefaultSettingsForProcess(NSBundle* bundle = nil) {
       make_mapping_callback(kPlatformStrongDill, kPlatformStrongDillSize);
 #endif  // FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG
 
+  // Lets the engine size its caches to the memory class of the device.
+  if (settings.device_memory_mb == 0) {
+    settings.device_memory_mb = [NSProcessInfo processInfo].physicalMemory >> 20;
+  }
+
   return settings;
 }
 
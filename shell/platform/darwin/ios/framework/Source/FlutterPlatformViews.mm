@@ -8,10 +8,10 @@
 #import "flutter/shell/platform/darwin/ios/ios_surface.h"
 #import "flutter/shell/platform/darwin/ios/ios_surface_gl.h"
 
-#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "FlutterPlatformViews_Internal.h"
 #include "flutter/flow/rtree.h"
@@ -315,10 +315,10 @@ std::vector<SkCanvas*> FlutterPlatformViewsController::GetCurrentCanvases() {
 }
 
 int FlutterPlatformViewsController::CountClips(const MutatorsStack& mutators_stack) {
-  std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator iter = mutators_stack.Bottom();
+  MutatorsStack::const_reverse_iterator iter = mutators_stack.Bottom();
   int clipCount = 0;
   while (iter != mutators_stack.Top()) {
-    if ((*iter)->IsClipType()) {
+    if (iter->IsClipType()) {
       clipCount++;
     }
     ++iter;
@@ -366,11 +366,11 @@ void FlutterPlatformViewsController::ApplyMutators(const MutatorsStack& mutators
   UIView* head = embedded_view;
   ResetAnchor(head.layer);
 
-  std::vector<std::shared_ptr<Mutator>>::const_reverse_iterator iter = mutators_stack.Bottom();
+  MutatorsStack::const_reverse_iterator iter = mutators_stack.Bottom();
   while (iter != mutators_stack.Top()) {
-    switch ((*iter)->GetType()) {
+    switch (iter->GetType()) {
       case transform: {
-        CATransform3D transform = GetCATransform3DFromSkMatrix((*iter)->GetMatrix());
+        CATransform3D transform = GetCATransform3DFromSkMatrix(iter->GetMatrix());
         head.layer.transform = CATransform3DConcat(head.layer.transform, transform);
         break;
       }
@@ -379,16 +379,16 @@ void FlutterPlatformViewsController::ApplyMutators(const MutatorsStack& mutators
       case clip_path: {
         ChildClippingView* clipView = (ChildClippingView*)head.superview;
         clipView.layer.transform = CATransform3DIdentity;
-        [clipView setClip:(*iter)->GetType()
-                     rect:(*iter)->GetRect()
-                    rrect:(*iter)->GetRRect()
-                     path:(*iter)->GetPath()];
+        [clipView setClip:iter->GetType()
+                     rect:iter->GetRect()
+                    rrect:iter->GetRRect()
+                     path:iter->GetPath()];
         ResetAnchor(clipView.layer);
         head = clipView;
         break;
       }
       case opacity:
-        embedded_view.alpha = (*iter)->GetAlphaFloat() * embedded_view.alpha;
+        embedded_view.alpha = iter->GetAlphaFloat() * embedded_view.alpha;
         break;
     }
     ++iter;
@@ -502,6 +502,8 @@ bool FlutterPlatformViewsController::SubmitFrame(GrContext* gr_context,
   auto did_submit = true;
   auto num_platform_views = composition_order_.size();
 
+  // Reused by every r-tree query below.
+  std::vector<SkRect> intersection_rects;
   for (size_t i = 0; i < num_platform_views; i++) {
     int64_t platform_view_id = composition_order_[i];
     sk_sp<RTree> rtree = platform_view_rtrees_[platform_view_id];
@@ -509,19 +511,19 @@ bool FlutterPlatformViewsController::SubmitFrame(GrContext* gr_context,
 
     // Check if the current picture contains overlays that intersect with the
     // current platform view or any of the previous platform views.
+    //
+    // All of them are drawn on a single layer right above the current platform view, which is
+    // also above the previous platform views. This keeps the number of layers to at most one per
+    // platform view, no matter how many disjoint parts of the picture are above platform views.
+    SkRegion overlay_region;
     for (size_t j = i + 1; j > 0; j--) {
       int64_t current_platform_view_id = composition_order_[j - 1];
       SkRect platform_view_rect = GetPlatformViewRect(current_platform_view_id);
-      std::list<SkRect> intersection_rects =
-          rtree->searchNonOverlappingDrawnRects(platform_view_rect);
+      rtree->searchNonOverlappingDrawnRects(platform_view_rect, &intersection_rects);
       auto allocation_size = intersection_rects.size();
 
-      // For testing purposes, the overlay id is used to find the overlay view.
-      // This is the index of the layer for the current platform view.
-      auto overlay_id = platform_view_layers[current_platform_view_id].size();
-
-      // If the max number of allocations per platform view is exceeded,
-      // then join all the rects into a single one.
+      // If the max number of rects per platform view is exceeded,
+      // then join all the rects into a single one, which keeps the region simple.
       //
       // TODO(egarciad): Consider making this configurable.
       // https://github.com/flutter/flutter/issues/52510
@@ -547,19 +549,20 @@ bool FlutterPlatformViewsController::SubmitFrame(GrContext* gr_context,
         // Clip the background canvas, so it doesn't contain any of the pixels drawn
         // on the overlay layer.
         background_canvas->clipRect(joined_rect, SkClipOp::kDifference);
-        // Get a new host layer.
-        std::shared_ptr<FlutterPlatformViewLayer> layer = GetLayer(gr_context,                //
-                                                                   ios_context,               //
-                                                                   picture,                   //
-                                                                   joined_rect,               //
-                                                                   current_platform_view_id,  //
-                                                                   overlay_id                 //
-        );
-        did_submit &= layer->did_submit_last_frame;
-        platform_view_layers[current_platform_view_id].push_back(layer);
-        overlay_id++;
+        overlay_region.op(joined_rect.roundOut(), SkRegion::kUnion_Op);
       }
     }
+    if (!overlay_region.isEmpty()) {
+      // Get a new host layer.
+      std::shared_ptr<FlutterPlatformViewLayer> layer = GetLayer(gr_context,       //
+                                                                 ios_context,      //
+                                                                 picture,          //
+                                                                 overlay_region,   //
+                                                                 platform_view_id  //
+      );
+      did_submit &= layer->did_submit_last_frame;
+      platform_view_layers[platform_view_id].push_back(layer);
+    }
     background_canvas->drawPicture(picture);
   }
   // If a layer was allocated in the previous frame, but it's not used in the current frame,
@@ -616,10 +619,10 @@ std::shared_ptr<FlutterPlatformViewLayer> FlutterPlatformViewsController::GetLay
     GrContext* gr_context,
     std::shared_ptr<IOSContext> ios_context,
     sk_sp<SkPicture> picture,
-    SkRect rect,
-    int64_t view_id,
-    int64_t overlay_id) {
+    const SkRegion& region,
+    int64_t view_id) {
   std::shared_ptr<FlutterPlatformViewLayer> layer = layer_pool_->GetLayer(gr_context, ios_context);
+  SkRect rect = SkRect::Make(region.getBounds());
 
   UIView* overlay_view_wrapper = layer->overlay_view_wrapper.get();
   auto screenScale = [UIScreen mainScreen].scale;
@@ -629,7 +632,7 @@ std::shared_ptr<FlutterPlatformViewLayer> FlutterPlatformViewsController::GetLay
                                           rect.width() / screenScale, rect.height() / screenScale);
   // Set a unique view identifier, so the overlay wrapper can be identified in unit tests.
   overlay_view_wrapper.accessibilityIdentifier =
-      [NSString stringWithFormat:@"platform_view[%lld].overlay[%lld]", view_id, overlay_id];
+      [NSString stringWithFormat:@"platform_view[%lld].overlay[0]", view_id];
 
   UIView* overlay_view = layer->overlay_view.get();
   // Set the size of the overlay view.
@@ -643,6 +646,11 @@ std::shared_ptr<FlutterPlatformViewLayer> FlutterPlatformViewsController::GetLay
   }
   SkCanvas* overlay_canvas = frame->SkiaCanvas();
   overlay_canvas->clear(SK_ColorTRANSPARENT);
+  // Only draw the parts of the picture that are above platform views, the rest
+  // of the overlay must let the content below show through.
+  SkRegion overlay_region = region;
+  overlay_region.translate(-rect.x(), -rect.y());
+  overlay_canvas->clipRegion(overlay_region);
   // Offset the picture since its absolute position on the scene is determined
   // by the position of the overlay view.
   overlay_canvas->translate(-rect.x(), -rect.y());
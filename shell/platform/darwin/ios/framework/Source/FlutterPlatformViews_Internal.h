@@ -15,6 +15,7 @@
 #include "flutter/shell/platform/darwin/ios/framework/Headers/FlutterPlugin.h"
 #include "flutter/shell/platform/darwin/ios/ios_context.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkRegion.h"
 
 // A UIView that is used as the parent for embedded UIViews.
 //
@@ -288,14 +289,16 @@ class FlutterPlatformViewsController {
   // If `true`, gpu thread and platform thread should be merged during |EndFrame|.
   // Always resets to `false` right after the threads are merged.
   bool merge_threads_ = false;
-  // Allocates a new FlutterPlatformViewLayer if needed, draws the pixels within the rect from
+  // Allocates a new FlutterPlatformViewLayer if needed, draws the pixels within the region from
   // the picture on the layer's canvas.
+  //
+  // The layer covers the bounds of the region, and is transparent outside of the region, so that
+  // a single layer can hold all the disjoint parts of a picture that are above platform views.
   std::shared_ptr<FlutterPlatformViewLayer> GetLayer(GrContext* gr_context,
                                                      std::shared_ptr<IOSContext> ios_context,
                                                      sk_sp<SkPicture> picture,
-                                                     SkRect rect,
-                                                     int64_t view_id,
-                                                     int64_t overlay_id);
+                                                     const SkRegion& region,
+                                                     int64_t view_id);
   // Removes overlay views and platform views that aren't needed in the current frame.
   // Must run on the platform thread.
   void RemoveUnusedLayers();
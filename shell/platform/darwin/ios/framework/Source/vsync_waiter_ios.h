@@ -29,6 +29,9 @@ class VsyncWaiterIOS final : public VsyncWaiter {
   // |VsyncWaiter|
   float GetDisplayRefreshRate() const override;
 
+  // |VsyncWaiter|
+  void SetPreferredFrameRate(float fps) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterIOS);
 };
 
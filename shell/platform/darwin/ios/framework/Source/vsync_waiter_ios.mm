@@ -35,6 +35,12 @@
 ///
 - (float)displayRefreshRate;
 
+//------------------------------------------------------------------------------
+/// @brief      Asks the display link to fire at the given rate, or at the maximum refresh rate of
+///             the display if it is 0. Must be called on the thread the display link runs on.
+///
+- (void)setPreferredFrameRate:(float)fps;
+
 @end
 
 namespace flutter {
@@ -62,6 +68,11 @@ float VsyncWaiterIOS::GetDisplayRefreshRate() const {
   return [client_.get() displayRefreshRate];
 }
 
+// |VsyncWaiter|
+void VsyncWaiterIOS::SetPreferredFrameRate(float fps) {
+  [client_.get() setPreferredFrameRate:fps];
+}
+
 }  // namespace flutter
 
 @implementation VSyncClient {
@@ -109,6 +120,12 @@ float VsyncWaiterIOS::GetDisplayRefreshRate() const {
   }
 }
 
+- (void)setPreferredFrameRate:(float)fps {
+  if (@available(iOS 10.0, *)) {
+    display_link_.get().preferredFramesPerSecond = static_cast<NSInteger>(fps);
+  }
+}
+
 - (void)await {
   display_link_.get().paused = NO;
 }
@@ -65,6 +65,18 @@ class IOSContext {
   ///
   virtual sk_sp<GrContext> CreateResourceContext() = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Create another resource context, for a thread that uploads
+  ///             textures besides the IO task runner. Called on that thread.
+  ///
+  /// @attention  Client rendering APIs whose resource contexts can't be
+  ///             realized more than once will always return null, which is the
+  ///             default.
+  ///
+  /// @return     A non-null Skia context on success. `nullptr` on failure.
+  ///
+  virtual sk_sp<GrContext> CreateWorkerResourceContext();
+
   //----------------------------------------------------------------------------
   /// @brief      When using client rendering APIs whose contexts need to be
   ///             bound to a specific thread, the engine will call this method
@@ -18,6 +18,10 @@ IOSContext::IOSContext() = default;
 
 IOSContext::~IOSContext() = default;
 
+sk_sp<GrContext> IOSContext::CreateWorkerResourceContext() {
+  return nullptr;
+}
+
 std::unique_ptr<IOSContext> IOSContext::Create(IOSRenderingAPI rendering_api) {
   switch (rendering_api) {
     case IOSRenderingAPI::kOpenGLES:
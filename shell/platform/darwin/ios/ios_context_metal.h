@@ -42,6 +42,9 @@ class IOSContextMetal final : public IOSContext {
   // |IOSContext|
   sk_sp<GrContext> CreateResourceContext() override;
 
+  // |IOSContext|
+  sk_sp<GrContext> CreateWorkerResourceContext() override;
+
   // |IOSContext|
   std::unique_ptr<GLContextResult> MakeCurrent() override;
 
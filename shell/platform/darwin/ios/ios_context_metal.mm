@@ -95,6 +95,18 @@ sk_sp<GrContext> IOSContextMetal::CreateResourceContext() {
   return resource_context_;
 }
 
+// |IOSContext|
+sk_sp<GrContext> IOSContextMetal::CreateWorkerResourceContext() {
+  // Metal devices and command queues may be used from any thread, so each upload thread only needs
+  // a GrContext of its own.
+  auto context =
+      GrContext::MakeMetal([device_ retain], [main_queue_ retain], CreateMetalGrContextOptions());
+  if (context) {
+    context->setResourceCacheLimits(0u, 0u);
+  }
+  return context;
+}
+
 // |IOSContext|
 std::unique_ptr<GLContextResult> IOSContextMetal::MakeCurrent() {
   // This only makes sense for context that need to be bound to a specific thread.
@@ -21,4 +21,9 @@ bool IOSSwitchableGLContext::RemoveCurrent() {
   FML_DCHECK_CREATION_THREAD_IS_CURRENT(checker);
   return [EAGLContext setCurrentContext:previous_context_];
 };
+
+bool IOSSwitchableGLContext::IsCurrent() {
+  FML_DCHECK_CREATION_THREAD_IS_CURRENT(checker);
+  return EAGLContext.currentContext == context_;
+};
 }
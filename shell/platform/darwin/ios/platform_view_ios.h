@@ -140,6 +140,9 @@ class PlatformViewIOS final : public PlatformView {
   // |PlatformView|
   sk_sp<GrContext> CreateResourceContext() const override;
 
+  // |PlatformView|
+  sk_sp<GrContext> CreateWorkerResourceContext() const override;
+
   // |PlatformView|
   void SetAccessibilityFeatures(int32_t flags) override;
 
@@ -150,6 +153,9 @@ class PlatformViewIOS final : public PlatformView {
   // |PlatformView|
   std::unique_ptr<VsyncWaiter> CreateVSyncWaiter() override;
 
+  // |PlatformView|
+  ImageDecoderBackends CreateImageDecoderBackends() override;
+
   // |PlatformView|
   void OnPreEngineRestart() const override;
 
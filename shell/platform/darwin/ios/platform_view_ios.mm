@@ -10,6 +10,7 @@
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "flutter/shell/platform/darwin/common/image_decoder_backend_image_io.h"
 #import "flutter/shell/platform/darwin/ios/framework/Source/FlutterViewController_Internal.h"
 #import "flutter/shell/platform/darwin/ios/framework/Source/vsync_waiter_ios.h"
 
@@ -142,6 +143,11 @@ sk_sp<GrContext> PlatformViewIOS::CreateResourceContext() const {
   return ios_context_->CreateResourceContext();
 }
 
+// |PlatformView|
+sk_sp<GrContext> PlatformViewIOS::CreateWorkerResourceContext() const {
+  return ios_context_->CreateWorkerResourceContext();
+}
+
 // |PlatformView|
 void PlatformViewIOS::SetSemanticsEnabled(bool enabled) {
   if (!owner_controller_) {
@@ -181,6 +187,11 @@ std::unique_ptr<VsyncWaiter> PlatformViewIOS::CreateVSyncWaiter() {
   return std::make_unique<VsyncWaiterIOS>(task_runners_);
 }
 
+// |PlatformView|
+ImageDecoderBackends PlatformViewIOS::CreateImageDecoderBackends() {
+  return {std::make_shared<ImageDecoderBackendImageIO>()};
+}
+
 void PlatformViewIOS::OnPreEngineRestart() const {
   if (accessibility_bridge_) {
     accessibility_bridge_->clearState();
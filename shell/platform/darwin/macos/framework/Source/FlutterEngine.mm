@@ -9,6 +9,7 @@
 
 #import "flutter/shell/platform/darwin/macos/framework/Source/FlutterDartProject_Internal.h"
 #import "flutter/shell/platform/darwin/macos/framework/Source/FlutterExternalTextureGL.h"
+#import "flutter/shell/platform/darwin/macos/framework/Source/FlutterIOSurfaceCompositor.h"
 #import "flutter/shell/platform/darwin/macos/framework/Source/FlutterViewController_Internal.h"
 #import "flutter/shell/platform/embedder/embedder.h"
 
@@ -163,6 +164,9 @@ static bool OnAcquireExternalTexture(FlutterEngine* engine,
 
   // A mapping of textureID to internal FlutterExternalTextureGL adapter.
   NSMutableDictionary<NSNumber*, FlutterExternalTextureGL*>* _textures;
+
+  // Presents the frames of the engine in the view of the view controller.
+  FlutterIOSurfaceCompositor* _compositor;
 }
 
 - (instancetype)initWithName:(NSString*)labelPrefix project:(FlutterDartProject*)project {
@@ -178,6 +182,7 @@ static bool OnAcquireExternalTexture(FlutterEngine* engine,
   _project = project ?: [[FlutterDartProject alloc] init];
   _messageHandlers = [[NSMutableDictionary alloc] init];
   _textures = [[NSMutableDictionary alloc] init];
+  _compositor = [[FlutterIOSurfaceCompositor alloc] init];
   _allowHeadlessExecution = allowHeadlessExecution;
 
   return self;
@@ -239,6 +244,8 @@ static bool OnAcquireExternalTexture(FlutterEngine* engine,
       .render_task_runner = &cocoa_task_runner_description,
   };
   flutterArguments.custom_task_runners = &custom_task_runners;
+  const FlutterCompositor compositor = [_compositor flutterCompositor];
+  flutterArguments.compositor = &compositor;
 
   FlutterEngineResult result = FlutterEngineInitialize(
       FLUTTER_ENGINE_VERSION, &rendererConfig, &flutterArguments, (__bridge void*)(self), &_engine);
@@ -260,6 +267,7 @@ static bool OnAcquireExternalTexture(FlutterEngine* engine,
 - (void)setViewController:(FlutterViewController*)controller {
   _viewController = controller;
   _mainOpenGLContext = controller.flutterView.openGLContext;
+  _compositor.view = controller.flutterView;
   if (!controller && !_allowHeadlessExecution) {
     [self shutDownEngine];
     _resourceContext = nil;
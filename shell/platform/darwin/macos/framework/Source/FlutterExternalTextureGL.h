@@ -23,6 +23,7 @@
  * When the user side marks the textureID as available, the Flutter engine will
  * callback to this method and ask for populate the |openGLTexture| object,
  * such as the texture type and the format of the pixel buffer and the texture object.
+ * The IOSurfaces of BGRA pixel buffers are bound to the texture without copies.
  */
 - (BOOL)populateTexture:(nonnull FlutterOpenGLTexture*)openGLTexture;
 
@@ -6,12 +6,29 @@
 
 #import <AppKit/AppKit.h>
 #import <CoreVideo/CoreVideo.h>
+#import <OpenGL/CGLIOSurface.h>
 #import <OpenGL/gl.h>
+#import <OpenGL/glext.h>
 
 static void OnCVOpenGLTextureRelease(CVOpenGLTextureRef cvOpenGLTexture) {
   CVOpenGLTextureRelease(cvOpenGLTexture);
 }
 
+/**
+ * A texture bound to the IOSurface of a pixel buffer, which is kept alive as long as the engine
+ * reads from the texture.
+ */
+struct IOSurfaceTexture {
+  CVPixelBufferRef pixelBuffer;
+  GLuint name;
+};
+
+static void OnIOSurfaceTextureRelease(IOSurfaceTexture* texture) {
+  glDeleteTextures(1, &texture->name);
+  CVPixelBufferRelease(texture->pixelBuffer);
+  delete texture;
+}
+
 @implementation FlutterExternalTextureGL {
   /**
    * OpenGL texture cache.
@@ -43,6 +60,10 @@ static void OnCVOpenGLTextureRelease(CVOpenGLTextureRef cvOpenGLTexture) {
     return NO;
   }
 
+  if ([self populateTexture:openGLTexture fromIOSurfaceOfPixelBuffer:pixelBuffer]) {
+    return YES;
+  }
+
   // Create the opengl texture cache if necessary.
   if (!_openGLTextureCache) {
     CGLContextObj context = [NSOpenGLContext currentContext].CGLContextObj;
@@ -78,6 +99,43 @@ static void OnCVOpenGLTextureRelease(CVOpenGLTextureRef cvOpenGLTexture) {
   return YES;
 }
 
+#pragma mark - Private methods
+
+/**
+ * Binds the IOSurface of |pixelBuffer| to a texture, without copying it, if it has one in a format
+ * that can be bound. Takes ownership of |pixelBuffer| if it returns YES.
+ */
+- (BOOL)populateTexture:(FlutterOpenGLTexture*)openGLTexture
+    fromIOSurfaceOfPixelBuffer:(CVPixelBufferRef)pixelBuffer {
+  IOSurfaceRef ioSurface = CVPixelBufferGetIOSurface(pixelBuffer);
+  if (!ioSurface || CVPixelBufferGetPixelFormatType(pixelBuffer) != kCVPixelFormatType_32BGRA) {
+    return NO;
+  }
+
+  const size_t width = IOSurfaceGetWidth(ioSurface);
+  const size_t height = IOSurfaceGetHeight(ioSurface);
+  GLuint name = 0;
+  glGenTextures(1, &name);
+  glBindTexture(GL_TEXTURE_RECTANGLE_ARB, name);
+  CGLError error = CGLTexImageIOSurface2D(
+      CGLGetCurrentContext(), GL_TEXTURE_RECTANGLE_ARB, GL_RGBA, static_cast<GLsizei>(width),
+      static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, ioSurface, 0);
+  glBindTexture(GL_TEXTURE_RECTANGLE_ARB, 0);
+  if (error != kCGLNoError) {
+    glDeleteTextures(1, &name);
+    return NO;
+  }
+
+  openGLTexture->target = GL_TEXTURE_RECTANGLE_ARB;
+  openGLTexture->name = name;
+  openGLTexture->format = static_cast<uint32_t>(GL_RGBA8);
+  openGLTexture->destruction_callback = (VoidCallback)OnIOSurfaceTextureRelease;
+  openGLTexture->user_data = new IOSurfaceTexture{pixelBuffer, name};
+  openGLTexture->width = width;
+  openGLTexture->height = height;
+  return YES;
+}
+
 - (void)dealloc {
   CVOpenGLTextureCacheRelease(_openGLTextureCache);
 }
@@ -0,0 +1,52 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import <Cocoa/Cocoa.h>
+
+#import "flutter/shell/platform/embedder/embedder.h"
+
+/**
+ * Composites the layers of the frames of the Flutter engine into the layer of a view, without
+ * copying their contents.
+ *
+ * The engine renders each layer into a backing store made of a pair of IOSurfaces, one of which
+ * is bound to an OpenGL framebuffer at a time. When the layers are presented, the IOSurface that
+ * was rendered into becomes the contents of a sublayer of the view, and the framebuffer is bound
+ * to the other IOSurface, so that the next frame is not rendered into the IOSurface on screen.
+ * The IOSurfaces of the collected backing stores are kept for the next backing stores of the same
+ * size.
+ *
+ * All the methods must be called on the thread the engine renders on, and the backing store
+ * methods with the context the engine renders with current.
+ */
+@interface FlutterIOSurfaceCompositor : NSObject
+
+/**
+ * The view the layers are presented in.
+ */
+@property(nonatomic, weak, nullable) NSView* view;
+
+/**
+ * Returns the compositor to pass to the engine, whose callbacks call this object, which must
+ * outlive the engine.
+ */
+- (FlutterCompositor)flutterCompositor;
+
+/**
+ * Fills |backingStore| with a framebuffer of the size of |config|.
+ */
+- (BOOL)createBackingStore:(nonnull const FlutterBackingStoreConfig*)config
+              backingStore:(nonnull FlutterBackingStore*)backingStore;
+
+/**
+ * Collects a backing store created by |createBackingStore:backingStore:|.
+ */
+- (BOOL)collectBackingStore:(nonnull const FlutterBackingStore*)backingStore;
+
+/**
+ * Replaces the sublayers of the view with |layers|, in order.
+ */
+- (BOOL)presentLayers:(nonnull const FlutterLayer**)layers count:(size_t)count;
+
+@end
@@ -0,0 +1,311 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "flutter/shell/platform/darwin/macos/framework/Source/FlutterIOSurfaceCompositor.h"
+
+#import <CoreVideo/CoreVideo.h>
+#import <IOSurface/IOSurface.h>
+#import <OpenGL/CGLIOSurface.h>
+#import <OpenGL/gl.h>
+#import <OpenGL/glext.h>
+#import <QuartzCore/QuartzCore.h>
+
+/**
+ * The number of unused IOSurfaces kept for reuse, which is enough for the backing stores of a
+ * couple of layers.
+ */
+static const NSUInteger kMaxPooledSurfaces = 4;
+
+static IOSurfaceRef CreateIOSurface(size_t width, size_t height) {
+  NSDictionary* properties = @{
+    (id)kIOSurfaceWidth : @(width),
+    (id)kIOSurfaceHeight : @(height),
+    (id)kIOSurfaceBytesPerElement : @(4),
+    (id)kIOSurfacePixelFormat : @(kCVPixelFormatType_32BGRA),
+  };
+  return IOSurfaceCreate((__bridge CFDictionaryRef)properties);
+}
+
+static void OnFramebufferRelease(void* user_data) {
+  // The framebuffer is deleted when its backing store is collected.
+}
+
+/**
+ * The backing store of a layer: two IOSurfaces, each bound to a texture, and a framebuffer with
+ * the texture of the back surface as its color attachment.
+ */
+@interface FlutterIOSurfaceBackingStore : NSObject
+
+@property(nonatomic, readonly) size_t width;
+@property(nonatomic, readonly) size_t height;
+@property(nonatomic, readonly) GLuint framebuffer;
+
+/**
+ * Takes ownership of the two |surfaces|, which must be of the given size. Returns nil if the
+ * framebuffer could not be set up.
+ */
+- (nullable instancetype)initWithSurfaces:(nonnull IOSurfaceRef*)surfaces
+                                    width:(size_t)width
+                                   height:(size_t)height;
+
+/**
+ * The surface last rendered into before |swapSurfaces|, which is the one to display.
+ */
+- (nonnull IOSurfaceRef)frontSurface;
+
+/**
+ * Makes the back surface the front one, and renders into the other one from then on.
+ */
+- (void)swapSurfaces;
+
+/**
+ * Deletes the framebuffer and textures, and returns the two surfaces, which the caller then owns.
+ */
+- (void)releaseSurfaces:(nonnull IOSurfaceRef*)surfaces;
+
+@end
+
+@implementation FlutterIOSurfaceBackingStore {
+  IOSurfaceRef _surfaces[2];
+  GLuint _textures[2];
+  // The index of the surface that is rendered into.
+  int _back;
+}
+
+- (instancetype)initWithSurfaces:(IOSurfaceRef*)surfaces width:(size_t)width height:(size_t)height {
+  self = [super init];
+  if (self) {
+    _width = width;
+    _height = height;
+    _surfaces[0] = surfaces[0];
+    _surfaces[1] = surfaces[1];
+
+    CGLContextObj context = CGLGetCurrentContext();
+    glGenTextures(2, _textures);
+    for (int i = 0; i < 2; i++) {
+      glBindTexture(GL_TEXTURE_RECTANGLE_ARB, _textures[i]);
+      CGLError error = CGLTexImageIOSurface2D(
+          context, GL_TEXTURE_RECTANGLE_ARB, GL_RGBA, static_cast<GLsizei>(width),
+          static_cast<GLsizei>(height), GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, _surfaces[i], 0);
+      if (error != kCGLNoError) {
+        NSLog(@"Could not bind an IOSurface to a texture: CGLError %d", error);
+      }
+    }
+    glBindTexture(GL_TEXTURE_RECTANGLE_ARB, 0);
+
+    glGenFramebuffers(1, &_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_RECTANGLE_ARB,
+                           _textures[_back], 0);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+      NSLog(@"IOSurface framebuffer was incomplete: status 0x%x", status);
+      IOSurfaceRef unused[2];
+      [self releaseSurfaces:unused];
+      CFRelease(unused[0]);
+      CFRelease(unused[1]);
+      return nil;
+    }
+  }
+  return self;
+}
+
+- (IOSurfaceRef)frontSurface {
+  return _surfaces[1 - _back];
+}
+
+- (void)swapSurfaces {
+  _back = 1 - _back;
+  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_RECTANGLE_ARB,
+                         _textures[_back], 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+- (void)releaseSurfaces:(IOSurfaceRef*)surfaces {
+  glDeleteFramebuffers(1, &_framebuffer);
+  glDeleteTextures(2, _textures);
+  _framebuffer = 0;
+  surfaces[0] = _surfaces[0];
+  surfaces[1] = _surfaces[1];
+  _surfaces[0] = nullptr;
+  _surfaces[1] = nullptr;
+}
+
+- (void)dealloc {
+  // Only reached if the backing store was never collected, in which case there may be no context
+  // to delete the framebuffer with.
+  for (IOSurfaceRef surface : _surfaces) {
+    if (surface) {
+      CFRelease(surface);
+    }
+  }
+}
+
+@end
+
+#pragma mark - Static methods provided to the engine
+
+static bool OnCreateBackingStore(const FlutterBackingStoreConfig* config,
+                                 FlutterBackingStore* backing_store_out,
+                                 void* user_data) {
+  return [(__bridge FlutterIOSurfaceCompositor*)user_data createBackingStore:config
+                                                                backingStore:backing_store_out];
+}
+
+static bool OnCollectBackingStore(const FlutterBackingStore* backing_store, void* user_data) {
+  return [(__bridge FlutterIOSurfaceCompositor*)user_data collectBackingStore:backing_store];
+}
+
+static bool OnPresentLayers(const FlutterLayer** layers, size_t layers_count, void* user_data) {
+  return [(__bridge FlutterIOSurfaceCompositor*)user_data presentLayers:layers count:layers_count];
+}
+
+#pragma mark -
+
+@implementation FlutterIOSurfaceCompositor {
+  // Unused IOSurfaces, most recently collected last.
+  NSMutableArray* _pooledSurfaces;
+
+  // The sublayers of the view, one per presented backing store, in order.
+  NSMutableArray<CALayer*>* _contentLayers;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _pooledSurfaces = [[NSMutableArray alloc] init];
+    _contentLayers = [[NSMutableArray alloc] init];
+  }
+  return self;
+}
+
+- (FlutterCompositor)flutterCompositor {
+  FlutterCompositor compositor = {};
+  compositor.struct_size = sizeof(FlutterCompositor);
+  compositor.user_data = (__bridge void*)self;
+  compositor.create_backing_store_callback = OnCreateBackingStore;
+  compositor.collect_backing_store_callback = OnCollectBackingStore;
+  compositor.present_layers_callback = OnPresentLayers;
+  return compositor;
+}
+
+- (BOOL)createBackingStore:(const FlutterBackingStoreConfig*)config
+              backingStore:(FlutterBackingStore*)backingStore {
+  const size_t width = static_cast<size_t>(config->size.width);
+  const size_t height = static_cast<size_t>(config->size.height);
+
+  IOSurfaceRef surfaces[2] = {[self takePooledSurfaceWithWidth:width height:height],
+                              [self takePooledSurfaceWithWidth:width height:height]};
+  for (IOSurfaceRef& surface : surfaces) {
+    if (!surface) {
+      surface = CreateIOSurface(width, height);
+    }
+  }
+  if (!surfaces[0] || !surfaces[1]) {
+    NSLog(@"Could not create IOSurfaces of %zux%zu.", width, height);
+    for (IOSurfaceRef surface : surfaces) {
+      if (surface) {
+        CFRelease(surface);
+      }
+    }
+    return NO;
+  }
+
+  FlutterIOSurfaceBackingStore* store =
+      [[FlutterIOSurfaceBackingStore alloc] initWithSurfaces:surfaces width:width height:height];
+  if (!store) {
+    return NO;
+  }
+
+  backingStore->type = kFlutterBackingStoreTypeOpenGL;
+  backingStore->user_data = (__bridge_retained void*)store;
+  backingStore->open_gl.type = kFlutterOpenGLTargetTypeFramebuffer;
+  backingStore->open_gl.framebuffer.target = GL_RGBA8;
+  backingStore->open_gl.framebuffer.name = store.framebuffer;
+  backingStore->open_gl.framebuffer.user_data = nullptr;
+  backingStore->open_gl.framebuffer.destruction_callback = OnFramebufferRelease;
+  return YES;
+}
+
+- (BOOL)collectBackingStore:(const FlutterBackingStore*)backingStore {
+  FlutterIOSurfaceBackingStore* store =
+      (__bridge_transfer FlutterIOSurfaceBackingStore*)backingStore->user_data;
+  IOSurfaceRef surfaces[2];
+  [store releaseSurfaces:surfaces];
+  for (IOSurfaceRef surface : surfaces) {
+    // The engine only collects the backing stores the last presented frame did not use, so
+    // neither surface is on screen.
+    [_pooledSurfaces addObject:(__bridge_transfer id)surface];
+  }
+  while (_pooledSurfaces.count > kMaxPooledSurfaces) {
+    [_pooledSurfaces removeObjectAtIndex:0];
+  }
+  return YES;
+}
+
+- (BOOL)presentLayers:(const FlutterLayer**)layers count:(size_t)count {
+  NSView* view = self.view;
+  if (!view) {
+    return NO;
+  }
+
+  // The IOSurfaces are read by the window server, which does not wait for the rendering commands
+  // that were not submitted yet.
+  glFlush();
+
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  NSUInteger presented = 0;
+  for (size_t i = 0; i < count; i++) {
+    const FlutterLayer* layer = layers[i];
+    if (layer->type != kFlutterLayerContentTypeBackingStore) {
+      // There are no platform views on macOS yet. Their layers would go between the content
+      // layers here.
+      continue;
+    }
+    FlutterIOSurfaceBackingStore* store =
+        (__bridge FlutterIOSurfaceBackingStore*)layer->backing_store->user_data;
+    if (layer->backing_store->did_update) {
+      [store swapSurfaces];
+    }
+
+    if (presented == _contentLayers.count) {
+      CALayer* contentLayer = [CALayer layer];
+      // OpenGL renders bottom-up.
+      contentLayer.transform = CATransform3DMakeScale(1, -1, 1);
+      [view.layer addSublayer:contentLayer];
+      [_contentLayers addObject:contentLayer];
+    }
+    CALayer* contentLayer = _contentLayers[presented++];
+    contentLayer.frame = [view convertRectFromBacking:NSMakeRect(layer->offset.x, layer->offset.y,
+                                                                 layer->size.width,
+                                                                 layer->size.height)];
+    contentLayer.contentsScale = view.layer.contentsScale;
+    contentLayer.contents = (__bridge id)store.frontSurface;
+  }
+  while (_contentLayers.count > presented) {
+    [_contentLayers.lastObject removeFromSuperlayer];
+    [_contentLayers removeLastObject];
+  }
+  [CATransaction commit];
+  return YES;
+}
+
+#pragma mark - Private methods
+
+- (IOSurfaceRef)takePooledSurfaceWithWidth:(size_t)width height:(size_t)height {
+  for (NSUInteger i = _pooledSurfaces.count; i > 0; i--) {
+    IOSurfaceRef surface = (__bridge IOSurfaceRef)_pooledSurfaces[i - 1];
+    if (IOSurfaceGetWidth(surface) == width && IOSurfaceGetHeight(surface) == height) {
+      CFRetain(surface);
+      [_pooledSurfaces removeObjectAtIndex:i - 1];
+      return surface;
+    }
+  }
+  return nullptr;
+}
+
+@end
@@ -17,8 +17,17 @@
 /**
  * View capable of acting as a rendering target and input source for the Flutter
  * engine.
+ *
+ * The view is layer-backed. The engine renders into IOSurfaces, which are handed to sublayers of
+ * the layer of the view by a FlutterIOSurfaceCompositor, so the view itself has no drawable.
  */
-@interface FlutterView : NSOpenGLView
+@interface FlutterView : NSView
+
+/**
+ * The context the engine renders with, which shares its resources with the share context the view
+ * was initialized with.
+ */
+@property(nonatomic, readonly, nonnull) NSOpenGLContext* openGLContext;
 
 - (nullable instancetype)initWithFrame:(NSRect)frame
                           shareContext:(nonnull NSOpenGLContext*)shareContext
@@ -29,8 +38,6 @@
                               reshapeListener:
                                   (nonnull id<FlutterViewReshapeListener>)reshapeListener;
 
-- (nullable instancetype)initWithFrame:(NSRect)frameRect
-                           pixelFormat:(nullable NSOpenGLPixelFormat*)format NS_UNAVAILABLE;
 - (nonnull instancetype)initWithFrame:(NSRect)frameRect NS_UNAVAILABLE;
 - (nullable instancetype)initWithCoder:(nonnull NSCoder*)coder NS_UNAVAILABLE;
 - (nonnull instancetype)init NS_UNAVAILABLE;
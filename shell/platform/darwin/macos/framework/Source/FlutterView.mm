@@ -18,10 +18,12 @@
               reshapeListener:(id<FlutterViewReshapeListener>)reshapeListener {
   self = [super initWithFrame:frame];
   if (self) {
-    self.openGLContext = [[NSOpenGLContext alloc] initWithFormat:shareContext.pixelFormat
-                                                    shareContext:shareContext];
+    _openGLContext = [[NSOpenGLContext alloc] initWithFormat:shareContext.pixelFormat
+                                                shareContext:shareContext];
     _reshapeListener = reshapeListener;
-    self.wantsBestResolutionOpenGLSurface = YES;
+    self.wantsLayer = YES;
+    // The contents are provided by the compositor, and never drawn by the view.
+    self.layerContentsRedrawPolicy = NSViewLayerContentsRedrawNever;
   }
   return self;
 }
@@ -39,8 +41,8 @@
   return YES;
 }
 
-- (void)reshape {
-  [super reshape];
+- (void)setFrameSize:(NSSize)newSize {
+  [super setFrameSize:newSize];
   [_reshapeListener viewDidReshape:self];
 }
 
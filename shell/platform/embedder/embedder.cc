@@ -5,7 +5,10 @@
 #define FML_USED_ON_EMBEDDER
 #define RAPIDJSON_HAS_STDSTRING 1
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <mutex>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/closure.h"
@@ -43,6 +46,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_engine.h"
+#include "flutter/shell/platform/embedder/embedder_engine_group.h"
 #include "flutter/shell/platform/embedder/embedder_platform_message_response.h"
 #include "flutter/shell/platform/embedder/embedder_render_target.h"
 #include "flutter/shell/platform/embedder/embedder_safe_access.h"
@@ -52,6 +56,14 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/writer.h"
 
+#if OS_LINUX
+#include "flutter/shell/platform/embedder/embedder_dmabuf_importer.h"
+#endif  // OS_LINUX
+
+#ifdef SHELL_ENABLE_VULKAN
+#include "third_party/skia/include/gpu/vk/GrVkTypes.h"
+#endif  // SHELL_ENABLE_VULKAN
+
 const int32_t kFlutterSemanticsNodeIdBatchEnd = -1;
 const int32_t kFlutterSemanticsCustomActionIdBatchEnd = -1;
 
@@ -88,11 +100,15 @@ static bool IsOpenGLRendererConfigValid(const FlutterRendererConfig* config) {
 
   if (SAFE_ACCESS(open_gl_config, make_current, nullptr) == nullptr ||
       SAFE_ACCESS(open_gl_config, clear_current, nullptr) == nullptr ||
-      SAFE_ACCESS(open_gl_config, present, nullptr) == nullptr ||
       SAFE_ACCESS(open_gl_config, fbo_callback, nullptr) == nullptr) {
     return false;
   }
 
+  if (SAFE_ACCESS(open_gl_config, present, nullptr) == nullptr &&
+      SAFE_ACCESS(open_gl_config, present_with_info, nullptr) == nullptr) {
+    return false;
+  }
+
   return true;
 }
 
@@ -104,7 +120,30 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, surface_present_with_info_callback,
+                  nullptr) == nullptr) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool IsVulkanRendererConfigValid(const FlutterRendererConfig* config) {
+  if (config->type != kVulkan) {
+    return false;
+  }
+
+  const FlutterVulkanRendererConfig* vulkan_config = &config->vulkan;
+
+  if (SAFE_ACCESS(vulkan_config, instance, nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, physical_device, nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, device, nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, queue, nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, get_instance_proc_address_callback,
+                  nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, get_next_image_callback, nullptr) == nullptr ||
+      SAFE_ACCESS(vulkan_config, present_image_callback, nullptr) == nullptr) {
     return false;
   }
 
@@ -121,6 +160,8 @@ static bool IsRendererValid(const FlutterRendererConfig* config) {
       return IsOpenGLRendererConfigValid(config);
     case kSoftware:
       return IsSoftwareRendererConfigValid(config);
+    case kVulkan:
+      return IsVulkanRendererConfigValid(config);
     default:
       return false;
   }
@@ -141,6 +182,19 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // OS_LINUX || OS_WIN
 
+// Describes the repainted |damage| of a frame, which is stored in |rect|.
+static FlutterDamage ToFlutterDamage(const SkIRect& damage, FlutterRect* rect) {
+  *rect = FlutterRect{static_cast<double>(damage.left()),
+                      static_cast<double>(damage.top()),
+                      static_cast<double>(damage.right()),
+                      static_cast<double>(damage.bottom())};
+  FlutterDamage flutter_damage = {};
+  flutter_damage.struct_size = sizeof(FlutterDamage);
+  flutter_damage.num_rects = damage.isEmpty() ? 0 : 1;
+  flutter_damage.damage = rect;
+  return flutter_damage;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferOpenGLPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -148,7 +202,8 @@ InferOpenGLPlatformViewCreationCallback(
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
-        external_view_embedder) {
+        external_view_embedder,
+    std::shared_ptr<flutter::EmbedderEngineGroup> engine_group) {
   if (config->type != kOpenGL) {
     return nullptr;
   }
@@ -159,14 +214,48 @@ InferOpenGLPlatformViewCreationCallback(
   auto gl_clear_current = [ptr = config->open_gl.clear_current,
                            user_data]() -> bool { return ptr(user_data); };
 
-  auto gl_present = [ptr = config->open_gl.present, user_data]() -> bool {
-    return ptr(user_data);
-  };
-
   auto gl_fbo_callback = [ptr = config->open_gl.fbo_callback,
                           user_data]() -> intptr_t { return ptr(user_data); };
 
   const FlutterOpenGLRendererConfig* open_gl_config = &config->open_gl;
+  std::function<bool()> gl_present = nullptr;
+  if (SAFE_ACCESS(open_gl_config, present, nullptr) != nullptr) {
+    gl_present = [ptr = config->open_gl.present, user_data]() -> bool {
+      return ptr(user_data);
+    };
+  }
+
+  std::function<bool(const SkIRect&)> gl_present_with_damage = nullptr;
+  if (SAFE_ACCESS(open_gl_config, present_with_info, nullptr) != nullptr) {
+    gl_present_with_damage = [ptr = config->open_gl.present_with_info,
+                              user_data](const SkIRect& damage) -> bool {
+      FlutterRect rect;
+      FlutterOpenGLPresentInfo present_info = {};
+      present_info.struct_size = sizeof(FlutterOpenGLPresentInfo);
+      present_info.frame_damage = ToFlutterDamage(damage, &rect);
+      return ptr(user_data, &present_info);
+    };
+  }
+
+  std::function<int()> gl_fbo_buffer_age_callback = nullptr;
+  if (SAFE_ACCESS(open_gl_config, fbo_buffer_age_callback, nullptr) !=
+      nullptr) {
+    gl_fbo_buffer_age_callback =
+        [ptr = config->open_gl.fbo_buffer_age_callback, user_data]() -> int {
+      return static_cast<int>(ptr(user_data));
+    };
+  }
+
+  std::function<void(const SkIRect&)> gl_set_damage_region_callback = nullptr;
+  if (SAFE_ACCESS(open_gl_config, set_damage_region, nullptr) != nullptr) {
+    gl_set_damage_region_callback = [ptr = config->open_gl.set_damage_region,
+                                     user_data](const SkIRect& damage) {
+      FlutterRect rect;
+      FlutterDamage flutter_damage = ToFlutterDamage(damage, &rect);
+      ptr(user_data, &flutter_damage);
+    };
+  }
+
   std::function<bool()> gl_make_resource_current_callback = nullptr;
   if (SAFE_ACCESS(open_gl_config, make_resource_current, nullptr) != nullptr) {
     gl_make_resource_current_callback =
@@ -215,6 +304,9 @@ InferOpenGLPlatformViewCreationCallback(
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
+  bool skip_redundant_context_switches =
+      SAFE_ACCESS(open_gl_config, skip_redundant_context_switches, false);
+
   flutter::EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table = {
       gl_make_current,                     // gl_make_current_callback
       gl_clear_current,                    // gl_clear_current_callback
@@ -223,19 +315,25 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      gl_present_with_damage,              // gl_present_with_damage_callback
+      gl_fbo_buffer_age_callback,          // gl_fbo_buffer_age_callback
+      gl_set_damage_region_callback,       // gl_set_damage_region_callback
+      skip_redundant_context_switches,     // skip_redundant_context_switches
   };
 
   return fml::MakeCopyable(
       [gl_dispatch_table, fbo_reset_after_present, platform_dispatch_table,
-       external_view_embedder =
-           std::move(external_view_embedder)](flutter::Shell& shell) mutable {
+       external_view_embedder = std::move(external_view_embedder),
+       engine_group =
+           std::move(engine_group)](flutter::Shell& shell) mutable {
         return std::make_unique<flutter::PlatformViewEmbedder>(
             shell,                    // delegate
             shell.GetTaskRunners(),   // task runners
             gl_dispatch_table,        // embedder GL dispatch table
             fbo_reset_after_present,  // fbo reset after present
             platform_dispatch_table,  // embedder platform dispatch table
-            std::move(external_view_embedder)  // external view embedder
+            std::move(external_view_embedder),  // external view embedder
+            std::move(engine_group)             // engine group
         );
       });
 }
@@ -252,15 +350,63 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store = nullptr;
+  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) !=
+      nullptr) {
+    software_present_backing_store =
+        [ptr = config->software.surface_present_callback, user_data](
+            const void* allocation, size_t row_bytes, size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  std::function<bool(const void*, size_t, size_t, const SkIRect&)>
+      software_present_backing_store_with_damage = nullptr;
+  if (SAFE_ACCESS(software_config, surface_present_with_info_callback,
+                  nullptr) != nullptr) {
+    software_present_backing_store_with_damage =
+        [ptr = config->software.surface_present_with_info_callback,
+         user_data](const void* allocation, size_t row_bytes, size_t height,
+                    const SkIRect& damage) -> bool {
+      FlutterRect rect;
+      FlutterSoftwarePresentInfo present_info = {};
+      present_info.struct_size = sizeof(FlutterSoftwarePresentInfo);
+      present_info.allocation = allocation;
+      present_info.row_bytes = row_bytes;
+      present_info.height = height;
+      present_info.frame_damage = ToFlutterDamage(damage, &rect);
+      return ptr(user_data, &present_info);
+    };
+  }
+
+  std::function<bool(const SkISize&,
+                     flutter::EmbedderSurfaceSoftware::Buffer*)>
+      software_acquire_buffer = nullptr;
+  if (SAFE_ACCESS(software_config, surface_acquire_buffer_callback, nullptr) !=
+      nullptr) {
+    software_acquire_buffer =
+        [ptr = config->software.surface_acquire_buffer_callback, user_data](
+            const SkISize& size,
+            flutter::EmbedderSurfaceSoftware::Buffer* buffer) -> bool {
+      FlutterSoftwareBuffer software_buffer = {};
+      software_buffer.struct_size = sizeof(FlutterSoftwareBuffer);
+      if (!ptr(user_data, size.width(), size.height(), &software_buffer)) {
+        return false;
+      }
+      buffer->allocation = software_buffer.allocation;
+      buffer->row_bytes = software_buffer.row_bytes;
+      buffer->age = static_cast<int>(software_buffer.age);
+      return true;
+    };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,              // required*
+          software_present_backing_store_with_damage,  // optional
+          software_acquire_buffer,                     // optional
       };
 
   return fml::MakeCopyable(
@@ -277,6 +423,89 @@ InferSoftwarePlatformViewCreationCallback(
       });
 }
 
+static flutter::Shell::CreateCallback<flutter::PlatformView>
+InferVulkanPlatformViewCreationCallback(
+    const FlutterRendererConfig* config,
+    void* user_data,
+    flutter::PlatformViewEmbedder::PlatformDispatchTable
+        platform_dispatch_table,
+    std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
+        external_view_embedder,
+    std::shared_ptr<flutter::EmbedderEngineGroup> engine_group) {
+  if (config->type != kVulkan) {
+    return nullptr;
+  }
+
+#ifdef SHELL_ENABLE_VULKAN
+  const FlutterVulkanRendererConfig* vulkan_config = &config->vulkan;
+
+  // The handles were checked in IsVulkanRendererConfigValid.
+  flutter::EmbedderSurfaceVulkan::Context vulkan_context = {};
+  vulkan_context.version = SAFE_ACCESS(vulkan_config, version, 0);
+  vulkan_context.instance = static_cast<VkInstance>(vulkan_config->instance);
+  vulkan_context.physical_device =
+      static_cast<VkPhysicalDevice>(vulkan_config->physical_device);
+  vulkan_context.device = static_cast<VkDevice>(vulkan_config->device);
+  vulkan_context.queue_family_index =
+      SAFE_ACCESS(vulkan_config, queue_family_index, 0);
+  vulkan_context.queue = static_cast<VkQueue>(vulkan_config->queue);
+
+  auto vulkan_get_instance_proc_address =
+      reinterpret_cast<PFN_vkGetInstanceProcAddr>(
+          vulkan_config->get_instance_proc_address_callback(
+              user_data, nullptr, "vkGetInstanceProcAddr"));
+
+  auto vulkan_get_next_image =
+      [ptr = vulkan_config->get_next_image_callback,
+       user_data](const SkISize& size) {
+        FlutterVulkanImage image = ptr(user_data, size.width(), size.height());
+        flutter::GPUSurfaceVulkanDelegate::Image result;
+        if (image.struct_size != sizeof(FlutterVulkanImage)) {
+          FML_LOG(ERROR) << "Embedder returned an invalid Vulkan image.";
+          return result;
+        }
+        result.image = reinterpret_cast<VkImage>(image.image);
+        result.format = static_cast<VkFormat>(image.format);
+        return result;
+      };
+
+  auto vulkan_present_image =
+      [ptr = vulkan_config->present_image_callback,
+       user_data](const flutter::GPUSurfaceVulkanDelegate::Image& image) {
+        FlutterVulkanImage vulkan_image = {};
+        vulkan_image.struct_size = sizeof(FlutterVulkanImage);
+        vulkan_image.image = reinterpret_cast<uint64_t>(image.image);
+        vulkan_image.format = static_cast<uint32_t>(image.format);
+        return ptr(user_data, &vulkan_image);
+      };
+
+  flutter::EmbedderSurfaceVulkan::VulkanDispatchTable vulkan_dispatch_table = {
+      vulkan_get_instance_proc_address,  // get_instance_proc_address
+      vulkan_get_next_image,             // get_next_image
+      vulkan_present_image,              // present_image
+  };
+
+  return fml::MakeCopyable(
+      [vulkan_context, vulkan_dispatch_table, platform_dispatch_table,
+       external_view_embedder = std::move(external_view_embedder),
+       engine_group =
+           std::move(engine_group)](flutter::Shell& shell) mutable {
+        return std::make_unique<flutter::PlatformViewEmbedder>(
+            shell,                              // delegate
+            shell.GetTaskRunners(),             // task runners
+            vulkan_context,                     // Vulkan context
+            vulkan_dispatch_table,              // Vulkan dispatch table
+            platform_dispatch_table,            // platform dispatch table
+            std::move(external_view_embedder),  // external view embedder
+            std::move(engine_group)             // engine group
+        );
+      });
+#else   // SHELL_ENABLE_VULKAN
+  FML_LOG(ERROR) << "This engine was built without Vulkan support.";
+  return nullptr;
+#endif  // SHELL_ENABLE_VULKAN
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -284,7 +513,8 @@ InferPlatformViewCreationCallback(
     flutter::PlatformViewEmbedder::PlatformDispatchTable
         platform_dispatch_table,
     std::unique_ptr<flutter::EmbedderExternalViewEmbedder>
-        external_view_embedder) {
+        external_view_embedder,
+    std::shared_ptr<flutter::EmbedderEngineGroup> engine_group) {
   if (config == nullptr) {
     return nullptr;
   }
@@ -293,11 +523,15 @@ InferPlatformViewCreationCallback(
     case kOpenGL:
       return InferOpenGLPlatformViewCreationCallback(
           config, user_data, platform_dispatch_table,
-          std::move(external_view_embedder));
+          std::move(external_view_embedder), std::move(engine_group));
     case kSoftware:
       return InferSoftwarePlatformViewCreationCallback(
           config, user_data, platform_dispatch_table,
           std::move(external_view_embedder));
+    case kVulkan:
+      return InferVulkanPlatformViewCreationCallback(
+          config, user_data, platform_dispatch_table,
+          std::move(external_view_embedder), std::move(engine_group));
     default:
       return nullptr;
   }
@@ -419,6 +653,70 @@ static sk_sp<SkSurface> MakeSkSurfaceFromBackingStore(
   return surface;
 }
 
+#ifdef SHELL_ENABLE_VULKAN
+static sk_sp<SkSurface> MakeSkSurfaceFromBackingStore(
+    GrContext* context,
+    const FlutterBackingStoreConfig& config,
+    const FlutterVulkanBackingStore* vulkan) {
+  const auto format = static_cast<VkFormat>(vulkan->image.format);
+  SkColorType color_type = kUnknown_SkColorType;
+  switch (format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+      color_type = kRGBA_8888_SkColorType;
+      break;
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+      color_type = kBGRA_8888_SkColorType;
+      break;
+    default:
+      FML_LOG(ERROR) << "Unsupported format of the embedder supplied Vulkan "
+                        "backing store: "
+                     << format;
+      vulkan->destruction_callback(vulkan->user_data);
+      return nullptr;
+  }
+
+  GrVkImageInfo image_info = {
+      reinterpret_cast<VkImage>(vulkan->image.image),  // image
+      GrVkAlloc(),                                     // alloc
+      VK_IMAGE_TILING_OPTIMAL,                         // tiling
+      VK_IMAGE_LAYOUT_UNDEFINED,                       // layout
+      format,                                          // format
+      1,                                               // level count
+  };
+
+  GrBackendRenderTarget backend_render_target(
+      config.size.width,   // width
+      config.size.height,  // height
+      0,                   // sample count
+      image_info           // image info
+  );
+
+  SkSurfaceProps surface_properties(
+      SkSurfaceProps::InitType::kLegacyFontHost_InitType);
+
+  auto surface = SkSurface::MakeFromBackendRenderTarget(
+      context,                   // context
+      backend_render_target,     // backend render target
+      kTopLeft_GrSurfaceOrigin,  // surface origin
+      color_type,                // color type
+      SkColorSpace::MakeSRGB(),  // color space
+      &surface_properties,       // surface properties
+      static_cast<SkSurface::RenderTargetReleaseProc>(
+          vulkan->destruction_callback),  // release proc
+      vulkan->user_data                   // release context
+  );
+
+  if (!surface) {
+    FML_LOG(ERROR) << "Could not wrap embedder supplied Vulkan image.";
+    vulkan->destruction_callback(vulkan->user_data);
+    return nullptr;
+  }
+  return surface;
+}
+#endif  // SHELL_ENABLE_VULKAN
+
 static std::unique_ptr<flutter::EmbedderRenderTarget>
 CreateEmbedderRenderTarget(const FlutterCompositor* compositor,
                            const FlutterBackingStoreConfig& config,
@@ -476,6 +774,12 @@ CreateEmbedderRenderTarget(const FlutterCompositor* compositor,
       render_surface = MakeSkSurfaceFromBackingStore(context, config,
                                                      &backing_store.software);
       break;
+    case kFlutterBackingStoreTypeVulkan:
+#ifdef SHELL_ENABLE_VULKAN
+      render_surface = MakeSkSurfaceFromBackingStore(context, config,
+                                                     &backing_store.vulkan);
+#endif  // SHELL_ENABLE_VULKAN
+      break;
   };
 
   if (!render_surface) {
@@ -526,15 +830,60 @@ InferExternalViewEmbedderFromArgs(const FlutterCompositor* compositor) {
             user_data);
       };
 
-  return {std::make_unique<flutter::EmbedderExternalViewEmbedder>(
-              create_render_target_callback, present_callback),
-          false};
+  flutter::EmbedderRenderTargetCache::Config render_target_cache_config;
+  render_target_cache_config.max_unused_frames = std::max<size_t>(
+      SAFE_ACCESS(compositor, backing_store_cache_max_unused_frames, 1), 1);
+  render_target_cache_config.max_bytes =
+      SAFE_ACCESS(compositor, backing_store_cache_max_bytes, 0);
+  render_target_cache_config.size_granularity = static_cast<int32_t>(
+      SAFE_ACCESS(compositor, backing_store_size_granularity, 0));
+
+  auto external_view_embedder =
+      std::make_unique<flutter::EmbedderExternalViewEmbedder>(
+          create_render_target_callback, present_callback,
+          render_target_cache_config);
+
+  if (auto c_stats_callback = SAFE_ACCESS(
+          compositor, backing_store_cache_stats_callback, nullptr)) {
+    external_view_embedder->SetRenderTargetCacheStatsCallback(
+        [c_stats_callback, user_data = compositor->user_data](
+            const flutter::EmbedderRenderTargetCache::Stats& stats) {
+          FlutterBackingStoreCacheStats c_stats = {};
+          c_stats.struct_size = sizeof(FlutterBackingStoreCacheStats);
+          c_stats.hit_count = stats.hit_count;
+          c_stats.miss_count = stats.miss_count;
+          c_stats.evicted_count = stats.evicted_count;
+          c_stats.cached_count = stats.cached_count;
+          c_stats.cached_bytes = stats.cached_bytes;
+          c_stats_callback(&c_stats, user_data);
+        });
+  }
+
+  return {std::move(external_view_embedder), false};
 }
 
 struct _FlutterPlatformMessageResponseHandle {
   fml::RefPtr<flutter::PlatformMessage> message;
 };
 
+// Hands |message| to an embedder callback, which responds to it through the
+// response handle.
+static void DispatchPlatformMessageToCallback(
+    FlutterPlatformMessageCallback callback,
+    void* user_data,
+    fml::RefPtr<flutter::PlatformMessage> message) {
+  auto handle = new FlutterPlatformMessageResponseHandle();
+  const FlutterPlatformMessage incoming_message = {
+      sizeof(FlutterPlatformMessage),  // struct_size
+      message->channel().c_str(),      // channel
+      message->data().GetMapping(),    // message
+      message->data().GetSize(),       // message_size
+      handle,                          // response_handle
+  };
+  handle->message = std::move(message);
+  callback(&incoming_message, user_data);
+}
+
 struct LoadedElfDeleter {
   void operator()(Dart_LoadedElf* elf) {
     if (elf) {
@@ -545,14 +894,61 @@ struct LoadedElfDeleter {
 
 using UniqueLoadedElf = std::unique_ptr<Dart_LoadedElf, LoadedElfDeleter>;
 
+struct LoadedAOTElf {
+  UniqueLoadedElf elf;
+  const uint8_t* vm_snapshot_data = nullptr;
+  const uint8_t* vm_snapshot_instrs = nullptr;
+  const uint8_t* vm_isolate_data = nullptr;
+  const uint8_t* vm_isolate_instrs = nullptr;
+};
+
 struct _FlutterEngineAOTData {
-  UniqueLoadedElf loaded_elf = nullptr;
+  std::shared_ptr<const LoadedAOTElf> loaded_elf = nullptr;
   const uint8_t* vm_snapshot_data = nullptr;
   const uint8_t* vm_snapshot_instrs = nullptr;
   const uint8_t* vm_isolate_data = nullptr;
   const uint8_t* vm_isolate_instrs = nullptr;
 };
 
+// Loads the ELF at |elf_path|, or returns the one another AOT data of the
+// process loaded from it and still uses. The loader maps the snapshots
+// read-only from the file, so their pages are shared with the processes
+// running the same ELF; sharing the loaded ELF also keeps the engines of
+// this process from mapping it again each.
+static std::shared_ptr<const LoadedAOTElf> LoadAOTElf(const char* elf_path,
+                                                      const char** error) {
+  TRACE_EVENT1("flutter", "LoadAOTElf", "path", elf_path);
+  static std::mutex mutex;
+  static auto* loaded_elves =
+      new std::map<std::string, std::weak_ptr<const LoadedAOTElf>>();
+
+  std::scoped_lock lock(mutex);
+  auto found = loaded_elves->find(elf_path);
+  if (found != loaded_elves->end()) {
+    if (auto loaded_elf = found->second.lock()) {
+      TRACE_EVENT_INSTANT0("flutter", "ReusedLoadedAOTElf");
+      return loaded_elf;
+    }
+    loaded_elves->erase(found);
+  }
+
+  auto loaded_elf = std::make_shared<LoadedAOTElf>();
+  loaded_elf->elf.reset(Dart_LoadELF(
+      elf_path,                         // file path
+      0,                                // file offset
+      error,                            // error (out)
+      &loaded_elf->vm_snapshot_data,    // vm snapshot data (out)
+      &loaded_elf->vm_snapshot_instrs,  // vm snapshot instr (out)
+      &loaded_elf->vm_isolate_data,     // vm isolate data (out)
+      &loaded_elf->vm_isolate_instrs    // vm isolate instr (out)
+      ));
+  if (!loaded_elf->elf) {
+    return nullptr;
+  }
+  loaded_elves->emplace(elf_path, loaded_elf);
+  return loaded_elf;
+}
+
 FlutterEngineResult FlutterEngineCreateAOTData(
     const FlutterEngineAOTDataSource* source,
     FlutterEngineAOTData* data_out) {
@@ -575,21 +971,16 @@ FlutterEngineResult FlutterEngineCreateAOTData(
       auto aot_data = std::make_unique<_FlutterEngineAOTData>();
       const char* error = nullptr;
 
-      Dart_LoadedElf* loaded_elf = Dart_LoadELF(
-          source->elf_path,               // file path
-          0,                              // file offset
-          &error,                         // error (out)
-          &aot_data->vm_snapshot_data,    // vm snapshot data (out)
-          &aot_data->vm_snapshot_instrs,  // vm snapshot instr (out)
-          &aot_data->vm_isolate_data,     // vm isolate data (out)
-          &aot_data->vm_isolate_instrs    // vm isolate instr (out)
-      );
-
+      auto loaded_elf = LoadAOTElf(source->elf_path, &error);
       if (loaded_elf == nullptr) {
         return LOG_EMBEDDER_ERROR(kInvalidArguments, error);
       }
 
-      aot_data->loaded_elf.reset(loaded_elf);
+      aot_data->vm_snapshot_data = loaded_elf->vm_snapshot_data;
+      aot_data->vm_snapshot_instrs = loaded_elf->vm_snapshot_instrs;
+      aot_data->vm_isolate_data = loaded_elf->vm_isolate_data;
+      aot_data->vm_isolate_instrs = loaded_elf->vm_isolate_instrs;
+      aot_data->loaded_elf = std::move(loaded_elf);
 
       *data_out = aot_data.release();
       return kSuccess;
@@ -612,6 +1003,32 @@ FlutterEngineResult FlutterEngineCollectAOTData(FlutterEngineAOTData data) {
   return kSuccess;
 }
 
+struct _FlutterEngineGroup {
+  std::shared_ptr<flutter::EmbedderEngineGroup> group;
+};
+
+FlutterEngineResult FlutterEngineGroupCreate(
+    const FlutterEngineGroupConfig* config,
+    FlutterEngineGroup* group_out) {
+  if (!config) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Null config specified.");
+  } else if (!group_out) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Null group_out specified.");
+  }
+
+  auto group = std::make_unique<_FlutterEngineGroup>();
+  group->group = std::make_shared<flutter::EmbedderEngineGroup>(
+      SAFE_ACCESS(config, resource_cache_max_bytes, 0));
+  *group_out = group.release();
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineGroupCollect(FlutterEngineGroup group) {
+  // The engines of the group keep the shared state alive until they shut down.
+  delete group;
+  return kSuccess;
+}
+
 void PopulateSnapshotMappingCallbacks(const FlutterProjectArgs* args,
                                       flutter::Settings& settings) {
   // There are no ownership concerns here as all mappings are owned by the
@@ -798,6 +1215,30 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
       callback(user_data);
     };
   }
+  if (SAFE_ACCESS(args, preferred_frame_rate_callback, nullptr) != nullptr) {
+    settings.adaptive_frame_rate = true;
+  }
+  if (SAFE_ACCESS(args, frame_timings_callback, nullptr) != nullptr) {
+    settings.frame_rasterized_callback =
+        [ptr = args->frame_timings_callback,
+         user_data](const flutter::FrameTiming& timing) {
+          auto nanos = [](fml::TimePoint time) -> uint64_t {
+            return time.ToEpochDelta().ToNanoseconds();
+          };
+          FlutterFrameTimings timings = {};
+          timings.struct_size = sizeof(FlutterFrameTimings);
+          timings.vsync_start_time_nanos = nanos(timing.GetVsyncStart());
+          timings.build_start_time_nanos =
+              nanos(timing.Get(flutter::FrameTiming::kBuildStart));
+          timings.build_finish_time_nanos =
+              nanos(timing.Get(flutter::FrameTiming::kBuildFinish));
+          timings.raster_start_time_nanos =
+              nanos(timing.Get(flutter::FrameTiming::kRasterStart));
+          timings.raster_finish_time_nanos =
+              nanos(timing.Get(flutter::FrameTiming::kRasterFinish));
+          ptr(&timings, user_data);
+        };
+  }
 
   flutter::PlatformViewEmbedder::UpdateSemanticsNodesCallback
       update_semantics_nodes_callback = nullptr;
@@ -890,26 +1331,28 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
     platform_message_response_callback =
         [ptr = args->platform_message_callback,
          user_data](fml::RefPtr<flutter::PlatformMessage> message) {
-          auto handle = new FlutterPlatformMessageResponseHandle();
-          const FlutterPlatformMessage incoming_message = {
-              sizeof(FlutterPlatformMessage),  // struct_size
-              message->channel().c_str(),      // channel
-              message->data().data(),          // message
-              message->data().size(),          // message_size
-              handle,                          // response_handle
-          };
-          handle->message = std::move(message);
-          return ptr(&incoming_message, user_data);
+          DispatchPlatformMessageToCallback(ptr, user_data,
+                                            std::move(message));
         };
   }
 
+  const bool disable_vsync = SAFE_ACCESS(args, disable_vsync, false);
   flutter::VsyncWaiterEmbedder::VsyncCallback vsync_callback = nullptr;
-  if (SAFE_ACCESS(args, vsync_callback, nullptr) != nullptr) {
+  if (!disable_vsync && SAFE_ACCESS(args, vsync_callback, nullptr) != nullptr) {
     vsync_callback = [ptr = args->vsync_callback, user_data](intptr_t baton) {
       return ptr(user_data, baton);
     };
   }
 
+  flutter::VsyncWaiterEmbedder::PreferredFrameRateCallback
+      preferred_frame_rate_callback = nullptr;
+  if (SAFE_ACCESS(args, preferred_frame_rate_callback, nullptr) != nullptr) {
+    preferred_frame_rate_callback = [ptr = args->preferred_frame_rate_callback,
+                                     user_data](float fps) {
+      ptr(fps, user_data);
+    };
+  }
+
   auto external_view_embedder_result =
       InferExternalViewEmbedderFromArgs(SAFE_ACCESS(args, compositor, nullptr));
   if (external_view_embedder_result.second) {
@@ -923,11 +1366,18 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           update_semantics_custom_actions_callback,  //
           platform_message_response_callback,        //
           vsync_callback,                            //
+          disable_vsync,                             //
+          preferred_frame_rate_callback,             //
       };
 
+  std::shared_ptr<flutter::EmbedderEngineGroup> engine_group;
+  if (SAFE_ACCESS(args, engine_group, nullptr) != nullptr) {
+    engine_group = args->engine_group->group;
+  }
+
   auto on_create_platform_view = InferPlatformViewCreationCallback(
       config, user_data, platform_dispatch_table,
-      std::move(external_view_embedder_result.first));
+      std::move(external_view_embedder_result.first), engine_group);
 
   if (!on_create_platform_view) {
     return LOG_EMBEDDER_ERROR(
@@ -935,10 +1385,18 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
         "Could not infer platform view creation callback.");
   }
 
+  // The engines of a group share one resource cache, so its budget covers all
+  // of them instead of following the viewport of each.
+  const size_t group_cache_max_bytes =
+      engine_group ? engine_group->GetResourceCacheMaxBytes() : 0;
   flutter::Shell::CreateCallback<flutter::Rasterizer> on_create_rasterizer =
-      [](flutter::Shell& shell) {
-        return std::make_unique<flutter::Rasterizer>(
+      [group_cache_max_bytes](flutter::Shell& shell) {
+        auto rasterizer = std::make_unique<flutter::Rasterizer>(
             shell, shell.GetTaskRunners(), shell.GetIsGpuDisabledSyncSwitch());
+        if (group_cache_max_bytes > 0) {
+          rasterizer->SetResourceCacheMaxBytes(group_cache_max_bytes, true);
+        }
+        return rasterizer;
       };
 
   // TODO(chinmaygarde): This is the wrong spot for this. It belongs in the
@@ -998,11 +1456,52 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
         return image;
       };
     }
+#if OS_LINUX
+    if (SAFE_ACCESS(open_gl_config, dmabuf_external_texture_frame_callback,
+                    nullptr) != nullptr) {
+      flutter::EmbedderDmaBufImporter::ProcResolver proc_resolver =
+          DefaultGLProcResolver;
+      if (SAFE_ACCESS(open_gl_config, gl_proc_resolver, nullptr) != nullptr) {
+        proc_resolver = [ptr = open_gl_config->gl_proc_resolver,
+                         user_data](const char* name) {
+          return ptr(user_data, name);
+        };
+      }
+      auto importer =
+          std::make_shared<flutter::EmbedderDmaBufImporter>(proc_resolver);
+      if (importer->IsValid()) {
+        // Frames the embedder doesn't have as dma-bufs are asked for as GL
+        // textures.
+        external_texture_callback =
+            [ptr = open_gl_config->dmabuf_external_texture_frame_callback,
+             user_data, importer,
+             gl_texture_callback = std::move(external_texture_callback)](
+                int64_t texture_identifier, GrContext* context,
+                const SkISize& size) -> sk_sp<SkImage> {
+          FlutterDmaBufTexture texture = {};
+          texture.acquire_fence_fd = -1;
+          if (ptr(user_data, texture_identifier, size.width(), size.height(),
+                  &texture)) {
+            return importer->Import(context, texture);
+          }
+          if (gl_texture_callback) {
+            return gl_texture_callback(texture_identifier, context, size);
+          }
+          return nullptr;
+        };
+      } else {
+        FML_LOG(ERROR) << "The dma-buf external texture frame callback is "
+                          "ignored because the dma-buf import extensions are "
+                          "unavailable.";
+      }
+    }
+#endif  // OS_LINUX
   }
 
   auto thread_host =
       flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
-          SAFE_ACCESS(args, custom_task_runners, nullptr));
+          SAFE_ACCESS(args, custom_task_runners, nullptr),
+          std::move(engine_group));
 
   if (!thread_host || !thread_host->IsValid()) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments,
@@ -1112,6 +1611,23 @@ FlutterEngineResult FlutterEngineShutdown(FLUTTER_API_SYMBOL(FlutterEngine)
   return kSuccess;
 }
 
+// Converts the window metrics sent by the embedder to viewport metrics.
+static FlutterEngineResult ToViewportMetrics(
+    const FlutterWindowMetricsEvent* flutter_metrics,
+    flutter::ViewportMetrics* metrics) {
+  metrics->physical_width = SAFE_ACCESS(flutter_metrics, width, 0.0);
+  metrics->physical_height = SAFE_ACCESS(flutter_metrics, height, 0.0);
+  metrics->device_pixel_ratio = SAFE_ACCESS(flutter_metrics, pixel_ratio, 1.0);
+
+  if (metrics->device_pixel_ratio <= 0.0) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Device pixel ratio was invalid. It must be greater than zero.");
+  }
+
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineSendWindowMetricsEvent(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterWindowMetricsEvent* flutter_metrics) {
@@ -1120,15 +1636,9 @@ FlutterEngineResult FlutterEngineSendWindowMetricsEvent(
   }
 
   flutter::ViewportMetrics metrics;
-
-  metrics.physical_width = SAFE_ACCESS(flutter_metrics, width, 0.0);
-  metrics.physical_height = SAFE_ACCESS(flutter_metrics, height, 0.0);
-  metrics.device_pixel_ratio = SAFE_ACCESS(flutter_metrics, pixel_ratio, 1.0);
-
-  if (metrics.device_pixel_ratio <= 0.0) {
-    return LOG_EMBEDDER_ERROR(
-        kInvalidArguments,
-        "Device pixel ratio was invalid. It must be greater than zero.");
+  FlutterEngineResult result = ToViewportMetrics(flutter_metrics, &metrics);
+  if (result != kSuccess) {
+    return result;
   }
 
   return reinterpret_cast<flutter::EmbedderEngine*>(engine)->SetViewportMetrics(
@@ -1206,6 +1716,53 @@ inline int64_t PointerDataButtonsForLegacyEvent(
   return 0;
 }
 
+// Converts a pointer event sent by the embedder to pointer data.
+static flutter::PointerData ToPointerData(const FlutterPointerEvent* current) {
+  flutter::PointerData pointer_data;
+  pointer_data.Clear();
+  // this is currely in use only on android embedding.
+  pointer_data.embedder_id = 0;
+  pointer_data.time_stamp = SAFE_ACCESS(current, timestamp, 0);
+  pointer_data.change = ToPointerDataChange(
+      SAFE_ACCESS(current, phase, FlutterPointerPhase::kCancel));
+  pointer_data.physical_x = SAFE_ACCESS(current, x, 0.0);
+  pointer_data.physical_y = SAFE_ACCESS(current, y, 0.0);
+  // Delta will be generated in pointer_data_packet_converter.cc.
+  pointer_data.physical_delta_x = 0.0;
+  pointer_data.physical_delta_y = 0.0;
+  pointer_data.device = SAFE_ACCESS(current, device, 0);
+  // Pointer identifier will be generated in pointer_data_packet_converter.cc.
+  pointer_data.pointer_identifier = 0;
+  pointer_data.signal_kind = ToPointerDataSignalKind(
+      SAFE_ACCESS(current, signal_kind, kFlutterPointerSignalKindNone));
+  pointer_data.scroll_delta_x = SAFE_ACCESS(current, scroll_delta_x, 0.0);
+  pointer_data.scroll_delta_y = SAFE_ACCESS(current, scroll_delta_y, 0.0);
+  FlutterPointerDeviceKind device_kind = SAFE_ACCESS(current, device_kind, 0);
+  // For backwards compatibility with embedders written before the device kind
+  // and buttons were exposed, if the device kind is not set treat it as a
+  // mouse, with a synthesized primary button state based on the phase.
+  if (device_kind == 0) {
+    pointer_data.kind = flutter::PointerData::DeviceKind::kMouse;
+    pointer_data.buttons =
+        PointerDataButtonsForLegacyEvent(pointer_data.change);
+
+  } else {
+    pointer_data.kind = ToPointerDataKind(device_kind);
+    if (pointer_data.kind == flutter::PointerData::DeviceKind::kTouch) {
+      // For touch events, set the button internally rather than requiring
+      // it at the API level, since it's a confusing construction to expose.
+      if (pointer_data.change == flutter::PointerData::Change::kDown ||
+          pointer_data.change == flutter::PointerData::Change::kMove) {
+        pointer_data.buttons = flutter::kPointerButtonTouchContact;
+      }
+    } else {
+      // Buttons use the same mask values, so pass them through directly.
+      pointer_data.buttons = SAFE_ACCESS(current, buttons, 0);
+    }
+  }
+  return pointer_data;
+}
+
 FlutterEngineResult FlutterEngineSendPointerEvent(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPointerEvent* pointers,
@@ -1223,49 +1780,7 @@ FlutterEngineResult FlutterEngineSendPointerEvent(
   const FlutterPointerEvent* current = pointers;
 
   for (size_t i = 0; i < events_count; ++i) {
-    flutter::PointerData pointer_data;
-    pointer_data.Clear();
-    // this is currely in use only on android embedding.
-    pointer_data.embedder_id = 0;
-    pointer_data.time_stamp = SAFE_ACCESS(current, timestamp, 0);
-    pointer_data.change = ToPointerDataChange(
-        SAFE_ACCESS(current, phase, FlutterPointerPhase::kCancel));
-    pointer_data.physical_x = SAFE_ACCESS(current, x, 0.0);
-    pointer_data.physical_y = SAFE_ACCESS(current, y, 0.0);
-    // Delta will be generated in pointer_data_packet_converter.cc.
-    pointer_data.physical_delta_x = 0.0;
-    pointer_data.physical_delta_y = 0.0;
-    pointer_data.device = SAFE_ACCESS(current, device, 0);
-    // Pointer identifier will be generated in pointer_data_packet_converter.cc.
-    pointer_data.pointer_identifier = 0;
-    pointer_data.signal_kind = ToPointerDataSignalKind(
-        SAFE_ACCESS(current, signal_kind, kFlutterPointerSignalKindNone));
-    pointer_data.scroll_delta_x = SAFE_ACCESS(current, scroll_delta_x, 0.0);
-    pointer_data.scroll_delta_y = SAFE_ACCESS(current, scroll_delta_y, 0.0);
-    FlutterPointerDeviceKind device_kind = SAFE_ACCESS(current, device_kind, 0);
-    // For backwards compatibility with embedders written before the device kind
-    // and buttons were exposed, if the device kind is not set treat it as a
-    // mouse, with a synthesized primary button state based on the phase.
-    if (device_kind == 0) {
-      pointer_data.kind = flutter::PointerData::DeviceKind::kMouse;
-      pointer_data.buttons =
-          PointerDataButtonsForLegacyEvent(pointer_data.change);
-
-    } else {
-      pointer_data.kind = ToPointerDataKind(device_kind);
-      if (pointer_data.kind == flutter::PointerData::DeviceKind::kTouch) {
-        // For touch events, set the button internally rather than requiring
-        // it at the API level, since it's a confusing construction to expose.
-        if (pointer_data.change == flutter::PointerData::Change::kDown ||
-            pointer_data.change == flutter::PointerData::Change::kMove) {
-          pointer_data.buttons = flutter::kPointerButtonTouchContact;
-        }
-      } else {
-        // Buttons use the same mask values, so pass them through directly.
-        pointer_data.buttons = SAFE_ACCESS(current, buttons, 0);
-      }
-    }
-    packet->SetPointerData(i, pointer_data);
+    packet->SetPointerData(i, ToPointerData(current));
     current = reinterpret_cast<const FlutterPointerEvent*>(
         reinterpret_cast<const uint8_t*>(current) + current->struct_size);
   }
@@ -1278,17 +1793,10 @@ FlutterEngineResult FlutterEngineSendPointerEvent(
                                   "running Flutter application.");
 }
 
-FlutterEngineResult FlutterEngineSendPlatformMessage(
-    FLUTTER_API_SYMBOL(FlutterEngine) engine,
-    const FlutterPlatformMessage* flutter_message) {
-  if (engine == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
-  }
-
-  if (flutter_message == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid message argument.");
-  }
-
+// Converts a platform message sent by the embedder to one for the engine.
+static FlutterEngineResult ToPlatformMessage(
+    const FlutterPlatformMessage* flutter_message,
+    fml::RefPtr<flutter::PlatformMessage>* message) {
   if (SAFE_ACCESS(flutter_message, channel, nullptr) == nullptr) {
     return LOG_EMBEDDER_ERROR(
         kInvalidArguments, "Message argument did not specify a valid channel.");
@@ -1311,17 +1819,36 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     response = response_handle->message->response();
   }
 
-  fml::RefPtr<flutter::PlatformMessage> message;
   if (message_size == 0) {
-    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+    *message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel, response);
   } else {
-    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+    *message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel,
         std::vector<uint8_t>(message_data, message_data + message_size),
         response);
   }
 
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineSendPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (flutter_message == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid message argument.");
+  }
+
+  fml::RefPtr<flutter::PlatformMessage> message;
+  FlutterEngineResult result = ToPlatformMessage(flutter_message, &message);
+  if (result != kSuccess) {
+    return result;
+  }
+
   return reinterpret_cast<flutter::EmbedderEngine*>(engine)
                  ->SendPlatformMessage(std::move(message))
              ? kSuccess
@@ -1330,6 +1857,89 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
                                   "Flutter application.");
 }
 
+FlutterEngineResult FlutterEngineSendEvents(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterEngineEvent* events,
+    size_t events_count) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (events == nullptr || events_count == 0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid events.");
+  }
+
+  flutter::PlatformEventBatch batch;
+  std::vector<flutter::PointerData> pointer_data;
+
+  const FlutterEngineEvent* current = events;
+  for (size_t i = 0; i < events_count; ++i) {
+    switch (SAFE_ACCESS(current, type, kFlutterEngineEventTypePointer)) {
+      case kFlutterEngineEventTypeWindowMetrics: {
+        const FlutterWindowMetricsEvent* flutter_metrics =
+            SAFE_ACCESS(current, window_metrics, nullptr);
+        if (flutter_metrics == nullptr) {
+          return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                    "Invalid window metrics event.");
+        }
+        flutter::ViewportMetrics metrics;
+        FlutterEngineResult result =
+            ToViewportMetrics(flutter_metrics, &metrics);
+        if (result != kSuccess) {
+          return result;
+        }
+        batch.viewport_metrics = metrics;
+        break;
+      }
+      case kFlutterEngineEventTypePointer: {
+        const FlutterPointerEvent* pointer =
+            SAFE_ACCESS(current, pointer, nullptr);
+        if (pointer == nullptr) {
+          return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                    "Invalid pointer event.");
+        }
+        pointer_data.push_back(ToPointerData(pointer));
+        break;
+      }
+      case kFlutterEngineEventTypePlatformMessage: {
+        const FlutterPlatformMessage* flutter_message =
+            SAFE_ACCESS(current, platform_message, nullptr);
+        if (flutter_message == nullptr) {
+          return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                    "Invalid message argument.");
+        }
+        fml::RefPtr<flutter::PlatformMessage> message;
+        FlutterEngineResult result =
+            ToPlatformMessage(flutter_message, &message);
+        if (result != kSuccess) {
+          return result;
+        }
+        batch.platform_messages.push_back(std::move(message));
+        break;
+      }
+      default:
+        return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid event type.");
+    }
+    current = reinterpret_cast<const FlutterEngineEvent*>(
+        reinterpret_cast<const uint8_t*>(current) + current->struct_size);
+  }
+
+  if (!pointer_data.empty()) {
+    batch.pointer_data_packet =
+        std::make_unique<flutter::PointerDataPacket>(pointer_data.size());
+    for (size_t i = 0; i < pointer_data.size(); ++i) {
+      batch.pointer_data_packet->SetPointerData(i, pointer_data[i]);
+    }
+  }
+
+  return reinterpret_cast<flutter::EmbedderEngine*>(engine)->DispatchEventBatch(
+             std::move(batch))
+             ? kSuccess
+             : LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                                  "Could not send the events to the running "
+                                  "Flutter application.");
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterDataCallback data_callback,
@@ -1483,6 +2093,20 @@ FlutterEngineResult FlutterEngineUpdateSemanticsEnabled(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineUpdateSemanticsClientActive(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    bool active) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+  if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)
+           ->SetSemanticsClientActive(active)) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                              "Could not update semantics client state.");
+  }
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineUpdateAccessibilityFeatures(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterAccessibilityFeature flags) {
@@ -1535,7 +2159,53 @@ FlutterEngineResult FlutterEngineOnVsync(FLUTTER_API_SYMBOL(FlutterEngine)
       fml::TimeDelta::FromNanoseconds(frame_target_time_nanos));
 
   if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)->OnVsyncEvent(
-          baton, start_time, target_time)) {
+          baton, start_time, target_time,
+          flutter::VsyncWaiter::kUnknownRefreshRateFPS)) {
+    return LOG_EMBEDDER_ERROR(
+        kInternalInconsistency,
+        "Could not notify the running engine instance of a Vsync event.");
+  }
+
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineOnVsyncWithInfo(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterVsyncInfo* info) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (info == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid vsync info.");
+  }
+
+  TRACE_EVENT0("flutter", "FlutterEngineOnVsyncWithInfo");
+
+  auto start_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromNanoseconds(
+          SAFE_ACCESS(info, frame_start_time_nanos, 0)));
+
+  auto target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromNanoseconds(
+          SAFE_ACCESS(info, frame_target_time_nanos, 0)));
+
+  if (target_time < start_time) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "The frame target time must not be before the frame start time.");
+  }
+
+  const double display_refresh_rate =
+      SAFE_ACCESS(info, display_refresh_rate, 0.0);
+  if (display_refresh_rate < 0.0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid display refresh rate.");
+  }
+
+  if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)->OnVsyncEvent(
+          SAFE_ACCESS(info, baton, 0), start_time, target_time,
+          static_cast<float>(display_refresh_rate))) {
     return LOG_EMBEDDER_ERROR(
         kInternalInconsistency,
         "Could not notify the running engine instance of a Vsync event.");
@@ -1595,6 +2265,63 @@ FlutterEngineResult FlutterEnginePostRenderThreadTask(
                                   "Could not post the render thread task.");
 }
 
+FlutterEngineResult FlutterEngineRasterizeLastFrame(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterOffscreenRasterJob* jobs,
+    size_t jobs_count) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (jobs == nullptr && jobs_count != 0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Raster jobs were null.");
+  }
+
+  std::vector<flutter::Rasterizer::OffscreenRasterJob> raster_jobs;
+  raster_jobs.reserve(jobs_count);
+  const FlutterOffscreenRasterJob* job = jobs;
+  for (size_t i = 0; i < jobs_count; ++i) {
+    const size_t width = SAFE_ACCESS(job, width, 0);
+    const size_t height = SAFE_ACCESS(job, height, 0);
+    void* allocation = SAFE_ACCESS(job, allocation, nullptr);
+    const size_t row_bytes = SAFE_ACCESS(job, row_bytes, 0);
+    FlutterOffscreenRasterJobCallback callback =
+        SAFE_ACCESS(job, callback, nullptr);
+    if (width == 0 || height == 0 || allocation == nullptr ||
+        callback == nullptr) {
+      return LOG_EMBEDDER_ERROR(
+          kInvalidArguments,
+          "Raster jobs need a non-empty size, an allocation and a callback.");
+    }
+    if (row_bytes < width * 4) {
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "The row bytes of a raster job were too small "
+                                "for its width.");
+    }
+
+    flutter::Rasterizer::OffscreenRasterJob raster_job;
+    raster_job.size = SkISize::Make(width, height);
+    raster_job.pixels = allocation;
+    raster_job.row_bytes = row_bytes;
+    raster_job.callback = [callback,
+                           user_data = SAFE_ACCESS(job, user_data, nullptr)](
+                              bool success) { callback(success, user_data); };
+    raster_jobs.push_back(std::move(raster_job));
+    job = reinterpret_cast<const FlutterOffscreenRasterJob*>(
+        reinterpret_cast<const uint8_t*>(job) + job->struct_size);
+  }
+
+  if (raster_jobs.empty()) {
+    return kSuccess;
+  }
+
+  return reinterpret_cast<flutter::EmbedderEngine*>(engine)->RasterizeLastFrame(
+             std::move(raster_jobs))
+             ? kSuccess
+             : LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                                  "Could not post the raster jobs.");
+}
+
 uint64_t FlutterEngineGetCurrentTime() {
   return fml::TimePoint::Now().ToEpochDelta().ToNanoseconds();
 }
@@ -1707,6 +2434,54 @@ bool FlutterEngineRunsAOTCompiledDartCode(void) {
   return flutter::DartVM::IsRunningPrecompiledCode();
 }
 
+static bool ToDartTypedDataType(FlutterEngineDartTypedDataType type,
+                                Dart_TypedData_Type* dart_type,
+                                size_t* element_size) {
+  switch (type) {
+    case kFlutterEngineDartTypedDataTypeUint8:
+      *dart_type = Dart_TypedData_kUint8;
+      *element_size = sizeof(uint8_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeInt8:
+      *dart_type = Dart_TypedData_kInt8;
+      *element_size = sizeof(int8_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeUint16:
+      *dart_type = Dart_TypedData_kUint16;
+      *element_size = sizeof(uint16_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeInt16:
+      *dart_type = Dart_TypedData_kInt16;
+      *element_size = sizeof(int16_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeUint32:
+      *dart_type = Dart_TypedData_kUint32;
+      *element_size = sizeof(uint32_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeInt32:
+      *dart_type = Dart_TypedData_kInt32;
+      *element_size = sizeof(int32_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeUint64:
+      *dart_type = Dart_TypedData_kUint64;
+      *element_size = sizeof(uint64_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeInt64:
+      *dart_type = Dart_TypedData_kInt64;
+      *element_size = sizeof(int64_t);
+      return true;
+    case kFlutterEngineDartTypedDataTypeFloat32:
+      *dart_type = Dart_TypedData_kFloat32;
+      *element_size = sizeof(float);
+      return true;
+    case kFlutterEngineDartTypedDataTypeFloat64:
+      *dart_type = Dart_TypedData_kFloat64;
+      *element_size = sizeof(double);
+      return true;
+  }
+  return false;
+}
+
 FlutterEngineResult FlutterEnginePostDartObject(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterEngineDartPort port,
@@ -1772,16 +2547,42 @@ FlutterEngineResult FlutterEnginePostDartObject(
       auto callback =
           SAFE_ACCESS(object->buffer_value, buffer_collect_callback, nullptr);
       auto user_data = SAFE_ACCESS(object->buffer_value, user_data, nullptr);
+      auto typed_data_type =
+          SAFE_ACCESS(object->buffer_value, typed_data_type,
+                      kFlutterEngineDartTypedDataTypeUint8);
+
+      Dart_TypedData_Type dart_typed_data_type = Dart_TypedData_kInvalid;
+      size_t element_size = 0;
+      if (!ToDartTypedDataType(typed_data_type, &dart_typed_data_type,
+                               &element_size)) {
+        return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                  "Unknown typed data type of the buffer.");
+      }
+
+      if (buffer_size % element_size != 0) {
+        return LOG_EMBEDDER_ERROR(
+            kInvalidArguments,
+            "The size of the buffer must be a multiple of the size of its "
+            "typed data elements.");
+      }
 
       // The user has provided a callback, let them manage the lifecycle of
       // the underlying data. If not, copy it out from the provided buffer.
 
       if (callback == nullptr) {
         dart_object.type = Dart_CObject_kTypedData;
-        dart_object.value.as_typed_data.type = Dart_TypedData_kUint8;
-        dart_object.value.as_typed_data.length = buffer_size;
+        dart_object.value.as_typed_data.type = dart_typed_data_type;
+        dart_object.value.as_typed_data.length = buffer_size / element_size;
         dart_object.value.as_typed_data.values = buffer;
       } else {
+        // Dart code reads the elements of the external buffer in place.
+        if (reinterpret_cast<uintptr_t>(buffer) % element_size != 0) {
+          return LOG_EMBEDDER_ERROR(
+              kInvalidArguments,
+              "Buffers owned by the embedder must be aligned to the size of "
+              "their typed data elements.");
+        }
+
         struct ExternalTypedDataPeer {
           void* user_data = nullptr;
           VoidCallback trampoline = nullptr;
@@ -1802,8 +2603,9 @@ FlutterEngineResult FlutterEnginePostDartObject(
           delete peer;
         });
         dart_object.type = Dart_CObject_kExternalTypedData;
-        dart_object.value.as_external_typed_data.type = Dart_TypedData_kUint8;
-        dart_object.value.as_external_typed_data.length = buffer_size;
+        dart_object.value.as_external_typed_data.type = dart_typed_data_type;
+        dart_object.value.as_external_typed_data.length =
+            buffer_size / element_size;
         dart_object.value.as_external_typed_data.data = buffer;
         dart_object.value.as_external_typed_data.peer = peer;
         dart_object.value.as_external_typed_data.callback =
@@ -1834,12 +2636,35 @@ FlutterEngineResult FlutterEnginePostDartObject(
 
 FlutterEngineResult FlutterEngineNotifyLowMemoryWarning(
     FLUTTER_API_SYMBOL(FlutterEngine) raw_engine) {
+  return FlutterEngineNotifyMemoryPressure(raw_engine,
+                                           kFlutterMemoryPressureLevelCritical);
+}
+
+FlutterEngineResult FlutterEngineNotifyMemoryPressure(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterMemoryPressureLevel level) {
   auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
   if (engine == nullptr || !engine->IsValid()) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
   }
 
-  engine->GetShell().NotifyLowMemoryWarning();
+  flutter::MemoryPressureLevel shell_level;
+  switch (level) {
+    case kFlutterMemoryPressureLevelModerate:
+      shell_level = flutter::MemoryPressureLevel::kModerate;
+      break;
+    case kFlutterMemoryPressureLevelCritical:
+      shell_level = flutter::MemoryPressureLevel::kCritical;
+      break;
+    case kFlutterMemoryPressureLevelBackground:
+      shell_level = flutter::MemoryPressureLevel::kBackground;
+      break;
+    default:
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "Invalid memory pressure level.");
+  }
+
+  engine->GetShell().NotifyMemoryPressure(shell_level);
 
   rapidjson::Document document;
   auto& allocator = document.GetAllocator();
@@ -1855,6 +2680,75 @@ FlutterEngineResult FlutterEngineNotifyLowMemoryWarning(
                    "Could not dispatch the low memory notification message.");
 }
 
+FlutterEngineResult FlutterEngineConfigurePlatformMessageChannel(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    const FlutterPlatformMessageChannelConfig* config) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  const char* channel = SAFE_ACCESS(config, channel, nullptr);
+  if (channel == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Channel configuration did not specify a "
+                              "channel.");
+  }
+
+  flutter::PlatformMessageBuffers::ChannelConfig channel_config;
+  channel_config.capacity = SAFE_ACCESS(config, capacity, 0);
+  channel_config.batch_delivery = SAFE_ACCESS(config, batch_delivery, false);
+  switch (SAFE_ACCESS(config, overflow_policy,
+                      kFlutterPlatformMessageOverflowDropOldest)) {
+    case kFlutterPlatformMessageOverflowDropOldest:
+      channel_config.overflow_policy =
+          flutter::PlatformMessageBuffers::OverflowPolicy::kDropOldest;
+      break;
+    case kFlutterPlatformMessageOverflowBlockProducer:
+      channel_config.overflow_policy =
+          flutter::PlatformMessageBuffers::OverflowPolicy::kBlockProducer;
+      break;
+    case kFlutterPlatformMessageOverflowCoalesceLatest:
+      channel_config.overflow_policy =
+          flutter::PlatformMessageBuffers::OverflowPolicy::kCoalesceLatest;
+      break;
+    default:
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "Invalid platform message overflow policy.");
+  }
+
+  engine->GetShell().ConfigurePlatformMessageChannel(channel, channel_config);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineSetBackgroundPlatformMessageCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    const char* channel,
+    FlutterPlatformMessageCallback callback,
+    void* user_data) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (channel == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Channel was null.");
+  }
+
+  if (callback == nullptr) {
+    engine->GetShell().SetPlatformMessageHandler(channel, nullptr, nullptr);
+    return kSuccess;
+  }
+
+  engine->GetShell().SetPlatformMessageHandler(
+      channel, engine->GetPlatformMessageHandlerTaskRunner(),
+      [callback, user_data](fml::RefPtr<flutter::PlatformMessage> message) {
+        DispatchPlatformMessageToCallback(callback, user_data,
+                                          std::move(message));
+      });
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterNativeThreadCallback callback,
@@ -1878,3 +2772,50 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
                                   "Internal error while attempting to post "
                                   "tasks to all threads.");
 }
+
+FlutterEngineResult FlutterEngineGetStartupTiming(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineStartupTiming* timing_out) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (timing_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid startup timing.");
+  }
+
+  auto embedder_engine = reinterpret_cast<flutter::EmbedderEngine*>(engine);
+  if (!embedder_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The engine was not initialized.");
+  }
+
+  using flutter::StartupProfiler;
+  const StartupProfiler& profiler =
+      embedder_engine->GetShell().GetStartupProfiler();
+  if (SAFE_EXISTS(timing_out, engine_main_enter)) {
+    timing_out->engine_main_enter =
+        profiler.Get(StartupProfiler::kEngineMainEnter);
+  }
+  if (SAFE_EXISTS(timing_out, vm_created)) {
+    timing_out->vm_created =
+        profiler.GetSinceMainEnter(StartupProfiler::kVMCreated);
+  }
+  if (SAFE_EXISTS(timing_out, engine_initialized)) {
+    timing_out->engine_initialized =
+        profiler.GetSinceMainEnter(StartupProfiler::kShellCreated);
+  }
+  if (SAFE_EXISTS(timing_out, run_engine)) {
+    timing_out->run_engine =
+        profiler.GetSinceMainEnter(StartupProfiler::kRunEngine);
+  }
+  if (SAFE_EXISTS(timing_out, root_isolate_running)) {
+    timing_out->root_isolate_running =
+        profiler.GetSinceMainEnter(StartupProfiler::kRootIsolateRunning);
+  }
+  if (SAFE_EXISTS(timing_out, first_frame_rasterized)) {
+    timing_out->first_frame_rasterized =
+        profiler.GetSinceMainEnter(StartupProfiler::kFirstFrameRasterized);
+  }
+  return kSuccess;
+}
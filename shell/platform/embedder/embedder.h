@@ -39,6 +39,8 @@ typedef enum {
 typedef enum {
   kOpenGL,
   kSoftware,
+  /// Vulkan is only supported by engines built with `embedder_enable_vulkan`.
+  kVulkan,
 } FlutterRendererType;
 
 /// Additional accessibility features that may be enabled by the platform.
@@ -241,6 +243,47 @@ typedef struct {
   size_t height;
 } FlutterOpenGLTexture;
 
+/// The most planes a `FlutterDmaBufTexture` can have.
+#define FLUTTER_DMA_BUF_MAX_PLANES 4
+
+typedef struct {
+  /// The dma-buf file descriptor of the plane. It remains owned by the
+  /// embedder and must stay open until the destruction callback of the
+  /// texture is invoked.
+  int fd;
+  /// The offset of the plane in the dma-buf, in bytes.
+  uint32_t offset;
+  /// The number of bytes between the starts of consecutive rows of the plane.
+  uint32_t stride;
+} FlutterDmaBufPlane;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDmaBufTexture).
+  size_t struct_size;
+  /// The width of the frame in pixels.
+  size_t width;
+  /// The height of the frame in pixels.
+  size_t height;
+  /// The DRM fourcc code of the pixel format (example DRM_FORMAT_ARGB8888 or
+  /// DRM_FORMAT_NV12).
+  uint32_t fourcc;
+  /// The DRM format modifier describing the layout of the buffer, or
+  /// DRM_FORMAT_MOD_INVALID to let the driver infer it.
+  uint64_t modifier;
+  /// The number of planes, up to `FLUTTER_DMA_BUF_MAX_PLANES`.
+  size_t num_planes;
+  FlutterDmaBufPlane planes[FLUTTER_DMA_BUF_MAX_PLANES];
+  /// A sync file descriptor that is signaled once the producer has finished
+  /// writing the frame, or -1 if the frame is ready. The engine takes
+  /// ownership of it and makes the GPU wait on it, not the CPU.
+  int acquire_fence_fd;
+  /// User data to be returned on the invocation of the destruction callback.
+  void* user_data;
+  /// Callback invoked (on an engine managed thread) once the engine no longer
+  /// reads from the frame, which the embedder may then reuse.
+  VoidCallback destruction_callback;
+} FlutterDmaBufTexture;
+
 typedef struct {
   /// The target of the color attachment of the frame-buffer. For example,
   /// GL_TEXTURE_2D or GL_RENDERBUFFER. In case of ambiguity when dealing with
@@ -258,6 +301,13 @@ typedef struct {
   VoidCallback destruction_callback;
 } FlutterOpenGLFramebuffer;
 
+typedef struct {
+  double left;
+  double top;
+  double right;
+  double bottom;
+} FlutterRect;
+
 typedef bool (*BoolCallback)(void* /* user data */);
 typedef FlutterTransformation (*TransformationCallback)(void* /* user data */);
 typedef uint32_t (*UIntCallback)(void* /* user data */);
@@ -265,12 +315,79 @@ typedef bool (*SoftwareSurfacePresentCallback)(void* /* user data */,
                                                const void* /* allocation */,
                                                size_t /* row bytes */,
                                                size_t /* height */);
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// The number of rectangles in `damage`.
+  size_t num_rects;
+  /// The rectangles, in physical pixels, that were repainted. Pixels outside
+  /// of them are the same as in the last frame presented from the buffer. No
+  /// rectangles means that nothing changed.
+  const FlutterRect* damage;
+} FlutterDamage;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterOpenGLPresentInfo).
+  size_t struct_size;
+  /// The region of the framebuffer that was repainted for this frame.
+  FlutterDamage frame_damage;
+} FlutterOpenGLPresentInfo;
+
+typedef bool (*OpenGLPresentWithInfoCallback)(
+    void* /* user data */,
+    const FlutterOpenGLPresentInfo* /* present info */);
+
+typedef void (*OpenGLDamageRegionCallback)(
+    void* /* user data */,
+    const FlutterDamage* /* damage */);
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwarePresentInfo).
+  size_t struct_size;
+  /// The pixels of the frame.
+  const void* allocation;
+  /// The number of bytes in a row of pixels.
+  size_t row_bytes;
+  /// The number of rows of pixels.
+  size_t height;
+  /// The region of the buffer that was repainted for this frame.
+  FlutterDamage frame_damage;
+} FlutterSoftwarePresentInfo;
+
+typedef bool (*SoftwareSurfacePresentWithInfoCallback)(
+    void* /* user data */,
+    const FlutterSoftwarePresentInfo* /* present info */);
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareBuffer).
+  size_t struct_size;
+  /// The memory to render the frame into, at least `row_bytes * height` bytes.
+  /// It must remain valid until the frame has been presented.
+  void* allocation;
+  /// The number of bytes in a row of pixels. At least four times the width.
+  size_t row_bytes;
+  /// The number of frames since the buffer was last presented, or zero if its
+  /// contents are undefined. A buffer presented every frame has an age of one.
+  uint32_t age;
+} FlutterSoftwareBuffer;
+
+typedef bool (*SoftwareSurfaceAcquireBufferCallback)(
+    void* /* user data */,
+    size_t /* width */,
+    size_t /* height */,
+    FlutterSoftwareBuffer* /* buffer out */);
 typedef void* (*ProcResolver)(void* /* user data */, const char* /* name */);
 typedef bool (*TextureFrameCallback)(void* /* user data */,
                                      int64_t /* texture identifier */,
                                      size_t /* width */,
                                      size_t /* height */,
                                      FlutterOpenGLTexture* /* texture out */);
+typedef bool (*DmaBufTextureFrameCallback)(
+    void* /* user data */,
+    int64_t /* texture identifier */,
+    size_t /* width */,
+    size_t /* height */,
+    FlutterDmaBufTexture* /* texture out */);
 typedef void (*VsyncCallback)(void* /* user data */, intptr_t /* baton */);
 
 typedef struct {
@@ -309,6 +426,43 @@ typedef struct {
   /// that external texture details can be supplied to the engine for subsequent
   /// composition.
   TextureFrameCallback gl_external_texture_frame_callback;
+  /// Optional callback that presents the frame like `present`, along with the
+  /// region of the framebuffer that was repainted. If set, it is used instead
+  /// of `present`, which may then be null.
+  OpenGLPresentWithInfoCallback present_with_info;
+  /// Optional callback that returns the age of the buffer backing the
+  /// framebuffer returned by `fbo_callback`, as reported by
+  /// EGL_EXT_buffer_age: the number of frames since it was last presented, or
+  /// zero if its contents are undefined. If the callback is set and returns a
+  /// non-zero age, the engine only repaints the parts of the frame that
+  /// changed.
+  UIntCallback fbo_buffer_age_callback;
+  /// Optional callback, used on Linux, that provides the latest frame of an
+  /// external texture as a dma-buf, such as one decoded by a video decoder or
+  /// captured by a camera. The engine imports it as an EGLImage and samples
+  /// it directly, without copying it into a texture. It is asked first for
+  /// every external texture; returning false falls back to
+  /// `gl_external_texture_frame_callback`. This needs the
+  /// EGL_EXT_image_dma_buf_import and GL_OES_EGL_image_external extensions,
+  /// and EGL_ANDROID_native_fence_sync for frames with acquire fences. The
+  /// `gl_proc_resolver` must resolve eglGetCurrentDisplay and the functions
+  /// of those extensions.
+  DmaBufTextureFrameCallback dmabuf_external_texture_frame_callback;
+  /// Optional callback invoked on the raster thread before the engine renders
+  /// into the framebuffer, with the region of it that will be repainted. It
+  /// is only invoked after `fbo_buffer_age_callback` for the same frame, so
+  /// embedders can pass the region to `eglSetDamageRegionKHR`
+  /// (EGL_KHR_partial_update) and let tiled GPUs skip loading and storing the
+  /// rest of the buffer.
+  OpenGLDamageRegionCallback set_damage_region;
+  /// Whether the embedder promises that the current context of the threads
+  /// the engine renders on is only changed by the engine's calls to
+  /// `make_current` and `clear_current`. The engine then keeps track of the
+  /// current context of each thread and skips the calls that would not change
+  /// it, such as making the context current at the start of every frame.
+  /// Embedders that make contexts current on the render thread themselves,
+  /// for example when it is also their platform thread, must not set this.
+  bool skip_redundant_context_switches;
 } FlutterOpenGLRendererConfig;
 
 typedef struct {
@@ -319,13 +473,92 @@ typedef struct {
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// Optional callback that presents the frame like
+  /// `surface_present_callback`, along with the region of the buffer that was
+  /// repainted. If set, it is used instead of `surface_present_callback`,
+  /// which may then be null, and the engine only repaints the parts of a
+  /// buffer it owns that changed.
+  SoftwareSurfacePresentWithInfoCallback surface_present_with_info_callback;
+  /// Optional callback that provides the buffer to render a frame into, for
+  /// embedders that want to keep the buffer, or render straight into memory
+  /// they display from. If the buffer has a non-zero age, the engine only
+  /// repaints the parts of the frame that changed. The pixel format is the
+  /// same as that of buffers owned by the engine.
+  SoftwareSurfaceAcquireBufferCallback surface_acquire_buffer_callback;
 } FlutterSoftwareRendererConfig;
 
+/// Alias for VkInstance.
+typedef void* FlutterVulkanInstanceHandle;
+/// Alias for VkPhysicalDevice.
+typedef void* FlutterVulkanPhysicalDeviceHandle;
+/// Alias for VkDevice.
+typedef void* FlutterVulkanDeviceHandle;
+/// Alias for VkQueue.
+typedef void* FlutterVulkanQueueHandle;
+/// Alias for VkImage.
+typedef uint64_t FlutterVulkanImageHandle;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterVulkanImage).
+  size_t struct_size;
+  /// The image to render into. It must have been created with the
+  /// VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT usage, and VK_IMAGE_TILING_OPTIMAL.
+  FlutterVulkanImageHandle image;
+  /// The VkFormat of the image (example VK_FORMAT_R8G8B8A8_UNORM).
+  uint32_t format;
+} FlutterVulkanImage;
+
+/// Returns the address of the Vulkan function called `name`, like
+/// vkGetInstanceProcAddr. It is first asked for "vkGetInstanceProcAddr" itself
+/// with a null instance.
+typedef void* (*FlutterVulkanInstanceProcAddressCallback)(
+    void* /* user data */,
+    FlutterVulkanInstanceHandle /* instance */,
+    const char* /* name */);
+/// Provides the image to render the next frame of the given size into.
+typedef FlutterVulkanImage (*FlutterVulkanImageCallback)(
+    void* /* user data */,
+    size_t /* width */,
+    size_t /* height */);
+/// Presents an image returned by the image callback.
+typedef bool (*FlutterVulkanPresentCallback)(
+    void* /* user data */,
+    const FlutterVulkanImage* /* image */);
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterVulkanRendererConfig).
+  size_t struct_size;
+  /// The Vulkan API version the instance was created with (example
+  /// VK_MAKE_VERSION(1, 1, 0)).
+  uint32_t version;
+  /// The instance, physical device, device and queue the engine renders with.
+  /// They are owned by the embedder and must outlive the engine. The engine
+  /// submits work to the queue from its raster thread, so the embedder must
+  /// not use the queue from other threads at the same time.
+  FlutterVulkanInstanceHandle instance;
+  FlutterVulkanPhysicalDeviceHandle physical_device;
+  FlutterVulkanDeviceHandle device;
+  /// The index of the queue family of `queue`, which must support graphics.
+  uint32_t queue_family_index;
+  FlutterVulkanQueueHandle queue;
+  FlutterVulkanInstanceProcAddressCallback get_instance_proc_address_callback;
+  /// Called on the raster thread for the image to render each frame into.
+  /// The engine renders the whole image, which may come from a swapchain the
+  /// embedder manages or be an offscreen image.
+  FlutterVulkanImageCallback get_next_image_callback;
+  /// Called on the raster thread once all the work of rendering into the
+  /// image has been submitted to the queue. Work the embedder submits to the
+  /// same queue afterwards, like a present, is ordered after the engine's. The
+  /// image is left in the VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL layout.
+  FlutterVulkanPresentCallback present_image_callback;
+} FlutterVulkanRendererConfig;
+
 typedef struct {
   FlutterRendererType type;
   union {
     FlutterOpenGLRendererConfig open_gl;
     FlutterSoftwareRendererConfig software;
+    FlutterVulkanRendererConfig vulkan;
   };
 } FlutterRendererConfig;
 
@@ -449,6 +682,30 @@ typedef struct {
   const FlutterPlatformMessageResponseHandle* response_handle;
 } FlutterPlatformMessage;
 
+typedef enum {
+  /// The event is a `FlutterWindowMetricsEvent`.
+  kFlutterEngineEventTypeWindowMetrics,
+  /// The event is a `FlutterPointerEvent`.
+  kFlutterEngineEventTypePointer,
+  /// The event is a `FlutterPlatformMessage`.
+  kFlutterEngineEventTypePlatformMessage,
+} FlutterEngineEventType;
+
+/// An event of any of the kinds the embedder sends to the engine, for use with
+/// `FlutterEngineSendEvents`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterEngineEvent).
+  size_t struct_size;
+  /// The kind of the event, which determines the member of the subsequent
+  /// union that describes it.
+  FlutterEngineEventType type;
+  union {
+    const FlutterWindowMetricsEvent* window_metrics;
+    const FlutterPointerEvent* pointer;
+    const FlutterPlatformMessage* platform_message;
+  };
+} FlutterEngineEvent;
+
 typedef void (*FlutterPlatformMessageCallback)(
     const FlutterPlatformMessage* /* message*/,
     void* /* user data */);
@@ -457,13 +714,6 @@ typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
                                     size_t /* size */,
                                     void* /* user data */);
 
-typedef struct {
-  double left;
-  double top;
-  double right;
-  double bottom;
-} FlutterRect;
-
 typedef struct {
   double x;
   double y;
@@ -640,6 +890,23 @@ typedef struct {
   size_t identifier;
 } FlutterTaskRunnerDescription;
 
+/// The priority of the work on a thread the engine creates. The embedder may
+/// map these to the thread priorities, quality of service classes or core
+/// affinities of its platform.
+typedef enum {
+  /// Work that can wait, like loading resources on the IO thread.
+  kFlutterThreadPriorityBackground = 0,
+  /// The default priority.
+  kFlutterThreadPriorityNormal = 1,
+  /// Work that a frame waits for, like building it on the UI thread.
+  kFlutterThreadPriorityUI = 2,
+  /// Work that puts pixels on the screen, like rasterizing a frame.
+  kFlutterThreadPriorityDisplay = 3,
+} FlutterThreadPriority;
+
+typedef void (*FlutterThreadPrioritySetter)(
+    FlutterThreadPriority /* priority */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterCustomTaskRunners).
   size_t struct_size;
@@ -653,6 +920,11 @@ typedef struct {
   /// and platform task runners. This makes the Flutter engine use the same
   /// thread for both task runners.
   const FlutterTaskRunnerDescription* render_task_runner;
+  /// Called on each thread the engine creates for itself, before any task
+  /// runs on it, with the priority of the work on that thread. The embedder
+  /// can use it to set the priority and core affinity of the thread. If this
+  /// is null, engine created threads keep their default priority.
+  FlutterThreadPrioritySetter thread_priority_setter;
 } FlutterCustomTaskRunners;
 
 typedef struct {
@@ -742,8 +1014,27 @@ typedef enum {
   kFlutterBackingStoreTypeOpenGL,
   /// Specified an software allocation for Flutter to render into using the CPU.
   kFlutterBackingStoreTypeSoftware,
+  /// Specifies a Vulkan image for Flutter to render into with the Vulkan
+  /// renderer.
+  kFlutterBackingStoreTypeVulkan,
 } FlutterBackingStoreType;
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterVulkanBackingStore).
+  size_t struct_size;
+  /// The image that the layer will be rendered to. Its usage must include
+  /// VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, and it must stay valid until the
+  /// destruction callback is invoked.
+  FlutterVulkanImage image;
+  /// A baton that is not interpreted by the engine in any way. It will be given
+  /// back to the embedder in the destruction callback below. Embedder resources
+  /// may be associated with this baton.
+  void* user_data;
+  /// The callback invoked by the engine when it no longer needs this backing
+  /// store.
+  VoidCallback destruction_callback;
+} FlutterVulkanBackingStore;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterBackingStore).
   size_t struct_size;
@@ -761,6 +1052,8 @@ typedef struct {
     FlutterOpenGLBackingStore open_gl;
     /// The description of the software backing store.
     FlutterSoftwareBackingStore software;
+    /// The description of the Vulkan backing store.
+    FlutterVulkanBackingStore vulkan;
   };
 } FlutterBackingStore;
 
@@ -813,6 +1106,26 @@ typedef bool (*FlutterLayersPresentCallback)(const FlutterLayer** layers,
                                              size_t layers_count,
                                              void* user_data);
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterBackingStoreCacheStats).
+  size_t struct_size;
+  /// The number of backing stores of the last frame that were reused.
+  size_t hit_count;
+  /// The number of backing stores of the last frame that had to be created.
+  size_t miss_count;
+  /// The number of backing stores collected during the last frame.
+  size_t evicted_count;
+  /// The number of backing stores the engine holds on to for reuse.
+  size_t cached_count;
+  /// An estimate of the memory of the backing stores the engine holds on to
+  /// for reuse, assuming four bytes per pixel.
+  size_t cached_bytes;
+} FlutterBackingStoreCacheStats;
+
+typedef void (*FlutterBackingStoreCacheStatsCallback)(
+    const FlutterBackingStoreCacheStats* /* stats */,
+    void* /* user data */);
+
 typedef struct {
   /// This size of this struct. Must be sizeof(FlutterCompositor).
   size_t struct_size;
@@ -835,6 +1148,24 @@ typedef struct {
   /// Callback invoked by the engine to composite the contents of each layer
   /// onto the screen.
   FlutterLayersPresentCallback present_layers_callback;
+  /// The number of frames a backing store may go unused before the engine
+  /// collects it. Zero is the same as one, which only keeps the backing stores
+  /// of the last frame for reuse.
+  size_t backing_store_cache_max_unused_frames;
+  /// The most memory the unused backing stores kept for reuse may take up,
+  /// estimated at four bytes per pixel. The least recently used ones are
+  /// collected first. Zero means no limit.
+  size_t backing_store_cache_max_bytes;
+  /// If greater than one, the sizes of the backing stores the engine asks for
+  /// are rounded up to multiples of this many pixels, so that backing stores
+  /// can be reused while the size of the view changes a little, like during a
+  /// window resize. The contents of a layer are then rendered into the top
+  /// left of its backing store, and only that region, of the size of the
+  /// layer, must be composited.
+  size_t backing_store_size_granularity;
+  /// An optional callback invoked by the engine on the raster thread after
+  /// each frame with statistics about the reuse of backing stores.
+  FlutterBackingStoreCacheStatsCallback backing_store_cache_stats_callback;
 } FlutterCompositor;
 
 typedef struct {
@@ -875,6 +1206,31 @@ typedef enum {
   kFlutterEngineDartObjectTypeBuffer,
 } FlutterEngineDartObjectType;
 
+/// The element type of the typed data a `FlutterEngineDartBuffer` is received
+/// as on the Dart side.
+typedef enum {
+  /// Received as a Uint8List. This is the default.
+  kFlutterEngineDartTypedDataTypeUint8,
+  /// Received as an Int8List.
+  kFlutterEngineDartTypedDataTypeInt8,
+  /// Received as a Uint16List.
+  kFlutterEngineDartTypedDataTypeUint16,
+  /// Received as an Int16List.
+  kFlutterEngineDartTypedDataTypeInt16,
+  /// Received as a Uint32List.
+  kFlutterEngineDartTypedDataTypeUint32,
+  /// Received as an Int32List.
+  kFlutterEngineDartTypedDataTypeInt32,
+  /// Received as a Uint64List.
+  kFlutterEngineDartTypedDataTypeUint64,
+  /// Received as an Int64List.
+  kFlutterEngineDartTypedDataTypeInt64,
+  /// Received as a Float32List.
+  kFlutterEngineDartTypedDataTypeFloat32,
+  /// Received as a Float64List.
+  kFlutterEngineDartTypedDataTypeFloat64,
+} FlutterEngineDartTypedDataType;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterEngineDartBuffer).
   size_t struct_size;
@@ -892,6 +1248,19 @@ typedef struct {
   /// callback is invoked by the engine. The user data specified in the callback
   /// is the value of `user_data` field in this struct.
   ///
+  /// The buffer is not copied in this case. The receiving isolate gets an
+  /// external typed data object that views the buffer directly, so large
+  /// payloads (camera frames, tensors) cost the same to post as small ones.
+  /// The callback is invoked exactly once, when the Dart garbage collector
+  /// finalizes that object. This happens on whichever VM thread runs the
+  /// collection, which may be a Dart VM worker thread and never the platform
+  /// thread in particular; the embedder must synchronize access to any state
+  /// it touches in the callback. If the receiving port is closed before the
+  /// message is delivered, the callback is invoked when the message is
+  /// dropped. Finalizers that have not run by then are run when the isolate
+  /// is shut down, so the callback may be invoked after
+  /// `FlutterEngineShutdown` has returned.
+  ///
   /// When NOT specified, the VM creates an internal copy of the buffer. The
   /// caller is free to modify the buffer as necessary or collect it immediately
   /// after the call to `FlutterEnginePostDartObject`.
@@ -908,8 +1277,13 @@ typedef struct {
   /// this buffer not have page protections that restrict writing to this
   /// buffer.
   uint8_t* buffer;
-  /// The size of the buffer.
+  /// The size of the buffer in bytes. This must be a multiple of the size of
+  /// the elements of `typed_data_type`.
   size_t buffer_size;
+  /// The element type of the typed data the buffer is received as. When the
+  /// buffer is owned by the embedder, it must be aligned to the size of these
+  /// elements.
+  FlutterEngineDartTypedDataType typed_data_type;
 } FlutterEngineDartBuffer;
 
 /// This struct specifies the native representation of a Dart object that can be
@@ -959,6 +1333,46 @@ typedef enum {
 typedef void (*FlutterNativeThreadCallback)(FlutterNativeThreadType type,
                                             void* user_data);
 
+/// How much memory the engine should give up in response to
+/// `FlutterEngineNotifyMemoryPressure`, in increasing order of severity.
+typedef enum {
+  /// The system is running low on memory while the application is visible.
+  /// Only caches that the current frames don't use are trimmed.
+  kFlutterMemoryPressureLevelModerate,
+  /// The system is running very low on memory while the application is
+  /// visible. This is what `FlutterEngineNotifyLowMemoryWarning` notifies.
+  kFlutterMemoryPressureLevelCritical,
+  /// The application is not visible. Everything that can be rebuilt when it
+  /// becomes visible again is released.
+  kFlutterMemoryPressureLevelBackground,
+} FlutterMemoryPressureLevel;
+
+/// What happens when a message arrives on a channel whose queue is full. See
+/// `FlutterEngineConfigurePlatformMessageChannel`.
+typedef enum {
+  /// The oldest queued message is dropped to make room.
+  kFlutterPlatformMessageOverflowDropOldest,
+  /// The thread sending the message waits for the queue to be drained.
+  kFlutterPlatformMessageOverflowBlockProducer,
+  /// The most recently queued message is replaced, so that only the latest
+  /// message is delivered.
+  kFlutterPlatformMessageOverflowCoalesceLatest,
+} FlutterPlatformMessageOverflowPolicy;
+
+typedef struct {
+  /// The size of this struct. Must be
+  /// sizeof(FlutterPlatformMessageChannelConfig).
+  size_t struct_size;
+  /// The name of the channel.
+  const char* channel;
+  /// The most messages queued on the channel at once. Zero removes the queue.
+  size_t capacity;
+  FlutterPlatformMessageOverflowPolicy overflow_policy;
+  /// Whether the queued messages are handed to the Dart application in a
+  /// single call instead of one call per message.
+  bool batch_delivery;
+} FlutterPlatformMessageChannelConfig;
+
 /// AOT data source type.
 typedef enum {
   kFlutterEngineAOTDataSourceTypeElfPath
@@ -1010,6 +1424,111 @@ FlutterEngineResult FlutterEngineCreateAOTData(
 FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineCollectAOTData(FlutterEngineAOTData data);
 
+/// An opaque group of engines that render on one raster thread with one Skia
+/// context, and so share its resource cache, shader cache and glyph atlases
+/// instead of keeping their own. Each engine still renders to its own
+/// surfaces. The shaders persisted to disk are already shared by all the
+/// engines of the process.
+typedef struct _FlutterEngineGroup* FlutterEngineGroup;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterEngineGroupConfig).
+  size_t struct_size;
+  /// The maximum number of bytes of GPU resources that Skia caches for all the
+  /// engines of the group. Zero lets each engine size the cache to its
+  /// viewport, as engines outside of a group do.
+  size_t resource_cache_max_bytes;
+} FlutterEngineGroupConfig;
+
+//------------------------------------------------------------------------------
+/// @brief      Creates a group that engines opt into with
+///             `FlutterProjectArgs::engine_group`.
+///
+///             Engines of a group that don't specify a render task runner
+///             render on a raster thread owned by the group. Engines that do
+///             must all specify the same one.
+///
+///             With the OpenGL renderer, the `make_current` callbacks of the
+///             engines of a group must make the same OpenGL context current,
+///             each with its own surface bound, or contexts of one share
+///             group. With the Vulkan renderer, the engines must use the same
+///             device and queue. The software renderer doesn't share anything
+///             but the raster thread.
+///
+/// @param[in]  config     The configuration of the group.
+/// @param[out] group_out  The group on success. Unchanged on failure.
+///
+/// @return     Returns if the group was created.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGroupCreate(
+    const FlutterEngineGroupConfig* config,
+    FlutterEngineGroup* group_out);
+
+//------------------------------------------------------------------------------
+/// @brief      Releases the embedder's reference to the group. Engines of the
+///             group that are still running keep using it, and the raster
+///             thread and Skia context of the group are destroyed once the last
+///             of them shut down. The resources of a shared OpenGL context are
+///             then freed along with the OpenGL context, not by the engine.
+///
+/// @param[in]  group  The group to collect.
+///
+/// @return     Returns if the group was collected.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGroupCollect(FlutterEngineGroup group);
+
+/// The timings of a frame rasterized by the engine. All times are in
+/// nanoseconds and use the clock of `FlutterEngineGetCurrentTime`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimings).
+  size_t struct_size;
+  /// The start time of the vsync that the frame was built for, as given to
+  /// `FlutterEngineOnVsync` or `FlutterEngineOnVsyncWithInfo`.
+  uint64_t vsync_start_time_nanos;
+  /// When the UI thread started building the frame.
+  uint64_t build_start_time_nanos;
+  /// When the UI thread finished building the frame.
+  uint64_t build_finish_time_nanos;
+  /// When the raster thread started rasterizing the frame.
+  uint64_t raster_start_time_nanos;
+  /// When the raster thread finished rasterizing and presenting the frame.
+  uint64_t raster_finish_time_nanos;
+} FlutterFrameTimings;
+
+typedef void (*FlutterFrameTimingsCallback)(
+    const FlutterFrameTimings* /* timings */,
+    void* /* user data */);
+
+typedef void (*FlutterPreferredFrameRateCallback)(float /* frames per second */,
+                                                  void* /* user data */);
+
+typedef void (*FlutterOffscreenRasterJobCallback)(bool /* success */,
+                                                  void* /* user data */);
+
+/// A request to rasterize the last frame of an engine into a buffer owned by
+/// the embedder. See `FlutterEngineRasterizeLastFrame`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterOffscreenRasterJob).
+  size_t struct_size;
+  /// The width of the output in pixels. The frame is scaled to fill it.
+  size_t width;
+  /// The height of the output in pixels. The frame is scaled to fill it.
+  size_t height;
+  /// The output, in the native 32 bits per pixel premultiplied format (BGRA
+  /// on most desktop platforms). It must stay valid until `callback` is
+  /// invoked.
+  void* allocation;
+  /// The number of bytes between the starts of two rows of `allocation`.
+  size_t row_bytes;
+  /// Invoked with whether the frame was written into `allocation`, on an
+  /// internal engine-managed thread.
+  FlutterOffscreenRasterJobCallback callback;
+  /// The user data passed to `callback`.
+  void* user_data;
+} FlutterOffscreenRasterJob;
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterProjectArgs).
   size_t struct_size;
@@ -1205,6 +1724,31 @@ typedef struct {
   ///
   /// Embedders can provide either snapshot buffers or aot_data, but not both.
   FlutterEngineAOTData aot_data;
+
+  /// An optional callback that the engine invokes with the timings of each
+  /// frame once it has been rasterized, so that embedders scheduling frames
+  /// themselves can tell how long frames take and when they are done. The
+  /// callback is made on the raster thread and must not block.
+  FlutterFrameTimingsCallback frame_timings_callback;
+
+  /// The group the engine shares its raster thread and Skia context with, as
+  /// created by `FlutterEngineGroupCreate`. Null for an engine with its own.
+  FlutterEngineGroup engine_group;
+
+  /// Whether frames are produced as soon as they are scheduled instead of
+  /// being paced by vsync, for engines that only render offscreen. The
+  /// `vsync_callback` is ignored when this is set. Without a `vsync_callback`,
+  /// frames are otherwise paced by a 60Hz timer.
+  bool disable_vsync;
+
+  /// An optional callback that the engine invokes with the refresh rate it
+  /// would like the display to have, in frames per second, or 0 once it has
+  /// no preference. The engine asks for a lower rate while it produces frames
+  /// less often than the display refreshes, and for the highest rate again
+  /// once it doesn't. Setting the callback enables these requests, which are
+  /// only made while frames are paced by the `vsync_callback`. The callback is
+  /// made on the UI thread and must not block.
+  FlutterPreferredFrameRateCallback preferred_frame_rate_callback;
 } FlutterProjectArgs;
 
 //------------------------------------------------------------------------------
@@ -1332,6 +1876,33 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
 
+//------------------------------------------------------------------------------
+/// @brief      Sends events of different kinds to the engine at once. This is
+///             cheaper than the calls for each kind of event, which each wake
+///             up the thread the Dart application runs on: the whole batch is
+///             delivered to the engine together, with all of its pointer
+///             events in a single packet.
+///
+///             The events of the batch are applied in a fixed order. Window
+///             metrics come first, and only the last of them has an effect.
+///             Then the platform messages are delivered in the order they
+///             appear, then the pointer events.
+///
+///             The batch is validated as a whole: if any event of it is
+///             invalid, none of them are sent.
+///
+/// @param[in]  engine        A running engine instance.
+/// @param[in]  events        The events to send.
+/// @param[in]  events_count  The number of events in `events`.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendEvents(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterEngineEvent* events,
+    size_t events_count);
+
 //------------------------------------------------------------------------------
 /// @brief     Creates a platform message response handle that allows the
 ///            embedder to set a native callback for a response to a message.
@@ -1497,6 +2068,26 @@ FlutterEngineResult FlutterEngineUpdateSemanticsEnabled(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     bool enabled);
 
+//------------------------------------------------------------------------------
+/// @brief      Tells the engine whether anything, such as a screen reader,
+///             currently consumes the semantics tree. Semantics may stay
+///             enabled without a consumer, for instance after a one-time
+///             accessibility probe. While no client is active, the engine
+///             merges the semantics updates instead of invoking the
+///             `FlutterUpdateSemanticsNodeCallback` every frame, and sends the
+///             merged update once a client becomes active. Clients are assumed
+///             to be active until the embedder says otherwise.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  active     Whether a consumer of the semantics tree is active.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineUpdateSemanticsClientActive(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    bool active);
+
 //------------------------------------------------------------------------------
 /// @brief      Sets additional accessibility features.
 ///
@@ -1567,6 +2158,44 @@ FlutterEngineResult FlutterEngineOnVsync(FLUTTER_API_SYMBOL(FlutterEngine)
                                          uint64_t frame_start_time_nanos,
                                          uint64_t frame_target_time_nanos);
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterVsyncInfo).
+  size_t struct_size;
+  /// The baton passed to the vsync callback.
+  intptr_t baton;
+  /// The point at which the vsync event occurred or will occur, in
+  /// nanoseconds on the clock of `FlutterEngineGetCurrentTime`.
+  uint64_t frame_start_time_nanos;
+  /// The time by which the frame must be rasterized and presented to be
+  /// displayed on time, such as when the compositor latches the next frame,
+  /// in nanoseconds on the clock of `FlutterEngineGetCurrentTime`. Engines
+  /// run with `--predictive-frame-scheduling` start building frames as late
+  /// as they can while still meeting this deadline.
+  uint64_t frame_target_time_nanos;
+  /// The refresh rate of the display in frames per second, for displays whose
+  /// refresh rate changes. Zero keeps the last refresh rate given, if any.
+  double display_refresh_rate;
+} FlutterVsyncInfo;
+
+//------------------------------------------------------------------------------
+/// @brief      Notify the engine that a vsync event occurred, like
+///             `FlutterEngineOnVsync`, along with what the embedder knows
+///             about the display. This allows embedders with variable refresh
+///             rates or compositor driven scheduling to tell the engine when
+///             frames are due. The timings of the resulting frames are
+///             reported to `FlutterProjectArgs.frame_timings_callback`.
+///
+/// @param[in]  engine  A running engine instance.
+/// @param[in]  info    The vsync event. The baton must be one passed to the
+///                     vsync callback that has not been returned yet.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineOnVsyncWithInfo(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterVsyncInfo* info);
+
 //------------------------------------------------------------------------------
 /// @brief      Reloads the system fonts in engine.
 ///
@@ -1635,6 +2264,33 @@ FlutterEngineResult FlutterEnginePostRenderThreadTask(
     VoidCallback callback,
     void* callback_data);
 
+//------------------------------------------------------------------------------
+/// @brief      Rasterizes the last frame produced by the engine into buffers
+///             owned by the embedder, without presenting it. This is meant for
+///             servers rendering previews or thumbnails, which usually also
+///             set `FlutterProjectArgs.disable_vsync`.
+///
+///             The frame is recorded once on the render thread, after which
+///             the jobs are rasterized in parallel on the CPU by the
+///             engine-managed worker threads. Frames that contain textures
+///             only available to the GPU, such as external textures of the
+///             OpenGL renderer, can't be rasterized this way.
+///
+///             If the call succeeds, the callback of each job is invoked
+///             exactly once, otherwise none are.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[in]  jobs        The jobs to rasterize.
+/// @param[in]  jobs_count  The number of jobs.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineRasterizeLastFrame(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterOffscreenRasterJob* jobs,
+    size_t jobs_count);
+
 //------------------------------------------------------------------------------
 /// @brief      Get the current time in nanoseconds from the clock used by the
 ///             flutter engine. This is the system monotonic clock.
@@ -1751,6 +2407,69 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineNotifyLowMemoryWarning(
     FLUTTER_API_SYMBOL(FlutterEngine) engine);
 
+//------------------------------------------------------------------------------
+/// @brief      Posts a memory pressure notification of the given level to a
+///             running engine instance. Like
+///             `FlutterEngineNotifyLowMemoryWarning`, which is the same as the
+///             `kFlutterMemoryPressureLevelCritical` level, the resources
+///             released in response may not have been collected by the time
+///             this call returns.
+///
+/// @param[in]  engine  A running engine instance.
+/// @param[in]  level   How much memory the engine should give up.
+///
+/// @return     If the memory pressure notification was sent to the running
+///             engine instance.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineNotifyMemoryPressure(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterMemoryPressureLevel level);
+
+//------------------------------------------------------------------------------
+/// @brief      Queues the platform messages sent on a high rate channel, like a
+///             sensor stream, on their way to the UI thread. The engine then
+///             delivers all the messages that arrived since the last delivery
+///             in a single UI task instead of one task per message. Dropped
+///             messages are responded to with an empty response.
+///
+/// @param[in]  engine  A running engine instance.
+/// @param[in]  config  The channel and the capacity and overflow policy of its
+///                     queue.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineConfigurePlatformMessageChannel(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageChannelConfig* config);
+
+//------------------------------------------------------------------------------
+/// @brief      Delivers the platform messages sent on a channel to a callback
+///             on a background thread owned by the engine, instead of to the
+///             `platform_message_callback` in the project args on the platform
+///             thread. This is meant for channels whose handlers do heavy
+///             work, like a database or an image processing plugin, which
+///             would otherwise hold up input and vsync handling on the
+///             platform thread. The messages of all such channels are
+///             delivered in order on the same thread, and may be responded to
+///             from any thread with `FlutterEngineSendPlatformMessageResponse`.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  channel    The channel.
+/// @param[in]  callback   The callback. A null callback delivers the messages
+///                        to the `platform_message_callback` again.
+/// @param[in]  user_data  The user data passed to the callback.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSetBackgroundPlatformMessageCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const char* channel,
+    FlutterPlatformMessageCallback callback,
+    void* user_data);
+
 //------------------------------------------------------------------------------
 /// @brief      Schedule a callback to be run on all engine managed threads.
 ///             The engine will attempt to service this callback the next time
@@ -1790,6 +2509,47 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
     FlutterNativeThreadCallback callback,
     void* user_data);
 
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterEngineStartupTiming).
+  size_t struct_size;
+  /// When the embedder entered the engine, in microseconds on the clock of the
+  /// Dart timeline. This is the time `FlutterEngineRun` or
+  /// `FlutterEngineInitialize` was first called in the process.
+  int64_t engine_main_enter;
+  /// The milestones of the startup of the engine, in microseconds since
+  /// `engine_main_enter`, or -1 if the milestone wasn't reached yet.
+  ///
+  /// When the Dart VM was created. This may be before the engine was
+  /// initialized if another engine of the process created the VM.
+  int64_t vm_created;
+  /// When the engine was initialized, before it was asked to run.
+  int64_t engine_initialized;
+  /// When the engine was asked to run the Dart application.
+  int64_t run_engine;
+  /// When the main entrypoint of the root isolate returned.
+  int64_t root_isolate_running;
+  /// When the first frame was rasterized.
+  int64_t first_frame_rasterized;
+} FlutterEngineStartupTiming;
+
+//------------------------------------------------------------------------------
+/// @brief      Reports when the engine reached the milestones of its startup,
+///             so that embedders can report startup breakdowns without
+///             recording a timeline. The timing is recorded by every engine
+///             and may be queried on any thread, at any time after the engine
+///             was initialized.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[out] timing_out  The timing. Its `struct_size` must be set by the
+///                         caller. Only the fields within it are written.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetStartupTiming(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineStartupTiming* timing_out);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
@@ -0,0 +1,277 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_dmabuf_importer.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
+
+namespace flutter {
+
+// The embedder doesn't link against EGL, so the few types and enums used from
+// EGL_EXT_image_dma_buf_import(_modifiers), EGL_ANDROID_native_fence_sync and
+// GL_OES_EGL_image_external are declared here.
+using EGLDisplay = void*;
+using EGLImageKHR = void*;
+using EGLSyncKHR = void*;
+using EGLint = int32_t;
+using EGLenum = uint32_t;
+using EGLBoolean = uint32_t;
+
+static constexpr EGLint kEGLNone = 0x3038;
+static constexpr EGLint kEGLWidth = 0x3057;
+static constexpr EGLint kEGLHeight = 0x3056;
+static constexpr EGLenum kEGLLinuxDmaBufEXT = 0x3270;
+static constexpr EGLint kEGLLinuxDrmFourccEXT = 0x3271;
+static constexpr EGLenum kEGLSyncNativeFenceAndroid = 0x3144;
+static constexpr EGLint kEGLSyncNativeFenceFdAndroid = 0x3145;
+static constexpr uint64_t kDrmFormatModInvalid = 0x00ffffffffffffffull;
+
+static constexpr uint32_t kGLTextureExternalOES = 0x8D65;
+static constexpr uint32_t kGLRGBA8 = 0x8058;
+static constexpr uint32_t kGLTextureMinFilter = 0x2801;
+static constexpr uint32_t kGLTextureMagFilter = 0x2800;
+static constexpr uint32_t kGLLinear = 0x2601;
+
+struct PlaneAttributes {
+  EGLint fd;
+  EGLint offset;
+  EGLint pitch;
+  EGLint modifier_lo;
+  EGLint modifier_hi;
+};
+
+static constexpr PlaneAttributes kPlaneAttributes[FLUTTER_DMA_BUF_MAX_PLANES] =
+    {
+        {0x3272, 0x3273, 0x3274, 0x3443, 0x3444},
+        {0x3275, 0x3276, 0x3277, 0x3445, 0x3446},
+        {0x3278, 0x3279, 0x327A, 0x3447, 0x3448},
+        {0x3440, 0x3441, 0x3442, 0x3449, 0x344A},
+};
+
+struct EmbedderDmaBufImporter::Procs {
+  EGLDisplay (*GetCurrentDisplay)() = nullptr;
+  EGLImageKHR (*CreateImageKHR)(EGLDisplay,
+                                void*,
+                                EGLenum,
+                                void*,
+                                const EGLint*) = nullptr;
+  EGLBoolean (*DestroyImageKHR)(EGLDisplay, EGLImageKHR) = nullptr;
+  EGLSyncKHR (*CreateSyncKHR)(EGLDisplay, EGLenum, const EGLint*) = nullptr;
+  EGLint (*WaitSyncKHR)(EGLDisplay, EGLSyncKHR, EGLint) = nullptr;
+  EGLBoolean (*DestroySyncKHR)(EGLDisplay, EGLSyncKHR) = nullptr;
+  void (*EGLImageTargetTexture2DOES)(uint32_t, void*) = nullptr;
+  void (*GenTextures)(int32_t, uint32_t*) = nullptr;
+  void (*BindTexture)(uint32_t, uint32_t) = nullptr;
+  void (*TexParameteri)(uint32_t, uint32_t, int32_t) = nullptr;
+  void (*DeleteTextures)(int32_t, const uint32_t*) = nullptr;
+};
+
+struct EmbedderDmaBufImporter::ImportedFrame {
+  std::shared_ptr<const Procs> procs;
+  EGLDisplay display = nullptr;
+  EGLImageKHR image = nullptr;
+  uint32_t texture = 0;
+  void* user_data = nullptr;
+  VoidCallback destruction_callback = nullptr;
+};
+
+template <typename Proc>
+static bool ResolveProc(const EmbedderDmaBufImporter::ProcResolver& resolver,
+                        const char* name,
+                        Proc* proc) {
+  *proc = reinterpret_cast<Proc>(resolver(name));
+  if (*proc == nullptr) {
+    FML_LOG(ERROR) << "Could not resolve " << name
+                   << "; dma-buf textures are not supported.";
+    return false;
+  }
+  return true;
+}
+
+EmbedderDmaBufImporter::EmbedderDmaBufImporter(
+    const ProcResolver& proc_resolver) {
+  if (!proc_resolver) {
+    return;
+  }
+  auto procs = std::make_shared<Procs>();
+  const bool resolved =
+      ResolveProc(proc_resolver, "eglGetCurrentDisplay",
+                  &procs->GetCurrentDisplay) &&
+      ResolveProc(proc_resolver, "eglCreateImageKHR", &procs->CreateImageKHR) &&
+      ResolveProc(proc_resolver, "eglDestroyImageKHR",
+                  &procs->DestroyImageKHR) &&
+      ResolveProc(proc_resolver, "glEGLImageTargetTexture2DOES",
+                  &procs->EGLImageTargetTexture2DOES) &&
+      ResolveProc(proc_resolver, "glGenTextures", &procs->GenTextures) &&
+      ResolveProc(proc_resolver, "glBindTexture", &procs->BindTexture) &&
+      ResolveProc(proc_resolver, "glTexParameteri", &procs->TexParameteri) &&
+      ResolveProc(proc_resolver, "glDeleteTextures", &procs->DeleteTextures);
+  if (!resolved) {
+    return;
+  }
+  // Fences are optional. Without them, frames with acquire fences are waited
+  // on by the CPU.
+  procs->CreateSyncKHR = reinterpret_cast<decltype(procs->CreateSyncKHR)>(
+      proc_resolver("eglCreateSyncKHR"));
+  procs->WaitSyncKHR = reinterpret_cast<decltype(procs->WaitSyncKHR)>(
+      proc_resolver("eglWaitSyncKHR"));
+  procs->DestroySyncKHR = reinterpret_cast<decltype(procs->DestroySyncKHR)>(
+      proc_resolver("eglDestroySyncKHR"));
+  procs_ = std::move(procs);
+}
+
+EmbedderDmaBufImporter::~EmbedderDmaBufImporter() = default;
+
+bool EmbedderDmaBufImporter::IsValid() const {
+  return procs_ != nullptr;
+}
+
+sk_sp<SkImage> EmbedderDmaBufImporter::Import(
+    GrContext* context,
+    const FlutterDmaBufTexture& texture) {
+  auto release = [&texture]() {
+    if (texture.acquire_fence_fd >= 0) {
+      close(texture.acquire_fence_fd);
+    }
+    if (texture.destruction_callback != nullptr) {
+      texture.destruction_callback(texture.user_data);
+    }
+  };
+
+  if (!IsValid() || context == nullptr ||
+      texture.struct_size < sizeof(FlutterDmaBufTexture) ||
+      texture.width == 0 || texture.height == 0 || texture.num_planes == 0 ||
+      texture.num_planes > FLUTTER_DMA_BUF_MAX_PLANES) {
+    FML_LOG(ERROR) << "Invalid dma-buf texture.";
+    release();
+    return nullptr;
+  }
+
+  EGLDisplay display = procs_->GetCurrentDisplay();
+  if (display == nullptr) {
+    FML_LOG(ERROR) << "No current EGL display to import a dma-buf texture on.";
+    release();
+    return nullptr;
+  }
+
+  std::vector<EGLint> attributes = {
+      kEGLWidth,  static_cast<EGLint>(texture.width),
+      kEGLHeight, static_cast<EGLint>(texture.height),
+      kEGLLinuxDrmFourccEXT, static_cast<EGLint>(texture.fourcc),
+  };
+  for (size_t i = 0; i < texture.num_planes; ++i) {
+    const auto& plane = texture.planes[i];
+    const auto& names = kPlaneAttributes[i];
+    attributes.insert(attributes.end(),
+                      {names.fd, plane.fd, names.offset,
+                       static_cast<EGLint>(plane.offset), names.pitch,
+                       static_cast<EGLint>(plane.stride)});
+    if (texture.modifier != kDrmFormatModInvalid) {
+      attributes.insert(
+          attributes.end(),
+          {names.modifier_lo,
+           static_cast<EGLint>(texture.modifier & 0xffffffff),
+           names.modifier_hi, static_cast<EGLint>(texture.modifier >> 32)});
+    }
+  }
+  attributes.push_back(kEGLNone);
+
+  EGLImageKHR image = procs_->CreateImageKHR(
+      display, nullptr, kEGLLinuxDmaBufEXT, nullptr, attributes.data());
+  if (image == nullptr) {
+    FML_LOG(ERROR) << "Could not create an EGL image from a dma-buf texture.";
+    release();
+    return nullptr;
+  }
+
+  if (!WaitForFence(display, texture.acquire_fence_fd)) {
+    FML_LOG(ERROR) << "Could not wait for the fence of a dma-buf texture.";
+  }
+
+  uint32_t texture_name = 0;
+  procs_->GenTextures(1, &texture_name);
+  procs_->BindTexture(kGLTextureExternalOES, texture_name);
+  procs_->TexParameteri(kGLTextureExternalOES, kGLTextureMinFilter, kGLLinear);
+  procs_->TexParameteri(kGLTextureExternalOES, kGLTextureMagFilter, kGLLinear);
+  procs_->EGLImageTargetTexture2DOES(kGLTextureExternalOES, image);
+  // Skia tracks the bound texture, which was changed behind its back.
+  context->resetContext(kTextureBinding_GrGLBackendState);
+
+  auto frame = new ImportedFrame{procs_,
+                                 display,
+                                 image,
+                                 texture_name,
+                                 texture.user_data,
+                                 texture.destruction_callback};
+
+  GrGLTextureInfo texture_info = {kGLTextureExternalOES, texture_name,
+                                  kGLRGBA8};
+  GrBackendTexture backend_texture(texture.width, texture.height,
+                                   GrMipMapped::kNo, texture_info);
+  auto image = SkImage::MakeFromTexture(
+      context,                   // context
+      backend_texture,           // texture handle
+      kTopLeft_GrSurfaceOrigin,  // origin
+      kRGBA_8888_SkColorType,    // color type
+      kPremul_SkAlphaType,       // alpha type
+      nullptr,                   // colorspace
+      &ReleaseFrame,             // texture release proc
+      frame                      // texture release context
+  );
+  if (!image) {
+    // In case Skia rejects the image, release the frame so that the embedder
+    // may reuse it.
+    FML_LOG(ERROR) << "Could not create an image from a dma-buf texture.";
+    ReleaseFrame(frame);
+    return nullptr;
+  }
+  return image;
+}
+
+bool EmbedderDmaBufImporter::WaitForFence(void* display, int fence_fd) const {
+  if (fence_fd < 0) {
+    return true;
+  }
+  if (procs_->CreateSyncKHR != nullptr && procs_->WaitSyncKHR != nullptr &&
+      procs_->DestroySyncKHR != nullptr) {
+    const EGLint attributes[] = {kEGLSyncNativeFenceFdAndroid, fence_fd,
+                                 kEGLNone};
+    // The sync takes ownership of the fence once it is created.
+    EGLSyncKHR sync = procs_->CreateSyncKHR(
+        display, kEGLSyncNativeFenceAndroid, attributes);
+    if (sync != nullptr) {
+      const bool waited = procs_->WaitSyncKHR(display, sync, 0) != 0;
+      procs_->DestroySyncKHR(display, sync);
+      return waited;
+    }
+  }
+  // Without native fence syncs, the CPU waits for the sync file to signal.
+  pollfd poll_fd = {fence_fd, POLLIN, 0};
+  int result;
+  do {
+    result = poll(&poll_fd, 1, -1);
+  } while (result < 0 && errno == EINTR);
+  close(fence_fd);
+  return result > 0;
+}
+
+void EmbedderDmaBufImporter::ReleaseFrame(void* context) {
+  auto frame = static_cast<ImportedFrame*>(context);
+  frame->procs->DeleteTextures(1, &frame->texture);
+  frame->procs->DestroyImageKHR(frame->display, frame->image);
+  if (frame->destruction_callback != nullptr) {
+    frame->destruction_callback(frame->user_data);
+  }
+  delete frame;
+}
+
+}  // namespace flutter
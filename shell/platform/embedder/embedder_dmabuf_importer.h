@@ -0,0 +1,77 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_DMABUF_IMPORTER_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_DMABUF_IMPORTER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/platform/embedder/embedder.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Wraps dma-buf frames of external textures in Skia images
+///             without copying them. Each frame is imported as an EGLImage
+///             that backs a GL_TEXTURE_EXTERNAL_OES texture, so the GPU
+///             samples the memory the frame was produced in, and converts YUV
+///             formats while doing so.
+///
+///             Frames are imported on the raster thread with the onscreen
+///             context current.
+///
+class EmbedderDmaBufImporter {
+ public:
+  using ProcResolver = std::function<void*(const char*)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves the EGL and GL functions needed to import frames.
+  ///
+  /// @param[in]  proc_resolver  Resolves EGL and GL functions by name.
+  ///
+  explicit EmbedderDmaBufImporter(const ProcResolver& proc_resolver);
+
+  ~EmbedderDmaBufImporter();
+
+  //----------------------------------------------------------------------------
+  /// @return     Whether all the functions needed to import frames were
+  ///             resolved.
+  ///
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Imports a frame. The destruction callback of the frame is
+  ///             invoked once the image is collected, or right away if the
+  ///             frame could not be imported.
+  ///
+  /// @param[in]  context  The context of the onscreen surface.
+  /// @param[in]  texture  The frame, which is taken ownership of.
+  ///
+  /// @return     The image of the frame, or null if it could not be imported.
+  ///
+  sk_sp<SkImage> Import(GrContext* context, const FlutterDmaBufTexture& texture);
+
+ private:
+  struct Procs;
+  struct ImportedFrame;
+
+  std::shared_ptr<const Procs> procs_;
+
+  // Makes the GPU wait for the producer of a frame to signal |fence_fd|, which
+  // is taken ownership of.
+  bool WaitForFence(void* display, int fence_fd) const;
+
+  static void ReleaseFrame(void* context);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderDmaBufImporter);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_DMABUF_IMPORTER_H_
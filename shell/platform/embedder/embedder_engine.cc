@@ -143,6 +143,20 @@ bool EmbedderEngine::SendPlatformMessage(
   return true;
 }
 
+bool EmbedderEngine::DispatchEventBatch(flutter::PlatformEventBatch batch) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  auto platform_view = shell_->GetPlatformView();
+  if (!platform_view) {
+    return false;
+  }
+
+  platform_view->DispatchEventBatch(std::move(batch));
+  return true;
+}
+
 bool EmbedderEngine::RegisterTexture(int64_t texture) {
   if (!IsValid() || !external_texture_callback_) {
     return false;
@@ -182,6 +196,19 @@ bool EmbedderEngine::SetSemanticsEnabled(bool enabled) {
   return true;
 }
 
+bool EmbedderEngine::SetSemanticsClientActive(bool active) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  auto platform_view = shell_->GetPlatformView();
+  if (!platform_view) {
+    return false;
+  }
+  platform_view->SetSemanticsClientActive(active);
+  return true;
+}
+
 bool EmbedderEngine::SetAccessibilityFeatures(int32_t flags) {
   if (!IsValid()) {
     return false;
@@ -210,13 +237,14 @@ bool EmbedderEngine::DispatchSemanticsAction(int id,
 
 bool EmbedderEngine::OnVsyncEvent(intptr_t baton,
                                   fml::TimePoint frame_start_time,
-                                  fml::TimePoint frame_target_time) {
+                                  fml::TimePoint frame_target_time,
+                                  float display_refresh_rate) {
   if (!IsValid()) {
     return false;
   }
 
-  return VsyncWaiterEmbedder::OnEmbedderVsync(baton, frame_start_time,
-                                              frame_target_time);
+  return VsyncWaiterEmbedder::OnEmbedderVsync(
+      baton, frame_start_time, frame_target_time, display_refresh_rate);
 }
 
 bool EmbedderEngine::ReloadSystemFonts() {
@@ -236,6 +264,29 @@ bool EmbedderEngine::PostRenderThreadTask(const fml::closure& task) {
   return true;
 }
 
+bool EmbedderEngine::RasterizeLastFrame(
+    std::vector<Rasterizer::OffscreenRasterJob> jobs) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  shell_->GetTaskRunners().GetRasterTaskRunner()->PostTask(fml::MakeCopyable(
+      [rasterizer = shell_->GetRasterizer(),
+       worker_task_runner =
+           shell_->GetDartVM()->GetConcurrentWorkerTaskRunner(),
+       jobs = std::move(jobs)]() mutable {
+        if (!rasterizer) {
+          for (const auto& job : jobs) {
+            job.callback(false);
+          }
+          return;
+        }
+        rasterizer->RasterizeLastLayerTree(std::move(jobs),
+                                           std::move(worker_task_runner));
+      }));
+  return true;
+}
+
 bool EmbedderEngine::RunTask(const FlutterTask* task) {
   // The shell doesn't need to be running or valid for access to the thread
   // host. This is why there is no `IsValid` check here. This allows embedders
@@ -280,4 +331,14 @@ Shell& EmbedderEngine::GetShell() {
   return *shell_.get();
 }
 
+fml::RefPtr<fml::TaskRunner>
+EmbedderEngine::GetPlatformMessageHandlerTaskRunner() {
+  std::scoped_lock lock(platform_message_thread_mutex_);
+  if (!platform_message_thread_) {
+    platform_message_thread_ =
+        std::make_unique<fml::Thread>("io.flutter.platform_messages");
+  }
+  return platform_message_thread_->GetTaskRunner();
+}
+
 }  // namespace flutter
@@ -6,9 +6,11 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_ENGINE_H_
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -56,6 +58,8 @@ class EmbedderEngine {
 
   bool SendPlatformMessage(fml::RefPtr<flutter::PlatformMessage> message);
 
+  bool DispatchEventBatch(flutter::PlatformEventBatch batch);
+
   bool RegisterTexture(int64_t texture);
 
   bool UnregisterTexture(int64_t texture);
@@ -64,6 +68,8 @@ class EmbedderEngine {
 
   bool SetSemanticsEnabled(bool enabled);
 
+  bool SetSemanticsClientActive(bool active);
+
   bool SetAccessibilityFeatures(int32_t flags);
 
   bool DispatchSemanticsAction(int id,
@@ -72,12 +78,17 @@ class EmbedderEngine {
 
   bool OnVsyncEvent(intptr_t baton,
                     fml::TimePoint frame_start_time,
-                    fml::TimePoint frame_target_time);
+                    fml::TimePoint frame_target_time,
+                    float display_refresh_rate);
 
   bool ReloadSystemFonts();
 
   bool PostRenderThreadTask(const fml::closure& task);
 
+  // Rasterizes the last frame into the buffers of |jobs|, in parallel on the
+  // concurrent workers of the VM.
+  bool RasterizeLastFrame(std::vector<Rasterizer::OffscreenRasterJob> jobs);
+
   bool RunTask(const FlutterTask* task);
 
   bool PostTaskOnEngineManagedNativeThreads(
@@ -85,11 +96,18 @@ class EmbedderEngine {
 
   Shell& GetShell();
 
+  // Returns the task runner of the thread that background platform message
+  // callbacks are called on, starting the thread on first use.
+  fml::RefPtr<fml::TaskRunner> GetPlatformMessageHandlerTaskRunner();
+
  private:
   const std::unique_ptr<EmbedderThreadHost> thread_host_;
   TaskRunners task_runners_;
   RunConfiguration run_configuration_;
   std::unique_ptr<ShellArgs> shell_args_;
+  // Outlives the shell, which posts messages to it.
+  std::mutex platform_message_thread_mutex_;
+  std::unique_ptr<fml::Thread> platform_message_thread_;
   std::unique_ptr<Shell> shell_;
   const EmbedderExternalTextureGL::ExternalTextureCallback
       external_texture_callback_;
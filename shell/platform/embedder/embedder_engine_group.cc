@@ -0,0 +1,67 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_engine_group.h"
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+EmbedderEngineGroup::EmbedderEngineGroup(size_t resource_cache_max_bytes)
+    : resource_cache_max_bytes_(resource_cache_max_bytes),
+      raster_thread_({"io.flutter.group.raster",
+                      fml::Thread::ThreadPriority::kDisplay}) {}
+
+EmbedderEngineGroup::~EmbedderEngineGroup() {
+  // All the engines of the group have shut down, so nothing renders with the
+  // context anymore. Release it on the raster thread all the same, so that
+  // Skia's thread checks hold for engines that rendered there.
+  fml::AutoResetWaitableEvent latch;
+  raster_thread_.GetTaskRunner()->PostTask([&]() {
+    if (gr_context_ && abandon_on_destruction_) {
+      gr_context_->abandonContext();
+    }
+    gr_context_ = nullptr;
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+fml::RefPtr<fml::TaskRunner> EmbedderEngineGroup::GetRasterTaskRunner() const {
+  return raster_thread_.GetTaskRunner();
+}
+
+size_t EmbedderEngineGroup::GetResourceCacheMaxBytes() const {
+  return resource_cache_max_bytes_;
+}
+
+sk_sp<GrContext> EmbedderEngineGroup::GetOrCreateGrContext(
+    const std::function<sk_sp<GrContext>()>& create,
+    bool abandon_on_destruction) {
+  std::scoped_lock lock(mutex_);
+  if (gr_context_) {
+    return gr_context_;
+  }
+
+  TRACE_EVENT0("flutter", "EmbedderEngineGroup::CreateGrContext");
+  gr_context_ = create();
+  abandon_on_destruction_ = abandon_on_destruction;
+  if (gr_context_ && resource_cache_max_bytes_ > 0) {
+    int max_resources;
+    gr_context_->getResourceCacheLimits(&max_resources, nullptr);
+    gr_context_->setResourceCacheLimits(max_resources,
+                                        resource_cache_max_bytes_);
+  }
+  return gr_context_;
+}
+
+bool EmbedderEngineGroup::SwitchGrContextUser(const void* user) {
+  std::scoped_lock lock(mutex_);
+  const bool switched = last_user_ != nullptr && last_user_ != user;
+  last_user_ = user;
+  return switched;
+}
+
+}  // namespace flutter
@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_ENGINE_GROUP_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_ENGINE_GROUP_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      The state shared by the engines of a `FlutterEngineGroup`: the
+///             raster thread of the engines that don't supply their own render
+///             task runner, and the Skia context that their surfaces render
+///             with, along with its resource cache. Each engine still has its
+///             own surfaces and raster cache.
+///
+///             Engines and their surfaces keep the group alive, so it is only
+///             destroyed once the embedder collected it and all of its engines
+///             have shut down.
+///
+class EmbedderEngineGroup {
+ public:
+  //----------------------------------------------------------------------------
+  /// @param[in]  resource_cache_max_bytes  The budget of the resource cache of
+  ///                                       the shared Skia context, or zero to
+  ///                                       let the engines size it to their
+  ///                                       viewports.
+  ///
+  explicit EmbedderEngineGroup(size_t resource_cache_max_bytes);
+
+  ~EmbedderEngineGroup();
+
+  //----------------------------------------------------------------------------
+  /// @return     The task runner of the raster thread shared by the engines of
+  ///             the group.
+  ///
+  fml::RefPtr<fml::TaskRunner> GetRasterTaskRunner() const;
+
+  size_t GetResourceCacheMaxBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the Skia context shared by the engines of the group,
+  ///             creating it with `create` if this is the first engine to ask.
+  ///             A null context from `create` isn't kept, so the next engine
+  ///             tries again.
+  ///
+  /// @param[in]  create          Creates the context. It is called with the
+  ///                             lock of the group held.
+  /// @param[in]  abandon_on_destruction
+  ///                             Whether the context must be abandoned
+  ///                             instead of releasing its resources when the
+  ///                             group is destroyed, for OpenGL contexts that
+  ///                             may not be current then.
+  ///
+  sk_sp<GrContext> GetOrCreateGrContext(
+      const std::function<sk_sp<GrContext>()>& create,
+      bool abandon_on_destruction);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records that the engine identified by `user` is about to
+  ///             render with the shared context.
+  ///
+  /// @return     Whether another engine rendered with it last, in which case
+  ///             the GPU state Skia assumes may be stale.
+  ///
+  bool SwitchGrContextUser(const void* user);
+
+ private:
+  const size_t resource_cache_max_bytes_;
+  fml::Thread raster_thread_;
+  std::mutex mutex_;
+  sk_sp<GrContext> gr_context_;
+  bool abandon_on_destruction_ = false;
+  const void* last_user_ = nullptr;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngineGroup);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_ENGINE_GROUP_H_
@@ -23,12 +23,20 @@ void EmbedderExternalTextureGL::Paint(SkCanvas& canvas,
                                       bool freeze,
                                       GrContext* context,
                                       SkFilterQuality filter_quality) {
-  if (auto image = external_texture_callback_(
-          Id(),                                           //
-          canvas.getGrContext(),                          //
-          SkISize::Make(bounds.width(), bounds.height())  //
-          )) {
-    last_image_ = image;
+  // Only ask the embedder for a new image when it marked a new frame
+  // available, or when the last image cannot be reused.
+  const SkISize size = SkISize::Make(bounds.width(), bounds.height());
+  if ((!freeze && new_frame_ready_) || !last_image_ ||
+      size != last_image_size_) {
+    if (auto image = external_texture_callback_(
+            Id(),                   //
+            canvas.getGrContext(),  //
+            size                    //
+            )) {
+      last_image_ = image;
+      last_image_size_ = size;
+      new_frame_ready_ = false;
+    }
   }
 
   if (last_image_) {
@@ -46,10 +54,15 @@ void EmbedderExternalTextureGL::Paint(SkCanvas& canvas,
 void EmbedderExternalTextureGL::OnGrContextCreated() {}
 
 // |flutter::Texture|
-void EmbedderExternalTextureGL::OnGrContextDestroyed() {}
+void EmbedderExternalTextureGL::OnGrContextDestroyed() {
+  // The image belongs to the destroyed context.
+  last_image_.reset();
+}
 
 // |flutter::Texture|
-void EmbedderExternalTextureGL::MarkNewFrameAvailable() {}
+void EmbedderExternalTextureGL::MarkNewFrameAvailable() {
+  new_frame_ready_ = true;
+}
 
 // |flutter::Texture|
 void EmbedderExternalTextureGL::OnTextureUnregistered() {}
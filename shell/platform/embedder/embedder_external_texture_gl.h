@@ -25,6 +25,8 @@ class EmbedderExternalTextureGL : public flutter::Texture {
  private:
   ExternalTextureCallback external_texture_callback_;
   sk_sp<SkImage> last_image_;
+  SkISize last_image_size_ = SkISize::MakeEmpty();
+  bool new_frame_ready_ = false;
 
   // |flutter::Texture|
   void Paint(SkCanvas& canvas,
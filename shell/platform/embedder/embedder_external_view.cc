@@ -88,8 +88,10 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
     return false;
   }
 
-  FML_DCHECK(SkISize::Make(surface->width(), surface->height()) ==
-             render_surface_size_);
+  // The render target may have been rounded up to a larger size, in which case
+  // the contents are drawn into its top left.
+  FML_DCHECK(surface->width() >= render_surface_size_.width() &&
+             surface->height() >= render_surface_size_.height());
 
   auto canvas = surface->getCanvas();
   if (!canvas) {
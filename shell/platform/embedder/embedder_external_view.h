@@ -10,6 +10,7 @@
 #include <unordered_set>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/fml/hash.h"
 #include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/canvas_spy.h"
@@ -57,9 +58,11 @@ class EmbedderExternalView {
     struct Hash {
       constexpr std::size_t operator()(
           const RenderTargetDescriptor& desc) const {
-        return fml::HashCombine(desc.surface_size.width(),
-                                desc.surface_size.height(),
-                                ViewIdentifier::Hash{}(desc.view_identifier));
+        const uint64_t hash = fml::HashMix(
+            ViewIdentifier::Hash{}(desc.view_identifier),
+            static_cast<uint64_t>(desc.surface_size.width()));
+        return static_cast<std::size_t>(fml::HashMix(
+            hash, static_cast<uint64_t>(desc.surface_size.height())));
       }
     };
 
@@ -14,9 +14,11 @@ namespace flutter {
 
 EmbedderExternalViewEmbedder::EmbedderExternalViewEmbedder(
     const CreateRenderTargetCallback& create_render_target_callback,
-    const PresentCallback& present_callback)
+    const PresentCallback& present_callback,
+    const EmbedderRenderTargetCache::Config& render_target_cache_config)
     : create_render_target_callback_(create_render_target_callback),
-      present_callback_(present_callback) {
+      present_callback_(present_callback),
+      render_target_cache_(render_target_cache_config) {
   FML_DCHECK(create_render_target_callback_);
   FML_DCHECK(present_callback_);
 }
@@ -28,6 +30,11 @@ void EmbedderExternalViewEmbedder::SetSurfaceTransformationCallback(
   surface_transformation_callback_ = surface_transformation_callback;
 }
 
+void EmbedderExternalViewEmbedder::SetRenderTargetCacheStatsCallback(
+    RenderTargetCacheStatsCallback render_target_cache_stats_callback) {
+  render_target_cache_stats_callback_ = render_target_cache_stats_callback;
+}
+
 SkMatrix EmbedderExternalViewEmbedder::GetSurfaceTransformation() const {
   if (!surface_transformation_callback_) {
     return SkMatrix{};
@@ -142,7 +149,7 @@ bool EmbedderExternalViewEmbedder::SubmitFrame(
   // OpenGL context.
   //
   // For optimum performance, we should tell the render target cache to clear
-  // its unused entries before allocating new ones. This collection step before
+  // its stale entries before allocating new ones. This collection step before
   // allocating new render targets ameliorates peak memory usage within the
   // frame. But, this causes an issue in a known internal embedder. To work
   // around this issue while that embedder migrates, collection of render
@@ -150,7 +157,7 @@ bool EmbedderExternalViewEmbedder::SubmitFrame(
   //
   // @warning: Embedder may trample on our OpenGL context here.
   auto deferred_cleanup_render_targets =
-      render_target_cache_.ClearAllRenderTargetsInCache();
+      render_target_cache_.ClearStaleRenderTargetsInCache();
 
   for (const auto& pending_key : pending_keys) {
     const auto& external_view = pending_views_.at(pending_key);
@@ -169,10 +176,14 @@ bool EmbedderExternalViewEmbedder::SubmitFrame(
     // it so that embedder rendered into surfaces that aren't full screen,
     // this assumption will break. So it's just best to ask view for its size
     // directly.
-    const auto render_surface_size = external_view->GetRenderSurfaceSize();
+    //
+    // The render target cache may round this size up, so that the render
+    // target can be reused for views of similar sizes.
+    const auto render_target_size = render_target_cache_.GetRenderTargetSize(
+        external_view->GetRenderSurfaceSize());
 
     const auto backing_store_config =
-        MakeBackingStoreConfig(render_surface_size);
+        MakeBackingStoreConfig(render_target_size);
 
     // This is where the embedder will create render targets for us. Control
     // flow to the embedder makes the engine susceptible to having the embedder
@@ -259,11 +270,14 @@ bool EmbedderExternalViewEmbedder::SubmitFrame(
   // @warning: Embedder may trample on our OpenGL context here.
   deferred_cleanup_render_targets.clear();
 
-  // Hold all rendered layers in the render target cache for one frame to
-  // see if they may be reused next frame.
+  // Hold all rendered layers in the render target cache to see if they may be
+  // reused by the next frames.
   for (auto& render_target : matched_render_targets) {
-    render_target_cache_.CacheRenderTarget(render_target.first,
-                                           std::move(render_target.second));
+    render_target_cache_.CacheRenderTarget(std::move(render_target.second));
+  }
+
+  if (render_target_cache_stats_callback_) {
+    render_target_cache_stats_callback_(render_target_cache_.GetStats());
   }
 
   return frame->Submit();
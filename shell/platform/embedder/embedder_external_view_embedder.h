@@ -35,6 +35,8 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   using PresentCallback =
       std::function<bool(const std::vector<const FlutterLayer*>& layers)>;
   using SurfaceTransformationCallback = std::function<SkMatrix(void)>;
+  using RenderTargetCacheStatsCallback =
+      std::function<void(const EmbedderRenderTargetCache::Stats& stats)>;
 
   //----------------------------------------------------------------------------
   /// @brief      Creates an external view embedder used by the generic embedder
@@ -47,10 +49,15 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   ///                                     collection of layers (backed by
   ///                                     fulfilled render targets) to the
   ///                                     embedder for presentation.
+  /// @param[in]  render_target_cache_config
+  ///                                     How render targets are kept for
+  ///                                     reuse by later frames.
   ///
   EmbedderExternalViewEmbedder(
       const CreateRenderTargetCallback& create_render_target_callback,
-      const PresentCallback& present_callback);
+      const PresentCallback& present_callback,
+      const EmbedderRenderTargetCache::Config& render_target_cache_config =
+          EmbedderRenderTargetCache::Config{});
 
   //----------------------------------------------------------------------------
   /// @brief      Collects the external view embedder.
@@ -68,6 +75,15 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   void SetSurfaceTransformationCallback(
       SurfaceTransformationCallback surface_transformation_callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the callback that is given the statistics of the render
+  ///             target cache after each frame is submitted.
+  ///
+  /// @param[in]  render_target_cache_stats_callback  The statistics callback
+  ///
+  void SetRenderTargetCacheStatsCallback(
+      RenderTargetCacheStatsCallback render_target_cache_stats_callback);
+
  private:
   // |ExternalViewEmbedder|
   void CancelFrame() override;
@@ -101,6 +117,7 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   const CreateRenderTargetCallback create_render_target_callback_;
   const PresentCallback present_callback_;
   SurfaceTransformationCallback surface_transformation_callback_;
+  RenderTargetCacheStatsCallback render_target_cache_stats_callback_;
   SkISize pending_frame_size_ = SkISize::Make(0, 0);
   double pending_device_pixel_ratio_ = 1.0;
   SkMatrix pending_surface_transformation_;
@@ -4,16 +4,48 @@
 
 #include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace flutter {
 
-EmbedderRenderTargetCache::EmbedderRenderTargetCache() = default;
+static int32_t RoundUpToGranularity(int32_t value, int32_t granularity) {
+  if (granularity <= 1) {
+    return value;
+  }
+  return (value + granularity - 1) / granularity * granularity;
+}
+
+// Estimates the memory of a render target from its size, assuming four bytes
+// per pixel.
+static size_t GetRenderTargetBytes(const SkISize& size) {
+  return static_cast<size_t>(size.width()) * size.height() * 4;
+}
+
+EmbedderRenderTargetCache::EmbedderRenderTargetCache()
+    : EmbedderRenderTargetCache(Config{}) {}
+
+EmbedderRenderTargetCache::EmbedderRenderTargetCache(const Config& config)
+    : config_(config) {}
 
 EmbedderRenderTargetCache::~EmbedderRenderTargetCache() = default;
 
+SkISize EmbedderRenderTargetCache::GetRenderTargetSize(
+    const SkISize& render_surface_size) const {
+  return SkISize::Make(
+      RoundUpToGranularity(render_surface_size.width(),
+                           config_.size_granularity),
+      RoundUpToGranularity(render_surface_size.height(),
+                           config_.size_granularity));
+}
+
 std::pair<EmbedderRenderTargetCache::RenderTargets,
           EmbedderExternalView::ViewIdentifierSet>
 EmbedderRenderTargetCache::GetExistingTargetsInCache(
     const EmbedderExternalView::PendingViews& pending_views) {
+  frame_++;
+  frame_stats_ = {};
+
   RenderTargets resolved_render_targets;
   EmbedderExternalView::ViewIdentifierSet unmatched_identifiers;
 
@@ -22,44 +54,94 @@ EmbedderRenderTargetCache::GetExistingTargetsInCache(
     if (!external_view->HasEngineRenderedContents()) {
       continue;
     }
-    auto& compatible_targets =
-        cached_render_targets_[external_view->CreateRenderTargetDescriptor()];
-    if (compatible_targets.size() == 0) {
+    auto found = cached_render_targets_.find(
+        GetRenderTargetSize(external_view->GetRenderSurfaceSize()));
+    if (found == cached_render_targets_.end() || found->second.empty()) {
       unmatched_identifiers.insert(view.first);
+      frame_stats_.miss_count++;
     } else {
-      std::unique_ptr<EmbedderRenderTarget> target =
-          std::move(compatible_targets.top());
-      compatible_targets.pop();
-      resolved_render_targets[view.first] = std::move(target);
+      // Reuse the most recently used target, so that the others age out.
+      auto& compatible_targets = found->second;
+      cached_bytes_ -= compatible_targets.back().bytes;
+      resolved_render_targets[view.first] =
+          std::move(compatible_targets.back().target);
+      compatible_targets.pop_back();
+      frame_stats_.hit_count++;
     }
   }
   return {std::move(resolved_render_targets), std::move(unmatched_identifiers)};
 }
 
+std::set<std::unique_ptr<EmbedderRenderTarget>>
+EmbedderRenderTargetCache::ClearStaleRenderTargetsInCache() {
+  std::set<std::unique_ptr<EmbedderRenderTarget>> cleared_targets;
+
+  for (auto it = cached_render_targets_.begin();
+       it != cached_render_targets_.end();) {
+    auto& targets = it->second;
+    auto fresh = std::remove_if(
+        targets.begin(), targets.end(), [&](CachedRenderTarget& cached) {
+          if (frame_ - cached.last_used_frame < config_.max_unused_frames) {
+            return false;
+          }
+          cached_bytes_ -= cached.bytes;
+          cleared_targets.emplace(std::move(cached.target));
+          return true;
+        });
+    targets.erase(fresh, targets.end());
+    it = targets.empty() ? cached_render_targets_.erase(it) : std::next(it);
+  }
+
+  while (config_.max_bytes != 0 && cached_bytes_ > config_.max_bytes) {
+    // The targets of each size are ordered by use, so the least recently used
+    // target is at the front of one of them.
+    auto oldest = cached_render_targets_.end();
+    for (auto it = cached_render_targets_.begin();
+         it != cached_render_targets_.end(); ++it) {
+      if (oldest == cached_render_targets_.end() ||
+          it->second.front().last_used_frame <
+              oldest->second.front().last_used_frame) {
+        oldest = it;
+      }
+    }
+    auto& targets = oldest->second;
+    cached_bytes_ -= targets.front().bytes;
+    cleared_targets.emplace(std::move(targets.front().target));
+    targets.erase(targets.begin());
+    if (targets.empty()) {
+      cached_render_targets_.erase(oldest);
+    }
+  }
+
+  frame_stats_.evicted_count += cleared_targets.size();
+  return cleared_targets;
+}
+
 std::set<std::unique_ptr<EmbedderRenderTarget>>
 EmbedderRenderTargetCache::ClearAllRenderTargetsInCache() {
   std::set<std::unique_ptr<EmbedderRenderTarget>> cleared_targets;
   for (auto& targets : cached_render_targets_) {
-    auto& targets_stack = targets.second;
-    while (!targets_stack.empty()) {
-      cleared_targets.emplace(std::move(targets_stack.top()));
-      targets_stack.pop();
+    for (auto& cached : targets.second) {
+      cleared_targets.emplace(std::move(cached.target));
     }
   }
   cached_render_targets_.clear();
+  cached_bytes_ = 0;
+  frame_stats_.evicted_count += cleared_targets.size();
   return cleared_targets;
 }
 
 void EmbedderRenderTargetCache::CacheRenderTarget(
-    EmbedderExternalView::ViewIdentifier view_identifier,
     std::unique_ptr<EmbedderRenderTarget> target) {
   if (target == nullptr) {
     return;
   }
   auto surface = target->GetRenderSurface();
-  auto desc = EmbedderExternalView::RenderTargetDescriptor{
-      view_identifier, SkISize::Make(surface->width(), surface->height())};
-  cached_render_targets_[desc].push(std::move(target));
+  const auto size = SkISize::Make(surface->width(), surface->height());
+  const size_t bytes = GetRenderTargetBytes(size);
+  cached_bytes_ += bytes;
+  cached_render_targets_[size].push_back(
+      CachedRenderTarget{std::move(target), bytes, frame_});
 }
 
 size_t EmbedderRenderTargetCache::GetCachedTargetsCount() const {
@@ -70,4 +152,11 @@ size_t EmbedderRenderTargetCache::GetCachedTargetsCount() const {
   return count;
 }
 
+EmbedderRenderTargetCache::Stats EmbedderRenderTargetCache::GetStats() const {
+  Stats stats = frame_stats_;
+  stats.cached_count = GetCachedTargetsCount();
+  stats.cached_bytes = cached_bytes_;
+  return stats;
+}
+
 }  // namespace flutter
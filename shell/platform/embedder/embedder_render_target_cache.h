@@ -6,10 +6,11 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_CACHE_H_
 
 #include <set>
-#include <stack>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
+#include "flutter/fml/flat_hash_map.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/platform/embedder/embedder_external_view.h"
 
@@ -19,10 +20,44 @@ namespace flutter {
 /// @brief      A cache used to reference render targets that are owned by the
 ///             embedder but needed by th engine to render a frame.
 ///
+///             Render targets are pooled by size rather than by the view they
+///             were last used for, so a change in the number of platform views
+///             doesn't need new render targets. Sizes may be rounded up to a
+///             bucket so that small size changes, like those of a window being
+///             resized, reuse render targets too. Unused render targets are
+///             kept for a few frames within a byte budget.
+///
 class EmbedderRenderTargetCache {
  public:
+  struct Config {
+    /// The number of frames a render target may go unused before it is
+    /// collected. The default of one only keeps the render targets of the
+    /// last frame.
+    size_t max_unused_frames = 1;
+    /// The most bytes of unused render targets to keep, or zero for no limit.
+    size_t max_bytes = 0;
+    /// The granularity, in pixels, that render target sizes are rounded up
+    /// to. Zero or one keeps exact sizes.
+    int32_t size_granularity = 0;
+  };
+
+  struct Stats {
+    /// The render targets of the last frame that came from the cache.
+    size_t hit_count = 0;
+    /// The render targets of the last frame that had to be created.
+    size_t miss_count = 0;
+    /// The render targets collected by the last frame.
+    size_t evicted_count = 0;
+    /// The render targets in the cache.
+    size_t cached_count = 0;
+    /// The estimated size of the render targets in the cache.
+    size_t cached_bytes = 0;
+  };
+
   EmbedderRenderTargetCache();
 
+  explicit EmbedderRenderTargetCache(const Config& config);
+
   ~EmbedderRenderTargetCache();
 
   using RenderTargets =
@@ -31,26 +66,74 @@ class EmbedderRenderTargetCache {
                          EmbedderExternalView::ViewIdentifier::Hash,
                          EmbedderExternalView::ViewIdentifier::Equal>;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the size of the render target to create for a view that
+  ///             renders into a surface of the given size.
+  ///
+  SkISize GetRenderTargetSize(const SkISize& render_surface_size) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Takes cached render targets for the views with engine
+  ///             rendered contents and starts a new frame.
+  ///
+  /// @return     The render targets found, and the views with engine rendered
+  ///             contents that none could be found for.
+  ///
   std::pair<RenderTargets, EmbedderExternalView::ViewIdentifierSet>
   GetExistingTargetsInCache(
       const EmbedderExternalView::PendingViews& pending_views);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Removes the render targets that have gone unused for too
+  ///             long, then the least recently used ones while the cache is
+  ///             over budget.
+  ///
+  /// @return     The removed render targets, which the caller collects.
+  ///
+  std::set<std::unique_ptr<EmbedderRenderTarget>>
+  ClearStaleRenderTargetsInCache();
+
   std::set<std::unique_ptr<EmbedderRenderTarget>>
   ClearAllRenderTargetsInCache();
 
-  void CacheRenderTarget(EmbedderExternalView::ViewIdentifier view_identifier,
-                         std::unique_ptr<EmbedderRenderTarget> target);
+  void CacheRenderTarget(std::unique_ptr<EmbedderRenderTarget> target);
 
   size_t GetCachedTargetsCount() const;
 
- private:
-  using CachedRenderTargets =
-      std::unordered_map<EmbedderExternalView::RenderTargetDescriptor,
-                         std::stack<std::unique_ptr<EmbedderRenderTarget>>,
-                         EmbedderExternalView::RenderTargetDescriptor::Hash,
-                         EmbedderExternalView::RenderTargetDescriptor::Equal>;
+  Stats GetStats() const;
 
+ private:
+  struct CachedRenderTarget {
+    std::unique_ptr<EmbedderRenderTarget> target;
+    size_t bytes = 0;
+    uint64_t last_used_frame = 0;
+  };
+
+  struct SizeHash {
+    std::size_t operator()(const SkISize& size) const {
+      return static_cast<std::size_t>(
+          fml::HashMix(static_cast<uint64_t>(size.width()),
+                       static_cast<uint64_t>(size.height())));
+    }
+  };
+
+  struct SizeEqual {
+    bool operator()(const SkISize& lhs, const SkISize& rhs) const {
+      return lhs == rhs;
+    }
+  };
+
+  // The render targets of each size, least recently used first.
+  using CachedRenderTargets = fml::FlatHashMap<SkISize,
+                                               std::vector<CachedRenderTarget>,
+                                               SizeHash,
+                                               SizeEqual>;
+
+  const Config config_;
   CachedRenderTargets cached_render_targets_;
+  uint64_t frame_ = 0;
+  size_t cached_bytes_ = 0;
+  Stats frame_stats_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderRenderTargetCache);
 };
@@ -11,15 +11,18 @@ namespace flutter {
 EmbedderSurfaceGL::EmbedderSurfaceGL(
     GLDispatchTable gl_dispatch_table,
     bool fbo_reset_after_present,
-    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<EmbedderEngineGroup> engine_group)
     : gl_dispatch_table_(gl_dispatch_table),
       fbo_reset_after_present_(fbo_reset_after_present),
-      external_view_embedder_(std::move(external_view_embedder)) {
+      external_view_embedder_(std::move(external_view_embedder)),
+      engine_group_(std::move(engine_group)) {
   // Make sure all required members of the dispatch table are checked.
   if (!gl_dispatch_table_.gl_make_current_callback ||
       !gl_dispatch_table_.gl_clear_current_callback ||
-      !gl_dispatch_table_.gl_present_callback ||
-      !gl_dispatch_table_.gl_fbo_callback) {
+      !gl_dispatch_table_.gl_fbo_callback ||
+      (!gl_dispatch_table_.gl_present_callback &&
+       !gl_dispatch_table_.gl_present_with_damage_callback)) {
     return;
   }
 
@@ -35,20 +38,67 @@ bool EmbedderSurfaceGL::IsValid() const {
 
 // |GPUSurfaceGLDelegate|
 std::unique_ptr<GLContextResult> EmbedderSurfaceGL::GLContextMakeCurrent() {
-  return std::make_unique<GLContextDefaultResult>(
-      gl_dispatch_table_.gl_make_current_callback());
+  if (gl_dispatch_table_.skip_redundant_context_switches &&
+      GLContextTracker::GetCurrent() == this) {
+    GLContextTracker::DidAvoidSwitch();
+    return std::make_unique<GLContextDefaultResult>(true);
+  }
+  const bool made_current = gl_dispatch_table_.gl_make_current_callback();
+  GLContextTracker::DidSwitch(made_current ? this : nullptr);
+  // Another engine of the group may have rendered with the shared context
+  // since this one did, and the embedder may have changed the GL state in
+  // between, so Skia must not rely on the state it last set.
+  if (made_current && shared_gr_context_ &&
+      engine_group_->SwitchGrContextUser(this)) {
+    shared_gr_context_->resetContext();
+  }
+  return std::make_unique<GLContextDefaultResult>(made_current);
 }
 
 // |GPUSurfaceGLDelegate|
 bool EmbedderSurfaceGL::GLContextClearCurrent() {
-  return gl_dispatch_table_.gl_clear_current_callback();
+  if (gl_dispatch_table_.skip_redundant_context_switches &&
+      GLContextTracker::GetCurrent() != this) {
+    // The context of this surface isn't current, as far as the engine knows.
+    GLContextTracker::DidAvoidSwitch();
+    return true;
+  }
+  const bool cleared = gl_dispatch_table_.gl_clear_current_callback();
+  GLContextTracker::DidSwitch(nullptr);
+  return cleared;
 }
 
 // |GPUSurfaceGLDelegate|
 bool EmbedderSurfaceGL::GLContextPresent() {
+  if (!gl_dispatch_table_.gl_present_callback) {
+    return false;
+  }
   return gl_dispatch_table_.gl_present_callback();
 }
 
+// |GPUSurfaceGLDelegate|
+bool EmbedderSurfaceGL::GLContextPresentWithDamage(const SkIRect& damage) {
+  if (!gl_dispatch_table_.gl_present_with_damage_callback) {
+    return GLContextPresent();
+  }
+  return gl_dispatch_table_.gl_present_with_damage_callback(damage);
+}
+
+// |GPUSurfaceGLDelegate|
+void EmbedderSurfaceGL::GLContextSetDamageRegion(const SkIRect& damage) {
+  if (gl_dispatch_table_.gl_set_damage_region_callback) {
+    gl_dispatch_table_.gl_set_damage_region_callback(damage);
+  }
+}
+
+// |GPUSurfaceGLDelegate|
+int EmbedderSurfaceGL::GLContextFBOBufferAge() const {
+  if (!gl_dispatch_table_.gl_fbo_buffer_age_callback) {
+    return 0;
+  }
+  return gl_dispatch_table_.gl_fbo_buffer_age_callback();
+}
+
 // |GPUSurfaceGLDelegate|
 intptr_t EmbedderSurfaceGL::GLContextFBO() const {
   return gl_dispatch_table_.gl_fbo_callback();
@@ -83,6 +133,27 @@ EmbedderSurfaceGL::GLProcResolver EmbedderSurfaceGL::GetGLProcResolver() const {
 // |EmbedderSurface|
 std::unique_ptr<Surface> EmbedderSurfaceGL::CreateGPUSurface() {
   const bool render_to_surface = !external_view_embedder_;
+  if (engine_group_) {
+    // An OpenGL context may not be current when the group is destroyed, so the
+    // group abandons it instead of releasing its resources. They are freed
+    // along with the OpenGL context.
+    auto gr_context = engine_group_->GetOrCreateGrContext(
+        [this]() -> sk_sp<GrContext> {
+          if (!GLContextMakeCurrent()->GetResult()) {
+            return nullptr;
+          }
+          auto gr_context = GPUSurfaceGL::MakeGLContext(this);
+          GLContextClearCurrent();
+          return gr_context;
+        },
+        true);
+    if (!gr_context) {
+      return nullptr;
+    }
+    shared_gr_context_ = gr_context.get();
+    return std::make_unique<GPUSurfaceGL>(std::move(gr_context), this,
+                                          render_to_surface);
+  }
   return std::make_unique<GPUSurfaceGL>(this,  // GPU surface GL delegate
                                         render_to_surface  // render to surface
 
@@ -7,6 +7,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_gl.h"
+#include "flutter/shell/platform/embedder/embedder_engine_group.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 
@@ -18,18 +19,28 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   struct GLDispatchTable {
     std::function<bool(void)> gl_make_current_callback;           // required
     std::function<bool(void)> gl_clear_current_callback;          // required
-    std::function<bool(void)> gl_present_callback;                // required
+    std::function<bool(void)> gl_present_callback;                // required*
     std::function<intptr_t(void)> gl_fbo_callback;                // required
     std::function<bool(void)> gl_make_resource_current_callback;  // optional
     std::function<SkMatrix(void)>
         gl_surface_transformation_callback;              // optional
     std::function<void*(const char*)> gl_proc_resolver;  // optional
+    std::function<bool(const SkIRect& damage)>
+        gl_present_with_damage_callback;                  // optional
+    std::function<int(void)> gl_fbo_buffer_age_callback;  // optional
+    std::function<void(const SkIRect& damage)>
+        gl_set_damage_region_callback;  // optional
+    // Whether only the engine changes the current context on the threads it
+    // renders on, so that it can skip the calls that would not change it.
+    bool skip_redundant_context_switches;  // optional
+    // * Unless gl_present_with_damage_callback is set.
   };
 
   EmbedderSurfaceGL(
       GLDispatchTable gl_dispatch_table,
       bool fbo_reset_after_present,
-      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
 
   ~EmbedderSurfaceGL() override;
 
@@ -39,6 +50,9 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   bool fbo_reset_after_present_;
 
   std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
+  // Set for engines that render with the Skia context of their group.
+  std::shared_ptr<EmbedderEngineGroup> engine_group_;
+  GrContext* shared_gr_context_ = nullptr;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -58,6 +72,15 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   // |GPUSurfaceGLDelegate|
   bool GLContextPresent() override;
 
+  // |GPUSurfaceGLDelegate|
+  bool GLContextPresentWithDamage(const SkIRect& damage) override;
+
+  // |GPUSurfaceGLDelegate|
+  void GLContextSetDamageRegion(const SkIRect& damage) override;
+
+  // |GPUSurfaceGLDelegate|
+  int GLContextFBOBufferAge() const override;
+
   // |GPUSurfaceGLDelegate|
   intptr_t GLContextFBO() const override;
 
@@ -14,7 +14,8 @@ EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : software_dispatch_table_(software_dispatch_table),
       external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !software_dispatch_table_.software_present_backing_store_with_damage) {
     return;
   }
   valid_ = true;
@@ -57,15 +58,41 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  SkImageInfo info = SkImageInfo::MakeN32(
+      size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+
+  if (software_dispatch_table_.software_acquire_buffer) {
+    Buffer buffer;
+    if (!software_dispatch_table_.software_acquire_buffer(size, &buffer) ||
+        buffer.allocation == nullptr ||
+        buffer.row_bytes < info.minRowBytes()) {
+      FML_LOG(ERROR) << "Embedder did not return a valid software buffer.";
+      return nullptr;
+    }
+    sk_surface_ =
+        SkSurface::MakeRasterDirect(info, buffer.allocation, buffer.row_bytes);
+    backing_store_age_ = buffer.age;
+    if (sk_surface_ == nullptr) {
+      FML_LOG(ERROR) << "Could not wrap the software buffer of the embedder.";
+      return nullptr;
+    }
+    return sk_surface_;
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
-    // The old and new surface sizes are the same. Nothing to do here.
+    // The old and new surface sizes are the same. Nothing to do here. Its
+    // contents are those of the last frame, but only embedders told what
+    // changed need the engine to not repaint all of it.
+    backing_store_age_ =
+        software_dispatch_table_.software_present_backing_store_with_damage
+            ? 1
+            : 0;
     return sk_surface_;
   }
 
-  SkImageInfo info = SkImageInfo::MakeN32(
-      size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
   sk_surface_ = SkSurface::MakeRaster(info, nullptr);
+  backing_store_age_ = 0;
 
   if (sk_surface_ == nullptr) {
     FML_LOG(ERROR) << "Could not create backing store for software rendering.";
@@ -78,6 +105,15 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
+  return PresentBackingStoreWithDamage(
+      backing_store,
+      SkIRect::MakeWH(backing_store->width(), backing_store->height()));
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
@@ -89,16 +125,23 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
-  // Some basic sanity checking.
-  uint64_t expected_pixmap_data_size = pixmap.width() * pixmap.height() * 4;
-
-  const size_t pixmap_size = pixmap.computeByteSize();
-
-  if (expected_pixmap_data_size != pixmap_size) {
+  // Some basic sanity checking. Buffers of the embedder may have padded rows.
+  if (pixmap.rowBytes() < pixmap.info().minRowBytes() ||
+      (!software_dispatch_table_.software_acquire_buffer &&
+       pixmap.rowBytes() != pixmap.info().minRowBytes())) {
     FML_LOG(ERROR) << "Software backing store had unexpected size.";
     return false;
   }
 
+  if (software_dispatch_table_.software_present_backing_store_with_damage) {
+    return software_dispatch_table_.software_present_backing_store_with_damage(
+        pixmap.addr(),      //
+        pixmap.rowBytes(),  //
+        pixmap.height(),    //
+        damage              //
+    );
+  }
+
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
@@ -106,6 +149,11 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+int EmbedderSurfaceSoftware::GetBackingStoreAge() const {
+  return backing_store_age_;
+}
+
 // |GPUSurfaceSoftwareDelegate|
 ExternalViewEmbedder* EmbedderSurfaceSoftware::GetExternalViewEmbedder() {
   return external_view_embedder_.get();
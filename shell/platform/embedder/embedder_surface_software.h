@@ -15,9 +15,26 @@ namespace flutter {
 class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
+  // A buffer provided by the embedder to render a frame into.
+  struct Buffer {
+    void* allocation = nullptr;
+    size_t row_bytes = 0;
+    // The number of frames since the buffer was last presented, or zero if
+    // its contents are undefined.
+    int age = 0;
+  };
+
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // required*
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const SkIRect& damage)>
+        software_present_backing_store_with_damage;  // optional
+    std::function<bool(const SkISize& size, Buffer* buffer)>
+        software_acquire_buffer;  // optional
+    // * Unless software_present_backing_store_with_damage is set.
   };
 
   EmbedderSurfaceSoftware(
@@ -30,6 +47,7 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  int backing_store_age_ = 0;
   std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
   // |EmbedderSurface|
@@ -47,6 +65,13 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreWithDamage(sk_sp<SkSurface> backing_store,
+                                     const SkIRect& damage) override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  int GetBackingStoreAge() const override;
+
   // |GPUSurfaceSoftwareDelegate|
   ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
@@ -0,0 +1,166 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_surface_vulkan.h"
+
+#include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/persistent_cache.h"
+#include "flutter/vulkan/vulkan_application.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/vk/GrVkBackendContext.h"
+
+namespace flutter {
+
+EmbedderSurfaceVulkan::EmbedderSurfaceVulkan(
+    const Context& context,
+    VulkanDispatchTable vulkan_dispatch_table,
+    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<EmbedderEngineGroup> engine_group)
+    : vk_(fml::MakeRefCounted<vulkan::VulkanProcTable>(
+          vulkan_dispatch_table.get_instance_proc_address)),
+      vulkan_dispatch_table_(vulkan_dispatch_table),
+      external_view_embedder_(std::move(external_view_embedder)),
+      engine_group_(std::move(engine_group)) {
+  if (!vulkan_dispatch_table_.get_next_image ||
+      !vulkan_dispatch_table_.present_image) {
+    return;
+  }
+
+  if (!vk_->HasAcquiredMandatoryProcAddresses()) {
+    FML_LOG(ERROR) << "Could not acquire the Vulkan loader procs.";
+    return;
+  }
+
+  // The instance and device are owned by the embedder, so the handles don't
+  // have disposers.
+  if (!vk_->SetupInstanceProcAddresses({context.instance, nullptr}) ||
+      !vk_->SetupDeviceProcAddresses({context.device, nullptr})) {
+    FML_LOG(ERROR) << "Could not acquire the Vulkan instance and device procs.";
+    return;
+  }
+
+  // Vulkan contexts aren't bound to a thread or surface, so the engines of a
+  // group can render with one as long as they share the device.
+  if (engine_group_) {
+    main_context_ = engine_group_->GetOrCreateGrContext(
+        [&]() { return CreateGrContext(context); }, false);
+  } else {
+    main_context_ = CreateGrContext(context);
+  }
+  if (!main_context_) {
+    FML_LOG(ERROR) << "Could not create the Skia context.";
+    return;
+  }
+
+  valid_ = true;
+}
+
+EmbedderSurfaceVulkan::~EmbedderSurfaceVulkan() = default;
+
+sk_sp<GrContext> EmbedderSurfaceVulkan::CreateGrContext(
+    const Context& context) const {
+  auto get_proc = vk_->CreateSkiaGetProc();
+  if (get_proc == nullptr) {
+    return nullptr;
+  }
+
+  VkPhysicalDeviceFeatures features = {};
+  vk_->GetPhysicalDeviceFeatures(context.physical_device, &features);
+  uint32_t skia_features = 0;
+  if (features.geometryShader) {
+    skia_features |= kGeometryShader_GrVkFeatureFlag;
+  }
+  if (features.dualSrcBlend) {
+    skia_features |= kDualSrcBlend_GrVkFeatureFlag;
+  }
+  if (features.sampleRateShading) {
+    skia_features |= kSampleRateShading_GrVkFeatureFlag;
+  }
+
+  GrVkBackendContext backend_context;
+  backend_context.fInstance = context.instance;
+  backend_context.fPhysicalDevice = context.physical_device;
+  backend_context.fDevice = context.device;
+  backend_context.fQueue = context.queue;
+  backend_context.fGraphicsQueueIndex = context.queue_family_index;
+  backend_context.fMinAPIVersion = context.version;
+  // Presentation is up to the embedder, so no surface or swapchain extensions
+  // are needed.
+  backend_context.fExtensions = 0;
+  backend_context.fFeatures = skia_features;
+  backend_context.fGetProc = std::move(get_proc);
+  backend_context.fOwnsInstanceAndDevice = false;
+
+  VkPhysicalDeviceProperties properties;
+  vk_->GetPhysicalDeviceProperties(context.physical_device, &properties);
+  PersistentCache::GetCacheForProcess()->SetVkPipelineCacheDevice(
+      properties.vendorID, properties.deviceID, properties.driverVersion);
+
+  GrContextOptions options;
+  if (PersistentCache::cache_sksl()) {
+    options.fShaderCacheStrategy = GrContextOptions::ShaderCacheStrategy::kSkSL;
+  }
+  PersistentCache::MarkStrategySet();
+  options.fPersistentCache = PersistentCache::GetCacheForProcess();
+
+  auto gr_context = GrContext::MakeVulkan(backend_context, options);
+  if (!gr_context) {
+    return nullptr;
+  }
+  gr_context->setResourceCacheLimits(vulkan::kGrCacheMaxCount,
+                                     vulkan::kGrCacheMaxByteSize);
+  return gr_context;
+}
+
+// |EmbedderSurface|
+bool EmbedderSurfaceVulkan::IsValid() const {
+  return valid_;
+}
+
+// |EmbedderSurface|
+std::unique_ptr<Surface> EmbedderSurfaceVulkan::CreateGPUSurface() {
+  if (!IsValid()) {
+    return nullptr;
+  }
+  const bool render_to_surface = !external_view_embedder_;
+  auto surface = std::make_unique<GPUSurfaceVulkan>(this, main_context_,
+                                                    render_to_surface);
+
+  if (!surface->IsValid()) {
+    return nullptr;
+  }
+
+  return surface;
+}
+
+// |EmbedderSurface|
+sk_sp<GrContext> EmbedderSurfaceVulkan::CreateResourceContext() const {
+  // Textures are uploaded on the raster thread.
+  return nullptr;
+}
+
+// |GPUSurfaceVulkanDelegate|
+fml::RefPtr<vulkan::VulkanProcTable> EmbedderSurfaceVulkan::vk() {
+  return vk_;
+}
+
+// |GPUSurfaceVulkanDelegate|
+ExternalViewEmbedder* EmbedderSurfaceVulkan::GetExternalViewEmbedder() {
+  return external_view_embedder_.get();
+}
+
+// |GPUSurfaceVulkanDelegate|
+GPUSurfaceVulkanDelegate::Image EmbedderSurfaceVulkan::AcquireImage(
+    const SkISize& size) {
+  TRACE_EVENT0("flutter", "EmbedderSurfaceVulkan::AcquireImage");
+  return vulkan_dispatch_table_.get_next_image(size);
+}
+
+// |GPUSurfaceVulkanDelegate|
+bool EmbedderSurfaceVulkan::PresentImage(const Image& image) {
+  TRACE_EVENT0("flutter", "EmbedderSurfaceVulkan::PresentImage");
+  return vulkan_dispatch_table_.present_image(image);
+}
+
+}  // namespace flutter
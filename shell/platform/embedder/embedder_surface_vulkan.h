@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_VULKAN_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_VULKAN_H_
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/gpu/gpu_surface_vulkan.h"
+#include "flutter/shell/platform/embedder/embedder_engine_group.h"
+#include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
+#include "flutter/shell/platform/embedder/embedder_surface.h"
+
+namespace flutter {
+
+class EmbedderSurfaceVulkan final : public EmbedderSurface,
+                                    public GPUSurfaceVulkanDelegate {
+ public:
+  struct VulkanDispatchTable {
+    PFN_vkGetInstanceProcAddr get_instance_proc_address;     // required
+    std::function<Image(const SkISize& size)> get_next_image;  // required
+    std::function<bool(const Image& image)> present_image;     // required
+  };
+
+  struct Context {
+    uint32_t version;
+    VkInstance instance;
+    VkPhysicalDevice physical_device;
+    VkDevice device;
+    uint32_t queue_family_index;
+    VkQueue queue;
+  };
+
+  EmbedderSurfaceVulkan(
+      const Context& context,
+      VulkanDispatchTable vulkan_dispatch_table,
+      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
+
+  ~EmbedderSurfaceVulkan() override;
+
+ private:
+  bool valid_ = false;
+  fml::RefPtr<vulkan::VulkanProcTable> vk_;
+  VulkanDispatchTable vulkan_dispatch_table_;
+  std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
+  // Keeps the shared context alive, for engines of a group.
+  std::shared_ptr<EmbedderEngineGroup> engine_group_;
+  sk_sp<GrContext> main_context_;
+
+  // |EmbedderSurface|
+  bool IsValid() const override;
+
+  // |EmbedderSurface|
+  std::unique_ptr<Surface> CreateGPUSurface() override;
+
+  // |EmbedderSurface|
+  sk_sp<GrContext> CreateResourceContext() const override;
+
+  // |GPUSurfaceVulkanDelegate|
+  fml::RefPtr<vulkan::VulkanProcTable> vk() override;
+
+  // |GPUSurfaceVulkanDelegate|
+  ExternalViewEmbedder* GetExternalViewEmbedder() override;
+
+  // |GPUSurfaceVulkanDelegate|
+  Image AcquireImage(const SkISize& size) override;
+
+  // |GPUSurfaceVulkanDelegate|
+  bool PresentImage(const Image& image) override;
+
+  sk_sp<GrContext> CreateGrContext(const Context& context) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceVulkan);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_VULKAN_H_
@@ -81,9 +81,11 @@ CreateEmbedderTaskRunner(const FlutterTaskRunnerDescription* description) {
 
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
-    const FlutterCustomTaskRunners* custom_task_runners) {
+    const FlutterCustomTaskRunners* custom_task_runners,
+    std::shared_ptr<EmbedderEngineGroup> engine_group) {
   {
-    auto host = CreateEmbedderManagedThreadHost(custom_task_runners);
+    auto host =
+        CreateEmbedderManagedThreadHost(custom_task_runners, engine_group);
     if (host && host->IsValid()) {
       return host;
     }
@@ -94,7 +96,7 @@ EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
   // configuration if the embedder attempted to specify a configuration but
   // messed up with an incorrect configuration.
   if (custom_task_runners == nullptr) {
-    auto host = CreateEngineManagedThreadHost();
+    auto host = CreateEngineManagedThreadHost(std::move(engine_group));
     if (host && host->IsValid()) {
       return host;
     }
@@ -110,10 +112,50 @@ static fml::RefPtr<fml::TaskRunner> GetCurrentThreadTaskRunner() {
 
 constexpr const char* kFlutterThreadName = "io.flutter";
 
+static FlutterThreadPriority ToEmbedderThreadPriority(
+    fml::Thread::ThreadPriority priority) {
+  switch (priority) {
+    case fml::Thread::ThreadPriority::kBackground:
+      return kFlutterThreadPriorityBackground;
+    case fml::Thread::ThreadPriority::kNormal:
+      return kFlutterThreadPriorityNormal;
+    case fml::Thread::ThreadPriority::kUI:
+      return kFlutterThreadPriorityUI;
+    case fml::Thread::ThreadPriority::kDisplay:
+      return kFlutterThreadPriorityDisplay;
+  }
+  return kFlutterThreadPriorityNormal;
+}
+
+// Creates the engine managed threads. If the embedder supplied a priority
+// setter, it is called on each of them with the priority of its work.
+static ThreadHost CreateThreadHost(
+    uint64_t type_mask,
+    FlutterThreadPrioritySetter priority_setter) {
+  if (priority_setter == nullptr) {
+    return ThreadHost(kFlutterThreadName, type_mask);
+  }
+
+  ThreadHost::ThreadConfigs configs;
+  configs[ThreadHost::Type::UI].priority = fml::Thread::ThreadPriority::kUI;
+  configs[ThreadHost::Type::GPU].priority =
+      fml::Thread::ThreadPriority::kDisplay;
+  configs[ThreadHost::Type::IO].priority =
+      fml::Thread::ThreadPriority::kBackground;
+
+  return ThreadHost(kFlutterThreadName, type_mask, std::move(configs),
+                    [priority_setter](const fml::Thread::ThreadConfig& config) {
+                      fml::Thread::SetCurrentThreadName(config.name);
+                      priority_setter(
+                          ToEmbedderThreadPriority(config.priority));
+                    });
+}
+
 // static
 std::unique_ptr<EmbedderThreadHost>
 EmbedderThreadHost::CreateEmbedderManagedThreadHost(
-    const FlutterCustomTaskRunners* custom_task_runners) {
+    const FlutterCustomTaskRunners* custom_task_runners,
+    std::shared_ptr<EmbedderEngineGroup> engine_group) {
   if (custom_task_runners == nullptr) {
     return nullptr;
   }
@@ -138,8 +180,8 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
   }
 
   // If the embedder has not supplied a GPU task runner, one needs to be
-  // created.
-  if (!render_task_runner_pair.second) {
+  // created, unless the engine renders on the raster thread of its group.
+  if (!render_task_runner_pair.second && !engine_group) {
     engine_thread_host_mask |= ThreadHost::Type::GPU;
   }
 
@@ -154,7 +196,10 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
 
   // Create a thread host with just the threads that need to be managed by the
   // engine. The embedder has provided the rest.
-  ThreadHost thread_host(kFlutterThreadName, engine_thread_host_mask);
+  ThreadHost thread_host =
+      CreateThreadHost(engine_thread_host_mask,
+                       SAFE_ACCESS(custom_task_runners, thread_priority_setter,
+                                   nullptr));
 
   // If the embedder has supplied a platform task runner, use that. If not, use
   // the current thread task runner.
@@ -164,11 +209,15 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
                                   : GetCurrentThreadTaskRunner();
 
   // If the embedder has supplied a GPU task runner, use that. If not, use the
-  // one from our thread host.
-  auto render_task_runner = render_task_runner_pair.second
-                                ? static_cast<fml::RefPtr<fml::TaskRunner>>(
-                                      render_task_runner_pair.second)
-                                : thread_host.raster_thread->GetTaskRunner();
+  // one of the engine group or from our thread host.
+  fml::RefPtr<fml::TaskRunner> render_task_runner;
+  if (render_task_runner_pair.second) {
+    render_task_runner = render_task_runner_pair.second;
+  } else if (engine_group) {
+    render_task_runner = engine_group->GetRasterTaskRunner();
+  } else {
+    render_task_runner = thread_host.raster_thread->GetTaskRunner();
+  }
 
   flutter::TaskRunners task_runners(
       kFlutterThreadName,
@@ -194,7 +243,7 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
 
   auto embedder_host = std::make_unique<EmbedderThreadHost>(
       std::move(thread_host), std::move(task_runners),
-      std::move(embedder_task_runners));
+      std::move(embedder_task_runners), std::move(engine_group));
 
   if (embedder_host->IsValid()) {
     return embedder_host;
@@ -205,24 +254,31 @@ EmbedderThreadHost::CreateEmbedderManagedThreadHost(
 
 // static
 std::unique_ptr<EmbedderThreadHost>
-EmbedderThreadHost::CreateEngineManagedThreadHost() {
+EmbedderThreadHost::CreateEngineManagedThreadHost(
+    std::shared_ptr<EmbedderEngineGroup> engine_group) {
   // Create a thread host with the current thread as the platform thread and all
-  // other threads managed.
-  ThreadHost thread_host(kFlutterThreadName, ThreadHost::Type::GPU |
-                                                 ThreadHost::Type::IO |
-                                                 ThreadHost::Type::UI);
+  // other threads managed. Engines of a group render on its raster thread.
+  uint64_t type_mask = ThreadHost::Type::IO | ThreadHost::Type::UI;
+  if (!engine_group) {
+    type_mask |= ThreadHost::Type::GPU;
+  }
+  ThreadHost thread_host(kFlutterThreadName, type_mask);
 
   // For embedder platforms that don't have native message loop interop, this
   // will reference a task runner that points to a null message loop
   // implementation.
   auto platform_task_runner = GetCurrentThreadTaskRunner();
 
+  auto raster_task_runner = engine_group
+                                ? engine_group->GetRasterTaskRunner()
+                                : thread_host.raster_thread->GetTaskRunner();
+
   flutter::TaskRunners task_runners(
       kFlutterThreadName,
-      platform_task_runner,                        // platform
-      thread_host.raster_thread->GetTaskRunner(),  // raster
-      thread_host.ui_thread->GetTaskRunner(),      // ui
-      thread_host.io_thread->GetTaskRunner()       // io
+      platform_task_runner,                    // platform
+      raster_task_runner,                      // raster
+      thread_host.ui_thread->GetTaskRunner(),  // ui
+      thread_host.io_thread->GetTaskRunner()   // io
   );
 
   if (!task_runners.IsValid()) {
@@ -233,7 +289,7 @@ EmbedderThreadHost::CreateEngineManagedThreadHost() {
 
   auto embedder_host = std::make_unique<EmbedderThreadHost>(
       std::move(thread_host), std::move(task_runners),
-      empty_embedder_task_runners);
+      empty_embedder_task_runners, std::move(engine_group));
 
   if (embedder_host->IsValid()) {
     return embedder_host;
@@ -245,8 +301,11 @@ EmbedderThreadHost::CreateEngineManagedThreadHost() {
 EmbedderThreadHost::EmbedderThreadHost(
     ThreadHost host,
     flutter::TaskRunners runners,
-    std::set<fml::RefPtr<EmbedderTaskRunner>> embedder_task_runners)
-    : host_(std::move(host)), runners_(std::move(runners)) {
+    std::set<fml::RefPtr<EmbedderTaskRunner>> embedder_task_runners,
+    std::shared_ptr<EmbedderEngineGroup> engine_group)
+    : host_(std::move(host)),
+      runners_(std::move(runners)),
+      engine_group_(std::move(engine_group)) {
   for (const auto& runner : embedder_task_runners) {
     runners_map_[reinterpret_cast<int64_t>(runner.get())] = runner;
   }
@@ -13,6 +13,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
+#include "flutter/shell/platform/embedder/embedder_engine_group.h"
 #include "flutter/shell/platform/embedder/embedder_task_runner.h"
 
 namespace flutter {
@@ -21,12 +22,14 @@ class EmbedderThreadHost {
  public:
   static std::unique_ptr<EmbedderThreadHost>
   CreateEmbedderOrEngineManagedThreadHost(
-      const FlutterCustomTaskRunners* custom_task_runners);
+      const FlutterCustomTaskRunners* custom_task_runners,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
 
   EmbedderThreadHost(
       ThreadHost host,
       flutter::TaskRunners runners,
-      std::set<fml::RefPtr<EmbedderTaskRunner>> embedder_task_runners);
+      std::set<fml::RefPtr<EmbedderTaskRunner>> embedder_task_runners,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
 
   ~EmbedderThreadHost();
 
@@ -40,11 +43,15 @@ class EmbedderThreadHost {
   ThreadHost host_;
   flutter::TaskRunners runners_;
   std::map<int64_t, fml::RefPtr<EmbedderTaskRunner>> runners_map_;
+  // Keeps the raster thread of the group running for as long as the engine.
+  std::shared_ptr<EmbedderEngineGroup> engine_group_;
 
   static std::unique_ptr<EmbedderThreadHost> CreateEmbedderManagedThreadHost(
-      const FlutterCustomTaskRunners* custom_task_runners);
+      const FlutterCustomTaskRunners* custom_task_runners,
+      std::shared_ptr<EmbedderEngineGroup> engine_group);
 
-  static std::unique_ptr<EmbedderThreadHost> CreateEngineManagedThreadHost();
+  static std::unique_ptr<EmbedderThreadHost> CreateEngineManagedThreadHost(
+      std::shared_ptr<EmbedderEngineGroup> engine_group);
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderThreadHost);
 };
@@ -161,6 +161,17 @@ void platform_messages_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void platform_messages_to_background_channel() {
+  window.onPlatformMessage = (String name, ByteData data, PlatformMessageResponseCallback callback) {
+    window.sendPlatformMessage('test/background', data, (ByteData reply) {
+      var list = reply.buffer.asUint8List(reply.offsetInBytes, reply.lengthInBytes);
+      signalNativeMessage(utf8.decode(list));
+    });
+  };
+  signalNativeTest();
+}
+
 @pragma('vm:entry-point')
 void platform_messages_no_response() {
   window.onPlatformMessage = (String name, ByteData data, PlatformMessageResponseCallback callback) {
@@ -173,6 +184,24 @@ void platform_messages_no_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void event_batches() {
+  final List<String> log = <String>[];
+  window.onMetricsChanged = () {
+    log.add('metrics:${window.physicalSize.width.toInt()}');
+  };
+  window.onPlatformMessage = (String name, ByteData data, PlatformMessageResponseCallback callback) {
+    var list = data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes);
+    log.add('message:${utf8.decode(list)}');
+    callback(data);
+  };
+  window.onPointerDataPacket = (PointerDataPacket packet) {
+    log.add('pointers:${packet.data.length}');
+    signalNativeMessage(log.join(' '));
+  };
+  signalNativeTest();
+}
+
 @pragma('vm:entry-point')
 void null_platform_messages() {
   window.onPlatformMessage =
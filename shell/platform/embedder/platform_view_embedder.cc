@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
 
+#include "flutter/shell/platform/embedder/vsync_waiter_immediate.h"
+
 namespace flutter {
 
 PlatformViewEmbedder::PlatformViewEmbedder(
@@ -12,12 +14,14 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table,
     bool fbo_reset_after_present,
     PlatformDispatchTable platform_dispatch_table,
-    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<EmbedderEngineGroup> engine_group)
     : PlatformView(delegate, std::move(task_runners)),
       embedder_surface_(std::make_unique<EmbedderSurfaceGL>(
           gl_dispatch_table,
           fbo_reset_after_present,
-          std::move(external_view_embedder))),
+          std::move(external_view_embedder),
+          std::move(engine_group))),
       platform_dispatch_table_(platform_dispatch_table) {}
 
 PlatformViewEmbedder::PlatformViewEmbedder(
@@ -32,6 +36,24 @@ PlatformViewEmbedder::PlatformViewEmbedder(
           std::move(external_view_embedder))),
       platform_dispatch_table_(platform_dispatch_table) {}
 
+#ifdef SHELL_ENABLE_VULKAN
+PlatformViewEmbedder::PlatformViewEmbedder(
+    PlatformView::Delegate& delegate,
+    flutter::TaskRunners task_runners,
+    const EmbedderSurfaceVulkan::Context& vulkan_context,
+    EmbedderSurfaceVulkan::VulkanDispatchTable vulkan_dispatch_table,
+    PlatformDispatchTable platform_dispatch_table,
+    std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<EmbedderEngineGroup> engine_group)
+    : PlatformView(delegate, std::move(task_runners)),
+      embedder_surface_(std::make_unique<EmbedderSurfaceVulkan>(
+          vulkan_context,
+          vulkan_dispatch_table,
+          std::move(external_view_embedder),
+          std::move(engine_group))),
+      platform_dispatch_table_(platform_dispatch_table) {}
+#endif  // SHELL_ENABLE_VULKAN
+
 PlatformViewEmbedder::~PlatformViewEmbedder() = default;
 
 void PlatformViewEmbedder::UpdateSemantics(
@@ -84,13 +106,18 @@ sk_sp<GrContext> PlatformViewEmbedder::CreateResourceContext() const {
 
 // |PlatformView|
 std::unique_ptr<VsyncWaiter> PlatformViewEmbedder::CreateVSyncWaiter() {
+  if (platform_dispatch_table_.disable_vsync) {
+    return std::make_unique<VsyncWaiterImmediate>(task_runners_);
+  }
+
   if (!platform_dispatch_table_.vsync_callback) {
     // Superclass implementation creates a timer based fallback.
     return PlatformView::CreateVSyncWaiter();
   }
 
   return std::make_unique<VsyncWaiterEmbedder>(
-      platform_dispatch_table_.vsync_callback, task_runners_);
+      platform_dispatch_table_.vsync_callback, task_runners_,
+      platform_dispatch_table_.preferred_frame_rate_callback);
 }
 
 // |PlatformView|
@@ -15,6 +15,10 @@
 #include "flutter/shell/platform/embedder/embedder_surface_software.h"
 #include "flutter/shell/platform/embedder/vsync_waiter_embedder.h"
 
+#ifdef SHELL_ENABLE_VULKAN
+#include "flutter/shell/platform/embedder/embedder_surface_vulkan.h"
+#endif  // SHELL_ENABLE_VULKAN
+
 namespace flutter {
 
 class PlatformViewEmbedder final : public PlatformView {
@@ -33,6 +37,9 @@ class PlatformViewEmbedder final : public PlatformView {
     PlatformMessageResponseCallback
         platform_message_response_callback;             // optional
     VsyncWaiterEmbedder::VsyncCallback vsync_callback;  // optional
+    bool disable_vsync;                                 // optional
+    VsyncWaiterEmbedder::PreferredFrameRateCallback
+        preferred_frame_rate_callback;  // optional
   };
 
   // Creates a platform view that sets up an OpenGL rasterizer.
@@ -42,7 +49,8 @@ class PlatformViewEmbedder final : public PlatformView {
       EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table,
       bool fbo_reset_after_present,
       PlatformDispatchTable platform_dispatch_table,
-      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
 
   // Create a platform view that sets up a software rasterizer.
   PlatformViewEmbedder(
@@ -52,6 +60,18 @@ class PlatformViewEmbedder final : public PlatformView {
       PlatformDispatchTable platform_dispatch_table,
       std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
+#ifdef SHELL_ENABLE_VULKAN
+  // Creates a platform view that sets up a Vulkan rasterizer.
+  PlatformViewEmbedder(
+      PlatformView::Delegate& delegate,
+      flutter::TaskRunners task_runners,
+      const EmbedderSurfaceVulkan::Context& vulkan_context,
+      EmbedderSurfaceVulkan::VulkanDispatchTable vulkan_dispatch_table,
+      PlatformDispatchTable platform_dispatch_table,
+      std::unique_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<EmbedderEngineGroup> engine_group = nullptr);
+#endif  // SHELL_ENABLE_VULKAN
+
   ~PlatformViewEmbedder() override;
 
   // |PlatformView|
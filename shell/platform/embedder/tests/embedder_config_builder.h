@@ -49,6 +49,8 @@ class EmbedderConfigBuilder {
 
   void SetOpenGLRendererConfig(SkISize surface_size);
 
+  FlutterRendererConfig& GetRendererConfig();
+
   void SetAssetsPath();
 
   void SetSnapshots();
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Creates a render target backed by a raster surface of |size|, which
+// increments |collected| when it is collected.
+std::unique_ptr<EmbedderRenderTarget> CreateRenderTarget(const SkISize& size,
+                                                         size_t* collected) {
+  FlutterBackingStore backing_store = {};
+  backing_store.struct_size = sizeof(FlutterBackingStore);
+  return std::make_unique<EmbedderRenderTarget>(
+      backing_store,
+      SkSurface::MakeRasterN32Premul(size.width(), size.height()),
+      [collected]() { (*collected)++; });
+}
+
+// Creates |count| views of |size| with engine rendered contents: a root view,
+// then views for platform views with IDs counting up from one.
+EmbedderExternalView::PendingViews CreatePendingViews(const SkISize& size,
+                                                      size_t count) {
+  EmbedderExternalView::PendingViews views;
+  for (size_t i = 0; i < count; ++i) {
+    EmbedderExternalView::ViewIdentifier view_identifier;
+    std::unique_ptr<EmbeddedViewParams> params;
+    if (i > 0) {
+      view_identifier = EmbedderExternalView::ViewIdentifier(i);
+      params = std::make_unique<EmbeddedViewParams>();
+    }
+    auto view = std::make_unique<EmbedderExternalView>(
+        size, SkMatrix::I(), view_identifier, std::move(params));
+    view->GetCanvas()->drawColor(SK_ColorRED);
+    views[view_identifier] = std::move(view);
+  }
+  return views;
+}
+
+// Renders a frame of |views|, creating the render targets the cache doesn't
+// have, like EmbedderExternalViewEmbedder::SubmitFrame does.
+void RenderFrame(EmbedderRenderTargetCache& cache,
+                 const EmbedderExternalView::PendingViews& views,
+                 size_t* collected) {
+  auto [targets, unmatched] = cache.GetExistingTargetsInCache(views);
+  cache.ClearStaleRenderTargetsInCache();
+  for (const auto& view_identifier : unmatched) {
+    targets[view_identifier] = CreateRenderTarget(
+        cache.GetRenderTargetSize(
+            views.at(view_identifier)->GetRenderSurfaceSize()),
+        collected);
+  }
+  for (auto& target : targets) {
+    cache.CacheRenderTarget(std::move(target.second));
+  }
+}
+
+}  // namespace
+
+TEST(EmbedderRenderTargetCacheTest, ReusesTargetsAcrossPlatformViews) {
+  size_t collected = 0;
+  EmbedderRenderTargetCache cache;
+  const auto size = SkISize::Make(100, 100);
+
+  RenderFrame(cache, CreatePendingViews(size, 3), &collected);
+  EXPECT_EQ(cache.GetStats().miss_count, 3u);
+
+  // The root view and a different platform view reuse the targets.
+  RenderFrame(cache, CreatePendingViews(size, 2), &collected);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hit_count, 2u);
+  EXPECT_EQ(stats.miss_count, 0u);
+  EXPECT_EQ(stats.evicted_count, 1u);
+  EXPECT_EQ(stats.cached_count, 2u);
+  EXPECT_EQ(stats.cached_bytes, 2u * 100 * 100 * 4);
+  EXPECT_EQ(collected, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, KeepsUnusedTargetsForConfiguredFrames) {
+  size_t collected = 0;
+  EmbedderRenderTargetCache::Config config;
+  config.max_unused_frames = 3;
+  EmbedderRenderTargetCache cache(config);
+
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 100), 1),
+              &collected);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(200, 200), 1),
+              &collected);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(200, 200), 1),
+              &collected);
+  EXPECT_EQ(collected, 0u);
+
+  // The first size comes back before its target is collected.
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 100), 1),
+              &collected);
+  EXPECT_EQ(cache.GetStats().hit_count, 1u);
+  EXPECT_EQ(collected, 0u);
+
+  for (int i = 0; i < 3; ++i) {
+    RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 100), 1),
+                &collected);
+  }
+  EXPECT_EQ(collected, 1u);
+  EXPECT_EQ(cache.GetStats().cached_count, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+  size_t collected = 0;
+  EmbedderRenderTargetCache::Config config;
+  config.max_unused_frames = 10;
+  config.max_bytes = 2 * 100 * 100 * 4;
+  EmbedderRenderTargetCache cache(config);
+
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 100), 1),
+              &collected);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 101), 1),
+              &collected);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 102), 1),
+              &collected);
+  EXPECT_EQ(collected, 1u);
+
+  // The target of the first frame was the one collected.
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 101), 1),
+              &collected);
+  EXPECT_EQ(cache.GetStats().hit_count, 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, BucketsSizesByGranularity) {
+  size_t collected = 0;
+  EmbedderRenderTargetCache::Config config;
+  config.size_granularity = 64;
+  EmbedderRenderTargetCache cache(config);
+
+  EXPECT_EQ(cache.GetRenderTargetSize(SkISize::Make(100, 128)),
+            SkISize::Make(128, 128));
+
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(100, 100), 1),
+              &collected);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(110, 120), 1),
+              &collected);
+  EXPECT_EQ(cache.GetStats().hit_count, 1u);
+  RenderFrame(cache, CreatePendingViews(SkISize::Make(130, 120), 1),
+              &collected);
+  EXPECT_EQ(cache.GetStats().miss_count, 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,7 +4,9 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include "embedder.h"
 #include "embedder_engine.h"
@@ -52,6 +54,96 @@ TEST_F(EmbedderTest, CanLaunchAndShutdownWithValidProjectArgs) {
   engine.reset();
 }
 
+TEST_F(EmbedderTest, ReportsTheStartupTimingOfTheEngine) {
+  auto& context = GetEmbedderContext();
+  fml::AutoResetWaitableEvent latch;
+  context.AddIsolateCreateCallback([&latch]() { latch.Signal(); });
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  latch.Wait();
+
+  ASSERT_EQ(FlutterEngineGetStartupTiming(engine.get(), nullptr),
+            kInvalidArguments);
+  FlutterEngineStartupTiming timing = {};
+  timing.struct_size = sizeof(FlutterEngineStartupTiming);
+  ASSERT_EQ(FlutterEngineGetStartupTiming(engine.get(), &timing), kSuccess);
+  ASSERT_GT(timing.engine_main_enter, 0);
+  ASSERT_GE(timing.vm_created, 0);
+  ASSERT_GE(timing.engine_initialized, 0);
+  ASSERT_GE(timing.run_engine, timing.engine_initialized);
+
+  // Fields past the struct size of older embedders are left alone.
+  FlutterEngineStartupTiming old_timing = {};
+  old_timing.struct_size = offsetof(FlutterEngineStartupTiming, vm_created);
+  old_timing.vm_created = 42;
+  ASSERT_EQ(FlutterEngineGetStartupTiming(engine.get(), &old_timing),
+            kSuccess);
+  ASSERT_EQ(old_timing.engine_main_enter, timing.engine_main_enter);
+  ASSERT_EQ(old_timing.vm_created, 42);
+  engine.reset();
+}
+
+TEST(EmbedderTestNoFixture, EngineGroupsRequireAConfig) {
+  FlutterEngineGroup group = nullptr;
+  ASSERT_EQ(FlutterEngineGroupCreate(nullptr, &group), kInvalidArguments);
+  ASSERT_EQ(group, nullptr);
+
+  FlutterEngineGroupConfig config = {};
+  config.struct_size = sizeof(FlutterEngineGroupConfig);
+  ASSERT_EQ(FlutterEngineGroupCreate(&config, nullptr), kInvalidArguments);
+  ASSERT_EQ(FlutterEngineGroupCreate(&config, &group), kSuccess);
+  ASSERT_NE(group, nullptr);
+  ASSERT_EQ(FlutterEngineGroupCollect(group), kSuccess);
+}
+
+TEST_F(EmbedderTest, EnginesOfAGroupShareTheRasterThread) {
+  FlutterEngineGroupConfig group_config = {};
+  group_config.struct_size = sizeof(FlutterEngineGroupConfig);
+  FlutterEngineGroup group = nullptr;
+  ASSERT_EQ(FlutterEngineGroupCreate(&group_config, &group), kSuccess);
+
+  EmbedderConfigBuilder builder(GetEmbedderContext());
+  builder.SetSoftwareRendererConfig();
+  builder.GetProjectArgs().engine_group = group;
+
+  auto engine1 = builder.LaunchEngine();
+  auto engine2 = builder.LaunchEngine();
+  ASSERT_TRUE(engine1.is_valid());
+  ASSERT_TRUE(engine2.is_valid());
+
+  // The running engines keep the group alive.
+  ASSERT_EQ(FlutterEngineGroupCollect(group), kSuccess);
+
+  struct RasterThread {
+    std::thread::id id;
+    fml::AutoResetWaitableEvent latch;
+  };
+  auto get_raster_thread = [](FLUTTER_API_SYMBOL(FlutterEngine) engine,
+                              RasterThread* thread) {
+    ASSERT_EQ(FlutterEnginePostRenderThreadTask(
+                  engine,
+                  [](void* baton) {
+                    auto thread = reinterpret_cast<RasterThread*>(baton);
+                    thread->id = std::this_thread::get_id();
+                    thread->latch.Signal();
+                  },
+                  thread),
+              kSuccess);
+    thread->latch.Wait();
+  };
+
+  RasterThread thread1;
+  RasterThread thread2;
+  get_raster_thread(engine1.get(), &thread1);
+  get_raster_thread(engine2.get(), &thread2);
+  ASSERT_EQ(thread1.id, thread2.id);
+
+  engine1.reset();
+  engine2.reset();
+}
+
 // TODO(41999): Disabled because flaky.
 TEST_F(EmbedderTest, DISABLED_CanLaunchAndShutdownMultipleTimes) {
   EmbedderConfigBuilder builder(GetEmbedderContext());
@@ -395,6 +487,83 @@ TEST_F(EmbedderTest, PlatformMessagesCanReceiveResponse) {
   captures.latch.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the messages of a channel with a background callback are handled
+/// off the platform thread, and that their responses reach Dart.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeHandledOnBackgroundThread) {
+  struct Captures {
+    FlutterEngine engine = nullptr;
+    std::thread::id platform_thread_id;
+    std::thread::id handler_thread_id;
+  };
+  Captures captures;
+  auto& context = GetEmbedderContext();
+  fml::AutoResetWaitableEvent replied;
+  std::string reply;
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(([&replied, &reply](Dart_NativeArguments args) {
+        reply = tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        replied.Signal();
+      })));
+
+  auto platform_task_runner = CreateNewThread();
+  UniqueEngine engine;
+  platform_task_runner->PostTask([&]() {
+    captures.platform_thread_id = std::this_thread::get_id();
+    EmbedderConfigBuilder builder(context);
+    builder.SetSoftwareRendererConfig();
+    builder.SetDartEntrypoint("platform_messages_to_background_channel");
+
+    fml::AutoResetWaitableEvent ready;
+    context.AddNativeCallback(
+        "SignalNativeTest",
+        CREATE_NATIVE_ENTRY(
+            [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+
+    engine = builder.LaunchEngine();
+    ASSERT_TRUE(engine.is_valid());
+    captures.engine = engine.get();
+
+    auto callback = [](const FlutterPlatformMessage* message,
+                       void* user_data) {
+      auto captures = reinterpret_cast<Captures*>(user_data);
+      captures->handler_thread_id = std::this_thread::get_id();
+      static const std::string kReply = "Hello from the background.";
+      FlutterEngineSendPlatformMessageResponse(
+          captures->engine, message->response_handle,
+          reinterpret_cast<const uint8_t*>(kReply.data()), kReply.size());
+    };
+    auto result = FlutterEngineSetBackgroundPlatformMessageCallback(
+        engine.get(), "test/background", callback, &captures);
+    ASSERT_EQ(result, kSuccess);
+
+    ready.Wait();
+    FlutterPlatformMessage message = {};
+    message.struct_size = sizeof(FlutterPlatformMessage);
+    message.channel = "test_channel";
+    message.message = reinterpret_cast<const uint8_t*>("Hi");
+    message.message_size = 2;
+    result = FlutterEngineSendPlatformMessage(engine.get(), &message);
+    ASSERT_EQ(result, kSuccess);
+  });
+
+  replied.Wait();
+  ASSERT_EQ(reply, "Hello from the background.");
+  ASSERT_NE(captures.handler_thread_id, captures.platform_thread_id);
+
+  // Since the engine was started on its own thread, it must be killed there as
+  // well.
+  fml::AutoResetWaitableEvent kill_latch;
+  platform_task_runner->PostTask([&]() {
+    engine.reset();
+    kill_latch.Signal();
+  });
+  kill_latch.Wait();
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a platform message can be sent with no response handle. Instead
 /// of the platform message integrity checked via a response handle, a native
@@ -507,6 +676,109 @@ TEST_F(EmbedderTest, InvalidPlatformMessages) {
   ASSERT_EQ(result, kInvalidArguments);
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the events of a batch are all delivered, in a fixed order by
+/// kind, and that its pointer events arrive in a single packet.
+///
+TEST_F(EmbedderTest, EventBatchesAreDeliveredTogether) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("event_batches");
+
+  fml::AutoResetWaitableEvent ready, delivered;
+  std::string log;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(([&delivered, &log](Dart_NativeArguments args) {
+        log = tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        delivered.Signal();
+      })));
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  const std::string message_data = "batched";
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message =
+      reinterpret_cast<const uint8_t*>(message_data.data());
+  platform_message.message_size = message_data.size();
+
+  FlutterWindowMetricsEvent metrics = {};
+  metrics.struct_size = sizeof(FlutterWindowMetricsEvent);
+  metrics.width = 800;
+  metrics.height = 600;
+  metrics.pixel_ratio = 1.0;
+
+  FlutterPointerEvent pointers[2] = {};
+  for (auto& pointer : pointers) {
+    pointer.struct_size = sizeof(FlutterPointerEvent);
+    pointer.phase = kAdd;
+  }
+  pointers[1].phase = kHover;
+  pointers[1].x = 10;
+
+  // The pointer events come first and the metrics last, but the metrics are
+  // applied first.
+  FlutterEngineEvent events[4] = {};
+  for (auto& event : events) {
+    event.struct_size = sizeof(FlutterEngineEvent);
+  }
+  events[0].type = kFlutterEngineEventTypePointer;
+  events[0].pointer = &pointers[0];
+  events[1].type = kFlutterEngineEventTypePlatformMessage;
+  events[1].platform_message = &platform_message;
+  events[2].type = kFlutterEngineEventTypePointer;
+  events[2].pointer = &pointers[1];
+  events[3].type = kFlutterEngineEventTypeWindowMetrics;
+  events[3].window_metrics = &metrics;
+
+  ASSERT_EQ(FlutterEngineSendEvents(engine.get(), events, 4), kSuccess);
+  delivered.Wait();
+  ASSERT_EQ(log, "metrics:800 message:batched pointers:2");
+}
+
+//------------------------------------------------------------------------------
+/// Tests that a batch with an invalid event is rejected as a whole.
+///
+TEST_F(EmbedderTest, InvalidEventBatches) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineSendEvents(engine.get(), nullptr, 0),
+            kInvalidArguments);
+
+  FlutterWindowMetricsEvent metrics = {};
+  metrics.struct_size = sizeof(FlutterWindowMetricsEvent);
+  metrics.width = 800;
+  metrics.height = 600;
+  metrics.pixel_ratio = 0.0;
+
+  FlutterEngineEvent events[2] = {};
+  events[0].struct_size = sizeof(FlutterEngineEvent);
+  events[0].type = kFlutterEngineEventTypePlatformMessage;
+  events[0].platform_message = nullptr;
+  events[1].struct_size = sizeof(FlutterEngineEvent);
+  events[1].type = kFlutterEngineEventTypeWindowMetrics;
+  events[1].window_metrics = &metrics;
+
+  ASSERT_EQ(FlutterEngineSendEvents(engine.get(), events, 2),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineSendEvents(engine.get(), &events[1], 1),
+            kInvalidArguments);
+}
+
 //------------------------------------------------------------------------------
 /// Asserts behavior of FlutterProjectArgs::shutdown_dart_vm_when_done (which is
 /// set to true by default in these unit-tests).
@@ -2000,6 +2272,266 @@ TEST_F(EmbedderTest, CanRenderSceneWithoutCustomCompositor) {
                                   renderered_scene));
 }
 
+TEST_F(EmbedderTest, SoftwareRendererPresentsEmbedderBufferWithDamage) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+
+  // The callbacks only get the test context as their user data.
+  static std::vector<uint32_t> buffer;
+  static std::vector<FlutterRect> damage;
+  static fml::AutoResetWaitableEvent latch;
+  buffer.assign(800 * 600, 0);
+  damage.clear();
+
+  auto& software_config = builder.GetRendererConfig().software;
+  software_config.surface_present_callback = nullptr;
+  software_config.surface_acquire_buffer_callback =
+      [](void* user_data, size_t width, size_t height,
+         FlutterSoftwareBuffer* buffer_out) -> bool {
+    if (width * height != buffer.size()) {
+      return false;
+    }
+    buffer_out->allocation = buffer.data();
+    buffer_out->row_bytes = width * 4;
+    buffer_out->age = 1;
+    return true;
+  };
+  software_config.surface_present_with_info_callback =
+      [](void* user_data, const FlutterSoftwarePresentInfo* info) -> bool {
+    EXPECT_EQ(info->allocation, buffer.data());
+    EXPECT_EQ(info->row_bytes, 800u * 4);
+    EXPECT_EQ(info->height, 600u);
+    damage.assign(info->frame_damage.damage,
+                  info->frame_damage.damage + info->frame_damage.num_rects);
+    latch.Signal();
+    return true;
+  };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+
+  // Nothing has been rendered before, so all of the first frame is damaged.
+  ASSERT_EQ(damage.size(), 1u);
+  ASSERT_EQ(damage[0].left, 0.0);
+  ASSERT_EQ(damage[0].top, 0.0);
+  ASSERT_EQ(damage[0].right, 800.0);
+  ASSERT_EQ(damage[0].bottom, 600.0);
+
+  // The scene was drawn into the buffer of the embedder.
+  ASSERT_NE(buffer[(20 * 800) + 20], 0u);
+
+  engine.reset();
+}
+
+TEST_F(EmbedderTest, CanRasterizeLastFrameIntoEmbedderBuffers) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.GetProjectArgs().disable_vsync = true;
+
+  auto rendered_scene = context.GetNextSceneImage();
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  rendered_scene.wait();
+
+  struct Output {
+    std::vector<uint32_t> pixels;
+    bool success = false;
+    fml::AutoResetWaitableEvent latch;
+  };
+  Output full_size;
+  full_size.pixels.assign(800 * 600, 0);
+  Output thumbnail;
+  thumbnail.pixels.assign(80 * 60, 0);
+
+  auto make_job = [](Output* output, size_t width, size_t height) {
+    FlutterOffscreenRasterJob job = {};
+    job.struct_size = sizeof(job);
+    job.width = width;
+    job.height = height;
+    job.allocation = output->pixels.data();
+    job.row_bytes = width * 4;
+    job.callback = [](bool success, void* user_data) {
+      auto output = reinterpret_cast<Output*>(user_data);
+      output->success = success;
+      output->latch.Signal();
+    };
+    job.user_data = output;
+    return job;
+  };
+  FlutterOffscreenRasterJob jobs[] = {
+      make_job(&full_size, 800, 600),
+      make_job(&thumbnail, 80, 60),
+  };
+  ASSERT_EQ(FlutterEngineRasterizeLastFrame(engine.get(), jobs, 2), kSuccess);
+
+  full_size.latch.Wait();
+  thumbnail.latch.Wait();
+  ASSERT_TRUE(full_size.success);
+  ASSERT_TRUE(thumbnail.success);
+  ASSERT_NE(full_size.pixels[(20 * 800) + 20], 0u);
+  ASSERT_NE(thumbnail.pixels[(2 * 80) + 2], 0u);
+
+  // Jobs without an allocation are rejected before any is run.
+  jobs[1].allocation = nullptr;
+  ASSERT_EQ(FlutterEngineRasterizeLastFrame(engine.get(), jobs, 2),
+            kInvalidArguments);
+
+  engine.reset();
+}
+
+TEST_F(EmbedderTest, GLRendererSetsDamageRegionBeforeRendering) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+
+  // The callbacks only get the test context as their user data.
+  static std::vector<FlutterRect> damage;
+  static fml::AutoResetWaitableEvent latch;
+  damage.clear();
+
+  auto& open_gl_config = builder.GetRendererConfig().open_gl;
+  open_gl_config.fbo_buffer_age_callback = [](void* user_data) -> uint32_t {
+    return 0;
+  };
+  open_gl_config.set_damage_region = [](void* user_data,
+                                        const FlutterDamage* frame_damage) {
+    if (!damage.empty()) {
+      return;
+    }
+    damage.assign(frame_damage->damage,
+                  frame_damage->damage + frame_damage->num_rects);
+    latch.Signal();
+  };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+
+  // The buffer has no known contents, so all of it is repainted.
+  ASSERT_EQ(damage.size(), 1u);
+  ASSERT_EQ(damage[0].left, 0.0);
+  ASSERT_EQ(damage[0].top, 0.0);
+  ASSERT_EQ(damage[0].right, 800.0);
+  ASSERT_EQ(damage[0].bottom, 600.0);
+
+  engine.reset();
+}
+
+TEST_F(EmbedderTest, GLRendererRequiresAPresentCallback) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.GetRendererConfig().open_gl.present = nullptr;
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+TEST_F(EmbedderTest, VsyncWithInfoReportsFrameTimings) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+
+  // The callbacks only get the test context as their user data.
+  static std::atomic<intptr_t> vsync_baton;
+  static fml::AutoResetWaitableEvent vsync_latch;
+  static FlutterFrameTimings frame_timings;
+  static fml::AutoResetWaitableEvent timings_latch;
+
+  builder.GetProjectArgs().vsync_callback = [](void* user_data,
+                                               intptr_t baton) {
+    vsync_baton = baton;
+    vsync_latch.Signal();
+  };
+  builder.GetProjectArgs().frame_timings_callback =
+      [](const FlutterFrameTimings* timings, void* user_data) {
+        frame_timings = *timings;
+        timings_latch.Signal();
+      };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  vsync_latch.Wait();
+
+  const uint64_t now = FlutterEngineGetCurrentTime();
+  FlutterVsyncInfo info = {};
+  info.struct_size = sizeof(info);
+  info.baton = vsync_baton;
+  info.frame_start_time_nanos = now;
+  info.frame_target_time_nanos = now - 1;
+  ASSERT_EQ(FlutterEngineOnVsyncWithInfo(engine.get(), &info),
+            kInvalidArguments);
+
+  info.frame_target_time_nanos = now + 8333333;
+  info.display_refresh_rate = 120.0;
+  ASSERT_EQ(FlutterEngineOnVsyncWithInfo(engine.get(), &info), kSuccess);
+  timings_latch.Wait();
+
+  ASSERT_EQ(frame_timings.struct_size, sizeof(FlutterFrameTimings));
+  ASSERT_EQ(frame_timings.vsync_start_time_nanos, now);
+  ASSERT_LE(frame_timings.vsync_start_time_nanos,
+            frame_timings.build_start_time_nanos);
+  ASSERT_LE(frame_timings.build_start_time_nanos,
+            frame_timings.build_finish_time_nanos);
+  ASSERT_LE(frame_timings.build_finish_time_nanos,
+            frame_timings.raster_start_time_nanos);
+  ASSERT_LE(frame_timings.raster_start_time_nanos,
+            frame_timings.raster_finish_time_nanos);
+}
+
 TEST_F(EmbedderTest, CanRenderSceneWithoutCustomCompositorWithTransformation) {
   auto& context = GetEmbedderContext();
 
@@ -3869,6 +4401,58 @@ TEST_F(EmbedderTest, ObjectsCanBePostedViaPorts) {
     event.Wait();
   }
 
+  std::vector<float> float_message;
+  fml::AutoResetWaitableEvent float_buffer_released_latch;
+
+  // Check buffer (caller owned buffer received as a Float32List).
+  {
+    float_message.resize(256, 1988.0f);
+
+    FlutterEngineDartBuffer buffer = {};
+
+    buffer.struct_size = sizeof(buffer);
+    buffer.user_data = &float_buffer_released_latch;
+    buffer.buffer_collect_callback = +[](void* user_data) {
+      reinterpret_cast<fml::AutoResetWaitableEvent*>(user_data)->Signal();
+    };
+    buffer.buffer = reinterpret_cast<uint8_t*>(float_message.data());
+    buffer.buffer_size = float_message.size() * sizeof(float);
+    buffer.typed_data_type = kFlutterEngineDartTypedDataTypeFloat32;
+
+    FlutterEngineDartObject object = {};
+    object.type = kFlutterEngineDartObjectTypeBuffer;
+    object.buffer_value = &buffer;
+    trampoline = [&](Dart_Handle handle) {
+      ASSERT_EQ(Dart_GetTypeOfExternalTypedData(handle),
+                Dart_TypedData_kFloat32);
+      intptr_t length = 0;
+      Dart_ListLength(handle, &length);
+      ASSERT_EQ(length, 256);
+      event.Signal();
+    };
+    ASSERT_EQ(FlutterEnginePostDartObject(engine.get(), port, &object),
+              kSuccess);
+    event.Wait();
+  }
+
+  // Check buffer (size not a multiple of the element size).
+  {
+    std::vector<uint8_t> odd_message(7);
+
+    FlutterEngineDartBuffer buffer = {};
+
+    buffer.struct_size = sizeof(buffer);
+    buffer.buffer = odd_message.data();
+    buffer.buffer_size = odd_message.size();
+    buffer.typed_data_type = kFlutterEngineDartTypedDataTypeFloat32;
+
+    FlutterEngineDartObject object = {};
+    object.type = kFlutterEngineDartObjectTypeBuffer;
+    object.buffer_value = &buffer;
+    ASSERT_EQ(FlutterEnginePostDartObject(engine.get(), port, &object),
+              kInvalidArguments);
+  }
+
   engine.reset();
 
   // We cannot determine when the VM will GC objects that might have external
@@ -3876,6 +4460,7 @@ TEST_F(EmbedderTest, ObjectsCanBePostedViaPorts) {
   // finalizers from the embedders, we force the VM to collect all objects but
   // just shutting it down.
   buffer_released_latch.Wait();
+  float_buffer_released_latch.Wait();
 }
 
 TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
@@ -3896,6 +4481,27 @@ TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   ASSERT_EQ(FlutterEngineNotifyLowMemoryWarning(engine.get()), kSuccess);
 }
 
+TEST_F(EmbedderTest, CanSendMemoryPressureNotifications) {
+  auto& context = GetEmbedderContext();
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  for (auto level : {kFlutterMemoryPressureLevelModerate,
+                     kFlutterMemoryPressureLevelCritical,
+                     kFlutterMemoryPressureLevelBackground}) {
+    ASSERT_EQ(FlutterEngineNotifyMemoryPressure(engine.get(), level),
+              kSuccess);
+  }
+  ASSERT_EQ(FlutterEngineNotifyMemoryPressure(
+                engine.get(), static_cast<FlutterMemoryPressureLevel>(42)),
+            kInvalidArguments);
+}
+
 TEST_F(EmbedderTest, CanPostTaskToAllNativeThreads) {
   UniqueEngine engine;
   size_t worker_count = 0;
@@ -6,9 +6,13 @@
 
 namespace flutter {
 
-VsyncWaiterEmbedder::VsyncWaiterEmbedder(const VsyncCallback& vsync_callback,
-                                         flutter::TaskRunners task_runners)
-    : VsyncWaiter(std::move(task_runners)), vsync_callback_(vsync_callback) {
+VsyncWaiterEmbedder::VsyncWaiterEmbedder(
+    const VsyncCallback& vsync_callback,
+    flutter::TaskRunners task_runners,
+    const PreferredFrameRateCallback& preferred_frame_rate_callback)
+    : VsyncWaiter(std::move(task_runners)),
+      vsync_callback_(vsync_callback),
+      preferred_frame_rate_callback_(preferred_frame_rate_callback) {
   FML_DCHECK(vsync_callback_);
 }
 
@@ -23,7 +27,8 @@ void VsyncWaiterEmbedder::AwaitVSync() {
 // static
 bool VsyncWaiterEmbedder::OnEmbedderVsync(intptr_t baton,
                                           fml::TimePoint frame_start_time,
-                                          fml::TimePoint frame_target_time) {
+                                          fml::TimePoint frame_target_time,
+                                          float display_refresh_rate) {
   if (baton == 0) {
     return false;
   }
@@ -36,8 +41,27 @@ bool VsyncWaiterEmbedder::OnEmbedderVsync(intptr_t baton,
     return false;
   }
 
-  strong_waiter->FireCallback(frame_start_time, frame_target_time);
+  // Batons are only handed out by |AwaitVSync|.
+  auto embedder_waiter =
+      std::static_pointer_cast<VsyncWaiterEmbedder>(strong_waiter);
+  if (display_refresh_rate > kUnknownRefreshRateFPS) {
+    embedder_waiter->display_refresh_rate_ = display_refresh_rate;
+  }
+
+  embedder_waiter->FireCallback(frame_start_time, frame_target_time);
   return true;
 }
 
+// |VsyncWaiter|
+float VsyncWaiterEmbedder::GetDisplayRefreshRate() const {
+  return display_refresh_rate_;
+}
+
+// |VsyncWaiter|
+void VsyncWaiterEmbedder::SetPreferredFrameRate(float fps) {
+  if (preferred_frame_rate_callback_) {
+    preferred_frame_rate_callback_(fps);
+  }
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #ifndef SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_EMBEDDER_H_
 #define SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_EMBEDDER_H_
 
+#include <atomic>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/vsync_waiter.h"
 
@@ -13,18 +15,32 @@ namespace flutter {
 class VsyncWaiterEmbedder final : public VsyncWaiter {
  public:
   using VsyncCallback = std::function<void(intptr_t)>;
+  using PreferredFrameRateCallback = std::function<void(float)>;
 
-  VsyncWaiterEmbedder(const VsyncCallback& callback,
-                      flutter::TaskRunners task_runners);
+  VsyncWaiterEmbedder(
+      const VsyncCallback& callback,
+      flutter::TaskRunners task_runners,
+      const PreferredFrameRateCallback& preferred_frame_rate_callback =
+          nullptr);
 
   ~VsyncWaiterEmbedder() override;
 
   static bool OnEmbedderVsync(intptr_t baton,
                               fml::TimePoint frame_start_time,
-                              fml::TimePoint frame_target_time);
+                              fml::TimePoint frame_target_time,
+                              float display_refresh_rate);
+
+  // |VsyncWaiter|
+  float GetDisplayRefreshRate() const override;
+
+  // |VsyncWaiter|
+  void SetPreferredFrameRate(float fps) override;
 
  private:
   const VsyncCallback vsync_callback_;
+  const PreferredFrameRateCallback preferred_frame_rate_callback_;
+  // The last refresh rate given by the embedder with a vsync event.
+  std::atomic<float> display_refresh_rate_ = kUnknownRefreshRateFPS;
 
   // |VsyncWaiter|
   void AwaitVSync() override;
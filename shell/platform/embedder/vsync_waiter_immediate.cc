@@ -0,0 +1,25 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/vsync_waiter_immediate.h"
+
+namespace flutter {
+
+VsyncWaiterImmediate::VsyncWaiterImmediate(flutter::TaskRunners task_runners)
+    : VsyncWaiter(std::move(task_runners)) {}
+
+VsyncWaiterImmediate::~VsyncWaiterImmediate() = default;
+
+// |VsyncWaiter|
+void VsyncWaiterImmediate::AwaitVSync() {
+  // The target time still gives the frame a regular budget, so that idle
+  // notifications and frame timings behave as they would on a display.
+  constexpr fml::TimeDelta kSingleFrameInterval =
+      fml::TimeDelta::FromSecondsF(1.0 / 60.0);
+
+  auto now = fml::TimePoint::Now();
+  FireCallback(now, now + kSingleFrameInterval);
+}
+
+}  // namespace flutter
@@ -0,0 +1,30 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_IMMEDIATE_H_
+#define SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_IMMEDIATE_H_
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/common/vsync_waiter.h"
+
+namespace flutter {
+
+// A vsync waiter that begins frames as soon as they are requested, for
+// engines that only render offscreen and have no display to pace them.
+class VsyncWaiterImmediate final : public VsyncWaiter {
+ public:
+  explicit VsyncWaiterImmediate(flutter::TaskRunners task_runners);
+
+  ~VsyncWaiterImmediate() override;
+
+ private:
+  // |VsyncWaiter|
+  void AwaitVSync() override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterImmediate);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_IMMEDIATE_H_
@@ -24,6 +24,7 @@
 #include <regex>
 #include <utility>
 
+#include "flutter/fml/trace_event.h"
 #include "runtime/dart/utils/files.h"
 #include "runtime/dart/utils/handle_exception.h"
 #include "runtime/dart/utils/inlines.h"
@@ -156,6 +157,7 @@ constexpr char kTmpPath[] = "/tmp";
 constexpr char kServiceRootPath[] = "/svc";
 
 bool DartComponentController::SetupNamespace() {
+  TRACE_EVENT0("dart", "DartComponentController::SetupNamespace");
   fuchsia::sys::FlatNamespace* flat = &startup_info_.flat_namespace;
   zx_status_t status = fdio_ns_create(&namespace_);
   if (status != ZX_OK) {
@@ -194,6 +196,7 @@ bool DartComponentController::SetupNamespace() {
 }
 
 bool DartComponentController::SetupFromKernel() {
+  TRACE_EVENT0("dart", "DartComponentController::SetupFromKernel");
   dart_utils::MappedResource manifest;
   if (!dart_utils::MappedResource::LoadFromNamespace(
           namespace_, data_path_ + "/app.dilplist", manifest)) {
@@ -266,6 +269,7 @@ bool DartComponentController::SetupFromAppSnapshot() {
 #if !defined(AOT_RUNTIME)
   return false;
 #else
+  TRACE_EVENT0("dart", "DartComponentController::SetupFromAppSnapshot");
   // Load the ELF snapshot as available, and fall back to a blobs snapshot
   // otherwise.
   const uint8_t *isolate_data, *isolate_instructions;
@@ -310,6 +314,7 @@ int DartComponentController::SetupFileDescriptor(
 bool DartComponentController::CreateIsolate(
     const uint8_t* isolate_snapshot_data,
     const uint8_t* isolate_snapshot_instructions) {
+  TRACE_EVENT0("dart", "DartComponentController::CreateIsolate");
   // Create the isolate from the snapshot.
   char* error = nullptr;
 
@@ -187,7 +187,7 @@ static void PrintNodeSizeError(uint32_t node_id) {
 }
 
 void AccessibilityBridge::AddSemanticsNodeUpdate(
-    const flutter::SemanticsNodeUpdates update) {
+    const flutter::SemanticsNodeUpdates& update) {
   if (update.empty()) {
     return;
   }
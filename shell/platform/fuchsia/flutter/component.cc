@@ -26,6 +26,7 @@
 
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/switches.h"
@@ -83,16 +84,18 @@ ActiveApplication Application::Create(
     fuchsia::sys::Package package,
     fuchsia::sys::StartupInfo startup_info,
     std::shared_ptr<sys::ServiceDirectory> runner_incoming_services,
-    fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller) {
-  std::unique_ptr<Thread> thread = std::make_unique<Thread>();
+    fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller,
+    WarmPool* warm_pool) {
+  std::unique_ptr<Thread> thread = warm_pool->TakeThread();
   std::unique_ptr<Application> application;
 
   fml::AutoResetWaitableEvent latch;
   async::PostTask(thread->dispatcher(), [&]() mutable {
+    TRACE_EVENT0("flutter", "Application::Application");
     application.reset(
         new Application(std::move(termination_callback), std::move(package),
                         std::move(startup_info), runner_incoming_services,
-                        std::move(controller)));
+                        std::move(controller), warm_pool));
     latch.Signal();
   });
 
@@ -109,54 +112,18 @@ static std::string DebugLabelForURL(const std::string& url) {
   }
 }
 
-static std::unique_ptr<fml::FileMapping> MakeFileMapping(const char* path,
-                                                         bool executable) {
-  uint32_t flags = OPEN_RIGHT_READABLE;
-  if (executable) {
-    flags |= OPEN_RIGHT_EXECUTABLE;
-  }
-
-  int fd = 0;
-  // The returned file descriptor is compatible with standard posix operations
-  // such as close, mmap, etc. We only need to treat open/open_at specially.
-  zx_status_t status = fdio_open_fd(path, flags, &fd);
-
-  if (status != ZX_OK) {
-    return nullptr;
-  }
-
-  using Protection = fml::FileMapping::Protection;
-
-  std::initializer_list<Protection> protection_execute = {Protection::kRead,
-                                                          Protection::kExecute};
-  std::initializer_list<Protection> protection_read = {Protection::kRead};
-  auto mapping = std::make_unique<fml::FileMapping>(
-      fml::UniqueFD{fd}, executable ? protection_execute : protection_read);
-
-  if (!mapping->IsValid()) {
-    return nullptr;
-  }
-
-  return mapping;
-}
-
-// Defaults to readonly. If executable is `true`, we treat it as `read + exec`.
-static flutter::MappingCallback MakeDataFileMapping(const char* absolute_path,
-                                                    bool executable = false) {
-  return [absolute_path, executable = executable](void) {
-    return MakeFileMapping(absolute_path, executable);
-  };
-}
-
 Application::Application(
     TerminationCallback termination_callback,
     fuchsia::sys::Package package,
     fuchsia::sys::StartupInfo startup_info,
     std::shared_ptr<sys::ServiceDirectory> runner_incoming_services,
     fidl::InterfaceRequest<fuchsia::sys::ComponentController>
-        application_controller_request)
+        application_controller_request,
+    WarmPool* warm_pool)
     : termination_callback_(std::move(termination_callback)),
       debug_label_(DebugLabelForURL(startup_info.launch_info.url)),
+      warm_pool_(warm_pool),
+      package_key_(WarmPool::GetPackageKey(package.resolved_url)),
       application_controller_(this),
       outgoing_dir_(new vfs::PseudoDir()),
       runner_incoming_services_(runner_incoming_services),
@@ -184,30 +151,34 @@ Application::Application(
     return;
   }
 
-  // Setup /tmp to be mapped to the process-local memfs.
-  dart_utils::RunnerTemp::SetupComponent(fdio_ns_.get());
-
-  // LaunchInfo::flat_namespace optional.
-  for (size_t i = 0; i < startup_info.flat_namespace.paths.size(); ++i) {
-    const auto& path = startup_info.flat_namespace.paths.at(i);
-    if (path == kTmpPath) {
-      continue;
-    }
-
-    zx::channel dir;
-    if (path == kServiceRootPath) {
-      svc_ = std::make_unique<sys::ServiceDirectory>(
-          std::move(startup_info.flat_namespace.directories.at(i)));
-      dir = svc_->CloneChannel().TakeChannel();
-    } else {
-      dir = std::move(startup_info.flat_namespace.directories.at(i));
+  {
+    TRACE_EVENT0("flutter", "Application::SetupNamespace");
+    // Setup /tmp to be mapped to the process-local memfs.
+    dart_utils::RunnerTemp::SetupComponent(fdio_ns_.get());
+
+    // LaunchInfo::flat_namespace optional.
+    for (size_t i = 0; i < startup_info.flat_namespace.paths.size(); ++i) {
+      const auto& path = startup_info.flat_namespace.paths.at(i);
+      if (path == kTmpPath) {
+        continue;
+      }
+
+      zx::channel dir;
+      if (path == kServiceRootPath) {
+        svc_ = std::make_unique<sys::ServiceDirectory>(
+            std::move(startup_info.flat_namespace.directories.at(i)));
+        dir = svc_->CloneChannel().TakeChannel();
+      } else {
+        dir = std::move(startup_info.flat_namespace.directories.at(i));
+      }
+
+      zx_handle_t dir_handle = dir.release();
+      if (fdio_ns_bind(fdio_ns_.get(), path.data(), dir_handle) != ZX_OK) {
+        FML_DLOG(ERROR) << "Could not bind path to namespace: " << path;
+        zx_handle_close(dir_handle);
+      }
     }
 
-    zx_handle_t dir_handle = dir.release();
-    if (fdio_ns_bind(fdio_ns_.get(), path.data(), dir_handle) != ZX_OK) {
-      FML_DLOG(ERROR) << "Could not bind path to namespace: " << path;
-      zx_handle_close(dir_handle);
-    }
   }
 
   {
@@ -309,13 +280,13 @@ Application::Application(
 
   // Compare flutter_jit_runner in BUILD.gn.
   settings_.vm_snapshot_data =
-      MakeDataFileMapping("/pkg/data/vm_snapshot_data.bin");
-  settings_.vm_snapshot_instr =
-      MakeDataFileMapping("/pkg/data/vm_snapshot_instructions.bin", true);
+      warm_pool_->GetRunnerFileMapping("/pkg/data/vm_snapshot_data.bin");
+  settings_.vm_snapshot_instr = warm_pool_->GetRunnerFileMapping(
+      "/pkg/data/vm_snapshot_instructions.bin", true);
 
-  settings_.isolate_snapshot_data =
-      MakeDataFileMapping("/pkg/data/isolate_core_snapshot_data.bin");
-  settings_.isolate_snapshot_instr = MakeDataFileMapping(
+  settings_.isolate_snapshot_data = warm_pool_->GetRunnerFileMapping(
+      "/pkg/data/isolate_core_snapshot_data.bin");
+  settings_.isolate_snapshot_instr = warm_pool_->GetRunnerFileMapping(
       "/pkg/data/isolate_core_snapshot_instructions.bin", true);
 
   {
@@ -328,14 +299,14 @@ Application::Application(
                                        "app.frameworkversion",
                                        &app_framework) &&
         (runner_framework.compare(app_framework) == 0)) {
-      settings_.vm_snapshot_data =
-          MakeDataFileMapping("/pkg/data/framework_vm_snapshot_data.bin");
-      settings_.vm_snapshot_instr =
-          MakeDataFileMapping("/pkg/data/vm_snapshot_instructions.bin", true);
+      settings_.vm_snapshot_data = warm_pool_->GetRunnerFileMapping(
+          "/pkg/data/framework_vm_snapshot_data.bin");
+      settings_.vm_snapshot_instr = warm_pool_->GetRunnerFileMapping(
+          "/pkg/data/vm_snapshot_instructions.bin", true);
 
-      settings_.isolate_snapshot_data = MakeDataFileMapping(
+      settings_.isolate_snapshot_data = warm_pool_->GetRunnerFileMapping(
           "/pkg/data/framework_isolate_core_snapshot_data.bin");
-      settings_.isolate_snapshot_instr = MakeDataFileMapping(
+      settings_.isolate_snapshot_instr = warm_pool_->GetRunnerFileMapping(
           "/pkg/data/isolate_core_snapshot_instructions.bin", true);
 
       FML_LOG(INFO) << "Using snapshot with framework for "
@@ -534,6 +505,15 @@ void Application::AttemptVMLaunchWithCurrentSettings(
     return;
   }
 
+  // Components of a package started before share its isolate snapshot. The VM
+  // is already running then, as they keep it alive while they run.
+  isolate_snapshot_ = warm_pool_->GetPackageSnapshot(package_key_);
+  if (isolate_snapshot_ && flutter::DartVMRef::IsInstanceRunning()) {
+    TRACE_EVENT_INSTANT0("flutter", "ReusedPackageSnapshot");
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "Application::LoadSnapshots");
   // Compare with flutter_aot_app in flutter_app.gni.
   fml::RefPtr<flutter::DartSnapshot> vm_snapshot;
 
@@ -573,6 +553,8 @@ void Application::AttemptVMLaunchWithCurrentSettings(
                                  "isolate_snapshot_instructions.bin", true));
   }
 
+  warm_pool_->PutPackageSnapshot(package_key_, isolate_snapshot_);
+
   auto vm = flutter::DartVMRef::Create(settings_,               //
                                        std::move(vm_snapshot),  //
                                        isolate_snapshot_        //
@@ -655,7 +637,8 @@ void Application::CreateViewWithViewRef(
       },
       std::move(fdio_ns_),            // FDIO namespace
       std::move(directory_request_),  // outgoing request
-      product_config_                 // product configuration
+      product_config_,                // product configuration
+      warm_pool_                      // warm pool
       ));
 }
 
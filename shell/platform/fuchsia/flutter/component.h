@@ -28,6 +28,7 @@
 #include "flutter_runner_product_configuration.h"
 #include "thread.h"
 #include "unique_fdio_ns.h"
+#include "warm_pool.h"
 
 namespace flutter_runner {
 
@@ -58,13 +59,15 @@ class Application final : public Engine::Delegate,
 
   // Creates a dedicated thread to run the application and constructions the
   // application on it. The application can be accessed only on this thread.
-  // This is a synchronous operation.
+  // This is a synchronous operation. The threads and snapshots of the
+  // application come from |warm_pool|, which must outlive it.
   static ActiveApplication Create(
       TerminationCallback termination_callback,
       fuchsia::sys::Package package,
       fuchsia::sys::StartupInfo startup_info,
       std::shared_ptr<sys::ServiceDirectory> runner_incoming_services,
-      fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller);
+      fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller,
+      WarmPool* warm_pool);
 
   // Must be called on the same thread returned from the create call. The thread
   // may be collected after.
@@ -86,6 +89,8 @@ class Application final : public Engine::Delegate,
   FlutterRunnerProductConfiguration product_config_;
   TerminationCallback termination_callback_;
   const std::string debug_label_;
+  WarmPool* const warm_pool_;
+  const std::string package_key_;
   UniqueFDIONS fdio_ns_ = UniqueFDIONSCreate();
   fml::UniqueFD application_data_directory_;
   fml::UniqueFD application_assets_directory_;
@@ -109,7 +114,8 @@ class Application final : public Engine::Delegate,
       fuchsia::sys::Package package,
       fuchsia::sys::StartupInfo startup_info,
       std::shared_ptr<sys::ServiceDirectory> runner_incoming_services,
-      fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller);
+      fidl::InterfaceRequest<fuchsia::sys::ComponentController> controller,
+      WarmPool* warm_pool);
 
   // |fuchsia::sys::ComponentController|
   void Kill() override;
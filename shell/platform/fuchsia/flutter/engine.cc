@@ -61,7 +61,8 @@ Engine::Engine(Delegate& delegate,
                scenic::ViewRefPair view_ref_pair,
                UniqueFDIONS fdio_ns,
                fidl::InterfaceRequest<fuchsia::io::Directory> directory_request,
-               FlutterRunnerProductConfiguration product_config)
+               FlutterRunnerProductConfiguration product_config,
+               WarmPool* warm_pool)
     : delegate_(delegate),
       thread_label_(std::move(thread_label)),
       settings_(std::move(settings)),
@@ -71,10 +72,11 @@ Engine::Engine(Delegate& delegate,
     return;
   }
 
-  // Launch the threads that will be used to run the shell. These threads will
-  // be joined in the destructor.
+  // Take the threads that will be used to run the shell, which the warm pool
+  // usually has started already. These threads will be joined in the
+  // destructor.
   for (auto& thread : threads_) {
-    thread.reset(new Thread());
+    thread = warm_pool->TakeThread();
   }
 
   // Set up the session connection.
@@ -20,6 +20,7 @@
 #include "flutter_runner_product_configuration.h"
 #include "isolate_configurator.h"
 #include "thread.h"
+#include "warm_pool.h"
 
 namespace flutter_runner {
 
@@ -42,7 +43,8 @@ class Engine final {
          scenic::ViewRefPair view_ref_pair,
          UniqueFDIONS fdio_ns,
          fidl::InterfaceRequest<fuchsia::io::Directory> directory_request,
-         FlutterRunnerProductConfiguration product_config);
+         FlutterRunnerProductConfiguration product_config,
+         WarmPool* warm_pool);
   ~Engine();
 
   // Returns the Dart return code for the root isolate if one is present. This
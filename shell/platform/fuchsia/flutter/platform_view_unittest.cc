@@ -61,6 +61,8 @@ class MockPlatformViewDelegate : public flutter::PlatformView::Delegate {
   void OnPlatformViewDispatchPointerDataPacket(
       std::unique_ptr<flutter::PointerDataPacket> packet) {}
   // |flutter::PlatformView::Delegate|
+  void OnPlatformViewDispatchEventBatch(flutter::PlatformEventBatch batch) {}
+  // |flutter::PlatformView::Delegate|
   void OnPlatformViewDispatchSemanticsAction(int32_t id,
                                              flutter::SemanticsAction action,
                                              std::vector<uint8_t> args) {}
@@ -69,6 +71,8 @@ class MockPlatformViewDelegate : public flutter::PlatformView::Delegate {
     semantics_enabled_ = enabled;
   }
   // |flutter::PlatformView::Delegate|
+  void OnPlatformViewSetSemanticsClientActive(bool active) {}
+  // |flutter::PlatformView::Delegate|
   void OnPlatformViewSetAccessibilityFeatures(int32_t flags) {
     semantics_features_ = flags;
   }
@@ -170,6 +170,9 @@ Runner::Runner(async::Loop* loop, sys::ComponentContext* context)
   context_->outgoing()->AddPublicService<fuchsia::sys::Runner>(
       std::bind(&Runner::RegisterApplication, this, std::placeholders::_1));
 
+  // Start the threads of the first component once the runner is idle.
+  async::PostTask(loop_->dispatcher(), [this]() { warm_pool_.Refill(); });
+
 #if !defined(DART_PRODUCT)
   if (Dart_IsPrecompiledRuntime()) {
     RegisterProfilerSymbols("pkg/data/flutter_aot_runner.dartprofilersymbols",
@@ -227,11 +230,16 @@ void Runner::StartComponent(
       std::move(package),               // application package
       std::move(startup_info),          // startup info
       context_->svc(),                  // runner incoming services
-      std::move(controller)             // controller request
+      std::move(controller),            // controller request
+      &warm_pool_                       // warm pool
   );
 
   auto key = active_application.application.get();
   active_applications_[key] = std::move(active_application);
+
+  // Replace the threads the component took once the runner is idle, so that
+  // the next component doesn't wait for its threads to start.
+  async::PostTask(loop_->dispatcher(), [this]() { warm_pool_.Refill(); });
 }
 
 void Runner::OnApplicationTerminate(const Application* application) {
@@ -18,6 +18,7 @@
 #include "flutter/fml/macros.h"
 #include "lib/fidl/cpp/binding_set.h"
 #include "runtime/dart/utils/vmservice_object.h"
+#include "warm_pool.h"
 
 namespace flutter_runner {
 
@@ -34,6 +35,8 @@ class Runner final : public fuchsia::sys::Runner {
   async::Loop* loop_;
 
   sys::ComponentContext* context_;
+  // Outlives the applications, which take from it.
+  WarmPool warm_pool_;
   fidl::BindingSet<fuchsia::sys::Runner> active_applications_bindings_;
   std::unordered_map<const Application*, ActiveApplication>
       active_applications_;
@@ -100,6 +100,7 @@ void SessionConnection::Present(
   next_present_session_trace_id_++;
 
   present_requested_time_ = fml::TimePoint::Now();
+  VsyncRecorder::GetInstance().RecordPresentRequested(present_requested_time_);
 
   // Throttle frame submission to Scenic if we already have the maximum amount
   // of frames in flight. This allows the paint tasks for this frame to execute
@@ -117,7 +118,10 @@ void SessionConnection::Present(
 
   if (frame) {
     // Execute paint tasks and signal fences.
+    const fml::TimePoint paint_start = fml::TimePoint::Now();
     auto surfaces_to_submit = scene_update_context_.ExecutePaintTasks(*frame);
+    VsyncRecorder::GetInstance().RecordRasterDuration(fml::TimePoint::Now() -
+                                                      paint_start);
 
     // Tell the surface producer that a present has occurred so it can perform
     // book-keeping on buffer caches.
@@ -201,10 +205,15 @@ void SessionConnection::PresentSession() {
   fml::TimeDelta presentation_interval =
       VsyncRecorder::GetInstance().GetCurrentVsyncInfo().presentation_interval;
 
+  // The paint tasks of the frame still have to run after the ops are flushed,
+  // so don't target a latch point they can't make.
+  fml::TimeDelta raster_duration =
+      VsyncRecorder::GetInstance().GetPredictedRasterDuration();
+
   fml::TimePoint next_latch_point = CalculateNextLatchPoint(
-      fml::TimePoint::Now(), present_requested_time_,
+      present_requested_time_, fml::TimePoint::Now(),
       last_latch_point_targeted_,
-      fml::TimeDelta::FromMicroseconds(0),  // flutter_frame_build_time
+      raster_duration,  // flutter_frame_build_time
       presentation_interval, future_presentation_infos_);
 
   last_latch_point_targeted_ = next_latch_point;
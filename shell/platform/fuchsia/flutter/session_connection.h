@@ -115,7 +115,11 @@ class SessionConnection final {
   // The maximum number of frames Flutter sent to Scenic that it can have
   // outstanding at any time. This is equivalent to how many times it has
   // called Present2() before receiving an OnFramePresented() event.
-  static constexpr int kMaxFramesInFlight = 3;
+  //
+  // Frames are started just in time for Scenic's predicted latch points (see
+  // |VsyncWaiter::AwaitVSync|), so queueing more than one present would only
+  // add latency.
+  static constexpr int kMaxFramesInFlight = 1;
   int frames_in_flight_ = 0;
 
   int frames_in_flight_allowed_ = 0;
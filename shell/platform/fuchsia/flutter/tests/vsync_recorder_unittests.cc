@@ -131,4 +131,49 @@ TEST(VsyncRecorderTest, FramePresentedInfo_IsUpdatedCorrectly) {
       fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromNanoseconds(time3)));
 }
 
+TEST(VsyncRecorderTest, FuturePresentations_AreUpdatedCorrectly) {
+  std::vector<fuchsia::scenic::scheduling::PresentationInfo>
+      future_presentations = {};
+  future_presentations.push_back(
+      CreatePresentationInfo(/*latch_point=*/55, /*presentation_time=*/60));
+  future_presentations.push_back(
+      CreatePresentationInfo(/*latch_point=*/65, /*presentation_time=*/70));
+  VsyncRecorder::GetInstance().UpdateNextPresentationInfo(
+      {.future_presentations = std::move(future_presentations),
+       .remaining_presents_in_flight_allowed = 1});
+
+  auto presentations = VsyncRecorder::GetInstance().GetFuturePresentations();
+  ASSERT_EQ(presentations.size(), 2u);
+  EXPECT_EQ(
+      presentations[0].latch_point,
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromNanoseconds(55)));
+  EXPECT_EQ(
+      presentations[1].presentation_time,
+      fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromNanoseconds(70)));
+}
+
+TEST(VsyncRecorderTest, PredictedDurations_AreTheLongestRecentOnes) {
+  const auto start = fml::TimePoint::Now();
+
+  VsyncRecorder::GetInstance().RecordFrameStart(start);
+  VsyncRecorder::GetInstance().RecordPresentRequested(
+      start + fml::TimeDelta::FromMilliseconds(4));
+  VsyncRecorder::GetInstance().RecordFrameStart(start);
+  VsyncRecorder::GetInstance().RecordPresentRequested(
+      start + fml::TimeDelta::FromMilliseconds(2));
+  // A present without a frame start is not recorded.
+  VsyncRecorder::GetInstance().RecordPresentRequested(
+      start + fml::TimeDelta::FromMilliseconds(100));
+
+  VsyncRecorder::GetInstance().RecordRasterDuration(
+      fml::TimeDelta::FromMilliseconds(3));
+  VsyncRecorder::GetInstance().RecordRasterDuration(
+      fml::TimeDelta::FromMilliseconds(1));
+
+  EXPECT_EQ(VsyncRecorder::GetInstance().GetPredictedUiDuration(),
+            fml::TimeDelta::FromMilliseconds(4));
+  EXPECT_EQ(VsyncRecorder::GetInstance().GetPredictedRasterDuration(),
+            fml::TimeDelta::FromMilliseconds(3));
+}
+
 }  // namespace flutter_runner_test
@@ -4,6 +4,7 @@
 
 #include "vsync_recorder.h"
 
+#include <algorithm>
 #include <mutex>
 
 namespace flutter_runner {
@@ -17,6 +18,11 @@ std::mutex g_mutex;
 static constexpr fml::TimeDelta kDefaultPresentationInterval =
     fml::TimeDelta::FromSecondsF(1.0 / 60.0);
 
+template <size_t N>
+fml::TimeDelta MaxDuration(const std::array<fml::TimeDelta, N>& durations) {
+  return *std::max_element(durations.begin(), durations.end());
+}
+
 }  // namespace
 
 VsyncRecorder& VsyncRecorder::GetInstance() {
@@ -37,6 +43,15 @@ void VsyncRecorder::UpdateNextPresentationInfo(
     fuchsia::scenic::scheduling::FuturePresentationTimes info) {
   std::unique_lock<std::mutex> lock(g_mutex);
 
+  future_presentations_.clear();
+  for (auto& presentation_info : info.future_presentations) {
+    future_presentations_.push_back(
+        {fml::TimePoint::FromEpochDelta(
+             fml::TimeDelta::FromNanoseconds(presentation_info.latch_point())),
+         fml::TimePoint::FromEpochDelta(fml::TimeDelta::FromNanoseconds(
+             presentation_info.presentation_time()))});
+  }
+
   auto next_time = next_presentation_info_.presentation_time();
   // Get the earliest vsync time that is after our recorded |presentation_time|.
   for (auto& presentation_info : info.future_presentations) {
@@ -58,4 +73,43 @@ fml::TimePoint VsyncRecorder::GetLastPresentationTime() const {
   return last_presentation_time_;
 }
 
+std::vector<FuturePresentation> VsyncRecorder::GetFuturePresentations() const {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  return future_presentations_;
+}
+
+void VsyncRecorder::RecordFrameStart(fml::TimePoint frame_start) {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  frame_start_ = frame_start;
+}
+
+void VsyncRecorder::RecordPresentRequested(fml::TimePoint present_requested) {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  // Presents that weren't preceded by a vsync callback (for example the ones
+  // made during initialization) don't tell us anything about the UI thread.
+  if (!frame_start_ || *frame_start_ > present_requested) {
+    return;
+  }
+  ui_durations_[ui_durations_index_] = present_requested - *frame_start_;
+  ui_durations_index_ = (ui_durations_index_ + 1) % kDurationHistorySize;
+  frame_start_.reset();
+}
+
+void VsyncRecorder::RecordRasterDuration(fml::TimeDelta raster_duration) {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  raster_durations_[raster_durations_index_] = raster_duration;
+  raster_durations_index_ =
+      (raster_durations_index_ + 1) % kDurationHistorySize;
+}
+
+fml::TimeDelta VsyncRecorder::GetPredictedUiDuration() const {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  return MaxDuration(ui_durations_);
+}
+
+fml::TimeDelta VsyncRecorder::GetPredictedRasterDuration() const {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  return MaxDuration(raster_durations_);
+}
+
 }  // namespace flutter_runner
@@ -5,7 +5,9 @@
 #ifndef FLUTTER_SHELL_PLATFORM_FUCHSIA_VSYNC_RECORDER_H_
 #define FLUTTER_SHELL_PLATFORM_FUCHSIA_VSYNC_RECORDER_H_
 
+#include <array>
 #include <optional>
+#include <vector>
 
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
@@ -18,6 +20,13 @@ struct VsyncInfo {
   fml::TimeDelta presentation_interval;
 };
 
+// A future presentation predicted by Scenic: the content of a frame submitted
+// before |latch_point| is expected on screen at |presentation_time|.
+struct FuturePresentation {
+  fml::TimePoint latch_point;
+  fml::TimePoint presentation_time;
+};
+
 class VsyncRecorder {
  public:
   static VsyncRecorder& GetInstance();
@@ -39,11 +48,50 @@ class VsyncRecorder {
 
   fml::TimePoint GetLastPresentationTime() const;
 
+  // Retrieve all of the future presentations from the most recent
+  // |FuturePresentationTimes| provided to us by Scenic, in order.  This
+  // function is safe to call from any thread.
+  std::vector<FuturePresentation> GetFuturePresentations() const;
+
+  // Record that the UI thread started working on a frame at |frame_start|.
+  // This function is safe to call from any thread.
+  void RecordFrameStart(fml::TimePoint frame_start);
+
+  // Record that the frame started by the last |RecordFrameStart| was handed to
+  // |SessionConnection::Present| at |present_requested|, after its UI work and
+  // scene update.  This function is safe to call from any thread.
+  void RecordPresentRequested(fml::TimePoint present_requested);
+
+  // Record how long the raster thread took to execute the paint tasks of a
+  // frame.  This function is safe to call from any thread.
+  void RecordRasterDuration(fml::TimeDelta raster_duration);
+
+  // The time the UI work of a frame is expected to take, from the vsync
+  // callback to |SessionConnection::Present|.  This is the longest of the
+  // recently recorded durations so that a single fast frame doesn't make us
+  // start the next one too late.  This function is safe to call from any
+  // thread.
+  fml::TimeDelta GetPredictedUiDuration() const;
+
+  // The time the paint tasks of a frame are expected to take.  This function
+  // is safe to call from any thread.
+  fml::TimeDelta GetPredictedRasterDuration() const;
+
  private:
+  // The number of recent frames the durations are predicted from.
+  static constexpr size_t kDurationHistorySize = 8;
+
   VsyncRecorder() { next_presentation_info_.set_presentation_time(0); }
 
   fuchsia::scenic::scheduling::PresentationInfo next_presentation_info_;
   fml::TimePoint last_presentation_time_ = fml::TimePoint::Now();
+  std::vector<FuturePresentation> future_presentations_;
+
+  std::optional<fml::TimePoint> frame_start_;
+  std::array<fml::TimeDelta, kDurationHistorySize> ui_durations_ = {};
+  size_t ui_durations_index_ = 0;
+  std::array<fml::TimeDelta, kDurationHistorySize> raster_durations_ = {};
+  size_t raster_durations_index_ = 0;
 
   // Disallow copy and assignment.
   VsyncRecorder(const VsyncRecorder&) = delete;
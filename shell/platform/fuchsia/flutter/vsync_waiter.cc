@@ -4,6 +4,7 @@
 
 #include "vsync_waiter.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <lib/async/default.h>
@@ -134,26 +135,64 @@ fml::TimePoint VsyncWaiter::SnapToNextPhase(
   }
 }
 
+std::optional<FuturePresentation> VsyncWaiter::SelectNextPresentation(
+    const fml::TimePoint now,
+    const fml::TimeDelta frame_build_time,
+    const std::vector<FuturePresentation>& future_presentations) {
+  for (const auto& presentation : future_presentations) {
+    if (presentation.latch_point - frame_build_time >= now) {
+      return presentation;
+    }
+  }
+  return std::nullopt;
+}
+
+fml::TimePoint VsyncWaiter::CalculateFrameStartTime(
+    const FuturePresentation& presentation,
+    const fml::TimeDelta frame_build_time,
+    const fml::TimeDelta vsync_offset) {
+  return std::min(presentation.latch_point - frame_build_time,
+                  presentation.presentation_time - vsync_offset);
+}
+
 void VsyncWaiter::AwaitVSync() {
-  VsyncInfo vsync_info = VsyncRecorder::GetInstance().GetCurrentVsyncInfo();
+  VsyncRecorder& recorder = VsyncRecorder::GetInstance();
+  VsyncInfo vsync_info = recorder.GetCurrentVsyncInfo();
 
   fml::TimePoint now = fml::TimePoint::Now();
-  fml::TimePoint last_presentation_time =
-      VsyncRecorder::GetInstance().GetLastPresentationTime();
 
-  fml::TimePoint next_vsync =
-      VsyncRecorder::GetInstance().GetCurrentVsyncInfo().presentation_time;
+  // Prefer Scenic's predictions: start the frame just in time for the earliest
+  // latch point it can still make given how long recent frames took.
+  const fml::TimeDelta frame_build_time =
+      recorder.GetPredictedUiDuration() + recorder.GetPredictedRasterDuration();
+  target_presentation_ = SelectNextPresentation(
+      now, frame_build_time, recorder.GetFuturePresentations());
+
+  fml::TimePoint next_vsync_start_time;
+  if (target_presentation_) {
+    next_vsync_start_time = std::max(
+        now, CalculateFrameStartTime(*target_presentation_, frame_build_time,
+                                     vsync_offset_));
+  } else {
+    fml::TimePoint last_presentation_time =
+        recorder.GetLastPresentationTime();
+    fml::TimePoint next_vsync = vsync_info.presentation_time;
 
-  if (next_vsync <= now) {
-    next_vsync = SnapToNextPhase(now, last_presentation_time,
-                                 vsync_info.presentation_interval);
-  }
+    if (next_vsync <= now) {
+      next_vsync = SnapToNextPhase(now, last_presentation_time,
+                                   vsync_info.presentation_interval);
+    }
 
-  auto next_vsync_start_time = next_vsync - vsync_offset_;
+    next_vsync_start_time = next_vsync - vsync_offset_;
 
-  if (now >= next_vsync_start_time)
-    next_vsync_start_time =
-        next_vsync_start_time + vsync_info.presentation_interval;
+    if (now >= next_vsync_start_time)
+      next_vsync_start_time =
+          next_vsync_start_time + vsync_info.presentation_interval;
+  }
+
+  TRACE_EVENT2("flutter", "VsyncWaiter::AwaitVSync", "predicted",
+               target_presentation_ ? 1 : 0, "frame_build_time_us",
+               frame_build_time.ToMicroseconds());
 
   fml::TimeDelta delta = next_vsync_start_time - now;
 
@@ -183,20 +222,24 @@ void VsyncWaiter::FireCallbackWhenSessionAvailable() {
 void VsyncWaiter::FireCallbackNow() {
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
-  VsyncInfo vsync_info = VsyncRecorder::GetInstance().GetCurrentVsyncInfo();
+  VsyncRecorder& recorder = VsyncRecorder::GetInstance();
+  VsyncInfo vsync_info = recorder.GetCurrentVsyncInfo();
 
   fml::TimePoint now = fml::TimePoint::Now();
-  fml::TimePoint last_presentation_time =
-      VsyncRecorder::GetInstance().GetLastPresentationTime();
-  fml::TimePoint next_vsync =
-      VsyncRecorder::GetInstance().GetCurrentVsyncInfo().presentation_time;
-
-  if (next_vsync <= now) {
-    next_vsync = SnapToNextPhase(now, last_presentation_time,
+  fml::TimePoint next_vsync = vsync_info.presentation_time;
+
+  // Target the presentation the callback was scheduled for, unless waiting for
+  // the session made us miss it.
+  if (target_presentation_ && target_presentation_->presentation_time > now) {
+    next_vsync = target_presentation_->presentation_time;
+  } else if (next_vsync <= now) {
+    next_vsync = SnapToNextPhase(now, recorder.GetLastPresentationTime(),
                                  vsync_info.presentation_interval);
   }
+  target_presentation_.reset();
   fml::TimePoint previous_vsync = next_vsync - vsync_info.presentation_interval;
 
+  recorder.RecordFrameStart(now);
   FireCallback(previous_vsync, next_vsync);
 }
 
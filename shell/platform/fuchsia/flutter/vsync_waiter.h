@@ -7,12 +7,16 @@
 
 #include <lib/async/cpp/wait.h>
 
+#include <optional>
+#include <vector>
+
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/vsync_waiter.h"
 #include "flutter_runner_product_configuration.h"
+#include "vsync_recorder.h"
 
 namespace flutter_runner {
 
@@ -32,11 +36,31 @@ class VsyncWaiter final : public flutter::VsyncWaiter {
       const fml::TimePoint last_frame_presentation_time,
       const fml::TimeDelta presentation_interval);
 
+  // Returns the earliest of |future_presentations| whose latch point can still
+  // be met by a frame started now that takes |frame_build_time|, or nothing if
+  // Scenic predicted none.
+  static std::optional<FuturePresentation> SelectNextPresentation(
+      const fml::TimePoint now,
+      const fml::TimeDelta frame_build_time,
+      const std::vector<FuturePresentation>& future_presentations);
+
+  // Returns when the UI thread should start working on a frame targeting
+  // |presentation| so that it is ready just in time for its latch point, and
+  // at least |vsync_offset| before it is presented.
+  static fml::TimePoint CalculateFrameStartTime(
+      const FuturePresentation& presentation,
+      const fml::TimeDelta frame_build_time,
+      const fml::TimeDelta vsync_offset);
+
  private:
   const std::string debug_label_;
   async::Wait session_wait_;
   fml::TimeDelta vsync_offset_ = fml::TimeDelta::FromMicroseconds(0);
 
+  // The presentation the pending vsync callback targets. Only accessed on the
+  // UI thread.
+  std::optional<FuturePresentation> target_presentation_;
+
   fml::WeakPtrFactory<VsyncWaiter> weak_factory_;
 
   // For accessing the VsyncWaiter via the UI thread, necessary for the callback
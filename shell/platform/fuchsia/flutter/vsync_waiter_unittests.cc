@@ -132,4 +132,55 @@ TEST_F(VsyncWaiterTest, SnapToNextPhaseAfterNowMultiJumpAccountForCeils) {
   EXPECT_EQ(now + fml::TimeDelta::FromNanoseconds(12), next_vsync);
 }
 
+static flutter_runner::FuturePresentation MakePresentation(
+    const fml::TimePoint base,
+    int latch_point_ns,
+    int presentation_time_ns) {
+  return {base + fml::TimeDelta::FromNanoseconds(latch_point_ns),
+          base + fml::TimeDelta::FromNanoseconds(presentation_time_ns)};
+}
+
+TEST_F(VsyncWaiterTest, SelectNextPresentationWithoutPredictions) {
+  const auto now = fml::TimePoint::Now();
+  const auto presentation = flutter_runner::VsyncWaiter::SelectNextPresentation(
+      now, fml::TimeDelta::FromNanoseconds(5), {});
+
+  EXPECT_FALSE(presentation.has_value());
+}
+
+TEST_F(VsyncWaiterTest, SelectNextPresentationSkipsUnreachableLatchPoints) {
+  const auto now = fml::TimePoint::Now();
+  const std::vector<flutter_runner::FuturePresentation> future_presentations = {
+      MakePresentation(now, 4, 10),   //
+      MakePresentation(now, 14, 20),  //
+      MakePresentation(now, 24, 30),  //
+  };
+  const auto presentation = flutter_runner::VsyncWaiter::SelectNextPresentation(
+      now, fml::TimeDelta::FromNanoseconds(5), future_presentations);
+
+  ASSERT_TRUE(presentation.has_value());
+  EXPECT_EQ(now + fml::TimeDelta::FromNanoseconds(14),
+            presentation->latch_point);
+  EXPECT_EQ(now + fml::TimeDelta::FromNanoseconds(20),
+            presentation->presentation_time);
+}
+
+TEST_F(VsyncWaiterTest, CalculateFrameStartTimeIsJustInTimeForLatchPoint) {
+  const auto now = fml::TimePoint::Now();
+  const auto start_time = flutter_runner::VsyncWaiter::CalculateFrameStartTime(
+      MakePresentation(now, 14, 20), fml::TimeDelta::FromNanoseconds(5),
+      fml::TimeDelta::Zero());
+
+  EXPECT_EQ(now + fml::TimeDelta::FromNanoseconds(9), start_time);
+}
+
+TEST_F(VsyncWaiterTest, CalculateFrameStartTimeHonorsVsyncOffset) {
+  const auto now = fml::TimePoint::Now();
+  const auto start_time = flutter_runner::VsyncWaiter::CalculateFrameStartTime(
+      MakePresentation(now, 14, 20), fml::TimeDelta::FromNanoseconds(5),
+      fml::TimeDelta::FromNanoseconds(15));
+
+  EXPECT_EQ(now + fml::TimeDelta::FromNanoseconds(5), start_time);
+}
+
 }  // namespace flutter_runner_test
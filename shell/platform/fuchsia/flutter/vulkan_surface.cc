@@ -104,17 +104,25 @@ bool CreateVulkanImage(vulkan::VulkanProvider& vulkan_provider,
 }
 
 VulkanSurface::VulkanSurface(vulkan::VulkanProvider& vulkan_provider,
+                             vulkan::VulkanMemoryAllocator& memory_allocator,
                              sk_sp<GrContext> context,
                              scenic::Session* session,
-                             const SkISize& size)
-    : vulkan_provider_(vulkan_provider), session_(session), wait_(this) {
+                             const SkISize& size,
+                             const SkISize& allocation_size)
+    : vulkan_provider_(vulkan_provider),
+      memory_allocator_(memory_allocator),
+      session_(session),
+      wait_(this) {
   FML_DCHECK(session_);
+  FML_DCHECK(allocation_size.width() >= size.width() &&
+             allocation_size.height() >= size.height());
 
   zx::vmo exported_vmo;
-  if (!AllocateDeviceMemory(std::move(context), size, exported_vmo)) {
+  if (!AllocateDeviceMemory(context, allocation_size, exported_vmo)) {
     FML_DLOG(INFO) << "Could not allocate device memory.";
     return;
   }
+  allocated_image_size_ = allocation_size;
 
   uint64_t vmo_size;
   zx_status_t status = exported_vmo.get_size(&vmo_size);
@@ -128,7 +136,16 @@ VulkanSurface::VulkanSurface(vulkan::VulkanProvider& vulkan_provider,
   scenic_memory_ = std::make_unique<scenic::Memory>(
       session, std::move(exported_vmo), vmo_size,
       fuchsia::images::MemoryType::VK_DEVICE_MEMORY);
-  if (!PushSessionImageSetupOps(session)) {
+  if (size != allocation_size) {
+    // Bind the memory to an image of the requested size, which also pushes
+    // the session image setup ops.
+    VulkanImage vulkan_image;
+    if (!CreateVulkanImage(vulkan_provider_, size, &vulkan_image) ||
+        !BindToImage(std::move(context), std::move(vulkan_image))) {
+      FML_DLOG(INFO) << "Could not bind the surface to an image.";
+      return;
+    }
+  } else if (!PushSessionImageSetupOps(session)) {
     FML_DLOG(INFO) << "Could not push session image setup ops.";
     return;
   }
@@ -252,57 +269,27 @@ bool VulkanSurface::AllocateDeviceMemory(sk_sp<GrContext> context,
     }
   }
 
-  VkMemoryDedicatedAllocateInfo dedicated_allocate_info = {
-      .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
-      .pNext = nullptr,
-      .image = vulkan_image_.vk_image,
-      .buffer = VK_NULL_HANDLE};
-  VkExportMemoryAllocateInfoKHR export_allocate_info = {
-      .sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR,
-      .pNext = &dedicated_allocate_info,
-      .handleTypes =
-          VK_EXTERNAL_MEMORY_HANDLE_TYPE_TEMP_ZIRCON_VMO_BIT_FUCHSIA};
-
-  const VkMemoryAllocateInfo alloc_info = {
-      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-      .pNext = &export_allocate_info,
-      .allocationSize = memory_reqs.size,
-      .memoryTypeIndex = memory_type,
-  };
-
-  {
-    TRACE_EVENT1("flutter", "vkAllocateMemory", "allocationSize",
-                 alloc_info.allocationSize);
-    VkDeviceMemory vk_memory = VK_NULL_HANDLE;
-    if (VK_CALL_LOG_ERROR(vulkan_provider_.vk().AllocateMemory(
-            vulkan_provider_.vk_device(), &alloc_info, NULL, &vk_memory)) !=
-        VK_SUCCESS) {
-      return false;
-    }
-
-    vk_memory_ = {vk_memory,
-                  [&vulkan_provider = vulkan_provider_](VkDeviceMemory memory) {
-                    vulkan_provider.vk().FreeMemory(vulkan_provider.vk_device(),
-                                                    memory, NULL);
-                  }};
-
-    vk_memory_info_ = alloc_info;
+  memory_ = memory_allocator_.Allocate(memory_reqs, memory_type);
+  if (!memory_.IsValid()) {
+    return false;
   }
 
   // Bind image memory.
   if (VK_CALL_LOG_ERROR(vulkan_provider_.vk().BindImageMemory(
-          vulkan_provider_.vk_device(), vulkan_image_.vk_image, vk_memory_,
-          0)) != VK_SUCCESS) {
+          vulkan_provider_.vk_device(), vulkan_image_.vk_image,
+          memory_.GetMemory(), memory_.GetOffset())) != VK_SUCCESS) {
     return false;
   }
 
   {
-    // Acquire the VMO for the device memory.
+    // Acquire the VMO for the device memory, which is the whole block the
+    // memory of the surface is in.
     uint32_t vmo_handle = 0;
 
     VkMemoryGetZirconHandleInfoFUCHSIA get_handle_info = {
         VK_STRUCTURE_TYPE_TEMP_MEMORY_GET_ZIRCON_HANDLE_INFO_FUCHSIA, nullptr,
-        vk_memory_, VK_EXTERNAL_MEMORY_HANDLE_TYPE_TEMP_ZIRCON_VMO_BIT_FUCHSIA};
+        memory_.GetMemory(),
+        VK_EXTERNAL_MEMORY_HANDLE_TYPE_TEMP_ZIRCON_VMO_BIT_FUCHSIA};
     if (VK_CALL_LOG_ERROR(vulkan_provider_.vk().GetMemoryZirconHandleFUCHSIA(
             vulkan_provider_.vk_device(), &get_handle_info, &vmo_handle)) !=
         VK_SUCCESS) {
@@ -315,7 +302,7 @@ bool VulkanSurface::AllocateDeviceMemory(sk_sp<GrContext> context,
   // Assert that the VMO size was sufficient.
   size_t vmo_size = 0;
   if (exported_vmo.get_size(&vmo_size) != ZX_OK ||
-      vmo_size < memory_reqs.size) {
+      vmo_size < memory_.GetOffset() + memory_reqs.size) {
     return false;
   }
 
@@ -332,13 +319,15 @@ bool VulkanSurface::SetupSkiaSurface(sk_sp<GrContext> context,
     return false;
   }
 
+  const GrVkAlloc alloc(memory_.GetMemory(), memory_.GetOffset(),
+                        memory_reqs.size, 0);
   const GrVkImageInfo image_info = {
-      vulkan_image_.vk_image,                // image
-      {vk_memory_, 0, memory_reqs.size, 0},  // alloc
-      image_create_info.tiling,              // tiling
-      image_create_info.initialLayout,       // layout
-      image_create_info.format,              // format
-      image_create_info.mipLevels,           // level count
+      vulkan_image_.vk_image,           // image
+      alloc,                            // alloc
+      image_create_info.tiling,         // tiling
+      image_create_info.initialLayout,  // layout
+      image_create_info.format,         // format
+      image_create_info.mipLevels,      // level count
   };
 
   GrBackendRenderTarget sk_render_target(size.width(), size.height(), 0,
@@ -391,7 +380,7 @@ bool VulkanSurface::PushSessionImageSetupOps(scenic::Session* session) {
   }
 
   session_image_ = std::make_unique<scenic::Image>(
-      *scenic_memory_, 0 /* memory offset */, std::move(image_info));
+      *scenic_memory_, memory_.GetOffset(), std::move(image_info));
 
   return session_image_ != nullptr;
 }
@@ -409,15 +398,14 @@ sk_sp<SkSurface> VulkanSurface::GetSkiaSurface() const {
 
 bool VulkanSurface::BindToImage(sk_sp<GrContext> context,
                                 VulkanImage vulkan_image) {
-  FML_DCHECK(vulkan_image.vk_memory_requirements.size <=
-             vk_memory_info_.allocationSize);
+  FML_DCHECK(vulkan_image.vk_memory_requirements.size <= memory_.GetSize());
 
   vulkan_image_ = std::move(vulkan_image);
 
   // Bind image memory.
   if (VK_CALL_LOG_ERROR(vulkan_provider_.vk().BindImageMemory(
-          vulkan_provider_.vk_device(), vulkan_image_.vk_image, vk_memory_,
-          0)) != VK_SUCCESS) {
+          vulkan_provider_.vk_device(), vulkan_image_.vk_image,
+          memory_.GetMemory(), memory_.GetOffset())) != VK_SUCCESS) {
     valid_ = false;
     return false;
   }
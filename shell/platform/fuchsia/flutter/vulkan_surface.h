@@ -16,6 +16,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/vulkan/vulkan_command_buffer.h"
 #include "flutter/vulkan/vulkan_handle.h"
+#include "flutter/vulkan/vulkan_memory_allocator.h"
 #include "flutter/vulkan/vulkan_proc_table.h"
 #include "flutter/vulkan/vulkan_provider.h"
 #include "lib/ui/scenic/cpp/resources.h"
@@ -47,10 +48,16 @@ bool CreateVulkanImage(vulkan::VulkanProvider& vulkan_provider,
 class VulkanSurface final
     : public flutter::SceneUpdateContext::SurfaceProducerSurface {
  public:
+  // Allocates enough memory for an image of |allocation_size|, which must not
+  // be smaller than |size|, so that the surface can later be bound to images
+  // of any size up to |allocation_size| without a new allocation. The memory
+  // comes from |memory_allocator|, which must outlive the surface.
   VulkanSurface(vulkan::VulkanProvider& vulkan_provider,
+                vulkan::VulkanMemoryAllocator& memory_allocator,
                 sk_sp<GrContext> context,
                 scenic::Session* session,
-                const SkISize& size);
+                const SkISize& size,
+                const SkISize& allocation_size);
 
   ~VulkanSurface() override;
 
@@ -97,24 +104,23 @@ class VulkanSurface final
     return command_buffer_fence_;
   }
 
-  size_t GetAllocationSize() const { return vk_memory_info_.allocationSize; }
+  size_t GetAllocationSize() const { return memory_.GetSize(); }
 
   size_t GetImageMemoryRequirementsSize() const {
     return vulkan_image_.vk_memory_requirements.size;
   }
 
-  bool IsOversized() const {
-    return GetAllocationSize() > GetImageMemoryRequirementsSize();
-  }
+  // The size of the image the memory of the surface was allocated for.
+  SkISize GetAllocatedImageSize() const { return allocated_image_size_; }
 
   bool HasStableSizeHistory() const {
     return std::equal(size_history_.begin() + 1, size_history_.end(),
                       size_history_.begin());
   }
 
-  // Bind |vulkan_image| to |vk_memory_| and create a new skia surface,
+  // Bind |vulkan_image| to |memory_| and create a new skia surface,
   // replacing the previous |vk_image_|.  |vulkan_image| MUST require less
-  // than or equal the amount of memory contained in |vk_memory_|. Returns
+  // than or equal the amount of memory contained in |memory_|. Returns
   // whether the swap was successful.  The |VulkanSurface| will become invalid
   // if the swap was not successful.
   bool BindToImage(sk_sp<GrContext> context, VulkanImage vulkan_image);
@@ -182,10 +188,11 @@ class VulkanSurface final
       const zx::event& event) const;
 
   vulkan::VulkanProvider& vulkan_provider_;
+  vulkan::VulkanMemoryAllocator& memory_allocator_;
   scenic::Session* session_;
   VulkanImage vulkan_image_;
-  vulkan::VulkanHandle<VkDeviceMemory> vk_memory_;
-  VkMemoryAllocateInfo vk_memory_info_;
+  // A range of a block of device memory that other surfaces share.
+  vulkan::VulkanMemoryAllocation memory_;
   vulkan::VulkanHandle<VkFence> command_buffer_fence_;
   sk_sp<SkSurface> sk_surface_;
   // TODO: Don't heap allocate this once SCN-268 is resolved.
@@ -197,6 +204,7 @@ class VulkanSurface final
   zx::event release_event_;
   async::WaitMethod<VulkanSurface, &VulkanSurface::OnHandleReady> wait_;
   std::function<void()> pending_on_writes_committed_;
+  SkISize allocated_image_size_ = SkISize::MakeEmpty();
   std::array<SkISize, kSizeHistorySize> size_history_;
   int size_history_index_ = 0;
   size_t age_ = 0;
@@ -19,6 +19,19 @@ std::string ToString(const SkISize& size) {
          ", height: " + std::to_string(size.height()) + "}";
 }
 
+int RoundUpToAllocationClass(int dimension) {
+  constexpr int kMinStep = 64;
+  if (dimension <= kMinStep) {
+    return kMinStep;
+  }
+  int next_pow2 = 1;
+  while (next_pow2 < dimension) {
+    next_pow2 <<= 1;
+  }
+  const int step = std::max(kMinStep, next_pow2 / 8);
+  return ((dimension + step - 1) / step) * step;
+}
+
 }  // namespace
 
 VulkanSurfacePool::VulkanSurfacePool(vulkan::VulkanProvider& vulkan_provider,
@@ -26,10 +39,27 @@ VulkanSurfacePool::VulkanSurfacePool(vulkan::VulkanProvider& vulkan_provider,
                                      scenic::Session* scenic_session)
     : vulkan_provider_(vulkan_provider),
       context_(std::move(context)),
-      scenic_session_(scenic_session) {}
+      scenic_session_(scenic_session),
+      memory_allocator_(
+          vulkan_provider.vk(),
+          vulkan_provider.vk_device(),
+          VK_EXTERNAL_MEMORY_HANDLE_TYPE_TEMP_ZIRCON_VMO_BIT_FUCHSIA) {}
 
 VulkanSurfacePool::~VulkanSurfacePool() {}
 
+SkISize VulkanSurfacePool::GetAllocationClass(const SkISize& size) {
+  if (size.isEmpty()) {
+    return size;
+  }
+  return SkISize::Make(RoundUpToAllocationClass(size.width()),
+                       RoundUpToAllocationClass(size.height()));
+}
+
+bool VulkanSurfacePool::IsOversized(const VulkanSurface& surface) {
+  return surface.GetAllocatedImageSize() !=
+         GetAllocationClass(surface.GetSize());
+}
+
 std::unique_ptr<VulkanSurface> VulkanSurfacePool::AcquireSurface(
     const SkISize& size) {
   auto surface = GetCachedOrCreateSurface(size);
@@ -62,6 +92,7 @@ std::unique_ptr<VulkanSurface> VulkanSurfacePool::GetCachedOrCreateSurface(
       auto acquired_surface = std::move(*exact_match_it);
       available_surfaces_.erase(exact_match_it);
       TRACE_EVENT_INSTANT0("flutter", "Exact match found");
+      trace_surfaces_exact_hits_++;
       return acquired_surface;
     }
   }
@@ -170,8 +201,9 @@ std::unique_ptr<VulkanSurface> VulkanSurfacePool::CreateSurface(
     const SkISize& size) {
   TRACE_EVENT2("flutter", "VulkanSurfacePool::CreateSurface", "width",
                size.width(), "height", size.height());
-  auto surface = std::make_unique<VulkanSurface>(vulkan_provider_, context_,
-                                                 scenic_session_, size);
+  auto surface = std::make_unique<VulkanSurface>(
+      vulkan_provider_, memory_allocator_, context_, scenic_session_, size,
+      GetAllocationClass(size));
   if (!surface->IsValid()) {
     return nullptr;
   }
@@ -203,6 +235,12 @@ void VulkanSurfacePool::RecycleSurface(std::unique_ptr<VulkanSurface> surface) {
   }
 
   TRACE_EVENT0("flutter", "VulkanSurfacePool::RecycleSurface");
+  if (surface->GetAllocationSize() > kMaxCachedBytes) {
+    TRACE_EVENT_INSTANT0("flutter", "Surface too large for pool, dropping");
+    TraceStats();
+    return;
+  }
+
   // Recycle the buffer by putting it in the list of available surfaces if we
   // have not reached the maximum amount of cached surfaces.
   if (available_surfaces_.size() < kMaxSurfaces) {
@@ -210,6 +248,22 @@ void VulkanSurfacePool::RecycleSurface(std::unique_ptr<VulkanSurface> surface) {
   } else {
     TRACE_EVENT_INSTANT0("flutter", "Too many surfaces in pool, dropping");
   }
+
+  // Evict the least recently recycled surfaces until the pool fits in its
+  // memory budget.
+  size_t cached_bytes = 0;
+  for (const auto& available_surface : available_surfaces_) {
+    cached_bytes += available_surface->GetAllocationSize();
+  }
+  auto evict_end = available_surfaces_.begin();
+  while (cached_bytes > kMaxCachedBytes) {
+    cached_bytes -= (*evict_end)->GetAllocationSize();
+    ++evict_end;
+  }
+  if (evict_end != available_surfaces_.begin()) {
+    TRACE_EVENT_INSTANT0("flutter", "Pool over memory budget, evicting");
+    available_surfaces_.erase(available_surfaces_.begin(), evict_end);
+  }
   TraceStats();
 }
 
@@ -252,7 +306,7 @@ void VulkanSurfacePool::AgeAndCollectOldBuffers() {
   auto surface_to_remove_it = std::find_if(
       available_surfaces_.begin(), available_surfaces_.end(),
       [](const auto& surface) {
-        return surface->IsOversized() && surface->HasStableSizeHistory();
+        return IsOversized(*surface) && surface->HasStableSizeHistory();
       });
   // If we found such a surface, then destroy it and cache a new one that only
   // uses a necessary amount of memory.
@@ -297,7 +351,7 @@ void VulkanSurfacePool::ShrinkToFit() {
   // reducing our peak memory footprint.
   std::vector<SkISize> sizes_to_recreate;
   for (auto& surface : available_surfaces_) {
-    if (surface->IsOversized()) {
+    if (IsOversized(*surface)) {
       sizes_to_recreate.push_back(surface->GetSize());
       surface.reset();
     }
@@ -337,25 +391,40 @@ void VulkanSurfacePool::TraceStats() {
   const size_t skia_cache_purgeable =
       context_->getResourceCachePurgeableBytes();
 
+  // Share of acquisitions served without a new allocation.
+  const size_t acquisitions = trace_surfaces_exact_hits_ +
+                              trace_surfaces_reused_ + trace_surfaces_created_;
+  const size_t hit_rate_percent =
+      acquisitions == 0
+          ? 100
+          : (trace_surfaces_exact_hits_ + trace_surfaces_reused_) * 100 /
+                acquisitions;
+
   TRACE_COUNTER("flutter", "SurfacePoolCounts", 0u, "CachedCount",
                 available_surfaces_.size(),                       //
                 "Created", trace_surfaces_created_,               //
                 "Reused", trace_surfaces_reused_,                 //
+                "ExactHits", trace_surfaces_exact_hits_,          //
+                "HitRatePercent", hit_rate_percent,               //
                 "PendingInCompositor", pending_surfaces_.size(),  //
                 "Retained", retained_surfaces_.size(),            //
                 "SkiaCacheResources", skia_resources              //
   );
 
-  TRACE_COUNTER("flutter", "SurfacePoolBytes", 0u,          //
-                "CachedBytes", cached_surfaces_bytes,       //
-                "RetainedBytes", retained_surfaces_bytes,   //
-                "SkiaCacheBytes", skia_bytes,               //
-                "SkiaCachePurgeable", skia_cache_purgeable  //
+  TRACE_COUNTER("flutter", "SurfacePoolBytes", 0u,                        //
+                "CachedBytes", cached_surfaces_bytes,                     //
+                "CachedBytesLimit", kMaxCachedBytes,                      //
+                "RetainedBytes", retained_surfaces_bytes,                 //
+                "SkiaCacheBytes", skia_bytes,                             //
+                "SkiaCachePurgeable", skia_cache_purgeable,               //
+                "DeviceMemoryBlocks", memory_allocator_.GetBlockCount(),  //
+                "DeviceMemoryBytes", memory_allocator_.GetBlockBytes()    //
   );
 
   // Reset per present/frame stats.
   trace_surfaces_created_ = 0;
   trace_surfaces_reused_ = 0;
+  trace_surfaces_exact_hits_ = 0;
 }
 
 }  // namespace flutter_runner
@@ -19,6 +19,9 @@ class VulkanSurfacePool final {
   static constexpr int kMaxSurfaces = 12;
   // If a surface doesn't get used for 3 or more generations, we discard it.
   static constexpr int kMaxSurfaceAge = 3;
+  // Never hold more than this many bytes in |available_surfaces_|, evicting
+  // the least recently recycled surfaces first.
+  static constexpr size_t kMaxCachedBytes = 128 * 1024 * 1024;
 
   VulkanSurfacePool(vulkan::VulkanProvider& vulkan_provider,
                     sk_sp<GrContext> context,
@@ -26,8 +29,19 @@ class VulkanSurfacePool final {
 
   ~VulkanSurfacePool();
 
+  // Rounds |size| up to the size class the memory of surfaces is allocated
+  // for, so that a surface can be rebound to images of slightly different
+  // sizes without a new allocation. Each dimension is rounded up to a step of
+  // an eighth of its next power of two, wasting at most ~12.5% per dimension.
+  static SkISize GetAllocationClass(const SkISize& size);
+
   std::unique_ptr<VulkanSurface> AcquireSurface(const SkISize& size);
 
+  // The allocator the memory of the surfaces of the pool comes from.
+  vulkan::VulkanMemoryAllocator& GetMemoryAllocator() {
+    return memory_allocator_;
+  }
+
   void SubmitSurface(
       std::unique_ptr<flutter::SceneUpdateContext::SurfaceProducerSurface>
           surface);
@@ -61,6 +75,8 @@ class VulkanSurfacePool final {
   vulkan::VulkanProvider& vulkan_provider_;
   sk_sp<GrContext> context_;
   scenic::Session* scenic_session_;
+  // Declared before the surfaces, which it must outlive.
+  vulkan::VulkanMemoryAllocator memory_allocator_;
   std::vector<std::unique_ptr<VulkanSurface>> available_surfaces_;
   std::unordered_map<uintptr_t, std::unique_ptr<VulkanSurface>>
       pending_surfaces_;
@@ -69,12 +85,17 @@ class VulkanSurfacePool final {
   flutter::LayerRasterCacheKey::Map<RetainedSurface> retained_surfaces_;
 
   size_t trace_surfaces_created_ = 0;
+  size_t trace_surfaces_exact_hits_ = 0;
   size_t trace_surfaces_reused_ = 0;
 
   std::unique_ptr<VulkanSurface> GetCachedOrCreateSurface(const SkISize& size);
 
   std::unique_ptr<VulkanSurface> CreateSurface(const SkISize& size);
 
+  // Whether |surface| holds more memory than the allocation class of its
+  // current size needs.
+  static bool IsOversized(const VulkanSurface& surface);
+
   void RecycleSurface(std::unique_ptr<VulkanSurface> surface);
 
   void RecyclePendingSurface(uintptr_t surface_key);
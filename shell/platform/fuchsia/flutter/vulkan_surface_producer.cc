@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/persistent_cache.h"
 #include "third_party/skia/include/gpu/GrBackendSemaphore.h"
 #include "third_party/skia/include/gpu/GrBackendSurface.h"
 #include "third_party/skia/include/gpu/GrContext.h"
@@ -54,6 +55,7 @@ VulkanSurfaceProducer::~VulkanSurfaceProducer() {
     VkResult wait_result = VK_CALL_LOG_ERROR(
         vk_->QueueWaitIdle(logical_device_->GetQueueHandle()));
     FML_DCHECK(wait_result == VK_SUCCESS);
+    context_->storeVkPipelineCacheData();
   }
 };
 
@@ -127,7 +129,17 @@ bool VulkanSurfaceProducer::Initialize(scenic::Session* scenic_session) {
   backend_context.fGetProc = std::move(getProc);
   backend_context.fOwnsInstanceAndDevice = false;
 
-  context_ = GrContext::MakeVulkan(backend_context);
+  VkPhysicalDeviceProperties properties;
+  if (logical_device_->GetPhysicalDeviceProperties(&properties)) {
+    flutter::PersistentCache::GetCacheForProcess()->SetVkPipelineCacheDevice(
+        properties.vendorID, properties.deviceID, properties.driverVersion);
+  }
+
+  GrContextOptions options;
+  flutter::PersistentCache::MarkStrategySet();
+  options.fPersistentCache = flutter::PersistentCache::GetCacheForProcess();
+
+  context_ = GrContext::MakeVulkan(backend_context, options);
 
   if (context_ == nullptr) {
     FML_LOG(ERROR) << "Failed to create GrContext.";
@@ -183,6 +195,25 @@ void VulkanSurfaceProducer::OnSurfacesPresented(
         }
       },
       kShouldShrinkThreshold);
+
+  // The pipelines of new shaders went into the Vulkan pipeline cache too. It
+  // is stored once in a while rather than after each frame that adds to it.
+  constexpr auto kPipelineCacheStoreDelay = zx::sec(1);
+  if (flutter::PersistentCache::GetCacheForProcess()->StoredNewShaders() &&
+      !pipeline_cache_store_pending_) {
+    pipeline_cache_store_pending_ = true;
+    async::PostDelayedTask(
+        async_get_default_dispatcher(),
+        [self = weak_factory_.GetWeakPtr()] {
+          if (!self) {
+            return;
+          }
+          self->pipeline_cache_store_pending_ = false;
+          TRACE_EVENT0("flutter", "GrContext::storeVkPipelineCacheData");
+          self->context_->storeVkPipelineCacheData();
+        },
+        kPipelineCacheStoreDelay);
+  }
 }
 
 bool VulkanSurfaceProducer::TransitionSurfacesToExternal(
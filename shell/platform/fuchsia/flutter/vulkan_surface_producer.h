@@ -93,6 +93,7 @@ class VulkanSurfaceProducer final
   // Keep track of the last time we produced a surface.  This is used to
   // determine whether it is safe to shrink |surface_pool_| or not.
   zx::time last_produce_time_ = async::Now(async_get_default_dispatcher());
+  bool pipeline_cache_store_pending_ = false;
   fml::WeakPtrFactory<VulkanSurfaceProducer> weak_factory_{this};
 
   bool Initialize(scenic::Session* scenic_session);
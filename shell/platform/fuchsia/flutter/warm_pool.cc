@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "warm_pool.h"
+
+#include <lib/fdio/directory.h>
+#include <lib/fdio/io.h>
+#include <zircon/status.h>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter_runner {
+
+namespace {
+
+std::unique_ptr<fml::FileMapping> MakeFileMapping(const char* path,
+                                                  bool executable) {
+  uint32_t flags = OPEN_RIGHT_READABLE;
+  if (executable) {
+    flags |= OPEN_RIGHT_EXECUTABLE;
+  }
+
+  int fd = 0;
+  // The returned file descriptor is compatible with standard posix operations
+  // such as close, mmap, etc. We only need to treat open/open_at specially.
+  zx_status_t status = fdio_open_fd(path, flags, &fd);
+
+  if (status != ZX_OK) {
+    return nullptr;
+  }
+
+  using Protection = fml::FileMapping::Protection;
+
+  std::initializer_list<Protection> protection_execute = {Protection::kRead,
+                                                          Protection::kExecute};
+  std::initializer_list<Protection> protection_read = {Protection::kRead};
+  auto mapping = std::make_unique<fml::FileMapping>(
+      fml::UniqueFD{fd}, executable ? protection_execute : protection_read);
+
+  if (!mapping->IsValid()) {
+    return nullptr;
+  }
+
+  return mapping;
+}
+
+}  // namespace
+
+WarmPool::WarmPool(size_t spare_threads)
+    : spare_thread_count_(spare_threads) {}
+
+WarmPool::~WarmPool() {
+  for (const auto& thread : spare_threads_) {
+    thread->Quit();
+  }
+  for (const auto& thread : spare_threads_) {
+    thread->Join();
+  }
+}
+
+std::unique_ptr<Thread> WarmPool::TakeThread() {
+  {
+    std::scoped_lock lock(mutex_);
+    if (!spare_threads_.empty()) {
+      std::unique_ptr<Thread> thread = std::move(spare_threads_.back());
+      spare_threads_.pop_back();
+      return thread;
+    }
+  }
+  TRACE_EVENT0("flutter", "WarmPool::StartThread");
+  return std::make_unique<Thread>();
+}
+
+void WarmPool::Refill() {
+  TRACE_EVENT0("flutter", "WarmPool::Refill");
+  while (GetSpareThreadCount() < spare_thread_count_) {
+    auto thread = std::make_unique<Thread>();
+    if (!thread->IsValid()) {
+      FML_LOG(ERROR) << "Could not start a spare thread.";
+      return;
+    }
+    std::scoped_lock lock(mutex_);
+    spare_threads_.push_back(std::move(thread));
+  }
+}
+
+size_t WarmPool::GetSpareThreadCount() const {
+  std::scoped_lock lock(mutex_);
+  return spare_threads_.size();
+}
+
+flutter::MappingCallback WarmPool::GetRunnerFileMapping(const char* path,
+                                                        bool executable) {
+  return [this, path = std::string(path),
+          executable]() -> std::unique_ptr<fml::Mapping> {
+    std::shared_ptr<fml::Mapping> mapping;
+    {
+      std::scoped_lock lock(mutex_);
+      auto found = runner_file_mappings_.find(path);
+      if (found != runner_file_mappings_.end()) {
+        mapping = found->second;
+      }
+    }
+    if (!mapping) {
+      TRACE_EVENT0("flutter", "WarmPool::MapRunnerFile");
+      mapping = MakeFileMapping(path.c_str(), executable);
+      if (!mapping) {
+        return nullptr;
+      }
+      std::scoped_lock lock(mutex_);
+      // Another component may have mapped it meanwhile.
+      mapping = runner_file_mappings_.emplace(path, mapping).first->second;
+    }
+    return std::make_unique<fml::NonOwnedMapping>(
+        mapping->GetMapping(), mapping->GetSize(),
+        [mapping](const uint8_t*, size_t) {});
+  };
+}
+
+std::string WarmPool::GetPackageKey(const std::string& resolved_url) {
+  return resolved_url.substr(0, resolved_url.find('#'));
+}
+
+fml::RefPtr<flutter::DartSnapshot> WarmPool::GetPackageSnapshot(
+    const std::string& package_key) {
+  std::scoped_lock lock(mutex_);
+  for (auto it = package_snapshots_.begin(); it != package_snapshots_.end();
+       ++it) {
+    if (it->first == package_key) {
+      package_snapshots_.splice(package_snapshots_.begin(), package_snapshots_,
+                                it);
+      return package_snapshots_.front().second;
+    }
+  }
+  return nullptr;
+}
+
+void WarmPool::PutPackageSnapshot(const std::string& package_key,
+                                  fml::RefPtr<flutter::DartSnapshot> snapshot) {
+  std::scoped_lock lock(mutex_);
+  package_snapshots_.remove_if(
+      [&package_key](const auto& item) { return item.first == package_key; });
+  package_snapshots_.emplace_front(package_key, std::move(snapshot));
+  if (package_snapshots_.size() > kMaxPackageSnapshots) {
+    package_snapshots_.pop_back();
+  }
+}
+
+}  // namespace flutter_runner
@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_FUCHSIA_WARM_POOL_H_
+#define FLUTTER_SHELL_PLATFORM_FUCHSIA_WARM_POOL_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/runtime/dart_snapshot.h"
+#include "thread.h"
+
+namespace flutter_runner {
+
+// Holds what starting a component needs ready ahead of the component, and
+// shares what the components of a package can share, so that launching many
+// short-lived components doesn't pay for all of it each time:
+//
+// - Started threads, to be taken by the next component and its engines.
+// - The mappings of the snapshots of the runner itself, which are the same for
+//   every component.
+// - The isolate snapshots of the most recently started packages.
+//
+// This class is thread safe.
+class WarmPool {
+ public:
+  // The threads a component with a single view takes: one for the application
+  // and one each for the raster, UI and IO task runners of its engine.
+  static constexpr size_t kThreadsPerComponent = 4;
+
+  // The number of packages whose isolate snapshots are kept.
+  static constexpr size_t kMaxPackageSnapshots = 4;
+
+  explicit WarmPool(size_t spare_threads = kThreadsPerComponent);
+
+  ~WarmPool();
+
+  // Returns a started thread, which is a spare one if there is any left.
+  std::unique_ptr<Thread> TakeThread();
+
+  // Starts threads until there are as many spare ones as the pool keeps. This
+  // is meant to be called when the runner is idle, after a component started.
+  void Refill();
+
+  size_t GetSpareThreadCount() const;
+
+  // Returns a mapping callback for the file at |path| in the package of the
+  // runner. The file is mapped once, and the mapping is shared by all the
+  // components.
+  flutter::MappingCallback GetRunnerFileMapping(const char* path,
+                                                bool executable = false);
+
+  // The key under which the snapshots of the package of the component at
+  // |resolved_url| are kept, which is the URL without the fragment naming the
+  // component within the package.
+  static std::string GetPackageKey(const std::string& resolved_url);
+
+  // Returns the isolate snapshot kept for |package_key|, or null.
+  fml::RefPtr<flutter::DartSnapshot> GetPackageSnapshot(
+      const std::string& package_key);
+
+  // Keeps |snapshot| for |package_key|, evicting the snapshot of the least
+  // recently started package if there are too many.
+  void PutPackageSnapshot(const std::string& package_key,
+                          fml::RefPtr<flutter::DartSnapshot> snapshot);
+
+ private:
+  const size_t spare_thread_count_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Thread>> spare_threads_;
+  std::unordered_map<std::string, std::shared_ptr<fml::Mapping>>
+      runner_file_mappings_;
+  // Most recently started package first.
+  std::list<std::pair<std::string, fml::RefPtr<flutter::DartSnapshot>>>
+      package_snapshots_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WarmPool);
+};
+
+}  // namespace flutter_runner
+
+#endif  // FLUTTER_SHELL_PLATFORM_FUCHSIA_WARM_POOL_H_
@@ -0,0 +1,47 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/fuchsia/flutter/warm_pool.h"
+
+#include <gtest/gtest.h>
+
+namespace flutter_runner {
+namespace {
+
+TEST(WarmPool, GetPackageKey) {
+  EXPECT_EQ(WarmPool::GetPackageKey(
+                "fuchsia-pkg://fuchsia.com/hello#meta/hello.cmx"),
+            "fuchsia-pkg://fuchsia.com/hello");
+  EXPECT_EQ(WarmPool::GetPackageKey("fuchsia-pkg://fuchsia.com/hello"),
+            "fuchsia-pkg://fuchsia.com/hello");
+}
+
+TEST(WarmPool, RefillReplacesTakenThreads) {
+  WarmPool warm_pool(2);
+  EXPECT_EQ(warm_pool.GetSpareThreadCount(), 0u);
+
+  // Threads are started on demand while the pool is empty.
+  std::unique_ptr<Thread> thread = warm_pool.TakeThread();
+  ASSERT_TRUE(thread);
+  EXPECT_TRUE(thread->IsValid());
+
+  warm_pool.Refill();
+  EXPECT_EQ(warm_pool.GetSpareThreadCount(), 2u);
+
+  std::unique_ptr<Thread> spare_thread = warm_pool.TakeThread();
+  ASSERT_TRUE(spare_thread);
+  EXPECT_TRUE(spare_thread->IsValid());
+  EXPECT_EQ(warm_pool.GetSpareThreadCount(), 1u);
+
+  warm_pool.Refill();
+  EXPECT_EQ(warm_pool.GetSpareThreadCount(), 2u);
+
+  for (const auto& taken : {thread.get(), spare_thread.get()}) {
+    taken->Quit();
+    taken->Join();
+  }
+}
+
+}  // namespace
+}  // namespace flutter_runner
@@ -81,4 +81,11 @@ void FlutterEngine::RunEventLoopWithTimeout(std::chrono::milliseconds timeout) {
                                               timeout_milliseconds);
 }
 
+void FlutterEngine::WakeEventLoop() {
+  if (!engine_) {
+    return;
+  }
+  FlutterDesktopWakeEngineEventLoop(engine_.get());
+}
+
 }  // namespace flutter
@@ -28,6 +28,9 @@ class TestGlfwApi : public testing::StubFlutterGlfwApi {
     last_run_loop_timeout_ = millisecond_timeout;
   }
 
+  // |flutter::testing::StubFlutterGlfwApi|
+  void WakeEngineEventLoop() override { wake_called_ = true; }
+
   // |flutter::testing::StubFlutterGlfwApi|
   bool ShutDownEngine() override {
     shut_down_called_ = true;
@@ -40,8 +43,11 @@ class TestGlfwApi : public testing::StubFlutterGlfwApi {
 
   uint32_t last_run_loop_timeout() { return last_run_loop_timeout_; }
 
+  bool wake_called() { return wake_called_; }
+
  private:
   bool run_called_ = false;
+  bool wake_called_ = false;
   bool shut_down_called_ = false;
   uint32_t last_run_loop_timeout_ = 0;
 };
@@ -100,4 +106,21 @@ TEST(FlutterEngineTest, RunloopTimeoutTranslation) {
   EXPECT_EQ(test_api->last_run_loop_timeout(), 0U);
 }
 
+TEST(FlutterEngineTest, WakeEventLoop) {
+  const std::string icu_data_path = "fake/path/to/icu";
+  const std::string assets_path = "fake/path/to/assets";
+  testing::ScopedStubFlutterGlfwApi scoped_api_stub(
+      std::make_unique<TestGlfwApi>());
+  auto test_api = static_cast<TestGlfwApi*>(scoped_api_stub.stub());
+
+  FlutterEngine engine;
+  // Waking an engine that is not running does nothing.
+  engine.WakeEventLoop();
+  EXPECT_EQ(test_api->wake_called(), false);
+
+  engine.Start(icu_data_path, assets_path, {});
+  engine.WakeEventLoop();
+  EXPECT_EQ(test_api->wake_called(), true);
+}
+
 }  // namespace flutter
@@ -120,4 +120,11 @@ void FlutterWindowController::RunEventLoop() {
   }
 }
 
+void FlutterWindowController::WakeEventLoop() {
+  if (!controller_) {
+    return;
+  }
+  FlutterDesktopWakeEngineEventLoop(FlutterDesktopGetEngine(controller_));
+}
+
 }  // namespace flutter
@@ -43,6 +43,11 @@ class FlutterEngine : public PluginRegistry {
   void RunEventLoopWithTimeout(
       std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
 
+  // Makes the current or next RunEventLoopWithTimeout call return. May be
+  // called from any thread, to handle events from other sources without
+  // running the event loop with a timeout.
+  void WakeEventLoop();
+
   // flutter::PluginRegistry:
   FlutterDesktopPluginRegistrarRef GetRegistrarForPlugin(
       const std::string& plugin_name) override;
@@ -97,6 +97,11 @@ class FlutterWindowController : public PluginRegistry {
   // Deprecated. Use RunEventLoopWithTimeout.
   void RunEventLoop();
 
+  // Makes the current or next RunEventLoopWithTimeout call return. May be
+  // called from any thread, to handle events from other sources without
+  // running the event loop with a timeout.
+  void WakeEventLoop();
+
   // flutter::PluginRegistry:
   FlutterDesktopPluginRegistrarRef GetRegistrarForPlugin(
       const std::string& plugin_name) override;
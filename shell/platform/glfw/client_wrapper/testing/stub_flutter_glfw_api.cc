@@ -157,6 +157,12 @@ void FlutterDesktopRunEngineEventLoopWithTimeout(
   }
 }
 
+void FlutterDesktopWakeEngineEventLoop(FlutterDesktopEngineRef engine) {
+  if (s_stub_implementation) {
+    s_stub_implementation->WakeEngineEventLoop();
+  }
+}
+
 bool FlutterDesktopShutDownEngine(FlutterDesktopEngineRef engine_ref) {
   if (s_stub_implementation) {
     return s_stub_implementation->ShutDownEngine();
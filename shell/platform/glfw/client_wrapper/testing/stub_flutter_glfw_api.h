@@ -86,6 +86,9 @@ class StubFlutterGlfwApi {
   // Called for FlutterDesktopRunEngineEventLoopWithTimeout.
   virtual void RunEngineEventLoopWithTimeout(uint32_t millisecond_timeout) {}
 
+  // Called for FlutterDesktopWakeEngineEventLoop.
+  virtual void WakeEngineEventLoop() {}
+
   // Called for FlutterDesktopShutDownEngine.
   virtual bool ShutDownEngine() { return true; }
 };
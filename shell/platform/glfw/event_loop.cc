@@ -67,8 +67,13 @@ void EventLoop::WaitForEvents(std::chrono::nanoseconds max_wait) {
                                                ? TaskTimePoint::max()
                                                : task_queue_.top().fire_time;
       next_wake = std::min(max_wake_timepoint, next_event_timepoint);
+      next_wake_ = next_wake;
     }
     WaitUntil(next_wake);
+    {
+      std::lock_guard<std::mutex> lock(task_queue_mutex_);
+      next_wake_ = TaskTimePoint::min();
+    }
   }
 }
 
@@ -89,15 +94,24 @@ void EventLoop::PostTask(FlutterTask flutter_task,
   task.fire_time = TimePointFromFlutterTime(flutter_target_time_nanos);
   task.task = flutter_task;
 
+  bool wake = false;
   {
     std::lock_guard<std::mutex> lock(task_queue_mutex_);
     task_queue_.push(task);
+    // A loop that is waiting until this task is due, or later, needs no wake.
+    wake = task.fire_time < next_wake_;
 
     // Make sure the queue mutex is unlocked before waking up the loop. In case
     // the wake causes this thread to be descheduled for the primary thread to
     // process tasks, the acquisition of the lock on that thread while holding
     // the lock here momentarily till the end of the scope is a pessimization.
   }
+  if (wake) {
+    Wake();
+  }
+}
+
+void EventLoop::WakeForExternalEvent() {
   Wake();
 }
 
@@ -44,8 +44,16 @@ class EventLoop {
       std::chrono::nanoseconds max_wait = std::chrono::nanoseconds::max());
 
   // Posts a Flutter engine task to the event loop for delayed execution.
+  //
+  // The loop is only woken if the task is due before the time the loop is
+  // waiting until, so posting tasks that are not due yet causes no wakeups.
   void PostTask(FlutterTask flutter_task, uint64_t flutter_target_time_nanos);
 
+  // Makes the current or next wait of the loop return. May be called from any
+  // thread, so that events from other sources can be handled without waiting
+  // with a timeout.
+  void WakeForExternalEvent();
+
  protected:
   using TaskTimePoint = std::chrono::steady_clock::time_point;
 
@@ -81,6 +89,10 @@ class EventLoop {
   TaskExpiredCallback on_task_expired_;
   std::mutex task_queue_mutex_;
   std::priority_queue<Task, std::deque<Task>, Task::Comparer> task_queue_;
+  // The time the loop waits until, from when it is computed until the wait
+  // returns. It is |TaskTimePoint::min()| while the loop runs tasks, which
+  // picks up the posted tasks without being woken.
+  TaskTimePoint next_wake_ = TaskTimePoint::min();
 };
 
 }  // namespace flutter
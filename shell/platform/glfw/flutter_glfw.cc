@@ -953,6 +953,10 @@ void FlutterDesktopRunEngineEventLoopWithTimeout(
   engine->event_loop->WaitForEvents(wait_duration);
 }
 
+void FlutterDesktopWakeEngineEventLoop(FlutterDesktopEngineRef engine) {
+  engine->event_loop->WakeForExternalEvent();
+}
+
 bool FlutterDesktopShutDownEngine(FlutterDesktopEngineRef engine) {
   auto result = FlutterEngineShutdown(engine->flutter_engine);
   delete engine;
@@ -18,6 +18,12 @@ GLFWEventLoop::GLFWEventLoop(std::thread::id main_thread_id,
 GLFWEventLoop::~GLFWEventLoop() = default;
 
 void GLFWEventLoop::WaitUntil(const TaskTimePoint& time) {
+  if (time == TaskTimePoint::max()) {
+    // Nothing is due, so only an event or a wake ends the wait.
+    ::glfwWaitEvents();
+    return;
+  }
+
   const auto now = TaskTimePoint::clock::now();
 
   // Make sure the seconds are not integral.
@@ -18,10 +18,15 @@ HeadlessEventLoop::~HeadlessEventLoop() = default;
 void HeadlessEventLoop::WaitUntil(const TaskTimePoint& time) {
   std::mutex& mutex = GetTaskQueueMutex();
   std::unique_lock<std::mutex> lock(mutex);
-  task_queue_condition_.wait_until(lock, time);
+  task_queue_condition_.wait_until(lock, time, [this] { return woken_; });
+  woken_ = false;
 }
 
 void HeadlessEventLoop::Wake() {
+  {
+    std::lock_guard<std::mutex> lock(GetTaskQueueMutex());
+    woken_ = true;
+  }
   task_queue_condition_.notify_one();
 }
 
@@ -33,6 +33,10 @@ class HeadlessEventLoop : public EventLoop {
   void Wake() override;
 
   std::condition_variable task_queue_condition_;
+  // Whether |Wake| was called since the last wait returned, which keeps a
+  // wake that comes before the wait starts from being lost. Guarded by the
+  // task queue mutex.
+  bool woken_ = false;
 };
 
 }  // namespace flutter
@@ -213,6 +213,15 @@ FLUTTER_EXPORT void FlutterDesktopRunEngineEventLoopWithTimeout(
     FlutterDesktopEngineRef engine,
     uint32_t timeout_milliseconds);
 
+// Makes the current or next wait of the event loop of |engine| return, as if
+// an event was processed. May be called from any thread.
+//
+// This lets a caller that has to handle events from other sources run the
+// event loop without a timeout, and wake it when it has such events, instead
+// of polling for them with short timeouts.
+FLUTTER_EXPORT void FlutterDesktopWakeEngineEventLoop(
+    FlutterDesktopEngineRef engine);
+
 // Shuts down the given engine instance. Returns true if the shutdown was
 // successful. |engine_ref| is no longer valid after this call.
 FLUTTER_EXPORT bool FlutterDesktopShutDownEngine(
@@ -280,3 +280,12 @@ gchar* egl_config_to_string(EGLDisplay display, EGLConfig config) {
 
   return g_strjoinv(" ", reinterpret_cast<gchar**>(strings->pdata));
 }
+
+gboolean egl_has_extension(EGLDisplay display, const gchar* name) {
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (extensions == nullptr)
+    return FALSE;
+
+  g_auto(GStrv) names = g_strsplit(extensions, " ", -1);
+  return g_strv_contains(names, name);
+}
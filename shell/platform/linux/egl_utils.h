@@ -33,6 +33,17 @@ const gchar* egl_error_to_string(EGLint error);
  */
 gchar* egl_config_to_string(EGLDisplay display, EGLConfig config);
 
+/**
+ * egl_has_extension:
+ * @display: an EGL display.
+ * @name: an EGL extension name, e.g. "EGL_EXT_buffer_age".
+ *
+ * Checks if an EGL extension is supported by a display.
+ *
+ * Returns: %TRUE if the extension is supported.
+ */
+gboolean egl_has_extension(EGLDisplay display, const gchar* name);
+
 G_END_DECLS
 
 #endif  // FLUTTER_SHELL_PLATFORM_LINUX_EGL_UTILS_H_
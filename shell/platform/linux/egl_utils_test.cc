@@ -56,3 +56,12 @@ TEST(EGLUtils, ConfigToStringNullptr) {
   g_autofree gchar* config_string3 = egl_config_to_string(nullptr, nullptr);
   EXPECT_STREQ(config_string3, "");
 }
+
+TEST(EGLUtils, HasExtension) {
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  EXPECT_TRUE(eglInitialize(display, nullptr, nullptr));
+  EXPECT_TRUE(egl_has_extension(display, "EGL_KHR_partial_update"));
+  EXPECT_TRUE(egl_has_extension(display, "EGL_KHR_swap_buffers_with_damage"));
+  EXPECT_FALSE(egl_has_extension(display, "EGL_KHR_partial"));
+  EXPECT_FALSE(egl_has_extension(display, "EGL_EXT_buffer_age"));
+}
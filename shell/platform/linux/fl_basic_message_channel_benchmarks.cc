@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/linux/fl_engine_private.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_basic_message_channel.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_binary_codec.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_json_message_codec.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+#include "flutter/shell/platform/linux/testing/mock_renderer.h"
+
+namespace flutter {
+namespace benchmarking {
+
+namespace {
+
+// Creates a mock engine, which echoes messages sent on "test/echo" back from
+// the main loop like a running engine would.
+FlEngine* make_mock_engine() {
+  g_autoptr(FlDartProject) project = fl_dart_project_new();
+  g_autoptr(FlMockRenderer) renderer = fl_mock_renderer_new();
+  g_autoptr(GError) error = nullptr;
+  if (!fl_renderer_setup(FL_RENDERER(renderer), &error)) {
+    g_error("Failed to set up renderer: %s", error->message);
+  }
+  FlEngine* engine = fl_engine_new(project, FL_RENDERER(renderer));
+  if (!fl_engine_start(engine, &error)) {
+    g_error("Failed to start engine: %s", error->message);
+  }
+  return engine;
+}
+
+void echo_response_cb(GObject* object,
+                      GAsyncResult* result,
+                      gpointer user_data) {
+  g_autoptr(FlValue) reply = fl_basic_message_channel_send_finish(
+      FL_BASIC_MESSAGE_CHANNEL(object), result, nullptr);
+  benchmark::DoNotOptimize(reply);
+  g_main_loop_quit(static_cast<GMainLoop*>(user_data));
+}
+
+// Sends @message to the echo channel with @codec and waits for the decoded
+// reply, until @state is done.
+void round_trip(benchmark::State& state,
+                FlMessageCodec* codec,
+                FlValue* message) {
+  g_autoptr(GMainLoop) loop = g_main_loop_new(nullptr, 0);
+  g_autoptr(FlEngine) engine = make_mock_engine();
+  FlBinaryMessenger* messenger = fl_engine_get_binary_messenger(engine);
+  g_autoptr(FlBasicMessageChannel) channel =
+      fl_basic_message_channel_new(messenger, "test/echo", codec);
+
+  g_autoptr(GBytes) encoded =
+      fl_message_codec_encode_message(codec, message, nullptr);
+  while (state.KeepRunning()) {
+    fl_basic_message_channel_send(channel, message, nullptr, echo_response_cb,
+                                  loop);
+    g_main_loop_run(loop);
+  }
+  state.SetBytesProcessed(state.iterations() * g_bytes_get_size(encoded) * 2);
+}
+
+FlValue* create_uint8_list(int64_t length) {
+  g_autofree uint8_t* data = static_cast<uint8_t*>(g_malloc0(length));
+  return fl_value_new_uint8_list(data, length);
+}
+
+FlValue* create_string(int64_t length) {
+  g_autofree gchar* text = g_strnfill(length, 'a');
+  return fl_value_new_string(text);
+}
+
+}  // namespace
+
+static void BM_FlChannelRoundTripBinary(benchmark::State& state) {
+  g_autoptr(FlBinaryCodec) codec = fl_binary_codec_new();
+  g_autoptr(FlValue) message = create_uint8_list(state.range(0));
+  round_trip(state, FL_MESSAGE_CODEC(codec), message);
+}
+
+static void BM_FlChannelRoundTripStandardByteList(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) message = create_uint8_list(state.range(0));
+  round_trip(state, FL_MESSAGE_CODEC(codec), message);
+}
+
+static void BM_FlChannelRoundTripStandardString(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) message = create_string(state.range(0));
+  round_trip(state, FL_MESSAGE_CODEC(codec), message);
+}
+
+static void BM_FlChannelRoundTripJsonString(benchmark::State& state) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  g_autoptr(FlValue) message = create_string(state.range(0));
+  round_trip(state, FL_MESSAGE_CODEC(codec), message);
+}
+
+BENCHMARK(BM_FlChannelRoundTripBinary)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_FlChannelRoundTripStandardByteList)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_FlChannelRoundTripStandardString)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_FlChannelRoundTripJsonString)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+
+}  // namespace benchmarking
+}  // namespace flutter
@@ -9,12 +9,11 @@
 #include "flutter/shell/platform/linux/fl_plugin_registrar_private.h"
 #include "flutter/shell/platform/linux/fl_renderer.h"
 #include "flutter/shell/platform/linux/fl_renderer_headless.h"
+#include "flutter/shell/platform/linux/fl_task_source.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_plugin_registry.h"
 
 #include <gmodule.h>
 
-static constexpr int kMicrosecondsPerNanosecond = 1000;
-
 // Unique number associated with platform tasks.
 static constexpr size_t kPlatformTaskRunnerIdentifier = 1;
 
@@ -30,6 +29,9 @@ struct _FlEngine {
   FlutterEngineAOTData aot_data;
   FLUTTER_API_SYMBOL(FlutterEngine) engine;
 
+  // Runs the platform tasks of the engine in the GLib main loop.
+  GSource* task_source;
+
   // Function to call when a platform message is received.
   FlEnginePlatformMessageHandler platform_message_handler;
   gpointer platform_message_handler_data;
@@ -48,13 +50,6 @@ G_DEFINE_TYPE_WITH_CODE(
     G_IMPLEMENT_INTERFACE(fl_plugin_registry_get_type(),
                           fl_engine_plugin_registry_iface_init))
 
-// Subclass of GSource that integrates Flutter tasks into the GLib main loop.
-typedef struct {
-  GSource parent;
-  FlEngine* self;
-  FlutterTask task;
-} FlutterSource;
-
 // Parse a locale into its components.
 static void parse_locale(const gchar* locale,
                          gchar** language,
@@ -124,31 +119,15 @@ static void setup_locales(FlEngine* self) {
     g_warning("Failed to set up Flutter locales");
 }
 
-// Callback to run a Flutter task in the GLib main loop.
-static gboolean flutter_source_dispatch(GSource* source,
-                                        GSourceFunc callback,
-                                        gpointer user_data) {
-  FlutterSource* fl_source = reinterpret_cast<FlutterSource*>(source);
-  FlEngine* self = fl_source->self;
+// Called by the task source to run a Flutter task in the GLib main loop.
+static void fl_engine_run_task(const FlutterTask* task, gpointer user_data) {
+  FlEngine* self = static_cast<FlEngine*>(user_data);
 
-  FlutterEngineResult result =
-      FlutterEngineRunTask(self->engine, &fl_source->task);
+  FlutterEngineResult result = FlutterEngineRunTask(self->engine, task);
   if (result != kSuccess)
     g_warning("Failed to run Flutter task\n");
-
-  return G_SOURCE_REMOVE;
 }
 
-// Table of functions for Flutter GLib main loop integration.
-static GSourceFuncs flutter_source_funcs = {
-    nullptr,                  // prepare
-    nullptr,                  // check
-    flutter_source_dispatch,  // dispatch
-    nullptr,                  // finalize
-    nullptr,
-    nullptr  // Internal usage
-};
-
 // Flutter engine rendering callbacks.
 
 static void* fl_engine_gl_proc_resolver(void* user_data, const char* name) {
@@ -188,6 +167,29 @@ static bool fl_engine_gl_present(void* user_data) {
   return result;
 }
 
+static bool fl_engine_gl_present_with_info(
+    void* user_data,
+    const FlutterOpenGLPresentInfo* present_info) {
+  FlEngine* self = static_cast<FlEngine*>(user_data);
+  g_autoptr(GError) error = nullptr;
+  gboolean result = fl_renderer_present_with_damage(
+      self->renderer, &present_info->frame_damage, &error);
+  if (!result)
+    g_warning("%s", error->message);
+  return result;
+}
+
+static uint32_t fl_engine_gl_get_buffer_age(void* user_data) {
+  FlEngine* self = static_cast<FlEngine*>(user_data);
+  return fl_renderer_get_buffer_age(self->renderer);
+}
+
+static void fl_engine_gl_set_damage_region(void* user_data,
+                                           const FlutterDamage* damage) {
+  FlEngine* self = static_cast<FlEngine*>(user_data);
+  fl_renderer_set_damage_region(self->renderer, damage);
+}
+
 static bool fl_engine_gl_make_resource_current(void* user_data) {
   FlEngine* self = static_cast<FlEngine*>(user_data);
   g_autoptr(GError) error = nullptr;
@@ -209,14 +211,7 @@ static void fl_engine_post_task(FlutterTask task,
                                 void* user_data) {
   FlEngine* self = static_cast<FlEngine*>(user_data);
 
-  g_autoptr(GSource) source =
-      g_source_new(&flutter_source_funcs, sizeof(FlutterSource));
-  FlutterSource* fl_source = reinterpret_cast<FlutterSource*>(source);
-  fl_source->self = self;
-  fl_source->task = task;
-  g_source_set_ready_time(source,
-                          target_time_nanos / kMicrosecondsPerNanosecond);
-  g_source_attach(source, nullptr);
+  fl_task_source_post_task(self->task_source, task, target_time_nanos);
 }
 
 // Called when a platform message is received from the engine.
@@ -276,6 +271,12 @@ static void fl_engine_dispose(GObject* object) {
     self->aot_data = nullptr;
   }
 
+  // The engine is shut down, so no more tasks are posted.
+  if (self->task_source != nullptr) {
+    g_source_destroy(self->task_source);
+    g_clear_pointer(&self->task_source, g_source_unref);
+  }
+
   g_clear_object(&self->project);
   g_clear_object(&self->renderer);
   g_clear_object(&self->binary_messenger);
@@ -297,6 +298,9 @@ static void fl_engine_class_init(FlEngineClass* klass) {
 static void fl_engine_init(FlEngine* self) {
   self->thread = g_thread_self();
 
+  self->task_source = fl_task_source_new(fl_engine_run_task, self);
+  g_source_attach(self->task_source, nullptr);
+
   self->binary_messenger = fl_binary_messenger_new(self);
 }
 
@@ -330,6 +334,9 @@ gboolean fl_engine_start(FlEngine* self, GError** error) {
   config.open_gl.fbo_callback = fl_engine_gl_get_fbo;
   config.open_gl.present = fl_engine_gl_present;
   config.open_gl.make_resource_current = fl_engine_gl_make_resource_current;
+  config.open_gl.present_with_info = fl_engine_gl_present_with_info;
+  config.open_gl.fbo_buffer_age_callback = fl_engine_gl_get_buffer_age;
+  config.open_gl.set_damage_region = fl_engine_gl_set_damage_region;
 
   FlutterTaskRunnerDescription platform_task_runner = {};
   platform_task_runner.struct_size = sizeof(FlutterTaskRunnerDescription);
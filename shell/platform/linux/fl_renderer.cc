@@ -4,6 +4,8 @@
 
 #include "fl_renderer.h"
 
+#include <EGL/eglext.h>
+
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/linux/egl_utils.h"
 
@@ -17,6 +19,20 @@ typedef struct {
 
   EGLSurface resource_surface;
   EGLContext resource_context;
+
+  // TRUE if EGL_EXT_buffer_age is supported.
+  gboolean has_buffer_age;
+
+  // eglSetDamageRegionKHR from EGL_KHR_partial_update, if supported.
+  PFNEGLSETDAMAGEREGIONKHRPROC set_damage_region;
+
+  // eglSwapBuffersWithDamage from EGL_KHR_swap_buffers_with_damage or
+  // EGL_EXT_swap_buffers_with_damage, if supported.
+  PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage;
+
+  // TRUE if the age of the back buffer was queried since the last swap, which
+  // EGL_KHR_partial_update requires before setting the damage region.
+  gboolean buffer_age_queried;
 } FlRendererPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FlRenderer, fl_renderer, G_TYPE_OBJECT)
@@ -44,6 +60,60 @@ static void create_resource_surface(FlRenderer* self, EGLConfig config) {
               egl_error_to_string(eglGetError()));
 }
 
+// Looks up the partial update extensions supported by the display.
+static void setup_partial_updates(FlRenderer* self) {
+  FlRendererPrivate* priv =
+      static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
+
+  // Partial updates are only possible if the contents of old buffers are
+  // known.
+  priv->has_buffer_age =
+      egl_has_extension(priv->egl_display, "EGL_EXT_buffer_age");
+  if (!priv->has_buffer_age)
+    return;
+
+  if (egl_has_extension(priv->egl_display, "EGL_KHR_partial_update")) {
+    priv->set_damage_region = reinterpret_cast<PFNEGLSETDAMAGEREGIONKHRPROC>(
+        eglGetProcAddress("eglSetDamageRegionKHR"));
+  }
+
+  if (egl_has_extension(priv->egl_display,
+                        "EGL_KHR_swap_buffers_with_damage")) {
+    priv->swap_buffers_with_damage =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+  } else if (egl_has_extension(priv->egl_display,
+                               "EGL_EXT_swap_buffers_with_damage")) {
+    priv->swap_buffers_with_damage =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+  }
+}
+
+// Converts the damage of a frame to EGL rectangles, which have their origin at
+// the bottom left of the surface. Returns the number of rectangles written to
+// @rects.
+static EGLint damage_to_egl_rects(FlRenderer* self,
+                                  const FlutterDamage* damage,
+                                  EGLint* rects) {
+  FlRendererPrivate* priv =
+      static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
+
+  EGLint height = 0;
+  eglQuerySurface(priv->egl_display, priv->egl_surface, EGL_HEIGHT, &height);
+
+  for (size_t i = 0; i < damage->num_rects; i++) {
+    const FlutterRect& rect = damage->damage[i];
+    EGLint* egl_rect = rects + i * 4;
+    egl_rect[0] = static_cast<EGLint>(rect.left);
+    egl_rect[1] = height - static_cast<EGLint>(rect.bottom);
+    egl_rect[2] = static_cast<EGLint>(rect.right - rect.left);
+    egl_rect[3] = static_cast<EGLint>(rect.bottom - rect.top);
+  }
+
+  return damage->num_rects;
+}
+
 static void fl_renderer_class_init(FlRendererClass* klass) {}
 
 static void fl_renderer_init(FlRenderer* self) {}
@@ -92,6 +162,8 @@ gboolean fl_renderer_setup(FlRenderer* self, GError** error) {
     return FALSE;
   }
 
+  setup_partial_updates(self);
+
   if (!eglBindAPI(EGL_OPENGL_ES_API)) {
     g_autofree gchar* config_string =
         egl_config_to_string(priv->egl_display, priv->egl_config);
@@ -219,10 +291,47 @@ guint32 fl_renderer_get_fbo(FlRenderer* self) {
   return 0;
 }
 
+guint32 fl_renderer_get_buffer_age(FlRenderer* self) {
+  FlRendererPrivate* priv =
+      static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
+
+  if (!priv->has_buffer_age)
+    return 0;
+
+  EGLint age = 0;
+  if (!eglQuerySurface(priv->egl_display, priv->egl_surface,
+                       EGL_BUFFER_AGE_EXT, &age)) {
+    g_warning("Failed to query EGL buffer age: %s",
+              egl_error_to_string(eglGetError()));
+    return 0;
+  }
+  priv->buffer_age_queried = TRUE;
+
+  return age;
+}
+
+void fl_renderer_set_damage_region(FlRenderer* self,
+                                   const FlutterDamage* damage) {
+  FlRendererPrivate* priv =
+      static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
+
+  if (priv->set_damage_region == nullptr || !priv->buffer_age_queried)
+    return;
+
+  g_autofree EGLint* rects = g_new(EGLint, damage->num_rects * 4);
+  EGLint n_rects = damage_to_egl_rects(self, damage, rects);
+  if (!priv->set_damage_region(priv->egl_display, priv->egl_surface, rects,
+                               n_rects)) {
+    g_warning("Failed to set EGL damage region: %s",
+              egl_error_to_string(eglGetError()));
+  }
+}
+
 gboolean fl_renderer_present(FlRenderer* self, GError** error) {
   FlRendererPrivate* priv =
       static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
 
+  priv->buffer_age_queried = FALSE;
   if (!eglSwapBuffers(priv->egl_display, priv->egl_surface)) {
     g_set_error(error, fl_renderer_error_quark(), FL_RENDERER_ERROR_FAILED,
                 "Failed to swap EGL buffers: %s",
@@ -232,3 +341,29 @@ gboolean fl_renderer_present(FlRenderer* self, GError** error) {
 
   return TRUE;
 }
+
+gboolean fl_renderer_present_with_damage(FlRenderer* self,
+                                         const FlutterDamage* damage,
+                                         GError** error) {
+  FlRendererPrivate* priv =
+      static_cast<FlRendererPrivate*>(fl_renderer_get_instance_private(self));
+
+  if (priv->swap_buffers_with_damage == nullptr)
+    return fl_renderer_present(self, error);
+
+  // No rectangles swap the whole surface, which is also correct when nothing
+  // changed.
+  g_autofree EGLint* rects = g_new(EGLint, damage->num_rects * 4);
+  EGLint n_rects = damage_to_egl_rects(self, damage, rects);
+
+  priv->buffer_age_queried = FALSE;
+  if (!priv->swap_buffers_with_damage(priv->egl_display, priv->egl_surface,
+                                      rects, n_rects)) {
+    g_set_error(error, fl_renderer_error_quark(), FL_RENDERER_ERROR_FAILED,
+                "Failed to swap EGL buffers with damage: %s",
+                egl_error_to_string(eglGetError()));
+    return FALSE;
+  }
+
+  return TRUE;
+}
@@ -9,6 +9,7 @@
 
 #include <gtk/gtk.h>
 
+#include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_dart_project.h"
 
 G_BEGIN_DECLS
@@ -143,6 +144,31 @@ gboolean fl_renderer_clear_current(FlRenderer* renderer, GError** error);
  */
 guint32 fl_renderer_get_fbo(FlRenderer* renderer);
 
+/**
+ * fl_renderer_get_buffer_age:
+ * @renderer: an #FlRenderer.
+ *
+ * Gets the age of the buffer that will be rendered to, as reported by
+ * EGL_EXT_buffer_age. The rendering context must be current.
+ *
+ * Returns: the number of frames since the buffer was last presented, or 0 if
+ * its contents are undefined.
+ */
+guint32 fl_renderer_get_buffer_age(FlRenderer* renderer);
+
+/**
+ * fl_renderer_set_damage_region:
+ * @renderer: an #FlRenderer.
+ * @damage: the region of the buffer that will be repainted.
+ *
+ * Tells EGL which parts of the buffer will be repainted using
+ * EGL_KHR_partial_update, so tiled GPUs can skip loading and storing the rest.
+ * Does nothing if the extension is not supported or the buffer age has not
+ * been queried for the frame.
+ */
+void fl_renderer_set_damage_region(FlRenderer* renderer,
+                                   const FlutterDamage* damage);
+
 /**
  * fl_renderer_present:
  * @renderer: an #FlRenderer.
@@ -155,6 +181,23 @@ guint32 fl_renderer_get_fbo(FlRenderer* renderer);
  */
 gboolean fl_renderer_present(FlRenderer* renderer, GError** error);
 
+/**
+ * fl_renderer_present_with_damage:
+ * @renderer: an #FlRenderer.
+ * @damage: the region of the buffer that was repainted.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ * to ignore.
+ *
+ * Presents the current frame, only swapping the repainted region if
+ * EGL_KHR_swap_buffers_with_damage or EGL_EXT_swap_buffers_with_damage is
+ * supported.
+ *
+ * Returns %TRUE if successful.
+ */
+gboolean fl_renderer_present_with_damage(FlRenderer* renderer,
+                                         const FlutterDamage* damage,
+                                         GError** error);
+
 G_END_DECLS
 
 #endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_H_
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
 #include "flutter/shell/platform/linux/fl_standard_message_codec_private.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
@@ -346,6 +347,201 @@ static FlValue* read_map_value(FlStandardMessageCodec* self,
   return fl_value_ref(map);
 }
 
+// Reads a typed list from @buffer in standard codec format, as for
+// read_arena_value().
+static gboolean read_arena_typed_list(FlStandardMessageCodec* self,
+                                      GBytes* buffer,
+                                      size_t* offset,
+                                      FlValueType type,
+                                      size_t element_size,
+                                      FlValueArena* arena,
+                                      size_t* arena_size,
+                                      FlValue** value,
+                                      GError** error) {
+  uint32_t length;
+  if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
+                                           error))
+    return FALSE;
+  if (!read_align(buffer, offset, element_size, error))
+    return FALSE;
+  if (!check_size(buffer, *offset, element_size * length, error))
+    return FALSE;
+  const uint8_t* data = get_data(buffer, offset);
+  *offset += element_size * length;
+
+  *arena_size += fl_value_arena_get_value_size(type, data, length);
+  if (arena == nullptr)
+    return TRUE;
+  switch (type) {
+    case FL_VALUE_TYPE_UINT8_LIST:
+      *value = fl_value_arena_new_uint8_list(arena, data, length);
+      break;
+    case FL_VALUE_TYPE_INT32_LIST:
+      *value = fl_value_arena_new_int32_list(
+          arena, reinterpret_cast<const int32_t*>(data), length);
+      break;
+    case FL_VALUE_TYPE_INT64_LIST:
+      *value = fl_value_arena_new_int64_list(
+          arena, reinterpret_cast<const int64_t*>(data), length);
+      break;
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      *value = fl_value_arena_new_float_list(
+          arena, reinterpret_cast<const double*>(data), length);
+      break;
+    default:
+      g_assert_not_reached();
+  }
+  return TRUE;
+}
+
+// Reads a value from @buffer in standard codec format into @arena.
+// If @arena is %NULL the value is only checked, and the space it needs in an
+// arena is added to @arena_size, so that the arena can then be created with a
+// single allocation.
+// Returns TRUE if successful, otherwise sets an error.
+static gboolean read_arena_value(FlStandardMessageCodec* self,
+                                 GBytes* buffer,
+                                 size_t* offset,
+                                 FlValueArena* arena,
+                                 size_t* arena_size,
+                                 FlValue** value,
+                                 GError** error) {
+  uint8_t type;
+  if (!read_uint8(buffer, offset, &type, error))
+    return FALSE;
+
+  switch (type) {
+    case kValueNull:
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_NULL, nullptr, 0);
+      if (arena != nullptr)
+        *value = fl_value_arena_new_null(arena);
+      return TRUE;
+    case kValueTrue:
+    case kValueFalse:
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_BOOL, nullptr, 0);
+      if (arena != nullptr)
+        *value = fl_value_arena_new_bool(arena, type == kValueTrue);
+      return TRUE;
+    case kValueInt32:
+    case kValueInt64: {
+      int64_t v;
+      if (type == kValueInt32) {
+        if (!check_size(buffer, *offset, sizeof(int32_t), error))
+          return FALSE;
+        v = reinterpret_cast<const int32_t*>(get_data(buffer, offset))[0];
+        *offset += sizeof(int32_t);
+      } else {
+        if (!check_size(buffer, *offset, sizeof(int64_t), error))
+          return FALSE;
+        v = reinterpret_cast<const int64_t*>(get_data(buffer, offset))[0];
+        *offset += sizeof(int64_t);
+      }
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_INT, nullptr, 0);
+      if (arena != nullptr)
+        *value = fl_value_arena_new_int(arena, v);
+      return TRUE;
+    }
+    case kValueFloat64: {
+      if (!read_align(buffer, offset, 8, error))
+        return FALSE;
+      if (!check_size(buffer, *offset, sizeof(double), error))
+        return FALSE;
+      double v = reinterpret_cast<const double*>(get_data(buffer, offset))[0];
+      *offset += sizeof(double);
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_FLOAT, nullptr, 0);
+      if (arena != nullptr)
+        *value = fl_value_arena_new_float(arena, v);
+      return TRUE;
+    }
+    case kValueString: {
+      uint32_t length;
+      if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
+                                               error))
+        return FALSE;
+      if (!check_size(buffer, *offset, length, error))
+        return FALSE;
+      const gchar* text =
+          reinterpret_cast<const gchar*>(get_data(buffer, offset));
+      *offset += length;
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_STRING, nullptr, length);
+      if (arena != nullptr)
+        *value = fl_value_arena_new_string(arena, text, length);
+      return TRUE;
+    }
+    case kValueUint8List:
+      return read_arena_typed_list(self, buffer, offset,
+                                   FL_VALUE_TYPE_UINT8_LIST, sizeof(uint8_t),
+                                   arena, arena_size, value, error);
+    case kValueInt32List:
+      return read_arena_typed_list(self, buffer, offset,
+                                   FL_VALUE_TYPE_INT32_LIST, sizeof(int32_t),
+                                   arena, arena_size, value, error);
+    case kValueInt64List:
+      return read_arena_typed_list(self, buffer, offset,
+                                   FL_VALUE_TYPE_INT64_LIST, sizeof(int64_t),
+                                   arena, arena_size, value, error);
+    case kValueFloat64List:
+      return read_arena_typed_list(self, buffer, offset,
+                                   FL_VALUE_TYPE_FLOAT_LIST, sizeof(double),
+                                   arena, arena_size, value, error);
+    case kValueList: {
+      uint32_t length;
+      if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
+                                               error))
+        return FALSE;
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_LIST, nullptr, length);
+      FlValue* list =
+          arena != nullptr ? fl_value_arena_new_list(arena, length) : nullptr;
+      for (size_t i = 0; i < length; i++) {
+        FlValue* child = nullptr;
+        if (!read_arena_value(self, buffer, offset, arena, arena_size, &child,
+                              error))
+          return FALSE;
+        if (list != nullptr)
+          fl_value_arena_set_list_value(list, i, child);
+      }
+      if (arena != nullptr)
+        *value = list;
+      return TRUE;
+    }
+    case kValueMap: {
+      uint32_t length;
+      if (!fl_standard_message_codec_read_size(self, buffer, offset, &length,
+                                               error))
+        return FALSE;
+      *arena_size +=
+          fl_value_arena_get_value_size(FL_VALUE_TYPE_MAP, nullptr, length);
+      FlValue* map =
+          arena != nullptr ? fl_value_arena_new_map(arena, length) : nullptr;
+      for (size_t i = 0; i < length; i++) {
+        FlValue* key = nullptr;
+        FlValue* child = nullptr;
+        if (!read_arena_value(self, buffer, offset, arena, arena_size, &key,
+                              error) ||
+            !read_arena_value(self, buffer, offset, arena, arena_size, &child,
+                              error))
+          return FALSE;
+        if (map != nullptr)
+          fl_value_arena_set_map_entry(map, i, key, child);
+      }
+      if (arena != nullptr)
+        *value = map;
+      return TRUE;
+    }
+    default:
+      g_set_error(error, FL_MESSAGE_CODEC_ERROR,
+                  FL_MESSAGE_CODEC_ERROR_UNSUPPORTED_TYPE,
+                  "Unexpected standard codec type %02x", type);
+      return FALSE;
+  }
+}
+
 // Implements FlMessageCodec::encode_message.
 static GBytes* fl_standard_message_codec_encode_message(FlMessageCodec* codec,
                                                         FlValue* message,
@@ -361,6 +557,8 @@ static GBytes* fl_standard_message_codec_encode_message(FlMessageCodec* codec,
 }
 
 // Implements FlMessageCodec::decode_message.
+// Messages are decoded into an immutable arena, which is measured on a first
+// pass over the message so that it takes a single allocation.
 static FlValue* fl_standard_message_codec_decode_message(FlMessageCodec* codec,
                                                          GBytes* message,
                                                          GError** error) {
@@ -368,9 +566,9 @@ static FlValue* fl_standard_message_codec_decode_message(FlMessageCodec* codec,
       reinterpret_cast<FlStandardMessageCodec*>(codec);
 
   size_t offset = 0;
-  g_autoptr(FlValue) value =
-      fl_standard_message_codec_read_value(self, message, &offset, error);
-  if (value == nullptr)
+  size_t arena_size = 0;
+  if (!read_arena_value(self, message, &offset, nullptr, &arena_size, nullptr,
+                        error))
     return nullptr;
 
   if (offset != g_bytes_get_size(message)) {
@@ -381,6 +579,13 @@ static FlValue* fl_standard_message_codec_decode_message(FlMessageCodec* codec,
     return nullptr;
   }
 
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(message, arena_size);
+  offset = 0;
+  FlValue* value = nullptr;
+  if (!read_arena_value(self, message, &offset, arena, &arena_size, &value,
+                        error))
+    return nullptr;
+
   return fl_value_ref(value);
 }
 
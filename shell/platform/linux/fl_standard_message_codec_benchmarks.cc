@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+
+namespace flutter {
+namespace benchmarking {
+
+namespace {
+
+// A list of @count maps, shaped like a list of records sent by a plugin.
+FlValue* create_records(int64_t count) {
+  FlValue* records = fl_value_new_list();
+  for (int64_t i = 0; i < count; i++) {
+    g_autoptr(FlValue) record = fl_value_new_map();
+    fl_value_set_string_take(record, "id", fl_value_new_int(i));
+    fl_value_set_string_take(record, "name", fl_value_new_string("record"));
+    fl_value_set_string_take(record, "score", fl_value_new_float(0.5 * i));
+    fl_value_append(records, record);
+  }
+  return records;
+}
+
+FlValue* create_float_list(int64_t count) {
+  g_autofree double* values = g_new0(double, count);
+  return fl_value_new_float_list(values, count);
+}
+
+void encode(benchmark::State& state, FlValue* value) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  size_t message_size = 0;
+  while (state.KeepRunning()) {
+    g_autoptr(GBytes) message = fl_message_codec_encode_message(
+        FL_MESSAGE_CODEC(codec), value, nullptr);
+    message_size = g_bytes_get_size(message);
+    benchmark::DoNotOptimize(message);
+  }
+  state.SetBytesProcessed(state.iterations() * message_size);
+}
+
+void decode(benchmark::State& state, FlValue* value) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GBytes) message =
+      fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), value, nullptr);
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) decoded = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * g_bytes_get_size(message));
+}
+
+}  // namespace
+
+static void BM_FlStandardMessageCodecEncodeRecords(benchmark::State& state) {
+  g_autoptr(FlValue) value = create_records(state.range(0));
+  encode(state, value);
+}
+
+static void BM_FlStandardMessageCodecDecodeRecords(benchmark::State& state) {
+  g_autoptr(FlValue) value = create_records(state.range(0));
+  decode(state, value);
+}
+
+static void BM_FlStandardMessageCodecEncodeFloatList(benchmark::State& state) {
+  g_autoptr(FlValue) value = create_float_list(state.range(0));
+  encode(state, value);
+}
+
+static void BM_FlStandardMessageCodecDecodeFloatList(benchmark::State& state) {
+  g_autoptr(FlValue) value = create_float_list(state.range(0));
+  decode(state, value);
+}
+
+BENCHMARK(BM_FlStandardMessageCodecEncodeRecords)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096);
+BENCHMARK(BM_FlStandardMessageCodecDecodeRecords)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096);
+BENCHMARK(BM_FlStandardMessageCodecEncodeFloatList)
+    ->RangeMultiplier(16)
+    ->Range(16, 65536);
+BENCHMARK(BM_FlStandardMessageCodecDecodeFloatList)
+    ->RangeMultiplier(16)
+    ->Range(16, 65536);
+
+}  // namespace benchmarking
+}  // namespace flutter
@@ -1035,3 +1035,68 @@ TEST(FlStandardMessageCodecTest, EncodeDecode) {
 
   ASSERT_TRUE(fl_value_equal(input, output));
 }
+
+TEST(FlStandardMessageCodecTest, DecodeValueOutlivesParent) {
+  g_autoptr(FlValue) child = nullptr;
+  {
+    g_autoptr(FlValue) value = decode_message(
+        "0c02070568656c6c6f0d010703616765032a000000");
+    ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_LIST);
+    ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(2));
+    child = fl_value_ref(fl_value_get_list_value(value, 1));
+  }
+  ASSERT_EQ(fl_value_get_type(child), FL_VALUE_TYPE_MAP);
+  ASSERT_EQ(fl_value_get_length(child), static_cast<size_t>(1));
+  FlValue* age = fl_value_lookup_string(child, "age");
+  ASSERT_NE(age, nullptr);
+  EXPECT_EQ(fl_value_get_int(age), 42);
+}
+
+TEST(FlStandardMessageCodecTest, DecodeFloatListBorrowsMessage) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GBytes) message = hex_string_to_bytes(
+      "0b020000000000000000000000000000000000000000000000000000000000f03f");
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlValue) value =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  EXPECT_EQ(error, nullptr);
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_FLOAT_LIST);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(2));
+
+  gsize message_length;
+  const uint8_t* data =
+      static_cast<const uint8_t*>(g_bytes_get_data(message, &message_length));
+  const uint8_t* list =
+      reinterpret_cast<const uint8_t*>(fl_value_get_float_list(value));
+  EXPECT_EQ(list, data + 8);
+  EXPECT_EQ(fl_value_get_float_list(value)[1], 1.0);
+}
+
+TEST(FlStandardMessageCodecTest, EncodeDecodeNested) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+
+  g_autoptr(FlValue) input = fl_value_new_list();
+  for (int i = 0; i < 16; i++) {
+    g_autoptr(FlValue) record = fl_value_new_map();
+    fl_value_set_string_take(record, "id", fl_value_new_int(i));
+    fl_value_set_string_take(record, "name", fl_value_new_string("record"));
+    const int32_t values[] = {i, -i, i * 2};
+    fl_value_set_string_take(record, "values",
+                             fl_value_new_int32_list(values, 3));
+    fl_value_append(input, record);
+  }
+
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GBytes) message =
+      fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), input, &error);
+  EXPECT_NE(message, nullptr);
+  EXPECT_EQ(error, nullptr);
+
+  g_autoptr(FlValue) output =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  EXPECT_EQ(error, nullptr);
+  EXPECT_NE(output, nullptr);
+
+  ASSERT_TRUE(fl_value_equal(input, output));
+}
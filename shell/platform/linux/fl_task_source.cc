@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/linux/fl_task_source.h"
+
+#include <queue>
+#include <vector>
+
+static constexpr int kMicrosecondsPerNanosecond = 1000;
+
+// The time a dispatch keeps starting tasks for, which is a quarter of a frame
+// at 60Hz.
+static constexpr gint64 kDispatchBudgetMicroseconds = 4000;
+
+namespace {
+
+struct Task {
+  // The monotonic time the task is due, in microseconds.
+  gint64 ready_time;
+  // The order the task was posted in, which orders tasks due at the same time.
+  uint64_t order;
+  FlutterTask task;
+};
+
+// Orders the tasks that are due later first, so that the top of a priority
+// queue is the task that is due next.
+struct TaskIsDueLater {
+  bool operator()(const Task& a, const Task& b) const {
+    if (a.ready_time == b.ready_time) {
+      return a.order > b.order;
+    }
+    return a.ready_time > b.ready_time;
+  }
+};
+
+using TaskQueue = std::priority_queue<Task, std::vector<Task>, TaskIsDueLater>;
+
+}  // namespace
+
+// Subclass of GSource that integrates Flutter tasks into the GLib main loop.
+typedef struct {
+  GSource parent;
+
+  FlTaskSourceRunTaskFunc run_task;
+  gpointer user_data;
+
+  // Guards the fields below, and the ready time of the source so that it
+  // always matches the task that is due next.
+  GMutex mutex;
+  TaskQueue* tasks;
+  uint64_t next_order;
+} FlTaskSource;
+
+// Makes the source ready when the task that is due next is. Called with the
+// mutex held.
+static void update_ready_time(FlTaskSource* self) {
+  g_source_set_ready_time(reinterpret_cast<GSource*>(self),
+                          self->tasks->empty() ? -1
+                                               : self->tasks->top().ready_time);
+}
+
+// Runs the tasks that are due, until the budget runs out.
+static gboolean fl_task_source_dispatch(GSource* source,
+                                        GSourceFunc callback,
+                                        gpointer user_data) {
+  FlTaskSource* self = reinterpret_cast<FlTaskSource*>(source);
+
+  const gint64 start_time = g_get_monotonic_time();
+  while (TRUE) {
+    FlutterTask task;
+    {
+      g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+      const gint64 now = g_get_monotonic_time();
+      if (self->tasks->empty() || self->tasks->top().ready_time > now) {
+        update_ready_time(self);
+        break;
+      }
+      if (now - start_time >= kDispatchBudgetMicroseconds) {
+        // Let the other sources, like input, run before the remaining tasks.
+        g_source_set_ready_time(source, now);
+        break;
+      }
+      task = self->tasks->top().task;
+      self->tasks->pop();
+    }
+    // The task may post more tasks, so it runs without the mutex held.
+    self->run_task(&task, self->user_data);
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void fl_task_source_finalize(GSource* source) {
+  FlTaskSource* self = reinterpret_cast<FlTaskSource*>(source);
+  delete self->tasks;
+  g_mutex_clear(&self->mutex);
+}
+
+// Table of functions for Flutter GLib main loop integration.
+static GSourceFuncs fl_task_source_funcs = {
+    nullptr,                  // prepare
+    nullptr,                  // check
+    fl_task_source_dispatch,  // dispatch
+    fl_task_source_finalize,  // finalize
+    nullptr,
+    nullptr  // Internal usage
+};
+
+GSource* fl_task_source_new(FlTaskSourceRunTaskFunc run_task,
+                            gpointer user_data) {
+  GSource* source = g_source_new(&fl_task_source_funcs, sizeof(FlTaskSource));
+  FlTaskSource* self = reinterpret_cast<FlTaskSource*>(source);
+  self->run_task = run_task;
+  self->user_data = user_data;
+  g_mutex_init(&self->mutex);
+  self->tasks = new TaskQueue();
+  self->next_order = 0;
+  return source;
+}
+
+void fl_task_source_post_task(GSource* source,
+                              FlutterTask task,
+                              uint64_t target_time_nanos) {
+  FlTaskSource* self = reinterpret_cast<FlTaskSource*>(source);
+
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->mutex);
+  const gint64 ready_time = target_time_nanos / kMicrosecondsPerNanosecond;
+  // The main loop only needs waking if this task is due before the others.
+  const bool is_next =
+      self->tasks->empty() || ready_time < self->tasks->top().ready_time;
+  self->tasks->push(Task{ready_time, self->next_order++, task});
+  if (is_next) {
+    update_ready_time(self);
+  }
+}
+
+gint64 fl_task_source_get_dispatch_budget() {
+  return kDispatchBudgetMicroseconds;
+}
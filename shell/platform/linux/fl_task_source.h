@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_TASK_SOURCE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_TASK_SOURCE_H_
+
+#include <glib.h>
+
+#include "flutter/shell/platform/embedder/embedder.h"
+
+G_BEGIN_DECLS
+
+/**
+ * FlTaskSourceRunTaskFunc:
+ * @task: the task to run.
+ * @user_data: user data passed to fl_task_source_new().
+ *
+ * Function called to run a Flutter task that is due.
+ */
+typedef void (*FlTaskSourceRunTaskFunc)(const FlutterTask* task,
+                                        gpointer user_data);
+
+/**
+ * fl_task_source_new:
+ * @run_task: function to run the tasks with.
+ * @user_data: (closure): user data to pass to @run_task.
+ *
+ * Creates a #GSource that runs the platform tasks of a Flutter engine in the
+ * GLib main loop it is attached to.
+ *
+ * The tasks are kept in a heap ordered by the time they are due, and a single
+ * source serves all of them. Each dispatch runs the tasks that are due, for as
+ * long as fl_task_source_get_dispatch_budget() allows, so that a burst of tasks
+ * neither creates a source per task nor keeps the main loop from handling
+ * input.
+ *
+ * Returns: a new #GSource.
+ */
+GSource* fl_task_source_new(FlTaskSourceRunTaskFunc run_task,
+                            gpointer user_data);
+
+/**
+ * fl_task_source_post_task:
+ * @source: a #GSource created by fl_task_source_new().
+ * @task: the task to run.
+ * @target_time_nanos: the time to run @task at, in the clock of
+ * FlutterEngineGetCurrentTime().
+ *
+ * Queues @task to be run on the main loop. This can be called from any thread.
+ */
+void fl_task_source_post_task(GSource* source,
+                              FlutterTask task,
+                              uint64_t target_time_nanos);
+
+/**
+ * fl_task_source_get_dispatch_budget:
+ *
+ * Gets the longest time in microseconds a dispatch keeps starting tasks for
+ * before it yields to the other sources of the main loop.
+ *
+ * Returns: a duration in microseconds.
+ */
+gint64 fl_task_source_get_dispatch_budget();
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_TASK_SOURCE_H_
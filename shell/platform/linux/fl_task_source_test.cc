@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/linux/fl_task_source.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static constexpr uint64_t kNanosecondsPerMicrosecond = 1000;
+
+// Records the tasks that were run, identified by their task field.
+typedef struct {
+  std::vector<uint64_t> run_tasks;
+  // Time to spend in each task, in microseconds.
+  gint64 task_duration;
+} TaskRecord;
+
+static void record_task_cb(const FlutterTask* task, gpointer user_data) {
+  TaskRecord* record = static_cast<TaskRecord*>(user_data);
+  record->run_tasks.push_back(task->task);
+  if (record->task_duration > 0)
+    g_usleep(record->task_duration);
+}
+
+static FlutterTask make_task(uint64_t id) {
+  FlutterTask task = {};
+  task.task = id;
+  return task;
+}
+
+static uint64_t now_nanos() {
+  return g_get_monotonic_time() * kNanosecondsPerMicrosecond;
+}
+
+// Checks due tasks run in the order they are due, then the order they were
+// posted in.
+TEST(FlTaskSourceTest, RunsTasksInOrder) {
+  g_autoptr(GMainContext) context = g_main_context_new();
+  TaskRecord record = {};
+  g_autoptr(GSource) source = fl_task_source_new(record_task_cb, &record);
+  g_source_attach(source, context);
+
+  const uint64_t now = now_nanos();
+  fl_task_source_post_task(source, make_task(2), now);
+  fl_task_source_post_task(source, make_task(3), now);
+  fl_task_source_post_task(source, make_task(1), now - 1000);
+
+  while (record.run_tasks.size() < 3)
+    g_main_context_iteration(context, TRUE);
+  EXPECT_EQ(record.run_tasks, std::vector<uint64_t>({1, 2, 3}));
+
+  g_source_destroy(source);
+}
+
+// Checks tasks that are not due yet are not run.
+TEST(FlTaskSourceTest, DefersTasksUntilDue) {
+  g_autoptr(GMainContext) context = g_main_context_new();
+  TaskRecord record = {};
+  g_autoptr(GSource) source = fl_task_source_new(record_task_cb, &record);
+  g_source_attach(source, context);
+
+  const uint64_t an_hour = G_USEC_PER_SEC * 3600 * kNanosecondsPerMicrosecond;
+  fl_task_source_post_task(source, make_task(2), now_nanos() + an_hour);
+  fl_task_source_post_task(source, make_task(1), now_nanos());
+
+  while (record.run_tasks.size() < 1)
+    g_main_context_iteration(context, TRUE);
+  EXPECT_FALSE(g_main_context_iteration(context, FALSE));
+  EXPECT_EQ(record.run_tasks, std::vector<uint64_t>({1}));
+
+  g_source_destroy(source);
+}
+
+// Checks a dispatch yields to the main loop once its budget is used up, and
+// the remaining tasks run in the next ones.
+TEST(FlTaskSourceTest, YieldsAfterBudget) {
+  g_autoptr(GMainContext) context = g_main_context_new();
+  TaskRecord record = {};
+  record.task_duration = fl_task_source_get_dispatch_budget();
+  g_autoptr(GSource) source = fl_task_source_new(record_task_cb, &record);
+  g_source_attach(source, context);
+
+  const uint64_t now = now_nanos();
+  fl_task_source_post_task(source, make_task(1), now);
+  fl_task_source_post_task(source, make_task(2), now);
+
+  while (record.run_tasks.size() < 1)
+    g_main_context_iteration(context, TRUE);
+  EXPECT_EQ(record.run_tasks, std::vector<uint64_t>({1}));
+
+  EXPECT_TRUE(g_main_context_iteration(context, FALSE));
+  EXPECT_EQ(record.run_tasks, std::vector<uint64_t>({1, 2}));
+
+  g_source_destroy(source);
+}
@@ -3,12 +3,15 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
 struct _FlValue {
   FlValueType type;
   int ref_count;
+  // Arena the value is in, or nullptr if it has its own allocation.
+  FlValueArena* arena;
 };
 
 typedef struct {
@@ -66,6 +69,32 @@ typedef struct {
   GPtrArray* values;
 } FlValueMap;
 
+// Lists and maps in an arena, which can't change size.
+typedef struct {
+  FlValue parent;
+  FlValue** values;
+  size_t values_length;
+} FlValueArenaList;
+
+typedef struct {
+  FlValue parent;
+  FlValue** keys;
+  FlValue** values;
+  size_t values_length;
+} FlValueArenaMap;
+
+struct _FlValueArena {
+  int ref_count;
+  // Message the values were decoded from, which typed lists point into.
+  GBytes* buffer;
+  // Unused space.
+  uint8_t* data;
+  uint8_t* data_end;
+};
+
+// Alignment of the allocations in an arena, which suits all value types.
+static constexpr size_t kArenaAlignment = 8;
+
 static FlValue* fl_value_new(FlValueType type, size_t size) {
   FlValue* self = static_cast<FlValue*>(g_malloc0(size));
   self->type = type;
@@ -73,6 +102,52 @@ static FlValue* fl_value_new(FlValueType type, size_t size) {
   return self;
 }
 
+// Rounds @size up to a multiple of kArenaAlignment.
+static size_t arena_align(size_t size) {
+  return (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+}
+
+// Gets the space needed in an arena for the data of a typed list, which is
+// only copied if it is not aligned for its values.
+static size_t arena_list_data_size(const void* data,
+                                   size_t length,
+                                   size_t element_size) {
+  if (reinterpret_cast<uintptr_t>(data) % element_size == 0)
+    return 0;
+  return arena_align(element_size * length);
+}
+
+static void* arena_alloc(FlValueArena* arena, size_t size) {
+  size = arena_align(size);
+  g_return_val_if_fail(
+      static_cast<size_t>(arena->data_end - arena->data) >= size, nullptr);
+  void* data = arena->data;
+  arena->data += size;
+  return data;
+}
+
+static FlValue* arena_value_new(FlValueArena* arena,
+                                FlValueType type,
+                                size_t size) {
+  FlValue* self = static_cast<FlValue*>(arena_alloc(arena, size));
+  self->type = type;
+  self->ref_count = 1;
+  self->arena = arena;
+  return self;
+}
+
+// Returns @data, or a copy of it in @arena if it is not aligned for its values.
+static void* arena_list_data(FlValueArena* arena,
+                             const void* data,
+                             size_t length,
+                             size_t element_size) {
+  if (reinterpret_cast<uintptr_t>(data) % element_size == 0)
+    return const_cast<void*>(data);
+  void* copy = arena_alloc(arena, element_size * length);
+  memcpy(copy, data, element_size * length);
+  return copy;
+}
+
 // Helper function to match GDestroyNotify type.
 static void fl_value_destroy(gpointer value) {
   fl_value_unref(static_cast<FlValue*>(value));
@@ -322,12 +397,20 @@ G_MODULE_EXPORT FlValue* fl_value_new_map() {
 
 G_MODULE_EXPORT FlValue* fl_value_ref(FlValue* self) {
   g_return_val_if_fail(self != nullptr, nullptr);
+  if (self->arena != nullptr) {
+    self->arena->ref_count++;
+    return self;
+  }
   self->ref_count++;
   return self;
 }
 
 G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
   g_return_if_fail(self != nullptr);
+  if (self->arena != nullptr) {
+    fl_value_arena_unref(self->arena);
+    return;
+  }
   g_return_if_fail(self->ref_count > 0);
   self->ref_count--;
   if (self->ref_count != 0)
@@ -487,6 +570,7 @@ G_MODULE_EXPORT void fl_value_append(FlValue* self, FlValue* value) {
 G_MODULE_EXPORT void fl_value_append_take(FlValue* self, FlValue* value) {
   g_return_if_fail(self != nullptr);
   g_return_if_fail(self->type == FL_VALUE_TYPE_LIST);
+  g_return_if_fail(self->arena == nullptr);
   g_return_if_fail(value != nullptr);
 
   FlValueList* v = reinterpret_cast<FlValueList*>(self);
@@ -507,6 +591,7 @@ G_MODULE_EXPORT void fl_value_set_take(FlValue* self,
                                        FlValue* value) {
   g_return_if_fail(self != nullptr);
   g_return_if_fail(self->type == FL_VALUE_TYPE_MAP);
+  g_return_if_fail(self->arena == nullptr);
   g_return_if_fail(key != nullptr);
   g_return_if_fail(value != nullptr);
 
@@ -629,10 +714,14 @@ G_MODULE_EXPORT size_t fl_value_get_length(FlValue* self) {
       return v->values_length;
     }
     case FL_VALUE_TYPE_LIST: {
+      if (self->arena != nullptr)
+        return reinterpret_cast<FlValueArenaList*>(self)->values_length;
       FlValueList* v = reinterpret_cast<FlValueList*>(self);
       return v->values->len;
     }
     case FL_VALUE_TYPE_MAP: {
+      if (self->arena != nullptr)
+        return reinterpret_cast<FlValueArenaMap*>(self)->values_length;
       FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
       return v->keys->len;
     }
@@ -651,6 +740,8 @@ G_MODULE_EXPORT FlValue* fl_value_get_list_value(FlValue* self, size_t index) {
   g_return_val_if_fail(self != nullptr, nullptr);
   g_return_val_if_fail(self->type == FL_VALUE_TYPE_LIST, nullptr);
 
+  if (self->arena != nullptr)
+    return reinterpret_cast<FlValueArenaList*>(self)->values[index];
   FlValueList* v = reinterpret_cast<FlValueList*>(self);
   return static_cast<FlValue*>(g_ptr_array_index(v->values, index));
 }
@@ -659,6 +750,8 @@ G_MODULE_EXPORT FlValue* fl_value_get_map_key(FlValue* self, size_t index) {
   g_return_val_if_fail(self != nullptr, nullptr);
   g_return_val_if_fail(self->type == FL_VALUE_TYPE_MAP, nullptr);
 
+  if (self->arena != nullptr)
+    return reinterpret_cast<FlValueArenaMap*>(self)->keys[index];
   FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
   return static_cast<FlValue*>(g_ptr_array_index(v->keys, index));
 }
@@ -667,6 +760,8 @@ G_MODULE_EXPORT FlValue* fl_value_get_map_value(FlValue* self, size_t index) {
   g_return_val_if_fail(self != nullptr, nullptr);
   g_return_val_if_fail(self->type == FL_VALUE_TYPE_MAP, nullptr);
 
+  if (self->arena != nullptr)
+    return reinterpret_cast<FlValueArenaMap*>(self)->values[index];
   FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
   return static_cast<FlValue*>(g_ptr_array_index(v->values, index));
 }
@@ -693,3 +788,186 @@ G_MODULE_EXPORT gchar* fl_value_to_string(FlValue* value) {
   value_to_string(value, buffer);
   return g_string_free(buffer, FALSE);
 }
+
+size_t fl_value_arena_get_value_size(FlValueType type,
+                                     const void* data,
+                                     size_t length) {
+  switch (type) {
+    case FL_VALUE_TYPE_NULL:
+      return arena_align(sizeof(FlValue));
+    case FL_VALUE_TYPE_BOOL:
+      return arena_align(sizeof(FlValueBool));
+    case FL_VALUE_TYPE_INT:
+      return arena_align(sizeof(FlValueInt));
+    case FL_VALUE_TYPE_FLOAT:
+      return arena_align(sizeof(FlValueDouble));
+    case FL_VALUE_TYPE_STRING:
+      return arena_align(sizeof(FlValueString)) + arena_align(length + 1);
+    case FL_VALUE_TYPE_UINT8_LIST:
+      return arena_align(sizeof(FlValueUint8List));
+    case FL_VALUE_TYPE_INT32_LIST:
+      return arena_align(sizeof(FlValueInt32List)) +
+             arena_list_data_size(data, length, sizeof(int32_t));
+    case FL_VALUE_TYPE_INT64_LIST:
+      return arena_align(sizeof(FlValueInt64List)) +
+             arena_list_data_size(data, length, sizeof(int64_t));
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      return arena_align(sizeof(FlValueFloatList)) +
+             arena_list_data_size(data, length, sizeof(double));
+    case FL_VALUE_TYPE_LIST:
+      return arena_align(sizeof(FlValueArenaList)) +
+             arena_align(sizeof(FlValue*) * length);
+    case FL_VALUE_TYPE_MAP:
+      return arena_align(sizeof(FlValueArenaMap)) +
+             2 * arena_align(sizeof(FlValue*) * length);
+  }
+  return 0;
+}
+
+FlValueArena* fl_value_arena_new(GBytes* buffer, size_t size) {
+  size_t header_size = arena_align(sizeof(FlValueArena));
+  FlValueArena* self =
+      static_cast<FlValueArena*>(g_malloc(header_size + size));
+  self->ref_count = 1;
+  self->buffer = g_bytes_ref(buffer);
+  self->data = reinterpret_cast<uint8_t*>(self) + header_size;
+  self->data_end = self->data + size;
+  return self;
+}
+
+void fl_value_arena_unref(FlValueArena* self) {
+  g_return_if_fail(self != nullptr);
+  g_return_if_fail(self->ref_count > 0);
+  self->ref_count--;
+  if (self->ref_count != 0)
+    return;
+
+  g_bytes_unref(self->buffer);
+  g_free(self);
+}
+
+FlValue* fl_value_arena_new_null(FlValueArena* arena) {
+  return arena_value_new(arena, FL_VALUE_TYPE_NULL, sizeof(FlValue));
+}
+
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value) {
+  FlValueBool* self = reinterpret_cast<FlValueBool*>(
+      arena_value_new(arena, FL_VALUE_TYPE_BOOL, sizeof(FlValueBool)));
+  self->value = value;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value) {
+  FlValueInt* self = reinterpret_cast<FlValueInt*>(
+      arena_value_new(arena, FL_VALUE_TYPE_INT, sizeof(FlValueInt)));
+  self->value = value;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value) {
+  FlValueDouble* self = reinterpret_cast<FlValueDouble*>(
+      arena_value_new(arena, FL_VALUE_TYPE_FLOAT, sizeof(FlValueDouble)));
+  self->value = value;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_string(FlValueArena* arena,
+                                   const gchar* value,
+                                   size_t value_length) {
+  FlValueString* self = reinterpret_cast<FlValueString*>(
+      arena_value_new(arena, FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
+  self->value = static_cast<gchar*>(arena_alloc(arena, value_length + 1));
+  memcpy(self->value, value, value_length);
+  self->value[value_length] = '\0';
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_uint8_list(FlValueArena* arena,
+                                       const uint8_t* data,
+                                       size_t data_length) {
+  FlValueUint8List* self = reinterpret_cast<FlValueUint8List*>(arena_value_new(
+      arena, FL_VALUE_TYPE_UINT8_LIST, sizeof(FlValueUint8List)));
+  self->values = const_cast<uint8_t*>(data);
+  self->values_length = data_length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_int32_list(FlValueArena* arena,
+                                       const int32_t* data,
+                                       size_t data_length) {
+  FlValueInt32List* self = reinterpret_cast<FlValueInt32List*>(arena_value_new(
+      arena, FL_VALUE_TYPE_INT32_LIST, sizeof(FlValueInt32List)));
+  self->values = static_cast<int32_t*>(
+      arena_list_data(arena, data, data_length, sizeof(int32_t)));
+  self->values_length = data_length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_int64_list(FlValueArena* arena,
+                                       const int64_t* data,
+                                       size_t data_length) {
+  FlValueInt64List* self = reinterpret_cast<FlValueInt64List*>(arena_value_new(
+      arena, FL_VALUE_TYPE_INT64_LIST, sizeof(FlValueInt64List)));
+  self->values = static_cast<int64_t*>(
+      arena_list_data(arena, data, data_length, sizeof(int64_t)));
+  self->values_length = data_length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_float_list(FlValueArena* arena,
+                                       const double* data,
+                                       size_t data_length) {
+  FlValueFloatList* self = reinterpret_cast<FlValueFloatList*>(arena_value_new(
+      arena, FL_VALUE_TYPE_FLOAT_LIST, sizeof(FlValueFloatList)));
+  self->values = static_cast<double*>(
+      arena_list_data(arena, data, data_length, sizeof(double)));
+  self->values_length = data_length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t length) {
+  FlValueArenaList* self = reinterpret_cast<FlValueArenaList*>(
+      arena_value_new(arena, FL_VALUE_TYPE_LIST, sizeof(FlValueArenaList)));
+  self->values =
+      static_cast<FlValue**>(arena_alloc(arena, sizeof(FlValue*) * length));
+  self->values_length = length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+void fl_value_arena_set_list_value(FlValue* list,
+                                   size_t index,
+                                   FlValue* value) {
+  g_return_if_fail(list->type == FL_VALUE_TYPE_LIST);
+  g_return_if_fail(list->arena != nullptr);
+  g_return_if_fail(value->arena == list->arena);
+
+  FlValueArenaList* v = reinterpret_cast<FlValueArenaList*>(list);
+  g_return_if_fail(index < v->values_length);
+  v->values[index] = value;
+}
+
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t length) {
+  FlValueArenaMap* self = reinterpret_cast<FlValueArenaMap*>(
+      arena_value_new(arena, FL_VALUE_TYPE_MAP, sizeof(FlValueArenaMap)));
+  self->keys =
+      static_cast<FlValue**>(arena_alloc(arena, sizeof(FlValue*) * length));
+  self->values =
+      static_cast<FlValue**>(arena_alloc(arena, sizeof(FlValue*) * length));
+  self->values_length = length;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+void fl_value_arena_set_map_entry(FlValue* map,
+                                  size_t index,
+                                  FlValue* key,
+                                  FlValue* value) {
+  g_return_if_fail(map->type == FL_VALUE_TYPE_MAP);
+  g_return_if_fail(map->arena != nullptr);
+  g_return_if_fail(key->arena == map->arena);
+  g_return_if_fail(value->arena == map->arena);
+
+  FlValueArenaMap* v = reinterpret_cast<FlValueArenaMap*>(map);
+  g_return_if_fail(index < v->values_length);
+  v->keys[index] = key;
+  v->values[index] = value;
+}
@@ -0,0 +1,200 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+
+G_BEGIN_DECLS
+
+/**
+ * FlValueArena:
+ *
+ * #FlValueArena is a single allocation holding an immutable tree of #FlValue
+ * decoded from a message. Typed lists point into the message where they are
+ * suitably aligned rather than being copied.
+ *
+ * The values in an arena share its reference count, so referencing any of
+ * them keeps the whole tree and the message alive. Lists and maps in an arena
+ * cannot be modified with fl_value_append() or fl_value_set().
+ *
+ * An arena is sized up front with fl_value_arena_get_value_size(), which
+ * requires walking the message twice: once to measure it and once to build it.
+ */
+typedef struct _FlValueArena FlValueArena;
+
+/**
+ * fl_value_arena_get_value_size:
+ * @type: the type of value.
+ * @data: (allow-none): the data of a typed list, which determines whether it
+ * needs to be copied into the arena.
+ * @length: the length of a string, typed list, list or map.
+ *
+ * Gets the space a value needs in an arena, not including the values it
+ * contains.
+ *
+ * Returns: a size in bytes.
+ */
+size_t fl_value_arena_get_value_size(FlValueType type,
+                                     const void* data,
+                                     size_t length);
+
+/**
+ * fl_value_arena_new:
+ * @buffer: the message the values are decoded from.
+ * @size: the total size of the values, as given by
+ * fl_value_arena_get_value_size().
+ *
+ * Creates an arena to decode the values in @buffer into.
+ *
+ * Returns: a new #FlValueArena.
+ */
+FlValueArena* fl_value_arena_new(GBytes* buffer, size_t size);
+
+/**
+ * fl_value_arena_unref:
+ * @arena: an #FlValueArena.
+ *
+ * Drops the reference returned by fl_value_arena_new(). The arena is freed
+ * once there are no references to it or to its values either.
+ */
+void fl_value_arena_unref(FlValueArena* arena);
+
+/**
+ * fl_value_arena_new_null:
+ * @arena: an #FlValueArena.
+ *
+ * Creates a #FlValue that contains a null value in @arena.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_null(FlValueArena* arena);
+
+/**
+ * fl_value_arena_new_bool:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates a #FlValue that contains a boolean value in @arena.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value);
+
+/**
+ * fl_value_arena_new_int:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates a #FlValue that contains an integer in @arena.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value);
+
+/**
+ * fl_value_arena_new_float:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates a #FlValue that contains a floating point number in @arena.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value);
+
+/**
+ * fl_value_arena_new_string:
+ * @arena: an #FlValueArena.
+ * @value: a UTF-8 text string, which does not need to be null terminated.
+ * @value_length: number of bytes in @value.
+ *
+ * Creates a #FlValue that contains a copy of @value in @arena.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_string(FlValueArena* arena,
+                                   const gchar* value,
+                                   size_t value_length);
+
+/**
+ * fl_value_arena_new_uint8_list:
+ * @arena: an #FlValueArena.
+ * @data: the values, which must be in the message of @arena.
+ * @data_length: number of elements in @data.
+ *
+ * Creates a #FlValue that contains an unsigned 8 bit integer list in @arena.
+ * Similarly for fl_value_arena_new_int32_list(),
+ * fl_value_arena_new_int64_list() and fl_value_arena_new_float_list(), which
+ * copy @data into @arena if it is not aligned for the type of its values.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_uint8_list(FlValueArena* arena,
+                                       const uint8_t* data,
+                                       size_t data_length);
+FlValue* fl_value_arena_new_int32_list(FlValueArena* arena,
+                                       const int32_t* data,
+                                       size_t data_length);
+FlValue* fl_value_arena_new_int64_list(FlValueArena* arena,
+                                       const int64_t* data,
+                                       size_t data_length);
+FlValue* fl_value_arena_new_float_list(FlValueArena* arena,
+                                       const double* data,
+                                       size_t data_length);
+
+/**
+ * fl_value_arena_new_list:
+ * @arena: an #FlValueArena.
+ * @length: the number of values in the list.
+ *
+ * Creates a #FlValue that contains a list of @length values in @arena, which
+ * must be set with fl_value_arena_set_list_value() before it is used.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t length);
+
+/**
+ * fl_value_arena_set_list_value:
+ * @list: a list created by fl_value_arena_new_list().
+ * @index: an index less than the length of @list.
+ * @value: a #FlValue in the same arena as @list.
+ *
+ * Sets a value of a list in an arena.
+ */
+void fl_value_arena_set_list_value(FlValue* list, size_t index, FlValue* value);
+
+/**
+ * fl_value_arena_new_map:
+ * @arena: an #FlValueArena.
+ * @length: the number of entries in the map.
+ *
+ * Creates a #FlValue that contains a map of @length entries in @arena, which
+ * must be set with fl_value_arena_set_map_entry() before it is used.
+ *
+ * Returns: a #FlValue owned by @arena.
+ */
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t length);
+
+/**
+ * fl_value_arena_set_map_entry:
+ * @map: a map created by fl_value_arena_new_map().
+ * @index: an index less than the length of @map.
+ * @key: a #FlValue in the same arena as @map.
+ * @value: a #FlValue in the same arena as @map.
+ *
+ * Sets an entry of a map in an arena.
+ */
+void fl_value_arena_set_map_entry(FlValue* map,
+                                  size_t index,
+                                  FlValue* key,
+                                  FlValue* value);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FlValueArena, fl_value_arena_unref)
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
@@ -313,6 +313,37 @@ EGLBoolean eglMakeCurrent(EGLDisplay dpy,
   return bool_success();
 }
 
+const char* eglQueryString(EGLDisplay dpy, EGLint name) {
+  if (!check_display(dpy) || !check_initialized(dpy))
+    return nullptr;
+
+  switch (name) {
+    case EGL_EXTENSIONS:
+      mock_error = EGL_SUCCESS;
+      return "EGL_KHR_partial_update EGL_KHR_swap_buffers_with_damage";
+    default:
+      mock_error = EGL_BAD_PARAMETER;
+      return nullptr;
+  }
+}
+
+EGLBoolean eglQuerySurface(EGLDisplay dpy,
+                           EGLSurface surface,
+                           EGLint attribute,
+                           EGLint* value) {
+  if (!check_display(dpy) || !check_initialized(dpy))
+    return EGL_FALSE;
+
+  switch (attribute) {
+    case EGL_WIDTH:
+    case EGL_HEIGHT:
+      *value = 0;
+      return bool_success();
+    default:
+      return bool_failure(EGL_BAD_ATTRIBUTE);
+  }
+}
+
 EGLBoolean eglSwapBuffers(EGLDisplay dpy, EGLSurface surface) {
   if (!check_display(dpy) || !check_initialized(dpy))
     return EGL_FALSE;
@@ -4,10 +4,39 @@
 
 #include "flutter/shell/platform/windows/angle_surface_manager.h"
 
+#include <d3d11.h>
+#include <dxgi.h>
+
 #include <iostream>
+#include <sstream>
+#include <string>
 
 namespace flutter {
 
+namespace {
+
+// The maximum number of frames that may be queued for presentation. DXGI
+// queues 3 by default, which adds up to two frames of input latency.
+constexpr UINT kMaxFrameLatency = 1;
+
+// Whether |display| supports the EGL extension |name|.
+bool HasExtension(EGLDisplay display, const char* name) {
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (extensions == nullptr) {
+    return false;
+  }
+  std::istringstream stream(extensions);
+  std::string extension;
+  while (stream >> extension) {
+    if (extension == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 AngleSurfaceManager::AngleSurfaceManager()
     : egl_config_(nullptr),
       egl_display_(EGL_NO_DISPLAY),
@@ -138,9 +167,68 @@ bool AngleSurfaceManager::Initialize() {
     return false;
   }
 
+  supports_direct_composition_ =
+      HasExtension(egl_display_, "EGL_ANGLE_direct_composition");
+  LimitFrameLatency();
+  InitializePartialUpdates();
+
   return true;
 }
 
+void AngleSurfaceManager::LimitFrameLatency() {
+  auto query_display_attrib = reinterpret_cast<PFNEGLQUERYDISPLAYATTRIBEXTPROC>(
+      eglGetProcAddress("eglQueryDisplayAttribEXT"));
+  auto query_device_attrib = reinterpret_cast<PFNEGLQUERYDEVICEATTRIBEXTPROC>(
+      eglGetProcAddress("eglQueryDeviceAttribEXT"));
+  if (!query_display_attrib || !query_device_attrib) {
+    return;
+  }
+
+  EGLAttrib egl_device = 0;
+  EGLAttrib d3d11_device = 0;
+  if (query_display_attrib(egl_display_, EGL_DEVICE_EXT, &egl_device) !=
+          EGL_TRUE ||
+      query_device_attrib(reinterpret_cast<EGLDeviceEXT>(egl_device),
+                          EGL_D3D11_DEVICE_ANGLE, &d3d11_device) != EGL_TRUE) {
+    return;
+  }
+
+  IDXGIDevice1* dxgi_device = nullptr;
+  if (FAILED(reinterpret_cast<ID3D11Device*>(d3d11_device)
+                 ->QueryInterface(__uuidof(IDXGIDevice1),
+                                  reinterpret_cast<void**>(&dxgi_device)))) {
+    return;
+  }
+  if (FAILED(dxgi_device->SetMaximumFrameLatency(kMaxFrameLatency))) {
+    std::cerr << "DXGI: Failed to set the maximum frame latency" << std::endl;
+  }
+  dxgi_device->Release();
+}
+
+void AngleSurfaceManager::InitializePartialUpdates() {
+  // Partial updates are only possible if the contents of old buffers are
+  // known.
+  has_buffer_age_ = HasExtension(egl_display_, "EGL_EXT_buffer_age");
+  if (!has_buffer_age_) {
+    return;
+  }
+
+  if (HasExtension(egl_display_, "EGL_KHR_partial_update")) {
+    set_damage_region_ = reinterpret_cast<PFNEGLSETDAMAGEREGIONKHRPROC>(
+        eglGetProcAddress("eglSetDamageRegionKHR"));
+  }
+
+  if (HasExtension(egl_display_, "EGL_KHR_swap_buffers_with_damage")) {
+    swap_buffers_with_damage_ =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+  } else if (HasExtension(egl_display_, "EGL_EXT_swap_buffers_with_damage")) {
+    swap_buffers_with_damage_ =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+  }
+}
+
 void AngleSurfaceManager::CleanUp() {
   EGLBoolean result = EGL_FALSE;
 
@@ -175,15 +263,31 @@ bool AngleSurfaceManager::CreateSurface(WindowsRenderTarget* render_target) {
   }
 
   EGLSurface surface = EGL_NO_SURFACE;
+  auto window =
+      static_cast<EGLNativeWindowType>(std::get<HWND>(*render_target));
+
+  // Prefer presenting through DirectComposition, which makes ANGLE use a
+  // flip-model swapchain that DWM composes without copying the frame.
+  if (supports_direct_composition_) {
+    const EGLint direct_composition_attributes[] = {
+        EGL_DIRECT_COMPOSITION_ANGLE, EGL_TRUE, EGL_NONE};
+    surface = eglCreateWindowSurface(egl_display_, egl_config_, window,
+                                     direct_composition_attributes);
+    if (surface == EGL_NO_SURFACE) {
+      std::cerr << "DirectComposition surface creation failed, falling back "
+                   "to a window surface."
+                << std::endl;
+    }
+  }
 
-  const EGLint surfaceAttributes[] = {EGL_NONE};
-
-  surface = eglCreateWindowSurface(
-      egl_display_, egl_config_,
-      static_cast<EGLNativeWindowType>(std::get<HWND>(*render_target)),
-      surfaceAttributes);
   if (surface == EGL_NO_SURFACE) {
-    std::cerr << "Surface creation failed." << std::endl;
+    const EGLint surfaceAttributes[] = {EGL_NONE};
+
+    surface = eglCreateWindowSurface(egl_display_, egl_config_, window,
+                                     surfaceAttributes);
+    if (surface == EGL_NO_SURFACE) {
+      std::cerr << "Surface creation failed." << std::endl;
+    }
   }
 
   render_surface_ = surface;
@@ -224,7 +328,67 @@ bool AngleSurfaceManager::MakeResourceCurrent() {
 }
 
 EGLBoolean AngleSurfaceManager::SwapBuffers() {
+  buffer_age_queried_ = false;
   return (eglSwapBuffers(egl_display_, render_surface_));
 }
 
+EGLint AngleSurfaceManager::GetBufferAge() {
+  if (!has_buffer_age_ || render_surface_ == EGL_NO_SURFACE) {
+    return 0;
+  }
+
+  EGLint age = 0;
+  if (eglQuerySurface(egl_display_, render_surface_, EGL_BUFFER_AGE_EXT,
+                      &age) == EGL_FALSE) {
+    return 0;
+  }
+  buffer_age_queried_ = true;
+  return age;
+}
+
+void AngleSurfaceManager::SetDamageRegion(const FlutterDamage& damage) {
+  if (set_damage_region_ == nullptr || !buffer_age_queried_) {
+    return;
+  }
+
+  std::vector<EGLint> rects = ToEGLRects(damage);
+  if (set_damage_region_(egl_display_, render_surface_, rects.data(),
+                         static_cast<EGLint>(damage.num_rects)) ==
+      EGL_FALSE) {
+    std::cerr << "EGL: Failed to set damage region" << std::endl;
+  }
+}
+
+EGLBoolean AngleSurfaceManager::SwapBuffersWithDamage(
+    const FlutterDamage& damage) {
+  if (swap_buffers_with_damage_ == nullptr) {
+    return SwapBuffers();
+  }
+
+  // No rectangles swap the whole surface, which is also correct when nothing
+  // changed.
+  std::vector<EGLint> rects = ToEGLRects(damage);
+  buffer_age_queried_ = false;
+  return swap_buffers_with_damage_(egl_display_, render_surface_, rects.data(),
+                                   static_cast<EGLint>(damage.num_rects));
+}
+
+std::vector<EGLint> AngleSurfaceManager::ToEGLRects(
+    const FlutterDamage& damage) {
+  EGLint width = 0;
+  EGLint height = 0;
+  GetSurfaceDimensions(&width, &height);
+
+  std::vector<EGLint> rects;
+  rects.reserve(damage.num_rects * 4);
+  for (size_t i = 0; i < damage.num_rects; i++) {
+    const FlutterRect& rect = damage.damage[i];
+    rects.push_back(static_cast<EGLint>(rect.left));
+    rects.push_back(height - static_cast<EGLint>(rect.bottom));
+    rects.push_back(static_cast<EGLint>(rect.right - rect.left));
+    rects.push_back(static_cast<EGLint>(rect.bottom - rect.top));
+  }
+  return rects;
+}
+
 }  // namespace flutter
@@ -15,6 +15,9 @@
 // Windows platform specific includes
 #include <windows.h>
 
+#include <vector>
+
+#include "flutter/shell/platform/embedder/embedder.h"
 #include "window_binding_handler.h"
 
 namespace flutter {
@@ -57,10 +60,36 @@ class AngleSurfaceManager {
   // not null.
   EGLBoolean SwapBuffers();
 
+  // Returns the age of the back buffer of the surface as reported by
+  // EGL_EXT_buffer_age, or 0 if its contents are undefined or the extension
+  // isn't supported. egl_context_ must be current.
+  EGLint GetBufferAge();
+
+  // Tells EGL which parts of the back buffer will be repainted if
+  // EGL_KHR_partial_update is supported. Must be called after GetBufferAge()
+  // and before rendering.
+  void SetDamageRegion(const FlutterDamage& damage);
+
+  // Like SwapBuffers(), but only swaps the repainted |damage| if
+  // EGL_KHR_swap_buffers_with_damage or EGL_EXT_swap_buffers_with_damage is
+  // supported.
+  EGLBoolean SwapBuffersWithDamage(const FlutterDamage& damage);
+
  private:
   bool Initialize();
   void CleanUp();
 
+  // Limits the number of frames the D3D11 device behind egl_display_ may queue
+  // for presentation, trading throughput for input latency.
+  void LimitFrameLatency();
+
+  // Looks up the partial update extensions supported by egl_display_.
+  void InitializePartialUpdates();
+
+  // Converts |damage| to EGL rectangles, which have their origin at the
+  // bottom left of render_surface_.
+  std::vector<EGLint> ToEGLRects(const FlutterDamage& damage);
+
  private:
   // EGL representation of native display.
   EGLDisplay egl_display_;
@@ -81,6 +110,24 @@ class AngleSurfaceManager {
 
   // Current render_surface that engine will draw into.
   EGLSurface render_surface_ = EGL_NO_SURFACE;
+
+  // Whether surfaces can be presented through DirectComposition with a
+  // flip-model swapchain (EGL_ANGLE_direct_composition).
+  bool supports_direct_composition_ = false;
+
+  // Whether EGL_EXT_buffer_age is supported.
+  bool has_buffer_age_ = false;
+
+  // eglSetDamageRegionKHR from EGL_KHR_partial_update, if supported.
+  PFNEGLSETDAMAGEREGIONKHRPROC set_damage_region_ = nullptr;
+
+  // eglSwapBuffersWithDamage from EGL_KHR_swap_buffers_with_damage or
+  // EGL_EXT_swap_buffers_with_damage, if supported.
+  PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage_ = nullptr;
+
+  // Whether the buffer age was queried since the last swap, which
+  // EGL_KHR_partial_update requires before setting the damage region.
+  bool buffer_age_queried_ = false;
 };
 
 }  // namespace flutter
@@ -105,6 +105,20 @@ static std::unique_ptr<FlutterDesktopEngineState> RunFlutterEngine(
     auto host = static_cast<flutter::FlutterWindowsView*>(user_data);
     return host->MakeResourceCurrent();
   };
+  config.open_gl.present_with_info =
+      [](void* user_data, const FlutterOpenGLPresentInfo* info) -> bool {
+    auto host = static_cast<flutter::FlutterWindowsView*>(user_data);
+    return host->SwapBuffersWithDamage(info->frame_damage);
+  };
+  config.open_gl.fbo_buffer_age_callback = [](void* user_data) -> uint32_t {
+    auto host = static_cast<flutter::FlutterWindowsView*>(user_data);
+    return host->GetBufferAge();
+  };
+  config.open_gl.set_damage_region = [](void* user_data,
+                                        const FlutterDamage* damage) {
+    auto host = static_cast<flutter::FlutterWindowsView*>(user_data);
+    host->SetDamageRegion(*damage);
+  };
 
   // Configure task runner interop.
   auto state_ptr = state.get();
@@ -319,6 +319,18 @@ bool FlutterWindowsView::SwapBuffers() {
   return surface_manager_->SwapBuffers();
 }
 
+uint32_t FlutterWindowsView::GetBufferAge() {
+  return static_cast<uint32_t>(surface_manager_->GetBufferAge());
+}
+
+void FlutterWindowsView::SetDamageRegion(const FlutterDamage& damage) {
+  surface_manager_->SetDamageRegion(damage);
+}
+
+bool FlutterWindowsView::SwapBuffersWithDamage(const FlutterDamage& damage) {
+  return surface_manager_->SwapBuffersWithDamage(damage);
+}
+
 void FlutterWindowsView::CreateRenderSurface() {
   surface_manager_->CreateSurface(render_target_.get());
 }
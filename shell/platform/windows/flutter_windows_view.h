@@ -67,6 +67,11 @@ class FlutterWindowsView : public WindowBindingHandlerDelegate {
   bool MakeResourceCurrent();
   bool SwapBuffers();
 
+  // Callbacks for presenting only the parts of the surface that changed.
+  uint32_t GetBufferAge();
+  void SetDamageRegion(const FlutterDamage& damage);
+  bool SwapBuffersWithDamage(const FlutterDamage& damage);
+
   // |WindowBindingHandlerDelegate|
   void OnWindowSizeChanged(size_t width, size_t height) const override;
 
@@ -161,11 +161,20 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter)
+
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter)
 
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter)
 
+  if IsLinux():
+    RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter)
+
+    RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter)
+
+    RunEngineExecutable(build_dir, 'flutter_linux_benchmarks', filter)
+
 
 
 def SnapshotTest(build_dir, dart_file, kernel_file_output, verbose_dart_snapshot):
@@ -135,19 +135,15 @@
   XCTAssertEqual(platform_view.frame.size.width, 250);
   XCTAssertEqual(platform_view.frame.size.height, 250);
 
-  XCUIElement* overlay1 = app.otherElements[@"platform_view[0].overlay[0]"];
-  XCTAssertTrue(overlay1.exists);
-  XCTAssertEqual(overlay1.frame.origin.x, 150);
-  XCTAssertEqual(overlay1.frame.origin.y, 150);
-  XCTAssertEqual(overlay1.frame.size.width, 75);
-  XCTAssertEqual(overlay1.frame.size.height, 75);
-
-  XCUIElement* overlay2 = app.otherElements[@"platform_view[0].overlay[1]"];
-  XCTAssertTrue(overlay2.exists);
-  XCTAssertEqual(overlay2.frame.origin.x, 75);
-  XCTAssertEqual(overlay2.frame.origin.y, 225);
-  XCTAssertEqual(overlay2.frame.size.width, 50);
-  XCTAssertEqual(overlay2.frame.size.height, 50);
+  // The disjoint parts of the picture above the platform view share an overlay.
+  XCUIElement* overlay = app.otherElements[@"platform_view[0].overlay[0]"];
+  XCTAssertTrue(overlay.exists);
+  XCTAssertEqual(overlay.frame.origin.x, 75);
+  XCTAssertEqual(overlay.frame.origin.y, 150);
+  XCTAssertEqual(overlay.frame.size.width, 150);
+  XCTAssertEqual(overlay.frame.size.height, 125);
+
+  XCTAssertFalse(app.otherElements[@"platform_view[0].overlay[1]"].exists);
 }
 
 // A is the layer, which z index is higher than the platform view.
@@ -206,19 +202,15 @@
   XCTAssertEqual(platform_view2.frame.size.width, 250);
   XCTAssertEqual(platform_view2.frame.size.height, 250);
 
-  XCUIElement* overlay1 = app.otherElements[@"platform_view[0].overlay[0]"];
-  XCTAssertTrue(overlay1.exists);
-  XCTAssertEqual(overlay1.frame.origin.x, 25);
-  XCTAssertEqual(overlay1.frame.origin.y, 325);
-  XCTAssertEqual(overlay1.frame.size.width, 225);
-  XCTAssertEqual(overlay1.frame.size.height, 175);
-
-  XCUIElement* overlay2 = app.otherElements[@"platform_view[1].overlay[0]"];
-  XCTAssertTrue(overlay2.exists);
-  XCTAssertEqual(overlay2.frame.origin.x, 25);
-  XCTAssertEqual(overlay2.frame.origin.y, 25);
-  XCTAssertEqual(overlay2.frame.size.width, 225);
-  XCTAssertEqual(overlay2.frame.size.height, 250);
+  // The parts of A above both platform views share an overlay above the top one.
+  XCUIElement* overlay = app.otherElements[@"platform_view[1].overlay[0]"];
+  XCTAssertTrue(overlay.exists);
+  XCTAssertEqual(overlay.frame.origin.x, 25);
+  XCTAssertEqual(overlay.frame.origin.y, 25);
+  XCTAssertEqual(overlay.frame.size.width, 225);
+  XCTAssertEqual(overlay.frame.size.height, 475);
+
+  XCTAssertFalse(app.otherElements[@"platform_view[0].overlay[0]"].exists);
 }
 
 // More then two overlays are merged into a single layer.
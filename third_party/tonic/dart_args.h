@@ -98,6 +98,154 @@ void DartReturn(T result, Dart_NativeArguments args) {
   DartConverter<T>::SetReturnValue(args, std::move(result));
 }
 
+// Calls |callable| and returns its result, if any, to Dart.
+template <typename Callable>
+void DartReturnResult(const Callable& callable, Dart_NativeArguments args) {
+  if constexpr (std::is_void<decltype(callable())>::value) {
+    callable();
+  } else {
+    DartReturn(callable(), args);
+  }
+}
+
+// The types of arguments that are fetched all at once with
+// Dart_GetNativeArguments when all the arguments of a native are of such
+// types, instead of with a call to the Dart API per argument. They convert
+// the same way as their |DartConverter|.
+template <typename T, typename Enable = void>
+struct DartNativeArgument {
+  static constexpr bool kIsPrimitive = false;
+};
+
+template <>
+struct DartNativeArgument<bool> {
+  static constexpr bool kIsPrimitive = true;
+  static constexpr Dart_NativeArgument_Type kType = Dart_NativeArgument_kBool;
+
+  static bool FromValue(const Dart_NativeArgument_Value& value) {
+    return value.as_bool;
+  }
+};
+
+template <typename T>
+struct DartNativeArgument<
+    T,
+    typename std::enable_if<(std::is_integral<T>::value &&
+                             !std::is_same<T, bool>::value) ||
+                            std::is_enum<T>::value>::type> {
+  static constexpr bool kIsPrimitive = true;
+  static constexpr Dart_NativeArgument_Type kType = Dart_NativeArgument_kInt64;
+
+  static T FromValue(const Dart_NativeArgument_Value& value) {
+    return static_cast<T>(value.as_int64);
+  }
+};
+
+template <typename T>
+struct DartNativeArgument<
+    T,
+    typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static constexpr bool kIsPrimitive = true;
+  static constexpr Dart_NativeArgument_Type kType =
+      Dart_NativeArgument_kDouble;
+
+  static T FromValue(const Dart_NativeArgument_Value& value) {
+    return static_cast<T>(value.as_double);
+  }
+};
+
+template <typename... ArgTypes>
+struct DartPrimitiveArguments {
+  static constexpr size_t kCount = sizeof...(ArgTypes);
+
+  template <typename ArgType>
+  using Argument = DartNativeArgument<typename std::remove_const<
+      typename std::remove_reference<ArgType>::type>::type>;
+
+  static constexpr bool kCanBatch =
+      kCount > 0 && (Argument<ArgTypes>::kIsPrimitive && ...);
+
+  // Fetches the arguments from |start_index| on and calls |function| with
+  // them. Returns false without calling |function| if any of the arguments
+  // doesn't have the expected type, for example because it is null. The
+  // caller then converts them one by one, as that handles those cases.
+  template <size_t... indices, typename Function>
+  static bool Apply(Dart_NativeArguments args,
+                    int start_index,
+                    IndicesHolder<indices...>,
+                    const Function& function) {
+    const Dart_NativeArgument_Descriptor descriptors[kCount] = {
+        {static_cast<uint8_t>(Argument<ArgTypes>::kType),
+         static_cast<uint8_t>(start_index + indices)}...};
+    Dart_NativeArgument_Value values[kCount];
+    if (Dart_IsError(
+            Dart_GetNativeArguments(args, kCount, descriptors, values))) {
+      return false;
+    }
+    function(Argument<ArgTypes>::FromValue(values[indices])...);
+    return true;
+  }
+};
+
+// Dispatches natives whose arguments are all |DartNativeArgument|s, see
+// |DartPrimitiveArguments::Apply|.
+template <typename T>
+struct DartPrimitiveDispatcher {
+  static constexpr bool kCanBatch = false;
+};
+
+template <typename ResultType, typename... ArgTypes>
+struct DartPrimitiveDispatcher<ResultType (*)(ArgTypes...)>
+    : public DartPrimitiveArguments<ArgTypes...> {
+  using FunctionPtr = ResultType (*)(ArgTypes...);
+  using Indices = typename IndicesForSignature<FunctionPtr>::type;
+
+  static bool Dispatch(FunctionPtr func,
+                       Dart_NativeArguments args,
+                       int start_index) {
+    return DartPrimitiveArguments<ArgTypes...>::Apply(
+        args, start_index, Indices(), [&](auto... values) {
+          DartReturnResult([&]() { return (*func)(values...); }, args);
+        });
+  }
+};
+
+template <typename C, typename ResultType, typename... ArgTypes>
+struct DartPrimitiveDispatcher<ResultType (C::*)(ArgTypes...)>
+    : public DartPrimitiveArguments<ArgTypes...> {
+  using FunctionPtr = ResultType (C::*)(ArgTypes...);
+  using Indices = typename IndicesForSignature<FunctionPtr>::type;
+
+  static bool Dispatch(FunctionPtr func,
+                       Dart_NativeArguments args,
+                       int start_index) {
+    return DartPrimitiveArguments<ArgTypes...>::Apply(
+        args, start_index, Indices(), [&](auto... values) {
+          DartReturnResult(
+              [&]() { return (GetReceiver<C>(args)->*func)(values...); },
+              args);
+        });
+  }
+};
+
+template <typename C, typename ResultType, typename... ArgTypes>
+struct DartPrimitiveDispatcher<ResultType (C::*)(ArgTypes...) const>
+    : public DartPrimitiveArguments<ArgTypes...> {
+  using FunctionPtr = ResultType (C::*)(ArgTypes...) const;
+  using Indices = typename IndicesForSignature<FunctionPtr>::type;
+
+  static bool Dispatch(FunctionPtr func,
+                       Dart_NativeArguments args,
+                       int start_index) {
+    return DartPrimitiveArguments<ArgTypes...>::Apply(
+        args, start_index, Indices(), [&](auto... values) {
+          DartReturnResult(
+              [&]() { return (GetReceiver<C>(args)->*func)(values...); },
+              args);
+        });
+  }
+};
+
 template <typename IndicesType, typename T>
 class DartDispatcher {};
 
@@ -196,6 +344,11 @@ struct DartDispatcher<IndicesHolder<indices...>, ResultType (C::*)(ArgTypes...)>
 
 template <typename Sig>
 void DartCall(Sig func, Dart_NativeArguments args) {
+  if constexpr (DartPrimitiveDispatcher<Sig>::kCanBatch) {
+    if (DartPrimitiveDispatcher<Sig>::Dispatch(func, args, 1)) {
+      return;
+    }
+  }
   DartArgIterator it(args);
   using Indices = typename IndicesForSignature<Sig>::type;
   DartDispatcher<Indices, Sig> decoder(&it);
@@ -206,6 +359,11 @@ void DartCall(Sig func, Dart_NativeArguments args) {
 
 template <typename Sig>
 void DartCallStatic(Sig func, Dart_NativeArguments args) {
+  if constexpr (DartPrimitiveDispatcher<Sig>::kCanBatch) {
+    if (DartPrimitiveDispatcher<Sig>::Dispatch(func, args, 0)) {
+      return;
+    }
+  }
   DartArgIterator it(args, 0);
   using Indices = typename IndicesForSignature<Sig>::type;
   DartDispatcher<Indices, Sig> decoder(&it);
@@ -19,7 +19,11 @@ DartMessageHandler::DartMessageHandler()
       isolate_had_uncaught_exception_error_(false),
       isolate_had_fatal_error_(false),
       isolate_last_error_(kNoError),
-      task_dispatcher_(nullptr) {}
+      task_dispatcher_(nullptr),
+      batch_max_count_(1),
+      batch_budget_micros_(0),
+      pending_messages_(0),
+      batch_scheduled_(false) {}
 
 DartMessageHandler::~DartMessageHandler() {
   task_dispatcher_ = nullptr;
@@ -32,7 +36,19 @@ void DartMessageHandler::Initialize(TaskDispatcher dispatcher) {
   Dart_SetMessageNotifyCallback(MessageNotifyCallback);
 }
 
+void DartMessageHandler::SetBatchLimits(size_t max_count,
+                                        int64_t budget_micros) {
+  batch_max_count_ = max_count > 0 ? max_count : 1;
+  batch_budget_micros_ = budget_micros;
+}
+
 void DartMessageHandler::OnMessage(DartState* dart_state) {
+  if (batch_max_count_ > 1) {
+    pending_messages_.fetch_add(1);
+    ScheduleMessageBatch(dart_state);
+    return;
+  }
+
   auto task_dispatcher_ = dart_state->message_handler().task_dispatcher_;
 
   // Schedule a task to run on the message loop thread.
@@ -44,6 +60,50 @@ void DartMessageHandler::OnMessage(DartState* dart_state) {
   });
 }
 
+void DartMessageHandler::ScheduleMessageBatch(DartState* dart_state) {
+  if (batch_scheduled_.exchange(true)) {
+    // The pending task handles this message too.
+    return;
+  }
+
+  auto weak_dart_state = dart_state->GetWeakPtr();
+  task_dispatcher_([weak_dart_state]() {
+    if (auto dart_state = weak_dart_state.lock()) {
+      dart_state->message_handler().OnHandleMessageBatch(dart_state.get());
+    }
+  });
+}
+
+void DartMessageHandler::OnHandleMessageBatch(DartState* dart_state) {
+  // Messages that arrive from here on schedule the next batch, unless this one
+  // gets to them first.
+  batch_scheduled_.store(false);
+
+  const int64_t start_micros = Dart_TimelineGetMicros();
+  for (size_t handled = 0; handled < batch_max_count_; handled++) {
+    size_t pending = pending_messages_.load();
+    do {
+      if (pending == 0) {
+        return;
+      }
+    } while (!pending_messages_.compare_exchange_weak(pending, pending - 1));
+
+    OnHandleMessage(dart_state);
+    if (isolate_exited_ || isolate_had_fatal_error_) {
+      return;
+    }
+    if (Dart_TimelineGetMicros() - start_micros >= batch_budget_micros_) {
+      break;
+    }
+  }
+
+  // Yield to the other tasks of the runner, frame work in particular, before
+  // handling the rest.
+  if (pending_messages_.load() > 0) {
+    ScheduleMessageBatch(dart_state);
+  }
+}
+
 void DartMessageHandler::UnhandledError(Dart_Handle error) {
   TONIC_DCHECK(Dart_CurrentIsolate());
   TONIC_DCHECK(Dart_IsError(error));
@@ -5,6 +5,8 @@
 #ifndef LIB_TONIC_DART_MESSAGE_HANDLER_H_
 #define LIB_TONIC_DART_MESSAGE_HANDLER_H_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 
 #include "third_party/dart/runtime/include/dart_api.h"
@@ -24,6 +26,13 @@ class DartMessageHandler {
   // Messages for the current isolate will be scheduled on |runner|.
   void Initialize(TaskDispatcher dispatcher);
 
+  // Handle up to |max_count| pending messages in each task scheduled on the
+  // runner, for as long as handling them takes less than |budget_micros|.
+  // Messages that arrive while a task is pending are handled by that task
+  // instead of scheduling one each. Microtasks are still drained after every
+  // message. The default of one message per task disables batching.
+  void SetBatchLimits(size_t max_count, int64_t budget_micros);
+
   // Handle an unhandled error. If the error is fatal then shut down the
   // isolate. The message handler's isolate must be the current isolate.
   void UnhandledError(Dart_Handle error);
@@ -43,6 +52,11 @@ class DartMessageHandler {
   void OnMessage(DartState* dart_state);
   // By default, called on the task runner's thread for each message.
   void OnHandleMessage(DartState* dart_state);
+  // Called on the task runner's thread for each batch of messages when
+  // batching is enabled.
+  void OnHandleMessageBatch(DartState* dart_state);
+  // Schedules a task handling the pending messages unless one is pending.
+  void ScheduleMessageBatch(DartState* dart_state);
 
   bool handled_first_message() const { return handled_first_message_; }
 
@@ -56,6 +70,10 @@ class DartMessageHandler {
   bool isolate_had_fatal_error_;
   DartErrorHandleType isolate_last_error_;
   TaskDispatcher task_dispatcher_;
+  size_t batch_max_count_;
+  int64_t batch_budget_micros_;
+  std::atomic<size_t> pending_messages_;
+  std::atomic<bool> batch_scheduled_;
 
  private:
   static void MessageNotifyCallback(Dart_Isolate dest_isolate);
@@ -16,8 +16,13 @@
 
 #include <minikin/Layout.h>
 
+#include <atomic>
+#include <string>
+
 #include "flutter/fml/command_line.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/third_party/txt/tests/txt_test_utils.h"
 #include "minikin/LayoutUtils.h"
 #include "third_party/benchmark/include/benchmark/benchmark_api.h"
@@ -182,6 +187,81 @@ BENCHMARK_F(ParagraphFixture, ManyStylesLayout)(benchmark::State& state) {
   }
 }
 
+// Lays out 100 paragraphs that each differ in their words, spread over the
+// number of threads given by the range.
+BENCHMARK_DEFINE_F(ParagraphFixture, ManyParagraphsLayout)
+(benchmark::State& state) {
+  const size_t thread_count = state.range(0);
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  std::vector<std::unique_ptr<ParagraphTxt>> paragraphs;
+  for (int i = 0; i < 100; i++) {
+    std::string text = "Message " + std::to_string(i) +
+                       ": Lorem ipsum dolor sit amet, consectetur adipiscing "
+                       "elit, sed do eiusmod tempor incididunt ut labore " +
+                       std::to_string(i * 7919) + " et dolore magna aliqua.";
+    auto icu_text = icu::UnicodeString::fromUTF8(text);
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    paragraphs.push_back(BuildParagraph(builder));
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(thread_count);
+  auto runner = loop->GetTaskRunner();
+  while (state.KeepRunning()) {
+    std::atomic<size_t> next = {0};
+    fml::CountDownLatch latch(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+      runner->PostTask([&]() {
+        for (size_t j = next.fetch_add(1); j < paragraphs.size();
+             j = next.fetch_add(1)) {
+          paragraphs[j]->SetDirty();
+          paragraphs[j]->Layout(300);
+        }
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ManyParagraphsLayout)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+BENCHMARK_F(ParagraphFixture, ManyShortLabelsLayout)(benchmark::State& state) {
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  std::vector<std::u16string> labels;
+  for (int i = 0; i < 100; i++) {
+    auto icu_text = icu::UnicodeString::fromUTF8("Item " + std::to_string(i));
+    labels.emplace_back(icu_text.getBuffer(),
+                        icu_text.getBuffer() + icu_text.length());
+  }
+
+  while (state.KeepRunning()) {
+    for (const std::u16string& label : labels) {
+      txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+      builder.PushStyle(text_style);
+      builder.AddText(label);
+      builder.Pop();
+      auto paragraph = BuildParagraph(builder);
+      paragraph->Layout(300);
+    }
+  }
+}
+
 BENCHMARK_DEFINE_F(ParagraphFixture, TextBigO)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < state.range(0); ++i) {
@@ -213,6 +293,55 @@ BENCHMARK_REGISTER_F(ParagraphFixture, TextBigO)
     ->Range(1 << 6, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// Selects and hit tests the end of a document of |state.range(0)| paragraphs
+// of about eight lines each, as a long text field does every frame.
+BENCHMARK_DEFINE_F(ParagraphFixture, LongDocumentSelection)
+(benchmark::State& state) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur.\n";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text;
+  for (int i = 0; i < state.range(0); ++i) {
+    u16_text.append(icu_text.getBuffer(),
+                    icu_text.getBuffer() + icu_text.length());
+  }
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+
+  const size_t selection_end = u16_text.size() - 1;
+  const size_t selection_start = selection_end - icu_text.length() / 2;
+  const double bottom = paragraph->GetHeight() - 1;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(paragraph->GetRectsForRange(
+        selection_start, selection_end,
+        txt::Paragraph::RectHeightStyle::kMax,
+        txt::Paragraph::RectWidthStyle::kTight));
+    benchmark::DoNotOptimize(
+        paragraph->GetGlyphPositionAtCoordinate(150, bottom));
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, LongDocumentSelection)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 10)
+    ->Complexity(benchmark::oLogN);
+
 BENCHMARK_DEFINE_F(ParagraphFixture, StylesBigO)(benchmark::State& state) {
   const char* text = "vry shrt ";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
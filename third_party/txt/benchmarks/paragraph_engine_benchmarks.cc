@@ -0,0 +1,214 @@
+/*
+ * Copyright 2017 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Lays out and paints the same paragraphs with libtxt and, in builds that
+// include it, SkParagraph, so that the engines can be compared on identical
+// inputs.
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/third_party/txt/tests/txt_test_utils.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "third_party/icu/source/common/unicode/unistr.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "txt/font_collection.h"
+#include "txt/paragraph.h"
+#include "txt/paragraph_builder.h"
+
+namespace txt {
+namespace {
+
+enum class Engine { kTxt, kSkia };
+
+struct Corpus {
+  const char* name;
+  std::vector<std::string> font_families;
+  TextDirection direction;
+  // Whether each word gets a style of its own.
+  bool mixed_styles;
+  std::string text;
+};
+
+std::string Repeat(const std::string& text, size_t count) {
+  std::string repeated;
+  for (size_t i = 0; i < count; i++) {
+    repeated += text;
+  }
+  return repeated;
+}
+
+const std::string kLatin =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+    "tempor incididunt ut labore et dolore magna aliqua. ";
+
+const std::vector<Corpus>& GetCorpora() {
+  static const std::vector<Corpus> corpora = {
+      {"Latin", {"Roboto"}, TextDirection::ltr, false, Repeat(kLatin, 2)},
+      {"CJK",
+       {"Noto Sans CJK JP"},
+       TextDirection::ltr,
+       false,
+       Repeat("日本語の文章には単語の間に空白がなく、行は文字の間で折り返される。",
+              2)},
+      {"Arabic",
+       {"Noto Naskh Arabic"},
+       TextDirection::rtl,
+       false,
+       Repeat("هذه فقرة عربية لاختبار تخطيط النص من اليمين إلى اليسار. ", 3)},
+      {"Emoji",
+       {"Roboto", "Noto Color Emoji"},
+       TextDirection::ltr,
+       false,
+       Repeat("Hello 😀 world 🎉 thumbs 👍🏽 family 👨‍👩‍👧 heart ❤️ ", 2)},
+      {"MixedStyles", {"Roboto"}, TextDirection::ltr, true, Repeat(kLatin, 2)},
+      {"Long", {"Roboto"}, TextDirection::ltr, false, Repeat(kLatin, 50)},
+  };
+  return corpora;
+}
+
+std::unique_ptr<ParagraphBuilder> CreateBuilder(
+    Engine engine,
+    const ParagraphStyle& style,
+    std::shared_ptr<FontCollection> font_collection) {
+#if FLUTTER_ENABLE_SKSHAPER
+  if (engine == Engine::kSkia) {
+    return ParagraphBuilder::CreateSkiaBuilder(style, font_collection);
+  }
+#endif  // FLUTTER_ENABLE_SKSHAPER
+  FML_CHECK(engine == Engine::kTxt);
+  return ParagraphBuilder::CreateTxtBuilder(style, font_collection);
+}
+
+std::unique_ptr<Paragraph> BuildCorpus(
+    Engine engine,
+    const Corpus& corpus,
+    std::shared_ptr<FontCollection> font_collection) {
+  ParagraphStyle paragraph_style;
+  paragraph_style.text_direction = corpus.direction;
+  auto builder = CreateBuilder(engine, paragraph_style, font_collection);
+
+  TextStyle text_style;
+  text_style.font_families = corpus.font_families;
+  text_style.color = SK_ColorBLACK;
+
+  auto icu_text = icu::UnicodeString::fromUTF8(corpus.text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  if (!corpus.mixed_styles) {
+    builder->PushStyle(text_style);
+    builder->AddText(u16_text);
+    builder->Pop();
+    return builder->Build();
+  }
+
+  size_t word_start = 0;
+  for (size_t i = 0; word_start < u16_text.size(); i++) {
+    size_t word_end = u16_text.find(u' ', word_start);
+    word_end =
+        word_end == std::u16string::npos ? u16_text.size() : word_end + 1;
+    TextStyle word_style = text_style;
+    word_style.font_size = 12 + (i % 4) * 2;
+    word_style.font_weight = i % 2 ? FontWeight::w700 : FontWeight::w400;
+    word_style.color = i % 3 ? SK_ColorBLACK : SK_ColorBLUE;
+    builder->PushStyle(word_style);
+    builder->AddText(u16_text.substr(word_start, word_end - word_start));
+    builder->Pop();
+    word_start = word_end;
+  }
+  return builder->Build();
+}
+
+}  // namespace
+
+class ParagraphEngineFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) {
+    font_collection_ = GetTestFontCollection();
+
+    bitmap_ = std::make_unique<SkBitmap>();
+    bitmap_->allocN32Pixels(1000, 1000);
+    canvas_ = std::make_unique<SkCanvas>(*bitmap_);
+    canvas_->clear(SK_ColorWHITE);
+  }
+
+  void TearDown(const benchmark::State& state) { font_collection_.reset(); }
+
+ protected:
+  // Builds and lays out the corpus chosen by the benchmark's argument.
+  void BuildAndLayout(Engine engine, benchmark::State& state) {
+    const Corpus& corpus = GetCorpora()[state.range(0)];
+    state.SetLabel(corpus.name);
+    while (state.KeepRunning()) {
+      auto paragraph = BuildCorpus(engine, corpus, font_collection_);
+      paragraph->Layout(300);
+    }
+  }
+
+  // Paints the corpus chosen by the benchmark's argument, laid out once.
+  void Paint(Engine engine, benchmark::State& state) {
+    const Corpus& corpus = GetCorpora()[state.range(0)];
+    state.SetLabel(corpus.name);
+    auto paragraph = BuildCorpus(engine, corpus, font_collection_);
+    paragraph->Layout(300);
+    while (state.KeepRunning()) {
+      paragraph->Paint(canvas_.get(), 0, 0);
+    }
+  }
+
+  std::shared_ptr<FontCollection> font_collection_;
+  std::unique_ptr<SkCanvas> canvas_;
+  std::unique_ptr<SkBitmap> bitmap_;
+};
+
+// Registers a benchmark for each corpus.
+static void ForEachCorpus(benchmark::internal::Benchmark* benchmark) {
+  for (size_t i = 0; i < GetCorpora().size(); i++) {
+    benchmark->Arg(i);
+  }
+}
+
+BENCHMARK_DEFINE_F(ParagraphEngineFixture, TxtLayout)
+(benchmark::State& state) {
+  BuildAndLayout(Engine::kTxt, state);
+}
+BENCHMARK_REGISTER_F(ParagraphEngineFixture, TxtLayout)->Apply(ForEachCorpus);
+
+BENCHMARK_DEFINE_F(ParagraphEngineFixture, TxtPaint)(benchmark::State& state) {
+  Paint(Engine::kTxt, state);
+}
+BENCHMARK_REGISTER_F(ParagraphEngineFixture, TxtPaint)->Apply(ForEachCorpus);
+
+#if FLUTTER_ENABLE_SKSHAPER
+
+BENCHMARK_DEFINE_F(ParagraphEngineFixture, SkiaLayout)
+(benchmark::State& state) {
+  BuildAndLayout(Engine::kSkia, state);
+}
+BENCHMARK_REGISTER_F(ParagraphEngineFixture, SkiaLayout)->Apply(ForEachCorpus);
+
+BENCHMARK_DEFINE_F(ParagraphEngineFixture, SkiaPaint)
+(benchmark::State& state) {
+  Paint(Engine::kSkia, state);
+}
+BENCHMARK_REGISTER_F(ParagraphEngineFixture, SkiaPaint)->Apply(ForEachCorpus);
+
+#endif  // FLUTTER_ENABLE_SKSHAPER
+
+}  // namespace txt
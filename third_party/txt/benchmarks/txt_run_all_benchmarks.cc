@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <string>
+
+#include "flutter/benchmarking/engine_benchmark_reporter.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/logging.h"
 #include "flutter/testing/testing.h"
@@ -22,6 +25,8 @@
 
 // We will use a custom main to allow custom font directories for consistency.
 int main(int argc, char** argv) {
+  const std::string output_path =
+      benchmarking::EngineBenchmarkReporter::TakeOutputPath(&argc, argv);
   ::benchmark::Initialize(&argc, argv);
   fml::CommandLine cmd = fml::CommandLineFromArgcArgv(argc, argv);
   txt::SetCommandLine(cmd);
@@ -34,5 +39,6 @@ int main(int argc, char** argv) {
 
   fml::icu::InitializeICU("icudtl.dat");
 
-  ::benchmark::RunSpecifiedBenchmarks();
+  benchmarking::EngineBenchmarkReporter::RunSpecifiedBenchmarks(argv[0],
+                                                               output_path);
 }
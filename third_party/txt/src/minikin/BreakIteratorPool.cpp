@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BreakIteratorPool.h"
+
+#include <vector>
+
+namespace minikin {
+
+namespace {
+
+// Enough for a line and a word iterator in a few locales.
+const size_t kMaxPooledIterators = 8;
+
+struct PooledIterator {
+  BreakIteratorPool::Kind kind;
+  std::string locale;
+  std::unique_ptr<icu::BreakIterator> iterator;
+};
+
+// Least recently released first.
+thread_local std::vector<PooledIterator> tPool;
+
+}  // namespace
+
+BreakIteratorPool::Iterator& BreakIteratorPool::Iterator::operator=(
+    Iterator&& other) {
+  if (this != &other) {
+    release(this);
+    mKind = other.mKind;
+    mLocale = std::move(other.mLocale);
+    mIterator = std::move(other.mIterator);
+  }
+  return *this;
+}
+
+BreakIteratorPool::Iterator::~Iterator() {
+  release(this);
+}
+
+BreakIteratorPool::Iterator BreakIteratorPool::acquire(
+    Kind kind,
+    const icu::Locale& locale) {
+  Iterator iterator;
+  iterator.mKind = kind;
+  iterator.mLocale = locale.getName();
+  for (auto it = tPool.rbegin(); it != tPool.rend(); ++it) {
+    if (it->kind == kind && it->locale == iterator.mLocale) {
+      iterator.mIterator = std::move(it->iterator);
+      tPool.erase(std::next(it).base());
+      return iterator;
+    }
+  }
+
+  UErrorCode status = U_ZERO_ERROR;
+  if (kind == Kind::kLine) {
+    iterator.mIterator.reset(
+        icu::BreakIterator::createLineInstance(locale, status));
+  } else {
+    iterator.mIterator.reset(
+        icu::BreakIterator::createWordInstance(locale, status));
+  }
+  if (!U_SUCCESS(status)) {
+    iterator.mIterator.reset();
+  }
+  return iterator;
+}
+
+size_t BreakIteratorPool::getPooledCount() {
+  return tPool.size();
+}
+
+void BreakIteratorPool::purge() {
+  tPool.clear();
+}
+
+void BreakIteratorPool::release(Iterator* iterator) {
+  if (!iterator->mIterator) {
+    return;
+  }
+  if (tPool.size() == kMaxPooledIterators) {
+    tPool.erase(tPool.begin());
+  }
+  tPool.push_back({iterator->mKind, std::move(iterator->mLocale),
+                   std::move(iterator->mIterator)});
+}
+
+}  // namespace minikin
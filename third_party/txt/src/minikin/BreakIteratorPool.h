@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINIKIN_BREAK_ITERATOR_POOL_H
+#define MINIKIN_BREAK_ITERATOR_POOL_H
+
+#include <memory>
+#include <string>
+
+#include "unicode/brkiter.h"
+#include "unicode/locid.h"
+
+namespace minikin {
+
+// ICU break iterators that aren't in use anymore, kept for each thread by
+// their kind and locale.
+//
+// Creating a break iterator loads its locale's rules, which takes several
+// times longer than breaking a short label. An iterator taken from the pool
+// is given new text instead, which resets it. The pool of a thread keeps a
+// few of the most recently released iterators.
+class BreakIteratorPool {
+ public:
+  enum class Kind { kLine, kWord };
+
+  // An iterator taken from the pool. It is released to the pool of the
+  // thread that destroys it.
+  class Iterator {
+   public:
+    Iterator() = default;
+    Iterator(Iterator&& other) = default;
+    Iterator& operator=(Iterator&& other);
+    ~Iterator();
+
+    icu::BreakIterator* get() const { return mIterator.get(); }
+    icu::BreakIterator* operator->() const { return mIterator.get(); }
+    explicit operator bool() const { return mIterator != nullptr; }
+
+   private:
+    friend class BreakIteratorPool;
+
+    Kind mKind = Kind::kLine;
+    std::string mLocale;
+    std::unique_ptr<icu::BreakIterator> mIterator;
+
+    // Forbid copy and assign.
+    Iterator(const Iterator&) = delete;
+    void operator=(const Iterator&) = delete;
+  };
+
+  // Takes an iterator of |kind| for |locale| from the pool of the calling
+  // thread, or creates one if there is none. The iterator is null if it
+  // couldn't be created. Its text has to be set before it is used.
+  static Iterator acquire(Kind kind, const icu::Locale& locale);
+
+  // The number of iterators in the pool of the calling thread.
+  static size_t getPooledCount();
+
+  // Deletes the iterators in the pool of the calling thread.
+  static void purge();
+
+ private:
+  static void release(Iterator* iterator);
+};
+
+}  // namespace minikin
+
+#endif  // MINIKIN_BREAK_ITERATOR_POOL_H
@@ -530,6 +530,29 @@ void FontCollection::itemize(const uint16_t* string,
     }
     prevCh = ch;
     run->end = nextUtf16Pos;  // exclusive
+
+    // The first family is used for every character it covers that isn't
+    // followed by a variation selector, so the characters after this one that
+    // it covers are added to its run in bulk. The last of them is left to the
+    // loop, as it may be followed by one.
+    if (lastFamily == mFamilies[0].get() && nextCh != kEndOfString) {
+      size_t covered = lastFamily->getCoverage().countCoveredPrefix(
+          string + nextUtf16Pos, string_size - nextUtf16Pos);
+      for (size_t i = 0; i < covered; i++) {
+        if (isVariationSelector(string[nextUtf16Pos + i])) {
+          covered = i;
+          break;
+        }
+      }
+      if (covered > 1) {
+        const size_t end = nextUtf16Pos + covered - 1;
+        prevCh = string[end - 1];
+        nextUtf16Pos = end;
+        readLength = end;
+        U16_NEXT(string, readLength, string_size, nextCh);
+        run->end = end;
+      }
+    }
   } while (nextCh != kEndOfString);
 }
 
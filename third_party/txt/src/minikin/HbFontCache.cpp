@@ -18,100 +18,209 @@
 
 #include "HbFontCache.h"
 
-#include <log/log.h>
-#include <utils/LruCache.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <hb-ot.h>
 #include <hb.h>
 
 #include <minikin/MinikinFont.h>
-#include "MinikinInternal.h"
+#include "flutter/fml/memory/memory_accounting.h"
 
 namespace minikin {
 
-class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
- public:
-  HbFontCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+namespace {
+
+// The bytes charged for each font on top of the tables of its face, for the
+// state of HarfBuzz and of the cache.
+constexpr size_t kEntryOverheadBytes = 4 * 1024;
+
+hb_font_t* createHbFont(const MinikinFont* minikinFont) {
+  hb_face_t* face = minikinFont->CreateHarfBuzzFace();
+
+  hb_font_t* parent_font = hb_font_create(face);
+  hb_ot_font_set_funcs(parent_font);
+
+  unsigned int upem = hb_face_get_upem(face);
+  hb_font_set_scale(parent_font, upem, upem);
+
+  hb_font_t* font = hb_font_create_sub_font(parent_font);
+  std::vector<hb_variation_t> variations;
+  for (const FontVariation& variation : minikinFont->GetAxes()) {
+    variations.push_back({variation.axisTag, variation.value});
   }
+  hb_font_set_variations(font, variations.data(), variations.size());
+  // Layouts shape with sub fonts of this one, so it is shared between threads
+  // and must not change.
+  hb_font_make_immutable(font);
+  hb_font_destroy(parent_font);
+  hb_face_destroy(face);
+  return font;
+}
 
-  // callback for OnEntryRemoved
-  void operator()(int32_t& /* key */, hb_font_t*& value) {
-    hb_font_destroy(value);
+}  // namespace
+
+class HbFontCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 8 * 1024 * 1024;
+
+  HbFontCache()
+      : mMaxBytes(kDefaultMaxBytes),
+        mMemoryCharge(fml::MemoryCounter::Get("HbFontCache")) {}
+
+  // Returns a new reference to the font of |fontId|, or null if it isn't
+  // cached.
+  hb_font_t* get(int32_t fontId) {
+    std::scoped_lock _l(mMutex);
+    auto found = mIndex.find(fontId);
+    if (found == mIndex.end()) {
+      return nullptr;
+    }
+    // Moves the entry to the front.
+    mEntries.splice(mEntries.begin(), mEntries, found->second);
+    return hb_font_reference(found->second->font);
   }
 
-  hb_font_t* get(int32_t fontId) { return mCache.get(fontId); }
+  // Caches |font|, which the cache takes the reference of, unless another
+  // thread cached a font for |fontId| first. Returns a new reference to the
+  // cached font.
+  hb_font_t* put(int32_t fontId, hb_font_t* font, size_t bytes) {
+    std::vector<hb_font_t*> evicted;
+    hb_font_t* result;
+    {
+      std::scoped_lock _l(mMutex);
+      auto found = mIndex.find(fontId);
+      if (found != mIndex.end()) {
+        evicted.push_back(font);
+        result = hb_font_reference(found->second->font);
+      } else {
+        mEntries.push_front({fontId, font, bytes});
+        mIndex.emplace(fontId, mEntries.begin());
+        mBytes += bytes;
+        trimLocked(&evicted);
+        result = hb_font_reference(font);
+      }
+    }
+    destroy(evicted);
+    return result;
+  }
 
-  void put(int32_t fontId, hb_font_t* font) { mCache.put(fontId, font); }
+  void remove(int32_t fontId) {
+    std::vector<hb_font_t*> evicted;
+    {
+      std::scoped_lock _l(mMutex);
+      auto found = mIndex.find(fontId);
+      if (found == mIndex.end()) {
+        return;
+      }
+      evicted.push_back(found->second->font);
+      mBytes -= found->second->bytes;
+      mEntries.erase(found->second);
+      mIndex.erase(found);
+      mMemoryCharge.Update(mBytes);
+    }
+    destroy(evicted);
+  }
 
-  void clear() { mCache.clear(); }
+  void clear() {
+    std::vector<hb_font_t*> evicted;
+    {
+      std::scoped_lock _l(mMutex);
+      for (const Entry& entry : mEntries) {
+        evicted.push_back(entry.font);
+      }
+      mEntries.clear();
+      mIndex.clear();
+      mBytes = 0;
+      mMemoryCharge.Update(mBytes);
+    }
+    destroy(evicted);
+  }
 
-  void remove(int32_t fontId) { mCache.remove(fontId); }
+  void setMaxBytes(size_t maxBytes) {
+    std::vector<hb_font_t*> evicted;
+    {
+      std::scoped_lock _l(mMutex);
+      mMaxBytes = maxBytes;
+      trimLocked(&evicted);
+    }
+    destroy(evicted);
+  }
 
  private:
-  static const size_t kMaxEntries = 100;
+  struct Entry {
+    int32_t fontId;
+    hb_font_t* font;
+    size_t bytes;
+  };
+
+  std::mutex mMutex;
+  // Most recently used first.
+  std::list<Entry> mEntries;
+  std::unordered_map<int32_t, std::list<Entry>::iterator> mIndex;
+  size_t mBytes = 0;
+  size_t mMaxBytes;
+  fml::MemoryCharge mMemoryCharge;
+
+  // Evicts the least recently used fonts beyond the budget into |evicted|,
+  // which must be destroyed without the lock held.
+  void trimLocked(std::vector<hb_font_t*>* evicted) {
+    while (mBytes > mMaxBytes && mEntries.size() > 1) {
+      const Entry& entry = mEntries.back();
+      evicted->push_back(entry.font);
+      mBytes -= entry.bytes;
+      mIndex.erase(entry.fontId);
+      mEntries.pop_back();
+    }
+    mMemoryCharge.Update(mBytes);
+  }
 
-  android::LruCache<int32_t, hb_font_t*> mCache;
+  static void destroy(const std::vector<hb_font_t*>& fonts) {
+    for (hb_font_t* font : fonts) {
+      hb_font_destroy(font);
+    }
+  }
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+static HbFontCache* getFontCache() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
-  getFontCacheLocked()->clear();
+void purgeHbFontCache() {
+  getFontCache()->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
-  const int32_t fontId = minikinFont->GetUniqueId();
-  getFontCacheLocked()->remove(fontId);
+void purgeHbFont(const MinikinFont* minikinFont) {
+  getFontCache()->remove(minikinFont->GetUniqueId());
+}
+
+void setHbFontCacheMaxBytes(size_t maxBytes) {
+  getFontCache()->setMaxBytes(maxBytes);
 }
 
-// Returns a new reference to a hb_font_t object, caller is
-// responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
   // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
+  static hb_font_t* nullFaceFont = hb_font_create(nullptr);
   if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
     return hb_font_reference(nullFaceFont);
   }
 
-  HbFontCache* fontCache = getFontCacheLocked();
+  HbFontCache* fontCache = getFontCache();
   const int32_t fontId = minikinFont->GetUniqueId();
   hb_font_t* font = fontCache->get(fontId);
   if (font != nullptr) {
-    return hb_font_reference(font);
+    return font;
   }
 
-  hb_face_t* face = minikinFont->CreateHarfBuzzFace();
-
-  hb_font_t* parent_font = hb_font_create(face);
-  hb_ot_font_set_funcs(parent_font);
-
-  unsigned int upem = hb_face_get_upem(face);
-  hb_font_set_scale(parent_font, upem, upem);
-
-  font = hb_font_create_sub_font(parent_font);
-  std::vector<hb_variation_t> variations;
-  for (const FontVariation& variation : minikinFont->GetAxes()) {
-    variations.push_back({variation.axisTag, variation.value});
-  }
-  hb_font_set_variations(font, variations.data(), variations.size());
-  hb_font_destroy(parent_font);
-  hb_face_destroy(face);
-  fontCache->put(fontId, font);
-  return hb_font_reference(font);
+  // Fonts are created without the lock held. If two threads create the same
+  // font, the first one to put it is kept.
+  return fontCache->put(
+      fontId, createHbFont(minikinFont),
+      minikinFont->GetHarfBuzzFaceSize() + kEntryOverheadBytes);
 }
 
 }  // namespace minikin
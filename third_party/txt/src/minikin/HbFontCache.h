@@ -17,14 +17,26 @@
 #ifndef MINIKIN_HBFONT_CACHE_H
 #define MINIKIN_HBFONT_CACHE_H
 
+#include <cstddef>
+
 struct hb_font_t;
 
 namespace minikin {
 class MinikinFont;
 
-void purgeHbFontCacheLocked();
-void purgeHbFontLocked(const MinikinFont* minikinFont);
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
+// The HarfBuzz fonts of the MinikinFonts, shared by all the engines of the
+// process. Fonts are evicted least recently used first beyond a budget of
+// bytes, see |MinikinFont::GetHarfBuzzFaceSize|. These functions are
+// thread-safe and don't need gMinikinLock.
+
+void purgeHbFontCache();
+void purgeHbFont(const MinikinFont* minikinFont);
+// Returns a new reference to the HarfBuzz font of |minikinFont|, which the
+// caller must release with hb_font_destroy().
+hb_font_t* getHbFont(const MinikinFont* minikinFont);
+// Sets the bytes that the cached fonts may take up, evicting fonts beyond it.
+// The most recently used font is kept even if it doesn't fit.
+void setHbFontCacheMaxBytes(size_t maxBytes);
 
 }  // namespace minikin
 #endif  // MINIKIN_HBFONT_CACHE_H
@@ -18,7 +18,9 @@
 #include <unicode/uscript.h>
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // HACK: for reading pattern file
@@ -26,6 +28,7 @@
 
 #define LOG_TAG "Minikin"
 
+#include "flutter/fml/mapping.h"
 #include "minikin/Hyphenator.h"
 #include "utils/WindowsUtils.h"
 
@@ -122,6 +125,28 @@ Hyphenator* Hyphenator::loadBinary(const uint8_t* patternData,
   return result;
 }
 
+Hyphenator* Hyphenator::loadFile(const std::string& path,
+                                 size_t minPrefix,
+                                 size_t minSuffix) {
+  // The mappings are never unmapped, as hyphenators don't own their data.
+  static std::mutex mutex;
+  static auto* mappings =
+      new std::unordered_map<std::string, std::unique_ptr<fml::FileMapping>>();
+  const uint8_t* patternData = nullptr;
+  {
+    std::scoped_lock lock(mutex);
+    auto found = mappings->find(path);
+    if (found == mappings->end()) {
+      found = mappings->emplace(path, fml::FileMapping::CreateReadOnly(path))
+                  .first;
+    }
+    if (found->second && found->second->GetSize() > 0) {
+      patternData = found->second->GetMapping();
+    }
+  }
+  return loadBinary(patternData, minPrefix, minSuffix);
+}
+
 void Hyphenator::hyphenate(vector<HyphenationType>* result,
                            const uint16_t* word,
                            size_t len,
@@ -23,6 +23,7 @@
 #endif  //  U_USING_ICU_NAMESPACE
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "unicode/locid.h"
@@ -156,6 +157,14 @@ class Hyphenator {
                                 size_t minPrefix,
                                 size_t minSuffix);
 
+  // Loads the patterns of the file at |path|. Each file is mapped read-only
+  // once per process, and the mapping is shared by all the hyphenators of the
+  // file, whichever engine they belong to, for the lifetime of the process. If
+  // the file can't be mapped, the hyphenator only processes soft hyphens.
+  static Hyphenator* loadFile(const std::string& path,
+                              size_t minPrefix,
+                              size_t minSuffix);
+
  private:
   // apply various hyphenation rules including hard and soft hyphens, ignoring
   // patterns
@@ -20,8 +20,11 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -40,6 +43,8 @@
 #include "HbFontCache.h"
 #include "LayoutUtils.h"
 #include "MinikinInternal.h"
+#include "flutter/fml/memory/memory_accounting.h"
+#include "flutter/fml/trace_event.h"
 
 namespace minikin {
 
@@ -49,6 +54,16 @@ struct LayoutContext {
   MinikinPaint paint;
   FontStyle style;
   std::vector<hb_font_t*> hbFonts;  // parallel to mFaces
+  // The buffer that this context shapes with, so that contexts on different
+  // threads don't share one. Created when it is first needed.
+  hb_buffer_t* hbBuffer = nullptr;
+
+  ~LayoutContext() {
+    clearHbFonts();
+    if (hbBuffer != nullptr) {
+      hb_buffer_destroy(hbBuffer);
+    }
+  }
 
   void clearHbFonts() {
     for (size_t i = 0; i < hbFonts.size(); i++) {
@@ -63,6 +78,7 @@ struct LayoutContext {
 
 class LayoutCacheKey {
  public:
+  // The key of a word laid out with |collection|.
   LayoutCacheKey(const std::shared_ptr<FontCollection>& collection,
                  const MinikinPaint& paint,
                  FontStyle style,
@@ -71,20 +87,39 @@ class LayoutCacheKey {
                  size_t count,
                  size_t nchars,
                  bool dir)
-      : mChars(chars),
-        mNchars(nchars),
-        mStart(start),
-        mCount(count),
-        mId(collection->getId()),
-        mStyle(style),
-        mSize(paint.size),
-        mScaleX(paint.scaleX),
-        mSkewX(paint.skewX),
-        mLetterSpacing(paint.letterSpacing),
-        mPaintFlags(paint.paintFlags),
-        mHyphenEdit(paint.hyphenEdit),
-        mIsRtl(dir),
-        mHash(computeHash()) {}
+      : LayoutCacheKey(collection->getId(),
+                       false,
+                       FakedFont{},
+                       paint,
+                       style,
+                       chars,
+                       start,
+                       count,
+                       nchars,
+                       dir) {}
+
+  // The key of a word that was itemized into a single run of |font|.
+  // Collections that share fonts share these entries, so a word that misses
+  // the entries of one collection can still skip shaping.
+  LayoutCacheKey(const FakedFont& font,
+                 const MinikinPaint& paint,
+                 FontStyle style,
+                 const uint16_t* chars,
+                 size_t start,
+                 size_t count,
+                 size_t nchars,
+                 bool dir)
+      : LayoutCacheKey(font.font->GetUniqueId(),
+                       true,
+                       font,
+                       paint,
+                       style,
+                       chars,
+                       start,
+                       count,
+                       nchars,
+                       dir) {}
+
   bool operator==(const LayoutCacheKey& other) const;
 
   android::hash_t hash() const { return mHash; }
@@ -104,16 +139,61 @@ class LayoutCacheKey {
                 const std::shared_ptr<FontCollection>& collection) const {
     layout->mAdvances.resize(mCount, 0);
     ctx->clearHbFonts();
-    layout->doLayoutRun(mChars, mStart, mCount, mNchars, mIsRtl, ctx,
-                        collection);
+    if (mIsFontKey) {
+      layout->doLayoutFontRun(mChars, mStart, mCount, mNchars, mIsRtl, ctx,
+                              mFont);
+    } else {
+      layout->doLayoutRun(mChars, mStart, mCount, mNchars, mIsRtl, ctx,
+                          collection);
+    }
+  }
+
+  // The bytes held by a cache entry of this key and |layout|.
+  int64_t getMemoryUsage(const Layout& layout) const {
+    return mNchars * sizeof(uint16_t) + sizeof(Layout) +
+           layout.mGlyphs.capacity() * sizeof(LayoutGlyph) +
+           layout.mAdvances.capacity() * sizeof(float) +
+           layout.mFaces.capacity() * sizeof(FakedFont);
   }
 
  private:
+  LayoutCacheKey(uint32_t id,
+                 bool isFontKey,
+                 const FakedFont& font,
+                 const MinikinPaint& paint,
+                 FontStyle style,
+                 const uint16_t* chars,
+                 size_t start,
+                 size_t count,
+                 size_t nchars,
+                 bool dir)
+      : mChars(chars),
+        mNchars(nchars),
+        mStart(start),
+        mCount(count),
+        mId(id),
+        mIsFontKey(isFontKey),
+        mFont(font),
+        mStyle(style),
+        mSize(paint.size),
+        mScaleX(paint.scaleX),
+        mSkewX(paint.skewX),
+        mLetterSpacing(paint.letterSpacing),
+        mPaintFlags(paint.paintFlags),
+        mHyphenEdit(paint.hyphenEdit),
+        mIsRtl(dir),
+        mHash(computeHash()) {}
+
   const uint16_t* mChars;
   size_t mNchars;
   size_t mStart;
   size_t mCount;
-  uint32_t mId;  // for the font collection
+  // The font collection, or the font's unique id for font keys.
+  uint32_t mId;
+  bool mIsFontKey;
+  // Only used to lay out the word before it is added to the cache, since the
+  // collection that owns the font may go away while the entry is cached.
+  FakedFont mFont;
   FontStyle mStyle;
   float mSize;
   float mScaleX;
@@ -129,53 +209,140 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A cache of word layouts, split into shards that each have their own lock so
+// that threads laying out different words don't wait for each other.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  LayoutCache() : mMemoryCounter(fml::MemoryCounter::Get("LayoutCache")) {
+    setMaxBytes(kDefaultMaxBytes);
+  }
+
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mutex);
+      shard.cache.clear();
+    }
+    traceCounters();
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  // Evicts the least recently used layouts of each shard beyond its share of
+  // |maxBytes|.
+  void setMaxBytes(size_t maxBytes) {
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mutex);
+      shard.maxBytes = maxBytes / kShardCount;
+      shard.trim();
     }
+    traceCounters();
+  }
+
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock _l(shard.mutex);
+      std::shared_ptr<Layout> layout = shard.cache.get(key);
+      if (layout) {
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        return layout;
+      }
+      shard.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Shapes the word without the shard locked, so that hits of other words
+    // in the shard don't wait for it.
+    auto layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+    int64_t bytes = key.getMemoryUsage(*layout);
+    {
+      std::scoped_lock _l(shard.mutex);
+      // Another thread may have added the same word in the meantime.
+      if (bytes <= static_cast<int64_t>(shard.maxBytes) &&
+          !shard.cache.get(key)) {
+        key.copyText();
+        shard.cache.put(key, layout);
+        shard.memoryCharge.Update(shard.memoryCharge.GetBytes() + bytes);
+        shard.trim();
+      }
+    }
+    traceCounters();
     return layout;
   }
 
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
-  }
+  struct Shard : private android::OnEntryRemoved<LayoutCacheKey,
+                                                 std::shared_ptr<Layout>> {
+    Shard()
+        : memoryCharge(fml::MemoryCounter::Get("LayoutCache")),
+          cache(android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>::
+                    kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+    void trim() {
+      while (memoryCharge.GetBytes() > static_cast<int64_t>(maxBytes) &&
+             cache.removeOldest()) {
+      }
+    }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key,
+                    std::shared_ptr<Layout>& value) override {
+      memoryCharge.Update(memoryCharge.GetBytes() -
+                          key.getMemoryUsage(*value));
+      key.freeText();
+      // Layouts still in use by a get() are deleted once it is done with them.
+      value.reset();
+    }
+
+    std::mutex mutex;
+    size_t maxBytes = 0;
+    // The entries of |cache|, charged to the "LayoutCache" counter, and
+    // declared first since the cache removes its entries when it is destroyed.
+    fml::MemoryCharge memoryCharge;
+    android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> cache;
+    // Written with the mutex held, and read without it by traceCounters().
+    std::atomic<size_t> hits = {0};
+    std::atomic<size_t> misses = {0};
+  };
+
+  void traceCounters() const {
+#if !FLUTTER_RELEASE
+    size_t hits = 0;
+    size_t misses = 0;
+    for (const Shard& shard : mShards) {
+      hits += shard.hits.load(std::memory_order_relaxed);
+      misses += shard.misses.load(std::memory_order_relaxed);
+    }
+    const size_t lookups = hits + misses;
+    FML_TRACE_COUNTER("flutter", "LayoutCache",
+                      reinterpret_cast<int64_t>(this),                  //
+                      "Bytes", mMemoryCounter->GetBytes(),              //
+                      "Hits", hits,                                     //
+                      "Misses", misses,                                 //
+                      "HitRate", lookups ? hits * 1.0 / lookups : 0.0  //
+    );
+#endif  // !FLUTTER_RELEASE
+  }
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  // A power of two, so that the shard of a hash is cheap to compute.
+  static constexpr size_t kShardCount = 16;
+  // Roughly what the 5000 words this cache used to be limited to take up.
+  static constexpr size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+
+  // The counter that all shards charge their entries to.
+  fml::MemoryCounter* mMemoryCounter;
+  std::array<Shard, kShardCount> mShards;
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -186,7 +353,8 @@ class LayoutEngine {
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
-  return mId == other.mId && mStart == other.mStart && mCount == other.mCount &&
+  return mId == other.mId && mIsFontKey == other.mIsFontKey &&
+         mStart == other.mStart && mCount == other.mCount &&
          mStyle == other.mStyle && mSize == other.mSize &&
          mScaleX == other.mScaleX && mSkewX == other.mSkewX &&
          mLetterSpacing == other.mLetterSpacing &&
@@ -197,6 +365,7 @@ bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
 
 android::hash_t LayoutCacheKey::computeHash() const {
   uint32_t hash = android::JenkinsHashMix(0, mId);
+  hash = android::JenkinsHashMix(hash, hash_type(mIsFontKey));
   hash = android::JenkinsHashMix(hash, mStart);
   hash = android::JenkinsHashMix(hash, mCount);
   hash = android::JenkinsHashMix(hash, hash_type(mStyle));
@@ -316,7 +485,12 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // Shapes with a font of its own, whose size and advances are set for this
+    // context without changing the cached font that other threads shape with.
+    std::scoped_lock _l(gMinikinLock);
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +499,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +759,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -599,8 +768,6 @@ void Layout::doLayout(const uint16_t* buf,
 
   doLayoutRunCached(buf, start, count, bufSize, isRtl, &ctx, start, collection,
                     this, NULL);
-
-  ctx.clearHbFonts();
 }
 
 float Layout::measureText(const uint16_t* buf,
@@ -612,17 +779,12 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
 
-  float advance = doLayoutRunCached(buf, start, count, bufSize, isRtl, &ctx, 0,
-                                    collection, NULL, advances);
-
-  ctx.clearHbFonts();
-  return advance;
+  return doLayoutRunCached(buf, start, count, bufSize, isRtl, &ctx, 0,
+                           collection, NULL, advances);
 }
 
 float Layout::doLayoutRunCached(
@@ -720,9 +882,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -919,9 +1081,75 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  // Itemizing may match and cache fallback fonts, and other threads may
+  // register language lists, so both happen with gMinikinLock held. The
+  // languages are copied since the list they are in may move once the lock is
+  // released. Shaping itself doesn't need the lock.
   std::vector<FontCollection::Run> items;
-  collection->itemize(buf + start, count, ctx->style, &items);
+  std::vector<FontLanguage> languages;
+  {
+    std::scoped_lock _l(gMinikinLock);
+    collection->itemize(buf + start, count, ctx->style, &items);
+    const FontLanguages& langList =
+        FontLanguageListCache::getById(ctx->style.getLanguageListId());
+    for (size_t i = 0; i < langList.size(); ++i) {
+      languages.push_back(langList[i]);
+    }
+  }
+
+  // Words in a single font are shaped the same in any collection that has the
+  // font, so their shaping is cached by font as well.
+  if (!ctx->paint.skipCache() && items.size() == 1 &&
+      items[0].fakedFont.font != NULL && items[0].start == 0 &&
+      items[0].end == static_cast<int>(count)) {
+    LayoutCacheKey key(items[0].fakedFont, ctx->paint, ctx->style, buf, start,
+                       count, bufSize, isRtl);
+    std::shared_ptr<Layout> layout =
+        LayoutEngine::getInstance().layoutCache.get(key, ctx, collection);
+    appendLayout(layout.get(), 0, 0, &items[0].fakedFont);
+    return;
+  }
+
+  doLayoutItems(buf, start, count, bufSize, isRtl, ctx, items, languages);
+}
+
+void Layout::doLayoutFontRun(const uint16_t* buf,
+                             size_t start,
+                             size_t count,
+                             size_t bufSize,
+                             bool isRtl,
+                             LayoutContext* ctx,
+                             const FakedFont& font) {
+  std::vector<FontCollection::Run> items(1);
+  items[0].fakedFont = font;
+  items[0].start = 0;
+  items[0].end = count;
+  std::vector<FontLanguage> languages;
+  {
+    std::scoped_lock _l(gMinikinLock);
+    const FontLanguages& langList =
+        FontLanguageListCache::getById(ctx->style.getLanguageListId());
+    for (size_t i = 0; i < langList.size(); ++i) {
+      languages.push_back(langList[i]);
+    }
+  }
+  doLayoutItems(buf, start, count, bufSize, isRtl, ctx, items, languages);
+}
+
+void Layout::doLayoutItems(const uint16_t* buf,
+                           size_t start,
+                           size_t count,
+                           size_t bufSize,
+                           bool isRtl,
+                           LayoutContext* ctx,
+                           const std::vector<FontCollection::Run>& items,
+                           const std::vector<FontLanguage>& languages) {
+  if (ctx->hbBuffer == nullptr) {
+    ctx->hbBuffer = hb_buffer_create();
+    hb_buffer_set_unicode_funcs(ctx->hbBuffer,
+                                LayoutEngine::getInstance().unicodeFunctions);
+  }
+  hb_buffer_t* buffer = ctx->hbBuffer;
 
   std::vector<hb_feature_t> features;
   // Disable default-on non-required ligature features if letter-spacing
@@ -945,7 +1173,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
   for (int run_ix = isRtl ? items.size() - 1 : 0;
        isRtl ? run_ix >= 0 : run_ix < static_cast<int>(items.size());
        isRtl ? --run_ix : ++run_ix) {
-    FontCollection::Run& run = items[run_ix];
+    const FontCollection::Run& run = items[run_ix];
     if (run.fakedFont.font == NULL) {
       ALOGE("no font for run starting u+%04x length %d", buf[run.start],
             run.end - run.start);
@@ -1005,13 +1233,11 @@ void Layout::doLayoutRun(const uint16_t* buf,
       hb_buffer_set_script(buffer, script);
       hb_buffer_set_direction(buffer,
                               isRtl ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-      const FontLanguages& langList =
-          FontLanguageListCache::getById(ctx->style.getLanguageListId());
-      if (langList.size() != 0) {
-        const FontLanguage* hbLanguage = &langList[0];
-        for (size_t i = 0; i < langList.size(); ++i) {
-          if (langList[i].supportsHbScript(script)) {
-            hbLanguage = &langList[i];
+      if (!languages.empty()) {
+        const FontLanguage* hbLanguage = &languages[0];
+        for (size_t i = 0; i < languages.size(); ++i) {
+          if (languages[i].supportsHbScript(script)) {
+            hbLanguage = &languages[i];
             break;
           }
         }
@@ -1105,7 +1331,10 @@ void Layout::doLayoutRun(const uint16_t* buf,
   mAdvance = x;
 }
 
-void Layout::appendLayout(Layout* src, size_t start, float extraAdvance) {
+void Layout::appendLayout(Layout* src,
+                          size_t start,
+                          float extraAdvance,
+                          const FakedFont* face) {
   int fontMapStack[16];
   int* fontMap;
   if (src->mFaces.size() < sizeof(fontMapStack) / sizeof(fontMapStack[0])) {
@@ -1114,7 +1343,7 @@ void Layout::appendLayout(Layout* src, size_t start, float extraAdvance) {
     fontMap = new int[src->mFaces.size()];
   }
   for (size_t i = 0; i < src->mFaces.size(); i++) {
-    int font_ix = findFace(src->mFaces[i], NULL);
+    int font_ix = findFace(face ? *face : src->mFaces[i], NULL);
     fontMap[i] = font_ix;
   }
   // LibTxt: Changed x0 from int to float to prevent rounding that causes text
@@ -1192,11 +1421,15 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+void Layout::setCacheMaxBytes(size_t maxBytes) {
+  LayoutEngine::getInstance().layoutCache.setMaxBytes(maxBytes);
+}
+
 void Layout::purgeCaches() {
   std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
 }
 
 }  // namespace minikin
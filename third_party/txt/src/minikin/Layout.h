@@ -46,6 +46,8 @@ struct LayoutGlyph {
 // Internal state used during layout operation
 struct LayoutContext;
 
+struct FontLanguage;
+
 enum {
   kBidi_LTR = 0,
   kBidi_RTL = 1,
@@ -59,7 +61,8 @@ enum {
 
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
-// may not mutate it at the same time.
+// may not mutate it at the same time. Different objects may be laid out on
+// different threads at the same time.
 class Layout {
  public:
   Layout() : mGlyphs(), mAdvances(), mFaces(), mAdvance(0), mBounds() {
@@ -114,6 +117,10 @@ class Layout {
 
   void getBounds(MinikinRect* rect) const;
 
+  // Sets the bytes that the cached layouts of words may take up, evicting the
+  // least recently used words beyond it.
+  static void setCacheMaxBytes(size_t maxBytes);
+
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
@@ -162,8 +169,32 @@ class Layout {
                    LayoutContext* ctx,
                    const std::shared_ptr<FontCollection>& collection);
 
-  // Append another layout (for example, cached value) into this one
-  void appendLayout(Layout* src, size_t start, float extraAdvance);
+  // Lay out a single bidi run in a single font
+  void doLayoutFontRun(const uint16_t* buf,
+                       size_t start,
+                       size_t count,
+                       size_t bufSize,
+                       bool isRtl,
+                       LayoutContext* ctx,
+                       const FakedFont& font);
+
+  // Shape the itemized runs of a single bidi run
+  void doLayoutItems(const uint16_t* buf,
+                     size_t start,
+                     size_t count,
+                     size_t bufSize,
+                     bool isRtl,
+                     LayoutContext* ctx,
+                     const std::vector<FontCollection::Run>& items,
+                     const std::vector<FontLanguage>& languages);
+
+  // Append another layout (for example, cached value) into this one. When
+  // |face| is given, all of the glyphs of |src| are in it instead of the faces
+  // of |src|.
+  void appendLayout(Layout* src,
+                    size_t start,
+                    float extraAdvance,
+                    const FakedFont* face = NULL);
 
   std::vector<LayoutGlyph> mGlyphs;
   std::vector<float> mAdvances;
@@ -91,11 +91,12 @@ class LineBreaker {
       29;  // keep synchronized with TAB_MASK in StaticLayout.java
 
   // Note: Locale persists across multiple invocations (it is not cleaned up by
-  // finish()), explicitly to avoid the cost of creating ICU BreakIterator
-  // objects. It should always be set on the first invocation, but callers are
-  // encouraged not to call again unless locale has actually changed. That logic
-  // could be here but it's better for performance that it's upstream because of
-  // the cost of constructing and comparing the ICU Locale object.
+  // finish()). It should always be set on the first invocation, but callers
+  // are encouraged not to call again unless locale has actually changed. That
+  // logic could be here but it's better for performance that it's upstream
+  // because of the cost of constructing and comparing the ICU Locale object.
+  // The ICU BreakIterator is taken from the BreakIteratorPool of the thread
+  // when text is set, and released to it by finish().
   // Note: caller is responsible for managing lifetime of hyphenator
   void setLocale(const icu::Locale& locale, Hyphenator* hyphenator);
 
@@ -145,6 +146,16 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, for a run whose widths are already in
+  // charWidths(), such as those measured by an earlier addStyleRun of the same
+  // text. Lets text be broken at another width without measuring it again.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -103,6 +103,11 @@ class MinikinFont {
 
   virtual hb_face_t* CreateHarfBuzzFace() const { return nullptr; }
 
+  // The approximate bytes of the tables that the face created by
+  // |CreateHarfBuzzFace| loads to shape text, which the cache of HarfBuzz
+  // fonts counts against its budget.
+  virtual size_t GetHarfBuzzFaceSize() const { return 0; }
+
   virtual const std::vector<minikin::FontVariation>& GetAxes() const = 0;
 
   virtual std::shared_ptr<MinikinFont> createFontWithVariation(
@@ -155,4 +155,26 @@ uint32_t SparseBitSet::nextSetBit(uint32_t fromIndex) const {
   return kNotFound;
 }
 
+size_t SparseBitSet::countCoveredPrefix(const uint16_t* text,
+                                        size_t length) const {
+  uint32_t page = kNotFound;
+  const element* bitmap = nullptr;
+  for (size_t i = 0; i < length; i++) {
+    const uint32_t ch = text[i];
+    if (ch >= mMaxVal || (ch & 0xF800) == 0xD800) {
+      return i;
+    }
+    if ((ch >> kLogValuesPerPage) != page) {
+      page = ch >> kLogValuesPerPage;
+      bitmap = &mBitmaps[mIndices[page]];
+    }
+    const uint32_t index = ch & kPageMask;
+    if ((bitmap[index >> kLogBitsPerEl] & (kElFirst >> (index & kElMask))) ==
+        0) {
+      return i;
+    }
+  }
+  return length;
+}
+
 }  // namespace minikin
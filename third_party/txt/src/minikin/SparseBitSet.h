@@ -63,6 +63,13 @@ class SparseBitSet {
   // if none exists.
   uint32_t nextSetBit(uint32_t fromIndex) const;
 
+  // The number of code units at the start of |text| that are characters in
+  // the set. Stops at the first character that isn't, and at the first
+  // surrogate, as only characters in the BMP are counted. The bitmap of a
+  // page is looked up once for each run of characters in it, which is what
+  // text in one script is made of.
+  size_t countCoveredPrefix(const uint16_t* text, size_t length) const;
+
   static const uint32_t kNotFound = ~0u;
 
  private:
@@ -32,10 +32,13 @@ const uint32_t CHAR_SOFT_HYPHEN = 0x00AD;
 const uint32_t CHAR_ZWJ = 0x200D;
 
 void WordBreaker::setLocale(const icu::Locale& locale) {
-  UErrorCode status = U_ZERO_ERROR;
-  mBreakIterator.reset(icu::BreakIterator::createLineInstance(locale, status));
-  // TODO: handle failure status
+  mLocale = locale;
+  mBreakIterator = BreakIteratorPool::Iterator();
   if (mText != nullptr) {
+    mBreakIterator =
+        BreakIteratorPool::acquire(BreakIteratorPool::Kind::kLine, mLocale);
+    // TODO: handle failure status
+    UErrorCode status = U_ZERO_ERROR;
     mBreakIterator->setText(&mUText, status);
   }
   mIteratorWasReset = true;
@@ -52,6 +55,10 @@ void WordBreaker::setText(const uint16_t* data, size_t size) {
   UErrorCode status = U_ZERO_ERROR;
   utext_openUChars(&mUText, reinterpret_cast<const UChar*>(data), size,
                    &status);
+  if (!mBreakIterator) {
+    mBreakIterator =
+        BreakIteratorPool::acquire(BreakIteratorPool::Kind::kLine, mLocale);
+  }
   mBreakIterator->setText(&mUText, status);
   mBreakIterator->first();
 }
@@ -276,6 +283,7 @@ int WordBreaker::breakBadness() const {
 
 void WordBreaker::finish() {
   mText = nullptr;
+  mBreakIterator = BreakIteratorPool::Iterator();
   // Note: calling utext_close multiply is safe
   utext_close(&mUText);
 }
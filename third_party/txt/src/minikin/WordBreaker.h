@@ -24,7 +24,9 @@
 #define MINIKIN_WORD_BREAKER_H
 
 #include <memory>
+#include "minikin/BreakIteratorPool.h"
 #include "unicode/brkiter.h"
+#include "unicode/locid.h"
 #include "utils/WindowsUtils.h"
 
 namespace minikin {
@@ -52,6 +54,7 @@ class WordBreaker {
 
   int breakBadness() const;
 
+  // Releases the break iterator to the pool, until text is set again.
   void finish();
 
  private:
@@ -59,7 +62,9 @@ class WordBreaker {
   void detectEmailOrUrl();
   ssize_t findNextBreakInEmailOrUrl();
 
-  std::unique_ptr<icu::BreakIterator> mBreakIterator;
+  icu::Locale mLocale;
+  // Taken from the pool while there is text.
+  BreakIteratorPool::Iterator mBreakIterator;
   UText mUText = UTEXT_INITIALIZER;
   const uint16_t* mText = nullptr;
   size_t mTextSize;
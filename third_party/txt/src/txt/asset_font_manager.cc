@@ -109,4 +109,48 @@ sk_sp<SkTypeface> AssetFontManager::onLegacyMakeTypeface(
   return nullptr;
 }
 
+RemainderFontManager::RemainderFontManager(
+    std::unique_ptr<FontAssetProvider> font_provider)
+    : AssetFontManager(std::move(font_provider)) {}
+
+RemainderFontManager::~RemainderFontManager() = default;
+
+SkFontStyleSet* RemainderFontManager::onMatchFamily(
+    const char family_name_string[]) const {
+  std::string family_name(family_name_string);
+  auto matched = matched_family_names_.find(family_name);
+  if (matched != matched_family_names_.end()) {
+    family_name = matched->second;
+  }
+  return font_provider_->MatchFamily(family_name);
+}
+
+SkTypeface* RemainderFontManager::onMatchFamilyStyleCharacter(
+    const char familyName[],
+    const SkFontStyle& style,
+    const char* bcp47[],
+    int bcp47Count,
+    SkUnichar character) const {
+  for (size_t i = 0; i < font_provider_->GetFamilyCount(); i++) {
+    std::string family_name = font_provider_->GetFamilyName(i);
+    sk_sp<SkFontStyleSet> font_style_set(
+        font_provider_->MatchFamily(family_name));
+    if (font_style_set == nullptr) {
+      continue;
+    }
+    // Creating the typefaces loads the remainders of the family.
+    for (int j = 0; j < font_style_set->count(); j++) {
+      sk_sp<SkTypeface> typeface(font_style_set->createTypeface(j));
+      if (typeface == nullptr || typeface->unicharToGlyph(character) == 0) {
+        continue;
+      }
+      SkString typeface_family_name;
+      typeface->getFamilyName(&typeface_family_name);
+      matched_family_names_[typeface_family_name.c_str()] = family_name;
+      return typeface.release();
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace txt
@@ -18,6 +18,8 @@
 #define TXT_ASSET_FONT_MANAGER_H_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkStream.h"
@@ -95,6 +97,36 @@ class DynamicFontManager : public AssetFontManager {
   }
 };
 
+// Provides the remainders of subset fonts, which hold the characters that
+// were left out of the subsets. They are only matched as fallback fonts, so
+// that they are not loaded before text needs a character that the subsets
+// lack.
+class RemainderFontManager : public AssetFontManager {
+ public:
+  RemainderFontManager(std::unique_ptr<FontAssetProvider> font_provider);
+
+  ~RemainderFontManager() override;
+
+ protected:
+  // |SkFontMgr|
+  SkFontStyleSet* onMatchFamily(const char familyName[]) const override;
+
+ private:
+  // The families of the provider by the family names of the typefaces that
+  // were matched to characters, which fallback fonts are looked up by and
+  // which may differ from the names the fonts were registered with.
+  mutable std::unordered_map<std::string, std::string> matched_family_names_;
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                          const SkFontStyle&,
+                                          const char* bcp47[],
+                                          int bcp47Count,
+                                          SkUnichar character) const override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RemainderFontManager);
+};
+
 }  // namespace txt
 
 #endif  // TXT_ASSET_FONT_MANAGER_H_
@@ -24,9 +24,12 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "flutter/fml/hash.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
+#include "font_fallback_cache.h"
 #include "font_skia.h"
+#include "minikin/MinikinInternal.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
 
@@ -55,8 +58,8 @@ bool FontCollection::FamilyKey::operator==(
 
 size_t FontCollection::FamilyKey::Hasher::operator()(
     const FontCollection::FamilyKey& key) const {
-  return std::hash<std::string>()(key.font_families) ^
-         std::hash<std::string>()(key.locale);
+  return static_cast<size_t>(
+      fml::HashBytes(key.locale, fml::HashBytes(key.font_families)));
 }
 
 class TxtFallbackFontProvider
@@ -90,22 +93,32 @@ size_t FontCollection::GetFontManagersCount() const {
 
 void FontCollection::SetupDefaultFontManager() {
   default_font_manager_ = GetDefaultFontManager();
+  fonts_generation_++;
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
   default_font_manager_ = font_manager;
+  fonts_generation_++;
 }
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
   asset_font_manager_ = font_manager;
+  fonts_generation_++;
+}
+
+void FontCollection::SetRemainderFontManager(sk_sp<SkFontMgr> font_manager) {
+  remainder_font_manager_ = font_manager;
+  fonts_generation_++;
 }
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
   dynamic_font_manager_ = font_manager;
+  fonts_generation_++;
 }
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
   test_font_manager_ = font_manager;
+  fonts_generation_++;
 }
 
 // Return the available font managers in the order they should be queried.
@@ -115,6 +128,8 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
     order.push_back(dynamic_font_manager_);
   if (asset_font_manager_)
     order.push_back(asset_font_manager_);
+  if (remainder_font_manager_)
+    order.push_back(remainder_font_manager_);
   if (test_font_manager_)
     order.push_back(test_font_manager_);
   if (default_font_manager_)
@@ -122,14 +137,32 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
   return order;
 }
 
+sk_sp<SkTypeface> FontCollection::MatchTypeface(
+    const std::string& family_name) const {
+  for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
+    sk_sp<SkTypeface> typeface(
+        manager->matchFamilyStyle(family_name.c_str(), SkFontStyle()));
+    if (typeface) {
+      return typeface;
+    }
+  }
+  return nullptr;
+}
+
 void FontCollection::DisableFontFallback() {
   enable_font_fallback_ = false;
+  fonts_generation_++;
 }
 
 std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  // Fallback fonts are matched and cached while text is itemized, which holds
+  // gMinikinLock, so paragraphs laid out on different threads use the caches
+  // with the same lock held.
+  std::scoped_lock lock(minikin::gMinikinLock);
+
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -264,19 +297,27 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  FontFallbackCache& fallback_cache = FontFallbackCache::GetInstance();
+  const SkFontStyle style;
   for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
-    std::vector<const char*> bcp47;
-    if (!locale.empty())
-      bcp47.push_back(locale.c_str());
-    sk_sp<SkTypeface> typeface(manager->matchFamilyStyleCharacter(
-        0, SkFontStyle(), bcp47.data(), bcp47.size(), ch));
-    if (!typeface)
+    // Other collections with the same manager may have matched ch already.
+    std::string family_name;
+    if (!fallback_cache.Lookup(manager, ch, locale, style, &family_name)) {
+      std::vector<const char*> bcp47;
+      if (!locale.empty())
+        bcp47.push_back(locale.c_str());
+      sk_sp<SkTypeface> typeface(manager->matchFamilyStyleCharacter(
+          0, style, bcp47.data(), bcp47.size(), ch));
+      if (typeface) {
+        SkString sk_family_name;
+        typeface->getFamilyName(&sk_family_name);
+        family_name = sk_family_name.c_str();
+      }
+      fallback_cache.Insert(manager, ch, locale, style, family_name);
+    }
+    if (family_name.empty())
       continue;
 
-    SkString sk_family_name;
-    typeface->getFamilyName(&sk_family_name);
-    std::string family_name(sk_family_name.c_str());
-
     if (std::find(fallback_fonts_for_locale_[locale].begin(),
                   fallback_fonts_for_locale_[locale].end(),
                   family_name) == fallback_fonts_for_locale_[locale].end())
@@ -312,7 +353,9 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(minikin::gMinikinLock);
   font_collections_cache_.clear();
+  fonts_generation_++;
 }
 
 #if FLUTTER_ENABLE_SKSHAPER
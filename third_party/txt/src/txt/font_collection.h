@@ -17,16 +17,19 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include "flutter/fml/flat_hash_map.h"
 #include "flutter/fml/macros.h"
 #include "minikin/FontCollection.h"
 #include "minikin/FontFamily.h"
 #include "third_party/googletest/googletest/include/gtest/gtest_prod.h"  // nogncheck
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 #include "txt/asset_font_manager.h"
 #include "txt/text_style.h"
 
@@ -47,6 +50,9 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   void SetupDefaultFontManager();
   void SetDefaultFontManager(sk_sp<SkFontMgr> font_manager);
   void SetAssetFontManager(sk_sp<SkFontMgr> font_manager);
+  // Sets the manager of the remainders of the subset asset fonts, which is
+  // queried right after the asset font manager. See RemainderFontManager.
+  void SetRemainderFontManager(sk_sp<SkFontMgr> font_manager);
   void SetDynamicFontManager(sk_sp<SkFontMgr> font_manager);
   void SetTestFontManager(sk_sp<SkFontMgr> font_manager);
 
@@ -60,6 +66,10 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       uint32_t ch,
       std::string locale);
 
+  // Returns the typeface of the regular style of |family_name| from the first
+  // font manager that has the family, or null if none has it.
+  sk_sp<SkTypeface> MatchTypeface(const std::string& family_name) const;
+
   // Do not provide alternative fonts that can match characters which are
   // missing from the requested font family.
   void DisableFontFallback();
@@ -67,6 +77,11 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // A number that changes whenever the fonts of the collection may have
+  // changed, so that layouts made with the fonts before can tell they are
+  // stale.
+  uint64_t GetFontsGeneration() const { return fonts_generation_; }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -91,21 +106,26 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 
   sk_sp<SkFontMgr> default_font_manager_;
   sk_sp<SkFontMgr> asset_font_manager_;
+  sk_sp<SkFontMgr> remainder_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
-  std::unordered_map<FamilyKey,
-                     std::shared_ptr<minikin::FontCollection>,
-                     FamilyKey::Hasher>
+  fml::FlatHashMap<FamilyKey,
+                   std::shared_ptr<minikin::FontCollection>,
+                   FamilyKey::Hasher>
       font_collections_cache_;
   // Cache that stores the results of MatchFallbackFont to ensure lag-free emoji
-  // font fallback matching.
-  std::unordered_map<uint32_t, const std::shared_ptr<minikin::FontFamily>*>
+  // font fallback matching. Points into |fallback_fonts_|, whose entries don't
+  // move.
+  fml::FlatHashMap<uint32_t, const std::shared_ptr<minikin::FontFamily>*>
       fallback_match_cache_;
   std::unordered_map<std::string, std::shared_ptr<minikin::FontFamily>>
       fallback_fonts_;
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  // Incremented when font managers are set and when the font family cache is
+  // cleared, which may happen off the threads that lay out text.
+  std::atomic<uint64_t> fonts_generation_ = {0};
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -113,7 +133,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 #endif
 
   // Performs the actual work of MatchFallbackFont. The result is cached in
-  // fallback_match_cache_.
+  // fallback_match_cache_, and the families the font managers matched are
+  // shared with other collections through FontFallbackCache.
   const std::shared_ptr<minikin::FontFamily>& DoMatchFallbackFont(
       uint32_t ch,
       std::string locale);
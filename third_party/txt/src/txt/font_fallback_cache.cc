@@ -0,0 +1,79 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "font_fallback_cache.h"
+
+#include "flutter/fml/hash.h"
+
+namespace txt {
+
+bool FontFallbackCache::Key::operator==(const Key& other) const {
+  return manager == other.manager && ch == other.ch &&
+         locale == other.locale && style == other.style;
+}
+
+size_t FontFallbackCache::Key::Hasher::operator()(const Key& key) const {
+  uint64_t hash = fml::HashMix(reinterpret_cast<uintptr_t>(key.manager.get()),
+                               key.ch);
+  hash = fml::HashMix(hash, key.style.weight());
+  hash = fml::HashMix(hash, key.style.width());
+  hash = fml::HashMix(hash, key.style.slant());
+  return static_cast<size_t>(fml::HashBytes(key.locale, hash));
+}
+
+FontFallbackCache& FontFallbackCache::GetInstance() {
+  static FontFallbackCache* cache = new FontFallbackCache();
+  return *cache;
+}
+
+FontFallbackCache::FontFallbackCache() = default;
+
+FontFallbackCache::~FontFallbackCache() = default;
+
+bool FontFallbackCache::Lookup(const sk_sp<SkFontMgr>& manager,
+                               uint32_t ch,
+                               const std::string& locale,
+                               const SkFontStyle& style,
+                               std::string* family_name) const {
+  std::scoped_lock lock(mutex_);
+  auto found = family_names_.find(Key{manager, ch, locale, style});
+  if (found == family_names_.end()) {
+    return false;
+  }
+  *family_name = found->second;
+  return true;
+}
+
+void FontFallbackCache::Insert(const sk_sp<SkFontMgr>& manager,
+                               uint32_t ch,
+                               const std::string& locale,
+                               const SkFontStyle& style,
+                               std::string family_name) {
+  std::scoped_lock lock(mutex_);
+  family_names_[Key{manager, ch, locale, style}] = std::move(family_name);
+}
+
+void FontFallbackCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  family_names_.clear();
+}
+
+size_t FontFallbackCache::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return family_names_.size();
+}
+
+}  // namespace txt
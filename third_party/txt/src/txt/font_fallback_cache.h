@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
+#define LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
+
+#include <mutex>
+#include <string>
+
+#include "flutter/fml/flat_hash_map.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+#include "third_party/skia/include/core/SkFontStyle.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace txt {
+
+// The family names that font managers matched for characters missing from
+// the requested fonts, shared by all the FontCollections of the process.
+//
+// Matching a character asks the platform, which can take milliseconds, and
+// every engine would otherwise repeat it for the same characters on the same
+// default font manager. The cache keeps a reference to the managers it has
+// entries for so that their addresses aren't reused by others.
+//
+// The cache is thread-safe. Its lock isn't held while matching, so two
+// threads missing on the same character may both match it.
+class FontFallbackCache {
+ public:
+  static FontFallbackCache& GetInstance();
+
+  FontFallbackCache();
+
+  ~FontFallbackCache();
+
+  // Sets |family_name| to what |manager| matched for |ch| with |locale| and
+  // |style|, which is empty if it matched nothing. Returns false if the
+  // character hasn't been matched with that manager.
+  bool Lookup(const sk_sp<SkFontMgr>& manager,
+              uint32_t ch,
+              const std::string& locale,
+              const SkFontStyle& style,
+              std::string* family_name) const;
+
+  // Records that |manager| matched |family_name| for |ch| with |locale| and
+  // |style|, or nothing if it is empty.
+  void Insert(const sk_sp<SkFontMgr>& manager,
+              uint32_t ch,
+              const std::string& locale,
+              const SkFontStyle& style,
+              std::string family_name);
+
+  void Clear();
+
+  size_t GetEntryCount() const;
+
+ private:
+  struct Key {
+    sk_sp<SkFontMgr> manager;
+    uint32_t ch;
+    std::string locale;
+    SkFontStyle style;
+
+    bool operator==(const Key& other) const;
+
+    struct Hasher {
+      size_t operator()(const Key& key) const;
+    };
+  };
+
+  mutable std::mutex mutex_;
+  fml::FlatHashMap<Key, std::string, Key::Hasher> family_names_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FontFallbackCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_FONT_FALLBACK_CACHE_H_
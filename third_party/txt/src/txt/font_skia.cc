@@ -85,6 +85,24 @@ hb_face_t* FontSkia::CreateHarfBuzzFace() const {
   return hb_face_create_for_tables(GetTable, typeface_.get(), 0);
 }
 
+size_t FontSkia::GetHarfBuzzFaceSize() const {
+  // The tables that shaping copies with |GetTable|.
+  static const SkFontTableTag kShapingTables[] = {
+      SkSetFourByteTag('c', 'm', 'a', 'p'),
+      SkSetFourByteTag('h', 'm', 't', 'x'),
+      SkSetFourByteTag('G', 'D', 'E', 'F'),
+      SkSetFourByteTag('G', 'S', 'U', 'B'),
+      SkSetFourByteTag('G', 'P', 'O', 'S'),
+      SkSetFourByteTag('k', 'e', 'r', 'n'),
+      SkSetFourByteTag('m', 'o', 'r', 'x'),
+  };
+  size_t size = 0;
+  for (SkFontTableTag tag : kShapingTables) {
+    size += typeface_->getTableSize(tag);
+  }
+  return size;
+}
+
 const std::vector<minikin::FontVariation>& FontSkia::GetAxes() const {
   return variations_;
 }
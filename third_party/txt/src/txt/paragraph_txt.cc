@@ -29,6 +29,7 @@
 #include "flutter/fml/logging.h"
 #include "font_collection.h"
 #include "font_skia.h"
+#include "minikin/BreakIteratorPool.h"
 #include "minikin/FontLanguageListCache.h"
 #include "minikin/GraphemeBreak.h"
 #include "minikin/HbFontCache.h"
@@ -256,16 +257,24 @@ bool ParagraphTxt::ComputeLineBreaks() {
   line_widths_.clear();
   max_intrinsic_width_ = 0;
 
-  std::vector<size_t> newline_positions;
-  // Discover and add all hard breaks.
-  for (size_t i = 0; i < text_.size(); ++i) {
-    ULineBreak ulb = static_cast<ULineBreak>(
-        u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
-    if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
-      newline_positions.push_back(i);
+  // Whether the measurements of the last layout are reused, or made here.
+  const bool measured = measured_text_.valid;
+  std::vector<size_t>& newline_positions = measured_text_.newline_positions;
+  if (!measured) {
+    newline_positions.clear();
+    // Discover and add all hard breaks.
+    for (size_t i = 0; i < text_.size(); ++i) {
+      ULineBreak ulb = static_cast<ULineBreak>(
+          u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
+      if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
+        newline_positions.push_back(i);
+    }
+    // Break at the end of the paragraph.
+    newline_positions.push_back(text_.size());
+    measured_text_.char_widths.assign(text_.size(), 0);
+    measured_text_.run_widths.clear();
   }
-  // Break at the end of the paragraph.
-  newline_positions.push_back(text_.size());
+  size_t measured_run_index = 0;
 
   // Calculate and add any breaks due to a line being too long.
   size_t run_index = 0;
@@ -293,6 +302,11 @@ bool ParagraphTxt::ComputeLineBreaks() {
     breaker_.resize(block_size);
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
+    if (measured) {
+      memcpy(breaker_.charWidths(),
+             measured_text_.char_widths.data() + block_start,
+             block_size * sizeof(float));
+    }
     breaker_.setText();
 
     // Add the runs that include this line to the LineBreaker.
@@ -343,11 +357,17 @@ bool ParagraphTxt::ComputeLineBreaks() {
         breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
                              isRtl);
         inline_placeholder_index++;
+      } else if (measured) {
+        // Is a regular text run whose widths were already measured.
+        breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                     run_end, isRtl);
+        block_total_width += measured_text_.run_widths[measured_run_index++];
       } else {
         // Is a regular text run.
         double run_width = breaker_.addStyleRun(&paint, collection, font,
                                                 run_start, run_end, isRtl);
         block_total_width += run_width;
+        measured_text_.run_widths.push_back(run_width);
       }
 
       if (run.end > block_end)
@@ -355,6 +375,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
       run_index++;
     }
     max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (!measured) {
+      memcpy(measured_text_.char_widths.data() + block_start,
+             breaker_.charWidths(), block_size * sizeof(float));
+    }
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
@@ -666,12 +690,17 @@ void ParagraphTxt::Layout(double width) {
 
   width_ = rounded_width;
 
+  // Anything but the width may have changed, so the text is measured again.
+  if (needs_layout_) {
+    measured_text_ = MeasuredText();
+  }
   needs_layout_ = false;
 
   records_.clear();
   glyph_lines_.clear();
   code_unit_runs_.clear();
   inline_placeholder_code_unit_runs_.clear();
+  line_code_unit_run_starts_.clear();
   max_right_ = FLT_MIN;
   min_left_ = FLT_MAX;
   final_line_count_ = 0;
@@ -679,9 +708,13 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (!measured_text_.valid) {
+    measured_text_.bidi_runs.clear();
+    if (!ComputeBidiRuns(&measured_text_.bidi_runs))
+      return;
+    measured_text_.valid = true;
+  }
+  const std::vector<BidiRun>& bidi_runs = measured_text_.bidi_runs;
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -1173,6 +1206,20 @@ void ParagraphTxt::Layout(double width) {
               return a.code_units.start < b.code_units.start;
             });
 
+  // Index the runs by line, so that queries of long paragraphs only look at
+  // the runs of the lines they hit. Lines without runs start where the next
+  // line does.
+  line_code_unit_run_starts_.assign(line_metrics_.size() + 1,
+                                    code_unit_runs_.size());
+  for (size_t i = code_unit_runs_.size(); i-- > 0;) {
+    line_code_unit_run_starts_[code_unit_runs_[i].line_number] = i;
+  }
+  for (size_t line_number = line_metrics_.size(); line_number-- > 0;) {
+    line_code_unit_run_starts_[line_number] =
+        std::min(line_code_unit_run_starts_[line_number],
+                 line_code_unit_run_starts_[line_number + 1]);
+  }
+
   longest_line_ = max_right_ - min_left_;
 }
 
@@ -1629,6 +1676,24 @@ void ParagraphTxt::PaintShadow(SkCanvas* canvas,
   }
 }
 
+size_t ParagraphTxt::GetLineIndexAtOffset(size_t offset) const {
+  // Lines are sorted by code unit index.
+  auto line = std::partition_point(
+      line_metrics_.begin(), line_metrics_.end(),
+      [offset](const LineMetrics& line) {
+        return line.end_including_newline <= offset;
+      });
+  return line - line_metrics_.begin();
+}
+
+Range<size_t> ParagraphTxt::GetCodeUnitRunsOfLine(size_t line_number) const {
+  if (line_number + 1 >= line_code_unit_run_starts_.size()) {
+    return Range<size_t>(code_unit_runs_.size(), code_unit_runs_.size());
+  }
+  return Range<size_t>(line_code_unit_run_starts_[line_number],
+                       line_code_unit_run_starts_[line_number + 1]);
+}
+
 std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
     size_t start,
     size_t end,
@@ -1656,8 +1721,15 @@ std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
   size_t min_line = INT_MAX;
   size_t glyph_length = 0;
 
+  // Lines and runs that end before |start| are skipped, but the runs of the
+  // line of |start| are still visited for the x position of its newline.
+  const size_t first_line = GetLineIndexAtOffset(start);
+  const size_t first_run = GetCodeUnitRunsOfLine(first_line).start;
+
   // Generate initial boxes and calculate metrics.
-  for (const CodeUnitRun& run : code_unit_runs_) {
+  for (size_t run_index = first_run; run_index < code_unit_runs_.size();
+       ++run_index) {
+    const CodeUnitRun& run = code_unit_runs_[run_index];
     // Check to see if we are finished.
     if (run.code_units.start >= end)
       break;
@@ -1726,7 +1798,7 @@ std::vector<Paragraph::TextBox> ParagraphTxt::GetRectsForRange(
 
   // Add empty rectangles representing any newline characters within the
   // range.
-  for (size_t line_number = 0; line_number < line_metrics_.size();
+  for (size_t line_number = first_line; line_number < line_metrics_.size();
        ++line_number) {
     LineMetrics& line = line_metrics_[line_number];
     if (line.start_index >= end)
@@ -1856,20 +1928,21 @@ Paragraph::PositionWithAffinity ParagraphTxt::GetGlyphPositionAtCoordinate(
   if (final_line_count_ <= 0)
     return PositionWithAffinity(0, DOWNSTREAM);
 
-  size_t y_index;
-  for (y_index = 0; y_index < final_line_count_ - 1; ++y_index) {
-    if (dy < line_metrics_[y_index].height)
-      break;
-  }
+  // Lines are sorted by their bottom. Coordinates below the last line hit it.
+  const size_t y_index =
+      std::upper_bound(line_metrics_.begin(),
+                       line_metrics_.begin() + (final_line_count_ - 1), dy,
+                       [](double dy, const LineMetrics& line) {
+                         return dy < line.height;
+                       }) -
+      line_metrics_.begin();
 
   const std::vector<GlyphPosition>& line_glyph_position =
       glyph_lines_[y_index].positions;
   if (line_glyph_position.empty()) {
-    int line_start_index =
-        std::accumulate(glyph_lines_.begin(), glyph_lines_.begin() + y_index, 0,
-                        [](const int a, const GlyphLine& b) {
-                          return a + static_cast<int>(b.total_code_units);
-                        });
+    // Glyph lines hold the code units up to the start of the next line.
+    int line_start_index = static_cast<int>(
+        line_metrics_[y_index].start_index - line_metrics_[0].start_index);
     return PositionWithAffinity(line_start_index, DOWNSTREAM);
   }
 
@@ -1908,7 +1981,10 @@ Paragraph::PositionWithAffinity ParagraphTxt::GetGlyphPositionAtCoordinate(
 
   // Find the direction of the run that contains this glyph.
   TextDirection direction = TextDirection::ltr;
-  for (const CodeUnitRun& run : code_unit_runs_) {
+  const Range<size_t> line_runs = GetCodeUnitRunsOfLine(y_index);
+  for (size_t run_index = line_runs.start; run_index < line_runs.end;
+       ++run_index) {
+    const CodeUnitRun& run = code_unit_runs_[run_index];
     if (gp->code_units.start >= run.code_units.start &&
         gp->code_units.end <= run.code_units.end) {
       direction = run.direction;
@@ -1976,18 +2052,17 @@ Paragraph::Range<size_t> ParagraphTxt::GetWordBoundary(size_t offset) {
   if (text_.size() == 0)
     return Range<size_t>(0, 0);
 
-  if (!word_breaker_) {
-    UErrorCode status = U_ZERO_ERROR;
-    word_breaker_.reset(
-        icu::BreakIterator::createWordInstance(icu::Locale(), status));
-    if (!U_SUCCESS(status))
-      return Range<size_t>(0, 0);
-  }
+  minikin::BreakIteratorPool::Iterator word_breaker =
+      minikin::BreakIteratorPool::acquire(
+          minikin::BreakIteratorPool::Kind::kWord, icu::Locale());
+  if (!word_breaker)
+    return Range<size_t>(0, 0);
 
-  word_breaker_->setText(icu::UnicodeString(false, text_.data(), text_.size()));
+  icu::UnicodeString text(false, text_.data(), text_.size());
+  word_breaker->setText(text);
 
-  int32_t prev_boundary = word_breaker_->preceding(offset + 1);
-  int32_t next_boundary = word_breaker_->next();
+  int32_t prev_boundary = word_breaker->preceding(offset + 1);
+  int32_t next_boundary = word_breaker->next();
   if (prev_boundary == icu::BreakIterator::DONE)
     prev_boundary = offset;
   if (next_boundary == icu::BreakIterator::DONE)
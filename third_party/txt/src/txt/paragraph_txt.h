@@ -163,6 +163,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, RelayoutAtAnotherWidthMatchesFreshLayout);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -183,7 +184,6 @@ class ParagraphTxt : public Paragraph {
   std::shared_ptr<FontCollection> font_collection_;
 
   minikin::LineBreaker breaker_;
-  mutable std::unique_ptr<icu::BreakIterator> word_breaker_;
 
   std::vector<LineMetrics> line_metrics_;
   size_t final_line_count_;
@@ -312,6 +312,19 @@ class ParagraphTxt : public Paragraph {
   std::vector<CodeUnitRun> code_unit_runs_;
   // Holds the positions of the inline placeholders.
   std::vector<CodeUnitRun> inline_placeholder_code_unit_runs_;
+  // The index into |code_unit_runs_| of the first run of each line, followed
+  // by the number of runs. As lines hold consecutive ranges of code units, the
+  // runs of a line are consecutive too, from the first run of the line to the
+  // first run of the next one.
+  std::vector<size_t> line_code_unit_run_starts_;
+
+  // Returns the index of the first line that ends, including its newline,
+  // after the code unit at |offset|, or the number of lines if there is none.
+  size_t GetLineIndexAtOffset(size_t offset) const;
+
+  // Returns the range of |code_unit_runs_| that holds the runs of the line at
+  // |line_number|.
+  Range<size_t> GetCodeUnitRunsOfLine(size_t line_number) const;
 
   // The max width of the paragraph as provided in the most recent Layout()
   // call.
@@ -324,6 +337,21 @@ class ParagraphTxt : public Paragraph {
 
   bool needs_layout_ = true;
 
+  // What the last layout measured of the text, which doesn't depend on the
+  // width, so that laying the same text out at another width only breaks and
+  // positions its lines again. Dropped when the paragraph changes.
+  struct MeasuredText {
+    bool valid = false;
+    // The positions of the hard breaks, ending with the end of the text.
+    std::vector<size_t> newline_positions;
+    // The width of each code unit of the text.
+    std::vector<float> char_widths;
+    // The width of each text run as it was added to the line breaker.
+    std::vector<double> run_widths;
+    std::vector<BidiRun> bidi_runs;
+  };
+  MeasuredText measured_text_;
+
   struct WaveCoordinates {
     double x_start;
     double y_start;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <minikin/BreakIteratorPool.h>
+#include <minikin/WordBreaker.h>
+
+namespace minikin {
+
+TEST(BreakIteratorPoolTest, reusesReleasedIterators) {
+  BreakIteratorPool::purge();
+  icu::BreakIterator* line = nullptr;
+  {
+    BreakIteratorPool::Iterator iterator = BreakIteratorPool::acquire(
+        BreakIteratorPool::Kind::kLine, icu::Locale::getUS());
+    ASSERT_TRUE(iterator);
+    line = iterator.get();
+    EXPECT_EQ(0u, BreakIteratorPool::getPooledCount());
+  }
+  EXPECT_EQ(1u, BreakIteratorPool::getPooledCount());
+
+  // Only iterators of the same kind and for the same locale are reused.
+  BreakIteratorPool::Iterator word = BreakIteratorPool::acquire(
+      BreakIteratorPool::Kind::kWord, icu::Locale::getUS());
+  BreakIteratorPool::Iterator french = BreakIteratorPool::acquire(
+      BreakIteratorPool::Kind::kLine, icu::Locale::getFrance());
+  EXPECT_NE(line, word.get());
+  EXPECT_NE(line, french.get());
+  EXPECT_EQ(1u, BreakIteratorPool::getPooledCount());
+
+  BreakIteratorPool::Iterator us = BreakIteratorPool::acquire(
+      BreakIteratorPool::Kind::kLine, icu::Locale::getUS());
+  EXPECT_EQ(line, us.get());
+  EXPECT_EQ(0u, BreakIteratorPool::getPooledCount());
+  BreakIteratorPool::purge();
+}
+
+TEST(BreakIteratorPoolTest, wordBreakerHoldsAnIteratorWhileItHasText) {
+  BreakIteratorPool::purge();
+  const uint16_t kText[] = {'h', 'i', ' ', 'y', 'o', 'u'};
+  WordBreaker breaker;
+  breaker.setLocale(icu::Locale::getUS());
+  for (int i = 0; i < 3; i++) {
+    breaker.setText(kText, 6);
+    EXPECT_EQ(0u, BreakIteratorPool::getPooledCount());
+    EXPECT_EQ(3, breaker.next());
+    EXPECT_EQ(6, breaker.next());
+    breaker.finish();
+    EXPECT_EQ(1u, BreakIteratorPool::getPooledCount());
+  }
+  BreakIteratorPool::purge();
+}
+
+}  // namespace minikin
@@ -33,12 +33,12 @@ namespace minikin {
 class HbFontCacheTest : public testing::Test {
  public:
   virtual void TearDown() {
-    std::scoped_lock _l(gMinikinLock);
-    purgeHbFontCacheLocked();
+    purgeHbFontCache();
+    setHbFontCacheMaxBytes(8 * 1024 * 1024);
   }
 };
 
-TEST_F(HbFontCacheTest, getHbFontLockedTest) {
+TEST_F(HbFontCacheTest, getHbFontTest) {
   std::shared_ptr<MinikinFontForTest> fontA(
       new MinikinFontForTest(kTestFontDir "Regular.ttf"));
 
@@ -48,31 +48,29 @@ TEST_F(HbFontCacheTest, getHbFontLockedTest) {
   std::shared_ptr<MinikinFontForTest> fontC(
       new MinikinFontForTest(kTestFontDir "BoldItalic.ttf"));
 
-  std::scoped_lock _l(gMinikinLock);
   // Never return NULL.
-  EXPECT_NE(nullptr, getHbFontLocked(fontA.get()));
-  EXPECT_NE(nullptr, getHbFontLocked(fontB.get()));
-  EXPECT_NE(nullptr, getHbFontLocked(fontC.get()));
+  EXPECT_NE(nullptr, getHbFont(fontA.get()));
+  EXPECT_NE(nullptr, getHbFont(fontB.get()));
+  EXPECT_NE(nullptr, getHbFont(fontC.get()));
 
-  EXPECT_NE(nullptr, getHbFontLocked(nullptr));
+  EXPECT_NE(nullptr, getHbFont(nullptr));
 
   // Must return same object if same font object is passed.
-  EXPECT_EQ(getHbFontLocked(fontA.get()), getHbFontLocked(fontA.get()));
-  EXPECT_EQ(getHbFontLocked(fontB.get()), getHbFontLocked(fontB.get()));
-  EXPECT_EQ(getHbFontLocked(fontC.get()), getHbFontLocked(fontC.get()));
+  EXPECT_EQ(getHbFont(fontA.get()), getHbFont(fontA.get()));
+  EXPECT_EQ(getHbFont(fontB.get()), getHbFont(fontB.get()));
+  EXPECT_EQ(getHbFont(fontC.get()), getHbFont(fontC.get()));
 
   // Different object must be returned if the passed minikinFont has different
   // ID.
-  EXPECT_NE(getHbFontLocked(fontA.get()), getHbFontLocked(fontB.get()));
-  EXPECT_NE(getHbFontLocked(fontA.get()), getHbFontLocked(fontC.get()));
+  EXPECT_NE(getHbFont(fontA.get()), getHbFont(fontB.get()));
+  EXPECT_NE(getHbFont(fontA.get()), getHbFont(fontC.get()));
 }
 
 TEST_F(HbFontCacheTest, purgeCacheTest) {
   std::shared_ptr<MinikinFontForTest> minikinFont(
       new MinikinFontForTest(kTestFontDir "Regular.ttf"));
 
-  std::scoped_lock _l(gMinikinLock);
-  hb_font_t* font = getHbFontLocked(minikinFont.get());
+  hb_font_t* font = getHbFont(minikinFont.get());
   ASSERT_NE(nullptr, font);
 
   // Set user data to identify the font object.
@@ -81,13 +79,46 @@ TEST_F(HbFontCacheTest, purgeCacheTest) {
   hb_font_set_user_data(font, &key, data, NULL, false);
   ASSERT_EQ(data, hb_font_get_user_data(font, &key));
 
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
 
   // By checking user data, confirm that the object after purge is different
   // from previously created one. Do not compare the returned pointer here since
   // memory allocator may assign same region for new object.
-  font = getHbFontLocked(minikinFont.get());
+  font = getHbFont(minikinFont.get());
   EXPECT_EQ(nullptr, hb_font_get_user_data(font, &key));
 }
 
+TEST_F(HbFontCacheTest, evictsLeastRecentlyUsedFontsBeyondMaxBytes) {
+  std::shared_ptr<MinikinFontForTest> fontA(
+      new MinikinFontForTest(kTestFontDir "Regular.ttf"));
+  std::shared_ptr<MinikinFontForTest> fontB(
+      new MinikinFontForTest(kTestFontDir "Bold.ttf"));
+  std::shared_ptr<MinikinFontForTest> fontC(
+      new MinikinFontForTest(kTestFontDir "BoldItalic.ttf"));
+
+  // Test fonts don't report the size of their faces, so this fits two fonts.
+  setHbFontCacheMaxBytes(10 * 1024);
+
+  hb_user_data_key_t key;
+  void* data = (void*)0xdeadbeef;
+  hb_font_t* fontAHb = getHbFont(fontA.get());
+  hb_font_set_user_data(fontAHb, &key, data, NULL, false);
+  hb_font_destroy(fontAHb);
+  hb_font_t* fontBHb = getHbFont(fontB.get());
+  hb_font_set_user_data(fontBHb, &key, data, NULL, false);
+  hb_font_destroy(fontBHb);
+
+  // A is used again, so B is evicted.
+  fontAHb = getHbFont(fontA.get());
+  hb_font_destroy(fontAHb);
+  hb_font_destroy(getHbFont(fontC.get()));
+
+  fontAHb = getHbFont(fontA.get());
+  EXPECT_EQ(data, hb_font_get_user_data(fontAHb, &key));
+  hb_font_destroy(fontAHb);
+  fontBHb = getHbFont(fontB.get());
+  EXPECT_EQ(nullptr, hb_font_get_user_data(fontBHb, &key));
+  hb_font_destroy(fontBHb);
+}
+
 }  // namespace minikin
@@ -65,6 +65,29 @@ TEST_F(HyphenatorTest, usEnglishAutomaticHyphenation) {
   EXPECT_EQ(HyphenationType::DONT_BREAK, result[4]);
 }
 
+// Hyphenators loaded from the same file share its mapping.
+TEST_F(HyphenatorTest, loadFileSharesPatterns) {
+  Hyphenator* hyphenator = Hyphenator::loadFile(usHyph, 2, 3);
+  Hyphenator* other_hyphenator = Hyphenator::loadFile(usHyph, 2, 3);
+  const uint16_t word[] = {'t', 'a', 'b', 'l', 'e'};
+  std::vector<HyphenationType> result;
+  std::vector<HyphenationType> other_result;
+  hyphenator->hyphenate(&result, word, NELEM(word), usLocale);
+  other_hyphenator->hyphenate(&other_result, word, NELEM(word), usLocale);
+  ASSERT_EQ((size_t)5, result.size());
+  EXPECT_EQ(HyphenationType::BREAK_AND_INSERT_HYPHEN, result[2]);
+  EXPECT_EQ(result, other_result);
+
+  // Files that can't be mapped only process soft hyphens.
+  Hyphenator* missing_hyphenator =
+      Hyphenator::loadFile("/does/not/exist.hyb", 2, 2);
+  const uint16_t soft_hyphen_word[] = {'t', 'a', SOFT_HYPHEN, 'b', 'l', 'e'};
+  missing_hyphenator->hyphenate(&result, soft_hyphen_word,
+                                NELEM(soft_hyphen_word), usLocale);
+  ASSERT_EQ((size_t)6, result.size());
+  EXPECT_EQ(HyphenationType::BREAK_AND_INSERT_HYPHEN, result[3]);
+}
+
 // Catalan l·l should break as l-/l
 TEST_F(HyphenatorTest, catalanMiddleDot) {
   Hyphenator* hyphenator = Hyphenator::loadBinary(nullptr, 2, 2);
@@ -51,4 +51,19 @@ TEST(SparseBitSetTest, randomTest) {
   }
 }
 
+TEST(SparseBitSetTest, countCoveredPrefix) {
+  const uint32_t kRanges[] = {'a', 'z' + 1, 0x4E00, 0x4E10, 0x1F600, 0x1F650};
+  SparseBitSet bitset(kRanges, 3);
+
+  const uint16_t kText[] = {'a', 'b', 0x4E00, 'c', ' ', 'd'};
+  EXPECT_EQ(4u, bitset.countCoveredPrefix(kText, 6));
+  EXPECT_EQ(2u, bitset.countCoveredPrefix(kText, 2));
+  EXPECT_EQ(0u, bitset.countCoveredPrefix(kText + 4, 2));
+  EXPECT_EQ(0u, bitset.countCoveredPrefix(kText, 0));
+
+  // U+1F600 is in the set, but only characters in the BMP are counted.
+  const uint16_t kSurrogates[] = {'a', 0xD83D, 0xDE00};
+  EXPECT_EQ(1u, bitset.countCoveredPrefix(kSurrogates, 3));
+}
+
 }  // namespace minikin
@@ -17,7 +17,10 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/logging.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "txt/asset_font_manager.h"
 #include "txt/font_collection.h"
+#include "txt/font_fallback_cache.h"
 #include "txt_test_utils.h"
 
 namespace txt {
@@ -99,4 +102,57 @@ TEST(FontCollection, GetFamilyNames) {
 
 #endif  // 0
 
+TEST(FontFallbackCache, KeysByManagerCodePointLocaleAndStyle) {
+  FontFallbackCache cache;
+  sk_sp<SkFontMgr> manager = sk_make_sp<DynamicFontManager>();
+  sk_sp<SkFontMgr> other_manager = sk_make_sp<DynamicFontManager>();
+  const SkFontStyle style;
+  cache.Insert(manager, 0x1F600, "en", style, "Emoji");
+  cache.Insert(manager, 0x4E00, "ja", style, "");
+
+  std::string family_name;
+  ASSERT_TRUE(cache.Lookup(manager, 0x1F600, "en", style, &family_name));
+  EXPECT_EQ(family_name, "Emoji");
+  // Remembers that nothing matched.
+  ASSERT_TRUE(cache.Lookup(manager, 0x4E00, "ja", style, &family_name));
+  EXPECT_EQ(family_name, "");
+
+  EXPECT_FALSE(cache.Lookup(other_manager, 0x1F600, "en", style, &family_name));
+  EXPECT_FALSE(cache.Lookup(manager, 0x1F601, "en", style, &family_name));
+  EXPECT_FALSE(cache.Lookup(manager, 0x1F600, "fr", style, &family_name));
+  EXPECT_FALSE(cache.Lookup(manager, 0x1F600, "en", SkFontStyle::Bold(),
+                            &family_name));
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Lookup(manager, 0x1F600, "en", style, &family_name));
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+}
+
+TEST(RemainderFontManager, MatchesRemaindersByCharacter) {
+  auto font_provider = std::make_unique<TypefaceFontAssetProvider>();
+  font_provider->RegisterTypeface(
+      SkTypeface::MakeFromFile((GetFontDir() + "/HomemadeApple.ttf").c_str()),
+      "Remainder");
+  sk_sp<SkFontMgr> manager =
+      sk_make_sp<RemainderFontManager>(std::move(font_provider));
+
+  // Characters that no remainder holds are not matched.
+  EXPECT_EQ(manager->matchFamilyStyleCharacter(nullptr, SkFontStyle(), nullptr,
+                                               0, 0x4E00),
+            nullptr);
+
+  sk_sp<SkTypeface> typeface(manager->matchFamilyStyleCharacter(
+      nullptr, SkFontStyle(), nullptr, 0, 'a'));
+  ASSERT_NE(typeface, nullptr);
+
+  // Fallback fonts are looked up by the family name of the matched typeface.
+  SkString family_name;
+  typeface->getFamilyName(&family_name);
+  sk_sp<SkFontStyleSet> font_style_set(
+      manager->matchFamily(family_name.c_str()));
+  ASSERT_NE(font_style_set, nullptr);
+  EXPECT_EQ(font_style_set->count(), 1);
+}
+
 }  // namespace txt
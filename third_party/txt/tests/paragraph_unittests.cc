@@ -15,8 +15,11 @@
  */
 
 #include <iostream>
+#include <iterator>
+#include <thread>
 
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -6483,4 +6486,149 @@ TEST_F(ParagraphTest, TextHeightBehaviorRectsParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, ConcurrentLayoutMatchesSequentialLayout) {
+  const char* texts[] = {
+      "Hello World Text Dialog",
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line.",
+      "\xD7\xA9\xD7\x9C\xD7\x95\xD7\x9D world",
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit.",
+  };
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  auto build_paragraph = [&](const char* text) {
+    auto icu_text = icu::UnicodeString::fromUTF8(text);
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  std::vector<std::unique_ptr<ParagraphTxt>> expected;
+  for (const char* text : texts) {
+    expected.push_back(build_paragraph(text));
+    expected.back()->Layout(200);
+  }
+  minikin::Layout::purgeCaches();
+
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kParagraphsPerThread = 20;
+  std::vector<std::unique_ptr<ParagraphTxt>> paragraphs;
+  for (size_t i = 0; i < kThreadCount * kParagraphsPerThread; i++) {
+    paragraphs.push_back(build_paragraph(texts[i % std::size(texts)]));
+  }
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&paragraphs, i]() {
+      for (size_t j = i; j < paragraphs.size(); j += kThreadCount) {
+        paragraphs[j]->Layout(200);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < paragraphs.size(); i++) {
+    ParagraphTxt& paragraph = *expected[i % std::size(texts)];
+    EXPECT_EQ(paragraphs[i]->GetHeight(), paragraph.GetHeight());
+    EXPECT_EQ(paragraphs[i]->GetLongestLine(), paragraph.GetLongestLine());
+    EXPECT_EQ(paragraphs[i]->GetMinIntrinsicWidth(),
+              paragraph.GetMinIntrinsicWidth());
+    EXPECT_EQ(paragraphs[i]->GetMaxIntrinsicWidth(),
+              paragraph.GetMaxIntrinsicWidth());
+  }
+}
+
+
+TEST_F(ParagraphTest, RelayoutAtAnotherWidthMatchesFreshLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line.\nSometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  txt::ParagraphStyle paragraph_style;
+  paragraph_style.text_align = TextAlign::justify;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build_paragraph();
+  for (double width : {200.0, 500.0, 120.0, 200.0}) {
+    paragraph->Layout(width);
+    ASSERT_TRUE(paragraph->measured_text_.valid);
+    auto fresh = build_paragraph();
+    fresh->Layout(width);
+
+    EXPECT_EQ(paragraph->GetHeight(), fresh->GetHeight());
+    EXPECT_EQ(paragraph->GetLongestLine(), fresh->GetLongestLine());
+    EXPECT_EQ(paragraph->GetMaxIntrinsicWidth(), fresh->GetMaxIntrinsicWidth());
+    EXPECT_EQ(paragraph->GetMinIntrinsicWidth(), fresh->GetMinIntrinsicWidth());
+    ASSERT_EQ(paragraph->line_metrics_.size(), fresh->line_metrics_.size());
+    for (size_t i = 0; i < fresh->line_metrics_.size(); i++) {
+      EXPECT_EQ(paragraph->line_metrics_[i].end_index,
+                fresh->line_metrics_[i].end_index);
+      EXPECT_EQ(paragraph->line_metrics_[i].width,
+                fresh->line_metrics_[i].width);
+    }
+    ASSERT_EQ(paragraph->glyph_lines_.size(), fresh->glyph_lines_.size());
+  }
+}
+
+TEST_F(ParagraphTest, WordsInTheSameFontMatchAcrossFontFamilyLists) {
+  const char* text = "Name Price Quantity Name Price";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  txt::ParagraphStyle paragraph_style;
+  auto build_paragraph = [&](std::vector<std::string> font_families) {
+    txt::TextStyle text_style;
+    text_style.font_families = std::move(font_families);
+    text_style.font_size = 26;
+    text_style.color = SK_ColorBLACK;
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(GetTestCanvasWidth());
+    return paragraph;
+  };
+
+  // Roboto has all of the characters, so both lists lay the words out in it,
+  // though with different minikin font collections.
+  auto roboto = build_paragraph({"Roboto"});
+  auto roboto_first = build_paragraph({"Roboto", "Homemade Apple"});
+
+  EXPECT_EQ(roboto->GetMaxIntrinsicWidth(),
+            roboto_first->GetMaxIntrinsicWidth());
+  for (size_t i = 0; i < u16_text.length(); i++) {
+    std::vector<txt::Paragraph::TextBox> boxes = roboto->GetRectsForRange(
+        i, i + 1, Paragraph::RectHeightStyle::kTight,
+        Paragraph::RectWidthStyle::kTight);
+    std::vector<txt::Paragraph::TextBox> other_boxes =
+        roboto_first->GetRectsForRange(i, i + 1,
+                                       Paragraph::RectHeightStyle::kTight,
+                                       Paragraph::RectWidthStyle::kTight);
+    ASSERT_EQ(boxes.size(), other_boxes.size());
+    for (size_t j = 0; j < boxes.size(); j++) {
+      EXPECT_EQ(boxes[j].rect, other_boxes[j].rect);
+    }
+  }
+}
+
 }  // namespace txt
@@ -33,7 +33,9 @@ hb_codepoint_t ParseCodepoint(const std::string& arg) {
 
 void Usage() {
   std::cout << "Usage:" << std::endl;
-  std::cout << "font-subset <output.ttf> <input.ttf>" << std::endl;
+  std::cout << "font-subset [--remainder=<remainder.ttf>] <output.ttf> "
+               "<input.ttf>"
+            << std::endl;
   std::cout << std::endl;
   std::cout << "The output.ttf file will be overwritten if it exists already "
                "and the subsetting operation succeeds."
@@ -47,9 +49,74 @@ void Usage() {
       << "This program will de-duplicate codepoints if the same codepoint is "
          "specified multiple times, e.g. '123 123' will be treated as '123'."
       << std::endl;
+  std::cout << std::endl;
+  std::cout << "With --remainder, the codepoints of the input font that were "
+               "not specified are written to remainder.ttf, and codepoints "
+               "that are not in the input font are skipped instead of "
+               "failing. This is meant for text fonts subset to the "
+               "characters of the locales of an app, whose font manifest "
+               "entries name the remainder as well, e.g. "
+               "{\"asset\": \"output.ttf\", \"remainder\": "
+               "\"remainder.ttf\"}, so that it is only loaded when text "
+               "needs a character that the subset lacks."
+            << std::endl;
+}
+
+// Subsets |font_face| to |codepoints| and writes the result to
+// |output_file_path|.
+int WriteSubset(hb_face_t* font_face,
+                hb_set_t* codepoints,
+                const std::string& output_file_path) {
+  HarfbuzzWrappers::HbSubsetInputPtr input(hb_subset_input_create_or_fail());
+  hb_set_union(hb_subset_input_unicode_set(input.get()), codepoints);
+
+  HarfbuzzWrappers::HbFacePtr new_face(hb_subset(font_face, input.get()));
+
+  if (new_face.get() == hb_face_get_empty()) {
+    std::cerr << "Failed to subset font; aborting." << std::endl;
+    return -1;
+  }
+
+  HarfbuzzWrappers::HbBlobPtr result(hb_face_reference_blob(new_face.get()));
+  if (!hb_blob_get_length(result.get())) {
+    std::cerr << "Failed get new font bytes; aborting" << std::endl;
+    return -1;
+  }
+
+  unsigned int data_length;
+  const char* data = hb_blob_get_data(result.get(), &data_length);
+
+  std::ofstream output_font_file;
+  output_font_file.open(output_file_path,
+                        std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!output_font_file.is_open()) {
+    std::cerr << "Failed to open output file '" << output_file_path
+              << "'. The parent directory may not exist, or the user does not "
+                 "have permission to create this file."
+              << std::endl;
+    return -1;
+  }
+  output_font_file.write(data, data_length);
+  output_font_file.flush();
+  output_font_file.close();
+
+  std::cout << "Wrote " << data_length << " bytes to " << output_file_path
+            << std::endl;
+  return 0;
 }
 
 int main(int argc, char** argv) {
+  const std::string remainder_flag("--remainder=");
+  std::string remainder_file_path;
+  if (argc > 1 && std::string(argv[1]).rfind(remainder_flag, 0) == 0) {
+    remainder_file_path = std::string(argv[1]).substr(remainder_flag.size());
+    if (remainder_file_path.empty()) {
+      Usage();
+      return -1;
+    }
+    argc--;
+    argv++;
+  }
   if (argc != 3) {
     Usage();
     return -1;
@@ -58,6 +125,9 @@ int main(int argc, char** argv) {
   std::string input_file_path(argv[2]);
   std::cout << "Using output file: " << output_file_path << std::endl;
   std::cout << "Using source file: " << input_file_path << std::endl;
+  if (!remainder_file_path.empty()) {
+    std::cout << "Using remainder file: " << remainder_file_path << std::endl;
+  }
 
   HarfbuzzWrappers::HbBlobPtr font_blob(
       hb_blob_create_from_file(input_file_path.c_str()));
@@ -74,63 +144,44 @@ int main(int argc, char** argv) {
     return -1;
   }
 
-  HarfbuzzWrappers::HbSubsetInputPtr input(hb_subset_input_create_or_fail());
-  {
-    hb_set_t* desired_codepoints = hb_subset_input_unicode_set(input.get());
-    HarfbuzzWrappers::HbSetPtr actual_codepoints(hb_set_create());
-    hb_face_collect_unicodes(font_face.get(), actual_codepoints.get());
-    std::string raw_codepoint;
-    while (std::cin >> raw_codepoint) {
-      auto codepoint = ParseCodepoint(raw_codepoint);
-      if (!codepoint) {
-        std::cerr << "Invalid codepoint for " << raw_codepoint << "; exiting."
-                  << std::endl;
-        return -1;
-      }
-      if (!hb_set_has(actual_codepoints.get(), codepoint)) {
-        std::cerr << "Codepoint " << raw_codepoint
-                  << " not found in font, aborting." << std::endl;
-        return -1;
-      }
-      hb_set_add(desired_codepoints, codepoint);
+  HarfbuzzWrappers::HbSetPtr desired_codepoints(hb_set_create());
+  HarfbuzzWrappers::HbSetPtr actual_codepoints(hb_set_create());
+  hb_face_collect_unicodes(font_face.get(), actual_codepoints.get());
+  std::string raw_codepoint;
+  while (std::cin >> raw_codepoint) {
+    auto codepoint = ParseCodepoint(raw_codepoint);
+    if (!codepoint) {
+      std::cerr << "Invalid codepoint for " << raw_codepoint << "; exiting."
+                << std::endl;
+      return -1;
     }
-    if (hb_set_is_empty(desired_codepoints)) {
-      std::cerr << "No codepoints specified, exiting." << std::endl;
+    if (!hb_set_has(actual_codepoints.get(), codepoint)) {
+      // The characters of a locale are not all expected to be in a text font.
+      if (!remainder_file_path.empty()) {
+        continue;
+      }
+      std::cerr << "Codepoint " << raw_codepoint
+                << " not found in font, aborting." << std::endl;
       return -1;
     }
+    hb_set_add(desired_codepoints.get(), codepoint);
   }
-
-  HarfbuzzWrappers::HbFacePtr new_face(hb_subset(font_face.get(), input.get()));
-
-  if (new_face.get() == hb_face_get_empty()) {
-    std::cerr << "Failed to subset font; aborting." << std::endl;
+  if (hb_set_is_empty(desired_codepoints.get())) {
+    std::cerr << "No codepoints specified, exiting." << std::endl;
     return -1;
   }
 
-  HarfbuzzWrappers::HbBlobPtr result(hb_face_reference_blob(new_face.get()));
-  if (!hb_blob_get_length(result.get())) {
-    std::cerr << "Failed get new font bytes; aborting" << std::endl;
+  if (WriteSubset(font_face.get(), desired_codepoints.get(),
+                  output_file_path) != 0) {
     return -1;
   }
 
-  unsigned int data_length;
-  const char* data = hb_blob_get_data(result.get(), &data_length);
-
-  std::ofstream output_font_file;
-  output_font_file.open(output_file_path,
-                        std::ios::out | std::ios::trunc | std::ios::binary);
-  if (!output_font_file.is_open()) {
-    std::cerr << "Failed to open output file '" << output_file_path
-              << "'. The parent directory may not exist, or the user does not "
-                 "have permission to create this file."
-              << std::endl;
-    return -1;
+  if (!remainder_file_path.empty()) {
+    hb_set_subtract(actual_codepoints.get(), desired_codepoints.get());
+    if (WriteSubset(font_face.get(), actual_codepoints.get(),
+                    remainder_file_path) != 0) {
+      return -1;
+    }
   }
-  output_font_file.write(data, data_length);
-  output_font_file.flush();
-  output_font_file.close();
-
-  std::cout << "Wrote " << data_length << " bytes to " << output_file_path
-            << std::endl;
   return 0;
 }
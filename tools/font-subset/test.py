@@ -35,6 +35,13 @@ COMPARE_TESTS = (
   (True,  '3.ttf', MATERIAL_TTF, [r'0xE003', r'0xE004', r'0xE021',]),
 )
 
+# The subset is the same with --remainder, which skips codepoints that are not
+# in the font.
+REMAINDER_TESTS = (
+  ('1.ttf', MATERIAL_TTF, [r'0xE003']),
+  ('2.ttf', MATERIAL_TTF, [r'0xE003', r'0x12', r'0xE004']), # codepoint not in font
+)
+
 FAIL_TESTS = [
   ([FONT_SUBSET, 'output.ttf', 'does-not-exist.ttf'], ['1',]), # non-existant input font
   ([FONT_SUBSET, 'output.ttf', MATERIAL_TTF], ['0xFFFFFFFF',]), # Value too big.
@@ -45,6 +52,8 @@ FAIL_TESTS = [
   ([FONT_SUBSET, 'output.ttf', MATERIAL_TTF], [' ',]), # empty input
   ([FONT_SUBSET, 'output.ttf', MATERIAL_TTF], []), # empty input
   ([FONT_SUBSET, 'output.ttf', MATERIAL_TTF], ['']), # empty input
+  ([FONT_SUBSET, '--remainder=', 'output.ttf', MATERIAL_TTF], ['0xE003',]), # no remainder file
+  ([FONT_SUBSET, '--remainder=remainder.ttf', 'output.ttf', MATERIAL_TTF], ['0x12',]), # no codepoints in font
 ]
 
 def RunCmd(cmd, codepoints, fail=False):
@@ -90,6 +99,23 @@ def main():
       print('Test case %s failed.' % cmd)
       failures += 1
 
+  for golden_font, input_font, codepoints in REMAINDER_TESTS:
+    gen_ttf = os.path.join(SCRIPT_DIR, 'gen', golden_font)
+    gen_remainder_ttf = os.path.join(SCRIPT_DIR, 'gen', 'remainder-' + golden_font)
+    golden_ttf = os.path.join(SCRIPT_DIR, 'fixtures', golden_font)
+    cmd = [FONT_SUBSET, '--remainder=%s' % gen_remainder_ttf, gen_ttf, input_font]
+    if RunCmd(cmd, codepoints) != 0:
+      failures += 1
+      continue
+    if not filecmp.cmp(gen_ttf, golden_ttf, shallow=False):
+      print('Test case %s failed.' % cmd)
+      failures += 1
+    # The remainder holds the other codepoints of the font, so it is larger
+    # than the subset.
+    if os.path.getsize(gen_remainder_ttf) <= os.path.getsize(gen_ttf):
+      print('Test case %s failed: remainder too small.' % cmd)
+      failures += 1
+
   with open(os.devnull, 'w') as devnull:
     for cmd, codepoints in FAIL_TESTS:
       if RunCmd(cmd, codepoints, fail=True) == 0:
@@ -80,4 +80,16 @@ bool VulkanCommandBuffer::InsertPipelineBarrier(
   return true;
 }
 
+void VulkanCommandBuffer::ResetQueryPool(VkQueryPool query_pool,
+                                         uint32_t first_query,
+                                         uint32_t query_count) const {
+  vk.CmdResetQueryPool(handle_, query_pool, first_query, query_count);
+}
+
+void VulkanCommandBuffer::WriteTimestamp(VkPipelineStageFlagBits pipeline_stage,
+                                         VkQueryPool query_pool,
+                                         uint32_t query) const {
+  vk.CmdWriteTimestamp(handle_, pipeline_stage, query_pool, query);
+}
+
 }  // namespace vulkan
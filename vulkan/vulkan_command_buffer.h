@@ -40,6 +40,18 @@ class VulkanCommandBuffer {
       uint32_t image_memory_barrier_count,
       const VkImageMemoryBarrier* image_memory_barriers) const;
 
+  // Resets |query_count| queries of |query_pool| starting at |first_query| so
+  // that they can be written again.
+  void ResetQueryPool(VkQueryPool query_pool,
+                      uint32_t first_query,
+                      uint32_t query_count) const;
+
+  // Writes the device timestamp into the |query| of |query_pool| once all
+  // previously submitted commands have completed |pipeline_stage|.
+  void WriteTimestamp(VkPipelineStageFlagBits pipeline_stage,
+                      VkQueryPool query_pool,
+                      uint32_t query) const;
+
  private:
   const VulkanProcTable& vk;
   const VulkanHandle<VkDevice>& device_;
@@ -226,6 +226,36 @@ bool VulkanDevice::GetPhysicalDeviceFeatures(
   return true;
 }
 
+bool VulkanDevice::GetPhysicalDeviceProperties(
+    VkPhysicalDeviceProperties* properties) const {
+  if (properties == nullptr || !physical_device_) {
+    return false;
+  }
+  vk.GetPhysicalDeviceProperties(physical_device_, properties);
+  return true;
+}
+
+bool VulkanDevice::GetTimestampPeriod(float* period) const {
+  if (period == nullptr || !physical_device_) {
+    return false;
+  }
+
+  auto queue_families = GetQueueFamilyProperties();
+  if (graphics_queue_index_ >= queue_families.size() ||
+      queue_families[graphics_queue_index_].timestampValidBits == 0) {
+    return false;
+  }
+
+  VkPhysicalDeviceProperties properties;
+  vk.GetPhysicalDeviceProperties(physical_device_, &properties);
+  if (properties.limits.timestampPeriod <= 0.0f) {
+    return false;
+  }
+
+  *period = properties.limits.timestampPeriod;
+  return true;
+}
+
 bool VulkanDevice::GetPhysicalDeviceFeaturesSkia(uint32_t* sk_features) const {
   if (sk_features == nullptr) {
     return false;
@@ -312,6 +342,7 @@ int VulkanDevice::ChooseSurfaceFormat(const VulkanSurface& surface,
 }
 
 bool VulkanDevice::ChoosePresentMode(const VulkanSurface& surface,
+                                     VkPresentModeKHR desired_present_mode,
                                      VkPresentModeKHR* present_mode) const {
   if (!surface.IsValid() || present_mode == nullptr) {
     return false;
@@ -324,10 +355,37 @@ bool VulkanDevice::ChoosePresentMode(const VulkanSurface& surface,
   // powered by Vsync pulses instead of depending the submit to block.
   // However, for platforms that don't have VSync providers setup, it is better
   // to fall back to FIFO. For platforms that do have VSync providers, there
-  // should be little difference. In case there is a need for a mode other than
-  // FIFO, availability checks must be performed here before returning the
-  // result. FIFO is always present.
+  // should be little difference. Other modes are only used when asked for and
+  // supported by the surface. FIFO is always present.
   *present_mode = VK_PRESENT_MODE_FIFO_KHR;
+
+#if OS_ANDROID
+  if (desired_present_mode == VK_PRESENT_MODE_FIFO_KHR) {
+    return true;
+  }
+
+  uint32_t mode_count = 0;
+  if (VK_CALL_LOG_ERROR(vk.GetPhysicalDeviceSurfacePresentModesKHR(
+          physical_device_, surface.Handle(), &mode_count, nullptr)) !=
+      VK_SUCCESS) {
+    return true;
+  }
+
+  std::vector<VkPresentModeKHR> modes(mode_count);
+  if (VK_CALL_LOG_ERROR(vk.GetPhysicalDeviceSurfacePresentModesKHR(
+          physical_device_, surface.Handle(), &mode_count, modes.data())) !=
+      VK_SUCCESS) {
+    return true;
+  }
+
+  for (uint32_t i = 0; i < mode_count; i++) {
+    if (modes[i] == desired_present_mode) {
+      *present_mode = desired_present_mode;
+      break;
+    }
+  }
+#endif  // OS_ANDROID
+
   return true;
 }
 
@@ -45,6 +45,13 @@ class VulkanDevice {
   [[nodiscard]] bool GetPhysicalDeviceFeatures(
       VkPhysicalDeviceFeatures* features) const;
 
+  [[nodiscard]] bool GetPhysicalDeviceProperties(
+      VkPhysicalDeviceProperties* properties) const;
+
+  // Gets the number of nanoseconds per tick of the timestamps written on the
+  // graphics queue. Returns false if the queue doesn't support timestamps.
+  [[nodiscard]] bool GetTimestampPeriod(float* period) const;
+
   [[nodiscard]] bool GetPhysicalDeviceFeaturesSkia(
       uint32_t* /* mask of GrVkFeatureFlags */ features) const;
 
@@ -52,7 +59,10 @@ class VulkanDevice {
                                         std::vector<VkFormat> desired_formats,
                                         VkSurfaceFormatKHR* format) const;
 
+  // Picks |desired_present_mode| if the surface supports it, and FIFO, which
+  // is always supported, otherwise.
   [[nodiscard]] bool ChoosePresentMode(const VulkanSurface& surface,
+                                       VkPresentModeKHR desired_present_mode,
                                        VkPresentModeKHR* present_mode) const;
 
   [[nodiscard]] bool QueueSubmit(
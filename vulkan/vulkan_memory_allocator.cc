@@ -0,0 +1,290 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "vulkan_memory_allocator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+#include "flutter/fml/trace_event.h"
+#include "vulkan_proc_table.h"
+
+namespace vulkan {
+
+struct VulkanMemoryAllocation::Block {
+  VulkanHandle<VkDeviceMemory> memory;
+  VkDeviceSize size = 0;
+  uint32_t memory_type_index = 0;
+  // Whether the block holds a single allocation of its size.
+  bool dedicated = false;
+  VkDeviceSize allocated_bytes = 0;
+  // The free ranges of the block, from their offset to their size, and the
+  // same ranges from their size to their offset.
+  std::map<VkDeviceSize, VkDeviceSize> free_by_offset;
+  std::multimap<VkDeviceSize, VkDeviceSize> free_by_size;
+
+  void AddFreeRange(VkDeviceSize offset, VkDeviceSize size) {
+    free_by_offset.emplace(offset, size);
+    free_by_size.emplace(size, offset);
+  }
+
+  void RemoveFreeRange(std::map<VkDeviceSize, VkDeviceSize>::iterator range) {
+    auto by_size = free_by_size.equal_range(range->second);
+    for (auto it = by_size.first; it != by_size.second; ++it) {
+      if (it->second == range->first) {
+        free_by_size.erase(it);
+        break;
+      }
+    }
+    free_by_offset.erase(range);
+  }
+
+  // Takes the smallest free range that fits |size| at |alignment|, and
+  // returns the free parts of it on either side to the free ranges.
+  bool Allocate(VkDeviceSize size,
+                VkDeviceSize alignment,
+                VkDeviceSize* out_offset) {
+    for (auto it = free_by_size.lower_bound(size); it != free_by_size.end();
+         ++it) {
+      const VkDeviceSize range_offset = it->second;
+      const VkDeviceSize range_end = range_offset + it->first;
+      const VkDeviceSize offset =
+          (range_offset + alignment - 1) / alignment * alignment;
+      if (offset + size > range_end) {
+        continue;
+      }
+      RemoveFreeRange(free_by_offset.find(range_offset));
+      if (offset > range_offset) {
+        AddFreeRange(range_offset, offset - range_offset);
+      }
+      if (offset + size < range_end) {
+        AddFreeRange(offset + size, range_end - offset - size);
+      }
+      allocated_bytes += size;
+      *out_offset = offset;
+      return true;
+    }
+    return false;
+  }
+
+  // Returns the range to the free ranges, coalescing it with its neighbors.
+  void Free(VkDeviceSize offset, VkDeviceSize size) {
+    allocated_bytes -= size;
+    auto next = free_by_offset.lower_bound(offset);
+    if (next != free_by_offset.end() && next->first == offset + size) {
+      size += next->second;
+      RemoveFreeRange(next++);
+    }
+    if (next != free_by_offset.begin()) {
+      auto previous = std::prev(next);
+      if (previous->first + previous->second == offset) {
+        offset = previous->first;
+        size += previous->second;
+        RemoveFreeRange(previous);
+      }
+    }
+    AddFreeRange(offset, size);
+  }
+};
+
+VulkanMemoryAllocation::VulkanMemoryAllocation() = default;
+
+VulkanMemoryAllocation::VulkanMemoryAllocation(VulkanMemoryAllocation&& other)
+    : allocator_(other.allocator_),
+      block_(other.block_),
+      offset_(other.offset_),
+      size_(other.size_) {
+  other.allocator_ = nullptr;
+  other.block_ = nullptr;
+}
+
+VulkanMemoryAllocation& VulkanMemoryAllocation::operator=(
+    VulkanMemoryAllocation&& other) {
+  if (this != &other) {
+    Reset();
+    allocator_ = other.allocator_;
+    block_ = other.block_;
+    offset_ = other.offset_;
+    size_ = other.size_;
+    other.allocator_ = nullptr;
+    other.block_ = nullptr;
+  }
+  return *this;
+}
+
+VulkanMemoryAllocation::~VulkanMemoryAllocation() {
+  Reset();
+}
+
+bool VulkanMemoryAllocation::IsValid() const {
+  return block_ != nullptr;
+}
+
+VkDeviceMemory VulkanMemoryAllocation::GetMemory() const {
+  return block_ ? static_cast<VkDeviceMemory>(block_->memory) : VK_NULL_HANDLE;
+}
+
+VkDeviceSize VulkanMemoryAllocation::GetOffset() const {
+  return block_ ? offset_ : 0;
+}
+
+VkDeviceSize VulkanMemoryAllocation::GetSize() const {
+  return block_ ? size_ : 0;
+}
+
+void VulkanMemoryAllocation::Reset() {
+  if (block_ == nullptr) {
+    return;
+  }
+  allocator_->Free(block_, offset_, size_);
+  allocator_ = nullptr;
+  block_ = nullptr;
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(
+    const VulkanProcTable& p_vk,
+    const VulkanHandle<VkDevice>& device,
+    VkExternalMemoryHandleTypeFlags export_handle_types)
+    : vk(p_vk),
+      device_(device),
+      export_handle_types_(export_handle_types) {}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+  FML_DCHECK(GetAllocatedBytes() == 0)
+      << "Device memory allocations outlived their allocator.";
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::Allocate(
+    const VkMemoryRequirements& requirements,
+    uint32_t memory_type_index) {
+  VulkanMemoryAllocation allocation;
+  if (requirements.size == 0) {
+    return allocation;
+  }
+
+  Block* block = nullptr;
+  VkDeviceSize offset = 0;
+  if (requirements.size > kMaxSubAllocationSize) {
+    block = AllocateBlock(requirements.size, memory_type_index, true);
+    if (block == nullptr) {
+      return allocation;
+    }
+    block->allocated_bytes = requirements.size;
+  } else {
+    const VkDeviceSize alignment =
+        std::max<VkDeviceSize>(requirements.alignment, 1);
+    for (const auto& candidate : blocks_) {
+      if (!candidate->dedicated &&
+          candidate->memory_type_index == memory_type_index &&
+          candidate->Allocate(requirements.size, alignment, &offset)) {
+        block = candidate.get();
+        break;
+      }
+    }
+    if (block == nullptr) {
+      block = AllocateBlock(kBlockSize, memory_type_index, false);
+      if (block == nullptr) {
+        return allocation;
+      }
+      block->AddFreeRange(0, kBlockSize);
+      if (!block->Allocate(requirements.size, alignment, &offset)) {
+        FML_DLOG(ERROR) << "Could not place an allocation in a new block.";
+        return allocation;
+      }
+    }
+  }
+
+  allocation.allocator_ = this;
+  allocation.block_ = block;
+  allocation.offset_ = offset;
+  allocation.size_ = requirements.size;
+  return allocation;
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetBlockBytes() const {
+  VkDeviceSize bytes = 0;
+  for (const auto& block : blocks_) {
+    bytes += block->size;
+  }
+  return bytes;
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetAllocatedBytes() const {
+  VkDeviceSize bytes = 0;
+  for (const auto& block : blocks_) {
+    bytes += block->allocated_bytes;
+  }
+  return bytes;
+}
+
+VulkanMemoryAllocator::Block* VulkanMemoryAllocator::AllocateBlock(
+    VkDeviceSize size,
+    uint32_t memory_type_index,
+    bool dedicated) {
+  TRACE_EVENT1("flutter", "VulkanMemoryAllocator::AllocateBlock",
+               "allocationSize", size);
+
+  const VkExportMemoryAllocateInfoKHR export_allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR,
+      .pNext = nullptr,
+      .handleTypes = export_handle_types_,
+  };
+
+  const VkMemoryAllocateInfo allocate_info = {
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext = export_handle_types_ != 0 ? &export_allocate_info : nullptr,
+      .allocationSize = size,
+      .memoryTypeIndex = memory_type_index,
+  };
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  if (VK_CALL_LOG_ERROR(vk.AllocateMemory(device_, &allocate_info, nullptr,
+                                          &memory)) != VK_SUCCESS) {
+    return nullptr;
+  }
+
+  auto block = std::make_unique<Block>();
+  block->memory = {memory, [this](VkDeviceMemory memory) {
+                     vk.FreeMemory(device_, memory, nullptr);
+                   }};
+  block->size = size;
+  block->memory_type_index = memory_type_index;
+  block->dedicated = dedicated;
+  blocks_.push_back(std::move(block));
+  return blocks_.back().get();
+}
+
+void VulkanMemoryAllocator::Free(Block* block,
+                                 VkDeviceSize offset,
+                                 VkDeviceSize size) {
+  auto found = std::find_if(
+      blocks_.begin(), blocks_.end(),
+      [block](const auto& candidate) { return candidate.get() == block; });
+  FML_DCHECK(found != blocks_.end());
+
+  if (block->dedicated) {
+    blocks_.erase(found);
+    return;
+  }
+
+  block->Free(offset, size);
+  if (block->allocated_bytes != 0) {
+    return;
+  }
+
+  // Keep a single empty block per memory type, so that a heap that shrinks
+  // and grows back doesn't go to the driver each time.
+  const bool has_other_empty_block = std::any_of(
+      blocks_.begin(), blocks_.end(), [block](const auto& candidate) {
+        return candidate.get() != block && !candidate->dedicated &&
+               candidate->memory_type_index == block->memory_type_index &&
+               candidate->allocated_bytes == 0;
+      });
+  if (has_other_empty_block) {
+    blocks_.erase(found);
+  }
+}
+
+}  // namespace vulkan
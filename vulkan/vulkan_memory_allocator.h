@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
+#define FLUTTER_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "vulkan_handle.h"
+
+namespace vulkan {
+
+class VulkanProcTable;
+class VulkanMemoryAllocator;
+
+// A range of device memory handed out by a |VulkanMemoryAllocator|, which is
+// returned to it when this object is collected or reset.
+class VulkanMemoryAllocation {
+ public:
+  VulkanMemoryAllocation();
+
+  VulkanMemoryAllocation(VulkanMemoryAllocation&& other);
+
+  VulkanMemoryAllocation& operator=(VulkanMemoryAllocation&& other);
+
+  ~VulkanMemoryAllocation();
+
+  bool IsValid() const;
+
+  // The device memory the range is in, which other allocations may share.
+  VkDeviceMemory GetMemory() const;
+
+  VkDeviceSize GetOffset() const;
+
+  VkDeviceSize GetSize() const;
+
+  void Reset();
+
+ private:
+  friend class VulkanMemoryAllocator;
+
+  struct Block;
+
+  VulkanMemoryAllocator* allocator_ = nullptr;
+  Block* block_ = nullptr;
+  VkDeviceSize offset_ = 0;
+  VkDeviceSize size_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(VulkanMemoryAllocation);
+};
+
+// Sub-allocates the memory of images and buffers from large blocks of device
+// memory, one heap of blocks per memory type, instead of allocating device
+// memory for each of them. This keeps the number of live device memory
+// allocations, which drivers limit, low, and takes the slow allocation paths
+// of the driver only when a heap grows.
+//
+// Ranges are placed by best fit into the free ranges of the blocks, which are
+// coalesced when ranges are freed. Requests larger than
+// |kMaxSubAllocationSize| get a block of their own.
+//
+// This class is not thread safe, and must outlive its allocations.
+class VulkanMemoryAllocator {
+ public:
+  static constexpr VkDeviceSize kBlockSize = 32 * 1024 * 1024;
+  static constexpr VkDeviceSize kMaxSubAllocationSize = kBlockSize / 2;
+
+  // Blocks are allocated as exportable as |export_handle_types| if not zero.
+  VulkanMemoryAllocator(
+      const VulkanProcTable& vk,
+      const VulkanHandle<VkDevice>& device,
+      VkExternalMemoryHandleTypeFlags export_handle_types = 0);
+
+  ~VulkanMemoryAllocator();
+
+  // Returns an allocation that satisfies the size and alignment of
+  // |requirements| in memory of |memory_type_index|, or an invalid one if the
+  // device is out of memory.
+  VulkanMemoryAllocation Allocate(const VkMemoryRequirements& requirements,
+                                  uint32_t memory_type_index);
+
+  // The device memory held by the blocks of all the heaps.
+  VkDeviceSize GetBlockBytes() const;
+
+  // The part of |GetBlockBytes| that is handed out.
+  VkDeviceSize GetAllocatedBytes() const;
+
+  size_t GetBlockCount() const { return blocks_.size(); }
+
+ private:
+  friend class VulkanMemoryAllocation;
+
+  using Block = VulkanMemoryAllocation::Block;
+
+  const VulkanProcTable& vk;
+  const VulkanHandle<VkDevice>& device_;
+  const VkExternalMemoryHandleTypeFlags export_handle_types_;
+  std::vector<std::unique_ptr<Block>> blocks_;
+
+  Block* AllocateBlock(VkDeviceSize size,
+                       uint32_t memory_type_index,
+                       bool dedicated);
+
+  void Free(Block* block, VkDeviceSize offset, VkDeviceSize size);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(VulkanMemoryAllocator);
+};
+
+}  // namespace vulkan
+
+#endif  // FLUTTER_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
@@ -22,6 +22,14 @@ VulkanProcTable::VulkanProcTable()
       OpenLibraryHandle() && SetupLoaderProcAddresses();
 }
 
+VulkanProcTable::VulkanProcTable(
+    PFN_vkGetInstanceProcAddr get_instance_proc_addr)
+    : handle_(nullptr), acquired_mandatory_proc_addresses_(false) {
+  GetInstanceProcAddr = get_instance_proc_addr;
+  acquired_mandatory_proc_addresses_ =
+      GetInstanceProcAddr && SetupLoaderProcAddresses();
+}
+
 VulkanProcTable::~VulkanProcTable() {
   CloseLibraryHandle();
 }
@@ -43,17 +51,19 @@ bool VulkanProcTable::AreDeviceProcsSetup() const {
 }
 
 bool VulkanProcTable::SetupLoaderProcAddresses() {
-  if (handle_ == nullptr) {
-    return true;
-  }
+  if (!GetInstanceProcAddr) {
+    if (handle_ == nullptr) {
+      return true;
+    }
 
-  GetInstanceProcAddr =
+    GetInstanceProcAddr =
 #if VULKAN_LINK_STATICALLY
-      GetInstanceProcAddr = &vkGetInstanceProcAddr;
+        GetInstanceProcAddr = &vkGetInstanceProcAddr;
 #else   // VULKAN_LINK_STATICALLY
-      reinterpret_cast<PFN_vkGetInstanceProcAddr>(
-          dlsym(handle_, "vkGetInstanceProcAddr"));
+        reinterpret_cast<PFN_vkGetInstanceProcAddr>(
+            dlsym(handle_, "vkGetInstanceProcAddr"));
 #endif  // VULKAN_LINK_STATICALLY
+  }
 
   if (!GetInstanceProcAddr) {
     FML_DLOG(WARNING) << "Could not acquire vkGetInstanceProcAddr.";
@@ -78,6 +88,7 @@ bool VulkanProcTable::SetupInstanceProcAddresses(
   ACQUIRE_PROC(EnumeratePhysicalDevices, handle);
   ACQUIRE_PROC(GetDeviceProcAddr, handle);
   ACQUIRE_PROC(GetPhysicalDeviceFeatures, handle);
+  ACQUIRE_PROC(GetPhysicalDeviceProperties, handle);
   ACQUIRE_PROC(GetPhysicalDeviceQueueFamilyProperties, handle);
 #if OS_ANDROID
   ACQUIRE_PROC(GetPhysicalDeviceSurfaceCapabilitiesKHR, handle);
@@ -110,13 +121,17 @@ bool VulkanProcTable::SetupDeviceProcAddresses(
   ACQUIRE_PROC(BeginCommandBuffer, handle);
   ACQUIRE_PROC(BindImageMemory, handle);
   ACQUIRE_PROC(CmdPipelineBarrier, handle);
+  ACQUIRE_PROC(CmdResetQueryPool, handle);
+  ACQUIRE_PROC(CmdWriteTimestamp, handle);
   ACQUIRE_PROC(CreateCommandPool, handle);
   ACQUIRE_PROC(CreateFence, handle);
   ACQUIRE_PROC(CreateImage, handle);
+  ACQUIRE_PROC(CreateQueryPool, handle);
   ACQUIRE_PROC(CreateSemaphore, handle);
   ACQUIRE_PROC(DestroyCommandPool, handle);
   ACQUIRE_PROC(DestroyFence, handle);
   ACQUIRE_PROC(DestroyImage, handle);
+  ACQUIRE_PROC(DestroyQueryPool, handle);
   ACQUIRE_PROC(DestroySemaphore, handle);
   ACQUIRE_PROC(DeviceWaitIdle, handle);
   ACQUIRE_PROC(EndCommandBuffer, handle);
@@ -124,6 +139,7 @@ bool VulkanProcTable::SetupDeviceProcAddresses(
   ACQUIRE_PROC(FreeMemory, handle);
   ACQUIRE_PROC(GetDeviceQueue, handle);
   ACQUIRE_PROC(GetImageMemoryRequirements, handle);
+  ACQUIRE_PROC(GetQueryPoolResults, handle);
   ACQUIRE_PROC(QueueSubmit, handle);
   ACQUIRE_PROC(QueueWaitIdle, handle);
   ACQUIRE_PROC(ResetCommandBuffer, handle);
@@ -69,12 +69,15 @@ class VulkanProcTable : public fml::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(BeginCommandBuffer);
   DEFINE_PROC(BindImageMemory);
   DEFINE_PROC(CmdPipelineBarrier);
+  DEFINE_PROC(CmdResetQueryPool);
+  DEFINE_PROC(CmdWriteTimestamp);
   DEFINE_PROC(CreateCommandPool);
   DEFINE_PROC(CreateDebugReportCallbackEXT);
   DEFINE_PROC(CreateDevice);
   DEFINE_PROC(CreateFence);
   DEFINE_PROC(CreateImage);
   DEFINE_PROC(CreateInstance);
+  DEFINE_PROC(CreateQueryPool);
   DEFINE_PROC(CreateSemaphore);
   DEFINE_PROC(CreateSwapchainKHR);
   DEFINE_PROC(DestroyCommandPool);
@@ -83,6 +86,7 @@ class VulkanProcTable : public fml::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(DestroyFence);
   DEFINE_PROC(DestroyImage);
   DEFINE_PROC(DestroyInstance);
+  DEFINE_PROC(DestroyQueryPool);
   DEFINE_PROC(DestroySemaphore);
   DEFINE_PROC(DestroySurfaceKHR);
   DEFINE_PROC(DestroySwapchainKHR);
@@ -99,7 +103,9 @@ class VulkanProcTable : public fml::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(GetImageMemoryRequirements);
   DEFINE_PROC(GetInstanceProcAddr);
   DEFINE_PROC(GetPhysicalDeviceFeatures);
+  DEFINE_PROC(GetPhysicalDeviceProperties);
   DEFINE_PROC(GetPhysicalDeviceQueueFamilyProperties);
+  DEFINE_PROC(GetQueryPoolResults);
   DEFINE_PROC(QueueSubmit);
   DEFINE_PROC(QueueWaitIdle);
   DEFINE_PROC(ResetCommandBuffer);
@@ -128,6 +134,9 @@ class VulkanProcTable : public fml::RefCountedThreadSafe<VulkanProcTable> {
   VulkanHandle<VkDevice> device_;
 
   VulkanProcTable();
+  // Resolves procs through |get_instance_proc_addr| instead of loading the
+  // Vulkan library, for instances and devices created by someone else.
+  explicit VulkanProcTable(PFN_vkGetInstanceProcAddr get_instance_proc_addr);
   ~VulkanProcTable();
   bool OpenLibraryHandle();
   bool SetupLoaderProcAddresses();
@@ -4,6 +4,9 @@
 
 #include "vulkan_swapchain.h"
 
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/gpu/GrBackendSurface.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/skia/include/gpu/vk/GrVkTypes.h"
@@ -41,11 +44,13 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
                                  const VulkanSurface& surface,
                                  GrContext* skia_context,
                                  std::unique_ptr<VulkanSwapchain> old_swapchain,
-                                 uint32_t queue_family_index)
+                                 uint32_t queue_family_index,
+                                 const VulkanSwapchainConfig& config)
     : vk(p_vk),
       device_(device),
       capabilities_(),
       surface_format_(),
+      timestamp_period_(0.0f),
       current_pipeline_stage_(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
       current_backbuffer_index_(0),
       current_image_index_(0),
@@ -79,7 +84,8 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
   }
 
   VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
-  if (!device_.ChoosePresentMode(surface, &present_mode)) {
+  if (!device_.ChoosePresentMode(surface, config.present_mode,
+                                 &present_mode)) {
     FML_DLOG(INFO) << "Could not choose present mode.";
     return;
   }
@@ -113,12 +119,23 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
 
   VkSurfaceKHR surface_handle = surface.Handle();
 
+  // In mailbox mode, a frame queued while another one waits for vsync replaces
+  // it instead of blocking. That needs an image besides the ones being
+  // displayed and waiting.
+  uint32_t image_count = capabilities_.minImageCount;
+  if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+    image_count++;
+    if (capabilities_.maxImageCount > 0) {
+      image_count = std::min(image_count, capabilities_.maxImageCount);
+    }
+  }
+
   const VkSwapchainCreateInfoKHR create_info = {
       .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
       .pNext = nullptr,
       .flags = 0,
       .surface = surface_handle,
-      .minImageCount = capabilities_.minImageCount,
+      .minImageCount = image_count,
       .imageFormat = surface_format_.format,
       .imageColorSpace = surface_format_.colorSpace,
       .imageExtent = capabilities_.currentExtent,
@@ -156,6 +173,13 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
     return;
   }
 
+  if (!CreateBackbuffers(config.max_frames_in_flight)) {
+    FML_DLOG(INFO) << "Could not create swapchain backbuffers.";
+    return;
+  }
+
+  CreateTimestampQueryPool();
+
   valid_ = true;
 }
 
@@ -258,16 +282,6 @@ bool VulkanSwapchain::CreateSwapchainImages(GrContext* skia_context,
   const SkISize surface_size = GetSize();
 
   for (const VkImage& image : images) {
-    // Populate the backbuffer.
-    auto backbuffer = std::make_unique<VulkanBackbuffer>(
-        vk, device_.GetHandle(), device_.GetCommandPool());
-
-    if (!backbuffer->IsValid()) {
-      return false;
-    }
-
-    backbuffers_.emplace_back(std::move(backbuffer));
-
     // Populate the image.
     auto vulkan_image = std::make_unique<VulkanImage>(image);
 
@@ -288,12 +302,34 @@ bool VulkanSwapchain::CreateSwapchainImages(GrContext* skia_context,
     surfaces_.emplace_back(std::move(surface));
   }
 
-  FML_DCHECK(backbuffers_.size() == images_.size());
   FML_DCHECK(images_.size() == surfaces_.size());
 
   return true;
 }
 
+bool VulkanSwapchain::CreateBackbuffers(uint32_t max_frames_in_flight) {
+  // Acquiring a surface waits for the fences of the next backbuffer, so the
+  // number of backbuffers bounds the number of frames in flight. More than one
+  // per image would only queue frames behind the presentation engine.
+  size_t count = images_.size();
+  if (max_frames_in_flight > 0) {
+    count = std::min<size_t>(count, max_frames_in_flight);
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    auto backbuffer = std::make_unique<VulkanBackbuffer>(
+        vk, device_.GetHandle(), device_.GetCommandPool());
+
+    if (!backbuffer->IsValid()) {
+      return false;
+    }
+
+    backbuffers_.emplace_back(std::move(backbuffer));
+  }
+
+  return !backbuffers_.empty();
+}
+
 VulkanBackbuffer* VulkanSwapchain::GetNextBackbuffer() {
   auto available_backbuffers = backbuffers_.size();
 
@@ -314,7 +350,70 @@ VulkanBackbuffer* VulkanSwapchain::GetNextBackbuffer() {
   return backbuffer.get();
 }
 
+void VulkanSwapchain::CreateTimestampQueryPool() {
+  // GPU frame times are only informational, so the swapchain works without.
+  if (!device_.GetTimestampPeriod(&timestamp_period_)) {
+    return;
+  }
+
+  const VkQueryPoolCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .queryType = VK_QUERY_TYPE_TIMESTAMP,
+      .queryCount = static_cast<uint32_t>(backbuffers_.size() * 2),
+      .pipelineStatistics = 0,
+  };
+
+  VkQueryPool query_pool = VK_NULL_HANDLE;
+
+  if (VK_CALL_LOG_ERROR(vk.CreateQueryPool(device_.GetHandle(), &create_info,
+                                           nullptr, &query_pool)) !=
+      VK_SUCCESS) {
+    FML_DLOG(INFO) << "Could not create the timestamp query pool.";
+    return;
+  }
+
+  timestamp_query_pool_ = {query_pool, [this](VkQueryPool query_pool) {
+                             vk.DestroyQueryPool(device_.GetHandle(),
+                                                 query_pool, nullptr);
+                           }};
+  timestamps_pending_.resize(backbuffers_.size(), false);
+}
+
+void VulkanSwapchain::CollectTimestamps(size_t backbuffer_index) {
+  if (!timestamp_query_pool_ || !timestamps_pending_[backbuffer_index]) {
+    return;
+  }
+  timestamps_pending_[backbuffer_index] = false;
+
+  // The fences of the backbuffer have been waited on, so the results of its
+  // last frame are available.
+  uint64_t timestamps[2] = {};
+  if (VK_CALL_LOG_ERROR(vk.GetQueryPoolResults(
+          device_.GetHandle(), timestamp_query_pool_,
+          static_cast<uint32_t>(backbuffer_index * 2), 2, sizeof(timestamps),
+          timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT)) !=
+      VK_SUCCESS) {
+    return;
+  }
+
+  if (timestamps[1] < timestamps[0]) {
+    return;
+  }
+
+  gpu_frame_time_ = fml::TimeDelta::FromNanoseconds(static_cast<int64_t>(
+      (timestamps[1] - timestamps[0]) * timestamp_period_));
+}
+
+std::optional<fml::TimeDelta> VulkanSwapchain::TakeGpuFrameTime() {
+  auto frame_time = gpu_frame_time_;
+  gpu_frame_time_ = std::nullopt;
+  return frame_time;
+}
+
 VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
+  TRACE_EVENT0("flutter", "VulkanSwapchain::AcquireSurface");
   AcquireResult error = {AcquireStatus::ErrorSurfaceLost, nullptr};
 
   if (!IsValid()) {
@@ -337,11 +436,16 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
   // Step 1:
   // Wait for use readiness.
   // ---------------------------------------------------------------------------
-  if (!backbuffer->WaitFences()) {
-    FML_DLOG(INFO) << "Failed waiting on fences.";
-    return error;
+  {
+    TRACE_EVENT0("flutter", "WaitForFrameInFlight");
+    if (!backbuffer->WaitFences()) {
+      FML_DLOG(INFO) << "Failed waiting on fences.";
+      return error;
+    }
   }
 
+  CollectTimestamps(current_backbuffer_index_);
+
   // ---------------------------------------------------------------------------
   // Step 2:
   // Put semaphores in unsignaled state.
@@ -357,13 +461,17 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
   // ---------------------------------------------------------------------------
   uint32_t next_image_index = 0;
 
-  VkResult acquire_result = VK_CALL_LOG_ERROR(
-      vk.AcquireNextImageKHR(device_.GetHandle(),                   //
-                             swapchain_,                            //
-                             std::numeric_limits<uint64_t>::max(),  //
-                             backbuffer->GetUsageSemaphore(),       //
-                             VK_NULL_HANDLE,                        //
-                             &next_image_index));
+  VkResult acquire_result = VK_SUCCESS;
+  {
+    TRACE_EVENT0("flutter", "AcquireNextImageKHR");
+    acquire_result = VK_CALL_LOG_ERROR(
+        vk.AcquireNextImageKHR(device_.GetHandle(),                   //
+                               swapchain_,                            //
+                               std::numeric_limits<uint64_t>::max(),  //
+                               backbuffer->GetUsageSemaphore(),       //
+                               VK_NULL_HANDLE,                        //
+                               &next_image_index));
+  }
 
   switch (acquire_result) {
     case VK_SUCCESS:
@@ -421,6 +529,18 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
     current_pipeline_stage_ = destination_pipeline_stage;
   }
 
+  // Mark the start of the GPU work of the frame. It is written once the image
+  // has been acquired, so waiting on the presentation engine isn't counted.
+  const uint32_t start_query =
+      static_cast<uint32_t>(current_backbuffer_index_ * 2);
+  if (timestamp_query_pool_) {
+    backbuffer->GetUsageCommandBuffer().ResetQueryPool(timestamp_query_pool_,
+                                                       start_query, 2);
+    backbuffer->GetUsageCommandBuffer().WriteTimestamp(
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_query_pool_,
+        start_query);
+  }
+
   // ---------------------------------------------------------------------------
   // Step 6:
   // End recording to the command buffer.
@@ -475,6 +595,7 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
 }
 
 bool VulkanSwapchain::Submit() {
+  TRACE_EVENT0("flutter", "VulkanSwapchain::Submit");
   if (!IsValid()) {
     FML_DLOG(INFO) << "Swapchain was invalid.";
     return false;
@@ -499,6 +620,13 @@ bool VulkanSwapchain::Submit() {
     return false;
   }
 
+  // Mark the end of the GPU work Skia submitted for the frame.
+  if (timestamp_query_pool_) {
+    backbuffer->GetRenderCommandBuffer().WriteTimestamp(
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_query_pool_,
+        static_cast<uint32_t>(current_backbuffer_index_ * 2 + 1));
+  }
+
   // ---------------------------------------------------------------------------
   // Step 2:
   // Set image layout to present mode.
@@ -551,6 +679,10 @@ bool VulkanSwapchain::Submit() {
     return false;
   }
 
+  if (timestamp_query_pool_) {
+    timestamps_pending_[current_backbuffer_index_] = true;
+  }
+
   // ---------------------------------------------------------------------------
   // Step 5:
   // Submit the present operation and wait on the render semaphore.
@@ -569,6 +701,7 @@ bool VulkanSwapchain::Submit() {
       .pResults = nullptr,
   };
 
+  TRACE_EVENT0("flutter", "QueuePresentKHR");
   if (VK_CALL_LOG_ERROR(vk.QueuePresentKHR(device_.GetQueueHandle(),
                                            &present_info)) != VK_SUCCESS) {
     FML_DLOG(INFO) << "Could not submit the present operation.";
@@ -6,11 +6,13 @@
 #define FLUTTER_VULKAN_VULKAN_SWAPCHAIN_H_
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "vulkan_handle.h"
@@ -23,6 +25,16 @@ class VulkanSurface;
 class VulkanBackbuffer;
 class VulkanImage;
 
+struct VulkanSwapchainConfig {
+  /// The present mode of the swapchain if the surface supports it. FIFO, which
+  /// all surfaces support, is used otherwise.
+  VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+  /// The number of frames that may be rendering or waiting to be presented at
+  /// once before acquiring the next surface blocks. Zero allows one frame per
+  /// swapchain image.
+  uint32_t max_frames_in_flight = 0;
+};
+
 class VulkanSwapchain {
  public:
   VulkanSwapchain(const VulkanProcTable& vk,
@@ -30,7 +42,8 @@ class VulkanSwapchain {
                   const VulkanSurface& surface,
                   GrContext* skia_context,
                   std::unique_ptr<VulkanSwapchain> old_swapchain,
-                  uint32_t queue_family_index);
+                  uint32_t queue_family_index,
+                  const VulkanSwapchainConfig& config = {});
 
   ~VulkanSwapchain();
 
@@ -60,12 +73,23 @@ class VulkanSwapchain {
 
   SkISize GetSize() const;
 
+  /// Returns the time the GPU spent on the most recent frame whose timestamps
+  /// were collected since the last call, if any. Timestamps are collected when
+  /// the backbuffer of a frame is reused, a few frames after it was submitted.
+  std::optional<fml::TimeDelta> TakeGpuFrameTime();
+
 #if OS_ANDROID
  private:
   const VulkanProcTable& vk;
   const VulkanDevice& device_;
   VkSurfaceCapabilitiesKHR capabilities_;
   VkSurfaceFormatKHR surface_format_;
+  // Two timestamps per backbuffer that bracket the GPU work of the frame last
+  // rendered with it. Null if the graphics queue doesn't support timestamps.
+  VulkanHandle<VkQueryPool> timestamp_query_pool_;
+  float timestamp_period_;
+  std::vector<bool> timestamps_pending_;
+  std::optional<fml::TimeDelta> gpu_frame_time_;
   VulkanHandle<VkSwapchainKHR> swapchain_;
   std::vector<std::unique_ptr<VulkanBackbuffer>> backbuffers_;
   std::vector<std::unique_ptr<VulkanImage>> images_;
@@ -81,6 +105,8 @@ class VulkanSwapchain {
                              SkColorType color_type,
                              sk_sp<SkColorSpace> color_space);
 
+  bool CreateBackbuffers(uint32_t max_frames_in_flight);
+
   sk_sp<SkSurface> CreateSkiaSurface(GrContext* skia_context,
                                      VkImage image,
                                      const SkISize& size,
@@ -88,6 +114,10 @@ class VulkanSwapchain {
                                      sk_sp<SkColorSpace> color_space) const;
 
   VulkanBackbuffer* GetNextBackbuffer();
+
+  void CreateTimestampQueryPool();
+
+  void CollectTimestamps(size_t backbuffer_index);
 #endif  // OS_ANDROID
 
   FML_DISALLOW_COPY_AND_ASSIGN(VulkanSwapchain);
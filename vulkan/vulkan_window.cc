@@ -18,8 +18,11 @@ namespace vulkan {
 
 VulkanWindow::VulkanWindow(fml::RefPtr<VulkanProcTable> proc_table,
                            std::unique_ptr<VulkanNativeSurface> native_surface,
-                           bool render_to_surface)
-    : valid_(false), vk(std::move(proc_table)) {
+                           bool render_to_surface,
+                           const VulkanSwapchainConfig& swapchain_config)
+    : valid_(false),
+      vk(std::move(proc_table)),
+      swapchain_config_(swapchain_config) {
   if (!vk || !vk->HasAcquiredMandatoryProcAddresses()) {
     FML_DLOG(INFO) << "Proc table has not acquired mandatory proc addresses.";
     return;
@@ -222,6 +225,14 @@ bool VulkanWindow::SwapBuffers() {
   return swapchain_->Submit();
 }
 
+std::optional<fml::TimeDelta> VulkanWindow::TakeGpuFrameTime() {
+  if (!IsValid()) {
+    return std::nullopt;
+  }
+
+  return swapchain_->TakeGpuFrameTime();
+}
+
 bool VulkanWindow::RecreateSwapchain() {
   // This way, we always lose our reference to the old swapchain. Even if we
   // cannot create a new one to replace it.
@@ -245,7 +256,8 @@ bool VulkanWindow::RecreateSwapchain() {
 
   auto swapchain = std::make_unique<VulkanSwapchain>(
       *vk, *logical_device_, *surface_, skia_gr_context_.get(),
-      std::move(old_swapchain), logical_device_->GetGraphicsQueueIndex());
+      std::move(old_swapchain), logical_device_->GetGraphicsQueueIndex(),
+      swapchain_config_);
 
   if (!swapchain->IsValid()) {
     return false;
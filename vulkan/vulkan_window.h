@@ -6,25 +6,27 @@
 #define FLUTTER_VULKAN_VULKAN_WINDOW_H_
 
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 #include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/skia/include/gpu/vk/GrVkBackendContext.h"
 #include "vulkan_proc_table.h"
+#include "vulkan_swapchain.h"
 
 namespace vulkan {
 
 class VulkanNativeSurface;
 class VulkanDevice;
 class VulkanSurface;
-class VulkanSwapchain;
 class VulkanImage;
 class VulkanApplication;
 class VulkanBackbuffer;
@@ -33,7 +35,8 @@ class VulkanWindow {
  public:
   VulkanWindow(fml::RefPtr<VulkanProcTable> proc_table,
                std::unique_ptr<VulkanNativeSurface> native_surface,
-               bool render_to_surface);
+               bool render_to_surface,
+               const VulkanSwapchainConfig& swapchain_config = {});
 
   ~VulkanWindow();
 
@@ -45,12 +48,15 @@ class VulkanWindow {
 
   bool SwapBuffers();
 
+  std::optional<fml::TimeDelta> TakeGpuFrameTime();
+
  private:
   bool valid_;
   fml::RefPtr<VulkanProcTable> vk;
   std::unique_ptr<VulkanApplication> application_;
   std::unique_ptr<VulkanDevice> logical_device_;
   std::unique_ptr<VulkanSurface> surface_;
+  const VulkanSwapchainConfig swapchain_config_;
   std::unique_ptr<VulkanSwapchain> swapchain_;
   sk_sp<GrContext> skia_gr_context_;
 